@@ -1,77 +1,231 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "kota/async/async.h"
+#include "kota/codec/bincode.h"
 
 namespace kota {
 
-struct CompileUnit {
-    std::string name;
-    std::vector<std::string> dependencies;
-    std::vector<std::string> dependents;
-    bool dirty = true;
-    bool compiling = false;
-    std::unique_ptr<cancellation_source> source = std::make_unique<cancellation_source>();
-    std::unique_ptr<event> completion;
-};
-
+/// Rebuilds units when they or their dependencies change, with early
+/// cutoff: a unit whose dependencies were rebuilt but all produced the same
+/// output hash as before is not rebuilt itself.
 class CompileGraph {
 public:
     using delay_fn = std::function<std::chrono::milliseconds()>;
 
-    explicit CompileGraph(delay_fn delay = [] { return std::chrono::milliseconds{10}; }) :
-        compile_delay_(std::move(delay)) {}
+    /// Hash of a unit's output after compiling revision `revision` of it;
+    /// update() bumps the revision. The default changes with every
+    /// revision, so only an output_fn that sees through an edit (say, one
+    /// touching only comments) triggers the cutoff.
+    using output_fn = std::function<std::uint64_t(const std::string& name, std::uint64_t revision)>;
 
-    void add_unit(const std::string& name, std::vector<std::string> deps = {}) {
-        auto& unit = units_[name];
-        unit.name = name;
-        unit.dependencies = std::move(deps);
+    explicit CompileGraph(delay_fn delay = [] { return std::chrono::milliseconds{10}; },
+                          output_fn output = default_output) :
+        compile_delay_(std::move(delay)), output_(std::move(output)) {}
 
-        for(auto& dep: unit.dependencies) {
-            if(units_.find(dep) == units_.end()) {
-                units_[dep].name = dep;
-            }
-            units_[dep].dependents.push_back(name);
+    void add_unit(const std::string& name, std::vector<std::string> deps = {}) {
+        auto id = unit_id(name);
+        for(auto& dep: deps) {
+            graph_.add_edge(id, unit_id(dep));
         }
     }
 
     task<bool> compile(const std::string& name, event_loop& loop) {
-        co_return co_await compile_impl(name, loop);
+        auto id = graph_.find(name);
+        if(!id || !prepare()) {
+            co_return false;
+        }
+        co_return co_await compile_impl(*id, loop);
+    }
+
+    /// Compiles `targets` and their dependencies, at most `concurrency`
+    /// units at once, starting the longest chains first.
+    task<bool> build(std::span<const std::string> targets,
+                     std::size_t concurrency,
+                     event_loop& loop) {
+        if(!prepare()) {
+            co_return false;
+        }
+
+        std::vector<task_graph::node_id> ids;
+        for(auto& name: targets) {
+            auto id = graph_.find(name);
+            if(!id) {
+                co_return false;
+            }
+            ids.push_back(*id);
+        }
+
+        // Dependencies are already built when a unit's turn comes, so this
+        // compiles just the unit itself.
+        co_return co_await graph_.run(
+            ids,
+            [this, &loop](task_graph::node_id id) { return compile_impl(id, loop); },
+            concurrency);
     }
 
+    /// Marks `name` as edited and everything depending on it as needing a
+    /// check, cancelling their compilations in flight.
     void update(const std::string& name) {
-        auto it = units_.find(name);
-        if(it == units_.end()) {
+        auto id = graph_.find(name);
+        if(!id || !prepare()) {
             return;
         }
+        invalidate(*id);
+    }
+
+    /// Whether the last compile of `name` rebuilt it, as opposed to finding
+    /// it up to date.
+    bool rebuilt(const std::string& name) const {
+        auto id = graph_.find(name);
+        return id && units_[*id].rebuilt;
+    }
+
+    /// Serializes the hashes of every up-to-date unit with bincode, so a
+    /// later run can load_state() and skip what has not changed.
+    std::optional<std::vector<std::byte>> save_state() const {
+        saved_state state;
+        for(std::size_t id = 0; id < units_.size(); ++id) {
+            auto& unit = units_[id];
+            if(unit.status == unit_status::clean) {
+                state.units.push_back(saved_unit{std::string(graph_.name(
+                                                     static_cast<task_graph::node_id>(id))),
+                                                 unit.output_hash,
+                                                 unit.inputs_hash});
+            }
+        }
 
-        auto& unit = it->second;
-        unit.source->cancel();
-        unit.source = std::make_unique<cancellation_source>();
-        unit.dirty = true;
+        auto bytes = codec::bincode::to_bytes(state);
+        if(!bytes) {
+            return std::nullopt;
+        }
+        return std::move(*bytes);
+    }
 
-        for(auto& dep: unit.dependents) {
-            update(dep);
+    /// Restores hashes saved by save_state(). Units found there are
+    /// rechecked instead of rebuilt on their next compile; update() what
+    /// changed since. Returns false, changing nothing, on malformed input.
+    bool load_state(std::span<const std::byte> bytes) {
+        auto state = codec::bincode::from_bytes<saved_state>(bytes);
+        if(!state) {
+            return false;
         }
+
+        for(auto& saved: state->units) {
+            auto id = graph_.find(saved.name);
+            if(!id) {
+                continue;
+            }
+            auto& unit = units_[*id];
+            if(unit.status != unit_status::clean && !unit.compiling) {
+                unit.status = unit_status::check;
+                unit.output_hash = saved.output;
+                unit.inputs_hash = saved.inputs;
+            }
+        }
+        return true;
     }
 
 private:
-    task<bool> compile_impl(const std::string& name, event_loop& loop) {
-        auto it = units_.find(name);
-        if(it == units_.end()) {
-            co_return false;
+    /// dirty: edited, or never built. check: something it depends on was
+    /// edited, so it is rebuilt only if a dependency's output changed.
+    enum class unit_status : std::uint8_t { dirty, check, clean };
+
+    struct saved_unit {
+        std::string name;
+        std::uint64_t output = 0;
+        std::uint64_t inputs = 0;
+    };
+
+    struct saved_state {
+        std::vector<saved_unit> units;
+    };
+
+    struct unit_state {
+        unit_status status = unit_status::dirty;
+        bool compiling = false;
+        bool rebuilt = false;
+        std::uint64_t revision = 0;
+
+        /// Output of the last build, and the combined outputs of the
+        /// dependencies it was built against.
+        std::uint64_t output_hash = 0;
+        std::uint64_t inputs_hash = 0;
+
+        /// Cancels the compilation in flight; replaced in place once used.
+        std::optional<cancellation_source> source{std::in_place};
+        std::unique_ptr<event> completion;
+    };
+
+    task_graph::node_id unit_id(const std::string& name) {
+        auto id = graph_.add_node(name);
+        if(id == units_.size()) {
+            units_.emplace_back();
         }
+        return id;
+    }
 
-        auto& unit = it->second;
+    bool prepare() {
+        return !graph_.freeze();
+    }
+
+    static std::uint64_t default_output(const std::string& name, std::uint64_t revision) {
+        return std::hash<std::string>{}(name) ^ (revision * 0x9e3779b97f4a7c15ULL);
+    }
+
+    /// Walks the dependents with an explicit stack, visiting each once, so
+    /// deep or wide graphs neither recurse nor repeat work.
+    void invalidate(task_graph::node_id id) {
+        units_[id].status = unit_status::dirty;
+        units_[id].revision += 1;
+
+        std::vector<bool> seen(units_.size());
+        std::vector<task_graph::node_id> stack{id};
+        seen[id] = true;
+        while(!stack.empty()) {
+            auto current = stack.back();
+            stack.pop_back();
+
+            auto& unit = units_[current];
+            unit.source.reset();
+            unit.source.emplace();
+            if(unit.status == unit_status::clean) {
+                unit.status = unit_status::check;
+            }
 
-        // Already compiled and not dirty
-        if(!unit.dirty) {
+            for(auto dependent: graph_.dependents(current)) {
+                if(!seen[dependent]) {
+                    seen[dependent] = true;
+                    stack.push_back(dependent);
+                }
+            }
+        }
+    }
+
+    /// FNV-1a over the dependencies' output hashes.
+    std::uint64_t inputs_of(task_graph::node_id id) const {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for(auto dep: graph_.dependencies(id)) {
+            hash = (hash ^ units_[dep].output_hash) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    task<bool> compile_impl(task_graph::node_id id, event_loop& loop) {
+        auto& unit = units_[id];
+
+        // Already compiled and up to date
+        if(unit.status == unit_status::clean) {
             co_return true;
         }
 
@@ -79,16 +233,16 @@ private:
         // instead of starting a redundant compilation.
         if(unit.compiling) {
             co_await unit.completion->wait();
-            co_return !unit.dirty;
+            co_return unit.status == unit_status::clean;
         }
 
         unit.compiling = true;
+        unit.rebuilt = false;
         unit.completion = std::make_unique<event>();
 
         // Compile dependencies first, each cancellable via this unit's token
-        for(auto& dep_name: unit.dependencies) {
-            auto dep_result =
-                co_await with_token(compile_impl(dep_name, loop), unit.source->token());
+        for(auto dep: graph_.dependencies(id)) {
+            auto dep_result = co_await with_token(compile_impl(dep, loop), unit.source->token());
             if(!dep_result.has_value() || !*dep_result) {
                 unit.compiling = false;
                 unit.completion->set();
@@ -96,6 +250,15 @@ private:
             }
         }
 
+        // Early cutoff: every dependency came out as it was last time.
+        auto inputs = inputs_of(id);
+        if(unit.status == unit_status::check && inputs == unit.inputs_hash) {
+            unit.status = unit_status::clean;
+            unit.compiling = false;
+            unit.completion->set();
+            co_return true;
+        }
+
         // Simulate compilation work, cancellable via the unit's token
         auto work = [&]() -> task<bool> {
             co_await sleep(compile_delay_(), loop);
@@ -109,14 +272,19 @@ private:
             co_await cancel();
         }
 
-        unit.dirty = false;
+        unit.output_hash = output_(std::string(graph_.name(id)), unit.revision);
+        unit.inputs_hash = inputs;
+        unit.status = unit_status::clean;
+        unit.rebuilt = true;
         unit.compiling = false;
         unit.completion->set();
         co_return true;
     }
 
-    std::map<std::string, CompileUnit> units_;
+    task_graph graph_;
+    std::deque<unit_state> units_;
     delay_fn compile_delay_;
+    output_fn output_;
 };
 
 }  // namespace kota
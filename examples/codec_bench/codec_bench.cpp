@@ -0,0 +1,304 @@
+/// codec_bench.cpp — Measures encoding and decoding through every codec
+/// backend.
+///
+/// Each payload is encoded and decoded through each backend this build has:
+/// simdjson, yyjson (through the content DOM), bincode, TOML, and
+/// flatbuffers. The payloads are the standard cases the backend tests
+/// round-trip, and two LSP messages of the sizes a language server sends:
+/// a publishDiagnostics notification and a workspace/symbol result. The LSP
+/// payloads only run through the JSON backends: their optional fields are
+/// left out when empty, which bincode's positional structs cannot express.
+///
+/// Throughput is the encoded size over the best time of `rounds`, and the
+/// allocation count is the number of operator new calls per operation.
+///
+/// Usage:
+///   ./codec_bench [repeat] [rounds]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "standard_case_suite.h"
+#include "kota/codec/bincode.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/serializer.h"
+#include "kota/ipc/lsp/protocol.h"
+
+#if __has_include(<yyjson.h>)
+#include "kota/codec/json/json.h"
+#define CODEC_BENCH_YYJSON 1
+#endif
+
+#if __has_include(<toml++/toml.hpp>)
+#include "kota/codec/toml.h"
+#define CODEC_BENCH_TOML 1
+#endif
+
+#if __has_include(<flatbuffers/flatbuffers.h>)
+#include "kota/codec/flatbuffers/flatbuffers.h"
+#define CODEC_BENCH_FLATBUFFERS 1
+#endif
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line: GCC flags free() on a pointer it sees come from new.
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+namespace protocol = ipc::protocol;
+
+struct workspace_symbols {
+    std::vector<protocol::SymbolInformation> symbols;
+};
+
+auto make_diagnostics(std::size_t count) -> protocol::PublishDiagnosticsParams {
+    protocol::PublishDiagnosticsParams params;
+    params.uri = "file:///workspace/src/very/long/path/to/translation_unit.cpp";
+    params.version = 42;
+    for(std::size_t i = 0; i < count; ++i) {
+        protocol::Diagnostic diagnostic;
+        const auto line = static_cast<std::uint32_t>(i);
+        diagnostic.range = {
+            .start = {.line = line, .character = 4},
+            .end = {.line = line, .character = 27},
+        };
+        diagnostic.severity = protocol::DiagnosticSeverity::Warning;
+        diagnostic.code = std::string("-Wunused-variable");
+        diagnostic.source = "clang";
+        diagnostic.message = "unused variable 'temporary_" + std::to_string(i) + "'";
+        params.diagnostics.push_back(std::move(diagnostic));
+    }
+    return params;
+}
+
+auto make_symbols(std::size_t count) -> workspace_symbols {
+    workspace_symbols result;
+    for(std::size_t i = 0; i < count; ++i) {
+        protocol::SymbolInformation symbol;
+        const auto line = static_cast<std::uint32_t>(i * 3);
+        symbol.name = "function_" + std::to_string(i);
+        symbol.kind = protocol::SymbolKind::Function;
+        symbol.container_name = "namespace_" + std::to_string(i % 17);
+        symbol.location = {
+            .uri = "file:///workspace/src/module_" + std::to_string(i % 64) + ".cpp",
+            .range = {.start = {.line = line, .character = 0},
+                      .end = {.line = line + 2, .character = 1}},
+        };
+        result.symbols.push_back(std::move(symbol));
+    }
+    return result;
+}
+
+/// A payload repeated `repeat` times, so every backend sees a document large
+/// enough to time. TOML needs a table at the root, hence the wrapper.
+template <typename T>
+struct batch {
+    std::vector<T> items;
+};
+
+/// Some standard cases hold unique_ptr, so each item is made afresh.
+template <typename Make>
+auto make_batch(std::size_t repeat, Make make) -> batch<decltype(make())> {
+    batch<decltype(make())> result;
+    result.items.reserve(repeat);
+    for(std::size_t i = 0; i < repeat; ++i) {
+        result.items.push_back(make());
+    }
+    return result;
+}
+
+struct timing {
+    double ms = 0;
+    double allocations = 0;
+};
+
+/// Best time over `rounds`, with the allocations of one round.
+template <typename Run>
+timing measure(std::size_t rounds, Run&& run) {
+    timing best;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        const auto before = allocations.load(std::memory_order_relaxed);
+        auto start = clock_type::now();
+        bool ok = run();
+        std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+        const auto count = allocations.load(std::memory_order_relaxed) - before;
+        if(!ok) {
+            std::println(stderr, "codec failed");
+            std::exit(1);
+        }
+        if(round == 0 || elapsed.count() < best.ms) {
+            best = {elapsed.count(), static_cast<double>(count)};
+        }
+    }
+    return best;
+}
+
+void report(std::string_view payload,
+            std::string_view backend,
+            std::size_t bytes,
+            const timing& encode,
+            const timing& decode) {
+    const auto mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::println("{:<20} {:<12} {:>10} {:>10.1f} {:>10.1f} {:>10.0f} {:>10.0f}",
+                 payload,
+                 backend,
+                 bytes,
+                 mb / (encode.ms / 1000.0),
+                 mb / (decode.ms / 1000.0),
+                 encode.allocations,
+                 decode.allocations);
+}
+
+/// Encodes and decodes `value` with `encode` and `decode`, where `encode`
+/// returns the encoded bytes as an expected and `decode` reads them back.
+template <typename T, typename Encode, typename Decode>
+void run_backend(std::string_view payload,
+                 std::string_view backend,
+                 std::size_t rounds,
+                 const T& value,
+                 Encode&& encode,
+                 Decode&& decode) {
+    auto encoded = encode(value);
+    if(!encoded) {
+        std::println(stderr, "{} cannot encode {}", backend, payload);
+        return;
+    }
+    auto encoding = measure(rounds, [&] { return encode(value).has_value(); });
+    auto decoding = measure(rounds, [&] { return decode(*encoded); });
+    report(payload, backend, encoded->size(), encoding, decoding);
+}
+
+template <typename T>
+void run_json(std::string_view payload, std::size_t rounds, const T& value) {
+    run_backend(
+        payload,
+        "simdjson",
+        rounds,
+        value,
+        [](const T& input) { return codec::json::to_json(input); },
+        [](const std::string& text) {
+            T output{};
+            return codec::json::from_json(text, output).has_value();
+        });
+
+#ifdef CODEC_BENCH_YYJSON
+    run_backend(
+        payload,
+        "yyjson",
+        rounds,
+        value,
+        [](const T& input) { return codec::json::yy::to_json(input); },
+        [](const std::string& text) {
+            auto dom = codec::json::Value::parse(text);
+            if(!dom) {
+                return false;
+            }
+            T output{};
+            codec::json::yy::Deserializer deserializer(*dom);
+            return codec::deserialize(deserializer, output).has_value() &&
+                   deserializer.finish().has_value();
+        });
+#endif
+}
+
+/// A standard case through every backend.
+template <typename T>
+void run_all(std::string_view payload, std::size_t rounds, const T& value) {
+    run_json(payload, rounds, value);
+
+    run_backend(
+        payload,
+        "bincode",
+        rounds,
+        value,
+        [](const T& input) { return codec::bincode::to_bytes(input); },
+        [](const std::vector<std::byte>& bytes) {
+            return codec::bincode::from_bytes<T>(bytes).has_value();
+        });
+
+#ifdef CODEC_BENCH_TOML
+    run_backend(
+        payload,
+        "toml",
+        rounds,
+        value,
+        [](const T& input) { return codec::toml::to_string(input); },
+        [](const std::string& text) { return codec::toml::parse<T>(text).has_value(); });
+#endif
+
+#ifdef CODEC_BENCH_FLATBUFFERS
+    run_backend(
+        payload,
+        "flatbuffers",
+        rounds,
+        value,
+        [](const T& input) { return codec::flatbuffers::to_flatbuffer(input); },
+        [](const std::vector<std::uint8_t>& bytes) {
+            return codec::flatbuffers::from_flatbuffer<T>(bytes).has_value();
+        });
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t repeat = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+    if(repeat == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [repeat] [rounds]", argv[0]);
+        return 1;
+    }
+
+    std::println("{} items per payload, best of {} rounds", repeat, rounds);
+    std::println("{:<20} {:<12} {:>10} {:>10} {:>10} {:>10} {:>10}",
+                 "payload",
+                 "backend",
+                 "bytes",
+                 "enc MB/s",
+                 "dec MB/s",
+                 "enc alloc",
+                 "dec alloc");
+
+    run_all("scalars", rounds, make_batch(repeat, codec::standard_case::make_scalars));
+    run_all("nested_containers",
+            rounds,
+            make_batch(repeat, codec::standard_case::make_nested_containers));
+    run_all("ultimate", rounds, make_batch(repeat, codec::standard_case::make_ultimate));
+
+    const auto diagnostics = make_diagnostics(repeat);
+    run_json("publishDiagnostics", rounds, diagnostics);
+
+    const auto symbols = make_symbols(repeat);
+    run_json("workspace/symbol", rounds, symbols);
+}
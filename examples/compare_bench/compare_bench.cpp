@@ -0,0 +1,93 @@
+/// compare_bench.cpp — Measures meta::eq on large vectors of LSP ranges.
+///
+/// protocol::Range has no operator==, so meta::eq compares it through
+/// reflection. It is a padding-free struct of integers, so meta::eq
+/// compares a whole std::vector<Range> with one memcmp; this times that
+/// against comparing the same vectors field by field, as meta::eq did
+/// before.
+///
+/// Usage:
+///   ./compare_bench [ranges] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <vector>
+
+#include "kota/meta/compare.h"
+#include "kota/ipc/lsp/protocol.h"
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using protocol_range = ipc::protocol::Range;
+
+bool fieldwise_eq(const std::vector<protocol_range>& lhs, const std::vector<protocol_range>& rhs) {
+    if(lhs.size() != rhs.size()) {
+        return false;
+    }
+    for(std::size_t i = 0; i < lhs.size(); ++i) {
+        const auto& l = lhs[i];
+        const auto& r = rhs[i];
+        if(l.start.line != r.start.line || l.start.character != r.start.character ||
+           l.end.line != r.end.line || l.end.character != r.end.character) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Best time over `rounds`, in microseconds per comparison.
+template <typename Run>
+double measure(std::size_t rounds, Run&& run) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        bool equal = run();
+        std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        if(!equal) {
+            std::println(stderr, "ranges compared unequal");
+            std::exit(1);
+        }
+        best = round == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    if(count == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [ranges] [rounds]", argv[0]);
+        return 1;
+    }
+
+    static_assert(meta::detail::bitwise_eq_comparable<protocol_range>());
+
+    std::vector<protocol_range> lhs(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        const auto line = static_cast<std::uint32_t>(i);
+        lhs[i] = {
+            .start = {.line = line, .character = 4},
+            .end = {.line = line, .character = 27},
+        };
+    }
+    const auto rhs = lhs;
+
+    auto fieldwise = measure(rounds, [&] { return fieldwise_eq(lhs, rhs); });
+    auto bitwise = measure(rounds, [&] { return meta::eq(lhs, rhs); });
+    const auto mb = static_cast<double>(count * sizeof(protocol_range)) / (1024.0 * 1024.0);
+    auto gbps = [&](double us) { return mb / 1024.0 / (us / 1e6); };
+
+    std::println("{} ranges ({:.1f} MB), best of {} rounds", count, mb, rounds);
+    std::println("{:<12} {:>12} {:>12}", "compare", "us", "GB/s");
+    std::println("{:<12} {:>12.1f} {:>12.2f}", "fieldwise", fieldwise, gbps(fieldwise));
+    std::println("{:<12} {:>12.1f} {:>12.2f}", "meta::eq", bitwise, gbps(bitwise));
+}
@@ -0,0 +1,182 @@
+/// cow_string_bench.cpp — Measures promoting short borrowed keys.
+///
+/// A deserializer borrows every key from its input and copies out only
+/// the ones it keeps. Those are mostly short identifiers, so cow_string
+/// keeps an owned string of up to inline_capacity characters inside the
+/// object. This times promoting borrowed keys of a given length with
+/// make_owned(), handing them on to a small_string with release(), copying
+/// them to the heap as make_owned() did before it had inline storage, and
+/// copying them into std::string, and counts operator new calls per key
+/// for each.
+///
+/// Usage:
+///   ./cow_string_bench [keys] [rounds]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/support/cow_string.h"
+#include "kota/support/small_string.h"
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line: GCC flags free() on a pointer it sees come from new.
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct result {
+    double ns_per_key;
+    double allocations_per_key;
+};
+
+/// Best time over `rounds`, and allocations, per key.
+template <typename Run>
+result measure(std::size_t rounds, std::size_t keys, Run&& run) {
+    result best{};
+    for(std::size_t round = 0; round < rounds; ++round) {
+        const auto before = allocations.load(std::memory_order_relaxed);
+        auto start = clock_type::now();
+        std::size_t bytes = run();
+        std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+        const auto allocated = allocations.load(std::memory_order_relaxed) - before;
+        if(bytes == 0) {
+            std::println(stderr, "no keys were copied");
+            std::exit(1);
+        }
+        const auto per_key = elapsed.count() / static_cast<double>(keys);
+        if(round == 0 || per_key < best.ns_per_key) {
+            best.ns_per_key = per_key;
+        }
+        best.allocations_per_key = static_cast<double>(allocated) / static_cast<double>(keys);
+    }
+    return best;
+}
+
+void run(std::size_t length, std::size_t keys, std::size_t rounds) {
+    // Distinct keys in one buffer, borrowed the way a parser borrows them.
+    std::string input;
+    for(std::size_t i = 0; i < keys; ++i) {
+        auto key = "k" + std::to_string(i);
+        key.resize(length, 'x');
+        input += key;
+    }
+    std::vector<std::string_view> borrowed;
+    for(std::size_t i = 0; i < keys; ++i) {
+        borrowed.push_back(std::string_view(input).substr(i * length, length));
+    }
+
+    std::vector<cow_string> promoted(keys);
+    std::vector<small_string<16>> released(keys);
+    std::vector<std::string> copied(keys);
+
+    auto cow = measure(rounds, keys, [&] {
+        std::size_t bytes = 0;
+        for(std::size_t i = 0; i < keys; ++i) {
+            cow_string key{string_ref{borrowed[i]}};
+            key.make_owned();
+            bytes += key.size();
+            promoted[i] = std::move(key);
+        }
+        return bytes;
+    });
+
+    auto handoff = measure(rounds, keys, [&] {
+        std::size_t bytes = 0;
+        for(std::size_t i = 0; i < keys; ++i) {
+            cow_string key{string_ref{borrowed[i]}};
+            key.make_owned();
+            released[i] = key.release<16>();
+            bytes += released[i].size();
+        }
+        return bytes;
+    });
+
+    std::vector<char*> buffers(keys, nullptr);
+    auto heap = measure(rounds, keys, [&] {
+        std::size_t bytes = 0;
+        for(std::size_t i = 0; i < keys; ++i) {
+            auto* buffer = mem::allocate<char>(length);
+            std::memcpy(buffer, borrowed[i].data(), length);
+            if(buffers[i]) {
+                mem::deallocate(buffers[i], length);
+            }
+            buffers[i] = buffer;
+            bytes += length;
+        }
+        return bytes;
+    });
+    for(auto* buffer: buffers) {
+        mem::deallocate(buffer, length);
+    }
+
+    auto string = measure(rounds, keys, [&] {
+        std::size_t bytes = 0;
+        for(std::size_t i = 0; i < keys; ++i) {
+            copied[i] = std::string(borrowed[i]);
+            bytes += copied[i].size();
+        }
+        return bytes;
+    });
+
+    std::println("{:>3} bytes | make_owned {:6.2f} ns {:4.2f} allocs | release<16> {:6.2f} ns "
+                 "{:4.2f} allocs | heap copy {:6.2f} ns {:4.2f} allocs | std::string {:6.2f} ns "
+                 "{:4.2f} allocs",
+                 length,
+                 cow.ns_per_key,
+                 cow.allocations_per_key,
+                 handoff.ns_per_key,
+                 handoff.allocations_per_key,
+                 heap.ns_per_key,
+                 heap.allocations_per_key,
+                 string.ns_per_key,
+                 string.allocations_per_key);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    if(keys == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [keys] [rounds]", argv[0]);
+        return 1;
+    }
+
+    std::println("inline capacity: {} bytes", cow_string::inline_capacity);
+    for(std::size_t length: {4, 8, 12, 16, 24, 48}) {
+        run(length, keys, rounds);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/// enum_bench.cpp — Measures enum name and value lookup.
+///
+/// meta::enum_name() reads a value's position from a table indexed by the
+/// value, and meta::enum_value() finds a name through a perfect hash built
+/// at compile time. Both are timed against what they replaced, a binary
+/// search of member_values and a scan of member_names, on the LSP enums
+/// decoded on nearly every message.
+///
+/// Usage:
+///   ./enum_bench [lookups] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "kota/meta/enum.h"
+#include "kota/ipc/lsp/protocol.h"
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename E>
+std::string_view name_by_search(E e) {
+    using U = std::underlying_type_t<E>;
+    const auto& values = meta::reflection<E>::member_values;
+    auto it = std::ranges::lower_bound(values, static_cast<U>(e), std::ranges::less{}, [](E v) {
+        return static_cast<U>(v);
+    });
+    if(it == values.end() || *it != e) {
+        return {};
+    }
+    return meta::reflection<E>::member_names[static_cast<std::size_t>(it - values.begin())];
+}
+
+template <typename E>
+std::optional<E> value_by_scan(std::string_view name) {
+    const auto& names = meta::reflection<E>::member_names;
+    for(std::size_t index = 0; index < names.size(); ++index) {
+        if(names[index] == name) {
+            return meta::reflection<E>::member_values[index];
+        }
+    }
+    return std::nullopt;
+}
+
+/// Best time over `rounds`, in nanoseconds per lookup.
+template <typename Run>
+double measure(std::size_t rounds, std::size_t lookups, Run&& run) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        std::size_t found = run();
+        std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+        if(found != lookups) {
+            std::println(stderr, "lookup failed");
+            std::exit(1);
+        }
+        const auto per_lookup = elapsed.count() / static_cast<double>(lookups);
+        best = round == 0 ? per_lookup : std::min(best, per_lookup);
+    }
+    return best;
+}
+
+template <typename E>
+void run(std::string_view label, std::size_t lookups, std::size_t rounds) {
+    const auto& members = meta::reflection<E>::member_values;
+    std::vector<E> values;
+    std::vector<std::string_view> names;
+    for(std::size_t i = 0; i < lookups; ++i) {
+        // A fixed stride keeps the order from being predictable.
+        values.push_back(members[(i * 7) % members.size()]);
+        names.push_back(meta::enum_name(values.back()));
+    }
+
+    auto count_names = [&](auto lookup) {
+        std::size_t found = 0;
+        for(auto value: values) {
+            found += !lookup(value).empty();
+        }
+        return found;
+    };
+    auto count_values = [&](auto lookup) {
+        std::size_t found = 0;
+        for(auto name: names) {
+            found += lookup(name).has_value();
+        }
+        return found;
+    };
+
+    auto searched = measure(rounds, lookups, [&] { return count_names(name_by_search<E>); });
+    auto indexed = measure(rounds, lookups, [&] {
+        return count_names([](E e) { return meta::enum_name(e); });
+    });
+    auto scanned = measure(rounds, lookups, [&] { return count_values(value_by_scan<E>); });
+    auto hashed = measure(rounds, lookups, [&] { return count_values(meta::enum_value<E>); });
+
+    std::println("{:<20} {:>3} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}",
+                 label,
+                 members.size(),
+                 searched,
+                 indexed,
+                 scanned,
+                 hashed);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t lookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(lookups == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [lookups] [rounds]", argv[0]);
+        return 1;
+    }
+
+    std::println("{} lookups, best of {} rounds, ns per lookup", lookups, rounds);
+    std::println("{:<20} {:>3} {:>10} {:>10} {:>10} {:>10}",
+                 "enum",
+                 "n",
+                 "name/bsrch",
+                 "name/table",
+                 "value/scan",
+                 "value/hash");
+    run<ipc::protocol::SymbolKind>("SymbolKind", lookups, rounds);
+    run<ipc::protocol::CompletionItemKind>("CompletionItemKind", lookups, rounds);
+    run<ipc::protocol::DiagnosticSeverity>("DiagnosticSeverity", lookups, rounds);
+    run<ipc::protocol::TextDocumentSyncKind>("TextDocumentSyncKind", lookups, rounds);
+}
@@ -0,0 +1,117 @@
+/// escape_bench.cpp — Measures JSON string escaping throughput.
+///
+/// Each input is serialized as a JSON string, once through a byte-by-byte
+/// escaper and once through json::escape_string(), and then once more as a
+/// whole document through json::to_json(). The inputs are the shapes that
+/// dominate LSP traffic: plain ASCII source text, UTF-8 text, and text dense
+/// with quotes and newlines.
+///
+/// Usage:
+///   ./escape_bench [bytes per input] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "kota/codec/json/escape.h"
+#include "kota/codec/json/serializer.h"
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void escape_bytewise(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for(unsigned char c: text) {
+        char storage[6];
+        if(c < 0x20 || c == '"' || c == '\\') {
+            out.append(codec::json::escape_sequence(c, storage));
+        } else {
+            out.push_back(static_cast<char>(c));
+        }
+    }
+    out.push_back('"');
+}
+
+void escape_scanning(std::string& out, std::string_view text) {
+    out.push_back('"');
+    codec::json::escape_string(text, [&](std::string_view part) { out.append(part); });
+    out.push_back('"');
+}
+
+std::string repeat(std::string_view pattern, std::size_t bytes) {
+    std::string text;
+    text.reserve(bytes + pattern.size());
+    while(text.size() < bytes) {
+        text.append(pattern);
+    }
+    return text;
+}
+
+/// Best throughput over `rounds`, in MB/s of input.
+template <typename Run>
+double measure(std::string_view text, std::size_t rounds, Run&& run) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        auto written = run(text);
+        std::chrono::duration<double> elapsed = clock_type::now() - start;
+        if(written < text.size()) {
+            std::println(stderr, "benchmark lost output: {} < {}", written, text.size());
+            std::exit(1);
+        }
+        best = std::max(best, static_cast<double>(text.size()) / elapsed.count() / 1e6);
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16 * 1024 * 1024;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(bytes == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [bytes per input] [rounds]", argv[0]);
+        return 1;
+    }
+
+    struct input {
+        std::string_view name;
+        std::string text;
+    };
+    const input inputs[] = {
+        {"ascii", repeat("    for(auto item: items) { total += item.size(); }  ", bytes)},
+        {"utf-8", repeat("    // 注释: コメント — κείμενο, текст; ", bytes)},
+        {"escape-heavy", repeat("\tprintf(\"%s\\n\", name);\n", bytes)},
+    };
+
+    std::string out;
+    std::println("{} bytes per input, best of {} rounds (MB/s of input)", bytes, rounds);
+    for(const auto& [name, text]: inputs) {
+        auto bytewise = measure(text, rounds, [&](std::string_view s) {
+            out.clear();
+            escape_bytewise(out, s);
+            return out.size();
+        });
+        auto scanning = measure(text, rounds, [&](std::string_view s) {
+            out.clear();
+            escape_scanning(out, s);
+            return out.size();
+        });
+        auto serializer = measure(text, rounds, [&](std::string_view s) {
+            auto json = codec::json::to_json(s);
+            return json ? json->size() : 0;
+        });
+        std::println("{:<13} byte-by-byte {:8.0f}   escape_string {:8.0f}   to_json {:8.0f}",
+                     name,
+                     bytewise,
+                     scanning,
+                     serializer);
+    }
+}
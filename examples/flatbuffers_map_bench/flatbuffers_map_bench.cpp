@@ -0,0 +1,93 @@
+/// flatbuffers_map_bench.cpp — Measures encoding maps with large values.
+///
+/// A FlatBuffers map is a vector of key/value tables sorted by key. The
+/// inputs are an std::unordered_map, whose entries have to be put in order
+/// first, and an std::map, whose entries already are, both holding values
+/// that are expensive to copy.
+///
+/// Usage:
+///   ./flatbuffers_map_bench [entries] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <print>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kota/codec/flatbuffers/serializer.h"
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct symbol {
+    std::string name;
+    std::string detail;
+    std::vector<std::int32_t> references;
+    std::uint32_t kind = 0;
+};
+
+template <typename Map>
+struct index_payload {
+    Map symbols;
+};
+
+template <typename Map>
+Map make_symbols(std::size_t entries) {
+    Map symbols;
+    for(std::size_t i = 0; i < entries; ++i) {
+        auto key = "symbol_" + std::to_string(i * 7919 % entries);
+        symbols.emplace(key,
+                        symbol{
+                            .name = key,
+                            .detail = std::string(96, 'd'),
+                            .references = std::vector<std::int32_t>(64, static_cast<int>(i)),
+                            .kind = static_cast<std::uint32_t>(i % 26),
+                        });
+    }
+    return symbols;
+}
+
+/// Best time over `rounds`, in microseconds per encoded map.
+template <typename Map>
+double measure(const Map& symbols, std::size_t rounds) {
+    const index_payload<Map> payload{symbols};
+    codec::flatbuffers::Serializer<> serializer;
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        auto encoded = serializer.bytes(payload);
+        std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        if(!encoded) {
+            std::println(stderr, "encoding failed");
+            std::exit(1);
+        }
+        best = round == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    if(entries == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [entries] [rounds]", argv[0]);
+        return 1;
+    }
+
+    auto unordered = make_symbols<std::unordered_map<std::string, symbol>>(entries);
+    auto ordered = make_symbols<std::map<std::string, symbol>>(entries);
+
+    std::println("{} entries, best of {} rounds", entries, rounds);
+    std::println("unordered_map {:10.0f} us", measure(unordered, rounds));
+    std::println("map           {:10.0f} us", measure(ordered, rounds));
+}
@@ -0,0 +1,188 @@
+/// option_bench.cpp — Measures OptTable argument matching on a large table.
+///
+/// OptTable resolves each argument by walking a trie of option spellings
+/// built with the table, instead of running a prefix match against every
+/// entry. The table here is synthetic but shaped like clang's: about three
+/// thousand -f/-fno-/-W/-Wno-/-m options plus joined and separate ones. It
+/// parses the same command lines with an unsorted (longest match) table and
+/// a TableGen-sorted one, and times a scan of all entries, the matching
+/// cost each argument paid before, next to them.
+///
+/// Usage:
+///   ./option_bench [commands] [rounds]
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/option/option.h"
+
+using namespace kota::option;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::string_view families[] = {"f", "fno-", "W", "Wno-", "m", "mno-"};
+constexpr std::size_t words_per_family = 500;
+
+struct Table {
+    std::deque<std::string> spellings;
+    std::vector<OptTable::Info> infos;
+};
+
+std::string word(std::size_t index) {
+    constexpr std::string_view syllables[] = {"al", "bo", "ce", "di", "en", "fu", "ga", "hi"};
+    std::string text;
+    for(auto n = index + 8; n != 0; n /= 8) {
+        text += syllables[n % 8];
+    }
+    return text;
+}
+
+/// Same order as TableGen: case-insensitive, with an option placed after
+/// any longer option it prefixes.
+bool tablegen_less(const OptTable::Info& lhs, const OptTable::Info& rhs) {
+    auto a = lhs.name();
+    auto b = rhs.name();
+    auto size = std::min(a.size(), b.size());
+    for(std::size_t i = 0; i < size; ++i) {
+        auto x = std::tolower(static_cast<unsigned char>(a[i]));
+        auto y = std::tolower(static_cast<unsigned char>(b[i]));
+        if(x != y) {
+            return x < y;
+        }
+    }
+    return a.size() > b.size();
+}
+
+Table make_table(bool sorted) {
+    Table table;
+    auto add = [&](std::string spelling, unsigned char kind) {
+        table.spellings.push_back(std::move(spelling));
+        auto id = static_cast<unsigned>(table.infos.size() + 1);
+        table.infos.push_back(
+            OptTable::Info::unaliased_one(pfx_dash, table.spellings.back(), id, kind, 1));
+    };
+
+    table.infos.push_back(OptTable::Info::input(1));
+    table.infos.push_back(OptTable::Info::unknown(2));
+    for(auto family: families) {
+        for(std::size_t i = 0; i < words_per_family; ++i) {
+            add(std::format("-{}{}", family, word(i)), Option::FlagClass);
+        }
+    }
+    add("-I", Option::JoinedOrSeparateClass);
+    add("-D", Option::JoinedOrSeparateClass);
+    add("-std=", Option::JoinedClass);
+    add("-o", Option::JoinedOrSeparateClass);
+
+    if(sorted) {
+        std::stable_sort(table.infos.begin() + 2, table.infos.end(), tablegen_less);
+        for(std::size_t i = 0; i < table.infos.size(); ++i) {
+            table.infos[i].id = static_cast<unsigned>(i + 1);
+        }
+    }
+    return table;
+}
+
+std::vector<std::vector<std::string>> make_commands(std::size_t count) {
+    std::vector<std::vector<std::string>> commands;
+    for(std::size_t i = 0; i < count; ++i) {
+        // One flag the table does not know, as compilation databases often
+        // carry flags of another compiler.
+        std::vector<std::string> argv = {"-std=c++20", "-Iinclude", "-DNDEBUG", "-Qunknown"};
+        for(std::size_t k = 0; k < 12; ++k) {
+            // A fixed stride keeps the order from being predictable.
+            auto n = (i * 12 + k) * 7919;
+            argv.push_back(std::format("-{}{}", families[n % 6], word(n % words_per_family)));
+        }
+        argv.push_back(std::format("src/file{}.cpp", i));
+        argv.push_back("-o");
+        argv.push_back(std::format("file{}.o", i));
+        commands.push_back(std::move(argv));
+    }
+    return commands;
+}
+
+/// How each argument was matched before: a prefix test against every entry.
+std::size_t scan_all(const Table& table, const std::vector<std::vector<std::string>>& commands) {
+    std::size_t matched = 0;
+    for(const auto& argv: commands) {
+        for(std::string_view arg: argv) {
+            for(const auto& info: table.infos) {
+                if(!info.has_no_prefix() && arg.starts_with(info.prefixed_name())) {
+                    matched += 1;
+                    break;
+                }
+            }
+        }
+    }
+    return matched;
+}
+
+/// Best time over `rounds`, in nanoseconds per argument.
+template <typename Run>
+double measure(std::size_t rounds, std::size_t arguments, Run&& run) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        std::size_t parsed = run();
+        std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+        if(parsed == 0) {
+            std::println(stderr, "nothing parsed");
+            std::exit(1);
+        }
+        const auto per_argument = elapsed.count() / static_cast<double>(arguments);
+        best = round == 0 ? per_argument : std::min(best, per_argument);
+    }
+    return best;
+}
+
+void run(std::string_view label, bool sorted, std::size_t count, std::size_t rounds) {
+    auto table = make_table(sorted);
+    auto opt_table = OptTable(table.infos).set_tablegen_mode(sorted);
+    auto commands = make_commands(count);
+    std::size_t arguments = 0;
+    for(const auto& argv: commands) {
+        arguments += argv.size();
+    }
+
+    auto scanned = measure(rounds, arguments, [&] { return scan_all(table, commands); });
+    auto parsed = measure(rounds, arguments, [&] {
+        std::vector<OptTable::InputArgv> spans(commands.begin(), commands.end());
+        ParsedBatch batch;
+        opt_table.parse_batch(spans, batch);
+        std::size_t known = 0;
+        for(const auto& arg: batch.arguments()) {
+            known += arg.option_id.id() != 2;
+        }
+        return known;
+    });
+
+    std::println("{:<10} {:>6} {:>12.1f} {:>12.1f}", label, table.infos.size(), scanned, parsed);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t commands = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(commands == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [commands] [rounds]", argv[0]);
+        return 1;
+    }
+
+    std::println("{} command lines, best of {} rounds, ns per argument", commands, rounds);
+    std::println("{:<10} {:>6} {:>12} {:>12}", "table", "n", "scan", "parse");
+    run("unsorted", false, commands, rounds);
+    run("tablegen", true, commands, rounds);
+}
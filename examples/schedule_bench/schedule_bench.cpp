@@ -0,0 +1,89 @@
+/// schedule_bench.cpp — Measures event_loop ready-queue throughput.
+///
+/// Two workloads, both dominated by event_loop::schedule() and the idle-tick
+/// drain of the ready queue:
+///
+///   fan-out   schedule N trivial root tasks up front, then run the loop.
+///   cascade   each task schedules its successor before finishing, so the
+///             queue is refilled from inside a tick N times in a row.
+///
+/// Usage:
+///   ./schedule_bench [tasks] [rounds]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+
+#include "kota/async/async.h"
+
+using namespace kota;
+
+namespace {
+
+std::size_t completed = 0;
+
+task<> trivial() {
+    completed += 1;
+    co_return;
+}
+
+task<> cascade(event_loop& loop, std::size_t remaining) {
+    completed += 1;
+    if(remaining > 1) {
+        loop.schedule(cascade(loop, remaining - 1));
+    }
+    co_return;
+}
+
+template <typename Fn>
+double measure(std::size_t tasks, std::size_t rounds, Fn&& fn) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        completed = 0;
+        event_loop loop;
+
+        auto start = std::chrono::steady_clock::now();
+        fn(loop, tasks);
+        loop.run();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if(completed != tasks) {
+            std::println(stderr, "expected {} completions, got {}", tasks, completed);
+            std::exit(1);
+        }
+
+        auto seconds = std::chrono::duration<double>(elapsed).count();
+        auto rate = static_cast<double>(tasks) / seconds;
+        if(rate > best) {
+            best = rate;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(tasks == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [tasks] [rounds]", argv[0]);
+        return 1;
+    }
+
+    auto fan_out = measure(tasks, rounds, [](event_loop& loop, std::size_t count) {
+        for(std::size_t i = 0; i < count; ++i) {
+            loop.schedule(trivial());
+        }
+    });
+
+    auto chained = measure(tasks, rounds, [](event_loop& loop, std::size_t count) {
+        loop.schedule(cascade(loop, count));
+    });
+
+    std::println("tasks per round: {}, best of {} rounds", tasks, rounds);
+    std::println("fan-out: {:.0f} schedules/sec", fan_out);
+    std::println("cascade: {:.0f} schedules/sec", chained);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/// toml_parse_bench.cpp — Measures decoding a large TOML manifest.
+///
+/// toml++ parses the text into a ::toml::table, and the struct is then
+/// read out of it. The manifest is decoded three ways: the table alone, to
+/// show what building the tree costs; the table read with from_toml(),
+/// which copies every string out of it; and toml::parse(), which hands its
+/// table over and moves strings out instead.
+///
+/// Usage:
+///   ./toml_parse_bench [packages] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "kota/codec/toml.h"
+
+using namespace kota;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct package_entry {
+    std::string name;
+    std::string version;
+    std::string description;
+    std::vector<std::string> dependencies;
+    std::int64_t downloads = 0;
+};
+
+struct manifest {
+    std::string name;
+    std::vector<package_entry> package;
+};
+
+std::string make_manifest(std::size_t packages) {
+    std::string text = "name = \"generated\"\n";
+    for(std::size_t i = 0; i < packages; ++i) {
+        text += std::format("\n[[package]]\nname = \"package_{}\"\nversion = \"1.{}.0\"\n", i, i);
+        text += std::format("description = \"{}\"\n", std::string(120, 'd'));
+        text += std::format("dependencies = [\"dep_{}\", \"dep_{}\"]\n", i, i + 1);
+        text += std::format("downloads = {}\n", i * 31);
+    }
+    return text;
+}
+
+/// Best time over `rounds`, in milliseconds.
+template <typename Run>
+double measure(std::size_t rounds, Run&& run) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        auto start = clock_type::now();
+        bool ok = run();
+        std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+        if(!ok) {
+            std::println(stderr, "decoding failed");
+            std::exit(1);
+        }
+        best = round == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t packages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(packages == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [packages] [rounds]", argv[0]);
+        return 1;
+    }
+
+    const auto text = make_manifest(packages);
+    auto tree = measure(rounds, [&] { return codec::toml::parse_table(text).has_value(); });
+    auto copying = measure(rounds, [&] {
+        auto table = codec::toml::parse_table(text);
+        return table && codec::toml::from_toml<manifest>(*table).has_value();
+    });
+    auto moving = measure(rounds, [&] { return codec::toml::parse<manifest>(text).has_value(); });
+
+    std::println("{} packages, {} bytes, best of {} rounds", packages, text.size(), rounds);
+    std::println("parse_table only        {:8.1f} ms", tree);
+    std::println("parse_table + from_toml {:8.1f} ms", copying);
+    std::println("parse                   {:8.1f} ms", moving);
+}
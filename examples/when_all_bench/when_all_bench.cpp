@@ -0,0 +1,104 @@
+/// when_all_bench.cpp — Measures when_all over children that are already done.
+///
+/// Each iteration awaits when_all of `width` tasks that complete during their
+/// first resume, the shape of a batch of cache hits. Such an aggregate
+/// settles while it is still arming and hands control straight back to the
+/// awaiter, so the numbers reflect aggregate setup and child bookkeeping
+/// rather than event loop round trips.
+///
+/// Usage:
+///   ./when_all_bench [iterations] [rounds]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+
+#include "kota/async/async.h"
+
+using namespace kota;
+
+namespace {
+
+std::size_t checksum = 0;
+
+task<std::size_t> hit(std::size_t value) {
+    co_return value;
+}
+
+task<> fixed_width(std::size_t iterations) {
+    for(std::size_t i = 0; i < iterations; ++i) {
+        auto [value] = co_await when_all(hit(i));
+        checksum += value;
+    }
+}
+
+task<> fixed_width_8(std::size_t iterations) {
+    for(std::size_t i = 0; i < iterations; ++i) {
+        auto [a, b, c, d, e, f, g, h] =
+            co_await when_all(hit(i), hit(i), hit(i), hit(i), hit(i), hit(i), hit(i), hit(i));
+        checksum += a + b + c + d + e + f + g + h;
+    }
+}
+
+task<> range_width(std::size_t iterations, std::size_t width) {
+    for(std::size_t i = 0; i < iterations; ++i) {
+        small_vector<task<std::size_t>> children;
+        children.reserve(width);
+        for(std::size_t j = 0; j < width; ++j) {
+            children.emplace_back(hit(j));
+        }
+        auto values = co_await when_all(std::move(children));
+        checksum += values.size();
+    }
+}
+
+template <typename Fn>
+double measure(std::size_t iterations, std::size_t rounds, Fn&& make) {
+    double best = 0;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        checksum = 0;
+        event_loop loop;
+
+        auto start = std::chrono::steady_clock::now();
+        auto driver = make(iterations);
+        loop.schedule(driver);
+        loop.run();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if(checksum == 0) {
+            std::println(stderr, "benchmark produced no results");
+            std::exit(1);
+        }
+
+        auto seconds = std::chrono::duration<double>(elapsed).count();
+        auto rate = static_cast<double>(iterations) / seconds;
+        if(rate > best) {
+            best = rate;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if(iterations == 0 || rounds == 0) {
+        std::println(stderr, "usage: {} [iterations] [rounds]", argv[0]);
+        return 1;
+    }
+
+    auto one = measure(iterations, rounds, [](std::size_t n) { return fixed_width(n); });
+    auto eight = measure(iterations, rounds, [](std::size_t n) { return fixed_width_8(n); });
+    auto range_eight = measure(iterations, rounds, [](std::size_t n) { return range_width(n, 8); });
+    auto range_64 = measure(iterations, rounds, [](std::size_t n) { return range_width(n, 64); });
+
+    std::println("iterations per round: {}, best of {} rounds", iterations, rounds);
+    std::println("when_all(1 task):      {:.0f} awaits/sec", one);
+    std::println("when_all(8 tasks):     {:.0f} awaits/sec", eight);
+    std::println("when_all(range of 8):  {:.0f} awaits/sec", range_eight);
+    std::println("when_all(range of 64): {:.0f} awaits/sec", range_64);
+    return 0;
+}
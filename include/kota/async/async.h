@@ -1,17 +1,32 @@
 #pragma once
 
 #include "kota/support/config.h"
+#include "kota/async/io/deadline.h"
+#include "kota/async/io/file.h"
 #include "kota/async/io/fs.h"
 #include "kota/async/io/fs_event.h"
 #include "kota/async/io/loop.h"
+#include "kota/async/io/loop_group.h"
+#include "kota/async/io/parallel.h"
 #include "kota/async/io/process.h"
+#include "kota/async/io/process_monitor.h"
+#include "kota/async/io/process_pool.h"
+#include "kota/async/io/profiler.h"
 #include "kota/async/io/request.h"
+#include "kota/async/io/resolver.h"
 #include "kota/async/io/stream.h"
+#include "kota/async/io/tcp_pool.h"
+#include "kota/async/io/thread_pool.h"
+#include "kota/async/io/tree_watcher.h"
 #include "kota/async/io/udp.h"
 #include "kota/async/io/watcher.h"
+#include "kota/async/runtime/atomic_sync.h"
+#include "kota/async/runtime/channel.h"
 #include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/generator.h"
 #include "kota/async/runtime/sync.h"
 #include "kota/async/runtime/task.h"
+#include "kota/async/runtime/task_graph.h"
 #include "kota/async/runtime/when.h"
 #include "kota/async/vocab/awaitable.h"
 #include "kota/async/vocab/cancellation.h"
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/cancellation.h"
+
+namespace kota {
+
+/// Suspends for `timeout` on the loop's timer wheel.
+///
+/// Unlike sleep(), which starts a uv timer per call, every after() on a loop
+/// shares one wheel and one uv timer, so arming and cancelling are O(1) and
+/// touch no handles. Resolution is one millisecond; timers expiring in the
+/// same millisecond complete in the order they were armed.
+task<> after(std::chrono::milliseconds timeout, event_loop& loop = event_loop::current());
+
+inline task<> after(int ms, event_loop& loop = event_loop::current()) {
+    return after(std::chrono::milliseconds{ms}, loop);
+}
+
+/// A cancellation source that fires itself after a timeout.
+///
+/// Intended for per-request timeouts: construct one next to the operation,
+/// hand its token() to with_token(), and let it go out of scope. It is a thin
+/// wrapper over cancellation_source::cancel_after(), so thousands of live
+/// deadlines still cost one uv timer.
+///
+/// Usage:
+///   deadline timeout(std::chrono::seconds(5));
+///   auto response = co_await with_token(fetch(request), timeout.token());
+///   if(timeout.expired()) { ... }
+///
+/// NOT thread-safe: must be created and used on the loop thread.
+class deadline {
+public:
+    explicit deadline(std::chrono::milliseconds timeout,
+                      event_loop& loop = event_loop::current()) noexcept : loop(&loop) {
+        source.cancel_after(timeout, loop);
+    }
+
+    deadline(const deadline&) = delete;
+    deadline& operator=(const deadline&) = delete;
+
+    cancellation_token token() const noexcept {
+        return source.token();
+    }
+
+    /// True once the timeout has fired and cancelled the token.
+    bool expired() const noexcept {
+        return source.cancelled();
+    }
+
+    /// Stops the countdown. The token is still cancelled when the deadline
+    /// is destroyed, like any cancellation_source.
+    void disarm() noexcept {
+        source.clear_timeout();
+    }
+
+    /// Restarts the countdown at `timeout` from now. No effect once expired.
+    void rearm(std::chrono::milliseconds timeout) noexcept {
+        source.cancel_after(timeout, *loop);
+    }
+
+private:
+    cancellation_source source;
+    event_loop* loop;
+};
+
+}  // namespace kota
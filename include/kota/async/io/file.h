@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota::fs {
+
+/// A file descriptor with a read buffer and a write buffer in front of it,
+/// so that many small reads and writes become a few large threadpool jobs
+/// instead of one job each.
+///
+/// Reads are served from the read buffer where they can be. On a miss the
+/// buffer is refilled from the missing offset; reads that keep continuing
+/// where the previous one ended double the refill size, up to
+/// options::max_readahead, and any other read starts over at
+/// options::buffer_size. A read at least as large as the refill goes
+/// straight into the caller's buffer.
+///
+/// Writes at the offset where the buffered ones end are appended to the
+/// write buffer, which goes out in one write once it is full, when a write
+/// elsewhere or any read needs it out of the way, or on flush(). Data is only
+/// durable after sync().
+///
+/// read()/write() use and advance position(); pread()/pwrite() take an
+/// offset and leave it alone. Only one operation may be in flight at a time,
+/// the file must not be moved while one is, and it is used on its loop's
+/// thread only.
+class async_file {
+public:
+    struct options {
+        /// Write buffer size, and the first refill of the read buffer.
+        std::size_t buffer_size;
+
+        /// Largest refill sequential reads grow to.
+        std::size_t max_readahead;
+
+        constexpr options(std::size_t buffer_size = 64 * 1024,
+                          std::size_t max_readahead = 1024 * 1024) :
+            buffer_size(buffer_size), max_readahead(max_readahead) {}
+    };
+
+    async_file() = default;
+
+    /// Takes ownership of an open descriptor.
+    explicit async_file(int fd,
+                        options opts = {},
+                        event_loop& loop = event_loop::current()) noexcept;
+
+    async_file(const async_file&) = delete;
+    async_file& operator=(const async_file&) = delete;
+
+    async_file(async_file&& other) noexcept;
+    async_file& operator=(async_file&& other) noexcept;
+
+    /// Closes the descriptor synchronously. Buffered writes that were not
+    /// flushed are lost; call close() to keep them.
+    ~async_file();
+
+    /// Opens `path` with UV_FS_O_* `flags`, see fs::open().
+    static task<async_file, error> open(std::string_view path,
+                                        int flags,
+                                        int mode = 0,
+                                        options opts = {},
+                                        event_loop& loop = event_loop::current());
+
+    bool is_open() const noexcept {
+        return fd >= 0;
+    }
+
+    int native_handle() const noexcept {
+        return fd;
+    }
+
+    std::int64_t position() const noexcept {
+        return cursor;
+    }
+
+    /// Moves the position used by read() and write().
+    void seek(std::int64_t offset) noexcept {
+        cursor = offset;
+    }
+
+    /// Reads up to `out.size()` bytes at position() and advances it. Returns
+    /// 0 at end of file.
+    task<std::size_t, error> read(std::span<char> out);
+
+    /// Reads up to `out.size()` bytes at `offset`.
+    task<std::size_t, error> pread(std::span<char> out, std::int64_t offset);
+
+    /// Reads the next line at position() into `line`, without its '\n', and
+    /// advances past it. Returns false at end of file; a last line without a
+    /// newline is still returned.
+    task<bool, error> read_line(std::string& line);
+
+    /// Buffers `data` for writing at position() and advances it.
+    task<void, error> write(std::span<const char> data);
+
+    /// Buffers `data` for writing at `offset`.
+    task<void, error> pwrite(std::span<const char> data, std::int64_t offset);
+
+    /// Writes out everything buffered.
+    task<void, error> flush();
+
+    /// Flushes, then asks the system to make the file durable: fdatasync()
+    /// when `data_only`, fsync() otherwise.
+    task<void, error> sync(bool data_only = false);
+
+    /// Flushes and closes the descriptor. The descriptor is closed even if
+    /// the flush fails; its error is reported.
+    task<void, error> close();
+
+private:
+    /// The buffered bytes from `offset` on; empty on a miss.
+    std::span<const char> buffered(std::int64_t offset) const noexcept;
+
+    /// Size of the refill for a miss at `offset`: doubled while reads are
+    /// sequential, back to options::buffer_size otherwise.
+    std::size_t next_refill(std::int64_t offset) noexcept;
+
+    /// Reads up to `size` bytes at `offset` into the read buffer. Returns
+    /// how many it got; 0 at end of file.
+    task<std::size_t, error> refill(std::int64_t offset, std::size_t size);
+
+    /// Writes all of `data` at `offset`, looping over short writes.
+    task<void, error> write_all(std::span<const char> data, std::int64_t offset);
+
+    /// Forgets the read buffer if it overlaps [offset, offset + size).
+    void drop_read_buffer(std::int64_t offset, std::size_t size) noexcept;
+
+    int fd = -1;
+    event_loop* loop = nullptr;
+    options opts;
+
+    std::int64_t cursor = 0;
+
+    // File bytes [read_offset, read_offset + read_size) are in read_buffer.
+    std::vector<char> read_buffer;
+    std::int64_t read_offset = 0;
+    std::size_t read_size = 0;
+
+    // Where a read continuing the previous one would start, and the size
+    // of the next refill.
+    std::int64_t sequential_offset = -1;
+    std::size_t readahead = 0;
+
+    // Bytes waiting to be written at write_offset.
+    std::vector<char> write_buffer;
+    std::int64_t write_offset = 0;
+};
+
+}  // namespace kota::fs
@@ -3,11 +3,14 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "kota/async/runtime/generator.h"
 #include "kota/async/runtime/task.h"
 #include "kota/async/vocab/error.h"
 #include "kota/async/vocab/owned.h"
@@ -122,6 +125,108 @@ private:
     void* dir = nullptr;
 };
 
+/// One entry produced by walk().
+struct walk_entry {
+    /// Path of the entry: the walk root joined with every name below it.
+    std::string path;
+
+    /// Type reported by the directory listing, or derived from `stats` when
+    /// the listing did not know it.
+    dirent::type kind = dirent::type::unknown;
+
+    /// lstat() of the entry; only filled when it was needed or requested.
+    std::optional<file_stats> stats;
+
+    /// 1 for direct children of the root.
+    std::size_t depth = 0;
+};
+
+struct walk_options {
+    /// Called for every directory before it is entered; returning true skips
+    /// its contents. The directory itself is still yielded.
+    std::function<bool(const walk_entry&)> prune;
+
+    /// lstat every entry. Otherwise only entries whose type the directory
+    /// listing did not report are stat'ed.
+    bool stat = false;
+
+    /// Maximum number of lstat requests in flight at once.
+    std::size_t max_concurrency = 16;
+
+    /// Directories deeper than this are yielded but not entered.
+    std::size_t max_depth = static_cast<std::size_t>(-1);
+};
+
+class mapped_file;
+
+/// Maps the file at `path` read-only into memory. The mapping is followed by
+/// at least mapped_file::min_padding zero bytes, which is what simdjson
+/// needs to parse the bytes in place:
+///
+///   auto file = co_await fs::map("cache.json").or_fail();
+///   auto value = codec::json::from_json<cache>(simdjson::padded_string_view(
+///       file.data(), file.size(), file.size() + file.padding()));
+///
+/// Where the padding cannot come from the mapping itself (an empty file, or
+/// on Windows a file that ends too close to a page boundary), the file is
+/// read into a padded heap buffer instead.
+task<mapped_file, error> map(std::string_view path, event_loop& loop = event_loop::current());
+
+/// Read-only view of a whole file returned by fs::map(); move-only, and the
+/// bytes stay valid until it is destroyed.
+class mapped_file {
+public:
+    /// Zero bytes guaranteed readable past size() (SIMDJSON_PADDING).
+    constexpr static std::size_t min_padding = 64;
+
+    mapped_file() = default;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    const char* data() const noexcept {
+        return base;
+    }
+
+    std::size_t size() const noexcept {
+        return length;
+    }
+
+    bool empty() const noexcept {
+        return length == 0;
+    }
+
+    /// Readable zero bytes after the file contents; at least min_padding.
+    std::size_t padding() const noexcept {
+        return reserved - length;
+    }
+
+    std::span<const char> bytes() const noexcept {
+        return {base, length};
+    }
+
+    std::string_view view() const noexcept {
+        return {base, length};
+    }
+
+private:
+    friend task<mapped_file, error> map(std::string_view path, event_loop& loop);
+
+    enum class backing { none, mapping, heap };
+
+    void reset() noexcept;
+
+    char* base = nullptr;
+    std::size_t length = 0;
+    // Readable bytes starting at base, padding included.
+    std::size_t reserved = 0;
+    backing kind = backing::none;
+};
+
 /// Remove a file.
 task<void, error> unlink(std::string_view path, event_loop& loop = event_loop::current());
 
@@ -159,6 +264,20 @@ task<std::vector<dirent>, error> readdir(dir_handle& dir, event_loop& loop = eve
 /// Close an opened directory handle.
 task<void, error> closedir(dir_handle& dir, event_loop& loop = event_loop::current());
 
+/// Recursively walks the tree under `root`, depth first, yielding entries as
+/// each directory batch is read rather than collecting the whole tree. The
+/// root itself is not yielded, and symlinks are never followed. Failing to
+/// open `root` fails the walk; subdirectories that cannot be opened (removed
+/// or unreadable meanwhile) are skipped.
+///
+///   auto entries = fs::walk(root, {.prune = [](auto& e) { return e.path.ends_with("/.git"); }});
+///   while(auto entry = co_await or_fail(co_await entries.next())) {
+///       index(*entry);
+///   }
+generator<walk_entry, error> walk(std::string root,
+                                  walk_options options = {},
+                                  event_loop& loop = event_loop::current());
+
 /// Get file status by file descriptor.
 task<file_stats, error> fstat(int fd, event_loop& loop = event_loop::current());
 
@@ -292,6 +411,19 @@ task<std::size_t, error> write(int fd,
 /// Close a file descriptor asynchronously.
 task<void, error> close(int fd, event_loop& loop = event_loop::current());
 
+/// Read a whole file. Open, fstat, read and close run as one threadpool job
+/// instead of one round trip each; see sync::read_to_string().
+task<std::string, error> read_file(std::string_view path,
+                                   event_loop& loop = event_loop::current());
+
+/// Read many whole files, `batch` files per threadpool job, returning one
+/// result per path in order. A file that cannot be read only fails its own
+/// entry. `paths` must stay alive until the task completes.
+task<std::vector<result<std::string>>, error>
+    read_many(std::span<const std::string> paths,
+              std::size_t batch = 64,
+              event_loop& loop = event_loop::current());
+
 namespace sync {
 
 /// Open a file. Returns the fd on success.
@@ -307,7 +439,12 @@ result<std::size_t> write(int fd, std::span<const char> buf, std::int64_t offset
 /// Close a file descriptor.
 error close(int fd);
 
-/// Convenience: read entire file into a string.
+/// Get file status by file descriptor.
+result<file_stats> fstat(int fd);
+
+/// Convenience: read entire file into a string. The buffer is sized from
+/// fstat(), so a regular file takes a single read plus the one that sees
+/// its end; files reporting no size (pipes, procfs) grow as they are read.
 result<std::string> read_to_string(std::string_view path);
 
 }  // namespace sync
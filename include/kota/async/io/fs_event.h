@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include "kota/async/runtime/task.h"
 #include "kota/async/vocab/error.h"
@@ -67,6 +69,15 @@ public:
     /// Await a change event; delivers one pending change at a time.
     task<change, error> wait();
 
+    /// Await changes and return every one collected since the last call,
+    /// one entry per path with the flags of all its events merged. With a
+    /// non-zero `window`, waits that long after the first change so that
+    /// the rest of a burst (a checkout, a build) lands in the same batch.
+    ///
+    /// The first call switches the watcher to collecting batches; wait()
+    /// fails with invalid_argument from then on.
+    task<std::vector<change>, error> wait_batch(std::chrono::milliseconds window = {});
+
 private:
     explicit fs_event(unique_handle<Self> self) noexcept;
 
@@ -1,21 +1,83 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <source_location>
+#include <span>
+#include <string>
 #include <tuple>
 
 #include "kota/support/functional.h"
+#include "kota/support/name_table.h"
 
 struct uv_loop_s;
 using uv_loop_t = uv_loop_s;
 
+/// Set to 1 to have event loops maintain the counters returned by
+/// event_loop::stats(). When 0, stats() reports all zeros and the counting
+/// code is compiled out. Only affects the library's own translation units.
+#ifndef KOTA_ASYNC_LOOP_STATS
+#define KOTA_ASYNC_LOOP_STATS 0
+#endif
+
+/// Set to 1 to compile in the task event hooks behind event_loop::start_trace().
+/// When 0, tracing calls are no-ops. Only affects the library's own
+/// translation units.
+#ifndef KOTA_ASYNC_TRACE
+#define KOTA_ASYNC_TRACE 0
+#endif
+
 namespace kota {
 
 class async_node;
 
+namespace detail {
+
+struct wheel_link {
+    wheel_link* prev = nullptr;
+    wheel_link* next = nullptr;
+};
+
+/// Intrusive entry of an event loop's timer wheel. Owners embed it and are
+/// called back through `fire` once its expiry (in loop milliseconds) passes.
+struct wheel_entry : wheel_link {
+    std::uint64_t expiry = 0;
+    std::uint8_t level = 0;
+    std::uint8_t slot = 0;
+    void (*fire)(wheel_entry& self) = nullptr;
+
+    bool armed() const noexcept {
+        return next != nullptr;
+    }
+};
+
+class resolve_cache;
+
+}  // namespace detail
+
+/// A callback run once on another thread or loop: by event_loop::post(),
+/// post_batch(), relay::send(), queue() and thread_pool::submit(). The
+/// inline buffer fits a coroutine handle, a std::string and a shared_ptr,
+/// which is what those callbacks usually capture, so posting one does not
+/// allocate. The captures are released as soon as the callback has run.
+using loop_callback = unique_function<void(), 56>;
+
 template <typename T = void, typename E = void, typename C = void>
 class task;
 
+/// Ready-queue lane of a scheduled task. Each loop tick resumes every node
+/// that was ready in the interactive lane, then the normal lane, then up to
+/// the loop's background budget (see event_loop::set_background_budget()).
+/// Lanes are snapshotted per tick, so no lane can starve another.
+enum class priority : std::uint8_t {
+    interactive,
+    normal,
+    background,
+};
+
 /// A one-shot relay for posting a callback to an event loop from an
 /// external context (e.g. a system async API callback).
 ///
@@ -53,7 +115,7 @@ public:
     /// Can be called from any thread. Only the first call takes effect;
     /// subsequent calls from the same thread are safe no-ops.
     /// Concurrent calls from multiple threads are undefined behavior.
-    void send(function<void()> callback);
+    void send(loop_callback callback);
 
     /// Opaque implementation detail. Defined in loop.cpp.
     struct self;
@@ -66,6 +128,82 @@ private:
     self* self;
 };
 
+/// Counters for an event loop's coroutine frame pool.
+///
+/// Only frames allocated or freed on the loop's thread while run() is active
+/// are counted; frames created before run() always come from the heap.
+struct frame_pool_stats {
+    /// Frame allocations served from a cached block.
+    std::size_t hits = 0;
+
+    /// Pool-eligible allocations that found no cached block and went to the heap.
+    std::size_t misses = 0;
+
+    /// Allocations too large for any size class. Never cached.
+    std::size_t oversized = 0;
+
+    /// Frees that were kept for reuse instead of returned to the heap.
+    std::size_t recycled = 0;
+
+    /// Blocks currently held by the pool.
+    std::size_t cached = 0;
+
+    double hit_rate() const noexcept {
+        auto total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+/// Scheduler and callback counters for one event loop. Collected only when
+/// the library is built with KOTA_ASYNC_LOOP_STATS=1.
+struct loop_stats {
+    /// Nodes queued with event_loop::schedule().
+    std::size_t scheduled = 0;
+
+    /// Nodes resumed from the ready queue.
+    std::size_t resumed = 0;
+
+    /// Continuations resumed directly by completions, outside the ready queue.
+    std::size_t continuations = 0;
+
+    /// Largest number of nodes waiting in the ready queue at once.
+    std::size_t max_ready = 0;
+
+    /// Callbacks run from post() and post_batch().
+    std::size_t posts = 0;
+
+    /// Relay callbacks delivered on this loop.
+    std::size_t relay_sends = 0;
+
+    /// uv callbacks by source: ready-queue idle ticks, post wakeups, timer
+    /// wheel expirations, and I/O, fs, process and watcher completions.
+    std::size_t idle_callbacks = 0;
+    std::size_t async_callbacks = 0;
+    std::size_t timer_callbacks = 0;
+    std::size_t io_callbacks = 0;
+
+    /// Loop iterations and time spent inside run(), split into time blocked
+    /// waiting for events and time spent running callbacks.
+    std::uint64_t iterations = 0;
+    std::uint64_t idle_ns = 0;
+    std::uint64_t busy_ns = 0;
+
+    /// With busy polling on (see event_loop::set_busy_poll()): non-blocking
+    /// polls that found work, polls that found nothing, and times the loop
+    /// gave up spinning and blocked in the kernel.
+    std::uint64_t spin_hits = 0;
+    std::uint64_t spin_misses = 0;
+    std::uint64_t sleeps = 0;
+
+    double busy_ns_per_iteration() const noexcept {
+        return iterations == 0 ? 0.0 : static_cast<double>(busy_ns) / static_cast<double>(iterations);
+    }
+
+    double idle_ns_per_iteration() const noexcept {
+        return iterations == 0 ? 0.0 : static_cast<double>(idle_ns) / static_cast<double>(iterations);
+    }
+};
+
 /// Runs an event loop backed by libuv.
 ///
 /// All async operations (tasks, timers, I/O) require an event_loop.
@@ -89,6 +227,7 @@ public:
     }
 
     friend class async_node;
+    friend class loop_group;
 
 public:
     operator uv_loop_t&() noexcept;
@@ -97,6 +236,23 @@ public:
 
     int run();
 
+    /// Runs a single loop iteration, waiting at most `timeout` for events,
+    /// and returns nonzero while handles or requests are still active. For
+    /// embedding the loop in a host that has its own poller (epoll, a GUI
+    /// toolkit): the host watches backend_fd(), sleeps no longer than
+    /// next_timeout(), and calls run_once() whenever either fires. The loop
+    /// is current on this thread only for the duration of the call.
+    int run_once(std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+
+    /// The descriptor that becomes readable when the loop has events to
+    /// process, or -1 where the platform has none (Windows).
+    int backend_fd() const noexcept;
+
+    /// How long the host may sleep before the loop has something to do:
+    /// zero while tasks are ready, the time to the next timer otherwise,
+    /// and nullopt when only an event on backend_fd() can wake it.
+    std::optional<std::chrono::milliseconds> next_timeout() const noexcept;
+
     void stop();
 
     /// Posts a callback to be executed on this event loop's thread.
@@ -104,7 +260,14 @@ public:
     /// Thread-safe: can be called from any thread. The callback will be
     /// invoked on the event loop thread during a subsequent iteration.
     /// Internally uses uv_async_t to wake up the loop.
-    void post(function<void()> callback);
+    void post(loop_callback callback);
+
+    /// Posts several callbacks at once. They run in span order, after any
+    /// callback posted earlier from the same thread. The callbacks are moved
+    /// from, and the loop is signalled at most once for the whole batch.
+    ///
+    /// Thread-safe: can be called from any thread.
+    void post_batch(std::span<loop_callback> callbacks);
 
     /// Creates a relay that keeps this event loop alive until used or destroyed.
     ///
@@ -113,6 +276,60 @@ public:
     /// callback, where relay::send() can be called thread-safely.
     relay create_relay();
 
+    /// Enables or disables this loop's coroutine frame pool. Disabling
+    /// returns every cached block to the heap; frames are then allocated and
+    /// freed with the global operator new/delete until it is enabled again.
+    /// Build with KOTA_ASYNC_FRAME_POOL=0 to bypass the pool entirely.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void set_frame_pool_enabled(bool enabled) noexcept;
+
+    /// Returns the frame pool counters accumulated since the loop was created.
+    frame_pool_stats frame_stats() const noexcept;
+
+    /// Returns the scheduler counters accumulated since the loop was created.
+    /// All zeros unless built with KOTA_ASYNC_LOOP_STATS=1.
+    loop_stats stats() const noexcept;
+
+    /// Starts recording task create, resume and finish events, with their
+    /// source locations and resume durations, into a ring of `capacity`
+    /// events. Restarting discards the previous trace; once the ring is full
+    /// the oldest events are overwritten. No-op unless built with
+    /// KOTA_ASYNC_TRACE=1.
+    ///
+    /// NOT thread-safe: must be called on the loop thread or while the loop
+    /// is not running, like stop_trace() and trace_json().
+    void start_trace(std::size_t capacity = 64 * 1024);
+
+    /// Stops recording. Recorded events stay available to trace_json().
+    void stop_trace() noexcept;
+
+    /// Returns recorded events as Chrome trace event JSON, loadable in
+    /// chrome://tracing or ui.perfetto.dev.
+    std::string trace_json() const;
+
+    /// Records a named instant event in the current trace, e.g. with
+    /// static_name<"flush">() so the hot path stores four bytes instead of
+    /// a string. No-op unless tracing, or without KOTA_ASYNC_TRACE=1.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void trace_mark(name_id name,
+                    std::source_location location = std::source_location::current()) noexcept;
+
+    /// Arms `entry` on this loop's timer wheel to fire `timeout` from now.
+    /// The entry must not already be armed. Used by after() and deadline.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void arm_timeout(detail::wheel_entry& entry, std::chrono::milliseconds timeout) noexcept;
+
+    /// Removes `entry` from the timer wheel. No-op if it is not armed.
+    void disarm_timeout(detail::wheel_entry& entry) noexcept;
+
+    /// Host name answers cached by resolve() and tcp::connect().
+    ///
+    /// NOT thread-safe: must be used on the loop thread.
+    detail::resolve_cache& dns_cache() noexcept;
+
     /// Schedules a task for execution on this event loop.
     /// If the task is passed by rvalue (temporary), the loop takes ownership
     /// (sets root=true). The task will be destroyed after it completes.
@@ -127,12 +344,68 @@ public:
         schedule(static_cast<async_node&>(promise), location);
     }
 
+    /// Like schedule(), but queues the task in `lane` instead of the normal one.
+    template <typename Task>
+    void schedule(Task&& task,
+                  priority lane,
+                  std::source_location location = std::source_location::current()) {
+        auto& promise = task.h.promise();
+        if constexpr(std::is_rvalue_reference_v<Task&&>) {
+            promise.root = true;
+            task.release();
+        }
+
+        schedule(static_cast<async_node&>(promise), location, lane);
+    }
+
+    /// Caps how many background nodes are resumed per loop tick (default 64,
+    /// minimum 1). Lower values keep I/O latency down under background load.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void set_background_budget(std::size_t nodes) noexcept;
+
+    /// Sets how long a task may run after being resumed from the ready queue
+    /// before yield() actually suspends it. Zero (the default) makes every
+    /// yield() suspend.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void set_time_slice(std::chrono::nanoseconds slice) noexcept;
+
+    /// Makes run() keep polling for events without blocking for up to
+    /// `window` after the last one it saw, before it waits in the kernel
+    /// again. A reply that arrives within the window is picked up without a
+    /// wakeup, at the cost of a core spinning meanwhile; meant for peers on
+    /// the same machine exchanging many small messages. Spinning counts as
+    /// busy time in stats(). Zero (the default) always blocks when there is
+    /// nothing to do.
+    ///
+    /// NOT thread-safe: must be called on the loop thread or before run().
+    void set_busy_poll(std::chrono::nanoseconds window) noexcept;
+
 private:
-    void schedule(async_node& frame, std::source_location location);
+    void schedule(async_node& frame,
+                  std::source_location location,
+                  priority lane = priority::normal);
 
     std::unique_ptr<self> self;
 };
 
+/// Suspends the calling task and queues it again in `lane` of `loop`, so
+/// that work already ready in higher lanes runs first.
+task<> reschedule(priority lane = priority::normal, event_loop& loop = event_loop::current());
+
+/// Cooperative yield point for CPU-bound work on the loop thread. Requeues
+/// the calling task in the normal lane; since the loop polls for I/O without
+/// blocking while tasks are ready, pending I/O callbacks run before it
+/// continues.
+///
+/// With a time slice set (see event_loop::set_time_slice()), completes
+/// without suspending until the task has used up its slice, so it can be
+/// called on every iteration of a hot loop. A task resumed directly by an
+/// I/O callback is timed from the last ready-queue resume and may therefore
+/// yield on its first call.
+task<> yield(event_loop& loop = event_loop::current());
+
 /// Convenience: creates a loop, schedules all tasks, runs to completion,
 /// and returns a tuple of their values (via task::value()).
 template <typename... Tasks>
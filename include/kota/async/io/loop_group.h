@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <source_location>
+#include <utility>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/task.h"
+
+namespace kota {
+
+/// Owns N event loops, each running on its own thread, and balances root
+/// tasks across them with per-loop work-stealing deques.
+///
+/// Only tasks that have not started yet are ever moved between loops. Once a
+/// task is resumed on a worker, it is bound to that worker's event_loop for
+/// the rest of its life: timers, streams and other handles it creates through
+/// `event_loop::current()` stay on the same thread. Use spawn_on() for tasks
+/// that capture handles created on a specific loop.
+///
+/// Usage:
+///   loop_group group(4);
+///   for(auto& request: requests) {
+///       group.spawn(handle(request));
+///   }
+///   group.wait();
+///
+/// Thread safety:
+///   - spawn(), spawn_on(), wait() and stop() may be called from any thread,
+///     including from tasks running on the group's own workers.
+///   - The destructor stops the workers and joins them; it must not run on
+///     one of the group's worker threads.
+class loop_group {
+public:
+    /// Starts `workers` threads, each with its own event_loop. Zero selects
+    /// std::thread::hardware_concurrency().
+    explicit loop_group(std::size_t workers = 0);
+
+    loop_group(const loop_group&) = delete;
+    loop_group& operator=(const loop_group&) = delete;
+
+    ~loop_group();
+
+    /// Number of worker loops.
+    std::size_t size() const noexcept;
+
+    /// Returns the group whose worker is running on the current thread.
+    static loop_group* current() noexcept;
+
+    /// Returns the index of the current worker if the calling thread belongs
+    /// to this group.
+    std::optional<std::size_t> current_index() const noexcept;
+
+    /// Returns worker `index`'s loop. Handles created on it must only be used
+    /// by tasks pinned to the same worker via spawn_on().
+    event_loop& loop(std::size_t index) noexcept;
+
+    /// Hands a root task to the group. When called from one of the group's
+    /// workers the task goes onto that worker's local deque, otherwise into
+    /// the shared injection queue. Idle workers steal it until it starts.
+    template <typename T, typename E, typename C>
+    void spawn(task<T, E, C>&& t, std::source_location location = std::source_location::current()) {
+        begin_one();
+        auto node = track(std::move(t), completion_guard(this));
+        submit(release(node, location), npos);
+    }
+
+    /// Hands a root task to a specific worker. The task is never stolen.
+    template <typename T, typename E, typename C>
+    void spawn_on(std::size_t index,
+                  task<T, E, C>&& t,
+                  std::source_location location = std::source_location::current()) {
+        begin_one();
+        auto node = track(std::move(t), completion_guard(this));
+        submit(release(node, location), index);
+    }
+
+    /// Blocks until every task handed to the group so far has completed.
+    /// Must not be called from a worker thread.
+    void wait();
+
+    /// Asks every worker to leave its event loop. Tasks that have not started
+    /// yet are destroyed. Non-blocking; the destructor joins the threads.
+    void stop();
+
+    /// Opaque implementation detail. Defined in loop_group.cpp.
+    struct self;
+
+private:
+    constexpr static std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Decrements the outstanding-task count once the wrapper frame goes
+    /// away, whether the task completed, failed, was cancelled, or was
+    /// destroyed before it ever started. It is a coroutine parameter rather
+    /// than a local so that destroying an unstarted frame also runs it.
+    class completion_guard {
+    public:
+        explicit completion_guard(loop_group* group) noexcept : group(group) {}
+
+        completion_guard(completion_guard&& other) noexcept :
+            group(std::exchange(other.group, nullptr)) {}
+
+        completion_guard(const completion_guard&) = delete;
+        completion_guard& operator=(const completion_guard&) = delete;
+        completion_guard& operator=(completion_guard&&) = delete;
+
+        ~completion_guard() {
+            if(group) {
+                group->complete_one();
+            }
+        }
+
+    private:
+        loop_group* group;
+    };
+
+    template <typename T, typename E, typename C>
+    static task<> track(task<T, E, C> inner, [[maybe_unused]] completion_guard guard) {
+        [[maybe_unused]] auto result = co_await std::move(inner).catch_cancel();
+    }
+
+    static async_node* release(task<>& t, std::source_location location) {
+        auto* node = t.operator->();
+        node->root = true;
+        node->location = location;
+        t.release();
+        return node;
+    }
+
+    void submit(async_node* node, std::size_t index);
+
+    void begin_one() noexcept;
+
+    void complete_one() noexcept;
+
+    std::unique_ptr<self> self;
+};
+
+}  // namespace kota
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "kota/support/small_vector.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/io/request.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/runtime/when.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// Chunked fan-out of data-parallel work over queue().
+///
+/// Each algorithm splits the range into chunks of `grain` elements, runs
+/// every chunk as one queue() job and combines the results on the loop
+/// thread. A `grain` of zero picks one that gives every hardware thread a
+/// few chunks, so uneven chunks still balance out. The callables are shared
+/// by all chunks and must be safe to call concurrently.
+///
+/// The range must stay alive and unmodified until the task completes.
+/// Cancelling the task (for example through with_token()) cancels chunks
+/// that have not started; running chunks finish first.
+///
+/// Usage:
+///   co_await parallel_for(pixels, [](pixel& p) { p = shade(p); }).or_fail();
+///   auto sizes = co_await parallel_transform(paths, file_size).or_fail();
+///   auto total = co_await parallel_reduce(sizes, 0, std::plus{}).or_fail();
+
+namespace detail {
+
+template <typename Range>
+concept parallel_range = std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>;
+
+inline std::size_t parallel_grain(std::size_t size, std::size_t grain) noexcept {
+    if(grain != 0) {
+        return grain;
+    }
+    const std::size_t chunks = 4 * (std::max)(1u, std::thread::hardware_concurrency());
+    return (std::max)(std::size_t(1), (size + chunks - 1) / chunks);
+}
+
+/// Queues `chunk(begin, end)` for every grain-sized slice of [0, size) and
+/// returns the chunk results in order.
+template <typename R, typename Chunk>
+task<small_vector<R>, error>
+    run_chunks(std::size_t size, std::size_t grain, Chunk chunk, event_loop& loop) {
+    const auto step = parallel_grain(size, grain);
+
+    small_vector<task<R, error>> chunks;
+    chunks.reserve((size + step - 1) / step);
+    for(std::size_t begin = 0; begin < size; begin += step) {
+        const auto end = (std::min)(size, begin + step);
+        chunks.push_back(queue([&chunk, begin, end] { return chunk(begin, end); }, loop));
+    }
+
+    auto results = co_await when_all(std::move(chunks));
+    if(results.has_error()) {
+        co_await fail(std::move(results).error());
+    }
+    co_return std::move(*results);
+}
+
+}  // namespace detail
+
+/// Calls `fn` on every element of `range`.
+template <detail::parallel_range Range, typename Fn>
+    requires std::invocable<Fn&, std::ranges::range_reference_t<Range>>
+task<void, error> parallel_for(Range& range,
+                               Fn fn,
+                               std::size_t grain = 0,
+                               event_loop& loop = event_loop::current()) {
+    auto first = std::ranges::begin(range);
+    auto chunk = [&fn, first](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) {
+            std::invoke(fn, first[i]);
+        }
+        return true;
+    };
+
+    co_await detail::run_chunks<bool>(std::ranges::size(range), grain, chunk, loop).or_fail();
+}
+
+/// Returns `fn(element)` for every element of `range`, in order.
+template <detail::parallel_range Range,
+          typename Fn,
+          typename R = std::invoke_result_t<Fn&, std::ranges::range_reference_t<Range>>>
+    requires (!std::is_void_v<R>)
+task<std::vector<R>, error> parallel_transform(Range& range,
+                                               Fn fn,
+                                               std::size_t grain = 0,
+                                               event_loop& loop = event_loop::current()) {
+    auto first = std::ranges::begin(range);
+    auto chunk = [&fn, first](std::size_t begin, std::size_t end) {
+        std::vector<R> out;
+        out.reserve(end - begin);
+        for(auto i = begin; i < end; ++i) {
+            out.push_back(std::invoke(fn, first[i]));
+        }
+        return out;
+    };
+
+    auto parts = co_await detail::run_chunks<std::vector<R>>(std::ranges::size(range),
+                                                             grain,
+                                                             chunk,
+                                                             loop)
+                     .or_fail();
+
+    std::vector<R> values;
+    values.reserve(std::ranges::size(range));
+    for(auto& part: parts) {
+        std::ranges::move(part, std::back_inserter(values));
+    }
+    co_return values;
+}
+
+/// Folds `range` with `op`, which must be associative and have `init` as its
+/// identity: every chunk starts from a copy of `init`, and the partial
+/// results are folded again, in order, starting from `init`.
+template <detail::parallel_range Range, typename T, typename Op>
+    requires std::invocable<Op&, T, std::ranges::range_reference_t<Range>> &&
+             std::invocable<Op&, T, T>
+task<T, error> parallel_reduce(Range& range,
+                               T init,
+                               Op op,
+                               std::size_t grain = 0,
+                               event_loop& loop = event_loop::current()) {
+    auto first = std::ranges::begin(range);
+    auto chunk = [&op, &init, first](std::size_t begin, std::size_t end) {
+        T acc = init;
+        for(auto i = begin; i < end; ++i) {
+            acc = std::invoke(op, std::move(acc), first[i]);
+        }
+        return acc;
+    };
+
+    auto partials =
+        co_await detail::run_chunks<T>(std::ranges::size(range), grain, chunk, loop).or_fail();
+
+    T acc = std::move(init);
+    for(auto& partial: partials) {
+        acc = std::invoke(op, std::move(acc), std::move(partial));
+    }
+    co_return acc;
+}
+
+}  // namespace kota
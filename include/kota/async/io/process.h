@@ -1,11 +1,15 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "kota/async/io/stream.h"
+#include "kota/async/runtime/generator.h"
 #include "kota/async/runtime/task.h"
 #include "kota/async/vocab/error.h"
 #include "kota/async/vocab/owned.h"
@@ -137,6 +141,29 @@ public:
     static result<spawn_result> spawn(const options& opts,
                                       event_loop& loop = event_loop::current());
 
+    /// Output kept by spawn_and_collect().
+    struct collected;
+
+    /// Spawn with stdout and stderr piped, keep at most `limit` bytes of
+    /// each, and wait for the child to exit. Output past the limit is still
+    /// read, so the child never blocks on a full pipe, but it is dropped. A
+    /// piped stdin is closed right away.
+    static task<collected, error> spawn_and_collect(options opts,
+                                                    std::size_t limit = 1024 * 1024,
+                                                    event_loop& loop = event_loop::current());
+
+    /// Stream `output`, typically a child's stdout or stderr, in chunks until
+    /// end of file. Each chunk views the pipe's read buffer and stays valid
+    /// until the next next(); bytes are released as they are passed on, so
+    /// memory is bounded by the read buffer however much the child writes.
+    /// `output` must outlive the generator.
+    static generator<std::string_view, error> read_output(pipe& output);
+
+    /// Pass every chunk of `output` to `sink` until end of file; see
+    /// read_output().
+    static task<void, error> drain_output(pipe& output,
+                                          std::function<void(std::string_view)> sink);
+
     /// Await process termination and fetch exit status.
     task<wait_result> wait();
 
@@ -161,6 +188,19 @@ private:
     unique_handle<Self> self;
 };
 
+struct process::collected {
+    exit_status status{};
+
+    std::string out;
+
+    std::string err;
+
+    /// Set when output past `limit` was dropped.
+    bool out_truncated = false;
+
+    bool err_truncated = false;
+};
+
 struct process::spawn_result {
     process proc;
 
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "kota/support/flat_hash_map.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/io/process.h"
+#include "kota/async/runtime/sync.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/cancellation.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// One reading of a watched process.
+struct process_sample {
+    process_info info;
+
+    /// When the reading was taken.
+    std::chrono::steady_clock::time_point time;
+
+    /// CPU time used since the previous sample per wall time elapsed, in
+    /// percent of one core; 0 for the first sample. Above 100 for a process
+    /// busy on several cores.
+    double cpu_percent = 0;
+};
+
+/// Tracks memory and CPU use of many processes, e.g. child compilers, so a
+/// scheduler can hold back new work while memory is short.
+///
+/// Every interval the monitor queries all watched processes in one job on
+/// the worker pool, reading /proc on Linux, and appends a sample to each
+/// one's history. A process that has exited and been reaped is dropped
+/// from the watch list on the next pass.
+///
+/// memory_pressure() relates the summed RSS of the watched processes to a
+/// budget: options::memory_limit, or by default the memory available to
+/// this process (its cgroup limit if any, otherwise the machine's). Above
+/// options::high_watermark the monitor is under pressure, and relieved()
+/// waits until a later pass finds it below again.
+///
+/// NOT thread-safe: must be used on the loop thread, and must not be moved
+/// while started.
+class process_monitor {
+public:
+    struct options {
+        /// How often start() samples.
+        std::chrono::milliseconds interval;
+
+        /// Samples kept per process, oldest dropped first.
+        std::size_t history;
+
+        /// Memory budget in bytes; 0 asks the system.
+        std::uint64_t memory_limit;
+
+        /// Fraction of the budget above which the monitor is under pressure.
+        double high_watermark;
+
+        constexpr options(std::chrono::milliseconds interval = std::chrono::seconds(1),
+                          std::size_t history = 60,
+                          std::uint64_t memory_limit = 0,
+                          double high_watermark = 0.8) :
+            interval(interval), history(history), memory_limit(memory_limit),
+            high_watermark(high_watermark) {}
+    };
+
+    explicit process_monitor(options opts = options(), event_loop& loop = event_loop::current());
+
+    process_monitor(const process_monitor&) = delete;
+    process_monitor& operator=(const process_monitor&) = delete;
+
+    ~process_monitor();
+
+    /// Adds `pid` to the processes every pass samples.
+    void watch(int pid);
+
+    /// Watches `proc`; it may be destroyed while watched.
+    void watch(const process& proc) {
+        watch(proc.pid());
+    }
+
+    /// Stops watching `pid` and drops its history.
+    void unwatch(int pid) noexcept;
+
+    bool watching(int pid) const noexcept {
+        return series.contains(pid);
+    }
+
+    std::size_t size() const noexcept {
+        return series.size();
+    }
+
+    /// Starts sampling every interval on the loop. No-op if started.
+    void start();
+
+    /// Stops the sampler. Histories stay until unwatched.
+    void stop() noexcept;
+
+    bool sampling() const noexcept {
+        return sampler.has_value();
+    }
+
+    /// Samples every watched process once now, on the worker pool. start()
+    /// runs this every interval.
+    task<void, error> sample();
+
+    /// The most recent sample of `pid`, if any.
+    const process_sample* latest(int pid) const noexcept;
+
+    /// Samples of `pid`, oldest first; empty if not watched.
+    const std::deque<process_sample>& history(int pid) const noexcept;
+
+    /// Summed RSS of the watched processes as of the last pass.
+    std::uint64_t total_rss() const noexcept {
+        return rss_sum;
+    }
+
+    /// The memory budget memory_pressure() is measured against.
+    std::uint64_t memory_limit() const noexcept {
+        return limit;
+    }
+
+    /// total_rss() as a fraction of memory_limit().
+    double memory_pressure() const noexcept {
+        return limit == 0 ? 0.0 : static_cast<double>(rss_sum) / static_cast<double>(limit);
+    }
+
+    bool under_pressure() const noexcept {
+        return !below_watermark.is_set();
+    }
+
+    /// Completes once a pass finds memory_pressure() at or below the high
+    /// watermark; immediately if it already is.
+    auto relieved() {
+        return below_watermark.wait();
+    }
+
+private:
+    task<> sample_every(cancellation_token token);
+
+    /// The watched pids, for a pass to query off the loop thread.
+    std::vector<int> snapshot() const;
+
+    /// Folds in one pass's readings of `pids`, in the same order.
+    void record(const std::vector<int>& pids,
+                const std::vector<result<process_info>>& infos,
+                std::chrono::steady_clock::time_point time);
+
+    options opts;
+    event_loop& loop;
+    std::uint64_t limit = 0;
+
+    flat_hash_map<int, std::deque<process_sample>> series;
+    std::optional<cancellation_source> sampler;
+
+    std::uint64_t rss_sum = 0;
+    event below_watermark{true};
+};
+
+}  // namespace kota
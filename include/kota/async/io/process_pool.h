@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/io/process.h"
+#include "kota/async/io/stream.h"
+#include "kota/async/runtime/sync.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// Keeps a fixed set of long-lived worker processes and hands jobs to them
+/// over their stdio pipes, so a job costs one pipe round trip instead of a
+/// process spawn.
+///
+/// Workers speak a framed protocol: every frame is a 4-byte little-endian
+/// payload length followed by the payload. For each job the pool writes one
+/// request frame to an idle worker's stdin and reads one reply frame from its
+/// stdout; a worker handles its requests one at a time, in order, and exits
+/// when stdin reaches end of file.
+///
+/// Workers are spawned on first use. One whose pipes fail, that sends a
+/// malformed frame, or whose job was cancelled midway, is killed and its job
+/// fails; the next job that picks its slot spawns a replacement.
+///
+/// NOT thread-safe: must be used on its loop's thread.
+class process_pool {
+public:
+    struct options {
+        /// How each worker is launched. Its stdin and stdout are replaced by
+        /// the pool's pipes; stderr is left as configured.
+        process::options worker;
+
+        /// Number of workers, and of jobs that run at once.
+        std::size_t size = 4;
+
+        /// Largest reply payload accepted; a longer frame retires the worker.
+        std::size_t max_reply = 64 * 1024 * 1024;
+    };
+
+    explicit process_pool(options opts, event_loop& loop = event_loop::current());
+
+    process_pool(const process_pool&) = delete;
+    process_pool& operator=(const process_pool&) = delete;
+
+    /// Closes the workers' pipes, which asks them to exit; call shutdown()
+    /// first to also wait until they have.
+    ~process_pool();
+
+    /// Sends `request` to an idle worker and returns its reply, waiting for
+    /// a worker to become idle when all are busy.
+    task<std::string, error> run(std::string_view request);
+
+    /// Closes the stdin of every worker and waits for each to exit. Must not
+    /// overlap run().
+    task<> shutdown();
+
+    /// Worker processes currently running.
+    std::size_t running() const noexcept;
+
+private:
+    struct worker {
+        process proc;
+        pipe input;
+        pipe output;
+
+        // Bytes read from stdout that are not part of a consumed frame.
+        std::string inbox;
+
+        bool alive = false;
+
+        // Set while a job is in flight; still set afterwards only if the job
+        // was cancelled midway, leaving the stream out of step.
+        bool in_job = false;
+    };
+
+    error spawn(worker& w);
+    task<std::string, error> exchange(worker& w, std::string_view request);
+    task<> retire(worker& w);
+
+    options opts;
+    event_loop* loop;
+    std::vector<worker> workers;
+    std::vector<std::size_t> idle;
+    semaphore slots;
+};
+
+}  // namespace kota
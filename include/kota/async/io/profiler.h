@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <vector>
+
+#include "kota/support/flat_hash_map.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/cancellation.h"
+
+namespace kota {
+
+/// Samples where watched tasks are waiting, to find the awaits that
+/// dominate latency. Each sample walks the graph below every watched root,
+/// as dump_dot() would, and counts one hit for each path down to something
+/// pending: an I/O operation, a mutex or event waiter, an aggregate
+/// (when_all, when_any, scope) or a task ready to run. A frame on the path
+/// is a node's kind and the source location it was awaited at.
+///
+/// folded() renders the counts as folded stacks, the input of flamegraph.pl
+/// and speedscope. hottest() ranks the leaves alone; samples times the
+/// interval approximates how long tasks spent waiting there.
+///
+/// Watched tasks must stay alive while watched: watch tasks the caller owns
+/// and unwatch() them before destroying them. While started, the sampler
+/// keeps the loop running; stop() it to let run() return.
+///
+/// NOT thread-safe: must be used on the loop thread, and must not be moved
+/// while started.
+class async_profiler {
+public:
+    struct wait_site {
+        async_node::NodeKind kind = async_node::NodeKind::Task;
+
+        /// Where the leaf was awaited.
+        std::source_location location;
+
+        std::uint64_t samples = 0;
+
+        /// samples times the sampling interval.
+        std::chrono::nanoseconds waited{0};
+    };
+
+    explicit async_profiler(std::chrono::milliseconds interval = std::chrono::milliseconds(1),
+                            event_loop& loop = event_loop::current()) noexcept;
+
+    async_profiler(const async_profiler&) = delete;
+    async_profiler& operator=(const async_profiler&) = delete;
+
+    ~async_profiler();
+
+    /// Adds `root`, e.g. task.operator->(), to the roots every sample walks.
+    void watch(const async_node* root);
+
+    void unwatch(const async_node* root) noexcept;
+
+    /// Starts sampling every interval on the loop. No-op if started.
+    void start();
+
+    /// Stops the sampler. Counts stay until reset().
+    void stop() noexcept;
+
+    bool sampling() const noexcept {
+        return sampler.has_value();
+    }
+
+    /// Takes one sample now; start() calls this every interval.
+    void sample();
+
+    /// Samples taken so far.
+    std::uint64_t samples() const noexcept {
+        return ticks;
+    }
+
+    /// One line per distinct wait path, root first, frames separated by ';'
+    /// and followed by its sample count, e.g.
+    /// "Task server.cpp:40;WhenAll server.cpp:52;SystemIO stream.cpp:88 17".
+    std::string folded() const;
+
+    /// The `limit` leaves with the most samples, most first.
+    std::vector<wait_site> hottest(std::size_t limit = 20) const;
+
+    /// Drops all counts.
+    void reset() noexcept;
+
+private:
+    task<> sample_every(cancellation_token token);
+
+    std::chrono::milliseconds interval;
+    event_loop& loop;
+
+    std::vector<const async_node*> roots;
+    std::optional<cancellation_source> sampler;
+
+    std::uint64_t ticks = 0;
+    flat_hash_map<std::string, std::uint64_t> stacks;
+    flat_hash_map<std::string, wait_site> sites;
+
+    // Reused to build each path's key.
+    std::string scratch;
+};
+
+}  // namespace kota
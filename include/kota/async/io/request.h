@@ -1,25 +1,108 @@
 #pragma once
 
+#include <coroutine>
+#include <cstddef>
 #include <optional>
+#include <source_location>
+#include <type_traits>
+#include <utility>
 
 #include "kota/support/function_traits.h"
 #include "kota/support/functional.h"
 #include "kota/async/io/loop.h"
+#include "kota/async/runtime/frame.h"
 #include "kota/async/runtime/task.h"
 #include "kota/async/vocab/error.h"
 
 namespace kota {
 
+namespace detail {
+
+/// A libuv work request stored inline in the awaiting coroutine frame, so
+/// queue() needs no allocation besides that frame. The uv_work_t lives in
+/// `req`; request.cpp checks that it fits. See work_call for the callable.
+struct work_request : system_op {
+    using invoke_fn = void (*)(work_request& self);
+
+    work_request(event_loop& loop, invoke_fn invoke) noexcept;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename Promise>
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        if(!start()) {
+            // Not queued; resume straight away with the error in `result`.
+            return waiting;
+        }
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    error await_resume() noexcept {
+        return result;
+    }
+
+    /// Queues the request, returning false with `result` set on failure.
+    bool start() noexcept;
+
+    /// Runs on the worker thread.
+    invoke_fn invoke;
+
+    event_loop* loop;
+
+    /// Completion status, consumed by await_resume().
+    error result;
+
+    alignas(std::max_align_t) std::byte req[192];
+};
+
+/// Binds the user callable and its result slot to a work_request. The
+/// callable runs once, so it is invoked as an rvalue.
+template <typename Fn, typename R>
+struct work_call : work_request {
+    work_call(Fn fn, event_loop& loop) : work_request(loop, &run), fn(std::move(fn)) {}
+
+    static void run(work_request& self) {
+        auto& call = static_cast<work_call&>(self);
+        call.value.emplace(std::move(call.fn)());
+    }
+
+    Fn fn;
+    std::optional<R> value;
+};
+
+template <typename Fn>
+struct work_call<Fn, void> : work_request {
+    work_call(Fn fn, event_loop& loop) : work_request(loop, &run), fn(std::move(fn)) {}
+
+    static void run(work_request& self) {
+        std::move(static_cast<work_call&>(self).fn)();
+    }
+
+    Fn fn;
+};
+
+}  // namespace detail
+
 /// Run work on libuv's worker pool and complete when finished or with an error.
-task<void, error> queue(function<void()> fn, event_loop& loop = event_loop::current());
+task<void, error> queue(loop_callback fn, event_loop& loop = event_loop::current());
 
 /// Run work on libuv's worker pool and return either its value or an error.
+/// The callable, its result and the libuv request all live in the returned
+/// task's frame.
 template <typename Fn, typename R = callable_return_t<Fn>>
-    requires std::is_invocable_v<Fn> && (!std::is_void_v<R>)
+    requires std::is_invocable_v<Fn>
 task<R, error> queue(Fn fn, event_loop& loop = event_loop::current()) {
-    std::optional<R> ret;
-    co_await queue(function<void()>([&] { ret.emplace(fn()); }), loop).or_fail();
-    co_return std::move(*ret);
+    detail::work_call<Fn, R> call(std::move(fn), loop);
+    if(auto err = co_await call) {
+        co_await fail(std::move(err));
+    }
+    if constexpr(!std::is_void_v<R>) {
+        co_return std::move(*call.value);
+    }
 }
 
 }  // namespace kota
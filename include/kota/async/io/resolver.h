@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// One address a host name resolved to.
+struct resolved_address {
+    /// Numeric form, e.g. "192.0.2.1" or "2001:db8::1".
+    std::string addr;
+
+    bool ipv6 = false;
+};
+
+/// Resolves `host` through getaddrinfo on libuv's threadpool, returning the
+/// addresses in the order getaddrinfo prefers them. Answers are cached on
+/// `loop` (see set_resolve_ttl()) and shared with tcp::connect(); numeric
+/// hosts are returned as they are, without a lookup.
+task<std::vector<resolved_address>, error> resolve(std::string_view host,
+                                                   event_loop& loop = event_loop::current());
+
+/// How long resolve() and tcp::connect() reuse an answer on `loop`, 30 s by
+/// default. Zero disables caching.
+///
+/// NOT thread-safe: must be called on the loop thread or while the loop is
+/// not running.
+void set_resolve_ttl(std::chrono::milliseconds ttl, event_loop& loop = event_loop::current());
+
+/// Drops every answer cached on `loop`, e.g. after a network change.
+void clear_resolve_cache(event_loop& loop = event_loop::current());
+
+}  // namespace kota
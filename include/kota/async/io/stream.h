@@ -1,17 +1,22 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <span>
 #include <string>
 #include <string_view>
 
+#include "kota/support/small_vector.h"
 #include "kota/async/runtime/task.h"
+#include "kota/async/vocab/byte_chain.h"
 #include "kota/async/vocab/error.h"
 #include "kota/async/vocab/owned.h"
 
 namespace kota {
 
 class event_loop;
+class loop_group;
 
 template <typename Stream>
 class acceptor;
@@ -58,12 +63,64 @@ public:
     /// Consume bytes from the internal buffer.
     void consume(std::size_t n);
 
+    /// Views of every buffered byte, in order; waits for at least one read if
+    /// empty. The views are invalidated by consume(), detach() and reads.
+    task<small_vector<chunk>, error> read_chunks();
+
+    /// Takes the first `n` buffered bytes (at most what is buffered) out of
+    /// the internal buffer without copying them.
+    byte_chain detach(std::size_t n);
+
+    /// Takes the read buffer from a pool shared by the streams of this
+    /// thread's loop, only while unread bytes are buffered, so idle streams
+    /// hold no buffer memory. Suits servers with many mostly idle
+    /// connections; off by default.
+    void set_pooled_buffer(bool enabled);
+
     /// Stop active reads and abort any pending read waiter.
     void stop();
 
-    /// Write data to the stream; only one writer at a time.
+    /// Write data to the stream. Any number of writes may be pending at
+    /// once; they reach the stream in the order write() was called.
     task<void, error> write(std::span<const char> data);
 
+    /// Writes `pieces` back to back, as one gather write where the handle
+    /// supports it, without first joining them into one buffer. Only bytes
+    /// that cannot be written immediately are copied.
+    task<void, error> write(std::span<const std::span<const char>> pieces);
+
+    /// Writes `length` bytes of the file `fd` starting at `offset`, through
+    /// sendfile() where the stream has a descriptor that supports it, so the
+    /// bytes do not pass through user space. Whenever the socket is full, or
+    /// earlier writes are still queued, one chunk is copied through a pooled
+    /// buffer and write() instead, which waits for the stream to drain.
+    /// Returns the bytes sent, fewer than `length` only at end of file.
+    /// Other writes must not be started until it completes.
+    task<std::size_t, error> send_file(int fd, std::int64_t offset, std::size_t length);
+
+    /// Buffers later writes instead of sending each one, so a burst of small
+    /// writes goes out in a few syscalls. Corked writes complete as soon as
+    /// their bytes are buffered; the buffer is sent once it reaches
+    /// `threshold` bytes, at the end of the current loop iteration, or on
+    /// flush() or uncork(). A failed send is reported by the next write()
+    /// or flush().
+    void cork(std::size_t threshold = 64 * 1024);
+
+    /// Stops buffering writes and sends whatever is buffered right away.
+    void uncork();
+
+    /// Sends the corked buffer and waits until every corked byte has been
+    /// written; completes immediately if the stream was never corked.
+    task<void, error> flush();
+
+    /// Bytes accepted by write() that the kernel has not taken yet, including
+    /// corked and queued writes; a writer can wait on this for backpressure.
+    std::size_t queued_bytes() const noexcept;
+
+    /// Caps the writes handed to libuv at once (16 by default); later
+    /// writes wait, already copied, until an earlier one completes.
+    void set_max_inflight_writes(std::size_t limit);
+
     /// Try a non-blocking write; returns bytes written or error.
     result<std::size_t> try_write(std::span<const char> data);
 
@@ -79,9 +136,28 @@ public:
 protected:
     explicit stream(unique_handle<Self> self) noexcept;
 
+    /// While corked, also sends the buffer as soon as a write ends a line.
+    void set_line_flush(bool enabled);
+
+    /// Buffers `frame` to be sent at the end of the loop iteration, without
+    /// waiting, and replaces the previous frame if that is still buffered.
+    /// Returns false, dropping the frame, while earlier writes have not
+    /// reached the kernel.
+    bool write_frame(std::span<const char> frame);
+
     unique_handle<Self> self;
 };
 
+/// Forwards everything read from `from` to `to` until `from` reaches end of
+/// file, and returns the bytes forwarded. On Linux, when both streams have a
+/// descriptor, the bytes move through a kernel pipe with splice() and never
+/// enter user space, except for a chunk copied whenever `to` is full or has
+/// writes queued. Elsewhere, or for descriptors splice() does not support,
+/// chunks are relayed through the read buffer of `from`, which is only
+/// consumed once `to` has taken them. `to` is not closed at the end, and
+/// other reads of `from` or writes to `to` must not be started meanwhile.
+task<std::size_t, error> splice(stream& from, stream& to);
+
 template <typename Stream>
 class acceptor {
 public:
@@ -102,6 +178,13 @@ public:
     /// Accept one connection; only one pending accept is allowed at a time.
     task<Stream, error> accept();
 
+    /// Accept every connection already queued, up to `max`, waiting only
+    /// while none is. Under connection storms a wakeup typically queues
+    /// several, and this hands them over in one resumption instead of one
+    /// accept() each. An error behind accepted connections is reported by
+    /// the next call.
+    task<small_vector<Stream>, error> accept_batch(std::size_t max = 64);
+
     /// Stop pending accept which will complete with error::operation_aborted. If no accept is
     /// pending, the next accept() will complete with error instead.
     error stop();
@@ -153,6 +236,22 @@ public:
 
     explicit pipe(unique_handle<Self> self) noexcept;
 
+    /// Writes `data` with `descriptors` attached (SCM_RIGHTS), so the peer
+    /// gets its own descriptors for the same open files, sockets or shared
+    /// mappings. They travel with the first byte of `data`, which must not be
+    /// empty; the receiving pipe must be opened with `ipc` set, or the kernel
+    /// drops them. Waits for earlier writes to reach the kernel first, and
+    /// other writes must not be started until it completes. Unix only.
+    task<void, error> write_with_descriptors(std::span<const char> data,
+                                             std::span<const int> descriptors);
+
+    /// Descriptors received on an `ipc` pipe and not yet taken. They arrive
+    /// as the bytes they were sent with are read.
+    std::size_t pending_descriptors() noexcept;
+
+    /// Takes the oldest received descriptor; the caller owns and closes it.
+    result<int> take_descriptor();
+
 private:
     friend class process;
 
@@ -198,6 +297,21 @@ public:
 
     /// Query the local address/port of a listening acceptor.
     static result<int> local_port(acceptor& acc);
+
+    /// Listen on host/port once per worker of `group`, each listener bound
+    /// with SO_REUSEPORT on and owned by its worker's loop, so the kernel
+    /// spreads incoming connections across the workers instead of one loop
+    /// accepting them all. `serve` is spawned on every worker with that
+    /// worker's acceptor once all of them are bound.
+    ///
+    /// Blocks until every listener is bound; on the first failure none is
+    /// served and its error is returned. Must not be called from one of the
+    /// group's workers.
+    static error listen_sharded(std::string_view host,
+                                int port,
+                                options opts,
+                                loop_group& group,
+                                std::function<task<>(acceptor)> serve);
 };
 
 /// TTY/console wrapper.
@@ -217,11 +331,26 @@ public:
 
     enum class vterm_state { supported, unsupported };
 
+    /// How writes are batched. Unbuffered, each write() is its own TTY
+    /// write, which is slow on Windows consoles. Buffered writes complete
+    /// once copied and go out together when `buffer_size` bytes pile up,
+    /// at the end of the loop iteration, or on flush(); line buffering
+    /// also sends whenever a write ends a line.
+    enum class buffering { none, line, full };
+
     struct options {
         /// Whether the TTY is readable (stdin).
-        bool readable = false;
+        bool readable;
+
+        buffering buffer;
 
-        constexpr options(bool readable = false) : readable(readable) {}
+        /// Bytes buffered before a write waits for them to be sent.
+        std::size_t buffer_size;
+
+        constexpr options(bool readable = false,
+                          buffering buffer = buffering::none,
+                          std::size_t buffer_size = 64 * 1024) :
+            readable(readable), buffer(buffer), buffer_size(buffer_size) {}
     };
 
     /// Wrap a console file descriptor.
@@ -244,6 +373,13 @@ public:
     /// Query global virtual terminal processing state.
     static result<vterm_state> get_vterm_state();
 
+    /// Draws a progress frame, such as "\r[=====>    ] 52%", without
+    /// waiting. Frames go out at the end of the loop iteration, and a frame
+    /// still buffered then is replaced by the next, so only the latest is
+    /// drawn. While the terminal has not taken earlier output the frame is
+    /// dropped and false returned; write() a final state that must appear.
+    bool redraw(std::string_view frame);
+
 private:
     explicit console(unique_handle<Self> self) noexcept;
 };
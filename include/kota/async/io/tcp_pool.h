@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/io/stream.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// Keeps idle connected tcp streams per (host, port), so short exchanges with
+/// the same endpoint reuse a connection instead of paying a handshake each.
+///
+/// acquire() hands out the most recently returned idle connection that still
+/// looks healthy, or connects a new one; the lease puts the connection back
+/// when it is destroyed. A connection is healthy while it is readable and
+/// writable, has no unread or unsent bytes, and the peer has neither closed
+/// it nor sent anything since it went idle.
+///
+/// The pool must outlive its leases and is used on its loop's thread only.
+class tcp_pool {
+public:
+    struct options {
+        /// Idle connections kept per endpoint; extra returns are closed.
+        std::size_t max_idle;
+
+        /// Idle connections older than this are closed instead of reused.
+        std::chrono::milliseconds idle_timeout;
+
+        constexpr options(std::size_t max_idle = 8,
+                          std::chrono::milliseconds idle_timeout = std::chrono::seconds(30)) :
+            max_idle(max_idle), idle_timeout(idle_timeout) {}
+    };
+
+    /// One connection taken from the pool.
+    class lease {
+    public:
+        lease() noexcept = default;
+
+        lease(const lease&) = delete;
+        lease& operator=(const lease&) = delete;
+
+        lease(lease&& other) noexcept;
+        lease& operator=(lease&& other) noexcept;
+
+        /// Returns the connection to the pool unless discard() was called.
+        ~lease();
+
+        tcp& operator*() noexcept {
+            return conn;
+        }
+
+        tcp* operator->() noexcept {
+            return &conn;
+        }
+
+        /// Whether the connection came from the idle set rather than a new
+        /// connect; a request that fails on a reused one may be retried.
+        bool reused() const noexcept {
+            return was_idle;
+        }
+
+        /// Closes the connection instead of returning it, e.g. after a
+        /// protocol error left it in an unknown state.
+        void discard() noexcept;
+
+    private:
+        friend class tcp_pool;
+
+        lease(tcp_pool* pool, std::string key, tcp conn, bool was_idle) noexcept;
+
+        tcp_pool* pool = nullptr;
+        std::string key;
+        tcp conn;
+        bool was_idle = false;
+    };
+
+    explicit tcp_pool(options opts = options(), event_loop& loop = event_loop::current());
+
+    tcp_pool(const tcp_pool&) = delete;
+    tcp_pool& operator=(const tcp_pool&) = delete;
+
+    ~tcp_pool();
+
+    /// Leases a connection to `host`:`port`, reusing an idle one when one is
+    /// healthy and connecting through tcp::connect() otherwise.
+    task<lease, error> acquire(std::string_view host, int port);
+
+    /// Idle connections across all endpoints.
+    std::size_t idle_count() const noexcept;
+
+    /// Closes every idle connection; leased ones are unaffected.
+    void clear() noexcept;
+
+private:
+    struct idle_conn {
+        tcp conn;
+        std::uint64_t since = 0;
+    };
+
+    void release(std::string key, tcp conn);
+
+    options opts;
+    event_loop* loop;
+    std::unordered_map<std::string, std::vector<idle_conn>> idle;
+};
+
+}  // namespace kota
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include "kota/support/function_traits.h"
+#include "kota/support/functional.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// A pool of CPU worker threads, separate from libuv's threadpool.
+///
+/// queue() shares libuv's small threadpool with filesystem and DNS requests,
+/// so long computations there delay unrelated I/O. Work submitted here runs
+/// on the pool's own threads instead. Each worker keeps a work-stealing
+/// deque: submissions land in a shared queue, idle workers take a share of
+/// it into their own deque, and workers that run dry steal from the others.
+///
+/// Usage:
+///   thread_pool pool(4);
+///   auto digest = co_await pool.submit([&] { return sha256(buffer); }).or_fail();
+///
+/// Thread safety:
+///   - submit() must be called on the loop thread that awaits the result;
+///     the job itself runs on a pool thread, and the awaiting task resumes
+///     back on its loop.
+///   - The destructor finishes every queued job, then joins the workers. It
+///     must not run on one of the pool's threads.
+class thread_pool {
+public:
+    /// Starts `workers` threads. Zero selects std::thread::hardware_concurrency().
+    explicit thread_pool(std::size_t workers = 0);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool();
+
+    /// Number of worker threads.
+    std::size_t size() const noexcept;
+
+    /// Runs `fn` on a pool thread and completes on `loop` once it returns.
+    /// Cancelling before a worker picks the job up drops it; once it has
+    /// started it runs to completion and the cancellation is reported after.
+    task<void, error> submit(loop_callback fn, event_loop& loop = event_loop::current());
+
+    /// Runs `fn` on a pool thread and returns its value.
+    template <typename Fn, typename R = callable_return_t<Fn>>
+        requires std::is_invocable_v<Fn> && (!std::is_void_v<R>)
+    task<R, error> submit(Fn fn, event_loop& loop = event_loop::current()) {
+        std::optional<R> ret;
+        co_await submit(loop_callback([&] { ret.emplace(fn()); }), loop).or_fail();
+        co_return std::move(*ret);
+    }
+
+    /// Opaque implementation detail. Defined in thread_pool.cpp.
+    struct self;
+
+private:
+    std::unique_ptr<self> self;
+};
+
+}  // namespace kota
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "kota/async/io/fs_event.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+#include "kota/async/vocab/owned.h"
+
+namespace kota {
+
+class event_loop;
+
+/// Watches a whole directory tree through one kernel watch source.
+///
+/// On Linux it owns a single inotify descriptor with one watch per
+/// directory, adding watches as directories are created or moved into the
+/// tree and dropping them as they go away, so no uv handle is allocated per
+/// directory. On macOS and Windows it is one recursive fs_event (an FSEvents
+/// stream, or ReadDirectoryChangesW), which already covers the subtree.
+///
+/// Changes are reported like fs_event::wait_batch(), with paths relative to
+/// the root. An empty path means the kernel dropped events or the root
+/// itself went away; the consumer should rescan the tree.
+class tree_watcher {
+public:
+    tree_watcher() noexcept;
+
+    tree_watcher(const tree_watcher&) = delete;
+    tree_watcher& operator=(const tree_watcher&) = delete;
+
+    tree_watcher(tree_watcher&& other) noexcept;
+    tree_watcher& operator=(tree_watcher&& other) noexcept;
+
+    ~tree_watcher();
+
+    struct Self;
+    Self* operator->() noexcept;
+
+    static result<tree_watcher> create(event_loop& loop = event_loop::current());
+
+    /// Starts watching `root` and every directory below it. Changes are
+    /// collected from the start of the call, even while the tree is still
+    /// being scanned.
+    task<void, error> start(std::string root);
+
+    error stop();
+
+    /// Await changes and return every one collected since the last call;
+    /// see fs_event::wait_batch().
+    task<std::vector<fs_event::change>, error> wait_batch(std::chrono::milliseconds window = {});
+
+private:
+    explicit tree_watcher(unique_handle<Self> self) noexcept;
+
+    unique_handle<Self> self;
+};
+
+}  // namespace kota
@@ -51,6 +51,25 @@ public:
         int port = 0;
     };
 
+    /// One slot of a recv_batch(). The caller points `buffer` at storage for
+    /// the payload; recv_batch() fills in the rest. Reusing the same slots
+    /// across calls reuses the address strings too.
+    struct datagram {
+        std::span<char> buffer;
+
+        /// Payload bytes stored in `buffer`; a longer datagram is cut to
+        /// fit and marked partial.
+        std::size_t size = 0;
+
+        /// Size of each datagram the payload holds: recv_segmented() may
+        /// receive several back to back, the last one possibly shorter.
+        /// Equal to `size` for a single datagram.
+        std::size_t segment_size = 0;
+
+        endpoint peer;
+        recv_flags flags;
+    };
+
     /// Multicast membership operation.
     enum class membership {
         join,  // join multicast group
@@ -105,6 +124,35 @@ public:
 
     error try_send(std::span<const char> data);
 
+    /// Sends as many of `datagrams` as the socket takes right now, in order,
+    /// with one sendmmsg() per 64 datagrams where supported; returns how
+    /// many were sent.
+    result<std::size_t> try_send_batch(std::span<const std::span<const char>> datagrams,
+                                       std::string_view host,
+                                       int port);
+
+    result<std::size_t> try_send_batch(std::span<const std::span<const char>> datagrams);
+
+    /// Sends every one of `datagrams`: as many as possible through
+    /// try_send_batch(), then the rest one send() at a time.
+    task<void, error> send_batch(std::span<const std::span<const char>> datagrams,
+                                 std::string_view host,
+                                 int port);
+
+    task<void, error> send_batch(std::span<const std::span<const char>> datagrams);
+
+    /// Sends `data` as datagrams of `segment_size` bytes each, the last one
+    /// possibly shorter. On Linux with UDP_SEGMENT, up to 64 of them go out
+    /// in one sendmsg() and the kernel (or the NIC) cuts them apart. Where
+    /// that is unavailable, or once the socket is full or has sends queued,
+    /// the rest go through send_batch().
+    task<void, error> send_segmented(std::span<const char> data,
+                                     std::size_t segment_size,
+                                     std::string_view host,
+                                     int port);
+
+    task<void, error> send_segmented(std::span<const char> data, std::size_t segment_size);
+
     result<endpoint> getsockname() const;
 
     result<endpoint> getpeername() const;
@@ -138,6 +186,21 @@ public:
 
     task<recv_result, error> recv();
 
+    /// Fills up to batch.size() slots with datagrams that are already
+    /// queued or arrive in the next read pass, and returns how many were
+    /// filled (at least one). With create_options::recvmmsg the socket reads
+    /// them through recvmmsg() into one preallocated buffer, copying each
+    /// payload once, into its slot.
+    task<std::size_t, error> recv_batch(std::span<datagram> batch);
+
+    /// Receives into `slot`. On Linux the first call turns on UDP_GRO, and
+    /// from then on the kernel may coalesce consecutive equal-size datagrams
+    /// from one peer into a single receive; `slot.segment_size` tells where
+    /// they split. Give it a buffer of 64 KiB to take whole coalesced
+    /// payloads. Elsewhere this is one recv(). Once GRO is on, recv() and
+    /// recv_batch() may see coalesced payloads too, so do not mix them.
+    task<void, error> recv_segmented(datagram& slot);
+
 private:
     explicit udp(unique_handle<Self> self) noexcept;
 
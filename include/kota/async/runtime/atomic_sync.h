@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <source_location>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/frame.h"
+
+namespace kota {
+
+namespace detail {
+
+class atomic_waiter;
+
+/// Heap-allocated wait record shared between a parked awaiter and the
+/// lock-free waiter stack of an atomic_event or atomic_semaphore.
+///
+/// The record outlives the awaiter when the awaiter is cancelled while still
+/// linked, so whoever later walks the stack can inspect `status` safely. It
+/// carries two references: one for the awaiter and one for the stack.
+struct atomic_wait_ticket {
+    enum Status : std::uint8_t {
+        Waiting,
+        Woken,
+        Cancelled,
+    };
+
+    std::atomic<std::uint8_t> status{Waiting};
+    std::atomic<std::uint8_t> refs{2};
+
+    /// Keeps the waiter's loop alive while it is parked. Written before the
+    /// ticket is published and used only by whichever side wins the
+    /// transition out of Waiting.
+    std::optional<relay> wakeup;
+    atomic_waiter* op = nullptr;
+
+    atomic_wait_ticket* next = nullptr;
+
+    /// Claims the waiter and sends its completion to its own loop through
+    /// the relay. Returns false if the waiter was cancelled first.
+    bool wake();
+
+    void release() noexcept {
+        if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+/// Awaiter base for the cross-loop primitives. The coroutine always
+/// completes on the event loop it was suspended on.
+class atomic_waiter : public system_op {
+public:
+    atomic_waiter();
+
+    atomic_waiter(const atomic_waiter&) = delete;
+    atomic_waiter& operator=(const atomic_waiter&) = delete;
+
+    ~atomic_waiter();
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_resume() const noexcept {}
+
+protected:
+    /// Allocates the ticket for this wait, bound to the current loop.
+    atomic_wait_ticket* make_ticket();
+
+    /// Frees a ticket that lost the race to be published.
+    void discard_ticket() noexcept;
+
+    /// Wires this op under `parent` after its ticket has been published.
+    void link(async_node* parent, std::source_location location);
+
+    /// Called on the waiter's loop when a wakeup arrives after the waiter was
+    /// cancelled, so a semaphore permit handed to it is not lost.
+    void (*forfeit)(atomic_waiter& self) = nullptr;
+
+private:
+    friend struct atomic_wait_ticket;
+
+    static void on_cancel(system_op* op);
+
+    atomic_wait_ticket* ticket = nullptr;
+};
+
+}  // namespace detail
+
+/// Manual-reset event that may be set from any thread and awaited from
+/// coroutines on any event loop.
+///
+/// Waiters are kept on a lock-free stack. set() detaches the whole stack and
+/// resumes every waiter on its own loop through a relay, so a waiter never
+/// runs on the setter's thread and a parked waiter keeps its loop running. A waiter that is cancelled while parked
+/// leaves a small record on the stack until the next set().
+///
+/// Thread safety: every member may be called from any thread. wait() must be
+/// awaited on a thread that is running an event_loop.
+class atomic_event {
+public:
+    explicit atomic_event(bool signaled = false) noexcept;
+
+    atomic_event(const atomic_event&) = delete;
+    atomic_event& operator=(const atomic_event&) = delete;
+
+    ~atomic_event();
+
+    struct wait_awaiter : detail::atomic_waiter {
+        explicit wait_awaiter(atomic_event& owner) noexcept : owner(&owner) {}
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> awaiter,
+                           std::source_location location = std::source_location::current()) {
+            return suspend(&awaiter.promise(), location);
+        }
+
+    private:
+        bool suspend(async_node* parent, std::source_location location);
+
+        atomic_event* owner = nullptr;
+    };
+
+    wait_awaiter wait() noexcept {
+        return wait_awaiter(*this);
+    }
+
+    /// Signals the event and resumes every waiter parked so far.
+    void set();
+
+    /// Clears the signal. Has no effect on waiters that are already parked.
+    void reset() noexcept;
+
+    bool is_set() const noexcept;
+
+private:
+    /// 0: unset with no waiters. `signaled`: set. Otherwise the top of the
+    /// waiter stack.
+    constexpr static std::uintptr_t signaled = 1;
+
+    std::atomic<std::uintptr_t> state;
+};
+
+/// Counting semaphore that may be released from any thread and acquired
+/// from coroutines on any event loop.
+///
+/// The permit count and the waiter stack share one atomic word: an odd value
+/// encodes `count * 2 + 1` with no waiters, an even value points to the top
+/// of the stack of parked acquirers (no permits left). release() hands a
+/// permit to the oldest live waiter and resumes it on its own loop through a
+/// relay.
+///
+/// Thread safety: every member may be called from any thread. acquire() must
+/// be awaited on a thread that is running an event_loop.
+class atomic_semaphore {
+public:
+    explicit atomic_semaphore(std::ptrdiff_t initial = 0) noexcept;
+
+    atomic_semaphore(const atomic_semaphore&) = delete;
+    atomic_semaphore& operator=(const atomic_semaphore&) = delete;
+
+    ~atomic_semaphore();
+
+    struct acquire_awaiter : detail::atomic_waiter {
+        explicit acquire_awaiter(atomic_semaphore& owner) noexcept : owner(&owner) {
+            this->forfeit = [](atomic_waiter& self) {
+                static_cast<acquire_awaiter&>(self).owner->release();
+            };
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> awaiter,
+                           std::source_location location = std::source_location::current()) {
+            return suspend(&awaiter.promise(), location);
+        }
+
+    private:
+        bool suspend(async_node* parent, std::source_location location);
+
+        atomic_semaphore* owner = nullptr;
+    };
+
+    acquire_awaiter acquire() noexcept {
+        return acquire_awaiter(*this);
+    }
+
+    bool try_acquire() noexcept;
+
+    void release(std::ptrdiff_t n = 1);
+
+    /// Permits currently available; zero while acquirers are parked.
+    std::ptrdiff_t available() const noexcept;
+
+private:
+    void release_one();
+
+    /// Hands one permit to a waiter on the detached chain `waiters`, pushes
+    /// the rest back, and returns true; returns false if every waiter on the
+    /// chain had been cancelled.
+    bool hand_off(detail::atomic_wait_ticket* waiters);
+
+    std::atomic<std::uintptr_t> state;
+};
+
+}  // namespace kota
@@ -0,0 +1,575 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/sync.h"
+#include "kota/async/runtime/task.h"
+
+namespace kota {
+
+namespace detail {
+
+/// Fixed-capacity FIFO used as channel storage. Slots are constructed on
+/// push and destroyed on pop, so T does not need to be default-constructible.
+template <typename T>
+class channel_ring {
+public:
+    explicit channel_ring(std::size_t capacity) :
+        slots(capacity == 0 ? nullptr : new std::optional<T>[capacity]), capacity_(capacity) {}
+
+    std::size_t size() const noexcept {
+        return count;
+    }
+
+    std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    bool empty() const noexcept {
+        return count == 0;
+    }
+
+    bool full() const noexcept {
+        return count == capacity_;
+    }
+
+    template <typename U>
+    void push(U&& value) {
+        assert(!full() && "channel_ring::push on full ring");
+        slots[(head + count) % capacity_].emplace(std::forward<U>(value));
+        count += 1;
+    }
+
+    T pop() {
+        assert(!empty() && "channel_ring::pop on empty ring");
+        auto& slot = slots[head];
+        T value = std::move(*slot);
+        slot.reset();
+        head = (head + 1) % capacity_;
+        count -= 1;
+        return value;
+    }
+
+private:
+    std::unique_ptr<std::optional<T>[]> slots;
+    std::size_t capacity_ = 0;
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+
+}  // namespace detail
+
+/// Bounded FIFO channel between coroutines on the same event loop.
+///
+/// `co_await send(value)` suspends while the buffer is full and
+/// `co_await recv()` suspends while it is empty. A value sent while a
+/// receiver is parked is handed straight to that receiver, and a parked
+/// sender's value is moved into the slot a receive frees, so neither side
+/// takes an extra trip through the buffer or the ready queue. A capacity of
+/// zero makes every send a rendezvous with a receiver.
+///
+/// Like the other sync primitives, resuming a parked peer happens
+/// synchronously inside the call that unblocked it.
+///
+/// Usage:
+///   channel<int> ch(16);
+///   co_await ch.send(1);          // false once the channel is closed
+///   auto value = co_await ch.recv();  // std::nullopt once closed and drained
+///
+/// Thread safety: none. Use shared_channel to cross threads.
+template <typename T>
+class channel {
+    static_assert(std::is_move_constructible_v<T>, "channel<T> requires a movable T");
+
+    /// One wait queue per side. sync_primitive keeps a single queue, so the
+    /// channel owns two and exposes the protected helpers it needs.
+    struct wait_queue : sync_primitive {
+        wait_queue() : sync_primitive(sync_primitive::Kind::Channel) {}
+
+        using sync_primitive::drain_waiter_snapshot;
+        using sync_primitive::has_waiters;
+        using sync_primitive::resume_waiter;
+
+        /// Pops the first waiter whose task can still be resumed.
+        template <typename Awaiter>
+        Awaiter* pop_armed() noexcept {
+            while(auto* link = pop_waiter()) {
+                auto* waiter = static_cast<Awaiter*>(link);
+                if(waiter->is_armed()) {
+                    return waiter;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+public:
+    explicit channel(std::size_t capacity,
+                     std::source_location location = std::source_location::current()) :
+        buffer(capacity) {
+        senders.location = location;
+        receivers.location = location;
+    }
+
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+
+    struct send_awaiter : waiter_link {
+        /// Reuses EventWaiter kind — see semaphore::acquire_awaiter comment.
+        send_awaiter(channel& owner, T value) :
+            waiter_link(async_node::NodeKind::EventWaiter), owner(&owner),
+            value(std::move(value)) {}
+
+        bool await_ready() {
+            if(owner->closed) {
+                return true;
+            }
+            accepted = owner->push(std::move(*value));
+            return accepted;
+        }
+
+        template <typename Promise>
+        auto await_suspend(
+            std::coroutine_handle<Promise> awaiter,
+            std::source_location location = std::source_location::current()) noexcept {
+            owner->senders.insert(this);
+            return link_continuation(&awaiter.promise(), location);
+        }
+
+        /// True if the value entered the channel, false if it was closed.
+        bool await_resume() noexcept {
+            return accepted;
+        }
+
+        /// True while the awaiting task is parked and can still be resumed.
+        bool is_armed() const noexcept {
+            return this->awaiter && !this->awaiter->is_cancelled();
+        }
+
+    private:
+        friend class channel;
+
+        channel* owner = nullptr;
+        std::optional<T> value;
+        bool accepted = false;
+    };
+
+    struct recv_awaiter : waiter_link {
+        /// Reuses EventWaiter kind — see semaphore::acquire_awaiter comment.
+        explicit recv_awaiter(channel& owner) :
+            waiter_link(async_node::NodeKind::EventWaiter), owner(&owner) {}
+
+        bool await_ready() {
+            slot = owner->try_recv();
+            return slot.has_value() || owner->closed;
+        }
+
+        template <typename Promise>
+        auto await_suspend(
+            std::coroutine_handle<Promise> awaiter,
+            std::source_location location = std::source_location::current()) noexcept {
+            owner->receivers.insert(this);
+            return link_continuation(&awaiter.promise(), location);
+        }
+
+        /// The received value, or std::nullopt if the channel was closed.
+        std::optional<T> await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return std::move(slot);
+        }
+
+        /// True while the awaiting task is parked and can still be resumed.
+        bool is_armed() const noexcept {
+            return this->awaiter && !this->awaiter->is_cancelled();
+        }
+
+    private:
+        friend class channel;
+
+        channel* owner = nullptr;
+        std::optional<T> slot;
+    };
+
+    send_awaiter send(T value) {
+        return send_awaiter(*this, std::move(value));
+    }
+
+    recv_awaiter recv() noexcept {
+        return recv_awaiter(*this);
+    }
+
+    /// Sends without suspending. `value` is only moved from on success.
+    template <typename U = T>
+        requires std::constructible_from<T, U&&>
+    bool try_send(U&& value) {
+        if(closed) {
+            return false;
+        }
+        return push(std::forward<U>(value));
+    }
+
+    /// Receives without suspending. Returns std::nullopt when nothing is
+    /// available, whether or not the channel is closed.
+    std::optional<T> try_recv() {
+        if(!buffer.empty()) {
+            std::optional<T> out(buffer.pop());
+            // Refill the freed slot from a parked sender before waking it.
+            if(auto* sender = senders.template pop_armed<send_awaiter>()) {
+                buffer.push(std::move(*sender->value));
+                sender->accepted = true;
+                senders.resume_waiter(sender);
+            }
+            return out;
+        }
+
+        // Unbuffered channel, or a buffer drained by direct handoffs.
+        if(auto* sender = senders.template pop_armed<send_awaiter>()) {
+            std::optional<T> out(std::move(*sender->value));
+            sender->accepted = true;
+            senders.resume_waiter(sender);
+            return out;
+        }
+
+        return std::nullopt;
+    }
+
+    /// Wakes every parked receiver with std::nullopt and every parked sender
+    /// with false. Values already buffered can still be received.
+    void close() noexcept {
+        closed = true;
+        receivers.drain_waiter_snapshot([this](waiter_link* link) {
+            auto* receiver = static_cast<recv_awaiter*>(link);
+            if(receiver->is_armed()) {
+                receivers.resume_waiter(receiver);
+            }
+        });
+        senders.drain_waiter_snapshot([this](waiter_link* link) {
+            auto* sender = static_cast<send_awaiter*>(link);
+            if(sender->is_armed()) {
+                senders.resume_waiter(sender);
+            }
+        });
+    }
+
+    bool is_closed() const noexcept {
+        return closed;
+    }
+
+    /// Number of buffered values; excludes values held by parked senders.
+    std::size_t size() const noexcept {
+        return buffer.size();
+    }
+
+    std::size_t capacity() const noexcept {
+        return buffer.capacity();
+    }
+
+private:
+    template <typename U>
+    bool push(U&& value) {
+        // A parked receiver implies an empty buffer: hand the value over.
+        if(auto* receiver = receivers.template pop_armed<recv_awaiter>()) {
+            receiver->slot.emplace(std::forward<U>(value));
+            receivers.resume_waiter(receiver);
+            return true;
+        }
+        if(buffer.full()) {
+            return false;
+        }
+        buffer.push(std::forward<U>(value));
+        return true;
+    }
+
+    detail::channel_ring<T> buffer;
+    wait_queue senders;
+    wait_queue receivers;
+    bool closed = false;
+};
+
+/// Bounded FIFO channel that may be shared by coroutines on different event
+/// loops and plain threads.
+///
+/// The buffer is guarded by a std::mutex. A coroutine that finds the
+/// buffer full (or empty) parks on the channel and is woken through a relay
+/// to the event loop it was running on, which also keeps that loop alive
+/// while it waits; it then retries. Values
+/// never leave a sender until they are in the buffer, so cancelling a parked
+/// send or receive cannot lose one.
+///
+/// Thread safety: every member may be called from any thread. send() and
+/// recv() must be awaited on a thread that is running an event_loop. The
+/// channel must outlive every coroutine parked on it.
+template <typename T>
+class shared_channel {
+    static_assert(std::is_move_constructible_v<T>, "shared_channel<T> requires a movable T");
+
+    enum class attempt : std::uint8_t {
+        Done,
+        Closed,
+        Retry,
+    };
+
+    struct parked_list;
+
+    /// A single wakeup request. Lives in the waiting coroutine's frame.
+    struct park_op : system_op {
+        park_op(shared_channel& owner, parked_list& list) : owner(&owner), list(&list) {
+            this->action = &on_cancel;
+        }
+
+        static void on_cancel(system_op* op) {
+            auto* self = static_cast<park_op*>(op);
+            auto& channel = *self->owner;
+            {
+                std::lock_guard lock(channel.mutex);
+                if(!self->queued) {
+                    // A wakeup is already posted; it finishes the op and
+                    // passes the wakeup on since this task will not retry.
+                    return;
+                }
+                self->list->remove(self);
+            }
+            self->wakeup.reset();
+            self->complete();
+        }
+
+        shared_channel* owner = nullptr;
+        parked_list* list = nullptr;
+        /// Keeps the parked coroutine's loop alive and carries its wakeup.
+        std::optional<relay> wakeup;
+        park_op* prev = nullptr;
+        park_op* next = nullptr;
+        bool queued = false;
+    };
+
+    struct parked_list {
+        park_op* head = nullptr;
+        park_op* tail = nullptr;
+
+        void push(park_op* op) noexcept {
+            op->prev = tail;
+            op->next = nullptr;
+            if(tail) {
+                tail->next = op;
+            } else {
+                head = op;
+            }
+            tail = op;
+            op->queued = true;
+        }
+
+        void remove(park_op* op) noexcept {
+            if(op->prev) {
+                op->prev->next = op->next;
+            } else {
+                head = op->next;
+            }
+            if(op->next) {
+                op->next->prev = op->prev;
+            } else {
+                tail = op->prev;
+            }
+            op->prev = nullptr;
+            op->next = nullptr;
+            op->queued = false;
+        }
+
+        park_op* pop() noexcept {
+            auto* op = head;
+            if(op) {
+                remove(op);
+            }
+            return op;
+        }
+    };
+
+    /// Tries `fn` under the lock and parks if it asks to retry.
+    template <typename Fn>
+    struct attempt_awaiter : park_op {
+        attempt_awaiter(shared_channel& owner, parked_list& list, Fn fn) :
+            park_op(owner, list), fn(std::move(fn)) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        bool await_suspend(std::coroutine_handle<Promise> awaiter,
+                           std::source_location location = std::source_location::current()) {
+            auto& channel = *this->owner;
+            std::unique_lock lock(channel.mutex);
+            result = fn();
+            if(result != attempt::Retry) {
+                lock.unlock();
+                if(result == attempt::Done) {
+                    channel.after_attempt(*this->list);
+                }
+                return false;
+            }
+
+            // Link before publishing: once queued, any thread may claim the
+            // op, but its completion only runs later on this loop's thread.
+            this->wakeup.emplace(event_loop::current().create_relay());
+            this->link_continuation(&awaiter.promise(), location);
+            this->list->push(this);
+            return true;
+        }
+
+        attempt await_resume() const noexcept {
+            return result;
+        }
+
+        Fn fn;
+        attempt result = attempt::Retry;
+    };
+
+    template <typename Fn>
+    attempt_awaiter<Fn> try_or_park(parked_list& list, Fn fn) {
+        return attempt_awaiter<Fn>(*this, list, std::move(fn));
+    }
+
+public:
+    explicit shared_channel(std::size_t capacity) : buffer(capacity) {
+        assert(capacity > 0 && "shared_channel requires a non-zero capacity");
+    }
+
+    shared_channel(const shared_channel&) = delete;
+    shared_channel& operator=(const shared_channel&) = delete;
+
+    /// Sends `value`, suspending while the buffer is full. Returns false if
+    /// the channel was closed before the value could be buffered.
+    task<bool> send(T value) {
+        for(;;) {
+            auto outcome = co_await try_or_park(senders, [&] {
+                if(closed) {
+                    return attempt::Closed;
+                }
+                if(buffer.full()) {
+                    return attempt::Retry;
+                }
+                buffer.push(std::move(value));
+                return attempt::Done;
+            });
+            if(outcome != attempt::Retry) {
+                co_return outcome == attempt::Done;
+            }
+        }
+    }
+
+    /// Receives the next value, suspending while the buffer is empty.
+    /// Returns std::nullopt once the channel is closed and drained.
+    task<std::optional<T>> recv() {
+        std::optional<T> out;
+        for(;;) {
+            auto outcome = co_await try_or_park(receivers, [&] {
+                if(!buffer.empty()) {
+                    out.emplace(buffer.pop());
+                    return attempt::Done;
+                }
+                return closed ? attempt::Closed : attempt::Retry;
+            });
+            if(outcome != attempt::Retry) {
+                co_return std::move(out);
+            }
+        }
+    }
+
+    /// Sends without suspending. `value` is only moved from on success.
+    template <typename U = T>
+        requires std::constructible_from<T, U&&>
+    bool try_send(U&& value) {
+        {
+            std::lock_guard lock(mutex);
+            if(closed || buffer.full()) {
+                return false;
+            }
+            buffer.push(std::forward<U>(value));
+        }
+        after_attempt(senders);
+        return true;
+    }
+
+    /// Receives without suspending.
+    std::optional<T> try_recv() {
+        std::optional<T> out;
+        {
+            std::lock_guard lock(mutex);
+            if(buffer.empty()) {
+                return std::nullopt;
+            }
+            out.emplace(buffer.pop());
+        }
+        after_attempt(receivers);
+        return out;
+    }
+
+    /// Wakes every parked coroutine. Parked senders return false; receivers
+    /// drain what is buffered and then return std::nullopt.
+    void close() {
+        std::lock_guard lock(mutex);
+        closed = true;
+        while(auto* op = senders.pop()) {
+            wake(op);
+        }
+        while(auto* op = receivers.pop()) {
+            wake(op);
+        }
+    }
+
+    bool is_closed() const {
+        std::lock_guard lock(mutex);
+        return closed;
+    }
+
+    std::size_t size() const {
+        std::lock_guard lock(mutex);
+        return buffer.size();
+    }
+
+    std::size_t capacity() const noexcept {
+        return buffer.capacity();
+    }
+
+private:
+    /// After a successful send wake one receiver, after a receive one sender.
+    void after_attempt(parked_list& side) {
+        auto& other = &side == &senders ? receivers : senders;
+        std::lock_guard lock(mutex);
+        if(auto* op = other.pop()) {
+            wake(op);
+        }
+    }
+
+    /// Must hold `mutex`; `op` has just been unlinked.
+    void wake(park_op* op) {
+        op->wakeup->send([op] {
+            if(op->is_cancelled()) {
+                // The woken task will not retry; give the wakeup to the next
+                // parked peer on the same side instead of dropping it.
+                auto& channel = *op->owner;
+                std::lock_guard lock(channel.mutex);
+                if(auto* next = op->list->pop()) {
+                    channel.wake(next);
+                }
+            }
+            op->complete();
+        });
+    }
+
+    mutable std::mutex mutex;
+    detail::channel_ring<T> buffer;
+    parked_list senders;
+    parked_list receivers;
+    bool closed = false;
+};
+
+}  // namespace kota
@@ -8,10 +8,19 @@
 #include <limits>
 #include <set>
 #include <source_location>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "kota/support/config.h"
+#include "kota/support/functional.h"
+#include "kota/support/small_vector.h"
+
+/// Set to 0 to make task frames use the global operator new/delete instead of
+/// the per-loop frame pool. Must be consistent across translation units.
+#ifndef KOTA_ASYNC_FRAME_POOL
+#define KOTA_ASYNC_FRAME_POOL 1
+#endif
 
 namespace kota {
 
@@ -22,6 +31,14 @@ namespace detail {
 /// Resume a coroutine and immediately drain any deferred root-frame destruction.
 void resume_and_drain(std::coroutine_handle<> handle);
 
+/// Allocates a task coroutine frame, reusing a block cached by the event loop
+/// running on this thread when one of the right size class is available.
+void* allocate_frame(std::size_t size);
+
+/// Releases a frame obtained from allocate_frame(). `size` must be the value
+/// passed to allocate_frame(); the block may be freed on any thread.
+void deallocate_frame(void* ptr, std::size_t size) noexcept;
+
 }  // namespace detail
 
 /// Type-erased base for all coroutine-related nodes in the task tree.
@@ -39,9 +56,10 @@ public:
         MutexWaiter,
         EventWaiter,
 
-        /// Aggregate operations — when_all / when_any / async_scope.
+        /// Aggregate operations — when_all / when_any / as_completed / async_scope.
         WhenAll,
         WhenAny,
+        WhenEach,
         Scope,
 
         /// Pending libuv I/O — timers, signals, fs, network, etc.
@@ -76,6 +94,10 @@ public:
 
     std::source_location location;
 
+    /// Intrusive link for event_loop's ready queue. Only meaningful while the
+    /// node is queued; the loop clears it before resuming the node.
+    async_node* next_ready = nullptr;
+
     bool is_standard_task() const noexcept {
         return kind == NodeKind::Task;
     }
@@ -121,6 +143,13 @@ public:
     /// Dump the async graph reachable from this node as a DOT (graphviz) graph.
     std::string dump_dot() const;
 
+    /// Calls `visit` once for everything below this node that it is waiting
+    /// on: a pending I/O operation, a queued mutex or event waiter, an
+    /// aggregate none of whose children are pending, or a task that is ready
+    /// to run. The path runs from this node down to that leaf. Used by
+    /// async_profiler; the graph must not change during the walk.
+    void walk_waits(function_ref<void(std::span<const async_node* const>)> visit) const;
+
 private:
     const static async_node* get_awaiter(const async_node* node);
     const static sync_primitive* get_resource_parent(const async_node* node);
@@ -132,6 +161,10 @@ private:
                               std::set<const void*>& visited,
                               std::string& out);
 
+    static void walk_waits(const async_node* node,
+                           std::vector<const async_node*>& path,
+                           function_ref<void(std::span<const async_node* const>)>& visit);
+
 protected:
     explicit async_node(NodeKind k) : kind(k) {}
 
@@ -234,7 +267,7 @@ protected:
     async_node* awaiter = nullptr;
 };
 
-/// Base for when_all / when_any / async_scope.
+/// Base for when_all / when_any / as_completed / async_scope.
 ///
 /// Uses a two-phase protocol in await_suspend:
 ///   1. Arming: link all children, then resume them. During this phase,
@@ -291,8 +324,9 @@ protected:
     /// The parent node that co_awaited this aggregate.
     async_node* awaiter = nullptr;
 
-    /// Child nodes managed by this aggregate (tasks spawned into it).
-    std::vector<async_node*> awaitees;
+    /// Child nodes managed by this aggregate (tasks spawned into it). Small
+    /// aggregates keep them inline, so awaiting one allocates nothing.
+    small_vector<async_node*> awaitees;
 
     /// Number of children that have completed so far.
     std::size_t completed = 0;
@@ -358,6 +392,11 @@ protected:
 
     /// Common await_suspend logic for all aggregate operations.
     /// The caller must populate `awaitees` and set `total` before calling.
+    ///
+    /// Children are started inline, not through the loop. A child that
+    /// completes during its first resume is counted right away; if that
+    /// settles the aggregate, the awaiter is returned for symmetric transfer
+    /// and the whole co_await finishes without a loop hop.
     template <typename Promise>
     std::coroutine_handle<> arm_and_resume(std::coroutine_handle<Promise> awaiter_handle,
                                            std::source_location location) noexcept {
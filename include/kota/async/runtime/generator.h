@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <source_location>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/outcome.h"
+
+namespace kota {
+
+template <typename T, typename E = void>
+class generator;
+
+template <typename T, typename E>
+struct generator_promise : standard_task, promise_result<void, E, void>, promise_exception {
+    using coroutine_handle = std::coroutine_handle<generator_promise>;
+
+    using promise_result<void, E, void>::value;
+
+    /// Item produced by the last co_yield, moved out by the consumer.
+    std::optional<T> current;
+
+    /// The node awaiting next(). Null while the body is parked at a co_yield.
+    async_node* consumer = nullptr;
+
+    auto handle() {
+        return coroutine_handle::from_promise(*this);
+    }
+
+    bool is_done() const noexcept {
+        return state == Finished || state == Failed || state == Cancelled;
+    }
+
+    auto initial_suspend() const noexcept {
+        return std::suspend_always();
+    }
+
+    auto final_suspend() const noexcept {
+        return transition_await(async_node::Finished);
+    }
+
+    generator<T, E> get_return_object() {
+        return generator<T, E>(handle());
+    }
+
+    /// Parks the body and resumes the consumer with the stored item.
+    struct yield_await {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(coroutine_handle handle) const noexcept {
+            auto& promise = handle.promise();
+            auto* parent = std::exchange(promise.consumer, nullptr);
+            assert(parent && parent->is_standard_task() && "generator yielded without a consumer");
+            parent->clear_awaitee();
+            return static_cast<standard_task*>(parent)->handle();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    template <typename U = T>
+        requires std::constructible_from<T, U&&>
+    yield_await yield_value(U&& item) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        current.emplace(std::forward<U>(item));
+        return {};
+    }
+
+    /// co_await fail(args...): write error and transition to Finished.
+    template <typename... Args>
+    auto await_transform(fail_await<Args...>&& fail) noexcept
+        requires (!std::is_void_v<E>) && std::constructible_from<E, Args...> {
+        value.emplace(outcome_error(std::apply(
+            [](auto&&... forwarded) { return E(std::forward<decltype(forwarded)>(forwarded)...); },
+            std::move(fail.args))));
+        return transition_await(async_node::Finished);
+    }
+
+    /// co_await or_fail(outcome): propagate error or unwrap value (non-task).
+    template <typename Outcome>
+    auto await_transform(or_fail_await<Outcome>&& failed) noexcept
+        requires (!std::is_void_v<E>) &&
+                 or_fail_result<Outcome> && std::constructible_from<E, typename Outcome::error_type>
+    {
+        if(failed.result.has_error()) {
+            value.emplace(outcome_error(E(std::move(failed.result).error())));
+            return or_fail_resume_await<Outcome>{std::move(failed.result), true};
+        }
+        return or_fail_resume_await<Outcome>{std::move(failed.result), false};
+    }
+
+    /// co_await task.or_fail(): install error hook for cross-task propagation.
+    template <typename ChildT, typename ChildE>
+    auto await_transform(detail::or_fail_proxy<task<ChildT, ChildE, void>>&& wrapped) noexcept
+        requires (!std::is_void_v<E>) && std::constructible_from<E, ChildE> {
+        using child_task = task<ChildT, ChildE, void>;
+        return detail::or_fail_task_await<generator_promise, E, child_task>{
+            std::move(wrapped.inner).operator co_await()};
+    }
+
+    /// Pass-through for all other awaitables.
+    template <typename Awaitable>
+    decltype(auto) await_transform(Awaitable&& awaitable) noexcept {
+        return std::forward<Awaitable>(awaitable);
+    }
+
+#if KOTA_ASYNC_FRAME_POOL
+    static void* operator new(std::size_t size) {
+        return detail::allocate_frame(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept {
+        detail::deallocate_frame(ptr, size);
+    }
+#endif
+
+    generator_promise() {
+        this->address = handle().address();
+    }
+};
+
+/// Lazy asynchronous sequence. The body runs only while a consumer awaits
+/// next(), and each `co_yield` hands one item back without any buffering.
+///
+/// While next() is pending the generator is the consumer's child in the task
+/// tree, so cancelling the consumer (directly, through when_any, or via
+/// with_token) cancels whatever the generator body is awaiting. The body may
+/// use `co_await fail(...)` and `or_fail()` like a task with error type `E`.
+///
+/// next() yields `std::optional<T>` (empty at the end) when `E` is void and
+/// `outcome<std::optional<T>, E>` otherwise. An exception thrown by the body
+/// is rethrown from next().
+///
+/// Usage:
+///   generator<std::string> lines(pipe& p) {
+///       while(auto chunk = co_await p.read()) {
+///           co_yield std::move(*chunk);
+///       }
+///   }
+///
+///   auto source = lines(p);
+///   while(auto line = co_await source.next()) {
+///       handle(*line);
+///   }
+template <typename T, typename E>
+class generator {
+public:
+    using value_type = T;
+    using error_type = E;
+
+    using promise_type = generator_promise<T, E>;
+
+    using coroutine_handle = std::coroutine_handle<promise_type>;
+
+    using result_type = std::conditional_t<std::is_void_v<E>,
+                                           std::optional<T>,
+                                           outcome<std::optional<T>, E, void>>;
+
+    struct next_awaiter {
+        coroutine_handle h;
+
+        bool await_ready() const noexcept {
+            return !h || h.promise().is_done();
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> awaiter,
+            std::source_location location = std::source_location::current()) noexcept {
+            auto& promise = h.promise();
+            promise.consumer = &awaiter.promise();
+            return promise.link_continuation(&awaiter.promise(), location);
+        }
+
+        result_type await_resume() {
+            if(!h) {
+                return result_type(std::optional<T>());
+            }
+
+            auto& promise = h.promise();
+            if(promise.current.has_value()) {
+                auto item = std::move(promise.current);
+                promise.current.reset();
+                return result_type(std::move(item));
+            }
+
+            promise.rethrow_if_exception();
+            if constexpr(!std::is_void_v<E>) {
+                if(promise.has_error_result()) {
+                    return result_type(outcome_error(std::move(*promise.value).error()));
+                }
+            }
+            return result_type(std::optional<T>());
+        }
+    };
+
+    generator() = default;
+
+    explicit generator(coroutine_handle h) noexcept : h(h) {}
+
+    generator(const generator&) = delete;
+    generator& operator=(const generator&) = delete;
+
+    generator(generator&& other) noexcept : h(std::exchange(other.h, nullptr)) {}
+
+    generator& operator=(generator&& other) noexcept {
+        if(this != &other) {
+            reset();
+            h = std::exchange(other.h, nullptr);
+        }
+        return *this;
+    }
+
+    ~generator() {
+        reset();
+    }
+
+    /// Resumes the body until it yields the next item or finishes.
+    /// Must not be awaited concurrently.
+    next_awaiter next() noexcept {
+        return next_awaiter{h};
+    }
+
+    /// True once the body has finished, failed, or been cancelled.
+    bool done() const noexcept {
+        return !h || h.promise().is_done();
+    }
+
+    async_node* operator->() {
+        return &h.promise();
+    }
+
+private:
+    void reset() noexcept {
+        if(!h) {
+            return;
+        }
+
+        auto& promise = h.promise();
+        if(promise.has_awaitee()) {
+            // The body is suspended inside an operation that has not noticed
+            // its cancellation yet; let it free itself once it does.
+            promise.cancel();
+            promise.detach_as_root();
+        } else {
+            h.destroy();
+        }
+        h = nullptr;
+    }
+
+    coroutine_handle h;
+};
+
+}  // namespace kota
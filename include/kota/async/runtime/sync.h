@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <optional>
 #include <source_location>
+#include <utility>
 
 #include "kota/async/runtime/frame.h"
 #include "kota/async/runtime/task.h"
@@ -15,9 +18,11 @@ class sync_primitive {
 public:
     enum class Kind : std::uint8_t {
         Mutex,
+        SharedMutex,
         Event,
         Semaphore,
         ConditionVariable,
+        Channel,
     };
 
     friend class async_node;
@@ -39,6 +44,10 @@ protected:
         return head != nullptr;
     }
 
+    waiter_link* front_waiter() const noexcept {
+        return head;
+    }
+
     waiter_link* pop_waiter() noexcept {
         auto* link = head;
         if(link) {
@@ -149,6 +158,10 @@ public:
         return true;
     }
 
+    /// Hands ownership straight to the oldest live waiter, which resumes
+    /// before unlock() returns. The mutex stays locked across the handoff,
+    /// so a lock() issued meanwhile queues behind the remaining waiters
+    /// instead of barging ahead of them.
     void unlock() noexcept {
         assert(locked && "mutex::unlock without lock");
         while(auto* waiter = pop_waiter()) {
@@ -163,6 +176,124 @@ private:
     bool locked = false;
 };
 
+/// Reader/writer mutex: any number of shared holders, or one exclusive holder.
+///
+/// Waiters are served in FIFO order and ownership is handed off on release,
+/// as with mutex. A queued exclusive waiter blocks later shared lockers, so
+/// a steady stream of readers cannot starve a writer; when it releases, every
+/// shared waiter queued up to the next exclusive one is admitted together.
+class shared_mutex : public sync_primitive {
+public:
+    shared_mutex(std::source_location location = std::source_location::current()) :
+        sync_primitive(sync_primitive::Kind::SharedMutex) {
+        this->location = location;
+    }
+
+    shared_mutex(const shared_mutex&) = delete;
+    shared_mutex& operator=(const shared_mutex&) = delete;
+
+    struct lock_awaiter : waiter_link {
+        lock_awaiter(shared_mutex& owner, bool exclusive) :
+            waiter_link(async_node::NodeKind::MutexWaiter), owner(&owner), exclusive(exclusive) {}
+
+        bool await_ready() noexcept {
+            return exclusive ? owner->try_lock() : owner->try_lock_shared();
+        }
+
+        template <typename Promise>
+        auto await_suspend(
+            std::coroutine_handle<Promise> awaiter,
+            std::source_location location = std::source_location::current()) noexcept {
+            owner->insert(this);
+            return link_continuation(&awaiter.promise(), location);
+        }
+
+        void await_resume() noexcept {}
+
+    private:
+        friend class shared_mutex;
+
+        shared_mutex* owner = nullptr;
+        bool exclusive = false;
+    };
+
+    lock_awaiter lock() noexcept {
+        return lock_awaiter(*this, true);
+    }
+
+    lock_awaiter lock_shared() noexcept {
+        return lock_awaiter(*this, false);
+    }
+
+    bool try_lock() noexcept {
+        if(writer || readers != 0 || has_waiters()) {
+            return false;
+        }
+        writer = true;
+        return true;
+    }
+
+    bool try_lock_shared() noexcept {
+        if(writer || has_waiters()) {
+            return false;
+        }
+        readers += 1;
+        return true;
+    }
+
+    void unlock() noexcept {
+        assert(writer && "shared_mutex::unlock without lock");
+        writer = false;
+        admit_waiters();
+    }
+
+    void unlock_shared() noexcept {
+        assert(readers != 0 && "shared_mutex::unlock_shared without lock_shared");
+        readers -= 1;
+        if(readers == 0) {
+            admit_waiters();
+        }
+    }
+
+private:
+    /// Grants the lock to waiters at the front of the queue. Ownership is
+    /// recorded before each resume, since a resumed holder may release again
+    /// and re-enter this function before the resume returns.
+    void admit_waiters() noexcept {
+        while(!writer) {
+            auto* front = static_cast<lock_awaiter*>(front_waiter());
+            if(!front) {
+                return;
+            }
+
+            if(front->exclusive) {
+                if(readers != 0) {
+                    return;
+                }
+                pop_waiter();
+                writer = true;
+                if(resume_waiter(front)) {
+                    return;
+                }
+                writer = false;
+                continue;
+            }
+
+            pop_waiter();
+            readers += 1;
+            if(!resume_waiter(front)) {
+                readers -= 1;
+            }
+        }
+    }
+
+    std::size_t readers = 0;
+    bool writer = false;
+};
+
+/// Counting semaphore. An acquisition may take several permits at once,
+/// e.g. one per byte; waiters are served in order, so a large acquisition
+/// is not starved by smaller ones arriving after it.
 class semaphore : public sync_primitive {
 public:
     explicit semaphore(std::ptrdiff_t initial = 0,
@@ -180,11 +311,11 @@ public:
         /// Reuses EventWaiter kind — all waiter_link subtypes share identical
         /// cancel/link_continuation/final_transition logic, so a dedicated
         /// SemaphoreWaiter kind is unnecessary.
-        explicit acquire_awaiter(semaphore& owner) :
-            waiter_link(async_node::NodeKind::EventWaiter), owner(&owner) {}
+        acquire_awaiter(semaphore& owner, std::ptrdiff_t permits) :
+            waiter_link(async_node::NodeKind::EventWaiter), owner(&owner), permits(permits) {}
 
         bool await_ready() noexcept {
-            return owner->try_acquire();
+            return owner->try_acquire(permits);
         }
 
         template <typename Promise>
@@ -198,40 +329,165 @@ public:
         void await_resume() noexcept {}
 
     private:
+        friend class semaphore;
+
         semaphore* owner = nullptr;
+        std::ptrdiff_t permits = 1;
     };
 
-    acquire_awaiter acquire() noexcept {
-        return acquire_awaiter(*this);
+    /// Waits until `n` permits are available and no earlier acquisition is
+    /// still waiting, then takes them.
+    acquire_awaiter acquire(std::ptrdiff_t n = 1) noexcept {
+        assert(n >= 0 && "semaphore::acquire count must be non-negative");
+        return acquire_awaiter(*this, n);
     }
 
-    bool try_acquire() noexcept {
-        if(count <= 0) {
+    /// Takes `n` permits if they are available and nobody is waiting.
+    bool try_acquire(std::ptrdiff_t n = 1) noexcept {
+        if(count < n || has_waiters()) {
             return false;
         }
-        count -= 1;
+        count -= n;
         return true;
     }
 
+    /// Returns `n` permits, waking the waiters they now cover in order.
     void release(std::ptrdiff_t n = 1) {
         assert(n >= 0 && "semaphore::release count must be non-negative");
-        for(std::ptrdiff_t i = 0; i < n; ++i) {
-            if(has_waiters()) {
-                while(auto* waiter = pop_waiter()) {
-                    if(resume_waiter(waiter)) {
-                        break;
-                    }
-                }
-            } else {
-                count += 1;
+        count += n;
+        grant();
+    }
+
+    /// Permits not taken right now.
+    std::ptrdiff_t available() const noexcept {
+        return count;
+    }
+
+private:
+    friend class async_node;
+
+    /// Hands permits to waiters from the front while they suffice. Also
+    /// called when a waiter is cancelled, since it may have been holding
+    /// back smaller ones behind it.
+    void grant() {
+        while(auto* front = static_cast<acquire_awaiter*>(front_waiter())) {
+            const auto permits = front->permits;
+            if(permits > count) {
+                break;
+            }
+            pop_waiter();
+            count -= permits;
+            // The waiter may be gone once resumed; `permits` is a copy.
+            if(!resume_waiter(front)) {
+                count += permits;
             }
         }
     }
 
-private:
     std::ptrdiff_t count = 0;
 };
 
+/// Caps a quantity many tasks share, such as the bytes of file contents
+/// held in memory or of writes queued on streams:
+///
+///   byte_budget budget(256 << 20);
+///   auto lease = co_await budget.reserve(size);
+///   co_await stream.write(data);  // the lease returns the bytes after
+///
+/// Reservations are granted in order. One larger than the whole budget is
+/// cut down to it, so it waits for everything else to come back and then
+/// runs alone rather than never.
+class byte_budget {
+public:
+    /// Bytes reserved from a budget, returned when the lease is destroyed.
+    class lease {
+    public:
+        lease() = default;
+
+        lease(const lease&) = delete;
+        lease& operator=(const lease&) = delete;
+
+        lease(lease&& other) noexcept :
+            owner(std::exchange(other.owner, nullptr)), bytes(std::exchange(other.bytes, 0)) {}
+
+        lease& operator=(lease&& other) noexcept {
+            if(this != &other) {
+                release();
+                owner = std::exchange(other.owner, nullptr);
+                bytes = std::exchange(other.bytes, 0);
+            }
+            return *this;
+        }
+
+        ~lease() {
+            release();
+        }
+
+        std::size_t size() const noexcept {
+            return bytes;
+        }
+
+        /// Returns `n` of the leased bytes early, e.g. as a write drains.
+        void release(std::size_t n) {
+            n = (std::min)(n, bytes);
+            bytes -= n;
+            if(owner && n != 0) {
+                owner->permits.release(static_cast<std::ptrdiff_t>(n));
+            }
+        }
+
+        /// Returns all leased bytes.
+        void release() {
+            release(bytes);
+        }
+
+    private:
+        friend class byte_budget;
+
+        lease(byte_budget& owner, std::size_t bytes) : owner(&owner), bytes(bytes) {}
+
+        byte_budget* owner = nullptr;
+        std::size_t bytes = 0;
+    };
+
+    explicit byte_budget(std::size_t capacity,
+                         std::source_location location = std::source_location::current()) :
+        permits(static_cast<std::ptrdiff_t>(capacity), location), limit(capacity) {}
+
+    byte_budget(const byte_budget&) = delete;
+    byte_budget& operator=(const byte_budget&) = delete;
+
+    /// Waits until `bytes` (at most capacity()) are free and reserves them.
+    task<lease> reserve(std::size_t bytes) {
+        bytes = (std::min)(bytes, limit);
+        co_await permits.acquire(static_cast<std::ptrdiff_t>(bytes));
+        co_return lease(*this, bytes);
+    }
+
+    /// Reserves `bytes` (at most capacity()) if they are free now and no
+    /// reservation is waiting.
+    std::optional<lease> try_reserve(std::size_t bytes) {
+        bytes = (std::min)(bytes, limit);
+        if(!permits.try_acquire(static_cast<std::ptrdiff_t>(bytes))) {
+            return std::nullopt;
+        }
+        return lease(*this, bytes);
+    }
+
+    std::size_t capacity() const noexcept {
+        return limit;
+    }
+
+    /// Bytes not reserved right now.
+    std::size_t available() const noexcept {
+        return static_cast<std::size_t>(permits.available());
+    }
+
+private:
+    semaphore permits;
+    std::size_t limit;
+};
+
 class event : public sync_primitive {
 public:
     explicit event(bool signaled = false,
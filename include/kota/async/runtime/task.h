@@ -3,6 +3,7 @@
 #include <cassert>
 #include <concepts>
 #include <coroutine>
+#include <cstddef>
 #include <cstdlib>
 #include <exception>
 #include <optional>
@@ -351,6 +352,16 @@ struct task_promise_object : standard_task, promise_result<T, E, void>, promise_
         return std::forward<Awaitable>(awaitable);
     }
 
+#if KOTA_ASYNC_FRAME_POOL
+    static void* operator new(std::size_t size) {
+        return detail::allocate_frame(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) noexcept {
+        detail::deallocate_frame(ptr, size);
+    }
+#endif
+
     task_promise_object() {
         this->address = handle().address();
     }
@@ -518,6 +529,18 @@ public:
         }
     }
 
+    /// Moves the value out of a task known to have finished with one,
+    /// without building the outcome result() returns; for aggregates that
+    /// have already checked every child for errors and cancellation.
+    std::add_rvalue_reference_t<T> take_value()
+        requires (!std::is_void_v<T>) {
+        auto&& promise = h.promise();
+        promise.rethrow_if_exception();
+        assert(promise.value.has_value() && promise.value->has_value() &&
+               "take_value() on a task without a value");
+        return std::move(**promise.value);
+    }
+
     auto value() {
         auto&& promise = h.promise();
         promise.rethrow_if_exception();
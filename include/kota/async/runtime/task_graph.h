@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "kota/support/flat_hash_map.h"
+#include "kota/support/small_vector.h"
+#include "kota/async/runtime/sync.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/runtime/when.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// A dependency graph of named units of work, such as a build graph, kept
+/// in dense arrays for scheduling.
+///
+/// Nodes are numbered in the order they are added. Edges are collected by
+/// add_edge(); freeze() then lays them out as CSR adjacency in both
+/// directions, orders the nodes topologically, and computes each node's
+/// level and critical path. Queries other than name lookups need a frozen
+/// graph, and adding nodes or edges thaws it again.
+///
+/// run() schedules work over the frozen graph: a node starts once all its
+/// dependencies have finished, at most `concurrency` run at once, and among
+/// ready nodes the one with the longest remaining critical path goes first,
+/// so long chains start early.
+///
+/// NOT thread-safe; run() must be awaited on one loop.
+class task_graph {
+public:
+    using node_id = std::uint32_t;
+
+    /// Returns the node named `name`, adding it if it is new. `cost`
+    /// estimates its work, in any unit, for critical-path priorities.
+    node_id add_node(std::string_view name, std::uint64_t cost = 1);
+
+    /// Makes `dependent` wait for `dependency`.
+    void add_edge(node_id dependent, node_id dependency);
+
+    void set_cost(node_id node, std::uint64_t cost) noexcept;
+
+    std::optional<node_id> find(std::string_view name) const;
+
+    std::string_view name(node_id node) const noexcept {
+        return names[node];
+    }
+
+    std::size_t size() const noexcept {
+        return names.size();
+    }
+
+    /// Builds adjacency, order, levels and critical paths. Fails with
+    /// invalid_argument, leaving the graph unfrozen, if it has a cycle.
+    error freeze();
+
+    bool frozen() const noexcept {
+        return is_frozen;
+    }
+
+    /// Nodes `node` waits for.
+    std::span<const node_id> dependencies(node_id node) const noexcept;
+
+    /// Nodes waiting for `node`.
+    std::span<const node_id> dependents(node_id node) const noexcept;
+
+    /// Every node, each after all of its dependencies.
+    std::span<const node_id> topological_order() const noexcept {
+        assert(is_frozen && "task_graph::topological_order on unfrozen graph");
+        return order;
+    }
+
+    /// 0 for nodes without dependencies, otherwise one more than the
+    /// highest level among them. Nodes on one level never depend on each
+    /// other.
+    std::uint32_t level(node_id node) const noexcept {
+        assert(is_frozen && "task_graph::level on unfrozen graph");
+        return levels[node];
+    }
+
+    /// Cost of `node` plus the costliest chain of dependents after it.
+    std::uint64_t critical_path(node_id node) const noexcept {
+        assert(is_frozen && "task_graph::critical_path on unfrozen graph");
+        return paths[node];
+    }
+
+    /// Runs `work(id)`, a task<bool>, for every node in `targets` and all
+    /// they depend on, each after its dependencies. A node whose work
+    /// returns false fails, and whatever depends on it is skipped. Returns
+    /// whether every node succeeded. Cancelling run() cancels the work in
+    /// flight and starts no more.
+    template <typename Work>
+    task<bool> run(std::span<const node_id> targets, Work work, std::size_t concurrency = 1) {
+        assert(is_frozen && "task_graph::run on unfrozen graph");
+
+        run_state state;
+        prepare(state, targets);
+        if(state.remaining == 0) {
+            co_return true;
+        }
+
+        const auto workers = (std::min)((std::max)(concurrency, std::size_t(1)), state.remaining);
+        small_vector<task<>> pool;
+        pool.reserve(workers);
+        for(std::size_t i = 0; i < workers; ++i) {
+            pool.push_back(run_worker(state, work));
+        }
+        co_await when_all(std::move(pool));
+        co_return !state.failed;
+    }
+
+private:
+    enum class run_mark : std::uint8_t { idle, waiting, ready, running, done, skipped };
+
+    struct run_state {
+        std::vector<run_mark> marks;
+
+        /// Unfinished dependencies of each waiting node.
+        std::vector<std::uint32_t> blockers;
+
+        /// Ready nodes, a max-heap by critical path.
+        std::vector<node_id> ready;
+
+        /// Nodes of this run not yet done or skipped.
+        std::size_t remaining = 0;
+
+        bool failed = false;
+
+        /// Set whenever a node finishes, to wake idle workers.
+        event progress;
+    };
+
+    template <typename Work>
+    task<> run_worker(run_state& state, Work& work) {
+        while(state.remaining != 0) {
+            auto next = pop_ready(state);
+            if(!next) {
+                state.progress.reset();
+                co_await state.progress.wait();
+                continue;
+            }
+            bool ok = co_await work(*next);
+            finish(state, *next, ok);
+        }
+    }
+
+    /// Marks `targets` and their dependencies as part of the run, and
+    /// queues those without dependencies.
+    void prepare(run_state& state, std::span<const node_id> targets) const;
+
+    std::optional<node_id> pop_ready(run_state& state) const;
+
+    /// Records the outcome of `node`: releases its dependents, or skips
+    /// them all if it failed.
+    void finish(run_state& state, node_id node, bool ok) const;
+
+    bool is_frozen = false;
+
+    std::vector<std::string> names;
+    std::vector<std::uint64_t> costs;
+    flat_hash_map<std::string, node_id> index;
+
+    // (dependent, dependency) pairs as added.
+    std::vector<std::pair<node_id, node_id>> edges;
+
+    // CSR: the dependencies of node i are dependency_targets[dependency_offsets[i],
+    // dependency_offsets[i + 1]), and likewise for dependents.
+    std::vector<std::uint32_t> dependency_offsets;
+    std::vector<node_id> dependency_targets;
+    std::vector<std::uint32_t> dependent_offsets;
+    std::vector<node_id> dependent_targets;
+
+    std::vector<node_id> order;
+    std::vector<std::uint32_t> levels;
+    std::vector<std::uint64_t> paths;
+};
+
+}  // namespace kota
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
+#include <deque>
+#include <functional>
 #include <optional>
 #include <ranges>
 #include <stdexcept>
@@ -11,9 +14,11 @@
 #include <utility>
 #include <variant>
 
+#include "kota/support/functional.h"
 #include "kota/support/memory.h"
 #include "kota/support/small_vector.h"
 #include "kota/support/type_list.h"
+#include "kota/async/io/loop.h"
 #include "kota/async/runtime/frame.h"
 #include "kota/async/runtime/task.h"
 #include "kota/async/vocab/outcome.h"
@@ -186,6 +191,18 @@ Return tuple_visit_at_return(std::size_t index, Tuple& tuple, F&& f) {
 #endif
 }
 
+/// Runs `inner` only after a hop through `lane` of the current loop. Errors
+/// and cancellation of `inner` propagate unchanged.
+template <typename T, typename E>
+task<void, E> start_in_lane(task<T, E> inner, priority lane) {
+    co_await reschedule(lane);
+    if constexpr(std::is_void_v<E>) {
+        co_await std::move(inner);
+    } else {
+        co_await std::move(inner).or_fail();
+    }
+}
+
 }  // namespace detail
 
 template <bool All, typename... Tasks>
@@ -404,7 +421,13 @@ private:
             success_type results;
             results.reserve(tasks.size());
             for(auto& task: tasks) {
-                results.emplace_back(detail::take_success_result<capture_cancel>(task));
+                if constexpr(requires { task.take_value(); }) {
+                    // No child failed or was cancelled, so each holds a value;
+                    // move it straight from the promise into its slot.
+                    results.emplace_back(task.take_value());
+                } else {
+                    results.emplace_back(detail::take_success_result<capture_cancel>(task));
+                }
             }
             return results;
         } else {
@@ -485,6 +508,167 @@ when_any(Tasks...) -> when_any<detail::normalized_task_t<Tasks>...>;
 template <detail::async_range Range>
 when_any(Range) -> when_any<detail::range_tasks<detail::normalized_range_task_t<Range>>>;
 
+/// Streams the results of a range of tasks in the order they complete.
+///
+/// Children start on the first `co_await next()` and keep running while the
+/// consumer works on earlier results. Each call yields the next finished
+/// child as `(index, result)`, where `result` is what `task.result()` returns
+/// (an outcome for tasks with error or cancel channels), and yields
+/// `std::nullopt` once every child has been consumed. Errors do not cancel
+/// siblings; they are delivered with the child that produced them, and an
+/// exception is rethrown by the `next()` that yields it.
+///
+/// An uncaught child cancellation cancels the remaining children and the
+/// consumer, as in when_all. Destroying the stream early cancels the children
+/// that have not finished; those with an operation in flight are detached and
+/// cleaned up once it completes.
+///
+/// Usage:
+///   as_completed stream(std::move(fetches));
+///   while(auto item = co_await stream.next()) {
+///       auto& [index, body] = *item;
+///       co_await parse(index, std::move(body));
+///   }
+template <typename Task>
+class as_completed : public aggregate_op {
+public:
+    using result_type = detail::task_result_t<Task>;
+    using value_type = std::pair<std::size_t, result_type>;
+
+    template <detail::async_range Range>
+        requires std::same_as<detail::normalized_range_task_t<Range>, Task>
+    explicit as_completed(Range range) : aggregate_op(async_node::NodeKind::WhenEach) {
+        if constexpr(std::ranges::sized_range<Range>) {
+            tasks.reserve(std::ranges::size(range));
+        }
+        for(auto&& async: range) {
+            tasks.emplace_back(detail::normalize_task(std::move(async)));
+        }
+    }
+
+    as_completed(const as_completed&) = delete;
+    as_completed& operator=(const as_completed&) = delete;
+
+    ~as_completed() {
+        phase = Phase::Settled;
+        for(std::size_t i = completed; i < awaitees.size(); ++i) {
+            awaitees[i]->cancel();
+        }
+        for(auto& task: tasks) {
+            detail::release_inflight(task);
+        }
+    }
+
+    struct next_awaiter {
+        as_completed* self;
+
+        bool await_ready() const noexcept {
+            return self->deferred == Deferred::None &&
+                   (self->yielded < self->completed || self->yielded == self->tasks.size());
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<Promise> awaiter_handle,
+                          std::source_location location = std::source_location::current()) {
+            return self->suspend(&awaiter_handle.promise(), awaiter_handle, location);
+        }
+
+        std::optional<value_type> await_resume() {
+            return self->take_next();
+        }
+    };
+
+    /// Awaits the next child to finish. Must not be awaited concurrently.
+    next_awaiter next() noexcept {
+        return next_awaiter{this};
+    }
+
+    /// Number of children in the stream.
+    std::size_t size() const noexcept {
+        return tasks.size();
+    }
+
+private:
+    std::coroutine_handle<> suspend(async_node* parent,
+                                    std::coroutine_handle<> parent_handle,
+                                    std::source_location location) {
+        assert(!awaiter && "as_completed::next awaited concurrently");
+
+        if(parent->kind == async_node::NodeKind::Task) {
+            static_cast<standard_task*>(parent)->set_awaitee(this);
+        }
+        awaiter = parent;
+
+        if(!started) {
+            start(location);
+        }
+
+        if(deferred != Deferred::None) {
+            phase = Phase::Settled;
+            for(std::size_t i = completed; i < awaitees.size(); ++i) {
+                awaitees[i]->cancel();
+            }
+            return deliver_deferred();
+        }
+
+        // Children that finished synchronously while starting.
+        if(yielded < completed) {
+            awaiter = nullptr;
+            parent->clear_awaitee();
+            return parent_handle;
+        }
+        return std::noop_coroutine();
+    }
+
+    void start(std::source_location location) {
+        started = true;
+        this->location = location;
+        state = Running;
+        total = tasks.size();
+        awaitees.reserve(total);
+        for(auto& task: tasks) {
+            awaitees.push_back(detail::node_from(task));
+        }
+
+        phase = Phase::Arming;
+        for(auto* child: awaitees) {
+            child->link_continuation(this, location);
+        }
+        for(auto* child: awaitees) {
+            child->resume();
+            if(deferred != Deferred::None) {
+                break;
+            }
+        }
+        if(phase == Phase::Arming) {
+            phase = Phase::Open;
+        }
+    }
+
+    std::optional<value_type> take_next() {
+        if(yielded == tasks.size()) {
+            return std::nullopt;
+        }
+
+        auto* node = awaitees[yielded++];
+        auto it = std::ranges::find(tasks, node, [](Task& task) { return detail::node_from(task); });
+        assert(it != tasks.end() && "as_completed: unknown child");
+        auto index = static_cast<std::size_t>(it - tasks.begin());
+        return value_type(index, detail::take_result(*it));
+    }
+
+    small_vector<Task> tasks;
+
+    /// Number of results handed out; awaitees[0, completed) is in completion order.
+    std::size_t yielded = 0;
+
+    bool started = false;
+};
+
+template <detail::async_range Range>
+as_completed(Range) -> as_completed<detail::normalized_range_task_t<Range>>;
+
 template <typename... Errors>
 class async_scope : public aggregate_op {
 public:
@@ -538,6 +722,15 @@ public:
         spawn(detail::normalize_task(std::move(awaitable)));
     }
 
+    /// Spawns `t` so that, once the scope is awaited, it starts from `lane`
+    /// of the loop's ready queue instead of inline. Background children then
+    /// yield to interactive work that is already waiting.
+    template <typename T, typename E>
+        requires std::is_void_v<E> || is_one_of<E, Errors...>
+    void spawn(task<T, E>&& t, priority lane) {
+        spawn(detail::start_in_lane(std::move(t), lane));
+    }
+
     bool await_ready() const noexcept {
         return awaitees.empty();
     }
@@ -568,4 +761,99 @@ private:
 
 async_scope() -> async_scope<>;
 
+/// async_scope that runs at most `max_inflight` children at a time.
+///
+/// Children are given as factories (callables returning a task) and a
+/// factory is only invoked when a slot frees up, so no more than
+/// `max_inflight` child frames exist at once; queued work costs only the
+/// factory object. Errors, exceptions and cancellation behave as in
+/// async_scope: the first failure cancels the running children and the
+/// queued ones are never started.
+///
+/// A running child may spawn more work into the same scope; it is picked up
+/// by the runners that are still active and never raises the concurrency.
+///
+/// Usage:
+///   bounded_scope scope(16);
+///   for(auto& path: paths) {
+///       scope.spawn([&path] { return stat(path); });
+///   }
+///   co_await scope;
+template <typename... Errors>
+class bounded_scope {
+    using inner_error = detail::aggregated_channel_t<Errors...>;
+    using inner_scope =
+        std::conditional_t<std::is_void_v<inner_error>, async_scope<>, async_scope<inner_error>>;
+
+public:
+    using error_type = typename inner_scope::error_type;
+    using result_type = typename inner_scope::result_type;
+
+    explicit bounded_scope(std::size_t max_inflight) : limit(max_inflight) {
+        assert(max_inflight > 0 && "bounded_scope requires a positive limit");
+    }
+
+    bounded_scope(const bounded_scope&) = delete;
+    bounded_scope& operator=(const bounded_scope&) = delete;
+
+    template <typename Factory,
+              typename Task = std::remove_cvref_t<std::invoke_result_t<Factory&>>>
+        requires detail::is_task_v<Task> && (std::is_void_v<typename Task::error_type> ||
+                                             is_one_of<typename Task::error_type, Errors...>)
+    void spawn(Factory factory) {
+        pending.push_back(
+            [factory = std::move(factory)]() mutable { return run_job(std::move(factory)); });
+    }
+
+    /// Number of children that have been spawned but not started.
+    std::size_t queued() const noexcept {
+        return pending.size();
+    }
+
+    /// Starts up to `max_inflight` runners and awaits them all.
+    inner_scope& operator co_await() & {
+        const auto runners = (std::min)(limit, pending.size());
+        for(std::size_t i = 0; i < runners; ++i) {
+            scope.spawn(runner(*this));
+        }
+        return scope;
+    }
+
+private:
+    using job_task = task<void, error_type>;
+
+    template <typename Factory>
+    static job_task run_job(Factory factory) {
+        using child_task = std::remove_cvref_t<std::invoke_result_t<Factory&>>;
+        if constexpr(std::is_void_v<typename child_task::error_type>) {
+            co_await factory();
+        } else {
+            auto result = co_await factory();
+            if(result.has_error()) {
+                co_await fail(std::move(result).error());
+            }
+        }
+    }
+
+    /// Pulls jobs one at a time until the queue is empty. Each runner keeps
+    /// at most one child frame alive.
+    static job_task runner(bounded_scope& self) {
+        while(!self.pending.empty()) {
+            auto job = std::move(self.pending.front());
+            self.pending.pop_front();
+            if constexpr(std::is_void_v<error_type>) {
+                co_await job();
+            } else {
+                co_await job().or_fail();
+            }
+        }
+    }
+
+    std::size_t limit;
+    std::deque<function<job_task()>> pending;
+    inner_scope scope;
+};
+
+bounded_scope(std::size_t) -> bounded_scope<>;
+
 }  // namespace kota
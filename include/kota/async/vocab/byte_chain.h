@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "kota/support/small_vector.h"
+
+namespace kota {
+
+/// Reference-counted block of bytes shared between a stream's read buffer
+/// and the byte_chains detached from it. Not thread-safe: a slab and every
+/// chain referencing it belong to one thread at a time.
+struct byte_slab {
+    std::uint32_t refs = 1;
+    std::uint32_t capacity = 0;
+
+    char* data() noexcept {
+        return reinterpret_cast<char*>(this + 1);
+    }
+
+    static byte_slab* create(std::size_t capacity) {
+        auto* memory = ::operator new(sizeof(byte_slab) + capacity);
+        auto* slab = new (memory) byte_slab();
+        slab->capacity = static_cast<std::uint32_t>(capacity);
+        return slab;
+    }
+
+    static void acquire(byte_slab* slab) noexcept {
+        slab->refs += 1;
+    }
+
+    static void release(byte_slab* slab) noexcept {
+        if(--slab->refs == 0) {
+            slab->~byte_slab();
+            ::operator delete(slab);
+        }
+    }
+};
+
+/// Bytes taken out of a stream buffer without copying (see stream::detach()).
+/// Holds references to the underlying slabs, so the bytes stay valid until
+/// the chain is destroyed regardless of what the stream reads next.
+class byte_chain {
+public:
+    byte_chain() = default;
+
+    byte_chain(const byte_chain&) = delete;
+    byte_chain& operator=(const byte_chain&) = delete;
+
+    byte_chain(byte_chain&& other) noexcept :
+        pieces(std::move(other.pieces)), total(std::exchange(other.total, 0)) {
+        other.pieces.clear();
+    }
+
+    byte_chain& operator=(byte_chain&& other) noexcept {
+        if(this != &other) {
+            reset();
+            pieces = std::move(other.pieces);
+            other.pieces.clear();
+            total = std::exchange(other.total, 0);
+        }
+        return *this;
+    }
+
+    ~byte_chain() {
+        reset();
+    }
+
+    std::size_t size() const noexcept {
+        return total;
+    }
+
+    bool empty() const noexcept {
+        return total == 0;
+    }
+
+    /// Views over the bytes, in order.
+    small_vector<std::span<const char>> chunks() const {
+        small_vector<std::span<const char>> out;
+        out.reserve(pieces.size());
+        for(auto& piece: pieces) {
+            out.emplace_back(piece.slab->data() + piece.offset, piece.length);
+        }
+        return out;
+    }
+
+    /// Copies the bytes into one string.
+    std::string to_string() const {
+        std::string out;
+        out.resize(total);
+        auto* dest = out.data();
+        for(auto& piece: pieces) {
+            std::memcpy(dest, piece.slab->data() + piece.offset, piece.length);
+            dest += piece.length;
+        }
+        return out;
+    }
+
+    /// Appends `length` bytes of `slab` starting at `offset`, taking a
+    /// reference to it.
+    void append(byte_slab* slab, std::size_t offset, std::size_t length) {
+        if(length == 0) {
+            return;
+        }
+        byte_slab::acquire(slab);
+        pieces.push_back(piece{slab,
+                               static_cast<std::uint32_t>(offset),
+                               static_cast<std::uint32_t>(length)});
+        total += length;
+    }
+
+private:
+    struct piece {
+        byte_slab* slab;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    void reset() noexcept {
+        for(auto& piece: pieces) {
+            byte_slab::release(piece.slab);
+        }
+        pieces.clear();
+        total = 0;
+    }
+
+    small_vector<piece, 4> pieces;
+    std::size_t total = 0;
+};
+
+}  // namespace kota
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <thread>
 #include <utility>
 
+#include "kota/async/io/loop.h"
 #include "kota/async/runtime/sync.h"
 #include "kota/async/runtime/task.h"
 #include "kota/async/runtime/when.h"
@@ -11,17 +17,75 @@ namespace kota {
 
 class cancellation_token {
 public:
+    class state;
+
+    /// A registration in a token's callback list, embedded in the object
+    /// that registers, so registering allocates nothing; see
+    /// cancellation_callback.
+    class callback_node {
+    public:
+        callback_node(const callback_node&) = delete;
+        callback_node& operator=(const callback_node&) = delete;
+
+    protected:
+        explicit callback_node(void (*invoke)(callback_node&)) noexcept : invoke(invoke) {}
+
+        ~callback_node() = default;
+
+    private:
+        friend class state;
+
+        void (*invoke)(callback_node&);
+        callback_node* prev = nullptr;
+        callback_node* next = nullptr;
+
+        /// Set by the thread running the callback once it returned, for a
+        /// deregistration on another thread waiting for it.
+        std::atomic<bool> finished{false};
+
+        /// Set while the callback runs; a callback destroying its own
+        /// registration flags it so cancel() no longer touches the node.
+        bool* destroyed = nullptr;
+    };
+
     class state {
     public:
         bool is_cancelled() const noexcept {
-            return cancelled;
+            return cancelled.load(std::memory_order_acquire);
         }
 
+        /// Runs the registered callbacks, then wakes the waiters. Callbacks
+        /// run on the calling thread, which may be any thread; the waiters
+        /// of wait() belong to the loop and must be woken from its thread.
         void cancel() noexcept {
-            if(cancelled) {
+            lock();
+            if(cancelled.load(std::memory_order_relaxed)) {
+                unlock();
                 return;
             }
-            cancelled = true;
+            cancelled.store(true, std::memory_order_release);
+            running_thread = std::this_thread::get_id();
+
+            // A callback may register or drop others, so each is taken off
+            // the list and run with the lock released.
+            while(auto* node = head) {
+                unlink(*node);
+                running = node;
+                bool destroyed = false;
+                node->destroyed = &destroyed;
+                unlock();
+
+                node->invoke(*node);
+                if(!destroyed) {
+                    node->destroyed = nullptr;
+                    node->finished.store(true, std::memory_order_release);
+                }
+
+                lock();
+                running = nullptr;
+            }
+            unlock();
+
             // This event represents the sticky fact "cancellation has already
             // happened", not the transient action "cancel whoever is currently
             // waiting". That is why this uses set() instead of interrupt():
@@ -34,6 +98,49 @@ public:
             event.set();
         }
 
+        /// Links `node`; false, leaving it unlinked, once cancelled.
+        bool add(callback_node& node) noexcept {
+            lock();
+            if(cancelled.load(std::memory_order_relaxed)) {
+                unlock();
+                return false;
+            }
+            node.next = head;
+            if(head) {
+                head->prev = &node;
+            }
+            head = &node;
+            unlock();
+            return true;
+        }
+
+        /// Unlinks `node`. If its callback is running on another thread,
+        /// waits for it to return, so the node may be destroyed after.
+        void remove(callback_node& node) noexcept {
+            lock();
+            if(node.prev || head == &node) {
+                unlink(node);
+                unlock();
+                return;
+            }
+
+            const bool is_running = running == &node;
+            const auto thread = running_thread;
+            unlock();
+            if(!is_running) {
+                return;
+            }
+
+            if(thread == std::this_thread::get_id()) {
+                // Dropped by its own callback.
+                *node.destroyed = true;
+                return;
+            }
+            while(!node.finished.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
         /// Returns a task that never succeeds.
         ///
         /// This awaitable turns the sticky cancellation state stored in
@@ -50,7 +157,7 @@ public:
         /// coroutine state `Cancelled`, which is what with_token(...) and other
         /// callers rely on.
         task<> wait() {
-            if(cancelled) {
+            if(is_cancelled()) {
                 // Preserve cancellation semantics for already-fired tokens.
                 co_await kota::cancel();
             }
@@ -64,8 +171,38 @@ public:
         }
 
     private:
+        void lock() noexcept {
+            while(locked.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        void unlock() noexcept {
+            locked.store(false, std::memory_order_release);
+        }
+
+        void unlink(callback_node& node) noexcept {
+            if(node.prev) {
+                node.prev->next = node.next;
+            } else {
+                head = node.next;
+            }
+            if(node.next) {
+                node.next->prev = node.prev;
+            }
+            node.prev = nullptr;
+            node.next = nullptr;
+        }
+
         class event event;
-        bool cancelled = false;
+        std::atomic<bool> cancelled{false};
+
+        // Guards the fields below; held only to link and unlink, never
+        // while a callback runs.
+        std::atomic<bool> locked{false};
+        callback_node* head = nullptr;
+        callback_node* running = nullptr;
+        std::thread::id running_thread;
     };
 
     cancellation_token() noexcept = delete;
@@ -83,12 +220,63 @@ public:
 private:
     friend class cancellation_source;
 
+    template <typename Fn>
+    friend class cancellation_callback;
+
     explicit cancellation_token(std::shared_ptr<state> state) : state(std::move(state)) {}
 
     std::shared_ptr<state> state;
 };
 
-class cancellation_source {
+/// Calls `fn` once when `token` is cancelled, or right away if it already
+/// is, on the thread that cancels. Unlike waiting on the token, it costs no
+/// coroutine frame and no allocation: the registration lives inside this
+/// object, typically in the frame that declares it. Destroying it drops the
+/// registration; if `fn` is running on another thread at that moment, the
+/// destructor waits for it to return.
+///
+///   cancellation_callback on_cancel(token, [&] { stop_flag.store(true); });
+template <typename Fn>
+class cancellation_callback : cancellation_token::callback_node {
+public:
+    template <typename F>
+    cancellation_callback(const cancellation_token& token, F&& fn) :
+        callback_node(&run), fn(std::forward<F>(fn)), state(token.state) {
+        if(!state->add(*this)) {
+            state.reset();
+            std::invoke(this->fn);
+        }
+    }
+
+    cancellation_callback(const cancellation_callback&) = delete;
+    cancellation_callback& operator=(const cancellation_callback&) = delete;
+
+    ~cancellation_callback() {
+        if(state) {
+            state->remove(*this);
+        }
+    }
+
+private:
+    static void run(callback_node& node) {
+        std::invoke(static_cast<cancellation_callback&>(node).fn);
+    }
+
+    Fn fn;
+    std::shared_ptr<class cancellation_token::state> state;
+};
+
+template <typename F>
+cancellation_callback(const cancellation_token&, F) -> cancellation_callback<F>;
+
+/// Owner side of a cancellation_token.
+///
+/// cancel_after() and cancel_at() arm a timeout on the loop's timer wheel
+/// instead of racing a sleep, so a per-request deadline costs no coroutine
+/// frame and no uv handle. The timeout is disarmed by cancel(), by
+/// clear_timeout(), or when the source is destroyed; a source with a pending
+/// timeout must not outlive its loop.
+class cancellation_source : detail::wheel_entry {
 public:
     cancellation_source() : state(std::make_shared<class cancellation_token::state>()) {}
 
@@ -100,9 +288,41 @@ public:
     }
 
     void cancel() noexcept {
+        clear_timeout();
         state->cancel();
     }
 
+    /// Cancels once `timeout` has elapsed on `loop`, replacing any pending
+    /// timeout. No effect if already cancelled.
+    ///
+    /// NOT thread-safe: must be called on the loop thread.
+    void cancel_after(std::chrono::milliseconds timeout,
+                      event_loop& loop = event_loop::current()) noexcept {
+        clear_timeout();
+        if(cancelled()) {
+            return;
+        }
+
+        this->fire = &on_timeout;
+        timeout_loop = &loop;
+        loop.arm_timeout(*this, timeout);
+    }
+
+    /// Cancels at `when`, rounded up to the wheel's millisecond resolution.
+    template <typename Clock, typename Duration>
+    void cancel_at(std::chrono::time_point<Clock, Duration> when,
+                   event_loop& loop = event_loop::current()) noexcept {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(when - Clock::now());
+        cancel_after((std::max)(remaining, std::chrono::milliseconds::zero()), loop);
+    }
+
+    /// Drops a pending cancel_after() or cancel_at() without cancelling.
+    void clear_timeout() noexcept {
+        if(auto* loop = std::exchange(timeout_loop, nullptr)) {
+            loop->disarm_timeout(*this);
+        }
+    }
+
     bool cancelled() const noexcept {
         return state->is_cancelled();
     }
@@ -112,7 +332,16 @@ public:
     }
 
 private:
+    static void on_timeout(detail::wheel_entry& entry) {
+        auto& self = static_cast<cancellation_source&>(entry);
+        self.timeout_loop = nullptr;
+        self.state->cancel();
+    }
+
     std::shared_ptr<class cancellation_token::state> state;
+
+    /// Loop holding the pending timeout, if any.
+    event_loop* timeout_loop = nullptr;
 };
 
 /// with_token: cancel a task when any of the given tokens fire.
@@ -16,9 +16,9 @@ struct serialize_traits<bincode::Serializer<Config>, RawValue> {
 
     static auto serialize(bincode::Serializer<Config>& serializer, const RawValue& value)
         -> std::expected<value_type, error_type> {
-        auto bytes =
-            std::span<const std::byte>(reinterpret_cast<const std::byte*>(value.data.data()),
-                                       value.data.size());
+        const auto text = value.text();
+        auto bytes = std::span<const std::byte>(reinterpret_cast<const std::byte*>(text.data()),
+                                                text.size());
         return serializer.serialize_bytes(bytes);
     }
 };
@@ -36,9 +36,27 @@ struct deserialize_traits<bincode::Deserializer<Config>, RawValue> {
         if(!status) {
             return std::unexpected(status.error());
         }
+        value.buffer.reset();
+        value.slice = {};
         value.data.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
         return {};
     }
 };
 
+template <typename Config>
+struct deserialize_traits<bincode::Deserializer<Config>, RawValueView> {
+    using error_type = typename bincode::Deserializer<Config>::error_type;
+
+    static auto deserialize(bincode::Deserializer<Config>& deserializer, RawValueView& value)
+        -> std::expected<void, error_type> {
+        auto bytes = deserializer.deserialize_bytes_view();
+        if(!bytes) {
+            return std::unexpected(bytes.error());
+        }
+        value.offset = static_cast<std::size_t>(bytes->data() - deserializer.source().data());
+        value.length = bytes->size();
+        return {};
+    }
+};
+
 }  // namespace kota::codec
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <limits>
 #include <optional>
+#include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
@@ -18,6 +21,8 @@
 #include "kota/support/expected_try.h"
 #include "kota/support/ranges.h"
 #include "kota/codec/bincode/error.h"
+#include "kota/codec/bincode/scalars.h"
+#include "kota/codec/bincode/varint.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
 #include "kota/codec/detail/narrow.h"
@@ -47,6 +52,12 @@ public:
             return read_count < expected_count;
         }
 
+        /// Elements left to read, bounded by the bytes left in the input so
+        /// a corrupt length cannot make a container reserve more than that.
+        std::size_t size_hint() const noexcept {
+            return std::min(expected_count - read_count, deserializer.source().size());
+        }
+
         template <typename T>
         status_t deserialize_element(T& value) {
             KOTA_EXPECTED_TRY_V(auto has_next_value, has_next());
@@ -194,7 +205,7 @@ public:
 
     template <codec::int_like T>
     status_t deserialize_int(T& value) {
-        KOTA_EXPECTED_TRY_V(auto parsed, read_integral<std::int64_t>());
+        KOTA_EXPECTED_TRY_V(auto parsed, read_signed());
 
         auto narrowed = codec::detail::narrow_int<T>(parsed, error_type::number_out_of_range);
         if(!narrowed) {
@@ -206,7 +217,7 @@ public:
 
     template <codec::uint_like T>
     status_t deserialize_uint(T& value) {
-        KOTA_EXPECTED_TRY_V(auto parsed, read_integral<std::uint64_t>());
+        KOTA_EXPECTED_TRY_V(auto parsed, read_unsigned());
 
         auto narrowed = codec::detail::narrow_uint<T>(parsed, error_type::number_out_of_range);
         if(!narrowed) {
@@ -253,6 +264,32 @@ public:
         return {};
     }
 
+    /// Like deserialize_bytes(), but views the bytes in the input instead of
+    /// copying them.
+    result_t<std::span<const std::byte>> deserialize_bytes_view() {
+        KOTA_EXPECTED_TRY_V(auto length, read_length());
+
+        if(offset + length > bytes.size()) {
+            return mark_invalid(error_kind::unexpected_eof);
+        }
+
+        auto view = bytes.subspan(offset, length);
+        offset += length;
+        return view;
+    }
+
+    /// Like deserialize_str(), but views the characters in the input instead
+    /// of copying them.
+    result_t<std::string_view> deserialize_str_view() {
+        KOTA_EXPECTED_TRY_V(auto view, deserialize_bytes_view());
+        return std::string_view(reinterpret_cast<const char*>(view.data()), view.size());
+    }
+
+    /// The input being read.
+    std::span<const std::byte> source() const noexcept {
+        return bytes;
+    }
+
     status_t deserialize_bytes(std::vector<std::byte>& value) {
         KOTA_EXPECTED_TRY_V(auto length, read_length());
 
@@ -271,6 +308,54 @@ public:
         return {};
     }
 
+    /// Reads `values.size()` scalars written back to back, as deserializing
+    /// them one at a time would, but as a single block.
+    template <packed_scalar T>
+    status_t deserialize_scalars(std::span<T> values) {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        if constexpr(uses_varint<Config> && (int_like<T> || uint_like<T>)) {
+            // A varint takes at least a byte.
+            if(values.size() > bytes.size() - offset) {
+                return mark_invalid(error_kind::unexpected_eof);
+            }
+            for(auto& value: values) {
+                KOTA_EXPECTED_TRY_V(auto raw, read_varint());
+                if constexpr(int_like<T>) {
+                    raw = static_cast<std::uint64_t>(zigzag_decode(raw));
+                }
+                KOTA_EXPECTED_TRY(from_wire_scalar(raw, value));
+            }
+            return {};
+        }
+
+        using wire_t = wire_scalar_t<T>;
+        if(values.size() > (bytes.size() - offset) / sizeof(wire_t)) {
+            return mark_invalid(error_kind::unexpected_eof);
+        }
+
+        const auto* in = bytes.data() + offset;
+        const auto length = values.size() * sizeof(wire_t);
+        if constexpr(is_wire_layout<T>) {
+            if(length != 0) {
+                std::memcpy(values.data(), in, length);
+            }
+        } else {
+            for(auto& value: values) {
+                wire_t raw = 0;
+                for(std::size_t i = 0; i < sizeof(wire_t); ++i) {
+                    raw |= static_cast<wire_t>(std::to_integer<std::uint8_t>(in[i])) << (i * 8);
+                }
+                in += sizeof(wire_t);
+                KOTA_EXPECTED_TRY(from_wire_scalar(raw, value));
+            }
+        }
+        offset += length;
+        return {};
+    }
+
     result_t<bool> deserialize_none() {
         KOTA_EXPECTED_TRY_V(auto tag, read_u8());
 
@@ -285,7 +370,12 @@ public:
 
     template <typename... Ts>
     status_t deserialize_variant(std::variant<Ts...>& value) {
-        KOTA_EXPECTED_TRY_V(auto index, read_integral<std::uint32_t>());
+        std::uint64_t index = 0;
+        if constexpr(uses_varint<Config>) {
+            KOTA_EXPECTED_TRY_V(index, read_varint());
+        } else {
+            KOTA_EXPECTED_TRY_V(index, read_integral<std::uint32_t>());
+        }
 
         constexpr std::size_t variant_size = sizeof...(Ts);
         if(index >= variant_size) {
@@ -386,12 +476,83 @@ private:
         }
     }
 
+    template <packed_scalar T>
+    status_t from_wire_scalar(wire_scalar_t<T> raw, T& value) {
+        if constexpr(bool_like<T>) {
+            if(raw > 1U) {
+                return mark_invalid(error_type::type_mismatch);
+            }
+            value = raw == 1U;
+            return {};
+        } else if constexpr(char_like<T>) {
+            value = static_cast<char>(raw);
+            return {};
+        } else {
+            auto narrowed = [&] {
+                if constexpr(int_like<T>) {
+                    return codec::detail::narrow_int<T>(std::bit_cast<std::int64_t>(raw),
+                                                        error_type::number_out_of_range);
+                } else if constexpr(uint_like<T>) {
+                    return codec::detail::narrow_uint<T>(raw, error_type::number_out_of_range);
+                } else {
+                    return codec::detail::narrow_float<T>(std::bit_cast<double>(raw),
+                                                          error_type::number_out_of_range);
+                }
+            }();
+            if(!narrowed) {
+                return mark_invalid(narrowed.error());
+            }
+            value = *narrowed;
+            return {};
+        }
+    }
+
+    result_t<std::uint64_t> read_varint() {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        std::uint64_t value = 0;
+        for(std::size_t i = 0; i < max_varint_bytes; ++i) {
+            if(offset >= bytes.size()) {
+                return mark_invalid(error_kind::unexpected_eof);
+            }
+            const auto byte = std::to_integer<std::uint8_t>(bytes[offset++]);
+            // The tenth byte holds the top bit alone.
+            if(i == max_varint_bytes - 1 && byte > 1U) {
+                return mark_invalid(error_type::number_out_of_range);
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << (i * 7);
+            if((byte & 0x80U) == 0) {
+                return value;
+            }
+        }
+        return mark_invalid(error_type::number_out_of_range);
+    }
+
+    result_t<std::int64_t> read_signed() {
+        if constexpr(uses_varint<Config>) {
+            KOTA_EXPECTED_TRY_V(auto raw, read_varint());
+            return zigzag_decode(raw);
+        } else {
+            return read_integral<std::int64_t>();
+        }
+    }
+
+    result_t<std::uint64_t> read_unsigned() {
+        if constexpr(uses_varint<Config>) {
+            return read_varint();
+        } else {
+            return read_integral<std::uint64_t>();
+        }
+    }
+
     result_t<std::uint8_t> read_u8() {
         return read_integral<std::uint8_t>();
     }
 
     result_t<std::size_t> read_length() {
-        KOTA_EXPECTED_TRY_V(auto raw, read_integral<std::uint64_t>());
+        KOTA_EXPECTED_TRY_V(auto raw, read_unsigned());
 
         if(raw > static_cast<std::uint64_t>((std::numeric_limits<std::size_t>::max)())) {
             return mark_invalid(error_type::number_out_of_range);
@@ -560,6 +721,56 @@ struct deserialize_traits<bincode::Deserializer<Config>, T> {
     }
 };
 
+/// std::string_view and std::span<const std::byte> members borrow from the
+/// input, which has to outlive them.
+template <typename Config>
+struct deserialize_traits<bincode::Deserializer<Config>, std::string_view> {
+    using error_type = typename bincode::Deserializer<Config>::error_type;
+
+    static auto deserialize(bincode::Deserializer<Config>& deserializer, std::string_view& value)
+        -> std::expected<void, error_type> {
+        KOTA_EXPECTED_TRY_V(value, deserializer.deserialize_str_view());
+        return {};
+    }
+};
+
+template <typename Config>
+struct deserialize_traits<bincode::Deserializer<Config>, std::span<const std::byte>> {
+    using error_type = typename bincode::Deserializer<Config>::error_type;
+
+    static auto deserialize(bincode::Deserializer<Config>& deserializer,
+                            std::span<const std::byte>& value) -> std::expected<void, error_type> {
+        KOTA_EXPECTED_TRY_V(value, deserializer.deserialize_bytes_view());
+        return {};
+    }
+};
+
+/// Vectors and arrays of scalars are read as one block through
+/// deserialize_scalars(); see the matching serialize_traits.
+template <typename Config, typename T>
+    requires (bincode::scalar_block<T> && !str_like<T> &&
+              (tuple_like<T> || requires(T& value, std::size_t size) { value.resize(size); }))
+struct deserialize_traits<bincode::Deserializer<Config>, T> {
+    using deserializer_t = bincode::Deserializer<Config>;
+    using error_type = typename deserializer_t::error_type;
+
+    static auto deserialize(deserializer_t& deserializer, T& value)
+        -> std::expected<void, error_type> {
+        using element_t = std::ranges::range_value_t<T>;
+        if constexpr(!tuple_like<T>) {
+            KOTA_EXPECTED_TRY_V(auto length, deserializer.read_length_prefix());
+            // Every element takes at least a byte, so this bounds the
+            // allocation by the input before it is read.
+            if(length > deserializer.source().size()) {
+                return std::unexpected(error_type(bincode::error_kind::unexpected_eof));
+            }
+            value.resize(length);
+        }
+        return deserializer.deserialize_scalars(
+            std::span<element_t>(std::ranges::data(value), std::ranges::size(value)));
+    }
+};
+
 template <typename Config, typename T>
     requires (std::ranges::input_range<std::remove_cvref_t<T>> &&
               format_kind<std::remove_cvref_t<T>> == range_format::map)
@@ -584,12 +795,16 @@ struct deserialize_traits<bincode::Deserializer<Config>, T> {
         if constexpr(requires { value.clear(); }) {
             value.clear();
         }
+        // Each entry takes at least a byte, which bounds a corrupt length.
+        if constexpr(requires { value.reserve(length); }) {
+            value.reserve(std::min(length, deserializer.source().size()));
+        }
 
         for(std::size_t i = 0; i < length; ++i) {
             key_t key{};
             KOTA_EXPECTED_TRY(codec::deserialize(deserializer, key));
 
-            mapped_t mapped{};
+            auto mapped = codec::detail::make_element<mapped_t>(value);
             KOTA_EXPECTED_TRY(codec::deserialize(deserializer, mapped));
 
             kota::detail::insert_map_entry(value, std::move(key), std::move(mapped));
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+
+#include "kota/codec/traits.h"
+
+namespace kota::codec::bincode {
+
+/// Element types whose contiguous sequences are encoded and decoded as one
+/// block instead of element by element.
+template <typename T>
+concept packed_scalar =
+    bool_like<T> || int_like<T> || uint_like<T> || floating_like<T> || char_like<T>;
+
+/// Ranges of packed scalars laid out one after another in memory.
+template <typename R>
+concept scalar_block =
+    std::ranges::contiguous_range<R> && packed_scalar<std::ranges::range_value_t<R>>;
+
+/// What a scalar is widened to on the wire: a byte for bool and char, eight
+/// bytes for every number, floats as the bits of a double.
+template <packed_scalar T>
+using wire_scalar_t =
+    std::conditional_t<bool_like<T> || char_like<T>, std::uint8_t, std::uint64_t>;
+
+/// True when the bytes of a T in memory already are its encoding, so a block
+/// of them is copied as is. bool is left out: decoding has to check it.
+template <packed_scalar T>
+constexpr inline bool is_wire_layout = std::endian::native == std::endian::little &&
+                                       !bool_like<T> && sizeof(T) == sizeof(wire_scalar_t<T>) &&
+                                       (!floating_like<T> || std::same_as<T, double>);
+
+template <packed_scalar T>
+constexpr auto to_wire_scalar(T value) noexcept -> wire_scalar_t<T> {
+    if constexpr(bool_like<T> || char_like<T>) {
+        return static_cast<std::uint8_t>(value);
+    } else if constexpr(int_like<T>) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+    } else if constexpr(uint_like<T>) {
+        return static_cast<std::uint64_t>(value);
+    } else {
+        return std::bit_cast<std::uint64_t>(static_cast<double>(value));
+    }
+}
+
+}  // namespace kota::codec::bincode
@@ -1,26 +1,41 @@
 #pragma once
 
+#include <array>
 #include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <ranges>
 #include <span>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #include "kota/support/expected_try.h"
+#include "kota/support/type_traits.h"
 #include "kota/codec/bincode/error.h"
+#include "kota/codec/bincode/scalars.h"
+#include "kota/codec/bincode/varint.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
 
 namespace kota::codec::bincode {
 
+/// Selects the Serializer that counts bytes instead of writing them.
+struct size_only_t {
+    explicit size_only_t() = default;
+};
+
+inline constexpr size_only_t size_only{};
+
 template <typename Config = config::default_config>
 class Serializer {
 public:
@@ -38,6 +53,15 @@ public:
         SerializeElements(Serializer& serializer, std::size_t expected_count) noexcept :
             serializer(serializer), expected_count(expected_count) {}
 
+        /// Elements of a sequence or map whose length is written in front of
+        /// them, at `length_at`, once end() knows it.
+        static auto unsized(Serializer& serializer, std::size_t length_at) noexcept
+            -> SerializeElements {
+            SerializeElements elements(serializer, (std::numeric_limits<std::size_t>::max)());
+            elements.length_at = length_at;
+            return elements;
+        }
+
         template <typename T>
         status_t serialize_element(const T& value) {
             if(written_count >= expected_count) {
@@ -69,6 +93,9 @@ public:
         }
 
         result_t<value_type> end() {
+            if(length_at.has_value()) {
+                return serializer.close_length(*length_at, written_count);
+            }
             if(written_count != expected_count) {
                 return serializer.mark_invalid(error_type::invalid_state);
             }
@@ -79,6 +106,7 @@ public:
         Serializer& serializer;
         std::size_t expected_count = 0;
         std::size_t written_count = 0;
+        std::optional<std::size_t> length_at;
     };
 
     using SerializeSeq = SerializeElements;
@@ -92,6 +120,14 @@ public:
         bytes_buffer.reserve(reserve_bytes);
     }
 
+    /// Writes after whatever `buffer` already holds, taking over its storage;
+    /// take_bytes() hands it back.
+    explicit Serializer(std::vector<std::byte>&& buffer) : bytes_buffer(std::move(buffer)) {}
+
+    /// Counts what the values written would encode to, without storing any
+    /// of it; size() reads the count and bytes() stays empty.
+    explicit Serializer(size_only_t) noexcept : is_size_only(true) {}
+
     [[nodiscard]] bool valid() const noexcept {
         return is_valid;
     }
@@ -104,10 +140,24 @@ public:
         return std::span<const std::byte>(bytes_buffer.data(), bytes_buffer.size());
     }
 
+    /// Bytes written so far, or counted by a size-only serializer.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return is_size_only ? counted_bytes : bytes_buffer.size();
+    }
+
     auto take_bytes() -> std::vector<std::byte> {
         return std::move(bytes_buffer);
     }
 
+    /// Empties the output, keeping its capacity, so one serializer can be
+    /// reused across values.
+    void clear() noexcept {
+        bytes_buffer.clear();
+        counted_bytes = 0;
+        is_valid = true;
+        last_error = error_type::ok;
+    }
+
     result_t<value_type> serialize_null() {
         return write_u8(0);
     }
@@ -123,11 +173,19 @@ public:
     }
 
     result_t<value_type> serialize_int(std::int64_t value) {
-        return write_integral(value);
+        if constexpr(uses_varint<Config>) {
+            return write_varint(zigzag_encode(value));
+        } else {
+            return write_integral(value);
+        }
     }
 
     result_t<value_type> serialize_uint(std::uint64_t value) {
-        return write_integral(value);
+        if constexpr(uses_varint<Config>) {
+            return write_varint(value);
+        } else {
+            return write_integral(value);
+        }
     }
 
     result_t<value_type> serialize_float(double value) {
@@ -150,9 +208,7 @@ public:
             return {};
         }
 
-        bytes_buffer.insert(bytes_buffer.end(),
-                            reinterpret_cast<const std::byte*>(value.data()),
-                            reinterpret_cast<const std::byte*>(value.data() + value.size()));
+        append(reinterpret_cast<const std::byte*>(value.data()), value.size());
         return {};
     }
 
@@ -163,7 +219,62 @@ public:
             return std::unexpected(last_error);
         }
 
-        bytes_buffer.insert(bytes_buffer.end(), value.begin(), value.end());
+        append(value.data(), value.size());
+        return {};
+    }
+
+    /// Writes `value` as a byte string holding its own encoding, exactly as
+    /// serialize_bytes() of that encoding would, but in one pass: the length
+    /// is filled in once the value has been written after it. A varint
+    /// length is not known up front, so it is inserted in front afterwards.
+    template <typename T>
+    result_t<value_type> serialize_nested(const T& value) {
+        KOTA_EXPECTED_TRY_V(auto at, open_length());
+        KOTA_EXPECTED_TRY(codec::serialize(*this, value));
+        return close_length(at, size() - at - (uses_varint<Config> ? 0 : sizeof(std::uint64_t)));
+    }
+
+    /// Writes `values` back to back, exactly as serializing them one at a
+    /// time would, but as a single block; no length is written.
+    template <packed_scalar T>
+    result_t<value_type> serialize_scalars(std::span<const T> values) {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        if constexpr(uses_varint<Config> && (int_like<T> || uint_like<T>)) {
+            for(const auto& value: values) {
+                if constexpr(int_like<T>) {
+                    KOTA_EXPECTED_TRY(write_varint(zigzag_encode(value)));
+                } else {
+                    KOTA_EXPECTED_TRY(write_varint(value));
+                }
+            }
+            return {};
+        }
+
+        using wire_t = wire_scalar_t<T>;
+        const auto length = values.size() * sizeof(wire_t);
+        if(is_size_only) {
+            counted_bytes += length;
+            return {};
+        }
+
+        const auto at = bytes_buffer.size();
+        bytes_buffer.resize(at + length);
+        auto* out = bytes_buffer.data() + at;
+        if constexpr(is_wire_layout<T>) {
+            if(length != 0) {
+                std::memcpy(out, values.data(), length);
+            }
+        } else {
+            for(const auto& value: values) {
+                const auto raw = to_wire_scalar(value);
+                for(std::size_t i = 0; i < sizeof(wire_t); ++i) {
+                    *out++ = static_cast<std::byte>((raw >> (i * 8)) & 0xFFU);
+                }
+            }
+        }
         return {};
     }
 
@@ -174,7 +285,11 @@ public:
             return mark_invalid(error_type::invalid_variant_index);
         }
 
-        KOTA_EXPECTED_TRY(write_integral(static_cast<std::uint32_t>(variant_index)));
+        if constexpr(uses_varint<Config>) {
+            KOTA_EXPECTED_TRY(write_varint(variant_index));
+        } else {
+            KOTA_EXPECTED_TRY(write_integral(static_cast<std::uint32_t>(variant_index)));
+        }
 
         std::expected<void, error_type> payload_status{};
         std::visit(
@@ -199,9 +314,12 @@ public:
         return {};
     }
 
+    /// Without `len`, the count is written once the elements are, as
+    /// serialize_nested() writes its length.
     result_t<SerializeSeq> serialize_seq(std::optional<std::size_t> len) {
         if(!len.has_value()) {
-            return std::unexpected(error_type::invalid_state);
+            KOTA_EXPECTED_TRY_V(auto at, open_length());
+            return SerializeSeq::unsized(*this, at);
         }
 
         KOTA_EXPECTED_TRY(write_length(*len));
@@ -214,7 +332,8 @@ public:
 
     result_t<SerializeMap> serialize_map(std::optional<std::size_t> len) {
         if(!len.has_value()) {
-            return std::unexpected(error_type::invalid_state);
+            KOTA_EXPECTED_TRY_V(auto at, open_length());
+            return SerializeMap::unsized(*this, at);
         }
 
         KOTA_EXPECTED_TRY(write_length(*len));
@@ -235,10 +354,11 @@ private:
 
         using unsigned_t = std::make_unsigned_t<T>;
         unsigned_t raw = static_cast<unsigned_t>(value);
+        std::array<std::byte, sizeof(unsigned_t)> encoded;
         for(std::size_t i = 0; i < sizeof(unsigned_t); ++i) {
-            const auto byte = static_cast<std::uint8_t>((raw >> (i * 8)) & 0xFFU);
-            bytes_buffer.push_back(static_cast<std::byte>(byte));
+            encoded[i] = static_cast<std::byte>((raw >> (i * 8)) & 0xFFU);
         }
+        append(encoded.data(), encoded.size());
         return {};
     }
 
@@ -251,7 +371,61 @@ private:
            static_cast<unsigned long long>((std::numeric_limits<std::uint64_t>::max)())) {
             return mark_invalid(error_type::invalid_state);
         }
-        return write_integral(static_cast<std::uint64_t>(len));
+        return serialize_uint(static_cast<std::uint64_t>(len));
+    }
+
+    // A length known only after what it counts has been written goes in at
+    // open_length()'s offset: a fixed-width one over the placeholder written
+    // there, a varint one inserted in front of what follows.
+    result_t<std::size_t> open_length() {
+        const auto at = size();
+        if constexpr(!uses_varint<Config>) {
+            KOTA_EXPECTED_TRY(write_length(0));
+        }
+        return at;
+    }
+
+    status_t close_length(std::size_t at, std::size_t length) {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        const auto value = static_cast<std::uint64_t>(length);
+        if constexpr(uses_varint<Config>) {
+            if(is_size_only) {
+                counted_bytes += varint_size(value);
+                return {};
+            }
+
+            std::array<std::byte, max_varint_bytes> encoded;
+            const auto count = encode_varint(value, encoded.data());
+            bytes_buffer.insert(bytes_buffer.begin() + static_cast<std::ptrdiff_t>(at),
+                                encoded.begin(),
+                                encoded.begin() + static_cast<std::ptrdiff_t>(count));
+        } else if(!is_size_only) {
+            for(std::size_t i = 0; i < sizeof(std::uint64_t); ++i) {
+                bytes_buffer[at + i] = static_cast<std::byte>((value >> (i * 8)) & 0xFFU);
+            }
+        }
+        return {};
+    }
+
+    status_t write_varint(std::uint64_t value) {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        std::array<std::byte, max_varint_bytes> encoded;
+        append(encoded.data(), encode_varint(value, encoded.data()));
+        return {};
+    }
+
+    void append(const std::byte* data, std::size_t count) {
+        if(is_size_only) {
+            counted_bytes += count;
+        } else {
+            bytes_buffer.insert(bytes_buffer.end(), data, data + count);
+        }
     }
 
     status_t mark_invalid(error_type error) {
@@ -262,13 +436,97 @@ private:
 
 private:
     std::vector<std::byte> bytes_buffer;
+    std::size_t counted_bytes = 0;
+    bool is_size_only = false;
     bool is_valid = true;
     error_type last_error = error_type::ok;
 };
 
+/// The encoded length shared by every `T`, when there is one: scalars, and
+/// tuples and plain structs made only of them. std::nullopt for anything
+/// whose length depends on the value, or that has its own serialize_traits.
+template <typename T, typename Config = config::default_config>
+consteval auto fixed_serialized_size() -> std::optional<std::size_t> {
+    using S = Serializer<Config>;
+    auto sum = []<typename... Ts>(std::type_identity<Ts>...) -> std::optional<std::size_t> {
+        std::size_t total = 0;
+        for(auto size: {std::optional<std::size_t>(0), fixed_serialized_size<Ts, Config>()...}) {
+            if(!size) {
+                return std::nullopt;
+            }
+            total += *size;
+        }
+        return total;
+    };
+
+    // The same order of cases as codec::serialize(), after arrays of
+    // scalars, which have their own serialize_traits.
+    if constexpr(tuple_like<T> && scalar_block<T>) {
+        constexpr auto element = fixed_serialized_size<std::ranges::range_value_t<T>, Config>();
+        if(!element) {
+            return std::nullopt;
+        }
+        return std::tuple_size_v<T> * *element;
+    } else if constexpr(requires(S& s, const T& v) { serialize_traits<S, T>::serialize(s, v); } ||
+                 meta::annotated_type<T>) {
+        return std::nullopt;
+    } else if constexpr(std::is_enum_v<T>) {
+        return uses_varint<Config> ? std::nullopt : std::optional(sizeof(std::uint64_t));
+    } else if constexpr(bool_like<T>) {
+        return 1;
+    } else if constexpr(int_like<T> || uint_like<T>) {
+        return uses_varint<Config> ? std::nullopt : std::optional(sizeof(std::uint64_t));
+    } else if constexpr(floating_like<T>) {
+        return sizeof(std::uint64_t);
+    } else if constexpr(char_like<T>) {
+        return 1;
+    } else if constexpr(str_like<T> || bytes_like<T>) {
+        return std::nullopt;
+    } else if constexpr(null_like<T>) {
+        return 1;
+    } else if constexpr(is_specialization_of<std::optional, T> ||
+                        is_specialization_of<std::unique_ptr, T> ||
+                        is_specialization_of<std::shared_ptr, T> ||
+                        is_specialization_of<std::variant, T>) {
+        return std::nullopt;
+    } else if constexpr(tuple_like<T>) {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return sum(std::type_identity<std::remove_cv_t<std::tuple_element_t<Is, T>>>{}...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else if constexpr(std::ranges::input_range<T>) {
+        return std::nullopt;
+    } else if constexpr(meta::reflectable_class<T>) {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return sum(std::type_identity<std::remove_cv_t<meta::field_type<T, Is>>>{}...);
+        }(std::make_index_sequence<meta::field_count<T>()>{});
+    } else {
+        return std::nullopt;
+    }
+}
+
+/// Exact length of the encoding of `value`, found without writing it. A
+/// constant for types with a fixed_serialized_size(); otherwise one pass
+/// over the value that only counts.
+template <typename Config = config::default_config, typename T>
+auto serialized_size(const T& value) -> std::expected<std::size_t, error> {
+    constexpr auto fixed = fixed_serialized_size<T, Config>();
+    if constexpr(fixed.has_value()) {
+        return *fixed;
+    } else {
+        Serializer<Config> counter(size_only);
+        KOTA_EXPECTED_TRY(codec::serialize(counter, value));
+        if(!counter.valid()) {
+            return std::unexpected(counter.error());
+        }
+        return counter.size();
+    }
+}
+
+/// Sizes the output with serialized_size() first, so it is allocated once.
 template <typename Config = config::default_config, typename T>
 auto to_bytes(const T& value) -> std::expected<std::vector<std::byte>, error> {
-    Serializer<Config> serializer;
+    KOTA_EXPECTED_TRY_V(auto size, serialized_size<Config>(value));
+    Serializer<Config> serializer(size);
     KOTA_EXPECTED_TRY(codec::serialize(serializer, value));
     if(!serializer.valid()) {
         return std::unexpected(serializer.error());
@@ -276,6 +534,48 @@ auto to_bytes(const T& value) -> std::expected<std::vector<std::byte>, error> {
     return serializer.take_bytes();
 }
 
+/// Appends `value` to `out`, reusing its capacity. `out` is left as it was
+/// when serialization fails.
+template <typename Config = config::default_config, typename T>
+auto to_bytes_into(std::vector<std::byte>& out, const T& value) -> std::expected<void, error> {
+    const auto original_size = out.size();
+    Serializer<Config> serializer(std::move(out));
+    auto status = codec::serialize(serializer, value);
+    out = serializer.take_bytes();
+    if(!status || !serializer.valid()) {
+        out.resize(original_size);
+        return std::unexpected(status ? serializer.error() : status.error());
+    }
+    return {};
+}
+
 static_assert(codec::serializer_like<Serializer<>>);
 
 }  // namespace kota::codec::bincode
+
+namespace kota::codec {
+
+/// Contiguous sequences of scalars, such as std::vector<int>, go out as one
+/// block through serialize_scalars(). Arrays keep the tuple encoding, with
+/// no length in front.
+template <typename Config, typename R>
+    requires (bincode::scalar_block<R> && std::ranges::sized_range<R> && !str_like<R> &&
+              !bytes_like<R> && format_kind<R> == range_format::sequence)
+struct serialize_traits<bincode::Serializer<Config>, R> {
+    using serializer_t = bincode::Serializer<Config>;
+    using value_type = typename serializer_t::value_type;
+    using error_type = typename serializer_t::error_type;
+
+    static auto serialize(serializer_t& serializer, const R& value)
+        -> std::expected<value_type, error_type> {
+        using element_t = std::ranges::range_value_t<R>;
+        const auto size = static_cast<std::size_t>(std::ranges::size(value));
+        if constexpr(!tuple_like<R>) {
+            KOTA_EXPECTED_TRY(serializer.serialize_uint(static_cast<std::uint64_t>(size)));
+        }
+        auto values = std::span<const element_t>(std::ranges::data(value), size);
+        return serializer.serialize_scalars(values);
+    }
+};
+
+}  // namespace kota::codec
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace kota::codec::bincode {
+
+/// Integer encodings a Config picks with `using int_encoding = ...;`.
+///
+/// fixed_int_encoding, the default, writes every integer and length as eight
+/// little-endian bytes.
+struct fixed_int_encoding {};
+
+/// LEB128, seven bits a byte with the top bit set while more follow; signed
+/// integers are zigzag-mapped first, so small magnitudes of either sign stay
+/// short. Lengths and variant indices are varints too. Floats, bools and
+/// chars keep their fixed width.
+struct varint_encoding {};
+
+template <typename Config>
+constexpr inline bool uses_varint = [] {
+    if constexpr(requires { typename Config::int_encoding; }) {
+        return std::same_as<typename Config::int_encoding, varint_encoding>;
+    } else {
+        return false;
+    }
+}();
+
+/// The default config with varint integers.
+struct varint_config {
+    using int_encoding = varint_encoding;
+};
+
+constexpr inline std::size_t max_varint_bytes = 10;
+
+constexpr auto zigzag_encode(std::int64_t value) noexcept -> std::uint64_t {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr auto zigzag_decode(std::uint64_t value) noexcept -> std::int64_t {
+    return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+constexpr auto varint_size(std::uint64_t value) noexcept -> std::size_t {
+    return (static_cast<std::size_t>(std::bit_width(value | 1)) + 6) / 7;
+}
+
+/// Writes `value` to `out`, which has room for max_varint_bytes, and returns
+/// how many bytes it took.
+constexpr auto encode_varint(std::uint64_t value, std::byte* out) noexcept -> std::size_t {
+    std::size_t count = 0;
+    while(value >= 0x80) {
+        out[count++] = static_cast<std::byte>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out[count++] = static_cast<std::byte>(value);
+    return count;
+}
+
+}  // namespace kota::codec::bincode
@@ -1,14 +1,22 @@
 #pragma once
 
+#include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "config.h"
 #include "traits.h"
 #include "kota/support/expected_try.h"
+#include "kota/support/interned_string.h"
 #include "kota/support/ranges.h"
+#include "kota/support/small_string.h"
+#include "kota/support/small_vector.h"
 #include "kota/meta/annotation.h"
 #include "kota/meta/attrs.h"
 #include "kota/meta/enum.h"
@@ -22,6 +30,17 @@
 
 namespace kota::codec {
 
+namespace detail {
+
+/// Strings of char other than std::string, read by assigning the text to
+/// them: small_string, and std::basic_string with another allocator.
+template <typename T>
+concept assigned_string =
+    kota::detail::is_small_string<T>::value ||
+    (is_specialization_of<std::basic_string, T> && std::same_as<typename T::value_type, char>);
+
+}  // namespace detail
+
 template <serializer_like S, typename V, typename T, typename E>
 constexpr auto serialize(S& s, const V& v) -> std::expected<T, E> {
     using Serde = serialize_traits<S, V>;
@@ -132,7 +151,16 @@ constexpr auto serialize(S& s, const V& v) -> std::expected<T, E> {
         return s_tuple.end();
     } else if constexpr(std::ranges::input_range<V>) {
         constexpr auto kind = format_kind<V>;
-        if constexpr(kind == range_format::sequence || kind == range_format::set) {
+        if constexpr(kind == range_format::sequence && std::ranges::contiguous_range<V> &&
+                     uint_like<std::ranges::range_value_t<V>> &&
+                     requires(std::span<const std::ranges::range_value_t<V>> numbers) {
+                         s.serialize_uint_array(numbers);
+                     }) {
+            // Backends may write a run of unsigned numbers in one pass.
+            return s.serialize_uint_array(
+                std::span<const std::ranges::range_value_t<V>>(std::ranges::data(v),
+                                                               std::ranges::size(v)));
+        } else if constexpr(kind == range_format::sequence || kind == range_format::set) {
             std::optional<std::size_t> len = std::nullopt;
             if constexpr(std::ranges::sized_range<V>) {
                 len = static_cast<std::size_t>(std::ranges::size(v));
@@ -254,6 +282,20 @@ constexpr auto deserialize(D& d, V& v) -> std::expected<void, E> {
         return d.deserialize_char(v);
     } else if constexpr(std::same_as<V, std::string> || std::derived_from<V, std::string>) {
         return d.deserialize_str(static_cast<std::string&>(v));
+    } else if constexpr(std::same_as<V, interned_string>) {
+        return detail::deserialize_interned(d, v, string_pool::global());
+    } else if constexpr(detail::assigned_string<V>) {
+        // Assigned into, so the string keeps its allocator: a std::pmr::string
+        // stays in its memory resource.
+        if constexpr(requires { d.deserialize_str_view(); }) {
+            KOTA_EXPECTED_TRY_V(auto text, d.deserialize_str_view());
+            v.assign(text);
+        } else {
+            std::string text;
+            KOTA_EXPECTED_TRY(d.deserialize_str(text));
+            v.assign(std::string_view(text));
+        }
+        return {};
     } else if constexpr(std::same_as<V, std::vector<std::byte>>) {
         return d.deserialize_bytes(v);
     } else if constexpr(detail::is_captured_dom_value_v<D, V>) {
@@ -338,7 +380,9 @@ constexpr auto deserialize(D& d, V& v) -> std::expected<void, E> {
             auto result = d_tuple.deserialize_element(element);
             if(!result) {
                 auto err = std::move(result).error();
-                err.prepend_index(tuple_index);
+                if constexpr(config::error_detail<config::config_of<D>>) {
+                    err.prepend_index(tuple_index);
+                }
                 element_result = std::unexpected(std::move(err));
                 return false;
             }
@@ -367,23 +411,41 @@ constexpr auto deserialize(D& d, V& v) -> std::expected<void, E> {
             static_assert(kota::detail::sequence_insertable<V, element_t>,
                           "cannot auto deserialize range: container does not support insertion");
 
-            std::size_t seq_index = 0;
-            while(true) {
-                KOTA_EXPECTED_TRY_V(auto has_next, d_seq.has_next());
-                if(!has_next) {
-                    break;
-                }
+            auto read_elements = [&](auto& out) -> std::expected<void, E> {
+                std::size_t seq_index = 0;
+                while(true) {
+                    KOTA_EXPECTED_TRY_V(auto has_next, d_seq.has_next());
+                    if(!has_next) {
+                        break;
+                    }
 
-                element_t element{};
-                auto elem_status = d_seq.deserialize_element(element);
-                if(!elem_status) {
-                    auto err = std::move(elem_status).error();
-                    err.prepend_index(seq_index);
-                    return std::unexpected(std::move(err));
-                }
+                    auto element = detail::make_element<element_t>(out);
+                    auto elem_status = d_seq.deserialize_element(element);
+                    if(!elem_status) {
+                        auto err = std::move(elem_status).error();
+                        if constexpr(config::error_detail<config::config_of<D>>) {
+                            err.prepend_index(seq_index);
+                        }
+                        return std::unexpected(std::move(err));
+                    }
 
-                kota::detail::append_sequence_element(v, std::move(element));
-                ++seq_index;
+                    kota::detail::append_sequence_element(out, std::move(element));
+                    ++seq_index;
+                }
+                return {};
+            };
+
+            constexpr auto buffer = config::vector_buffer_capacity<config::config_of<D>>;
+            if constexpr(requires { v.reserve(d_seq.size_hint()); }) {
+                v.reserve(d_seq.size_hint());
+                KOTA_EXPECTED_TRY(read_elements(v));
+            } else if constexpr(buffer > 0 && std::same_as<V, std::vector<element_t>>) {
+                kota::small_vector<element_t, buffer> staged;
+                KOTA_EXPECTED_TRY(read_elements(staged));
+                v.assign(std::make_move_iterator(staged.begin()),
+                         std::make_move_iterator(staged.end()));
+            } else {
+                KOTA_EXPECTED_TRY(read_elements(v));
             }
 
             return d_seq.end();
@@ -423,11 +485,13 @@ constexpr auto deserialize(D& d, V& v) -> std::expected<void, E> {
                     }
                 }
 
-                mapped_t mapped{};
+                auto mapped = detail::make_element<mapped_t>(v);
                 auto map_val_status = d_map.deserialize_value(mapped);
                 if(!map_val_status) {
                     auto err = std::move(map_val_status).error();
-                    err.prepend_field(*key);
+                    if constexpr(config::error_detail<config::config_of<D>>) {
+                        err.prepend_field(*key);
+                    }
                     return std::unexpected(std::move(err));
                 }
 
@@ -2,8 +2,10 @@
 
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 #include "spelling.h"
+#include "kota/support/fixed_string.h"
 #include "kota/meta/type_info.h"
 
 namespace kota::codec::config {
@@ -40,6 +42,93 @@ inline std::string_view apply_field_rename(bool is_serialize,
     }
 }
 
+/// apply_field_rename() for a name fixed at compile time. With a constexpr
+/// policy, as the built-in ones are, the result is a static string and
+/// `scratch` is left alone.
+template <typename Config, fixed_string Name>
+constexpr std::string_view static_field_rename(std::string& scratch) {
+    if constexpr(requires { typename Config::field_rename; }) {
+        using policy_t = typename Config::field_rename;
+        if constexpr(spelling::constexpr_rename_policy<policy_t>) {
+            return spelling::static_rename<policy_t, Name>;
+        } else {
+            scratch = spelling::apply_rename_policy<policy_t>(true, std::string_view(Name));
+            return scratch;
+        }
+    } else {
+        return std::string_view(Name);
+    }
+}
+
+/// How text formats write doubles; a Config picks one with
+/// `using float_format = ...;`. The default, shortest_float, writes the
+/// fewest digits that read back as the same double.
+struct shortest_float {};
+
+/// At most `Digits` significant digits, for payloads whose doubles carry
+/// more precision than anyone reads.
+template <int Digits>
+    requires (Digits > 0 && Digits <= 17)
+struct float_precision {
+    constexpr static int digits = Digits;
+};
+
+/// Significant digits Config's float_format allows, 0 for shortest.
+template <typename Config>
+constexpr inline int float_digits = [] {
+    if constexpr(requires { Config::float_format::digits; }) {
+        return Config::float_format::digits;
+    } else {
+        return 0;
+    }
+}();
+
+/// What deserialization errors carry; a Config picks one with
+/// `using error_detail = ...;`. By default an error has its message, the
+/// path to the failing value and, where the format knows it, the location.
+struct full_error_detail {};
+
+/// The error kind alone: no message is formatted, no path is built and no
+/// location computed. For speculative decodes, such as trying a value as
+/// each of several types, whose errors are mostly thrown away.
+struct no_error_detail {};
+
+/// False if Config asks for errors without detail.
+template <typename Config>
+constexpr inline bool error_detail = [] {
+    if constexpr(requires { typename Config::error_detail; }) {
+        return !std::is_same_v<typename Config::error_detail, no_error_detail>;
+    } else {
+        return true;
+    }
+}();
+
+/// How std::vector values are read when the format does not say how many
+/// elements follow, as streaming JSON does not; other formats have the
+/// vector reserve the length up front. A Config picks one with
+/// `using vector_buffer = ...;`. By default elements are appended to the
+/// vector as they are read, growing it a few times over.
+struct append_elements {};
+
+/// Read the elements into a small_vector with room for `N` of them first,
+/// then move them into the vector in one allocation of the final size. An
+/// empty array allocates nothing.
+template <unsigned N>
+    requires (N > 0)
+struct small_buffer {
+    constexpr static unsigned capacity = N;
+};
+
+/// Inline capacity of Config's vector_buffer, 0 to append directly.
+template <typename Config>
+constexpr inline unsigned vector_buffer_capacity = [] {
+    if constexpr(requires { Config::vector_buffer::capacity; }) {
+        return Config::vector_buffer::capacity;
+    } else {
+        return 0U;
+    }
+}();
+
 /// Apply enum rename policy from Config.
 /// If Config::enum_rename exists, uses it; otherwise returns value unchanged.
 template <typename Config>
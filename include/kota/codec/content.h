@@ -3,4 +3,5 @@
 #include "kota/codec/content/deserializer.h"
 #include "kota/codec/content/dom.h"
 #include "kota/codec/content/error.h"
+#include "kota/codec/content/overlay.h"
 #include "kota/codec/content/serializer.h"
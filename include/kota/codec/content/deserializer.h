@@ -45,20 +45,82 @@ public:
             Base(deserializer, array, array.size(), expectedLength, isStrictLength) {}
     };
 
-    class DeserializeObject :
-        public codec::detail::IndexedObjectDeserializer<Deserializer, content::ValueRef> {
-        using Base = codec::detail::IndexedObjectDeserializer<Deserializer, content::ValueRef>;
-        friend class Deserializer;
+    /// Reads the object's entries where they lie in the DOM, one after the
+    /// other, instead of copying them out first. Struct fields are already
+    /// found by hashing each key into the type's wire_name_index(), so going
+    /// through the entries once is all a struct needs.
+    class DeserializeObject {
+    public:
+        result_t<std::optional<std::string_view>> next_key() {
+            if(!deserializer.valid()) {
+                return std::unexpected(deserializer.error());
+            }
+            if(has_pending_value) {
+                return deserializer.mark_invalid();
+            }
+            if(cursor == last) {
+                return std::optional<std::string_view>{};
+            }
+
+            pending = *cursor;
+            has_pending_value = true;
+            return std::optional<std::string_view>{pending.key};
+        }
+
+        status_t invalid_key(std::string_view /*key_name*/) {
+            return skip_value();
+        }
 
-        DeserializeObject(Deserializer& deserializer, content::ObjectRef object) :
-            Base(deserializer) {
-            auto collected = deserializer.collect_object_entries(object);
-            if(!collected) {
-                (void)deserializer.mark_invalid(collected.error());
-                return;
+        template <typename T>
+        status_t deserialize_value(T& value) {
+            if(!deserializer.valid()) {
+                return std::unexpected(deserializer.error());
             }
-            this->entries = std::move(*collected);
+            if(!has_pending_value) {
+                return deserializer.mark_invalid();
+            }
+
+            KOTA_EXPECTED_TRY(deserializer.deserialize_entry_value(pending.value, value));
+
+            ++cursor;
+            has_pending_value = false;
+            return {};
         }
+
+        status_t skip_value() {
+            if(!deserializer.valid()) {
+                return std::unexpected(deserializer.error());
+            }
+            if(!has_pending_value) {
+                return deserializer.mark_invalid();
+            }
+
+            ++cursor;
+            has_pending_value = false;
+            return {};
+        }
+
+        status_t end() {
+            if(!deserializer.valid()) {
+                return std::unexpected(deserializer.error());
+            }
+
+            has_pending_value = false;
+            cursor = last;
+            return {};
+        }
+
+    private:
+        friend class Deserializer;
+
+        DeserializeObject(Deserializer& deserializer, const content::ObjectRef& object) :
+            deserializer(deserializer), cursor(object.begin()), last(object.end()) {}
+
+        Deserializer& deserializer;
+        content::ObjectRef::iterator cursor;
+        content::ObjectRef::iterator last;
+        content::ObjectRef::entry pending{};
+        bool has_pending_value = false;
     };
 
     using DeserializeSeq = DeserializeArray;
@@ -306,7 +368,6 @@ public:
 
 private:
     friend class codec::detail::IndexedArrayDeserializer<Deserializer, content::ArrayRef>;
-    friend class codec::detail::IndexedObjectDeserializer<Deserializer, content::ValueRef>;
 
     enum class value_kind : std::uint8_t {
         null,
@@ -415,21 +476,6 @@ private:
         }
     }
 
-    result_t<std::vector<typename DeserializeObject::entry>>
-        collect_object_entries(content::ObjectRef object) {
-        std::vector<typename DeserializeObject::entry> entries;
-        entries.reserve(object.size());
-
-        for(auto entry: object) {
-            entries.push_back(typename DeserializeObject::entry{
-                .key = entry.key,
-                .value = entry.value,
-            });
-        }
-
-        return entries;
-    }
-
     result_t<content::ValueRef> access_value_ref(bool consume) {
         if(!is_valid) {
             return std::unexpected(last_error);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
@@ -7,10 +8,12 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if __has_include(<yyjson.h>)
 #include "yyjson.h"
@@ -29,6 +32,7 @@ class Value;
 class Array;
 class Object;
 class Document;
+class Overlay;
 
 enum class ValueKind : std::uint8_t {
     invalid = 0,
@@ -96,6 +100,7 @@ private:
     std::uintptr_t tagged_handle_value = 0;
 
     friend class OwnedDoc;
+    friend class Overlay;
 };
 
 class ValueRef : public TaggedRef {
@@ -293,7 +298,8 @@ private:
 private:
     friend class ObjectRef;
 
-    const ObjectRef* owner = nullptr;
+    // A copy, so the iterator outlives the ObjectRef it came from.
+    ObjectRef owner{};
     bool end_flag = true;
     bool mutable_mode = false;
     yyjson_obj_iter immutable_iter{};
@@ -302,10 +308,62 @@ private:
     yyjson_mut_val* mutable_key = nullptr;
 };
 
+/// Bump allocator for yyjson documents, handed to Value::parse() through
+/// parse_options::allocator. Allocations are carved out of large blocks and
+/// freeing does nothing, so a parse costs at most a few block allocations.
+/// reset() rewinds to the first block for the next message, keeping every
+/// block; all Values allocated from the arena must be gone by then. Not
+/// thread-safe, and not movable: the yyjson_alc points back at it.
+class Arena {
+public:
+    constexpr static std::size_t default_block_size = 64 * 1024;
+
+    explicit Arena(std::size_t block_size = default_block_size) noexcept;
+
+    Arena(const Arena&) = delete;
+    auto operator=(const Arena&) -> Arena& = delete;
+
+    [[nodiscard]] yyjson_alc* allocator() noexcept {
+        return &alc;
+    }
+
+    void reset() noexcept;
+
+    /// Bytes handed out since the last reset(), alignment padding included.
+    [[nodiscard]] std::size_t used() const noexcept;
+
+private:
+    struct block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    static void* allocate(void* context, std::size_t size) noexcept;
+    static void* reallocate(void* context,
+                            void* pointer,
+                            std::size_t old_size,
+                            std::size_t size) noexcept;
+    static void deallocate(void* context, void* pointer) noexcept;
+
+    void* bump(std::size_t size) noexcept;
+
+    yyjson_alc alc{};
+    std::vector<block> blocks;
+    std::size_t block_size;
+    std::size_t current = 0;
+    std::size_t offset = 0;
+    std::size_t retired = 0;
+};
+
+/// Shared ownership of a yyjson document. The count is atomic, so copies of
+/// one Value may live on different threads: parsed documents are never
+/// written, and writing through a shared copy detaches it first.
 class OwnedDoc {
 public:
     using status_t = std::expected<void, error_kind>;
 
+    using ref_count_t = std::atomic<int>;
+
     OwnedDoc() noexcept = default;
 
     OwnedDoc(const OwnedDoc& other) noexcept;
@@ -326,13 +384,13 @@ public:
 
 protected:
     OwnedDoc(std::uintptr_t tagged_doc_handle,
-             int* ref_count,
+             ref_count_t* ref_count,
              bool retain_owner,
              bool external_owner = false) noexcept;
 
     constexpr static std::uintptr_t k_mutable_bit = std::uintptr_t{1};
     std::uintptr_t tagged_doc_handle = 0;
-    int* ref_count = nullptr;
+    ref_count_t* ref_count = nullptr;
     bool external_owner = false;
 
     [[nodiscard]] static std::uintptr_t tag_doc(const void* pointer, bool mutable_bit) noexcept;
@@ -372,6 +430,18 @@ public:
     static auto parse(std::string_view json, parse_options options)
         -> std::expected<Value, yyjson_read_code>;
 
+    /// Parses the first `length` bytes of `buffer` in place: strings are
+    /// unescaped where they are and the result points into `buffer`, so
+    /// nothing is copied. At least YYJSON_PADDING_SIZE bytes must follow the
+    /// JSON, or the parse fails with YYJSON_READ_ERROR_INVALID_PARAMETER, and
+    /// `buffer` has to outlive the result and every copy of it.
+    static auto parse_in_place(std::span<char> buffer, std::size_t length)
+        -> std::expected<Value, yyjson_read_code>;
+
+    static auto parse_in_place(std::span<char> buffer,
+                               std::size_t length,
+                               parse_options options) -> std::expected<Value, yyjson_read_code>;
+
     static auto from_immutable_doc(yyjson_doc* raw_doc) noexcept -> std::optional<Value>;
 
     static auto from_mutable_doc(yyjson_mut_doc* raw_doc) noexcept -> std::optional<Value>;
@@ -419,7 +489,7 @@ private:
 
     Value(std::uintptr_t tagged_value_handle,
           std::uintptr_t tagged_doc_handle,
-          int* ref_count,
+          ref_count_t* ref_count,
           bool retain_owner,
           bool external_owner = false) noexcept;
 
@@ -472,7 +542,7 @@ private:
 
     Array(std::uintptr_t tagged_value_handle,
           std::uintptr_t tagged_doc_handle,
-          int* ref_count,
+          ref_count_t* ref_count,
           bool retain_owner,
           bool external_owner = false) noexcept;
 
@@ -524,7 +594,7 @@ private:
 
     Object(std::uintptr_t tagged_value_handle,
            std::uintptr_t tagged_doc_handle,
-           int* ref_count,
+           ref_count_t* ref_count,
            bool retain_owner,
            bool external_owner = false) noexcept;
 
@@ -4,10 +4,98 @@
 #define KOTA_CODEC_CONTENT_DOM_INL_INCLUDED 1
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 #include "kota/codec/content/dom.h"
 
 namespace kota::codec::content {
 
+inline Arena::Arena(std::size_t block_size) noexcept : block_size(block_size) {
+    alc.malloc = &Arena::allocate;
+    alc.realloc = &Arena::reallocate;
+    alc.free = &Arena::deallocate;
+    alc.ctx = this;
+}
+
+inline void Arena::reset() noexcept {
+    current = 0;
+    offset = 0;
+    retired = 0;
+}
+
+inline std::size_t Arena::used() const noexcept {
+    return retired + offset;
+}
+
+inline void* Arena::bump(std::size_t size) noexcept {
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    const auto rounded = (size + alignment - 1) & ~(alignment - 1);
+    if(rounded < size) {
+        return nullptr;
+    }
+
+    // Move on to the next block that fits; ones skipped stay unused until
+    // the next reset().
+    while(current < blocks.size() && blocks[current].size - offset < rounded) {
+        retired += blocks[current].size;
+        ++current;
+        offset = 0;
+    }
+    if(current == blocks.size()) {
+        const auto wanted = (std::max)(block_size, rounded);
+        auto* data = new (std::nothrow) std::byte[wanted];
+        if(data == nullptr) {
+            return nullptr;
+        }
+        try {
+            blocks.push_back(block{std::unique_ptr<std::byte[]>(data), wanted});
+        } catch(...) {
+            delete[] data;
+            return nullptr;
+        }
+    }
+
+    auto* result = blocks[current].data.get() + offset;
+    offset += rounded;
+    return result;
+}
+
+inline void* Arena::allocate(void* context, std::size_t size) noexcept {
+    return static_cast<Arena*>(context)->bump(size);
+}
+
+inline void* Arena::reallocate(void* context,
+                               void* pointer,
+                               std::size_t old_size,
+                               std::size_t size) noexcept {
+    auto& arena = *static_cast<Arena*>(context);
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    const auto old_rounded = (old_size + alignment - 1) & ~(alignment - 1);
+    const auto rounded = (size + alignment - 1) & ~(alignment - 1);
+
+    // The most recent allocation grows or shrinks where it is when its block
+    // has room.
+    if(pointer != nullptr && arena.current < arena.blocks.size()) {
+        auto& top = arena.blocks[arena.current];
+        auto* at = static_cast<std::byte*>(pointer);
+        if(at + old_rounded == top.data.get() + arena.offset &&
+           rounded <= top.size - (arena.offset - old_rounded)) {
+            arena.offset = arena.offset - old_rounded + rounded;
+            return pointer;
+        }
+    }
+
+    void* moved = arena.bump(size);
+    if(moved != nullptr && pointer != nullptr) {
+        std::memcpy(moved, pointer, (std::min)(old_size, size));
+    }
+    return moved;
+}
+
+inline void Arena::deallocate(void* /*context*/, void* /*pointer*/) noexcept {}
+
 inline TaggedRef::TaggedRef(const yyjson_val* value) noexcept :
     tagged_handle_value(tag_handle(value, false)) {}
 
@@ -386,17 +474,17 @@ inline auto ObjectRef::end() const noexcept -> iterator {
 }
 
 inline ObjectRef::iterator::iterator(const ObjectRef* owner, bool end) noexcept :
-    owner(owner), end_flag(end) {
-    if(owner == nullptr || end || !owner->valid()) {
+    owner(owner != nullptr ? *owner : ObjectRef{}), end_flag(end) {
+    if(end || !this->owner.valid()) {
         return;
     } else {
-        mutable_mode = owner->mutable_ref();
+        mutable_mode = this->owner.mutable_ref();
         if(mutable_mode) {
-            mutable_iter = yyjson_mut_obj_iter_with(owner->mutable_ptr());
+            mutable_iter = yyjson_mut_obj_iter_with(this->owner.mutable_ptr());
             mutable_key = yyjson_mut_obj_iter_next(&mutable_iter);
             end_flag = (mutable_key == nullptr);
         } else {
-            immutable_iter = yyjson_obj_iter_with(owner->immutable_ptr());
+            immutable_iter = yyjson_obj_iter_with(this->owner.immutable_ptr());
             immutable_key = yyjson_obj_iter_next(&immutable_iter);
             end_flag = (immutable_key == nullptr);
         }
@@ -404,9 +492,8 @@ inline ObjectRef::iterator::iterator(const ObjectRef* owner, bool end) noexcept
 }
 
 inline auto ObjectRef::iterator::operator*() const noexcept -> value_type {
-    assert(owner != nullptr);
     assert(!end_flag);
-    assert(owner->valid());
+    assert(owner.valid());
 
     if(mutable_mode) {
         auto* key = mutable_key;
@@ -458,7 +545,7 @@ inline auto ObjectRef::iterator::operator++(int) noexcept -> iterator {
 }
 
 inline bool ObjectRef::iterator::operator==(const iterator& other) const noexcept {
-    if(owner != other.owner) {
+    if(owner.tagged_handle() != other.owner.tagged_handle()) {
         return false;
     } else if(end_flag && other.end_flag) {
         return true;
@@ -527,7 +614,7 @@ inline int OwnedDoc::use_count() const noexcept {
     if(ref_count == nullptr) {
         return 0;
     }
-    return *ref_count;
+    return ref_count->load(std::memory_order_acquire);
 }
 
 inline bool OwnedDoc::mutable_doc() const noexcept {
@@ -599,7 +686,7 @@ inline auto OwnedDoc::ensure_writable_doc_and_rebind_root(TaggedRef& ref)
         }
 
         if(copied) {
-            int* new_ref_count = new (std::nothrow) int(1);
+            auto* new_ref_count = new (std::nothrow) ref_count_t(1);
             if(new_ref_count == nullptr) {
                 yyjson_mut_doc_free(writable_doc);
                 return std::unexpected(error_kind::allocation_failed);
@@ -622,7 +709,7 @@ inline auto OwnedDoc::ensure_writable_doc_and_rebind_root(TaggedRef& ref)
 }
 
 inline OwnedDoc::OwnedDoc(std::uintptr_t tagged_doc_handle,
-                          int* ref_count,
+                          ref_count_t* ref_count,
                           bool retain_owner,
                           bool external_owner) noexcept :
     tagged_doc_handle(tagged_doc_handle), ref_count(ref_count), external_owner(external_owner) {
@@ -635,7 +722,7 @@ inline void OwnedDoc::retain() noexcept {
     if(ref_count == nullptr) {
         return;
     }
-    ++(*ref_count);
+    ref_count->fetch_add(1, std::memory_order_relaxed);
 }
 
 inline void OwnedDoc::release() noexcept {
@@ -644,8 +731,8 @@ inline void OwnedDoc::release() noexcept {
         return;
     }
 
-    --(*ref_count);
-    if(*ref_count == 0) {
+    // The last release has to see every write made through other copies.
+    if(ref_count->fetch_sub(1, std::memory_order_acq_rel) == 1) {
         auto* raw_doc = reinterpret_cast<void*>(tagged_doc_handle & ~k_mutable_bit);
         if(!external_owner && raw_doc != nullptr) {
             mutable_doc() ? yyjson_mut_doc_free(reinterpret_cast<yyjson_mut_doc*>(raw_doc))
@@ -661,7 +748,7 @@ inline void OwnedDoc::release() noexcept {
 
 inline Value::Value(std::uintptr_t tagged_value_handle,
                     std::uintptr_t tagged_doc_handle,
-                    int* ref_count,
+                    ref_count_t* ref_count,
                     bool retain_owner,
                     bool external_owner) noexcept :
     ValueRef(tagged_value_handle),
@@ -692,6 +779,36 @@ inline auto Value::parse(std::string_view json, parse_options options)
     }
 }
 
+inline auto Value::parse_in_place(std::span<char> buffer, std::size_t length)
+    -> std::expected<Value, yyjson_read_code> {
+    return parse_in_place(buffer, length, parse_options{});
+}
+
+inline auto Value::parse_in_place(std::span<char> buffer,
+                                  std::size_t length,
+                                  parse_options options) -> std::expected<Value, yyjson_read_code> {
+    if(length > buffer.size() || buffer.size() - length < YYJSON_PADDING_SIZE) {
+        return std::unexpected(YYJSON_READ_ERROR_INVALID_PARAMETER);
+    }
+
+    // yyjson reads the padding as a sentinel, so it has to be zero.
+    std::fill_n(buffer.data() + length, YYJSON_PADDING_SIZE, '\0');
+    auto flags = static_cast<yyjson_read_flag>(options.flags | YYJSON_READ_INSITU);
+    yyjson_read_err err{};
+    yyjson_doc* raw_doc =
+        yyjson_read_opts(buffer.data(), length, flags, options.allocator, &err);
+    if(raw_doc == nullptr) {
+        return std::unexpected(err.code);
+    } else {
+        auto value = from_immutable_doc(raw_doc);
+        if(!value.has_value()) {
+            return std::unexpected(YYJSON_READ_ERROR_MEMORY_ALLOCATION);
+        } else {
+            return std::move(*value);
+        }
+    }
+}
+
 inline auto Value::from_immutable_doc(yyjson_doc* raw_doc) noexcept -> std::optional<Value> {
     if(raw_doc == nullptr) {
         return std::nullopt;
@@ -703,7 +820,7 @@ inline auto Value::from_immutable_doc(yyjson_doc* raw_doc) noexcept -> std::opti
         return std::nullopt;
     }
 
-    int* ref_count = new (std::nothrow) int(1);
+    auto* ref_count = new (std::nothrow) OwnedDoc::ref_count_t(1);
     if(ref_count == nullptr) {
         yyjson_doc_free(raw_doc);
         return std::nullopt;
@@ -723,7 +840,7 @@ inline auto Value::from_mutable_doc(yyjson_mut_doc* raw_doc) noexcept -> std::op
         return std::nullopt;
     }
 
-    int* ref_count = new (std::nothrow) int(1);
+    auto* ref_count = new (std::nothrow) OwnedDoc::ref_count_t(1);
     if(ref_count == nullptr) {
         yyjson_mut_doc_free(raw_doc);
         return std::nullopt;
@@ -931,7 +1048,7 @@ inline auto Value::operator=(T&& value) -> Value& {
 
 inline Array::Array(std::uintptr_t tagged_value_handle,
                     std::uintptr_t tagged_doc_handle,
-                    int* ref_count,
+                    ref_count_t* ref_count,
                     bool retain_owner,
                     bool external_owner) noexcept :
     ArrayRef(tagged_value_handle),
@@ -1050,7 +1167,7 @@ inline auto Array::insert(std::size_t index, T&& value) -> status_t {
 
 inline Object::Object(std::uintptr_t tagged_value_handle,
                       std::uintptr_t tagged_doc_handle,
-                      int* ref_count,
+                      ref_count_t* ref_count,
                       bool retain_owner,
                       bool external_owner) noexcept :
     ObjectRef(tagged_value_handle),
@@ -1216,7 +1333,7 @@ inline Array Document::make_array() {
     doc = std::shared_ptr<yyjson_mut_doc>(detached_doc, yyjson_mut_doc_free);
     owner_root.reset();
 
-    int* ref_count = new (std::nothrow) int(1);
+    auto* ref_count = new (std::nothrow) OwnedDoc::ref_count_t(1);
     if(ref_count == nullptr) {
         return Array();
     }
@@ -1250,7 +1367,7 @@ inline Object Document::make_object() {
     doc = std::shared_ptr<yyjson_mut_doc>(detached_doc, yyjson_mut_doc_free);
     owner_root.reset();
 
-    int* ref_count = new (std::nothrow) int(1);
+    auto* ref_count = new (std::nothrow) OwnedDoc::ref_count_t(1);
     if(ref_count == nullptr) {
         return Object();
     }
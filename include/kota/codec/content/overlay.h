@@ -0,0 +1,444 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "kota/support/expected_try.h"
+#include "kota/codec/content/dom.h"
+#include "kota/codec/json/escape.h"
+
+namespace kota::codec::content {
+
+/// Edits recorded against a document that is left as it is.
+///
+/// Writing through a Value over a parsed document first copies the whole
+/// tree into a mutable one. An Overlay keeps the base untouched and stores
+/// edits by JSON Pointer (RFC 6901), so an edit costs in the length of its
+/// path, not the size of the document. to_json_string() writes the merged
+/// result in one pass, unedited subtrees straight from the base.
+///
+/// Pointers always address the base: array indices are not shifted by
+/// removals, and paths cannot go below a value that an edit replaced or
+/// added. The base has to stay alive and unmodified while the overlay is
+/// in use; values handed to set() are kept by the overlay.
+class Overlay {
+public:
+    using status_t = std::expected<void, error_kind>;
+
+    Overlay() noexcept = default;
+
+    explicit Overlay(Value value) noexcept : base(std::move(value)) {}
+
+    [[nodiscard]] const Value& base_value() const noexcept {
+        return base;
+    }
+
+    /// True if nothing has been edited.
+    [[nodiscard]] bool empty() const noexcept {
+        return root.is_unchanged();
+    }
+
+    /// Replaces the value at `pointer`, or adds it when the last token names
+    /// a member missing from an object. Everything above it must exist.
+    auto set(std::string_view pointer, Value value) -> status_t;
+
+    /// Drops the member or element at `pointer`, or an earlier added member.
+    auto remove(std::string_view pointer) -> status_t;
+
+    /// The value at `pointer` with the edits applied, if there is one.
+    [[nodiscard]] auto get(std::string_view pointer) const -> std::optional<ValueRef>;
+
+    [[nodiscard]] auto to_json_string() const -> std::expected<std::string, yyjson_write_code>;
+
+private:
+    enum class edit : std::uint8_t {
+        inherited,
+        replaced,
+        removed,
+    };
+
+    struct node {
+        edit state = edit::inherited;
+        Value replacement;
+        std::map<std::string, node, std::less<>> members;
+        std::map<std::size_t, node> elements;
+
+        /// Lookups that failed partway can leave empty inherited nodes behind,
+        /// so this looks through the children too.
+        [[nodiscard]] bool is_unchanged() const noexcept {
+            if(state != edit::inherited) {
+                return false;
+            }
+            for(const auto& [key, child]: members) {
+                if(!child.is_unchanged()) {
+                    return false;
+                }
+            }
+            for(const auto& [index, child]: elements) {
+                if(!child.is_unchanged()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    using write_status = std::expected<void, yyjson_write_code>;
+
+    static auto split_pointer(std::string_view pointer)
+        -> std::expected<std::vector<std::string>, error_kind>;
+
+    static auto parse_index(std::string_view token, std::size_t size)
+        -> std::expected<std::size_t, error_kind>;
+
+    /// The node and base value the last of `tokens` is looked up in.
+    auto walk_to_parent(const std::vector<std::string>& tokens)
+        -> std::expected<std::pair<node*, ValueRef>, error_kind>;
+
+    static auto write_node(std::string& out, ValueRef source, const node& edits) -> write_status;
+
+    static auto write_value(std::string& out, const TaggedRef& source) -> write_status;
+
+    static void write_key(std::string& out, std::string_view key);
+
+    Value base;
+    node root;
+};
+
+inline auto Overlay::split_pointer(std::string_view pointer)
+    -> std::expected<std::vector<std::string>, error_kind> {
+    std::vector<std::string> tokens;
+    if(pointer.empty()) {
+        return tokens;
+    }
+    if(pointer.front() != '/') {
+        return std::unexpected(error_kind::parse_error);
+    }
+
+    pointer.remove_prefix(1);
+    while(true) {
+        const auto slash = pointer.find('/');
+        auto raw = pointer.substr(0, slash);
+        std::string token;
+        token.reserve(raw.size());
+        for(std::size_t i = 0; i < raw.size(); ++i) {
+            if(raw[i] != '~') {
+                token.push_back(raw[i]);
+            } else if(i + 1 < raw.size() && (raw[i + 1] == '0' || raw[i + 1] == '1')) {
+                token.push_back(raw[++i] == '0' ? '~' : '/');
+            } else {
+                return std::unexpected(error_kind::parse_error);
+            }
+        }
+        tokens.push_back(std::move(token));
+        if(slash == std::string_view::npos) {
+            return tokens;
+        }
+        pointer.remove_prefix(slash + 1);
+    }
+}
+
+inline auto Overlay::parse_index(std::string_view token, std::size_t size)
+    -> std::expected<std::size_t, error_kind> {
+    // RFC 6901 indices are plain decimals without leading zeros.
+    if(token.empty() || (token.size() > 1 && token.front() == '0')) {
+        return std::unexpected(error_kind::parse_error);
+    }
+    std::size_t index = 0;
+    for(char c: token) {
+        if(c < '0' || c > '9') {
+            return std::unexpected(error_kind::parse_error);
+        }
+        index = index * 10 + static_cast<std::size_t>(c - '0');
+        if(index >= size) {
+            return std::unexpected(error_kind::index_out_of_bounds);
+        }
+    }
+    return index;
+}
+
+inline auto Overlay::walk_to_parent(const std::vector<std::string>& tokens)
+    -> std::expected<std::pair<node*, ValueRef>, error_kind> {
+    node* edits = &root;
+    ValueRef source = base.as_ref();
+    for(std::size_t i = 0; i + 1 < tokens.size(); ++i) {
+        if(edits->state != edit::inherited) {
+            return std::unexpected(error_kind::invalid_state);
+        }
+
+        const auto& token = tokens[i];
+        if(auto object = source.get_object()) {
+            auto child = object->get(token);
+            if(!child.has_value()) {
+                // A member added by set() has no base to edit below.
+                return std::unexpected(edits->members.contains(token) ? error_kind::invalid_state
+                                                                      : error_kind::no_such_field);
+            }
+            edits = &edits->members[token];
+            source = *child;
+        } else if(auto array = source.get_array()) {
+            KOTA_EXPECTED_TRY_V(auto index, parse_index(token, array->size()));
+            edits = &edits->elements[index];
+            source = (*array)[index];
+        } else {
+            return std::unexpected(error_kind::type_mismatch);
+        }
+    }
+
+    if(edits->state != edit::inherited) {
+        return std::unexpected(error_kind::invalid_state);
+    }
+    return std::pair{edits, source};
+}
+
+inline auto Overlay::set(std::string_view pointer, Value value) -> status_t {
+    if(!base.valid() || !value.valid()) {
+        return std::unexpected(error_kind::invalid_state);
+    }
+
+    KOTA_EXPECTED_TRY_V(auto tokens, split_pointer(pointer));
+    auto assign = [&](node& target) {
+        target = node{};
+        target.state = edit::replaced;
+        target.replacement = std::move(value);
+    };
+    if(tokens.empty()) {
+        assign(root);
+        return {};
+    }
+
+    KOTA_EXPECTED_TRY_V(auto parent, walk_to_parent(tokens));
+    auto [edits, source] = parent;
+    if(source.is_object()) {
+        assign(edits->members[tokens.back()]);
+        return {};
+    } else if(auto array = source.get_array()) {
+        KOTA_EXPECTED_TRY_V(auto index, parse_index(tokens.back(), array->size()));
+        assign(edits->elements[index]);
+        return {};
+    } else {
+        return std::unexpected(error_kind::type_mismatch);
+    }
+}
+
+inline auto Overlay::remove(std::string_view pointer) -> status_t {
+    if(!base.valid()) {
+        return std::unexpected(error_kind::invalid_state);
+    }
+
+    KOTA_EXPECTED_TRY_V(auto tokens, split_pointer(pointer));
+    if(tokens.empty()) {
+        return std::unexpected(error_kind::invalid_state);
+    }
+
+    KOTA_EXPECTED_TRY_V(auto parent, walk_to_parent(tokens));
+    auto [edits, source] = parent;
+    const auto& key = tokens.back();
+    if(auto object = source.get_object()) {
+        if(object->contains(key)) {
+            auto& target = edits->members[key];
+            if(target.state == edit::removed) {
+                return std::unexpected(error_kind::no_such_field);
+            }
+            target = node{};
+            target.state = edit::removed;
+            return {};
+        }
+        // Not in the base: only a member added by set() can go.
+        auto added = edits->members.find(key);
+        if(added == edits->members.end() || added->second.state != edit::replaced) {
+            return std::unexpected(error_kind::no_such_field);
+        }
+        edits->members.erase(added);
+        return {};
+    } else if(auto array = source.get_array()) {
+        KOTA_EXPECTED_TRY_V(auto index, parse_index(key, array->size()));
+        auto& target = edits->elements[index];
+        if(target.state == edit::removed) {
+            return std::unexpected(error_kind::index_out_of_bounds);
+        }
+        target = node{};
+        target.state = edit::removed;
+        return {};
+    } else {
+        return std::unexpected(error_kind::type_mismatch);
+    }
+}
+
+inline auto Overlay::get(std::string_view pointer) const -> std::optional<ValueRef> {
+    auto tokens = split_pointer(pointer);
+    if(!tokens.has_value() || !base.valid()) {
+        return std::nullopt;
+    }
+
+    // `edits` goes null once the path leaves what the overlay tracks.
+    const node* edits = &root;
+    ValueRef source = base.as_ref();
+    auto apply = [&]() -> bool {
+        if(edits == nullptr || edits->state == edit::inherited) {
+            return true;
+        }
+        if(edits->state == edit::removed) {
+            return false;
+        }
+        source = edits->replacement.as_ref();
+        edits = nullptr;
+        return true;
+    };
+
+    if(!apply()) {
+        return std::nullopt;
+    }
+    for(const auto& token: *tokens) {
+        const node* next = nullptr;
+        if(auto object = source.get_object()) {
+            if(edits != nullptr) {
+                if(auto found = edits->members.find(token); found != edits->members.end()) {
+                    next = &found->second;
+                }
+            }
+            if(auto child = object->get(token)) {
+                source = *child;
+            } else if(next == nullptr || next->state != edit::replaced) {
+                return std::nullopt;
+            }
+        } else if(auto array = source.get_array()) {
+            auto index = parse_index(token, array->size());
+            if(!index.has_value()) {
+                return std::nullopt;
+            }
+            if(edits != nullptr) {
+                if(auto found = edits->elements.find(*index); found != edits->elements.end()) {
+                    next = &found->second;
+                }
+            }
+            source = (*array)[*index];
+        } else {
+            return std::nullopt;
+        }
+
+        edits = next;
+        if(!apply()) {
+            return std::nullopt;
+        }
+    }
+    return source;
+}
+
+inline auto Overlay::to_json_string() const -> std::expected<std::string, yyjson_write_code> {
+    if(!base.valid()) {
+        return std::unexpected(YYJSON_WRITE_ERROR_INVALID_PARAMETER);
+    }
+
+    std::string out;
+    KOTA_EXPECTED_TRY(write_node(out, base.as_ref(), root));
+    return out;
+}
+
+inline auto Overlay::write_node(std::string& out, ValueRef source, const node& edits)
+    -> write_status {
+    if(edits.state == edit::replaced) {
+        return write_value(out, edits.replacement);
+    }
+    if(edits.is_unchanged()) {
+        return write_value(out, source);
+    }
+
+    if(auto object = source.get_object()) {
+        bool first = true;
+        auto separate = [&] {
+            if(!first) {
+                out.push_back(',');
+            }
+            first = false;
+        };
+
+        out.push_back('{');
+        for(auto [key, value]: *object) {
+            auto found = edits.members.find(key);
+            if(found != edits.members.end() && found->second.state == edit::removed) {
+                continue;
+            }
+            separate();
+            write_key(out, key);
+            out.push_back(':');
+            if(found == edits.members.end()) {
+                KOTA_EXPECTED_TRY(write_value(out, value));
+            } else {
+                KOTA_EXPECTED_TRY(write_node(out, value, found->second));
+            }
+        }
+        // Added members follow the base ones, in key order.
+        for(const auto& [key, child]: edits.members) {
+            if(child.state != edit::replaced || object->contains(key)) {
+                continue;
+            }
+            separate();
+            write_key(out, key);
+            out.push_back(':');
+            KOTA_EXPECTED_TRY(write_value(out, child.replacement));
+        }
+        out.push_back('}');
+        return {};
+    }
+
+    if(auto array = source.get_array()) {
+        bool first = true;
+        std::size_t index = 0;
+        out.push_back('[');
+        for(auto element: *array) {
+            auto found = edits.elements.find(index++);
+            if(found != edits.elements.end() && found->second.state == edit::removed) {
+                continue;
+            }
+            if(!first) {
+                out.push_back(',');
+            }
+            first = false;
+            if(found == edits.elements.end()) {
+                KOTA_EXPECTED_TRY(write_value(out, element));
+            } else {
+                KOTA_EXPECTED_TRY(write_node(out, element, found->second));
+            }
+        }
+        out.push_back(']');
+        return {};
+    }
+
+    return write_value(out, source);
+}
+
+inline auto Overlay::write_value(std::string& out, const TaggedRef& source) -> write_status {
+    if(!source.valid()) {
+        return std::unexpected(YYJSON_WRITE_ERROR_INVALID_PARAMETER);
+    }
+
+    yyjson_write_err err{};
+    size_t len = 0;
+    constexpr auto flags = YYJSON_WRITE_NOFLAG;
+    char* text = source.mutable_ref()
+                     ? yyjson_mut_val_write_opts(source.mutable_ptr(), flags, nullptr, &len, &err)
+                     : yyjson_val_write_opts(source.immutable_ptr(), flags, nullptr, &len, &err);
+    if(text == nullptr) {
+        return std::unexpected(err.code);
+    }
+    out.append(text, len);
+    std::free(text);
+    return {};
+}
+
+inline void Overlay::write_key(std::string& out, std::string_view key) {
+    out.push_back('"');
+    json::escape_string(key, [&](std::string_view part) { out.append(part); });
+    out.push_back('"');
+}
+
+}  // namespace kota::codec::content
@@ -4,19 +4,24 @@
 #include <format>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "kota/meta/attrs.h"
+#include "kota/codec/detail/enum_flags.h"
+#include "kota/codec/detail/intern.h"
 #include "kota/codec/spelling.h"
 
 namespace kota::codec::detail {
 
 /// Serialize-side behavior attribute dispatch.
 ///
-/// Checks attrs_t for `with`/`as`/`enum_string` and handles them:
+/// Checks attrs_t for `with`/`as`/`enum_string`/`enum_flags`/`intern` and handles them:
 ///   - with:        calls with_fn(type_identity<Adapter>{}, value)
 ///   - as:          converts value to Target, then calls emit(converted)
 ///   - enum_string: maps enum to string, then calls emit(string)
+///   - enum_flags:  calls emit() with a proxy that writes the flag names
+///   - intern:      calls emit() with the string's text
 ///
 /// Returns std::nullopt if no behavior attribute matched (caller should use default path).
 template <typename attrs_t, typename value_t, typename E, typename Emitter, typename WithFn>
@@ -35,8 +40,17 @@ constexpr auto apply_serialize_behavior(const value_t& value, Emitter&& emit, Wi
     } else if constexpr(tuple_has_spec_v<attrs_t, meta::behavior::enum_string>) {
         using Policy = typename tuple_find_spec_t<attrs_t, meta::behavior::enum_string>::policy;
         static_assert(std::is_enum_v<value_t>, "behavior::enum_string requires an enum type");
-        auto enum_text = spelling::map_enum_to_string<value_t, Policy>(value);
+        std::string scratch;
+        auto enum_text = spelling::map_enum_to_string_view<value_t, Policy>(value, scratch);
         return emit(enum_text);
+    } else if constexpr(tuple_has_spec_v<attrs_t, meta::behavior::enum_flags>) {
+        using Policy = typename tuple_find_spec_t<attrs_t, meta::behavior::enum_flags>::policy;
+        static_assert(meta::flag_enum<value_t>, "behavior::enum_flags requires a flag enum");
+        return emit(enum_flag_names<value_t, Policy>(value));
+    } else if constexpr(tuple_has_spec_v<attrs_t, meta::behavior::intern>) {
+        static_assert(std::is_same_v<value_t, interned_string>,
+                      "behavior::intern requires an interned_string");
+        return emit(std::string_view(value));
     } else {
         return std::nullopt;
     }
@@ -44,10 +58,12 @@ constexpr auto apply_serialize_behavior(const value_t& value, Emitter&& emit, Wi
 
 /// Deserialize-side behavior attribute dispatch.
 ///
-/// Checks attrs_t for `with`/`as`/`enum_string` and handles them:
+/// Checks attrs_t for `with`/`as`/`enum_string`/`enum_flags`/`intern` and handles them:
 ///   - with:        calls with_fn(type_identity<Adapter>{}, value)
 ///   - as:          deserializes into Target via read(temp), then converts back
 ///   - enum_string: reads string via read(str), then maps to enum
+///   - enum_flags:  calls read() with a proxy that reads the flag names
+///   - intern:      calls read() with a proxy that interns into the named pool
 ///
 /// Returns std::nullopt if no behavior attribute matched (caller should use default path).
 template <typename attrs_t, typename value_t, typename E, typename Reader, typename WithFn>
@@ -84,6 +100,17 @@ constexpr auto apply_deserialize_behavior(value_t& value, Reader&& read, WithFn&
             return std::expected<void, E>(std::unexpected(
                 E::custom(std::format("unknown enum string value '{}'", enum_text))));
         }
+    } else if constexpr(tuple_has_spec_v<attrs_t, meta::behavior::enum_flags>) {
+        using Policy = typename tuple_find_spec_t<attrs_t, meta::behavior::enum_flags>::policy;
+        static_assert(meta::flag_enum<value_t>, "behavior::enum_flags requires a flag enum");
+        enum_flag_names_out<value_t, Policy> flags(value);
+        return std::expected<void, E>(read(flags));
+    } else if constexpr(tuple_has_spec_v<attrs_t, meta::behavior::intern>) {
+        using Pool = typename tuple_find_spec_t<attrs_t, meta::behavior::intern>::pool;
+        static_assert(std::is_same_v<value_t, interned_string>,
+                      "behavior::intern requires an interned_string");
+        interned_string_out<Pool> out(value);
+        return std::expected<void, E>(read(out));
     } else {
         return std::nullopt;
     }
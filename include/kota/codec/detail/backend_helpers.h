@@ -98,6 +98,11 @@ public:
         return index < array_size;
     }
 
+    /// Elements left to read, so a container can reserve room for them.
+    std::size_t size_hint() const noexcept {
+        return array_size - index;
+    }
+
     template <typename T>
     status_t deserialize_element(T& value) {
         KOTA_EXPECTED_TRY_V(auto has_next_result, has_next());
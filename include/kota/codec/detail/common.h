@@ -1,10 +1,13 @@
 #pragma once
 
 #include <limits>
+#include <memory>
 #include <optional>
 #include <type_traits>
 #include <utility>
 
+#include "kota/codec/config.h"
+
 namespace kota::codec {
 
 namespace content {
@@ -51,6 +54,34 @@ template <typename D>
 template <typename D>
 constexpr bool can_buffer_adjacently_tagged_v = can_buffer_adjacently_tagged<D>::value;
 
+/// make()'s error, or when Config asks for no error detail the bare
+/// type_mismatch the message would have gone with, so nothing is formatted.
+template <typename Config, typename E, typename Make>
+constexpr auto detailed_error(Make&& make) -> E {
+    if constexpr(config::error_detail<Config>) {
+        return std::forward<Make>(make)();
+    } else {
+        return E(E::type_mismatch);
+    }
+}
+
+/// A new element for `container`, built with the container's allocator when
+/// it takes one: the elements of a std::pmr container then come from its
+/// memory resource, not the default one, and move in without a copy.
+template <typename T, typename Container>
+constexpr T make_element(const Container& container) {
+    if constexpr(requires { container.get_allocator(); }) {
+        using allocator_t = decltype(container.get_allocator());
+        if constexpr(std::uses_allocator_v<T, allocator_t>) {
+            return std::make_obj_using_allocator<T>(container.get_allocator());
+        } else {
+            return T{};
+        }
+    } else {
+        return T{};
+    }
+}
+
 template <typename To, typename From>
 constexpr bool integral_value_in_range(From value) {
     static_assert(std::is_integral_v<To>);
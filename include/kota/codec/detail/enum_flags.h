@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+
+#include "kota/support/expected_try.h"
+#include "kota/meta/enum.h"
+#include "kota/codec/detail/fwd.h"
+#include "kota/codec/spelling.h"
+
+namespace kota::codec::detail {
+
+/// A flag enum to be written as the array of its set flags' names, one
+/// name at a time, with no vector in between. Bits with no name are not
+/// written, as enum_string writes nothing for an unnamed value.
+template <typename E, typename Policy>
+class enum_flag_names {
+public:
+    explicit constexpr enum_flag_names(const E& value) noexcept : value(&value) {}
+
+    const E* value;
+};
+
+/// A flag enum to be read from an array of flag names, each name read
+/// into the same scratch string.
+template <typename E, typename Policy>
+class enum_flag_names_out {
+public:
+    explicit constexpr enum_flag_names_out(E& value) noexcept : value(&value) {}
+
+    E* value;
+};
+
+}  // namespace kota::codec::detail
+
+namespace kota::codec {
+
+template <typename S, typename E, typename Policy>
+struct serialize_traits<S, detail::enum_flag_names<E, Policy>> {
+    using value_type = typename S::value_type;
+    using error_type = typename S::error_type;
+
+    static auto serialize(S& serializer, const detail::enum_flag_names<E, Policy>& flags)
+        -> std::expected<value_type, error_type> {
+        using reflect = meta::flag_reflection<E>;
+        using bits_t = typename reflect::bits_t;
+        const auto bits = static_cast<bits_t>(*flags.value);
+        const auto named = static_cast<bits_t>(bits & reflect::known_bits);
+
+        const auto count = static_cast<std::size_t>(std::popcount(named));
+
+        KOTA_EXPECTED_TRY_V(auto seq, serializer.serialize_seq(count));
+        std::string scratch;
+        for(std::size_t i = 0; i < reflect::member_count; ++i) {
+            if(bits & reflect::member_bits[i]) {
+                KOTA_EXPECTED_TRY(seq.serialize_element(
+                    spelling::map_enum_flag_to_string_view<E, Policy>(i, scratch)));
+            }
+        }
+        return seq.end();
+    }
+};
+
+template <typename D, typename E, typename Policy>
+struct deserialize_traits<D, detail::enum_flag_names_out<E, Policy>> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, detail::enum_flag_names_out<E, Policy>& flags)
+        -> std::expected<void, error_type> {
+        using bits_t = typename meta::flag_reflection<E>::bits_t;
+
+        KOTA_EXPECTED_TRY_V(auto seq, deserializer.deserialize_seq(std::nullopt));
+        bits_t bits = 0;
+        std::string name;
+        while(true) {
+            KOTA_EXPECTED_TRY_V(auto has_next, seq.has_next());
+            if(!has_next) {
+                break;
+            }
+            KOTA_EXPECTED_TRY(seq.deserialize_element(name));
+            auto flag = spelling::map_string_to_enum_flag<E, Policy>(name);
+            if(!flag) {
+                return std::unexpected(
+                    error_type::custom(std::format("unknown enum flag '{}'", name)));
+            }
+            bits |= static_cast<bits_t>(*flag);
+        }
+        KOTA_EXPECTED_TRY(seq.end());
+        *flags.value = static_cast<E>(bits);
+        return {};
+    }
+};
+
+}  // namespace kota::codec
@@ -7,6 +7,7 @@
 #include <variant>
 
 #include "kota/support/expected_try.h"
+#include "kota/support/fixed_string.h"
 #include "kota/meta/annotation.h"
 #include "kota/meta/attrs.h"
 #include "kota/meta/struct.h"
@@ -18,6 +19,13 @@
 
 namespace kota::codec::detail {
 
+/// Wire name of a reflected field (a meta::field) under Config.
+template <typename Config, typename Field>
+constexpr std::string_view field_wire_name(std::string& scratch) {
+    constexpr auto name = std::remove_cvref_t<Field>::name();
+    return config::static_field_rename<Config, fixed_string<name.size()>(name.data())>(scratch);
+}
+
 template <typename Config, typename E, typename SerializeStruct, typename Field>
 constexpr auto serialize_struct_field(SerializeStruct& s_struct, Field field)
     -> std::expected<void, E> {
@@ -25,7 +33,7 @@ constexpr auto serialize_struct_field(SerializeStruct& s_struct, Field field)
 
     if constexpr(!meta::annotated_type<field_t>) {
         std::string scratch;
-        auto mapped_name = config::apply_field_rename<Config>(true, field.name(), scratch);
+        auto mapped_name = field_wire_name<Config, Field>(scratch);
         return s_struct.serialize_field(mapped_name, field.value());
     } else {
         using attrs_t = typename std::remove_cvref_t<field_t>::attrs;
@@ -58,7 +66,7 @@ constexpr auto serialize_struct_field(SerializeStruct& s_struct, Field field)
                 using rename_attr = tuple_find_t<attrs_t, meta::is_rename_attr>;
                 effective_name = rename_attr::name;
             } else {
-                effective_name = config::apply_field_rename<Config>(true, field.name(), scratch);
+                effective_name = field_wire_name<Config, Field>(scratch);
             }
 
             // Behavior: skip_if — conditionally skip
@@ -102,7 +110,7 @@ constexpr auto deserialize_struct_field(DeserializeStruct& d_struct,
 
     if constexpr(!meta::annotated_type<field_t>) {
         std::string scratch;
-        auto mapped_name = config::apply_field_rename<Config>(true, field.name(), scratch);
+        auto mapped_name = field_wire_name<Config, Field>(scratch);
         if(mapped_name != key_name) {
             return false;
         }
@@ -147,7 +155,7 @@ constexpr auto deserialize_struct_field(DeserializeStruct& d_struct,
                 using rename_attr = tuple_find_t<attrs_t, meta::is_rename_attr>;
                 effective_name = rename_attr::name;
             } else {
-                effective_name = config::apply_field_rename<Config>(true, field.name(), scratch);
+                effective_name = field_wire_name<Config, Field>(scratch);
             }
 
             // Check name match: canonical name + aliases
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <expected>
+#include <string>
+
+#include "kota/support/expected_try.h"
+#include "kota/support/interned_string.h"
+#include "kota/codec/detail/fwd.h"
+
+namespace kota::codec::detail {
+
+/// Reads a string into `pool` and points `value` at the pooled copy. The
+/// text is viewed in the input where the format allows it, so a string
+/// the pool already has costs a lookup and no allocation.
+template <typename D>
+auto deserialize_interned(D& deserializer, interned_string& value, string_pool& pool)
+    -> std::expected<void, typename D::error_type> {
+    if constexpr(requires { deserializer.deserialize_str_view(); }) {
+        KOTA_EXPECTED_TRY_V(auto text, deserializer.deserialize_str_view());
+        value = pool.intern(text);
+    } else {
+        std::string text;
+        KOTA_EXPECTED_TRY(deserializer.deserialize_str(text));
+        value = pool.intern(text);
+    }
+    return {};
+}
+
+/// An interned_string to be read into the pool of a behavior::intern.
+template <typename Pool>
+class interned_string_out {
+public:
+    explicit constexpr interned_string_out(interned_string& value) noexcept : value(&value) {}
+
+    interned_string* value;
+};
+
+}  // namespace kota::codec::detail
+
+namespace kota::codec {
+
+template <typename D, typename Pool>
+struct deserialize_traits<D, detail::interned_string_out<Pool>> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, detail::interned_string_out<Pool>& out)
+        -> std::expected<void, error_type> {
+        return detail::deserialize_interned(deserializer, *out.value, Pool::pool());
+    }
+};
+
+}  // namespace kota::codec
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "kota/codec/config.h"
+
+namespace kota::codec::detail {
+
+/// Room for any int64_t or uint64_t: twenty digits or a sign and nineteen.
+constexpr inline std::size_t max_integer_chars = 20;
+
+/// Room for a double in any float_format: sign, seventeen digits, point,
+/// exponent, and the ".0" an integral value gets.
+constexpr inline std::size_t max_float_chars = 32;
+
+// "00" "01" ... "99", so two digits are written per division.
+constexpr inline auto digit_pairs = [] {
+    std::array<char, 200> pairs{};
+    for(int i = 0; i < 100; ++i) {
+        pairs[i * 2] = static_cast<char>('0' + i / 10);
+        pairs[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return pairs;
+}();
+
+constexpr auto decimal_digits(std::uint64_t value) noexcept -> std::size_t {
+    std::size_t digits = 1;
+    for(; value >= 10000; value /= 10000) {
+        digits += 4;
+    }
+    return digits + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+/// Writes `value` in decimal at `out` and returns the end. The length is
+/// known before the first digit, so digits are written back to front in
+/// pairs with no reversal and no branch per digit.
+inline auto format_uint(std::uint64_t value, char* out) noexcept -> char* {
+    char* end = out + decimal_digits(value);
+    char* cursor = end;
+    while(value >= 100) {
+        const auto pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        cursor -= 2;
+        std::memcpy(cursor, digit_pairs.data() + pair, 2);
+    }
+    if(value >= 10) {
+        cursor -= 2;
+        std::memcpy(cursor, digit_pairs.data() + value * 2, 2);
+    } else {
+        *--cursor = static_cast<char>('0' + value);
+    }
+    return end;
+}
+
+inline auto format_int(std::int64_t value, char* out) noexcept -> char* {
+    if(value < 0) {
+        *out++ = '-';
+        // Negate in unsigned arithmetic so INT64_MIN does not overflow.
+        return format_uint(~static_cast<std::uint64_t>(value) + 1, out);
+    }
+    return format_uint(static_cast<std::uint64_t>(value), out);
+}
+
+/// Writes the finite `value` at `out`, which has max_float_chars of room,
+/// as Config's float_format says, and returns the end.
+///
+/// The shortest form is std::to_chars's: the fewest digits that read back
+/// as the same double. A result without a point or an exponent gets ".0",
+/// so a double stays a float on the wire and reads back as one.
+template <typename Config>
+auto format_float(double value, char* out) noexcept -> char* {
+    char* const last = out + max_float_chars - 2;
+    std::to_chars_result result;
+    if constexpr(config::float_digits<Config> == 0) {
+        result = std::to_chars(out, last, value);
+    } else {
+        result = std::to_chars(out,
+                               last,
+                               value,
+                               std::chars_format::general,
+                               config::float_digits<Config>);
+    }
+
+    char* end = result.ptr;
+    if(std::string_view(out, end).find_first_of(".e") == std::string_view::npos) {
+        std::memcpy(end, ".0", 2);
+        end += 2;
+    }
+    return end;
+}
+
+/// `value` as format_float() would write it, read back.
+template <typename Config>
+auto round_float(double value) noexcept -> double {
+    if constexpr(config::float_digits<Config> == 0) {
+        return value;
+    } else {
+        if(!std::isfinite(value)) {
+            return value;
+        }
+        char buffer[max_float_chars];
+        char* end = format_float<Config>(value, buffer);
+        double rounded = value;
+        std::from_chars(buffer, end, rounded);
+        return rounded;
+    }
+}
+
+}  // namespace kota::codec::detail
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -11,11 +14,13 @@
 #include <variant>
 
 #include "kota/support/expected_try.h"
+#include "kota/support/fixed_string.h"
 #include "kota/meta/annotation.h"
 #include "kota/meta/attrs.h"
 #include "kota/meta/struct.h"
 #include "kota/codec/config.h"
 #include "kota/codec/detail/apply_behavior.h"
+#include "kota/codec/detail/common.h"
 #include "kota/codec/detail/field_dispatch.h"
 #include "kota/codec/detail/fwd.h"
 
@@ -101,19 +106,213 @@ consteval auto make_field_table() {
     return table;
 }
 
+/// FNV-1a, for the field name index.
+constexpr std::uint64_t hash_field_name(std::string_view name) noexcept {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for(char c: name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/// Open-addressing hash table from the N wire names of a struct to their
+/// field indices. It is kept at most half full, so a lookup hashes the key
+/// once and compares it with one or two names. When two entries share a
+/// name the first one inserted wins.
+///
+/// The lengths and first bytes of the names are kept as bit sets too, which
+/// turn most unknown keys away before they are hashed.
+template <std::size_t N>
+struct field_name_index {
+    constexpr static std::size_t capacity = std::bit_ceil(N < 1 ? std::size_t(2) : N * 2);
+
+    std::array<std::string_view, N> names{};
+    std::array<std::size_t, N> fields{};
+    /// Entry + 1 of each occupied slot; 0 marks an empty one.
+    std::array<std::uint16_t, capacity> slots{};
+    std::size_t count = 0;
+    /// Bit min(size, 63) for the size of every name.
+    std::uint64_t lengths = 0;
+    /// Bit c for the first byte c of every name.
+    std::array<std::uint64_t, 4> first_bytes{};
+
+    constexpr void insert(std::string_view name, std::size_t field) {
+        auto slot = hash_field_name(name) & (capacity - 1);
+        while(slots[slot] != 0) {
+            if(names[slots[slot] - 1] == name) {
+                return;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        names[count] = name;
+        fields[count] = field;
+        slots[slot] = static_cast<std::uint16_t>(++count);
+
+        lengths |= length_bit(name);
+        if(!name.empty()) {
+            const auto first = static_cast<unsigned char>(name.front());
+            first_bytes[first >> 6] |= std::uint64_t(1) << (first & 63);
+        }
+    }
+
+    /// False when no name can equal `key`; true says nothing.
+    constexpr bool may_contain(std::string_view key) const noexcept {
+        if((lengths & length_bit(key)) == 0) {
+            return false;
+        }
+        if(key.empty()) {
+            return true;
+        }
+        const auto first = static_cast<unsigned char>(key.front());
+        return (first_bytes[first >> 6] >> (first & 63)) & 1;
+    }
+
+    constexpr auto find(std::string_view key) const noexcept -> std::optional<std::size_t> {
+        if(!may_contain(key)) {
+            return std::nullopt;
+        }
+
+        auto slot = hash_field_name(key) & (capacity - 1);
+        while(slots[slot] != 0) {
+            const auto entry = slots[slot] - 1;
+            if(names[entry] == key) {
+                return fields[entry];
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        return std::nullopt;
+    }
+
+    /// find() for keys expected in insertion order: the entry at `cursor`
+    /// is compared first, and `cursor` moves past whichever entry matched.
+    constexpr auto find(std::string_view key, std::size_t& cursor) const noexcept
+        -> std::optional<std::size_t> {
+        if(cursor < count && names[cursor] == key) {
+            return fields[cursor++];
+        }
+        if(!may_contain(key)) {
+            return std::nullopt;
+        }
+
+        auto slot = hash_field_name(key) & (capacity - 1);
+        while(slots[slot] != 0) {
+            const auto entry = slots[slot] - 1;
+            if(names[entry] == key) {
+                cursor = entry + 1;
+                return fields[entry];
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        return std::nullopt;
+    }
+
+private:
+    constexpr static std::uint64_t length_bit(std::string_view name) noexcept {
+        return std::uint64_t(1) << (name.size() < 63 ? name.size() : 63);
+    }
+};
+
+/// True if Config renames fields at compile time: it has no rename policy
+/// or a constexpr one.
+template <typename Config>
+concept static_field_names =
+    !requires { typename Config::field_rename; } ||
+    spelling::constexpr_rename_policy<typename Config::field_rename>;
+
+template <typename T, typename Config>
+constexpr inline auto field_table = make_field_table<T, Config>();
+
+/// effective_wire_name() of entry I of field_table, as a static string.
+template <typename T, typename Config, std::size_t I>
+    requires static_field_names<Config>
+constexpr std::string_view static_wire_name() {
+    constexpr auto entry = field_table<T, Config>[I];
+    if constexpr(entry.has_explicit_rename || entry.is_alias) {
+        return entry.name;
+    } else {
+        std::string unused;
+        return config::static_field_rename<Config,
+                                           fixed_string<entry.name.size()>(entry.name.data())>(
+            unused);
+    }
+}
+
+/// True if every field of T is written, in declaration order, under a name
+/// known at compile time: no field carries attributes that could skip,
+/// flatten, rename or re-encode it. Such a struct always has the same keys,
+/// so a serializer may write them as precomputed text.
+template <typename T, typename Config>
+concept fixed_shape_struct =
+    meta::reflectable_class<T> && static_field_names<Config> && (meta::field_count<T>() > 0) &&
+    []<std::size_t... Is>(std::index_sequence<Is...>) consteval {
+        return (!meta::annotated_type<std::remove_cv_t<meta::field_type<T, Is>>> && ...);
+    }(std::make_index_sequence<meta::field_count<T>()>{});
+
+/// The wire names of a fixed_shape_struct, in field order.
+template <typename T, typename Config>
+    requires fixed_shape_struct<T, Config>
+constexpr inline auto fixed_field_names =
+    []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<std::string_view, sizeof...(Is)>{static_wire_name<T, Config, Is>()...};
+    }(std::make_index_sequence<meta::field_count<T>()>{});
+
+/// Index of the wire names of T, built at compile time unless Config's
+/// rename policy only runs at runtime. Then it runs once per name, on
+/// first use, into names kept for the life of the program.
+///
+/// The canonical names go in first, in declaration order, then the
+/// aliases, so a struct our serializer wrote is read entry after entry.
+template <typename T, typename Config>
+auto wire_name_index() -> const auto& {
+    constexpr auto& table = field_table<T, Config>;
+    using index_t = field_name_index<table.size()>;
+
+    if constexpr(static_field_names<Config>) {
+        constexpr static auto index = []<std::size_t... Is>(std::index_sequence<Is...>) {
+            index_t result;
+            for(bool aliases: {false, true}) {
+                ((table[Is].is_alias == aliases
+                      ? result.insert(static_wire_name<T, Config, Is>(), table[Is].index)
+                      : void()),
+                 ...);
+            }
+            return result;
+        }(std::make_index_sequence<table.size()>{});
+        return index;
+    } else {
+        const static auto index = [] {
+            static std::array<std::string, table.size()> renamed;
+            index_t result;
+            for(std::size_t i = 0; i < table.size(); ++i) {
+                std::string scratch;
+                renamed[i] = std::string(effective_wire_name<Config>(table[i], scratch));
+            }
+            for(bool aliases: {false, true}) {
+                for(std::size_t i = 0; i < table.size(); ++i) {
+                    if(table[i].is_alias == aliases) {
+                        result.insert(renamed[i], table[i].index);
+                    }
+                }
+            }
+            return result;
+        }();
+        return index;
+    }
+}
+
 /// Lookup a field index by key name. Returns nullopt if not found.
 /// Applies Config rename policy to transform canonical names to wire names.
 template <typename T, typename Config>
 auto lookup_field(std::string_view key) -> std::optional<std::size_t> {
-    constexpr auto table = make_field_table<T, Config>();
+    return wire_name_index<T, Config>().find(key);
+}
 
-    std::string scratch;
-    for(const auto& entry: table) {
-        if(effective_wire_name<Config>(entry, scratch) == key) {
-            return entry.index;
-        }
-    }
-    return std::nullopt;
+/// lookup_field() that expects the field after the one `cursor` last
+/// matched; see field_name_index::find().
+template <typename T, typename Config>
+auto lookup_field(std::string_view key, std::size_t& cursor) -> std::optional<std::size_t> {
+    return wire_name_index<T, Config>().find(key, cursor);
 }
 
 /// True if two different fields collapse to the same effective wire name.
@@ -276,6 +475,13 @@ template <typename Config, typename E, serializer_like S, typename V>
 constexpr auto serialize_reflectable(S& s, const V& v) -> std::expected<typename S::value_type, E> {
     using value_t = std::remove_cvref_t<V>;
 
+    // A serializer that can write a struct's keys as precomputed text says
+    // so with serialize_fixed_struct().
+    if constexpr(fixed_shape_struct<value_t, Config> &&
+                 requires { s.template serialize_fixed_struct<Config>(v); }) {
+        return s.template serialize_fixed_struct<Config>(v);
+    }
+
     KOTA_EXPECTED_TRY_V(
         auto s_struct,
         s.serialize_struct(meta::type_name<value_t>(), meta::field_count<value_t>()));
@@ -332,6 +538,26 @@ consteval std::uint64_t required_field_mask() {
     return mask;
 }
 
+/// For untagged variants: false when an object with these top-level keys
+/// cannot deserialize as struct T because a required field is missing,
+/// which deserialize_reflectable() would reject after reading the whole
+/// object. True leaves the values still to be checked.
+template <typename T, typename Config>
+auto keys_admit_struct(std::span<const std::string_view> keys) -> bool {
+    constexpr std::uint64_t required = required_field_mask<T>();
+    if constexpr(required == 0) {
+        return true;
+    } else {
+        std::uint64_t seen = 0;
+        for(auto key: keys) {
+            if(auto index = lookup_field<T, Config>(key)) {
+                seen |= std::uint64_t(1) << *index;
+            }
+        }
+        return (seen & required) == required;
+    }
+}
+
 template <typename Config, typename E, bool DenyUnknown, deserializer_like D, typename V>
     requires meta::reflectable_class<std::remove_cvref_t<V>>
 constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
@@ -346,6 +572,7 @@ constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
         d.deserialize_struct(meta::type_name<value_t>(), meta::field_count<value_t>()));
 
     std::uint64_t seen_fields = 0;
+    std::size_t cursor = 0;
 
     while(true) {
         KOTA_EXPECTED_TRY_V(auto key, d_struct.next_key());
@@ -355,12 +582,15 @@ constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
 
         std::string_view key_name = *key;
 
-        auto idx = lookup_field<value_t, Config>(key_name);
+        auto idx = lookup_field<value_t, Config>(key_name, cursor);
         if(idx) {
             auto field_status = dispatch_field_by_index<value_t, Config, E>(*idx, d_struct, v);
             if(!field_status) {
                 auto err = std::move(field_status).error();
-                err.prepend_field(key_name);
+                if constexpr(config::error_detail<Config>) {
+                    // The index keeps the name the key matched for good.
+                    err.prepend_static_field(wire_name_index<value_t, Config>().names[cursor - 1]);
+                }
                 return std::unexpected(std::move(err));
             }
             seen_fields |= (std::uint64_t(1) << *idx);
@@ -372,7 +602,9 @@ constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
             auto flatten_status = try_flatten_fields<value_t, Config, E>(key_name, d_struct, v);
             if(!flatten_status) {
                 auto err = std::move(flatten_status).error();
-                err.prepend_field(key_name);
+                if constexpr(config::error_detail<Config>) {
+                    err.prepend_field(key_name);
+                }
                 return std::unexpected(std::move(err));
             }
             flatten_matched = *flatten_status;
@@ -383,7 +615,8 @@ constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
         }
 
         if constexpr(DenyUnknown) {
-            return std::unexpected(E::unknown_field(key_name));
+            return std::unexpected(
+                detailed_error<Config, E>([&] { return E::unknown_field(key_name); }));
         } else {
             KOTA_EXPECTED_TRY(d_struct.skip_value());
         }
@@ -393,15 +626,17 @@ constexpr auto deserialize_reflectable(D& d, V& v) -> std::expected<void, E> {
     // This enables correct variant backtracking and catches malformed input.
     constexpr std::uint64_t required = required_field_mask<value_t>();
     if((seen_fields & required) != required) {
-        // Find the first missing required field name
-        constexpr auto table = make_field_table<value_t, Config>();
-        std::uint64_t missing = required & ~seen_fields;
-        for(const auto& entry: table) {
-            if(!entry.is_alias && (missing & (std::uint64_t(1) << entry.index))) {
-                return std::unexpected(E::missing_field(entry.name));
+        return std::unexpected(detailed_error<Config, E>([&] {
+            // Find the first missing required field name
+            constexpr auto table = make_field_table<value_t, Config>();
+            std::uint64_t missing = required & ~seen_fields;
+            for(const auto& entry: table) {
+                if(!entry.is_alias && (missing & (std::uint64_t(1) << entry.index))) {
+                    return E::missing_field(entry.name);
+                }
             }
-        }
-        return std::unexpected(E::missing_field("unknown"));
+            return E::missing_field("unknown");
+        }));
     }
 
     return d_struct.end();
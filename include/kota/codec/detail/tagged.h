@@ -6,6 +6,7 @@
 #include <format>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -14,6 +15,7 @@
 #include "kota/support/expected_try.h"
 #include "kota/meta/annotation.h"
 #include "kota/meta/attrs.h"
+#include "kota/meta/enum.h"
 #include "kota/meta/struct.h"
 #include "kota/codec/config.h"
 #include "kota/codec/detail/common.h"
@@ -22,53 +24,75 @@
 
 namespace kota::codec::detail {
 
-/// Match tag_value against variant alternative names, construct the matching alternative,
-/// call reader(alt) to deserialize it, then assign to the variant.
-template <typename E, typename... Ts, typename Names, typename Reader>
-constexpr auto match_and_deserialize_alt(std::string_view tag_value,
-                                         const Names& names,
-                                         std::variant<Ts...>& value,
-                                         Reader&& reader) -> std::expected<void, E> {
-    bool matched = false;
+/// Perfect hash of the tag names of a variant, built once at compile time, so
+/// that a tag is looked up with one hash and one comparison.
+template <typename TagAttr, typename... Ts>
+constexpr inline auto tag_name_index =
+    meta::detail::enum_name_index<sizeof...(Ts)>(meta::resolve_tag_names<TagAttr, Ts...>());
+
+template <typename Config, typename E>
+constexpr auto unknown_tag_error(std::string_view tag_value) -> E {
+    return detailed_error<Config, E>(
+        [&] { return E::custom(std::format("unknown variant tag '{}'", tag_value)); });
+}
+
+/// Construct alternative `index`, call reader(alt) to deserialize it, then
+/// assign it to the variant.
+template <typename E, typename... Ts, typename Reader>
+constexpr auto deserialize_alt_at(std::size_t index, std::variant<Ts...>& value, Reader&& reader)
+    -> std::expected<void, E> {
     std::expected<void, E> status{};
 
     [&]<std::size_t... I>(std::index_sequence<I...>) {
-        (([&] {
-             if(matched || names[I] != tag_value) {
-                 return;
-             }
-             matched = true;
-
-             using alt_t = std::variant_alternative_t<I, std::variant<Ts...>>;
-             if constexpr(std::same_as<alt_t, std::monostate>) {
-                 std::monostate alt{};
-                 auto result = reader(alt);
-                 if(!result) {
-                     status = std::unexpected(result.error());
-                 } else {
-                     value.template emplace<I>();
-                 }
-             } else if constexpr(std::default_initializable<alt_t>) {
-                 alt_t alt{};
-                 auto result = reader(alt);
-                 if(!result) {
-                     status = std::unexpected(result.error());
-                 } else {
-                     value = std::move(alt);
-                 }
-             } else {
-                 status = std::unexpected(E::invalid_state);
-             }
-         }()),
-         ...);
+        (void)((index == I && ([&] {
+                    using alt_t = std::variant_alternative_t<I, std::variant<Ts...>>;
+                    if constexpr(std::same_as<alt_t, std::monostate>) {
+                        std::monostate alt{};
+                        auto result = reader(alt);
+                        if(!result) {
+                            status = std::unexpected(result.error());
+                        } else {
+                            value.template emplace<I>();
+                        }
+                    } else if constexpr(std::default_initializable<alt_t>) {
+                        alt_t alt{};
+                        auto result = reader(alt);
+                        if(!result) {
+                            status = std::unexpected(result.error());
+                        } else {
+                            value = std::move(alt);
+                        }
+                    } else {
+                        status = std::unexpected(E::invalid_state);
+                    }
+                    return true;
+                }())) ||
+               ...);
     }(std::make_index_sequence<sizeof...(Ts)>{});
 
-    if(!matched) {
-        return std::unexpected(E::custom(std::format("unknown variant tag '{}'", tag_value)));
-    }
     return status;
 }
 
+/// Look tag_value up among the variant's tag names and deserialize the
+/// alternative it names with reader(alt).
+template <typename Config, typename E, typename TagAttr, typename... Ts, typename Reader>
+constexpr auto match_and_deserialize_alt(std::string_view tag_value,
+                                         std::variant<Ts...>& value,
+                                         Reader&& reader) -> std::expected<void, E> {
+    auto index = tag_name_index<TagAttr, Ts...>.find(tag_value);
+    if(!index) {
+        return std::unexpected(unknown_tag_error<Config, E>(tag_value));
+    }
+    return deserialize_alt_at<E>(*index, value, std::forward<Reader>(reader));
+}
+
+/// The alternative a variant tag names, read through deserialize_value().
+/// Formats that view strings in place look the tag up without copying it.
+template <typename TagAttr, typename... Ts>
+struct variant_tag_out {
+    std::size_t index = 0;
+};
+
 /// Visit variant and call emitter with the active alternative's value.
 /// Propagates the emitter's result through expected.
 template <typename E, typename R, typename... Ts, typename Emitter>
@@ -116,51 +140,79 @@ constexpr auto serialize_adjacently_tagged(S& s, const std::variant<Ts...>& valu
 template <typename E, typename D, typename... Ts, typename TagAttr>
 constexpr auto deserialize_externally_tagged(D& d, std::variant<Ts...>& value, TagAttr)
     -> std::expected<void, E> {
-    constexpr auto names = meta::resolve_tag_names<TagAttr, Ts...>();
+    using config_t = config::config_of<D>;
 
     KOTA_EXPECTED_TRY_V(auto d_struct, d.deserialize_struct("", 1));
 
     KOTA_EXPECTED_TRY_V(auto key, d_struct.next_key());
     if(!key.has_value()) {
-        return std::unexpected(E::custom("expected externally tagged variant key"));
+        return std::unexpected(detailed_error<config_t, E>(
+            [] { return E::custom("expected externally tagged variant key"); }));
     }
 
-    KOTA_EXPECTED_TRY((match_and_deserialize_alt<E>(*key, names, value, [&](auto& alt) {
-        return d_struct.deserialize_value(alt);
-    })));
+    KOTA_EXPECTED_TRY((match_and_deserialize_alt<config_t, E, TagAttr>(
+        *key,
+        value,
+        [&](auto& alt) { return d_struct.deserialize_value(alt); })));
 
     return d_struct.end();
 }
 
+/// Scan the object about to be read for its tag, when the format can do so
+/// without consuming it. The unknown-tag error is reported up front.
+template <typename Config, typename E, typename TagAttr, typename... Ts, typename D>
+constexpr auto prescan_tag(D& d) -> std::expected<std::optional<std::size_t>, E> {
+    if constexpr(requires { d.peek_object_string_field(std::string_view{}); }) {
+        KOTA_EXPECTED_TRY_V(auto scanned, d.peek_object_string_field(TagAttr::field_names[0]));
+        if(!scanned.has_value()) {
+            return std::nullopt;
+        }
+        auto index = tag_name_index<TagAttr, Ts...>.find(*scanned);
+        if(!index) {
+            return std::unexpected(unknown_tag_error<Config, E>(*scanned));
+        }
+        return index;
+    } else {
+        return std::nullopt;
+    }
+}
+
 template <typename E, typename D, typename... Ts, typename TagAttr>
 constexpr auto deserialize_adjacently_tagged(D& d, std::variant<Ts...>& value, TagAttr)
     -> std::expected<void, E> {
-    constexpr auto names = meta::resolve_tag_names<TagAttr, Ts...>();
+    using config_t = config::config_of<D>;
 
-    KOTA_EXPECTED_TRY_V(auto d_struct, d.deserialize_struct("", 2));
+    // Known before the fields are read when the format can scan for it, so
+    // that content ahead of the tag is decoded in place, not buffered.
+    KOTA_EXPECTED_TRY_V(auto tag_index, (prescan_tag<config_t, E, TagAttr, Ts...>(d)));
+    const bool prescanned = tag_index.has_value();
 
-    std::string tag_value;
+    KOTA_EXPECTED_TRY_V(auto d_struct, d.deserialize_struct("", 2));
 
-    auto deserialize_content_for_tag = [&](auto&& read_content_alt) -> std::expected<void, E> {
-        return match_and_deserialize_alt<E>(
-            tag_value,
-            names,
-            value,
-            std::forward<decltype(read_content_alt)>(read_content_alt));
+    auto read_tag = [&]() -> std::expected<void, E> {
+        if(prescanned) {
+            return d_struct.skip_value();
+        }
+        variant_tag_out<TagAttr, Ts...> tag;
+        KOTA_EXPECTED_TRY(d_struct.deserialize_value(tag));
+        tag_index = tag.index;
+        return {};
     };
 
     // Read content directly from the struct deserializer
-    auto read_content_direct = [&](auto& alt) -> std::expected<void, E> {
-        KOTA_EXPECTED_TRY(d_struct.deserialize_value(alt));
-        return {};
+    auto read_content = [&]() -> std::expected<void, E> {
+        return deserialize_alt_at<E>(*tag_index, value, [&](auto& alt) {
+            return d_struct.deserialize_value(alt);
+        });
     };
 
     // Expect the next key to match a specific field name
     auto expect_next_key = [&](std::string_view expected) -> std::expected<void, E> {
         KOTA_EXPECTED_TRY_V(auto key, d_struct.next_key());
         if(!key.has_value() || *key != expected) {
-            return std::unexpected(
-                E::custom(std::format("expected adjacent tag field '{}'", expected)));
+            return std::unexpected(detailed_error<config_t, E>([&] {
+                return E::custom(std::format("expected adjacent tag field '{}'", expected));
+            }));
         }
         return {};
     };
@@ -179,18 +231,20 @@ constexpr auto deserialize_adjacently_tagged(D& d, std::variant<Ts...>& value, T
 
             if(*key == TagAttr::field_names[0]) {
                 if(has_tag) {
-                    return std::unexpected(E::duplicate_field(TagAttr::field_names[0]));
+                    return std::unexpected(detailed_error<config_t, E>(
+                        [] { return E::duplicate_field(TagAttr::field_names[0]); }));
                 }
-                KOTA_EXPECTED_TRY(d_struct.deserialize_value(tag_value));
+                KOTA_EXPECTED_TRY(read_tag());
                 has_tag = true;
             } else if(*key == TagAttr::field_names[1]) {
                 if(has_content) {
-                    return std::unexpected(E::duplicate_field(TagAttr::field_names[1]));
+                    return std::unexpected(detailed_error<config_t, E>(
+                        [] { return E::duplicate_field(TagAttr::field_names[1]); }));
                 }
                 has_content = true;
 
-                if(has_tag) {
-                    KOTA_EXPECTED_TRY(deserialize_content_for_tag(read_content_direct));
+                if(tag_index.has_value()) {
+                    KOTA_EXPECTED_TRY(read_content());
                 } else {
                     captured_t captured{};
                     KOTA_EXPECTED_TRY(d_struct.deserialize_value(captured));
@@ -202,28 +256,30 @@ constexpr auto deserialize_adjacently_tagged(D& d, std::variant<Ts...>& value, T
         }
 
         if(!has_tag || !has_content) {
-            if(!has_tag) {
-                return std::unexpected(E::missing_field(TagAttr::field_names[0]));
-            }
-            return std::unexpected(E::missing_field(TagAttr::field_names[1]));
+            return std::unexpected(detailed_error<config_t, E>([&] {
+                return E::missing_field(TagAttr::field_names[has_tag ? 1 : 0]);
+            }));
         }
 
         if(buffered_content.has_value()) {
-            KOTA_EXPECTED_TRY(deserialize_content_for_tag([&](auto& alt) -> std::expected<void, E> {
-                content::Deserializer<typename D::config_type> buffered_deserializer(
-                    *buffered_content);
-                KOTA_EXPECTED_TRY(codec::deserialize(buffered_deserializer, alt));
-                KOTA_EXPECTED_TRY(buffered_deserializer.finish());
-                return {};
-            }));
+            KOTA_EXPECTED_TRY(deserialize_alt_at<E>(
+                *tag_index,
+                value,
+                [&](auto& alt) -> std::expected<void, E> {
+                    content::Deserializer<typename D::config_type> buffered_deserializer(
+                        *buffered_content);
+                    KOTA_EXPECTED_TRY(codec::deserialize(buffered_deserializer, alt));
+                    KOTA_EXPECTED_TRY(buffered_deserializer.finish());
+                    return {};
+                }));
         }
 
         return d_struct.end();
     } else {
         KOTA_EXPECTED_TRY(expect_next_key(TagAttr::field_names[0]));
-        KOTA_EXPECTED_TRY(d_struct.deserialize_value(tag_value));
+        KOTA_EXPECTED_TRY(read_tag());
         KOTA_EXPECTED_TRY(expect_next_key(TagAttr::field_names[1]));
-        KOTA_EXPECTED_TRY(deserialize_content_for_tag(read_content_direct));
+        KOTA_EXPECTED_TRY(read_content());
         return d_struct.end();
     }
 }
@@ -270,17 +326,28 @@ template <typename E, typename D, typename... Ts, typename TagAttr>
 constexpr auto deserialize_internally_tagged(D& d, std::variant<Ts...>& value, TagAttr)
     -> std::expected<void, E> {
     using config_t = config::config_of<D>;
+    static_assert((meta::reflectable_class<Ts> && ...),
+                  "internally_tagged requires struct alternatives");
+
+    // A format that finds the tag in the object's text reads the object as
+    // the alternative in place, the tag being one more field it skips.
+    KOTA_EXPECTED_TRY_V(auto tag_index, (prescan_tag<config_t, E, TagAttr, Ts...>(d)));
+    if(tag_index.has_value()) {
+        return deserialize_alt_at<E>(*tag_index, value, [&](auto& alt) {
+            return codec::deserialize(d, alt);
+        });
+    }
 
-    // Requires capture_dom_value() — buffer to content DOM, then two-pass dispatch
+    // Otherwise buffer to content DOM, then two-pass dispatch
     KOTA_EXPECTED_TRY_V(auto dom_result, d.capture_dom_value());
 
-    constexpr auto names = meta::resolve_tag_names<TagAttr, Ts...>();
     constexpr std::string_view tag_field = TagAttr::field_names[0];
 
     auto obj_ref = dom_result.as_ref();
     auto obj = obj_ref.get_object();
     if(!obj) {
-        return std::unexpected(E::invalid_type("object", "non-object"));
+        return std::unexpected(
+            detailed_error<config_t, E>([] { return E::invalid_type("object", "non-object"); }));
     }
 
     // Pass 1: find tag
@@ -290,7 +357,8 @@ constexpr auto deserialize_internally_tagged(D& d, std::variant<Ts...>& value, T
         if(entry.key == tag_field) {
             auto s = entry.value.get_string();
             if(!s) {
-                return std::unexpected(E::invalid_type("string", "non-string"));
+                return std::unexpected(detailed_error<config_t, E>(
+                    [] { return E::invalid_type("string", "non-string"); }));
             }
             tag_value = *s;
             found = true;
@@ -298,30 +366,51 @@ constexpr auto deserialize_internally_tagged(D& d, std::variant<Ts...>& value, T
         }
     }
     if(!found) {
-        return std::unexpected(E::missing_field(tag_field));
+        return std::unexpected(
+            detailed_error<config_t, E>([&] { return E::missing_field(tag_field); }));
     }
 
     // Pass 2: match tag -> deserialize full object as that struct type
-    return match_and_deserialize_alt<E>(tag_value,
-                                        names,
-                                        value,
-                                        [&](auto& alt) -> std::expected<void, E> {
-                                            using alt_t = std::remove_cvref_t<decltype(alt)>;
-                                            static_assert(
-                                                meta::reflectable_class<alt_t>,
-                                                "internally_tagged requires struct alternatives");
-
-                                            content::Deserializer<config_t> deser(obj_ref);
-                                            KOTA_EXPECTED_TRY(codec::deserialize(deser, alt));
-                                            KOTA_EXPECTED_TRY(deser.finish());
-                                            return {};
-                                        });
+    auto read_alt = [&](auto& alt) -> std::expected<void, E> {
+        content::Deserializer<config_t> deser(obj_ref);
+        KOTA_EXPECTED_TRY(codec::deserialize(deser, alt));
+        KOTA_EXPECTED_TRY(deser.finish());
+        return {};
+    };
+    return match_and_deserialize_alt<config_t, E, TagAttr>(tag_value, value, read_alt);
 }
 
 }  // namespace kota::codec::detail
 
 namespace kota::codec {
 
+template <typename D, typename TagAttr, typename... Ts>
+struct deserialize_traits<D, detail::variant_tag_out<TagAttr, Ts...>> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, detail::variant_tag_out<TagAttr, Ts...>& out)
+        -> std::expected<void, error_type> {
+        using config_t = config::config_of<D>;
+        auto lookup = [&](std::string_view text) -> std::expected<void, error_type> {
+            auto index = detail::tag_name_index<TagAttr, Ts...>.find(text);
+            if(!index) {
+                return std::unexpected(detail::unknown_tag_error<config_t, error_type>(text));
+            }
+            out.index = *index;
+            return {};
+        };
+
+        if constexpr(requires { deserializer.deserialize_str_view(); }) {
+            KOTA_EXPECTED_TRY_V(auto text, deserializer.deserialize_str_view());
+            return lookup(text);
+        } else {
+            std::string text;
+            KOTA_EXPECTED_TRY(deserializer.deserialize_str(text));
+            return lookup(text);
+        }
+    }
+};
+
 /// Bitmask of data-model type categories.
 /// Backends map their format-specific "kind" enums to these bits;
 /// the shared `expected_type_hints<T>()` maps C++ types to them.
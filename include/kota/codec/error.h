@@ -18,10 +18,14 @@ struct source_location {
     std::size_t byte_offset = 0;
 };
 
-using path_segment = std::variant<std::string, std::size_t>;
+/// A field name, as copied from the input or as a static string, or an index.
+using path_segment = std::variant<std::string, std::string_view, std::size_t>;
 
 /// Rich serde error with lazy allocation. Constructing from Kind is zero-cost (no heap).
 /// Message, path, and location are stored behind a unique_ptr, allocated only when needed.
+///
+/// The path is built while the error unwinds, innermost segment first, so
+/// each prepend_* appends to it; format_path() reads it back to front.
 template <typename Kind>
 struct serde_error {
     Kind kind;
@@ -84,14 +88,22 @@ struct serde_error {
         return {k, std::string(msg)};
     }
 
+    /// Copies `name`, which may point into the input.
     void prepend_field(std::string_view name) {
         ensure_detail();
-        detail->path.insert(detail->path.begin(), std::string(name));
+        detail->path.emplace_back(std::in_place_type<std::string>, name);
+    }
+
+    /// For names that live as long as the program, such as the wire names
+    /// of a struct's fields: only the view is kept.
+    void prepend_static_field(std::string_view name) {
+        ensure_detail();
+        detail->path.emplace_back(std::in_place_type<std::string_view>, name);
     }
 
     void prepend_index(std::size_t index) {
         ensure_detail();
-        detail->path.insert(detail->path.begin(), index);
+        detail->path.emplace_back(index);
     }
 
     std::optional<source_location> location() const {
@@ -112,17 +124,18 @@ struct serde_error {
             return {};
         }
         std::string result;
-        for(std::size_t i = 0; i < detail->path.size(); ++i) {
-            if(auto* field = std::get_if<std::string>(&detail->path[i])) {
-                if(i > 0) {
-                    result += '.';
-                }
-                result += *field;
-            } else {
+        for(auto segment = detail->path.rbegin(); segment != detail->path.rend(); ++segment) {
+            if(auto* index = std::get_if<std::size_t>(&*segment)) {
                 result += '[';
-                result += std::to_string(std::get<std::size_t>(detail->path[i]));
+                result += std::to_string(*index);
                 result += ']';
+                continue;
+            }
+            if(!result.empty()) {
+                result += '.';
             }
+            auto* owned = std::get_if<std::string>(&*segment);
+            result += owned ? std::string_view(*owned) : std::get<std::string_view>(*segment);
         }
         return result;
     }
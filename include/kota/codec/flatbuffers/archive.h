@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "kota/codec/flatbuffers/proxy.h"
+#include "kota/codec/flatbuffers/serializer.h"
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace kota::codec::flatbuffers {
+
+/// An archive is a run of finished buffers, one per record, appended one
+/// after another, so a file of them grows by appending records instead of
+/// being rebuilt. Each record is an eight byte header, holding the buffer's
+/// size as a little-endian uint32 and four zero bytes, then the buffer,
+/// then zeros up to a multiple of eight. Buffers therefore start eight-byte
+/// aligned in the archive, which is how flatbuffers lays its scalars out,
+/// and on an archive mapped into memory they are read where they lie.
+constexpr inline std::size_t archive_alignment = 8;
+
+constexpr inline std::size_t archive_header_size = 8;
+
+/// Encodes `value` with `serializer` and appends it to `archive` as one
+/// more record.
+template <typename Config, typename T>
+auto append_record(Serializer<Config>& serializer,
+                   std::vector<std::uint8_t>& archive,
+                   const T& value) -> object_result_t<void> {
+    KOTA_EXPECTED_TRY_V(auto encoded, serializer.encode(value));
+
+    const auto start = archive.size();
+    const auto padded = (encoded.size() + archive_alignment - 1) / archive_alignment *
+                        archive_alignment;
+    archive.resize(start + archive_header_size + padded);
+    ::flatbuffers::WriteScalar(archive.data() + start,
+                               static_cast<::flatbuffers::uoffset_t>(encoded.size()));
+    std::copy(encoded.begin(), encoded.end(), archive.begin() + start + archive_header_size);
+    return {};
+}
+
+template <typename Config = config::default_config, typename T>
+auto append_record(std::vector<std::uint8_t>& archive, const T& value) -> object_result_t<void> {
+    Serializer<Config> serializer;
+    return append_record(serializer, archive, value);
+}
+
+/// The records of an archive, read in place as table_view<T>s with nothing
+/// decoded ahead of time. `bytes` has to outlive the range; for a file, map
+/// it with fs::map() and pass std::as_bytes(file.bytes()).
+///
+/// Iteration ends early at a record that does not fit in what is left of
+/// the archive or is not a buffer of ours, as after an append that was cut
+/// short; intact_size() is where the records before it end, so the archive
+/// can be truncated back to it and appended to again.
+template <typename T>
+class record_archive {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = table_view<T>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        /// The record's buffer, read without checks; see verified().
+        auto operator*() const -> table_view<T> {
+            return table_view<T>::from_bytes(record());
+        }
+
+        /// The record's buffer, or an empty view if it does not verify; for
+        /// archives that cannot be trusted.
+        auto verified() const -> table_view<T> {
+            return table_view<T>::verified(record());
+        }
+
+        iterator& operator++() {
+            position = next;
+            locate();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        /// The record's buffer, without the header and padding.
+        auto record() const noexcept -> std::span<const std::uint8_t> {
+            return bytes.subspan(position + archive_header_size, size);
+        }
+
+        /// Byte offset of the current record's header in the archive.
+        auto offset() const noexcept -> std::size_t {
+            return position;
+        }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return it.next == it.position;
+        }
+
+    private:
+        friend class record_archive;
+
+        explicit iterator(std::span<const std::uint8_t> bytes) : bytes(bytes) {
+            locate();
+        }
+
+        // Finds the record at `position`; next == position if there is none.
+        void locate() noexcept {
+            next = position;
+            const auto remaining = bytes.size() - position;
+            if(remaining < archive_header_size) {
+                return;
+            }
+            const auto* header = bytes.data() + position;
+            const auto length = ::flatbuffers::ReadScalar<::flatbuffers::uoffset_t>(header);
+            const auto padded = (static_cast<std::size_t>(length) + archive_alignment - 1) /
+                                archive_alignment * archive_alignment;
+            if(padded > remaining - archive_header_size ||
+               length < sizeof(::flatbuffers::uoffset_t) + ::flatbuffers::kFileIdentifierLength ||
+               !::flatbuffers::BufferHasIdentifier(header + archive_header_size,
+                                                   detail::buffer_identifier)) {
+                return;
+            }
+            size = length;
+            next = position + archive_header_size + padded;
+        }
+
+        std::span<const std::uint8_t> bytes;
+        std::size_t position = 0;
+        std::size_t size = 0;
+        std::size_t next = 0;
+    };
+
+    explicit record_archive(std::span<const std::uint8_t> bytes) : bytes(bytes) {}
+
+    explicit record_archive(std::span<const std::byte> bytes) :
+        bytes(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()) {}
+
+    iterator begin() const {
+        return iterator(bytes);
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+    /// Bytes from the start of the archive up to the first record that is
+    /// cut short or malformed; bytes.size() when every record is intact.
+    auto intact_size() const noexcept -> std::size_t {
+        auto it = begin();
+        while(it != end()) {
+            ++it;
+        }
+        return it.offset();
+    }
+
+private:
+    std::span<const std::uint8_t> bytes;
+};
+
+}  // namespace kota::codec::flatbuffers
@@ -33,8 +33,7 @@ namespace kota::codec::flatbuffers {
 
 namespace deserialize_detail {
 
-constexpr ::flatbuffers::voffset_t first_field = 4;
-constexpr ::flatbuffers::voffset_t field_step = 2;
+constexpr ::flatbuffers::voffset_t first_field = schema_detail::first_field;
 
 template <typename T>
 using result_t = std::expected<T, object_error_code>;
@@ -50,15 +49,6 @@ constexpr bool root_unboxed_v =
     (meta::reflectable_class<T> && !can_inline_struct_v<T>) || is_pair_v<T> || is_tuple_v<T> ||
     is_specialization_of<std::variant, T>;
 
-inline auto field_voffset(std::size_t index) -> ::flatbuffers::voffset_t {
-    return static_cast<::flatbuffers::voffset_t>(static_cast<std::size_t>(first_field) +
-                                                 index * static_cast<std::size_t>(field_step));
-}
-
-inline auto variant_field_voffset(std::size_t index) -> ::flatbuffers::voffset_t {
-    return field_voffset(index + 1);
-}
-
 inline auto has_field(const ::flatbuffers::Table* table, ::flatbuffers::voffset_t field) -> bool {
     return table != nullptr && table->GetOptionalFieldOffset(field) != 0;
 }
@@ -169,9 +159,10 @@ private:
             return std::unexpected(object_error_code::invalid_state);
         }
 
+        constexpr auto& voffsets = table_layout<U>::voffsets;
         std::expected<void, object_error_code> result{};
         meta::for_each(out, [&](auto field) {
-            const auto field_id = field_voffset(field.index());
+            const auto field_id = voffsets[field.index()];
             auto status = decode_field(table, field_id, field.value(), false);
             if(!status) {
                 result = std::unexpected(status.error());
@@ -194,7 +185,7 @@ private:
         std::expected<void, object_error_code> status{};
         auto decode_one = [&](auto index_c, auto& element) {
             constexpr std::size_t index = decltype(index_c)::value;
-            const auto field = field_voffset(index);
+            const auto field = table_layout<std::remove_cvref_t<T>>::voffsets[index];
             auto decoded = decode_field(table, field, element, false);
             if(!decoded) {
                 status = std::unexpected(decoded.error());
@@ -221,12 +212,13 @@ private:
         if(table == nullptr) {
             return std::unexpected(object_error_code::invalid_state);
         }
-        if(!has_field(table, first_field)) {
+        constexpr auto& voffsets = table_layout<U>::voffsets;
+        if(!has_field(table, voffsets[0])) {
             return std::unexpected(object_error_code::invalid_state);
         }
 
         const auto index =
-            static_cast<std::size_t>(table->GetField<std::uint32_t>(first_field, 0U));
+            static_cast<std::size_t>(table->GetField<std::uint32_t>(voffsets[0], 0U));
         if(index >= std::variant_size_v<U>) {
             return std::unexpected(object_error_code::invalid_state);
         }
@@ -239,7 +231,7 @@ private:
                      return;
                  }
                  matched = true;
-                 status = [&, value_field = variant_field_voffset(I)]() -> status_t {
+                 status = [&, value_field = voffsets[I + 1]]() -> status_t {
                      using alt_t = std::variant_alternative_t<I, U>;
                      if constexpr(!std::default_initializable<alt_t>) {
                          return std::unexpected(object_error_code::unsupported_type);
@@ -497,6 +489,7 @@ private:
         using U = std::remove_cvref_t<T>;
         using key_t = typename U::key_type;
         using mapped_t = typename U::mapped_type;
+        constexpr auto& entry_voffsets = table_layout<std::pair<key_t, mapped_t>>::voffsets;
 
         if(!has_field(table, field)) {
             if(required) {
@@ -526,8 +519,8 @@ private:
 
             key_t key{};
             mapped_t mapped{};
-            KOTA_EXPECTED_TRY(decode_field(entry, first_field, key, true));
-            KOTA_EXPECTED_TRY(decode_field(entry, field_voffset(1), mapped, true));
+            KOTA_EXPECTED_TRY(decode_field(entry, entry_voffsets[0], key, true));
+            KOTA_EXPECTED_TRY(decode_field(entry, entry_voffsets[1], mapped, true));
 
             auto ok = kota::detail::insert_map_entry(out, std::move(key), std::move(mapped));
             if(!ok) {
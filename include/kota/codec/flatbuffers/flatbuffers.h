@@ -1,5 +1,6 @@
 #pragma once
 
+#include "kota/codec/flatbuffers/archive.h"
 #include "kota/codec/flatbuffers/deserializer.h"
 #include "kota/codec/flatbuffers/proxy.h"
 #include "kota/codec/flatbuffers/schema.h"
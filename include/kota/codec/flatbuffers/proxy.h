@@ -30,6 +30,9 @@ namespace kota::codec::flatbuffers {
 template <typename T>
 class table_view;
 
+template <typename T>
+class cached_table_view;
+
 template <typename T>
 class array_view;
 
@@ -44,8 +47,7 @@ class map_view;
 
 namespace proxy_detail {
 
-constexpr ::flatbuffers::voffset_t first_field = 4;
-constexpr ::flatbuffers::voffset_t field_step = 2;
+constexpr ::flatbuffers::voffset_t first_field = schema_detail::first_field;
 
 using codec::detail::remove_annotation_t;
 using codec::detail::remove_optional_t;
@@ -126,7 +128,8 @@ auto field_index(Member Object::* member) -> std::size_t {
     static_assert(std::default_initializable<Object>,
                   "table_view member access requires default-constructible object type");
 
-    Object sample{};
+    // One instance per type serves every lookup.
+    const static Object sample{};
     const auto base = reinterpret_cast<std::uintptr_t>(std::addressof(sample));
     const auto field = reinterpret_cast<std::uintptr_t>(std::addressof(sample.*member));
     const auto offset = static_cast<std::size_t>(field - base);
@@ -140,11 +143,6 @@ auto field_index(Member Object::* member) -> std::size_t {
     return offsets.size();
 }
 
-inline auto voffset(std::size_t index) -> ::flatbuffers::voffset_t {
-    return static_cast<::flatbuffers::voffset_t>(static_cast<std::size_t>(first_field) +
-                                                 index * static_cast<std::size_t>(field_step));
-}
-
 template <typename Element,
           typename CleanElement = clean_t<Element>,
           bool IsScalarLike = std::same_as<CleanElement, std::byte> ||
@@ -331,60 +329,205 @@ public:
 template <typename Element>
 using array_element_return_t = typename array_element_return<Element>::type;
 
-// Shared helper: read a typed value from a flatbuffers::Table at a given voffset.
-// Returns the appropriate proxy type (scalar by value, string_view, table_view, etc.)
+// A scalar stored in a field's slot, or zero for an absent field.
+template <typename S>
+auto read_scalar_at(const std::uint8_t* slot) -> S {
+    return slot == nullptr ? S{} : ::flatbuffers::ReadScalar<S>(slot);
+}
+
+// The object an offset stored in a field's slot points to, or null.
+template <typename P>
+auto read_pointer_at(const std::uint8_t* slot) -> P {
+    if(slot == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<P>(slot + ::flatbuffers::ReadScalar<::flatbuffers::uoffset_t>(slot));
+}
+
+// Read a typed value from a field's slot in its table, as Table::GetAddressOf()
+// finds it; null reads as an absent field. Returns the appropriate proxy type
+// (scalar by value, string_view, table_view, etc.)
 template <typename T>
-auto read_field(const std::uint8_t* root,
-                const ::flatbuffers::Table* table,
-                ::flatbuffers::voffset_t field) -> field_return_type_t<T> {
+auto read_field_at(const std::uint8_t* root, const std::uint8_t* slot) -> field_return_type_t<T> {
     using return_t = field_return_type_t<T>;
 
     if constexpr(std::same_as<T, std::byte>) {
-        return std::byte{table->GetField<std::uint8_t>(field, std::uint8_t{})};
+        return std::byte{read_scalar_at<std::uint8_t>(slot)};
     } else if constexpr(std::is_enum_v<T>) {
         using storage_t = std::underlying_type_t<T>;
-        return static_cast<T>(table->GetField<storage_t>(field, storage_t{}));
+        return static_cast<T>(read_scalar_at<storage_t>(slot));
     } else if constexpr(codec::char_like<T>) {
-        return static_cast<T>(table->GetField<std::int8_t>(field, std::int8_t{}));
+        return static_cast<T>(read_scalar_at<std::int8_t>(slot));
     } else if constexpr(codec::bool_like<T> || codec::int_like<T> || codec::uint_like<T>) {
-        return table->GetField<T>(field, T{});
+        return read_scalar_at<T>(slot);
     } else if constexpr(codec::floating_like<T>) {
         if constexpr(std::same_as<T, float> || std::same_as<T, double>) {
-            return table->GetField<T>(field, T{});
+            return read_scalar_at<T>(slot);
         } else {
-            return static_cast<T>(table->GetField<double>(field, 0.0));
+            return static_cast<T>(read_scalar_at<double>(slot));
         }
     } else if constexpr(is_string_like_v<T>) {
-        const auto* text = table->GetPointer<const ::flatbuffers::String*>(field);
+        const auto* text = read_pointer_at<const ::flatbuffers::String*>(slot);
         if(text == nullptr) {
             return {};
         }
         return std::string_view(text->data(), text->size());
     } else if constexpr(can_inline_struct_v<T>) {
-        const auto* value = table->GetStruct<const T*>(field);
-        if(value == nullptr) {
+        if(slot == nullptr) {
             return {};
         }
-        return *value;
+        return *reinterpret_cast<const T*>(slot);
     } else if constexpr(is_specialization_of<std::variant, T>) {
-        const auto* nested = table->GetPointer<const ::flatbuffers::Table*>(field);
-        return return_t(root, nested);
+        return return_t(root, read_pointer_at<const ::flatbuffers::Table*>(slot));
     } else if constexpr(is_pair_v<T> || is_tuple_v<T>) {
-        const auto* nested = table->GetPointer<const ::flatbuffers::Table*>(field);
-        return return_t(root, nested);
+        return return_t(root, read_pointer_at<const ::flatbuffers::Table*>(slot));
     } else if constexpr(is_map_range_v<T>) {
-        const auto* vec = table->GetPointer<
-            const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::Table>>*>(field);
-        return return_t(root, vec);
+        using vector_ptr_t =
+            const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::Table>>*;
+        return return_t(root, read_pointer_at<vector_ptr_t>(slot));
     } else if constexpr(is_range_like_v<T>) {
         using element_type = clean_t<std::ranges::range_value_t<T>>;
         using vector_ptr_t = array_vector_ptr_t<element_type>;
-        const auto* value = table->GetPointer<vector_ptr_t>(field);
-        return return_t(root, value);
+        return return_t(root, read_pointer_at<vector_ptr_t>(slot));
     } else {
         // reflectable struct -> table_view
-        const auto* nested = table->GetPointer<const ::flatbuffers::Table*>(field);
-        return return_t(root, nested);
+        return return_t(root, read_pointer_at<const ::flatbuffers::Table*>(slot));
+    }
+}
+
+// Shared helper: read a typed value from a flatbuffers::Table at a given voffset.
+template <typename T>
+auto read_field(const std::uint8_t* root,
+                const ::flatbuffers::Table* table,
+                ::flatbuffers::voffset_t field) -> field_return_type_t<T> {
+    return read_field_at<T>(root, table->GetAddressOf(field));
+}
+
+template <typename T>
+auto verify_field(::flatbuffers::Verifier& verifier,
+                  const ::flatbuffers::Table* table,
+                  ::flatbuffers::voffset_t field) -> bool;
+
+// Verifies a table holding a T the way the serializer lays one out: a
+// variant as its index and the alternative, a pair or tuple and a struct
+// as one field per element, and anything else as one boxed field.
+template <typename T>
+auto verify_table(::flatbuffers::Verifier& verifier, const ::flatbuffers::Table* table) -> bool {
+    if(table == nullptr) {
+        return true;
+    }
+    if(!table->VerifyTableStart(verifier)) {
+        return false;
+    }
+
+    bool fields_ok = true;
+    if constexpr(is_specialization_of<std::variant, T>) {
+        constexpr auto& voffsets = table_layout<T>::voffsets;
+        fields_ok = table->VerifyField<std::uint32_t>(verifier, voffsets[0], sizeof(std::uint32_t));
+        const auto index = table->GetField<std::uint32_t>(voffsets[0], 0U);
+        auto verify_alternative = [&]<std::size_t I>() {
+            using alternative_t = deep_clean_t<std::variant_alternative_t<I, T>>;
+            return index != I || verify_field<alternative_t>(verifier, table, voffsets[I + 1]);
+        };
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            fields_ok = fields_ok && (verify_alternative.template operator()<I>() && ...);
+        }(std::make_index_sequence<std::variant_size_v<T>>{});
+    } else if constexpr(is_pair_v<T> || is_tuple_v<T>) {
+        constexpr auto& voffsets = table_layout<T>::voffsets;
+        auto verify_element = [&]<std::size_t I>() {
+            using element_t = deep_clean_t<std::tuple_element_t<I, T>>;
+            return verify_field<element_t>(verifier, table, voffsets[I]);
+        };
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            fields_ok = (verify_element.template operator()<I>() && ...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else if constexpr(meta::reflectable_class<T>) {
+        constexpr auto& voffsets = table_layout<T>::voffsets;
+        auto verify_member = [&]<std::size_t I>() {
+            using member_t = deep_clean_t<meta::field_type<T, I>>;
+            return verify_field<member_t>(verifier, table, voffsets[I]);
+        };
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            fields_ok = (verify_member.template operator()<I>() && ...);
+        }(std::make_index_sequence<meta::field_count<T>()>{});
+    } else {
+        fields_ok = verify_field<T>(verifier, table, first_field);
+    }
+    return fields_ok && verifier.EndTable();
+}
+
+// Verifies field `field` of `table` as read_field<T>() would read it.
+template <typename T>
+auto verify_field(::flatbuffers::Verifier& verifier,
+                  const ::flatbuffers::Table* table,
+                  ::flatbuffers::voffset_t field) -> bool {
+    using table_ptr_t = const ::flatbuffers::Table*;
+
+    if constexpr(is_scalar_v<T>) {
+        using storage_t = scalar_storage_t<T>;
+        return table->VerifyField<storage_t>(verifier, field, sizeof(storage_t));
+    } else if constexpr(is_string_like_v<T>) {
+        return table->VerifyOffset(verifier, field) &&
+               verifier.VerifyString(table->GetPointer<const ::flatbuffers::String*>(field));
+    } else if constexpr(can_inline_struct_v<T>) {
+        return table->VerifyField<T>(verifier, field, alignof(T));
+    } else if constexpr(is_map_range_v<T>) {
+        using vector_ptr_t =
+            const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::Table>>*;
+        if(!table->VerifyOffset(verifier, field)) {
+            return false;
+        }
+        const auto* entries = table->GetPointer<vector_ptr_t>(field);
+        if(entries == nullptr) {
+            return true;
+        }
+        if(!verifier.VerifyVector(entries)) {
+            return false;
+        }
+        using key_t = deep_clean_t<typename T::key_type>;
+        using mapped_t = deep_clean_t<typename T::mapped_type>;
+        constexpr auto& voffsets =
+            table_layout<std::pair<typename T::key_type, typename T::mapped_type>>::voffsets;
+        for(::flatbuffers::uoffset_t i = 0; i < entries->size(); ++i) {
+            const auto* entry = entries->template GetAs<::flatbuffers::Table>(i);
+            if(!entry->VerifyTableStart(verifier) ||
+               !verify_field<key_t>(verifier, entry, voffsets[0]) ||
+               !verify_field<mapped_t>(verifier, entry, voffsets[1]) ||
+               !verifier.EndTable()) {
+                return false;
+            }
+        }
+        return true;
+    } else if constexpr(is_range_like_v<T>) {
+        using element_type = clean_t<std::ranges::range_value_t<T>>;
+        using clean_element_t = deep_clean_t<element_type>;
+        if(!table->VerifyOffset(verifier, field)) {
+            return false;
+        }
+        const auto* elements = table->GetPointer<array_vector_ptr_t<element_type>>(field);
+        if(elements == nullptr) {
+            return true;
+        }
+        if(!verifier.VerifyVector(elements)) {
+            return false;
+        }
+        if constexpr(is_string_like_v<clean_element_t>) {
+            return verifier.VerifyVectorOfStrings(elements);
+        } else if constexpr(!is_scalar_v<clean_element_t> &&
+                            !can_inline_struct_v<clean_element_t>) {
+            for(::flatbuffers::uoffset_t i = 0; i < elements->size(); ++i) {
+                if(!verify_table<clean_element_t>(
+                       verifier,
+                       elements->template GetAs<::flatbuffers::Table>(i))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    } else {
+        // variants, pairs, tuples and structs are nested tables
+        return table->VerifyOffset(verifier, field) &&
+               verify_table<T>(verifier, table->GetPointer<table_ptr_t>(field));
     }
 }
 
@@ -512,8 +655,7 @@ public:
             return return_t{};
         }
 
-        // variant field I is at voffset 6 + I*2 = first_field + (I+1) * field_step
-        const auto field = proxy_detail::voffset(I + 1);
+        const auto field = table_layout<std::variant<Ts...>>::voffsets[I + 1];
         return proxy_detail::read_field<clean_alt_t>(root, table, field);
     }
 
@@ -560,7 +702,7 @@ public:
             return return_t{};
         }
 
-        const auto field = proxy_detail::voffset(I);
+        const auto field = table_layout<std::tuple<Ts...>>::voffsets[I];
         return proxy_detail::read_field<clean_element_t>(root, table, field);
     }
 
@@ -626,7 +768,9 @@ public:
         if(entry == nullptr) {
             return value_return_t{};
         }
-        return proxy_detail::read_field<clean_v>(root, entry, proxy_detail::voffset(1));
+        return proxy_detail::read_field<clean_v>(root,
+                                                 entry,
+                                                 table_layout<std::pair<K, V>>::voffsets[1]);
     }
 
     template <typename U = K>
@@ -724,6 +868,34 @@ public:
         return table_view(data, ::flatbuffers::GetRoot<table_type>(data));
     }
 
+    /// from_bytes() for a buffer that cannot be trusted, such as a file mapped
+    /// from disk: empty unless every table, vector and string the view can
+    /// reach lies inside `bytes`. The check runs once, here; reads through the
+    /// view and the views it hands out are unchecked.
+    static auto verified(std::span<const std::uint8_t> bytes) -> table_view
+        requires meta::reflectable_class<object_type>
+    {
+        if(bytes.size() < sizeof(::flatbuffers::uoffset_t)) {
+            return {};
+        }
+        ::flatbuffers::Verifier verifier(bytes.data(), bytes.size());
+        if(!verifier.VerifyOffset(0)) {
+            return {};
+        }
+        const auto* root_table = ::flatbuffers::GetRoot<table_type>(bytes.data());
+        if(!proxy_detail::verify_table<object_type>(verifier, root_table)) {
+            return {};
+        }
+        return table_view(bytes.data(), root_table);
+    }
+
+    static auto verified(std::span<const std::byte> bytes) -> table_view
+        requires meta::reflectable_class<object_type>
+    {
+        return verified(std::span(reinterpret_cast<const std::uint8_t*>(bytes.data()),
+                                  bytes.size()));
+    }
+
     constexpr auto valid() const noexcept -> bool {
         return table != nullptr;
     }
@@ -740,6 +912,14 @@ public:
         return table;
     }
 
+    /// The same view with every field's vtable lookup done up front; see
+    /// cached_table_view.
+    auto cached() const -> cached_table_view<T>
+        requires meta::reflectable_class<object_type>
+    {
+        return cached_table_view<T>(*this);
+    }
+
     template <typename Member>
         requires meta::reflectable_class<object_type>
     auto has(Member object_type::* member) const -> bool {
@@ -751,7 +931,7 @@ public:
         if(index >= meta::field_count<object_type>()) {
             return false;
         }
-        return table->GetOptionalFieldOffset(proxy_detail::voffset(index)) != 0;
+        return table->GetOptionalFieldOffset(table_layout<object_type>::voffsets[index]) != 0;
     }
 
     template <typename Member>
@@ -775,7 +955,7 @@ public:
             return return_t{};
         }
 
-        const auto field = proxy_detail::voffset(index);
+        const auto field = table_layout<object_type>::voffsets[index];
         return proxy_detail::read_field<member_type>(root, table, field);
     }
 
@@ -784,4 +964,62 @@ private:
     const table_type* table = nullptr;
 };
 
+/// A table_view that looks up where each of T's fields lives once, when it
+/// is made, instead of walking the vtable on every read. Worth it for a
+/// table read field by field many times over, such as one in a hot loop.
+template <typename T>
+class cached_table_view {
+public:
+    using object_type = std::remove_cvref_t<T>;
+
+    constexpr cached_table_view() = default;
+
+    explicit cached_table_view(table_view<T> view) : view(view) {
+        if(!view.valid()) {
+            return;
+        }
+        for(std::size_t index = 0; index < slots.size(); ++index) {
+            slots[index] = view.raw()->GetAddressOf(table_layout<object_type>::voffsets[index]);
+        }
+    }
+
+    constexpr auto valid() const noexcept -> bool {
+        return view.valid();
+    }
+
+    constexpr explicit operator bool() const noexcept {
+        return valid();
+    }
+
+    constexpr auto uncached() const noexcept -> table_view<T> {
+        return view;
+    }
+
+    template <typename Member>
+    auto has(Member object_type::* member) const -> bool {
+        const auto index = proxy_detail::field_index(member);
+        return index < slots.size() && slots[index] != nullptr;
+    }
+
+    template <typename Member>
+    auto operator[](Member object_type::* member) const -> proxy_detail::member_return_t<Member> {
+        return (*this)(member);
+    }
+
+    template <typename Member>
+    auto operator()(Member object_type::* member) const -> proxy_detail::member_return_t<Member> {
+        using member_type = proxy_detail::deep_clean_t<Member>;
+
+        const auto index = proxy_detail::field_index(member);
+        if(index >= slots.size()) {
+            return proxy_detail::member_return_t<Member>{};
+        }
+        return proxy_detail::read_field_at<member_type>(view.root_data(), slots[index]);
+    }
+
+private:
+    table_view<T> view;
+    std::array<const std::uint8_t*, meta::field_count<object_type>()> slots{};
+};
+
 }  // namespace kota::codec::flatbuffers
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "kota/codec/codec.h"
@@ -16,8 +22,33 @@
 
 namespace kota::codec::flatbuffers {
 
+/// The same type as ::flatbuffers::voffset_t, which this header does not
+/// need flatbuffers for.
+using voffset_t = std::uint16_t;
+
 namespace schema_detail {
 
+constexpr voffset_t first_field = 4;
+constexpr voffset_t field_step = 2;
+
+/// Slots a vtable can address with 16-bit voffsets.
+constexpr std::size_t max_table_slots =
+    ((std::numeric_limits<voffset_t>::max)() - first_field) / field_step + 1;
+
+template <typename T>
+consteval std::size_t table_slots() {
+    using U = std::remove_cvref_t<T>;
+    if constexpr(is_specialization_of<std::variant, U>) {
+        return std::variant_size_v<U> + 1;
+    } else if constexpr(is_pair_v<U> || is_tuple_v<U>) {
+        return std::tuple_size_v<U>;
+    } else if constexpr(meta::reflectable_class<U>) {
+        return meta::field_count<U>();
+    } else {
+        return 1;
+    }
+}
+
 using codec::detail::remove_annotation_t;
 using codec::detail::remove_optional_t;
 using codec::detail::clean_t;
@@ -273,6 +304,31 @@ private:
 
 }  // namespace schema_detail
 
+/// Where each slot of T's table lives. Field I of a reflected class and
+/// element I of a tuple or pair are at voffsets[I]; a variant keeps the
+/// index of its alternative, the union type id, at voffsets[0] and
+/// alternative I at voffsets[I + 1]. Anything else is boxed in slot 0.
+///
+/// The table is built once per type at compile time, so the serializer,
+/// deserializer and proxies index it instead of deriving and range-checking
+/// every voffset as they go; a type with too many fields fails to compile.
+template <typename T>
+struct table_layout {
+    constexpr static std::size_t slots = schema_detail::table_slots<T>();
+
+    static_assert(slots <= schema_detail::max_table_slots,
+                  "too many fields for a flatbuffers table");
+
+    constexpr static std::array<voffset_t, slots> voffsets = [] {
+        std::array<voffset_t, slots> out{};
+        for(std::size_t i = 0; i < slots; ++i) {
+            out[i] = static_cast<voffset_t>(schema_detail::first_field +
+                                            i * schema_detail::field_step);
+        }
+        return out;
+    }();
+};
+
 template <typename T>
 constexpr bool is_schema_struct_v = schema_detail::is_schema_struct_v<T>;
 
@@ -4,6 +4,7 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <functional>
 #include <limits>
@@ -62,13 +63,17 @@ using object_result_t = std::expected<T, object_error_code>;
 namespace detail {
 
 constexpr inline char buffer_identifier[] = "EVTO";
-constexpr ::flatbuffers::voffset_t first_field = 4;
-constexpr ::flatbuffers::voffset_t field_step = 2;
+static_assert(std::same_as<voffset_t, ::flatbuffers::voffset_t>);
+
+constexpr ::flatbuffers::voffset_t first_field = schema_detail::first_field;
+constexpr ::flatbuffers::voffset_t field_step = schema_detail::field_step;
 
 using codec::detail::clean_t;
 using codec::detail::remove_annotation_t;
 using codec::detail::remove_optional_t;
 
+/// For the SerializeTuple and SerializeStruct visitors, which see fields
+/// one at a time without their type; the typed encoders use table_layout.
 inline auto field_voffset(std::size_t index) -> object_result_t<::flatbuffers::voffset_t> {
     constexpr auto max_voffset =
         static_cast<std::size_t>((std::numeric_limits<::flatbuffers::voffset_t>::max)());
@@ -80,8 +85,66 @@ inline auto field_voffset(std::size_t index) -> object_result_t<::flatbuffers::v
     return static_cast<::flatbuffers::voffset_t>(raw);
 }
 
-inline auto variant_field_voffset(std::size_t index) -> object_result_t<::flatbuffers::voffset_t> {
-    return field_voffset(index + 1);
+/// True if iterating a Map already visits its keys in ascending `<` order,
+/// as a std::map or std::multimap with the default comparison does.
+template <typename Map>
+constexpr bool ordered_by_key_v = [] {
+    if constexpr(requires { typename Map::key_compare; }) {
+        using compare_t = typename Map::key_compare;
+        return std::same_as<compare_t, std::less<typename Map::key_type>> ||
+               std::same_as<compare_t, std::less<>>;
+    } else {
+        return false;
+    }
+}();
+
+/// A field of the table being built. Strings, vectors and nested tables
+/// must be in the buffer before StartTable(), so each field is recorded
+/// while those are written and added once the table starts: `write` adds
+/// the value whose bytes are at `payload` in the serializer's payload
+/// buffer.
+struct pending_field {
+    using write_fn = void (*)(::flatbuffers::FlatBufferBuilder&,
+                              ::flatbuffers::voffset_t,
+                              const std::byte*);
+
+    write_fn write;
+    ::flatbuffers::voffset_t field;
+    std::uint32_t payload;
+};
+
+/// Where a table's fields start on the serializer's pending stacks. Tables
+/// nest strictly, as a nested table is finished before its parent's next
+/// field is collected, so the fields above a mark are that table's.
+struct table_mark {
+    std::size_t fields;
+    std::size_t payloads;
+};
+
+template <typename T>
+void write_element(::flatbuffers::FlatBufferBuilder& builder,
+                   ::flatbuffers::voffset_t field,
+                   const std::byte* payload) {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+    builder.AddElement<T>(field, value);
+}
+
+template <typename T>
+void write_struct(::flatbuffers::FlatBufferBuilder& builder,
+                  ::flatbuffers::voffset_t field,
+                  const std::byte* payload) {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+    builder.AddStruct(field, &value);
+}
+
+inline void write_offset(::flatbuffers::FlatBufferBuilder& builder,
+                         ::flatbuffers::voffset_t field,
+                         const std::byte* payload) {
+    ::flatbuffers::uoffset_t raw;
+    std::memcpy(&raw, payload, sizeof(raw));
+    builder.AddOffset(field, ::flatbuffers::Offset<void>(raw));
 }
 
 }  // namespace detail
@@ -126,26 +189,24 @@ public:
 
     class SerializeTuple {
     public:
-        explicit SerializeTuple(Serializer& serializer, std::size_t len) noexcept :
-            serializer(serializer) {
-            writers.reserve(len);
-        }
+        explicit SerializeTuple(Serializer& serializer, std::size_t /*len*/) noexcept :
+            serializer(serializer), table(serializer.open_table()) {}
 
         template <typename T>
         status_t serialize_element(const T& value) {
             KOTA_EXPECTED_TRY_V(auto field_id, detail::field_voffset(next_index));
             ++next_index;
 
-            return serializer.collect_field(writers, field_id, value);
+            return serializer.collect_field(field_id, value);
         }
 
         result_t<value_type> end() {
-            return serializer.finish_table(writers);
+            return serializer.finish_table(table);
         }
 
     private:
         Serializer& serializer;
-        std::vector<std::function<void()>> writers;
+        detail::table_mark table;
         std::size_t next_index = 0;
     };
 
@@ -160,12 +221,12 @@ public:
 
         template <typename K, typename V>
         status_t serialize_entry(const K& key, const V& value) {
-            std::vector<std::function<void()>> writers;
+            const auto table = serializer.open_table();
 
-            KOTA_EXPECTED_TRY(serializer.collect_field(writers, detail::first_field, key));
-            KOTA_EXPECTED_TRY_V(auto value_field, detail::field_voffset(1));
-            KOTA_EXPECTED_TRY(serializer.collect_field(writers, value_field, value));
-            KOTA_EXPECTED_TRY_V(auto entry, serializer.finish_table(writers));
+            constexpr auto& voffsets = table_layout<std::pair<K, V>>::voffsets;
+            KOTA_EXPECTED_TRY(serializer.collect_field(voffsets[0], key));
+            KOTA_EXPECTED_TRY(serializer.collect_field(voffsets[1], value));
+            KOTA_EXPECTED_TRY_V(auto entry, serializer.finish_table(table));
             entries.push_back(entry);
 
             return {};
@@ -183,39 +244,63 @@ public:
 
     class SerializeStruct {
     public:
-        explicit SerializeStruct(Serializer& serializer, std::size_t len) noexcept :
-            serializer(serializer) {
-            writers.reserve(len);
-        }
+        explicit SerializeStruct(Serializer& serializer, std::size_t /*len*/) noexcept :
+            serializer(serializer), table(serializer.open_table()) {}
 
         template <typename T>
         status_t serialize_field(std::string_view /*key*/, const T& value) {
             KOTA_EXPECTED_TRY_V(auto field_id, detail::field_voffset(next_index));
             ++next_index;
-            return serializer.collect_field(writers, field_id, value);
+            return serializer.collect_field(field_id, value);
         }
 
         result_t<value_type> end() {
-            return serializer.finish_table(writers);
+            return serializer.finish_table(table);
         }
 
     private:
         Serializer& serializer;
-        std::vector<std::function<void()>> writers;
+        detail::table_mark table;
         std::size_t next_index = 0;
     };
 
-    explicit Serializer(std::size_t initial_capacity = 1024) : builder(initial_capacity) {}
+    explicit Serializer(std::size_t initial_capacity = 1024) :
+        owned_builder(std::in_place, initial_capacity), builder(*owned_builder) {}
+
+    /// Builds into `builder`, which the caller keeps, and may have given its
+    /// own allocator, so its buffer is reused from one message to the next.
+    explicit Serializer(::flatbuffers::FlatBufferBuilder& builder) : builder(builder) {}
+
+    // `builder` may refer to the serializer's own.
+    Serializer(const Serializer&) = delete;
+    Serializer& operator=(const Serializer&) = delete;
 
+    /// Encodes `value` as a finished buffer and returns a view of it inside
+    /// the builder, good until the next encode() or release(). The builder
+    /// is cleared first, keeping its capacity, so encoding message after
+    /// message grows it only while messages grow.
     template <typename T>
-    auto bytes(const T& value) -> result_t<std::vector<std::uint8_t>> {
+    auto encode(const T& value) -> result_t<std::span<const std::uint8_t>> {
         builder.Clear();
+        pending.clear();
+        pending_payloads.clear();
 
         KOTA_EXPECTED_TRY_V(auto root, codec::serialize(*this, value));
 
         builder.Finish(root, detail::buffer_identifier);
-        const auto* begin = builder.GetBufferPointer();
-        return std::vector<std::uint8_t>(begin, begin + builder.GetSize());
+        return std::span<const std::uint8_t>(builder.GetBufferPointer(), builder.GetSize());
+    }
+
+    /// Hands the buffer encode() finished over to the caller without a
+    /// copy. The builder starts over with a new buffer afterwards.
+    auto release() -> ::flatbuffers::DetachedBuffer {
+        return builder.Release();
+    }
+
+    template <typename T>
+    auto bytes(const T& value) -> result_t<std::vector<std::uint8_t>> {
+        KOTA_EXPECTED_TRY_V(auto encoded, encode(value));
+        return std::vector<std::uint8_t>(encoded.begin(), encoded.end());
     }
 
     result_t<value_type> serialize_null() {
@@ -292,51 +377,69 @@ public:
     }
 
 private:
-    // Non-template helper to avoid lld issues with std::function vtable entries
-    // for lambdas inside heavily-instantiated template member functions.
-    void push_add_offset(std::vector<std::function<void()>>& writers,
-                         ::flatbuffers::voffset_t field,
-                         ::flatbuffers::uoffset_t raw_offset) {
-        writers.push_back([this, field, raw_offset] {
-            builder.AddOffset(field, ::flatbuffers::Offset<void>(raw_offset));
-        });
+    using table_mark = detail::table_mark;
+
+    table_mark open_table() const noexcept {
+        return {pending.size(), pending_payloads.size()};
+    }
+
+    void push_pending(::flatbuffers::voffset_t field,
+                      detail::pending_field::write_fn write,
+                      const void* payload,
+                      std::size_t size) {
+        const auto at = pending_payloads.size();
+        pending_payloads.resize(at + size);
+        std::memcpy(pending_payloads.data() + at, payload, size);
+        pending.push_back({write, field, static_cast<std::uint32_t>(at)});
+    }
+
+    template <typename T>
+    void push_element(::flatbuffers::voffset_t field, T value) {
+        push_pending(field, &detail::write_element<T>, &value, sizeof(T));
+    }
+
+    void push_add_offset(::flatbuffers::voffset_t field, ::flatbuffers::uoffset_t raw_offset) {
+        push_pending(field, &detail::write_offset, &raw_offset, sizeof(raw_offset));
     }
 
     template <typename OffsetT>
     auto wrap_offset(::flatbuffers::Offset<OffsetT> offset) -> result_t<value_type> {
-        std::vector<std::function<void()>> writers;
-        push_add_offset(writers, detail::first_field, offset.o);
-        return finish_table(writers);
+        const auto table = open_table();
+        push_add_offset(detail::first_field, offset.o);
+        return finish_table(table);
     }
 
-    auto finish_table(std::vector<std::function<void()>>& writers) -> result_t<value_type> {
+    /// Writes the fields collected since `table` was opened and pops them.
+    auto finish_table(table_mark table) -> result_t<value_type> {
         const auto start = builder.StartTable();
-        for(auto& write: writers) {
-            write();
+        for(std::size_t i = table.fields; i < pending.size(); ++i) {
+            const auto& field = pending[i];
+            field.write(builder, field.field, pending_payloads.data() + field.payload);
         }
+        pending.resize(table.fields);
+        pending_payloads.resize(table.payloads);
         return value_type(builder.EndTable(start));
     }
 
     struct TableFieldCollector {
         Serializer<Config>* serializer = nullptr;
-        std::vector<std::function<void()>>* writers = nullptr;
+        std::span<const ::flatbuffers::voffset_t> voffsets;
         std::size_t current_index = 0;
 
         template <typename V>
         auto serialize_field(std::string_view /*key*/, const V& field_value) -> status_t {
-            if(serializer == nullptr || writers == nullptr) {
+            if(serializer == nullptr) {
                 return std::unexpected(object_error_code::invalid_state);
             }
-            KOTA_EXPECTED_TRY_V(auto field_id, detail::field_voffset(current_index));
-            return serializer->collect_field(*writers, field_id, field_value);
+            return serializer->collect_field(voffsets[current_index], field_value);
         }
     };
 
     template <typename T>
     auto encode_boxed(const T& value) -> result_t<value_type> {
-        std::vector<std::function<void()>> writers;
-        KOTA_EXPECTED_TRY(collect_field(writers, detail::first_field, value));
-        return finish_table(writers);
+        const auto table = open_table();
+        KOTA_EXPECTED_TRY(collect_field(detail::first_field, value));
+        return finish_table(table);
     }
 
     template <typename T>
@@ -344,10 +447,10 @@ private:
         using U = detail::remove_annotation_t<T>;
         static_assert(meta::reflectable_class<U>, "encode_table requires reflectable class");
 
-        std::vector<std::function<void()>> writers;
+        const auto table = open_table();
         TableFieldCollector collector{
             .serializer = this,
-            .writers = &writers,
+            .voffsets = table_layout<U>::voffsets,
             .current_index = 0,
         };
 
@@ -366,7 +469,7 @@ private:
             return std::unexpected(field_result.error());
         }
 
-        return finish_table(writers);
+        return finish_table(table);
     }
 
     template <typename T>
@@ -374,11 +477,9 @@ private:
         using U = std::remove_cvref_t<T>;
         static_assert(is_specialization_of<std::variant, U>, "variant required");
 
-        std::vector<std::function<void()>> writers;
-        const auto variant_index = static_cast<std::uint32_t>(value.index());
-        writers.push_back([this, variant_index] {
-            builder.AddElement<std::uint32_t>(detail::first_field, variant_index);
-        });
+        constexpr auto& voffsets = table_layout<U>::voffsets;
+        const auto table = open_table();
+        push_element(voffsets[0], static_cast<std::uint32_t>(value.index()));
 
         std::expected<void, object_error_code> picked{};
         bool matched = false;
@@ -388,12 +489,7 @@ private:
                      return;
                  }
                  matched = true;
-                 auto field = detail::variant_field_voffset(I);
-                 if(!field) {
-                     picked = std::unexpected(field.error());
-                     return;
-                 }
-                 picked = collect_field(writers, *field, std::get<I>(value));
+                 picked = collect_field(voffsets[I + 1], std::get<I>(value));
              }()),
              ...);
         }(std::make_index_sequence<std::variant_size_v<U>>{});
@@ -405,22 +501,18 @@ private:
             return std::unexpected(picked.error());
         }
 
-        return finish_table(writers);
+        return finish_table(table);
     }
 
     template <typename T>
     auto encode_tuple_like(const T& value) -> result_t<value_type> {
-        std::vector<std::function<void()>> writers;
+        const auto table = open_table();
         std::expected<void, object_error_code> status{};
 
         auto collect_one = [&](auto index_c, const auto& element) {
             constexpr std::size_t index = decltype(index_c)::value;
-            auto field_id = detail::field_voffset(index);
-            if(!field_id) {
-                status = std::unexpected(field_id.error());
-                return false;
-            }
-            auto collected = collect_field(writers, *field_id, element);
+            auto collected =
+                collect_field(table_layout<std::remove_cvref_t<T>>::voffsets[index], element);
             if(!collected) {
                 status = std::unexpected(collected.error());
                 return false;
@@ -436,7 +528,7 @@ private:
             return std::unexpected(status.error());
         }
 
-        return finish_table(writers);
+        return finish_table(table);
     }
 
     template <typename T>
@@ -446,38 +538,47 @@ private:
         using key_t = typename U::key_type;
         using mapped_t = typename U::mapped_type;
 
-        std::vector<std::pair<key_t, mapped_t>> entries;
-        entries.reserve(value.size());
-        for(const auto& [key, mapped]: value) {
-            entries.emplace_back(key, mapped);
-        }
-
-        if constexpr(requires(const key_t& lhs, const key_t& rhs) {
-                         { lhs < rhs } -> std::convertible_to<bool>;
-                     }) {
-            std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
-                return lhs.first < rhs.first;
-            });
-        }
-
         std::vector<value_type> offsets;
-        offsets.reserve(entries.size());
-        for(const auto& [key, mapped]: entries) {
-            std::vector<std::function<void()>> writers;
-            KOTA_EXPECTED_TRY(collect_field(writers, detail::first_field, key));
-            KOTA_EXPECTED_TRY_V(auto value_field, detail::field_voffset(1));
-            KOTA_EXPECTED_TRY(collect_field(writers, value_field, mapped));
-            KOTA_EXPECTED_TRY_V(auto entry, finish_table(writers));
+        offsets.reserve(value.size());
+        auto encode_entry = [&](const key_t& key, const mapped_t& mapped) -> status_t {
+            constexpr auto& voffsets = table_layout<std::pair<key_t, mapped_t>>::voffsets;
+            const auto table = open_table();
+            KOTA_EXPECTED_TRY(collect_field(voffsets[0], key));
+            KOTA_EXPECTED_TRY(collect_field(voffsets[1], mapped));
+            KOTA_EXPECTED_TRY_V(auto entry, finish_table(table));
             offsets.push_back(entry);
+            return {};
+        };
+
+        // Entries go out in key order so readers can binary-search them. The
+        // entries are sorted through pointers, never copied: mapped values can be
+        // whole tables.
+        constexpr bool sortable = requires(const key_t& lhs, const key_t& rhs) {
+            { lhs < rhs } -> std::convertible_to<bool>;
+        };
+        if constexpr(detail::ordered_by_key_v<U> || !sortable) {
+            for(const auto& [key, mapped]: value) {
+                KOTA_EXPECTED_TRY(encode_entry(key, mapped));
+            }
+        } else {
+            std::vector<const typename U::value_type*> entries;
+            entries.reserve(value.size());
+            for(const auto& entry: value) {
+                entries.push_back(&entry);
+            }
+            std::sort(entries.begin(), entries.end(), [](const auto* lhs, const auto* rhs) {
+                return lhs->first < rhs->first;
+            });
+            for(const auto* entry: entries) {
+                KOTA_EXPECTED_TRY(encode_entry(entry->first, entry->second));
+            }
         }
 
         return builder.CreateVector(offsets);
     }
 
     template <typename T>
-    auto collect_sequence_field(std::vector<std::function<void()>>& writers,
-                                ::flatbuffers::voffset_t field,
-                                const T& value) -> status_t {
+    auto collect_sequence_field(::flatbuffers::voffset_t field, const T& value) -> status_t {
         using U = std::remove_cvref_t<T>;
         using element_t = std::ranges::range_value_t<U>;
         using element_clean_t = detail::clean_t<element_t>;
@@ -491,7 +592,7 @@ private:
                 bytes.push_back(std::to_integer<std::uint8_t>(b));
             }
             auto offset = builder.CreateVector(bytes);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(codec::bool_like<element_clean_t> || codec::int_like<element_clean_t> ||
                             codec::uint_like<element_clean_t>) {
@@ -503,7 +604,7 @@ private:
                 elements.push_back(static_cast<element_clean_t>(element));
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(codec::floating_like<element_clean_t>) {
             if constexpr(std::same_as<element_clean_t, float> ||
@@ -516,7 +617,7 @@ private:
                     elements.push_back(static_cast<element_clean_t>(element));
                 }
                 auto offset = builder.CreateVector(elements);
-                push_add_offset(writers, field, offset.o);
+                push_add_offset(field, offset.o);
                 return {};
             } else {
                 std::vector<double> elements;
@@ -527,7 +628,7 @@ private:
                     elements.push_back(static_cast<double>(element));
                 }
                 auto offset = builder.CreateVector(elements);
-                push_add_offset(writers, field, offset.o);
+                push_add_offset(field, offset.o);
                 return {};
             }
         } else if constexpr(codec::char_like<element_clean_t>) {
@@ -539,7 +640,7 @@ private:
                 elements.push_back(static_cast<std::int8_t>(element));
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(codec::str_like<element_clean_t>) {
             std::vector<::flatbuffers::Offset<::flatbuffers::String>> elements;
@@ -551,7 +652,7 @@ private:
                 elements.push_back(builder.CreateString(text.data(), text.size()));
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(is_pair_v<element_clean_t> || is_tuple_v<element_clean_t>) {
             std::vector<value_type> elements;
@@ -563,7 +664,7 @@ private:
                 elements.push_back(tuple);
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(can_inline_struct_v<element_clean_t>) {
             std::vector<element_clean_t> elements;
@@ -574,7 +675,7 @@ private:
                 elements.push_back(static_cast<element_clean_t>(element));
             }
             auto offset = builder.CreateVectorOfStructs(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(meta::reflectable_class<element_clean_t>) {
             std::vector<value_type> elements;
@@ -586,7 +687,7 @@ private:
                 elements.push_back(table);
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else {
             std::vector<value_type> elements;
@@ -598,97 +699,89 @@ private:
                 elements.push_back(boxed);
             }
             auto offset = builder.CreateVector(elements);
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         }
     }
 
     template <typename T>
-    auto collect_field(std::vector<std::function<void()>>& writers,
-                       ::flatbuffers::voffset_t field,
-                       const T& value) -> status_t {
+    auto collect_field(::flatbuffers::voffset_t field, const T& value) -> status_t {
         using U = std::remove_cvref_t<T>;
         using clean_t = detail::clean_t<U>;
 
         if constexpr(meta::annotated_type<U>) {
-            return collect_field(writers, field, meta::annotated_value(value));
+            return collect_field(field, meta::annotated_value(value));
         } else if constexpr(is_specialization_of<std::optional, U>) {
             if(!value.has_value()) {
                 return {};
             }
-            return collect_field(writers, field, value.value());
+            return collect_field(field, value.value());
         } else if constexpr(is_specialization_of<std::unique_ptr, U> ||
                             is_specialization_of<std::shared_ptr, U>) {
             if(!value) {
                 return {};
             }
-            return collect_field(writers, field, *value);
+            return collect_field(field, *value);
         } else if constexpr(std::same_as<clean_t, std::nullptr_t>) {
             return {};
         } else if constexpr(std::is_enum_v<clean_t>) {
             using underlying_t = std::underlying_type_t<clean_t>;
-            return collect_field(writers, field, static_cast<underlying_t>(value));
+            return collect_field(field, static_cast<underlying_t>(value));
         } else if constexpr(codec::bool_like<clean_t>) {
-            const bool v = static_cast<bool>(value);
-            writers.push_back([this, field, v] { builder.AddElement<bool>(field, v); });
+            push_element(field, static_cast<bool>(value));
             return {};
         } else if constexpr(codec::int_like<clean_t>) {
-            const clean_t v = static_cast<clean_t>(value);
-            writers.push_back([this, field, v] { builder.AddElement<clean_t>(field, v); });
+            push_element(field, static_cast<clean_t>(value));
             return {};
         } else if constexpr(codec::uint_like<clean_t>) {
-            const clean_t v = static_cast<clean_t>(value);
-            writers.push_back([this, field, v] { builder.AddElement<clean_t>(field, v); });
+            push_element(field, static_cast<clean_t>(value));
             return {};
         } else if constexpr(codec::floating_like<clean_t>) {
             if constexpr(std::same_as<clean_t, float> || std::same_as<clean_t, double>) {
-                const clean_t v = static_cast<clean_t>(value);
-                writers.push_back([this, field, v] { builder.AddElement<clean_t>(field, v); });
+                push_element(field, static_cast<clean_t>(value));
             } else {
-                const double v = static_cast<double>(value);
-                writers.push_back([this, field, v] { builder.AddElement<double>(field, v); });
+                push_element(field, static_cast<double>(value));
             }
             return {};
         } else if constexpr(codec::char_like<clean_t>) {
-            const std::int8_t v = static_cast<std::int8_t>(value);
-            writers.push_back([this, field, v] { builder.AddElement<std::int8_t>(field, v); });
+            push_element(field, static_cast<std::int8_t>(value));
             return {};
         } else if constexpr(codec::str_like<clean_t>) {
             const std::string_view text = value;
             const auto offset = builder.CreateString(text.data(), text.size());
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(codec::bytes_like<clean_t>) {
             const std::span<const std::byte> bytes = value;
             const auto* data =
                 bytes.empty() ? nullptr : reinterpret_cast<const std::uint8_t*>(bytes.data());
             const auto offset = builder.CreateVector(data, bytes.size());
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(is_specialization_of<std::variant, U>) {
             KOTA_EXPECTED_TRY_V(auto offset, encode_variant(value));
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(std::ranges::input_range<clean_t>) {
             constexpr auto kind = kota::format_kind<clean_t>;
             if constexpr(kind == kota::range_format::map) {
                 KOTA_EXPECTED_TRY_V(auto offset, encode_map(value));
-                push_add_offset(writers, field, offset.o);
+                push_add_offset(field, offset.o);
                 return {};
             } else {
-                return collect_sequence_field(writers, field, value);
+                return collect_sequence_field(field, value);
             }
         } else if constexpr(is_pair_v<clean_t> || is_tuple_v<clean_t>) {
             KOTA_EXPECTED_TRY_V(auto offset, encode_tuple_like(value));
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else if constexpr(can_inline_struct_v<clean_t>) {
             const clean_t copy = static_cast<clean_t>(value);
-            writers.push_back([this, field, copy] { builder.AddStruct(field, &copy); });
+            push_pending(field, &detail::write_struct<clean_t>, &copy, sizeof(copy));
             return {};
         } else if constexpr(meta::reflectable_class<clean_t>) {
             KOTA_EXPECTED_TRY_V(auto offset, encode_table(value));
-            push_add_offset(writers, field, offset.o);
+            push_add_offset(field, offset.o);
             return {};
         } else {
             return std::unexpected(object_error_code::unsupported_type);
@@ -696,7 +789,12 @@ private:
     }
 
 private:
-    ::flatbuffers::FlatBufferBuilder builder;
+    std::optional<::flatbuffers::FlatBufferBuilder> owned_builder;
+    ::flatbuffers::FlatBufferBuilder& builder;
+    // Fields of the tables being built, innermost last; kept across tables
+    // so that once grown, building a table allocates nothing.
+    std::vector<detail::pending_field> pending;
+    std::vector<std::byte> pending_payloads;
 };
 
 template <typename Config = config::default_config, typename T>
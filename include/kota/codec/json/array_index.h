@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <string_view>
+#include <vector>
+
+#include "kota/codec/config.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/error.h"
+
+namespace kota::codec::json {
+
+/// Where each element of a top-level JSON array lies, so that elements can
+/// be decoded independently of each other, e.g. a range of them per thread.
+///
+/// build() walks the array once over simdjson's structural index, skipping
+/// each element instead of decoding it; decode() then reads one element in
+/// place. Views point into the indexed buffer, which has to outlive the
+/// index.
+class array_index {
+public:
+    array_index() = default;
+
+    /// Indexes the array `json` holds; fails unless it is one.
+    static auto build(simdjson::padded_string_view json) -> std::expected<array_index, error> {
+        auto& context = parse_context::local();
+        if(context.busy()) {
+            simdjson::ondemand::parser parser;
+            return build(parser, json);
+        }
+        parse_context::lease lease(context);
+        return build(context.parser(), json);
+    }
+
+    std::size_t size() const noexcept {
+        return elements.size();
+    }
+
+    /// The text of element `i`.
+    std::string_view operator[](std::size_t i) const noexcept {
+        return elements[i];
+    }
+
+    /// Decodes element `i` into `value` with the calling thread's
+    /// parse_context. Several threads may decode elements at once.
+    template <typename Config = config::default_config, typename T>
+    auto decode(std::size_t i, T& value) const -> std::expected<void, error> {
+        // An element's view runs on to the end of the buffer's padding.
+        const auto text = elements[i];
+        const auto offset = static_cast<std::size_t>(text.data() - input.data());
+        simdjson::padded_string_view padded(text.data(), text.size(), input.capacity() - offset);
+        return from_json<Config>(parse_context::local(), padded, value);
+    }
+
+private:
+    static auto build(simdjson::ondemand::parser& parser, simdjson::padded_string_view json)
+        -> std::expected<array_index, error> {
+        simdjson::ondemand::document document;
+        if(auto err = parser.iterate(json).get(document); err != simdjson::SUCCESS) {
+            return std::unexpected(make_error(err));
+        }
+
+        simdjson::ondemand::array array;
+        if(auto err = document.get_array().get(array); err != simdjson::SUCCESS) {
+            return std::unexpected(make_error(err));
+        }
+
+        array_index index;
+        index.input = json;
+        for(auto element: array) {
+            simdjson::ondemand::value value;
+            if(auto err = element.get(value); err != simdjson::SUCCESS) {
+                return std::unexpected(make_error(err));
+            }
+
+            std::string_view raw;
+            if(auto err = value.raw_json().get(raw); err != simdjson::SUCCESS) {
+                return std::unexpected(make_error(err));
+            }
+            index.elements.push_back(raw);
+        }
+
+        if(!document.at_end()) {
+            return std::unexpected(error_kind::trailing_content);
+        }
+        return index;
+    }
+
+    simdjson::padded_string_view input{};
+    std::vector<std::string_view> elements;
+};
+
+}  // namespace kota::codec::json
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -13,6 +17,7 @@
 #include <vector>
 
 #include "kota/support/expected_try.h"
+#include "kota/support/fixed_string.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
 #include "kota/codec/content/deserializer.h"
@@ -21,6 +26,71 @@
 
 namespace kota::codec::json {
 
+/// A simdjson parser and a padded input buffer kept from one parse to the
+/// next, so decoding a stream of similar documents stops allocating once
+/// both have grown to fit. Pass one to from_json(), or use local() for the
+/// calling thread's.
+///
+/// A context reads one document at a time; a parse that finds it busy (one
+/// nested in a deserialize hook, say) uses a parser of its own instead.
+class parse_context {
+public:
+    parse_context() = default;
+    parse_context(const parse_context&) = delete;
+    parse_context& operator=(const parse_context&) = delete;
+
+    /// The calling thread's context.
+    static parse_context& local() noexcept {
+        thread_local parse_context context;
+        return context;
+    }
+
+    bool busy() const noexcept {
+        return in_use;
+    }
+
+    /// Marks the context busy until destroyed.
+    class lease {
+    public:
+        explicit lease(parse_context& context) noexcept : context(context) {
+            context.in_use = true;
+        }
+
+        lease(const lease&) = delete;
+        lease& operator=(const lease&) = delete;
+
+        ~lease() {
+            context.in_use = false;
+        }
+
+    private:
+        parse_context& context;
+    };
+
+    simdjson::ondemand::parser& parser() noexcept {
+        return shared_parser;
+    }
+
+    /// Copies `json` into the buffer, growing it only when `json` does not
+    /// fit with simdjson's padding, and returns a view of the copy.
+    simdjson::padded_string_view pad(std::string_view json) {
+        const auto needed = json.size() + simdjson::SIMDJSON_PADDING;
+        if(buffer.size() < needed) {
+            buffer.resize(needed);
+        }
+        if(!json.empty()) {
+            std::memcpy(buffer.data(), json.data(), json.size());
+        }
+        std::memset(buffer.data() + json.size(), 0, simdjson::SIMDJSON_PADDING);
+        return simdjson::padded_string_view(buffer.data(), json.size(), buffer.size());
+    }
+
+private:
+    simdjson::ondemand::parser shared_parser;
+    std::string buffer;
+    bool in_use = false;
+};
+
 template <typename Config = config::default_config>
 class Deserializer {
 public:
@@ -159,13 +229,19 @@ public:
                 return deserializer.mark_invalid(field_err);
             }
 
-            auto key_err = field.unescaped_key(pending_key);
-            if(key_err != simdjson::SUCCESS) {
-                return deserializer.mark_invalid(key_err);
+            // Most keys have no escapes and are returned in place, without an
+            // unescaped copy.
+            std::string_view key = field.escaped_key();
+            if(key.find('\\') != std::string_view::npos) {
+                auto key_err = field.unescaped_key(pending_key);
+                if(key_err != simdjson::SUCCESS) {
+                    return deserializer.mark_invalid(key_err);
+                }
+                key = pending_key;
             }
             pending_value = std::move(field).value();
             has_pending_value = true;
-            return std::optional<std::string_view>{std::string_view(pending_key)};
+            return std::optional<std::string_view>{key};
         }
 
         status_t invalid_key(std::string_view /*key_name*/) {
@@ -196,8 +272,8 @@ public:
                 return deserializer.mark_invalid();
             }
 
-            KOTA_EXPECTED_TRY(deserializer.skip_value(pending_value));
-
+            // Left unread, the value is stepped over by the iterator on its
+            // structural index alone, however large it is.
             ++iter;
             has_pending_value = false;
             return {};
@@ -220,9 +296,6 @@ public:
                     return deserializer.mark_invalid(field_err);
                 }
 
-                auto value = std::move(field).value();
-                KOTA_EXPECTED_TRY(deserializer.skip_value(value));
-
                 ++iter;
             }
 
@@ -271,10 +344,21 @@ public:
         initialize_document(json);
     }
 
+    /// Reads `json` with a parser that outlives this deserializer rather
+    /// than one of its own, reusing the parser's buffers.
+    Deserializer(simdjson::ondemand::parser& shared, simdjson::padded_string_view json) {
+        initialize_document(shared, json);
+    }
+
     bool valid() const {
         return is_valid;
     }
 
+    /// The document being read; raw JSON views point into it.
+    std::string_view source() const noexcept {
+        return std::string_view(input_view.data(), input_view.size());
+    }
+
     error_type error() const {
         return last_error;
     }
@@ -292,6 +376,25 @@ public:
         return {};
     }
 
+    /// Decodes the value that JSON Pointer `pointer` (RFC 6901) names into
+    /// `value`, skipping what lies around it unparsed. Every call searches
+    /// from the top of the document, so pointers may come in any order, and
+    /// finish() does not apply afterwards.
+    template <typename T>
+    status_t deserialize_at(std::string_view pointer, T& value) {
+        if(!is_valid) {
+            return std::unexpected(last_error);
+        }
+
+        simdjson::ondemand::value target;
+        auto err = document.at_pointer(pointer).get(target);
+        if(err != simdjson::SUCCESS) {
+            return mark_invalid(err);
+        }
+        root_consumed = true;
+        return deserialize_from_value(target, value);
+    }
+
     result_t<bool> deserialize_none() {
         if(!is_valid) {
             return std::unexpected(last_error);
@@ -343,19 +446,18 @@ public:
         }
 
         if(*json_type == simdjson::ondemand::json_type::object) {
-            /// TODO(kotatsu/serde): Optimize object-variant dispatch with a two-pass strategy.
-            /// Pass 1: walk fields once to collect a lightweight structural signature
-            /// (field names + coarse JSON value categories).
-            /// Use that signature to select a likely target alternative (especially among
-            /// many struct-like alternatives) without trying each candidate parser.
-            /// Pass 2: deserialize exactly once into the selected alternative.
-            /// Target complexity: at most two object traversals regardless of the number
-            /// of struct alternatives in std::variant.
+            // One scan of the object's keys rules out the struct alternatives
+            // missing a required field, so usually only the alternative that
+            // matches is parsed. The trials keep their order, so the result
+            // is the same as trying every alternative.
+            std::array<std::string_view, max_screened_keys> key_storage;
+            const auto keys = scan_object_keys(std::string_view(*raw), key_storage);
+
             bool matched = false;
             bool considered = false;
             error_type obj_last_error = error_type::type_mismatch;
 
-            auto try_alternative = [&](auto type_tag) {
+            auto try_alternative = [&](auto type_tag, bool screen) {
                 if(matched) {
                     return;
                 }
@@ -364,6 +466,12 @@ public:
                 if(!variant_candidate_matches<alt_t>(*json_type, number_type)) {
                     return;
                 }
+                if constexpr(screened_by_keys<alt_t>) {
+                    if(screen && keys &&
+                       !codec::detail::keys_admit_struct<alt_t, config_type>(*keys)) {
+                        return;
+                    }
+                }
                 considered = true;
 
                 auto candidate_status = deserialize_variant_candidate<alt_t>(*raw, value);
@@ -374,7 +482,15 @@ public:
                 }
             };
 
-            (try_alternative(std::type_identity<Ts>{}), ...);
+            (try_alternative(std::type_identity<Ts>{}, true), ...);
+
+            // Nothing fits: try them all, for the error an unscreened
+            // dispatch reports.
+            if(!matched && keys) {
+                considered = false;
+                obj_last_error = error_type::type_mismatch;
+                (try_alternative(std::type_identity<Ts>{}, false), ...);
+            }
 
             if(!matched) {
                 return mark_invalid(considered ? obj_last_error.kind : error_kind::type_mismatch);
@@ -502,6 +618,14 @@ public:
     }
 
     status_t deserialize_str(std::string& value) {
+        KOTA_EXPECTED_TRY_V(auto text, deserialize_str_view());
+        value.assign(text.data(), text.size());
+        return {};
+    }
+
+    /// The string unescaped into the parser's own buffer, without a copy;
+    /// it stays valid until the parser reads another document.
+    result_t<std::string_view> deserialize_str_view() {
         std::string_view text;
         auto status = read_scalar(
             text,
@@ -510,9 +634,7 @@ public:
         if(!status) {
             return std::unexpected(status.error());
         }
-
-        value.assign(text.data(), text.size());
-        return {};
+        return text;
     }
 
     status_t deserialize_bytes(std::vector<std::byte>& value) {
@@ -578,6 +700,46 @@ public:
                                                           false);
     }
 
+    /// The string value of the top-level field `key` of the object about to
+    /// be read, found by scanning the object's text without consuming it, so
+    /// that e.g. a variant tag is known before the fields around it are
+    /// decoded. nullopt when the scan cannot vouch for it: the value is not
+    /// an object, or the field is missing, not a string or escaped.
+    result_t<std::optional<std::string_view>> peek_object_string_field(std::string_view key) {
+        KOTA_EXPECTED_TRY_V(
+            auto token,
+            read_source<std::string_view>(
+                [](auto& doc) { return doc.raw_json_token(); },
+                [](auto& val) {
+                    return simdjson::simdjson_result<std::string_view>(val.raw_json_token());
+                },
+                false));
+
+        // The token is the object's opening brace; the rest of the object
+        // follows it in the input.
+        const char* end = input_view.data() + input_view.size();
+        if(token.data() < input_view.data() || token.data() >= end) {
+            return std::optional<std::string_view>{};
+        }
+        const std::string_view rest(token.data(), static_cast<std::size_t>(end - token.data()));
+
+        std::optional<std::string_view> found;
+        auto on_field = [&](std::string_view field, std::string_view value) {
+            if(field != key) {
+                return true;
+            }
+            if(value.size() >= 2 && value.front() == '"' && value.back() == '"' &&
+               value.find('\\') == std::string_view::npos) {
+                found = value.substr(1, value.size() - 2);
+            }
+            return false;
+        };
+        if(!scan_object_fields(rest, on_field)) {
+            return std::optional<std::string_view>{};
+        }
+        return found;
+    }
+
 private:
     /// Unified root-vs-value dispatch. Calls `doc_fn(document)` or `val_fn(*current_value)`,
     /// each returning a simdjson result whose `.get(T&)` populates the output.
@@ -689,15 +851,162 @@ private:
                               map_to_type_hint(json_type, number_type));
     }
 
+    /// Alternatives codec::deserialize() reads as plain reflectable structs,
+    /// whose required fields keys_admit_struct() can check.
+    template <typename Alt>
+    constexpr static bool screened_by_keys =
+        meta::reflectable_class<Alt> && !meta::annotated_type<Alt> &&
+        !codec::detail::is_captured_dom_value_v<Deserializer, Alt> && !codec::tuple_like<Alt> &&
+        !std::ranges::input_range<Alt> &&
+        !requires(Deserializer& d, Alt& v) {
+            deserialize_traits<Deserializer, Alt>::deserialize(d, v);
+        };
+
+    /// Objects with more keys than this are not screened.
+    constexpr static std::size_t max_screened_keys = 32;
+
+    /// Walks the top-level fields of the object `raw` by scanning its text
+    /// rather than parsing it, passing each key and the text of its value
+    /// to `on_field`, which returns false to stop early. False when the scan
+    /// cannot follow the text (a key with escapes, a stray token), in which
+    /// case the fields seen so far vouch for nothing.
+    template <typename OnField>
+    static bool scan_object_fields(std::string_view raw, OnField&& on_field) {
+        std::size_t at = 0;
+        auto skip_space = [&] {
+            while(at < raw.size() &&
+                  (raw[at] == ' ' || raw[at] == '\t' || raw[at] == '\n' || raw[at] == '\r')) {
+                ++at;
+            }
+        };
+
+        skip_space();
+        if(at >= raw.size() || raw[at] != '{') {
+            return false;
+        }
+        ++at;
+        skip_space();
+        if(at < raw.size() && raw[at] == '}') {
+            return true;
+        }
+
+        while(true) {
+            skip_space();
+            if(at >= raw.size() || raw[at] != '"') {
+                return false;
+            }
+            const auto close = raw.find('"', at + 1);
+            if(close == std::string_view::npos) {
+                return false;
+            }
+            auto key = raw.substr(at + 1, close - at - 1);
+            if(key.find('\\') != std::string_view::npos) {
+                return false;
+            }
+            at = close + 1;
+
+            skip_space();
+            if(at >= raw.size() || raw[at] != ':') {
+                return false;
+            }
+            ++at;
+            skip_space();
+            const auto value_begin = at;
+
+            // Skip the value: up to the comma or brace that closes it.
+            std::size_t depth = 0;
+            while(at < raw.size()) {
+                const char c = raw[at];
+                if(c == '"') {
+                    ++at;
+                    while(at < raw.size() && raw[at] != '"') {
+                        at += raw[at] == '\\' ? 2 : 1;
+                    }
+                } else if(c == '{' || c == '[') {
+                    ++depth;
+                } else if(c == '}' || c == ']') {
+                    if(depth == 0) {
+                        break;
+                    }
+                    --depth;
+                } else if(c == ',' && depth == 0) {
+                    break;
+                }
+                ++at;
+            }
+
+            if(at >= raw.size()) {
+                return false;
+            }
+            auto value = raw.substr(value_begin, at - value_begin);
+            while(!value.empty() && (value.back() == ' ' || value.back() == '\t' ||
+                                     value.back() == '\n' || value.back() == '\r')) {
+                value.remove_suffix(1);
+            }
+            if(!on_field(key, value)) {
+                return true;
+            }
+            if(raw[at] == '}') {
+                return true;
+            }
+            if(raw[at] != ',') {
+                return false;
+            }
+            ++at;
+        }
+    }
+
+    /// The top-level keys of the object `raw`. nullopt when the scan cannot
+    /// vouch for them (see scan_object_fields(), or too many keys); nothing
+    /// is ruled out then.
+    static std::optional<std::span<const std::string_view>>
+        scan_object_keys(std::string_view raw,
+                         std::array<std::string_view, max_screened_keys>& storage) {
+        std::size_t count = 0;
+        bool overflow = false;
+        const bool scanned = scan_object_fields(raw, [&](std::string_view key, std::string_view) {
+            if(count == storage.size()) {
+                overflow = true;
+                return false;
+            }
+            storage[count++] = key;
+            return true;
+        });
+        if(!scanned || overflow) {
+            return std::nullopt;
+        }
+        return std::span<const std::string_view>(storage.data(), count);
+    }
+
+    /// Reuses one parser per thread for trial parses; a trial nested in
+    /// another (a variant inside an alternative) gets a parser of its own.
+    static parse_context& probe_context() noexcept {
+        thread_local parse_context context;
+        return context;
+    }
+
     template <typename Alt, typename... Ts>
     static auto deserialize_variant_candidate(simdjson::padded_string_view raw,
                                               std::variant<Ts...>& value) -> status_t {
-        Alt candidate{};
+        auto& context = probe_context();
+        if(!context.busy()) {
+            parse_context::lease lease(context);
+            Deserializer probe(context.parser(), raw);
+            return finish_variant_candidate<Alt>(probe, value);
+        }
+
         Deserializer probe(raw);
+        return finish_variant_candidate<Alt>(probe, value);
+    }
+
+    template <typename Alt, typename... Ts>
+    static auto finish_variant_candidate(Deserializer& probe, std::variant<Ts...>& value)
+        -> status_t {
         if(!probe.valid()) {
             return std::unexpected(probe.error());
         }
 
+        Alt candidate{};
         KOTA_EXPECTED_TRY(codec::deserialize(probe, candidate));
         KOTA_EXPECTED_TRY(probe.finish());
 
@@ -737,9 +1046,14 @@ private:
     }
 
     void initialize_document(simdjson::padded_string_view json) {
+        initialize_document(parser, json);
+    }
+
+    void initialize_document(simdjson::ondemand::parser& reader,
+                             simdjson::padded_string_view json) {
         input_view = json;
 
-        auto document_result = parser.iterate(json);
+        auto document_result = reader.iterate(json);
         auto err = std::move(document_result).get(document);
         if(err != simdjson::SUCCESS) {
             (void)mark_invalid(err);
@@ -759,8 +1073,10 @@ private:
     std::unexpected<error_type> mark_invalid(error_kind err = error_kind::invalid_state) {
         is_valid = false;
         error_type error(err);
-        if(auto loc = compute_location()) {
-            error.set_location(*loc);
+        if constexpr(config::error_detail<Config>) {
+            if(auto loc = compute_location()) {
+                error.set_location(*loc);
+            }
         }
         last_error = error;
         return std::unexpected(last_error);
@@ -839,6 +1155,42 @@ auto from_json(simdjson::padded_string_view json, T& value) -> std::expected<voi
     return deserializer.finish();
 }
 
+/// Parses with `context`'s parser and buffer; see parse_context.
+template <typename Config = config::default_config, typename T>
+auto from_json(parse_context& context, simdjson::padded_string_view json, T& value)
+    -> std::expected<void, error> {
+    if(context.busy()) {
+        return from_json<Config>(json, value);
+    }
+
+    parse_context::lease lease(context);
+    Deserializer<Config> deserializer(context.parser(), json);
+    if(!deserializer.valid()) {
+        return std::unexpected(deserializer.error());
+    }
+
+    KOTA_EXPECTED_TRY(codec::deserialize(deserializer, value));
+
+    return deserializer.finish();
+}
+
+template <typename Config = config::default_config, typename T>
+auto from_json(parse_context& context, std::string_view json, T& value)
+    -> std::expected<void, error> {
+    if(context.busy()) {
+        return from_json<Config>(json, value);
+    }
+    return from_json<Config>(context, context.pad(json), value);
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto from_json(parse_context& context, std::string_view json) -> std::expected<T, error> {
+    T value{};
+    KOTA_EXPECTED_TRY(from_json<Config>(context, json, value));
+    return value;
+}
+
 template <typename T, typename Config = config::default_config>
     requires std::default_initializable<T>
 auto from_json(std::string_view json) -> std::expected<T, error> {
@@ -855,6 +1207,83 @@ auto from_json(simdjson::padded_string_view json) -> std::expected<T, error> {
     return value;
 }
 
+namespace detail {
+
+template <typename Config, typename... Ts>
+auto extract_pointers(std::string_view json,
+                      const std::array<std::string_view, sizeof...(Ts)>& pointers,
+                      Ts&... values) -> std::expected<void, error> {
+    auto run = [&](Deserializer<Config>& deserializer) -> std::expected<void, error> {
+        if(!deserializer.valid()) {
+            return std::unexpected(deserializer.error());
+        }
+        std::size_t index = 0;
+        std::expected<void, error> status;
+        ((status = deserializer.deserialize_at(pointers[index++], values)) && ...);
+        return status;
+    };
+
+    auto& context = parse_context::local();
+    if(context.busy()) {
+        Deserializer<Config> deserializer(json);
+        return run(deserializer);
+    }
+
+    parse_context::lease lease(context);
+    Deserializer<Config> deserializer(context.parser(), context.pad(json));
+    return run(deserializer);
+}
+
+consteval bool valid_json_pointer(std::string_view pointer) {
+    if(!pointer.empty() && pointer.front() != '/') {
+        return false;
+    }
+    for(std::size_t i = 0; i < pointer.size(); ++i) {
+        if(pointer[i] == '~' &&
+           (i + 1 == pointer.size() || (pointer[i + 1] != '0' && pointer[i + 1] != '1'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+/// Decodes only the value at JSON Pointer `pointer` (RFC 6901), e.g.
+/// "/textDocument/uri", leaving the rest of `json` unparsed. A missing path
+/// fails with no_such_field or index_out_of_bounds.
+template <typename Config = config::default_config, typename T>
+auto extract(std::string_view json, std::string_view pointer, T& value)
+    -> std::expected<void, error> {
+    return detail::extract_pointers<Config>(json, {pointer}, value);
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto extract(std::string_view json, std::string_view pointer) -> std::expected<T, error> {
+    T value{};
+    KOTA_EXPECTED_TRY(extract<Config>(json, pointer, value));
+    return value;
+}
+
+/// Decodes the value at each of `pointers` into the matching `values` in one
+/// parse. The pointers are checked when compiled:
+///
+///     std::string uri;
+///     int version = 0;
+///     extract<"/textDocument/uri", "/textDocument/version">(json, uri, version);
+template <fixed_string... Pointers, typename... Ts>
+    requires (sizeof...(Pointers) == sizeof...(Ts) && sizeof...(Ts) > 0)
+auto extract(std::string_view json, Ts&... values) -> std::expected<void, error> {
+    static_assert((detail::valid_json_pointer(Pointers) && ...),
+                  "JSON pointers must be empty or start with '/', and '~' must be "
+                  "followed by '0' or '1'");
+    return detail::extract_pointers<config::default_config>(
+        json,
+        {std::string_view(Pointers)...},
+        values...);
+}
+
 static_assert(codec::deserializer_like<Deserializer<>>);
 
 }  // namespace kota::codec::json
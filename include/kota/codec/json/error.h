@@ -69,6 +69,7 @@ constexpr auto make_error(simdjson::error_code error) noexcept -> error_kind {
         case simdjson::IO_ERROR: return error_kind::io_error;
         case simdjson::INDEX_OUT_OF_BOUNDS: return error_kind::index_out_of_bounds;
         case simdjson::NO_SUCH_FIELD: return error_kind::no_such_field;
+        case simdjson::INVALID_JSON_POINTER: return error_kind::parse_error;
         case simdjson::TAPE_ERROR: return error_kind::tape_error;
         default: return error_kind::unknown;
     }
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KOTA_JSON_ESCAPE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define KOTA_JSON_ESCAPE_NEON 1
+#endif
+
+namespace kota::codec::json {
+
+/// Index of the first byte at or after `from` that a JSON string cannot hold
+/// as it is: '"', '\\' or a control character. text.size() if there is none.
+///
+/// Sixteen bytes are tested at a time with SSE2 or NEON, then eight with
+/// word arithmetic, so long runs of plain text, ASCII or UTF-8, are skipped
+/// without looking at each byte.
+inline auto find_escape(std::string_view text, std::size_t from = 0) noexcept -> std::size_t {
+    constexpr std::size_t chunk_size = 16;
+    std::size_t index = from;
+
+#if defined(KOTA_JSON_ESCAPE_SSE2)
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control_max = _mm_set1_epi8(0x1F);
+    for(; index + chunk_size <= text.size(); index += chunk_size) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + index));
+        // min(byte, 0x1F) == byte exactly when byte <= 0x1F, unsigned.
+        auto control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk);
+        auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                    _mm_cmpeq_epi8(chunk, backslash));
+        if(auto hits = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(control, special)))) {
+            return index + std::countr_zero(hits);
+        }
+    }
+#elif defined(KOTA_JSON_ESCAPE_NEON)
+    const auto quote = vdupq_n_u8('"');
+    const auto backslash = vdupq_n_u8('\\');
+    const auto control_end = vdupq_n_u8(0x20);
+    for(; index + chunk_size <= text.size(); index += chunk_size) {
+        auto chunk = vld1q_u8(reinterpret_cast<const std::uint8_t*>(text.data() + index));
+        auto hits = vorrq_u8(vcltq_u8(chunk, control_end),
+                             vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)));
+        if(vmaxvq_u8(hits) != 0) {
+            break;
+        }
+    }
+#endif
+
+    // Eight bytes at a time: a byte below 0x20, or one equal to '"' or '\\'
+    // after xor-ing it to zero, sets its top bit.
+    constexpr std::uint64_t ones = 0x0101010101010101ULL;
+    constexpr std::uint64_t high_bits = 0x8080808080808080ULL;
+    for(; index + sizeof(std::uint64_t) <= text.size(); index += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, text.data() + index, sizeof(word));
+        auto below = [&](std::uint64_t value, std::uint64_t limit) {
+            return (value - ones * limit) & ~value & high_bits;
+        };
+        if(below(word, 0x20) || below(word ^ (ones * '"'), 1) || below(word ^ (ones * '\\'), 1)) {
+            break;
+        }
+    }
+    for(; index < text.size(); ++index) {
+        auto byte = static_cast<unsigned char>(text[index]);
+        if(byte < 0x20 || byte == '"' || byte == '\\') {
+            return index;
+        }
+    }
+    return text.size();
+}
+
+/// The escape sequence for a byte find_escape() stopped at.
+inline auto escape_sequence(unsigned char byte, char (&storage)[6]) noexcept -> std::string_view {
+    switch(byte) {
+        case '"': return R"(\")";
+        case '\\': return R"(\\)";
+        case '\b': return R"(\b)";
+        case '\f': return R"(\f)";
+        case '\n': return R"(\n)";
+        case '\r': return R"(\r)";
+        case '\t': return R"(\t)";
+        default: {
+            constexpr std::string_view hex = "0123456789abcdef";
+            std::memcpy(storage, R"(\u00)", 4);
+            storage[4] = hex[byte >> 4];
+            storage[5] = hex[byte & 0xF];
+            return std::string_view(storage, 6);
+        }
+    }
+}
+
+/// Passes `text` escaped for the inside of a JSON string to `append`, a
+/// callable taking std::string_view, in order: the runs between escapes go
+/// out whole.
+template <typename Append>
+void escape_string(std::string_view text, Append&& append) {
+    std::size_t start = 0;
+    while(true) {
+        const auto at = find_escape(text, start);
+        if(at != start) {
+            append(text.substr(start, at - start));
+        }
+        if(at == text.size()) {
+            return;
+        }
+        char storage[6];
+        append(escape_sequence(static_cast<unsigned char>(text[at]), storage));
+        start = at + 1;
+    }
+}
+
+}  // namespace kota::codec::json
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#include "kota/support/expected_try.h"
+#include "kota/support/ranges.h"
+#include "kota/meta/compare.h"
+#include "kota/meta/hash.h"
+#include "kota/meta/struct.h"
+#include "kota/codec/codec.h"
+#include "kota/codec/config.h"
+#include "kota/codec/json/serializer.h"
+
+namespace kota::codec::json {
+
+/// The JSON of values serialized before, so a large result re-sent with
+/// only a few elements changed has only those re-encoded; the rest is
+/// copied as the text it was. Values are found by meta::hash and told
+/// apart by meta::eq, so the cache holds a copy of each value next to its
+/// text.
+///
+/// sweep() after each use drops what that use did not need, which keeps
+/// the cache to the values of the last result.
+template <typename T, typename Config = config::default_config>
+class fragment_cache {
+public:
+    /// `value` as JSON: the text kept for an equal value if there is one,
+    /// else freshly encoded and kept. The view lasts until sweep() or
+    /// clear() drops the entry.
+    auto encode(const T& value)
+        -> std::expected<std::string_view, typename Serializer<Config>::error_type> {
+        const auto key = meta::hash<T>{}(value);
+        auto [first, last] = fragments.equal_range(key);
+        for(auto it = first; it != last; ++it) {
+            if(meta::eq(it->second.value, value)) {
+                it->second.generation = generation;
+                ++hit_count;
+                return std::string_view(it->second.text);
+            }
+        }
+
+        scratch.clear();
+        KOTA_EXPECTED_TRY(codec::serialize(scratch, value));
+        KOTA_EXPECTED_TRY_V(auto text, scratch.view());
+        auto it = fragments.emplace(key, fragment{value, std::string(text), generation});
+        return std::string_view(it->second.text);
+    }
+
+    /// Drops the entries no encode() asked for since the last sweep().
+    void sweep() {
+        std::erase_if(fragments, [&](const auto& entry) {
+            return entry.second.generation != generation;
+        });
+        ++generation;
+    }
+
+    void clear() {
+        fragments.clear();
+        hit_count = 0;
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return fragments.size();
+    }
+
+    /// How many encode() calls were answered with kept text.
+    auto hits() const noexcept -> std::size_t {
+        return hit_count;
+    }
+
+private:
+    struct fragment {
+        T value;
+        std::string text;
+        std::uint64_t generation = 0;
+    };
+
+    std::unordered_multimap<std::uint64_t, fragment> fragments;
+    Serializer<Config> scratch;
+    std::uint64_t generation = 0;
+    std::size_t hit_count = 0;
+};
+
+/// A range that serializes as a JSON array of its elements' text from
+/// `cache`; see cached().
+template <typename R, typename Config>
+class cached_range {
+public:
+    using element_type = std::ranges::range_value_t<const R>;
+
+    cached_range(const R& values, fragment_cache<element_type, Config>& cache) noexcept :
+        values(&values), cache(&cache) {}
+
+    const R* values;
+    fragment_cache<element_type, Config>* cache;
+};
+
+/// `values`, to be serialized with each element's JSON taken from `cache`
+/// when it holds an equal element. It can stand anywhere a value can, as
+/// in a field of a response struct.
+template <std::ranges::input_range R, typename Config>
+auto cached(const R& values, fragment_cache<std::ranges::range_value_t<const R>, Config>& cache)
+    -> cached_range<R, Config> {
+    return cached_range<R, Config>(values, cache);
+}
+
+}  // namespace kota::codec::json
+
+namespace kota::codec {
+
+template <typename Config, typename R>
+struct serialize_traits<json::Serializer<Config>, json::cached_range<R, Config>> {
+    using value_type = typename json::Serializer<Config>::value_type;
+    using error_type = typename json::Serializer<Config>::error_type;
+
+    static auto serialize(json::Serializer<Config>& serializer,
+                          const json::cached_range<R, Config>& range)
+        -> std::expected<value_type, error_type> {
+        KOTA_EXPECTED_TRY_V(auto array, serializer.serialize_seq(std::nullopt));
+        for(const auto& element: *range.values) {
+            KOTA_EXPECTED_TRY_V(auto text, range.cache->encode(element));
+            KOTA_EXPECTED_TRY(serializer.serialize_raw_json(text));
+        }
+        return array.end();
+    }
+};
+
+}  // namespace kota::codec
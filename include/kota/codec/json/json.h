@@ -10,9 +10,14 @@
 #include "kota/codec/config.h"
 #include "kota/codec/content/deserializer.h"
 #include "kota/codec/content/dom.h"
+#include "kota/codec/content/overlay.h"
 #include "kota/codec/content/serializer.h"
+#include "kota/codec/json/array_index.h"
 #include "kota/codec/json/deserializer.h"
 #include "kota/codec/json/error.h"
+#include "kota/codec/json/fragment_cache.h"
+#include "kota/codec/json/push_parser.h"
+#include "kota/codec/json/record_stream.h"
 #include "kota/codec/json/serializer.h"
 #include "kota/codec/raw_value.h"
 
@@ -29,6 +34,8 @@ using Value = content::Value;
 using Array = content::Array;
 using Object = content::Object;
 using Document = content::Document;
+using Arena = content::Arena;
+using Overlay = content::Overlay;
 
 template <typename T>
 constexpr inline bool dom_writable_char_array_v = content::dom_writable_char_array_v<T>;
@@ -83,6 +90,25 @@ auto parse(std::string_view json) -> std::expected<T, error> {
     return from_json<T, Config>(json);
 }
 
+template <typename Config = config::default_config, typename T>
+auto parse(parse_context& context, std::string_view json, T& value) -> std::expected<void, error> {
+    return from_json<Config>(context, json, value);
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto parse(parse_context& context, std::string_view json) -> std::expected<T, error> {
+    return from_json<T, Config>(context, json);
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto parse_many(std::string_view json,
+                std::size_t batch_size = simdjson::ondemand::DEFAULT_BATCH_SIZE)
+    -> record_stream<T, Config> {
+    return from_json_many<T, Config>(json, batch_size);
+}
+
 template <typename Config = config::default_config, typename T>
 auto to_string(const T& value, std::optional<std::size_t> initial_capacity = std::nullopt)
     -> std::expected<std::string, error> {
@@ -186,7 +212,7 @@ struct serialize_traits<json::Serializer<Config>, RawValue> {
         if(value.empty()) {
             return serializer.serialize_null();
         }
-        return serializer.serialize_raw_json(value.data);
+        return serializer.serialize_raw_json(value.text());
     }
 };
 
@@ -202,9 +228,27 @@ struct deserialize_traits<json::Deserializer<Config>, RawValue> {
         if(!raw) {
             return std::unexpected(raw.error());
         }
+        value.buffer.reset();
+        value.slice = {};
         value.data.assign(raw->data(), raw->size());
         return {};
     }
 };
 
+template <typename Config>
+struct deserialize_traits<json::Deserializer<Config>, RawValueView> {
+    using error_type = typename json::Deserializer<Config>::error_type;
+
+    static auto deserialize(json::Deserializer<Config>& deserializer, RawValueView& value)
+        -> std::expected<void, error_type> {
+        auto raw = deserializer.deserialize_raw_json_view();
+        if(!raw) {
+            return std::unexpected(raw.error());
+        }
+        value.offset = static_cast<std::size_t>(raw->data() - deserializer.source().data());
+        value.length = raw->size();
+        return {};
+    }
+};
+
 }  // namespace kota::codec
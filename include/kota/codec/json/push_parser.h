@@ -0,0 +1,251 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "kota/codec/config.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/error.h"
+
+namespace kota::codec::json {
+
+/// Decodes a top-level JSON array that arrives in pieces, one element at a
+/// time, as soon as the bytes of each element are in.
+///
+/// feed() scans each piece for element boundaries, tracking only nesting
+/// and strings, and decodes every element it completes as a T. An element
+/// that lies within one piece is read straight out of it; only one split
+/// across pieces is copied aside until it is complete, so memory stays at
+/// about the size of the largest element however long the array is.
+///
+/// Elements are passed on as std::expected<T, error>: one that does not
+/// decode as a T fails alone and the array goes on, but bytes that cannot
+/// be part of an array fail the parser, and every later feed().
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+class array_push_parser {
+public:
+    using value_type = std::expected<T, error>;
+
+    /// Reads `bytes`, the next piece of the input, and calls `on_element`
+    /// with each element they complete, in order. Returns how many that was.
+    /// Whatever follows the closing bracket is left unread; later pieces may
+    /// only add whitespace.
+    template <typename F>
+        requires std::invocable<F&, value_type>
+    std::expected<std::size_t, error> feed(std::string_view bytes, F&& on_element) {
+        if(state == state_t::failed) {
+            return std::unexpected(error_kind::parse_error);
+        }
+
+        std::size_t decoded = 0;
+        std::size_t element_start = 0;
+        std::size_t i = 0;
+        while(i < bytes.size()) {
+            const char c = bytes[i];
+            switch(state) {
+                case state_t::start:
+                    if(c == '[') {
+                        state = state_t::first;
+                    } else if(!is_space(c)) {
+                        return fail();
+                    }
+                    ++i;
+                    continue;
+
+                case state_t::first:
+                case state_t::before_element:
+                    if(is_space(c)) {
+                        ++i;
+                        continue;
+                    }
+                    if(c == ']' && state == state_t::first) {
+                        state = state_t::closed;
+                        return close(i + 1, decoded);
+                    }
+                    if(c == ',' || c == ']' || c == '}' || c == ':') {
+                        return fail();
+                    }
+                    begin_element(c);
+                    element_start = i++;
+                    if(depth == 0 && !in_string && !scalar) {
+                        return fail();
+                    }
+                    continue;
+
+                case state_t::in_element: break;
+
+                case state_t::after_element:
+                    if(c == ',') {
+                        state = state_t::before_element;
+                    } else if(c == ']') {
+                        state = state_t::closed;
+                        return close(i + 1, decoded);
+                    } else if(!is_space(c)) {
+                        return fail();
+                    }
+                    ++i;
+                    continue;
+
+                case state_t::closed:
+                    if(!is_space(c)) {
+                        state = state_t::failed;
+                        return std::unexpected(error_kind::trailing_content);
+                    }
+                    ++i;
+                    continue;
+
+                case state_t::failed: return fail();
+            }
+
+            // Inside an element: find where it ends.
+            if(in_string) {
+                if(escaped) {
+                    escaped = false;
+                    ++i;
+                    continue;
+                }
+                const auto stop = bytes.find_first_of("\"\\", i);
+                if(stop == std::string_view::npos) {
+                    i = bytes.size();
+                    continue;
+                }
+                i = stop + 1;
+                if(bytes[stop] == '\\') {
+                    escaped = true;
+                } else {
+                    in_string = false;
+                    if(depth == 0) {
+                        complete(bytes.substr(element_start, i - element_start), on_element);
+                        ++decoded;
+                    }
+                }
+                continue;
+            }
+
+            if(scalar) {
+                if(is_space(c) || c == ',' || c == ']') {
+                    // The delimiter is read again as the one after the element.
+                    complete(bytes.substr(element_start, i - element_start), on_element);
+                    ++decoded;
+                } else {
+                    ++i;
+                }
+                continue;
+            }
+
+            ++i;
+            if(c == '"') {
+                in_string = true;
+            } else if(c == '{' || c == '[') {
+                ++depth;
+            } else if(c == '}' || c == ']') {
+                if(--depth == 0) {
+                    complete(bytes.substr(element_start, i - element_start), on_element);
+                    ++decoded;
+                }
+            }
+        }
+
+        if(state == state_t::in_element) {
+            pending.append(bytes.substr(element_start));
+        }
+        read += bytes.size();
+        return decoded;
+    }
+
+    /// Whether the closing bracket has been read.
+    bool done() const noexcept {
+        return state == state_t::closed;
+    }
+
+    /// Call at the end of the input: fails unless the array was closed.
+    std::expected<void, error> finish() const {
+        if(state != state_t::closed) {
+            return std::unexpected(error_kind::parse_error);
+        }
+        return {};
+    }
+
+    /// Bytes of the input read so far. feed() stops right after the closing
+    /// bracket, so this tells where whatever follows the array begins.
+    std::size_t offset() const noexcept {
+        return read;
+    }
+
+    /// Bytes held back for an element whose end has not arrived yet.
+    std::size_t buffered() const noexcept {
+        return pending.size();
+    }
+
+private:
+    enum class state_t : std::uint8_t {
+        start,
+        first,
+        before_element,
+        in_element,
+        after_element,
+        closed,
+        failed,
+    };
+
+    static bool is_space(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void begin_element(char c) noexcept {
+        state = state_t::in_element;
+        depth = c == '{' || c == '[' ? 1 : 0;
+        in_string = c == '"';
+        escaped = false;
+        scalar = c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n';
+    }
+
+    std::size_t close(std::size_t end, std::size_t decoded) noexcept {
+        read += end;
+        return decoded;
+    }
+
+    std::unexpected<error> fail() {
+        state = state_t::failed;
+        pending.clear();
+        return std::unexpected(error(error_kind::parse_error));
+    }
+
+    /// Decodes the element ending with `tail`, the part of it in the current
+    /// piece.
+    template <typename F>
+    void complete(std::string_view tail, F& on_element) {
+        std::string_view text = tail;
+        if(!pending.empty()) {
+            pending.append(tail);
+            text = pending;
+        }
+
+        T value{};
+        auto status = from_json<Config>(parse_context::local(), text, value);
+        pending.clear();
+        state = state_t::after_element;
+
+        if(status) {
+            on_element(value_type(std::move(value)));
+        } else {
+            on_element(value_type(std::unexpected(status.error())));
+        }
+    }
+
+    std::string pending;
+    std::size_t read = 0;
+    state_t state = state_t::start;
+    std::uint32_t depth = 0;
+    bool in_string = false;
+    bool escaped = false;
+    bool scalar = false;
+};
+
+}  // namespace kota::codec::json
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#include "kota/codec/config.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/error.h"
+
+namespace kota::codec::json {
+
+/// A lazy range over a buffer holding many JSON documents one after another,
+/// as in newline-delimited JSON, each decoded as a T when reached.
+///
+/// Document boundaries come from simdjson's iterate_many, which indexes the
+/// buffer one batch at a time, so memory stays at about `batch_size` however
+/// long the buffer is. A batch must be larger than the largest document.
+///
+/// Dereferencing yields std::expected<T, error>: a record that does not
+/// decode as a T fails alone and iteration goes on, but a malformed stream
+/// ends the range after reporting it. iterator::source() is the record's
+/// own text, which lets callers hand batches of records to other threads and
+/// decode them there.
+///
+/// A padded_string_view buffer is read in place and has to outlive the
+/// stream; a plain string_view is copied first.
+template <typename T, typename Config = config::default_config>
+class record_stream {
+public:
+    using value_type = std::expected<T, error>;
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = record_stream::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        value_type& operator*() {
+            if(!current.has_value()) {
+                current.emplace(owner->decode(position));
+            }
+            return *current;
+        }
+
+        iterator& operator++() {
+            if(stopped()) {
+                owner = nullptr;
+                return *this;
+            }
+            current.reset();
+            ++position;
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        /// The current record's text, without the whitespace around it.
+        std::string_view source() const noexcept {
+            return position.source();
+        }
+
+        /// Byte offset of the current record in the buffer.
+        std::size_t offset() const noexcept {
+            return position.current_index();
+        }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return it.owner == nullptr || !(it.position != it.last);
+        }
+
+    private:
+        friend class record_stream;
+
+        iterator(record_stream* owner,
+                 simdjson::ondemand::document_stream::iterator position,
+                 simdjson::ondemand::document_stream::iterator last) :
+            owner(owner), position(position), last(last) {}
+
+        // A stream error leaves simdjson unable to find the next document.
+        bool stopped() const noexcept {
+            return position.error() != simdjson::SUCCESS;
+        }
+
+        record_stream* owner = nullptr;
+        simdjson::ondemand::document_stream::iterator position{};
+        simdjson::ondemand::document_stream::iterator last{};
+        std::optional<value_type> current;
+    };
+
+    /// Copies `json` into a padded buffer the range owns.
+    explicit record_stream(std::string_view json,
+                           std::size_t batch_size = simdjson::ondemand::DEFAULT_BATCH_SIZE) :
+        owned(json) {
+        start(static_cast<simdjson::padded_string_view>(owned), batch_size);
+    }
+
+    explicit record_stream(simdjson::padded_string_view json,
+                           std::size_t batch_size = simdjson::ondemand::DEFAULT_BATCH_SIZE) {
+        start(json, batch_size);
+    }
+
+    // simdjson's stream points back at the parser, so the range stays put.
+    record_stream(const record_stream&) = delete;
+    record_stream& operator=(const record_stream&) = delete;
+
+    /// Set when the buffer could not be opened as a stream at all; the range
+    /// is then empty.
+    std::optional<error> status() const noexcept {
+        return failure;
+    }
+
+    iterator begin() {
+        if(failure.has_value()) {
+            return iterator();
+        }
+        return iterator(this, stream.begin(), stream.end());
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+private:
+    void start(simdjson::padded_string_view json, std::size_t batch_size) {
+        input = json;
+        auto err = stream_parser.iterate_many(json.data(), json.size(), batch_size).get(stream);
+        if(err != simdjson::SUCCESS) {
+            failure.emplace(make_error(err));
+        }
+    }
+
+    value_type decode(simdjson::ondemand::document_stream::iterator& position) {
+        // The stream cannot go past a document it failed to delimit.
+        if(auto err = position.error(); err != simdjson::SUCCESS) {
+            return std::unexpected(error(make_error(err)));
+        }
+
+        // Each record is re-read by a second parser, straight out of the
+        // buffer: its view runs on to the end of the buffer's padding.
+        auto text = position.source();
+        const auto offset = static_cast<std::size_t>(text.data() - input.data());
+        simdjson::padded_string_view padded(text.data(),
+                                            text.size(),
+                                            input.capacity() - offset);
+
+        T value{};
+        Deserializer<Config> deserializer(record_parser, padded);
+        if(!deserializer.valid()) {
+            return std::unexpected(deserializer.error());
+        }
+        KOTA_EXPECTED_TRY(codec::deserialize(deserializer, value));
+        KOTA_EXPECTED_TRY(deserializer.finish());
+        return value;
+    }
+
+    simdjson::padded_string owned;
+    simdjson::padded_string_view input{};
+    simdjson::ondemand::parser stream_parser;
+    simdjson::ondemand::parser record_parser;
+    simdjson::ondemand::document_stream stream;
+    std::optional<error> failure;
+};
+
+/// Decodes each of the documents in `json` as a T, lazily; see record_stream.
+///
+///     for(auto& record: from_json_many<Entry>(contents)) { ... }
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto from_json_many(std::string_view json,
+                    std::size_t batch_size = simdjson::ondemand::DEFAULT_BATCH_SIZE)
+    -> record_stream<T, Config> {
+    return record_stream<T, Config>(json, batch_size);
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto from_json_many(simdjson::padded_string_view json,
+                    std::size_t batch_size = simdjson::ondemand::DEFAULT_BATCH_SIZE)
+    -> record_stream<T, Config> {
+    return record_stream<T, Config>(json, batch_size);
+}
+
+}  // namespace kota::codec::json
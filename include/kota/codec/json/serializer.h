@@ -1,23 +1,89 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <functional>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "kota/support/expected_try.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
 #include "kota/codec/detail/backend_helpers.h"
+#include "kota/codec/detail/number_format.h"
 #include "kota/codec/json/error.h"
+#include "kota/codec/json/escape.h"
 
 namespace kota::codec::json {
 
+namespace detail {
+
+/// The text around the values of a fixed_shape_struct T, built at compile
+/// time: `{"line":`, `,"character":`, and last the closing `}`. Only
+/// names that need no escape qualify, which field names always do in
+/// practice.
+template <typename T, typename Config>
+struct fixed_struct_keys {
+    constexpr static auto& names = codec::detail::fixed_field_names<T, Config>;
+
+    constexpr static bool plain = [] {
+        for(auto name: names) {
+            for(char c: name) {
+                if(static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\') {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }();
+
+    constexpr static std::size_t text_size = [] {
+        std::size_t size = 1;
+        for(auto name: names) {
+            size += name.size() + 4;
+        }
+        return size;
+    }();
+
+    constexpr static auto text = [] {
+        std::array<char, text_size> out{};
+        std::size_t pos = 0;
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            out[pos++] = i == 0 ? '{' : ',';
+            out[pos++] = '"';
+            for(char c: names[i]) {
+                out[pos++] = c;
+            }
+            out[pos++] = '"';
+            out[pos++] = ':';
+        }
+        out[pos] = '}';
+        return out;
+    }();
+
+    /// fragments[i] goes before the value of field i; the last one closes
+    /// the object.
+    constexpr static auto fragments = [] {
+        std::array<std::string_view, names.size() + 1> out{};
+        std::size_t pos = 0;
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            out[i] = std::string_view(text.data() + pos, names[i].size() + 4);
+            pos += names[i].size() + 4;
+        }
+        out[names.size()] = std::string_view(text.data() + pos, 1);
+        return out;
+    }();
+};
+
+}  // namespace detail
+
 template <typename Config = config::default_config>
 class Serializer {
 public:
@@ -38,15 +104,42 @@ public:
     using SerializeMap = SerializeObject;
     using SerializeStruct = SerializeObject;
 
+    /// Receives the output of a streaming serializer a chunk at a time, in
+    /// order. Returning false stops serialization with write_failed.
+    using sink_type = std::function<bool(std::string_view)>;
+
+    constexpr static std::size_t default_chunk_size = 64 * 1024;
+
     Serializer() = default;
 
     explicit Serializer(std::size_t initial_capacity) : builder(initial_capacity) {}
 
+    /// A streaming serializer: whenever `chunk_size` bytes are buffered they
+    /// go to `sink` before the next value is written, so the whole document
+    /// is never held in memory. Call finish() once the value is written.
+    explicit Serializer(sink_type sink, std::size_t chunk_size = default_chunk_size) :
+        builder(chunk_size + chunk_size / 4), sink(std::move(sink)), chunk_size(chunk_size) {}
+
+    /// Hands what is still buffered to the sink; streaming serializers only.
+    status_t finish() {
+        if(!sink) {
+            mark_invalid();
+            return status();
+        }
+        if(is_valid && (!stack.empty() || !root_written)) {
+            mark_invalid();
+        }
+        flush();
+        return status();
+    }
+
+    /// The document written; not available from a streaming serializer,
+    /// which has handed most of it to the sink already.
     result_t<std::string_view> view() const {
         if(!is_valid) {
             return std::unexpected(last_error);
         }
-        if(!stack.empty() || !root_written) {
+        if(!stack.empty() || !root_written || sink) {
             return std::unexpected(error_kind::invalid_state);
         }
 
@@ -63,6 +156,8 @@ public:
         return std::string(out);
     }
 
+    /// Empties the output, keeping its capacity, so one serializer can be
+    /// reused across values.
     void clear() {
         builder.clear();
         stack.clear();
@@ -109,7 +204,8 @@ public:
             return status();
         }
 
-        builder.append(value);
+        char text[codec::detail::max_integer_chars];
+        builder.append_raw(std::string_view(text, codec::detail::format_int(value, text)));
         return status();
     }
 
@@ -118,7 +214,8 @@ public:
             return status();
         }
 
-        builder.append(value);
+        char text[codec::detail::max_integer_chars];
+        builder.append_raw(std::string_view(text, codec::detail::format_uint(value, text)));
         return status();
     }
 
@@ -128,7 +225,9 @@ public:
         }
 
         if(std::isfinite(value)) {
-            builder.append(value);
+            char text[codec::detail::max_float_chars];
+            auto* end = codec::detail::format_float<config_type>(value, text);
+            builder.append_raw(std::string_view(text, end));
         } else {
             builder.append_null();
         }
@@ -141,7 +240,7 @@ public:
         }
 
         const char text[1] = {value};
-        builder.escape_and_append_with_quotes(std::string_view(text, 1));
+        append_quoted(std::string_view(text, 1));
         return status();
     }
 
@@ -150,7 +249,7 @@ public:
             return status();
         }
 
-        builder.escape_and_append_with_quotes(value);
+        append_quoted(value);
         return status();
     }
 
@@ -184,6 +283,37 @@ public:
         return seq.end();
     }
 
+    /// Writes a contiguous run of unsigned numbers, such as semantic token
+    /// data, as one array. The numbers are formatted into a local block and
+    /// appended a block at a time, skipping the per-element state checks.
+    template <uint_like T>
+    result_t<value_type> serialize_uint_array(std::span<const T> values) {
+        if(!before_value()) {
+            return status();
+        }
+
+        constexpr std::size_t block_size = 1024;
+        char block[block_size];
+        std::size_t used = 0;
+        block[used++] = '[';
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            if(block_size - used <= codec::detail::max_integer_chars + 1) {
+                builder.append_raw(std::string_view(block, used));
+                used = 0;
+                flush_if_full();
+            }
+            if(i != 0) {
+                block[used++] = ',';
+            }
+            auto* end = codec::detail::format_uint(static_cast<std::uint64_t>(values[i]),
+                                                   block + used);
+            used = static_cast<std::size_t>(end - block);
+        }
+        block[used++] = ']';
+        builder.append_raw(std::string_view(block, used));
+        return status();
+    }
+
     result_t<SerializeSeq> serialize_seq(std::optional<std::size_t> /*len*/) {
         KOTA_EXPECTED_TRY(begin_array());
         return SerializeSeq(*this);
@@ -204,6 +334,39 @@ public:
         return SerializeStruct(*this);
     }
 
+    /// Writes a struct whose keys never change, see fixed_shape_struct: the
+    /// text between its values is copied from fixed_struct_keys in one
+    /// piece each, with no per-key escaping, comma or colon bookkeeping.
+    /// `FieldConfig` is the config its field names are renamed under.
+    template <typename FieldConfig, typename T>
+        requires codec::detail::fixed_shape_struct<T, FieldConfig> &&
+                 detail::fixed_struct_keys<T, FieldConfig>::plain
+    result_t<value_type> serialize_fixed_struct(const T& value) {
+        constexpr auto& fragments = detail::fixed_struct_keys<T, FieldConfig>::fragments;
+        if(!before_value()) {
+            return status();
+        }
+
+        // The frame lets nested values place themselves as object members.
+        stack.push_back(container_frame{container_kind::object, false, true});
+        std::size_t index = 0;
+        status_t field_status;
+        meta::for_each(value, [&](auto field) {
+            flush_if_full();
+            builder.append_raw(fragments[index++]);
+            stack.back().expect_key = false;
+            field_status = codec::serialize(*this, field.value());
+            return field_status.has_value();
+        });
+        if(!field_status) {
+            return field_status;
+        }
+
+        builder.append_raw(fragments.back());
+        stack.pop_back();
+        return status();
+    }
+
 private:
     friend class codec::detail::SerializeArray<Serializer<Config>>;
     friend class codec::detail::SerializeObject<Serializer<Config>>;
@@ -274,6 +437,7 @@ private:
             mark_invalid();
             return std::unexpected(last_error);
         }
+        flush_if_full();
 
         auto& frame = stack.back();
         if(frame.kind != container_kind::object || !frame.expect_key) {
@@ -286,7 +450,7 @@ private:
         }
         frame.first = false;
 
-        builder.escape_and_append_with_quotes(key_name);
+        append_quoted(key_name);
         builder.append_colon();
         frame.expect_key = false;
         return status();
@@ -302,6 +466,7 @@ private:
     }
 
     bool before_value() {
+        flush_if_full();
         if(!is_valid) {
             return false;
         }
@@ -334,6 +499,38 @@ private:
         return true;
     }
 
+    /// Writes `text` as a JSON string, copying the runs that need no escape
+    /// in one piece; see find_escape().
+    void append_quoted(std::string_view text) {
+        builder.append_raw(std::string_view("\""));
+        escape_string(text, [&](std::string_view part) { builder.append_raw(part); });
+        builder.append_raw(std::string_view("\""));
+    }
+
+    void flush_if_full() {
+        if(sink && builder.size() >= chunk_size) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if(!is_valid || builder.size() == 0) {
+            return;
+        }
+
+        std::string_view out{};
+        auto err = builder.view().get(out);
+        if(err != simdjson::SUCCESS) {
+            mark_invalid(json::make_error(err));
+            return;
+        }
+        if(!sink(out)) {
+            mark_invalid(error_kind::write_failed);
+            return;
+        }
+        builder.clear();
+    }
+
     void mark_invalid(error_kind error = error_kind::invalid_state) {
         is_valid = false;
         if(last_error == error_kind::ok) {
@@ -354,6 +551,8 @@ private:
     error_type last_error = error_kind::ok;
     std::vector<container_frame> stack;
     simdjson::builder::string_builder builder;
+    sink_type sink;
+    std::size_t chunk_size = 0;
 };
 
 template <typename Config = config::default_config, typename T>
@@ -365,6 +564,31 @@ auto to_json(const T& value, std::optional<std::size_t> initial_capacity = std::
     return serializer.str();
 }
 
+/// Appends `value` to `out` through a serializer kept per thread, so once
+/// both buffers have grown no value allocates. `out` is left untouched when
+/// serialization fails.
+template <typename Config = config::default_config, typename T>
+auto to_json_into(std::string& out, const T& value) -> std::expected<void, error> {
+    thread_local Serializer<Config> serializer;
+    serializer.clear();
+    KOTA_EXPECTED_TRY(codec::serialize(serializer, value));
+    KOTA_EXPECTED_TRY_V(auto text, serializer.view());
+    out.append(text);
+    return {};
+}
+
+/// Serializes `value` to `sink` in chunks of about `chunk_size` bytes,
+/// without building the whole document; see Serializer::sink_type.
+template <typename Config = config::default_config, typename T>
+auto to_json(const T& value,
+             typename Serializer<Config>::sink_type sink,
+             std::size_t chunk_size = Serializer<Config>::default_chunk_size)
+    -> std::expected<void, error> {
+    Serializer<Config> serializer(std::move(sink), chunk_size);
+    KOTA_EXPECTED_TRY(codec::serialize(serializer, value));
+    return serializer.finish();
+}
+
 static_assert(codec::serializer_like<Serializer<>>);
 
 }  // namespace kota::codec::json
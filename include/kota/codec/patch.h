@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "kota/support/expected_try.h"
+#include "kota/meta/diff.h"
+#include "kota/codec/detail/fwd.h"
+
+namespace kota::codec {
+
+/// A value to update in place from a serialized meta::patch. Deserializing
+/// into it applies each operation as it is read, so the changed values go
+/// straight into the target. The target must equal the snapshot the patch
+/// was made from.
+template <typename T>
+class patch_target {
+public:
+    explicit constexpr patch_target(T& value) noexcept : value(&value) {}
+
+    T* value;
+};
+
+namespace detail {
+
+/// One operation of a serialized patch with the values it sets, written
+/// as the tuple [kind, path, start, remove, value]. A replace's value is
+/// the new value at the path; a splice's is the array of inserted
+/// elements.
+template <typename T>
+class patch_entry {
+public:
+    constexpr patch_entry(const T& source, const meta::patch_op& op) noexcept :
+        source(&source), op(&op) {}
+
+    const T* source;
+    const meta::patch_op* op;
+};
+
+template <typename T>
+class patch_entry_out {
+public:
+    explicit constexpr patch_entry_out(T& target) noexcept : target(&target) {}
+
+    T* target;
+};
+
+/// The elements a splice inserts, as a plain range: a subrange would be
+/// written as a tuple.
+template <typename Iterator>
+struct patch_elements {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const {
+        return first;
+    }
+
+    Iterator end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(last - first);
+    }
+};
+
+}  // namespace detail
+
+template <typename S, typename T>
+struct serialize_traits<S, meta::patch<T>> {
+    using value_type = typename S::value_type;
+    using error_type = typename S::error_type;
+
+    static auto serialize(S& serializer, const meta::patch<T>& changes)
+        -> std::expected<value_type, error_type> {
+        KOTA_EXPECTED_TRY_V(auto seq, serializer.serialize_seq(changes.ops.size()));
+        for(const auto& op: changes.ops) {
+            KOTA_EXPECTED_TRY(seq.serialize_element(detail::patch_entry<T>(*changes.source, op)));
+        }
+        return seq.end();
+    }
+};
+
+template <typename S, typename T>
+struct serialize_traits<S, detail::patch_entry<T>> {
+    using value_type = typename S::value_type;
+    using error_type = typename S::error_type;
+
+    static auto serialize(S& serializer, const detail::patch_entry<T>& entry)
+        -> std::expected<value_type, error_type> {
+        const auto& op = *entry.op;
+        KOTA_EXPECTED_TRY_V(auto tuple, serializer.serialize_tuple(5));
+        KOTA_EXPECTED_TRY(tuple.serialize_element(static_cast<std::uint8_t>(op.kind)));
+        KOTA_EXPECTED_TRY(tuple.serialize_element(op.path));
+        KOTA_EXPECTED_TRY(tuple.serialize_element(static_cast<std::uint64_t>(op.start)));
+        KOTA_EXPECTED_TRY(tuple.serialize_element(static_cast<std::uint64_t>(op.remove)));
+
+        std::expected<void, error_type> status = std::unexpected(error_type::invalid_state);
+        auto write_value = [&](const auto& value) {
+            if(op.kind == meta::patch_kind::replace) {
+                status = tuple.serialize_element(value);
+                return;
+            }
+            if constexpr(!std::is_null_pointer_v<decltype(meta::detail::splice_target(value))>) {
+                const auto* sequence = meta::detail::splice_target(value);
+                if(sequence && op.start <= std::ranges::size(*sequence) &&
+                   op.insert <= std::ranges::size(*sequence) - op.start) {
+                    auto first =
+                        std::ranges::begin(*sequence) + static_cast<std::ptrdiff_t>(op.start);
+                    auto last = first + static_cast<std::ptrdiff_t>(op.insert);
+                    status = tuple.serialize_element(detail::patch_elements{first, last});
+                }
+            }
+        };
+        meta::detail::visit_patch_path(std::span(op.indices), write_value, *entry.source);
+        KOTA_EXPECTED_TRY(status);
+        return tuple.end();
+    }
+};
+
+template <typename D, typename T>
+struct deserialize_traits<D, patch_target<T>> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, patch_target<T>& target)
+        -> std::expected<void, error_type> {
+        KOTA_EXPECTED_TRY_V(auto seq, deserializer.deserialize_seq(std::nullopt));
+        detail::patch_entry_out<T> entry(*target.value);
+        while(true) {
+            KOTA_EXPECTED_TRY_V(auto has_next, seq.has_next());
+            if(!has_next) {
+                break;
+            }
+            KOTA_EXPECTED_TRY(seq.deserialize_element(entry));
+        }
+        return seq.end();
+    }
+};
+
+template <typename D, typename T>
+struct deserialize_traits<D, detail::patch_entry_out<T>> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, detail::patch_entry_out<T>& entry)
+        -> std::expected<void, error_type> {
+        KOTA_EXPECTED_TRY_V(auto tuple, deserializer.deserialize_tuple(5));
+        std::uint8_t kind = 0;
+        std::string path;
+        std::uint64_t start = 0;
+        std::uint64_t remove = 0;
+        KOTA_EXPECTED_TRY(tuple.deserialize_element(kind));
+        KOTA_EXPECTED_TRY(tuple.deserialize_element(path));
+        KOTA_EXPECTED_TRY(tuple.deserialize_element(start));
+        KOTA_EXPECTED_TRY(tuple.deserialize_element(remove));
+
+        std::optional<std::expected<void, error_type>> status;
+        auto read_value = [&](auto& value) {
+            if(kind == static_cast<std::uint8_t>(meta::patch_kind::replace)) {
+                status = tuple.deserialize_element(value);
+                return;
+            }
+            if constexpr(!std::is_null_pointer_v<decltype(meta::detail::splice_target(value))>) {
+                auto* sequence = meta::detail::splice_target(value);
+                if(!sequence) {
+                    return;
+                }
+                using sequence_t = std::remove_cvref_t<decltype(*sequence)>;
+                using element_t = std::ranges::range_value_t<sequence_t>;
+                std::vector<element_t> inserted;
+                status = tuple.deserialize_element(inserted);
+                if(!*status) {
+                    return;
+                }
+                auto moved = std::ranges::subrange(std::make_move_iterator(inserted.begin()),
+                                                   std::make_move_iterator(inserted.end()));
+                if(!meta::detail::splice_sequence(*sequence,
+                                                  static_cast<std::size_t>(start),
+                                                  static_cast<std::size_t>(remove),
+                                                  moved)) {
+                    status = std::unexpected(error_type::custom(
+                        std::format("patch splice at '{}' is out of range", path)));
+                }
+            }
+        };
+
+        using config_t = typename D::config_type;
+        if(!meta::detail::visit_patch_text<config_t>(*entry.target, path, read_value) || !status) {
+            return std::unexpected(
+                error_type::custom(std::format("patch path '{}' does not exist", path)));
+        }
+        KOTA_EXPECTED_TRY(*status);
+        return tuple.end();
+    }
+};
+
+}  // namespace kota::codec
@@ -1,13 +1,69 @@
 #pragma once
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace kota::codec {
 
+/// A value's encoded text, kept as is. It is either owned, in `data`, or a
+/// slice of an immutable buffer that copies of the value, and whatever else
+/// holds the buffer, share; a forwarded or broadcast value then costs no
+/// copy of its text. Serializers write text(), whichever form it is in.
 struct RawValue {
     std::string data;
 
+    /// Set for a shared value, whose text is `slice`, inside `*buffer`;
+    /// `data` is then unused.
+    std::shared_ptr<const std::string> buffer;
+    std::string_view slice;
+
+    /// A value whose text is `text`, which lies within `*buffer`, e.g. the
+    /// message it arrived in.
+    static RawValue shared(std::shared_ptr<const std::string> buffer,
+                           std::string_view text) noexcept {
+        RawValue value;
+        value.buffer = std::move(buffer);
+        value.slice = text;
+        return value;
+    }
+
+    /// Moves owned text into a buffer of its own, so that copies made from
+    /// now on share it. Does nothing to a value that is already shared.
+    void share() {
+        if(buffer) {
+            return;
+        }
+        buffer = std::make_shared<const std::string>(std::move(data));
+        slice = *buffer;
+        data.clear();
+    }
+
+    std::string_view text() const noexcept {
+        return buffer ? slice : std::string_view(data);
+    }
+
     bool empty() const noexcept {
-        return data.empty();
+        return text().empty();
+    }
+};
+
+/// Borrowed form of RawValue: where the value's encoded text sits in the
+/// document it was deserialized from, instead of a copy of it. Deserializers
+/// may read from an internal copy of their input, so the position is kept
+/// rather than a pointer; in() resolves it against the caller's document.
+struct RawValueView {
+    std::size_t offset = 0;
+    std::size_t length = 0;
+
+    bool empty() const noexcept {
+        return length == 0;
+    }
+
+    /// The value's text within `document`, the input it was read from.
+    std::string_view in(std::string_view document) const noexcept {
+        return document.substr(offset, length);
     }
 };
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <charconv>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -11,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "kota/support/fixed_string.h"
 #include "kota/support/naming.h"
 #include "kota/support/type_traits.h"
 #include "kota/meta/enum.h"
@@ -88,10 +92,71 @@ std::string apply_rename_policy(bool is_serialize, std::string_view value) {
     }
 }
 
+/// True if Policy renames in a constant expression, as the built-in
+/// policies do. Names it renames are then fixed at compile time.
+template <typename Policy>
+concept constexpr_rename_policy = requires {
+    typename std::integral_constant<std::size_t,
+                                    Policy{}(true, std::string_view("a_b")).size()>;
+};
+
+namespace detail {
+
+template <typename Policy, fixed_string Name>
+constexpr inline auto static_rename_storage = [] {
+    constexpr auto size = Policy{}(true, std::string_view(Name)).size();
+    std::array<char, size + 1> out{};
+    std::ranges::copy(Policy{}(true, std::string_view(Name)), out.begin());
+    return out;
+}();
+
+}  // namespace detail
+
+/// `Name` as Policy renames it for serialization, as a static string.
+template <typename Policy, fixed_string Name>
+    requires constexpr_rename_policy<Policy>
+constexpr inline std::string_view static_rename{
+    detail::static_rename_storage<Policy, Name>.data(),
+    detail::static_rename_storage<Policy, Name>.size() - 1};
+
+/// The serialized names of the enumerators of E under Policy, in
+/// meta::reflection<E>::member_values order.
+template <typename E, typename Policy>
+    requires constexpr_rename_policy<Policy>
+constexpr inline auto static_enum_names = []<std::size_t... Is>(std::index_sequence<Is...>) {
+    constexpr auto& names = meta::reflection<E>::member_names;
+    return std::array<std::string_view, sizeof...(Is)>{
+        static_rename<Policy, fixed_string<names[Is].size()>(names[Is].data())>...};
+}(std::make_index_sequence<meta::reflection<E>::member_count>{});
+
+/// Perfect hash of static_enum_names<E, Policy>.
+template <typename E, typename Policy>
+    requires constexpr_rename_policy<Policy>
+constexpr inline auto static_enum_names_index =
+    meta::detail::enum_name_index<meta::reflection<E>::member_count>(static_enum_names<E, Policy>);
+
+/// The serialized name of `value`, static when Policy is constexpr and
+/// otherwise renamed into `scratch`. Empty for values that are not an
+/// enumerator.
+template <typename E, typename Policy = rename_policy::lower_camel>
+std::string_view map_enum_to_string_view(E value, std::string& scratch) {
+    static_assert(std::is_enum_v<E>, "map_enum_to_string_view requires an enum type");
+    if constexpr(constexpr_rename_policy<Policy>) {
+        if(auto index = meta::enum_index(value)) {
+            return static_enum_names<E, Policy>[*index];
+        }
+        return {};
+    } else {
+        scratch = apply_rename_policy<Policy>(true, meta::enum_name(value));
+        return scratch;
+    }
+}
+
 template <typename E, typename Policy = rename_policy::lower_camel>
 std::string map_enum_to_string(E value) {
     static_assert(std::is_enum_v<E>, "map_enum_to_string requires an enum type");
-    return apply_rename_policy<Policy>(true, meta::enum_name(value));
+    std::string scratch;
+    return std::string(map_enum_to_string_view<E, Policy>(value, scratch));
 }
 
 template <typename E, typename Policy = rename_policy::lower_camel>
@@ -111,6 +176,13 @@ auto enum_strings() -> const std::vector<std::string>& {
 template <typename E, typename Policy = rename_policy::lower_camel>
 constexpr std::optional<E> map_string_to_enum(std::string_view value) {
     static_assert(std::is_enum_v<E>, "map_string_to_enum requires an enum type");
+    // Text spelled the way this policy serializes needs no conversion.
+    if constexpr(constexpr_rename_policy<Policy>) {
+        if(auto index = static_enum_names_index<E, Policy>.find(value)) {
+            return meta::reflection<E>::member_values[*index];
+        }
+    }
+
     auto mapped = apply_rename_policy<Policy>(false, value);
     auto try_parse = [](std::string_view candidate) -> std::optional<E> {
         if(auto parsed = meta::enum_value<E>(candidate)) {
@@ -156,6 +228,52 @@ constexpr std::optional<E> map_string_to_enum(std::string_view value) {
     return std::nullopt;
 }
 
+/// The serialized names of the flags of E under Policy, in
+/// meta::flag_reflection<E>::member_bits order.
+template <typename E, typename Policy>
+    requires constexpr_rename_policy<Policy>
+constexpr inline auto static_enum_flag_names = []<std::size_t... Is>(std::index_sequence<Is...>) {
+    constexpr auto& names = meta::flag_reflection<E>::member_names;
+    return std::array<std::string_view, sizeof...(Is)>{
+        static_rename<Policy, fixed_string<names[Is].size()>(names[Is].data())>...};
+}(std::make_index_sequence<meta::flag_reflection<E>::member_count>{});
+
+/// Perfect hash of static_enum_flag_names<E, Policy>.
+template <typename E, typename Policy>
+    requires constexpr_rename_policy<Policy>
+constexpr inline auto static_enum_flag_names_index =
+    meta::detail::enum_name_index<meta::flag_reflection<E>::member_count>(
+        static_enum_flag_names<E, Policy>);
+
+/// The serialized name of flag `index` of meta::flag_reflection<E>, static
+/// when Policy is constexpr and otherwise renamed into `scratch`.
+template <meta::flag_enum E, typename Policy = rename_policy::lower_camel>
+std::string_view map_enum_flag_to_string_view(std::size_t index, std::string& scratch) {
+    if constexpr(constexpr_rename_policy<Policy>) {
+        return static_enum_flag_names<E, Policy>[index];
+    } else {
+        scratch = apply_rename_policy<Policy>(true, meta::flag_reflection<E>::member_names[index]);
+        return scratch;
+    }
+}
+
+/// The single flag of E that serializes as `value` under Policy.
+template <meta::flag_enum E, typename Policy = rename_policy::lower_camel>
+constexpr std::optional<E> map_string_to_enum_flag(std::string_view value) {
+    using reflect = meta::flag_reflection<E>;
+    if constexpr(constexpr_rename_policy<Policy>) {
+        if(auto index = static_enum_flag_names_index<E, Policy>.find(value)) {
+            return static_cast<E>(reflect::member_bits[*index]);
+        }
+    }
+
+    auto mapped = apply_rename_policy<Policy>(false, value);
+    if(auto parsed = meta::enum_flag_value<E>(mapped)) {
+        return parsed;
+    }
+    return meta::enum_flag_value<E>(naming::snake_to_camel(mapped, true));
+}
+
 template <typename Key>
 std::string map_key_to_string(const Key& key) {
     using key_t = std::remove_cvref_t<Key>;
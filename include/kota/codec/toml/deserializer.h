@@ -74,6 +74,11 @@ auto select_root_node(const ::toml::table& table) -> const ::toml::node* {
     }
 }
 
+template <typename T>
+auto select_root_node(::toml::table& table) -> ::toml::node* {
+    return const_cast<::toml::node*>(select_root_node<T>(std::as_const(table)));
+}
+
 }  // namespace detail
 
 template <typename Config = config::default_config>
@@ -119,6 +124,15 @@ public:
 
     explicit Deserializer(const ::toml::node* root) : root_node(root) {}
 
+    /// Reads out of `root`, which the caller is done with: strings and
+    /// captured tables and arrays are moved into the value instead of
+    /// copied, leaving `root` valid but unspecified.
+    static auto consuming(::toml::node* root) -> Deserializer {
+        Deserializer deserializer(static_cast<const ::toml::node*>(root));
+        deserializer.take_values = true;
+        return deserializer;
+    }
+
     [[nodiscard]] bool valid() const noexcept {
         return is_valid;
     }
@@ -258,20 +272,10 @@ public:
     }
 
     status_t deserialize_char(char& value) {
-        std::string text;
-        auto status = read_scalar(text, [](const ::toml::node& node) -> result_t<std::string> {
-            auto parsed = node.value<std::string>();
-            if(!parsed.has_value()) {
-                return std::unexpected(error_kind::type_mismatch);
-            }
-            return std::move(*parsed);
-        });
-        if(!status) {
-            return std::unexpected(status.error());
-        }
+        KOTA_EXPECTED_TRY_V(auto text, open_string());
 
         auto narrowed =
-            codec::detail::narrow_char(std::string_view(text), error_kind::type_mismatch);
+            codec::detail::narrow_char(std::string_view(text->get()), error_kind::type_mismatch);
         if(!narrowed) {
             return mark_invalid(narrowed.error());
         }
@@ -281,13 +285,14 @@ public:
     }
 
     status_t deserialize_str(std::string& value) {
-        return read_scalar(value, [](const ::toml::node& node) -> result_t<std::string> {
-            auto parsed = node.value<std::string>();
-            if(!parsed.has_value()) {
-                return std::unexpected(error_kind::type_mismatch);
-            }
-            return std::move(*parsed);
-        });
+        KOTA_EXPECTED_TRY_V(auto text, open_string());
+        if(take_values) {
+            value = std::move(taken(*text).get());
+        } else {
+            // assign() keeps value's buffer when it is large enough.
+            value.assign(text->get());
+        }
+        return {};
     }
 
     status_t deserialize_bytes(std::vector<std::byte>& value) {
@@ -325,6 +330,9 @@ public:
         if(!table) {
             return std::unexpected(table.error());
         }
+        if(take_values) {
+            return std::move(taken(**table));
+        }
         return **table;
     }
 
@@ -333,6 +341,9 @@ public:
         if(!array) {
             return std::unexpected(array.error());
         }
+        if(take_values) {
+            return std::move(taken(**array));
+        }
         return **array;
     }
 
@@ -491,6 +502,8 @@ private:
         const auto* casted = [&]() -> const T* {
             if constexpr(std::same_as<T, ::toml::array>) {
                 return (*node)->as_array();
+            } else if constexpr(std::same_as<T, ::toml::value<std::string>>) {
+                return (*node)->as_string();
             } else {
                 return (*node)->as_table();
             }
@@ -510,6 +523,17 @@ private:
         return open_as<::toml::table>();
     }
 
+    result_t<const ::toml::value<std::string>*> open_string() {
+        return open_as<::toml::value<std::string>>();
+    }
+
+    // Only a tree handed over through consuming(), which is not const, has
+    // its nodes taken.
+    template <typename Node>
+    static auto taken(const Node& node) -> Node& {
+        return const_cast<Node&>(node);
+    }
+
     static std::optional<codec::source_location> source_from_node(const ::toml::node* node) {
         if(!node) {
             return std::nullopt;
@@ -528,7 +552,7 @@ private:
     std::unexpected<error_type> mark_invalid(error_type error = error_type::invalid_state) {
         is_valid = false;
         if(last_error == error_type::invalid_state || error != error_type::invalid_state) {
-            if(!error.location()) {
+            if(config::error_detail<Config> && !error.location()) {
                 if(auto loc = source_from_node(last_accessed_node)) {
                     error.set_location(*loc);
                 }
@@ -544,6 +568,7 @@ private:
     error_type last_error = error_type::invalid_state;
     const ::toml::node* root_node = nullptr;
     bool has_current_value = false;
+    bool take_values = false;
     const ::toml::node* current_node = nullptr;
     const ::toml::node* last_accessed_node = nullptr;
 };
@@ -566,6 +591,25 @@ auto from_toml(const ::toml::table& table) -> std::expected<T, error> {
     return value;
 }
 
+/// from_toml() for a table that is not needed afterwards: strings and
+/// captured tables are moved out of it rather than copied.
+template <typename Config = config::default_config, typename T>
+auto from_toml(::toml::table&& table, T& value) -> std::expected<void, error> {
+    auto deserializer = Deserializer<Config>::consuming(detail::select_root_node<T>(table));
+
+    KOTA_EXPECTED_TRY(codec::deserialize(deserializer, value));
+    KOTA_EXPECTED_TRY(deserializer.finish());
+    return {};
+}
+
+template <typename T, typename Config = config::default_config>
+    requires std::default_initializable<T>
+auto from_toml(::toml::table&& table) -> std::expected<T, error> {
+    T value{};
+    KOTA_EXPECTED_TRY(from_toml<Config>(std::move(table), value));
+    return value;
+}
+
 static_assert(codec::deserializer_like<Deserializer<>>);
 
 }  // namespace kota::codec::toml
@@ -17,6 +17,7 @@
 #include "kota/support/expected_try.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
+#include "kota/codec/detail/number_format.h"
 #include "kota/codec/toml/error.h"
 
 #if __has_include(<toml++/toml.hpp>)
@@ -362,7 +363,8 @@ public:
     }
 
     result_t<value_type> serialize_float(double value) {
-        return value_type(value);
+        // toml++ writes the numbers; the precision policy is applied here.
+        return value_type(codec::detail::round_float<config_type>(value));
     }
 
     result_t<value_type> serialize_char(char value) {
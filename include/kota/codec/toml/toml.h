@@ -2,7 +2,9 @@
 
 #include <concepts>
 #include <expected>
-#include <sstream>
+#include <ios>
+#include <ostream>
+#include <streambuf>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -36,7 +38,7 @@ auto parse(std::string_view text, T& value) -> std::expected<void, error> {
     if(!table) {
         return std::unexpected(table.error());
     }
-    return from_toml(*table, value);
+    return from_toml(std::move(*table), value);
 }
 
 template <typename T>
@@ -46,19 +48,64 @@ auto parse(std::string_view text) -> std::expected<T, error> {
     if(!table) {
         return std::unexpected(table.error());
     }
-    return from_toml<T>(*table);
+    return from_toml<T>(std::move(*table));
 }
 
+namespace detail {
+
+/// Appends what is written to it to a std::string, so that toml++'s
+/// formatter writes the text in place rather than into a stringstream
+/// that is copied out afterwards.
+class string_appender : public std::streambuf {
+public:
+    explicit string_appender(std::string& out) noexcept : out(&out) {}
+
+protected:
+    int_type overflow(int_type ch) override {
+        if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+            out->push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        out->append(data, static_cast<std::size_t>(count));
+        return count;
+    }
+
+private:
+    std::string* out;
+};
+
+}  // namespace detail
+
+/// Appends `value` as TOML to `out`, formatted as to_string() formats it.
+/// Reusing one string across many documents reuses its capacity, too.
+/// `out` is left as it was when `value` cannot be converted.
 template <typename T>
-auto to_string(const T& value) -> std::expected<std::string, error> {
+auto to_string(const T& value, std::string& out) -> std::expected<void, error> {
     auto table = to_toml(value);
     if(!table) {
         return std::unexpected(table.error());
     }
 
-    std::ostringstream out;
-    out << *table;
-    return out.str();
+    // One stream per thread: constructing a stream copies the global locale.
+    thread_local std::ostream stream(nullptr);
+    detail::string_appender appender(out);
+    stream.rdbuf(&appender);
+    stream << *table;
+    stream.rdbuf(nullptr);
+    return {};
+}
+
+template <typename T>
+auto to_string(const T& value) -> std::expected<std::string, error> {
+    std::string out;
+    auto status = to_string(value, out);
+    if(!status) {
+        return std::unexpected(status.error());
+    }
+    return out;
 }
 
 }  // namespace kota::codec::toml
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "kota/support/expected_try.h"
+#include "kota/support/ranges.h"
+#include "kota/meta/struct.h"
+#include "kota/codec/codec.h"
+#include "kota/codec/config.h"
+#include "kota/codec/detail/reflectable.h"
+
+namespace kota::codec {
+
+/// Why transcode() stopped: the input could not be read as a T, or the
+/// output refused what was read.
+template <typename D, typename S>
+using transcode_error = std::variant<typename D::error_type, typename S::error_type>;
+
+namespace detail {
+
+template <typename D, typename S>
+struct transcode_state {
+    S& out;
+
+    // Strings pass through here when D cannot lend them out.
+    std::string text;
+
+    // The first failure on either side; after it both sides only unwind.
+    std::optional<transcode_error<D, S>> failure;
+};
+
+// Stands in for the T being read: deserializing it writes the T to
+// state.out as it is read, instead of into a T.
+template <typename T, typename D, typename S>
+class transcode_sink {
+public:
+    explicit transcode_sink(transcode_state<D, S>& state) noexcept : state(&state) {}
+
+    transcode_state<D, S>* state;
+};
+
+// Stands in for the T being written: serializing it hands `read` a
+// transcode_sink, which reads the T from wherever `read` reads it.
+template <typename T, typename D, typename S, typename Read>
+class transcode_source {
+public:
+    transcode_source(transcode_state<D, S>& state, Read read) :
+        state(&state), read(std::move(read)) {}
+
+    transcode_state<D, S>* state;
+    Read read;
+};
+
+template <typename T, typename D, typename S, typename Read>
+auto make_transcode_source(transcode_state<D, S>& state, Read read) {
+    return transcode_source<T, D, S, Read>(state, std::move(read));
+}
+
+// Keeps an output error, which has no room in D's error type, and reports
+// invalid_state to D in its place.
+template <typename D, typename S, typename R>
+auto written(transcode_state<D, S>& state, const R& result)
+    -> std::expected<void, typename D::error_type> {
+    if(result) {
+        return {};
+    }
+    if(!state.failure) {
+        state.failure.emplace(std::in_place_index<1>, result.error());
+    }
+    return std::unexpected(D::error_type::invalid_state);
+}
+
+template <typename T, typename D, typename S>
+auto transcode_value(D& d, transcode_state<D, S>& state)
+    -> std::expected<void, typename D::error_type>;
+
+// Ranges read and written element by element. Sets and ordered maps are
+// left out: their encoding is sorted and has no duplicates, which takes
+// the whole container to get right.
+template <typename T>
+concept transcoded_sequence = std::ranges::input_range<T> && !str_like<T> &&
+                              format_kind<T> == range_format::sequence;
+
+template <typename T>
+concept transcoded_map =
+    std::ranges::input_range<T> && format_kind<T> == range_format::map &&
+    std::same_as<typename T::key_type, std::string> && !requires { typename T::key_compare; };
+
+template <typename T, typename D, typename S>
+concept transcoded_struct =
+    fixed_shape_struct<T, config::config_of<D>> && fixed_shape_struct<T, config::config_of<S>> &&
+    (meta::field_count<T>() <= 64);
+
+// Puts where a failure happened on the error it left: the one returned,
+// or the input error kept in state.
+template <typename Config, typename D, typename S, typename E, typename Prepend>
+auto with_path(transcode_state<D, S>& state, std::expected<void, E> status, Prepend prepend)
+    -> std::expected<void, E> {
+    if constexpr(config::error_detail<Config>) {
+        if(!status) {
+            if(!state.failure) {
+                prepend(status.error());
+            } else if(state.failure->index() == 0) {
+                prepend(std::get<0>(*state.failure));
+            }
+        }
+    }
+    return status;
+}
+
+/// Copies a struct across field by field. Fields that arrive in order are
+/// written as they are read. One that arrives ahead of its turn is read
+/// into a value of its own and written when its turn comes, since the
+/// output has its fields in declaration order.
+template <typename T, typename D, typename S>
+auto transcode_struct(D& d, transcode_state<D, S>& state)
+    -> std::expected<void, typename D::error_type> {
+    using E = typename D::error_type;
+    using config_t = config::config_of<D>;
+    constexpr auto count = meta::field_count<T>();
+    constexpr auto& in_names = fixed_field_names<T, config_t>;
+    constexpr auto& out_names = fixed_field_names<T, config::config_of<S>>;
+
+    if(has_ambiguous_wire_names<T, config_t>()) {
+        return std::unexpected(E::invalid_state);
+    }
+
+    KOTA_EXPECTED_TRY_V(auto d_struct, d.deserialize_struct(meta::type_name<T>(), count));
+    auto s_struct = state.out.serialize_struct(meta::type_name<T>(), count);
+    KOTA_EXPECTED_TRY(written(state, s_struct));
+
+    auto early = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::tuple<std::optional<std::remove_cv_t<meta::field_type<T, I>>>...>{};
+    }(std::make_index_sequence<count>{});
+
+    auto on_field = [&](std::size_t index, auto&& action) -> std::expected<void, E> {
+        std::expected<void, E> status;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (void)((I == index && (status = action.template operator()<I>(), true)) || ...);
+        }(std::make_index_sequence<count>{});
+        return status;
+    };
+
+    auto stream = [&]<std::size_t I>() -> std::expected<void, E> {
+        using field_t = std::remove_cv_t<meta::field_type<T, I>>;
+        auto read = [&](auto& sink) { return d_struct.deserialize_value(sink); };
+        return written(state,
+                       s_struct->serialize_field(out_names[I],
+                                                 make_transcode_source<field_t>(state, read)));
+    };
+
+    auto stash = [&]<std::size_t I>() -> std::expected<void, E> {
+        return d_struct.deserialize_value(std::get<I>(early).emplace());
+    };
+
+    auto write_early = [&]<std::size_t I>() -> std::expected<void, E> {
+        return written(state, s_struct->serialize_field(out_names[I], *std::get<I>(early)));
+    };
+
+    auto write_missing = [&]<std::size_t I>() -> std::expected<void, E> {
+        using field_t = std::remove_cv_t<meta::field_type<T, I>>;
+        if constexpr(is_field_optional<T, I>()) {
+            return written(state, s_struct->serialize_field(out_names[I], field_t{}));
+        } else {
+            return std::unexpected(detailed_error<config_t, E>(
+                [&] { return E::missing_field(meta::field_name<I, T>()); }));
+        }
+    };
+
+    std::uint64_t seen = 0;
+    std::size_t next = 0;
+    std::size_t cursor = 0;
+
+    auto at_field = [&](std::size_t index, std::expected<void, E> status) {
+        return with_path<config_t>(state, std::move(status), [&](E& err) {
+            err.prepend_static_field(in_names[index]);
+        });
+    };
+
+    // Writes the fields, from `next` on, that were stashed ahead of time.
+    auto catch_up = [&]() -> std::expected<void, E> {
+        while(next < count && (seen >> next & 1)) {
+            KOTA_EXPECTED_TRY(at_field(next, on_field(next, write_early)));
+            ++next;
+        }
+        return {};
+    };
+
+    while(true) {
+        KOTA_EXPECTED_TRY_V(auto key, d_struct.next_key());
+        if(!key.has_value()) {
+            break;
+        }
+
+        auto index = lookup_field<T, config_t>(*key, cursor);
+        if(!index || (seen >> *index & 1)) {
+            KOTA_EXPECTED_TRY(d_struct.skip_value());
+            continue;
+        }
+
+        seen |= std::uint64_t(1) << *index;
+        if(*index == next) {
+            KOTA_EXPECTED_TRY(at_field(next, on_field(next, stream)));
+            ++next;
+            KOTA_EXPECTED_TRY(catch_up());
+        } else {
+            KOTA_EXPECTED_TRY(at_field(*index, on_field(*index, stash)));
+        }
+    }
+
+    while(next < count) {
+        KOTA_EXPECTED_TRY(on_field(next, write_missing));
+        ++next;
+        KOTA_EXPECTED_TRY(catch_up());
+    }
+
+    KOTA_EXPECTED_TRY(d_struct.end());
+    return written(state, s_struct->end());
+}
+
+template <typename T, typename D, typename S>
+auto transcode_value(D& d, transcode_state<D, S>& state)
+    -> std::expected<void, typename D::error_type> {
+    using U = std::remove_cvref_t<T>;
+    using E = typename D::error_type;
+    using config_t = config::config_of<D>;
+    auto& s = state.out;
+
+    if constexpr(std::same_as<U, std::string>) {
+        if constexpr(requires { d.deserialize_str_view(); }) {
+            KOTA_EXPECTED_TRY_V(auto text, d.deserialize_str_view());
+            return written(state, s.serialize_str(text));
+        } else {
+            KOTA_EXPECTED_TRY(d.deserialize_str(state.text));
+            return written(state, s.serialize_str(state.text));
+        }
+    } else if constexpr(is_specialization_of<std::optional, U>) {
+        KOTA_EXPECTED_TRY_V(auto is_none, d.deserialize_none());
+        if(is_none) {
+            return written(state, s.serialize_null());
+        }
+        using value_t = typename U::value_type;
+        auto read = [&](auto& sink) { return codec::deserialize(d, sink); };
+        return written(state, s.serialize_some(make_transcode_source<value_t>(state, read)));
+    } else if constexpr(tuple_like<U>) {
+        constexpr auto count = std::tuple_size_v<U>;
+        KOTA_EXPECTED_TRY_V(auto d_tuple, d.deserialize_tuple(count));
+        auto s_tuple = s.serialize_tuple(count);
+        KOTA_EXPECTED_TRY(written(state, s_tuple));
+
+        std::expected<void, E> status;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (void)(((status = [&] {
+                         auto read = [&](auto& sink) { return d_tuple.deserialize_element(sink); };
+                         using element_t = std::tuple_element_t<I, U>;
+                         auto source = make_transcode_source<element_t>(state, read);
+                         return with_path<config_t>(
+                             state,
+                             written(state, s_tuple->serialize_element(source)),
+                             [](E& err) { err.prepend_index(I); });
+                     }())) &&
+                   ...);
+        }(std::make_index_sequence<count>{});
+        KOTA_EXPECTED_TRY(status);
+
+        KOTA_EXPECTED_TRY(d_tuple.end());
+        return written(state, s_tuple->end());
+    } else if constexpr(transcoded_sequence<U>) {
+        KOTA_EXPECTED_TRY_V(auto d_seq, d.deserialize_seq(std::nullopt));
+        auto s_seq = s.serialize_seq(std::nullopt);
+        KOTA_EXPECTED_TRY(written(state, s_seq));
+
+        using element_t = std::ranges::range_value_t<U>;
+        auto read = [&](auto& sink) { return d_seq.deserialize_element(sink); };
+        for(std::size_t index = 0;; ++index) {
+            KOTA_EXPECTED_TRY_V(auto has_next, d_seq.has_next());
+            if(!has_next) {
+                break;
+            }
+            auto source = make_transcode_source<element_t>(state, read);
+            KOTA_EXPECTED_TRY(with_path<config_t>(
+                state,
+                written(state, s_seq->serialize_element(source)),
+                [&](E& err) { err.prepend_index(index); }));
+        }
+
+        KOTA_EXPECTED_TRY(d_seq.end());
+        return written(state, s_seq->end());
+    } else if constexpr(transcoded_map<U>) {
+        KOTA_EXPECTED_TRY_V(auto d_map, d.deserialize_map(std::nullopt));
+        auto s_map = s.serialize_map(std::nullopt);
+        KOTA_EXPECTED_TRY(written(state, s_map));
+
+        using mapped_t = typename U::mapped_type;
+        auto read = [&](auto& sink) { return d_map.deserialize_value(sink); };
+        while(true) {
+            KOTA_EXPECTED_TRY_V(auto key, d_map.next_key());
+            if(!key.has_value()) {
+                break;
+            }
+            auto source = make_transcode_source<mapped_t>(state, read);
+            KOTA_EXPECTED_TRY(with_path<config_t>(
+                state,
+                written(state, s_map->serialize_entry(*key, source)),
+                [&](E& err) { err.prepend_field(*key); }));
+        }
+
+        KOTA_EXPECTED_TRY(d_map.end());
+        return written(state, s_map->end());
+    } else if constexpr(transcoded_struct<U, D, S>) {
+        return transcode_struct<U>(d, state);
+    } else {
+        // Scalars, and what has to be seen whole to be read or written:
+        // variants, annotated types, structs with attributes.
+        static_assert(std::default_initializable<U>,
+                      "transcode() reads this type into a value first; it must be "
+                      "default-constructible");
+        U value{};
+        KOTA_EXPECTED_TRY(codec::deserialize(d, value));
+        return written(state, codec::serialize(s, value));
+    }
+}
+
+}  // namespace detail
+
+template <deserializer_like D, typename T, typename S>
+struct deserialize_traits<D, detail::transcode_sink<T, D, S>> {
+    static auto deserialize(D& d, detail::transcode_sink<T, D, S>& sink)
+        -> std::expected<void, typename D::error_type> {
+        return detail::transcode_value<T>(d, *sink.state);
+    }
+};
+
+template <serializer_like S, typename T, typename D, typename Read>
+struct serialize_traits<S, detail::transcode_source<T, D, S, Read>> {
+    static auto serialize(S& /*s*/, const detail::transcode_source<T, D, S, Read>& source)
+        -> std::expected<typename S::value_type, typename S::error_type> {
+        detail::transcode_sink<T, D, S> sink(*source.state);
+        auto status = source.read(sink);
+        if(!status) {
+            if(!source.state->failure) {
+                source.state->failure.emplace(std::in_place_index<0>, status.error());
+            }
+            return std::unexpected(S::error_type::invalid_state);
+        }
+        return {};
+    }
+};
+
+/// Reads a T from `d` and writes it to `s` as serializing that T would,
+/// without building the T: strings go from the parser's buffer straight
+/// to the output, and structs, sequences and unordered maps of strings are
+/// copied member by member as they are read. What needs the whole value
+/// at once, a variant, a set or an ordered map, a struct with attributes,
+/// is read into a value of its own on the way.
+///
+/// An unordered map is written in the order its entries were read.
+template <typename T, deserializer_like D, serializer_like S>
+    requires std::is_void_v<typename S::value_type>
+auto transcode(D& d, S& s) -> std::expected<void, transcode_error<D, S>> {
+    detail::transcode_state<D, S> state{.out = s, .text = {}, .failure = {}};
+    auto status = detail::transcode_value<T>(d, state);
+    if(status) {
+        if constexpr(requires { d.finish(); }) {
+            status = d.finish();
+        }
+    }
+
+    if(state.failure) {
+        return std::unexpected(std::move(*state.failure));
+    }
+    if(!status) {
+        return std::unexpected(transcode_error<D, S>(std::in_place_index<0>, status.error()));
+    }
+    return {};
+}
+
+}  // namespace kota::codec
@@ -507,6 +507,14 @@ private:
                                         "");
     }
 
+    auto unbuilt_opt_table() const {
+        return backend::OptTable(option_infos(), false, {}, false)
+            .set_tablegen_mode(false)
+            .set_input_random_index(input_random_index)
+            .set_dash_dash_parsing(hasTrailingPack)
+            .set_dash_dash_as_single_pack(hasTrailingPack);
+    }
+
     constexpr auto& item_by_id(unsigned id) {
         return itemPool[id];
     }
@@ -563,57 +571,28 @@ private:
         aliasMetaMap[item_id] = snapshot.meta;
     }
 
-    template <typename CallbackTy>
-    constexpr static auto encode_callback(CallbackTy callback) -> parse_callback_t::storage_t {
-        static_assert(sizeof(CallbackTy) == parse_callback_t::storage_size,
-                      "Eventide Error: callback pointer size mismatch");
-        parse_callback_t::storage_t storage{};
-        const auto* src = reinterpret_cast<const char*>(&callback);
-        for(std::size_t i = 0; i < sizeof(CallbackTy); ++i) {
-            storage[i] = src[i];
-        }
-        return storage;
-    }
-
-    template <typename CallbackTy>
-    static auto decode_callback(const parse_callback_t::storage_t& storage) -> CallbackTy {
-        static_assert(sizeof(CallbackTy) == parse_callback_t::storage_size,
-                      "Eventide Error: callback pointer size mismatch");
-        CallbackTy callback = nullptr;
-        auto* dst = reinterpret_cast<char*>(&callback);
-        for(std::size_t i = 0; i < sizeof(CallbackTy); ++i) {
-            dst[i] = storage[i];
-        }
-        return callback;
-    }
-
-    template <typename ResultTy, typename CallbackTy>
-    static auto invoke_parse_callback(const parse_callback_t::storage_t& storage,
-                                      const backend::ParsedArgumentOwning& arg,
+    template <typename CfgTy>
+    static auto invoke_parse_callback(const backend::ParsedArgumentOwning& arg,
                                       unsigned next_cursor,
-                                      std::span<std::string> argv,
+                                      backend::ArgvView argv,
                                       const decl::DecoOptionBase& option) -> decl::ParseControl {
-        const auto callback = decode_callback<CallbackTy>(storage);
-        if(callback == nullptr) {
-            return decl::ParseControl::next();
-        }
-        const auto& typed_option = static_cast<const decl::DecoOption<ResultTy>&>(option);
-        const decl::ParseStep<ResultTy> step(arg, next_cursor, argv, typed_option.value());
+        using result_type = typename CfgTy::result_type;
+        constexpr auto callback = CfgTy{}.after_parsed;
+        const auto& typed_option = static_cast<const decl::DecoOption<result_type>&>(option);
+        const decl::ParseStep<result_type> step(arg, next_cursor, argv, typed_option.value());
         return callback(step);
     }
 
-    template <typename ResultTy, typename CallbackTy>
-    constexpr static auto make_parse_callback(CallbackTy callback) -> parse_callback_t {
-        if constexpr(resource_ty::is_counting) {
-            return {};
-        }
-        if(callback == nullptr) {
+    /// The callback is part of the cfg type, so the erased invoker reads it
+    /// from there instead of carrying the pointer, which keeps the generator
+    /// usable in constant evaluation.
+    template <typename CfgTy>
+    constexpr static auto make_parse_callback() -> parse_callback_t {
+        if constexpr(resource_ty::is_counting || CfgTy{}.after_parsed == nullptr) {
             return {};
+        } else {
+            return parse_callback_t{.invoke = &invoke_parse_callback<CfgTy>};
         }
-        return parse_callback_t{
-            .storage = encode_callback(callback),
-            .invoke = &invoke_parse_callback<ResultTy, CallbackTy>,
-        };
     }
 
     template <typename FieldsTy>
@@ -716,8 +695,7 @@ private:
         idMap[inputOptionId] = mapped_accessor;
         set_common_options(item_by_id(inputOptionId), cfg);
         set_category_for_item(inputOptionId, cfg.category.ptr());
-        set_callback_for_item(inputOptionId,
-                              make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed));
+        set_callback_for_item(inputOptionId, make_parse_callback<CfgTy>());
     }
 
     template <typename CfgTy>
@@ -730,7 +708,7 @@ private:
         hasTrailingPack = true;
         trailingAccessor = mapped_accessor;
         trailingCategory = cfg.category.ptr();
-        trailingCallback = make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed);
+        trailingCallback = make_parse_callback<CfgTy>();
 
         // The backend only has one input id slot. If trailing appears first, reserve that slot
         // now so parse_args can still emit a valid input option id.
@@ -747,7 +725,7 @@ private:
     constexpr void add_flag_option(const CfgTy& cfg,
                                    accessor_fn mapped_accessor,
                                    std::string_view field_name) {
-        const auto callback = make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed);
+        const auto callback = make_parse_callback<CfgTy>();
         auto& item = new_item(mapped_accessor);
         item.kind = backend::Option::FlagClass;
         item.param = 0;
@@ -780,9 +758,7 @@ private:
         set_generated_name_from_field(alias, field_name, "=");
         set_common_options(alias, fields);
         set_category_for_item(alias.id, fields.category.ptr());
-        set_callback_for_item(
-            alias.id,
-            make_parse_callback<typename FieldsTy::result_type>(fields.after_parsed));
+        set_callback_for_item(alias.id, make_parse_callback<FieldsTy>());
         restore_alias_storage(alias.id, alias_storage);
     }
 
@@ -862,18 +838,14 @@ private:
             item.kind = backend::Option::SeparateClass;
             set_common_options(item, fields);
             set_category_for_item(item.id, category);
-            set_callback_for_item(
-                item.id,
-                make_parse_callback<typename FieldsTy::result_type>(fields.after_parsed));
+            set_callback_for_item(item.id, make_parse_callback<FieldsTy>());
             add_generated_kv_joined_alias(item.id, mapped_accessor, field_name, fields);
             return item_by_id(item_id);
         }
 
         set_kv_name_and_kind(item, fields.names.front());
         set_category_for_item(item.id, category);
-        set_callback_for_item(
-            item.id,
-            make_parse_callback<typename FieldsTy::result_type>(fields.after_parsed));
+        set_callback_for_item(item.id, make_parse_callback<FieldsTy>());
 
         const auto item_snapshot = item;
         for(std::size_t i = 1; i < fields.names.size(); ++i) {
@@ -885,9 +857,7 @@ private:
             set_kv_name_and_kind(alias, fields.names[i]);
             set_common_options(alias, fields);
             set_category_for_item(alias.id, category);
-            set_callback_for_item(
-                alias.id,
-                make_parse_callback<typename FieldsTy::result_type>(fields.after_parsed));
+            set_callback_for_item(alias.id, make_parse_callback<FieldsTy>());
             restore_alias_storage(alias.id, alias_storage);
         }
 
@@ -899,7 +869,7 @@ private:
     constexpr void add_kv_option(const CfgTy& cfg,
                                  accessor_fn mapped_accessor,
                                  std::string_view field_name) {
-        const auto callback = make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed);
+        const auto callback = make_parse_callback<CfgTy>();
         const bool allow_joined = has_kv_style(cfg.style, decl::KVStyle::Joined);
         const bool allow_separate = has_kv_style(cfg.style, decl::KVStyle::Separate);
         if(!allow_joined && !allow_separate) {
@@ -924,7 +894,7 @@ private:
     constexpr void add_comma_option(const CfgTy& cfg,
                                     accessor_fn mapped_accessor,
                                     std::string_view field_name) {
-        const auto callback = make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed);
+        const auto callback = make_parse_callback<CfgTy>();
         auto& item = new_item(mapped_accessor);
         item.kind = backend::Option::CommaJoinedClass;
         item.param = 1;
@@ -935,7 +905,7 @@ private:
     constexpr void add_multi_option(const CfgTy& cfg,
                                     accessor_fn mapped_accessor,
                                     std::string_view field_name) {
-        const auto callback = make_parse_callback<typename CfgTy::result_type>(cfg.after_parsed);
+        const auto callback = make_parse_callback<CfgTy>();
         if(cfg.arg_num == 0) {
             KOTA_THROW("DecoMulti arg_num must be greater than 0");
         }
@@ -1295,16 +1265,22 @@ public:
         return callbackMap[id];
     }
 
+    /// Tables parse with a random input index; an index adopted by
+    /// make_opt_table() must be derived with that too.
+    constexpr static bool input_random_index = true;
+
     auto make_opt_table() const& {
-        return backend::OptTable(option_infos(), false, {}, false)
-            .set_tablegen_mode(false)
-            .set_input_random_index(true)
-            .set_dash_dash_parsing(hasTrailingPack)
-            .set_dash_dash_as_single_pack(hasTrailingPack)
-            .build();
+        return unbuilt_opt_table().build();
+    }
+
+    /// Like make_opt_table(), but adopts an index derived ahead of time,
+    /// e.g. BuildStorage::index, instead of deriving it.
+    auto make_opt_table(const backend::OptTable::IndexView& index) const& {
+        return unbuilt_opt_table().build(index);
     }
 
     auto make_opt_table() const&& = delete;
+    auto make_opt_table(const backend::OptTable::IndexView& index) const&& = delete;
 
     consteval auto gen_record() const {
         static_assert(resource_ty::is_counting, "gen_record() is only for counting builders");
@@ -1319,16 +1295,28 @@ consteval auto build_record() {
     return counter.gen_record();
 }
 
+/// The generator and the backend index of an option struct, both built
+/// during compilation, so a parse only has to wrap them in an OptTable.
 template <typename OptDeco>
 struct BuildStorage {
     constexpr inline static auto record = build_record<OptDeco>();
     using builder_t = LLVMOptGenerator<OptDeco, record>;
+    constexpr inline static builder_t value{std::in_place};
+
+    constexpr inline static auto index_sizes =
+        backend::OptTable::index_sizes(value.option_infos(), builder_t::input_random_index);
+    constexpr inline static backend::StaticIndex<index_sizes> index{value.option_infos(),
+                                                                   builder_t::input_random_index};
 };
 
 template <typename OptDeco>
-const auto& build_storage() {
-    const static typename BuildStorage<OptDeco>::builder_t value{std::in_place};
-    return value;
+constexpr const auto& build_storage() {
+    return BuildStorage<OptDeco>::value;
+}
+
+template <typename OptDeco>
+auto make_opt_table() {
+    return build_storage<OptDeco>().make_opt_table(BuildStorage<OptDeco>::index.view());
 }
 
 }  // namespace kota::deco::detail
@@ -108,14 +108,15 @@ struct ParseControl {
     };
 
     Action action = Action::Continue;
-    std::span<std::string> next_argv{};
-    std::shared_ptr<std::vector<std::string>> owned_next_argv{};
+    backend::ArgvView next_argv{};
+    /// Keeps the storage behind `next_argv` alive when parsing owns it.
+    std::shared_ptr<const void> owned_next_argv{};
 
     ParseControl() = default;
 
     ParseControl(Action action,
-                 std::span<std::string> next_argv = {},
-                 std::shared_ptr<std::vector<std::string>> owned_next_argv = {}) :
+                 backend::ArgvView next_argv = {},
+                 std::shared_ptr<const void> owned_next_argv = {}) :
         action(action), next_argv(next_argv), owned_next_argv(std::move(owned_next_argv)) {}
 
     static auto next() -> ParseControl {
@@ -131,7 +132,7 @@ struct ParseControl {
     /// IMPORTANT: `next_argv` must outlive the parsing session (and any returned Invocation that
     /// exposes `argv()`).
     /// For callback-local rewritten argv, use the `std::vector<std::string>` overload.
-    static auto restart(std::span<std::string> next_argv) -> ParseControl {
+    static auto restart(backend::ArgvView next_argv) -> ParseControl {
         return ParseControl(Action::Restart, next_argv);
     }
 
@@ -141,7 +142,7 @@ struct ParseControl {
     /// `std::vector<std::string> rewritten; return step.restart(std::move(rewritten));`.
     static auto restart(std::vector<std::string> next_argv) -> ParseControl {
         auto owned = std::make_shared<std::vector<std::string>>(std::move(next_argv));
-        auto view = std::span<std::string>(owned->data(), owned->size());
+        auto view = backend::ArgvView(*owned);
         return ParseControl(Action::Restart, view, std::move(owned));
     }
 };
@@ -150,14 +151,14 @@ template <typename ResTy>
 struct ParseStep {
     const backend::ParsedArgumentOwning* parsed_arg = nullptr;
     unsigned next_cursor_index = 0;
-    std::span<std::string> argv_span{};
+    backend::ArgvView argv_span{};
     const ResTy* parsed_value = nullptr;
 
     constexpr ParseStep() = default;
 
     constexpr ParseStep(const backend::ParsedArgumentOwning& arg,
                         unsigned next_cursor,
-                        std::span<std::string> argv,
+                        backend::ArgvView argv,
                         const ResTy& value) :
         parsed_arg(&arg), next_cursor_index(next_cursor), argv_span(argv), parsed_value(&value) {}
 
@@ -169,7 +170,7 @@ struct ParseStep {
         return next_cursor_index;
     }
 
-    constexpr auto argv() const -> std::span<std::string> {
+    constexpr auto argv() const -> backend::ArgvView {
         return argv_span;
     }
 
@@ -185,7 +186,7 @@ struct ParseStep {
         return ParseControl::stop();
     }
 
-    auto restart(std::span<std::string> next_argv) const -> ParseControl {
+    auto restart(backend::ArgvView next_argv) const -> ParseControl {
         return ParseControl::restart(next_argv);
     }
 
@@ -195,21 +196,21 @@ struct ParseStep {
 };
 
 struct IntoContext {
-    std::span<const std::string> argv_span{};
+    backend::ArgvView argv_span{};
     unsigned highlight_begin_index = 0;
     unsigned highlight_end_index = 0;
     const cli::text::Renderer* renderer_ptr = nullptr;
 
     constexpr IntoContext() = default;
 
-    constexpr IntoContext(std::span<const std::string> argv,
+    constexpr IntoContext(backend::ArgvView argv,
                           unsigned highlight_begin,
                           unsigned highlight_end,
                           const cli::text::Renderer* renderer = nullptr) :
         argv_span(argv), highlight_begin_index(highlight_begin), highlight_end_index(highlight_end),
         renderer_ptr(renderer) {}
 
-    constexpr auto argv() const -> std::span<const std::string> {
+    constexpr auto argv() const -> backend::ArgvView {
         return argv_span;
     }
 
@@ -225,7 +226,7 @@ struct IntoContext {
         return renderer_ptr;
     }
 
-    static auto at_cursor(std::span<const std::string> argv,
+    static auto at_cursor(backend::ArgvView argv,
                           unsigned index,
                           const cli::text::Renderer* renderer = nullptr) -> IntoContext {
         const unsigned clamped = std::min<unsigned>(index, static_cast<unsigned>(argv.size()));
@@ -233,7 +234,7 @@ struct IntoContext {
     }
 
     template <typename ArgTy>
-    static auto from_argument(std::span<const std::string> argv,
+    static auto from_argument(backend::ArgvView argv,
                               const ArgTy& arg,
                               const cli::text::Renderer* renderer = nullptr) -> IntoContext {
         const unsigned begin = std::min<unsigned>(arg.index, static_cast<unsigned>(argv.size()));
@@ -254,7 +255,7 @@ struct IntoContext {
     }
 
     template <typename ArgTy>
-    static auto from_value(std::span<const std::string> argv,
+    static auto from_value(backend::ArgvView argv,
                            const ArgTy& arg,
                            std::string_view value,
                            const cli::text::Renderer* renderer = nullptr) -> IntoContext {
@@ -552,15 +553,11 @@ struct DecoOptionBase {
 };
 
 struct ErasedParseCallback {
-    constexpr static std::size_t storage_size = sizeof(void (*)());
-    using storage_t = std::array<char, storage_size>;
-    using invoker_t = ParseControl (*)(const storage_t& storage,
-                                       const backend::ParsedArgumentOwning& arg,
+    using invoker_t = ParseControl (*)(const backend::ParsedArgumentOwning& arg,
                                        unsigned next_cursor,
-                                       std::span<std::string> argv,
+                                       backend::ArgvView argv,
                                        const DecoOptionBase& option);
 
-    storage_t storage{};
     invoker_t invoke = nullptr;
 
     constexpr explicit operator bool() const {
@@ -569,12 +566,12 @@ struct ErasedParseCallback {
 
     constexpr auto operator()(const backend::ParsedArgumentOwning& arg,
                               unsigned next_cursor,
-                              std::span<std::string> argv,
+                              backend::ArgvView argv,
                               const DecoOptionBase& option) const -> ParseControl {
         if(invoke == nullptr) {
             return ParseControl::next();
         }
-        return invoke(storage, arg, next_cursor, argv, option);
+        return invoke(arg, next_cursor, argv, option);
     }
 };
 
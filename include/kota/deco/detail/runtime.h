@@ -28,6 +28,12 @@ namespace kota::deco::util {
 
 std::vector<std::string> argvify(int argc, const char* const* argv, unsigned skip_num = 1);
 
+/// Like argvify(), but views the tokens in place instead of copying them;
+/// `argv` must outlive the result and anything parsed from it.
+std::vector<std::string_view> borrow_argv(int argc,
+                                          const char* const* argv,
+                                          unsigned skip_num = 1);
+
 }  // namespace kota::deco::util
 
 namespace kota::deco::cli {
@@ -40,9 +46,10 @@ struct Invocation {
     unsigned next_index = 0;
     T options{};
     std::set<const decl::Category*> matched_categories;
-    std::span<std::string> original_argv{};
-    std::span<std::string> active_argv{};
-    std::shared_ptr<std::vector<std::string>> owned_active_argv{};
+    backend::ArgvView original_argv{};
+    backend::ArgvView active_argv{};
+    /// Keeps `active_argv` alive when it was rewritten during parsing.
+    std::shared_ptr<const void> owned_active_argv{};
     std::vector<backend::ParsedArgumentOwning> parsed_arguments{};
     std::vector<std::string> command_path{};
     std::string_view command_overview{};
@@ -59,11 +66,11 @@ struct Invocation {
         return next_index;
     }
 
-    auto argv() const -> std::span<std::string> {
+    auto argv() const -> backend::ArgvView {
         return active_argv;
     }
 
-    auto remaining() const -> std::span<std::string> {
+    auto remaining() const -> backend::ArgvView {
         if(next_index > active_argv.size()) {
             return {};
         }
@@ -90,13 +97,11 @@ struct Invocation {
     }
 
     auto into_context_at_cursor(unsigned index) const -> decl::IntoContext {
-        const auto argv_view = std::span<const std::string>(argv().data(), argv().size());
-        return decl::IntoContext::at_cursor(argv_view, index, renderer_ptr);
+        return decl::IntoContext::at_cursor(argv(), index, renderer_ptr);
     }
 
     auto into_context(const backend::ParsedArgumentOwning& arg) const -> decl::IntoContext {
-        const auto argv_view = std::span<const std::string>(argv().data(), argv().size());
-        return decl::IntoContext::from_argument(argv_view, arg, renderer_ptr);
+        return decl::IntoContext::from_argument(argv(), arg, renderer_ptr);
     }
 
     auto format_error(std::string_view reason) const -> std::string {
@@ -126,72 +131,88 @@ constexpr inline bool always_false_v = false;
 
 namespace detail {
 
+/// The argv an alias forwards to, followed by the rest of the command line.
+///
+/// Static forwards view the alias' tokens, the values it was given and the
+/// remaining argv in place; only tokens the forward synthesizes, such as a
+/// comma-joined value or a dynamic forward's result, are owned here.
 struct ResolvedAliasForward {
-    std::vector<std::string> argv;
+    std::vector<std::string> tokens;
+    std::vector<std::string_view> argv;
+    /// Keeps the argv the suffix views alive.
+    std::shared_ptr<const void> parent;
+
+    auto append_tokens() -> void {
+        for(const auto& token: tokens) {
+            argv.emplace_back(token);
+        }
+    }
 };
 
 template <typename AliasMeta>
 inline auto resolve_static_alias_forward(const AliasMeta& meta,
-                                         const backend::ParsedArgumentOwning& arg)
-    -> std::expected<std::vector<std::string>, std::string> {
-    std::vector<std::string> argv;
+                                         const backend::ParsedArgument& arg,
+                                         ResolvedAliasForward& out)
+    -> std::expected<void, std::string> {
     switch(meta.kind) {
-        case AliasMeta::Kind::None: return argv;
+        case AliasMeta::Kind::None: return {};
         case AliasMeta::Kind::Flag:
         case AliasMeta::Kind::KV:
         case AliasMeta::Kind::Multi:
-            argv.reserve(meta.static_tokens.size() + arg.values.size());
-            for(const auto token: meta.static_tokens) {
-                argv.emplace_back(token);
-            }
-            for(const auto& value: arg.values) {
-                argv.push_back(value);
-            }
-            return argv;
+            out.argv.reserve(meta.static_tokens.size() + arg.values.size());
+            out.argv.insert(out.argv.end(), meta.static_tokens.begin(), meta.static_tokens.end());
+            out.argv.insert(out.argv.end(), arg.values.begin(), arg.values.end());
+            return {};
         case AliasMeta::Kind::CommaJoined:
             if(meta.static_tokens.empty()) {
                 return std::unexpected(
                     std::string("comma alias forward requires at least one target token"));
             }
-            argv.reserve(meta.static_tokens.size());
-            for(std::size_t i = 0; i + 1 < meta.static_tokens.size(); ++i) {
-                argv.emplace_back(meta.static_tokens[i]);
-            }
+            out.argv.reserve(meta.static_tokens.size());
+            out.argv.insert(out.argv.end(),
+                            meta.static_tokens.begin(),
+                            meta.static_tokens.end() - 1);
             {
                 std::string joined(meta.static_tokens.back());
                 for(const auto& value: arg.values) {
                     joined.push_back(',');
                     joined += value;
                 }
-                argv.push_back(std::move(joined));
+                out.tokens.push_back(std::move(joined));
             }
-            return argv;
+            out.append_tokens();
+            return {};
     }
     return std::unexpected(std::string("unsupported alias kind"));
 }
 
 template <typename AliasMeta>
 inline auto resolve_alias_forward(const AliasMeta& meta,
-                                  const backend::ParsedArgumentOwning& arg,
+                                  const backend::ParsedArgument& arg,
+                                  const backend::ParsedArgumentOwning& arg_snapshot,
                                   const decl::IntoContext& context)
     -> std::expected<ResolvedAliasForward, std::string> {
+    ResolvedAliasForward resolved;
     if(meta.forward_kind == decl::AliasForwardField::Kind::Static) {
-        if(auto rewritten = resolve_static_alias_forward(meta, arg)) {
-            return ResolvedAliasForward{.argv = std::move(*rewritten)};
-        } else {
-            return std::unexpected(std::move(rewritten.error()));
+        if(auto ok = resolve_static_alias_forward(meta, arg, resolved); !ok) {
+            return std::unexpected(std::move(ok.error()));
         }
+        return resolved;
     }
     if(meta.dynamic_with_context != nullptr) {
-        if(auto rewritten = meta.dynamic_with_context(arg, context)) {
-            return ResolvedAliasForward{.argv = std::move(*rewritten)};
+        if(auto rewritten = meta.dynamic_with_context(arg_snapshot, context)) {
+            resolved.tokens = std::move(*rewritten);
+            resolved.append_tokens();
+            return resolved;
         } else {
             return std::unexpected(std::move(rewritten.error()));
         }
     }
     if(meta.dynamic != nullptr) {
-        if(auto rewritten = meta.dynamic(arg)) {
-            return ResolvedAliasForward{.argv = std::move(*rewritten)};
+        if(auto rewritten = meta.dynamic(arg_snapshot)) {
+            resolved.tokens = std::move(*rewritten);
+            resolved.append_tokens();
+            return resolved;
         } else {
             return std::unexpected(std::move(rewritten.error()));
         }
@@ -304,7 +325,7 @@ class AfterStep {
     invocation_t* invocation_ptr = nullptr;
     const backend::ParsedArgumentOwning* parsed_arg = nullptr;
     unsigned next_cursor_index = 0;
-    std::span<std::string> argv_span{};
+    backend::ArgvView argv_span{};
     const FieldTy* parsed_value = nullptr;
 
 public:
@@ -313,7 +334,7 @@ public:
     AfterStep(invocation_t& invocation,
               const backend::ParsedArgumentOwning& arg,
               unsigned next_cursor,
-              std::span<std::string> argv,
+              backend::ArgvView argv,
               const FieldTy& value) :
         invocation_ptr(&invocation), parsed_arg(&arg), next_cursor_index(next_cursor),
         argv_span(argv), parsed_value(&value) {}
@@ -342,11 +363,11 @@ public:
         return invocation().trace();
     }
 
-    auto argv() const -> std::span<std::string> {
+    auto argv() const -> backend::ArgvView {
         return argv_span;
     }
 
-    auto original_argv() const -> std::span<std::string> {
+    auto original_argv() const -> backend::ArgvView {
         return invocation().original_argv;
     }
 
@@ -404,12 +425,12 @@ public:
 
     auto seek(unsigned index) const -> decl::ParseControl {
         if(index >= argv_span.size()) {
-            return resume_from(std::span<std::string>{});
+            return resume_from(backend::ArgvView{});
         }
         return resume_from(argv_span.subspan(index));
     }
 
-    auto resume_from(std::span<std::string> next_argv) const -> decl::ParseControl {
+    auto resume_from(backend::ArgvView next_argv) const -> decl::ParseControl {
         return decl::ParseControl::restart(next_argv);
     }
 
@@ -425,13 +446,13 @@ struct SubCommandMatch {
     };
 
     Kind kind = Kind::Default;
-    std::span<std::string> original_argv{};
-    std::span<std::string> remaining_argv{};
+    backend::ArgvView original_argv{};
+    backend::ArgvView remaining_argv{};
     std::string_view token{};
     std::string name{};
     std::string command{};
 
-    auto args() const -> std::span<std::string> {
+    auto args() const -> backend::ArgvView {
         return remaining_argv;
     }
 
@@ -518,15 +539,15 @@ namespace detail {
 
 template <typename T, typename OnOption>
 std::expected<Invocation<T>, ParseError>
-    run_parse_session(std::span<std::string> argv,
+    run_parse_session(backend::ArgvView argv,
                       OnOption&& on_option,
                       const text::Renderer* formatter = nullptr) {
     const auto& storage = ::kota::deco::detail::build_storage<T>();
-    backend::OptTable table = storage.make_opt_table();
+    backend::OptTable table = ::kota::deco::detail::make_opt_table<T>();
     Invocation<T> res{};
     ParseError err;
-    std::span<std::string> current_argv = argv;
-    std::shared_ptr<std::vector<std::string>> current_owned_argv{};
+    backend::ArgvView current_argv = argv;
+    std::shared_ptr<const void> current_owned_argv{};
     bool stopped_during_parse = false;
     res.original_argv = argv;
     res.active_argv = current_argv;
@@ -534,12 +555,11 @@ std::expected<Invocation<T>, ParseError>
 
     while(true) {
         bool restart_requested = false;
-        std::span<std::string> restart_argv{};
-        std::shared_ptr<std::vector<std::string>> restart_owned_argv{};
+        backend::ArgvView restart_argv{};
+        std::shared_ptr<const void> restart_owned_argv{};
         res.active_argv = current_argv;
         res.owned_active_argv = current_owned_argv;
-        const auto argv_view =
-            std::span<const std::string>(current_argv.data(), current_argv.size());
+        const auto argv_view = current_argv;
 
         table.parse_args(
             current_argv,
@@ -599,7 +619,8 @@ std::expected<Invocation<T>, ParseError>
                                                  std::to_string(raw_parg.option_id.id()))};
                         return false;
                     }
-                    auto resolved = resolve_alias_forward(*alias_meta, arg_snapshot, into_context);
+                    auto resolved =
+                        resolve_alias_forward(*alias_meta, raw_parg, arg_snapshot, into_context);
                     if(!resolved.has_value()) {
                         const auto reason = resolved.error();
                         const bool should_format =
@@ -612,19 +633,15 @@ std::expected<Invocation<T>, ParseError>
                         return false;
                     }
 
-                    std::vector<std::string> rewritten = std::move(resolved->argv);
                     const auto suffix = current_argv.subspan(next_cursor);
-                    rewritten.reserve(rewritten.size() + suffix.size());
-                    for(const auto& token: suffix) {
-                        rewritten.push_back(token);
-                    }
+                    resolved->argv.insert(resolved->argv.end(), suffix.begin(), suffix.end());
+                    resolved->parent = current_owned_argv;
 
                     res.next_index = next_cursor;
                     restart_requested = true;
-                    restart_owned_argv =
-                        std::make_shared<std::vector<std::string>>(std::move(rewritten));
-                    restart_argv = std::span<std::string>(restart_owned_argv->data(),
-                                                          restart_owned_argv->size());
+                    auto forwarded = std::make_shared<ResolvedAliasForward>(std::move(*resolved));
+                    restart_argv = backend::ArgvView(forwarded->argv);
+                    restart_owned_argv = std::move(forwarded);
                     return false;
                 }
 
@@ -666,16 +683,10 @@ std::expected<Invocation<T>, ParseError>
                             restart_requested = true;
                             restart_argv = control.next_argv;
                             restart_owned_argv = control.owned_next_argv;
-                            if(!restart_owned_argv && current_owned_argv &&
-                               !current_owned_argv->empty()) {
-                                std::less<std::string*> ptr_less;
-                                auto* begin = current_owned_argv->data();
-                                auto* end = begin + current_owned_argv->size();
-                                auto* cursor = restart_argv.data();
-                                if(cursor != nullptr && !ptr_less(cursor, begin) &&
-                                   !ptr_less(end, cursor)) {
-                                    restart_owned_argv = current_owned_argv;
-                                }
+                            // A borrowed view may point into the argv being
+                            // parsed, e.g. seek() past an alias forward.
+                            if(!restart_owned_argv) {
+                                restart_owned_argv = current_owned_argv;
                             }
                             return false;
                     }
@@ -721,8 +732,7 @@ std::expected<Invocation<T>, ParseError>
             if constexpr(ty::deco_option_like<field_ty>) {
                 if(res.matched_categories.contains(cfg.category.ptr()) && cfg.required &&
                    !field.has_value()) {
-                    const auto active_argv = std::span<const std::string>(res.active_argv.data(),
-                                                                          res.active_argv.size());
+                    const auto active_argv = res.active_argv;
                     err = {
                         ParseError::Type::DecoParsing,
                         decl::IntoContext::at_cursor(active_argv, res.next_index, formatter)
@@ -739,8 +749,7 @@ std::expected<Invocation<T>, ParseError>
 
     const std::string check_err = check_valid(res.options, res.matched_categories);
     if(!check_err.empty()) {
-        const auto active_argv =
-            std::span<const std::string>(res.active_argv.data(), res.active_argv.size());
+        const auto active_argv = res.active_argv;
         err = {ParseError::Type::DecoParsing,
                decl::IntoContext::at_cursor(active_argv, res.next_index, formatter)
                    .format_error(check_err)};
@@ -753,7 +762,7 @@ std::expected<Invocation<T>, ParseError>
 
 template <typename T, typename Fn>
     requires std::is_invocable_r_v<bool, Fn, const T&, decl::DecoOptionBase*>
-std::expected<ParsedResult<T>, ParseError> parse_with_callback(std::span<std::string> argv,
+std::expected<ParsedResult<T>, ParseError> parse_with_callback(backend::ArgvView argv,
                                                                Fn&& cont_fn) {
     return detail::run_parse_session<T>(
         argv,
@@ -761,7 +770,7 @@ std::expected<ParsedResult<T>, ParseError> parse_with_callback(std::span<std::st
                                          decl::DecoOptionBase& accessor,
                                          const backend::ParsedArgumentOwning&,
                                          unsigned,
-                                         std::span<std::string>) mutable -> decl::ParseControl {
+                                         backend::ArgvView) mutable -> decl::ParseControl {
             if(std::invoke(fn, std::as_const(res.options), &accessor)) {
                 return decl::ParseControl::next();
             }
@@ -770,7 +779,7 @@ std::expected<ParsedResult<T>, ParseError> parse_with_callback(std::span<std::st
 }
 
 template <typename T>
-std::expected<Invocation<T>, ParseError> invoke(std::span<std::string> argv,
+std::expected<Invocation<T>, ParseError> invoke(backend::ArgvView argv,
                                                 const text::Renderer& formatter) {
     return detail::run_parse_session<T>(
         argv,
@@ -781,7 +790,7 @@ std::expected<Invocation<T>, ParseError> invoke(std::span<std::string> argv,
 }
 
 template <typename T>
-std::expected<Invocation<T>, ParseError> invoke(std::span<std::string> argv) {
+std::expected<Invocation<T>, ParseError> invoke(backend::ArgvView argv) {
     return detail::run_parse_session<T>(
         argv,
         [](auto&, decl::DecoOptionBase&, const backend::ParsedArgumentOwning&, unsigned, auto) {
@@ -790,13 +799,13 @@ std::expected<Invocation<T>, ParseError> invoke(std::span<std::string> argv) {
 }
 
 template <typename T>
-std::expected<Invocation<T>, ParseError> parse(std::span<std::string> argv,
+std::expected<Invocation<T>, ParseError> parse(backend::ArgvView argv,
                                                const text::Renderer& formatter) {
     return invoke<T>(argv, formatter);
 }
 
 template <typename T>
-std::expected<Invocation<T>, ParseError> parse(std::span<std::string> argv) {
+std::expected<Invocation<T>, ParseError> parse(backend::ArgvView argv) {
     return invoke<T>(argv);
 }
 
@@ -810,7 +819,7 @@ class Command {
         runtime_callable_t<decl::ParseControl(invocation_t&,
                                               const backend::ParsedArgumentOwning&,
                                               unsigned,
-                                              std::span<std::string>,
+                                              backend::ArgvView,
                                               decl::DecoOptionBase&)>;
 
     struct CategoryMatch {
@@ -938,7 +947,7 @@ public:
                            invocation_t& invocation,
                            const backend::ParsedArgumentOwning& arg,
                            unsigned cursor,
-                           std::span<std::string> argv,
+                           backend::ArgvView argv,
                            decl::DecoOptionBase& accessor) mutable -> decl::ParseControl {
                 auto& typed_option = static_cast<OptionTy&>(accessor);
                 AfterStep<T, ValueTy> step(invocation, arg, cursor, argv, typed_option.value());
@@ -1021,7 +1030,7 @@ public:
         return render_with(text::ModernRenderer(std::move(config)));
     }
 
-    auto invoke(std::span<std::string> argv) -> std::expected<invocation_t, ParseError> {
+    auto invoke(backend::ArgvView argv) -> std::expected<invocation_t, ParseError> {
         std::optional<text::Renderer> fallback_renderer = make_fallback_renderer();
         const text::Renderer* active_renderer = renderer_ptr();
         if(fallback_renderer.has_value()) {
@@ -1034,7 +1043,7 @@ public:
                                     decl::DecoOptionBase& accessor,
                                     const backend::ParsedArgumentOwning& arg,
                                     unsigned cursor,
-                                    std::span<std::string> active_argv) {
+                                    backend::ArgvView active_argv) {
                 if(afterHooks.empty()) {
                     return decl::ParseControl::next();
                 }
@@ -1079,7 +1088,7 @@ public:
                            fallback_renderer.has_value() ? &*fallback_renderer : renderer_ptr());
     }
 
-    auto execute(std::span<std::string> argv) -> void {
+    auto execute(backend::ArgvView argv) -> void {
         auto res = invoke(argv);
         if(!res.has_value()) {
             errorHandler(std::move(res.error()));
@@ -1097,7 +1106,7 @@ public:
         }
     }
 
-    auto operator()(std::span<std::string> argv) -> void {
+    auto operator()(backend::ArgvView argv) -> void {
         execute(argv);
     }
 };
@@ -1123,7 +1132,7 @@ class SubCommander {
     static auto adapt_handler(Handler&& handler) -> handler_fn_t {
         using HandlerTy = std::remove_cvref_t<Handler>;
         return handler_fn_t([handler = std::forward<Handler>(handler)](match_t match) mutable {
-            if constexpr(std::is_invocable_v<HandlerTy&, std::span<std::string>>) {
+            if constexpr(std::is_invocable_v<HandlerTy&, backend::ArgvView>) {
                 handler(match.args());
             } else if constexpr(std::is_invocable_v<HandlerTy&, match_t>) {
                 handler(std::move(match));
@@ -1132,7 +1141,7 @@ class SubCommander {
             } else {
                 static_assert(
                     always_false_v<HandlerTy>,
-                    "SubCommander handler must accept std::span<std::string> or " "SubCommandMatch.");
+                    "SubCommander handler must accept backend::ArgvView or " "SubCommandMatch.");
             }
         });
     }
@@ -1168,7 +1177,7 @@ public:
 
     template <typename Handler>
         requires (!std::same_as<std::remove_cvref_t<Handler>, handler_fn_t> &&
-                  (std::is_invocable_v<std::remove_cvref_t<Handler>&, std::span<std::string>> ||
+                  (std::is_invocable_v<std::remove_cvref_t<Handler>&, backend::ArgvView> ||
                    std::is_invocable_v<std::remove_cvref_t<Handler>&, match_t> ||
                    std::is_invocable_v<std::remove_cvref_t<Handler>&, const match_t&>))
     auto& add(const decl::SubCommand& subcommand, Handler&& handler) {
@@ -1191,7 +1200,7 @@ public:
 
     template <typename Handler>
         requires (!std::same_as<std::remove_cvref_t<Handler>, handler_fn_t> &&
-                  (std::is_invocable_v<std::remove_cvref_t<Handler>&, std::span<std::string>> ||
+                  (std::is_invocable_v<std::remove_cvref_t<Handler>&, backend::ArgvView> ||
                    std::is_invocable_v<std::remove_cvref_t<Handler>&, match_t> ||
                    std::is_invocable_v<std::remove_cvref_t<Handler>&, const match_t&>))
     auto& add(Handler&& default_handler) {
@@ -1219,9 +1228,9 @@ public:
     auto when_err(error_fn_t error_handler) -> SubCommander&;
     auto when_err(std::ostream& os) -> SubCommander&;
     void usage(std::ostream& os) const;
-    auto match(std::span<std::string> argv) const -> std::expected<match_t, SubCommandError>;
-    void parse(std::span<std::string> argv);
-    void operator()(std::span<std::string> argv);
+    auto match(backend::ArgvView argv) const -> std::expected<match_t, SubCommandError>;
+    void parse(backend::ArgvView argv);
+    void operator()(backend::ArgvView argv);
 };
 
 };  // namespace kota::deco::cli
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "./config.h"
+#include "kota/option/detail/argv_view.h"
 
 namespace kota::deco::cli::text {
 
@@ -19,7 +20,7 @@ using ModernRendererConfig = ::kota::deco::config::ModernRendererConfig;
 
 struct Diagnostic {
     std::string message;
-    std::span<const std::string> argv{};
+    ::kota::option::ArgvView argv{};
     unsigned begin = 0;
     unsigned end = 0;
     bool positioned = false;
@@ -57,7 +58,7 @@ struct SubCommandDocument {
 
 auto looks_like_rendered_diagnostic(std::string_view text) -> bool;
 
-auto diagnostic_at(std::span<const std::string> argv,
+auto diagnostic_at(::kota::option::ArgvView argv,
                    unsigned begin,
                    unsigned end,
                    std::string message) -> Diagnostic;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "kota/ipc/transport.h"
+
+namespace kota::ipc {
+
+/// Stream transport that frames each message with a 4-byte little-endian
+/// payload length instead of a Content-Length header, for binary codecs
+/// such as bincode: finding a message's end is a fixed-size read, with no
+/// header text to scan or parse.
+///
+/// Both ends must use it; it does not interoperate with StreamTransport.
+class BinaryFramedTransport : public Transport {
+public:
+    /// Largest payload accepted; a longer frame ends reading.
+    constexpr static std::size_t max_payload = 64 * 1024 * 1024;
+
+    BinaryFramedTransport(stream input, stream output);
+    explicit BinaryFramedTransport(stream stream);
+
+    static Result<std::unique_ptr<BinaryFramedTransport>> open_stdio(event_loop& loop);
+
+    task<std::optional<std::string>> read_message() override;
+
+    /// Borrows the payload when the whole frame is already buffered.
+    task<std::optional<BorrowedMessage>> read_borrowed() override;
+
+    task<void, Error> write_message(std::string_view payload) override;
+
+    task<void, Error> write_messages(std::span<const std::string_view> payloads) override;
+
+    void cork() override;
+
+    task<void, Error> uncork() override;
+
+    Result<void> close_output() override;
+
+    Result<void> close() override;
+
+private:
+    stream& output() noexcept {
+        return shared_stream ? read_stream : write_stream;
+    }
+
+    stream read_stream;
+    stream write_stream;
+    bool shared_stream = false;
+};
+
+}  // namespace kota::ipc
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include "kota/ipc/protocol.h"
@@ -14,15 +15,19 @@ template <typename T>
 using Result = outcome<T, Error>;
 
 /// Typed incoming message alternatives (codec-agnostic).
+///
+/// Request and notification params are views into the payload passed to
+/// parse_message(), sliced out without copying; they are only valid while
+/// that payload is.
 struct IncomingRequest {
     protocol::RequestID id;
     std::string method;
-    std::string params;
+    std::string_view params;
 };
 
 struct IncomingNotification {
     std::string method;
-    std::string params;
+    std::string_view params;
 };
 
 struct IncomingResponse {
@@ -39,6 +44,14 @@ struct IncomingParseError {
     Error error;
 };
 
+/// A request decoded together with its params, for codecs that can decode
+/// a message straight into the handler's param type.
+template <typename Params>
+struct TypedIncomingRequest {
+    protocol::RequestID id;
+    Params params;
+};
+
 using IncomingMessage = std::variant<IncomingRequest,
                                      IncomingNotification,
                                      IncomingResponse,
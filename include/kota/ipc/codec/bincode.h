@@ -3,6 +3,9 @@
 #include <concepts>
 #include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
 
 #include "kota/ipc/codec.h"
 #include "kota/ipc/peer.h"
@@ -20,11 +23,10 @@ struct serialize_traits<bincode::Serializer<Config>, kota::ipc::protocol::Reques
     static auto serialize(bincode::Serializer<Config>& serializer,
                           const kota::ipc::protocol::RequestID& id)
         -> std::expected<value_type, error_type> {
-        auto* int_id = std::get_if<std::int64_t>(&id);
-        if(!int_id) {
+        if(!id.is_integer()) {
             return std::unexpected(error_type::type_mismatch);
         }
-        return codec::serialize(serializer, *int_id);
+        return codec::serialize(serializer, id.as_integer());
     }
 };
 
@@ -40,13 +42,61 @@ struct deserialize_traits<bincode::Deserializer<Config>, kota::ipc::protocol::Re
         if(!status) {
             return std::unexpected(status.error());
         }
-        id.emplace<std::int64_t>(v);
+        id = v;
         return {};
     }
 };
 
 }  // namespace kota::codec
 
+namespace kota::ipc::detail {
+
+/// Params written in place of the encoded blob an envelope carries.
+template <typename T>
+struct bincode_nested {
+    const T* value = nullptr;
+};
+
+template <typename Params>
+struct typed_bincode_request {
+    protocol::RequestID id;
+    std::string_view method;
+    bincode_nested<Params> params;
+};
+
+template <typename Params>
+struct typed_bincode_notification {
+    std::string_view method;
+    bincode_nested<Params> params;
+};
+
+// The alternative indices match those of bincode_envelope in bincode.cpp,
+// so these encode to the same bytes as the envelopes parse_message() reads.
+template <typename Params>
+using typed_bincode_request_envelope = std::variant<typed_bincode_request<Params>>;
+
+template <typename Params>
+using typed_bincode_notification_envelope =
+    std::variant<std::monostate, typed_bincode_notification<Params>>;
+
+}  // namespace kota::ipc::detail
+
+namespace kota::codec {
+
+template <typename Config, typename T>
+struct serialize_traits<bincode::Serializer<Config>, kota::ipc::detail::bincode_nested<T>> {
+    using value_type = typename bincode::Serializer<Config>::value_type;
+    using error_type = typename bincode::Serializer<Config>::error_type;
+
+    static auto serialize(bincode::Serializer<Config>& serializer,
+                          const kota::ipc::detail::bincode_nested<T>& nested)
+        -> std::expected<value_type, error_type> {
+        return serializer.serialize_nested(*nested.value);
+    }
+};
+
+}  // namespace kota::codec
+
 namespace kota::ipc {
 
 class BincodeCodec {
@@ -64,14 +114,57 @@ public:
 
     Result<std::string> encode_error_response(const protocol::RequestID& id, const Error& error);
 
+    /// The same encodings written into `out`, replacing its contents but
+    /// reusing its capacity, so callers can recycle message buffers.
+    Result<void> encode_request(std::string& out,
+                                const protocol::RequestID& id,
+                                std::string_view method,
+                                std::string_view params);
+
+    Result<void> encode_notification(std::string& out,
+                                     std::string_view method,
+                                     std::string_view params);
+
+    Result<void> encode_success_response(std::string& out,
+                                         const protocol::RequestID& id,
+                                         std::string_view result);
+
+    Result<void> encode_error_response(std::string& out,
+                                       const protocol::RequestID& id,
+                                       const Error& error);
+
+    /// encode_request() and encode_notification() for params given as a
+    /// value, serialized straight into the envelope instead of into a blob
+    /// of their own first. The bytes are the same.
+    template <typename Params>
+    Result<void> encode_typed_request(std::string& out,
+                                      const protocol::RequestID& id,
+                                      std::string_view method,
+                                      const Params& params) {
+        return write_typed(out,
+                           detail::typed_bincode_request_envelope<Params>{
+                               detail::typed_bincode_request<Params>{id, method, {&params}}});
+    }
+
+    template <typename Params>
+    Result<void> encode_typed_notification(std::string& out,
+                                           std::string_view method,
+                                           const Params& params) {
+        return write_typed(
+            out,
+            detail::typed_bincode_notification_envelope<Params>{
+                std::in_place_index<1>,
+                detail::typed_bincode_notification<Params>{method, {&params}}});
+    }
+
     template <typename T>
     Result<std::string> serialize_value(const T& value) {
-        auto bytes = codec::bincode::to_bytes(value);
-        if(!bytes) {
-            return outcome_error(
-                Error(protocol::ErrorCode::InternalError, bytes.error().to_string()));
+        std::string out;
+        auto status = write_typed(out, value);
+        if(status.has_error()) {
+            return outcome_error(std::move(status.error()));
         }
-        return std::string(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+        return out;
     }
 
     template <typename T>
@@ -93,6 +186,26 @@ public:
         }
         return value;
     }
+
+private:
+    template <typename Envelope>
+    static Result<void> write_typed(std::string& out, const Envelope& envelope) {
+        // One serializer per thread, cleared before each message, so its
+        // buffer is reused.
+        thread_local codec::bincode::Serializer<> writer;
+        writer.clear();
+
+        auto status = codec::serialize(writer, envelope);
+        if(!status || !writer.valid()) {
+            auto kind = status ? writer.error() : status.error();
+            return outcome_error(Error(protocol::ErrorCode::InternalError,
+                                       codec::bincode::error(kind).to_string()));
+        }
+
+        auto bytes = writer.bytes();
+        out.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return {};
+    }
 };
 
 using BincodePeer = Peer<BincodeCodec>;
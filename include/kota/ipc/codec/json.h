@@ -1,6 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "kota/ipc/codec.h"
 #include "kota/ipc/peer.h"
@@ -15,10 +26,43 @@ struct lsp_config {
     using field_rename = codec::rename_policy::lower_camel;
 };
 
+namespace detail {
+
+template <typename Params>
+struct typed_request_envelope {
+    std::optional<protocol::RequestID> id;
+    std::optional<Params> params;
+};
+
+}  // namespace detail
+
 class JsonCodec {
 public:
     IncomingMessage parse_message(std::string_view payload);
 
+    /// Whether `payload` is a JSON-RPC batch, i.e. a top-level array.
+    static bool is_batch(std::string_view payload) noexcept;
+
+    /// The messages of a batch, as views into `payload`, each to be passed
+    /// to parse_message() in turn.
+    Result<std::vector<std::string_view>> split_batch(std::string_view payload);
+
+    /// Joins encoded messages into one batch array, replacing `out`.
+    Result<void> encode_batch(std::string& out, std::span<const std::string> messages);
+
+    /// Top-level "method" of a request or notification, found by scanning
+    /// the payload rather than parsing it. nullopt when it cannot be found
+    /// that way (absent, escaped, malformed JSON); parse_message() then
+    /// handles the message.
+    static std::optional<std::string_view> peek_method(std::string_view payload);
+
+    /// Decodes a request whose params are a `Params` in the same pass as its
+    /// id, instead of extracting params as raw text and parsing them again.
+    /// Fails for anything that is not such a request; parse_message() then
+    /// tells what it is.
+    template <typename Params>
+    Result<TypedIncomingRequest<Params>> decode_request(std::string_view payload);
+
     Result<std::string> encode_request(const protocol::RequestID& id,
                                        std::string_view method,
                                        std::string_view params);
@@ -30,33 +74,166 @@ public:
 
     Result<std::string> encode_error_response(const protocol::RequestID& id, const Error& error);
 
+    /// The same encodings written into `out`, replacing its contents but
+    /// reusing its capacity, so callers can recycle message buffers.
+    Result<void> encode_request(std::string& out,
+                                const protocol::RequestID& id,
+                                std::string_view method,
+                                std::string_view params);
+
+    Result<void> encode_notification(std::string& out,
+                                     std::string_view method,
+                                     std::string_view params);
+
+    Result<void> encode_success_response(std::string& out,
+                                         const protocol::RequestID& id,
+                                         std::string_view result);
+
+    Result<void> encode_error_response(std::string& out,
+                                       const protocol::RequestID& id,
+                                       const Error& error);
+
     template <typename T>
-    Result<std::string> serialize_value(const T& value) {
-        auto serialized = codec::json::to_string<lsp_config>(value);
-        if(!serialized) {
-            return outcome_error(
-                Error(protocol::ErrorCode::InternalError, serialized.error().to_string()));
-        }
-        return std::move(*serialized);
-    }
+    Result<std::string> serialize_value(const T& value);
 
     template <typename T>
     Result<T> deserialize_value(std::string_view raw,
-                                protocol::ErrorCode code = protocol::ErrorCode::RequestFailed) {
-        if(raw.empty()) {
-            if constexpr(std::is_same_v<T, protocol::null> || std::is_same_v<T, protocol::Value>) {
-                raw = "null";
-            } else {
-                raw = "{}";
-            }
+                                protocol::ErrorCode code = protocol::ErrorCode::RequestFailed);
+};
+
+// Defined out of class, so they are not inline and an explicit
+// instantiation elsewhere (see kota/ipc/lsp/json_codec.h) can stand in for
+// them.
+
+template <typename Params>
+Result<TypedIncomingRequest<Params>> JsonCodec::decode_request(std::string_view payload) {
+    auto parsed = codec::json::parse<detail::typed_request_envelope<Params>, lsp_config>(
+        codec::json::parse_context::local(),
+        payload);
+    if(!parsed) {
+        return outcome_error(Error(protocol::ErrorCode::ParseError, parsed.error().to_string()));
+    }
+    if(!parsed->id) {
+        return outcome_error(Error(protocol::ErrorCode::InvalidRequest, "request has no id"));
+    }
+    if(!parsed->params) {
+        auto params = deserialize_value<Params>({}, protocol::ErrorCode::InvalidParams);
+        if(!params) {
+            return outcome_error(params.error());
         }
-        auto parsed = codec::json::parse<T, lsp_config>(raw);
-        if(!parsed) {
-            return outcome_error(Error(code, parsed.error().to_string()));
+        parsed->params = std::move(*params);
+    }
+    return TypedIncomingRequest<Params>{std::move(*parsed->id), std::move(*parsed->params)};
+}
+
+template <typename T>
+Result<std::string> JsonCodec::serialize_value(const T& value) {
+    std::string out;
+    if(auto status = codec::json::to_json_into<lsp_config>(out, value); !status) {
+        return outcome_error(Error(protocol::ErrorCode::InternalError, status.error().to_string()));
+    }
+    return out;
+}
+
+template <typename T>
+Result<T> JsonCodec::deserialize_value(std::string_view raw, protocol::ErrorCode code) {
+    if(raw.empty()) {
+        if constexpr(std::is_same_v<T, protocol::null> || std::is_same_v<T, protocol::Value>) {
+            raw = "null";
+        } else {
+            raw = "{}";
         }
-        return std::move(*parsed);
     }
-};
+    auto parsed = codec::json::parse<T, lsp_config>(codec::json::parse_context::local(), raw);
+    if(!parsed) {
+        return outcome_error(Error(code, parsed.error().to_string()));
+    }
+    return std::move(*parsed);
+}
+
+/// Decodes the JSON array arriving on `input` element by element, passing
+/// each to `on_element` as std::expected<T, codec::json::error> as soon as
+/// its bytes have been read; see codec::json::array_push_parser. Decoding
+/// overlaps the receive, and only the element in flight is buffered rather
+/// than the whole array. Returns the number of elements.
+///
+/// Reads exactly `length` bytes when given, e.g. a message body whose
+/// Content-Length has been read, and otherwise stops after the closing
+/// bracket, leaving what follows buffered in `input`. Fails when the stream
+/// ends first or the bytes are not an array.
+template <typename T, typename Config = lsp_config, typename F>
+task<std::size_t, Error> read_json_array(stream& input,
+                                         F on_element,
+                                         std::optional<std::size_t> length = std::nullopt) {
+    codec::json::array_push_parser<T, Config> parser;
+    auto remaining = length.value_or((std::numeric_limits<std::size_t>::max)());
+    std::size_t count = 0;
+
+    while(remaining != 0 && (length || !parser.done())) {
+        auto chunk = co_await input.read_chunk();
+        if(!chunk) {
+            co_await fail(std::string(chunk.error().message()));
+        }
+
+        const auto before = parser.offset();
+        const auto size = std::min(chunk->size(), remaining);
+        auto decoded = parser.feed(std::string_view(chunk->data(), size), on_element);
+        const auto used = decoded ? parser.offset() - before : size;
+        input.consume(used);
+        remaining -= used;
+        if(!decoded) {
+            co_await fail(protocol::ErrorCode::ParseError, decoded.error().to_string());
+        }
+        count += *decoded;
+    }
+
+    if(auto status = parser.finish(); !status) {
+        co_await fail(protocol::ErrorCode::ParseError, status.error().to_string());
+    }
+    co_return count;
+}
+
+/// Decodes the top-level array `json` as a std::vector<T>, decoding its
+/// elements on queue()'s thread pool, `grain` at a time (see parallel_for()).
+/// The array is indexed in one pass on the calling thread, and the elements
+/// are then decoded straight into their slots of the presized vector. This
+/// pays off for arrays of many thousands of elements; codec::json::parse()
+/// is faster for small ones.
+template <typename T, typename Config = lsp_config>
+    requires std::default_initializable<T> && (!std::same_as<T, bool>)
+task<std::vector<T>, Error> parse_array_parallel(std::string_view json,
+                                                 std::size_t grain = 0,
+                                                 event_loop& loop = event_loop::current()) {
+    simdjson::padded_string padded(json);
+    auto index = codec::json::array_index::build(padded);
+    if(!index) {
+        co_await fail(protocol::ErrorCode::ParseError, index.error().to_string());
+    }
+
+    std::vector<T> values(index->size());
+    std::mutex failure_mutex;
+    std::optional<std::pair<std::size_t, codec::json::error>> failure;
+    auto decode = [&](T& value) {
+        const auto i = static_cast<std::size_t>(&value - values.data());
+        if(auto status = index->template decode<Config>(i, value); !status) {
+            std::lock_guard lock(failure_mutex);
+            if(!failure || i < failure->first) {
+                failure.emplace(i, status.error());
+            }
+        }
+    };
+
+    auto status = co_await parallel_for(values, decode, grain, loop);
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
+    if(failure) {
+        co_await fail(protocol::ErrorCode::ParseError,
+                      "element " + std::to_string(failure->first) + ": " +
+                          failure->second.to_string());
+    }
+    co_return values;
+}
 
 using JsonPeer = Peer<JsonCodec>;
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "kota/ipc/transport.h"
+
+namespace kota::ipc {
+
+/// Transport decorator that compresses large messages with the LZ4 block
+/// format, for links where bandwidth costs more than CPU.
+///
+/// Before its first message the sending side writes a hello naming the
+/// format; after it, every message is a one-byte tag followed by either the
+/// payload as is or its uncompressed size (4 bytes, little-endian) and the
+/// compressed block. Each direction keeps the last 64 KiB it carried as a
+/// dictionary for the next message, so the envelopes and keys repeated
+/// from one JSON-RPC message to the next cost a few bytes each even in
+/// small messages.
+///
+/// A reader that sees no hello passes messages through unchanged, so a
+/// compressing receiver still talks to a plain sender; a plain receiver
+/// cannot read a compressing sender, so both ends must wrap their transport
+/// to enable `compress`. A message that fails to decompress ends the input,
+/// like a malformed frame does.
+class CompressingTransport : public Transport {
+public:
+    struct options {
+        /// Payloads shorter than this are sent uncompressed, though still
+        /// added to the dictionary.
+        std::size_t threshold = 1024;
+
+        /// Whether outgoing messages are compressed. When false no hello is
+        /// sent and messages go out unchanged.
+        bool compress = true;
+    };
+
+    CompressingTransport(std::unique_ptr<Transport> transport, options opts);
+
+    explicit CompressingTransport(std::unique_ptr<Transport> transport) :
+        CompressingTransport(std::move(transport), options{}) {}
+
+    task<std::optional<std::string>> read_message() override;
+    task<void, Error> write_message(std::string_view payload) override;
+    task<void, Error> write_messages(std::span<const std::string_view> payloads) override;
+    void cork() override;
+    task<void, Error> uncork() override;
+    Result<void> close_output() override;
+    Result<void> close() override;
+
+private:
+    enum class input_mode { unknown, plain, framed };
+
+    /// Frames `payload` for the wire and adds it to the output dictionary.
+    std::string encode(std::string_view payload);
+
+    /// Decodes a framed message and adds it to the input dictionary.
+    std::optional<std::string> decode(std::string_view frame);
+
+    std::unique_ptr<Transport> inner;
+    options opts;
+
+    bool hello_sent = false;
+    input_mode mode = input_mode::unknown;
+
+    // The last bytes carried in each direction, which compressed blocks may
+    // refer back into.
+    std::string output_history;
+    std::string input_history;
+};
+
+}  // namespace kota::ipc
@@ -1,8 +1,26 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <format>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// Messages below this level, 0 (trace) to 4 (error), are compiled out of
+/// the peer: define it to 2, say, and no trace or debug call is left in the
+/// binary, whatever level a logger is set to at run time.
+#ifndef KOTA_IPC_LOG_LEVEL
+#define KOTA_IPC_LOG_LEVEL 0
+#endif
 
 namespace kota::ipc {
 
@@ -16,4 +34,115 @@ enum class LogLevel : std::uint8_t {
 
 using LogCallback = std::function<void(LogLevel, std::string)>;
 
+constexpr LogLevel compiled_log_level = static_cast<LogLevel>(KOTA_IPC_LOG_LEVEL);
+
+/// A logger that keeps formatting off the thread that logs. push() copies
+/// the format arguments into a ring and returns; a background thread
+/// formats the records in order and hands each to the sink.
+///
+/// The ring has a single producer: all peers feeding one DeferredLog must
+/// run on the same loop, so use one per loop. push() takes no lock and
+/// never waits; when the ring is full the record is dropped and counted.
+/// The sink runs on the background thread.
+class DeferredLog {
+public:
+    explicit DeferredLog(LogCallback sink, std::size_t capacity = 4096);
+
+    DeferredLog(const DeferredLog&) = delete;
+    DeferredLog& operator=(const DeferredLog&) = delete;
+
+    /// Formats and delivers whatever is still queued, then stops the thread.
+    ~DeferredLog();
+
+    /// Queues std::format(fmt, args...) at `level`. Strings and string
+    /// views are copied, as the text they refer to may be gone by the time
+    /// the record is formatted; `fmt` itself must outlive the record, as a
+    /// string literal does. Returns false if the ring is full.
+    template <typename... Args>
+    bool push(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        using captured = std::tuple<stored_t<Args>...>;
+
+        const auto tail = write_index.load(std::memory_order_relaxed);
+        if(tail - read_index.load(std::memory_order_acquire) == capacity) {
+            dropped_records.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& slot = records[tail & (capacity - 1)];
+        slot.level = level;
+        slot.fmt = fmt.get();
+        if constexpr(sizeof(captured) <= inline_args &&
+                     alignof(captured) <= alignof(std::max_align_t)) {
+            ::new(slot.args) captured(std::forward<Args>(args)...);
+            slot.render = [](record& r, std::string& out) {
+                auto* values = std::launder(reinterpret_cast<captured*>(r.args));
+                render_args(r.fmt, *values, out);
+                values->~captured();
+            };
+        } else {
+            ::new(slot.args) captured*(new captured(std::forward<Args>(args)...));
+            slot.render = [](record& r, std::string& out) {
+                std::unique_ptr<captured> values(
+                    *std::launder(reinterpret_cast<captured**>(r.args)));
+                render_args(r.fmt, *values, out);
+            };
+        }
+
+        publish(tail + 1);
+        return true;
+    }
+
+    /// Blocks until every record pushed so far has reached the sink.
+    void flush();
+
+    /// Records dropped because the ring was full.
+    std::uint64_t dropped() const noexcept {
+        return dropped_records.load(std::memory_order_relaxed);
+    }
+
+private:
+    template <typename T>
+    using stored_t =
+        std::conditional_t<std::is_convertible_v<T, std::string_view>, std::string, std::decay_t<T>>;
+
+    /// Arguments up to this size are stored in the record itself.
+    constexpr static std::size_t inline_args = 64;
+
+    struct record {
+        LogLevel level = LogLevel::trace;
+        std::string_view fmt;
+
+        /// Formats the captured arguments into `out` and destroys them.
+        void (*render)(record&, std::string& out) = nullptr;
+
+        alignas(std::max_align_t) std::byte args[inline_args];
+    };
+
+    template <typename Tuple>
+    static void render_args(std::string_view fmt, Tuple& values, std::string& out) {
+        std::apply(
+            [&](auto&... unpacked) {
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(unpacked...));
+            },
+            values);
+    }
+
+    /// Makes records up to `tail` visible and wakes the thread if it sleeps.
+    void publish(std::size_t tail);
+
+    void drain();
+
+    const std::size_t capacity;
+    std::unique_ptr<record[]> records;
+    LogCallback sink;
+
+    alignas(64) std::atomic<std::size_t> write_index{0};
+    alignas(64) std::atomic<std::size_t> read_index{0};
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> dropped_records{0};
+
+    std::thread worker;
+};
+
 }  // namespace kota::ipc
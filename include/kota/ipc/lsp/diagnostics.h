@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "kota/support/flat_hash_map.h"
+#include "kota/async/async.h"
+#include "kota/codec/bincode/serializer.h"
+#include "kota/ipc/peer.h"
+#include "kota/ipc/lsp/protocol.h"
+
+namespace kota::ipc::lsp {
+
+/// Sends `textDocument/publishDiagnostics` for a server that re-analyzes
+/// documents often. Each URI remembers a hash of the diagnostics it last
+/// sent, and a publish with the same list is dropped. With a window,
+/// publishes are held for up to that long: a later publish for the same
+/// URI replaces the held one, and everything held goes out together in one
+/// batch once the window closes or flush() is called. Anything still held
+/// when the publisher is destroyed is dropped.
+///
+/// Must be used on the loop thread.
+template <typename PeerT>
+class DiagnosticsPublisher {
+public:
+    explicit DiagnosticsPublisher(PeerT& peer,
+                                  std::chrono::milliseconds window = std::chrono::milliseconds::zero(),
+                                  event_loop& loop = event_loop::current()) :
+        peer(peer), window(window), loop(loop) {}
+
+    DiagnosticsPublisher(const DiagnosticsPublisher&) = delete;
+    DiagnosticsPublisher& operator=(const DiagnosticsPublisher&) = delete;
+
+    /// Publishes `params`, unless the client already has the same list.
+    Result<void> publish(protocol::PublishDiagnosticsParams params) {
+        auto hash = hash_of(params.diagnostics);
+        if(!hash) {
+            return outcome_error(hash.error());
+        }
+
+        auto sent_it = sent.find(std::string_view(params.uri));
+        bool already_sent = sent_it != sent.end() && sent_it->second == *hash;
+
+        auto held_it = held.find(std::string_view(params.uri));
+        if(held_it != held.end()) {
+            if(already_sent) {
+                // Back to what the client shows; the held change is moot.
+                held.erase(held_it);
+            } else {
+                held_it->second = held_publish{std::move(params), *hash};
+            }
+            return {};
+        }
+        if(already_sent) {
+            return {};
+        }
+
+        if(window <= std::chrono::milliseconds::zero()) {
+            auto status = peer.send_notification(params);
+            if(status) {
+                sent.insert_or_assign(std::move(params.uri), *hash);
+            }
+            return status;
+        }
+
+        std::string uri = params.uri;
+        held.insert_or_assign(std::move(uri), held_publish{std::move(params), *hash});
+        if(!timer_armed) {
+            timer_armed = true;
+            loop.schedule(flush_after(timer.token()));
+        }
+        return {};
+    }
+
+    /// Sends every held publish now, in one batch.
+    Result<void> flush() {
+        if(held.empty()) {
+            return {};
+        }
+
+        auto batch = peer.batch();
+        for(auto& [uri, entry]: held) {
+            auto status = batch.notify(entry.params);
+            if(!status) {
+                return status;
+            }
+        }
+        for(auto& [uri, entry]: held) {
+            sent.insert_or_assign(uri, entry.hash);
+        }
+        held.clear();
+        return batch.send();
+    }
+
+    /// Forgets what was sent for `uri`, e.g. once it is closed, so the
+    /// next publish for it always goes out.
+    void forget(std::string_view uri) {
+        sent.erase(uri);
+        held.erase(uri);
+    }
+
+    /// Publishes waiting for the window to close.
+    std::size_t pending() const noexcept {
+        return held.size();
+    }
+
+private:
+    struct held_publish {
+        protocol::PublishDiagnosticsParams params;
+        std::uint64_t hash = 0;
+    };
+
+    task<> flush_after(cancellation_token token) {
+        auto waited = co_await with_token(after(window, loop), token);
+        if(!waited.has_value()) {
+            co_return;
+        }
+        timer_armed = false;
+        (void)flush();
+    }
+
+    Result<std::uint64_t> hash_of(const std::vector<protocol::Diagnostic>& diagnostics) {
+        scratch.clear();
+        auto status = codec::bincode::to_bytes_into(scratch, diagnostics);
+        if(!status) {
+            return outcome_error(Error(status.error().to_string()));
+        }
+        std::string_view bytes(reinterpret_cast<const char*>(scratch.data()), scratch.size());
+        return static_cast<std::uint64_t>(std::hash<std::string_view>{}(bytes));
+    }
+
+    PeerT& peer;
+    std::chrono::milliseconds window;
+    event_loop& loop;
+
+    flat_hash_map<std::string, std::uint64_t> sent;
+    flat_hash_map<std::string, held_publish> held;
+
+    // Reused to serialize each list before hashing it.
+    std::vector<std::byte> scratch;
+
+    cancellation_source timer;
+    bool timer_armed = false;
+};
+
+}  // namespace kota::ipc::lsp
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "kota/support/flat_hash_map.h"
+#include "kota/support/interned_string.h"
+#include "kota/support/rope.h"
+#include "kota/ipc/lsp/position.h"
+#include "kota/ipc/lsp/protocol.h"
+
+namespace kota::ipc::lsp {
+
+/// Text of an open document, kept in step with `textDocument/didChange`.
+///
+/// The text is kept in a rope, and the PositionMapper reads the line and
+/// UTF-16 counts the rope caches, so converting a position and applying a
+/// ranged change each take O(log n) plus the size of the change, however
+/// large the document is. Nothing is copied or rebuilt per change.
+///
+/// The mapper views the text this object owns, so it can be neither copied
+/// nor moved; keep documents in a node-based container or behind a pointer.
+class TextDocument {
+public:
+    TextDocument(std::string_view text, PositionEncoding encoding);
+
+    TextDocument(const TextDocument&) = delete;
+    TextDocument& operator=(const TextDocument&) = delete;
+
+    /// Applies one change. Returns false, leaving the document as it was,
+    /// when its range does not lie within the document.
+    bool apply(const protocol::TextDocumentContentChangeEvent& change);
+
+    /// Applies `changes` in order, each against the result of the one
+    /// before, as `DidChangeTextDocumentParams::content_changes` requires.
+    /// Returns false, leaving the document as it was, when one of them
+    /// does not apply.
+    bool apply(std::span<const protocol::TextDocumentContentChangeEvent> changes);
+
+    const kota::rope& text() const noexcept {
+        return content;
+    }
+
+    const PositionMapper& positions() const noexcept {
+        return mapper;
+    }
+
+private:
+    kota::rope content;
+    PositionMapper mapper;
+};
+
+/// One version of an open document. Copies share the text and nothing
+/// changes it, so a snapshot can be read on any thread, such as by work
+/// handed to queue(), while the store goes on applying edits.
+class DocumentSnapshot {
+public:
+    DocumentSnapshot() = default;
+
+    /// False for a default-constructed snapshot.
+    explicit operator bool() const noexcept {
+        return state != nullptr;
+    }
+
+    interned_string uri() const noexcept {
+        return state->uri;
+    }
+
+    protocol::integer version() const noexcept {
+        return state->version;
+    }
+
+    const kota::rope& text() const noexcept {
+        return state->text;
+    }
+
+    /// A mapper over this snapshot's text. It reads the counts the rope
+    /// keeps, so making one costs O(1); it is valid while the snapshot is.
+    PositionMapper positions() const {
+        return PositionMapper(state->text, state->encoding);
+    }
+
+private:
+    friend class DocumentStore;
+
+    struct snapshot_state {
+        interned_string uri;
+        protocol::integer version;
+        PositionEncoding encoding;
+        kota::rope text;
+    };
+
+    explicit DocumentSnapshot(std::shared_ptr<const snapshot_state> state) :
+        state(std::move(state)) {}
+
+    std::shared_ptr<const snapshot_state> state;
+};
+
+/// The open documents of a server, keyed by interned URI and kept in step
+/// with `didOpen`, `didChange` and `didClose`. The store belongs to the
+/// loop thread; the snapshots it hands out may go anywhere. Taking one
+/// shares the rope's nodes, and an edit copies only the nodes it changes,
+/// so neither side copies the document or waits for the other.
+class DocumentStore {
+public:
+    explicit DocumentStore(PositionEncoding encoding, string_pool& pool = string_pool::global()) :
+        encoding(encoding), pool(pool) {}
+
+    DocumentStore(const DocumentStore&) = delete;
+    DocumentStore& operator=(const DocumentStore&) = delete;
+
+    /// Opens `item`, replacing any document already open under its URI.
+    DocumentSnapshot open(const protocol::TextDocumentItem& item);
+
+    /// Applies a `didChange`. Returns false, leaving the document as it
+    /// was, when it is not open or one of the changes does not apply.
+    bool change(const protocol::DidChangeTextDocumentParams& params);
+
+    void close(std::string_view uri);
+
+    /// The current version of `uri`, or an empty snapshot when it is not
+    /// open. Snapshots taken between two edits share one state.
+    DocumentSnapshot snapshot(std::string_view uri);
+
+    std::size_t size() const noexcept {
+        return documents.size();
+    }
+
+private:
+    struct uri_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view uri) const noexcept {
+            return std::hash<std::string_view>{}(uri);
+        }
+    };
+
+    struct entry {
+        std::unique_ptr<TextDocument> document;
+        protocol::integer version = 0;
+
+        // The last snapshot handed out, until the next edit.
+        DocumentSnapshot latest;
+    };
+
+    PositionEncoding encoding;
+    string_pool& pool;
+    flat_hash_map<interned_string, entry, uri_hash> documents;
+};
+
+}  // namespace kota::ipc::lsp
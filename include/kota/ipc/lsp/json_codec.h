@@ -0,0 +1,258 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "kota/ipc/codec/json.h"
+#include "kota/ipc/lsp/protocol.h"
+
+/// Explicit-instantiation mode for the JSON codec of the LSP types.
+///
+/// Including this header declares JsonCodec's serialize_value(),
+/// deserialize_value() and decode_request() for every LSP request's params
+/// and result and every notification's params as extern templates, so a
+/// translation unit using them calls the copies kota::ipc::lsp_codec
+/// compiles once instead of instantiating the reflection and field dispatch
+/// behind them again. Link kota::ipc::lsp_codec when including it.
+///
+/// Each type is listed once, counting aliases such as protocol::Definition
+/// and protocol::Declaration: an explicit instantiation may appear only once
+/// in a program. A type missing from the lists is still instantiated where
+/// it is used, as without this header.
+
+// Every type a request or notification carries, params and results alike.
+#define KOTA_LSP_JSON_CODEC_TYPES(X) \
+    X((protocol::CallHierarchyIncomingCallsParams)) \
+    X((protocol::nullable<std::vector<protocol::CallHierarchyIncomingCall>>)) \
+    X((protocol::CallHierarchyOutgoingCallsParams)) \
+    X((protocol::nullable<std::vector<protocol::CallHierarchyOutgoingCall>>)) \
+    X((protocol::RegistrationParams)) \
+    X((protocol::null)) \
+    X((protocol::UnregistrationParams)) \
+    X((protocol::CodeAction)) \
+    X((protocol::CodeLens)) \
+    X((protocol::CompletionItem)) \
+    X((protocol::DocumentLink)) \
+    X((protocol::InitializeParams)) \
+    X((protocol::InitializeResult)) \
+    X((protocol::InlayHint)) \
+    X((protocol::ShutdownParams)) \
+    X((protocol::CodeActionParams)) \
+    X((protocol::nullable<std::vector<protocol::variant<protocol::Command, protocol::CodeAction>>>)) \
+    X((protocol::CodeLensParams)) \
+    X((protocol::nullable<std::vector<protocol::CodeLens>>)) \
+    X((protocol::ColorPresentationParams)) \
+    X((std::vector<protocol::ColorPresentation>)) \
+    X((protocol::CompletionParams)) \
+    X((protocol::variant<protocol::null, std::vector<protocol::CompletionItem>, protocol::CompletionList>)) \
+    X((protocol::DeclarationParams)) \
+    X((protocol::variant<protocol::null, protocol::Declaration, std::vector<protocol::DeclarationLink>>)) \
+    X((protocol::DefinitionParams)) \
+    X((protocol::DocumentDiagnosticParams)) \
+    X((protocol::DocumentDiagnosticReport)) \
+    X((protocol::DocumentColorParams)) \
+    X((std::vector<protocol::ColorInformation>)) \
+    X((protocol::DocumentHighlightParams)) \
+    X((protocol::nullable<std::vector<protocol::DocumentHighlight>>)) \
+    X((protocol::DocumentLinkParams)) \
+    X((protocol::nullable<std::vector<protocol::DocumentLink>>)) \
+    X((protocol::DocumentSymbolParams)) \
+    X((protocol::variant<protocol::null, std::vector<protocol::SymbolInformation>, std::vector<protocol::DocumentSymbol>>)) \
+    X((protocol::FoldingRangeParams)) \
+    X((protocol::nullable<std::vector<protocol::FoldingRange>>)) \
+    X((protocol::DocumentFormattingParams)) \
+    X((protocol::nullable<std::vector<protocol::TextEdit>>)) \
+    X((protocol::HoverParams)) \
+    X((protocol::nullable<protocol::Hover>)) \
+    X((protocol::ImplementationParams)) \
+    X((protocol::InlayHintParams)) \
+    X((protocol::nullable<std::vector<protocol::InlayHint>>)) \
+    X((protocol::InlineCompletionParams)) \
+    X((protocol::variant<protocol::null, protocol::InlineCompletionList, std::vector<protocol::InlineCompletionItem>>)) \
+    X((protocol::InlineValueParams)) \
+    X((protocol::nullable<std::vector<protocol::InlineValue>>)) \
+    X((protocol::LinkedEditingRangeParams)) \
+    X((protocol::nullable<protocol::LinkedEditingRanges>)) \
+    X((protocol::MonikerParams)) \
+    X((protocol::nullable<std::vector<protocol::Moniker>>)) \
+    X((protocol::DocumentOnTypeFormattingParams)) \
+    X((protocol::CallHierarchyPrepareParams)) \
+    X((protocol::nullable<std::vector<protocol::CallHierarchyItem>>)) \
+    X((protocol::PrepareRenameParams)) \
+    X((protocol::nullable<protocol::PrepareRenameResult>)) \
+    X((protocol::TypeHierarchyPrepareParams)) \
+    X((protocol::nullable<std::vector<protocol::TypeHierarchyItem>>)) \
+    X((protocol::DocumentRangeFormattingParams)) \
+    X((protocol::DocumentRangesFormattingParams)) \
+    X((protocol::ReferenceParams)) \
+    X((protocol::nullable<std::vector<protocol::Location>>)) \
+    X((protocol::RenameParams)) \
+    X((protocol::nullable<protocol::WorkspaceEdit>)) \
+    X((protocol::SelectionRangeParams)) \
+    X((protocol::nullable<std::vector<protocol::SelectionRange>>)) \
+    X((protocol::SemanticTokensParams)) \
+    X((protocol::nullable<protocol::SemanticTokens>)) \
+    X((protocol::SemanticTokensDeltaParams)) \
+    X((protocol::variant<protocol::null, protocol::SemanticTokens, protocol::SemanticTokensDelta>)) \
+    X((protocol::SemanticTokensRangeParams)) \
+    X((protocol::SignatureHelpParams)) \
+    X((protocol::nullable<protocol::SignatureHelp>)) \
+    X((protocol::TypeDefinitionParams)) \
+    X((protocol::WillSaveTextDocumentParams)) \
+    X((protocol::TypeHierarchySubtypesParams)) \
+    X((protocol::TypeHierarchySupertypesParams)) \
+    X((protocol::ShowDocumentParams)) \
+    X((protocol::ShowDocumentResult)) \
+    X((protocol::ShowMessageRequestParams)) \
+    X((protocol::nullable<protocol::MessageActionItem>)) \
+    X((protocol::WorkDoneProgressCreateParams)) \
+    X((protocol::ApplyWorkspaceEditParams)) \
+    X((protocol::ApplyWorkspaceEditResult)) \
+    X((protocol::CodeLensRefreshParams)) \
+    X((protocol::ConfigurationParams)) \
+    X((std::vector<protocol::LSPAny>)) \
+    X((protocol::WorkspaceDiagnosticParams)) \
+    X((protocol::WorkspaceDiagnosticReport)) \
+    X((protocol::DiagnosticRefreshParams)) \
+    X((protocol::ExecuteCommandParams)) \
+    X((protocol::nullable<protocol::LSPAny>)) \
+    X((protocol::FoldingRangeRefreshParams)) \
+    X((protocol::InlayHintRefreshParams)) \
+    X((protocol::InlineValueRefreshParams)) \
+    X((protocol::SemanticTokensRefreshParams)) \
+    X((protocol::WorkspaceSymbolParams)) \
+    X((protocol::variant<protocol::null, std::vector<protocol::SymbolInformation>, std::vector<protocol::WorkspaceSymbol>>)) \
+    X((protocol::TextDocumentContentParams)) \
+    X((protocol::TextDocumentContentResult)) \
+    X((protocol::TextDocumentContentRefreshParams)) \
+    X((protocol::CreateFilesParams)) \
+    X((protocol::DeleteFilesParams)) \
+    X((protocol::RenameFilesParams)) \
+    X((protocol::WorkspaceFoldersParams)) \
+    X((protocol::nullable<std::vector<protocol::WorkspaceFolder>>)) \
+    X((protocol::WorkspaceSymbol)) \
+    X((protocol::CancelParams)) \
+    X((protocol::LogTraceParams)) \
+    X((protocol::ProgressParams)) \
+    X((protocol::SetTraceParams)) \
+    X((protocol::ExitParams)) \
+    X((protocol::InitializedParams)) \
+    X((protocol::DidChangeNotebookDocumentParams)) \
+    X((protocol::DidCloseNotebookDocumentParams)) \
+    X((protocol::DidOpenNotebookDocumentParams)) \
+    X((protocol::DidSaveNotebookDocumentParams)) \
+    X((protocol::LSPAny)) \
+    X((protocol::DidChangeTextDocumentParams)) \
+    X((protocol::DidCloseTextDocumentParams)) \
+    X((protocol::DidOpenTextDocumentParams)) \
+    X((protocol::DidSaveTextDocumentParams)) \
+    X((protocol::PublishDiagnosticsParams)) \
+    X((protocol::LogMessageParams)) \
+    X((protocol::ShowMessageParams)) \
+    X((protocol::WorkDoneProgressCancelParams)) \
+    X((protocol::DidChangeConfigurationParams)) \
+    X((protocol::DidChangeWatchedFilesParams)) \
+    X((protocol::DidChangeWorkspaceFoldersParams))
+
+// The params of every request, which decode_request() reads.
+#define KOTA_LSP_JSON_CODEC_REQUEST_PARAMS(X) \
+    X((protocol::CallHierarchyIncomingCallsParams)) \
+    X((protocol::CallHierarchyOutgoingCallsParams)) \
+    X((protocol::RegistrationParams)) \
+    X((protocol::UnregistrationParams)) \
+    X((protocol::CodeAction)) \
+    X((protocol::CodeLens)) \
+    X((protocol::CompletionItem)) \
+    X((protocol::DocumentLink)) \
+    X((protocol::InitializeParams)) \
+    X((protocol::InlayHint)) \
+    X((protocol::ShutdownParams)) \
+    X((protocol::CodeActionParams)) \
+    X((protocol::CodeLensParams)) \
+    X((protocol::ColorPresentationParams)) \
+    X((protocol::CompletionParams)) \
+    X((protocol::DeclarationParams)) \
+    X((protocol::DefinitionParams)) \
+    X((protocol::DocumentDiagnosticParams)) \
+    X((protocol::DocumentColorParams)) \
+    X((protocol::DocumentHighlightParams)) \
+    X((protocol::DocumentLinkParams)) \
+    X((protocol::DocumentSymbolParams)) \
+    X((protocol::FoldingRangeParams)) \
+    X((protocol::DocumentFormattingParams)) \
+    X((protocol::HoverParams)) \
+    X((protocol::ImplementationParams)) \
+    X((protocol::InlayHintParams)) \
+    X((protocol::InlineCompletionParams)) \
+    X((protocol::InlineValueParams)) \
+    X((protocol::LinkedEditingRangeParams)) \
+    X((protocol::MonikerParams)) \
+    X((protocol::DocumentOnTypeFormattingParams)) \
+    X((protocol::CallHierarchyPrepareParams)) \
+    X((protocol::PrepareRenameParams)) \
+    X((protocol::TypeHierarchyPrepareParams)) \
+    X((protocol::DocumentRangeFormattingParams)) \
+    X((protocol::DocumentRangesFormattingParams)) \
+    X((protocol::ReferenceParams)) \
+    X((protocol::RenameParams)) \
+    X((protocol::SelectionRangeParams)) \
+    X((protocol::SemanticTokensParams)) \
+    X((protocol::SemanticTokensDeltaParams)) \
+    X((protocol::SemanticTokensRangeParams)) \
+    X((protocol::SignatureHelpParams)) \
+    X((protocol::TypeDefinitionParams)) \
+    X((protocol::WillSaveTextDocumentParams)) \
+    X((protocol::TypeHierarchySubtypesParams)) \
+    X((protocol::TypeHierarchySupertypesParams)) \
+    X((protocol::ShowDocumentParams)) \
+    X((protocol::ShowMessageRequestParams)) \
+    X((protocol::WorkDoneProgressCreateParams)) \
+    X((protocol::ApplyWorkspaceEditParams)) \
+    X((protocol::CodeLensRefreshParams)) \
+    X((protocol::ConfigurationParams)) \
+    X((protocol::WorkspaceDiagnosticParams)) \
+    X((protocol::DiagnosticRefreshParams)) \
+    X((protocol::ExecuteCommandParams)) \
+    X((protocol::FoldingRangeRefreshParams)) \
+    X((protocol::InlayHintRefreshParams)) \
+    X((protocol::InlineValueRefreshParams)) \
+    X((protocol::SemanticTokensRefreshParams)) \
+    X((protocol::WorkspaceSymbolParams)) \
+    X((protocol::TextDocumentContentParams)) \
+    X((protocol::TextDocumentContentRefreshParams)) \
+    X((protocol::CreateFilesParams)) \
+    X((protocol::DeleteFilesParams)) \
+    X((protocol::RenameFilesParams)) \
+    X((protocol::WorkspaceFoldersParams)) \
+    X((protocol::WorkspaceSymbol))
+
+#define KOTA_LSP_JSON_CODEC_TYPE(...) __VA_ARGS__
+
+#define KOTA_LSP_JSON_CODEC_VALUE(INSTANTIATE, TYPE) \
+    INSTANTIATE Result<std::string> JsonCodec::serialize_value( \
+        const KOTA_LSP_JSON_CODEC_TYPE TYPE& value); \
+    INSTANTIATE Result<KOTA_LSP_JSON_CODEC_TYPE TYPE> JsonCodec::deserialize_value( \
+        std::string_view raw, \
+        protocol::ErrorCode code);
+
+#define KOTA_LSP_JSON_CODEC_REQUEST(INSTANTIATE, PARAMS) \
+    INSTANTIATE Result<TypedIncomingRequest<KOTA_LSP_JSON_CODEC_TYPE PARAMS>> \
+    JsonCodec::decode_request(std::string_view payload);
+
+#ifndef KOTA_LSP_JSON_CODEC_BUILD
+
+namespace kota::ipc {
+
+#define KOTA_LSP_JSON_CODEC_EXTERN_VALUE(TYPE) KOTA_LSP_JSON_CODEC_VALUE(extern template, TYPE)
+#define KOTA_LSP_JSON_CODEC_EXTERN_REQUEST(PARAMS) \
+    KOTA_LSP_JSON_CODEC_REQUEST(extern template, PARAMS)
+
+KOTA_LSP_JSON_CODEC_TYPES(KOTA_LSP_JSON_CODEC_EXTERN_VALUE)
+KOTA_LSP_JSON_CODEC_REQUEST_PARAMS(KOTA_LSP_JSON_CODEC_EXTERN_REQUEST)
+
+#undef KOTA_LSP_JSON_CODEC_EXTERN_REQUEST
+#undef KOTA_LSP_JSON_CODEC_EXTERN_VALUE
+
+}  // namespace kota::ipc
+
+#endif
@@ -6,6 +6,7 @@
 #include <string_view>
 #include <vector>
 
+#include "kota/support/rope.h"
 #include "kota/ipc/lsp/protocol.h"
 
 namespace kota::ipc::lsp {
@@ -32,6 +33,13 @@ public:
     /// Builds an index for `content` using the given position encoding.
     PositionMapper(std::string_view content, PositionEncoding encoding);
 
+    /// Maps positions in `content` through the line and unit counts the
+    /// rope keeps, so each conversion takes O(log n) and no index is built.
+    /// The mapper follows edits made to the rope without apply_edit().
+    /// Offsets inside a code point, and malformed UTF-8, are counted by
+    /// lead bytes, as rope_metrics counts them.
+    PositionMapper(const kota::rope& content, PositionEncoding encoding);
+
     /// Returns the zero-based line containing `offset`.
     std::uint32_t line_of(std::uint32_t offset) const;
 
@@ -60,10 +68,36 @@ public:
     /// Measures `text` length in the current position encoding.
     std::uint32_t measure(std::string_view text) const;
 
+    /// Updates the index after bytes [begin, end) of the previous content
+    /// were replaced by `text`, giving `content`. Costs the size of `text`
+    /// plus the lines after the edit, instead of a rescan of `content`.
+    /// Not for a mapper over a rope.
+    void apply_edit(std::string_view content,
+                    std::uint32_t begin,
+                    std::uint32_t end,
+                    std::string_view text);
+
 private:
+    bool line_is_ascii(std::uint32_t line) const;
+
+    std::uint32_t content_size() const;
+
+    /// The units before `offset` in a rope, in the current encoding.
+    std::size_t rope_units(std::uint32_t offset) const;
+
+    std::optional<std::uint32_t> rope_offset(protocol::Position position) const;
+
     std::string_view content;
+
+    // Set instead of `content` and the line index for a mapper over a rope.
+    const kota::rope* text_rope = nullptr;
+
     PositionEncoding encoding;
     std::vector<std::uint32_t> line_starts;
+
+    // Lines with only ASCII bytes, whose byte and character columns agree
+    // in every encoding.
+    std::vector<bool> ascii_lines;
 };
 
 }  // namespace kota::ipc::lsp
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <optional>
 #include <string>
 #include <utility>
@@ -9,12 +10,42 @@
 
 namespace kota::ipc::lsp {
 
+namespace detail {
+
+/// `WorkDoneProgressReport`, except that `cancellable` can be sent as false
+/// to disable the cancel button.
+struct progress_report {
+    std::string kind = "report";
+    protocol::optional<bool> cancellable = {};
+    protocol::optional<std::string> message = {};
+    protocol::optional<protocol::uinteger> percentage = {};
+};
+
+/// `ProgressParams` with a typed value, so it is serialized straight from
+/// the struct instead of through an `LSPAny` map.
+template <typename Value>
+struct progress_params {
+    protocol::ProgressToken token;
+    Value value;
+};
+
+}  // namespace detail
+
 template <typename PeerT>
 class ProgressReporter {
 public:
+    using clock = std::chrono::steady_clock;
+
     ProgressReporter(PeerT& peer, protocol::ProgressToken token) :
         peer(peer), token(std::move(token)) {}
 
+    /// Throttled: report() sends at most one notification per `interval`.
+    /// Reports that come sooner are merged, keeping the latest message and
+    /// percentage, and go out with the first report() after the interval,
+    /// with flush(), or ahead of end().
+    ProgressReporter(PeerT& peer, protocol::ProgressToken token, std::chrono::milliseconds interval) :
+        peer(peer), token(std::move(token)), interval(interval) {}
+
     /// Send window/workDoneProgress/create request to register the token.
     task<void, Error> create(request_options opts = {}) {
         auto result = co_await peer.send_request(protocol::WorkDoneProgressCreateParams{token},
@@ -27,46 +58,60 @@ public:
                        std::optional<std::string> message = {},
                        std::optional<protocol::uinteger> percentage = {},
                        bool cancellable = false) {
-        protocol::LSPObject value;
-        value.emplace("kind", protocol::LSPAny(std::string("begin")));
-        value.emplace("title", protocol::LSPAny(std::move(title)));
-        if(cancellable) {
-            value.emplace("cancellable", protocol::LSPAny(true));
-        }
-        if(message) {
-            value.emplace("message", protocol::LSPAny(std::move(*message)));
-        }
-        if(percentage) {
-            value.emplace("percentage", protocol::LSPAny(static_cast<std::int64_t>(*percentage)));
-        }
+        protocol::WorkDoneProgressBegin value;
+        value.kind = "begin";
+        value.title = std::move(title);
+        value.cancellable = cancellable;
+        value.message = std::move(message);
+        value.percentage = percentage;
+        last_sent = clock::now();
         return send_progress(std::move(value));
     }
 
-    /// Send $/progress with kind=report.
+    /// Send $/progress with kind=report, or hold it back when throttled.
     Result<void> report(std::optional<std::string> message = {},
                         std::optional<protocol::uinteger> percentage = {},
                         std::optional<bool> cancellable = {}) {
-        protocol::LSPObject value;
-        value.emplace("kind", protocol::LSPAny(std::string("report")));
-        if(cancellable) {
-            value.emplace("cancellable", protocol::LSPAny(*cancellable));
+        if(!held) {
+            held.emplace();
         }
         if(message) {
-            value.emplace("message", protocol::LSPAny(std::move(*message)));
+            held->message = std::move(*message);
         }
         if(percentage) {
-            value.emplace("percentage", protocol::LSPAny(static_cast<std::int64_t>(*percentage)));
+            held->percentage = *percentage;
+        }
+        if(cancellable) {
+            held->cancellable = *cancellable;
+        }
+
+        if(interval > std::chrono::milliseconds::zero() && clock::now() - last_sent < interval) {
+            return {};
         }
+        return flush();
+    }
+
+    /// Sends the report held back by throttling, if there is one.
+    Result<void> flush() {
+        if(!held) {
+            return {};
+        }
+        auto value = std::move(*held);
+        held.reset();
+        last_sent = clock::now();
         return send_progress(std::move(value));
     }
 
-    /// Send $/progress with kind=end.
+    /// Send $/progress with kind=end, after any report still held back.
     Result<void> end(std::optional<std::string> message = {}) {
-        protocol::LSPObject value;
-        value.emplace("kind", protocol::LSPAny(std::string("end")));
-        if(message) {
-            value.emplace("message", protocol::LSPAny(std::move(*message)));
+        auto flushed = flush();
+        if(!flushed) {
+            return flushed;
         }
+
+        protocol::WorkDoneProgressEnd value;
+        value.kind = "end";
+        value.message = std::move(message);
         return send_progress(std::move(value));
     }
 
@@ -74,10 +119,16 @@ public:
     protocol::ProgressToken token;
 
 private:
-    Result<void> send_progress(protocol::LSPObject value) {
+    template <typename Value>
+    Result<void> send_progress(Value value) {
         return peer.send_notification(
-            protocol::ProgressParams{token, protocol::LSPAny(std::move(value))});
+            protocol::NotificationTraits<protocol::ProgressParams>::method,
+            detail::progress_params<Value>{token, std::move(value)});
     }
+
+    std::chrono::milliseconds interval = std::chrono::milliseconds::zero();
+    clock::time_point last_sent;
+    std::optional<detail::progress_report> held;
 };
 
 }  // namespace kota::ipc::lsp
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "kota/ipc/lsp/position.h"
+#include "kota/ipc/lsp/protocol.h"
+
+namespace kota::ipc::lsp {
+
+/// Collects the semantic tokens of one document into the flat array
+/// `SemanticTokens::data` carries: five numbers per token, with line and
+/// start relative to the previous token. Tokens are given as byte ranges
+/// and converted to the mapper's position encoding. They may be added in
+/// any order; build() sorts them when they were not added in order.
+class SemanticTokensBuilder {
+public:
+    explicit SemanticTokensBuilder(const PositionMapper& mapper) : mapper(mapper) {}
+
+    /// Adds a token over bytes [begin, end). A token crossing line breaks
+    /// is split into one token per line, since not every client supports
+    /// multiline tokens. Empty ranges are ignored.
+    void add(std::uint32_t begin,
+             std::uint32_t end,
+             std::uint32_t type,
+             std::uint32_t modifiers = 0);
+
+    /// Adds a token whose position and length are already in LSP units.
+    void push(std::uint32_t line,
+              std::uint32_t character,
+              std::uint32_t length,
+              std::uint32_t type,
+              std::uint32_t modifiers = 0);
+
+    std::size_t size() const noexcept {
+        return tokens.size() / 5;
+    }
+
+    /// Encodes the tokens relative to each other and leaves the builder
+    /// empty for reuse.
+    std::vector<protocol::uinteger> build();
+
+private:
+    const PositionMapper& mapper;
+
+    // Five absolute numbers per token until build() encodes them.
+    std::vector<protocol::uinteger> tokens;
+
+    bool sorted = true;
+};
+
+/// The edits that turn `previous` token data into `current`: at most one
+/// edit, covering the tokens between their common prefix and suffix.
+std::vector<protocol::SemanticTokensEdit>
+    diff_semantic_tokens(std::span<const protocol::uinteger> previous,
+                         std::span<const protocol::uinteger> current);
+
+/// Remembers the last tokens sent for one document, so that the next
+/// `textDocument/semanticTokens/full/delta` request can be answered with
+/// edits against them instead of the whole array.
+class SemanticTokensCache {
+public:
+    /// Answers a full request and remembers `data` under a new result id.
+    protocol::SemanticTokens full(std::vector<protocol::uinteger> data);
+
+    /// Answers a delta request. When `previous_result_id` is the id handed
+    /// out last, the result holds the edits; otherwise the client gets the
+    /// full tokens again.
+    std::variant<protocol::SemanticTokens, protocol::SemanticTokensDelta>
+        delta(std::string_view previous_result_id, std::vector<protocol::uinteger> data);
+
+    /// Forgets the remembered tokens, e.g. when the document closes.
+    void clear();
+
+private:
+    std::string next_result_id();
+
+    std::uint64_t generation = 0;
+    std::optional<std::string> result_id;
+    std::vector<protocol::uinteger> data;
+};
+
+}  // namespace kota::ipc::lsp
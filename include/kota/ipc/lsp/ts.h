@@ -1,13 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -57,8 +60,76 @@ struct LSPAny;
 using LSPArray = std::vector<LSPAny>;
 
 /// LSP object definition.
+///
+/// Entries live in one vector in insertion order instead of one heap node
+/// per key, so building or decoding an object costs a single growing
+/// allocation. LSP payloads rarely carry more than a handful of keys, so
+/// lookups scan linearly. Assigning to an existing key replaces its value.
 /// @since 3.17.0
-using LSPObject = std::unordered_map<std::string, LSPAny>;
+class LSPObject {
+public:
+    using key_type = std::string;
+    using mapped_type = LSPAny;
+    using value_type = std::pair<std::string, LSPAny>;
+    using size_type = std::size_t;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    LSPObject() = default;
+
+    LSPObject(std::initializer_list<value_type> init);
+
+    iterator begin() noexcept {
+        return entries.begin();
+    }
+
+    const_iterator begin() const noexcept {
+        return entries.begin();
+    }
+
+    iterator end() noexcept {
+        return entries.end();
+    }
+
+    const_iterator end() const noexcept {
+        return entries.end();
+    }
+
+    size_type size() const noexcept {
+        return entries.size();
+    }
+
+    bool empty() const noexcept {
+        return entries.empty();
+    }
+
+    void clear() noexcept {
+        entries.clear();
+    }
+
+    void reserve(size_type count) {
+        entries.reserve(count);
+    }
+
+    iterator find(std::string_view key) noexcept;
+
+    const_iterator find(std::string_view key) const noexcept;
+
+    bool contains(std::string_view key) const noexcept;
+
+    LSPAny& operator[](std::string_view key);
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(std::string key, V&& value);
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(std::string key, Args&&... args);
+
+    size_type erase(std::string_view key);
+
+private:
+    std::vector<value_type> entries;
+};
 
 using LSPVariant = std::variant<LSPObject,
                                 LSPArray,
@@ -74,6 +145,69 @@ struct LSPAny : LSPVariant {
     using LSPVariant::operator=;
 };
 
+inline LSPObject::LSPObject(std::initializer_list<value_type> init) {
+    entries.reserve(init.size());
+    for(const auto& [key, value]: init) {
+        insert_or_assign(key, value);
+    }
+}
+
+inline auto LSPObject::find(std::string_view key) noexcept -> iterator {
+    return std::ranges::find(entries, key, [](const value_type& entry) -> std::string_view {
+        return entry.first;
+    });
+}
+
+inline auto LSPObject::find(std::string_view key) const noexcept -> const_iterator {
+    return std::ranges::find(entries, key, [](const value_type& entry) -> std::string_view {
+        return entry.first;
+    });
+}
+
+inline bool LSPObject::contains(std::string_view key) const noexcept {
+    return find(key) != end();
+}
+
+inline LSPAny& LSPObject::operator[](std::string_view key) {
+    auto it = find(key);
+    if(it != end()) {
+        return it->second;
+    }
+    return entries.emplace_back(std::string(key), LSPAny{}).second;
+}
+
+template <typename V>
+auto LSPObject::insert_or_assign(std::string key, V&& value) -> std::pair<iterator, bool> {
+    auto it = find(key);
+    if(it != end()) {
+        it->second = std::forward<V>(value);
+        return {it, false};
+    }
+    entries.emplace_back(std::move(key), std::forward<V>(value));
+    return {std::prev(entries.end()), true};
+}
+
+template <typename... Args>
+auto LSPObject::emplace(std::string key, Args&&... args) -> std::pair<iterator, bool> {
+    auto it = find(key);
+    if(it != end()) {
+        return {it, false};
+    }
+    entries.emplace_back(std::piecewise_construct,
+                         std::forward_as_tuple(std::move(key)),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+    return {std::prev(entries.end()), true};
+}
+
+inline auto LSPObject::erase(std::string_view key) -> size_type {
+    auto it = find(key);
+    if(it == end()) {
+        return 0;
+    }
+    entries.erase(it);
+    return 1;
+}
+
 struct LSPEmpty {};
 
 using URI = string;
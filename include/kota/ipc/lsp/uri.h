@@ -1,9 +1,14 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <expected>
+#include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 namespace kota::ipc::lsp {
 
@@ -25,9 +30,20 @@ public:
     /// Percent-encodes bytes that are not valid URI characters.
     static std::string percent_encode(std::string_view text, bool encode_slash = false);
 
+    /// Like percent_encode(), appending to `output` so its capacity can be
+    /// reused.
+    static void percent_encode_to(std::string_view text,
+                                  std::string& output,
+                                  bool encode_slash = false);
+
     /// Decodes percent-encoded bytes (`%HH`), returning an error on invalid input.
     static std::expected<std::string, std::string> percent_decode(std::string_view text);
 
+    /// Like percent_decode(), appending to `output` so its capacity can be
+    /// reused. On error `output` is left as it was.
+    static std::expected<void, std::string> percent_decode_to(std::string_view text,
+                                                              std::string& output);
+
     /// Reconstructs the normalized URI string.
     std::string str() const;
 
@@ -65,6 +81,8 @@ public:
     std::expected<std::string, std::string> file_path() const;
 
 private:
+    friend class URITable;
+
     struct Segment {
         constexpr static std::size_t missing = std::string::npos;
         std::size_t offset = missing;
@@ -86,4 +104,57 @@ private:
     Segment fragment_segment;
 };
 
+/// Interns document URIs as small ids, so handlers can compare them and key
+/// maps by an integer instead of re-parsing the same text in every message.
+///
+/// Spellings that normalize to the same URI share an id. Every spelling seen
+/// is remembered, so looking one up again costs a hash of the raw text and
+/// no parsing. Ids are dense, start at 0 and stay valid, as do references to
+/// the URIs they name, for the table's lifetime. NOT thread-safe.
+class URITable {
+public:
+    using ID = std::uint32_t;
+
+    /// Returns the id of the URI `text` names, parsing it the first time
+    /// this spelling is seen. Fails as URI::parse() does.
+    std::expected<ID, std::string> intern(std::string_view text);
+
+    /// Like intern(), for the `file://` URI of an absolute path. Fails as
+    /// URI::from_file_path() does.
+    std::expected<ID, std::string> intern_file_path(std::string_view path);
+
+    /// Id of `text` if this spelling, or the normalized form it is, was
+    /// interned before; never parses.
+    std::optional<ID> find(std::string_view text) const;
+
+    const URI& uri(ID id) const;
+
+    /// Normalized text of the URI, as URI::str() would return it.
+    std::string_view str(ID id) const;
+
+    std::size_t size() const noexcept {
+        return uris.size();
+    }
+
+private:
+    struct string_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view value) const noexcept {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    using spelling_map = std::unordered_map<std::string, ID, string_hash, std::equal_to<>>;
+
+    ID add(std::string_view spelling, URI uri, spelling_map& spellings);
+
+    // A deque, so references returned by uri() survive later interning.
+    std::deque<URI> uris;
+    // Raw and normalized URI spellings.
+    spelling_map uri_spellings;
+    // Filesystem paths, kept apart since a path may read as a URI.
+    spelling_map path_spellings;
+};
+
 }  // namespace kota::ipc::lsp
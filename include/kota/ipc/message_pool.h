@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kota::ipc {
+
+/// Free list of message buffers. take() hands out an empty string that keeps
+/// the capacity it had for an earlier message, so a peer whose messages are
+/// of similar sizes stops allocating payload storage once warmed up.
+class MessagePool {
+public:
+    /// Keeps at most `max_buffers` buffers, none larger than `max_capacity`:
+    /// one grown by a rare huge message is freed rather than pinned.
+    explicit MessagePool(std::size_t max_buffers = 64,
+                         std::size_t max_capacity = 1024 * 1024) :
+        max_buffers(max_buffers), max_capacity(max_capacity) {
+        free.reserve(max_buffers);
+    }
+
+    MessagePool(const MessagePool&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+
+    /// An empty buffer, recycled when one is available.
+    std::string take() noexcept {
+        if(free.empty()) {
+            return {};
+        }
+        auto buffer = std::move(free.back());
+        free.pop_back();
+        return buffer;
+    }
+
+    /// Returns `buffer` for reuse; its contents are discarded.
+    void give(std::string buffer) noexcept {
+        if(free.size() >= max_buffers || buffer.capacity() > max_capacity ||
+           buffer.capacity() == 0) {
+            return;
+        }
+        buffer.clear();
+        free.push_back(std::move(buffer));
+    }
+
+    /// Buffers waiting to be reused.
+    std::size_t size() const noexcept {
+        return free.size();
+    }
+
+private:
+    std::vector<std::string> free;
+    std::size_t max_buffers;
+    std::size_t max_capacity;
+};
+
+}  // namespace kota::ipc
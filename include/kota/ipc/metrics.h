@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kota::ipc {
+
+/// Log-linear histogram in the manner of HdrHistogram: values below 8 get a
+/// bucket each, and every power of two above is split into 8 buckets, so a
+/// reported value is within 12.5% of the true one across the whole 64-bit
+/// range. Recording is a few relaxed atomic adds and may race with reads
+/// from other threads, which see each counter whole but not necessarily in
+/// step with the others.
+class Histogram {
+public:
+    constexpr static std::size_t sub_bits = 3;
+    constexpr static std::size_t sub_buckets = std::size_t(1) << sub_bits;
+    constexpr static std::size_t bucket_count = sub_buckets * (64 - sub_bits + 1);
+
+    void record(std::uint64_t value) noexcept;
+
+    std::uint64_t count() const noexcept {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t sum() const noexcept {
+        return total_sum.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t max() const noexcept {
+        return maximum.load(std::memory_order_relaxed);
+    }
+
+    /// Upper bound of the bucket holding the `quantile` (0 to 1) of the
+    /// recorded values; 0 when nothing was recorded.
+    std::uint64_t percentile(double quantile) const noexcept;
+
+    void reset() noexcept;
+
+private:
+    static std::size_t bucket_of(std::uint64_t value) noexcept;
+    static std::uint64_t bucket_upper(std::size_t bucket) noexcept;
+
+    std::array<std::atomic<std::uint64_t>, bucket_count> counts{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> total_sum{0};
+    std::atomic<std::uint64_t> maximum{0};
+};
+
+/// What a peer observed handling one incoming method.
+struct MethodMetrics {
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> notifications{0};
+    /// Requests answered with an error, cancellations included.
+    std::atomic<std::uint64_t> errors{0};
+    std::atomic<std::uint64_t> cancelled{0};
+
+    /// Requests received and not answered yet, queued ones included.
+    std::atomic<std::int64_t> in_flight{0};
+
+    /// Nanoseconds spent decoding an incoming message.
+    Histogram decode_ns;
+    /// Nanoseconds from a handler starting to it finishing, suspensions
+    /// included.
+    Histogram handler_ns;
+    /// Nanoseconds spent encoding a response.
+    Histogram encode_ns;
+
+    Histogram request_bytes;
+    Histogram response_bytes;
+};
+
+/// Per-method metrics a Peer records once set_metrics() hands it an
+/// instance. Methods appear the first time a handled message arrives for
+/// them; messages to methods without a handler are not counted, so a
+/// client cannot grow the table with made-up names.
+///
+/// The peer records from its loop thread without locking; the table itself
+/// is guarded, so find(), methods() and to_prometheus() may be called from
+/// any thread while the peer runs.
+class PeerMetrics {
+public:
+    /// The entry for `method`, created if needed. The reference stays valid
+    /// for the life of this object.
+    MethodMetrics& method(std::string_view method);
+
+    /// Null if nothing was recorded for `method`.
+    const MethodMetrics* find(std::string_view method) const;
+
+    /// The methods with an entry, sorted.
+    std::vector<std::string> methods() const;
+
+    /// Everything recorded, in the Prometheus text exposition format, each
+    /// metric name starting with `prefix` and labelled with the method.
+    /// Times are in seconds; the histograms are reported as summaries.
+    std::string to_prometheus(std::string_view prefix = "kota_ipc") const;
+
+private:
+    mutable std::mutex lock;
+    std::map<std::string, std::unique_ptr<MethodMetrics>, std::less<>> entries;
+};
+
+}  // namespace kota::ipc
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "kota/ipc/transport.h"
+
+namespace kota::ipc {
+
+/// Carries many independent channels over one transport, so several Peers
+/// (say, one per workspace) between the same two processes share a single
+/// pipe, socket or shared-memory link.
+///
+/// Each message on the shared transport is a one-byte kind, the channel id
+/// (4 bytes, little-endian) and a body: a channel's message, a credit grant
+/// or the end of a channel's output. Flow control is per channel and
+/// counted in messages: a channel may have `window` messages in flight
+/// before its writes wait for the reader on the other side to take some,
+/// so a channel whose Peer stops reading cannot block the others. A write
+/// returns once its message is queued; one writer task sends the queue in
+/// gather writes, so messages of all channels queued while a write is in
+/// flight go out together in the next one.
+///
+/// Both sides wrap their end of the link, open() the same ids and keep
+/// run() scheduled. Messages for an id not opened yet are held, up to the
+/// window, until it is.
+///
+/// NOT thread-safe: must be used on the loop thread, and must outlive the
+/// channels it opened.
+class Multiplexer {
+public:
+    struct options {
+        /// Messages a channel may have in flight before it waits for
+        /// credit. Both sides must use the same value.
+        std::uint32_t window = 64;
+    };
+
+    Multiplexer(event_loop& loop, std::unique_ptr<Transport> transport, options opts);
+
+    Multiplexer(event_loop& loop, std::unique_ptr<Transport> transport) :
+        Multiplexer(loop, std::move(transport), options{}) {}
+
+    Multiplexer(const Multiplexer&) = delete;
+    Multiplexer& operator=(const Multiplexer&) = delete;
+
+    ~Multiplexer();
+
+    /// A transport for channel `id`; fails if `id` is open already. Its
+    /// close_output() ends the channel's input on the other side, and
+    /// close() also ends its own input.
+    Result<std::unique_ptr<Transport>> open(std::uint32_t id);
+
+    /// Reads the shared transport and hands each message to its channel.
+    /// When the input ends, a malformed message arrives or a write fails,
+    /// every channel reads end of input and its writes fail.
+    task<> run();
+
+    /// Closes the shared transport, which ends run().
+    Result<void> close();
+
+private:
+    class Channel;
+    struct ChannelState;
+
+    ChannelState& state_of(std::uint32_t id);
+
+    /// Queues `frame` behind those of every channel and starts the writer
+    /// if it is idle.
+    void enqueue(std::string frame);
+
+    task<> write_loop();
+
+    /// Ends every channel's input and wakes its writers, which then fail.
+    void shut_down(Error error);
+
+    /// Forgets channel `id` once its transport is destroyed.
+    void release(std::uint32_t id) noexcept;
+
+    event_loop& loop;
+    std::unique_ptr<Transport> inner;
+    options opts;
+
+    std::unordered_map<std::uint32_t, std::unique_ptr<ChannelState>> channels;
+
+    std::vector<std::string> outgoing;
+    bool writer_running = false;
+
+    /// Why the link is down, once it is.
+    std::optional<Error> failure;
+};
+
+}  // namespace kota::ipc
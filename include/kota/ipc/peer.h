@@ -1,18 +1,24 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "kota/ipc/codec.h"
 #include "kota/ipc/logger.h"
+#include "kota/ipc/metrics.h"
 #include "kota/ipc/transport.h"
 #include "kota/async/async.h"
 #include "kota/codec/raw_value.h"
+#include "kota/support/functional.h"
 
 namespace kota::ipc {
 
@@ -43,6 +49,12 @@ struct basic_request_context {
     PeerT& peer;
     cancellation_token cancellation;
 
+    /// Memory for the data a handler builds, released all at once when the
+    /// request completes: allocating is a pointer bump and nothing is freed
+    /// one by one. Decoding a std::pmr container constructed with it puts
+    /// the decoded strings and elements there too.
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource();
+
     basic_request_context(PeerT& peer, const protocol::RequestID& id, cancellation_token token) :
         id(id), peer(peer), cancellation(std::move(token)) {}
 
@@ -67,6 +79,30 @@ struct request_options {
     std::optional<std::chrono::milliseconds> timeout = std::nullopt;
 };
 
+struct notification_options {
+    /// A notification sent with a key replaces one sent earlier with the
+    /// same key that is still waiting to be written, e.g. an older progress
+    /// report for the same token while the transport is backed up. Empty
+    /// for none.
+    std::string_view supersede_key = {};
+};
+
+/// Bounds on the incoming requests a peer handles at once. A request over a
+/// limit waits, in arrival order, until a handler finishes; once
+/// `max_queued` requests wait, run() stops reading from the transport, and
+/// so also stops reading responses, until one starts. Handlers that block
+/// on requests of their own must leave enough room for that.
+struct dispatch_options {
+    /// Handlers running at once across all methods; 0 for no limit.
+    std::size_t max_in_flight = 0;
+
+    /// Handlers running at once for any one method; 0 for no limit.
+    std::size_t max_in_flight_per_method = 0;
+
+    /// Waiting requests at which reading pauses.
+    std::size_t max_queued = 256;
+};
+
 template <typename Codec>
 class Peer {
 public:
@@ -92,6 +128,18 @@ public:
 
     void set_logger(LogCallback callback, LogLevel min_level = LogLevel::info);
 
+    /// Logs through `log`, which formats on its own thread and must outlive
+    /// the peer; every peer sharing it must run on this peer's loop.
+    void set_logger(DeferredLog& log, LogLevel min_level = LogLevel::info);
+
+    /// Applies to requests dispatched from now on; unlimited by default.
+    void set_dispatch_options(dispatch_options opts);
+
+    /// Records counts, timings and sizes of the incoming messages handled
+    /// from now on into `metrics`, which may be shared with other peers; null
+    /// turns recording off, which is the default.
+    void set_metrics(std::shared_ptr<PeerMetrics> metrics);
+
     template <typename Params>
     RequestResult<Params> send_request(const Params& params, request_options opts = {});
 
@@ -100,11 +148,17 @@ public:
                                       const Params& params,
                                       request_options opts = {});
 
+    /// Outgoing messages are written most urgent first: responses, then
+    /// requests, then notifications, then progress and log notifications
+    /// (`$/progress`, `$/logTrace`, `window/logMessage`, `telemetry/event`).
+    /// Messages of one class keep the order they were sent in.
     template <typename Params>
-    Result<void> send_notification(const Params& params);
+    Result<void> send_notification(const Params& params, notification_options opts = {});
 
     template <typename Params>
-    Result<void> send_notification(std::string_view method, const Params& params);
+    Result<void> send_notification(std::string_view method,
+                                   const Params& params,
+                                   notification_options opts = {});
 
     template <typename Callback>
     void on_request(Callback&& callback);
@@ -112,12 +166,84 @@ public:
     template <typename Callback>
     void on_request(std::string_view method, Callback&& callback);
 
+    /// Runs the handler of a method on `pool` instead of the loop, so that
+    /// one that computes for a long time does not hold up reading and
+    /// writing other messages. Decoding the params, the handler and
+    /// encoding its result all happen on a worker; only the encoded
+    /// response comes back to the loop to be written.
+    ///
+    /// The handler is a plain function `Result<R>(const Params&)`, not a
+    /// coroutine. It gets no RequestContext, must not touch the peer, and
+    /// may run on several workers at once. A request cancelled before a
+    /// worker takes it up is dropped; one already running completes and is
+    /// answered as cancelled. Such methods do not take part in
+    /// supersede_requests().
+    template <typename Callback>
+    void on_request(thread_pool& pool, Callback&& callback);
+
+    template <typename Callback>
+    void on_request(std::string_view method, thread_pool& pool, Callback&& callback);
+
     template <typename Callback>
     void on_notification(Callback&& callback);
 
     template <typename Callback>
     void on_notification(std::string_view method, Callback&& callback);
 
+    /// For methods where only the latest answer matters (completion,
+    /// semantic tokens): when a request to `method` starts, an earlier one
+    /// still running whose params map to the same `key(params)` (say, the
+    /// document URI) is cancelled.
+    template <typename Params, typename KeyFn>
+    void supersede_requests(std::string_view method, KeyFn&& key);
+
+    template <typename Params, typename KeyFn>
+    void supersede_requests(KeyFn&& key);
+
+    /// Requests and notifications collected to go out in one frame: a single
+    /// batch array for codecs that have one (JSON-RPC), consecutive messages
+    /// otherwise. A request is registered as soon as it is added, so its
+    /// task may be awaited before or after send(); the requests of a batch
+    /// destroyed unsent fail.
+    class Batch {
+    public:
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        ~Batch();
+
+        template <typename Params>
+        RequestResult<Params> request(const Params& params);
+
+        template <typename ResultT, typename Params>
+        task<ResultT, Error> request(std::string_view method, const Params& params);
+
+        template <typename Params>
+        Result<void> notify(const Params& params);
+
+        template <typename Params>
+        Result<void> notify(std::string_view method, const Params& params);
+
+        /// Sends everything added so far; the batch cannot be reused.
+        Result<void> send();
+
+    private:
+        friend class Peer;
+
+        explicit Batch(Peer& peer) : peer(peer) {}
+
+        Result<void> add_notification(std::string_view method, Result<std::string> params);
+
+        void fail_requests(const std::string& message);
+
+        Peer& peer;
+        std::vector<std::string> messages;
+        std::vector<std::int64_t> request_ids;
+        bool sent = false;
+    };
+
+    Batch batch();
+
     template <typename Tag>
         requires detail::has_tag_request_traits_v<Tag>
     auto send_request(const typename protocol::RequestTraits<Tag>::Params& params,
@@ -136,9 +262,16 @@ public:
     void on_notification(Callback&& callback);
 
 private:
+    struct Self;
+
     template <typename Params, typename Callback>
     void bind_request_callback(std::string_view method, Callback&& callback);
 
+    template <typename Params, typename Callback>
+    void bind_pooled_request_callback(std::string_view method,
+                                      thread_pool& pool,
+                                      Callback&& callback);
+
     template <typename Params, typename Callback>
     void bind_notification_callback(std::string_view method, Callback&& callback);
 
@@ -146,17 +279,39 @@ private:
         task<std::string, Error>(const protocol::RequestID&, std::string_view, cancellation_token)>;
     using NotificationCallback = std::function<void(std::string_view)>;
 
+    /// A request decoded up front by a typed handler, ready to run.
+    struct DecodedRequest {
+        protocol::RequestID id;
+        std::function<task<std::string, Error>(cancellation_token)> run;
+    };
+
+    /// Decodes a whole request payload for one method; nullopt sends the
+    /// payload down the generic path instead.
+    using RequestDecoder = std::function<std::optional<DecodedRequest>(std::string_view)>;
+
     void register_request_callback(std::string_view method, RequestCallback callback);
 
+    void register_request_decoder(std::string_view method, RequestDecoder decoder);
+
     void register_notification_callback(std::string_view method, NotificationCallback callback);
 
+    /// Writes a request with the assigned id into the buffer; it is called
+    /// once the request is registered, while send_request_impl() runs.
+    using RequestEncoder = function_ref<Result<void>(std::string&, const protocol::RequestID&)>;
+
     task<std::string, Error> send_request_impl(std::string_view method,
-                                               std::string params,
+                                               RequestEncoder encode,
                                                request_options opts);
 
-    Result<void> send_notification_impl(std::string_view method, std::string params);
+    template <typename Params>
+    Result<void> send_notification_impl(std::string_view method,
+                                        const Params& params,
+                                        std::string_view supersede_key = {});
+
+    /// Waits for the response to a request added to a Batch.
+    template <typename ResultT, typename Pending>
+    task<ResultT, Error> await_batched(Result<Pending> pending);
 
-    struct Self;
     std::unique_ptr<Self> self;
 };
 
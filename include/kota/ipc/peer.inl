@@ -4,28 +4,46 @@
 #include "kota/ipc/peer.h"
 #endif
 
+#include <algorithm>
+#include <any>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <format>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#include "kota/ipc/message_pool.h"
+#include "kota/support/flat_hash_map.h"
 #include "kota/support/function_traits.h"
+#include "kota/support/type_traits.h"
 
 // Lazy log macro: level check happens before std::format is evaluated.
+// Levels below KOTA_IPC_LOG_LEVEL compile to nothing; with a DeferredLog
+// the arguments are only copied, and formatted on its thread.
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define ET_IPC_LOG(self_ptr, lvl, fmt, ...)                                                        \
     do {                                                                                           \
-        if((self_ptr)->logger && (lvl) >= (self_ptr)->min_level)                                   \
-            (self_ptr)->logger((lvl), std::format(fmt, __VA_ARGS__));                              \
+        if constexpr((lvl) >= ::kota::ipc::compiled_log_level) {                                   \
+            if((lvl) >= (self_ptr)->min_level) {                                                   \
+                if((self_ptr)->deferred_log)                                                       \
+                    (self_ptr)->deferred_log->push((lvl), fmt, __VA_ARGS__);                       \
+                else if((self_ptr)->logger)                                                        \
+                    (self_ptr)->logger((lvl), std::format(fmt, __VA_ARGS__));                      \
+            }                                                                                      \
+        }                                                                                          \
     } while(false)
 
 namespace kota::ipc {
@@ -72,6 +90,21 @@ consteval void validate_request_callback_signature() {
                   "request callback first parameter should be RequestContext");
 }
 
+template <typename Callback>
+consteval void validate_pooled_request_callback_signature() {
+    using Args = request_callback_args_t<Callback>;
+    static_assert(std::tuple_size_v<Args> == 1,
+                  "pooled request callback should take only the params");
+
+    using Ret = request_callback_return_t<Callback>;
+    static_assert(is_specialization_of<outcome, Ret>,
+                  "pooled request callback should return Result<R>");
+}
+
+template <typename Callback>
+using pooled_request_callback_params_t =
+    std::remove_cvref_t<std::tuple_element_t<0, request_callback_args_t<Callback>>>;
+
 template <typename Callback>
 consteval void validate_notification_callback_signature() {
     using Args = notification_callback_args_t<Callback>;
@@ -81,13 +114,12 @@ consteval void validate_notification_callback_signature() {
     static_assert(std::is_same_v<Ret, void>, "notification callback should return void");
 }
 
-inline task<> cancel_after_timeout(std::chrono::milliseconds timeout,
-                                   std::shared_ptr<cancellation_source> timeout_source,
-                                   cancellation_token stop_token,
-                                   event_loop& loop) {
-    auto result = co_await with_token(sleep(timeout, loop), stop_token);
-    if(result.has_value()) {
-        timeout_source->cancel();
+/// Raw params are handed to handlers shared, so that a handler forwarding
+/// or broadcasting them copies no text.
+template <typename Params>
+void share_raw_params(Params& params) {
+    if constexpr(std::is_same_v<Params, codec::RawValue>) {
+        params.share();
     }
 }
 
@@ -99,40 +131,420 @@ inline task<> cancel_after_timeout(std::chrono::milliseconds timeout,
 
 template <typename CodecT>
 struct Peer<CodecT>::Self {
+    struct PendingTable;
+
+    /// Lives in the frame of the send_request() awaiting it, and leaves the
+    /// table by itself if that frame is destroyed before a response arrives.
+    /// The remote is then told to drop the request, as nobody will read its
+    /// response.
     struct PendingRequest {
+        std::int64_t id = 0;
+        Self* owner = nullptr;
+        PendingTable* table = nullptr;
         event ready;
         std::optional<Result<std::string>> response;
+
+        PendingRequest() = default;
+        PendingRequest(const PendingRequest&) = delete;
+        PendingRequest& operator=(const PendingRequest&) = delete;
+
+        ~PendingRequest() {
+            // The table is cleared before the peer goes away, so owner is
+            // only followed while it is alive.
+            if(table) {
+                table->erase(id);
+                if(owner) {
+                    owner->send_cancel_request(id);
+                }
+            }
+        }
+    };
+
+    /// Outgoing requests awaiting a response, indexed by their integer id.
+    /// Ids are handed out in sequence, so `id & mask` puts the requests in
+    /// flight in distinct slots; only a request still outstanding a whole
+    /// lap later collides, and then the table doubles.
+    struct PendingTable {
+        std::vector<PendingRequest*> slots;
+        std::size_t count = 0;
+
+        PendingTable() = default;
+        PendingTable(const PendingTable&) = delete;
+        PendingTable& operator=(const PendingTable&) = delete;
+
+        ~PendingTable() {
+            for(auto* request: slots) {
+                if(request) {
+                    request->table = nullptr;
+                }
+            }
+        }
+
+        void insert(PendingRequest& request) {
+            if(slots.empty()) {
+                slots.resize(16);
+            }
+            while(slots[slot_of(request.id)]) {
+                grow();
+            }
+            slots[slot_of(request.id)] = &request;
+            request.table = this;
+            ++count;
+        }
+
+        /// Unregisters the request waiting for `id`; null if there is none.
+        PendingRequest* take(const protocol::RequestID& id) {
+            return id.is_integer() ? take(id.as_integer()) : nullptr;
+        }
+
+        PendingRequest* take(std::int64_t id) {
+            if(slots.empty()) {
+                return nullptr;
+            }
+            auto& slot = slots[slot_of(id)];
+            if(!slot || slot->id != id) {
+                return nullptr;
+            }
+            auto* request = std::exchange(slot, nullptr);
+            request->table = nullptr;
+            --count;
+            return request;
+        }
+
+        void erase(std::int64_t id) {
+            (void)take(id);
+        }
+
+        std::vector<std::int64_t> ids() const {
+            std::vector<std::int64_t> result;
+            result.reserve(count);
+            for(auto* request: slots) {
+                if(request) {
+                    result.push_back(request->id);
+                }
+            }
+            return result;
+        }
+
+        std::size_t size() const noexcept {
+            return count;
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+    private:
+        std::size_t slot_of(std::int64_t id) const noexcept {
+            return static_cast<std::size_t>(id) & (slots.size() - 1);
+        }
+
+        void grow() {
+            // Ids distinct modulo the old size stay distinct modulo the new.
+            std::vector<PendingRequest*> grown(slots.size() * 2);
+            for(auto* request: slots) {
+                if(request) {
+                    grown[static_cast<std::size_t>(request->id) & (grown.size() - 1)] = request;
+                }
+            }
+            slots = std::move(grown);
+        }
+    };
+
+    /// Outgoing messages by urgency. A response ends a wait on the other
+    /// side, while a progress or log message only informs, so a burst of
+    /// the latter must not delay the former.
+    enum class outgoing_class : std::uint8_t {
+        response,
+        request,
+        notification,
+        bulk,
+    };
+
+    static outgoing_class notification_class(std::string_view method) noexcept {
+        if(method == "$/progress" || method == "$/logTrace" || method == "window/logMessage" ||
+           method == "telemetry/event") {
+            return outgoing_class::bulk;
+        }
+        return outgoing_class::notification;
+    }
+
+    /// Messages waiting for the writer, one FIFO per class, taken from the
+    /// most urgent class first.
+    struct OutgoingQueue {
+        static constexpr std::size_t class_count = 4;
+
+        struct Message {
+            std::string payload;
+            // Key a later message replaces this one under; empty for none.
+            std::string key;
+        };
+
+        /// Queues `payload`, or puts it in place of the queued message with
+        /// the same non-empty `key`; returns the buffer that one held.
+        std::optional<std::string>
+            push(outgoing_class kind, std::string payload, std::string_view key = {}) {
+            const auto index = static_cast<std::size_t>(kind);
+            auto& queue = queues[index];
+            if(!key.empty()) {
+                if(auto it = keyed.find(key); it != keyed.end() && it->second.first == index) {
+                    auto& queued = queue[it->second.second - taken[index]];
+                    return std::exchange(queued.payload, std::move(payload));
+                }
+                keyed.insert_or_assign(std::string(key),
+                                       std::pair{index, taken[index] + queue.size()});
+            }
+            queue.push_back({std::move(payload), std::string(key)});
+            ++count;
+            return std::nullopt;
+        }
+
+        /// Takes the oldest message of the most urgent class. Not empty().
+        std::string pop() {
+            for(std::size_t index = 0; index < class_count; ++index) {
+                auto& queue = queues[index];
+                if(queue.empty()) {
+                    continue;
+                }
+
+                auto message = std::move(queue.front());
+                queue.pop_front();
+                const auto position = taken[index]++;
+                --count;
+                if(!message.key.empty()) {
+                    // The key may have moved on to a message of another class.
+                    auto it = keyed.find(std::string_view(message.key));
+                    if(it != keyed.end() && it->second == std::pair{index, position}) {
+                        keyed.erase(it);
+                    }
+                }
+                return std::move(message.payload);
+            }
+            return {};
+        }
+
+        void clear() {
+            for(auto& queue: queues) {
+                queue.clear();
+            }
+            keyed.clear();
+            count = 0;
+        }
+
+        std::size_t size() const noexcept {
+            return count;
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+    private:
+        std::array<std::deque<Message>, class_count> queues;
+        // Messages ever taken from each class, so that a position recorded
+        // in `keyed` as a running count stays valid as the front moves.
+        std::array<std::uint64_t, class_count> taken{};
+        // Keyed messages still queued: their class and running position.
+        flat_hash_map<std::string, std::pair<std::size_t, std::uint64_t>> keyed;
+        std::size_t count = 0;
     };
 
     event_loop& loop;
     std::unique_ptr<Transport> transport;
     CodecT codec;
 
-    std::deque<std::string> outgoing_queue;
+    OutgoingQueue outgoing_queue;
+    // Storage of written messages, reused to encode later ones.
+    MessagePool buffers;
     std::int64_t next_request_id = 1;
 
-    std::unordered_map<std::string, RequestCallback> request_callbacks;
-    std::unordered_map<std::string, NotificationCallback> notification_callbacks;
+    // Keyed by method name; looked up with views of the incoming payload.
+    template <typename Callback>
+    using method_table = flat_hash_map<std::string, Callback>;
+
+    method_table<RequestCallback> request_callbacks;
+    // Methods whose typed handler can decode the request in a single pass.
+    method_table<RequestDecoder> request_decoders;
+    // Node-based: a notification handler runs in place and may register
+    // other handlers while it does, which a flat table would move it for.
+    std::unordered_map<std::string, NotificationCallback, flat_hash<std::string>, std::equal_to<>>
+        notification_callbacks;
+
+    PendingTable pending_requests;
+    flat_hash_map<protocol::RequestID, std::shared_ptr<cancellation_source>> incoming_requests;
+
+    // Key functions of superseding methods, std::function<std::string(const
+    // Params&)> each; and the latest request seen for each method and key.
+    method_table<std::any> supersede_keys;
+    method_table<protocol::RequestID> latest_requests;
+
+    struct QueuedRequest {
+        std::string method;
+        protocol::RequestID id;
+        task<> run;
+    };
 
-    std::unordered_map<protocol::RequestID, std::shared_ptr<PendingRequest>> pending_requests;
-    std::unordered_map<protocol::RequestID, std::shared_ptr<cancellation_source>> incoming_requests;
+    dispatch_options limits;
+    std::size_t in_flight = 0;
+    method_table<std::size_t> in_flight_by_method;
+    // Requests over a limit, not started yet.
+    std::deque<QueuedRequest> queued_requests;
+    // Set when the queue drops below max_queued, or on close().
+    event queue_space;
 
     bool running = false;
     bool writer_running = false;
     bool closed = false;
 
     LogCallback logger;
+    // Takes precedence over `logger` when set.
+    DeferredLog* deferred_log = nullptr;
     LogLevel min_level = LogLevel::info;
 
+    using metrics_clock = std::chrono::steady_clock;
+
+    std::shared_ptr<PeerMetrics> metrics;
+    // Entries of `metrics` already looked up, so recording takes no lock.
+    method_table<MethodMetrics*> method_metrics;
+    // Metrics replaced by set_metrics(), which requests still running may
+    // record into.
+    std::vector<std::shared_ptr<PeerMetrics>> retired_metrics;
+
+    /// Size and decode time of the message being dispatched.
+    struct MessageSample {
+        std::size_t bytes = 0;
+        std::uint64_t decode_ns = 0;
+    };
+
     explicit Self(event_loop& external_loop, CodecT codec_arg) :
         loop(external_loop), codec(std::move(codec_arg)) {}
 
-    void enqueue_outgoing(std::string payload) {
+    /// The metrics entry for `method`; null when metrics are off.
+    MethodMetrics* metrics_for(std::string_view method) {
+        if(!metrics) {
+            return nullptr;
+        }
+        auto it = method_metrics.find(method);
+        if(it == method_metrics.end()) {
+            it = method_metrics.emplace(std::string(method), &metrics->method(method)).first;
+        }
+        return it->second;
+    }
+
+    metrics_clock::time_point metrics_now() const noexcept {
+        return metrics ? metrics_clock::now() : metrics_clock::time_point{};
+    }
+
+    static std::uint64_t elapsed_ns(metrics_clock::time_point since) noexcept {
+        auto elapsed = metrics_clock::now() - since;
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    static void record_received(MethodMetrics& stats, const MessageSample& sample) noexcept {
+        stats.decode_ns.record(sample.decode_ns);
+        stats.request_bytes.record(sample.bytes);
+    }
+
+    /// Runs `encode(buffer)` on a recycled buffer and queues the result.
+    template <typename Encode>
+    Result<void> enqueue_encoded(outgoing_class kind,
+                                 Encode&& encode,
+                                 std::string_view supersede_key = {}) {
+        auto buffer = buffers.take();
+        auto status = encode(buffer);
+        if(status.has_error()) {
+            buffers.give(std::move(buffer));
+            return status;
+        }
+        enqueue_outgoing(kind, std::move(buffer), supersede_key);
+        return {};
+    }
+
+    /// Encodes a request carrying `params`. Codecs that can write typed
+    /// params straight into the envelope do so in one pass; the rest get
+    /// the params serialized on their own first.
+    template <typename Params>
+    Result<void> encode_request_with(std::string& out,
+                                     const protocol::RequestID& id,
+                                     std::string_view method,
+                                     const Params& params) {
+        if constexpr(requires { codec.encode_typed_request(out, id, method, params); }) {
+            return codec.encode_typed_request(out, id, method, params);
+        } else {
+            auto serialized = codec.serialize_value(params);
+            if(!serialized) {
+                return outcome_error(serialized.error());
+            }
+            return codec.encode_request(out, id, method, *serialized);
+        }
+    }
+
+    template <typename Params>
+    Result<void> encode_notification_with(std::string& out,
+                                          std::string_view method,
+                                          const Params& params) {
+        if constexpr(requires { codec.encode_typed_notification(out, method, params); }) {
+            return codec.encode_typed_notification(out, method, params);
+        } else {
+            auto serialized = codec.serialize_value(params);
+            if(!serialized) {
+                return outcome_error(serialized.error());
+            }
+            return codec.encode_notification(out, method, *serialized);
+        }
+    }
+
+    /// Registers a request and appends its encoding to `messages`, for a
+    /// Batch; the returned state is what its response completes.
+    Result<std::unique_ptr<PendingRequest>> add_batched_request(std::vector<std::string>& messages,
+                                                                std::string_view method,
+                                                                std::string_view params) {
+        if(!transport || closed) {
+            return outcome_error(Error("transport is null"));
+        }
+
+        auto pending = std::make_unique<PendingRequest>();
+        pending->id = next_request_id++;
+        auto buffer = buffers.take();
+        auto status =
+            codec.encode_request(buffer, protocol::RequestID{pending->id}, method, params);
+        if(status.has_error()) {
+            buffers.give(std::move(buffer));
+            return outcome_error(status.error());
+        }
+
+        messages.push_back(std::move(buffer));
+        pending_requests.insert(*pending);
+        return pending;
+    }
+
+    /// Tells the remote to stop working on request `id`, whose response
+    /// nobody waits for any more.
+    void send_cancel_request(std::int64_t id) {
+        if(!transport || closed) {
+            return;
+        }
+
+        auto params = codec.serialize_value(protocol::CancelRequestParams{protocol::RequestID{id}});
+        if(!params) {
+            return;
+        }
+        (void)enqueue_encoded(outgoing_class::request, [&](std::string& out) {
+            return codec.encode_notification(out, "$/cancelRequest", *params);
+        });
+    }
+
+    void enqueue_outgoing(outgoing_class kind,
+                          std::string payload,
+                          std::string_view supersede_key = {}) {
         if(closed) {
             return;
         }
         ET_IPC_LOG(this, LogLevel::trace, "send: {}", payload);
-        outgoing_queue.push_back(std::move(payload));
+        if(auto replaced = outgoing_queue.push(kind, std::move(payload), supersede_key)) {
+            buffers.give(std::move(*replaced));
+        }
         if(!writer_running) {
             writer_running = true;
             loop.schedule(write_loop());
@@ -140,22 +552,30 @@ struct Peer<CodecT>::Self {
     }
 
     task<> write_loop() {
-        while(!outgoing_queue.empty()) {
-            auto payload = std::move(outgoing_queue.front());
-            outgoing_queue.pop_front();
+        // Cap on the messages handed to one gather write.
+        constexpr std::size_t max_batch = 256;
+
+        std::vector<std::string> batch;
+        std::vector<std::string_view> payloads;
+        while(!outgoing_queue.empty() && transport) {
+            // Everything queued so far goes out in one write; messages
+            // queued while it is in flight form the next batch.
+            const auto count = (std::min)(outgoing_queue.size(), max_batch);
+            for(std::size_t i = 0; i < count; ++i) {
+                batch.push_back(outgoing_queue.pop());
+            }
+            payloads.assign(batch.begin(), batch.end());
 
-            if(!transport) {
-                break;
+            auto written = co_await transport->write_messages(payloads);
+
+            payloads.clear();
+            for(auto& payload: batch) {
+                buffers.give(std::move(payload));
             }
+            batch.clear();
 
-            auto written = co_await transport->write_message(payload);
             if(!written) {
-                ET_IPC_LOG(this,
-                           LogLevel::error,
-                           "transport write failed: {}",
-                           written.error().message);
-                outgoing_queue.clear();
-                fail_pending_requests(written.error().message);
+                abort_writes(written.error());
                 break;
             }
         }
@@ -163,25 +583,28 @@ struct Peer<CodecT>::Self {
         writer_running = false;
     }
 
+    void abort_writes(const Error& error) {
+        ET_IPC_LOG(this, LogLevel::error, "transport write failed: {}", error.message);
+        outgoing_queue.clear();
+        fail_pending_requests(error.message);
+    }
+
     void send_error(const protocol::RequestID& id, const Error& error) {
         ET_IPC_LOG(this, LogLevel::error, "error response: {}", error.message);
-        auto response = codec.encode_error_response(id, error);
-        if(response) {
-            enqueue_outgoing(std::move(*response));
-        }
+        (void)enqueue_encoded(outgoing_class::response, [&](std::string& out) {
+            return codec.encode_error_response(out, id, error);
+        });
     }
 
     void complete_pending_request(const protocol::RequestID& id, Result<std::string>&& response) {
-        auto it = pending_requests.find(id);
-        if(it == pending_requests.end()) {
+        auto* pending = pending_requests.take(id);
+        if(!pending) {
             ET_IPC_LOG(this, LogLevel::warn, "orphan response for id={}", id);
             return;
         }
 
         ET_IPC_LOG(this, LogLevel::debug, "response received for id={}", id);
 
-        auto pending = std::move(it->second);
-        pending_requests.erase(it);
         pending->response = std::move(response);
         pending->ready.set();
     }
@@ -197,17 +620,19 @@ struct Peer<CodecT>::Self {
                    pending_requests.size(),
                    message);
 
-        auto values = pending_requests | std::views::values;
-        std::vector<std::shared_ptr<PendingRequest>> pending(values.begin(), values.end());
-        pending_requests.clear();
-
-        for(auto& state: pending) {
-            state->response = outcome_error(Error(message));
-            state->ready.set();
+        // Waking one request may end others, whose state then leaves the
+        // table with their frames; look each one up again before failing it.
+        for(auto id: pending_requests.ids()) {
+            if(auto* pending = pending_requests.take(id)) {
+                pending->response = outcome_error(Error(message));
+                pending->ready.set();
+            }
         }
     }
 
-    void dispatch_notification(const std::string& method, std::string_view params) {
+    void dispatch_notification(std::string_view method,
+                               std::string_view params,
+                               const MessageSample& sample) {
         ET_IPC_LOG(this, LogLevel::debug, "notification: {}", method);
 
         if(method == "$/cancelRequest") {
@@ -228,15 +653,23 @@ struct Peer<CodecT>::Self {
         }
 
         if(auto it = notification_callbacks.find(method); it != notification_callbacks.end()) {
+            auto* stats = metrics_for(method);
+            const auto started = metrics_now();
             it->second(params);
+            if(stats) {
+                stats->notifications.fetch_add(1, std::memory_order_relaxed);
+                record_received(*stats, sample);
+                stats->handler_ns.record(elapsed_ns(started));
+            }
         } else {
             ET_IPC_LOG(this, LogLevel::warn, "unhandled notification: {}", method);
         }
     }
 
-    void dispatch_request(const std::string& method,
+    void dispatch_request(std::string_view method,
                           const protocol::RequestID& id,
-                          std::string_view params) {
+                          std::string_view params,
+                          const MessageSample& sample) {
         ET_IPC_LOG(this, LogLevel::debug, "request: {} id={}", method, id);
 
         if(incoming_requests.contains(id)) {
@@ -247,54 +680,307 @@ struct Peer<CodecT>::Self {
         auto it = request_callbacks.find(method);
         if(it == request_callbacks.end()) {
             send_error(id,
-                       Error(protocol::ErrorCode::MethodNotFound, "method not found: " + method));
+                       Error(protocol::ErrorCode::MethodNotFound,
+                             std::format("method not found: {}", method)));
             return;
         }
 
         auto callback = it->second;
         auto cancel_source = std::make_shared<cancellation_source>();
         incoming_requests.insert_or_assign(id, cancel_source);
-        auto task =
-            run_request(id, std::move(callback), std::string(params), cancel_source->token());
-        loop.schedule(std::move(task));
+        auto* stats = request_received(method, sample);
+        // The handler outlives the payload params view into, so they are
+        // copied once, into a recycled buffer.
+        auto owned_params = buffers.take();
+        owned_params.assign(params);
+        auto task = run_request(id,
+                                std::move(callback),
+                                std::move(owned_params),
+                                cancel_source->token(),
+                                stats);
+        start_request(method, id, std::move(task));
+    }
+
+    /// Counts a request accepted for `method`; null when metrics are off.
+    MethodMetrics* request_received(std::string_view method, const MessageSample& sample) {
+        auto* stats = metrics_for(method);
+        if(stats) {
+            stats->requests.fetch_add(1, std::memory_order_relaxed);
+            stats->in_flight.fetch_add(1, std::memory_order_relaxed);
+            record_received(*stats, sample);
+        }
+        return stats;
+    }
+
+    bool limited() const noexcept {
+        return limits.max_in_flight != 0 || limits.max_in_flight_per_method != 0;
+    }
+
+    bool has_capacity(std::string_view method) const {
+        if(limits.max_in_flight != 0 && in_flight >= limits.max_in_flight) {
+            return false;
+        }
+        if(limits.max_in_flight_per_method != 0) {
+            auto it = in_flight_by_method.find(method);
+            if(it != in_flight_by_method.end() && it->second >= limits.max_in_flight_per_method) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool queue_full() const noexcept {
+        return !queued_requests.empty() && queued_requests.size() >= limits.max_queued;
+    }
+
+    /// Runs `request` now if the limits allow, or queues it until they do.
+    void start_request(std::string_view method, const protocol::RequestID& id, task<> request) {
+        if(!limited()) {
+            loop.schedule(std::move(request));
+            return;
+        }
+
+        if(!has_capacity(method)) {
+            ET_IPC_LOG(this, LogLevel::debug, "request queued: {} id={}", method, id);
+            queued_requests.push_back({std::string(method), id, std::move(request)});
+            return;
+        }
+
+        launch_limited(std::string(method), std::move(request));
     }
 
+    void launch_limited(std::string method, task<> request) {
+        ++in_flight;
+        ++in_flight_by_method[method];
+        loop.schedule(run_limited(std::move(method), std::move(request)));
+    }
+
+    task<> run_limited(std::string method, task<> request) {
+        co_await std::move(request);
+
+        --in_flight;
+        if(auto it = in_flight_by_method.find(method); it != in_flight_by_method.end()) {
+            if(--it->second == 0) {
+                in_flight_by_method.erase(it);
+            }
+        }
+        start_queued();
+    }
+
+    /// Starts the queued requests that fit, oldest first; one blocked by its
+    /// method's limit does not hold back those after it.
+    void start_queued() {
+        const bool was_full = queue_full();
+        for(auto it = queued_requests.begin(); it != queued_requests.end();) {
+            if(limits.max_in_flight != 0 && in_flight >= limits.max_in_flight) {
+                break;
+            }
+            if(!has_capacity(it->method)) {
+                ++it;
+                continue;
+            }
+            auto queued = std::move(*it);
+            it = queued_requests.erase(it);
+            launch_limited(std::move(queued.method), std::move(queued.run));
+        }
+        if(was_full && !queue_full()) {
+            queue_space.set();
+        }
+    }
+
+    /// Records `id` as the latest request under `key`, cancelling the one
+    /// it replaces if that is still running.
+    void supersede(const std::string& key, const protocol::RequestID& id) {
+        auto [it, inserted] = latest_requests.try_emplace(key, id);
+        if(inserted) {
+            return;
+        }
+
+        auto previous = std::exchange(it->second, id);
+        auto found = incoming_requests.find(previous);
+        if(found == incoming_requests.end() || !found->second) {
+            return;
+        }
+
+        ET_IPC_LOG(this, LogLevel::debug, "request id={} superseded by id={}", previous, id);
+        // cancel() may resume the older request, which erases its entry.
+        auto source = found->second;
+        source->cancel();
+    }
+
+    void release_superseded(std::string_view key, const protocol::RequestID& id) {
+        if(auto it = latest_requests.find(key); it != latest_requests.end() && it->second == id) {
+            latest_requests.erase(it);
+        }
+    }
+
+    /// Drops the requests that never started; close() has cancelled them.
+    void discard_queued() {
+        for(auto& queued: queued_requests) {
+            incoming_requests.erase(queued.id);
+            if(auto* stats = metrics_for(queued.method)) {
+                stats->in_flight.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        queued_requests.clear();
+        queue_space.set();
+    }
+
+    // `stats` is the entry counting the request, or null.
     task<> run_request(protocol::RequestID id,
                        RequestCallback callback,
                        std::string params,
-                       cancellation_token token) {
+                       cancellation_token token,
+                       MethodMetrics* stats) {
+        const auto started = stats ? metrics_clock::now() : metrics_clock::time_point{};
         auto guarded_result = co_await with_token(callback(id, params, token), token);
+        if(stats) {
+            stats->handler_ns.record(elapsed_ns(started));
+        }
         incoming_requests.erase(id);
+        buffers.give(std::move(params));
+        send_result(id, guarded_result, stats);
+    }
+
+    task<> run_decoded_request(DecodedRequest request,
+                               cancellation_token token,
+                               MethodMetrics* stats) {
+        const auto started = stats ? metrics_clock::now() : metrics_clock::time_point{};
+        auto guarded_result = co_await with_token(request.run(token), token);
+        if(stats) {
+            stats->handler_ns.record(elapsed_ns(started));
+        }
+        incoming_requests.erase(request.id);
+        send_result(request.id, guarded_result, stats);
+    }
+
+    /// Replies to request `id` with the handler outcome in `guarded_result`.
+    template <typename Guarded>
+    void send_result(const protocol::RequestID& id,
+                     Guarded& guarded_result,
+                     MethodMetrics* stats) {
+        if(stats) {
+            stats->in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
 
         if(guarded_result.is_cancelled()) {
+            if(stats) {
+                stats->cancelled.fetch_add(1, std::memory_order_relaxed);
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+            }
             send_error(id, Error(protocol::ErrorCode::RequestCancelled, "request cancelled"));
-            co_return;
+            return;
         }
 
         if(guarded_result.has_error()) {
+            if(stats) {
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+            }
             send_error(id, guarded_result.error());
-            co_return;
+            return;
         }
 
-        auto response = codec.encode_success_response(id, *guarded_result);
-        if(!response) {
+        const auto started = stats ? metrics_clock::now() : metrics_clock::time_point{};
+        std::size_t bytes = 0;
+        auto response = enqueue_encoded(outgoing_class::response, [&](std::string& out) {
+            auto status = codec.encode_success_response(out, id, *guarded_result);
+            bytes = out.size();
+            return status;
+        });
+        if(response.has_error()) {
+            if(stats) {
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+            }
             send_error(id, Error(protocol::ErrorCode::InternalError, response.error().message));
-            co_return;
+        } else if(stats) {
+            stats->encode_ns.record(elapsed_ns(started));
+            stats->response_bytes.record(bytes);
         }
+    }
+
+    /// Hands a request for a method with a typed handler to that handler's
+    /// decoder, which reads id and params in one pass. False when the
+    /// payload has to go through parse_message() instead.
+    bool dispatch_decoded_request(std::string_view payload) {
+        if constexpr(requires(std::string_view text) { CodecT::peek_method(text); }) {
+            if(request_decoders.empty()) {
+                return false;
+            }
+
+            auto method = CodecT::peek_method(payload);
+            if(!method) {
+                return false;
+            }
 
-        enqueue_outgoing(std::move(*response));
+            auto it = request_decoders.find(*method);
+            if(it == request_decoders.end()) {
+                return false;
+            }
+
+            const auto started = metrics_now();
+            auto decoded = it->second(payload);
+            if(!decoded) {
+                return false;
+            }
+            const MessageSample sample{payload.size(), metrics ? elapsed_ns(started) : 0};
+
+            ET_IPC_LOG(this, LogLevel::debug, "request: {} id={}", *method, decoded->id);
+            if(incoming_requests.contains(decoded->id)) {
+                send_error(decoded->id,
+                           Error(protocol::ErrorCode::InvalidRequest, "duplicate request id"));
+                return true;
+            }
+
+            auto cancel_source = std::make_shared<cancellation_source>();
+            incoming_requests.insert_or_assign(decoded->id, cancel_source);
+            auto* stats = request_received(*method, sample);
+            auto id = decoded->id;
+            start_request(
+                *method,
+                id,
+                run_decoded_request(std::move(*decoded), cancel_source->token(), stats));
+            return true;
+        } else {
+            return false;
+        }
     }
 
     void dispatch_incoming_message(std::string_view payload) {
         ET_IPC_LOG(this, LogLevel::trace, "recv: {}", payload);
+        if constexpr(requires(std::string_view text) { CodecT::is_batch(text); }) {
+            // Each message of a batch is dispatched as if it had come alone;
+            // replies go out one by one, not as a batch.
+            if(CodecT::is_batch(payload)) {
+                auto messages = codec.split_batch(payload);
+                if(!messages) {
+                    send_error(protocol::RequestID{}, messages.error());
+                    return;
+                }
+
+                for(auto message: *messages) {
+                    dispatch_message(message);
+                }
+                return;
+            }
+        }
+        dispatch_message(payload);
+    }
+
+    void dispatch_message(std::string_view payload) {
+        if(dispatch_decoded_request(payload)) {
+            return;
+        }
+
+        const auto started = metrics_now();
         auto msg = codec.parse_message(payload);
+        const MessageSample sample{payload.size(), metrics ? elapsed_ns(started) : 0};
         std::visit(
             [&](auto& m) {
                 using T = std::remove_cvref_t<decltype(m)>;
                 if constexpr(std::is_same_v<T, IncomingRequest>) {
-                    dispatch_request(m.method, m.id, m.params);
+                    dispatch_request(m.method, m.id, m.params, sample);
                 } else if constexpr(std::is_same_v<T, IncomingNotification>) {
-                    dispatch_notification(m.method, m.params);
+                    dispatch_notification(m.method, m.params, sample);
                 } else if constexpr(std::is_same_v<T, IncomingResponse>) {
                     complete_pending_request(m.id, Result<std::string>(std::move(m.result)));
                 } else if constexpr(std::is_same_v<T, IncomingErrorResponse>) {
@@ -330,13 +1016,22 @@ task<> Peer<CodecT>::run() {
     ET_IPC_LOG(self.get(), LogLevel::info, "{}", "read loop started");
 
     while(self->transport) {
-        auto payload = co_await self->transport->read_message();
-        if(!payload.has_value()) {
+        // Backpressure: leave further requests in the transport while the
+        // queue of those over the dispatch limits is full.
+        while(self->queue_full()) {
+            co_await self->queue_space.wait();
+            self->queue_space.reset();
+        }
+
+        // Dispatch parses the payload into owned values, so it may borrow
+        // from the read buffer until the next read.
+        auto message = co_await self->transport->read_borrowed();
+        if(!message.has_value()) {
             self->fail_pending_requests("transport closed");
             break;
         }
 
-        self->dispatch_incoming_message(*payload);
+        self->dispatch_incoming_message(message->payload());
     }
 
     ET_IPC_LOG(self.get(), LogLevel::info, "{}", "read loop ended");
@@ -364,6 +1059,8 @@ Result<void> Peer<CodecT>::close() {
         }
     }
 
+    self->discard_queued();
+
     // Fail pending outgoing requests.
     self->fail_pending_requests("peer closed");
 
@@ -386,12 +1083,42 @@ Result<void> Peer<CodecT>::close_output() {
 template <typename CodecT>
 void Peer<CodecT>::set_logger(LogCallback callback, LogLevel min_level) {
     self->logger = std::move(callback);
+    self->deferred_log = nullptr;
     self->min_level = min_level;
 }
 
+template <typename CodecT>
+void Peer<CodecT>::set_logger(DeferredLog& log, LogLevel min_level) {
+    self->logger = nullptr;
+    self->deferred_log = &log;
+    self->min_level = min_level;
+}
+
+template <typename CodecT>
+void Peer<CodecT>::set_dispatch_options(dispatch_options opts) {
+    self->limits = opts;
+}
+
+template <typename CodecT>
+void Peer<CodecT>::set_metrics(std::shared_ptr<PeerMetrics> metrics) {
+    self->method_metrics.clear();
+    if(self->metrics) {
+        self->retired_metrics.push_back(std::move(self->metrics));
+    }
+    self->metrics = std::move(metrics);
+}
+
 template <typename CodecT>
 void Peer<CodecT>::register_request_callback(std::string_view method, RequestCallback callback) {
     self->request_callbacks.insert_or_assign(std::string(method), std::move(callback));
+    if(auto it = self->request_decoders.find(method); it != self->request_decoders.end()) {
+        self->request_decoders.erase(it);
+    }
+}
+
+template <typename CodecT>
+void Peer<CodecT>::register_request_decoder(std::string_view method, RequestDecoder decoder) {
+    self->request_decoders.insert_or_assign(std::string(method), std::move(decoder));
 }
 
 template <typename CodecT>
@@ -402,22 +1129,19 @@ void Peer<CodecT>::register_notification_callback(std::string_view method,
 
 template <typename CodecT>
 task<std::string, Error> Peer<CodecT>::send_request_impl(std::string_view method,
-                                                         std::string params,
+                                                         RequestEncoder encode,
                                                          request_options opts) {
-    std::shared_ptr<cancellation_source> timeout_source;
-    // Stops the timeout timer when this coroutine finishes (destructor calls cancel()).
-    std::optional<cancellation_source> timeout_stop;
+    // Armed on the loop's timer wheel; disarmed when this frame goes away.
+    std::optional<cancellation_source> deadline;
 
     if(opts.timeout.has_value()) {
         if(*opts.timeout <= std::chrono::milliseconds::zero()) {
             co_await fail(protocol::ErrorCode::RequestCancelled, "request timed out");
         }
 
-        timeout_source = std::make_shared<cancellation_source>();
-        timeout_stop.emplace();
+        deadline.emplace();
         if(self) {
-            self->loop.schedule(detail::cancel_after_timeout(
-                *opts.timeout, timeout_source, timeout_stop->token(), self->loop));
+            deadline->cancel_after(*opts.timeout, self->loop);
         }
     }
 
@@ -429,46 +1153,38 @@ task<std::string, Error> Peer<CodecT>::send_request_impl(std::string_view method
         co_await fail(protocol::ErrorCode::RequestCancelled, "request cancelled");
     }
 
-    protocol::RequestID request_id{self->next_request_id++};
-
-    auto pending = std::make_shared<typename Self::PendingRequest>();
-    self->pending_requests.insert_or_assign(request_id, pending);
-
-    auto request_encoded = self->codec.encode_request(request_id, method, params);
-    if(!request_encoded) {
-        self->pending_requests.erase(request_id);
+    typename Self::PendingRequest pending;
+    pending.id = self->next_request_id++;
+    pending.owner = self.get();
+    protocol::RequestID request_id{pending.id};
+    self->pending_requests.insert(pending);
+
+    auto request_encoded = self->enqueue_encoded(Self::outgoing_class::request,
+                                                 [&](std::string& out) {
+                                                     return encode(out, request_id);
+                                                 });
+    if(request_encoded.has_error()) {
+        self->pending_requests.erase(pending.id);
         co_await fail(request_encoded.error());
     }
 
-    self->enqueue_outgoing(std::move(*request_encoded));
-
-    auto wait_pending = [](const std::shared_ptr<typename Self::PendingRequest>& state) -> task<> {
-        co_await state->ready.wait();
+    auto wait_pending = [](typename Self::PendingRequest& state) -> task<> {
+        co_await state.ready.wait();
     };
     auto wait_task = wait_pending(pending);
     outcome<void, void, cancellation> wait_result = outcome_value();
-    if(opts.token && timeout_source) {
-        wait_result =
-            co_await with_token(std::move(wait_task), *opts.token, timeout_source->token());
+    if(opts.token && deadline) {
+        wait_result = co_await with_token(std::move(wait_task), *opts.token, deadline->token());
     } else if(opts.token) {
         wait_result = co_await with_token(std::move(wait_task), *opts.token);
-    } else if(timeout_source) {
-        wait_result = co_await with_token(std::move(wait_task), timeout_source->token());
+    } else if(deadline) {
+        wait_result = co_await with_token(std::move(wait_task), deadline->token());
     } else {
         co_await std::move(wait_task);
     }
     if(!wait_result.has_value()) {
-        if(auto it = self->pending_requests.find(request_id); it != self->pending_requests.end()) {
-            self->pending_requests.erase(it);
-            auto cancel_params_serialized =
-                self->codec.serialize_value(protocol::CancelRequestParams{request_id});
-            if(cancel_params_serialized) {
-                auto cancel_encoded =
-                    self->codec.encode_notification("$/cancelRequest", *cancel_params_serialized);
-                if(cancel_encoded) {
-                    self->enqueue_outgoing(std::move(*cancel_encoded));
-                }
-            }
+        if(self->pending_requests.take(pending.id)) {
+            self->send_cancel_request(pending.id);
         }
 
         if(opts.token && opts.token->cancelled()) {
@@ -477,32 +1193,183 @@ task<std::string, Error> Peer<CodecT>::send_request_impl(std::string_view method
         co_await fail(protocol::ErrorCode::RequestCancelled, "request timed out");
     }
 
-    if(!pending->response.has_value()) {
+    if(!pending.response.has_value()) {
         co_await fail("request was not completed");
     }
 
-    co_return co_await or_fail(std::move(*pending->response));
+    co_return co_await or_fail(std::move(*pending.response));
 }
 
 template <typename CodecT>
-Result<void> Peer<CodecT>::send_notification_impl(std::string_view method, std::string params) {
+template <typename Params>
+Result<void> Peer<CodecT>::send_notification_impl(std::string_view method,
+                                                  const Params& params,
+                                                  std::string_view supersede_key) {
     if(!self || !self->transport || self->closed) {
         return outcome_error(Error("transport is null"));
     }
 
-    auto notification_encoded = self->codec.encode_notification(method, params);
-    if(!notification_encoded) {
-        return outcome_error(notification_encoded.error());
+    return self->enqueue_encoded(
+        Self::notification_class(method),
+        [&](std::string& out) { return self->encode_notification_with(out, method, params); },
+        supersede_key);
+}
+
+template <typename CodecT>
+auto Peer<CodecT>::batch() -> Batch {
+    return Batch(*this);
+}
+
+template <typename CodecT>
+Peer<CodecT>::Batch::~Batch() {
+    if(!sent) {
+        fail_requests("batch was not sent");
+    }
+}
+
+template <typename CodecT>
+Result<void> Peer<CodecT>::Batch::send() {
+    if(sent) {
+        return outcome_error(Error("batch already sent"));
+    }
+    sent = true;
+
+    auto& state = *peer.self;
+    if(!state.transport || state.closed) {
+        fail_requests("transport is null");
+        return outcome_error(Error("transport is null"));
+    }
+    if(messages.empty()) {
+        return {};
     }
 
-    self->enqueue_outgoing(std::move(*notification_encoded));
+    // A batch waits as long as the most urgent message in it may.
+    const auto kind =
+        request_ids.empty() ? Self::outgoing_class::notification : Self::outgoing_class::request;
+    if constexpr(requires(CodecT& codec, std::string& out, std::span<const std::string> all) {
+                     codec.encode_batch(out, all);
+                 }) {
+        auto status = state.enqueue_encoded(kind, [&](std::string& out) {
+            return state.codec.encode_batch(out, messages);
+        });
+        for(auto& message: messages) {
+            state.buffers.give(std::move(message));
+        }
+        messages.clear();
+        if(status.has_error()) {
+            fail_requests(status.error().message);
+        }
+        return status;
+    } else {
+        for(auto& message: messages) {
+            state.enqueue_outgoing(kind, std::move(message));
+        }
+        messages.clear();
+        return {};
+    }
+}
+
+template <typename CodecT>
+Result<void> Peer<CodecT>::Batch::add_notification(std::string_view method,
+                                                   Result<std::string> params) {
+    if(!params) {
+        return outcome_error(params.error());
+    }
+    if(sent) {
+        return outcome_error(Error("batch already sent"));
+    }
+
+    auto& state = *peer.self;
+    auto buffer = state.buffers.take();
+    auto status = state.codec.encode_notification(buffer, method, *params);
+    if(status.has_error()) {
+        state.buffers.give(std::move(buffer));
+        return status;
+    }
+    messages.push_back(std::move(buffer));
     return {};
 }
 
+template <typename CodecT>
+void Peer<CodecT>::Batch::fail_requests(const std::string& message) {
+    for(auto id: request_ids) {
+        // Requests whose task is gone have already left the table.
+        if(auto* pending = peer.self->pending_requests.take(id)) {
+            pending->response = outcome_error(Error(message));
+            pending->ready.set();
+        }
+    }
+    request_ids.clear();
+
+    for(auto& buffer: messages) {
+        peer.self->buffers.give(std::move(buffer));
+    }
+    messages.clear();
+}
+
 // ---------------------------------------------------------------------------
 // Peer<CodecT> template methods
 // ---------------------------------------------------------------------------
 
+template <typename CodecT>
+template <typename Params>
+RequestResult<Params> Peer<CodecT>::Batch::request(const Params& params) {
+    static_assert(detail::has_request_traits_v<Params>,
+                  "Batch::request(params) requires RequestTraits<Params>");
+    using Traits = protocol::RequestTraits<Params>;
+    return request<typename Traits::Result>(Traits::method, params);
+}
+
+template <typename CodecT>
+template <typename ResultT, typename Params>
+task<ResultT, Error> Peer<CodecT>::Batch::request(std::string_view method, const Params& params) {
+    using Pending = std::unique_ptr<typename Self::PendingRequest>;
+
+    auto serialized_params = peer.self->codec.serialize_value(params);
+    if(!serialized_params) {
+        return peer.template await_batched<ResultT>(
+            Result<Pending>(outcome_error(serialized_params.error())));
+    }
+    if(sent) {
+        return peer.template await_batched<ResultT>(
+            Result<Pending>(outcome_error(Error("batch already sent"))));
+    }
+
+    auto pending = peer.self->add_batched_request(messages, method, *serialized_params);
+    if(pending) {
+        request_ids.push_back((*pending)->id);
+    }
+    return peer.template await_batched<ResultT>(std::move(pending));
+}
+
+template <typename CodecT>
+template <typename Params>
+Result<void> Peer<CodecT>::Batch::notify(const Params& params) {
+    static_assert(detail::has_notification_traits_v<Params>,
+                  "Batch::notify(params) requires NotificationTraits<Params>");
+    return add_notification(protocol::NotificationTraits<Params>::method,
+                            peer.self->codec.serialize_value(params));
+}
+
+template <typename CodecT>
+template <typename Params>
+Result<void> Peer<CodecT>::Batch::notify(std::string_view method, const Params& params) {
+    return add_notification(method, peer.self->codec.serialize_value(params));
+}
+
+template <typename CodecT>
+template <typename ResultT, typename Pending>
+task<ResultT, Error> Peer<CodecT>::await_batched(Result<Pending> pending) {
+    auto state = co_await or_fail(std::move(pending));
+    co_await state->ready.wait();
+    if(!state->response.has_value()) {
+        co_await fail("request was not completed");
+    }
+
+    auto raw_result = co_await or_fail(std::move(*state->response));
+    co_return co_await or_fail(self->codec.template deserialize_value<ResultT>(raw_result));
+}
+
 template <typename CodecT>
 template <typename Params>
 RequestResult<Params> Peer<CodecT>::send_request(const Params& params, request_options opts) {
@@ -510,10 +1377,10 @@ RequestResult<Params> Peer<CodecT>::send_request(const Params& params, request_o
                   "send_request(params) requires RequestTraits<Params>");
     using Traits = protocol::RequestTraits<Params>;
 
-    auto serialized_params = co_await or_fail(self->codec.serialize_value(params));
-    auto raw_result =
-        co_await send_request_impl(Traits::method, std::move(serialized_params), std::move(opts))
-            .or_fail();
+    auto encode = [&](std::string& out, const protocol::RequestID& id) {
+        return self->encode_request_with(out, id, Traits::method, params);
+    };
+    auto raw_result = co_await send_request_impl(Traits::method, encode, std::move(opts)).or_fail();
     co_return co_await or_fail(
         self->codec.template deserialize_value<typename Traits::Result>(raw_result));
 }
@@ -523,34 +1390,29 @@ template <typename ResultT, typename Params>
 task<ResultT, Error> Peer<CodecT>::send_request(std::string_view method,
                                                 const Params& params,
                                                 request_options opts) {
-    auto serialized_params = co_await or_fail(self->codec.serialize_value(params));
-    auto raw_result =
-        co_await send_request_impl(method, std::move(serialized_params), std::move(opts)).or_fail();
+    auto encode = [&](std::string& out, const protocol::RequestID& id) {
+        return self->encode_request_with(out, id, method, params);
+    };
+    auto raw_result = co_await send_request_impl(method, encode, std::move(opts)).or_fail();
     co_return co_await or_fail(self->codec.template deserialize_value<ResultT>(raw_result));
 }
 
 template <typename CodecT>
 template <typename Params>
-Result<void> Peer<CodecT>::send_notification(const Params& params) {
+Result<void> Peer<CodecT>::send_notification(const Params& params, notification_options opts) {
     static_assert(detail::has_notification_traits_v<Params>,
                   "send_notification(params) requires NotificationTraits<Params>");
     using Traits = protocol::NotificationTraits<Params>;
 
-    auto serialized_params = self->codec.serialize_value(params);
-    if(!serialized_params) {
-        return outcome_error(serialized_params.error());
-    }
-    return send_notification_impl(Traits::method, std::move(*serialized_params));
+    return send_notification_impl(Traits::method, params, opts.supersede_key);
 }
 
 template <typename CodecT>
 template <typename Params>
-Result<void> Peer<CodecT>::send_notification(std::string_view method, const Params& params) {
-    auto serialized_params = self->codec.serialize_value(params);
-    if(!serialized_params) {
-        return outcome_error(serialized_params.error());
-    }
-    return send_notification_impl(method, std::move(*serialized_params));
+Result<void> Peer<CodecT>::send_notification(std::string_view method,
+                                             const Params& params,
+                                             notification_options opts) {
+    return send_notification_impl(method, params, opts.supersede_key);
 }
 
 template <typename CodecT>
@@ -581,6 +1443,50 @@ void Peer<CodecT>::on_request(std::string_view method, Callback&& callback) {
     bind_request_callback<Params>(method, std::forward<Callback>(callback));
 }
 
+template <typename CodecT>
+template <typename Callback>
+void Peer<CodecT>::on_request(thread_pool& pool, Callback&& callback) {
+    detail::validate_pooled_request_callback_signature<Callback>();
+
+    using Params = detail::pooled_request_callback_params_t<Callback>;
+    static_assert(detail::has_request_traits_v<Params>,
+                  "on_request(pool, callback) requires RequestTraits<Params>");
+
+    using Ret = detail::request_callback_return_t<Callback>;
+    static_assert(
+        std::is_same_v<Ret, Result<typename protocol::RequestTraits<Params>::Result>> ||
+            std::is_same_v<Ret, Result<codec::RawValue>>,
+        "pooled request callback return type should be Result<Result> or Result<codec::RawValue>");
+
+    bind_pooled_request_callback<Params>(protocol::RequestTraits<Params>::method,
+                                         pool,
+                                         std::forward<Callback>(callback));
+}
+
+template <typename CodecT>
+template <typename Callback>
+void Peer<CodecT>::on_request(std::string_view method, thread_pool& pool, Callback&& callback) {
+    detail::validate_pooled_request_callback_signature<Callback>();
+
+    using Params = detail::pooled_request_callback_params_t<Callback>;
+    bind_pooled_request_callback<Params>(method, pool, std::forward<Callback>(callback));
+}
+
+template <typename CodecT>
+template <typename Params, typename KeyFn>
+void Peer<CodecT>::supersede_requests(std::string_view method, KeyFn&& key) {
+    std::function<std::string(const Params&)> key_fn = std::forward<KeyFn>(key);
+    self->supersede_keys.insert_or_assign(std::string(method), std::any(std::move(key_fn)));
+}
+
+template <typename CodecT>
+template <typename Params, typename KeyFn>
+void Peer<CodecT>::supersede_requests(KeyFn&& key) {
+    static_assert(detail::has_request_traits_v<Params>,
+                  "supersede_requests<Params>(key) requires RequestTraits<Params>");
+    supersede_requests<Params>(protocol::RequestTraits<Params>::method, std::forward<KeyFn>(key));
+}
+
 template <typename CodecT>
 template <typename Callback>
 void Peer<CodecT>::on_notification(Callback&& callback) {
@@ -611,10 +1517,10 @@ auto Peer<CodecT>::send_request(const typename protocol::RequestTraits<Tag>::Par
     -> task<typename protocol::RequestTraits<Tag>::Result, Error> {
     using Traits = protocol::RequestTraits<Tag>;
 
-    auto serialized_params = co_await or_fail(self->codec.serialize_value(params));
-    auto raw_result =
-        co_await send_request_impl(Traits::method, std::move(serialized_params), std::move(opts))
-            .or_fail();
+    auto encode = [&](std::string& out, const protocol::RequestID& id) {
+        return self->encode_request_with(out, id, Traits::method, params);
+    };
+    auto raw_result = co_await send_request_impl(Traits::method, encode, std::move(opts)).or_fail();
     co_return co_await or_fail(
         self->codec.template deserialize_value<typename Traits::Result>(raw_result));
 }
@@ -626,11 +1532,7 @@ Result<void> Peer<CodecT>::send_notification(
     const typename protocol::NotificationTraits<Tag>::Params& params) {
     using Traits = protocol::NotificationTraits<Tag>;
 
-    auto serialized_params = self->codec.serialize_value(params);
-    if(!serialized_params) {
-        return outcome_error(serialized_params.error());
-    }
-    return send_notification_impl(Traits::method, std::move(*serialized_params));
+    return send_notification_impl(Traits::method, params);
 }
 
 template <typename CodecT>
@@ -668,11 +1570,59 @@ void Peer<CodecT>::on_notification(Callback&& callback) {
 template <typename CodecT>
 template <typename Params, typename Callback>
 void Peer<CodecT>::bind_request_callback(std::string_view method, Callback&& callback) {
-    auto wrapped = [cb = std::forward<Callback>(callback),
-                    method_name = std::string(method),
-                    peer = this](const protocol::RequestID& request_id,
-                                 std::string_view params_raw,
-                                 cancellation_token token) -> task<std::string, Error> {
+    // Shared by the generic path and, when the codec has one, the decoder.
+    auto handler =
+        std::make_shared<std::remove_cvref_t<Callback>>(std::forward<Callback>(callback));
+    auto invoke = [handler, method_name = std::string(method), peer = this](
+                      protocol::RequestID request_id,
+                      Params params,
+                      cancellation_token token) -> task<std::string, Error> {
+        using KeyFn = std::function<std::string(const Params&)>;
+
+        // Clears this request's supersession entry however the handler ends.
+        struct supersession {
+            Self* self = nullptr;
+            std::string key;
+            protocol::RequestID id;
+
+            ~supersession() {
+                if(self) {
+                    self->release_superseded(key, id);
+                }
+            }
+        } superseding;
+
+        if(auto it = peer->self->supersede_keys.find(method_name);
+           it != peer->self->supersede_keys.end()) {
+            if(auto* key = std::any_cast<KeyFn>(&it->second)) {
+                superseding.key = method_name;
+                superseding.key.push_back('\0');
+                superseding.key.append((*key)(params));
+                superseding.id = request_id;
+                superseding.self = peer->self.get();
+                peer->self->supersede(superseding.key, request_id);
+            }
+        }
+
+        // Allocates only once the handler uses it.
+        std::pmr::monotonic_buffer_resource arena;
+        typename Peer::RequestContext context(*peer, request_id, std::move(token));
+        context.method = method_name;
+        context.memory = &arena;
+
+        auto result = co_await std::invoke(*handler, context, params).or_fail();
+        auto serialized = peer->self->codec.serialize_value(result);
+        if(!serialized) {
+            co_await fail(Error(protocol::ErrorCode::InternalError, serialized.error().message));
+        }
+
+        co_return std::move(*serialized);
+    };
+
+    auto wrapped = [invoke, method_name = std::string(method), peer = this](
+                       const protocol::RequestID& request_id,
+                       std::string_view params_raw,
+                       cancellation_token token) -> task<std::string, Error> {
         auto parsed_params = peer->self->codec.template deserialize_value<Params>(
             params_raw,
             protocol::ErrorCode::InvalidParams);
@@ -684,17 +1634,85 @@ void Peer<CodecT>::bind_request_callback(std::string_view method, Callback&& cal
                        parsed_params.error().message);
             co_await fail(parsed_params.error());
         }
+        detail::share_raw_params(*parsed_params);
 
-        typename Peer::RequestContext context(*peer, request_id, std::move(token));
-        context.method = method_name;
+        co_return co_await invoke(request_id, std::move(*parsed_params), std::move(token))
+            .or_fail();
+    };
 
-        auto result = co_await std::invoke(cb, context, *parsed_params).or_fail();
-        auto serialized = peer->self->codec.serialize_value(result);
-        if(!serialized) {
-            co_await fail(Error(protocol::ErrorCode::InternalError, serialized.error().message));
-        }
+    register_request_callback(method, std::move(wrapped));
 
-        co_return std::move(*serialized);
+    if constexpr(requires(CodecT& codec, std::string_view payload) {
+                     codec.template decode_request<Params>(payload);
+                 }) {
+        // Malformed requests are left to the generic path, which reports
+        // them the same way it always has.
+        auto decoder = [invoke, peer = this](
+                           std::string_view payload) -> std::optional<DecodedRequest> {
+            auto decoded = peer->self->codec.template decode_request<Params>(payload);
+            if(!decoded) {
+                return std::nullopt;
+            }
+
+            detail::share_raw_params(decoded->params);
+            auto id = decoded->id;
+            return DecodedRequest{
+                id,
+                [invoke, id, params = std::move(decoded->params)](cancellation_token token) {
+                    return invoke(id, params, std::move(token));
+                },
+            };
+        };
+        register_request_decoder(method, std::move(decoder));
+    }
+}
+
+template <typename CodecT>
+template <typename Params, typename Callback>
+void Peer<CodecT>::bind_pooled_request_callback(std::string_view method,
+                                                thread_pool& pool,
+                                                Callback&& callback) {
+    auto handler =
+        std::make_shared<std::remove_cvref_t<Callback>>(std::forward<Callback>(callback));
+    auto wrapped = [handler, pool = &pool, method_name = std::string(method), peer = this](
+                       const protocol::RequestID&,
+                       std::string_view params_raw,
+                       cancellation_token) -> task<std::string, Error> {
+        // The codecs keep no state, and `params_raw` lives in the caller's
+        // frame until this one completes, which waits for the worker even
+        // when cancelled; so the job borrows both.
+        auto& codec = peer->self->codec;
+        auto job = [&]() -> Result<std::string> {
+            auto params =
+                codec.template deserialize_value<Params>(params_raw,
+                                                         protocol::ErrorCode::InvalidParams);
+            if(!params) {
+                return outcome_error(params.error());
+            }
+            detail::share_raw_params(*params);
+
+            auto result = std::invoke(*handler, std::as_const(*params));
+            if(!result) {
+                return outcome_error(result.error());
+            }
+            return codec.serialize_value(*result);
+        };
+
+        auto done = co_await pool->submit(job, peer->self->loop);
+        if(!done) {
+            co_await fail(
+                Error(protocol::ErrorCode::InternalError, std::string(done.error().message())));
+        }
+        constexpr auto invalid_params =
+            static_cast<protocol::integer>(protocol::ErrorCode::InvalidParams);
+        if(done->has_error() && done->error().code == invalid_params) {
+            ET_IPC_LOG(peer->self.get(),
+                       LogLevel::warn,
+                       "request '{}' params deserialization failed: {}",
+                       method_name,
+                       done->error().message);
+        }
+        co_return co_await or_fail(std::move(*done));
     };
 
     register_request_callback(method, std::move(wrapped));
@@ -713,6 +1731,7 @@ void Peer<CodecT>::bind_notification_callback(std::string_view method, Callback&
                        parsed_params.error().message);
             return;
         }
+        detail::share_raw_params(*parsed_params);
         std::invoke(cb, *parsed_params);
     };
 
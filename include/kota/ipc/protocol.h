@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cassert>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <format>
 #include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -40,7 +45,152 @@ struct Value : Variant {
     using Variant::operator=;
 };
 
-using RequestID = std::variant<std::int64_t, std::string>;
+/// A JSON-RPC request id, an integer or a string, in 16 bytes. Strings of
+/// up to eight bytes are kept inline and longer ones on the heap, and the
+/// hash is taken once when the id is made, so keying a table by an id and
+/// copying it into a response stay cheap.
+class RequestID {
+public:
+    constexpr static std::size_t inline_capacity = 8;
+
+    /// The integer 0.
+    RequestID() noexcept : RequestID(std::int64_t(0)) {}
+
+    template <std::integral T>
+        requires (!std::same_as<T, bool>)
+    RequestID(T value) noexcept : size_and_kind(integer_kind) {
+        payload.number = static_cast<std::int64_t>(value);
+        digest = mix(static_cast<std::uint64_t>(payload.number));
+    }
+
+    RequestID(std::string_view text) {
+        assign(text);
+    }
+
+    RequestID(const std::string& text) : RequestID(std::string_view(text)) {}
+
+    RequestID(const char* text) : RequestID(std::string_view(text)) {}
+
+    RequestID(const RequestID& other) :
+        payload(other.payload), digest(other.digest), size_and_kind(other.size_and_kind) {
+        if(kind() == heap_kind) {
+            copy_heap(other.as_string());
+        }
+    }
+
+    RequestID(RequestID&& other) noexcept :
+        payload(other.payload), digest(other.digest), size_and_kind(other.size_and_kind) {
+        other.size_and_kind = integer_kind;
+    }
+
+    RequestID& operator=(const RequestID& other) {
+        if(this != &other) {
+            RequestID copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    RequestID& operator=(RequestID&& other) noexcept {
+        if(this != &other) {
+            release();
+            payload = other.payload;
+            digest = other.digest;
+            size_and_kind = std::exchange(other.size_and_kind, integer_kind);
+        }
+        return *this;
+    }
+
+    ~RequestID() {
+        release();
+    }
+
+    bool is_integer() const noexcept {
+        return kind() == integer_kind;
+    }
+
+    bool is_string() const noexcept {
+        return kind() != integer_kind;
+    }
+
+    std::int64_t as_integer() const noexcept {
+        assert(is_integer() && "request id is a string");
+        return payload.number;
+    }
+
+    std::string_view as_string() const noexcept {
+        assert(is_string() && "request id is an integer");
+        const auto size = size_and_kind >> kind_bits;
+        return {kind() == heap_kind ? payload.heap : payload.chars, size};
+    }
+
+    std::size_t hash() const noexcept {
+        return digest;
+    }
+
+    friend bool operator==(const RequestID& lhs, const RequestID& rhs) noexcept {
+        if(lhs.digest != rhs.digest || lhs.is_integer() != rhs.is_integer()) {
+            return false;
+        }
+        return lhs.is_integer() ? lhs.payload.number == rhs.payload.number
+                                : lhs.as_string() == rhs.as_string();
+    }
+
+private:
+    enum : std::uint32_t {
+        integer_kind = 0,
+        inline_kind = 1,
+        heap_kind = 2,
+    };
+
+    constexpr static std::uint32_t kind_bits = 2;
+
+    static std::uint32_t mix(std::uint64_t value) noexcept {
+        value *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::uint32_t>(value >> 32);
+    }
+
+    std::uint32_t kind() const noexcept {
+        return size_and_kind & ((1U << kind_bits) - 1);
+    }
+
+    void assign(std::string_view text) {
+        assert(text.size() < (std::size_t(1) << (32 - kind_bits)) && "request id is too long");
+        digest = mix(std::hash<std::string_view>{}(text));
+        const auto size = static_cast<std::uint32_t>(text.size()) << kind_bits;
+        if(text.size() <= inline_capacity) {
+            payload.number = 0;
+            std::memcpy(payload.chars, text.data(), text.size());
+            size_and_kind = size | inline_kind;
+        } else {
+            copy_heap(text);
+            size_and_kind = size | heap_kind;
+        }
+    }
+
+    void copy_heap(std::string_view text) {
+        payload.heap = new char[text.size()];
+        std::memcpy(payload.heap, text.data(), text.size());
+    }
+
+    void release() noexcept {
+        if(kind() == heap_kind) {
+            delete[] payload.heap;
+        }
+    }
+
+    union {
+        std::int64_t number;
+        char* heap;
+        char chars[inline_capacity];
+    } payload;
+
+    std::uint32_t digest;
+    /// The string size above kind_bits bits of kind.
+    std::uint32_t size_and_kind;
+};
+
+static_assert(sizeof(RequestID) == 16);
 
 enum class ErrorCode : integer {
     ParseError = -32700,
@@ -81,11 +231,7 @@ namespace std {
 template <>
 struct hash<kota::ipc::protocol::RequestID> {
     std::size_t operator()(const kota::ipc::protocol::RequestID& id) const noexcept {
-        return std::visit(
-            [](const auto& v) -> std::size_t {
-                return std::hash<std::remove_cvref_t<decltype(v)>>{}(v);
-            },
-            id);
+        return id.hash();
     }
 };
 
@@ -96,15 +242,10 @@ struct formatter<kota::ipc::protocol::RequestID> {
     }
 
     auto format(const kota::ipc::protocol::RequestID& id, format_context& ctx) const {
-        return std::visit(
-            [&](const auto& v) {
-                if constexpr(std::is_same_v<std::remove_cvref_t<decltype(v)>, std::string>) {
-                    return std::format_to(ctx.out(), "\"{}\"", v);
-                } else {
-                    return std::format_to(ctx.out(), "{}", v);
-                }
-            },
-            id);
+        if(id.is_string()) {
+            return std::format_to(ctx.out(), "\"{}\"", id.as_string());
+        }
+        return std::format_to(ctx.out(), "{}", id.as_integer());
     }
 };
 
@@ -142,6 +283,38 @@ struct deserialize_traits<D, kota::ipc::protocol::Value> {
     }
 };
 
+template <serializer_like S>
+struct serialize_traits<S, kota::ipc::protocol::RequestID> {
+    using value_type = typename S::value_type;
+    using error_type = typename S::error_type;
+
+    static auto serialize(S& serializer, const kota::ipc::protocol::RequestID& id)
+        -> std::expected<value_type, error_type> {
+        if(id.is_integer()) {
+            return codec::serialize(serializer, id.as_integer());
+        }
+        return codec::serialize(serializer, id.as_string());
+    }
+};
+
+/// Read as the variant the wire holds, then packed.
+template <deserializer_like D>
+struct deserialize_traits<D, kota::ipc::protocol::RequestID> {
+    using error_type = typename D::error_type;
+
+    static auto deserialize(D& deserializer, kota::ipc::protocol::RequestID& id)
+        -> std::expected<void, error_type> {
+        std::variant<std::int64_t, std::string> wire;
+        KOTA_EXPECTED_TRY(codec::deserialize(deserializer, wire));
+        if(auto* number = std::get_if<std::int64_t>(&wire)) {
+            id = *number;
+        } else {
+            id = std::get<std::string>(wire);
+        }
+        return {};
+    }
+};
+
 template <serializer_like S>
 struct serialize_traits<S, kota::ipc::protocol::Error> {
     using value_type = typename S::value_type;
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 
 #include "kota/ipc/transport.h"
 
@@ -13,24 +19,80 @@ namespace kota::ipc {
 /// Transport decorator that records client-to-server messages to a JSONL file.
 /// Each line is: {"ts":<ms_since_start>,"msg":"<escaped_json>"}
 /// The timestamp enables faithful replay pacing.
+///
+/// The loop thread only copies each message into a bounded queue; a writer
+/// thread escapes the records and writes them to the file in large chunks,
+/// so a slow disk never stalls the loop. When the writer falls behind and
+/// the queue is full, messages are left out of the trace and counted by
+/// dropped(). The file is complete once close() returns or the transport is
+/// destroyed.
 class RecordingTransport : public Transport {
 public:
+    struct options {
+        /// Messages the queue holds before further ones are dropped.
+        std::size_t queue_capacity = 4096;
+
+        /// Bytes of records gathered before each write to the file.
+        std::size_t buffer_size = 256 * 1024;
+    };
+
     /// @param transport  The real transport to wrap.
     /// @param path       File path to write the recorded trace (.jsonl).
-    RecordingTransport(std::unique_ptr<Transport> transport, std::string path);
+    RecordingTransport(std::unique_ptr<Transport> transport, std::string path, options opts);
+
+    RecordingTransport(std::unique_ptr<Transport> transport, std::string path) :
+        RecordingTransport(std::move(transport), std::move(path), options{}) {}
+
     ~RecordingTransport();
 
+    /// Messages left out of the trace because the queue was full.
+    std::uint64_t dropped() const noexcept {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
     task<std::optional<std::string>> read_message() override;
     task<void, Error> write_message(std::string_view payload) override;
+    task<void, Error> write_messages(std::span<const std::string_view> payloads) override;
+    void cork() override;
+    task<void, Error> uncork() override;
     Result<void> close_output() override;
     Result<void> close() override;
 
 private:
+    struct Entry {
+        std::chrono::milliseconds time{0};
+        std::string message;
+    };
+
+    /// Loop thread: queues `payload`, or counts it as dropped.
     void write_record(std::string_view payload);
 
+    /// Writer thread: drains the queue into the file until stopped.
+    void run_writer();
+
+    /// Stops the writer once it has drained the queue, and closes the file.
+    void finish();
+
     std::unique_ptr<Transport> inner;
     std::FILE* file = nullptr;
     std::chrono::steady_clock::time_point start;
+    std::size_t buffer_size;
+
+    // Single-producer/single-consumer ring: the loop thread fills slots at
+    // `tail`, the writer empties them at `head`. Both only ever grow.
+    std::unique_ptr<Entry[]> slots;
+    std::size_t capacity;
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+
+    // The writer sets `sleeping` before waiting on `doorbell`; the loop
+    // thread only bumps the doorbell when it finds the flag set.
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint32_t> doorbell{0};
+
+    std::atomic<std::uint64_t> dropped_count{0};
+    std::thread writer;
 };
 
 }  // namespace kota::ipc
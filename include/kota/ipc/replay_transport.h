@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "kota/ipc/transport.h"
+
+namespace kota::ipc {
+
+/// Transport that plays back a trace written by RecordingTransport as its
+/// incoming messages, so a Peer can be driven by a recorded session.
+///
+/// Messages written to it go to the write hook, if one is set, and are
+/// otherwise dropped. Input ends after the last recorded message.
+class ReplayTransport : public Transport {
+public:
+    struct Record {
+        /// Time since the recording started.
+        std::chrono::milliseconds time{0};
+        std::string message;
+    };
+
+    struct options {
+        /// Deliver each message at its recorded time after the first read,
+        /// instead of as soon as it is asked for.
+        bool real_time = false;
+    };
+
+    using MessageHook = std::function<void(std::string_view)>;
+
+    ReplayTransport(std::vector<Record> records, options opts);
+
+    explicit ReplayTransport(std::vector<Record> records) :
+        ReplayTransport(std::move(records), options{}) {}
+
+    /// Reads a `.jsonl` trace. Fails when the file cannot be read or a line
+    /// is not a record RecordingTransport writes.
+    static Result<std::vector<Record>> load(const std::string& path);
+
+    /// Called with each message as read_message() delivers it.
+    void on_read(MessageHook hook) {
+        read_hook = std::move(hook);
+    }
+
+    /// Called with each message written.
+    void on_write(MessageHook hook) {
+        write_hook = std::move(hook);
+    }
+
+    /// Records not delivered yet.
+    std::size_t remaining() const noexcept {
+        return records.size() - next;
+    }
+
+    task<std::optional<std::string>> read_message() override;
+    task<void, Error> write_message(std::string_view payload) override;
+    Result<void> close() override;
+
+private:
+    std::vector<Record> records;
+    std::size_t next = 0;
+    options opts;
+
+    MessageHook read_hook;
+    MessageHook write_hook;
+
+    std::optional<std::chrono::steady_clock::time_point> start;
+    // Cancels a real-time wait when the transport is closed.
+    cancellation_source stop;
+    bool closed = false;
+};
+
+}  // namespace kota::ipc
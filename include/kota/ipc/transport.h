@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -10,14 +12,67 @@
 
 namespace kota::ipc {
 
+/// A received message whose payload may still sit in the transport's read
+/// buffer. Its bytes are released when it is destroyed; it must be destroyed
+/// before the next read from, or close of, the transport that produced it.
+class BorrowedMessage {
+public:
+    BorrowedMessage() = default;
+
+    /// A message that owns its payload.
+    explicit BorrowedMessage(std::string payload) noexcept;
+
+    /// Views `payload` inside `source`'s buffer; destruction consumes the
+    /// first `release` buffered bytes of `source`.
+    BorrowedMessage(std::string_view payload, stream& source, std::size_t release) noexcept;
+
+    BorrowedMessage(const BorrowedMessage&) = delete;
+    BorrowedMessage& operator=(const BorrowedMessage&) = delete;
+
+    BorrowedMessage(BorrowedMessage&& other) noexcept;
+    BorrowedMessage& operator=(BorrowedMessage&& other) noexcept;
+
+    ~BorrowedMessage();
+
+    std::string_view payload() const noexcept {
+        return source ? view : std::string_view(owned);
+    }
+
+private:
+    void release_bytes() noexcept;
+
+    std::string owned;
+    std::string_view view;
+    stream* source = nullptr;
+    std::size_t release = 0;
+};
+
 class Transport {
 public:
     virtual ~Transport() = default;
 
     virtual task<std::optional<std::string>> read_message() = 0;
 
+    /// Like read_message(), but without copying the payload out of the read
+    /// buffer where the transport can avoid it. By default it wraps
+    /// read_message().
+    virtual task<std::optional<BorrowedMessage>> read_borrowed();
+
     virtual task<void, Error> write_message(std::string_view payload) = 0;
 
+    /// Writes `payloads` in order, as the same messages write_message()
+    /// would. Transports that can send them in one gather write do; by
+    /// default each is written in turn.
+    virtual task<void, Error> write_messages(std::span<const std::string_view> payloads);
+
+    /// Lets the transport coalesce the messages written until uncork();
+    /// transports that cannot do so write each message as before.
+    virtual void cork();
+
+    /// Stops coalescing and waits until every message written since cork()
+    /// has been sent.
+    virtual task<void, Error> uncork();
+
     virtual Result<void> close_output();
 
     /// Close both input and output, aborting any pending read.
@@ -39,8 +94,19 @@ public:
 
     task<std::optional<std::string>> read_message() override;
 
+    /// Borrows the payload when the whole message is already buffered in one
+    /// contiguous piece, and copies it out as read_message() does otherwise.
+    task<std::optional<BorrowedMessage>> read_borrowed() override;
+
     task<void, Error> write_message(std::string_view payload) override;
 
+    /// Sends every frame in one gather write.
+    task<void, Error> write_messages(std::span<const std::string_view> payloads) override;
+
+    void cork() override;
+
+    task<void, Error> uncork() override;
+
     Result<void> close_output() override;
 
     Result<void> close() override;
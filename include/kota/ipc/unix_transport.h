@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/ipc/transport.h"
+
+namespace kota::ipc {
+
+/// Transport over a Unix domain socket (a named pipe on Windows) that can
+/// send open descriptors along with a message, so processes can hand each
+/// other files, sockets or shared memory mappings instead of their bytes.
+///
+/// Messages use StreamTransport's Content-Length framing; a message that
+/// carries descriptors also has a File-Descriptors header giving their
+/// count, and the descriptors themselves ride with its first byte
+/// (SCM_RIGHTS). Descriptor passing is Unix only; on Windows sending them
+/// fails and plain messages work as usual.
+class UnixSocketTransport : public Transport {
+public:
+    /// Most descriptors one message may carry (Linux's SCM_MAX_FD).
+    constexpr static std::size_t max_descriptors = 253;
+
+    /// Wraps a connected pipe; it must have been opened with
+    /// pipe::options::ipc set to receive descriptors.
+    explicit UnixSocketTransport(pipe channel);
+
+    /// Closes received descriptors that were not taken.
+    ~UnixSocketTransport() override;
+
+    static task<std::unique_ptr<UnixSocketTransport>, Error> connect(std::string_view path,
+                                                                     event_loop& loop);
+
+    /// Wraps a connected socket descriptor, e.g. one end of a socketpair()
+    /// inherited by a child process.
+    static Result<std::unique_ptr<UnixSocketTransport>> open(int fd, event_loop& loop);
+
+    /// Listens on `path`; wrap each accepted pipe in a transport.
+    static Result<pipe::acceptor> listen(std::string_view path, event_loop& loop);
+
+    task<std::optional<std::string>> read_message() override;
+
+    task<void, Error> write_message(std::string_view payload) override;
+
+    /// Sends `payload` with `descriptors`, which stay owned by the caller;
+    /// the peer receives duplicates of them.
+    task<void, Error> write_message(std::string_view payload, std::span<const int> descriptors);
+
+    /// Takes the descriptors that arrived with the message last returned by
+    /// read_message(); the caller owns them. Those not taken before the
+    /// next read_message() are closed.
+    std::vector<int> take_descriptors();
+
+    Result<void> close_output() override;
+
+    Result<void> close() override;
+
+private:
+    void close_received() noexcept;
+
+    pipe channel;
+    mutex write_lock;
+    std::vector<int> received;
+};
+
+}  // namespace kota::ipc
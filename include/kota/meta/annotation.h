@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "attrs.h"
+#include "kota/support/interned_string.h"
 #include "kota/support/naming.h"
 
 namespace kota::meta {
@@ -148,6 +149,18 @@ using skip_if = annotation<T, behavior::skip_if<Pred>>;
 template <typename E, typename Policy = rename_policy::lower_camel>
 using enum_string = annotation<E, behavior::enum_string<Policy>>;
 
+/// A flag enum written as the names of its set flags, ["read", "write"],
+/// rather than as the integer of all its bits, which is how an enum is
+/// written otherwise.
+template <typename E, typename Policy = rename_policy::lower_camel>
+using enum_flags = annotation<E, behavior::enum_flags<Policy>>;
+
+/// A string decoded into `Pool::pool()`, a string_pool, rather than the
+/// global one an unannotated interned_string goes into: a cache can keep
+/// its strings in a pool that is dropped with it.
+template <typename Pool>
+using interned = annotation<interned_string, behavior::intern<Pool>>;
+
 template <typename T>
 using skip_if_none = annotation<std::optional<T>, behavior::skip_if<pred::optional_none>>;
 
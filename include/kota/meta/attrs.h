@@ -405,6 +405,18 @@ struct enum_string {
     using policy = Policy;
 };
 
+/// A flag enum written as an array of the names of its set flags.
+template <typename Policy>
+struct enum_flags {
+    using policy = Policy;
+};
+
+/// A string decoded into the string_pool `Pool::pool()` returns.
+template <typename Pool>
+struct intern {
+    using pool = Pool;
+};
+
 template <typename Pred>
 struct skip_if {
     using predicate = Pred;
@@ -482,15 +494,20 @@ struct default_value {
 /// True for the closed set of behavior attributes.
 template <typename T>
 constexpr bool is_behavior_attr_v =
-    is_specialization_of<behavior::enum_string, T> || is_specialization_of<behavior::skip_if, T> ||
-    is_specialization_of<behavior::with, T> || is_specialization_of<behavior::as, T>;
+    is_specialization_of<behavior::enum_string, T> ||
+    is_specialization_of<behavior::enum_flags, T> || is_specialization_of<behavior::intern, T> ||
+    is_specialization_of<behavior::skip_if, T> || is_specialization_of<behavior::with, T> ||
+    is_specialization_of<behavior::as, T>;
 
-/// True for behavior providers (with/as/enum_string) — at most one per field.
+/// True for behavior providers (with/as/enum_string/enum_flags/intern) — at most one per
+/// field.
 template <typename T>
 struct is_behavior_provider {
     constexpr static bool value = is_specialization_of<behavior::with, T> ||
                                   is_specialization_of<behavior::as, T> ||
-                                  is_specialization_of<behavior::enum_string, T>;
+                                  is_specialization_of<behavior::enum_string, T> ||
+                                  is_specialization_of<behavior::enum_flags, T> ||
+                                  is_specialization_of<behavior::intern, T>;
 };
 
 namespace detail {
@@ -498,7 +515,8 @@ namespace detail {
 template <typename AttrsTuple>
 constexpr bool validate_attrs() {
     static_assert(tuple_count_of_v<AttrsTuple, is_behavior_provider> <= 1,
-                  "At most one behavior provider (with/as/enum_string) allowed per field");
+                  "At most one behavior provider (with/as/enum_string/enum_flags/intern) "
+                  "allowed per field");
     return true;
 }
 
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
+#include <memory>
 #include <ranges>
 #include <type_traits>
 #include <utility>
@@ -108,6 +110,43 @@ concept takeover_range_gt = takeover_for_range<gt_op, L, R>;
 template <typename L, typename R>
 concept takeover_range_ge = takeover_for_range<ge_op, L, R>;
 
+/// Whether meta::eq on two T compares exactly their bytes: T is a scalar
+/// that is not floating point, an array of such, or a struct that has no
+/// operator==, no padding and only such fields. A field with its own
+/// operator== may compare less than its bytes, so it rules the struct out.
+template <typename T>
+consteval bool bitwise_eq_comparable() {
+    if constexpr(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) {
+        return true;
+    } else if constexpr(std::is_bounded_array_v<T>) {
+        return bitwise_eq_comparable<std::remove_extent_t<T>>();
+    } else if constexpr(reflectable_class<T> && !eq_comparable_with<T, T>) {
+        if constexpr(!std::is_trivially_copyable_v<T> ||
+                     !std::has_unique_object_representations_v<T>) {
+            return false;
+        } else {
+            return []<std::size_t... Is>(std::index_sequence<Is...>) {
+                return (bitwise_eq_comparable<std::remove_cv_t<field_type<T, Is>>>() && ...);
+            }(std::make_index_sequence<field_count<T>()>{});
+        }
+    } else {
+        return false;
+    }
+}
+
+template <typename L, typename R>
+concept bitwise_eq_pair =
+    std::same_as<L, R> && std::is_class_v<L> && bitwise_eq_comparable<L>();
+
+/// Contiguous ranges of the same bitwise comparable element type, which
+/// compare equal exactly when their element bytes do.
+template <typename L, typename R>
+concept bitwise_eq_ranges =
+    std::ranges::contiguous_range<const L> && std::ranges::sized_range<const L> &&
+    std::ranges::contiguous_range<const R> && std::ranges::sized_range<const R> &&
+    std::same_as<std::ranges::range_value_t<const L>, std::ranges::range_value_t<const R>> &&
+    bitwise_eq_comparable<std::ranges::range_value_t<const L>>();
+
 template <typename L, typename R>
 constexpr bool compare_eq(const L& lhs, const R& rhs);
 
@@ -208,6 +247,18 @@ constexpr bool compare_map_eq_unordered(const L& lhs, const R& rhs) {
 
 template <typename L, typename R>
 constexpr bool compare_sequence_eq(const L& lhs, const R& rhs) {
+    if constexpr(bitwise_eq_ranges<L, R>) {
+        if !consteval {
+            const auto count = std::ranges::size(lhs);
+            if(count != std::ranges::size(rhs)) {
+                return false;
+            }
+            using element_t = std::ranges::range_value_t<const L>;
+            return count == 0 || std::memcmp(std::ranges::data(lhs),
+                                             std::ranges::data(rhs),
+                                             count * sizeof(element_t)) == 0;
+        }
+    }
     return compare_range_eq(lhs, rhs, [](const auto& l, const auto& r) {
         return compare_eq(l, r);
     });
@@ -342,6 +393,12 @@ constexpr bool compare_eq(const L& lhs, const R& rhs) {
         constexpr std::size_t lhs_count = reflection<L>::field_count;
         constexpr std::size_t rhs_count = reflection<R>::field_count;
 
+        if constexpr(bitwise_eq_pair<L, R>) {
+            if !consteval {
+                return std::memcmp(std::addressof(lhs), std::addressof(rhs), sizeof(L)) == 0;
+            }
+        }
+
         if constexpr(lhs_count != rhs_count) {
             return false;
         } else if constexpr(lhs_count == 0) {
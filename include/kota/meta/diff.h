@@ -0,0 +1,391 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "annotation.h"
+#include "compare.h"
+#include "struct.h"
+#include "type_info.h"
+#include "kota/support/ranges.h"
+#include "kota/support/type_traits.h"
+
+namespace kota::meta {
+
+enum class patch_kind : std::uint8_t {
+    /// The value at the path is replaced by the new snapshot's value.
+    replace,
+    /// Elements [start, start + remove) of the sequence at the path are
+    /// replaced by the new snapshot's elements [start, start + insert).
+    splice,
+};
+
+/// One change between two snapshots, at one path into the struct.
+struct patch_op {
+    patch_kind kind = patch_kind::replace;
+    /// Wire names and element indices joined by '/', as in
+    /// "/diagnostics/3/message"; empty for the whole value.
+    std::string path;
+    /// The same path as field and element indices.
+    std::vector<std::size_t> indices;
+    std::size_t start = 0;
+    std::size_t remove = 0;
+    std::size_t insert = 0;
+};
+
+/// The changes that turn one snapshot of a T into another. The values the
+/// operations set are read from `source`, the newer snapshot, which must
+/// outlive the patch; serializing the patch writes them inline.
+template <typename T>
+struct patch {
+    const T* source = nullptr;
+    std::vector<patch_op> ops;
+
+    bool empty() const noexcept {
+        return ops.empty();
+    }
+};
+
+namespace detail {
+
+/// Structs walked field by field: a struct with its own operator== is a
+/// single value to diff, compared and replaced as a whole.
+template <typename T>
+concept diff_struct = reflectable_class<T> && !eq_comparable_with<T, T>;
+
+/// Sequences that can be spliced in place and indexed into. Strings are
+/// single values.
+template <typename T>
+concept diff_sequence = sequence_range<T> && std::ranges::random_access_range<T> &&
+                        !std::convertible_to<const T&, std::string_view> &&
+                        requires(T& range, std::ranges::range_value_t<T> element) {
+                            range.erase(range.begin(), range.end());
+                            range.insert(range.begin(), std::move(element));
+                        };
+
+/// Optionals diffed through to their value when both are engaged.
+template <typename T>
+concept diff_optional = is_optional_v<T> && (diff_struct<typename T::value_type> ||
+                                             diff_sequence<typename T::value_type>);
+
+struct diff_path {
+    std::string text;
+    std::vector<std::size_t> indices;
+
+    void push(std::size_t index, std::string_view name) {
+        text += '/';
+        text += name;
+        indices.push_back(index);
+    }
+
+    void push(std::size_t index) {
+        text += '/';
+        text += std::to_string(index);
+        indices.push_back(index);
+    }
+
+    void pop(std::size_t length) {
+        text.resize(length);
+        indices.pop_back();
+    }
+
+    patch_op op(patch_kind kind) const {
+        return patch_op{.kind = kind, .path = text, .indices = indices};
+    }
+};
+
+template <typename Config, typename T>
+void diff_value(const T& old, const T& updated, diff_path& path, std::vector<patch_op>& ops);
+
+template <typename Config, typename T>
+void diff_sequence_value(const T& old,
+                         const T& updated,
+                         diff_path& path,
+                         std::vector<patch_op>& ops) {
+    using element_t = std::ranges::range_value_t<T>;
+    const std::size_t old_size = std::ranges::size(old);
+    const std::size_t new_size = std::ranges::size(updated);
+
+    std::size_t prefix = 0;
+    while(prefix < old_size && prefix < new_size && meta::eq(old[prefix], updated[prefix])) {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while(suffix < old_size - prefix && suffix < new_size - prefix &&
+          meta::eq(old[old_size - 1 - suffix], updated[new_size - 1 - suffix])) {
+        ++suffix;
+    }
+
+    const std::size_t removed = old_size - prefix - suffix;
+    const std::size_t inserted = new_size - prefix - suffix;
+    if(removed == 0 && inserted == 0) {
+        return;
+    }
+
+    // Structs edited in place are diffed element by element, so one changed
+    // field of one element costs one field, not the element.
+    if constexpr(diff_struct<element_t>) {
+        if(removed == inserted) {
+            for(std::size_t i = prefix; i < prefix + removed; ++i) {
+                const auto length = path.text.size();
+                path.push(i);
+                diff_value<Config>(old[i], updated[i], path, ops);
+                path.pop(length);
+            }
+            return;
+        }
+    }
+
+    auto op = path.op(patch_kind::splice);
+    op.start = prefix;
+    op.remove = removed;
+    op.insert = inserted;
+    ops.push_back(std::move(op));
+}
+
+template <typename Config, typename T>
+void diff_value(const T& old, const T& updated, diff_path& path, std::vector<patch_op>& ops) {
+    if constexpr(annotated_type<T>) {
+        diff_value<Config>(annotated_value(old), annotated_value(updated), path, ops);
+    } else if constexpr(diff_struct<T>) {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (
+                [&] {
+                    if constexpr(!field_attr_flags<T, Is>::skipped) {
+                        const auto length = path.text.size();
+                        path.push(Is, resolve_wire_name<T, Is, Config>());
+                        diff_value<Config>(field_of<Is>(old), field_of<Is>(updated), path, ops);
+                        path.pop(length);
+                    }
+                }(),
+                ...);
+        }(std::make_index_sequence<field_count<T>()>{});
+    } else if constexpr(diff_optional<T>) {
+        // Both engaged: the path runs through the optional to its value.
+        if(old.has_value() && updated.has_value()) {
+            diff_value<Config>(*old, *updated, path, ops);
+        } else if(old.has_value() != updated.has_value()) {
+            ops.push_back(path.op(patch_kind::replace));
+        }
+    } else if constexpr(diff_sequence<T>) {
+        diff_sequence_value<Config>(old, updated, path, ops);
+    } else {
+        if(!meta::eq(old, updated)) {
+            ops.push_back(path.op(patch_kind::replace));
+        }
+    }
+}
+
+/// Calls `visit` with the values at `indices` inside `value` and each of
+/// `others`, values of the same type walked in step. An annotated value is
+/// visited itself rather than what it wraps, and optionals on the way are
+/// passed through to their value. Returns false when the path does not
+/// exist in all of them.
+template <typename Visit, typename T, typename... Others>
+bool visit_patch_path(std::span<const std::size_t> indices,
+                      Visit& visit,
+                      T& value,
+                      Others&... others);
+
+template <std::size_t I, typename Visit, typename T, typename... Others>
+bool visit_patch_field(std::span<const std::size_t> indices,
+                       Visit& visit,
+                       T& value,
+                       Others&... others) {
+    return visit_patch_path(indices, visit, field_of<I>(value), field_of<I>(others)...);
+}
+
+/// Calls `visit` with the values at `indices` inside `value` and each of
+/// `others`, values of the same type walked in step. An annotated value is
+/// visited itself rather than what it wraps, and optionals on the way are
+/// passed through to their value. Returns false when the path does not
+/// exist in all of them.
+template <typename Visit, typename T, typename... Others>
+bool visit_patch_path(std::span<const std::size_t> indices,
+                      Visit& visit,
+                      T& value,
+                      Others&... others) {
+    using U = std::remove_const_t<T>;
+    if(indices.empty()) {
+        visit(value, others...);
+        return true;
+    }
+
+    if constexpr(annotated_type<U>) {
+        return visit_patch_path(indices,
+                                visit,
+                                annotated_value(value),
+                                annotated_value(others)...);
+    } else if constexpr(is_optional_v<U>) {
+        return value.has_value() && (others.has_value() && ...) &&
+               visit_patch_path(indices, visit, *value, *others...);
+    } else if constexpr(diff_struct<U>) {
+        bool found = false;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((indices[0] == Is &&
+              (found = visit_patch_field<Is>(indices.subspan(1), visit, value, others...), true)) ||
+             ...);
+        }(std::make_index_sequence<field_count<U>()>{});
+        return found;
+    } else if constexpr(diff_sequence<U>) {
+        const auto index = indices[0];
+        if(index >= std::ranges::size(value) || ((index >= std::ranges::size(others)) || ...)) {
+            return false;
+        }
+        return visit_patch_path(indices.subspan(1), visit, value[index], others[index]...);
+    } else {
+        return false;
+    }
+}
+
+/// As visit_patch_path(), for one value with the path as the text of
+/// patch_op::path, field names resolved under `Config`.
+template <typename Config, typename T, typename Visit>
+bool visit_patch_text(T& value, std::string_view path, Visit& visit) {
+    using U = std::remove_const_t<T>;
+    if(path.empty()) {
+        visit(value);
+        return true;
+    }
+
+    if constexpr(annotated_type<U>) {
+        return visit_patch_text<Config>(annotated_value(value), path, visit);
+    } else if constexpr(is_optional_v<U>) {
+        return value.has_value() && visit_patch_text<Config>(*value, path, visit);
+    } else if constexpr(diff_struct<U> || diff_sequence<U>) {
+        if(path.front() != '/') {
+            return false;
+        }
+        const auto slash = path.find('/', 1);
+        const auto token = path.substr(1, slash == std::string_view::npos ? slash : slash - 1);
+        const auto rest = slash == std::string_view::npos ? std::string_view{} : path.substr(slash);
+
+        if constexpr(diff_struct<U>) {
+            bool matched = false;
+            bool found = false;
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (
+                    [&] {
+                        if constexpr(!field_attr_flags<U, Is>::skipped) {
+                            if(!matched && token == resolve_wire_name<U, Is, Config>()) {
+                                matched = true;
+                                found = visit_patch_text<Config>(field_of<Is>(value), rest, visit);
+                            }
+                        }
+                    }(),
+                    ...);
+            }(std::make_index_sequence<field_count<U>()>{});
+            return found;
+        } else {
+            std::size_t index = 0;
+            auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), index);
+            if(ec != std::errc{} || end != token.data() + token.size() ||
+               index >= std::ranges::size(value)) {
+                return false;
+            }
+            return visit_patch_text<Config>(value[index], rest, visit);
+        }
+    } else {
+        return false;
+    }
+}
+
+/// The sequence a splice applies to, through any optional or annotation
+/// around it: null when the optional is empty, nullptr_t when there is no
+/// sequence at all.
+template <typename T>
+auto splice_target(T& value) {
+    using U = std::remove_const_t<T>;
+    if constexpr(annotated_type<U>) {
+        return splice_target(annotated_value(value));
+    } else if constexpr(is_optional_v<U>) {
+        using inner_t = decltype(splice_target(*value));
+        return value.has_value() ? splice_target(*value) : inner_t{};
+    } else if constexpr(diff_sequence<U>) {
+        return &value;
+    } else {
+        return nullptr;
+    }
+}
+
+/// Replaces elements [start, start + remove) of `target` with `inserted`.
+template <typename Range, typename Inserted>
+bool splice_sequence(Range& target, std::size_t start, std::size_t remove, Inserted&& inserted) {
+    if(start > std::ranges::size(target) || remove > std::ranges::size(target) - start) {
+        return false;
+    }
+    auto first = std::ranges::begin(target) + static_cast<std::ptrdiff_t>(start);
+    first = target.erase(first, first + static_cast<std::ptrdiff_t>(remove));
+    for(auto&& element: inserted) {
+        first = std::next(target.insert(first, std::forward<decltype(element)>(element)));
+    }
+    return true;
+}
+
+}  // namespace detail
+
+/// The changes from `old` to `updated`: replaced values for changed fields,
+/// found by walking both structs field by field, and one splice for each
+/// changed sequence, covering what lies between their common prefix and
+/// suffix. Sequences of structs that keep their length are diffed element
+/// by element instead. Field names in the paths follow `Config`.
+template <typename Config = default_config, typename T>
+    requires reflectable_class<T>
+patch<T> diff(const T& old, const T& updated) {
+    patch<T> result{.source = &updated, .ops = {}};
+    detail::diff_path path;
+    detail::diff_value<Config>(old, updated, path, result.ops);
+    return result;
+}
+
+/// Applies `changes` to `value`, which must equal the older snapshot the
+/// patch was made from. Returns false, leaving earlier operations applied,
+/// if an operation's path does not exist in `value`.
+template <typename T>
+bool apply(T& value, const patch<T>& changes) {
+    for(const auto& op: changes.ops) {
+        bool applied = false;
+        auto apply_op = [&](auto& target, const auto& source) {
+            using target_t = std::remove_cvref_t<decltype(target)>;
+            if(op.kind == patch_kind::replace) {
+                if constexpr(std::is_copy_assignable_v<target_t>) {
+                    target = source;
+                    applied = true;
+                }
+                return;
+            }
+            if constexpr(!std::is_null_pointer_v<decltype(detail::splice_target(target))>) {
+                auto* into = detail::splice_target(target);
+                auto* from = detail::splice_target(source);
+                if(!into || !from || op.start > std::ranges::size(*from) ||
+                   op.insert > std::ranges::size(*from) - op.start) {
+                    return;
+                }
+                auto first = std::ranges::begin(*from) + static_cast<std::ptrdiff_t>(op.start);
+                auto last = first + static_cast<std::ptrdiff_t>(op.insert);
+                applied = detail::splice_sequence(*into,
+                                                  op.start,
+                                                  op.remove,
+                                                  std::ranges::subrange(first, last));
+            }
+        };
+        detail::visit_patch_path(std::span(op.indices), apply_op, value, *changes.source);
+        if(!applied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace kota::meta
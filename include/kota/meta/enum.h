@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #include "name.h"
 
@@ -67,6 +72,143 @@ consteval auto count_valid(const std::array<bool, N>& valid) {
     return count;
 }
 
+/// The first-level hash of enum_name_index. It takes the name eight bytes
+/// at a time, so a short name costs a multiply or two.
+constexpr std::uint64_t hash_enum_name(std::string_view name) noexcept {
+    std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ name.size();
+    std::size_t i = 0;
+    for(; i + 8 <= name.size(); i += 8) {
+        std::uint64_t word = 0;
+        if consteval {
+            for(std::size_t b = 0; b < 8; ++b) {
+                word |= std::uint64_t(static_cast<unsigned char>(name[i + b])) << (8 * b);
+            }
+        } else {
+            std::memcpy(&word, name.data() + i, 8);
+            if constexpr(std::endian::native == std::endian::big) {
+                word = std::byteswap(word);
+            }
+        }
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+    }
+    std::uint64_t tail = 0;
+    for(std::size_t b = 0; i + b < name.size(); ++b) {
+        tail |= std::uint64_t(static_cast<unsigned char>(name[i + b])) << (8 * b);
+    }
+    hash = (hash ^ tail) * 0xc4ceb9fe1a85ec53ULL;
+    return hash ^ (hash >> 29);
+}
+
+/// A minimal perfect hash from N distinct names to their positions, found
+/// at compile time by hash and displace: the names are hashed once into
+/// buckets, and each bucket, largest first, is given the displacement that
+/// moves all of its names into free slots. A lookup then hashes the key
+/// once and compares it with a single name.
+///
+/// A handful of names are compared one by one, which beats hashing the
+/// key; so is every name if no displacement fits some bucket, leaving
+/// `perfect` false.
+template <std::size_t N>
+struct enum_name_index {
+    constexpr static std::size_t bucket_count = std::bit_ceil(N / 2 + 1);
+    constexpr static std::size_t capacity = std::bit_ceil(N * 2 + 1);
+
+    std::array<std::string_view, N> names{};
+    std::array<std::uint16_t, bucket_count> displacements{};
+    /// Position + 1 of the name in each slot; 0 marks an empty one.
+    std::array<std::uint16_t, capacity> slots{};
+    bool perfect = false;
+
+    constexpr static std::size_t slot_of(std::uint64_t hash, std::uint16_t displacement) noexcept {
+        auto mixed = hash + displacement * 0x9e3779b97f4a7c15ULL;
+        mixed = (mixed ^ (mixed >> 33)) * 0xff51afd7ed558ccdULL;
+        mixed ^= mixed >> 33;
+        return static_cast<std::size_t>(mixed & (capacity - 1));
+    }
+
+    constexpr explicit enum_name_index(const std::array<std::string_view, N>& input) :
+        names(input) {
+        std::array<std::uint64_t, N> hashes{};
+        std::array<std::size_t, bucket_count> sizes{};
+        for(std::size_t i = 0; i < N; ++i) {
+            hashes[i] = hash_enum_name(names[i]);
+            ++sizes[hashes[i] & (bucket_count - 1)];
+        }
+
+        std::array<std::size_t, bucket_count> order{};
+        for(std::size_t b = 0; b < bucket_count; ++b) {
+            order[b] = b;
+        }
+        for(std::size_t i = 1; i < bucket_count; ++i) {
+            for(std::size_t j = i; j > 0 && sizes[order[j - 1]] < sizes[order[j]]; --j) {
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+
+        for(auto bucket: order) {
+            if(sizes[bucket] == 0) {
+                break;
+            }
+            if(!place(bucket, hashes)) {
+                slots = {};
+                return;
+            }
+        }
+        perfect = true;
+    }
+
+    constexpr static std::size_t scan_limit = 8;
+
+    constexpr auto find(std::string_view key) const noexcept -> std::optional<std::size_t> {
+        if(N > scan_limit && perfect) {
+            const auto hash = hash_enum_name(key);
+            const auto entry = slots[slot_of(hash, displacements[hash & (bucket_count - 1)])];
+            if(entry != 0 && names[entry - 1] == key) {
+                return entry - 1;
+            }
+            return std::nullopt;
+        }
+        for(std::size_t i = 0; i < N; ++i) {
+            if(names[i] == key) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    constexpr bool place(std::size_t bucket, const std::array<std::uint64_t, N>& hashes) {
+        std::array<std::size_t, N> members{};
+        std::size_t size = 0;
+        for(std::size_t i = 0; i < N; ++i) {
+            if((hashes[i] & (bucket_count - 1)) == bucket) {
+                members[size++] = i;
+            }
+        }
+
+        std::array<std::size_t, N> picked{};
+        for(std::uint32_t displacement = 0; displacement <= 0xffff; ++displacement) {
+            const auto d = static_cast<std::uint16_t>(displacement);
+            bool fits = true;
+            for(std::size_t m = 0; m < size && fits; ++m) {
+                picked[m] = slot_of(hashes[members[m]], d);
+                fits = slots[picked[m]] == 0;
+                for(std::size_t k = 0; k < m && fits; ++k) {
+                    fits = picked[k] != picked[m];
+                }
+            }
+            if(fits) {
+                for(std::size_t m = 0; m < size; ++m) {
+                    slots[picked[m]] = static_cast<std::uint16_t>(members[m] + 1);
+                }
+                displacements[bucket] = d;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
 }  // namespace kota::meta::detail
 
 namespace kota::meta {
@@ -115,39 +257,276 @@ struct reflection<T> {
     }();
 };
 
+/// Position of each value of E in member_values. When the values span a
+/// compact range, as most enums do, the position is read from a table
+/// indexed by the value; otherwise member_values is binary searched.
 template <enum_type E>
-constexpr std::string_view enum_name(E e, std::string_view fallback = {}) {
-    using U = std::underlying_type_t<E>;
-    const auto target = static_cast<U>(e);
-    const auto& values = reflection<E>::member_values;
-
-    std::size_t left = 0;
-    std::size_t right = values.size();
-    while(left < right) {
-        const auto mid = left + (right - left) / 2;
-        if(static_cast<U>(values[mid]) < target) {
-            left = mid + 1;
+struct enum_value_index {
+    using underlying_t = std::underlying_type_t<E>;
+    constexpr static auto& values = reflection<E>::member_values;
+
+    constexpr static auto bounds = [] {
+        std::array<std::int64_t, 2> out{};
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            const auto value = static_cast<std::int64_t>(static_cast<underlying_t>(values[i]));
+            out[0] = i == 0 ? value : std::min(out[0], value);
+            out[1] = i == 0 ? value : std::max(out[1], value);
+        }
+        return out;
+    }();
+    constexpr static std::int64_t lowest = bounds[0];
+    constexpr static std::int64_t span = values.empty() ? 0 : bounds[1] - bounds[0] + 1;
+    constexpr static bool dense =
+        span <= 64 || span <= 4 * static_cast<std::int64_t>(values.size());
+
+    /// Position + 1 of the value lowest + i; 0 where there is none.
+    constexpr inline static auto table = [] {
+        std::array<std::uint16_t, dense ? static_cast<std::size_t>(span) : 0> out{};
+        if constexpr(dense) {
+            for(std::size_t i = 0; i < values.size(); ++i) {
+                const auto value = static_cast<std::int64_t>(static_cast<underlying_t>(values[i]));
+                out[static_cast<std::size_t>(value - lowest)] = static_cast<std::uint16_t>(i + 1);
+            }
+        }
+        return out;
+    }();
+
+    constexpr static auto find(E e) noexcept -> std::optional<std::size_t> {
+        const auto target = static_cast<underlying_t>(e);
+        if constexpr(dense) {
+            const auto offset = static_cast<std::int64_t>(target) - lowest;
+            if(offset < 0 || offset >= span) {
+                return std::nullopt;
+            }
+            const auto entry = table[static_cast<std::size_t>(offset)];
+            if(entry == 0) {
+                return std::nullopt;
+            }
+            return entry - 1;
         } else {
-            right = mid;
+            std::size_t left = 0;
+            std::size_t right = values.size();
+            while(left < right) {
+                const auto mid = left + (right - left) / 2;
+                if(static_cast<underlying_t>(values[mid]) < target) {
+                    left = mid + 1;
+                } else {
+                    right = mid;
+                }
+            }
+            if(left < values.size() && static_cast<underlying_t>(values[left]) == target) {
+                return left;
+            }
+            return std::nullopt;
         }
     }
+};
+
+/// Position of `e` in reflection<E>::member_values, or nullopt if it is
+/// not an enumerator.
+template <enum_type E>
+constexpr std::optional<std::size_t> enum_index(E e) {
+    return enum_value_index<E>::find(e);
+}
 
-    if(left < values.size() && static_cast<U>(values[left]) == target) {
-        return reflection<E>::member_names[left];
+template <enum_type E>
+constexpr std::string_view enum_name(E e, std::string_view fallback = {}) {
+    if(auto index = enum_index(e)) {
+        return reflection<E>::member_names[*index];
     }
     return fallback;
 }
 
+/// Perfect hash of the names of E, built once at compile time.
+template <enum_type E>
+constexpr inline auto enum_names_index =
+    detail::enum_name_index<reflection<E>::member_count>(reflection<E>::member_names);
+
 template <enum_type E>
 constexpr std::optional<E> enum_value(std::string_view name) {
-    const auto& values = reflection<E>::member_values;
-    const auto& names = reflection<E>::member_names;
-    for(std::size_t index = 0; index < names.size(); ++index) {
-        if(names[index] == name) {
-            return values[index];
+    if(auto index = enum_names_index<E>.find(name)) {
+        return reflection<E>::member_values[*index];
+    }
+    return std::nullopt;
+}
+
+/// Opts E into flag reflection when not every enumerator is a single bit,
+/// as when it names combinations such as `All`:
+///
+///     template <>
+///     constexpr inline bool kota::meta::enable_enum_flags<Access> = true;
+template <typename E>
+constexpr inline bool enable_enum_flags = false;
+
+namespace detail {
+
+template <typename E, std::size_t Bit>
+consteval E enum_flag_probe_value() {
+    using U = std::underlying_type_t<E>;
+    constexpr auto bits = static_cast<U>(std::make_unsigned_t<U>(1) << Bit);
+#if defined(__clang__) && __clang_major__ >= 16
+    return std::bit_cast<E>(bits);
+#else
+    return static_cast<E>(bits);
+#endif
+}
+
+template <typename E, std::size_t Bit>
+consteval std::string_view enum_flag_probe_name() {
+    constexpr E value = enum_flag_probe_value<E, Bit>();
+    std::string_view name = meta::enum_name<value>();
+    return name.find(')') == std::string_view::npos ? name : std::string_view{};
+}
+
+}  // namespace detail
+
+/// The single-bit enumerators of E, lowest bit first. Every bit of the
+/// underlying type is probed, so flags above the range reflection<E> scans
+/// are found too.
+template <enum_type E>
+struct flag_reflection {
+    using underlying_t = std::underlying_type_t<E>;
+    using bits_t = std::make_unsigned_t<underlying_t>;
+
+    constexpr static std::size_t bit_width = sizeof(underlying_t) * 8;
+
+    constexpr inline static auto probed_names =
+        []<std::size_t... Bits>(std::index_sequence<Bits...>) {
+            return std::array<std::string_view, bit_width>{
+                detail::enum_flag_probe_name<E, Bits>()...};
+        }(std::make_index_sequence<bit_width>{});
+
+    constexpr inline static std::size_t member_count = [] {
+        std::size_t count = 0;
+        for(auto name: probed_names) {
+            count += name.empty() ? 0 : 1;
+        }
+        return count;
+    }();
+
+    constexpr inline static auto member_bits = [] {
+        std::array<bits_t, member_count> out{};
+        std::size_t idx = 0;
+        for(std::size_t bit = 0; bit < bit_width; ++bit) {
+            if(!probed_names[bit].empty()) {
+                out[idx++] = static_cast<bits_t>(bits_t(1) << bit);
+            }
+        }
+        return out;
+    }();
+
+    constexpr inline static auto member_names = [] {
+        std::array<std::string_view, member_count> out{};
+        std::size_t idx = 0;
+        for(auto name: probed_names) {
+            if(!name.empty()) {
+                out[idx++] = name;
+            }
+        }
+        return out;
+    }();
+
+    /// Every bit that has a name.
+    constexpr static bits_t known_bits = [] {
+        bits_t mask = 0;
+        for(auto bit: member_bits) {
+            mask |= bit;
+        }
+        return mask;
+    }();
+};
+
+namespace detail {
+
+template <typename E>
+consteval bool has_only_flag_members() {
+    using bits_t = typename flag_reflection<E>::bits_t;
+    for(auto value: reflection<E>::member_values) {
+        const auto bits = static_cast<bits_t>(value);
+        if(bits != 0 && !std::has_single_bit(bits)) {
+            return false;
         }
     }
+    return flag_reflection<E>::member_count >= 3;
+}
+
+}  // namespace detail
+
+/// True for enums whose values are sets of flags: those opted in through
+/// enable_enum_flags, and those with three or more single-bit enumerators
+/// and no others besides zero.
+template <typename E>
+concept flag_enum = enum_type<E> && (enable_enum_flags<E> || detail::has_only_flag_members<E>());
+
+/// Calls f(flag, name) for each named flag set in `value`, lowest bit
+/// first, and returns the bits of `value` that have no name.
+template <flag_enum E, typename F>
+constexpr E for_each_enum_flag(E value, F&& f) {
+    using reflect = flag_reflection<E>;
+    using bits_t = typename reflect::bits_t;
+    const auto bits = static_cast<bits_t>(value);
+    for(std::size_t i = 0; i < reflect::member_count; ++i) {
+        if(bits & reflect::member_bits[i]) {
+            f(static_cast<E>(reflect::member_bits[i]), reflect::member_names[i]);
+        }
+    }
+    return static_cast<E>(static_cast<bits_t>(bits & ~reflect::known_bits));
+}
+
+/// The flags set in `value` as their names joined by `separator`: "Read|Write".
+/// Empty when no flag is set or when `value` has bits with no name.
+template <flag_enum E>
+constexpr std::string enum_flags_name(E value, std::string_view separator = "|") {
+    std::string out;
+    auto unnamed = for_each_enum_flag(value, [&](E, std::string_view name) {
+        if(!out.empty()) {
+            out += separator;
+        }
+        out += name;
+    });
+    if(unnamed != E{}) {
+        out.clear();
+    }
+    return out;
+}
+
+/// Perfect hash of the flag names of E.
+template <flag_enum E>
+constexpr inline auto enum_flag_names_index =
+    detail::enum_name_index<flag_reflection<E>::member_count>(flag_reflection<E>::member_names);
+
+/// The single flag called `name`.
+template <flag_enum E>
+constexpr std::optional<E> enum_flag_value(std::string_view name) {
+    if(auto index = enum_flag_names_index<E>.find(name)) {
+        return static_cast<E>(flag_reflection<E>::member_bits[*index]);
+    }
     return std::nullopt;
 }
 
+/// The flags named in `text`, separated by `separator`, as enum_flags_name()
+/// writes them. Empty text is no flags; any unknown name is nullopt.
+template <flag_enum E>
+constexpr std::optional<E> enum_flags_value(std::string_view text,
+                                            std::string_view separator = "|") {
+    using bits_t = typename flag_reflection<E>::bits_t;
+    bits_t bits = 0;
+    if(text.empty()) {
+        return static_cast<E>(bits);
+    }
+    while(true) {
+        const auto end = separator.empty() ? std::string_view::npos : text.find(separator);
+        auto flag = enum_flag_value<E>(text.substr(0, end));
+        if(!flag) {
+            return std::nullopt;
+        }
+        bits |= static_cast<bits_t>(*flag);
+        if(end == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(end + separator.size());
+    }
+    return static_cast<E>(bits);
+}
+
 }  // namespace kota::meta
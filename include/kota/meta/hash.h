@@ -0,0 +1,171 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+#include "annotation.h"
+#include "struct.h"
+#include "type_kind.h"
+#include "kota/support/ranges.h"
+#include "kota/support/type_traits.h"
+
+namespace kota::meta::detail {
+
+/// The 64-bit finalizer of MurmurHash3: every input bit affects every
+/// output bit, at the cost of two multiplies.
+constexpr std::uint64_t hash_mix(std::uint64_t value) noexcept {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+/// Folds `value` into `seed`; the order of the values matters.
+constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) noexcept {
+    return hash_mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/// Hashes `size` bytes a word at a time, mixing once at the end.
+inline std::uint64_t hash_bytes(const void* data, std::size_t size) noexcept {
+    constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t state = size * multiplier;
+    for(; size >= 8; bytes += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        state = (std::rotl(state, 29) ^ word) * multiplier;
+    }
+    if(size > 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes, size);
+        state = (std::rotl(state, 29) ^ word) * multiplier;
+    }
+    return hash_mix(state);
+}
+
+/// Set for types whose objects are equal exactly when their bytes are,
+/// so they can be hashed as one block of memory.
+template <typename T>
+constexpr inline bool bytewise_hashable =
+    std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>;
+
+template <typename T>
+std::uint64_t hash_value(const T& value);
+
+template <typename R>
+std::uint64_t hash_range(const R& range) {
+    using element_t = std::ranges::range_value_t<const R>;
+
+    if constexpr(std::ranges::contiguous_range<const R> && std::ranges::sized_range<const R> &&
+                 bytewise_hashable<element_t>) {
+        return hash_bytes(std::ranges::data(range), std::ranges::size(range) * sizeof(element_t));
+    } else {
+        std::uint64_t seed = 0;
+        std::size_t count = 0;
+        for(const auto& element: range) {
+            if constexpr(unordered_associative_range<R>) {
+                // Unordered containers iterate in no particular order.
+                seed += hash_value(element);
+            } else {
+                seed = hash_combine(seed, hash_value(element));
+            }
+            ++count;
+        }
+        return hash_combine(seed, count);
+    }
+}
+
+/// A hash of `value` that follows meta::eq: values it calls equal hash the
+/// same. Structs are hashed field by field through reflection, or as raw
+/// bytes when they have no padding; ranges by their elements, in any order
+/// for unordered containers. A struct whose operator== compares less than
+/// all its fields needs a std::hash specialization that agrees with it.
+template <typename T>
+std::uint64_t hash_value(const T& value) {
+    using U = std::remove_cvref_t<T>;
+
+    if constexpr(annotated_type<U>) {
+        return hash_value(annotated_value(value));
+    } else if constexpr(std::is_enum_v<U>) {
+        return hash_mix(static_cast<std::uint64_t>(value));
+    } else if constexpr(std::is_integral_v<U>) {
+        return hash_mix(static_cast<std::uint64_t>(value));
+    } else if constexpr(std::is_floating_point_v<U>) {
+        // std::hash maps 0.0 and -0.0, which compare equal, to one value.
+        return hash_mix(std::hash<U>{}(value));
+    } else if constexpr(std::convertible_to<const U&, std::string_view>) {
+        const auto text = std::string_view(value);
+        return hash_bytes(text.data(), text.size());
+    } else if constexpr(is_optional_v<U>) {
+        return value.has_value() ? hash_combine(1, hash_value(*value)) : 0;
+    } else if constexpr(is_specialization_of<std::variant, U>) {
+        return std::visit(
+            [&](const auto& alternative) {
+                return hash_combine(value.index(), hash_value(alternative));
+            },
+            value);
+    } else if constexpr(std::ranges::input_range<U>) {
+        return hash_range(value);
+    } else if constexpr(bytewise_hashable<U> && !requires { std::hash<U>{}(value); }) {
+        return hash_bytes(std::addressof(value), sizeof(U));
+    } else if constexpr(tuple_like<U>) {
+        return std::apply(
+            [](const auto&... elements) {
+                std::uint64_t seed = 0;
+                ((seed = hash_combine(seed, hash_value(elements))), ...);
+                return seed;
+            },
+            value);
+    } else if constexpr(reflectable_class<U> && !requires { std::hash<U>{}(value); }) {
+        std::uint64_t seed = field_count<U>();
+        auto addrs = reflection<U>::field_addrs(value);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((seed = hash_combine(seed, hash_value(*std::get<Is>(addrs)))), ...);
+        }(std::make_index_sequence<field_count<U>()>{});
+        return seed;
+    } else {
+        static_assert(requires { std::hash<U>{}(value); },
+                      "meta::hash: type is not reflectable and has no std::hash");
+        return hash_mix(std::hash<U>{}(value));
+    }
+}
+
+}  // namespace kota::meta::detail
+
+namespace kota::meta {
+
+/// A hasher that agrees with meta::eq, for keying unordered containers by
+/// reflectable structs:
+///
+///     std::unordered_map<Request, Result, meta::hash<Request>, meta::eq_t> memo;
+template <typename T = void>
+struct hash {
+    std::size_t operator()(const T& value) const {
+        return static_cast<std::size_t>(detail::hash_value(value));
+    }
+};
+
+template <>
+struct hash<void> {
+    using is_transparent = void;
+
+    template <typename T>
+    std::size_t operator()(const T& value) const {
+        return static_cast<std::size_t>(detail::hash_value(value));
+    }
+};
+
+}  // namespace kota::meta
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "compare.h"
+#include "hash.h"
+#include "struct.h"
+#include "type_info.h"
+#include "type_kind.h"
+
+namespace kota::meta {
+
+/// Type-erased operations on one field type, shared by every struct with a
+/// field of that type.
+struct value_ops {
+    bool (*equal)(const void* lhs, const void* rhs);
+    std::uint64_t (*hash)(const void* value);
+    void (*copy)(void* target, const void* source);
+};
+
+struct struct_layout;
+
+/// One field of a struct_layout. A field that is a reflectable struct is
+/// walked through `nested`; any other is handled by `ops`, or as raw bytes
+/// when the flags allow it.
+struct field_slot {
+    std::size_t offset;
+    std::size_t size;
+    type_kind kind;
+    /// Equal exactly when its bytes are: no padding, floats or pointers to
+    /// owned data.
+    bool bitwise_comparable;
+    bool trivially_copyable;
+    /// The wire name under the layout's Config; empty for skipped fields.
+    std::string_view name;
+    const type_info* type;
+    const struct_layout* nested;
+    const value_ops* ops;
+};
+
+/// Every physical field of a reflectable struct as a flat array, so one
+/// loop over it can copy, compare or hash any struct. The loops below are
+/// plain functions: a visitor built on them is compiled once, not once per
+/// struct, and only the leaf operations are instantiated per field type.
+struct struct_layout {
+    std::string_view type_name;
+    std::size_t size;
+    /// Set when the whole struct can be compared with one memcmp.
+    bool bitwise_comparable;
+    /// Set when the whole struct can be copied with one memcpy.
+    bool trivially_copyable;
+    std::span<const field_slot> fields;
+};
+
+template <typename T, typename Config = default_config>
+    requires reflectable_class<T>
+constexpr const struct_layout& layout_of();
+
+namespace detail {
+
+template <typename F>
+struct field_value_ops {
+    using raw_t = typename unwrap_annotated<F>::raw_type;
+
+    static const raw_t& raw(const void* value) {
+        return static_cast<const raw_t&>(*static_cast<const F*>(value));
+    }
+
+    /// Hashes through std::hash where there is one; a field without one
+    /// adds nothing, which keeps the hash consistent with equality.
+    static std::uint64_t hash(const void* value) {
+        if constexpr(requires(const raw_t& v) { std::hash<raw_t>{}(v); }) {
+            return std::hash<raw_t>{}(raw(value));
+        } else {
+            return 0;
+        }
+    }
+
+    constexpr inline static value_ops value = {
+        [](const void* lhs, const void* rhs) { return meta::eq(raw(lhs), raw(rhs)); },
+        &hash,
+        [](void* target, const void* source) {
+            *static_cast<F*>(target) = *static_cast<const F*>(source);
+        },
+    };
+};
+
+template <typename T, typename Config, std::size_t I>
+constexpr field_slot make_field_slot() {
+    using field_t = std::remove_cv_t<meta::field_type<T, I>>;
+    using raw_t = typename unwrap_annotated<field_t>::raw_type;
+    using attrs_t = typename unwrap_annotated<field_t>::attrs;
+
+    constexpr bool bitwise = std::has_unique_object_representations_v<field_t>;
+    constexpr bool nested = reflectable_class<raw_t> && !bitwise;
+
+    field_slot slot{
+        .offset = meta::field_offset<T>(I),
+        .size = sizeof(field_t),
+        .kind = kind_of<raw_t>(),
+        .bitwise_comparable = bitwise,
+        .trivially_copyable = std::is_trivially_copyable_v<field_t>,
+        .name = {},
+        .type = &type_instance<field_t, Config>::value,
+        .nested = nullptr,
+        .ops = nullptr,
+    };
+    if constexpr(!tuple_has_v<attrs_t, attrs::skip>) {
+        slot.name = resolve_wire_name<T, I, Config>();
+    }
+    if constexpr(nested) {
+        slot.nested = &layout_of<raw_t, Config>();
+    } else {
+        slot.ops = &field_value_ops<field_t>::value;
+    }
+    return slot;
+}
+
+template <typename T, typename Config>
+struct layout_node {
+    constexpr inline static auto fields =
+        []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<field_slot, sizeof...(Is)>{make_field_slot<T, Config, Is>()...};
+        }(std::make_index_sequence<field_count<T>()>{});
+
+    constexpr inline static struct_layout value = {
+        .type_name = meta::type_name<T>(),
+        .size = sizeof(T),
+        .bitwise_comparable = std::has_unique_object_representations_v<T>,
+        .trivially_copyable = std::is_trivially_copyable_v<T>,
+        .fields = {fields.data(), fields.size()},
+    };
+};
+
+}  // namespace detail
+
+template <typename T, typename Config>
+    requires reflectable_class<T>
+constexpr const struct_layout& layout_of() {
+    return detail::layout_node<T, Config>::value;
+}
+
+/// Field-by-field equality of two objects of the struct `layout` describes.
+inline bool layout_equal(const struct_layout& layout, const void* lhs, const void* rhs) {
+    if(layout.bitwise_comparable) {
+        return std::memcmp(lhs, rhs, layout.size) == 0;
+    }
+    const auto* left = static_cast<const std::byte*>(lhs);
+    const auto* right = static_cast<const std::byte*>(rhs);
+    for(const auto& field: layout.fields) {
+        const auto* a = left + field.offset;
+        const auto* b = right + field.offset;
+        bool same = field.bitwise_comparable ? std::memcmp(a, b, field.size) == 0
+                    : field.nested           ? layout_equal(*field.nested, a, b)
+                                             : field.ops->equal(a, b);
+        if(!same) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// A hash of an object of the struct `layout` describes, equal for objects
+/// layout_equal() calls equal.
+inline std::uint64_t layout_hash(const struct_layout& layout, const void* value) {
+    if(layout.bitwise_comparable) {
+        return detail::hash_bytes(value, layout.size);
+    }
+    const auto* bytes = static_cast<const std::byte*>(value);
+    std::uint64_t seed = layout.fields.size();
+    for(const auto& field: layout.fields) {
+        const auto* at = bytes + field.offset;
+        seed = detail::hash_combine(seed,
+                                    field.bitwise_comparable ? detail::hash_bytes(at, field.size)
+                                    : field.nested           ? layout_hash(*field.nested, at)
+                                                             : field.ops->hash(at));
+    }
+    return seed;
+}
+
+/// Assigns every field of `source` to the same field of `target`.
+inline void layout_copy(const struct_layout& layout, void* target, const void* source) {
+    if(layout.trivially_copyable) {
+        std::memmove(target, source, layout.size);
+        return;
+    }
+    auto* to = static_cast<std::byte*>(target);
+    const auto* from = static_cast<const std::byte*>(source);
+    for(const auto& field: layout.fields) {
+        if(field.trivially_copyable) {
+            std::memmove(to + field.offset, from + field.offset, field.size);
+        } else if(field.nested) {
+            layout_copy(*field.nested, to + field.offset, from + field.offset);
+        } else {
+            field.ops->copy(to + field.offset, from + field.offset);
+        }
+    }
+}
+
+}  // namespace kota::meta
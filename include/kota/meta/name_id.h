@@ -0,0 +1,16 @@
+#pragma once
+
+#include "kota/meta/name.h"
+#include "kota/support/name_table.h"
+
+namespace kota::meta {
+
+/// The global name_table id of type_name<T>(Qualified), interned the first
+/// time it is asked for.
+template <typename T, bool Qualified = false>
+name_id type_name_id() {
+    static const name_id id = name_table::global().intern(type_name<T>(Qualified));
+    return id;
+}
+
+}  // namespace kota::meta
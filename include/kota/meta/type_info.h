@@ -11,6 +11,7 @@
 #include <tuple>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 #include "annotation.h"
 #include "enum.h"
@@ -225,6 +226,10 @@ constexpr auto resolve_wire_type_impl() {
         return std::type_identity<typename tuple_find_spec_t<AttrsTuple, behavior::as>::target>{};
     } else if constexpr(tuple_has_spec_v<AttrsTuple, behavior::enum_string>) {
         return std::type_identity<std::string_view>{};
+    } else if constexpr(tuple_has_spec_v<AttrsTuple, behavior::enum_flags>) {
+        return std::type_identity<std::vector<std::string_view>>{};
+    } else if constexpr(tuple_has_spec_v<AttrsTuple, behavior::intern>) {
+        return std::type_identity<std::string_view>{};
     } else if constexpr(has_with_wire_type_v<AttrsTuple>) {
         return std::type_identity<typename extract_with_wire_type<AttrsTuple>::type>{};
     } else {
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace kota::option {
+
+/// ArgvView - Non-owning view of a command line.
+///
+/// Tokens are either `std::string`s owned by the caller or borrowed
+/// `std::string_view`s, e.g. over `main`'s argv, so a command line can be
+/// parsed without copying it. Only mutable strings can be rewritten in
+/// place, which grouped short options need to turn `-abc` into `-bc`.
+class ArgvView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        constexpr iterator() = default;
+
+        constexpr iterator(const ArgvView* view, std::size_t index) : view(view), index(index) {}
+
+        constexpr std::string_view operator*() const {
+            return (*this->view)[this->index];
+        }
+
+        constexpr iterator& operator++() {
+            ++this->index;
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto prev = *this;
+            ++this->index;
+            return prev;
+        }
+
+        constexpr iterator operator+(std::size_t offset) const {
+            return iterator(this->view, this->index + offset);
+        }
+
+        constexpr difference_type operator-(const iterator& other) const {
+            return static_cast<difference_type>(this->index) -
+                   static_cast<difference_type>(other.index);
+        }
+
+        constexpr bool operator==(const iterator& other) const {
+            return this->index == other.index;
+        }
+
+    private:
+        const ArgvView* view = nullptr;
+        std::size_t index = 0;
+    };
+
+    constexpr ArgvView() = default;
+
+    constexpr ArgvView(std::span<std::string> argv) :
+        strings(argv.data()), count(argv.size()), writable(true) {}
+
+    constexpr ArgvView(std::span<const std::string> argv) :
+        strings(argv.data()), count(argv.size()) {}
+
+    constexpr ArgvView(std::span<const std::string_view> argv) :
+        views(argv.data()), count(argv.size()) {}
+
+    /// Views a contiguous range of `std::string` or `std::string_view`, such
+    /// as a `std::vector` of either.
+    template <typename Range>
+        requires (!std::same_as<std::remove_cvref_t<Range>, ArgvView> &&
+                  std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range> &&
+                  (std::same_as<std::ranges::range_value_t<Range>, std::string> ||
+                   std::same_as<std::ranges::range_value_t<Range>, std::string_view>))
+    constexpr ArgvView(Range&& range) : count(std::ranges::size(range)) {
+        auto* data = std::ranges::data(range);
+        if constexpr(std::same_as<std::ranges::range_value_t<Range>, std::string_view>) {
+            this->views = data;
+        } else {
+            this->strings = data;
+            this->writable = !std::is_const_v<std::remove_pointer_t<decltype(data)>>;
+        }
+    }
+
+    template <std::contiguous_iterator It>
+        requires (std::same_as<std::iter_value_t<It>, std::string> ||
+                  std::same_as<std::iter_value_t<It>, std::string_view>)
+    constexpr ArgvView(It first, It last) : ArgvView(std::span(first, last)) {}
+
+    constexpr std::size_t size() const {
+        return this->count;
+    }
+
+    constexpr bool empty() const {
+        return this->count == 0;
+    }
+
+    constexpr std::string_view operator[](std::size_t index) const {
+        assert(index < this->count && "Argv index out of range.");
+        return this->strings != nullptr ? std::string_view(this->strings[index])
+                                        : this->views[index];
+    }
+
+    constexpr std::string_view front() const {
+        return (*this)[0];
+    }
+
+    constexpr std::string_view back() const {
+        return (*this)[this->count - 1];
+    }
+
+    constexpr iterator begin() const {
+        return iterator(this, 0);
+    }
+
+    constexpr iterator end() const {
+        return iterator(this, this->count);
+    }
+
+    constexpr ArgvView subspan(std::size_t offset,
+                               std::size_t length = std::dynamic_extent) const {
+        assert(offset <= this->count && "Argv offset out of range.");
+        const std::size_t rest = this->count - offset;
+        length = length == std::dynamic_extent || length > rest ? rest : length;
+        ArgvView view = *this;
+        if(this->strings != nullptr) {
+            view.strings += offset;
+        } else if(this->views != nullptr) {
+            view.views += offset;
+        }
+        view.count = length;
+        return view;
+    }
+
+    /// Whether the tokens are mutable strings that parsing may rewrite.
+    constexpr bool is_writable() const {
+        return this->writable || this->count == 0;
+    }
+
+    /// The mutable tokens; only valid when is_writable().
+    constexpr std::span<std::string> writable_tokens() const {
+        assert(this->is_writable() && "Argv tokens are not mutable strings.");
+        return std::span<std::string>(const_cast<std::string*>(this->strings), this->count);
+    }
+
+private:
+    const std::string* strings = nullptr;
+    const std::string_view* views = nullptr;
+    std::size_t count = 0;
+    bool writable = false;
+};
+
+}  // namespace kota::option
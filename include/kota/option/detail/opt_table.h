@@ -1,11 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <format>
 #include <functional>
-#include <set>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
@@ -13,13 +16,16 @@
 #include <utility>
 #include <vector>
 
+#include "argv_view.h"
 #include "opt_specifier.h"
 #include "parsed_arg.h"
 #include "util.h"
+#include "kota/support/small_vector.h"
 
 namespace kota::option {
 
 class Option;
+class ParseCache;
 
 /// Helper for overload resolution while transitioning from
 /// FlagsToInclude/FlagsToExclude APIs to VisibilityMask APIs.
@@ -81,15 +87,15 @@ public:
 
         // std::vector<unsigned> SubCommandIndexes;
 
-        bool has_no_prefix() const {
+        constexpr bool has_no_prefix() const {
             return this->_prefixes.size() == 0;
         }
 
-        unsigned num_prefixes() const {
+        constexpr unsigned num_prefixes() const {
             return static_cast<unsigned>(this->_prefixes.size());
         }
 
-        std::span<const std::string_view> prefixes() const {
+        constexpr std::span<const std::string_view> prefixes() const {
             return this->_prefixes;
         }
 
@@ -101,11 +107,11 @@ public:
         //   return std::span(this->SubCommandIndexes);
         // }
 
-        std::string_view prefixed_name() const {
+        constexpr std::string_view prefixed_name() const {
             return this->_prefixed_name;
         }
 
-        std::string_view name() const {
+        constexpr std::string_view name() const {
             unsigned prefix_length =
                 this->has_no_prefix() ? 0 : static_cast<unsigned>(this->_prefixes[0].size());
             return this->_prefixed_name.substr(prefix_length);
@@ -205,6 +211,84 @@ private:
 
     bool tablegen_mode = false;
 
+public:
+    /// Node of the spelling trie over the ASCII-lowercased spelling (prefix
+    /// then name) of every option. One walk of an argument through it finds
+    /// every option that may prefix the argument, in place of running
+    /// match_opt() on each table entry.
+    struct IndexNode {
+        /// Children, sorted by byte, in `edges`.
+        std::uint32_t first_edge = 0;
+        std::uint32_t edge_count = 0;
+
+        /// Indices into option_infos of options spelled by the path to this
+        /// node, in `options`.
+        std::uint32_t first_option = 0;
+        std::uint32_t option_count = 0;
+    };
+
+    struct IndexEdge {
+        unsigned char byte = 0;
+        std::uint32_t child = 0;
+    };
+
+    /// Everything build() derives from the option infos. derive_index() is
+    /// constexpr, so the same derivation backs runtime builds and a
+    /// StaticIndex generated at compile time.
+    struct DerivedIndex {
+        unsigned first_searchable_index = 0;
+        unsigned input_option_id = 0;
+        unsigned unknown_option_id = 0;
+        std::vector<std::string_view> prefixes_union;
+        std::vector<char> prefix_chars;
+        std::vector<IndexNode> nodes;
+        std::vector<IndexEdge> edges;
+        std::vector<std::uint32_t> options;
+        std::array<bool, 256> prefix_start = {};
+    };
+
+    /// Non-owning view of a derived index, as adopted by build(IndexView).
+    struct IndexView {
+        unsigned first_searchable_index = 0;
+        unsigned input_option_id = 0;
+        unsigned unknown_option_id = 0;
+        std::span<const std::string_view> prefixes_union;
+        std::span<const char> prefix_chars;
+        std::span<const IndexNode> nodes;
+        std::span<const IndexEdge> edges;
+        std::span<const std::uint32_t> options;
+        const bool* prefix_start = nullptr;
+    };
+
+    /// Element counts of a derived index, which size a StaticIndex.
+    struct IndexSizes {
+        std::size_t prefixes_union = 0;
+        std::size_t prefix_chars = 0;
+        std::size_t nodes = 0;
+        std::size_t edges = 0;
+        std::size_t options = 0;
+    };
+
+    /// Derive the index of `option_infos`. An empty `prefixes_union` is
+    /// computed from the infos; `input_random_index` must match the flag the
+    /// table parses with.
+    constexpr static DerivedIndex
+        derive_index(std::span<const Info> option_infos,
+                     bool input_random_index,
+                     std::span<const std::string_view> prefixes_union = {});
+
+    constexpr static IndexSizes index_sizes(std::span<const Info> option_infos,
+                                            bool input_random_index) {
+        const auto index = derive_index(option_infos, input_random_index);
+        return IndexSizes{
+            .prefixes_union = index.prefixes_union.size(),
+            .prefix_chars = index.prefix_chars.size(),
+            .nodes = index.nodes.size(),
+            .edges = index.edges.size(),
+            .options = index.options.size(),
+        };
+    }
+
 protected:
     /// The index of the first option which can be parsed (i.e., is not a
     /// special option like 'input' or 'unknown', and is not an option group).
@@ -212,12 +296,46 @@ protected:
 
     /// The union of all option prefixes. If an argument does not begin with
     /// one of these, it is an input.
-    std::vector<std::string_view> _prefixes_union;
+    std::span<const std::string_view> _prefixes_union;
 
-    /// The union of the first element of all option prefixes.
-    std::vector<char> prefix_chars;
+    /// The union of the characters of all option prefixes.
+    std::span<const char> prefix_chars;
 
 private:
+    /// The spelling trie, built by build().
+    struct SpellingIndex {
+        std::span<const IndexNode> nodes;
+        std::span<const IndexEdge> edges;
+        std::span<const std::uint32_t> options;
+
+        /// First bytes of the prefixes union, 256 entries; an argument
+        /// starting with any other byte is an input.
+        const bool* prefix_start = nullptr;
+    };
+
+    SpellingIndex spelling_index;
+
+    /// Backs the views above when they were derived at runtime, or holds the
+    /// prefixes passed to the constructor. Shared so copies of a built table
+    /// stay valid.
+    std::shared_ptr<const void> index_storage;
+
+    using Candidates = small_vector<const Info*, 8>;
+
+    /// Options from `first` on that may prefix `str`, in table order. Each
+    /// still has to be confirmed with match_opt(): the index folds case so
+    /// it serves both case modes.
+    Candidates candidates(std::string_view str, const Info* first) const;
+
+    bool is_input(std::string_view arg) const;
+
+    constexpr static unsigned char fold_ascii(char c) {
+        auto byte = static_cast<unsigned char>(c);
+        return byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>(byte + ('a' - 'A')) : byte;
+    }
+
+    friend class ParseCache;
+
     const Info& info(OptSpecifier opt) const {
         unsigned id = opt.id();
         assert(id > 0 && id - 1 < this->num_options() && "Invalid Option ID.");
@@ -233,17 +351,10 @@ public:
 
     OptTable& build();
 
-    /// Build (or rebuild) the PrefixChars member.
-    void buildPrefixChars() {
-        assert(this->prefix_chars.empty() && "rebuilding a non-empty prefix char");
-        std::set<char> seen_chars;
-
-        // Build prefix chars.
-        for(auto& prefix: this->_prefixes_union) {
-            seen_chars.insert(prefix.begin(), prefix.end());
-        }
-        this->prefix_chars.assign(seen_chars.begin(), seen_chars.end());
-    }
+    /// Adopt an index derived ahead of time, typically StaticIndex::view(),
+    /// instead of deriving it. It must have been derived from this table's
+    /// infos and must outlive the table.
+    OptTable& build(const IndexView& index);
 
 public:
     virtual ~OptTable() = default;
@@ -320,6 +431,7 @@ public:
     }
 
     /// Support grouped short options. e.g. -ab represents -a -b.
+    /// Parsing rewrites grouped tokens in place, so argv must own its tokens.
     auto set_grouped_short_options(bool value) {
         this->grouped_short_options = value;
         return *this;
@@ -361,7 +473,7 @@ public:
         return std::span(this->_prefixes_union);
     }
 
-    using InputArgv = std::span<std::string>;
+    using InputArgv = ArgvView;
 
 public:
     std::expected<PArg, const char*> parse_one_arg_grouped(InputArgv argv, unsigned& index) const;
@@ -379,6 +491,16 @@ public:
                                unsigned& index,
                                std::function<bool(const Option&)> exclude_option) const;
 
+    /// Parses every command line in `commands` as parse_args() would and
+    /// appends the results to `out`, one ParsedBatch::Command per line.
+    /// Results view the strings in `commands`, which must outlive them.
+    ///
+    /// Parsing never modifies the table, so one built table can be shared by
+    /// threads that each parse into their own batch.
+    void parse_batch(std::span<const InputArgv> commands,
+                     ParsedBatch& out,
+                     Visibility visibility_mask = Visibility()) const;
+
 private:
     bool exclude_for_visibility(const Option& opt, Visibility visibility_mask) const;
     bool exclude_for_flags(const Option& opt,
@@ -564,4 +686,163 @@ public:
     }
 };
 
+constexpr OptTable::DerivedIndex
+    OptTable::derive_index(std::span<const Info> option_infos,
+                           bool input_random_index,
+                           std::span<const std::string_view> prefixes_union) {
+    DerivedIndex index;
+
+    // Find start of normal options.
+    bool found_searchable = false;
+    for(unsigned i = 0, e = static_cast<unsigned>(option_infos.size()); i != e; ++i) {
+        const auto& info = option_infos[i];
+        if(info.kind == OptionEnum::InputClass) {
+            assert(!index.input_option_id && "Cannot have multiple input options!");
+            index.input_option_id = info.id;
+        } else if(info.kind == OptionEnum::UnknownClass) {
+            assert(!index.unknown_option_id && "Cannot have multiple unknown options!");
+            index.unknown_option_id = info.id;
+        } else if(info.kind != OptionEnum::GroupClass && !found_searchable) {
+            index.first_searchable_index = i;
+            found_searchable = true;
+        }
+    }
+    if(input_random_index) {
+        index.first_searchable_index = 0;
+    }
+
+    if(prefixes_union.empty()) {
+        for(const auto& info: option_infos.subspan(index.first_searchable_index)) {
+            if((info.kind == OptionEnum::InputClass || info.kind == OptionEnum::UnknownClass) &&
+               input_random_index) {
+                continue;
+            }
+            for(auto prefix: info.prefixes()) {
+                index.prefixes_union.push_back(prefix);
+            }
+        }
+        std::ranges::sort(index.prefixes_union);
+        auto duplicates = std::ranges::unique(index.prefixes_union);
+        index.prefixes_union.erase(duplicates.begin(), duplicates.end());
+    } else {
+        index.prefixes_union.assign(prefixes_union.begin(), prefixes_union.end());
+    }
+
+    for(auto prefix: index.prefixes_union) {
+        index.prefix_chars.insert(index.prefix_chars.end(), prefix.begin(), prefix.end());
+    }
+    std::ranges::sort(index.prefix_chars);
+    auto duplicates = std::ranges::unique(index.prefix_chars);
+    index.prefix_chars.erase(duplicates.begin(), duplicates.end());
+
+    // Build with per-node sorted child lists, then flatten into the node and
+    // edge arrays that lookups walk.
+    struct BuildNode {
+        std::vector<IndexEdge> children;
+        std::vector<std::uint32_t> options;
+    };
+    std::vector<BuildNode> trie(1);
+
+    for(std::uint32_t option = 0; option < option_infos.size(); ++option) {
+        const auto& info = option_infos[option];
+        for(auto prefix: info.prefixes()) {
+            std::uint32_t node = 0;
+            auto insert = [&](std::string_view text) {
+                for(char c: text) {
+                    auto byte = fold_ascii(c);
+                    auto& children = trie[node].children;
+                    auto edge = std::ranges::lower_bound(children, byte, {}, &IndexEdge::byte);
+                    if(edge != children.end() && edge->byte == byte) {
+                        node = edge->child;
+                        continue;
+                    }
+                    auto child = static_cast<std::uint32_t>(trie.size());
+                    children.insert(edge, IndexEdge{.byte = byte, .child = child});
+                    trie.emplace_back();
+                    node = child;
+                }
+            };
+            insert(prefix);
+            insert(info.name());
+            trie[node].options.push_back(option);
+        }
+    }
+
+    index.nodes.resize(trie.size());
+    for(std::size_t node = 0; node < trie.size(); ++node) {
+        auto& flat = index.nodes[node];
+        flat.first_edge = static_cast<std::uint32_t>(index.edges.size());
+        flat.edge_count = static_cast<std::uint32_t>(trie[node].children.size());
+        index.edges.insert(index.edges.end(),
+                           trie[node].children.begin(),
+                           trie[node].children.end());
+        flat.first_option = static_cast<std::uint32_t>(index.options.size());
+        flat.option_count = static_cast<std::uint32_t>(trie[node].options.size());
+        index.options.insert(index.options.end(),
+                             trie[node].options.begin(),
+                             trie[node].options.end());
+    }
+
+    for(auto prefix: index.prefixes_union) {
+        if(prefix.empty()) {
+            index.prefix_start.fill(true);
+            break;
+        }
+        index.prefix_start[static_cast<unsigned char>(prefix[0])] = true;
+    }
+    return index;
+}
+
+/// StaticIndex - The index of an option table whose infos are constant,
+/// derived at compile time so the table skips build()'s runtime work:
+///
+///   constexpr auto sizes = OptTable::index_sizes(infos, false);
+///   constexpr StaticIndex<sizes> index(infos, false);
+///   auto table = OptTable(infos, false, {}, false).build(index.view());
+template <OptTable::IndexSizes sizes>
+class StaticIndex {
+public:
+    constexpr StaticIndex(std::span<const OptTable::Info> option_infos, bool input_random_index) {
+        const auto index = OptTable::derive_index(option_infos, input_random_index);
+        assert(index.prefixes_union.size() == sizes.prefixes_union &&
+               index.prefix_chars.size() == sizes.prefix_chars &&
+               index.nodes.size() == sizes.nodes && index.edges.size() == sizes.edges &&
+               index.options.size() == sizes.options && "StaticIndex sizes do not match infos.");
+        this->first_searchable_index = index.first_searchable_index;
+        this->input_option_id = index.input_option_id;
+        this->unknown_option_id = index.unknown_option_id;
+        std::ranges::copy(index.prefixes_union, this->prefixes_union.begin());
+        std::ranges::copy(index.prefix_chars, this->prefix_chars.begin());
+        std::ranges::copy(index.nodes, this->nodes.begin());
+        std::ranges::copy(index.edges, this->edges.begin());
+        std::ranges::copy(index.options, this->options.begin());
+        this->prefix_start = index.prefix_start;
+    }
+
+    constexpr OptTable::IndexView view() const {
+        return OptTable::IndexView{
+            .first_searchable_index = this->first_searchable_index,
+            .input_option_id = this->input_option_id,
+            .unknown_option_id = this->unknown_option_id,
+            .prefixes_union = this->prefixes_union,
+            .prefix_chars = this->prefix_chars,
+            .nodes = this->nodes,
+            .edges = this->edges,
+            .options = this->options,
+            .prefix_start = this->prefix_start.data(),
+        };
+    }
+
+private:
+    unsigned first_searchable_index = 0;
+    unsigned input_option_id = 0;
+    unsigned unknown_option_id = 0;
+    std::array<std::string_view, sizes.prefixes_union> prefixes_union = {};
+    std::array<char, sizes.prefix_chars> prefix_chars = {};
+    std::array<OptTable::IndexNode, sizes.nodes> nodes = {};
+    std::array<OptTable::IndexEdge, sizes.edges> edges = {};
+    std::array<std::uint32_t, sizes.options> options = {};
+    std::array<bool, 256> prefix_start = {};
+};
+
 }  // namespace kota::option
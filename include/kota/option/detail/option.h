@@ -3,6 +3,7 @@
 #include <expected>
 #include <string_view>
 
+#include "argv_view.h"
 #include "opt_specifier.h"
 #include "opt_table.h"
 #include "parsed_arg.h"
@@ -189,7 +190,7 @@ public:
     //     return Owner->isValidForSubCommand(Info, SubCommand);
     //   }
 
-    using ArgList = std::span<std::string>;
+    using ArgList = ArgvView;
 
     /// Potentially accept the current argument, returning a new Arg instance,
     /// or 0 if the option does not accept this argument (or the argument is
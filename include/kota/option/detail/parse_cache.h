@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "opt_specifier.h"
+#include "opt_table.h"
+#include "parsed_arg.h"
+
+namespace kota::option {
+
+/// Memoizes OptTable::parse_batch() for command lines that repeat.
+///
+/// Compilation databases run the same flags over thousands of sources. The
+/// cache keys a command line by its tokens, with every token the table
+/// would take as an input (one starting with no option prefix) replaced by
+/// a placeholder, so `-c a.c -o a.o` and `-c b.c -o b.o` share an entry. A
+/// hit skips option matching and rebuilds the arguments by pointing the
+/// entry's spellings and values into the new argv. Parsing never looks at
+/// the text of such a token, only at whether it is empty, so results match
+/// an uncached parse exactly.
+///
+/// Tables with grouped short options rewrite argv while parsing, so their
+/// command lines bypass the cache. Not thread-safe: threads sharing a table
+/// each keep their own cache.
+class ParseCache {
+public:
+    explicit ParseCache(const OptTable& table, Visibility visibility_mask = Visibility()) :
+        table(&table), visibility_mask(visibility_mask) {}
+
+    /// Same as OptTable::parse_batch(), reusing earlier parses where the
+    /// command line only differs in its inputs.
+    void parse_batch(std::span<const OptTable::InputArgv> commands, ParsedBatch& out);
+
+    /// Distinct command line shapes seen so far.
+    std::size_t size() const {
+        return this->entries.size();
+    }
+
+    std::size_t hits() const {
+        return this->hit_count;
+    }
+
+    std::size_t misses() const {
+        return this->miss_count;
+    }
+
+    void clear() {
+        this->entries.clear();
+        this->hit_count = 0;
+        this->miss_count = 0;
+    }
+
+private:
+    /// Where a parsed string lives: `length` bytes at `offset` in argv
+    /// `token`, the whole token when `length` is `whole_token`, or, for text
+    /// outside argv such as alias values, at `text`.
+    struct TextRef {
+        constexpr static std::uint32_t no_token = ~std::uint32_t(0);
+        constexpr static std::uint32_t whole_token = ~std::uint32_t(0);
+
+        const char* text = nullptr;
+        std::uint32_t token = no_token;
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    struct CachedArgument {
+        OptSpecifier option_id;
+        TextRef spelling;
+        unsigned index = 0;
+
+        /// Range of this argument's values in Entry::values.
+        unsigned first_value = 0;
+        unsigned value_count = 0;
+
+        std::optional<OptSpecifier> unaliased_option_id;
+        std::optional<std::vector<std::string_view>> unaliased_addition_values;
+    };
+
+    struct Entry {
+        std::vector<CachedArgument> arguments;
+        std::vector<TextRef> values;
+        unsigned missing_arg_index = 0;
+        unsigned missing_arg_count = 0;
+        const char* missing_arg_reason = nullptr;
+    };
+
+    struct KeyHash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view key) const noexcept {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    void make_key(OptTable::InputArgv argv);
+
+    static TextRef locate(OptTable::InputArgv argv, unsigned hint, std::string_view text);
+
+    static std::string_view resolve(OptTable::InputArgv argv, const TextRef& ref);
+
+    /// Empty when a parsed string covers only part of an input token, which
+    /// could not be patched into another command line.
+    std::optional<Entry> record(OptTable::InputArgv argv,
+                                const ParsedBatch& out,
+                                std::size_t first);
+
+    void replay(const Entry& entry, OptTable::InputArgv argv, ParsedBatch& out);
+
+    const OptTable* table;
+    Visibility visibility_mask;
+    std::string key;
+    std::unordered_map<std::string, Entry, KeyHash, std::equal_to<>> entries;
+    std::size_t hit_count = 0;
+    std::size_t miss_count = 0;
+};
+
+}  // namespace kota::option
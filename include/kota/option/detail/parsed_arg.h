@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <optional>
 #include <ostream>
 #include <span>
@@ -182,6 +183,71 @@ struct ParsedArgumentOwning : public ParsedArgumentBase<std::string, std::string
     }
 };
 
+/// Arguments of many command lines, filled by OptTable::parse_batch().
+///
+/// Arguments of every command live in one vector and each command records
+/// its range, so a batch that is cleared and refilled, e.g. once per chunk of
+/// a compilation database, stops allocating for its own storage once it has
+/// grown. Like ParsedArgument, the results view the parsed argv strings,
+/// which must outlive them.
+class ParsedBatch {
+public:
+    struct Command {
+        /// Range of this command's arguments in arguments().
+        unsigned first = 0;
+        unsigned count = 0;
+
+        /// Set as by OptTable::parse_args() when the last option lacks
+        /// values; missing_arg_count is 0 otherwise.
+        unsigned missing_arg_index = 0;
+        unsigned missing_arg_count = 0;
+        const char* missing_arg_reason = nullptr;
+    };
+
+    /// Number of command lines parsed into the batch.
+    std::size_t size() const {
+        return this->commands.size();
+    }
+
+    bool empty() const {
+        return this->commands.empty();
+    }
+
+    const Command& command(std::size_t index) const {
+        assert(index < this->commands.size() && "command index out of range");
+        return this->commands[index];
+    }
+
+    /// Arguments of the `index`th command line.
+    std::span<const ParsedArgument> arguments(std::size_t index) const {
+        const auto& command = this->command(index);
+        return std::span(this->args).subspan(command.first, command.count);
+    }
+
+    /// Arguments of all command lines, in order.
+    std::span<const ParsedArgument> arguments() const {
+        return std::span(this->args);
+    }
+
+    /// Drops all results but keeps the allocated storage.
+    void clear() {
+        this->args.clear();
+        this->commands.clear();
+    }
+
+    void reserve(std::size_t commands, std::size_t arguments) {
+        this->commands.reserve(commands);
+        this->args.reserve(arguments);
+    }
+
+private:
+    friend class OptTable;
+    friend class ParseCache;
+
+    std::vector<ParsedArgument> args;
+    std::vector<Command> commands;
+};
+
 /// Helper to convert a string_view to an array for storage in the variant.
 inline std::array<char, 8> to_spelling_array(std::string_view str) {
     std::array<char, 8> arr{};
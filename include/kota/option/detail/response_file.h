@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "argv_view.h"
+
+namespace kota::option {
+
+/// Quoting rules of a response file.
+enum class ResponseFileSyntax {
+    /// GCC and Clang: whitespace separates arguments, single and double
+    /// quotes group them, and a backslash escapes the next character, also
+    /// inside quotes.
+    GNU,
+
+    /// MSVC, as CommandLineToArgvW: only double quotes group, `""` inside
+    /// quotes is a literal quote, and backslashes are literal unless they
+    /// precede a quote, where each pair of them becomes one backslash.
+    MSVC,
+};
+
+/// ResponseFile - The arguments of an `@file` response file.
+///
+/// The file is mapped copy-on-write and tokenized lazily, in place: next()
+/// resolves the quotes and escapes of an argument by rewriting the mapping,
+/// which only copies the pages where that happens, so every argument is a
+/// string_view into it. Arguments stay valid while the ResponseFile lives,
+/// including across moves.
+class ResponseFile {
+public:
+    ResponseFile() = default;
+
+    ResponseFile(const ResponseFile&) = delete;
+    ResponseFile& operator=(const ResponseFile&) = delete;
+
+    ResponseFile(ResponseFile&& other) noexcept;
+    ResponseFile& operator=(ResponseFile&& other) noexcept;
+
+    ~ResponseFile();
+
+    /// Map the file at `path`. The error says why it could not be read;
+    /// `missing` is set when the file does not exist.
+    static std::expected<ResponseFile, std::string>
+        open(const std::string& path,
+             ResponseFileSyntax syntax = ResponseFileSyntax::GNU,
+             bool* missing = nullptr);
+
+    /// Tokenize a copy of `text`, e.g. response file contents read elsewhere.
+    static ResponseFile from_text(std::string_view text,
+                                  ResponseFileSyntax syntax = ResponseFileSyntax::GNU);
+
+    /// The next argument, or nullopt once the file is exhausted.
+    std::optional<std::string_view> next();
+
+    /// Size of the file in bytes.
+    std::size_t size() const {
+        return this->length;
+    }
+
+private:
+    enum class Backing : char {
+        None,
+        Heap,
+        Mapping,
+    };
+
+    void reset() noexcept;
+
+    std::string_view next_gnu();
+    std::string_view next_msvc();
+
+    char* base = nullptr;
+    std::size_t length = 0;
+    std::size_t cursor = 0;
+    Backing backing = Backing::None;
+    ResponseFileSyntax syntax = ResponseFileSyntax::GNU;
+};
+
+class ExpandedArgv;
+
+/// Replace every `@file` argument of `argv`, and of the response files it
+/// names, with the arguments of that file. As with GCC, an `@file` whose
+/// file does not exist is kept as it is. Other read errors and a response
+/// file that names itself, directly or not, are errors.
+std::expected<ExpandedArgv, std::string>
+    expand_response_files(ArgvView argv, ResponseFileSyntax syntax = ResponseFileSyntax::GNU);
+
+/// ExpandedArgv - A command line with its `@file` arguments expanded.
+///
+/// Without any response file it simply views the original argv, which has
+/// to outlive it; otherwise it views the expanded arguments, which point
+/// into the original argv and into the ResponseFiles kept here.
+class ExpandedArgv {
+public:
+    ExpandedArgv() = default;
+
+    ExpandedArgv(const ExpandedArgv&) = delete;
+    ExpandedArgv& operator=(const ExpandedArgv&) = delete;
+
+    ExpandedArgv(ExpandedArgv&&) = default;
+    ExpandedArgv& operator=(ExpandedArgv&&) = default;
+
+    ArgvView argv() const {
+        return this->view;
+    }
+
+    /// Response files that were expanded, nested ones included.
+    std::size_t response_file_count() const {
+        return this->files.size();
+    }
+
+private:
+    friend std::expected<ExpandedArgv, std::string> expand_response_files(ArgvView argv,
+                                                                          ResponseFileSyntax syntax);
+
+    ArgvView view;
+    std::vector<std::string_view> args;
+    std::vector<ResponseFile> files;
+};
+
+}  // namespace kota::option
@@ -1,5 +1,8 @@
 #pragma once
+#include "./detail/argv_view.h"
 #include "./detail/opt_specifier.h"
 #include "./detail/opt_table.h"
 #include "./detail/option.h"
+#include "./detail/parse_cache.h"
 #include "./detail/parsed_arg.h"
+#include "./detail/response_file.h"
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include "memory.h"
@@ -11,40 +15,52 @@
 namespace kota {
 
 /// A copy-on-write string that can either borrow a reference to external data
-/// or own its own heap-allocated copy. Designed for zero-copy deserialization:
-/// unescaped strings borrow from the source buffer, while escaped strings
-/// allocate and own their data.
+/// or own its own copy. Designed for zero-copy deserialization: unescaped
+/// strings borrow from the source buffer, while escaped strings allocate and
+/// own their data.
 ///
 /// Layout: three machine words {pointer, size, capacity}.
 ///   - capacity == 0: borrowed mode, pointer refers to external buffer
-///   - capacity > 0: owned mode, pointer refers to allocator-managed memory
+///   - capacity has inline_flag set: owned inline, the first two words hold
+///     the characters and the low bits of capacity hold the size
+///   - otherwise: owned mode, pointer refers to allocator-managed memory
 ///
-/// Owned buffers are allocated via mem::allocate<char> and can be transferred
-/// to small_string via release().
+/// An owned string of up to inline_capacity characters is kept inline, so
+/// promoting a short borrowed key never allocates. Constant evaluation
+/// always allocates, since it cannot switch the words to characters.
+///
+/// Heap buffers are allocated via mem::allocate<char> and are transferred
+/// to small_string by release() without a copy.
 class cow_string {
+    struct heap_parts {
+        char* data;
+        std::size_t size;
+    };
+
 public:
+    /// Owned strings up to this size live inside the object.
+    constexpr static std::size_t inline_capacity = sizeof(heap_parts);
+
     /// Default constructor: empty borrowed string.
     constexpr cow_string() noexcept = default;
 
     /// Construct a borrowed string from a string_ref.
     constexpr cow_string(string_ref sv) noexcept :
-        m_data(const_cast<char*>(sv.data())), m_size(sv.size()), m_capacity(0) {}
+        m_storage{.heap = {const_cast<char*>(sv.data()), sv.size()}}, m_capacity(0) {}
 
-    /// Copy constructor: borrowed copies as borrowed, owned deep-copies.
+    /// Copy constructor: borrowed and inline copy as they are, heap-owned
+    /// deep-copies.
     constexpr cow_string(const cow_string& other) :
-        m_data(other.m_data), m_size(other.m_size), m_capacity(0) {
-        if(other.m_capacity > 0) {
-            m_data = alloc_copy(other.m_data, other.m_size, other.m_capacity);
-            m_capacity = other.m_capacity;
+        m_storage(other.m_storage), m_capacity(other.m_capacity) {
+        if(other.on_heap()) {
+            m_storage.heap.data = alloc_copy(other.data(), other.size(), other.m_capacity);
         }
     }
 
     /// Move constructor: transfers ownership, source becomes empty.
     constexpr cow_string(cow_string&& other) noexcept :
-        m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity) {
-        other.m_data = nullptr;
-        other.m_size = 0;
-        other.m_capacity = 0;
+        m_storage(other.m_storage), m_capacity(other.m_capacity) {
+        other.reset();
     }
 
     /// Copy assignment.
@@ -60,12 +76,9 @@ public:
     constexpr cow_string& operator=(cow_string&& other) noexcept {
         if(this != &other) {
             free();
-            m_data = other.m_data;
-            m_size = other.m_size;
+            m_storage = other.m_storage;
             m_capacity = other.m_capacity;
-            other.m_data = nullptr;
-            other.m_size = 0;
-            other.m_capacity = 0;
+            other.reset();
         }
         return *this;
     }
@@ -81,40 +94,32 @@ public:
         return cow_string(sv);
     }
 
-    /// Create an owned string by taking ownership of an std::string.
+    /// Create an owned string by copying an std::string.
     [[nodiscard]] constexpr static cow_string owned(std::string&& s) {
         cow_string result;
-        if(!s.empty()) {
-            result.m_size = s.size();
-            result.m_capacity = s.size();
-            result.m_data = alloc_copy(s.data(), s.size(), s.size());
-        }
+        result.own_copy(s.data(), s.size());
         return result;
     }
 
     /// Create an owned string by copying from a string_ref.
     [[nodiscard]] constexpr static cow_string owned(string_ref sv) {
         cow_string result;
-        if(!sv.empty()) {
-            result.m_size = sv.size();
-            result.m_capacity = sv.size();
-            result.m_data = alloc_copy(sv.data(), sv.size(), sv.size());
-        }
+        result.own_copy(sv.data(), sv.size());
         return result;
     }
 
     // --- Observers ---
 
     [[nodiscard]] constexpr const char* data() const noexcept {
-        return m_data;
+        return is_inline() ? m_storage.chars : m_storage.heap.data;
     }
 
     [[nodiscard]] constexpr std::size_t size() const noexcept {
-        return m_size;
+        return is_inline() ? m_capacity & ~inline_flag : m_storage.heap.size;
     }
 
     [[nodiscard]] constexpr bool empty() const noexcept {
-        return m_size == 0;
+        return size() == 0;
     }
 
     [[nodiscard]] constexpr bool is_borrowed() const noexcept {
@@ -125,11 +130,16 @@ public:
         return m_capacity > 0;
     }
 
+    /// Owned, with the characters inside the object rather than on the heap.
+    [[nodiscard]] constexpr bool is_inline() const noexcept {
+        return (m_capacity & inline_flag) != 0;
+    }
+
     // --- Conversion ---
 
     /// Return a string_ref view of this string.
     [[nodiscard]] constexpr string_ref ref() const noexcept {
-        return string_ref(m_data, m_size);
+        return string_ref(data(), size());
     }
 
     /// Implicit conversion to string_ref.
@@ -139,50 +149,45 @@ public:
 
     /// Implicit conversion to std::string_view.
     constexpr operator std::string_view() const noexcept {
-        return std::string_view(m_data, m_size);
+        return std::string_view(data(), size());
     }
 
     /// Convert to std::string.
     [[nodiscard]] constexpr std::string to_string() const {
-        return std::string(m_data, m_size);
+        return std::string(data(), size());
     }
 
     // --- Mutation ---
 
     /// Convert this string to owned mode (no-op if already owned).
     constexpr void make_owned() {
-        if(m_capacity == 0 && m_size > 0) {
-            m_data = alloc_copy(m_data, m_size, m_size);
-            m_capacity = m_size;
+        if(m_capacity == 0 && m_storage.heap.size > 0) {
+            own_copy(m_storage.heap.data, m_storage.heap.size);
         }
     }
 
     /// Release the buffer as a small_string<N>, transferring ownership.
-    /// If owned, the buffer is moved directly without copying.
-    /// If borrowed and fits in inline storage, copies to inline buffer
-    /// without heap allocation; otherwise allocates.
+    /// A heap buffer is moved directly without copying. Borrowed and
+    /// inline strings are copied, into the small_string's inline buffer
+    /// when they fit and onto the heap otherwise.
     /// After this call, the cow_string is empty.
     template <unsigned N = 0>
     [[nodiscard]] constexpr small_string<N> release() {
-        if(m_capacity == 0) {
-            // Borrowed: construct small_string from the view directly.
-            // If m_size <= N, small_string will use its inline buffer (no heap alloc).
-            small_string<N> result(string_ref(m_data, m_size));
-            m_data = nullptr;
-            m_size = 0;
+        if(!on_heap()) {
+            // If size() <= N, small_string will use its inline buffer (no heap alloc).
+            small_string<N> result(ref());
+            reset();
             return result;
         }
         // Owned: transfer the buffer directly.
-        auto result = small_string<N>::from_raw_parts(m_data, m_size, m_capacity);
-        m_data = nullptr;
-        m_size = 0;
-        m_capacity = 0;
+        auto result =
+            small_string<N>::from_raw_parts(m_storage.heap.data, m_storage.heap.size, m_capacity);
+        reset();
         return result;
     }
 
     constexpr void swap(cow_string& other) noexcept {
-        std::swap(m_data, other.m_data);
-        std::swap(m_size, other.m_size);
+        std::swap(m_storage, other.m_storage);
         std::swap(m_capacity, other.m_capacity);
     }
 
@@ -201,10 +206,38 @@ public:
     }
 
 private:
+    constexpr static std::size_t inline_flag = std::size_t(1)
+                                               << (std::numeric_limits<std::size_t>::digits - 1);
+
+    constexpr bool on_heap() const noexcept {
+        return m_capacity > 0 && !is_inline();
+    }
+
     constexpr void free() noexcept {
-        if(m_capacity > 0) {
-            mem::deallocate(m_data, m_capacity);
+        if(on_heap()) {
+            mem::deallocate(m_storage.heap.data, m_capacity);
+        }
+    }
+
+    constexpr void reset() noexcept {
+        m_storage.heap = {nullptr, 0};
+        m_capacity = 0;
+    }
+
+    /// Becomes an owned copy of [src, src + len), which must not be this
+    /// string's own storage. Any previous contents must need no freeing.
+    constexpr void own_copy(const char* src, std::size_t len) {
+        if(len == 0) {
+            reset();
+            return;
+        }
+        if(!std::is_constant_evaluated() && len <= inline_capacity) {
+            std::memcpy(m_storage.chars, src, len);
+            m_capacity = inline_flag | len;
+            return;
         }
+        m_storage.heap = {alloc_copy(src, len, len), len};
+        m_capacity = len;
     }
 
     constexpr static char* alloc_copy(const char* src, std::size_t len, std::size_t cap) {
@@ -215,9 +248,19 @@ private:
         return buf;
     }
 
-    char* m_data = nullptr;
-    std::size_t m_size = 0;
+    union storage {
+        heap_parts heap{nullptr, 0};
+        char chars[sizeof(heap_parts)];
+    };
+
+    storage m_storage;
     std::size_t m_capacity = 0;
 };
 
+/// A pointer, a size and a capacity, none of them aimed at the string
+/// itself: inline characters are found through the capacity's flag, not a
+/// pointer. Containers may move it with memcpy.
+template <>
+struct mem::is_trivially_relocatable<cow_string> : std::true_type {};
+
 }  // namespace kota
@@ -0,0 +1,971 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KOTA_FLAT_HASH_SSE2 1
+#else
+#define KOTA_FLAT_HASH_SSE2 0
+#endif
+
+#include "memory.h"
+
+namespace kota {
+
+/// The default hasher of flat_hash_map and flat_hash_set. Strings hash as
+/// string views, so a table keyed by std::string can be searched with a
+/// std::string_view or a literal without building a key.
+template <typename T>
+struct flat_hash : std::hash<T> {};
+
+template <>
+struct flat_hash<std::string> {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const noexcept {
+        return std::hash<std::string_view>{}(text);
+    }
+};
+
+template <>
+struct flat_hash<std::string_view> : flat_hash<std::string> {};
+
+namespace detail {
+
+/// One control byte per slot. A full slot stores the low 7 bits of its
+/// hash, so a probe compares 16 of them at once and touches the slots
+/// themselves only on a likely match.
+using flat_ctrl = std::int8_t;
+
+constexpr inline flat_ctrl flat_empty = -128;
+constexpr inline flat_ctrl flat_deleted = -2;
+/// Pads a table smaller than a group; never matches and is never free.
+constexpr inline flat_ctrl flat_sentinel = -1;
+
+/// The control bytes of one aligned group of 16 slots.
+class flat_group {
+public:
+    constexpr static std::size_t width = 16;
+
+    explicit flat_group(const flat_ctrl* ctrl) noexcept {
+#if KOTA_FLAT_HASH_SSE2
+        bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        std::memcpy(bytes, ctrl, width);
+#endif
+    }
+
+    /// Positions holding `h2`, one bit each.
+    std::uint32_t match(flat_ctrl h2) const noexcept {
+#if KOTA_FLAT_HASH_SSE2
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes)));
+#else
+        std::uint32_t mask = 0;
+        for(std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(bytes[i] == h2) << i;
+        }
+        return mask;
+#endif
+    }
+
+    std::uint32_t match_empty() const noexcept {
+        return match(flat_empty);
+    }
+
+    /// Positions that are empty or deleted, where an insert may go.
+    std::uint32_t match_free() const noexcept {
+#if KOTA_FLAT_HASH_SSE2
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flat_sentinel), bytes)));
+#else
+        std::uint32_t mask = 0;
+        for(std::size_t i = 0; i < width; ++i) {
+            mask |= static_cast<std::uint32_t>(bytes[i] < flat_sentinel) << i;
+        }
+        return mask;
+#endif
+    }
+
+private:
+#if KOTA_FLAT_HASH_SSE2
+    __m128i bytes;
+#else
+    flat_ctrl bytes[width];
+#endif
+};
+
+/// Spreads a std::hash result, which is the identity for integers, over
+/// all 64 bits: the low 7 go to the control byte, the rest pick a group.
+constexpr std::uint64_t flat_mix(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename T, std::size_t N>
+struct flat_inline_storage {
+    constexpr static std::size_t ctrl_size = N < flat_group::width ? flat_group::width : N;
+
+    alignas(T) std::byte slots[N * sizeof(T)];
+    flat_ctrl ctrl[ctrl_size];
+};
+
+template <typename T>
+struct flat_inline_storage<T, 0> {};
+
+template <typename Key>
+struct flat_set_policy {
+    using key_type = Key;
+    using value_type = Key;
+
+    static const key_type& key(const value_type& value) noexcept {
+        return value;
+    }
+
+    constexpr static bool relocatable = mem::is_trivially_relocatable_v<Key>;
+};
+
+template <typename Key, typename T>
+struct flat_map_policy {
+    using key_type = Key;
+    using value_type = std::pair<const Key, T>;
+
+    static const key_type& key(const value_type& value) noexcept {
+        return value.first;
+    }
+
+    constexpr static bool relocatable =
+        mem::is_trivially_relocatable_v<Key> && mem::is_trivially_relocatable_v<T>;
+};
+
+/// The open-addressing table behind flat_hash_map and flat_hash_set, laid
+/// out as in Abseil's Swiss tables: an array of control bytes beside an
+/// array of slots, probed one 16-byte group at a time with SSE2 where the
+/// target has it. Up to `InlineSlots` elements live inside the table
+/// itself. Inserting may move elements, so it invalidates iterators and
+/// references; erasing invalidates only those to the erased element.
+template <typename Policy, typename Hash, typename Eq, std::size_t InlineSlots>
+class flat_table {
+    static_assert(InlineSlots == 0 || (InlineSlots >= 2 && std::has_single_bit(InlineSlots)),
+                  "InlineSlots must be 0 or a power of two of at least 2");
+
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        basic_iterator() = default;
+
+        template <bool OtherConst>
+            requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept :
+            ctrl(other.ctrl), last(other.last), slot(other.slot) {}
+
+        reference operator*() const noexcept {
+            return *slot;
+        }
+
+        pointer operator->() const noexcept {
+            return slot;
+        }
+
+        basic_iterator& operator++() noexcept {
+            ++ctrl;
+            ++slot;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.ctrl == rhs.ctrl;
+        }
+
+    private:
+        friend class flat_table;
+        template <bool>
+        friend class basic_iterator;
+
+        basic_iterator(const flat_ctrl* ctrl, const flat_ctrl* last, value_type* slot) noexcept :
+            ctrl(ctrl), last(last), slot(slot) {}
+
+        void skip_free() noexcept {
+            while(ctrl != last && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        const flat_ctrl* ctrl = nullptr;
+        const flat_ctrl* last = nullptr;
+        value_type* slot = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_table() noexcept {
+        reset_to_inline();
+    }
+
+    explicit flat_table(size_type expected, const Hash& hash = Hash(), const Eq& eq = Eq()) :
+        m_hash(hash), m_eq(eq) {
+        reset_to_inline();
+        reserve(expected);
+    }
+
+    flat_table(const flat_table& other) : m_hash(other.m_hash), m_eq(other.m_eq) {
+        reset_to_inline();
+        reserve(other.size());
+        for(const auto& value: other) {
+            emplace_unique(hash_of(Policy::key(value)), value);
+        }
+    }
+
+    flat_table(flat_table&& other) noexcept(std::is_nothrow_move_constructible_v<value_type>) :
+        m_hash(std::move(other.m_hash)), m_eq(std::move(other.m_eq)) {
+        reset_to_inline();
+        take(other);
+    }
+
+    flat_table& operator=(const flat_table& other) {
+        if(this != &other) {
+            flat_table copy(other);
+            clear_and_release();
+            m_hash = std::move(copy.m_hash);
+            m_eq = std::move(copy.m_eq);
+            take(copy);
+        }
+        return *this;
+    }
+
+    flat_table& operator=(flat_table&& other) noexcept(
+        std::is_nothrow_move_constructible_v<value_type>) {
+        if(this != &other) {
+            clear_and_release();
+            m_hash = std::move(other.m_hash);
+            m_eq = std::move(other.m_eq);
+            take(other);
+        }
+        return *this;
+    }
+
+    ~flat_table() {
+        clear_and_release();
+    }
+
+    iterator begin() noexcept {
+        return make_begin<iterator>();
+    }
+
+    const_iterator begin() const noexcept {
+        return make_begin<const_iterator>();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    size_type capacity() const noexcept {
+        return m_capacity;
+    }
+
+    /// Whether the elements are in the inline m_slots rather than on the heap.
+    bool inlined() const noexcept {
+        if constexpr(InlineSlots == 0) {
+            return false;
+        } else {
+            return m_ctrl == m_inline.ctrl;
+        }
+    }
+
+    hasher hash_function() const {
+        return m_hash;
+    }
+
+    key_equal key_eq() const {
+        return m_eq;
+    }
+
+    void clear() noexcept {
+        destroy_elements();
+        reset_ctrl(m_ctrl, m_capacity);
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    /// Makes room for `wanted` elements without another rehash.
+    void reserve(size_type wanted) {
+        if(wanted > m_size + m_growth_left) {
+            rehash_to(capacity_for(wanted));
+        }
+    }
+
+    template <typename K = key_type>
+    iterator find(const K& key) {
+        return iterator_at(find_index(key));
+    }
+
+    template <typename K = key_type>
+    const_iterator find(const K& key) const {
+        return const_cast<flat_table*>(this)->find(key);
+    }
+
+    template <typename K = key_type>
+    bool contains(const K& key) const {
+        return find_index(key) != npos;
+    }
+
+    template <typename K = key_type>
+    size_type count_of(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    /// Erases the element at `pos`; the others stay where they are.
+    iterator erase(const_iterator pos) {
+        const auto index = static_cast<size_type>(pos.ctrl - m_ctrl);
+        erase_at(index);
+        auto next = iterator(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+        next.skip_free();
+        return next;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    template <typename K = key_type>
+    size_type erase_key(const K& key) {
+        const auto index = find_index(key);
+        if(index == npos) {
+            return 0;
+        }
+        erase_at(index);
+        return 1;
+    }
+
+    void swap(flat_table& other) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+        flat_table temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+protected:
+    constexpr static size_type npos = static_cast<size_type>(-1);
+
+    /// The slot holding `key`, or where it goes. `found` tells which; when
+    /// it is false the caller must construct an element in the slot and
+    /// then call commit_insert().
+    struct insert_slot {
+        size_type index;
+        bool found;
+    };
+
+    template <typename K>
+    std::size_t hash_of(const K& key) const {
+        return static_cast<std::size_t>(flat_mix(static_cast<std::uint64_t>(m_hash(key))));
+    }
+
+    template <typename K>
+    size_type find_index(const K& key) const {
+        if(m_size == 0) {
+            return npos;
+        }
+        return find_hashed(key, hash_of(key));
+    }
+
+    template <typename K>
+    size_type find_hashed(const K& key, std::size_t hash) const {
+        const auto h2 = static_cast<flat_ctrl>(hash & 0x7F);
+        const auto mask = group_mask();
+        auto group = (hash >> 7) & mask;
+        for(size_type step = 1;; ++step) {
+            flat_group bytes(m_ctrl + group * flat_group::width);
+            for(auto bits = bytes.match(h2); bits != 0; bits &= bits - 1) {
+                const auto index = group * flat_group::width +
+                                   static_cast<size_type>(std::countr_zero(bits));
+                if(m_eq(Policy::key(m_slots[index]), key)) {
+                    return index;
+                }
+            }
+            if(bytes.match_empty() != 0) {
+                return npos;
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    template <typename K>
+    insert_slot prepare_insert(const K& key) {
+        const auto hash = hash_of(key);
+        if(m_size != 0) {
+            if(auto index = find_hashed(key, hash); index != npos) {
+                return {index, true};
+            }
+        }
+        if(m_capacity == 0) {
+            rehash_to(next_capacity());
+        }
+        auto index = find_free(hash);
+        if(m_growth_left == 0 && m_ctrl[index] == flat_empty) {
+            rehash_to(next_capacity());
+            index = find_free(hash);
+        }
+        m_pending_h2 = static_cast<flat_ctrl>(hash & 0x7F);
+        return {index, false};
+    }
+
+    /// Marks the slot prepare_insert() returned as holding the element
+    /// just constructed there.
+    void commit_insert(size_type index) noexcept {
+        if(m_ctrl[index] == flat_empty) {
+            m_growth_left -= 1;
+        }
+        m_ctrl[index] = m_pending_h2;
+        m_size += 1;
+    }
+
+    template <typename... Args>
+    value_type& emplace_unique(std::size_t hash, Args&&... args) {
+        if(m_growth_left == 0) {
+            rehash_to(next_capacity());
+        }
+        const auto index = find_free(hash);
+        mem::construct(m_slots + index, std::forward<Args>(args)...);
+        m_pending_h2 = static_cast<flat_ctrl>(hash & 0x7F);
+        commit_insert(index);
+        return m_slots[index];
+    }
+
+    iterator iterator_at(size_type index) noexcept {
+        if(index == npos) {
+            return end();
+        }
+        return iterator(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+    }
+
+    value_type* slot_at(size_type index) noexcept {
+        return m_slots + index;
+    }
+
+private:
+    constexpr static size_type max_load(size_type capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    constexpr static size_type ctrl_size(size_type capacity) noexcept {
+        return capacity < flat_group::width ? flat_group::width : capacity;
+    }
+
+    static size_type capacity_for(size_type wanted) {
+        if(wanted == 0) {
+            return 0;
+        }
+        if(wanted > (static_cast<size_type>(-1) >> 4)) {
+            KOTA_THROW(std::length_error("flat_hash table capacity overflow"));
+        }
+        auto capacity = std::bit_ceil(wanted + (wanted + 6) / 7);
+        return capacity < flat_group::width ? flat_group::width : capacity;
+    }
+
+    size_type next_capacity() const {
+        // Mostly tombstones: rebuilding at the same size frees them.
+        if(m_capacity > InlineSlots && m_size <= max_load(m_capacity) / 2) {
+            return m_capacity;
+        }
+        return capacity_for(m_capacity == 0 ? 1 : max_load(m_capacity) + 1);
+    }
+
+    size_type group_mask() const noexcept {
+        return ctrl_size(m_capacity) / flat_group::width - 1;
+    }
+
+    static void reset_ctrl(flat_ctrl* bytes, size_type capacity) noexcept {
+        if(bytes == nullptr) {
+            return;
+        }
+        std::memset(bytes, flat_empty, capacity);
+        std::memset(bytes + capacity, flat_sentinel, ctrl_size(capacity) - capacity);
+    }
+
+    void reset_to_inline() noexcept {
+        if constexpr(InlineSlots == 0) {
+            m_ctrl = nullptr;
+            m_slots = nullptr;
+        } else {
+            m_ctrl = m_inline.ctrl;
+            m_slots = reinterpret_cast<value_type*>(m_inline.slots);
+            reset_ctrl(m_ctrl, InlineSlots);
+        }
+        m_capacity = InlineSlots;
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    size_type find_free(std::size_t hash) const noexcept {
+        const auto mask = group_mask();
+        auto group = (hash >> 7) & mask;
+        for(size_type step = 1;; ++step) {
+            flat_group bytes(m_ctrl + group * flat_group::width);
+            if(auto bits = bytes.match_free(); bits != 0) {
+                return group * flat_group::width + static_cast<size_type>(std::countr_zero(bits));
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    void erase_at(size_type index) noexcept {
+        mem::destroy(m_slots + index);
+        // A probe stops at the first group with an empty slot, so when this
+        // group already has one no probe can depend on it being full.
+        const auto group = index / flat_group::width * flat_group::width;
+        if(flat_group(m_ctrl + group).match_empty() != 0) {
+            m_ctrl[index] = flat_empty;
+            m_growth_left += 1;
+        } else {
+            m_ctrl[index] = flat_deleted;
+        }
+        m_size -= 1;
+    }
+
+    void destroy_elements() noexcept {
+        if constexpr(!std::is_trivially_destructible_v<value_type>) {
+            for(size_type i = 0; i < m_capacity && m_size != 0; ++i) {
+                if(m_ctrl[i] >= 0) {
+                    mem::destroy(m_slots + i);
+                }
+            }
+        }
+    }
+
+    static void relocate_slot(value_type* target, value_type* source) {
+        if constexpr(Policy::relocatable) {
+            std::memcpy(static_cast<void*>(target),
+                        static_cast<const void*>(source),
+                        sizeof(*source));
+        } else {
+            mem::construct(target, std::move(*source));
+            mem::destroy(source);
+        }
+    }
+
+    /// Moves every element into fresh heap arrays of `new_capacity`.
+    void rehash_to(size_type new_capacity) {
+        auto* new_ctrl = mem::allocate<flat_ctrl>(ctrl_size(new_capacity));
+        value_type* new_slots = nullptr;
+        KOTA_TRY {
+            new_slots = mem::allocate<value_type>(new_capacity);
+        }
+        KOTA_CATCH_ALL() {
+            mem::deallocate(new_ctrl, ctrl_size(new_capacity));
+            KOTA_RETHROW();
+        }
+        reset_ctrl(new_ctrl, new_capacity);
+
+        auto* old_ctrl = m_ctrl;
+        auto* old_slots = m_slots;
+        const auto old_capacity = m_capacity;
+        const bool was_heap = old_capacity != 0 && old_ctrl != inline_ctrl();
+
+        m_ctrl = new_ctrl;
+        m_slots = new_slots;
+        m_capacity = new_capacity;
+        m_growth_left = max_load(new_capacity) - m_size;
+
+        for(size_type i = 0; i < old_capacity; ++i) {
+            if(old_ctrl[i] < 0) {
+                continue;
+            }
+            const auto hash = hash_of(Policy::key(old_slots[i]));
+            const auto index = find_free(hash);
+            // Moves are expected not to throw here, as in std::vector growth.
+            relocate_slot(new_slots + index, old_slots + i);
+            m_ctrl[index] = static_cast<flat_ctrl>(hash & 0x7F);
+        }
+
+        if(was_heap) {
+            mem::deallocate(old_ctrl, ctrl_size(old_capacity));
+            mem::deallocate(old_slots, old_capacity);
+        }
+    }
+
+    flat_ctrl* inline_ctrl() noexcept {
+        if constexpr(InlineSlots == 0) {
+            return nullptr;
+        } else {
+            return m_inline.ctrl;
+        }
+    }
+
+    void clear_and_release() noexcept {
+        destroy_elements();
+        if(m_capacity != 0 && m_ctrl != inline_ctrl()) {
+            mem::deallocate(m_ctrl, ctrl_size(m_capacity));
+            mem::deallocate(m_slots, m_capacity);
+        }
+        reset_to_inline();
+    }
+
+    /// Takes the elements of `other`, which must be empty afterwards and
+    /// this table empty and inline before.
+    void take(flat_table& other) noexcept(std::is_nothrow_move_constructible_v<value_type>) {
+        if(other.m_capacity == 0) {
+            return;
+        }
+        if constexpr(InlineSlots != 0) {
+            if(other.inlined()) {
+                // Same capacity and hash, so every element keeps its index.
+                std::memcpy(m_ctrl, other.m_ctrl, ctrl_size(m_capacity));
+                for(size_type i = 0; i < m_capacity; ++i) {
+                    if(other.m_ctrl[i] >= 0) {
+                        relocate_slot(m_slots + i, other.m_slots + i);
+                    }
+                }
+                m_size = other.m_size;
+                m_growth_left = other.m_growth_left;
+                other.reset_to_inline();
+                return;
+            }
+        }
+
+        m_ctrl = other.m_ctrl;
+        m_slots = other.m_slots;
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+        m_growth_left = other.m_growth_left;
+        other.reset_to_inline();
+    }
+
+    template <typename It>
+    It make_begin() const noexcept {
+        It it(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity);
+        if(m_size != 0) {
+            it = It(m_ctrl, m_ctrl + m_capacity, m_slots);
+            it.skip_free();
+        }
+        return it;
+    }
+
+    flat_ctrl* m_ctrl;
+    value_type* m_slots;
+    size_type m_capacity;
+    size_type m_size;
+    size_type m_growth_left;
+    flat_ctrl m_pending_h2 = 0;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] flat_inline_storage<value_type, InlineSlots> m_inline;
+};
+
+template <typename Hash, typename Eq, typename K>
+concept flat_transparent = requires {
+    typename Hash::is_transparent;
+    typename Eq::is_transparent;
+} && std::is_invocable_v<const Hash&, const K&>;
+
+}  // namespace detail
+
+/// An open-addressing hash map for lookup-heavy tables such as method
+/// dispatch and option lookup. It stores its elements in one flat array,
+/// so a lookup costs one group probe and usually one key comparison
+/// instead of a bucket walk and a pointer chase. A transparent hasher and
+/// equality allow lookups with any type they accept, such as string views
+/// into a std::string-keyed map. Up to `InlineSlots` elements are kept in
+/// the map itself before the first allocation.
+///
+/// Inserting may move elements: it invalidates references to them, unlike
+/// std::unordered_map.
+template <typename Key,
+          typename T,
+          typename Hash = flat_hash<Key>,
+          typename Eq = std::equal_to<>,
+          std::size_t InlineSlots = 0>
+class flat_hash_map : public detail::flat_table<detail::flat_map_policy<Key, T>,
+                                                Hash,
+                                                Eq,
+                                                InlineSlots> {
+    using base = detail::flat_table<detail::flat_map_policy<Key, T>, Hash, Eq, InlineSlots>;
+
+    template <typename K>
+    constexpr static bool lookup_with =
+        std::is_convertible_v<const K&, const Key&> || detail::flat_transparent<Hash, Eq, K>;
+
+public:
+    using mapped_type = T;
+    using typename base::const_iterator;
+    using typename base::iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+
+    using base::base;
+
+    flat_hash_map() = default;
+
+    flat_hash_map(std::initializer_list<value_type> values) {
+        insert(values.begin(), values.end());
+    }
+
+    template <typename K, typename... Args>
+        requires lookup_with<K> && std::is_constructible_v<Key, K&&>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        auto [index, found] = this->prepare_insert(key);
+        if(found) {
+            return {this->iterator_at(index), false};
+        }
+        mem::construct(this->slot_at(index),
+                       std::piecewise_construct,
+                       std::forward_as_tuple(std::forward<K>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+        this->commit_insert(index);
+        return {this->iterator_at(index), true};
+    }
+
+    template <typename K, typename... Args>
+        requires lookup_with<K> && std::is_constructible_v<Key, K&&>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename M>
+        requires lookup_with<K> && std::is_constructible_v<Key, K&&>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& value) {
+        auto result = try_emplace(std::forward<K>(key), std::forward<M>(value));
+        if(!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(value.first, std::move(value.second));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        if constexpr(std::forward_iterator<InputIt>) {
+            this->reserve(this->size() + static_cast<size_type>(std::distance(first, last)));
+        }
+        for(; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    template <typename K>
+        requires lookup_with<K> && std::is_constructible_v<Key, K&&>
+    T& operator[](K&& key) {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    template <typename K>
+        requires lookup_with<K>
+    T& at(const K& key) {
+        auto it = this->find(key);
+        if(it == this->end()) {
+            KOTA_THROW(std::out_of_range("flat_hash_map::at: key not found"));
+        }
+        return it->second;
+    }
+
+    template <typename K>
+        requires lookup_with<K>
+    const T& at(const K& key) const {
+        return const_cast<flat_hash_map*>(this)->at(key);
+    }
+
+    template <typename K>
+        requires lookup_with<K>
+    size_type count(const K& key) const {
+        return this->count_of(key);
+    }
+
+    using base::erase;
+
+    template <typename K>
+        requires lookup_with<K> && (!std::is_convertible_v<K, const_iterator>)
+    size_type erase(const K& key) {
+        return this->erase_key(key);
+    }
+
+    friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs) {
+        if(lhs.size() != rhs.size()) {
+            return false;
+        }
+        for(const auto& [key, value]: lhs) {
+            auto it = rhs.find(key);
+            if(it == rhs.end() || !(it->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/// The set counterpart of flat_hash_map, with the same probing, inline
+/// slots and invalidation rules.
+template <typename Key,
+          typename Hash = flat_hash<Key>,
+          typename Eq = std::equal_to<>,
+          std::size_t InlineSlots = 0>
+class flat_hash_set
+    : public detail::flat_table<detail::flat_set_policy<Key>, Hash, Eq, InlineSlots> {
+    using base = detail::flat_table<detail::flat_set_policy<Key>, Hash, Eq, InlineSlots>;
+
+    template <typename K>
+    constexpr static bool lookup_with =
+        std::is_convertible_v<const K&, const Key&> || detail::flat_transparent<Hash, Eq, K>;
+
+public:
+    using typename base::const_iterator;
+    using typename base::key_type;
+    using typename base::size_type;
+    using typename base::value_type;
+    /// Elements are keys, so even a mutable iterator reads them as const.
+    using iterator = const_iterator;
+
+    using base::base;
+
+    flat_hash_set() = default;
+
+    flat_hash_set(std::initializer_list<value_type> values) {
+        insert(values.begin(), values.end());
+    }
+
+    const_iterator begin() const noexcept {
+        return base::begin();
+    }
+
+    const_iterator end() const noexcept {
+        return base::end();
+    }
+
+    template <typename K>
+        requires lookup_with<K> && std::is_constructible_v<Key, K&&>
+    std::pair<iterator, bool> insert(K&& key) {
+        auto [index, found] = this->prepare_insert(key);
+        if(found) {
+            return {this->iterator_at(index), false};
+        }
+        mem::construct(this->slot_at(index), std::forward<K>(key));
+        this->commit_insert(index);
+        return {this->iterator_at(index), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& key) {
+        return insert<const value_type&>(key);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& key) {
+        return insert<value_type>(std::move(key));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        if constexpr(std::forward_iterator<InputIt>) {
+            this->reserve(this->size() + static_cast<size_type>(std::distance(first, last)));
+        }
+        for(; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    template <typename K>
+        requires lookup_with<K>
+    const_iterator find(const K& key) const {
+        return base::find(key);
+    }
+
+    template <typename K>
+        requires lookup_with<K>
+    size_type count(const K& key) const {
+        return this->count_of(key);
+    }
+
+    const_iterator erase(const_iterator pos) {
+        return base::erase(pos);
+    }
+
+    template <typename K>
+        requires lookup_with<K> && (!std::is_convertible_v<K, const_iterator>)
+    size_type erase(const K& key) {
+        return this->erase_key(key);
+    }
+
+    friend bool operator==(const flat_hash_set& lhs, const flat_hash_set& rhs) {
+        if(lhs.size() != rhs.size()) {
+            return false;
+        }
+        for(const auto& key: lhs) {
+            if(!rhs.contains(key)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // namespace kota
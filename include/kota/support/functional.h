@@ -1,11 +1,14 @@
 #pragma once
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <new>
 #include <type_traits>
 #include <utility>
 
+#include "kota/support/memory.h"
+
 namespace kota {
 
 template <auto V, typename T = decltype(V)>
@@ -142,13 +145,16 @@ private:
     Erased erased;
 };
 
-template <typename Sign>
+/// An owning type-erased callable. A callable of at most `InlineBytes`
+/// that moves without throwing is stored inline; a larger one goes on the
+/// heap.
+template <typename Sign, std::size_t InlineBytes = 24>
 class function {
     static_assert(false, "Sign must be a function type");
 };
 
-template <typename R, typename... Args>
-class function<R(Args...)> {
+template <typename R, typename... Args, std::size_t InlineBytes>
+class function<R(Args...), InlineBytes> {
 public:
     using Sign = R(Args...);
 
@@ -159,9 +165,13 @@ public:
 
     using Deleter = void(function*);
 
-    constexpr static size_t sbo_size = 24;
+    using Relocator = void(function* target, function* source);
+
+    constexpr static size_t sbo_size = InlineBytes;
     constexpr static size_t sbo_align = alignof(std::max_align_t);
 
+    static_assert(sbo_size >= sizeof(Erased), "the inline buffer must hold a pointer");
+
     using Storage = union {
         alignas(sbo_align) std::byte sbo[sbo_size];
         Erased erased;
@@ -170,16 +180,23 @@ public:
     struct vtable {
         R (*proxy)(function*, Args&...);
         Deleter* deleter;
+        /// Null when the storage bytes can simply be copied.
+        Relocator* relocate = nullptr;
     };
 
     template <typename T>
-    constexpr static bool sbo_eligible = sizeof(T) <= sbo_size && alignof(T) <= sbo_align;
+    constexpr static bool sbo_eligible = sizeof(T) <= sbo_size && alignof(T) <= sbo_align &&
+                                         std::is_nothrow_move_constructible_v<T>;
 
     function(const function&) = delete;
 
     constexpr function(function&& other) noexcept {
         this->vptr = std::exchange(other.vptr, nullptr);
-        this->storage = std::exchange(other.storage, Storage{});
+        if(vptr && vptr->relocate) {
+            vptr->relocate(this, &other);
+        } else {
+            this->storage = std::exchange(other.storage, Storage{});
+        }
     }
 
     function& operator=(const function&) = delete;
@@ -233,10 +250,12 @@ private:
                     return (self->storage_as<ClassType>()->*MemFn::get())(
                         static_cast<Args&&>(args)...);
                 },
-                [](function* self) { self->storage_as<ClassType>()->~ClassType(); }};
-            Storage storage{};
-            new (storage.sbo) ClassType(std::forward<Class>(invocable));
-            return function(&vt, storage);
+                [](function* self) { self->storage_as<ClassType>()->~ClassType(); },
+                inline_relocator<ClassType>};
+            function result(nullptr);
+            new (result.storage.sbo) ClassType(std::forward<Class>(invocable));
+            result.vptr = &vt;
+            return result;
         }
     }
 
@@ -281,10 +300,12 @@ private:
                             auto& fn = *self->storage_as<ClassType>();
                             return invoke_ret<R>(fn, static_cast<Args&&>(args)...);
                         },
-                        [](function* self) { self->storage_as<ClassType>()->~ClassType(); }};
-                    Storage storage{};
-                    new (storage.sbo) ClassType(std::forward<Class>(invocable));
-                    return function(&vt, storage);
+                        [](function* self) { self->storage_as<ClassType>()->~ClassType(); },
+                        inline_relocator<ClassType>};
+                    function result(nullptr);
+                    new (result.storage.sbo) ClassType(std::forward<Class>(invocable));
+                    result.vptr = &vt;
+                    return result;
                 }
             } else {
                 constexpr static vtable vt = {
@@ -334,12 +355,25 @@ private:
         return std::launder(reinterpret_cast<Class*>(this->storage.sbo));
     }
 
+    template <typename Class>
+    static void relocate_inline(function* target, function* source) noexcept {
+        auto* from = source->storage_as<Class>();
+        new (target->storage.sbo) Class(std::move(*from));
+        from->~Class();
+    }
+
+    /// Inline callables that are not trivially relocatable, such as ones
+    /// holding a libstdc++ std::string, must be moved, not copied bytewise.
+    template <typename Class>
+    constexpr static Relocator* inline_relocator =
+        mem::is_trivially_relocatable_v<Class> ? nullptr : &relocate_inline<Class>;
+
     Storage storage;
     const vtable* vptr;
 };
 
-template <typename R, typename... Args>
-class function<R(Args...) const> {
+template <typename R, typename... Args, std::size_t InlineBytes>
+class function<R(Args...) const, InlineBytes> {
 public:
     using Sign = R(Args...);
 
@@ -350,9 +384,13 @@ public:
 
     using Deleter = void(function*);
 
-    constexpr static size_t sbo_size = 24;
+    using Relocator = void(function* target, function* source);
+
+    constexpr static size_t sbo_size = InlineBytes;
     constexpr static size_t sbo_align = alignof(std::max_align_t);
 
+    static_assert(sbo_size >= sizeof(Erased), "the inline buffer must hold a pointer");
+
     using Storage = union {
         alignas(sbo_align) std::byte sbo[sbo_size];
         Erased erased;
@@ -361,16 +399,23 @@ public:
     struct vtable {
         R (*proxy)(const function*, Args&...);
         Deleter* deleter;
+        /// Null when the storage bytes can simply be copied.
+        Relocator* relocate = nullptr;
     };
 
     template <typename T>
-    constexpr static bool sbo_eligible = sizeof(T) <= sbo_size && alignof(T) <= sbo_align;
+    constexpr static bool sbo_eligible = sizeof(T) <= sbo_size && alignof(T) <= sbo_align &&
+                                         std::is_nothrow_move_constructible_v<T>;
 
     function(const function&) = delete;
 
     constexpr function(function&& other) noexcept {
         this->vptr = std::exchange(other.vptr, nullptr);
-        this->storage = std::exchange(other.storage, Storage{});
+        if(vptr && vptr->relocate) {
+            vptr->relocate(this, &other);
+        } else {
+            this->storage = std::exchange(other.storage, Storage{});
+        }
     }
 
     function& operator=(const function&) = delete;
@@ -427,10 +472,12 @@ private:
                     return (self->storage_as<ClassType>()->*MemFn::get())(
                         static_cast<Args&&>(args)...);
                 },
-                [](function* self) { self->storage_as<ClassType>()->~ClassType(); }};
-            Storage storage{};
-            new (storage.sbo) ClassType(std::forward<Class>(invocable));
-            return function(&vt, storage);
+                [](function* self) { self->storage_as<ClassType>()->~ClassType(); },
+                inline_relocator<ClassType>};
+            function result(nullptr);
+            new (result.storage.sbo) ClassType(std::forward<Class>(invocable));
+            result.vptr = &vt;
+            return result;
         }
     }
 
@@ -476,10 +523,12 @@ private:
                             auto& fn = *self->storage_as<ClassType>();
                             return invoke_ret<R>(fn, static_cast<Args&&>(args)...);
                         },
-                        [](function* self) { self->storage_as<ClassType>()->~ClassType(); }};
-                    Storage storage{};
-                    new (storage.sbo) ClassType(std::forward<Class>(invocable));
-                    return function(&vt, storage);
+                        [](function* self) { self->storage_as<ClassType>()->~ClassType(); },
+                        inline_relocator<ClassType>};
+                    function result(nullptr);
+                    new (result.storage.sbo) ClassType(std::forward<Class>(invocable));
+                    result.vptr = &vt;
+                    return result;
                 }
             } else {
                 constexpr static vtable vt = {
@@ -526,10 +575,175 @@ private:
         return std::launder(reinterpret_cast<Class*>(this->storage.sbo));
     }
 
+    template <typename Class>
+    static void relocate_inline(function* target, function* source) noexcept {
+        auto* from = source->storage_as<Class>();
+        new (target->storage.sbo) Class(std::move(*from));
+        from->~Class();
+    }
+
+    /// Inline callables that are not trivially relocatable, such as ones
+    /// holding a libstdc++ std::string, must be moved, not copied bytewise.
+    template <typename Class>
+    constexpr static Relocator* inline_relocator =
+        mem::is_trivially_relocatable_v<Class> ? nullptr : &relocate_inline<Class>;
+
     Storage storage;
     const vtable* vptr;
 };
 
+/// A move-only callable that is called at most once. Calling it consumes
+/// the target: the callable is invoked as an rvalue and destroyed before
+/// the call returns, leaving the unique_function empty. Callbacks handed to
+/// another thread or loop run exactly once, so this frees their captures
+/// as soon as they have run and lets a larger `InlineBytes` keep typical
+/// captures off the heap.
+template <typename Sign, std::size_t InlineBytes = 24>
+class unique_function {
+    static_assert(false, "Sign must be a function type");
+};
+
+template <typename R, typename... Args, std::size_t InlineBytes>
+class unique_function<R(Args...), InlineBytes> {
+public:
+    constexpr static size_t sbo_size = InlineBytes;
+    constexpr static size_t sbo_align = alignof(std::max_align_t);
+
+    static_assert(sbo_size >= sizeof(void*), "the inline buffer must hold a pointer");
+
+    template <typename T>
+    constexpr static bool sbo_eligible = sizeof(T) <= sbo_size && alignof(T) <= sbo_align &&
+                                         std::is_nothrow_move_constructible_v<T>;
+
+    unique_function() noexcept = default;
+
+    unique_function(std::nullptr_t) noexcept {}
+
+    template <typename Class, typename ClassType = std::decay_t<Class>>
+        requires (!std::is_same_v<ClassType, unique_function>) &&
+                 std::is_invocable_r_v<R, ClassType&&, Args...>
+    unique_function(Class&& invocable) {
+        if constexpr(sbo_eligible<ClassType>) {
+            new (storage.sbo) ClassType(std::forward<Class>(invocable));
+            vptr = &ops<ClassType, true>::table;
+        } else {
+            storage.heap = new ClassType(std::forward<Class>(invocable));
+            vptr = &ops<ClassType, false>::table;
+        }
+    }
+
+    unique_function(const unique_function&) = delete;
+    unique_function& operator=(const unique_function&) = delete;
+
+    unique_function(unique_function&& other) noexcept {
+        take(other);
+    }
+
+    unique_function& operator=(unique_function&& other) noexcept {
+        if(this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~unique_function() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return vptr != nullptr;
+    }
+
+    /// Invokes and then destroys the target, even if the call throws.
+    template <typename... CallArgs>
+    R operator()(CallArgs&&... args) && {
+        static_assert(
+            requires(R (*fn)(Args...), CallArgs&&... call_args) {
+                fn(std::forward<CallArgs>(call_args)...);
+            },
+            "invocable object must be callable with the given arguments");
+        assert(vptr && "Attempting to call an empty unique_function");
+        return std::exchange(vptr, nullptr)->consume(this, args...);
+    }
+
+private:
+    struct vtable {
+        R (*consume)(unique_function*, Args&...);
+        /// Null for an inline callable that is trivially destructible.
+        void (*destroy)(unique_function*) noexcept;
+        /// Null when the storage bytes can simply be copied.
+        void (*relocate)(unique_function* target, unique_function* source) noexcept;
+    };
+
+    template <typename Class, bool Inline>
+    struct ops {
+        static Class* target(unique_function* self) noexcept {
+            if constexpr(Inline) {
+                return std::launder(reinterpret_cast<Class*>(self->storage.sbo));
+            } else {
+                return static_cast<Class*>(self->storage.heap);
+            }
+        }
+
+        static void destroy(unique_function* self) noexcept {
+            if constexpr(Inline) {
+                target(self)->~Class();
+            } else {
+                delete target(self);
+            }
+        }
+
+        static R consume(unique_function* self, Args&... args) {
+            struct cleanup {
+                unique_function* self;
+
+                ~cleanup() {
+                    destroy(self);
+                }
+            } guard{self};
+
+            return invoke_ret<R>(std::move(*target(self)), static_cast<Args&&>(args)...);
+        }
+
+        static void relocate(unique_function* to, unique_function* from) noexcept {
+            auto* source = target(from);
+            new (to->storage.sbo) Class(std::move(*source));
+            source->~Class();
+        }
+
+        constexpr static bool bytewise = !Inline || mem::is_trivially_relocatable_v<Class>;
+
+        constexpr inline static vtable table = {
+            &consume,
+            Inline && std::is_trivially_destructible_v<Class> ? nullptr : &destroy,
+            bytewise ? nullptr : &relocate,
+        };
+    };
+
+    void take(unique_function& other) noexcept {
+        vptr = std::exchange(other.vptr, nullptr);
+        if(vptr && vptr->relocate) {
+            vptr->relocate(this, &other);
+        } else {
+            std::memcpy(static_cast<void*>(&storage), &other.storage, sizeof(storage));
+        }
+    }
+
+    void reset() noexcept {
+        if(auto* table = std::exchange(vptr, nullptr); table && table->destroy) {
+            table->destroy(this);
+        }
+    }
+
+    union {
+        alignas(sbo_align) std::byte sbo[sbo_size];
+        void* heap;
+    } storage;
+
+    const vtable* vptr = nullptr;
+};
+
 template <auto MemFnPointer, typename Class, typename Mem = mem_fn<MemFnPointer>>
     requires std::is_lvalue_reference_v<Class&&>
 constexpr function_ref<typename Mem::FunctionType> bind_ref(Class&& obj) {
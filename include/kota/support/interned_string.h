@@ -0,0 +1,138 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "string_ref.h"
+
+namespace kota {
+
+class string_pool;
+
+/// A string kept once in a string_pool. Every interned_string a pool hands
+/// out for the same text points at the same characters, so a copy is two
+/// words and no allocation, and two strings from one pool compare equal by
+/// pointer. The characters live as long as the pool does.
+class interned_string {
+public:
+    /// The empty string, which needs no pool.
+    constexpr interned_string() noexcept = default;
+
+    [[nodiscard]] constexpr const char* data() const noexcept {
+        return text.data();
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return text.size();
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return text.empty();
+    }
+
+    [[nodiscard]] constexpr string_ref ref() const noexcept {
+        return string_ref(text);
+    }
+
+    constexpr operator std::string_view() const noexcept {
+        return text;
+    }
+
+    explicit operator std::string() const {
+        return std::string(text);
+    }
+
+    /// A pointer compare for strings from one pool; strings from different
+    /// pools fall back to comparing their text.
+    friend constexpr bool operator==(const interned_string& lhs,
+                                     const interned_string& rhs) noexcept {
+        return (lhs.text.data() == rhs.text.data() && lhs.text.size() == rhs.text.size()) ||
+               lhs.text == rhs.text;
+    }
+
+    friend constexpr bool operator==(const interned_string& lhs, std::string_view rhs) noexcept {
+        return lhs.text == rhs;
+    }
+
+    friend constexpr auto operator<=>(const interned_string& lhs,
+                                      const interned_string& rhs) noexcept {
+        return lhs.text <=> rhs.text;
+    }
+
+    friend constexpr auto operator<=>(const interned_string& lhs, std::string_view rhs) noexcept {
+        return lhs.text <=> rhs;
+    }
+
+private:
+    friend class string_pool;
+
+    constexpr explicit interned_string(std::string_view text) noexcept : text(text) {}
+
+    std::string_view text;
+};
+
+/// The set of texts interned_string values point into. A text is copied in
+/// the first time it is interned and stays until the pool is destroyed, so
+/// a pool suits values drawn from a bounded set, such as URIs, language
+/// ids and diagnostic sources, that recur across many messages. Interning
+/// is safe from several threads at once.
+class string_pool {
+public:
+    string_pool() = default;
+
+    string_pool(const string_pool&) = delete;
+    string_pool& operator=(const string_pool&) = delete;
+
+    /// The pooled copy of `text`, added if the pool does not have it yet.
+    interned_string intern(std::string_view text) {
+        if(text.empty()) {
+            return {};
+        }
+        std::lock_guard lock(mutex);
+        auto it = entries.find(text);
+        if(it == entries.end()) {
+            it = entries.emplace(text).first;
+        }
+        // The set's nodes never move, so neither do their characters.
+        return interned_string(*it);
+    }
+
+    /// Distinct texts in the pool.
+    std::size_t size() const {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+
+    /// The pool decoded interned_string values go into unless a field
+    /// names another with meta::interned.
+    static string_pool& global() {
+        static string_pool pool;
+        return pool;
+    }
+
+private:
+    struct text_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view text) const noexcept {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_set<std::string, text_hash, std::equal_to<>> entries;
+};
+
+}  // namespace kota
+
+template <>
+struct std::hash<kota::interned_string> {
+    std::size_t operator()(const kota::interned_string& value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
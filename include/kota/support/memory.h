@@ -1,9 +1,11 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iterator>
@@ -150,8 +152,33 @@ constexpr void check_range_length_overflow([[maybe_unused]] ItDiffT len) {
 #endif
 }
 
+/// Whether a T can be moved to new storage by copying its bytes and then
+/// forgetting the original, without running its move constructor or
+/// destructor. Trivially copyable types always can; a type that owns heap
+/// memory through a pointer it never aims at itself can opt in by
+/// specializing this. A type that points into its own storage, such as a
+/// container with an inline buffer, must not.
 template <typename T>
-constexpr inline bool is_trivially_relocatable_v = std::is_trivially_copyable_v<T>;
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<T>>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+#ifdef _LIBCPP_VERSION
+/// libc++ keeps a short string's characters in place of its pointer; the
+/// libstdc++ string points at its own buffer and stays opted out.
+template <>
+struct is_trivially_relocatable<std::string> : std::true_type {};
+#endif
+
+template <typename T>
+constexpr inline bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
 
 template <typename T, typename... Args>
 constexpr auto construct_at_impl(T* p,
@@ -483,9 +510,12 @@ constexpr T* uninitialized_relocate(Range&& range, T* dest) {
                  std::same_as<std::remove_cv_t<std::ranges::range_value_t<Range>>, T>) {
         const std::size_t count = range_length(range);
         if(count != 0 && !std::is_constant_evaluated()) {
-            std::memcpy(dest, std::ranges::data(range), count * sizeof(T));
+            std::memcpy(static_cast<void*>(dest),
+                        static_cast<const void*>(std::ranges::data(range)),
+                        count * sizeof(T));
         } else if(count != 0) {
-            uninitialized_copy<T>(std::forward<Range>(range), dest);
+            uninitialized_copy<T>(move_range(std::ranges::begin(range), std::ranges::end(range)),
+                                  dest);
         }
         return dest + static_cast<std::ptrdiff_t>(count);
     } else {
@@ -557,4 +587,299 @@ constexpr auto uninitialized_fill(Range&& range, const T& val) {
     }
 }
 
+/// Largest block slab_allocate() serves from a slab; larger requests go
+/// to operator new.
+constexpr inline std::size_t slab_max_size = 1024;
+
+/// Every slab block is aligned to at least this much.
+constexpr inline std::size_t slab_alignment = 16;
+
+namespace detail {
+
+constexpr inline std::size_t slab_bytes = std::size_t(64) * 1024;
+
+constexpr inline std::size_t slab_header_bytes = 64;
+
+constexpr inline std::size_t slab_class_count = 20;
+
+/// 16-byte steps to 128, then four classes per doubling up to 1024.
+constexpr std::size_t slab_class(std::size_t size) noexcept {
+    if(size <= 128) {
+        return size == 0 ? 0 : (size - 1) / 16;
+    }
+    if(size <= 256) {
+        return 8 + (size - 129) / 32;
+    }
+    if(size <= 512) {
+        return 12 + (size - 257) / 64;
+    }
+    return 16 + (size - 513) / 128;
+}
+
+constexpr std::size_t slab_class_size(std::size_t index) noexcept {
+    if(index < 8) {
+        return (index + 1) * 16;
+    }
+    if(index < 12) {
+        return 128 + (index - 7) * 32;
+    }
+    if(index < 16) {
+        return 256 + (index - 11) * 64;
+    }
+    return 512 + (index - 15) * 128;
+}
+
+static_assert(slab_class(slab_max_size) == slab_class_count - 1);
+static_assert(slab_class_size(slab_class_count - 1) == slab_max_size);
+
+class slab_cache;
+
+struct slab_block {
+    slab_block* next;
+};
+
+struct alignas(slab_header_bytes) slab_header {
+    slab_cache* owner;
+    slab_header* next;
+    std::size_t size_class;
+};
+
+static_assert(sizeof(slab_header) == slab_header_bytes);
+
+/// The thread-local cache behind slab_allocate(). Blocks are rounded to
+/// one of a few size classes and carved from 64 KiB slabs, each holding
+/// blocks of one class. A slab starts with a header naming the cache that
+/// carved it, found by masking a block's address, so a block freed on
+/// another thread goes back to that cache through a lock-free stack.
+///
+/// A cache outlives its thread: at thread exit it is parked, with its
+/// slabs, and the next thread to allocate adopts it. Memory is kept for
+/// reuse rather than returned to the system.
+class slab_cache {
+public:
+    /// The calling thread's cache, adopting a parked one or making one on
+    /// first use.
+    static slab_cache& local() {
+        auto& slot = local_slot();
+        if(!slot.cache) {
+            slot.cache = adopt();
+        }
+        return *slot.cache;
+    }
+
+    /// The calling thread's cache, or null if it has not allocated yet.
+    static slab_cache* local_if_any() noexcept {
+        return local_slot().cache;
+    }
+
+    void* allocate(std::size_t index) {
+        auto& bin = bins[index];
+        if(!bin.free && bin.bump == bin.end) {
+            collect_remote();
+            if(!bin.free) {
+                add_slab(index);
+            }
+        }
+        if(auto* block = bin.free) {
+            bin.free = block->next;
+            return block;
+        }
+        auto* block = bin.bump;
+        bin.bump += slab_class_size(index);
+        return block;
+    }
+
+    void deallocate(void* ptr, std::size_t index) noexcept {
+        auto& bin = bins[index];
+        bin.free = ::new(ptr) slab_block{bin.free};
+    }
+
+    /// Hands `ptr` back from a thread that does not own this cache.
+    void deallocate_remote(void* ptr) noexcept {
+        auto* block = ::new(ptr) slab_block{remote.load(std::memory_order_relaxed)};
+        while(!remote.compare_exchange_weak(block->next,
+                                            block,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+    }
+
+    static slab_header* header_of(void* ptr) noexcept {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return reinterpret_cast<slab_header*>(address & ~(slab_bytes - 1));
+    }
+
+private:
+    struct bin {
+        slab_block* free = nullptr;
+        char* bump = nullptr;
+        char* end = nullptr;
+    };
+
+    /// Parks the cache when its thread exits.
+    struct slot {
+        slab_cache* cache = nullptr;
+
+        ~slot() {
+            if(cache) {
+                park(std::exchange(cache, nullptr));
+            }
+        }
+    };
+
+    /// Parked caches, as an intrusive stack behind a spin lock. The list is
+    /// never destroyed, so a thread exiting late can still park its cache.
+    struct registry {
+        std::atomic_flag lock;
+        slab_cache* parked = nullptr;
+    };
+
+    static slot& local_slot() noexcept {
+        thread_local slot current;
+        return current;
+    }
+
+    static registry& parked_caches() noexcept {
+        static auto* caches = new registry();
+        return *caches;
+    }
+
+    static slab_cache* adopt() {
+        auto& caches = parked_caches();
+        while(caches.lock.test_and_set(std::memory_order_acquire)) {}
+        auto* cache = caches.parked;
+        if(cache) {
+            caches.parked = cache->next_parked;
+        }
+        caches.lock.clear(std::memory_order_release);
+        return cache ? cache : new slab_cache();
+    }
+
+    static void park(slab_cache* cache) noexcept {
+        auto& caches = parked_caches();
+        while(caches.lock.test_and_set(std::memory_order_acquire)) {}
+        cache->next_parked = caches.parked;
+        caches.parked = cache;
+        caches.lock.clear(std::memory_order_release);
+    }
+
+    /// Files the blocks other threads have handed back under their classes.
+    void collect_remote() noexcept {
+        auto* block = remote.exchange(nullptr, std::memory_order_acquire);
+        while(block) {
+            auto* next = block->next;
+            deallocate(block, header_of(block)->size_class);
+            block = next;
+        }
+    }
+
+    void add_slab(std::size_t index) {
+        auto* memory = static_cast<char*>(::operator new(slab_bytes, std::align_val_t(slab_bytes)));
+        slabs = ::new(memory) slab_header{this, slabs, index};
+
+        const auto block = slab_class_size(index);
+        auto& bin = bins[index];
+        bin.bump = memory + slab_header_bytes;
+        bin.end = bin.bump + (slab_bytes - slab_header_bytes) / block * block;
+    }
+
+    bin bins[slab_class_count];
+    std::atomic<slab_block*> remote{nullptr};
+    slab_header* slabs = nullptr;
+    slab_cache* next_parked = nullptr;
+};
+
+}  // namespace detail
+
+/// The size slab_allocate() actually reserves for `size` bytes.
+constexpr std::size_t slab_block_size(std::size_t size) noexcept {
+    return size > slab_max_size ? size : detail::slab_class_size(detail::slab_class(size));
+}
+
+/// Allocates `size` bytes from the calling thread's slab cache, or from
+/// operator new above slab_max_size.
+[[nodiscard]] inline void* slab_allocate(std::size_t size) {
+    if(size > slab_max_size) {
+        return ::operator new(size);
+    }
+    return detail::slab_cache::local().allocate(detail::slab_class(size));
+}
+
+/// Frees a block from slab_allocate(); `size` must be the size it was
+/// allocated with. Any thread may free a block.
+inline void slab_deallocate(void* ptr, std::size_t size) noexcept {
+    if(ptr == nullptr) {
+        return;
+    }
+    if(size > slab_max_size) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    auto* header = detail::slab_cache::header_of(ptr);
+    assert(header->size_class == detail::slab_class(size) && "slab block freed with wrong size");
+    if(header->owner == detail::slab_cache::local_if_any()) {
+        header->owner->deallocate(ptr, header->size_class);
+    } else {
+        header->owner->deallocate_remote(ptr);
+    }
+}
+
+/// Creates and destroys T objects in slab blocks. The pool has no state of
+/// its own: objects of one size share the calling thread's slab cache, and
+/// an object may be destroyed on any thread.
+template <typename T>
+class object_pool {
+    static_assert(alignof(T) <= slab_alignment, "object_pool does not over-align");
+
+public:
+    template <typename... Args>
+    [[nodiscard]] static T* create(Args&&... args) {
+        void* storage = slab_allocate(sizeof(T));
+        KOTA_TRY {
+            return ::new(storage) T(std::forward<Args>(args)...);
+        }
+        KOTA_CATCH_ALL() {
+            slab_deallocate(storage, sizeof(T));
+            KOTA_RETHROW();
+        }
+    }
+
+    static void destroy(T* object) noexcept {
+        if(object) {
+            object->~T();
+            slab_deallocate(object, sizeof(T));
+        }
+    }
+};
+
+/// A standard allocator over slab_allocate(), for containers and for the
+/// Alloc parameter of mem::allocate().
+template <typename T>
+struct slab_allocator {
+    static_assert(alignof(T) <= slab_alignment, "slab_allocator does not over-align");
+
+    using value_type = T;
+
+    slab_allocator() noexcept = default;
+
+    template <typename U>
+    slab_allocator(const slab_allocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count) {
+        if(count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            KOTA_THROW(std::bad_array_new_length());
+        }
+        return static_cast<T*>(slab_allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* data, std::size_t count) noexcept {
+        slab_deallocate(data, count * sizeof(T));
+    }
+
+    template <typename U>
+    friend bool operator==(const slab_allocator&, const slab_allocator<U>&) noexcept {
+        return true;
+    }
+};
+
 }  // namespace kota::mem
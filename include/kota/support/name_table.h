@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "fixed_string.h"
+
+namespace kota {
+
+/// A name kept in name_table::global(), as four bytes. Trace events and
+/// counters can store one in place of a string and turn it back into text
+/// only when they are exported. The default id is the empty name.
+class name_id {
+public:
+    constexpr name_id() noexcept = default;
+
+    constexpr explicit name_id(std::uint32_t value) noexcept : id(value) {}
+
+    constexpr std::uint32_t value() const noexcept {
+        return id;
+    }
+
+    constexpr bool empty() const noexcept {
+        return id == 0;
+    }
+
+    /// The text of the name, valid for the rest of the program.
+    std::string_view view() const noexcept;
+
+    friend constexpr bool operator==(name_id lhs, name_id rhs) noexcept = default;
+
+private:
+    std::uint32_t id = 0;
+};
+
+/// Deduplicated names, each copied once into pages that never move and
+/// numbered densely from 1. Interning takes a lock; looking an id up does
+/// not, since entries are kept in fixed-size segments that are published
+/// once and never reallocated.
+class name_table {
+public:
+    name_table() = default;
+
+    name_table(const name_table&) = delete;
+    name_table& operator=(const name_table&) = delete;
+
+    ~name_table() {
+        for(auto& segment: segments) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// The table static_name() and view() use. It is never destroyed, so
+    /// its ids stay readable while other statics are torn down.
+    static name_table& global() {
+        static auto* table = new name_table();
+        return *table;
+    }
+
+    /// The id of `text`, added with the next id if the table lacks it.
+    name_id intern(std::string_view text) {
+        if(text.empty()) {
+            return {};
+        }
+        std::lock_guard lock(mutex);
+        if(auto it = index.find(text); it != index.end()) {
+            return name_id(it->second);
+        }
+
+        const auto id = static_cast<std::uint32_t>(index.size() + 1);
+        assert(id <= segment_size * segment_count && "name table is full");
+        const auto slot = id - 1;
+        auto* segment = segments[slot / segment_size].load(std::memory_order_relaxed);
+        if(!segment) {
+            segment = new entry[segment_size];
+            segments[slot / segment_size].store(segment, std::memory_order_release);
+        }
+
+        const char* data = store(text);
+        segment[slot % segment_size] = {data, static_cast<std::uint32_t>(text.size())};
+        count.store(id, std::memory_order_release);
+        index.emplace(std::string_view(data, text.size()), id);
+        return name_id(id);
+    }
+
+    /// The id of `text` if it was interned before; never adds it.
+    std::optional<name_id> find(std::string_view text) const {
+        if(text.empty()) {
+            return name_id();
+        }
+        std::lock_guard lock(mutex);
+        if(auto it = index.find(text); it != index.end()) {
+            return name_id(it->second);
+        }
+        return std::nullopt;
+    }
+
+    /// The text of `id`, which must come from this table.
+    std::string_view view(name_id id) const noexcept {
+        if(id.empty()) {
+            return {};
+        }
+        assert(id.value() <= count.load(std::memory_order_acquire) && "unknown name id");
+        const auto slot = id.value() - 1;
+        const auto* segment = segments[slot / segment_size].load(std::memory_order_acquire);
+        const auto& name = segment[slot % segment_size];
+        return {name.data, name.size};
+    }
+
+    /// Names in the table, the empty name not counted.
+    std::size_t size() const noexcept {
+        return count.load(std::memory_order_acquire);
+    }
+
+private:
+    struct entry {
+        const char* data = nullptr;
+        std::uint32_t size = 0;
+    };
+
+    struct text_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view text) const noexcept {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    constexpr static std::size_t segment_size = 4096;
+    constexpr static std::size_t segment_count = 1024;
+    constexpr static std::size_t page_size = 64 * 1024;
+
+    /// Copies `text` into the current page, starting a new one when it is
+    /// full. Text longer than a page gets a page of its own.
+    const char* store(std::string_view text) {
+        if(text.size() > page_size - page_used) {
+            pages.push_back(std::make_unique<char[]>(std::max(text.size(), page_size)));
+            page_used = 0;
+        }
+        char* data = pages.back().get() + page_used;
+        std::memcpy(data, text.data(), text.size());
+        page_used += text.size();
+        return data;
+    }
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string_view, std::uint32_t, text_hash, std::equal_to<>> index;
+    std::vector<std::unique_ptr<char[]>> pages;
+    std::size_t page_used = page_size;
+    std::atomic<entry*> segments[segment_count] = {};
+    std::atomic<std::uint32_t> count{0};
+};
+
+inline std::string_view name_id::view() const noexcept {
+    return name_table::global().view(*this);
+}
+
+/// The global id of `Name`, interned on first use and then read from a
+/// function-local static, so a hot path pays one guard check.
+template <fixed_string Name>
+name_id static_name() {
+    static const name_id id = name_table::global().intern(std::string_view(Name));
+    return id;
+}
+
+}  // namespace kota
@@ -95,19 +95,19 @@ constexpr std::string snake_to_upper(std::string_view text) {
 namespace rename_policy {
 
 struct identity {
-    std::string operator()(bool, std::string_view value) const {
+    constexpr std::string operator()(bool, std::string_view value) const {
         return std::string(value);
     }
 };
 
 struct lower_snake {
-    std::string operator()(bool, std::string_view value) const {
+    constexpr std::string operator()(bool, std::string_view value) const {
         return normalize_to_lower_snake(value);
     }
 };
 
 struct lower_camel {
-    std::string operator()(bool is_serialize, std::string_view value) const {
+    constexpr std::string operator()(bool is_serialize, std::string_view value) const {
         if(is_serialize) {
             return snake_to_camel(value, false);
         }
@@ -116,7 +116,7 @@ struct lower_camel {
 };
 
 struct upper_camel {
-    std::string operator()(bool is_serialize, std::string_view value) const {
+    constexpr std::string operator()(bool is_serialize, std::string_view value) const {
         if(is_serialize) {
             return snake_to_camel(value, true);
         }
@@ -125,7 +125,7 @@ struct upper_camel {
 };
 
 struct upper_snake {
-    std::string operator()(bool is_serialize, std::string_view value) const {
+    constexpr std::string operator()(bool is_serialize, std::string_view value) const {
         if(is_serialize) {
             return snake_to_upper(value);
         }
@@ -0,0 +1,567 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace kota {
+
+/// Counts kept for a run of UTF-8 text. A code point is counted at its
+/// lead byte, so the counts of two runs add up to the counts of the two
+/// joined, wherever the split falls. For well-formed UTF-8 they match the
+/// code points of the text; a stray continuation byte counts as nothing.
+struct rope_metrics {
+    std::size_t bytes = 0;
+    std::size_t newlines = 0;
+
+    /// UTF-16 code units: two for a code point past U+FFFF, one otherwise.
+    std::size_t utf16 = 0;
+
+    std::size_t codepoints = 0;
+
+    constexpr static rope_metrics of(std::string_view text) noexcept {
+        rope_metrics result;
+        result.bytes = text.size();
+        for(char ch: text) {
+            const auto byte = static_cast<unsigned char>(ch);
+            const std::size_t lead = (byte & 0xC0u) != 0x80u;
+            result.newlines += byte == '\n';
+            result.codepoints += lead;
+            result.utf16 += lead + (byte >= 0xF0u && byte < 0xF5u);
+        }
+        return result;
+    }
+
+    constexpr rope_metrics& operator+=(const rope_metrics& other) noexcept {
+        bytes += other.bytes;
+        newlines += other.newlines;
+        utf16 += other.utf16;
+        codepoints += other.codepoints;
+        return *this;
+    }
+
+    friend constexpr rope_metrics operator+(rope_metrics lhs, const rope_metrics& rhs) noexcept {
+        return lhs += rhs;
+    }
+
+    friend constexpr bool operator==(const rope_metrics&, const rope_metrics&) = default;
+};
+
+/// Text kept as a balanced tree of chunks of at most a few kilobytes, each
+/// node caching the metrics of its subtree. Edits, and finding an offset by
+/// line or by UTF-16 or code point count, take O(log n) plus the size of a
+/// chunk, so a large document can be edited without copying all of it.
+///
+/// The tree is a treap split and joined at byte offsets. An edit that fits
+/// in the chunk it falls in is made in that chunk; any other splits the
+/// tree around the edited range and joins the new text in between.
+///
+/// Nodes are shared between copies and never changed while shared: a copy
+/// takes O(1), and an edit copies only the nodes on the paths it changes.
+/// The counts are atomic, so a copy handed to another thread can be read
+/// there while the original goes on being edited.
+class rope {
+public:
+    /// Chunks are cut to about this size when text is added.
+    constexpr static std::size_t chunk_size = 1024;
+
+    /// An edit within one chunk is made in place while the chunk stays at
+    /// or below this size.
+    constexpr static std::size_t max_chunk_size = 2 * chunk_size;
+
+    rope() noexcept = default;
+
+    explicit rope(std::string_view text) {
+        root = build(text);
+    }
+
+    rope(const rope& other) = default;
+
+    rope(rope&& other) noexcept = default;
+
+    rope& operator=(const rope& other) = default;
+
+    rope& operator=(rope&& other) noexcept = default;
+
+    ~rope() = default;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return total(root.get()).bytes;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return root == nullptr;
+    }
+
+    /// The metrics of the whole text.
+    [[nodiscard]] rope_metrics metrics() const noexcept {
+        return total(root.get());
+    }
+
+    /// Lines in the text, counting the one after the last newline.
+    [[nodiscard]] std::size_t line_count() const noexcept {
+        return total(root.get()).newlines + 1;
+    }
+
+    void assign(std::string_view text) {
+        root = build(text);
+    }
+
+    void clear() noexcept {
+        root.reset();
+    }
+
+    /// Replaces bytes [begin, end) with `text`.
+    void replace(std::size_t begin, std::size_t end, std::string_view text) {
+        assert(begin <= end && "replaced range reversed");
+        assert(end <= size() && "replaced range out of range");
+        if(replace_in_chunk(begin, end, text)) {
+            return;
+        }
+
+        auto [before, rest] = split(std::move(root), begin);
+        auto after = split(std::move(rest), end - begin).second;
+        root = join(join(std::move(before), build(text)), std::move(after));
+    }
+
+    void insert(std::size_t offset, std::string_view text) {
+        replace(offset, offset, text);
+    }
+
+    void erase(std::size_t begin, std::size_t end) {
+        replace(begin, end, {});
+    }
+
+    /// The byte at `offset`, found in O(log n).
+    [[nodiscard]] char at(std::size_t offset) const {
+        assert(offset < size() && "offset out of range");
+        const node* current = root.get();
+        while(true) {
+            const auto left = total(current->left.get()).bytes;
+            if(offset < left) {
+                current = current->left.get();
+            } else if(offset - left < current->text.size()) {
+                return current->text[offset - left];
+            } else {
+                offset -= left + current->text.size();
+                current = current->right.get();
+            }
+        }
+    }
+
+    /// Calls `fn` with each chunk of bytes [begin, end), in order.
+    template <typename Fn>
+    void for_each_chunk(std::size_t begin, std::size_t end, Fn&& fn) const {
+        assert(begin <= end && end <= size() && "chunk range out of range");
+        visit(root.get(), 0, begin, end, fn);
+    }
+
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) const {
+        visit(root.get(), 0, 0, size(), fn);
+    }
+
+    /// Copies out bytes [offset, offset + count), clamped to the text.
+    [[nodiscard]] std::string substr(std::size_t offset,
+                                     std::size_t count = std::string::npos) const {
+        assert(offset <= size() && "offset out of range");
+        const auto end = offset + std::min(count, size() - offset);
+        std::string result;
+        result.reserve(end - offset);
+        for_each_chunk(offset, end, [&](std::string_view chunk) { result.append(chunk); });
+        return result;
+    }
+
+    [[nodiscard]] std::string str() const {
+        return substr(0);
+    }
+
+    /// The metrics of bytes [0, offset).
+    [[nodiscard]] rope_metrics measure(std::size_t offset) const {
+        assert(offset <= size() && "offset out of range");
+        rope_metrics result;
+        const node* current = root.get();
+        while(current) {
+            const auto& left = total(current->left.get());
+            if(offset <= left.bytes) {
+                current = current->left.get();
+                continue;
+            }
+            result += left;
+            offset -= left.bytes;
+            if(offset <= current->text.size()) {
+                result += rope_metrics::of(std::string_view(current->text).substr(0, offset));
+                break;
+            }
+            result += current->own;
+            offset -= current->text.size();
+            current = current->right.get();
+        }
+        return result;
+    }
+
+    /// The zero-based line `offset` is on.
+    [[nodiscard]] std::size_t line_of(std::size_t offset) const {
+        return measure(offset).newlines;
+    }
+
+    /// The byte offset `line` starts at; `line` must be below line_count().
+    [[nodiscard]] std::size_t line_start(std::size_t line) const {
+        assert(line < line_count() && "line out of range");
+        if(line == 0) {
+            return 0;
+        }
+
+        // Find the line-th newline; the line starts just past it.
+        std::size_t offset = 0;
+        const node* current = root.get();
+        while(true) {
+            const auto& left = total(current->left.get());
+            if(line <= left.newlines) {
+                current = current->left.get();
+                continue;
+            }
+            line -= left.newlines;
+            offset += left.bytes;
+            if(line <= current->own.newlines) {
+                for(std::size_t index = 0;; ++index) {
+                    if(current->text[index] == '\n' && --line == 0) {
+                        return offset + index + 1;
+                    }
+                }
+            }
+            line -= current->own.newlines;
+            offset += current->text.size();
+            current = current->right.get();
+        }
+    }
+
+    /// The last byte offset with at most `count` units of `unit` before it:
+    /// the offset `count` code points or UTF-16 units into the text, or
+    /// the start of the code point that straddles it, whose measure then
+    /// falls short of `count`.
+    [[nodiscard]] std::size_t seek(std::size_t rope_metrics::*unit, std::size_t count) const {
+        std::size_t offset = 0;
+        const node* current = root.get();
+        while(current) {
+            const auto& left = total(current->left.get());
+            if(left.*unit > count) {
+                current = current->left.get();
+                continue;
+            }
+            count -= left.*unit;
+            offset += left.bytes;
+            if(current->own.*unit > count) {
+                const std::string_view text = current->text;
+                for(std::size_t index = 0;; ++index) {
+                    const auto step = rope_metrics::of(text.substr(index, 1)).*unit;
+                    if(step > count) {
+                        return offset + index;
+                    }
+                    count -= step;
+                }
+            }
+            count -= current->own.*unit;
+            offset += current->text.size();
+            current = current->right.get();
+        }
+        return offset;
+    }
+
+    friend bool operator==(const rope& lhs, std::string_view rhs) {
+        if(lhs.size() != rhs.size()) {
+            return false;
+        }
+        bool equal = true;
+        lhs.for_each_chunk([&](std::string_view chunk) {
+            equal = equal && rhs.starts_with(chunk);
+            rhs.remove_prefix(chunk.size());
+        });
+        return equal;
+    }
+
+    friend bool operator==(const rope& lhs, const rope& rhs) {
+        return lhs.size() == rhs.size() && lhs == std::string_view(rhs.str());
+    }
+
+private:
+    struct node;
+
+    /// An owning pointer to a node, counting every rope and parent node
+    /// that reaches it.
+    class node_ptr {
+    public:
+        node_ptr() noexcept = default;
+
+        node_ptr(std::nullptr_t) noexcept {}
+
+        /// Adopts a node just created with its count at one.
+        explicit node_ptr(node* adopted) noexcept : pointer(adopted) {}
+
+        node_ptr(const node_ptr& other) noexcept : pointer(other.pointer) {
+            if(pointer) {
+                pointer->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        node_ptr(node_ptr&& other) noexcept : pointer(std::exchange(other.pointer, nullptr)) {}
+
+        node_ptr& operator=(node_ptr other) noexcept {
+            std::swap(pointer, other.pointer);
+            return *this;
+        }
+
+        ~node_ptr() {
+            if(pointer && pointer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete pointer;
+            }
+        }
+
+        [[nodiscard]] node* get() const noexcept {
+            return pointer;
+        }
+
+        node& operator*() const noexcept {
+            return *pointer;
+        }
+
+        node* operator->() const noexcept {
+            return pointer;
+        }
+
+        explicit operator bool() const noexcept {
+            return pointer != nullptr;
+        }
+
+        friend bool operator==(const node_ptr& lhs, std::nullptr_t) noexcept {
+            return lhs.pointer == nullptr;
+        }
+
+        /// Whether nothing else reaches the node. The acquire pairs with
+        /// the release of the last other owner letting go, so its reads of
+        /// the node are done before this rope changes it.
+        [[nodiscard]] bool unique() const noexcept {
+            return pointer->refs.load(std::memory_order_acquire) == 1;
+        }
+
+        void reset() noexcept {
+            node_ptr().swap(*this);
+        }
+
+        void swap(node_ptr& other) noexcept {
+            std::swap(pointer, other.pointer);
+        }
+
+    private:
+        node* pointer = nullptr;
+    };
+
+    struct node {
+        std::string text;
+        rope_metrics own;
+        rope_metrics subtree;
+        std::uint32_t priority = 0;
+        std::atomic<std::uint32_t> refs{1};
+        node_ptr left;
+        node_ptr right;
+    };
+
+    static const rope_metrics& total(const node* tree) noexcept {
+        constexpr static rope_metrics none{};
+        return tree ? tree->subtree : none;
+    }
+
+    static void update(node& tree) noexcept {
+        tree.subtree = total(tree.left.get()) + tree.own + total(tree.right.get());
+    }
+
+    std::uint32_t next_priority() noexcept {
+        // xorshift32; the priorities only need to look random to the edits.
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    node_ptr make_node(std::string_view text) {
+        node_ptr created(new node());
+        created->text.assign(text);
+        created->own = rope_metrics::of(text);
+        created->subtree = created->own;
+        created->priority = next_priority();
+        return created;
+    }
+
+    /// Makes `tree` safe to change: a node another rope can still reach is
+    /// replaced by a copy sharing its children. Callers own a path from the
+    /// root down, so a node held only by an owned parent is this rope's.
+    static void own(node_ptr& tree) {
+        if(!tree || tree.unique()) {
+            return;
+        }
+        node_ptr copy(new node());
+        copy->text = tree->text;
+        copy->own = tree->own;
+        copy->subtree = tree->subtree;
+        copy->priority = tree->priority;
+        copy->left = tree->left;
+        copy->right = tree->right;
+        tree = std::move(copy);
+    }
+
+    /// Splits `tree` into bytes [0, offset) and the rest, cutting a chunk
+    /// in two if the offset falls inside it.
+    std::pair<node_ptr, node_ptr> split(node_ptr tree, std::size_t offset) {
+        if(!tree) {
+            return {};
+        }
+        own(tree);
+        const auto left = total(tree->left.get()).bytes;
+        if(offset <= left) {
+            auto [before, after] = split(std::move(tree->left), offset);
+            tree->left = std::move(after);
+            update(*tree);
+            return {std::move(before), std::move(tree)};
+        }
+
+        offset -= left;
+        if(offset >= tree->text.size()) {
+            auto [before, after] = split(std::move(tree->right), offset - tree->text.size());
+            tree->right = std::move(before);
+            update(*tree);
+            return {std::move(tree), std::move(after)};
+        }
+
+        auto tail = make_node(std::string_view(tree->text).substr(offset));
+        tree->text.resize(offset);
+        tree->own = rope_metrics::of(tree->text);
+        auto after = join(std::move(tail), std::move(tree->right));
+        update(*tree);
+        return {std::move(tree), std::move(after)};
+    }
+
+    static node_ptr join(node_ptr lhs, node_ptr rhs) {
+        if(!lhs) {
+            return rhs;
+        }
+        if(!rhs) {
+            return lhs;
+        }
+        if(lhs->priority > rhs->priority) {
+            own(lhs);
+            lhs->right = join(std::move(lhs->right), std::move(rhs));
+            update(*lhs);
+            return lhs;
+        }
+        own(rhs);
+        rhs->left = join(std::move(lhs), std::move(rhs->left));
+        update(*rhs);
+        return rhs;
+    }
+
+    /// A tree of `text` cut into chunks, never inside a code point.
+    node_ptr build(std::string_view text) {
+        node_ptr tree;
+        while(!text.empty()) {
+            auto cut = std::min(text.size(), chunk_size);
+            while(cut < text.size() && cut > chunk_size - 4 &&
+                  (static_cast<unsigned char>(text[cut]) & 0xC0u) == 0x80u) {
+                --cut;
+            }
+            tree = join(std::move(tree), make_node(text.substr(0, cut)));
+            text.remove_prefix(cut);
+        }
+        return tree;
+    }
+
+    /// Makes the edit inside the one chunk holding [begin, end], if there
+    /// is one and it stays within bounds, updating the counts above it.
+    bool replace_in_chunk(std::size_t begin, std::size_t end, std::string_view text) {
+        // Find the chunk first, so a failed attempt copies no shared nodes.
+        std::vector<bool> went_right;
+        const node* found = root.get();
+        while(found) {
+            const auto left = total(found->left.get()).bytes;
+            if(begin < left) {
+                if(end > left) {
+                    return false;
+                }
+                went_right.push_back(false);
+                found = found->left.get();
+                continue;
+            }
+            begin -= left;
+            end -= left;
+            if(end <= found->text.size()) {
+                break;
+            }
+            if(begin < found->text.size()) {
+                return false;
+            }
+            begin -= found->text.size();
+            end -= found->text.size();
+            went_right.push_back(true);
+            found = found->right.get();
+        }
+
+        if(!found) {
+            return false;
+        }
+        const auto resized = found->text.size() - (end - begin) + text.size();
+        if(resized == 0 || resized > max_chunk_size) {
+            return false;
+        }
+
+        std::vector<node*> path;
+        node_ptr* slot = &root;
+        own(*slot);
+        path.push_back(slot->get());
+        for(bool right: went_right) {
+            slot = right ? &path.back()->right : &path.back()->left;
+            own(*slot);
+            path.push_back(slot->get());
+        }
+
+        node* current = path.back();
+        current->text.replace(begin, end - begin, text);
+        current->own = rope_metrics::of(current->text);
+        for(auto it = path.rbegin(); it != path.rend(); ++it) {
+            update(**it);
+        }
+        return true;
+    }
+
+    template <typename Fn>
+    static void visit(const node* tree,
+                      std::size_t base,
+                      std::size_t begin,
+                      std::size_t end,
+                      Fn& fn) {
+        if(!tree || begin >= base + tree->subtree.bytes || end <= base) {
+            return;
+        }
+        const auto left = total(tree->left.get()).bytes;
+        visit(tree->left.get(), base, begin, end, fn);
+
+        const auto first = base + left;
+        const auto last = first + tree->text.size();
+        if(begin < last && end > first) {
+            const auto from = std::max(begin, first) - first;
+            const auto to = std::min(end, last) - first;
+            fn(std::string_view(tree->text).substr(from, to - from));
+        }
+        visit(tree->right.get(), last, begin, end, fn);
+    }
+
+    node_ptr root;
+    std::uint32_t seed = 0x9E3779B9u;
+};
+
+}  // namespace kota
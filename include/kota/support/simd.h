@@ -0,0 +1,475 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KOTA_SIMD_AVX2 1
+#define KOTA_SIMD_LOOKUP 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KOTA_SIMD_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define KOTA_SIMD_LOOKUP 1
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define KOTA_SIMD_NEON 1
+#define KOTA_SIMD_LOOKUP 1
+#endif
+
+#if defined(KOTA_SIMD_AVX2) || defined(KOTA_SIMD_SSE2) || defined(KOTA_SIMD_NEON)
+#define KOTA_SIMD_BATCH 1
+#endif
+
+/// Byte scanning kernels for text that is mostly uninteresting: finding a
+/// byte, a byte from a set or a substring, measuring an ASCII run and
+/// comparing without case. Each tests a register of bytes at a time with
+/// AVX2, SSE2 or NEON, whichever the target has, and finishes the tail one
+/// byte at a time; without any of them only the byte loop is left.
+///
+/// A search returns text.size() when it finds nothing, not npos.
+namespace kota::simd {
+
+/// A set of byte values, kept as a bitmap split by nibbles so that a whole
+/// register can be looked up at once with a byte shuffle.
+class byte_set {
+public:
+    constexpr byte_set() noexcept = default;
+
+    constexpr explicit byte_set(std::string_view bytes) noexcept {
+        for(char byte: bytes) {
+            insert(static_cast<unsigned char>(byte));
+        }
+    }
+
+    constexpr byte_set& insert(unsigned char byte) noexcept {
+        rows[byte >> 7][byte & 0x0F] |= static_cast<std::uint8_t>(1U << ((byte >> 4) & 0x07));
+        return *this;
+    }
+
+    /// Adds every byte from `first` to `last`, both included.
+    constexpr byte_set& insert_range(unsigned char first, unsigned char last) noexcept {
+        for(unsigned byte = first; byte <= last; ++byte) {
+            insert(static_cast<unsigned char>(byte));
+        }
+        return *this;
+    }
+
+    [[nodiscard]] constexpr bool contains(unsigned char byte) const noexcept {
+        return (rows[byte >> 7][byte & 0x0F] >> ((byte >> 4) & 0x07)) & 1U;
+    }
+
+    [[nodiscard]] constexpr byte_set operator~() const noexcept {
+        byte_set result;
+        for(std::size_t half = 0; half < 2; ++half) {
+            for(std::size_t row = 0; row < 16; ++row) {
+                result.rows[half][row] = static_cast<std::uint8_t>(~rows[half][row]);
+            }
+        }
+        return result;
+    }
+
+private:
+    friend std::size_t find_first_of(std::string_view, const byte_set&, std::size_t) noexcept;
+
+    /// rows[b >> 7][b & 15] holds bit (b >> 4) & 7 for each byte b in the set.
+    std::uint8_t rows[2][16] = {};
+};
+
+namespace detail {
+
+#if defined(KOTA_SIMD_AVX2)
+
+struct batch {
+    constexpr static std::size_t size = 32;
+
+    /// Bits mask() spends on each byte.
+    constexpr static int lane_bits = 1;
+
+    constexpr static std::uint64_t all_lanes = 0xFFFF'FFFFULL;
+
+    __m256i value;
+
+    static batch load(const char* data) noexcept {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))};
+    }
+
+    static batch splat(unsigned char byte) noexcept {
+        return {_mm256_set1_epi8(static_cast<char>(byte))};
+    }
+
+    /// Sixteen bytes repeated across the register, for lookup().
+    static batch table(const std::uint8_t* bytes) noexcept {
+        return {_mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)))};
+    }
+
+    batch eq(batch other) const noexcept {
+        return {_mm256_cmpeq_epi8(value, other.value)};
+    }
+
+    batch operator|(batch other) const noexcept {
+        return {_mm256_or_si256(value, other.value)};
+    }
+
+    batch operator&(batch other) const noexcept {
+        return {_mm256_and_si256(value, other.value)};
+    }
+
+    batch operator^(batch other) const noexcept {
+        return {_mm256_xor_si256(value, other.value)};
+    }
+
+    /// Lanes whose byte is between `low` and `high`, unsigned and inclusive.
+    batch in_range(unsigned char low, unsigned char high) const noexcept {
+        auto shifted = _mm256_sub_epi8(value, splat(low).value);
+        auto clamped = _mm256_min_epu8(shifted, splat(high - low).value);
+        return {_mm256_cmpeq_epi8(clamped, shifted)};
+    }
+
+    batch high_nibbles() const noexcept {
+        return {_mm256_and_si256(_mm256_srli_epi16(value, 4), splat(0x0F).value)};
+    }
+
+    /// table[index] for each lane, or zero where the index has its top bit.
+    static batch lookup(batch table, batch index) noexcept {
+        return {_mm256_shuffle_epi8(table.value, index.value)};
+    }
+
+    /// lane_bits bits for each lane of a comparison, lowest lane first.
+    std::uint64_t mask() const noexcept {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(value));
+    }
+};
+
+#elif defined(KOTA_SIMD_SSE2)
+
+struct batch {
+    constexpr static std::size_t size = 16;
+    constexpr static int lane_bits = 1;
+    constexpr static std::uint64_t all_lanes = 0xFFFFULL;
+
+    __m128i value;
+
+    static batch load(const char* data) noexcept {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))};
+    }
+
+    static batch splat(unsigned char byte) noexcept {
+        return {_mm_set1_epi8(static_cast<char>(byte))};
+    }
+
+    static batch table(const std::uint8_t* bytes) noexcept {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes))};
+    }
+
+    batch eq(batch other) const noexcept {
+        return {_mm_cmpeq_epi8(value, other.value)};
+    }
+
+    batch operator|(batch other) const noexcept {
+        return {_mm_or_si128(value, other.value)};
+    }
+
+    batch operator&(batch other) const noexcept {
+        return {_mm_and_si128(value, other.value)};
+    }
+
+    batch operator^(batch other) const noexcept {
+        return {_mm_xor_si128(value, other.value)};
+    }
+
+    batch in_range(unsigned char low, unsigned char high) const noexcept {
+        auto shifted = _mm_sub_epi8(value, splat(low).value);
+        auto clamped = _mm_min_epu8(shifted, splat(high - low).value);
+        return {_mm_cmpeq_epi8(clamped, shifted)};
+    }
+
+    batch high_nibbles() const noexcept {
+        return {_mm_and_si128(_mm_srli_epi16(value, 4), splat(0x0F).value)};
+    }
+
+#if defined(KOTA_SIMD_LOOKUP)
+    static batch lookup(batch table, batch index) noexcept {
+        return {_mm_shuffle_epi8(table.value, index.value)};
+    }
+#endif
+
+    std::uint64_t mask() const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(value));
+    }
+};
+
+#elif defined(KOTA_SIMD_NEON)
+
+struct batch {
+    constexpr static std::size_t size = 16;
+
+    /// NEON has no movemask; narrowing each 16-bit pair by four leaves a
+    /// nibble per byte.
+    constexpr static int lane_bits = 4;
+
+    constexpr static std::uint64_t all_lanes = ~0ULL;
+
+    uint8x16_t value;
+
+    static batch load(const char* data) noexcept {
+        return {vld1q_u8(reinterpret_cast<const std::uint8_t*>(data))};
+    }
+
+    static batch splat(unsigned char byte) noexcept {
+        return {vdupq_n_u8(byte)};
+    }
+
+    static batch table(const std::uint8_t* bytes) noexcept {
+        return {vld1q_u8(bytes)};
+    }
+
+    batch eq(batch other) const noexcept {
+        return {vceqq_u8(value, other.value)};
+    }
+
+    batch operator|(batch other) const noexcept {
+        return {vorrq_u8(value, other.value)};
+    }
+
+    batch operator&(batch other) const noexcept {
+        return {vandq_u8(value, other.value)};
+    }
+
+    batch operator^(batch other) const noexcept {
+        return {veorq_u8(value, other.value)};
+    }
+
+    batch in_range(unsigned char low, unsigned char high) const noexcept {
+        return {vcleq_u8(vsubq_u8(value, vdupq_n_u8(low)), vdupq_n_u8(high - low))};
+    }
+
+    batch high_nibbles() const noexcept {
+        return {vshrq_n_u8(value, 4)};
+    }
+
+    /// Indices of sixteen or more give zero, which covers a set top bit.
+    static batch lookup(batch table, batch index) noexcept {
+        return {vqtbl1q_u8(table.value, index.value)};
+    }
+
+    std::uint64_t mask() const noexcept {
+        auto narrowed = vshrn_n_u16(vreinterpretq_u16_u8(value), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+};
+
+#endif
+
+#if defined(KOTA_SIMD_BATCH)
+
+/// Offset of the lowest lane set in a non-zero mask().
+inline std::size_t first_lane(std::uint64_t mask) noexcept {
+    return static_cast<std::size_t>(std::countr_zero(mask)) / batch::lane_bits;
+}
+
+/// The mask() with the lowest set lane cleared.
+inline std::uint64_t drop_lane(std::uint64_t mask) noexcept {
+    constexpr std::uint64_t lane = (std::uint64_t(1) << batch::lane_bits) - 1;
+    return mask & ~(lane << std::countr_zero(mask));
+}
+
+#endif
+
+constexpr char to_lower_ascii(char byte) noexcept {
+    return byte >= 'A' && byte <= 'Z' ? static_cast<char>(byte + ('a' - 'A')) : byte;
+}
+
+}  // namespace detail
+
+/// Index of the first `byte` at or after `from`.
+inline std::size_t find_byte(std::string_view text, char byte, std::size_t from = 0) noexcept {
+    std::size_t index = from;
+
+#if defined(KOTA_SIMD_BATCH)
+    using detail::batch;
+    const auto target = batch::splat(static_cast<unsigned char>(byte));
+    for(; index + batch::size <= text.size(); index += batch::size) {
+        if(auto hits = batch::load(text.data() + index).eq(target).mask()) {
+            return index + detail::first_lane(hits);
+        }
+    }
+#endif
+
+    for(; index < text.size(); ++index) {
+        if(text[index] == byte) {
+            return index;
+        }
+    }
+    return text.size();
+}
+
+/// Calls `callback(index)` for the index of every `byte` in `text`, in
+/// order. Dense matches cost a bit scan each rather than a new search.
+template <typename Callback>
+void for_each_byte(std::string_view text, char byte, Callback&& callback) {
+    std::size_t index = 0;
+
+#if defined(KOTA_SIMD_BATCH)
+    using detail::batch;
+    const auto target = batch::splat(static_cast<unsigned char>(byte));
+    for(; index + batch::size <= text.size(); index += batch::size) {
+        auto hits = batch::load(text.data() + index).eq(target).mask();
+        while(hits != 0) {
+            callback(index + detail::first_lane(hits));
+            hits = detail::drop_lane(hits);
+        }
+    }
+#endif
+
+    for(; index < text.size(); ++index) {
+        if(text[index] == byte) {
+            callback(index);
+        }
+    }
+}
+
+/// Index of the first byte at or after `from` that is in `set`. The
+/// register path needs a byte shuffle (SSSE3, AVX2 or NEON); plain SSE2
+/// looks each byte up in the bitmap instead.
+inline std::size_t find_first_of(std::string_view text,
+                                 const byte_set& set,
+                                 std::size_t from = 0) noexcept {
+    std::size_t index = from;
+
+#if defined(KOTA_SIMD_LOOKUP)
+    using detail::batch;
+    const auto low_rows = batch::table(set.rows[0]);
+    const auto high_rows = batch::table(set.rows[1]);
+    constexpr std::uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const auto bit_table = batch::table(bits);
+    const auto low_index = batch::splat(0x8F);
+    const auto flip = batch::splat(0x80);
+    for(; index + batch::size <= text.size(); index += batch::size) {
+        auto chunk = batch::load(text.data() + index);
+        // The low nibble picks the row. Keeping the top bit in the index
+        // makes the lookup in the half the byte is not in come back zero.
+        auto in_low = chunk & low_index;
+        auto row = batch::lookup(low_rows, in_low) | batch::lookup(high_rows, in_low ^ flip);
+        auto bit = batch::lookup(bit_table, chunk.high_nibbles());
+        if(auto hits = (row & bit).eq(bit).mask()) {
+            return index + detail::first_lane(hits);
+        }
+    }
+#endif
+
+    for(; index < text.size(); ++index) {
+        if(set.contains(static_cast<unsigned char>(text[index]))) {
+            return index;
+        }
+    }
+    return text.size();
+}
+
+/// Index of the first occurrence of `needle` at or after `from`. Lanes
+/// matching both the needle's first and last byte are the only ones
+/// compared in full.
+inline std::size_t find(std::string_view text,
+                        std::string_view needle,
+                        std::size_t from = 0) noexcept {
+    if(needle.size() <= 1) {
+        return needle.empty() ? std::min(from, text.size())
+                              : find_byte(text, needle.front(), from);
+    }
+    std::size_t index = from;
+
+#if defined(KOTA_SIMD_BATCH)
+    using detail::batch;
+    const auto first = batch::splat(static_cast<unsigned char>(needle.front()));
+    const auto last = batch::splat(static_cast<unsigned char>(needle.back()));
+    const auto span = needle.size() - 1;
+    for(; index + span + batch::size <= text.size(); index += batch::size) {
+        auto hits = (batch::load(text.data() + index).eq(first) &
+                     batch::load(text.data() + index + span).eq(last))
+                        .mask();
+        while(hits != 0) {
+            auto at = index + detail::first_lane(hits);
+            if(std::memcmp(text.data() + at + 1, needle.data() + 1, span - 1) == 0) {
+                return at;
+            }
+            hits = detail::drop_lane(hits);
+        }
+    }
+#endif
+
+    auto found = text.find(needle, index);
+    return found == std::string_view::npos ? text.size() : found;
+}
+
+/// Length of the run of ASCII bytes `text` starts with.
+inline std::size_t ascii_prefix(std::string_view text) noexcept {
+    std::size_t index = 0;
+
+#if defined(KOTA_SIMD_BATCH)
+    using detail::batch;
+    for(; index + batch::size <= text.size(); index += batch::size) {
+        if(auto high = batch::load(text.data() + index).in_range(0x80, 0xFF).mask()) {
+            return index + detail::first_lane(high);
+        }
+    }
+#endif
+
+    // Eight bytes at a time, then byte by byte to find where the run ends.
+    constexpr std::uint64_t high_bits = 0x8080808080808080ULL;
+    for(; index + sizeof(std::uint64_t) <= text.size(); index += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, text.data() + index, sizeof(word));
+        if(word & high_bits) {
+            break;
+        }
+    }
+    while(index < text.size() && static_cast<unsigned char>(text[index]) < 0x80u) {
+        ++index;
+    }
+    return index;
+}
+
+inline bool is_ascii(std::string_view text) noexcept {
+    return ascii_prefix(text) == text.size();
+}
+
+/// Whether `lhs` and `rhs` are equal once ASCII letters are lowercased.
+/// Other bytes, UTF-8 included, must match exactly.
+inline bool iequals_ascii(std::string_view lhs, std::string_view rhs) noexcept {
+    if(lhs.size() != rhs.size()) {
+        return false;
+    }
+    std::size_t index = 0;
+
+#if defined(KOTA_SIMD_BATCH)
+    using detail::batch;
+    const auto case_bit = batch::splat(0x20);
+    auto fold = [&](batch chunk) {
+        return chunk | (chunk.in_range('A', 'Z') & case_bit);
+    };
+    for(; index + batch::size <= lhs.size(); index += batch::size) {
+        auto left = fold(batch::load(lhs.data() + index));
+        auto right = fold(batch::load(rhs.data() + index));
+        if(left.eq(right).mask() != batch::all_lanes) {
+            return false;
+        }
+    }
+#endif
+
+    for(; index < lhs.size(); ++index) {
+        if(detail::to_lower_ascii(lhs[index]) != detail::to_lower_ascii(rhs[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace kota::simd
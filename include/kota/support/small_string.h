@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 #include "small_vector.h"
 #include "string_ref.h"
@@ -132,4 +133,14 @@ public:
     }
 };
 
+namespace detail {
+
+template <typename T>
+struct is_small_string : std::false_type {};
+
+template <unsigned InlineCapacity>
+struct is_small_string<small_string<InlineCapacity>> : std::true_type {};
+
+}  // namespace detail
+
 }  // namespace kota
@@ -5,6 +5,7 @@
 #include <compare>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
@@ -382,6 +383,13 @@ private:
         this->m_size = 0;
     }
 
+    /// Set when uninitialized_relocate copies bytes: the elements left
+    /// behind are then husks that must be freed without being destroyed.
+    [[nodiscard]] constexpr static bool relocates_bitwise() noexcept {
+        return mem::is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated();
+    }
+
+    /// Switch to a buffer the old elements were relocated into.
     constexpr void commit_replacement(pointer new_begin,
                                       size_type new_size,
                                       size_type new_capacity) noexcept {
@@ -394,7 +402,9 @@ private:
         this->m_size = static_cast<decltype(this->m_size)>(new_size);
         this->m_capacity = static_cast<decltype(this->m_capacity)>(new_capacity);
 
-        mem::destroy_range(counted_range(old_begin, old_size));
+        if(!relocates_bitwise()) {
+            mem::destroy_range(counted_range(old_begin, old_size));
+        }
         if(!was_inline) {
             mem::deallocate(old_begin, old_capacity);
         }
@@ -476,6 +486,7 @@ private:
             auto guard = make_allocation_guard(new_capacity);
             auto* out = mem::uninitialized_fill(counted_range(guard.data(), count), value);
             guard.mark(out);
+            destroy_elements();
             commit_replacement(guard.release(), count, new_capacity);
             return;
         }
@@ -527,23 +538,44 @@ private:
         return back();
     }
 
-    template <typename U>
-    constexpr iterator reallocate_and_insert_one(const_iterator pos, U&& value) {
-        const auto index = mem::range_length(range_to(pos));
-        const auto old_size = size();
-        const auto new_size = checked_size(old_size, 1);
-        const auto new_capacity = next_capacity(new_size);
+    /// A new buffer holding the old elements with a gap of `count` at
+    /// `index` that `construct_gap` fills, returning the end of what it
+    /// built. Bitwise relocation cannot throw, so in that case the gap is
+    /// filled first: if that fails, the old elements are still the only
+    /// owners of what they hold.
+    template <typename Construct>
+    constexpr pointer relocate_around(size_type index,
+                                      size_type count,
+                                      size_type new_capacity,
+                                      Construct&& construct_gap) {
         auto guard = make_allocation_guard(new_capacity);
+        if(relocates_bitwise()) {
+            construct_gap(guard.data() + index);
+            auto* out = mem::uninitialized_relocate(prefix(index), guard.data());
+            mem::uninitialized_relocate(suffix(index), out + count);
+            return guard.release();
+        }
 
         auto* out = mem::uninitialized_relocate(prefix(index), guard.data());
         guard.mark(out);
-        mem::construct(out, std::forward<U>(value));
-        ++out;
+        out = construct_gap(out);
         guard.mark(out);
         out = mem::uninitialized_relocate(suffix(index), out);
         guard.mark(out);
+        return guard.release();
+    }
 
-        commit_replacement(guard.release(), new_size, new_capacity);
+    template <typename U>
+    constexpr iterator reallocate_and_insert_one(const_iterator pos, U&& value) {
+        const auto index = mem::range_length(range_to(pos));
+        const auto old_size = size();
+        const auto new_size = checked_size(old_size, 1);
+        const auto new_capacity = next_capacity(new_size);
+        auto* new_begin = relocate_around(index, 1, new_capacity, [&](pointer out) {
+            mem::construct(out, std::forward<U>(value));
+            return out + 1;
+        });
+        commit_replacement(new_begin, new_size, new_capacity);
         return prefix(index).end();
     }
 
@@ -563,6 +595,20 @@ private:
         auto insert_pos = prefix(index).end();
         auto old_end = end();
 
+        if(relocates_bitwise()) {
+            const auto shifted = static_cast<size_type>(old_end - insert_pos) * sizeof(value_type);
+            std::memmove(static_cast<void*>(insert_pos + 1), insert_pos, shifted);
+            KOTA_TRY {
+                mem::construct(insert_pos, std::forward<U>(value));
+            }
+            KOTA_CATCH_ALL() {
+                std::memmove(static_cast<void*>(insert_pos), insert_pos + 1, shifted);
+                KOTA_RETHROW();
+            }
+            this->set_size(size() + 1);
+            return insert_pos;
+        }
+
         mem::construct(old_end, std::move(*(old_end - 1)));
         this->set_size(size() + 1);
         std::ranges::move_backward(insert_pos, old_end - 1, old_end);
@@ -577,16 +623,10 @@ private:
         const auto old_size = size();
         const auto new_size = checked_size(old_size, count);
         const auto new_capacity = next_capacity(new_size);
-        auto guard = make_allocation_guard(new_capacity);
-
-        auto* out = mem::uninitialized_relocate(prefix(index), guard.data());
-        guard.mark(out);
-        out = mem::uninitialized_fill(counted_range(out, count), value);
-        guard.mark(out);
-        out = mem::uninitialized_relocate(suffix(index), out);
-        guard.mark(out);
-
-        commit_replacement(guard.release(), new_size, new_capacity);
+        auto* new_begin = relocate_around(index, count, new_capacity, [&](pointer out) {
+            return mem::uninitialized_fill(counted_range(out, count), value);
+        });
+        commit_replacement(new_begin, new_size, new_capacity);
         return prefix(index).end();
     }
 
@@ -625,16 +665,10 @@ private:
         const auto old_size = size();
         const auto new_size = checked_size(old_size, count);
         const auto new_capacity = next_capacity(new_size);
-        auto guard = make_allocation_guard(new_capacity);
-
-        auto* out = mem::uninitialized_relocate(prefix(index), guard.data());
-        guard.mark(out);
-        out = mem::uninitialized_copy(std::forward<Range>(range), out);
-        guard.mark(out);
-        out = mem::uninitialized_relocate(suffix(index), out);
-        guard.mark(out);
-
-        commit_replacement(guard.release(), new_size, new_capacity);
+        auto* new_begin = relocate_around(index, count, new_capacity, [&](pointer out) {
+            return mem::uninitialized_copy(std::forward<Range>(range), out);
+        });
+        commit_replacement(new_begin, new_size, new_capacity);
         return prefix(index).end();
     }
 
@@ -1213,6 +1247,15 @@ public:
 
         auto erase_begin = const_cast<pointer>(first);
         auto erase_end = const_cast<pointer>(last);
+        if(relocates_bitwise()) {
+            const auto erased = static_cast<size_type>(erase_end - erase_begin);
+            const auto tail = static_cast<size_type>(end() - erase_end);
+            mem::destroy_range(std::ranges::subrange(erase_begin, erase_end));
+            std::memmove(static_cast<void*>(erase_begin), erase_end, tail * sizeof(value_type));
+            this->set_size(size() - erased);
+            return erase_begin;
+        }
+
         auto new_end = std::ranges::move(erase_end, end(), erase_begin).out;
         mem::destroy_range(std::ranges::subrange(new_end, end()));
         this->set_size(static_cast<size_type>(new_end - begin()));
@@ -1450,7 +1493,9 @@ public:
 
             this->m_begin = new_begin;
             this->m_capacity = static_cast<decltype(this->m_capacity)>(InlineCapacity);
-            mem::destroy_range(base_type::counted_range(old_begin, old_size));
+            if(!base_type::relocates_bitwise()) {
+                mem::destroy_range(base_type::counted_range(old_begin, old_size));
+            }
             mem::deallocate(old_begin, old_capacity);
             return;
         }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <source_location>
+#include <string_view>
+#include <utility>
+
+namespace kota::zest {
+
+/// Heap activity through the global operator new and delete, which zest
+/// replaces to count it.
+struct AllocationStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+/// Everything the calling thread has allocated so far. Subtract two
+/// snapshots to count the allocations in between.
+AllocationStats thread_allocations() noexcept;
+
+/// Whether zest was built with KOTA_ZEST_COUNT_ALLOCATIONS, i.e. replaces
+/// operator new and delete. Without it every count stays zero.
+bool counts_allocations() noexcept;
+
+/// AllocationCheck - The scope behind ZEST_EXPECT_NO_ALLOC and
+/// ZEST_EXPECT_ALLOCS_LE.
+///
+/// Counts the allocations of the calling thread from construction to
+/// destruction and fails the running test when there were more than
+/// `limit`. Other threads are not counted, so work a scope hands off to
+/// them is not either.
+class AllocationCheck {
+public:
+    AllocationCheck(std::uint64_t limit,
+                    std::string_view expr,
+                    std::source_location loc = std::source_location::current()) noexcept :
+        limit(limit), expr(expr), loc(loc), before(thread_allocations()) {}
+
+    AllocationCheck(const AllocationCheck&) = delete;
+    AllocationCheck& operator=(const AllocationCheck&) = delete;
+
+    ~AllocationCheck();
+
+    /// True once, so that a `for` statement runs the checked block once.
+    bool enter() noexcept {
+        return !std::exchange(this->entered, true);
+    }
+
+private:
+    std::uint64_t limit;
+    std::string_view expr;
+    std::source_location loc;
+    AllocationStats before;
+    bool entered = false;
+};
+
+}  // namespace kota::zest
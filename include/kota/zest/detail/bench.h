@@ -0,0 +1,182 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace kota::zest {
+
+namespace detail {
+
+/// Opaque sink for compilers without inline assembly; defined out of line so
+/// that the optimizer cannot see what happens to the pointer.
+void use_char_pointer(const volatile char* p);
+
+}  // namespace detail
+
+/// Make the optimizer assume `value` is read, and possibly written, here, so
+/// that the computation producing it is neither dropped nor hoisted.
+template <typename T>
+inline void do_not_optimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+        asm volatile("" : "+m,r"(value) : : "memory");
+    } else {
+        asm volatile("" : "+m"(value) : : "memory");
+    }
+#else
+    detail::use_char_pointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#endif
+}
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    detail::use_char_pointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#endif
+}
+
+/// Make the optimizer assume all memory is read and written here, which
+/// forces pending stores out.
+inline void clobber() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+/// Timing of one benchmark, per iteration.
+struct BenchStats {
+    /// Iterations in every sample, as found by calibration.
+    std::uint64_t iterations = 0;
+    std::size_t samples = 0;
+
+    double mean_ns = 0;
+    double median_ns = 0;
+    double stddev_ns = 0;
+    double p99_ns = 0;
+    double min_ns = 0;
+    double max_ns = 0;
+
+    /// Heap allocations on the benchmark thread, and their bytes.
+    double allocations = 0;
+    double allocated_bytes = 0;
+
+    /// Throughput from the mean, when the benchmark set Bench::items().
+    double items_per_second = 0;
+
+    /// Percentiles of the latencies passed to Bench::record_latency() while
+    /// sampling, or of a uniform selection of them when there were many;
+    /// the maximum is over all of them.
+    std::uint64_t latency_count = 0;
+    double latency_p50_ns = 0;
+    double latency_p90_ns = 0;
+    double latency_p99_ns = 0;
+    double latency_max_ns = 0;
+};
+
+/// Bench - What a BENCH body measures with.
+///
+/// run() first warms up, then calibrates the iterations of a sample until
+/// one takes at least min_sample_time(), and then takes samples() samples of
+/// that many iterations. Code outside run() is not measured, so a body sets
+/// up its data around it.
+class Bench {
+public:
+    /// Number of samples to take (default 21).
+    Bench& samples(std::size_t count) {
+        this->sample_count = count == 0 ? 1 : count;
+        return *this;
+    }
+
+    /// Minimum duration of one sample (default 10 ms).
+    Bench& min_sample_time(std::chrono::nanoseconds time) {
+        this->sample_time = time;
+        return *this;
+    }
+
+    /// Time to run before calibrating (default 10 ms).
+    Bench& warmup(std::chrono::nanoseconds time) {
+        this->warmup_time = time;
+        return *this;
+    }
+
+    /// Number of items one iteration processes, e.g. the tasks of a
+    /// fan-out, to report a throughput.
+    Bench& items(std::uint64_t per_iteration) {
+        this->items_per_iteration = per_iteration;
+        return *this;
+    }
+
+    /// Measure `op`. A value it returns is passed to do_not_optimize().
+    template <typename F>
+    void run(F&& op) {
+        using Op = std::remove_reference_t<F>;
+        this->measure(std::addressof(op), [](const void* erased, std::uint64_t iterations) {
+            auto& fn = *static_cast<Op*>(const_cast<void*>(erased));
+            for(std::uint64_t i = 0; i < iterations; ++i) {
+                if constexpr(std::is_void_v<decltype(fn())>) {
+                    fn();
+                } else {
+                    do_not_optimize(fn());
+                }
+            }
+        });
+    }
+
+    /// Measure `batch`, which runs the number of iterations it is passed
+    /// itself. For operations that have to be driven, e.g. by an event loop,
+    /// rather than called one at a time.
+    template <typename F>
+    void run_batch(F&& batch) {
+        using Op = std::remove_reference_t<F>;
+        this->measure(std::addressof(batch), [](const void* erased, std::uint64_t iterations) {
+            (*static_cast<Op*>(const_cast<void*>(erased)))(iterations);
+        });
+    }
+
+    /// Record how long one operation took, e.g. a request from send to
+    /// reply, for the latency percentiles. Cheap enough to call from the
+    /// measured code; it does not allocate while sampling.
+    void record_latency(std::chrono::nanoseconds latency);
+
+    /// Whether run() was called.
+    bool measured() const {
+        return this->result.samples != 0;
+    }
+
+    const BenchStats& stats() const {
+        return this->result;
+    }
+
+private:
+    using invoker_t = void (*)(const void* op, std::uint64_t iterations);
+
+    void measure(const void* op, invoker_t invoke);
+
+    std::size_t sample_count = 21;
+    std::chrono::nanoseconds sample_time = std::chrono::milliseconds(10);
+    std::chrono::nanoseconds warmup_time = std::chrono::milliseconds(10);
+    std::uint64_t items_per_iteration = 0;
+    BenchStats result;
+
+    /// Reservoir of recorded latencies, so that memory stays bounded.
+    std::vector<double> latencies;
+    std::uint64_t latencies_seen = 0;
+    double latency_peak = 0;
+    std::uint64_t reservoir_state = 0x9E3779B97F4A7C15;
+};
+
+}  // namespace kota::zest
@@ -35,6 +35,21 @@ struct TestSuite {
     std::vector<TestCase> (*cases)();
 };
 
+class Bench;
+
+struct BenchCase {
+    std::string name;
+    std::string path;
+    std::size_t line;
+    TestAttrs attrs;
+    std::function<TestState(Bench&)> bench;
+};
+
+struct BenchSuite {
+    std::string name;
+    std::vector<BenchCase> (*cases)();
+};
+
 inline TestState& current_test_state() {
     thread_local TestState state = TestState::Passed;
     return state;
@@ -58,11 +73,16 @@ public:
 
     void add_suite(std::string_view suite, std::vector<TestCase> (*cases)());
 
+    void add_bench_suite(std::string_view suite, std::vector<BenchCase> (*cases)());
+
     int run_tests(RunnerOptions options);
     int run_tests(std::string_view filter);
 
 private:
+    int run_benchmarks(const RunnerOptions& options);
+
     std::vector<TestSuite> suites;
+    std::vector<BenchSuite> bench_suites;
 };
 
 }  // namespace kota::zest
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "kota/zest/detail/bench.h"
 #include "kota/zest/detail/registry.h"
 #include "kota/support/fixed_string.h"
 
@@ -67,6 +68,55 @@ struct TestSuiteDef {
         test_cases().emplace_back(case_name.data(), path.data(), line, effective_attrs, run_test);
         return true;
     }();
+
+    constexpr inline static auto& bench_cases() {
+        static std::vector<BenchCase> instance;
+        return instance;
+    }
+
+    constexpr inline static auto benches() {
+        return std::move(bench_cases());
+    }
+
+    template <typename T = void>
+    inline static bool _register_bench_suites = [] {
+        Runner::instance().add_bench_suite(TestName.data(), &benches);
+        return true;
+    }();
+
+    template <fixed_string case_name,
+              auto bench_body,
+              fixed_string path,
+              std::size_t line,
+              TestAttrs attrs = {}>
+    inline static bool _register_bench_case = [] {
+        constexpr auto effective_attrs = [] {
+            if constexpr(requires { Derived::suite_attrs; }) {
+                return merge_attrs(Derived::suite_attrs, attrs);
+            } else {
+                return attrs;
+            }
+        }();
+
+        auto run_bench = +[](Bench& bench) -> TestState {
+            current_test_state() = TestState::Passed;
+            Derived test;
+            if constexpr(requires { test.setup(); }) {
+                test.setup();
+            }
+
+            (test.*bench_body)(bench);
+
+            if constexpr(requires { test.teardown(); }) {
+                test.teardown();
+            }
+
+            return current_test_state();
+        };
+
+        bench_cases().emplace_back(case_name.data(), path.data(), line, effective_attrs, run_bench);
+        return true;
+    }();
 };
 
 }  // namespace kota::zest
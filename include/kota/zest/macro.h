@@ -1,5 +1,6 @@
 #pragma once
 
+#include "kota/zest/detail/alloc.h"
 #include "kota/zest/detail/check.h"
 #include "kota/zest/detail/suite.h"
 #include "kota/zest/detail/trace.h"
@@ -34,6 +35,20 @@
     }                                                                                              \
     void test_##name()
 
+#define BENCH(name, ...)                                                                           \
+    void _register_bench_##name() {                                                                \
+        constexpr auto file_name = std::source_location::current().file_name();                    \
+        constexpr auto file_len = std::string_view(file_name).size();                              \
+        (void)_register_bench_suites<>;                                                            \
+        constexpr auto _zest_attrs_ = ZEST_MAKE_ATTRS(__VA_OPT__(__VA_ARGS__));                    \
+        (void)_register_bench_case<#name,                                                          \
+                                   &Self::bench_##name,                                            \
+                                   ::kota::fixed_string<file_len>(file_name),                      \
+                                   std::source_location::current().line(),                         \
+                                   _zest_attrs_>;                                                  \
+    }                                                                                              \
+    void bench_##name([[maybe_unused]] ::kota::zest::Bench& bench)
+
 #define ZEST_CHECK_IMPL(condition, return_action)                                                  \
     do {                                                                                           \
         if(condition) [[unlikely]] {                                                               \
@@ -97,9 +112,20 @@
 #define CO_ASSERT_GE(...) ZEST_EXPECT_BINARY(>=, !::kota::meta::ge(lhs, rhs), co_return, __VA_ARGS__)
 // clang-format on
 
+/// Fail the test when the block that follows allocates on this thread more
+/// than `limit` times, e.g. `ZEST_EXPECT_ALLOCS_LE(1) { codec.encode(msg); }`.
+/// Leaving the block early with return or an exception still checks it.
+#define ZEST_EXPECT_ALLOCS_LE(limit)                                                               \
+    for(::kota::zest::AllocationCheck _zest_alloc_check_((limit), "allocations <= " #limit);       \
+        _zest_alloc_check_.enter();)
+
+#define ZEST_EXPECT_NO_ALLOC                                                                       \
+    for(::kota::zest::AllocationCheck _zest_alloc_check_(0, "no allocations");                     \
+        _zest_alloc_check_.enter();)
+
 #ifdef __cpp_exceptions
 
-#define CAUGHT(...)                                                                                \
+#define CAUGHT(...)                                                                               \
     ([&]() {                                                                                       \
         try {                                                                                      \
             (__VA_ARGS__);                                                                         \
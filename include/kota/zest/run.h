@@ -15,6 +15,25 @@ struct RunnerOptions {
     bool parallel = false;
     /// Number of worker threads for parallel mode (0 = hardware_concurrency).
     unsigned parallel_workers = 0;
+    /// When nonzero, every test case runs in a child process of its own, at most this many at a
+    /// time, so a test that crashes or hangs fails alone. Requires `executable`.
+    unsigned jobs = 0;
+    /// Only run the selected tests whose position modulo `shard_count` is `shard_index`, so that
+    /// several machines can split one run.
+    unsigned shard_index = 0;
+    unsigned shard_count = 1;
+    /// Per-test time limit in milliseconds (0 = none). A test past it fails; with `jobs` its
+    /// process is killed, otherwise it fails once it returns.
+    unsigned timeout_ms = 0;
+    /// Test binary that `jobs` re-executes; run_cli() takes it from argv[0].
+    std::string executable;
+    /// Set in the child processes of `jobs`: run the selected tests without progress output.
+    bool worker = false;
+    /// When non-empty, run the benchmarks matching this filter, in the syntax of `filter`,
+    /// instead of the tests.
+    std::string bench_filter;
+    /// File to write benchmark results to as JSON; empty for none.
+    std::string bench_json;
 };
 
 /// Parse CLI arguments into RunnerOptions and execute registered tests.
@@ -1,9 +1,20 @@
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "awaiter.h"
+#include "resolve_cache.h"
+#include "kota/async/io/deadline.h"
 #include "kota/async/io/loop.h"
+#include "kota/async/io/loop_group.h"
+#include "kota/async/runtime/sync.h"
+#include "kota/async/runtime/when.h"
 
 namespace kota {
 
@@ -56,7 +67,6 @@ result<unsigned int> to_uv_tcp_bind_flags(const tcp::options& opts) {
 template <typename Stream>
 struct accept_await : uv::await_op<accept_await<Stream>> {
     using await_base = uv::await_op<accept_await<Stream>>;
-    using promise_t = task<Stream, error>::promise_type;
     using self_t = typename acceptor<Stream>::Self;
 
     // Acceptor self used for waiter registration and pending queueing.
@@ -78,8 +88,9 @@ struct accept_await : uv::await_op<accept_await<Stream>> {
         return false;
     }
 
+    template <typename Promise>
     std::coroutine_handle<>
-        await_suspend(std::coroutine_handle<promise_t> waiting,
+        await_suspend(std::coroutine_handle<Promise> waiting,
                       std::source_location loc = std::source_location::current()) noexcept {
         if(!self) {
             return waiting;
@@ -172,16 +183,9 @@ struct connect_await : uv::await_op<connect_await<Stream>> {
         }
     }
 
-    connect_await(self_ptr self, std::string_view host, int port) : self(std::move(self)) {
-        if constexpr(std::is_same_v<Stream, tcp>) {
-            auto resolved = uv::resolve_addr(host, port);
-            if(!resolved) {
-                ready = false;
-                outcome = outcome_error(resolved.error());
-                return;
-            }
-            addr = resolved->storage;
-        } else {
+    connect_await(self_ptr self, const sockaddr_storage& addr) :
+        self(std::move(self)), addr(addr) {
+        if constexpr(!std::is_same_v<Stream, tcp>) {
             static_assert(always_false_v<Stream>, "tcp constructor requires Stream=tcp");
         }
     }
@@ -291,6 +295,41 @@ task<Stream, error> acceptor<Stream>::accept() {
     co_return co_await accept_await<Stream>{self.get()};
 }
 
+template <typename Stream>
+task<small_vector<Stream>, error> acceptor<Stream>::accept_batch(std::size_t max) {
+    if(!self || max == 0) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(self->has_waiter()) {
+        co_await fail(error::connection_already_in_progress);
+    }
+
+    small_vector<Stream> out;
+    if(!self->has_pending()) {
+        auto first = co_await accept_await<Stream>{self.get()};
+        if(!first) {
+            co_await fail(first.error());
+        }
+        out.emplace_back(std::move(*first));
+    }
+
+    while(out.size() < max && self->has_pending()) {
+        auto next = self->take_pending();
+        if(!next) {
+            if(out.empty()) {
+                co_await fail(next.error());
+            }
+            // Hand over what was accepted; the error waits for the next call.
+            self->pending.push_front(std::move(next));
+            break;
+        }
+        out.emplace_back(std::move(*next));
+    }
+
+    co_return out;
+}
+
 template <typename Stream>
 error acceptor<Stream>::stop() {
     if(!self) {
@@ -387,13 +426,109 @@ result<tcp> tcp::open(int fd, event_loop& loop) {
     return tcp(std::move(self));
 }
 
-task<tcp, error> tcp::connect(std::string_view host, int port, event_loop& loop) {
-    auto self = Self::make();
+namespace {
+
+/// Delay before the next connection attempt starts while the previous one is
+/// still pending (RFC 8305's recommended "Connection Attempt Delay").
+constexpr std::chrono::milliseconds connection_attempt_delay{250};
+
+task<tcp, error> connect_once(uv::resolved_addr addr, event_loop& loop) {
+    auto self = tcp::Self::make();
     if(auto err = uv::tcp_init(loop, self->tcp)) {
         co_await fail(err);
     }
 
-    co_return co_await connect_await<tcp>{std::move(self), host, port};
+    co_return co_await connect_await<tcp>{std::move(self), addr.storage};
+}
+
+/// Reorders addresses so the families alternate, starting with the family
+/// getaddrinfo preferred, as in RFC 8305 section 4.
+std::vector<uv::resolved_addr> interleave_families(std::vector<uv::resolved_addr> addrs) {
+    std::vector<uv::resolved_addr> first;
+    std::vector<uv::resolved_addr> second;
+    const int preferred = addrs.front().family;
+    for(auto& addr: addrs) {
+        (addr.family == preferred ? first : second).push_back(addr);
+    }
+
+    std::vector<uv::resolved_addr> out;
+    out.reserve(addrs.size());
+    for(std::size_t i = 0; i < first.size() || i < second.size(); ++i) {
+        if(i < first.size()) {
+            out.push_back(first[i]);
+        }
+        if(i < second.size()) {
+            out.push_back(second[i]);
+        }
+    }
+    return out;
+}
+
+/// State shared by the attempts of one happy-eyeballs connect.
+struct connect_race {
+    explicit connect_race(std::size_t count) : remaining(count) {
+        for(std::size_t i = 0; i < count; ++i) {
+            started.emplace_back();
+            failed.emplace_back();
+        }
+    }
+
+    // Attempts that have not failed yet.
+    std::size_t remaining;
+    // Error of the most recent failed attempt.
+    error last_error;
+    // Set once attempt i is under way, and once it has failed.
+    std::deque<event> started;
+    std::deque<event> failed;
+    // Never set; failed attempts park on it so that when_any only completes
+    // on the first success or on the last failure.
+    event never;
+};
+
+task<tcp, error> race_attempt(std::shared_ptr<connect_race> race,
+                              uv::resolved_addr addr,
+                              std::size_t index,
+                              event_loop& loop) {
+    if(index > 0) {
+        co_await race->started[index - 1].wait();
+        co_await when_any(after(connection_attempt_delay, loop), race->failed[index - 1].wait());
+    }
+    race->started[index].set();
+
+    auto conn = co_await connect_once(addr, loop);
+    if(conn) {
+        co_return std::move(*conn);
+    }
+
+    race->last_error = conn.error();
+    if(--race->remaining == 0) {
+        co_await fail(race->last_error);
+    }
+    race->failed[index].set();
+    co_await race->never.wait();
+    co_await fail(race->last_error);
+}
+
+}  // namespace
+
+task<tcp, error> tcp::connect(std::string_view host, int port, event_loop& loop) {
+    auto addrs = co_await resolve_sockaddrs(host, port, loop).or_fail();
+    if(addrs.size() == 1) {
+        co_return co_await connect_once(addrs.front(), loop).or_fail();
+    }
+
+    addrs = interleave_families(std::move(addrs));
+    auto race = std::make_shared<connect_race>(addrs.size());
+    small_vector<task<tcp, error>> attempts;
+    for(std::size_t i = 0; i < addrs.size(); ++i) {
+        attempts.push_back(race_attempt(race, addrs[i], i, loop));
+    }
+
+    auto winner = co_await when_any(std::move(attempts));
+    if(winner.has_error()) {
+        co_await fail(std::move(winner).error());
+    }
+    co_return std::move(winner->second);
 }
 
 result<tcp::acceptor>
@@ -429,6 +564,71 @@ result<tcp::acceptor>
     return tcp::acceptor(std::move(self));
 }
 
+namespace {
+
+task<> bind_shard(std::string_view host,
+                  int port,
+                  tcp::options opts,
+                  result<tcp::acceptor>& slot,
+                  std::latch& bound) {
+    slot = tcp::listen(host, port, opts, event_loop::current());
+    bound.count_down();
+    co_return;
+}
+
+task<> serve_shard(tcp::acceptor acc,
+                   bool serve,
+                   std::shared_ptr<std::function<task<>(tcp::acceptor)>> fn) {
+    if(serve) {
+        co_await (*fn)(std::move(acc));
+    }
+}
+
+}  // namespace
+
+error tcp::listen_sharded(std::string_view host,
+                          int port,
+                          options opts,
+                          loop_group& group,
+                          std::function<task<>(acceptor)> serve) {
+    assert(!group.current_index() && "tcp::listen_sharded must not run on a group worker");
+    if(!serve) {
+        return error::invalid_argument;
+    }
+
+    opts.reuse_port = true;
+    const auto shards = group.size();
+    std::vector<result<acceptor>> slots;
+    slots.reserve(shards);
+    for(std::size_t i = 0; i < shards; ++i) {
+        slots.emplace_back(outcome_error(error()));
+    }
+
+    // Each listener must be created on the loop that will own it.
+    std::latch bound(static_cast<std::ptrdiff_t>(shards));
+    for(std::size_t i = 0; i < shards; ++i) {
+        group.spawn_on(i, bind_shard(host, port, opts, slots[i], bound));
+    }
+    bound.wait();
+
+    error first_error;
+    for(auto& slot: slots) {
+        if(!slot && !first_error) {
+            first_error = slot.error();
+        }
+    }
+
+    // Every shard task is spawned even on failure, so that each bound
+    // listener is closed on its own loop.
+    auto fn = std::make_shared<std::function<task<>(acceptor)>>(std::move(serve));
+    for(std::size_t i = 0; i < shards; ++i) {
+        acceptor acc = slots[i] ? std::move(*slots[i]) : acceptor();
+        group.spawn_on(i, serve_shard(std::move(acc), !first_error, fn));
+    }
+
+    return first_error;
+}
+
 result<int> tcp::local_port(tcp::acceptor& acc) {
     if(!acc.self) {
         return outcome_error(error::invalid_argument);
@@ -3,11 +3,13 @@
 #include <cassert>
 #include <concepts>
 #include <deque>
+#include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "../libuv.h"
-#include "../vocab/ringbuffer.h"
+#include "../vocab/segmented_buffer.h"
 #include "kota/async/io/stream.h"
 #include "kota/async/runtime/frame.h"
 #include "kota/async/vocab/error.h"
@@ -223,14 +225,56 @@ struct stream_handle {
     };
 };
 
+/// Check handle that sends a corked stream's buffered bytes at the end of
+/// the loop iteration in which they were written.
+struct stream_flush_check : uv::handle<stream_flush_check, uv_check_t> {
+    uv_check_t handle{};
+    stream::Self* owner = nullptr;
+};
+
+/// Write coalescing state, created by the first stream::cork().
+struct stream_cork {
+    /// Bytes handed to one uv_write; the last finished batch is kept as a
+    /// spare so its buffer is reused by the next one.
+    struct batch {
+        uv_write_t req{};
+        std::vector<char> bytes;
+        stream_cork* owner = nullptr;
+    };
+
+    bool enabled = false;
+    // Send as soon as a write ends a line, as a line-buffered console does.
+    bool lines = false;
+    std::size_t threshold = 0;
+    // Bytes written while corked and not yet handed to libuv.
+    std::vector<char> pending;
+    // Start of the last frame from write_frame() when it is still the tail
+    // of `pending`, so the next frame can replace it; npos otherwise.
+    std::size_t frame_at = static_cast<std::size_t>(-1);
+    // Batches whose uv_write has not completed.
+    std::size_t inflight = 0;
+    std::unique_ptr<batch> spare;
+    // First write error; reported by every later write() and flush().
+    error failure{};
+    // Pending flush() calls, woken once nothing is in flight.
+    std::vector<system_op*> flushers;
+    unique_handle<stream_flush_check> check;
+};
+
 struct stream::Self : uv::handle<stream::Self, uv_stream_t>, stream_handle {
-    enum class read_mode { none, buffered, direct };
+    enum class read_mode { none, buffered, direct, readiness };
 
     uv::single_waiter reader;
-    uv::single_waiter writer;
-    ring_buffer buffer{};
+    segmented_buffer buffer{};
     error error_code{};
     read_mode active_read_mode = read_mode::none;
+    // Writes waiting for an in-flight slot, oldest first.
+    std::deque<system_op*> queued_writes;
+    // Bytes copied by queued_writes and not yet handed to libuv.
+    std::size_t queued_write_bytes = 0;
+    std::size_t inflight_writes = 0;
+    std::size_t max_inflight_writes = 16;
+    std::unique_ptr<stream_cork> cork;
 };
 
 template <typename Stream>
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kota/async/io/fs_event.h"
+#include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+/// Changes collected for fs_event::wait_batch() and tree_watcher::wait_batch(),
+/// one entry per path with the flags of all its events merged.
+struct fs_change_batch {
+    std::vector<fs_event::change> changes;
+    std::unordered_map<std::string, std::size_t> index;
+    // First watch error, reported once the collected changes are taken.
+    error failure{};
+    // wait_batch() suspended until the first change arrives.
+    system_op* waiter = nullptr;
+    // Whether a wait_batch() is running, including its debounce window.
+    bool busy = false;
+
+    bool ready() const noexcept {
+        return !changes.empty() || failure;
+    }
+
+    /// Records `change` and wakes a suspended wait_batch().
+    void add(fs_event::change&& change);
+
+    /// Records `err` unless an earlier error is pending, and wakes a
+    /// suspended wait_batch().
+    void add_error(error err);
+};
+
+/// Body of both wait_batch() calls: waits for the first change or error,
+/// then `window` longer, and takes everything collected by then.
+task<std::vector<fs_event::change>, error>
+    wait_change_batch(fs_change_batch& batch, std::chrono::milliseconds window, event_loop& loop);
+
+}  // namespace kota
@@ -9,7 +9,12 @@ result<console> console::open(int fd, console::options opts, event_loop& loop) {
         return outcome_error(err);
     }
 
-    return console(std::move(self));
+    console out(std::move(self));
+    if(opts.buffer != buffering::none) {
+        out.cork(opts.buffer_size);
+        out.set_line_flush(opts.buffer == buffering::line);
+    }
+    return out;
 }
 
 error console::set_mode(mode value) {
@@ -66,6 +71,10 @@ result<console::vterm_state> console::get_vterm_state() {
     return *out == UV_TTY_SUPPORTED ? vterm_state::supported : vterm_state::unsupported;
 }
 
+bool console::redraw(std::string_view frame) {
+    return write_frame(std::span<const char>(frame.data(), frame.size()));
+}
+
 console::console(unique_handle<Self> self) noexcept : stream(std::move(self)) {}
 
 }  // namespace kota
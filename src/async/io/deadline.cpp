@@ -0,0 +1,54 @@
+#include "kota/async/io/deadline.h"
+
+#include <coroutine>
+#include <source_location>
+
+#include "kota/async/runtime/frame.h"
+
+namespace kota {
+
+namespace {
+
+struct after_await : system_op, detail::wheel_entry {
+    using promise_t = task<>::promise_type;
+
+    event_loop* loop;
+    std::chrono::milliseconds timeout;
+
+    after_await(event_loop& loop, std::chrono::milliseconds timeout) :
+        loop(&loop), timeout(timeout) {
+        this->action = &on_cancel;
+        this->fire = &on_fire;
+    }
+
+    static void on_cancel(system_op* op) {
+        auto* self = static_cast<after_await*>(op);
+        self->loop->disarm_timeout(*self);
+        self->complete();
+    }
+
+    static void on_fire(detail::wheel_entry& entry) {
+        static_cast<after_await&>(entry).complete();
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        loop->arm_timeout(*this, timeout);
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+}  // namespace
+
+task<> after(std::chrono::milliseconds timeout, event_loop& loop) {
+    co_await after_await{loop, timeout};
+}
+
+}  // namespace kota
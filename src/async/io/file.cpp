@@ -0,0 +1,235 @@
+#include "kota/async/io/file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "kota/async/io/fs.h"
+
+namespace kota {
+
+fs::async_file::async_file(int fd, options opts, event_loop& loop) noexcept :
+    fd(fd), loop(&loop), opts(opts) {
+    this->opts.buffer_size = (std::max)(this->opts.buffer_size, std::size_t(1));
+    this->opts.max_readahead = (std::max)(this->opts.max_readahead, this->opts.buffer_size);
+    readahead = this->opts.buffer_size;
+}
+
+fs::async_file::async_file(async_file&& other) noexcept {
+    *this = std::move(other);
+}
+
+fs::async_file& fs::async_file::operator=(async_file&& other) noexcept {
+    if(this != &other) {
+        if(fd >= 0) {
+            (void)fs::sync::close(fd);
+        }
+        fd = std::exchange(other.fd, -1);
+        loop = other.loop;
+        opts = other.opts;
+        cursor = other.cursor;
+        read_buffer = std::move(other.read_buffer);
+        read_offset = other.read_offset;
+        read_size = std::exchange(other.read_size, 0);
+        sequential_offset = other.sequential_offset;
+        readahead = other.readahead;
+        write_buffer = std::move(other.write_buffer);
+        write_offset = other.write_offset;
+    }
+    return *this;
+}
+
+fs::async_file::~async_file() {
+    if(fd >= 0) {
+        (void)fs::sync::close(fd);
+    }
+}
+
+task<fs::async_file, error> fs::async_file::open(std::string_view path,
+                                                 int flags,
+                                                 int mode,
+                                                 options opts,
+                                                 event_loop& loop) {
+    auto fd = co_await fs::open(path, flags, mode, loop).or_fail();
+    co_return async_file(fd, opts, loop);
+}
+
+std::span<const char> fs::async_file::buffered(std::int64_t offset) const noexcept {
+    if(read_size == 0 || offset < read_offset ||
+       offset >= read_offset + static_cast<std::int64_t>(read_size)) {
+        return {};
+    }
+    auto start = static_cast<std::size_t>(offset - read_offset);
+    return {read_buffer.data() + start, read_size - start};
+}
+
+std::size_t fs::async_file::next_refill(std::int64_t offset) noexcept {
+    readahead = offset == sequential_offset ? (std::min)(readahead * 2, opts.max_readahead)
+                                            : opts.buffer_size;
+    return readahead;
+}
+
+task<std::size_t, error> fs::async_file::refill(std::int64_t offset, std::size_t size) {
+    if(read_buffer.size() < size) {
+        read_buffer.resize(size);
+    }
+    read_size = 0;
+    auto n = co_await fs::read(fd, std::span<char>(read_buffer.data(), size), offset, *loop)
+                 .or_fail();
+    read_offset = offset;
+    read_size = n;
+    co_return n;
+}
+
+void fs::async_file::drop_read_buffer(std::int64_t offset, std::size_t size) noexcept {
+    auto end = offset + static_cast<std::int64_t>(size);
+    if(read_size != 0 && offset < read_offset + static_cast<std::int64_t>(read_size) &&
+       read_offset < end) {
+        read_size = 0;
+    }
+}
+
+task<std::size_t, error> fs::async_file::pread(std::span<char> out, std::int64_t offset) {
+    if(out.empty()) {
+        co_return 0;
+    }
+    // Reads see what was written before them.
+    co_await flush().or_fail();
+
+    // A hit returns what the buffer holds, even if that is short; the next
+    // read continues sequentially and refills with a larger window.
+    if(auto hit = buffered(offset); !hit.empty()) {
+        auto n = (std::min)(out.size(), hit.size());
+        std::memcpy(out.data(), hit.data(), n);
+        sequential_offset = offset + static_cast<std::int64_t>(n);
+        co_return n;
+    }
+
+    auto size = next_refill(offset);
+    std::size_t n = 0;
+    if(out.size() >= size) {
+        n = co_await fs::read(fd, out, offset, *loop).or_fail();
+    } else {
+        auto filled = co_await refill(offset, size).or_fail();
+        n = (std::min)(out.size(), filled);
+        std::memcpy(out.data(), read_buffer.data(), n);
+    }
+    sequential_offset = offset + static_cast<std::int64_t>(n);
+    co_return n;
+}
+
+task<std::size_t, error> fs::async_file::read(std::span<char> out) {
+    auto n = co_await pread(out, cursor).or_fail();
+    cursor += static_cast<std::int64_t>(n);
+    co_return n;
+}
+
+task<bool, error> fs::async_file::read_line(std::string& line) {
+    line.clear();
+    co_await flush().or_fail();
+
+    bool found = false;
+    while(true) {
+        auto hit = buffered(cursor);
+        if(hit.empty()) {
+            auto filled = co_await refill(cursor, next_refill(cursor)).or_fail();
+            if(filled == 0) {
+                co_return found;
+            }
+            hit = buffered(cursor);
+        }
+
+        found = true;
+        auto* newline = static_cast<const char*>(std::memchr(hit.data(), '\n', hit.size()));
+        auto taken = newline ? static_cast<std::size_t>(newline - hit.data()) : hit.size();
+        line.append(hit.data(), taken);
+
+        auto consumed = newline ? taken + 1 : taken;
+        cursor += static_cast<std::int64_t>(consumed);
+        sequential_offset = cursor;
+        if(newline) {
+            co_return true;
+        }
+    }
+}
+
+task<void, error> fs::async_file::write_all(std::span<const char> data, std::int64_t offset) {
+    while(!data.empty()) {
+        auto n = co_await fs::write(fd, data, offset, *loop).or_fail();
+        if(n == 0) {
+            co_await fail(error::io_error);
+        }
+        data = data.subspan(n);
+        offset += static_cast<std::int64_t>(n);
+    }
+}
+
+task<void, error> fs::async_file::pwrite(std::span<const char> data, std::int64_t offset) {
+    if(data.empty()) {
+        co_return;
+    }
+    drop_read_buffer(offset, data.size());
+
+    // Only a write continuing the buffered ones can join them.
+    auto buffered_end = write_offset + static_cast<std::int64_t>(write_buffer.size());
+    if(!write_buffer.empty() && offset != buffered_end) {
+        co_await flush().or_fail();
+    }
+
+    if(write_buffer.size() + data.size() > opts.buffer_size) {
+        co_await flush().or_fail();
+        if(data.size() >= opts.buffer_size) {
+            co_await write_all(data, offset).or_fail();
+            co_return;
+        }
+    }
+
+    if(write_buffer.empty()) {
+        write_offset = offset;
+    }
+    write_buffer.insert(write_buffer.end(), data.begin(), data.end());
+}
+
+task<void, error> fs::async_file::write(std::span<const char> data) {
+    co_await pwrite(data, cursor).or_fail();
+    cursor += static_cast<std::int64_t>(data.size());
+}
+
+task<void, error> fs::async_file::flush() {
+    if(write_buffer.empty()) {
+        co_return;
+    }
+    // Kept on failure, so that a later flush() can retry.
+    co_await write_all(write_buffer, write_offset).or_fail();
+    write_buffer.clear();
+}
+
+task<void, error> fs::async_file::sync(bool data_only) {
+    co_await flush().or_fail();
+    if(data_only) {
+        co_await fs::fdatasync(fd, *loop).or_fail();
+    } else {
+        co_await fs::fsync(fd, *loop).or_fail();
+    }
+}
+
+task<void, error> fs::async_file::close() {
+    if(fd < 0) {
+        co_return;
+    }
+
+    auto flushed = co_await flush();
+    auto closing = std::exchange(fd, -1);
+    write_buffer.clear();
+    read_size = 0;
+
+    auto closed = co_await fs::close(closing, *loop);
+    if(!flushed) {
+        co_await fail(flushed.error());
+    }
+    if(!closed) {
+        co_await fail(closed.error());
+    }
+}
+
+}  // namespace kota
@@ -1,10 +1,24 @@
 #include "kota/async/io/fs.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "awaiter.h"
 #include "kota/async/io/loop.h"
+#include "kota/async/io/request.h"
+#include "kota/async/runtime/when.h"
 #include "kota/async/vocab/error.h"
 
 namespace kota {
@@ -193,6 +207,147 @@ fs::dir_handle fs::dir_handle::from_native(void* ptr) {
     return dir_handle(ptr);
 }
 
+// ============================================================================
+// mapped_file
+// ============================================================================
+
+fs::mapped_file::mapped_file(mapped_file&& other) noexcept :
+    base(std::exchange(other.base, nullptr)), length(std::exchange(other.length, 0)),
+    reserved(std::exchange(other.reserved, 0)), kind(std::exchange(other.kind, backing::none)) {}
+
+fs::mapped_file& fs::mapped_file::operator=(mapped_file&& other) noexcept {
+    if(this != &other) {
+        reset();
+        base = std::exchange(other.base, nullptr);
+        length = std::exchange(other.length, 0);
+        reserved = std::exchange(other.reserved, 0);
+        kind = std::exchange(other.kind, backing::none);
+    }
+    return *this;
+}
+
+fs::mapped_file::~mapped_file() {
+    reset();
+}
+
+void fs::mapped_file::reset() noexcept {
+    switch(kind) {
+        case backing::none: break;
+        case backing::heap: delete[] base; break;
+        case backing::mapping:
+#ifdef _WIN32
+            ::UnmapViewOfFile(base);
+#else
+            ::munmap(base, reserved);
+#endif
+            break;
+    }
+    base = nullptr;
+    length = 0;
+    reserved = 0;
+    kind = backing::none;
+}
+
+namespace {
+
+std::size_t page_size() noexcept {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/// Maps `length` bytes of `fd` followed by at least `padding` readable
+/// zero bytes; returns the base and readable size, or null if the padding
+/// cannot be provided this way.
+std::pair<char*, std::size_t>
+    map_padded(int fd, std::size_t length, std::size_t padding) noexcept {
+    const auto page = page_size();
+    const auto reserved = (length + padding + page - 1) / page * page;
+
+#ifdef _WIN32
+    // A view cannot be extended past the file, so only the zero-filled
+    // tail of its last page is available as padding.
+    if(reserved > (length + page - 1) / page * page) {
+        return {nullptr, 0};
+    }
+
+    auto file = reinterpret_cast<HANDLE>(uv_get_osfhandle(fd));
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr) {
+        return {nullptr, 0};
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if(view == nullptr) {
+        return {nullptr, 0};
+    }
+    return {static_cast<char*>(view), reserved};
+#else
+    // Reserve zeroed anonymous pages first and map the file over their
+    // start, so the padding is there even when the file ends on a page
+    // boundary.
+    void* region = ::mmap(nullptr, reserved, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(region == MAP_FAILED) {
+        return {nullptr, 0};
+    }
+    void* file = ::mmap(region, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if(file == MAP_FAILED) {
+        ::munmap(region, reserved);
+        return {nullptr, 0};
+    }
+    return {static_cast<char*>(region), reserved};
+#endif
+}
+
+}  // namespace
+
+task<fs::mapped_file, error> fs::map(std::string_view path, event_loop& loop) {
+    auto fd = co_await fs::open(path, UV_FS_O_RDONLY, 0, loop).or_fail();
+
+    auto stats = co_await fs::fstat(fd, loop);
+    if(!stats) {
+        co_await fs::close(fd, loop);
+        co_await fail(stats.error());
+    }
+
+    mapped_file out;
+    out.length = static_cast<std::size_t>(stats->size);
+    if(out.length != 0) {
+        auto [base, reserved] = map_padded(fd, out.length, mapped_file::min_padding);
+        if(base != nullptr) {
+            out.base = base;
+            out.reserved = reserved;
+            out.kind = mapped_file::backing::mapping;
+        }
+    }
+
+    if(out.base == nullptr) {
+        out.reserved = out.length + mapped_file::min_padding;
+        out.base = new char[out.reserved]();
+        out.kind = mapped_file::backing::heap;
+
+        std::size_t filled = 0;
+        while(filled < out.length) {
+            auto n = co_await fs::read(fd,
+                                       std::span<char>(out.base + filled, out.length - filled),
+                                       static_cast<std::int64_t>(filled),
+                                       loop);
+            if(!n || *n == 0) {
+                co_await fs::close(fd, loop);
+                co_await fail(n ? error::io_error : n.error());
+            }
+            filled += *n;
+        }
+    }
+
+    co_await fs::close(fd, loop);
+    co_return out;
+}
+
 // ============================================================================
 // Success/failure operations
 // ============================================================================
@@ -632,6 +787,182 @@ task<std::vector<fs::dirent>, error> fs::readdir(fs::dir_handle& dir, event_loop
         loop);
 }
 
+namespace {
+
+fs::dirent::type kind_from_mode(std::uint64_t mode) {
+    switch(mode & S_IFMT) {
+        case S_IFREG: return fs::dirent::type::file;
+        case S_IFDIR: return fs::dirent::type::dir;
+        case S_IFCHR: return fs::dirent::type::char_device;
+#ifdef S_IFLNK
+        case S_IFLNK: return fs::dirent::type::link;
+#endif
+#ifdef S_IFIFO
+        case S_IFIFO: return fs::dirent::type::fifo;
+#endif
+#ifdef S_IFSOCK
+        case S_IFSOCK: return fs::dirent::type::socket;
+#endif
+#ifdef S_IFBLK
+        case S_IFBLK: return fs::dirent::type::block_device;
+#endif
+        default: return fs::dirent::type::unknown;
+    }
+}
+
+std::string join_path(std::string_view dir, std::string_view name) {
+    std::string path;
+    path.reserve(dir.size() + 1 + name.size());
+    path.append(dir);
+    if(!path.empty() && path.back() != '/' && path.back() != '\\') {
+        path.push_back('/');
+    }
+    path.append(name);
+    return path;
+}
+
+/// lstat for walk(). A failure, usually an entry removed while the walk ran,
+/// only leaves the entry without stats.
+task<bool> walk_stat(fs::walk_entry& entry, event_loop& loop) {
+    auto stats = co_await fs::lstat(entry.path, loop);
+    if(!stats.has_value()) {
+        co_return false;
+    }
+    if(entry.kind == fs::dirent::type::unknown) {
+        entry.kind = kind_from_mode(stats->mode);
+    }
+    entry.stats = std::move(*stats);
+    co_return true;
+}
+
+}  // namespace
+
+generator<fs::walk_entry, error>
+    fs::walk(std::string root, walk_options options, event_loop& loop) {
+    struct pending_dir {
+        std::string path;
+        std::size_t depth;
+    };
+
+    const auto window = (std::max)(options.max_concurrency, std::size_t(1));
+
+    std::vector<pending_dir> stack;
+    stack.push_back({std::move(root), 0});
+    while(!stack.empty()) {
+        auto current = std::move(stack.back());
+        stack.pop_back();
+
+        auto opened = co_await fs::opendir(current.path, loop);
+        if(!opened.has_value()) {
+            if(current.depth == 0) {
+                co_await fail(std::move(opened).error());
+            }
+            continue;
+        }
+
+        // Read the whole listing and close the handle before yielding
+        // anything, so a consumer that stops early never leaks it.
+        auto dir = std::move(*opened);
+        std::vector<walk_entry> entries;
+        error listing_error;
+        while(true) {
+            auto batch = co_await fs::readdir(dir, loop);
+            if(!batch.has_value()) {
+                listing_error = batch.error();
+                break;
+            }
+            if(batch->empty()) {
+                break;
+            }
+            for(auto& ent: *batch) {
+                entries.push_back({
+                    .path = join_path(current.path, ent.name),
+                    .kind = ent.kind,
+                    .depth = current.depth + 1,
+                });
+            }
+        }
+        co_await fs::closedir(dir, loop);
+        if(listing_error && current.depth == 0) {
+            co_await fail(listing_error);
+        }
+
+        std::vector<pending_dir> children;
+        for(std::size_t begin = 0; begin < entries.size(); begin += window) {
+            const auto end = (std::min)(entries.size(), begin + window);
+
+            // The listing already carries d_type on most filesystems, so
+            // only entries it could not classify need an lstat.
+            small_vector<task<bool>> stats;
+            for(auto i = begin; i < end; ++i) {
+                if(options.stat || entries[i].kind == dirent::type::unknown) {
+                    stats.push_back(walk_stat(entries[i], loop));
+                }
+            }
+            if(!stats.empty()) {
+                co_await when_all(std::move(stats));
+            }
+
+            for(auto i = begin; i < end; ++i) {
+                auto& entry = entries[i];
+                if(entry.kind == dirent::type::dir && entry.depth < options.max_depth &&
+                   !(options.prune && options.prune(entry))) {
+                    children.push_back({entry.path, entry.depth});
+                }
+                co_yield std::move(entry);
+            }
+        }
+
+        // Reversed, so that subdirectories are entered in listing order.
+        for(auto& child: children | std::views::reverse) {
+            stack.push_back(std::move(child));
+        }
+    }
+}
+
+task<std::string, error> fs::read_file(std::string_view path, event_loop& loop) {
+    auto content =
+        co_await queue([p = std::string(path)] { return sync::read_to_string(p); }, loop).or_fail();
+    if(!content) {
+        co_await fail(content.error());
+    }
+    co_return std::move(*content);
+}
+
+task<std::vector<result<std::string>>, error>
+    fs::read_many(std::span<const std::string> paths, std::size_t batch, event_loop& loop) {
+    using contents = std::vector<result<std::string>>;
+
+    const auto step = (std::max)(batch, std::size_t(1));
+    small_vector<task<contents, error>> jobs;
+    jobs.reserve((paths.size() + step - 1) / step);
+    for(std::size_t begin = 0; begin < paths.size(); begin += step) {
+        auto chunk = paths.subspan(begin, (std::min)(step, paths.size() - begin));
+        jobs.push_back(queue(
+            [chunk] {
+                contents out;
+                out.reserve(chunk.size());
+                for(auto& path: chunk) {
+                    out.push_back(sync::read_to_string(path));
+                }
+                return out;
+            },
+            loop));
+    }
+
+    auto parts = co_await when_all(std::move(jobs));
+    if(parts.has_error()) {
+        co_await fail(std::move(parts).error());
+    }
+
+    contents out;
+    out.reserve(paths.size());
+    for(auto& part: *parts) {
+        std::ranges::move(part, std::back_inserter(out));
+    }
+    co_return out;
+}
+
 // ============================================================================
 // Synchronous file operations
 // ============================================================================
@@ -648,7 +979,7 @@ uv_loop_t* sync_loop() noexcept {
         uv_loop_t loop{};
 
         sync_loop_holder() {
-            if(uv_loop_init(&loop) != 0) {
+            if(uv::loop_init(loop)) {
                 std::terminate();
             }
         }
@@ -709,16 +1040,37 @@ error fs::sync::close(int fd) {
     return {};
 }
 
+result<fs::file_stats> fs::sync::fstat(int fd) {
+    uv_fs_t req{};
+    int r = uv_fs_fstat(sync_loop(), &req, fd, nullptr);
+    auto stats = to_file_stats(req.statbuf);
+    uv_fs_req_cleanup(&req);
+    if(r < 0) {
+        return outcome_error(uv::status_to_error(r));
+    }
+    return stats;
+}
+
 result<std::string> fs::sync::read_to_string(std::string_view path) {
     auto fd = open(path, UV_FS_O_RDONLY);
     if(!fd) {
         return outcome_error(fd.error());
     }
 
-    std::string content;
-    char buf[4096];
+    // One spare byte lets the read after the last one report the end
+    // without growing the buffer.
+    std::size_t capacity = 4096;
+    if(auto stats = fstat(*fd); stats && stats->size > 0) {
+        capacity = static_cast<std::size_t>(stats->size) + 1;
+    }
+
+    std::string content(capacity, '\0');
+    std::size_t filled = 0;
     while(true) {
-        auto n = read(*fd, std::span<char>(buf, sizeof(buf)));
+        if(filled == content.size()) {
+            content.resize(content.size() * 2);
+        }
+        auto n = read(*fd, std::span<char>(content.data() + filled, content.size() - filled));
         if(!n) {
             close(*fd);
             return outcome_error(n.error());
@@ -726,10 +1078,11 @@ result<std::string> fs::sync::read_to_string(std::string_view path) {
         if(*n == 0) {
             break;
         }
-        content.append(buf, *n);
+        filled += *n;
     }
 
     close(*fd);
+    content.resize(filled);
     return content;
 }
 
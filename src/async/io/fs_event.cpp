@@ -1,8 +1,11 @@
 #include "kota/async/io/fs_event.h"
 
 #include <cassert>
+#include <utility>
 
 #include "awaiter.h"
+#include "change_batch.h"
+#include "kota/async/io/deadline.h"
 #include "kota/async/io/loop.h"
 #include "kota/async/vocab/error.h"
 
@@ -12,6 +15,12 @@ struct fs_event::Self :
     uv::handle<fs_event::Self, uv_fs_event_t>,
     uv::latest_value_delivery<fs_event::change> {
     uv_fs_event_t handle{};
+    event_loop* loop = nullptr;
+
+    // Set by the first wait_batch(); changes then collect in `batch`
+    // instead of going through the latest-value slot.
+    bool batching = false;
+    fs_change_batch batch;
 };
 
 namespace {
@@ -85,7 +94,11 @@ struct fs_event_await : uv::await_op<fs_event_await> {
         assert(watcher != nullptr && "on_change requires watcher state in handle->data");
 
         if(auto err = uv::status_to_error(status)) {
-            watcher->deliver(err);
+            if(watcher->batching) {
+                watcher->batch.add_error(err);
+            } else {
+                watcher->deliver(err);
+            }
             return;
         }
 
@@ -95,7 +108,11 @@ struct fs_event_await : uv::await_op<fs_event_await> {
         }
         c.flags = to_fs_change_flags(events);
 
-        watcher->deliver(std::move(c));
+        if(watcher->batching) {
+            watcher->batch.add(std::move(c));
+        } else {
+            watcher->deliver(std::move(c));
+        }
     }
 
     bool await_ready() const noexcept {
@@ -120,8 +137,89 @@ struct fs_event_await : uv::await_op<fs_event_await> {
     }
 };
 
+/// Suspends wait_change_batch() until the first change or error arrives.
+struct fs_change_batch_await : uv::await_op<fs_change_batch_await> {
+    using await_base = uv::await_op<fs_change_batch_await>;
+    using promise_t = task<std::vector<fs_event::change>, error>::promise_type;
+
+    fs_change_batch* batch;
+
+    explicit fs_change_batch_await(fs_change_batch& batch) : batch(&batch) {}
+
+    static void on_cancel(system_op* op) {
+        await_base::complete_cancel(op, [](auto& aw) { aw.batch->waiter = nullptr; });
+    }
+
+    bool await_ready() const noexcept {
+        return batch->ready();
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        batch->waiter = this;
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    void await_resume() const noexcept {}
+};
+
 }  // namespace
 
+void fs_change_batch::add(fs_event::change&& change) {
+    auto [it, inserted] = index.try_emplace(change.path, changes.size());
+    if(inserted) {
+        changes.push_back(std::move(change));
+    } else {
+        auto& flags = changes[it->second].flags;
+        flags.rename = flags.rename || change.flags.rename;
+        flags.change = flags.change || change.flags.change;
+    }
+
+    if(auto* op = std::exchange(waiter, nullptr)) {
+        op->complete();
+    }
+}
+
+void fs_change_batch::add_error(error err) {
+    if(!failure) {
+        failure = err;
+    }
+
+    if(auto* op = std::exchange(waiter, nullptr)) {
+        op->complete();
+    }
+}
+
+task<std::vector<fs_event::change>, error>
+    wait_change_batch(fs_change_batch& batch, std::chrono::milliseconds window, event_loop& loop) {
+    if(batch.busy) {
+        co_await fail(error::connection_already_in_progress);
+    }
+
+    // Released however the call ends, including cancellation in the window.
+    struct busy_guard {
+        fs_change_batch& batch;
+
+        ~busy_guard() {
+            batch.busy = false;
+        }
+    } guard{batch};
+    batch.busy = true;
+
+    co_await fs_change_batch_await{batch};
+    if(window.count() > 0 && !batch.changes.empty()) {
+        co_await after(window, loop);
+    }
+
+    if(batch.changes.empty()) {
+        co_await fail(std::exchange(batch.failure, {}));
+    }
+
+    batch.index.clear();
+    co_return std::exchange(batch.changes, {});
+}
+
 fs_event::fs_event() noexcept = default;
 
 fs_event::fs_event(unique_handle<Self> self) noexcept : self(std::move(self)) {}
@@ -141,6 +239,7 @@ result<fs_event> fs_event::create(event_loop& loop) {
     if(auto err = uv::fs_event_init(loop, self->handle)) {
         return outcome_error(err);
     }
+    self->loop = &loop;
 
     return fs_event(std::move(self));
 }
@@ -181,6 +280,10 @@ task<fs_event::change, error> fs_event::wait() {
         co_await fail(error::invalid_argument);
     }
 
+    if(self->batching) {
+        co_await fail(error::invalid_argument);
+    }
+
     if(self->has_pending()) {
         co_return self->take_pending();
     }
@@ -192,4 +295,24 @@ task<fs_event::change, error> fs_event::wait() {
     co_return co_await fs_event_await{self.get()};
 }
 
+task<std::vector<fs_event::change>, error> fs_event::wait_batch(std::chrono::milliseconds window) {
+    if(!self) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(!self->batching) {
+        self->batching = true;
+        if(self->has_pending()) {
+            auto pending = self->take_pending();
+            if(pending) {
+                self->batch.add(std::move(*pending));
+            } else {
+                self->batch.add_error(pending.error());
+            }
+        }
+    }
+
+    co_return co_await wait_change_batch(self->batch, window, *self->loop).or_fail();
+}
+
 }  // namespace kota
@@ -1,35 +1,223 @@
 #include "kota/async/io/loop.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
-#include <deque>
+#include <utility>
 
+#include "resolve_cache.h"
+#include "timer_wheel.h"
 #include "../libuv.h"
+#include "../runtime/frame_pool.h"
+#include "../runtime/loop_stats.h"
+#include "../runtime/trace.h"
 #include "kota/support/functional.h"
 #include "kota/async/runtime/frame.h"
+#include "kota/async/runtime/task.h"
 
 namespace kota {
 
 /// A node in the lock-free MPSC (multi-producer, single-consumer) queue
-/// used by event_loop::post(). Each post() allocates a node, atomically
-/// pushes it onto the intrusive stack, and signals uv_async_t. The event
-/// loop thread pops all nodes in one atomic exchange and executes them.
+/// used by event_loop::post(). Each post() takes a node from the
+/// producer's cache (allocating only when the cache and the loop's free list
+/// are both empty), atomically pushes it onto the intrusive stack, and
+/// signals uv_async_t if the stack was empty. The event loop thread pops all
+/// nodes in one atomic exchange, executes them, and recycles the nodes.
 struct post_node {
-    function<void()> callback;
+    loop_callback callback;
     post_node* next = nullptr;
 };
 
+/// Thread-local cache of spare post_nodes for producers.
+///
+/// Consumed nodes are pushed back onto their loop's `free_head`. A producer
+/// whose cache is empty takes that whole list with a single exchange, so the
+/// free list only ever sees CAS pushes from the consumer and exchanges from
+/// producers and is not exposed to ABA. Nodes are plain heap objects, so a
+/// node taken from one loop may later be posted to any other.
+struct post_node_cache {
+    post_node* head = nullptr;
+
+    post_node_cache() = default;
+
+    post_node_cache(const post_node_cache&) = delete;
+    post_node_cache& operator=(const post_node_cache&) = delete;
+
+    ~post_node_cache() {
+        while(head) {
+            delete std::exchange(head, head->next);
+        }
+    }
+
+    post_node* acquire(std::atomic<post_node*>& pool, loop_callback&& callback) {
+        if(!head) {
+            head = pool.exchange(nullptr, std::memory_order_acquire);
+        }
+        if(!head) {
+            return new post_node{std::move(callback)};
+        }
+
+        auto* node = std::exchange(head, head->next);
+        node->callback = std::move(callback);
+        node->next = nullptr;
+        return node;
+    }
+};
+
+thread_local post_node_cache post_nodes;
+
+/// Intrusive FIFO of nodes waiting to be resumed on the next idle tick.
+/// The links live in async_node::next_ready, so scheduling never allocates
+/// and a tick walks the nodes themselves instead of a separate buffer.
+struct run_queue {
+    async_node* head = nullptr;
+    async_node* tail = nullptr;
+#if KOTA_ASYNC_LOOP_STATS
+    std::size_t size = 0;
+#endif
+
+    bool empty() const noexcept {
+        return head == nullptr;
+    }
+
+    void push(async_node* node) noexcept {
+        assert(node->next_ready == nullptr && node != tail && "node is already queued");
+        if(tail) {
+            tail->next_ready = node;
+        } else {
+            head = node;
+        }
+        tail = node;
+#if KOTA_ASYNC_LOOP_STATS
+        size += 1;
+#endif
+    }
+
+    /// Detaches the whole queue, leaving this one empty.
+    run_queue take() noexcept {
+        return std::exchange(*this, run_queue{});
+    }
+
+    /// Detaches at most `limit` nodes from the front.
+    run_queue take(std::size_t limit) noexcept {
+        if(empty() || limit == 0) {
+            return {};
+        }
+
+        auto* last = head;
+        std::size_t count = 1;
+        while(count < limit && last->next_ready) {
+            last = last->next_ready;
+            count += 1;
+        }
+        if(!last->next_ready) {
+            return take();
+        }
+
+        run_queue front;
+        front.head = head;
+        front.tail = last;
+        head = std::exchange(last->next_ready, nullptr);
+#if KOTA_ASYNC_LOOP_STATS
+        front.size = count;
+        size -= count;
+#endif
+        return front;
+    }
+};
+
+constexpr std::size_t lane_count = 3;
+
+constexpr std::size_t lane_index(priority lane) noexcept {
+    return static_cast<std::size_t>(lane);
+}
+
 struct event_loop::self {
     uv_loop_t loop = {};
     uv_idle_t idle = {};
     uv_async_t async = {};
     bool idle_running = false;
-    std::deque<async_node*> tasks;
+
+    /// Ready nodes, one FIFO per priority, indexed by lane_index().
+    run_queue lanes[lane_count];
+
+    /// Background nodes resumed per tick, see set_background_budget().
+    std::size_t background_budget = 64;
+
+    /// See set_time_slice(); 0 makes yield() always requeue.
+    std::uint64_t time_slice_ns = 0;
+
+    /// uv_hrtime() when the node being run was resumed from the ready queue.
+    /// Only stamped while a time slice is set.
+    std::uint64_t slice_start = 0;
+
+    /// See set_busy_poll(); 0 runs libuv's own blocking loop.
+    std::uint64_t busy_poll_ns = 0;
+
+    /// Set by stop(), which libuv forgets once the current uv_run returns.
+    bool stop_requested = false;
+
+    /// Recycled coroutine frames; active on this thread while run() is.
+    frame_pool frames;
+
+    /// Only updated when built with KOTA_ASYNC_LOOP_STATS.
+    loop_stats stats;
+
+    /// Only recorded into when built with KOTA_ASYNC_TRACE.
+    task_trace trace;
+
+    /// Timeouts from after() and deadline, all driven by `wheel_timer`.
+    timer_wheel wheel;
+    uv_timer_t wheel_timer = {};
+
+    /// Caps how long run_once() waits; stopped outside it.
+    uv_timer_t run_once_timer = {};
+
+    /// Tick `wheel_timer` is started for, or `never` while it is stopped.
+    std::uint64_t wheel_due = timer_wheel::never;
+
+    /// Set while the wheel fires entries; rescheduling waits until it is done.
+    bool advancing = false;
+
+    /// See dns_cache().
+    detail::resolve_cache dns;
 
     /// Lock-free MPSC stack head. Writers (any thread) push via CAS in
     /// post(); the single consumer (event loop thread) drains via exchange
     /// in the uv_async_t callback. No mutex required.
     std::atomic<post_node*> post_head{nullptr};
+
+    /// Nodes whose callbacks have run, waiting to be reused by producers.
+    /// Only the loop thread pushes; producers take the whole list at once.
+    std::atomic<post_node*> free_head{nullptr};
+
+    /// Pushes the chain [first, last] onto the post stack and signals the
+    /// loop if the stack was empty. A non-empty stack already has a wakeup
+    /// on its way, since whoever made it non-empty sent one.
+    void push_posts(post_node* first, post_node* last) noexcept;
+
+    bool ready_empty() const noexcept {
+        for(auto& lane: lanes) {
+            if(!lane.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Runs the loop like UV_RUN_DEFAULT, but spins on non-blocking polls
+    /// while events keep arriving within `busy_poll_ns` of each other.
+    int run_busy_poll();
+
+    /// Queues `node` in `lane`, starting the idle tick if nothing was ready.
+    void push_ready(async_node& node, priority lane) noexcept;
+
+    /// Resumes every node of `batch` in order.
+    void run_batch(run_queue batch);
+
+    /// Points `wheel_timer` at the wheel's next tick, or stops it when the
+    /// wheel is empty so pending timeouts are all that keep the loop alive.
+    void schedule_wheel() noexcept;
 };
 
 // ── relay implementation ────────────────────────────────────────────
@@ -37,13 +225,18 @@ struct event_loop::self {
 struct relay::self {
     uv_async_t async = {};
     bool has_callback = false;
-    function<void()> callback{+[] {}};
+    loop_callback callback;
 };
 
 static void on_relay(uv_async_t* handle) {
     auto* p = static_cast<struct relay::self*>(handle->data);
+#if KOTA_ASYNC_LOOP_STATS
+    if(auto* stats = active_loop_stats(); stats && p->has_callback) {
+        stats->relay_sends += 1;
+    }
+#endif
     if(p->has_callback) {
-        p->callback();
+        std::move(p->callback)();
     }
     // Close the handle, releasing the loop hold. The close callback
     // frees the impl once libuv is done with the handle.
@@ -75,7 +268,7 @@ relay::~relay() {
     }
 }
 
-void relay::send(function<void()> callback) {
+void relay::send(loop_callback callback) {
     auto* p = std::exchange(self, nullptr);
     if(!p) {
         return;  // Already sent or moved-from.
@@ -104,20 +297,77 @@ event_loop& event_loop::current() {
 
 void each(uv_idle_t* idle) {
     auto self = static_cast<struct event_loop::self*>(idle->data);
-    if(self->idle_running && self->tasks.empty()) {
+#if KOTA_ASYNC_LOOP_STATS
+    self->stats.idle_callbacks += 1;
+#endif
+    if(self->idle_running && self->ready_empty()) {
         self->idle_running = false;
         uv::idle_stop(*idle);
         return;
     }
 
     /// Resume may create new tasks, we want to run them in the next iteration.
-    auto all = std::move(self->tasks);
-    for(auto& task: all) {
-        task->resume();
+    /// Every lane is snapshotted before any of it runs, so higher lanes go
+    /// first without being able to starve lower ones. Background work is
+    /// further capped per tick so a backlog of it cannot delay I/O polling.
+    auto interactive = self->lanes[lane_index(priority::interactive)].take();
+    auto normal = self->lanes[lane_index(priority::normal)].take();
+    auto background = self->lanes[lane_index(priority::background)].take(self->background_budget);
+
+    self->run_batch(interactive);
+    self->run_batch(normal);
+    self->run_batch(background);
+}
+
+void event_loop::self::run_batch(run_queue batch) {
+    auto* task = batch.head;
+    while(task) {
+        // Unlink before resuming: the task may finish and be destroyed, or
+        // reschedule itself onto the fresh queue.
+        auto* next = std::exchange(task->next_ready, nullptr);
+#if KOTA_ASYNC_LOOP_STATS
+        stats.resumed += 1;
+#endif
+        if(time_slice_ns != 0) {
+            slice_start = uv::hrtime();
+        }
+        // The only system operations on the ready queue are reschedule()
+        // points; completing one resumes the task that awaited it.
+        auto resume = [task] {
+            if(task->kind == async_node::NodeKind::SystemIO) {
+                static_cast<system_op*>(task)->complete();
+            } else {
+                task->resume();
+            }
+        };
+#if KOTA_ASYNC_TRACE
+        if(trace.tracing()) {
+            trace.resume_slice(*task, resume);
+            task = next;
+            continue;
+        }
+#endif
+        resume();
+        task = next;
+    }
+}
+
+void event_loop::self::push_ready(async_node& node, priority lane) noexcept {
+    if(!idle_running && ready_empty()) {
+        idle_running = true;
+        uv::idle_start(idle, each);
+    }
+    lanes[lane_index(lane)].push(&node);
+#if KOTA_ASYNC_LOOP_STATS
+    std::size_t depth = 0;
+    for(auto& queue: lanes) {
+        depth += queue.size;
     }
+    stats.max_ready = (std::max)(stats.max_ready, depth);
+#endif
 }
 
-void event_loop::schedule(async_node& frame, std::source_location loc) {
+void event_loop::schedule(async_node& frame, std::source_location loc, priority lane) {
     assert(self && "schedule: no current event loop in this thread");
 
     if(frame.state == async_node::Pending) {
@@ -127,16 +377,111 @@ void event_loop::schedule(async_node& frame, std::source_location loc) {
     }
 
     frame.location = loc;
-    auto& loop = *this;
-    if(!loop->idle_running && loop->tasks.empty()) {
-        loop->idle_running = true;
-        uv::idle_start(loop->idle, each);
+    self->push_ready(frame, lane);
+#if KOTA_ASYNC_TRACE
+    if(self->trace.tracing()) {
+        self->trace.instant(task_trace::Phase::Create, frame);
     }
-    loop->tasks.push_back(&frame);
+#endif
+#if KOTA_ASYNC_LOOP_STATS
+    self->stats.scheduled += 1;
+#endif
+}
+
+void event_loop::set_background_budget(std::size_t nodes) noexcept {
+    self->background_budget = nodes == 0 ? 1 : nodes;
+}
+
+void event_loop::set_time_slice(std::chrono::nanoseconds slice) noexcept {
+    self->time_slice_ns = slice.count() > 0 ? static_cast<std::uint64_t>(slice.count()) : 0;
+}
+
+void event_loop::set_busy_poll(std::chrono::nanoseconds window) noexcept {
+    self->busy_poll_ns = window.count() > 0 ? static_cast<std::uint64_t>(window.count()) : 0;
+}
+
+int event_loop::self::run_busy_poll() {
+    int alive = 1;
+    while(alive != 0 && !stop_requested) {
+        auto last_activity = uv::hrtime();
+        while(true) {
+            const auto events = uv::metrics_events(loop);
+            alive = uv::run(loop, UV_RUN_NOWAIT);
+            if(alive == 0 || stop_requested) {
+                return alive;
+            }
+
+            // Ready tasks keep the idle tick running, which is work too.
+            const auto now = uv::hrtime();
+            if(uv::metrics_events(loop) != events || idle_running) {
+#if KOTA_ASYNC_LOOP_STATS
+                stats.spin_hits += 1;
+#endif
+                last_activity = now;
+            } else {
+#if KOTA_ASYNC_LOOP_STATS
+                stats.spin_misses += 1;
+#endif
+                if(now - last_activity >= busy_poll_ns) {
+                    break;
+                }
+            }
+        }
+
+#if KOTA_ASYNC_LOOP_STATS
+        stats.sleeps += 1;
+#endif
+        alive = uv::run(loop, UV_RUN_ONCE);
+    }
+    return alive;
+}
+
+namespace {
+
+/// Ready-queue entry standing in for the task that awaits it. Cancelling it
+/// only marks it; it is still completed, and reports the cancellation, when
+/// its turn comes, so the queue never holds a dangling node.
+struct reschedule_op : system_op {
+    using promise_t = task<>::promise_type;
+
+    event_loop* loop;
+    priority lane;
+
+    reschedule_op(event_loop& loop, priority lane) : loop(&loop), lane(lane) {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        (*loop)->push_ready(*this, lane);
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+}  // namespace
+
+task<> reschedule(priority lane, event_loop& loop) {
+    co_await reschedule_op{loop, lane};
+}
+
+task<> yield(event_loop& loop) {
+    auto* self = loop.operator->();
+    if(self->time_slice_ns != 0 && uv::hrtime() - self->slice_start < self->time_slice_ns) {
+        co_return;
+    }
+    co_await reschedule_op{loop, priority::normal};
 }
 
 void on_post(uv_async_t* handle) {
     auto* self = static_cast<struct event_loop::self*>(handle->data);
+#if KOTA_ASYNC_LOOP_STATS
+    self->stats.async_callbacks += 1;
+#endif
 
     // Atomically steal the entire pending list. Producers may keep
     // pushing concurrently — those nodes will be picked up next time.
@@ -151,38 +496,142 @@ void on_post(uv_async_t* handle) {
         head = next;
     }
 
-    // Execute all callbacks on the event loop thread, then free nodes.
+    // Execute all callbacks on the event loop thread, then hand the nodes
+    // back to producers in one push.
+    post_node* recycled = nullptr;
+    post_node* recycled_tail = nullptr;
     while(reversed) {
         auto* node = reversed;
         reversed = reversed->next;
-        node->callback();
-        delete node;
+#if KOTA_ASYNC_LOOP_STATS
+        self->stats.posts += 1;
+#endif
+        // Calling consumes the callback, so its captures are released now
+        // rather than when the node is reused.
+        std::move(node->callback)();
+
+        node->next = recycled;
+        recycled = node;
+        if(!recycled_tail) {
+            recycled_tail = node;
+        }
     }
-}
 
-void event_loop::post(function<void()> callback) {
-    assert(self && "post: event loop has been destroyed");
-
-    auto* node = new post_node{std::move(callback)};
+    if(recycled) {
+        auto* free = self->free_head.load(std::memory_order_relaxed);
+        do {
+            recycled_tail->next = free;
+        } while(!self->free_head.compare_exchange_weak(free,
+                                                       recycled,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed));
+    }
+}
 
-    // Lock-free push: CAS the new node onto the head of the stack.
-    // acq_rel on success: release makes this node's callback visible to
+void event_loop::self::push_posts(post_node* first, post_node* last) noexcept {
+    // Lock-free push: CAS the chain onto the head of the stack.
+    // acq_rel on success: release makes the chain's callbacks visible to
     // the consumer; acquire chains the visibility of all nodes pushed by
     // earlier producers (without acquire here, the consumer could follow
     // the next-pointer chain but see uninitialised callback data on
     // weakly-ordered architectures like ARM).
-    // uv_async_send is thread-safe and coalescing — multiple sends
-    // before the loop iterates result in a single callback invocation,
-    // which is fine because on_post drains the entire list each time.
-    auto* head = self->post_head.load(std::memory_order_relaxed);
+    auto* head = post_head.load(std::memory_order_relaxed);
     do {
-        node->next = head;
-    } while(!self->post_head.compare_exchange_weak(head,
-                                                   node,
-                                                   std::memory_order_acq_rel,
-                                                   std::memory_order_relaxed));
+        last->next = head;
+    } while(!post_head.compare_exchange_weak(head,
+                                             first,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+
+    // on_post drains the entire stack each time, so only the push that makes
+    // it non-empty needs to wake the loop.
+    if(head == nullptr) {
+        uv::async_send(async);
+    }
+}
+
+void event_loop::post(loop_callback callback) {
+    assert(self && "post: event loop has been destroyed");
+
+    auto* node = post_nodes.acquire(self->free_head, std::move(callback));
+    self->push_posts(node, node);
+}
+
+void event_loop::post_batch(std::span<loop_callback> callbacks) {
+    assert(self && "post_batch: event loop has been destroyed");
+
+    if(callbacks.empty()) {
+        return;
+    }
+
+    // The stack is LIFO, so link the chain newest-first. on_post reverses
+    // it and the callbacks run in span order.
+    post_node* first = nullptr;
+    post_node* last = nullptr;
+    for(auto& callback: callbacks) {
+        auto* node = post_nodes.acquire(self->free_head, std::move(callback));
+        node->next = first;
+        first = node;
+        if(!last) {
+            last = node;
+        }
+    }
+
+    self->push_posts(first, last);
+}
+
+static void on_wheel(uv_timer_t* handle) {
+    auto* self = static_cast<struct event_loop::self*>(handle->data);
+#if KOTA_ASYNC_LOOP_STATS
+    self->stats.timer_callbacks += 1;
+#endif
+    self->wheel_due = timer_wheel::never;
+    self->advancing = true;
+    self->wheel.advance(uv::now(self->loop));
+    self->advancing = false;
+    self->schedule_wheel();
+}
+
+void event_loop::self::schedule_wheel() noexcept {
+    if(advancing) {
+        return;
+    }
+
+    if(wheel.empty()) {
+        if(wheel_due != timer_wheel::never) {
+            uv::timer_stop(wheel_timer);
+            wheel_due = timer_wheel::never;
+        }
+        return;
+    }
+
+    const auto next = wheel.next_tick();
+    if(next == wheel_due) {
+        return;
+    }
 
-    uv::async_send(self->async);
+    const auto now = uv::now(loop);
+    wheel_due = next;
+    uv::timer_start(wheel_timer, on_wheel, next > now ? next - now : 0, 0);
+}
+
+void event_loop::arm_timeout(detail::wheel_entry& entry, std::chrono::milliseconds timeout) noexcept {
+    const auto now = uv::now(self->loop);
+    const auto delay = timeout.count() > 0 ? static_cast<std::uint64_t>(timeout.count()) : 0;
+    self->wheel.arm(entry, now + delay, now);
+    self->schedule_wheel();
+}
+
+void event_loop::disarm_timeout(detail::wheel_entry& entry) noexcept {
+    if(!entry.armed()) {
+        return;
+    }
+    self->wheel.disarm(entry);
+    self->schedule_wheel();
+}
+
+detail::resolve_cache& event_loop::dns_cache() noexcept {
+    return self->dns;
 }
 
 event_loop::event_loop() : self(new struct self()) {
@@ -200,6 +649,19 @@ event_loop::event_loop() : self(new struct self()) {
     async.data = self.get();
     // Unref so the async handle alone does not keep the loop alive.
     uv::unref(async);
+
+#if KOTA_ASYNC_LOOP_STATS
+    // Best effort: without it idle_ns stays zero and all time counts as busy.
+    uv::enable_idle_metrics(loop);
+#endif
+
+    auto& wheel_timer = self->wheel_timer;
+    uv::timer_init(loop, wheel_timer);
+    wheel_timer.data = self.get();
+
+    auto& run_once_timer = self->run_once_timer;
+    uv::timer_init(loop, run_once_timer);
+    uv::unref(run_once_timer);
 }
 
 event_loop::~event_loop() {
@@ -208,7 +670,9 @@ event_loop::~event_loop() {
         if(!uv::is_closing(*h)) {
             auto* idle = uv::as_handle(self->idle);
             auto* async = uv::as_handle(self->async);
-            if(h == idle || h == async) {
+            auto* wheel_timer = uv::as_handle(self->wheel_timer);
+            auto* run_once_timer = uv::as_handle(self->run_once_timer);
+            if(h == idle || h == async || h == wheel_timer || h == run_once_timer) {
                 uv::close(*h, nullptr);
                 return;
             }
@@ -226,6 +690,11 @@ event_loop::~event_loop() {
         leaked = next;
     }
 
+    auto* spare = self->free_head.exchange(nullptr, std::memory_order_acquire);
+    while(spare) {
+        delete std::exchange(spare, spare->next);
+    }
+
     auto& loop = self->loop;
     auto close_err = uv::loop_close(loop);
     if(close_err.value() == UV_EBUSY) {
@@ -246,16 +715,121 @@ event_loop::operator const uv_loop_t&() const noexcept {
     return self->loop;
 }
 
-int event_loop::run() {
+namespace {
+
+/// Makes `owner` the current loop on this thread, with its frame pool, trace
+/// and counters active, for the duration of `body`, which runs uv_run.
+template <typename Body>
+int run_as_current(event_loop& owner, struct event_loop::self& self, Body&& body) {
     auto previous = current_loop;
-    current_loop = this;
-    const int result = uv::run(self->loop, UV_RUN_DEFAULT);
+    current_loop = &owner;
+    auto* previous_pool = exchange_active_frame_pool(&self.frames);
+#if KOTA_ASYNC_TRACE
+    auto* previous_trace = exchange_active_trace(&self.trace);
+#endif
+#if KOTA_ASYNC_LOOP_STATS
+    auto* previous_stats = exchange_active_loop_stats(&self.stats);
+    const auto started = uv::hrtime();
+    const auto idle_before = uv::metrics_idle_time(self.loop);
+    const auto iterations_before = uv::metrics_loop_count(self.loop);
+#endif
+    const int result = body();
+    self.stop_requested = false;
+#if KOTA_ASYNC_LOOP_STATS
+    const auto elapsed = uv::hrtime() - started;
+    const auto idle = uv::metrics_idle_time(self.loop) - idle_before;
+    auto& stats = self.stats;
+    stats.iterations += uv::metrics_loop_count(self.loop) - iterations_before;
+    stats.idle_ns += idle;
+    stats.busy_ns += elapsed > idle ? elapsed - idle : 0;
+    exchange_active_loop_stats(previous_stats);
+#endif
+#if KOTA_ASYNC_TRACE
+    exchange_active_trace(previous_trace);
+#endif
+    exchange_active_frame_pool(previous_pool);
     current_loop = previous;
     return result;
 }
 
+}  // namespace
+
+int event_loop::run() {
+    return run_as_current(*this, *self, [&] {
+        return self->busy_poll_ns != 0 ? self->run_busy_poll()
+                                       : uv::run(self->loop, UV_RUN_DEFAULT);
+    });
+}
+
+int event_loop::run_once(std::chrono::milliseconds timeout) {
+    return run_as_current(*this, *self, [&] {
+        if(timeout.count() <= 0) {
+            return uv::run(self->loop, UV_RUN_NOWAIT);
+        }
+
+        // An armed timer bounds the poll even while unreferenced, so this
+        // one caps the wait without keeping the loop alive.
+        uv::timer_start(self->run_once_timer,
+                        [](uv_timer_t*) {},
+                        static_cast<std::uint64_t>(timeout.count()),
+                        0);
+        const int alive = uv::run(self->loop, UV_RUN_ONCE);
+        uv::timer_stop(self->run_once_timer);
+        return alive;
+    });
+}
+
+int event_loop::backend_fd() const noexcept {
+    return uv::backend_fd(self->loop);
+}
+
+std::optional<std::chrono::milliseconds> event_loop::next_timeout() const noexcept {
+    const int timeout = uv::backend_timeout(self->loop);
+    if(timeout < 0) {
+        return std::nullopt;
+    }
+    return std::chrono::milliseconds(timeout);
+}
+
 void event_loop::stop() {
+    self->stop_requested = true;
     uv::stop(self->loop);
 }
 
+void event_loop::set_frame_pool_enabled(bool enabled) noexcept {
+    self->frames.set_enabled(enabled);
+}
+
+frame_pool_stats event_loop::frame_stats() const noexcept {
+    return self->frames.stats();
+}
+
+loop_stats event_loop::stats() const noexcept {
+    return self->stats;
+}
+
+void event_loop::start_trace([[maybe_unused]] std::size_t capacity) {
+#if KOTA_ASYNC_TRACE
+    self->trace.start(capacity);
+#endif
+}
+
+void event_loop::stop_trace() noexcept {
+    self->trace.stop();
+}
+
+void event_loop::trace_mark([[maybe_unused]] name_id name,
+                            [[maybe_unused]] std::source_location location) noexcept {
+#if KOTA_ASYNC_TRACE
+    if(self->trace.tracing()) {
+        self->trace.mark(name, location);
+    }
+#endif
+}
+
+std::string event_loop::trace_json() const {
+    return self->trace.to_chrome_json(
+        static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(self.get()) >> 4));
+}
+
 }  // namespace kota
@@ -0,0 +1,414 @@
+#include "kota/async/io/loop_group.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../libuv.h"
+#include "../vocab/work_deque.h"
+#include "kota/async/runtime/frame.h"
+
+namespace kota {
+
+namespace {
+
+/// Upper bound on tasks a worker moves from its own deque into its loop per
+/// iteration. Leaving the rest in the deque keeps them visible to thieves
+/// instead of burying them in the loop's private ready queue.
+constexpr std::size_t pull_batch = 32;
+
+struct worker {
+    struct loop_group::self* group = nullptr;
+    std::size_t index = 0;
+
+    /// Owned by the worker thread; valid between startup and shutdown.
+    event_loop* loop = nullptr;
+
+    /// Ref'd wakeup handle. Keeps the loop alive while the group is running
+    /// and interrupts a parked worker's poll when new work arrives.
+    uv_async_t wake = {};
+
+    /// Runs before every poll and moves queued tasks into the loop.
+    uv_prepare_t pull = {};
+
+    /// Stealable tasks spawned from this worker's own thread.
+    work_stealing_deque<async_node> local;
+
+    /// Tasks pinned to this worker via spawn_on(). Never stolen.
+    std::mutex inbox_mutex;
+    std::vector<async_node*> inbox;
+
+    /// Set when the last pull found nothing to do and the loop is about to
+    /// block in poll. Producers clear it when they send a wakeup.
+    std::atomic<bool> parked{false};
+
+    std::thread thread;
+};
+
+thread_local loop_group* current_group = nullptr;
+thread_local worker* current_worker = nullptr;
+
+void destroy_unstarted(async_node* node) noexcept {
+    assert(node && node->is_standard_task() && node->state == async_node::Pending);
+    static_cast<standard_task*>(node)->handle().destroy();
+}
+
+}  // namespace
+
+struct loop_group::self {
+    loop_group* owner = nullptr;
+
+    std::vector<std::unique_ptr<worker>> workers;
+
+    /// Tasks spawned from threads that do not belong to the group.
+    std::mutex injected_mutex;
+    std::deque<async_node*> injected;
+
+    /// Number of workers that are currently parked. Only a hint used to skip
+    /// the wakeup scan on the hot spawn path.
+    std::atomic<std::size_t> parked_count{0};
+
+    /// Guards async_send against the worker closing its wake handle.
+    std::mutex wake_mutex;
+    bool stopping = false;
+
+    std::mutex outstanding_mutex;
+    std::condition_variable outstanding_cv;
+    std::size_t outstanding = 0;
+
+    static void start(worker& w, async_node* node) {
+        w.loop->schedule(*node, node->location);
+    }
+
+    async_node* take_injected() {
+        std::lock_guard lock(injected_mutex);
+        if(injected.empty()) {
+            return nullptr;
+        }
+        auto* node = injected.front();
+        injected.pop_front();
+        return node;
+    }
+
+    async_node* steal_for(worker& thief) {
+        const auto count = workers.size();
+        for(std::size_t offset = 1; offset < count; ++offset) {
+            auto& victim = *workers[(thief.index + offset) % count];
+            if(auto* node = victim.local.steal()) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    bool has_visible_work(worker& w) {
+        if(!w.local.empty()) {
+            return true;
+        }
+        {
+            std::lock_guard lock(w.inbox_mutex);
+            if(!w.inbox.empty()) {
+                return true;
+            }
+        }
+        {
+            std::lock_guard lock(injected_mutex);
+            if(!injected.empty()) {
+                return true;
+            }
+        }
+        return std::ranges::any_of(workers, [&](auto& other) {
+            return other.get() != &w && !other->local.empty();
+        });
+    }
+
+    /// Moves queued tasks into `w`'s event loop. Returns how many started.
+    std::size_t dispatch(worker& w) {
+        std::size_t started = 0;
+
+        std::vector<async_node*> pinned;
+        {
+            std::lock_guard lock(w.inbox_mutex);
+            pinned.swap(w.inbox);
+        }
+        for(auto* node: pinned) {
+            start(w, node);
+            started += 1;
+        }
+
+        while(started < pull_batch) {
+            auto* node = w.local.pop();
+            if(!node) {
+                break;
+            }
+            start(w, node);
+            started += 1;
+        }
+
+        // Take at least one injected task per iteration so external producers
+        // are not starved by a worker that keeps refilling its own deque.
+        if(started < pull_batch) {
+            if(auto* node = take_injected()) {
+                start(w, node);
+                started += 1;
+            }
+        }
+
+        if(started == 0) {
+            if(auto* node = steal_for(w)) {
+                start(w, node);
+                started += 1;
+            }
+        }
+
+        return started;
+    }
+
+    void unpark(worker& w) noexcept {
+        if(w.parked.exchange(false)) {
+            parked_count.fetch_sub(1);
+        }
+    }
+
+    /// Wakes one parked worker so it can pick up newly queued work.
+    void notify_parked() {
+        if(parked_count.load() == 0) {
+            return;
+        }
+
+        std::lock_guard lock(wake_mutex);
+        if(stopping) {
+            return;
+        }
+        for(auto& w: workers) {
+            bool expected = true;
+            if(w->parked.compare_exchange_strong(expected, false)) {
+                parked_count.fetch_sub(1);
+                uv::async_send(w->wake);
+                return;
+            }
+        }
+    }
+
+    static void on_pull(uv_prepare_t* handle) {
+        auto& w = *static_cast<worker*>(handle->data);
+        auto& group = *w.group;
+        group.unpark(w);
+
+        for(;;) {
+            if(group.dispatch(w) != 0) {
+                return;
+            }
+
+            // Publish the parked flag before re-checking the queues. A producer
+            // that queued work before seeing the flag is caught by the re-check;
+            // one that queues work afterwards observes the flag and wakes us.
+            w.parked.store(true);
+            group.parked_count.fetch_add(1);
+            if(!group.has_visible_work(w)) {
+                return;
+            }
+            group.unpark(w);
+        }
+    }
+
+    static void on_wake(uv_async_t* handle) {
+        auto& w = *static_cast<worker*>(handle->data);
+        auto& group = *w.group;
+
+        std::lock_guard lock(group.wake_mutex);
+        if(!group.stopping) {
+            // The following prepare phase picks up whatever was queued.
+            return;
+        }
+
+        uv::prepare_stop(w.pull);
+        uv::close(w.pull, nullptr);
+        uv::close(w.wake, nullptr);
+        w.loop->stop();
+    }
+
+    void run_worker(worker& w, std::latch& ready) {
+        event_loop loop;
+        uv_loop_t& raw = loop;
+
+        w.loop = &loop;
+        uv::async_init(raw, w.wake, on_wake);
+        w.wake.data = &w;
+        uv::prepare_init(raw, w.pull);
+        w.pull.data = &w;
+        uv::prepare_start(w.pull, on_pull);
+
+        current_group = owner;
+        current_worker = &w;
+        ready.count_down();
+
+        for(;;) {
+            loop.run();
+
+            // A task may call event_loop::current().stop() on its own; only leave
+            // once the group itself is stopping. The handles are normally closed by
+            // on_wake already, but close them here as well in case the stop request
+            // raced with a user-initiated loop stop.
+            std::lock_guard lock(wake_mutex);
+            if(stopping) {
+                if(!uv::is_closing(w.pull)) {
+                    uv::close(w.pull, nullptr);
+                }
+                if(!uv::is_closing(w.wake)) {
+                    uv::close(w.wake, nullptr);
+                }
+                break;
+            }
+        }
+
+        std::vector<async_node*> pinned;
+        {
+            std::lock_guard lock(w.inbox_mutex);
+            pinned.swap(w.inbox);
+        }
+        for(auto* node: pinned) {
+            destroy_unstarted(node);
+        }
+        while(auto* node = w.local.pop()) {
+            destroy_unstarted(node);
+        }
+
+        current_worker = nullptr;
+        current_group = nullptr;
+        w.loop = nullptr;
+    }
+};
+
+loop_group::loop_group(std::size_t workers) : self(new struct self()) {
+    if(workers == 0) {
+        workers = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    self->owner = this;
+    self->workers.reserve(workers);
+    for(std::size_t i = 0; i < workers; ++i) {
+        auto w = std::make_unique<worker>();
+        w->group = self.get();
+        w->index = i;
+        self->workers.push_back(std::move(w));
+    }
+
+    // Wait until every worker has initialized its wake handle so that
+    // submit() can signal any of them immediately.
+    std::latch ready(static_cast<std::ptrdiff_t>(workers));
+    for(auto& w: self->workers) {
+        auto* target = w.get();
+        w->thread = std::thread([this, target, &ready] { self->run_worker(*target, ready); });
+    }
+    ready.wait();
+}
+
+loop_group::~loop_group() {
+    assert(current_group != this && "loop_group must not be destroyed on its own worker");
+
+    stop();
+    for(auto& w: self->workers) {
+        if(w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+
+    while(auto* node = self->take_injected()) {
+        destroy_unstarted(node);
+    }
+}
+
+std::size_t loop_group::size() const noexcept {
+    return self->workers.size();
+}
+
+loop_group* loop_group::current() noexcept {
+    return current_group;
+}
+
+std::optional<std::size_t> loop_group::current_index() const noexcept {
+    if(current_group != this || !current_worker) {
+        return std::nullopt;
+    }
+    return current_worker->index;
+}
+
+event_loop& loop_group::loop(std::size_t index) noexcept {
+    assert(index < self->workers.size() && "loop_group::loop index out of range");
+    return *self->workers[index]->loop;
+}
+
+void loop_group::submit(async_node* node, std::size_t index) {
+    if(index != npos) {
+        assert(index < self->workers.size() && "loop_group::spawn_on index out of range");
+        auto& w = *self->workers[index];
+
+        std::lock_guard lock(self->wake_mutex);
+        if(self->stopping) {
+            destroy_unstarted(node);
+            return;
+        }
+        {
+            std::lock_guard inbox_lock(w.inbox_mutex);
+            w.inbox.push_back(node);
+        }
+        self->unpark(w);
+        uv::async_send(w.wake);
+        return;
+    }
+
+    if(current_group == this && current_worker) {
+        current_worker->local.push(node);
+    } else {
+        std::lock_guard lock(self->wake_mutex);
+        if(self->stopping) {
+            destroy_unstarted(node);
+            return;
+        }
+        std::lock_guard injected_lock(self->injected_mutex);
+        self->injected.push_back(node);
+    }
+
+    self->notify_parked();
+}
+
+void loop_group::wait() {
+    assert(current_group != this && "loop_group::wait called from its own worker");
+
+    std::unique_lock lock(self->outstanding_mutex);
+    self->outstanding_cv.wait(lock, [this] { return self->outstanding == 0; });
+}
+
+void loop_group::stop() {
+    std::lock_guard lock(self->wake_mutex);
+    if(self->stopping) {
+        return;
+    }
+    self->stopping = true;
+    for(auto& w: self->workers) {
+        uv::async_send(w->wake);
+    }
+}
+
+void loop_group::begin_one() noexcept {
+    std::lock_guard lock(self->outstanding_mutex);
+    self->outstanding += 1;
+}
+
+void loop_group::complete_one() noexcept {
+    std::lock_guard lock(self->outstanding_mutex);
+    assert(self->outstanding > 0 && "loop_group outstanding count underflow");
+    self->outstanding -= 1;
+    if(self->outstanding == 0) {
+        self->outstanding_cv.notify_all();
+    }
+}
+
+}  // namespace kota
@@ -1,10 +1,12 @@
 #include "kota/async/io/process.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "awaiter.h"
 #include "kota/async/io/fs.h"
 #include "kota/async/io/loop.h"
+#include "kota/async/runtime/when.h"
 #include "kota/async/vocab/error.h"
 
 #if defined(__linux__)
@@ -245,6 +247,68 @@ result<process::spawn_result> process::spawn(const options& opts, event_loop& lo
     return out;
 }
 
+generator<std::string_view, error> process::read_output(pipe& output) {
+    while(true) {
+        auto chunk = co_await output.read_chunk();
+        if(!chunk) {
+            if(chunk.error() == error::end_of_file) {
+                co_return;
+            }
+            co_await fail(chunk.error());
+        }
+
+        const auto size = chunk->size();
+        co_yield std::string_view(chunk->data(), size);
+        output.consume(size);
+    }
+}
+
+task<void, error> process::drain_output(pipe& output,
+                                        std::function<void(std::string_view)> sink) {
+    auto chunks = read_output(output);
+    while(auto chunk = co_await or_fail(co_await chunks.next())) {
+        sink(*chunk);
+    }
+}
+
+task<process::collected, error>
+    process::spawn_and_collect(options opts, std::size_t limit, event_loop& loop) {
+    opts.streams[1] = stdio::pipe(false, true);
+    opts.streams[2] = stdio::pipe(false, true);
+
+    auto spawned = spawn(opts, loop);
+    if(!spawned) {
+        co_await fail(spawned.error());
+    }
+    { auto drop = std::move(spawned->stdin_pipe); }
+
+    collected out;
+    auto keep = [limit](std::string& dst, bool& truncated) {
+        return [&dst, &truncated, limit](std::string_view chunk) {
+            const auto room = limit - std::min(limit, dst.size());
+            if(chunk.size() > room) {
+                truncated = true;
+                chunk = chunk.substr(0, room);
+            }
+            dst.append(chunk);
+        };
+    };
+
+    auto drained =
+        co_await when_all(drain_output(spawned->stdout_pipe, keep(out.out, out.out_truncated)),
+                          drain_output(spawned->stderr_pipe, keep(out.err, out.err_truncated)));
+    if(drained.has_error()) {
+        co_await fail(std::move(drained).error());
+    }
+
+    auto status = co_await spawned->proc.wait();
+    if(!status) {
+        co_await fail(status.error());
+    }
+    out.status = *status;
+    co_return out;
+}
+
 task<process::wait_result> process::wait() {
     if(!self) {
         co_return outcome_error(error::invalid_argument);
@@ -0,0 +1,173 @@
+#include "kota/async/io/process_monitor.h"
+
+#include <algorithm>
+
+#include "libuv.h"
+#include "kota/async/io/deadline.h"
+#include "kota/async/io/request.h"
+
+namespace kota {
+
+namespace {
+
+std::uint64_t system_memory() noexcept {
+    auto total = uv::get_total_memory();
+    auto constrained = uv::get_constrained_memory();
+    if(constrained != 0 && (total == 0 || constrained < total)) {
+        return constrained;
+    }
+    return total;
+}
+
+/// Reads every pid in one worker-pool job, so a pass over thousands of
+/// processes costs one trip off the loop rather than one each.
+task<std::vector<result<process_info>>, error> query_all(std::vector<int> pids,
+                                                         event_loop& loop) {
+    return queue(
+        [pids = std::move(pids)] {
+            std::vector<result<process_info>> infos;
+            infos.reserve(pids.size());
+            for(auto pid: pids) {
+                infos.push_back(process::query_info(pid));
+            }
+            return infos;
+        },
+        loop);
+}
+
+}  // namespace
+
+process_monitor::process_monitor(options opts, event_loop& loop) :
+    opts(opts), loop(loop),
+    limit(opts.memory_limit != 0 ? opts.memory_limit : system_memory()) {
+    this->opts.interval = (std::max)(opts.interval, std::chrono::milliseconds(1));
+    this->opts.history = (std::max)(opts.history, std::size_t(1));
+}
+
+process_monitor::~process_monitor() {
+    stop();
+}
+
+void process_monitor::watch(int pid) {
+    if(pid > 0) {
+        series.try_emplace(pid);
+    }
+}
+
+void process_monitor::unwatch(int pid) noexcept {
+    series.erase(pid);
+}
+
+void process_monitor::start() {
+    if(sampler) {
+        return;
+    }
+    sampler.emplace();
+    loop.schedule(sample_every(sampler->token()));
+}
+
+void process_monitor::stop() noexcept {
+    // Destroying the source cancels the sampler; a pass already on the
+    // worker pool finishes, and its readings are discarded.
+    sampler.reset();
+}
+
+task<> process_monitor::sample_every(cancellation_token token) {
+    while(true) {
+        auto waited = co_await with_token(after(opts.interval, loop), token);
+        if(!waited.has_value()) {
+            co_return;
+        }
+
+        auto pids = snapshot();
+        auto infos = co_await query_all(pids, loop);
+        // The monitor may be gone by now; only the token is safe to touch.
+        if(token.cancelled()) {
+            co_return;
+        }
+        if(infos.has_value()) {
+            record(pids, *infos, std::chrono::steady_clock::now());
+        }
+    }
+}
+
+task<void, error> process_monitor::sample() {
+    auto pids = snapshot();
+    auto infos = co_await query_all(pids, loop).or_fail();
+    record(pids, infos, std::chrono::steady_clock::now());
+}
+
+const process_sample* process_monitor::latest(int pid) const noexcept {
+    auto it = series.find(pid);
+    if(it == series.end() || it->second.empty()) {
+        return nullptr;
+    }
+    return &it->second.back();
+}
+
+const std::deque<process_sample>& process_monitor::history(int pid) const noexcept {
+    const static std::deque<process_sample> none;
+    auto it = series.find(pid);
+    return it == series.end() ? none : it->second;
+}
+
+std::vector<int> process_monitor::snapshot() const {
+    std::vector<int> pids;
+    pids.reserve(series.size());
+    for(auto& [pid, samples]: series) {
+        pids.push_back(pid);
+    }
+    return pids;
+}
+
+void process_monitor::record(const std::vector<int>& pids,
+                             const std::vector<result<process_info>>& infos,
+                             std::chrono::steady_clock::time_point time) {
+    for(std::size_t i = 0; i < pids.size(); ++i) {
+        // Unwatched while the pass ran.
+        auto it = series.find(pids[i]);
+        if(it == series.end()) {
+            continue;
+        }
+
+        auto& info = infos[i];
+        if(!info.has_value()) {
+            if(info.error() == error::no_such_process) {
+                series.erase(it);
+            }
+            continue;
+        }
+
+        auto& samples = it->second;
+        process_sample sample{*info, time};
+        if(!samples.empty()) {
+            auto& prev = samples.back();
+            auto elapsed = std::chrono::duration<double, std::micro>(time - prev.time).count();
+            auto used = static_cast<double>(info->utime_us + info->stime_us) -
+                        static_cast<double>(prev.info.utime_us + prev.info.stime_us);
+            if(elapsed > 0 && used > 0) {
+                sample.cpu_percent = used / elapsed * 100.0;
+            }
+        }
+
+        samples.push_back(sample);
+        while(samples.size() > opts.history) {
+            samples.pop_front();
+        }
+    }
+
+    rss_sum = 0;
+    for(auto& [pid, samples]: series) {
+        if(!samples.empty()) {
+            rss_sum += samples.back().info.rss;
+        }
+    }
+
+    if(memory_pressure() <= opts.high_watermark) {
+        below_watermark.set();
+    } else {
+        below_watermark.reset();
+    }
+}
+
+}  // namespace kota
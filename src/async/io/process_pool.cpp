@@ -0,0 +1,164 @@
+#include "kota/async/io/process_pool.h"
+
+#include <array>
+#include <csignal>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace kota {
+
+namespace {
+
+constexpr std::size_t frame_header_size = 4;
+
+std::array<char, frame_header_size> encode_length(std::size_t size) {
+    const auto value = static_cast<std::uint32_t>(size);
+    return {
+        static_cast<char>(value & 0xff),
+        static_cast<char>((value >> 8) & 0xff),
+        static_cast<char>((value >> 16) & 0xff),
+        static_cast<char>((value >> 24) & 0xff),
+    };
+}
+
+std::size_t decode_length(std::string_view header) {
+    std::uint32_t value = 0;
+    for(std::size_t i = 0; i < frame_header_size; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+    }
+    return value;
+}
+
+}  // namespace
+
+process_pool::process_pool(options opts, event_loop& loop) :
+    opts(std::move(opts)), loop(&loop), slots(static_cast<std::ptrdiff_t>(this->opts.size)) {
+    workers.resize(this->opts.size);
+    idle.reserve(this->opts.size);
+    for(std::size_t i = this->opts.size; i > 0; --i) {
+        idle.push_back(i - 1);
+    }
+}
+
+process_pool::~process_pool() = default;
+
+error process_pool::spawn(worker& w) {
+    auto launch = opts.worker;
+    launch.streams[0] = process::stdio::pipe(true, false);
+    launch.streams[1] = process::stdio::pipe(false, true);
+
+    auto spawned = process::spawn(launch, *loop);
+    if(!spawned) {
+        return spawned.error();
+    }
+
+    w.proc = std::move(spawned->proc);
+    w.input = std::move(spawned->stdin_pipe);
+    w.output = std::move(spawned->stdout_pipe);
+    w.inbox.clear();
+    w.alive = true;
+    return {};
+}
+
+task<std::string, error> process_pool::exchange(worker& w, std::string_view request) {
+    if(request.size() > UINT32_MAX) {
+        co_await fail(error::value_too_large_for_defined_data_type);
+    }
+
+    if(!w.alive) {
+        if(auto err = spawn(w)) {
+            co_await fail(err);
+        }
+    }
+
+    const auto header = encode_length(request.size());
+    const std::array<std::span<const char>, 2> pieces = {
+        std::span<const char>(header),
+        std::span<const char>(request.data(), request.size()),
+    };
+    co_await w.input.write(std::span<const std::span<const char>>(pieces)).or_fail();
+
+    while(w.inbox.size() < frame_header_size) {
+        w.inbox += co_await w.output.read().or_fail();
+    }
+    const auto length = decode_length(w.inbox);
+    if(length > opts.max_reply) {
+        co_await fail(error::value_too_large_for_defined_data_type);
+    }
+    while(w.inbox.size() < frame_header_size + length) {
+        w.inbox += co_await w.output.read().or_fail();
+    }
+
+    auto reply = w.inbox.substr(frame_header_size, length);
+    w.inbox.erase(0, frame_header_size + length);
+    co_return reply;
+}
+
+task<> process_pool::retire(worker& w) {
+    w.input = pipe();
+    w.output = pipe();
+    w.inbox.clear();
+    if(w.alive) {
+        w.alive = false;
+        if(!w.proc.kill(SIGKILL)) {
+            co_await w.proc.wait();
+        }
+    }
+    w.proc = process();
+}
+
+task<std::string, error> process_pool::run(std::string_view request) {
+    co_await slots.acquire();
+
+    // Returns the slot even when the job is cancelled while it waits.
+    struct slot_guard {
+        process_pool* pool;
+        std::size_t index;
+
+        ~slot_guard() {
+            pool->idle.push_back(index);
+            pool->slots.release();
+        }
+    };
+
+    slot_guard guard{this, idle.back()};
+    idle.pop_back();
+
+    auto& w = workers[guard.index];
+    if(w.in_job) {
+        co_await retire(w);
+    }
+
+    w.in_job = true;
+    auto reply = co_await exchange(w, request);
+    w.in_job = false;
+    if(!reply) {
+        co_await retire(w);
+        co_await fail(reply.error());
+    }
+    co_return std::move(*reply);
+}
+
+task<> process_pool::shutdown() {
+    for(auto& w: workers) {
+        w.input = pipe();
+        if(w.alive) {
+            w.alive = false;
+            co_await w.proc.wait();
+        }
+        w.output = pipe();
+        w.inbox.clear();
+        w.proc = process();
+    }
+}
+
+std::size_t process_pool::running() const noexcept {
+    std::size_t count = 0;
+    for(auto& w: workers) {
+        count += w.alive ? 1 : 0;
+    }
+    return count;
+}
+
+}  // namespace kota
@@ -1,6 +1,7 @@
 #include "kota/async/io/request.h"
 
 #include <cassert>
+#include <new>
 
 #include "awaiter.h"
 #include "kota/async/io/loop.h"
@@ -9,68 +10,59 @@
 
 namespace kota {
 
-namespace {
-
-struct work_op : uv::await_op<work_op> {
-    using promise_t = task<void, error>::promise_type;
+namespace detail {
 
-    // libuv request object; req.data points back to this awaiter.
-    uv_work_t req{};
-    // User-supplied function executed on libuv's worker thread.
-    function<void()> fn;
-    // Completion status consumed by await_resume().
-    error result;
+static_assert(sizeof(uv_work_t) <= sizeof(work_request::req),
+              "work_request::req is too small for uv_work_t");
+static_assert(alignof(uv_work_t) <= alignof(std::max_align_t));
 
-    explicit work_op(function<void()> fn) : fn(std::move(fn)) {}
-
-    static void on_cancel(system_op* op) {
-        auto* self = static_cast<work_op*>(op);
-        uv::cancel(self->req);
-    }
-
-    bool await_ready() const noexcept {
-        return false;
-    }
+namespace {
 
-    std::coroutine_handle<>
-        await_suspend(std::coroutine_handle<promise_t> waiting,
-                      std::source_location loc = std::source_location::current()) noexcept {
-        return this->link_continuation(&waiting.promise(), loc);
-    }
+uv_work_t& work_req(work_request& self) noexcept {
+    return *reinterpret_cast<uv_work_t*>(self.req);
+}
 
-    error await_resume() noexcept {
-        return result;
-    }
-};
+void cancel_work(system_op* op) {
+    uv::cancel(work_req(*static_cast<work_request*>(op)));
+}
 
 }  // namespace
 
-task<void, error> queue(function<void()> fn, event_loop& loop) {
-    work_op op(std::move(fn));
+work_request::work_request(event_loop& loop, invoke_fn invoke) noexcept :
+    invoke(invoke), loop(&loop) {
+    this->action = &cancel_work;
+    new (this->req) uv_work_t{};
+}
 
+bool work_request::start() noexcept {
     auto work_cb = [](uv_work_t* req) {
-        auto* holder = static_cast<work_op*>(req->data);
+        auto* holder = static_cast<work_request*>(req->data);
         assert(holder != nullptr && "work_cb requires operation in req->data");
-        holder->fn();
+        holder->invoke(*holder);
     };
 
     auto after_cb = [](uv_work_t* req, int status) {
-        auto* holder = static_cast<work_op*>(req->data);
+        auto* holder = static_cast<work_request*>(req->data);
         assert(holder != nullptr && "after_cb requires operation in req->data");
 
-        holder->mark_cancelled_if(status);
+        if(uv::is_cancelled_status(status)) {
+            holder->state = async_node::Cancelled;
+        }
         holder->result = uv::status_to_error(status);
         holder->complete();
     };
 
-    op.result.clear();
-    op.req.data = &op;
+    auto& req = work_req(*this);
+    req.data = this;
+    result = uv::queue_work(*loop, req, work_cb, after_cb);
+    return !result;
+}
 
-    if(auto err = uv::queue_work(loop, op.req, work_cb, after_cb)) {
-        co_await fail(err);
-    }
+}  // namespace detail
 
-    if(auto err = co_await op) {
+task<void, error> queue(loop_callback fn, event_loop& loop) {
+    detail::work_call<loop_callback, void> call(std::move(fn), loop);
+    if(auto err = co_await call) {
         co_await fail(std::move(err));
     }
 }
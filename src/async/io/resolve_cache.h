@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../libuv.h"
+#include "kota/async/runtime/task.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+class event_loop;
+
+namespace detail {
+
+/// getaddrinfo answers cached per event_loop, keyed by host name. Addresses
+/// are stored without a port and expire a fixed `ttl` after the lookup,
+/// since getaddrinfo does not report record TTLs.
+class resolve_cache {
+public:
+    using addresses = std::vector<uv::resolved_addr>;
+
+    /// Cached addresses for `host`, or null if absent or expired at `now`
+    /// (loop time in milliseconds).
+    const addresses* find(std::string_view host, std::uint64_t now);
+
+    void store(std::string host, addresses addrs, std::uint64_t now);
+
+    void clear() noexcept {
+        entries.clear();
+    }
+
+    /// A zero TTL disables caching and drops what is cached.
+    void set_ttl(std::chrono::milliseconds value) noexcept;
+
+private:
+    struct entry {
+        addresses addrs;
+        std::uint64_t expires = 0;
+    };
+
+    struct string_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view value) const noexcept {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    std::unordered_map<std::string, entry, string_hash, std::equal_to<>> entries;
+    std::chrono::milliseconds ttl{30'000};
+};
+
+}  // namespace detail
+
+/// Addresses of `host` with `port` applied: the host itself when it is a
+/// numeric IPv4/IPv6 address, otherwise a cached or fresh getaddrinfo answer
+/// in the order getaddrinfo preferred them.
+task<std::vector<uv::resolved_addr>, error>
+    resolve_sockaddrs(std::string_view host, int port, event_loop& loop);
+
+}  // namespace kota
@@ -0,0 +1,190 @@
+#include "kota/async/io/resolver.h"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "awaiter.h"
+#include "resolve_cache.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+namespace {
+
+/// Entries kept per loop; expired ones are swept once it is reached.
+constexpr std::size_t max_cached_hosts = 4096;
+
+struct getaddrinfo_await : uv::await_op<getaddrinfo_await> {
+    using promise_t = task<std::vector<uv::resolved_addr>, error>::promise_type;
+
+    // libuv lookup request; req.data points back to this awaiter.
+    uv_getaddrinfo_t req{};
+    // Host name kept alive for the threadpool lookup.
+    std::string host;
+    event_loop& loop;
+    // Result slot returned from await_resume().
+    result<detail::resolve_cache::addresses> out = outcome_error(error());
+
+    getaddrinfo_await(std::string host, event_loop& loop) : host(std::move(host)), loop(loop) {}
+
+    static void on_cancel(system_op* op) {
+        auto* aw = static_cast<getaddrinfo_await*>(op);
+        uv::cancel(aw->req);
+    }
+
+    static void on_resolved(uv_getaddrinfo_t* req, int status, addrinfo* res) {
+        auto* aw = static_cast<getaddrinfo_await*>(req->data);
+        assert(aw != nullptr && "on_resolved requires awaiter in req->data");
+
+        // A cancelled lookup reports its own EAI code instead of ECANCELED.
+        aw->mark_cancelled_if(status == UV_EAI_CANCELED ? UV_ECANCELED : status);
+
+        if(auto err = uv::status_to_error(status)) {
+            aw->out = outcome_error(err);
+        } else {
+            detail::resolve_cache::addresses addrs;
+            for(auto* ai = res; ai != nullptr; ai = ai->ai_next) {
+                if(ai->ai_family != AF_INET && ai->ai_family != AF_INET6) {
+                    continue;
+                }
+                uv::resolved_addr addr{};
+                std::memcpy(&addr.storage, ai->ai_addr, ai->ai_addrlen);
+                addr.family = ai->ai_family;
+                addrs.push_back(addr);
+            }
+            if(addrs.empty()) {
+                aw->out = outcome_error(error::addrinfo_no_address);
+            } else {
+                aw->out = std::move(addrs);
+            }
+        }
+
+        uv::freeaddrinfo(res);
+        aw->complete();
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_ADDRCONFIG;
+
+        req.data = this;
+        if(auto err = uv::getaddrinfo(loop, req, on_resolved, host.c_str(), &hints)) {
+            out = outcome_error(err);
+            return waiting;
+        }
+
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    result<detail::resolve_cache::addresses> await_resume() noexcept {
+        return std::move(out);
+    }
+};
+
+}  // namespace
+
+const detail::resolve_cache::addresses* detail::resolve_cache::find(std::string_view host,
+                                                                    std::uint64_t now) {
+    auto it = entries.find(host);
+    if(it == entries.end()) {
+        return nullptr;
+    }
+    if(it->second.expires <= now) {
+        entries.erase(it);
+        return nullptr;
+    }
+    return &it->second.addrs;
+}
+
+void detail::resolve_cache::store(std::string host, addresses addrs, std::uint64_t now) {
+    if(ttl.count() <= 0) {
+        return;
+    }
+
+    if(entries.size() >= max_cached_hosts) {
+        std::erase_if(entries, [now](const auto& item) { return item.second.expires <= now; });
+        if(entries.size() >= max_cached_hosts) {
+            entries.clear();
+        }
+    }
+
+    const auto expires = now + static_cast<std::uint64_t>(ttl.count());
+    entries.insert_or_assign(std::move(host), entry{std::move(addrs), expires});
+}
+
+void detail::resolve_cache::set_ttl(std::chrono::milliseconds value) noexcept {
+    ttl = value;
+    if(ttl.count() <= 0) {
+        clear();
+    }
+}
+
+task<std::vector<uv::resolved_addr>, error>
+    resolve_sockaddrs(std::string_view host, int port, event_loop& loop) {
+    if(auto numeric = uv::resolve_addr(host, port)) {
+        co_return std::vector<uv::resolved_addr>{*numeric};
+    }
+
+    auto& cache = loop.dns_cache();
+    detail::resolve_cache::addresses addrs;
+    if(auto* cached = cache.find(host, uv::now(loop))) {
+        addrs = *cached;
+    } else {
+        auto looked_up = co_await getaddrinfo_await(std::string(host), loop);
+        if(!looked_up) {
+            co_await fail(looked_up.error());
+        }
+        addrs = std::move(*looked_up);
+        cache.store(std::string(host), addrs, uv::now(loop));
+    }
+
+    for(auto& addr: addrs) {
+        uv::set_port(addr, port);
+    }
+    co_return addrs;
+}
+
+task<std::vector<resolved_address>, error> resolve(std::string_view host, event_loop& loop) {
+    auto addrs = co_await resolve_sockaddrs(host, 0, loop).or_fail();
+
+    std::vector<resolved_address> out;
+    out.reserve(addrs.size());
+    for(auto& addr: addrs) {
+        char name[INET6_ADDRSTRLEN] = {};
+        error err;
+        if(addr.family == AF_INET6) {
+            err = uv::ip6_name(*reinterpret_cast<const sockaddr_in6*>(&addr.storage),
+                               name,
+                               sizeof(name));
+        } else {
+            err = uv::ip4_name(*reinterpret_cast<const sockaddr_in*>(&addr.storage),
+                               name,
+                               sizeof(name));
+        }
+        if(err) {
+            co_await fail(err);
+        }
+        out.push_back({name, addr.family == AF_INET6});
+    }
+    co_return out;
+}
+
+void set_resolve_ttl(std::chrono::milliseconds ttl, event_loop& loop) {
+    loop.dns_cache().set_ttl(ttl);
+}
+
+void clear_resolve_cache(event_loop& loop) {
+    loop.dns_cache().clear();
+}
+
+}  // namespace kota
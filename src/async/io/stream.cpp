@@ -4,7 +4,18 @@
 #include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 #include "awaiter.h"
+#include "kota/async/io/fs.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/io/watcher.h"
 
 namespace kota {
 
@@ -72,6 +83,11 @@ struct stream_read_await : uv::await_op<stream_read_await> {
     static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
         auto s = static_cast<stream::Self*>(stream->data);
         assert(s != nullptr && "on_read requires stream state in stream->data");
+        if(nread <= 0) {
+            // Nothing landed in the slab on_alloc() may have just taken.
+            s->buffer.release_unused();
+        }
+
         if(auto err = uv::status_to_error(nread)) {
             uv::read_stop(*stream);
             s->active_read_mode = stream::Self::read_mode::none;
@@ -229,7 +245,84 @@ struct stream_read_some_await : uv::await_op<stream_read_some_await> {
     }
 };
 
+#ifdef __linux__
+
+/// Completes once the stream's descriptor is readable, without reading from
+/// it: a zero-length buffer from on_alloc makes libuv report UV_ENOBUFS
+/// instead of calling read(). splice() then moves the bytes itself.
+struct stream_readable_await : uv::await_op<stream_readable_await> {
+    using await_base = uv::await_op<stream_readable_await>;
+
+    // Stream self that owns the active read waiter.
+    stream::Self* self;
+    // Read error seen instead of readiness.
+    error error_code;
+
+    explicit stream_readable_await(stream::Self* self) : self(self) {}
+
+    static void on_cancel(system_op* op) {
+        await_base::complete_cancel(op, [](auto& aw) {
+            if(aw.self->active_read_mode != stream::Self::read_mode::none) {
+                uv::read_stop(aw.self->stream);
+                aw.self->active_read_mode = stream::Self::read_mode::none;
+            }
+            aw.self->reader.disarm();
+        });
+    }
+
+    static void on_alloc(uv_handle_t*, size_t, uv_buf_t* buf) {
+        buf->base = nullptr;
+        buf->len = 0;
+    }
+
+    static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t*) {
+        auto s = static_cast<stream::Self*>(stream->data);
+        assert(s != nullptr && "on_read requires stream state in stream->data");
+
+        uv::read_stop(*stream);
+        s->active_read_mode = stream::Self::read_mode::none;
+
+        auto* aw = static_cast<stream_readable_await*>(s->reader.waiter);
+        if(!aw) {
+            return;
+        }
+        if(nread != UV_ENOBUFS) {
+            if(auto err = uv::status_to_error(nread)) {
+                aw->error_code = err;
+                aw->mark_cancelled_if(nread);
+            }
+        }
+        s->reader.disarm();
+        aw->complete();
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename Promise>
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        self->reader.arm(*this);
+        if(auto err =
+               ensure_reading(self, stream::Self::read_mode::readiness, on_alloc, on_read)) {
+            error_code = err;
+            self->reader.disarm();
+            return waiting;
+        }
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    error await_resume() noexcept {
+        return error_code;
+    }
+};
+
+#endif
+
 struct stream_write_await : uv::await_op<stream_write_await> {
+    using await_base = uv::await_op<stream_write_await>;
     using promise_t = task<void, error>::promise_type;
 
     // Stream self that owns the active write waiter.
@@ -240,17 +333,38 @@ struct stream_write_await : uv::await_op<stream_write_await> {
     uv_write_t req{};
     // Completion status returned from await_resume().
     error error_code;
-
-    stream_write_await(stream::Self* self, std::span<const char> data) :
-        self(self), storage(data.begin(), data.end()) {}
+    // Whether uv_write() has been called, as opposed to still being queued.
+    bool issued = false;
+
+    /// Copies everything in `pieces` past the first `skip` bytes.
+    stream_write_await(stream::Self* self,
+                       std::span<const std::span<const char>> pieces,
+                       std::size_t skip) :
+        self(self) {
+        for(auto piece: pieces) {
+            if(skip >= piece.size()) {
+                skip -= piece.size();
+                continue;
+            }
+            storage.insert(storage.end(), piece.begin() + skip, piece.end());
+            skip = 0;
+        }
+    }
 
     static void on_cancel(system_op* op) {
         auto* aw = static_cast<stream_write_await*>(op);
-        if(!aw->self) {
+        if(!aw->self || aw->issued) {
+            // uv_write_t is not cancellable via uv_cancel().
+            // Keep the request in-flight and wait for on_write() to retire it.
             return;
         }
-        // uv_write_t is not cancellable via uv_cancel().
-        // Keep the request in-flight and wait for on_write() to retire it.
+
+        // Still queued behind other writes: drop it before libuv sees it.
+        await_base::complete_cancel(op, [](auto& aw) {
+            auto& queued = aw.self->queued_writes;
+            queued.erase(std::ranges::find(queued, &aw));
+            aw.self->queued_write_bytes -= aw.storage.size();
+        });
     }
 
     static void on_write(uv_write_t* req, int status) {
@@ -264,11 +378,37 @@ struct stream_write_await : uv::await_op<stream_write_await> {
             aw->error_code = err;
         }
 
-        if(aw->self->writer.has_waiter()) {
-            auto* w = aw->self->writer.waiter;
-            aw->self->writer.disarm();
-            w->complete();
+        aw->self->inflight_writes -= 1;
+        admit_writes(aw->self);
+        aw->complete();
+    }
+
+    /// Issues queued writes, oldest first, while in-flight slots are free.
+    static void admit_writes(stream::Self* self) {
+        while(self->inflight_writes < self->max_inflight_writes && !self->queued_writes.empty()) {
+            auto* next = static_cast<stream_write_await*>(self->queued_writes.front());
+            self->queued_writes.pop_front();
+            self->queued_write_bytes -= next->storage.size();
+            if(!next->issue()) {
+                next->complete();
+            }
+        }
+    }
+
+    /// Hands the copied bytes to libuv; false if uv_write failed right away.
+    bool issue() {
+        issued = true;
+        req.data = this;
+
+        uv_buf_t buf = uv::buf_init(storage.empty() ? nullptr : storage.data(),
+                                    static_cast<unsigned>(storage.size()));
+        if(auto err = uv::write(req, self->stream, std::span<const uv_buf_t>{&buf, 1}, on_write)) {
+            error_code = err;
+            return false;
         }
+
+        self->inflight_writes += 1;
+        return true;
     }
 
     bool await_ready() const noexcept {
@@ -282,14 +422,15 @@ struct stream_write_await : uv::await_op<stream_write_await> {
             return waiting;
         }
 
-        self->writer.arm(*this);
-        req.data = this;
+        // libuv keeps issued writes in order; writes past the in-flight
+        // limit wait here, behind any that are already waiting.
+        if(self->inflight_writes >= self->max_inflight_writes || !self->queued_writes.empty()) {
+            self->queued_writes.push_back(this);
+            self->queued_write_bytes += storage.size();
+            return this->link_continuation(&waiting.promise(), loc);
+        }
 
-        uv_buf_t buf = uv::buf_init(storage.empty() ? nullptr : storage.data(),
-                                    static_cast<unsigned>(storage.size()));
-        if(auto err = uv::write(req, self->stream, std::span<const uv_buf_t>{&buf, 1}, on_write)) {
-            error_code = err;
-            self->writer.disarm();
+        if(!issue()) {
             return waiting;
         }
 
@@ -297,13 +438,238 @@ struct stream_write_await : uv::await_op<stream_write_await> {
     }
 
     error await_resume() noexcept {
-        if(self) {
-            self->writer.disarm();
-        }
         return this->error_code;
     }
 };
 
+void on_corked_write(uv_write_t* req, int status) {
+    auto* done = static_cast<stream_cork::batch*>(req->data);
+    assert(done != nullptr && "on_corked_write requires batch in req->data");
+    auto& cork = *done->owner;
+
+    cork.inflight -= 1;
+    if(auto err = uv::status_to_error(status); err && !cork.failure) {
+        cork.failure = err;
+    }
+
+    done->bytes.clear();
+    if(cork.spare) {
+        delete done;
+    } else {
+        cork.spare.reset(done);
+    }
+
+    if(cork.inflight == 0) {
+        for(auto* w: std::exchange(cork.flushers, {})) {
+            w->complete();
+        }
+    }
+}
+
+/// Hands every corked byte to the stream. Writes straight to the kernel
+/// when nothing is in flight, and queues what is left as one uv_write.
+void send_corked(stream::Self* self) {
+    auto& cork = *self->cork;
+    cork.frame_at = static_cast<std::size_t>(-1);
+    if(cork.failure) {
+        cork.pending.clear();
+        return;
+    }
+    if(cork.pending.empty()) {
+        return;
+    }
+
+    std::size_t written = 0;
+    if(cork.inflight == 0) {
+        uv_buf_t buf =
+            uv::buf_init(cork.pending.data(), static_cast<unsigned>(cork.pending.size()));
+        if(auto res = uv::try_write(self->stream, std::span<const uv_buf_t>{&buf, 1})) {
+            written = *res;
+        }
+    }
+    if(written == cork.pending.size()) {
+        cork.pending.clear();
+        return;
+    }
+
+    auto next = cork.spare ? std::move(cork.spare) : std::make_unique<stream_cork::batch>();
+    next->owner = &cork;
+    next->req.data = next.get();
+    next->bytes.swap(cork.pending);
+
+    uv_buf_t buf = uv::buf_init(next->bytes.data() + written,
+                                static_cast<unsigned>(next->bytes.size() - written));
+    if(auto err = uv::write(next->req,
+                            self->stream,
+                            std::span<const uv_buf_t>{&buf, 1},
+                            on_corked_write)) {
+        cork.failure = err;
+        next->bytes.clear();
+        cork.spare = std::move(next);
+        return;
+    }
+
+    cork.inflight += 1;
+    next.release();
+}
+
+void on_flush_check(uv_check_t* handle) {
+    auto* check = static_cast<stream_flush_check*>(handle->data);
+    assert(check != nullptr && "on_flush_check requires check state in handle->data");
+
+    uv::check_stop(check->handle);
+    if(check->owner && !uv::is_closing(check->owner->handle)) {
+        send_corked(check->owner);
+    }
+}
+
+struct stream_flush_await : uv::await_op<stream_flush_await> {
+    using await_base = uv::await_op<stream_flush_await>;
+    using promise_t = task<void, error>::promise_type;
+
+    // Cork state whose in-flight batches are awaited.
+    stream_cork* cork;
+
+    explicit stream_flush_await(stream_cork* cork) : cork(cork) {}
+
+    static void on_cancel(system_op* op) {
+        await_base::complete_cancel(op, [](auto& aw) {
+            auto& flushers = aw.cork->flushers;
+            flushers.erase(std::ranges::find(flushers, &aw));
+        });
+    }
+
+    bool await_ready() const noexcept {
+        return cork->inflight == 0;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        cork->flushers.push_back(this);
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    void await_resume() noexcept {}
+};
+
+/// The stream's cork state, created on first use without corking it.
+stream_cork& cork_state(stream::Self& self) {
+    if(!self.cork) {
+        auto check = stream_flush_check::make();
+        uv::check_init(*self.stream.loop, check->handle);
+        check->owner = &self;
+
+        self.cork = std::make_unique<stream_cork>();
+        self.cork->check = std::move(check);
+    }
+    return *self.cork;
+}
+
+/// True when nothing written through the stream is still on its way to the
+/// kernel, so bytes written to the descriptor directly stay in order.
+bool write_side_idle(const stream::Self& self) {
+    if(self.inflight_writes != 0 || !self.queued_writes.empty() ||
+       uv::write_queue_size(self.stream) != 0) {
+        return false;
+    }
+    return !self.cork || (self.cork->pending.empty() && self.cork->inflight == 0);
+}
+
+#ifndef _WIN32
+
+/// One non-blocking sendmsg() of `data` with `descriptors` as SCM_RIGHTS;
+/// returns the bytes sent, or -1 with errno set.
+ssize_t send_with_rights(int fd, std::span<const char> data, std::span<const int> descriptors) {
+    const auto rights = descriptors.size() * sizeof(int);
+    std::vector<char> control(CMSG_SPACE(rights));
+
+    iovec iov{};
+    iov.iov_base = const_cast<char*>(data.data());
+    iov.iov_len = data.size();
+
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = static_cast<decltype(msg.msg_controllen)>(control.size());
+
+    auto* header = CMSG_FIRSTHDR(&msg);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(rights);
+    std::memcpy(CMSG_DATA(header), descriptors.data(), rights);
+
+    int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+
+    ssize_t n;
+    do {
+        n = ::sendmsg(fd, &msg, flags);
+    } while(n < 0 && errno == EINTR);
+    return n;
+}
+
+#endif
+
+/// Copy buffer of send_file(), taken from the thread's slab pool on first use.
+struct slab_lease {
+    byte_slab* slab = nullptr;
+
+    slab_lease() = default;
+    slab_lease(const slab_lease&) = delete;
+    slab_lease& operator=(const slab_lease&) = delete;
+
+    ~slab_lease() {
+        if(slab) {
+            slab_pool::local().give(slab);
+        }
+    }
+
+    std::span<char> get(std::size_t limit) {
+        if(!slab) {
+            slab = slab_pool::local().take(64 * 1024);
+        }
+        return {slab->data(), (std::min)(limit, std::size_t(slab->capacity))};
+    }
+};
+
+#ifdef __linux__
+
+/// The pipe splice() moves bytes through; both ends are non-blocking.
+struct kernel_pipe {
+    int read_end = -1;
+    int write_end = -1;
+
+    kernel_pipe() = default;
+    kernel_pipe(const kernel_pipe&) = delete;
+    kernel_pipe& operator=(const kernel_pipe&) = delete;
+
+    ~kernel_pipe() {
+        if(read_end >= 0) {
+            ::close(read_end);
+            ::close(write_end);
+        }
+    }
+
+    bool open() noexcept {
+        int fds[2];
+        if(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            return false;
+        }
+        read_end = fds[0];
+        write_end = fds[1];
+        return true;
+    }
+};
+
+/// Bytes moved into the pipe per splice(); the default pipe capacity.
+constexpr std::size_t splice_chunk = 64 * 1024;
+
+#endif
+
 }  // namespace
 
 stream::stream() noexcept = default;
@@ -398,6 +764,38 @@ void stream::consume(std::size_t n) {
     self->buffer.advance_read(n);
 }
 
+task<small_vector<stream::chunk>, error> stream::read_chunks() {
+    small_vector<chunk> out;
+    if(!self) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(self->buffer.readable_bytes() == 0) {
+        if(auto err = co_await stream_read_await{self.get()}) {
+            co_await fail(err);
+        }
+    }
+
+    self->buffer.read_chunks(out);
+    co_return out;
+}
+
+byte_chain stream::detach(std::size_t n) {
+    if(!self) {
+        return {};
+    }
+
+    return self->buffer.detach(n);
+}
+
+void stream::set_pooled_buffer(bool enabled) {
+    if(!self) {
+        return;
+    }
+
+    self->buffer.set_pooled(enabled);
+}
+
 void stream::stop() {
     // Runtime guard: match all other public methods. assert alone compiles
     // out in NDEBUG builds, leaving UB on default-constructed/moved-from streams.
@@ -435,20 +833,230 @@ void stream::stop() {
 }
 
 task<void, error> stream::write(std::span<const char> data) {
-    if(!self || !self->initialized() || data.empty()) {
-        co_await fail(error::invalid_argument);
+    co_await write(std::span<const std::span<const char>>(&data, 1)).or_fail();
+}
+
+task<void, error> stream::write(std::span<const std::span<const char>> pieces) {
+    std::size_t total = 0;
+    small_vector<uv_buf_t, 8> bufs;
+    for(auto piece: pieces) {
+        if(piece.empty()) {
+            continue;
+        }
+        if(piece.size() > static_cast<std::size_t>(std::numeric_limits<unsigned>::max())) {
+            co_await fail(error::value_too_large_for_defined_data_type);
+        }
+        bufs.push_back(
+            uv::buf_init(const_cast<char*>(piece.data()), static_cast<unsigned>(piece.size())));
+        total += piece.size();
     }
 
-    if(self->writer.has_waiter()) {
-        assert(false && "stream::write supports a single writer at a time");
+    if(!self || !self->initialized() || total == 0) {
         co_await fail(error::invalid_argument);
     }
 
-    if(auto err = co_await stream_write_await{self.get(), data}) {
+    if(auto* cork = self->cork.get(); cork && cork->enabled) {
+        if(cork->failure) {
+            co_await fail(cork->failure);
+        }
+
+        const bool was_empty = cork->pending.empty();
+        bool ends_line = false;
+        for(auto piece: pieces) {
+            cork->pending.insert(cork->pending.end(), piece.begin(), piece.end());
+            ends_line = ends_line || std::ranges::find(piece, '\n') != piece.end();
+        }
+        cork->frame_at = static_cast<std::size_t>(-1);
+
+        if(cork->pending.size() >= cork->threshold) {
+            // Waiting here keeps a writer that outpaces the peer from
+            // growing the buffer without bound.
+            co_await flush().or_fail();
+        } else if(cork->lines && ends_line) {
+            send_corked(self.get());
+        } else if(was_empty) {
+            uv::check_start(cork->check->handle, on_flush_check);
+        }
+        co_return;
+    }
+
+    // A frame from write_frame() still buffered goes out first.
+    if(auto* cork = self->cork.get(); cork && !cork->pending.empty()) {
+        send_corked(self.get());
+    }
+
+    // The caller's buffers are only guaranteed to live until this task is
+    // suspended, so first try to write them as they are. Whatever the
+    // kernel does not take right away (or everything, if the handle does
+    // not support try_write) is copied and queued with uv_write. Writes
+    // still waiting for an in-flight slot go first, so skip it then.
+    std::size_t written = 0;
+    if(self->queued_writes.empty()) {
+        auto res = uv::try_write(self->stream, std::span<const uv_buf_t>(bufs.data(), bufs.size()));
+        if(res) {
+            written = *res;
+        }
+    }
+    if(written == total) {
+        co_return;
+    }
+
+    if(auto err = co_await stream_write_await{self.get(), pieces, written}) {
         co_await fail(std::move(err));
     }
 }
 
+task<std::size_t, error> stream::send_file(int fd, std::int64_t offset, std::size_t length) {
+    if(!self || !self->initialized()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    // sendfile() needs the socket as a CRT descriptor, which Windows
+    // streams do not have; there every chunk is copied.
+    int out_fd = -1;
+#ifndef _WIN32
+    uv_os_fd_t os_fd;
+    if(!uv::fileno(self->stream, os_fd)) {
+        out_fd = os_fd;
+    }
+#endif
+
+    auto& loop = event_loop::current();
+    slab_lease buffer;
+    std::size_t sent = 0;
+    while(sent < length) {
+        const auto remaining = length - sent;
+        const auto at = offset + static_cast<std::int64_t>(sent);
+
+        if(out_fd >= 0 && write_side_idle(*self)) {
+            auto res = co_await fs::sendfile(out_fd, fd, at, remaining, loop);
+            if(res) {
+                if(*res == 0) {
+                    break;
+                }
+                sent += static_cast<std::size_t>(*res);
+                continue;
+            }
+
+            const auto err = res.error();
+            if(err == error::function_not_implemented ||
+               err == error::operation_not_supported_on_socket) {
+                out_fd = -1;
+            } else if(err != error::resource_temporarily_unavailable) {
+                co_await fail(err);
+            }
+            // Otherwise the socket is full: the copy below waits for it.
+        }
+
+        auto chunk = buffer.get(remaining);
+        auto n = co_await fs::read(fd, chunk, at, loop).or_fail();
+        if(n == 0) {
+            break;
+        }
+        co_await write(std::span<const char>(chunk.data(), n)).or_fail();
+        sent += n;
+    }
+
+    co_return sent;
+}
+
+void stream::cork(std::size_t threshold) {
+    if(!self || !self->initialized()) {
+        return;
+    }
+
+    auto& cork = cork_state(*self);
+    cork.enabled = true;
+    cork.threshold = (std::max)(threshold, std::size_t(1));
+}
+
+void stream::set_line_flush(bool enabled) {
+    if(!self || !self->initialized()) {
+        return;
+    }
+    cork_state(*self).lines = enabled;
+}
+
+bool stream::write_frame(std::span<const char> frame) {
+    if(!self || !self->initialized() || frame.empty()) {
+        return false;
+    }
+
+    auto& cork = cork_state(*self);
+    if(cork.failure) {
+        return false;
+    }
+
+    if(cork.frame_at != static_cast<std::size_t>(-1)) {
+        // Nobody has seen the buffered frame; this one overdraws it anyway.
+        cork.pending.resize(cork.frame_at);
+    } else if(cork.inflight != 0 || self->inflight_writes != 0 ||
+              !self->queued_writes.empty() || uv::write_queue_size(self->stream) != 0) {
+        // The terminal is behind; queueing frames would only grow the lag.
+        return false;
+    }
+
+    if(cork.pending.empty()) {
+        uv::check_start(cork.check->handle, on_flush_check);
+    }
+    cork.frame_at = cork.pending.size();
+    cork.pending.insert(cork.pending.end(), frame.begin(), frame.end());
+    return true;
+}
+
+void stream::uncork() {
+    if(!self || !self->cork) {
+        return;
+    }
+
+    // Sent now rather than at the end of the iteration so the buffered
+    // bytes stay ahead of the next, uncorked, write.
+    self->cork->enabled = false;
+    send_corked(self.get());
+}
+
+task<void, error> stream::flush() {
+    if(!self || !self->initialized()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    auto* cork = self->cork.get();
+    if(!cork) {
+        co_return;
+    }
+
+    send_corked(self.get());
+    while(cork->inflight > 0) {
+        co_await stream_flush_await{cork};
+        send_corked(self.get());
+    }
+
+    if(cork->failure) {
+        co_await fail(cork->failure);
+    }
+}
+
+std::size_t stream::queued_bytes() const noexcept {
+    if(!self || !self->initialized()) {
+        return 0;
+    }
+
+    std::size_t total = uv::write_queue_size(self->stream) + self->queued_write_bytes;
+    if(self->cork) {
+        total += self->cork->pending.size();
+    }
+    return total;
+}
+
+void stream::set_max_inflight_writes(std::size_t limit) {
+    if(!self) {
+        return;
+    }
+
+    self->max_inflight_writes = (std::max)(limit, std::size_t(1));
+    stream_write_await::admit_writes(self.get());
+}
+
 result<std::size_t> stream::try_write(std::span<const char> data) {
     if(!self || !self->initialized()) {
         return outcome_error(error::invalid_argument);
@@ -501,4 +1109,193 @@ error stream::set_blocking(bool enabled) {
 
 stream::stream(unique_handle<Self> self) noexcept : self(std::move(self)) {}
 
+task<std::size_t, error> splice(stream& from, stream& to) {
+    auto* source = from.operator->();
+    auto* sink = to.operator->();
+    if(!source || !source->initialized() || !sink || !sink->initialized()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    std::size_t total = 0;
+#ifdef __linux__
+    kernel_pipe pipe;
+    uv_os_fd_t in_fd;
+    uv_os_fd_t out_fd;
+    bool direct = !uv::fileno(source->stream, in_fd) && !uv::fileno(sink->stream, out_fd) &&
+                  pipe.open();
+    slab_lease buffer;
+    while(direct) {
+        // Bytes libuv already read into the stream's buffer go first.
+        if(source->buffer.readable_bytes() != 0) {
+            auto chunks = co_await from.read_chunks().or_fail();
+            std::size_t size = 0;
+            for(auto chunk: chunks) {
+                size += chunk.size();
+            }
+            co_await to.write(std::span<const std::span<const char>>(chunks.data(), chunks.size()))
+                .or_fail();
+            from.consume(size);
+            total += size;
+            continue;
+        }
+
+        if(auto err = co_await stream_readable_await{source}) {
+            co_await fail(err);
+        }
+
+        auto n = ::splice(in_fd,
+                          nullptr,
+                          pipe.write_end,
+                          nullptr,
+                          splice_chunk,
+                          SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if(n == 0) {
+            co_return total;
+        }
+        if(n < 0) {
+            if(errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            if(errno == EINVAL || errno == ENOSYS) {
+                // Nothing was moved; relay through user space instead.
+                direct = false;
+                break;
+            }
+            co_await fail(uv::sys_error(errno));
+        }
+
+        auto pending = static_cast<std::size_t>(n);
+        while(pending != 0) {
+            if(write_side_idle(*sink)) {
+                auto m = ::splice(pipe.read_end,
+                                  nullptr,
+                                  out_fd,
+                                  nullptr,
+                                  pending,
+                                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if(m > 0) {
+                    pending -= static_cast<std::size_t>(m);
+                    total += static_cast<std::size_t>(m);
+                    continue;
+                }
+                if(m < 0 && errno != EAGAIN && errno != EINTR) {
+                    co_await fail(uv::sys_error(errno));
+                }
+            }
+
+            // The destination is full or has writes queued: copy one chunk
+            // out of the pipe and write() it, which waits for it to drain.
+            auto chunk = buffer.get(pending);
+            auto got = ::read(pipe.read_end, chunk.data(), chunk.size());
+            if(got <= 0) {
+                co_await fail(got < 0 ? uv::sys_error(errno) : error::io_error);
+            }
+            co_await to.write(std::span<const char>(chunk.data(), static_cast<std::size_t>(got)))
+                .or_fail();
+            pending -= static_cast<std::size_t>(got);
+            total += static_cast<std::size_t>(got);
+        }
+    }
+#endif
+
+    // Relay through the source's read buffer: a chunk is consumed only once
+    // write() has handed it on, so a slow destination stops the reads.
+    while(true) {
+        auto chunk = co_await from.read_chunk();
+        if(!chunk) {
+            if(chunk.error() == error::end_of_file) {
+                break;
+            }
+            co_await fail(chunk.error());
+        }
+        co_await to.write(*chunk).or_fail();
+        from.consume(chunk->size());
+        total += chunk->size();
+    }
+    co_return total;
+}
+
+task<void, error> pipe::write_with_descriptors(std::span<const char> data,
+                                               std::span<const int> descriptors) {
+#ifdef _WIN32
+    co_await fail(error::function_not_implemented);
+#else
+    if(!self || !self->initialized() || data.empty()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(descriptors.empty()) {
+        co_await write(data).or_fail();
+        co_return;
+    }
+
+    uv_os_fd_t fd;
+    if(auto err = uv::fileno(self->stream, fd)) {
+        co_await fail(err);
+    }
+
+    // The descriptors have to go out with bytes written straight to the
+    // socket, so wait until nothing written earlier is still queued. libuv
+    // cannot report when a socket it writes to has room again without a
+    // write through it, so both waits poll.
+    auto& loop = event_loop::current();
+    std::size_t sent = 0;
+    while(true) {
+        if(write_side_idle(*self)) {
+            auto n = send_with_rights(fd, data, descriptors);
+            if(n >= 0) {
+                sent = static_cast<std::size_t>(n);
+                break;
+            }
+            if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                co_await fail(uv::sys_error(errno));
+            }
+        }
+        co_await sleep(1, loop);
+    }
+
+    if(sent < data.size()) {
+        co_await write(data.subspan(sent)).or_fail();
+    }
+#endif
+}
+
+std::size_t pipe::pending_descriptors() noexcept {
+    if(!self || !self->initialized()) {
+        return 0;
+    }
+    return static_cast<std::size_t>(uv::pipe_pending_count(self->pipe));
+}
+
+result<int> pipe::take_descriptor() {
+#ifdef _WIN32
+    return outcome_error(error::function_not_implemented);
+#else
+    if(pending_descriptors() == 0) {
+        return outcome_error(error::resource_temporarily_unavailable);
+    }
+
+    // uv_accept() hands a received descriptor over only as a handle; this
+    // one closes it again, so the caller gets a duplicate.
+    auto carrier = Self::make();
+    if(auto err = uv::pipe_init(*self->stream.loop, carrier->pipe, 0)) {
+        return outcome_error(err);
+    }
+    if(auto err = uv::accept(self->stream, carrier->stream)) {
+        return outcome_error(err);
+    }
+
+    uv_os_fd_t fd;
+    if(auto err = uv::fileno(carrier->stream, fd)) {
+        return outcome_error(err);
+    }
+
+    auto owned = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if(owned < 0) {
+        return outcome_error(uv::sys_error(errno));
+    }
+    return owned;
+#endif
+}
+
 }  // namespace kota
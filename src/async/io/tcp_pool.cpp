@@ -0,0 +1,138 @@
+#include "kota/async/io/tcp_pool.h"
+
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#endif
+
+#include "awaiter.h"
+
+namespace kota {
+
+namespace {
+
+std::string endpoint_key(std::string_view host, int port) {
+    std::string key(host);
+    key.push_back(':');
+    key.append(std::to_string(port));
+    return key;
+}
+
+/// Whether the peer still has the connection open and has sent nothing.
+/// Bytes libuv already read are in the stream buffer; the rest, and the end
+/// of stream, are still in the socket and can be peeked at there.
+bool peer_idle(tcp& conn) {
+    auto* self = conn.operator->();
+    if(self->buffer.readable_bytes() != 0) {
+        return false;
+    }
+
+#ifndef _WIN32
+    uv_os_fd_t fd;
+    if(uv::fileno(self->stream, fd)) {
+        return false;
+    }
+
+    char byte;
+    auto n = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#else
+    return true;
+#endif
+}
+
+bool healthy(tcp& conn) {
+    return conn.readable() && conn.writable() && conn.queued_bytes() == 0 && peer_idle(conn);
+}
+
+}  // namespace
+
+tcp_pool::lease::lease(tcp_pool* pool, std::string key, tcp conn, bool was_idle) noexcept :
+    pool(pool), key(std::move(key)), conn(std::move(conn)), was_idle(was_idle) {}
+
+tcp_pool::lease::lease(lease&& other) noexcept :
+    pool(std::exchange(other.pool, nullptr)), key(std::move(other.key)),
+    conn(std::move(other.conn)), was_idle(other.was_idle) {}
+
+tcp_pool::lease& tcp_pool::lease::operator=(lease&& other) noexcept {
+    if(this != &other) {
+        if(pool) {
+            pool->release(std::move(key), std::move(conn));
+        }
+        pool = std::exchange(other.pool, nullptr);
+        key = std::move(other.key);
+        conn = std::move(other.conn);
+        was_idle = other.was_idle;
+    }
+    return *this;
+}
+
+tcp_pool::lease::~lease() {
+    if(pool) {
+        pool->release(std::move(key), std::move(conn));
+    }
+}
+
+void tcp_pool::lease::discard() noexcept {
+    pool = nullptr;
+    conn = tcp();
+}
+
+tcp_pool::tcp_pool(options opts, event_loop& loop) : opts(opts), loop(&loop) {}
+
+tcp_pool::~tcp_pool() = default;
+
+task<tcp_pool::lease, error> tcp_pool::acquire(std::string_view host, int port) {
+    auto key = endpoint_key(host, port);
+
+    if(auto it = idle.find(key); it != idle.end()) {
+        auto& conns = it->second;
+        const auto now = uv::now(*loop);
+        // Most recently returned first: it is the one most likely alive.
+        while(!conns.empty()) {
+            auto entry = std::move(conns.back());
+            conns.pop_back();
+            if(now - entry.since < static_cast<std::uint64_t>(opts.idle_timeout.count()) &&
+               healthy(entry.conn)) {
+                co_return lease(this, std::move(key), std::move(entry.conn), true);
+            }
+        }
+        idle.erase(it);
+    }
+
+    auto conn = co_await tcp::connect(host, port, *loop).or_fail();
+    co_return lease(this, std::move(key), std::move(conn), false);
+}
+
+std::size_t tcp_pool::idle_count() const noexcept {
+    std::size_t count = 0;
+    for(auto& [key, conns]: idle) {
+        count += conns.size();
+    }
+    return count;
+}
+
+void tcp_pool::clear() noexcept {
+    idle.clear();
+}
+
+void tcp_pool::release(std::string key, tcp conn) {
+    if(opts.max_idle == 0 || !healthy(conn)) {
+        return;
+    }
+
+    auto& conns = idle[std::move(key)];
+    const auto now = uv::now(*loop);
+    std::erase_if(conns, [&](const idle_conn& entry) {
+        return now - entry.since >= static_cast<std::uint64_t>(opts.idle_timeout.count());
+    });
+    if(conns.size() >= opts.max_idle) {
+        // Keep the newest connections; the oldest is the first to go stale.
+        conns.erase(conns.begin());
+    }
+    conns.push_back({std::move(conn), now});
+}
+
+}  // namespace kota
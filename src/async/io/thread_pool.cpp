@@ -0,0 +1,251 @@
+#include "kota/async/io/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "awaiter.h"
+#include "../vocab/work_deque.h"
+#include "kota/async/runtime/frame.h"
+
+namespace kota {
+
+namespace {
+
+struct pool_op;
+
+/// One submitted job. Heap-allocated because a job dropped by cancellation
+/// outlives its awaiter until a worker takes it off a queue.
+struct pool_job {
+    enum State : std::uint8_t {
+        Queued,
+        Running,
+        Dropped,
+    };
+
+    pool_job(loop_callback fn, relay done) : fn(std::move(fn)), done(std::move(done)) {}
+
+    loop_callback fn;
+
+    /// Keeps the awaiting loop alive and carries the completion back to it.
+    relay done;
+
+    /// Loop thread only. Null once the awaiter gave up on the job.
+    pool_op* op = nullptr;
+
+    std::atomic<std::uint8_t> state{Queued};
+};
+
+struct pool_op : uv::await_op<pool_op> {
+    using promise_t = task<void, error>::promise_type;
+
+    struct thread_pool::self* pool;
+    pool_job* job;
+
+    pool_op(struct thread_pool::self& pool, pool_job& job) : pool(&pool), job(&job) {
+        job.op = this;
+    }
+
+    /// Only a job that no worker has claimed can be dropped; a running one
+    /// completes normally and reports the cancellation afterwards.
+    static void on_cancel(system_op* op) {
+        auto* self = static_cast<pool_op*>(op);
+        std::uint8_t expected = pool_job::Queued;
+        if(self->job->state.compare_exchange_strong(expected, pool_job::Dropped)) {
+            // The worker that dequeues it frees it.
+            self->job = nullptr;
+            self->complete();
+        }
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept;
+
+    void await_resume() const noexcept {}
+};
+
+}  // namespace
+
+struct thread_pool::self {
+    struct worker {
+        std::size_t index = 0;
+
+        /// Jobs this worker took from the shared queue; others steal from it.
+        work_stealing_deque<pool_job> local;
+
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<worker>> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+
+    /// Submitted jobs that no worker has taken yet.
+    std::deque<pool_job*> injected;
+
+    /// Bumped whenever jobs become visible, so a worker that found nothing
+    /// can tell whether it missed any before going to sleep.
+    std::uint64_t signals = 0;
+
+    bool stopping = false;
+
+    void push(pool_job* job) {
+        {
+            std::lock_guard lock(mutex);
+            injected.push_back(job);
+            signals += 1;
+        }
+        wakeup.notify_one();
+    }
+
+    /// Takes this worker's share of the shared queue: one job to run now and
+    /// the rest into its own deque, where idle workers can steal them.
+    pool_job* take_share(worker& w) {
+        pool_job* first = nullptr;
+        bool published = false;
+        {
+            std::lock_guard lock(mutex);
+            if(injected.empty()) {
+                return nullptr;
+            }
+
+            const auto share = (std::max)(std::size_t(1), injected.size() / workers.size());
+            first = injected.front();
+            injected.pop_front();
+            for(std::size_t i = 1; i < share; ++i) {
+                w.local.push(injected.front());
+                injected.pop_front();
+            }
+            if(share > 1) {
+                signals += 1;
+                published = true;
+            }
+        }
+        if(published) {
+            wakeup.notify_all();
+        }
+        return first;
+    }
+
+    pool_job* steal_for(worker& thief) {
+        const auto count = workers.size();
+        for(std::size_t offset = 1; offset < count; ++offset) {
+            auto& victim = *workers[(thief.index + offset) % count];
+            if(auto* job = victim.local.steal()) {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    pool_job* find(worker& w) {
+        if(auto* job = w.local.pop()) {
+            return job;
+        }
+        if(auto* job = take_share(w)) {
+            return job;
+        }
+        return steal_for(w);
+    }
+
+    static void run(pool_job* job) {
+        std::uint8_t expected = pool_job::Queued;
+        if(!job->state.compare_exchange_strong(expected, pool_job::Running)) {
+            // Dropped while queued; destroying the relay releases the loop.
+            delete job;
+            return;
+        }
+
+        std::move(job->fn)();
+        job->done.send([job] {
+            if(auto* op = job->op) {
+                op->complete();
+            }
+            delete job;
+        });
+    }
+
+    void run_worker(worker& w) {
+        while(true) {
+            if(auto* job = find(w)) {
+                run(job);
+                continue;
+            }
+
+            std::uint64_t seen;
+            {
+                std::lock_guard lock(mutex);
+                seen = signals;
+            }
+            if(auto* job = find(w)) {
+                run(job);
+                continue;
+            }
+
+            std::unique_lock lock(mutex);
+            // No submissions arrive once stopping; jobs left in other
+            // workers' deques are drained by their owners.
+            if(stopping && injected.empty()) {
+                return;
+            }
+            wakeup.wait(lock, [&] { return signals != seen || stopping; });
+        }
+    }
+};
+
+std::coroutine_handle<> pool_op::await_suspend(std::coroutine_handle<promise_t> waiting,
+                                               std::source_location loc) noexcept {
+    pool->push(job);
+    return this->link_continuation(&waiting.promise(), loc);
+}
+
+thread_pool::thread_pool(std::size_t workers) : self(std::make_unique<struct self>()) {
+    if(workers == 0) {
+        workers = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    self->workers.reserve(workers);
+    for(std::size_t i = 0; i < workers; ++i) {
+        auto w = std::make_unique<struct self::worker>();
+        w->index = i;
+        self->workers.push_back(std::move(w));
+    }
+    for(auto& w: self->workers) {
+        w->thread = std::thread([this, worker = w.get()] { self->run_worker(*worker); });
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard lock(self->mutex);
+        self->stopping = true;
+    }
+    self->wakeup.notify_all();
+    for(auto& w: self->workers) {
+        if(w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+}
+
+std::size_t thread_pool::size() const noexcept {
+    return self->workers.size();
+}
+
+task<void, error> thread_pool::submit(loop_callback fn, event_loop& loop) {
+    auto* job = new pool_job(std::move(fn), loop.create_relay());
+    co_await pool_op{*self, *job};
+}
+
+}  // namespace kota
@@ -0,0 +1,204 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace kota {
+
+namespace {
+
+using link = detail::wheel_link;
+
+/// Level marker for entries that were moved off the wheel while a slot is
+/// being cascaded or fired.
+constexpr std::uint8_t detached_level = 0xff;
+
+constexpr std::uint64_t slot_mask = timer_wheel::slots - 1;
+
+constexpr std::uint64_t span = std::uint64_t(1) << (timer_wheel::slot_bits * timer_wheel::levels);
+
+void init_ring(link& head) noexcept {
+    head.prev = &head;
+    head.next = &head;
+}
+
+bool ring_empty(const link& head) noexcept {
+    return head.next == &head;
+}
+
+void link_tail(link& head, link& node) noexcept {
+    node.prev = head.prev;
+    node.next = &head;
+    head.prev->next = &node;
+    head.prev = &node;
+}
+
+void unlink(link& node) noexcept {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = nullptr;
+    node.next = nullptr;
+}
+
+constexpr std::size_t shift_of(std::size_t level) noexcept {
+    return timer_wheel::slot_bits * level;
+}
+
+}  // namespace
+
+timer_wheel::timer_wheel() noexcept {
+    for(auto& level: wheel) {
+        for(auto& head: level) {
+            init_ring(head);
+        }
+    }
+}
+
+void timer_wheel::arm(entry& e, std::uint64_t expiry, std::uint64_t now) noexcept {
+    assert(!e.armed() && "timer_wheel::arm on an armed entry");
+    if(count == 0 && current < now) {
+        current = now;
+    }
+    e.expiry = expiry;
+    place(e);
+    count += 1;
+}
+
+void timer_wheel::disarm(entry& e) noexcept {
+    if(!e.armed()) {
+        return;
+    }
+
+    const auto level = e.level;
+    const auto slot = e.slot;
+    unlink(e);
+    if(level != detached_level && ring_empty(wheel[level][slot])) {
+        occupied[level] &= ~(std::uint64_t(1) << slot);
+    }
+    count -= 1;
+}
+
+void timer_wheel::place(entry& e) noexcept {
+    auto target = (std::max)(e.expiry, current);
+    if(target - current >= span) {
+        target = current + span - 1;
+    }
+
+    const auto delta = target - current;
+    std::size_t level = 0;
+    while(level + 1 < levels && delta >= (std::uint64_t(1) << shift_of(level + 1))) {
+        level += 1;
+    }
+
+    const auto slot = static_cast<std::size_t>((target >> shift_of(level)) & slot_mask);
+    e.level = static_cast<std::uint8_t>(level);
+    e.slot = static_cast<std::uint8_t>(slot);
+    link_tail(wheel[level][slot], e);
+    occupied[level] |= std::uint64_t(1) << slot;
+}
+
+void timer_wheel::detach_slot(std::size_t level, std::size_t slot, link& out) noexcept {
+    auto& head = wheel[level][slot];
+    occupied[level] &= ~(std::uint64_t(1) << slot);
+    while(!ring_empty(head)) {
+        auto& e = static_cast<entry&>(*head.next);
+        unlink(e);
+        e.level = detached_level;
+        link_tail(out, e);
+    }
+}
+
+void timer_wheel::cascade(std::size_t level, std::size_t slot) noexcept {
+    link pending;
+    init_ring(pending);
+    detach_slot(level, slot, pending);
+    while(!ring_empty(pending)) {
+        auto& e = static_cast<entry&>(*pending.next);
+        unlink(e);
+        place(e);
+    }
+}
+
+void timer_wheel::fire_slot(std::size_t slot) {
+    link due;
+    init_ring(due);
+    detach_slot(0, slot, due);
+
+    // Callbacks run with the clock already past this tick, so anything they
+    // arm lands in a later slot instead of the one being drained.
+    const auto tick = current;
+    current += 1;
+
+    // Callbacks may disarm entries still on `due`; unlinking from this local
+    // ring is as safe as unlinking from a slot.
+    while(!ring_empty(due)) {
+        auto& e = static_cast<entry&>(*due.next);
+        unlink(e);
+        if(e.expiry > tick) {
+            // Clamped from beyond the top level.
+            place(e);
+            continue;
+        }
+        count -= 1;
+        e.fire(e);
+    }
+}
+
+void timer_wheel::advance(std::uint64_t now) {
+    while(count != 0) {
+        const auto tick = next_tick();
+        if(tick > now) {
+            break;
+        }
+        current = tick;
+
+        // On a boundary, pull due slots down from the highest level that
+        // rolls over at this tick so nothing is cascaded a rotation late.
+        if((tick & slot_mask) == 0) {
+            std::size_t top = 0;
+            for(std::size_t level = 1; level < levels; ++level) {
+                top = level;
+                if(((tick >> shift_of(level)) & slot_mask) != 0) {
+                    break;
+                }
+            }
+            for(auto level = top; level >= 1; --level) {
+                cascade(level, static_cast<std::size_t>((tick >> shift_of(level)) & slot_mask));
+            }
+        }
+
+        fire_slot(static_cast<std::size_t>(tick & slot_mask));
+    }
+}
+
+std::uint64_t timer_wheel::next_tick() const noexcept {
+    if(count == 0) {
+        return never;
+    }
+
+    auto best = never;
+    for(std::size_t level = 0; level < levels; ++level) {
+        if(occupied[level] == 0) {
+            continue;
+        }
+
+        const auto shift = shift_of(level);
+        const auto base = current >> shift;
+        const auto index = static_cast<int>(base & slot_mask);
+        auto rotated = std::rotr(occupied[level], index);
+
+        // The slot under the cursor is still due only if this level's
+        // boundary at `current` has not been processed yet.
+        const bool on_boundary = (current & ((std::uint64_t(1) << shift) - 1)) == 0;
+        if(!on_boundary) {
+            rotated &= ~std::uint64_t(1);
+        }
+
+        const std::uint64_t distance = rotated ? std::countr_zero(rotated) : slots;
+        best = (std::min)(best, (base + distance) << shift);
+    }
+    return best;
+}
+
+}  // namespace kota
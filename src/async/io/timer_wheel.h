@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "kota/async/io/loop.h"
+
+namespace kota {
+
+/// Hierarchical timing wheel with 1 ms ticks, owned by an event_loop.
+///
+/// Entries are intrusive rings hung off 64-slot levels; level `l` covers
+/// deltas up to 64^(l+1) ticks. Arming computes the level from the delta and
+/// links the entry into a slot, disarming unlinks it. Both are O(1) and never
+/// allocate. Entries beyond the top level are clamped to it and re-placed
+/// each time they cascade.
+///
+/// A per-level occupancy bitmap lets next_tick() find the earliest slot that
+/// needs work without scanning, so the driving uv timer only wakes the loop
+/// when something actually expires or has to cascade.
+class timer_wheel {
+public:
+    using entry = detail::wheel_entry;
+
+    constexpr static std::size_t slot_bits = 6;
+    constexpr static std::size_t slots = std::size_t(1) << slot_bits;
+    constexpr static std::size_t levels = 4;
+
+    constexpr static std::uint64_t never = (std::numeric_limits<std::uint64_t>::max)();
+
+    timer_wheel() noexcept;
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /// Fires `e` once advance() reaches `expiry`. `now` is the caller's
+    /// clock; it only resyncs the wheel while it is empty.
+    void arm(entry& e, std::uint64_t expiry, std::uint64_t now) noexcept;
+
+    void disarm(entry& e) noexcept;
+
+    /// Fires every entry whose expiry is at or before `now`. Entry callbacks
+    /// may arm and disarm entries, including ones due in this same call.
+    void advance(std::uint64_t now);
+
+    /// Earliest tick at which advance() has work to do, or `never`.
+    std::uint64_t next_tick() const noexcept;
+
+    bool empty() const noexcept {
+        return count == 0;
+    }
+
+    std::size_t size() const noexcept {
+        return count;
+    }
+
+private:
+    using link = detail::wheel_link;
+
+    void place(entry& e) noexcept;
+
+    /// Moves every entry of one slot onto `out`, marking them detached.
+    void detach_slot(std::size_t level, std::size_t slot, link& out) noexcept;
+
+    void cascade(std::size_t level, std::size_t slot) noexcept;
+
+    void fire_slot(std::size_t slot);
+
+    /// Next tick that has not been processed yet.
+    std::uint64_t current = 0;
+
+    std::size_t count = 0;
+
+    std::uint64_t occupied[levels] = {};
+
+    link wheel[levels][slots];
+};
+
+}  // namespace kota
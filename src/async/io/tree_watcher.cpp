@@ -0,0 +1,361 @@
+#include "kota/async/io/tree_watcher.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "awaiter.h"
+#include "change_batch.h"
+#include "kota/async/io/fs.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/vocab/error.h"
+
+namespace kota {
+
+#ifdef __linux__
+
+struct tree_watcher::Self : uv::handle<tree_watcher::Self, uv_poll_t> {
+    uv_poll_t handle{};
+    event_loop* loop = nullptr;
+
+    // inotify descriptor polled by `handle`; closed after the handle is.
+    int fd = -1;
+
+    std::string root;
+
+    // Directory each watch descriptor covers, relative to root ("" for it).
+    std::unordered_map<int, std::string> dirs;
+
+    fs_change_batch batch;
+
+    ~Self() {
+        if(fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+namespace {
+
+std::string join_relative(std::string_view dir, std::string_view name) {
+    if(dir.empty()) {
+        return std::string(name);
+    }
+    std::string path;
+    path.reserve(dir.size() + 1 + name.size());
+    path.append(dir);
+    path.push_back('/');
+    path.append(name);
+    return path;
+}
+
+constexpr std::uint32_t tree_watch_mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB |
+                                          IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                          IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW |
+                                          IN_EXCL_UNLINK;
+
+std::string absolute_path(const tree_watcher::Self& self, std::string_view rel) {
+    if(rel.empty()) {
+        return self.root;
+    }
+    std::string path = self.root;
+    if(path.back() != '/') {
+        path.push_back('/');
+    }
+    path.append(rel);
+    return path;
+}
+
+error add_watch(tree_watcher::Self& self, std::string rel) {
+    auto path = absolute_path(self, rel);
+    int wd = ::inotify_add_watch(self.fd, path.c_str(), tree_watch_mask);
+    if(wd < 0) {
+        return uv::sys_error(errno);
+    }
+    self.dirs.insert_or_assign(wd, std::move(rel));
+    return {};
+}
+
+/// Watches a directory that appeared inside the tree, and everything below
+/// it. Entries already inside it were created before the watch existed, so
+/// they are reported as changes too.
+void add_subtree(tree_watcher::Self& self, std::string rel) {
+    std::vector<std::string> pending;
+    pending.push_back(std::move(rel));
+    while(!pending.empty()) {
+        auto dir_rel = std::move(pending.back());
+        pending.pop_back();
+        if(add_watch(self, dir_rel)) {
+            continue;
+        }
+
+        auto* dir = ::opendir(absolute_path(self, dir_rel).c_str());
+        if(dir == nullptr) {
+            continue;
+        }
+        while(auto* ent = ::readdir(dir)) {
+            std::string_view name = ent->d_name;
+            if(name == "." || name == "..") {
+                continue;
+            }
+
+            auto child = join_relative(dir_rel, name);
+            bool is_dir = ent->d_type == DT_DIR;
+            if(ent->d_type == DT_UNKNOWN) {
+                struct stat st{};
+                is_dir = ::lstat(absolute_path(self, child).c_str(), &st) == 0 &&
+                         S_ISDIR(st.st_mode);
+            }
+
+            self.batch.add({child, {true, false}});
+            if(is_dir) {
+                pending.push_back(std::move(child));
+            }
+        }
+        ::closedir(dir);
+    }
+}
+
+/// Drops the watches of a directory moved out of (or within) the tree; the
+/// ones it gets under a new name are added when the move's target is seen.
+void remove_subtree(tree_watcher::Self& self, std::string_view rel) {
+    for(auto it = self.dirs.begin(); it != self.dirs.end();) {
+        const auto& dir = it->second;
+        const bool below =
+            dir.size() > rel.size() && dir.starts_with(rel) && dir[rel.size()] == '/';
+        if(dir == rel || below) {
+            ::inotify_rm_watch(self.fd, it->first);
+            it = self.dirs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void handle_event(tree_watcher::Self& self, const inotify_event& ev) {
+    if((ev.mask & IN_Q_OVERFLOW) != 0) {
+        self.batch.add({"", {true, true}});
+        return;
+    }
+
+    auto it = self.dirs.find(ev.wd);
+    if(it == self.dirs.end()) {
+        return;
+    }
+
+    if((ev.mask & IN_IGNORED) != 0) {
+        self.dirs.erase(it);
+        return;
+    }
+
+    // A subdirectory going away is reported through its parent's watch.
+    if((ev.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0) {
+        if(it->second.empty()) {
+            self.batch.add({"", {true, false}});
+        }
+        return;
+    }
+
+    auto rel = join_relative(it->second, ev.len != 0 ? ev.name : "");
+    const fs_event::change_flags flags{
+        (ev.mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) != 0,
+        (ev.mask & (IN_MODIFY | IN_ATTRIB)) != 0,
+    };
+
+    if((ev.mask & IN_ISDIR) != 0) {
+        if((ev.mask & IN_MOVED_FROM) != 0) {
+            remove_subtree(self, rel);
+        }
+        if((ev.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+            add_subtree(self, rel);
+        }
+    }
+
+    self.batch.add({std::move(rel), flags});
+}
+
+void on_inotify_readable(uv_poll_t* handle, int status, [[maybe_unused]] int events) {
+    auto* self = static_cast<tree_watcher::Self*>(handle->data);
+    assert(self != nullptr && "on_inotify_readable requires watcher state in handle->data");
+
+    if(auto err = uv::status_to_error(status)) {
+        self->batch.add_error(err);
+        return;
+    }
+
+    alignas(inotify_event) char buffer[64 * 1024];
+    while(true) {
+        auto n = ::read(self->fd, buffer, sizeof(buffer));
+        if(n < 0 && errno == EINTR) {
+            continue;
+        }
+        if(n <= 0) {
+            break;
+        }
+
+        for(const char* p = buffer; p < buffer + n;) {
+            const auto* ev = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+            handle_event(*self, *ev);
+        }
+    }
+}
+
+}  // namespace
+
+result<tree_watcher> tree_watcher::create(event_loop& loop) {
+    auto self = Self::make();
+    self->fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(self->fd < 0) {
+        return outcome_error(uv::sys_error(errno));
+    }
+    if(auto err = uv::poll_init(loop, self->handle, self->fd)) {
+        return outcome_error(err);
+    }
+    self->loop = &loop;
+
+    return tree_watcher(std::move(self));
+}
+
+task<void, error> tree_watcher::start(std::string root) {
+    if(!self) {
+        co_await fail(error::invalid_argument);
+    }
+
+    auto* watcher = self.get();
+    while(root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+    watcher->root = std::move(root);
+
+    if(auto err = add_watch(*watcher, "")) {
+        co_await fail(err);
+    }
+    if(auto err = uv::poll_start(watcher->handle, UV_READABLE, on_inotify_readable)) {
+        co_await fail(err);
+    }
+
+    // Directories created during the scan are also picked up by the parent's
+    // watch; adding the same one twice only refreshes its entry.
+    const auto prefix = watcher->root.size() + (watcher->root.back() == '/' ? 0 : 1);
+    auto entries = fs::walk(watcher->root, {}, *watcher->loop);
+    while(auto entry = co_await or_fail(co_await entries.next())) {
+        if(entry->kind == fs::dirent::type::dir) {
+            add_watch(*watcher, entry->path.substr(prefix));
+        }
+    }
+}
+
+error tree_watcher::stop() {
+    if(!self) {
+        return error::invalid_argument;
+    }
+
+    if(auto err = uv::poll_stop(self->handle)) {
+        return err;
+    }
+    for(auto& [wd, dir]: self->dirs) {
+        ::inotify_rm_watch(self->fd, wd);
+    }
+    self->dirs.clear();
+
+    return {};
+}
+
+#else
+
+struct tree_watcher::Self : uv::handle<tree_watcher::Self, uv_fs_event_t> {
+    uv_fs_event_t handle{};
+    event_loop* loop = nullptr;
+    fs_change_batch batch;
+};
+
+namespace {
+
+void on_tree_change(uv_fs_event_t* handle, const char* filename, int events, int status) {
+    auto* self = static_cast<tree_watcher::Self*>(handle->data);
+    assert(self != nullptr && "on_tree_change requires watcher state in handle->data");
+
+    if(auto err = uv::status_to_error(status)) {
+        self->batch.add_error(err);
+        return;
+    }
+
+    fs_event::change c{};
+    if(filename) {
+        c.path = filename;
+    }
+    c.flags.rename = (events & UV_RENAME) != 0;
+    c.flags.change = (events & UV_CHANGE) != 0;
+    self->batch.add(std::move(c));
+}
+
+}  // namespace
+
+result<tree_watcher> tree_watcher::create(event_loop& loop) {
+    auto self = Self::make();
+    if(auto err = uv::fs_event_init(loop, self->handle)) {
+        return outcome_error(err);
+    }
+    self->loop = &loop;
+
+    return tree_watcher(std::move(self));
+}
+
+task<void, error> tree_watcher::start(std::string root) {
+    if(!self) {
+        co_await fail(error::invalid_argument);
+    }
+
+    auto& handle = self->handle;
+    if(auto err = uv::fs_event_start(handle, on_tree_change, root.c_str(), UV_FS_EVENT_RECURSIVE)) {
+        co_await fail(err);
+    }
+}
+
+error tree_watcher::stop() {
+    if(!self) {
+        return error::invalid_argument;
+    }
+
+    return uv::fs_event_stop(self->handle);
+}
+
+#endif
+
+tree_watcher::tree_watcher() noexcept = default;
+
+tree_watcher::tree_watcher(unique_handle<Self> self) noexcept : self(std::move(self)) {}
+
+tree_watcher::~tree_watcher() = default;
+
+tree_watcher::tree_watcher(tree_watcher&& other) noexcept = default;
+
+tree_watcher& tree_watcher::operator=(tree_watcher&& other) noexcept = default;
+
+tree_watcher::Self* tree_watcher::operator->() noexcept {
+    return self.get();
+}
+
+task<std::vector<fs_event::change>, error>
+    tree_watcher::wait_batch(std::chrono::milliseconds window) {
+    if(!self) {
+        co_await fail(error::invalid_argument);
+    }
+
+    co_return co_await wait_change_batch(self->batch, window, *self->loop).or_fail();
+}
+
+}  // namespace kota
@@ -1,10 +1,29 @@
 #include "kota/async/io/udp.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <optional>
 #include <utility>
 
+#ifdef __linux__
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+// Older headers lack the offload options; the kernel reports whether it
+// supports them.
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 #include "awaiter.h"
+#include "kota/support/small_vector.h"
 #include "kota/async/io/loop.h"
 #include "kota/async/vocab/error.h"
 
@@ -18,17 +37,46 @@ struct udp::Self : uv::handle<udp::Self, uv_udp_t> {
     std::vector<char> buffer;
     bool receiving = false;
 
+    // Pending recv_batch(): its slots, how many are filled, and the error
+    // to report if the read pass fails before filling any.
+    system_op* batch_waiter = nullptr;
+    std::span<udp::datagram> batch;
+    std::size_t batch_filled = 0;
+    error batch_error{};
+
     uv::stored_delivery<error> send;
     bool send_inflight = false;
+
+    // recv_segmented() waiting for the socket to become readable.
+    system_op* ready_waiter = nullptr;
+
+    // Whether UDP_SEGMENT sends and UDP_GRO receives work on this socket;
+    // unknown until first tried.
+    enum class offload : std::uint8_t { unknown, on, off };
+    offload gso = offload::unknown;
+    offload gro = offload::unknown;
 };
 
 namespace {
 
 constexpr std::size_t udp_recv_buffer_size = 64 * 1024;
 
-static udp::Self::pointer make_udp_self() {
+/// Datagrams libuv reads per recvmmsg() call at most; it splits the receive
+/// buffer into chunks of udp_recv_buffer_size, so the buffer is this many
+/// chunks long.
+constexpr std::size_t udp_mmsg_chunks = 20;
+
+/// Datagrams handed to one uv_udp_try_send2() call.
+constexpr std::size_t udp_send_batch_size = 64;
+
+/// Most segments one UDP_SEGMENT send may carry (UDP_MAX_SEGMENTS), and the
+/// largest payload of a single send, segmented or not.
+constexpr std::size_t udp_max_segments = 64;
+constexpr std::size_t udp_max_payload = 65507;
+
+static udp::Self::pointer make_udp_self(bool recvmmsg = false) {
     auto self = udp::Self::make();
-    self->buffer.resize(udp_recv_buffer_size);
+    self->buffer.resize(recvmmsg ? udp_mmsg_chunks * udp_recv_buffer_size : udp_recv_buffer_size);
     return self;
 }
 
@@ -102,6 +150,28 @@ static udp::recv_flags to_udp_recv_flags([[maybe_unused]] unsigned flags) {
     return out;
 }
 
+/// Copies one datagram into `slot`, cutting it to the slot's buffer.
+static void fill_datagram(udp::datagram& slot,
+                          std::span<const char> data,
+                          udp::recv_flags flags) {
+    slot.size = (std::min)(data.size(), slot.buffer.size());
+    slot.segment_size = slot.size;
+    if(slot.size != 0) {
+        std::memcpy(slot.buffer.data(), data.data(), slot.size);
+    }
+    slot.flags = flags;
+    if(data.size() > slot.buffer.size()) {
+        slot.flags.partial = true;
+    }
+}
+
+static void finish_batch(udp::Self* u) {
+    auto* w = u->batch_waiter;
+    u->batch_waiter = nullptr;
+    u->batch = {};
+    w->complete();
+}
+
 struct udp_recv_await : uv::await_op<udp_recv_await> {
     using await_base = uv::await_op<udp_recv_await>;
     using promise_t = task<udp::recv_result, error>::promise_type;
@@ -135,12 +205,23 @@ struct udp_recv_await : uv::await_op<udp_recv_await> {
 
     static void on_read(uv_udp_t* handle,
                         ssize_t nread,
-                        const uv_buf_t*,
+                        const uv_buf_t* buf,
                         const struct sockaddr* addr,
                         unsigned flags) {
         auto* u = static_cast<udp::Self*>(handle->data);
         assert(u != nullptr && "on_read requires udp state in handle->data");
 
+        if(u->batch_waiter) {
+            on_batch_read(u, nread, buf, addr, flags);
+            return;
+        }
+
+        if(nread == 0 && addr == nullptr) {
+            // Nothing more to read in this pass (or libuv releasing a
+            // recvmmsg buffer); not a datagram.
+            return;
+        }
+
         if(auto err = uv::status_to_error(nread)) {
             u->recv.mark_cancelled_if(nread);
             u->recv.deliver(err);
@@ -148,7 +229,8 @@ struct udp_recv_await : uv::await_op<udp_recv_await> {
         }
 
         udp::recv_result out{};
-        out.data.assign(u->buffer.data(), u->buffer.data() + nread);
+        // With recvmmsg each datagram lands in its own chunk of the buffer.
+        out.data.assign(buf->base, buf->base + nread);
         out.flags = to_udp_recv_flags(flags);
 
         if(addr != nullptr) {
@@ -162,6 +244,48 @@ struct udp_recv_await : uv::await_op<udp_recv_await> {
         u->recv.deliver(std::move(out));
     }
 
+    /// Fills the pending recv_batch() slots; completes it once they are all
+    /// filled or the read pass ends, whichever is first.
+    static void on_batch_read(udp::Self* u,
+                              ssize_t nread,
+                              const uv_buf_t* buf,
+                              const struct sockaddr* addr,
+                              unsigned flags) {
+        if(nread == 0 && addr == nullptr) {
+            if(u->batch_filled != 0) {
+                finish_batch(u);
+            }
+            return;
+        }
+
+        if(auto err = uv::status_to_error(nread)) {
+            if(u->batch_filled == 0) {
+                u->batch_error = err;
+            } else {
+                u->recv.deliver(err);
+            }
+            finish_batch(u);
+            return;
+        }
+
+        auto& slot = u->batch[u->batch_filled++];
+        fill_datagram(slot,
+                      std::span<const char>(buf->base, static_cast<std::size_t>(nread)),
+                      to_udp_recv_flags(flags));
+        slot.peer.addr.clear();
+        slot.peer.port = 0;
+        if(addr != nullptr) {
+            if(auto ep = endpoint_from_sockaddr(addr)) {
+                slot.peer.addr.assign(ep->addr);
+                slot.peer.port = ep->port;
+            }
+        }
+
+        if(u->batch_filled == u->batch.size()) {
+            finish_batch(u);
+        }
+    }
+
     bool await_ready() const noexcept {
         return false;
     }
@@ -197,6 +321,134 @@ struct udp_recv_await : uv::await_op<udp_recv_await> {
     }
 };
 
+struct udp_recv_batch_await : uv::await_op<udp_recv_batch_await> {
+    using await_base = uv::await_op<udp_recv_batch_await>;
+    using promise_t = task<std::size_t, error>::promise_type;
+
+    // UDP socket self that holds the batch slots while suspended.
+    udp::Self* self;
+    std::span<udp::datagram> batch;
+
+    udp_recv_batch_await(udp::Self* socket, std::span<udp::datagram> batch) :
+        self(socket), batch(batch) {}
+
+    static void on_cancel(system_op* op) {
+        await_base::complete_cancel(op, [](auto& aw) {
+            aw.self->batch_waiter = nullptr;
+            aw.self->batch = {};
+        });
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        self->batch_waiter = this;
+        self->batch = batch;
+        self->batch_filled = 0;
+        self->batch_error = {};
+
+        if(!self->receiving) {
+            if(auto err = uv::udp_recv_start(self->handle,
+                                             udp_recv_await::on_alloc,
+                                             udp_recv_await::on_read)) {
+                self->batch_waiter = nullptr;
+                self->batch = {};
+                self->batch_error = err;
+                return waiting;
+            }
+            self->receiving = true;
+        }
+
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    result<std::size_t> await_resume() noexcept {
+        if(self->batch_filled == 0) {
+            return outcome_error(self->batch_error ? self->batch_error : error::operation_aborted);
+        }
+        return self->batch_filled;
+    }
+};
+
+#ifdef __linux__
+
+/// Completes once the socket is readable, without receiving: a zero-length
+/// buffer from on_alloc makes libuv report UV_ENOBUFS instead of calling
+/// recvmsg(). recv_segmented() then receives itself, to see UDP_GRO's
+/// control message.
+struct udp_readable_await : uv::await_op<udp_readable_await> {
+    using await_base = uv::await_op<udp_readable_await>;
+    using promise_t = task<void, error>::promise_type;
+
+    // UDP socket self that holds the waiter while suspended.
+    udp::Self* self;
+    // Receive error seen instead of readiness.
+    error result;
+
+    explicit udp_readable_await(udp::Self* socket) : self(socket) {}
+
+    static void on_cancel(system_op* op) {
+        await_base::complete_cancel(op, [](auto& aw) {
+            uv::udp_recv_stop(aw.self->handle);
+            aw.self->ready_waiter = nullptr;
+        });
+    }
+
+    static void on_alloc(uv_handle_t*, size_t, uv_buf_t* buf) {
+        buf->base = nullptr;
+        buf->len = 0;
+    }
+
+    static void on_ready(uv_udp_t* handle,
+                         ssize_t nread,
+                         const uv_buf_t*,
+                         const struct sockaddr*,
+                         unsigned) {
+        auto* u = static_cast<udp::Self*>(handle->data);
+        assert(u != nullptr && "on_ready requires udp state in handle->data");
+
+        uv::udp_recv_stop(*handle);
+        auto* aw = static_cast<udp_readable_await*>(u->ready_waiter);
+        if(!aw) {
+            return;
+        }
+        u->ready_waiter = nullptr;
+        if(nread != UV_ENOBUFS) {
+            if(auto err = uv::status_to_error(nread)) {
+                aw->result = err;
+                aw->mark_cancelled_if(nread);
+            }
+        }
+        aw->complete();
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_t> waiting,
+                      std::source_location loc = std::source_location::current()) noexcept {
+        self->ready_waiter = this;
+        if(auto err = uv::udp_recv_start(self->handle, on_alloc, on_ready)) {
+            result = err;
+            self->ready_waiter = nullptr;
+            return waiting;
+        }
+        return this->link_continuation(&waiting.promise(), loc);
+    }
+
+    error await_resume() noexcept {
+        return result;
+    }
+};
+
+#endif
+
 struct udp_send_await : uv::await_op<udp_send_await> {
     using promise_t = task<void, error>::promise_type;
 
@@ -341,7 +593,7 @@ result<udp> udp::create(event_loop& loop) {
 }
 
 result<udp> udp::create(create_options options, event_loop& loop) {
-    auto self = make_udp_self();
+    auto self = make_udp_self(options.recvmmsg);
     auto uv_flags = to_uv_udp_init_flags(options);
     if(!uv_flags) {
         return outcome_error(uv_flags.error());
@@ -484,6 +736,300 @@ error udp::try_send(std::span<const char> data) {
     return {};
 }
 
+namespace {
+
+result<std::size_t> try_send_datagrams(uv_udp_t& handle,
+                                       std::span<const std::span<const char>> datagrams,
+                                       sockaddr* addr) {
+    std::size_t sent = 0;
+    while(sent < datagrams.size()) {
+        const auto count = (std::min)(datagrams.size() - sent, udp_send_batch_size);
+
+        small_vector<uv_buf_t, udp_send_batch_size> bufs;
+        small_vector<uv_buf_t*, udp_send_batch_size> buf_ptrs;
+        small_vector<unsigned, udp_send_batch_size> nbufs;
+        small_vector<sockaddr*, udp_send_batch_size> addrs;
+        bufs.reserve(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            auto datagram = datagrams[sent + i];
+            bufs.push_back(uv::buf_init(const_cast<char*>(datagram.data()),
+                                        static_cast<unsigned>(datagram.size())));
+        }
+        for(std::size_t i = 0; i < count; ++i) {
+            buf_ptrs.push_back(&bufs[i]);
+            nbufs.push_back(1);
+            addrs.push_back(addr);
+        }
+
+        auto res = uv::udp_try_send2(handle,
+                                     static_cast<unsigned>(count),
+                                     buf_ptrs.data(),
+                                     nbufs.data(),
+                                     addrs.data());
+        if(!res) {
+            if(sent != 0 && res.error() == error::resource_temporarily_unavailable) {
+                break;
+            }
+            return outcome_error(res.error());
+        }
+
+        sent += *res;
+        if(*res < count) {
+            break;
+        }
+    }
+    return sent;
+}
+
+}  // namespace
+
+result<std::size_t> udp::try_send_batch(std::span<const std::span<const char>> datagrams,
+                                        std::string_view host,
+                                        int port) {
+    if(!self) {
+        return outcome_error(error::invalid_argument);
+    }
+
+    if(datagrams.empty()) {
+        return std::size_t{0};
+    }
+
+    auto resolved = uv::resolve_addr(host, port);
+    if(!resolved) {
+        return outcome_error(resolved.error());
+    }
+
+    return try_send_datagrams(self->handle,
+                              datagrams,
+                              reinterpret_cast<sockaddr*>(&resolved->storage));
+}
+
+result<std::size_t> udp::try_send_batch(std::span<const std::span<const char>> datagrams) {
+    if(!self) {
+        return outcome_error(error::invalid_argument);
+    }
+
+    if(datagrams.empty()) {
+        return std::size_t{0};
+    }
+
+    return try_send_datagrams(self->handle, datagrams, nullptr);
+}
+
+task<void, error> udp::send_batch(std::span<const std::span<const char>> datagrams,
+                                  std::string_view host,
+                                  int port) {
+    std::size_t sent = 0;
+    if(auto res = try_send_batch(datagrams, host, port)) {
+        sent = *res;
+    } else if(res.error() != error::resource_temporarily_unavailable) {
+        co_await fail(res.error());
+    }
+
+    for(auto datagram: datagrams.subspan(sent)) {
+        co_await send(datagram, host, port).or_fail();
+    }
+}
+
+task<void, error> udp::send_batch(std::span<const std::span<const char>> datagrams) {
+    std::size_t sent = 0;
+    if(auto res = try_send_batch(datagrams)) {
+        sent = *res;
+    } else if(res.error() != error::resource_temporarily_unavailable) {
+        co_await fail(res.error());
+    }
+
+    for(auto datagram: datagrams.subspan(sent)) {
+        co_await send(datagram).or_fail();
+    }
+}
+
+namespace {
+
+#ifdef __linux__
+
+/// One non-blocking sendmsg() of `data`, which the kernel cuts into
+/// datagrams of `segment_size` bytes; returns the bytes sent, or -1 with
+/// errno set.
+ssize_t send_gso(int fd,
+                 std::span<const char> data,
+                 std::uint16_t segment_size,
+                 const sockaddr_storage* dest) {
+    iovec iov{};
+    iov.iov_base = const_cast<char*>(data.data());
+    iov.iov_len = data.size();
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint16_t))]{};
+    msghdr msg{};
+    if(dest) {
+        msg.msg_name = const_cast<sockaddr_storage*>(dest);
+        msg.msg_namelen = dest->ss_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    }
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    auto* header = CMSG_FIRSTHDR(&msg);
+    header->cmsg_level = IPPROTO_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+    std::memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+
+    ssize_t n;
+    do {
+        n = ::sendmsg(fd, &msg, MSG_DONTWAIT);
+    } while(n < 0 && errno == EINTR);
+    return n;
+}
+
+/// One non-blocking recvmsg() into `slot`, reading UDP_GRO's segment size;
+/// returns the bytes received, or -1 with errno set.
+ssize_t recv_gro(int fd, udp::datagram& slot) {
+    sockaddr_storage from{};
+    iovec iov{};
+    iov.iov_base = slot.buffer.data();
+    iov.iov_len = slot.buffer.size();
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    msghdr msg{};
+    msg.msg_name = &from;
+    msg.msg_namelen = sizeof(from);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = ::recvmsg(fd, &msg, MSG_DONTWAIT);
+    } while(n < 0 && errno == EINTR);
+    if(n < 0) {
+        return n;
+    }
+
+    slot.size = static_cast<std::size_t>(n);
+    slot.segment_size = slot.size;
+    slot.flags = udp::recv_flags((msg.msg_flags & MSG_TRUNC) != 0);
+    for(auto* header = CMSG_FIRSTHDR(&msg); header; header = CMSG_NXTHDR(&msg, header)) {
+        if(header->cmsg_level == IPPROTO_UDP && header->cmsg_type == UDP_GRO) {
+            int segment = 0;
+            std::memcpy(&segment, CMSG_DATA(header), sizeof(segment));
+            if(segment > 0) {
+                slot.segment_size = static_cast<std::size_t>(segment);
+            }
+        }
+    }
+
+    slot.peer.addr.clear();
+    slot.peer.port = 0;
+    if(auto ep = endpoint_from_sockaddr(reinterpret_cast<const sockaddr*>(&from))) {
+        slot.peer.addr.assign(ep->addr);
+        slot.peer.port = ep->port;
+    }
+    return n;
+}
+
+#endif
+
+/// Sends what it can of `data` as UDP_SEGMENT sends, in whole sends of up
+/// to udp_max_segments segments, and returns the bytes sent: 0 where
+/// segmentation offload is unavailable or sends are already queued, fewer
+/// than data.size() once the socket is full.
+result<std::size_t> try_send_segmented([[maybe_unused]] udp::Self& u,
+                                       [[maybe_unused]] std::span<const char> data,
+                                       [[maybe_unused]] std::size_t segment_size,
+                                       [[maybe_unused]] const sockaddr_storage* dest) {
+    std::size_t sent = 0;
+#ifdef __linux__
+    const auto per_send = (std::min)(udp_max_segments, udp_max_payload / segment_size);
+    if(u.gso == udp::Self::offload::off || per_send < 2 || u.send_inflight ||
+       uv::udp_get_send_queue_count(u.handle) != 0) {
+        return sent;
+    }
+
+    uv_os_fd_t fd;
+    if(uv::fileno(u.handle, fd)) {
+        return sent;
+    }
+
+    while(sent < data.size()) {
+        auto piece = data.subspan(sent, (std::min)(per_send * segment_size, data.size() - sent));
+        auto n = send_gso(fd, piece, static_cast<std::uint16_t>(segment_size), dest);
+        if(n < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            // Kernels without UDP_SEGMENT reject the control message, and
+            // devices without checksum offload fail the send with EIO.
+            if(u.gso == udp::Self::offload::unknown &&
+               (errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP ||
+                errno == EIO)) {
+                u.gso = udp::Self::offload::off;
+                break;
+            }
+            return outcome_error(uv::sys_error(errno));
+        }
+        u.gso = udp::Self::offload::on;
+        sent += piece.size();
+    }
+#endif
+    return sent;
+}
+
+/// Cuts `data` into `segment_size` pieces, the last one possibly shorter.
+small_vector<std::span<const char>> split_segments(std::span<const char> data,
+                                                   std::size_t segment_size) {
+    small_vector<std::span<const char>> pieces;
+    pieces.reserve((data.size() + segment_size - 1) / segment_size);
+    for(std::size_t at = 0; at < data.size(); at += segment_size) {
+        pieces.push_back(data.subspan(at, (std::min)(segment_size, data.size() - at)));
+    }
+    return pieces;
+}
+
+}  // namespace
+
+task<void, error> udp::send_segmented(std::span<const char> data,
+                                      std::size_t segment_size,
+                                      std::string_view host,
+                                      int port) {
+    if(!self || segment_size == 0 || segment_size > udp_max_payload) {
+        co_await fail(error::invalid_argument);
+    }
+
+    auto resolved = uv::resolve_addr(host, port);
+    if(!resolved) {
+        co_await fail(resolved.error());
+    }
+
+    auto sent = try_send_segmented(*self, data, segment_size, &resolved->storage);
+    if(!sent) {
+        co_await fail(sent.error());
+    }
+
+    auto rest = split_segments(data.subspan(*sent), segment_size);
+    if(!rest.empty()) {
+        co_await send_batch(rest, host, port).or_fail();
+    }
+}
+
+task<void, error> udp::send_segmented(std::span<const char> data, std::size_t segment_size) {
+    if(!self || segment_size == 0 || segment_size > udp_max_payload) {
+        co_await fail(error::invalid_argument);
+    }
+
+    auto sent = try_send_segmented(*self, data, segment_size, nullptr);
+    if(!sent) {
+        co_await fail(sent.error());
+    }
+
+    auto rest = split_segments(data.subspan(*sent), segment_size);
+    if(!rest.empty()) {
+        co_await send_batch(rest).or_fail();
+    }
+}
+
 error udp::stop_recv() {
     if(!self) {
         return error::invalid_argument;
@@ -503,13 +1049,93 @@ task<udp::recv_result, error> udp::recv() {
         co_return self->recv.take_pending();
     }
 
-    if(self->recv.has_waiter()) {
+    if(self->recv.has_waiter() || self->batch_waiter || self->ready_waiter) {
         co_await fail(error::connection_already_in_progress);
     }
 
     co_return co_await udp_recv_await{self.get()};
 }
 
+task<std::size_t, error> udp::recv_batch(std::span<datagram> batch) {
+    if(!self || batch.empty()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(self->recv.has_waiter() || self->batch_waiter || self->ready_waiter) {
+        co_await fail(error::connection_already_in_progress);
+    }
+
+    // Datagrams that arrived while nobody was waiting go first.
+    std::size_t filled = 0;
+    while(filled < batch.size() && self->recv.has_pending()) {
+        auto next = self->recv.take_pending();
+        if(!next) {
+            if(filled == 0) {
+                co_await fail(next.error());
+            }
+            // Report the error on the next call, after these datagrams.
+            self->recv.pending.push_front(std::move(next));
+            break;
+        }
+
+        auto& slot = batch[filled++];
+        fill_datagram(slot, next->data, next->flags);
+        slot.peer.addr.assign(next->addr);
+        slot.peer.port = next->port;
+    }
+
+    if(filled != 0) {
+        co_return filled;
+    }
+
+    co_return co_await udp_recv_batch_await{self.get(), batch};
+}
+
+task<void, error> udp::recv_segmented(datagram& slot) {
+    if(!self || slot.buffer.empty()) {
+        co_await fail(error::invalid_argument);
+    }
+
+    if(self->recv.has_waiter() || self->batch_waiter || self->ready_waiter) {
+        co_await fail(error::connection_already_in_progress);
+    }
+
+#ifdef __linux__
+    uv_os_fd_t fd;
+    if(self->gro == Self::offload::unknown) {
+        int on = 1;
+        self->gro = !uv::fileno(self->handle, fd) &&
+                            ::setsockopt(fd, IPPROTO_UDP, UDP_GRO, &on, sizeof(on)) == 0
+                        ? Self::offload::on
+                        : Self::offload::off;
+    }
+
+    // Datagrams libuv already received go first, through recv().
+    if(self->gro == Self::offload::on && !self->recv.has_pending() &&
+       !uv::fileno(self->handle, fd)) {
+        if(self->receiving) {
+            uv::udp_recv_stop(self->handle);
+            self->receiving = false;
+        }
+
+        while(recv_gro(fd, slot) < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                co_await fail(uv::sys_error(errno));
+            }
+            if(auto err = co_await udp_readable_await{self.get()}) {
+                co_await fail(err);
+            }
+        }
+        co_return;
+    }
+#endif
+
+    auto next = co_await recv().or_fail();
+    fill_datagram(slot, next.data, next.flags);
+    slot.peer.addr.assign(next.addr);
+    slot.peer.port = next.port;
+}
+
 result<udp::endpoint> udp::getsockname() const {
     if(!self) {
         return outcome_error(error::invalid_argument);
@@ -4,6 +4,7 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
 #include <span>
@@ -58,6 +59,7 @@ concept handle_like = is_one_of<bare_t<T>,
                                 uv_check_t,
                                 uv_signal_t,
                                 uv_fs_event_t,
+                                uv_poll_t,
                                 uv_process_t,
                                 uv_async_t>;
 
@@ -66,7 +68,14 @@ concept stream_like = is_one_of<bare_t<T>, uv_stream_t, uv_tcp_t, uv_pipe_t, uv_
 
 template <typename T>
 concept req_like =
-    is_one_of<bare_t<T>, uv_req_t, uv_fs_t, uv_work_t, uv_write_t, uv_udp_send_t, uv_connect_t>;
+    is_one_of<bare_t<T>,
+              uv_req_t,
+              uv_fs_t,
+              uv_work_t,
+              uv_write_t,
+              uv_udp_send_t,
+              uv_connect_t,
+              uv_getaddrinfo_t>;
 
 template <handle_like H>
 ALWAYS_INLINE uv_handle_t* as_handle(H& handle) noexcept {
@@ -117,6 +126,12 @@ ALWAYS_INLINE error status_to_error(StatusT status) noexcept {
     return {};
 }
 
+/// Maps a platform error (errno, or GetLastError() on Windows) from a call
+/// made outside libuv to the matching libuv error.
+ALWAYS_INLINE error sys_error(int code) noexcept {
+    return status_to_error(::uv_translate_sys_error(code));
+}
+
 template <handle_like H>
 ALWAYS_INLINE bool is_active(const H& handle) noexcept {
     return ::uv_is_active(as_handle(handle)) != 0;
@@ -132,11 +147,21 @@ ALWAYS_INLINE bool is_writable(const S& stream) noexcept {
     return ::uv_is_writable(as_stream(stream)) != 0;
 }
 
+template <stream_like S>
+ALWAYS_INLINE std::size_t write_queue_size(const S& stream) noexcept {
+    return ::uv_stream_get_write_queue_size(as_stream(stream));
+}
+
 template <handle_like H>
 ALWAYS_INLINE bool is_closing(const H& handle) noexcept {
     return ::uv_is_closing(as_handle(handle)) != 0;
 }
 
+template <handle_like H>
+ALWAYS_INLINE error fileno(const H& handle, uv_os_fd_t& fd) noexcept {
+    return status_to_error(::uv_fileno(as_handle(handle), &fd));
+}
+
 template <handle_like H>
 ALWAYS_INLINE void ref(H& handle) noexcept {
     ::uv_ref(as_handle(handle));
@@ -159,10 +184,56 @@ ALWAYS_INLINE error cancel(R& req) noexcept {
 }
 
 ALWAYS_INLINE error loop_init(uv_loop_t& loop) noexcept {
+#if KOTA_ASYNC_IO_URING && defined(__linux__)
+    // libuv submits fs requests (open, read, write, stat, close, ...) to an
+    // io_uring from the loop thread instead of its threadpool only when
+    // UV_USE_IO_URING is set, and reads it once, at the first loop init of
+    // the process. An explicit setting in the environment still wins.
+    [[maybe_unused]] static const bool io_uring_requested =
+        ::setenv("UV_USE_IO_URING", "1", 0) == 0;
+#endif
     // Errors: UV_ENOMEM and platform init failures.
     return status_to_error(::uv_loop_init(&loop));
 }
 
+ALWAYS_INLINE error enable_idle_metrics(uv_loop_t& loop) noexcept {
+    // Errors: UV_ENOSYS when the platform cannot measure idle time.
+    return status_to_error(::uv_loop_configure(&loop, UV_METRICS_IDLE_TIME));
+}
+
+ALWAYS_INLINE std::uint64_t metrics_idle_time(uv_loop_t& loop) noexcept {
+    return ::uv_metrics_idle_time(&loop);
+}
+
+ALWAYS_INLINE std::uint64_t metrics_loop_count(uv_loop_t& loop) noexcept {
+    uv_metrics_t metrics = {};
+    [[maybe_unused]] int rc = ::uv_metrics_info(&loop, &metrics);
+    assert(rc == 0 && "uv::metrics_info failed");
+    return metrics.loop_count;
+}
+
+/// Events the backend poll has reported so far, counted whether or not idle
+/// time metrics are enabled.
+ALWAYS_INLINE std::uint64_t metrics_events(uv_loop_t& loop) noexcept {
+    uv_metrics_t metrics = {};
+    [[maybe_unused]] int rc = ::uv_metrics_info(&loop, &metrics);
+    assert(rc == 0 && "uv::metrics_info failed");
+    return metrics.events;
+}
+
+ALWAYS_INLINE std::uint64_t hrtime() noexcept {
+    return ::uv_hrtime();
+}
+
+ALWAYS_INLINE std::uint64_t get_total_memory() noexcept {
+    return ::uv_get_total_memory();
+}
+
+/// Memory limit imposed on this process, e.g. by a cgroup; 0 when unknown.
+ALWAYS_INLINE std::uint64_t get_constrained_memory() noexcept {
+    return ::uv_get_constrained_memory();
+}
+
 ALWAYS_INLINE error loop_close(uv_loop_t& loop) noexcept {
     // Errors: UV_EBUSY when active handles/requests remain.
     return status_to_error(::uv_loop_close(&loop));
@@ -172,6 +243,16 @@ ALWAYS_INLINE int run(uv_loop_t& loop, uv_run_mode mode) noexcept {
     return ::uv_run(&loop, mode);
 }
 
+ALWAYS_INLINE int backend_fd(const uv_loop_t& loop) noexcept {
+    // -1 where the platform has no pollable backend descriptor (Windows).
+    return ::uv_backend_fd(&loop);
+}
+
+ALWAYS_INLINE int backend_timeout(const uv_loop_t& loop) noexcept {
+    // -1 means no timeout: nothing is due until an event arrives.
+    return ::uv_backend_timeout(&loop);
+}
+
 ALWAYS_INLINE void stop(uv_loop_t& loop) noexcept {
     ::uv_stop(&loop);
 }
@@ -181,6 +262,10 @@ ALWAYS_INLINE void walk(uv_loop_t& loop, uv_walk_cb cb, void* arg) noexcept {
     ::uv_walk(&loop, cb, arg);
 }
 
+ALWAYS_INLINE std::uint64_t now(const uv_loop_t& loop) noexcept {
+    return ::uv_now(&loop);
+}
+
 ALWAYS_INLINE void idle_init(uv_loop_t& loop, uv_idle_t& handle) noexcept {
     [[maybe_unused]] int rc = ::uv_idle_init(&loop, &handle);
     assert(rc == 0 && "uv::idle_init failed");
@@ -300,6 +385,20 @@ ALWAYS_INLINE error fs_event_stop(uv_fs_event_t& handle) noexcept {
     return status_to_error(::uv_fs_event_stop(&handle));
 }
 
+ALWAYS_INLINE error poll_init(uv_loop_t& loop, uv_poll_t& handle, int fd) noexcept {
+    // Errors: UV_EEXIST if fd is already polled by a handle on this loop.
+    return status_to_error(::uv_poll_init(&loop, &handle, fd));
+}
+
+ALWAYS_INLINE error poll_start(uv_poll_t& handle, int events, uv_poll_cb cb) noexcept {
+    assert(cb != nullptr && "uv::poll_start requires non-null callback");
+    return status_to_error(::uv_poll_start(&handle, events, cb));
+}
+
+ALWAYS_INLINE error poll_stop(uv_poll_t& handle) noexcept {
+    return status_to_error(::uv_poll_stop(&handle));
+}
+
 template <stream_like S>
 ALWAYS_INLINE error read_start(S& stream, uv_alloc_cb alloc_cb, uv_read_cb read_cb) noexcept {
     assert(alloc_cb != nullptr && read_cb != nullptr &&
@@ -342,6 +441,10 @@ ALWAYS_INLINE error pipe_open(uv_pipe_t& handle, uv_file fd) noexcept {
     return status_to_error(::uv_pipe_open(&handle, fd));
 }
 
+ALWAYS_INLINE int pipe_pending_count(uv_pipe_t& handle) noexcept {
+    return ::uv_pipe_pending_count(&handle);
+}
+
 ALWAYS_INLINE error pipe_bind2(uv_pipe_t& handle,
                                const char* name,
                                std::size_t namelen,
@@ -496,6 +599,22 @@ ALWAYS_INLINE result<std::size_t> udp_try_send(uv_udp_t& handle,
     return static_cast<std::size_t>(rc);
 }
 
+/// Sends up to `count` datagrams, one sendmmsg() where the platform has it;
+/// returns how many were sent. `addrs` entries may be null on a connected
+/// socket.
+ALWAYS_INLINE result<std::size_t> udp_try_send2(uv_udp_t& handle,
+                                                unsigned count,
+                                                uv_buf_t* bufs[],
+                                                unsigned nbufs[],
+                                                sockaddr* addrs[]) noexcept {
+    assert(count != 0 && "uv::udp_try_send2 requires at least one datagram");
+    int rc = ::uv_udp_try_send2(&handle, count, bufs, nbufs, addrs, 0);
+    if(rc < 0) {
+        return outcome_error(error(rc));
+    }
+    return static_cast<std::size_t>(rc);
+}
+
 ALWAYS_INLINE error udp_getsockname(const uv_udp_t& handle, sockaddr& name, int& namelen) noexcept {
     return status_to_error(::uv_udp_getsockname(&handle, &name, &namelen));
 }
@@ -597,6 +716,21 @@ ALWAYS_INLINE error ip6_name(const sockaddr_in6& src, char* dst, std::size_t siz
     return status_to_error(::uv_ip6_name(&src, dst, size));
 }
 
+ALWAYS_INLINE error getaddrinfo(uv_loop_t& loop,
+                                uv_getaddrinfo_t& req,
+                                uv_getaddrinfo_cb cb,
+                                const char* node,
+                                const addrinfo* hints) noexcept {
+    assert(cb != nullptr && node != nullptr &&
+           "uv::getaddrinfo requires non-null callback and node");
+    // Errors: UV_EINVAL and UV_ENOMEM; lookup failures arrive in the callback.
+    return status_to_error(::uv_getaddrinfo(&loop, &req, cb, node, nullptr, hints));
+}
+
+ALWAYS_INLINE void freeaddrinfo(addrinfo* ai) noexcept {
+    ::uv_freeaddrinfo(ai);
+}
+
 ALWAYS_INLINE std::string_view strerror(int code) noexcept {
     const char* msg = ::uv_strerror(code);
     return msg == nullptr ? std::string_view{} : std::string_view(msg);
@@ -919,6 +1053,15 @@ inline result<resolved_addr> resolve_addr(std::string_view host, int port) {
     return outcome_error(error::invalid_argument);
 }
 
+inline void set_port(resolved_addr& addr, int port) noexcept {
+    const auto net_port = htons(static_cast<std::uint16_t>(port));
+    if(addr.family == AF_INET6) {
+        reinterpret_cast<sockaddr_in6*>(&addr.storage)->sin6_port = net_port;
+    } else {
+        reinterpret_cast<sockaddr_in*>(&addr.storage)->sin_port = net_port;
+    }
+}
+
 /// Tracks handles that were force-closed during event_loop teardown.
 ///
 /// This is a fallback path for late owner destruction: the normal contract is
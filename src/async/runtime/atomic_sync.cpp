@@ -0,0 +1,358 @@
+#include "kota/async/runtime/atomic_sync.h"
+
+#include <cassert>
+
+namespace kota {
+
+namespace detail {
+
+namespace {
+
+atomic_wait_ticket* as_ticket(std::uintptr_t word) noexcept {
+    return reinterpret_cast<atomic_wait_ticket*>(word);
+}
+
+std::uintptr_t as_word(atomic_wait_ticket* ticket) noexcept {
+    return reinterpret_cast<std::uintptr_t>(ticket);
+}
+
+atomic_wait_ticket* reverse(atomic_wait_ticket* chain) noexcept {
+    atomic_wait_ticket* reversed = nullptr;
+    while(chain) {
+        auto* next = chain->next;
+        chain->next = reversed;
+        reversed = chain;
+        chain = next;
+    }
+    return reversed;
+}
+
+/// Wakes the first live waiter on `chain`, dropping every ticket it passes.
+/// Returns false if the chain ran out first.
+bool wake_first(atomic_wait_ticket*& chain) {
+    while(chain) {
+        auto* ticket = chain;
+        chain = ticket->next;
+        const bool woke = ticket->wake();
+        ticket->release();
+        if(woke) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Drops every ticket on a chain that has been detached from its stack.
+void wake_all(atomic_wait_ticket* chain) {
+    while(chain) {
+        auto* ticket = chain;
+        chain = ticket->next;
+        ticket->wake();
+        ticket->release();
+    }
+}
+
+}  // namespace
+
+bool atomic_wait_ticket::wake() {
+    std::uint8_t expected = Waiting;
+    if(!status.compare_exchange_strong(expected,
+                                       Woken,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Winning the transition pins the op: it can no longer complete through
+    // on_cancel, so it stays alive until the posted callback finishes it.
+    auto* waiter = op;
+    wakeup->send([waiter] {
+        if(waiter->is_cancelled() && waiter->forfeit) {
+            waiter->forfeit(*waiter);
+        }
+        waiter->complete();
+    });
+    return true;
+}
+
+atomic_waiter::atomic_waiter() {
+    this->action = &on_cancel;
+}
+
+atomic_waiter::~atomic_waiter() {
+    if(ticket) {
+        ticket->release();
+    }
+}
+
+atomic_wait_ticket* atomic_waiter::make_ticket() {
+    assert(!ticket && "atomic_waiter: ticket already allocated");
+    ticket = new atomic_wait_ticket();
+    ticket->wakeup.emplace(event_loop::current().create_relay());
+    ticket->op = this;
+    return ticket;
+}
+
+void atomic_waiter::discard_ticket() noexcept {
+    delete ticket;
+    ticket = nullptr;
+}
+
+void atomic_waiter::link(async_node* parent, std::source_location location) {
+    link_continuation(parent, location);
+}
+
+void atomic_waiter::on_cancel(system_op* op) {
+    auto* self = static_cast<atomic_waiter*>(op);
+    auto* ticket = self->ticket;
+    if(!ticket) {
+        return;
+    }
+
+    std::uint8_t expected = atomic_wait_ticket::Waiting;
+    if(ticket->status.compare_exchange_strong(expected,
+                                              atomic_wait_ticket::Cancelled,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+        // The ticket stays on the stack; whoever detaches it next drops it.
+        // Release the loop hold here, on the loop's own thread.
+        ticket->wakeup.reset();
+        self->complete();
+    }
+    // Otherwise a wakeup is already posted and will complete the op with
+    // the Cancelled state preserved.
+}
+
+}  // namespace detail
+
+// ── atomic_event ────────────────────────────────────────────────────
+
+atomic_event::atomic_event(bool initially_set) noexcept :
+    state(initially_set ? signaled : 0) {}
+
+atomic_event::~atomic_event() {
+    auto word = state.load(std::memory_order_acquire);
+    if(word != 0 && word != signaled) {
+        auto* chain = detail::as_ticket(word);
+        for(auto* ticket = chain; ticket; ticket = ticket->next) {
+            assert(ticket->status.load() == detail::atomic_wait_ticket::Cancelled &&
+                   "atomic_event destroyed with parked waiters");
+        }
+        detail::wake_all(chain);
+    }
+}
+
+bool atomic_event::wait_awaiter::suspend(async_node* parent, std::source_location location) {
+    auto& state = owner->state;
+    auto word = state.load(std::memory_order_acquire);
+    detail::atomic_wait_ticket* ticket = nullptr;
+
+    for(;;) {
+        if(word == signaled) {
+            if(ticket) {
+                discard_ticket();
+            }
+            return false;
+        }
+
+        if(!ticket) {
+            ticket = make_ticket();
+        }
+        ticket->next = detail::as_ticket(word);
+        if(state.compare_exchange_weak(word,
+                                       detail::as_word(ticket),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    // A concurrent set() can only post our completion, which runs on this
+    // thread after we return, so linking after publishing is safe.
+    link(parent, location);
+    return true;
+}
+
+void atomic_event::set() {
+    auto word = state.exchange(signaled, std::memory_order_acq_rel);
+    if(word != 0 && word != signaled) {
+        detail::wake_all(detail::as_ticket(word));
+    }
+}
+
+void atomic_event::reset() noexcept {
+    auto expected = signaled;
+    state.compare_exchange_strong(expected, 0, std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+bool atomic_event::is_set() const noexcept {
+    return state.load(std::memory_order_acquire) == signaled;
+}
+
+// ── atomic_semaphore ────────────────────────────────────────────────
+
+namespace {
+
+constexpr std::uintptr_t encode_count(std::ptrdiff_t count) noexcept {
+    return (static_cast<std::uintptr_t>(count) << 1) | 1;
+}
+
+constexpr bool has_count(std::uintptr_t word) noexcept {
+    return (word & 1) != 0;
+}
+
+constexpr std::ptrdiff_t decode_count(std::uintptr_t word) noexcept {
+    return static_cast<std::ptrdiff_t>(word >> 1);
+}
+
+/// Encoded value for "no permits and no waiters".
+constexpr std::uintptr_t empty_word = encode_count(0);
+
+}  // namespace
+
+atomic_semaphore::atomic_semaphore(std::ptrdiff_t initial) noexcept :
+    state(encode_count(initial)) {
+    assert(initial >= 0 && "atomic_semaphore initial count must be non-negative");
+}
+
+atomic_semaphore::~atomic_semaphore() {
+    auto word = state.load(std::memory_order_acquire);
+    if(!has_count(word)) {
+        auto* chain = detail::as_ticket(word);
+        for(auto* ticket = chain; ticket; ticket = ticket->next) {
+            assert(ticket->status.load() == detail::atomic_wait_ticket::Cancelled &&
+                   "atomic_semaphore destroyed with parked waiters");
+        }
+        detail::wake_all(chain);
+    }
+}
+
+bool atomic_semaphore::acquire_awaiter::suspend(async_node* parent,
+                                                std::source_location location) {
+    auto& state = owner->state;
+    auto word = state.load(std::memory_order_acquire);
+    detail::atomic_wait_ticket* ticket = nullptr;
+
+    for(;;) {
+        if(has_count(word) && decode_count(word) > 0) {
+            if(state.compare_exchange_weak(word,
+                                           word - 2,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                if(ticket) {
+                    discard_ticket();
+                }
+                return false;
+            }
+            continue;
+        }
+
+        if(!ticket) {
+            ticket = make_ticket();
+        }
+        ticket->next = has_count(word) ? nullptr : detail::as_ticket(word);
+        if(state.compare_exchange_weak(word,
+                                       detail::as_word(ticket),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    link(parent, location);
+    return true;
+}
+
+bool atomic_semaphore::try_acquire() noexcept {
+    auto word = state.load(std::memory_order_acquire);
+    while(has_count(word) && decode_count(word) > 0) {
+        if(state.compare_exchange_weak(word,
+                                       word - 2,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void atomic_semaphore::release(std::ptrdiff_t n) {
+    assert(n >= 0 && "atomic_semaphore::release count must be non-negative");
+    for(std::ptrdiff_t i = 0; i < n; ++i) {
+        release_one();
+    }
+}
+
+void atomic_semaphore::release_one() {
+    auto word = state.load(std::memory_order_acquire);
+    for(;;) {
+        if(has_count(word)) {
+            if(state.compare_exchange_weak(word,
+                                           word + 2,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                return;
+            }
+            continue;
+        }
+
+        // Detach the whole stack. Popping a single node would read `next`
+        // from a node another releaser may already have freed (ABA).
+        if(!state.compare_exchange_weak(word,
+                                        empty_word,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            continue;
+        }
+        if(hand_off(detail::as_ticket(word))) {
+            return;
+        }
+        word = state.load(std::memory_order_acquire);
+    }
+}
+
+bool atomic_semaphore::hand_off(detail::atomic_wait_ticket* waiters) {
+    // The stack is newest-first; serve the oldest waiter.
+    auto* oldest = detail::reverse(waiters);
+    if(!detail::wake_first(oldest)) {
+        return false;
+    }
+
+    // Push the remaining waiters back. Permits released while the chain was
+    // detached went into the count; hand those out first.
+    while(oldest) {
+        auto word = state.load(std::memory_order_acquire);
+        if(has_count(word) && decode_count(word) > 0) {
+            if(state.compare_exchange_strong(word,
+                                             word - 2,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                if(!detail::wake_first(oldest)) {
+                    // Everyone left was cancelled; return the permit.
+                    release_one();
+                }
+            }
+            continue;
+        }
+
+        auto* bottom = oldest;
+        auto* top = detail::reverse(oldest);
+        bottom->next = has_count(word) ? nullptr : detail::as_ticket(word);
+        if(state.compare_exchange_strong(word,
+                                         detail::as_word(top),
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+            return true;
+        }
+        bottom->next = nullptr;
+        oldest = detail::reverse(top);
+    }
+    return true;
+}
+
+std::ptrdiff_t atomic_semaphore::available() const noexcept {
+    auto word = state.load(std::memory_order_acquire);
+    return has_count(word) ? decode_count(word) : 0;
+}
+
+}  // namespace kota
@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <format>
 #include <set>
 #include <string>
 #include <string_view>
 
+#include "trace.h"
+#include "kota/async/io/deadline.h"
+#include "kota/async/io/profiler.h"
 #include "kota/async/runtime/frame.h"
 #include "kota/async/runtime/sync.h"
 
@@ -15,6 +19,7 @@ static std::string_view async_kind_name(async_node::NodeKind k) {
         case async_node::NodeKind::EventWaiter: return "EventWaiter";
         case async_node::NodeKind::WhenAll: return "WhenAll";
         case async_node::NodeKind::WhenAny: return "WhenAny";
+        case async_node::NodeKind::WhenEach: return "WhenEach";
         case async_node::NodeKind::Scope: return "Scope";
         case async_node::NodeKind::SystemIO: return "SystemIO";
     }
@@ -35,9 +40,11 @@ static std::string_view state_name(async_node::State s) {
 static std::string_view sync_kind_name(sync_primitive::Kind k) {
     switch(k) {
         case sync_primitive::Kind::Mutex: return "Mutex";
+        case sync_primitive::Kind::SharedMutex: return "SharedMutex";
         case sync_primitive::Kind::Event: return "Event";
         case sync_primitive::Kind::Semaphore: return "Semaphore";
         case sync_primitive::Kind::ConditionVariable: return "ConditionVariable";
+        case sync_primitive::Kind::Channel: return "Channel";
     }
     return "Unknown";
 }
@@ -150,6 +157,7 @@ const async_node* async_node::get_awaiter(const async_node* node) {
         }
         case NodeKind::WhenAll:
         case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
         case NodeKind::Scope: return static_cast<const aggregate_op*>(node)->awaiter;
         case NodeKind::SystemIO: return static_cast<const system_op*>(node)->awaiter;
         default: return nullptr;
@@ -187,6 +195,7 @@ void async_node::dump_dot_walk(const async_node* node,
 
         case NodeKind::WhenAll:
         case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
         case NodeKind::Scope: {
             auto* agg = static_cast<const aggregate_op*>(node);
             for(auto* child: agg->awaitees) {
@@ -253,4 +262,253 @@ std::string async_node::dump_dot() const {
     return out;
 }
 
+void async_node::walk_waits(const async_node* node,
+                            std::vector<const async_node*>& path,
+                            function_ref<void(std::span<const async_node* const>)>& visit) {
+    if(!node || (node->state != Pending && node->state != Running)) {
+        return;
+    }
+
+    path.push_back(node);
+    bool leaf = true;
+    switch(node->kind) {
+        case NodeKind::Task: {
+            auto* task = static_cast<const standard_task*>(node);
+            if(task->awaitee) {
+                walk_waits(task->awaitee, path, visit);
+                leaf = false;
+            }
+            break;
+        }
+
+        case NodeKind::WhenAll:
+        case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
+        case NodeKind::Scope: {
+            auto* agg = static_cast<const aggregate_op*>(node);
+            for(auto* child: agg->awaitees) {
+                if(child && (child->state == Pending || child->state == Running)) {
+                    walk_waits(child, path, visit);
+                    leaf = false;
+                }
+            }
+            break;
+        }
+
+        case NodeKind::MutexWaiter:
+        case NodeKind::EventWaiter:
+        case NodeKind::SystemIO: break;
+    }
+
+    if(leaf) {
+        visit(std::span<const async_node* const>(path));
+    }
+    path.pop_back();
+}
+
+void async_node::walk_waits(function_ref<void(std::span<const async_node* const>)> visit) const {
+    std::vector<const async_node*> path;
+    walk_waits(this, path, visit);
+}
+
+static std::string_view trace_phase_name(task_trace::Phase phase) {
+    switch(phase) {
+        case task_trace::Phase::Create: return "create";
+        case task_trace::Phase::Resume: return "resume";
+        case task_trace::Phase::Finish: return "finish";
+        case task_trace::Phase::Mark: return "mark";
+    }
+    return "unknown";
+}
+
+static void append_json_string(std::string_view text, std::string& out) {
+    out += '"';
+    for(char c: text) {
+        switch(c) {
+            case '"': out += R"(\")"; break;
+            case '\\': out += R"(\\)"; break;
+            case '\n': out += R"(\n)"; break;
+            case '\t': out += R"(\t)"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    std::format_to(std::back_inserter(out), R"(\u{:04x})", static_cast<unsigned>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+std::string task_trace::to_chrome_json(std::uint32_t thread_id) const {
+    std::string out = R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+    // Oldest first: once the ring has wrapped, the slot after the newest
+    // event holds the oldest one.
+    const bool wrapped = total > records.size();
+    const auto count = wrapped ? records.size() : total;
+    const auto first = wrapped ? next : 0;
+
+    for(std::size_t i = 0; i < count; ++i) {
+        const auto& entry = records[(first + i) % records.size()];
+        if(i != 0) {
+            out += ',';
+        }
+
+        const char* function = entry.location.function_name();
+        out += R"({"name":)";
+        if(entry.phase == Phase::Mark) {
+            append_json_string(entry.name.view(), out);
+        } else {
+            append_json_string(function && function[0] != '\0' ? std::string_view(function)
+                                                                 : async_kind_name(entry.kind),
+                               out);
+        }
+
+        const double ts = static_cast<double>(entry.start - epoch) / 1000.0;
+        std::format_to(std::back_inserter(out),
+                       R"(,"cat":"{}","pid":1,"tid":{},"ts":{:.3f})",
+                       trace_phase_name(entry.phase),
+                       thread_id,
+                       ts);
+        if(entry.phase == Phase::Resume) {
+            std::format_to(std::back_inserter(out),
+                           R"(,"ph":"X","dur":{:.3f})",
+                           static_cast<double>(entry.duration) / 1000.0);
+        } else {
+            out += R"(,"ph":"i","s":"t")";
+        }
+
+        std::format_to(std::back_inserter(out),
+                       R"(,"args":{{"node":"{}","kind":"{}","state":"{}","file":)",
+                       node_id(entry.node),
+                       async_kind_name(entry.kind),
+                       state_name(entry.state));
+        append_json_string(entry.location.file_name(), out);
+        std::format_to(std::back_inserter(out), R"(,"line":{}}}}})", entry.location.line());
+    }
+
+    std::format_to(std::back_inserter(out), R"(],"otherData":{{"dropped":{}}}}})", dropped());
+    return out;
+}
+
+/// One folded-stack frame: the node's kind and where it was awaited.
+static void append_frame(const async_node& node, std::string& out) {
+    out += async_kind_name(node.kind);
+    auto file = basename(node.location.file_name());
+    if(!file.empty()) {
+        std::format_to(std::back_inserter(out), " {}:{}", file, node.location.line());
+    }
+}
+
+async_profiler::async_profiler(std::chrono::milliseconds interval, event_loop& loop) noexcept :
+    interval((std::max)(interval, std::chrono::milliseconds(1))), loop(loop) {}
+
+async_profiler::~async_profiler() {
+    stop();
+}
+
+void async_profiler::watch(const async_node* root) {
+    if(root && std::ranges::find(roots, root) == roots.end()) {
+        roots.push_back(root);
+    }
+}
+
+void async_profiler::unwatch(const async_node* root) noexcept {
+    std::erase(roots, root);
+}
+
+void async_profiler::start() {
+    if(sampler) {
+        return;
+    }
+    sampler.emplace();
+    loop.schedule(sample_every(sampler->token()));
+}
+
+void async_profiler::stop() noexcept {
+    // Destroying the source cancels the sampler's wait; it then returns
+    // without touching the profiler.
+    sampler.reset();
+}
+
+task<> async_profiler::sample_every(cancellation_token token) {
+    while(true) {
+        auto waited = co_await with_token(after(interval, loop), token);
+        if(!waited.has_value()) {
+            co_return;
+        }
+        sample();
+    }
+}
+
+void async_profiler::sample() {
+    ticks += 1;
+
+    auto count = [this](std::span<const async_node* const> path) {
+        scratch.clear();
+        for(auto* node: path) {
+            if(!scratch.empty()) {
+                scratch += ';';
+            }
+            append_frame(*node, scratch);
+        }
+        if(auto it = stacks.find(std::string_view(scratch)); it != stacks.end()) {
+            it->second += 1;
+        } else {
+            stacks.try_emplace(scratch, 1);
+        }
+
+        const auto& leaf = *path.back();
+        scratch.clear();
+        append_frame(leaf, scratch);
+        auto it = sites.find(std::string_view(scratch));
+        if(it == sites.end()) {
+            it = sites.try_emplace(scratch, wait_site{leaf.kind, leaf.location}).first;
+        }
+        it->second.samples += 1;
+        it->second.waited += interval;
+    };
+
+    for(auto* root: roots) {
+        root->walk_waits(count);
+    }
+}
+
+std::string async_profiler::folded() const {
+    std::vector<std::pair<std::string_view, std::uint64_t>> lines;
+    lines.reserve(stacks.size());
+    for(auto& [stack, count]: stacks) {
+        lines.emplace_back(stack, count);
+    }
+    std::ranges::sort(lines);
+
+    std::string out;
+    for(auto& [stack, count]: lines) {
+        std::format_to(std::back_inserter(out), "{} {}\n", stack, count);
+    }
+    return out;
+}
+
+std::vector<async_profiler::wait_site> async_profiler::hottest(std::size_t limit) const {
+    std::vector<wait_site> out;
+    out.reserve(sites.size());
+    for(auto& [key, site]: sites) {
+        out.push_back(site);
+    }
+    std::ranges::stable_sort(out, [](const wait_site& lhs, const wait_site& rhs) {
+        return lhs.samples > rhs.samples;
+    });
+    if(out.size() > limit) {
+        out.resize(limit);
+    }
+    return out;
+}
+
+void async_profiler::reset() noexcept {
+    ticks = 0;
+    stacks.clear();
+    sites.clear();
+}
+
 }  // namespace kota
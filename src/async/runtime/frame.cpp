@@ -1,17 +1,33 @@
 #include "kota/async/runtime/frame.h"
 
+#include <algorithm>
 #include <cassert>
+#include <new>
 #include <utility>
 #include <vector>
 
 #include "../libuv.h"
+#include "frame_pool.h"
+#include "loop_stats.h"
+#include "trace.h"
 #include "kota/async/io/loop.h"
 #include "kota/async/runtime/sync.h"
+#include "kota/support/memory.h"
 
 namespace kota {
 
 namespace {
 
+thread_local frame_pool* active_frame_pool = nullptr;
+
+#if KOTA_ASYNC_LOOP_STATS
+thread_local loop_stats* current_loop_stats = nullptr;
+#endif
+
+#if KOTA_ASYNC_TRACE
+thread_local task_trace* current_trace = nullptr;
+#endif
+
 #if KOTA_WORKAROUND_MSVC_COROUTINE_ASAN_UAF
 thread_local std::vector<std::coroutine_handle<>> pending_frame_destroys;
 #endif
@@ -44,6 +60,11 @@ void drain_pending_destroys() {
 
 void detail::resume_and_drain(std::coroutine_handle<> handle) {
     if(handle) {
+#if KOTA_ASYNC_LOOP_STATS
+        if(auto* stats = current_loop_stats; stats && handle != std::noop_coroutine()) {
+            stats->continuations += 1;
+        }
+#endif
         handle.resume();
     }
 #if KOTA_WORKAROUND_MSVC_COROUTINE_ASAN_UAF
@@ -51,6 +72,54 @@ void detail::resume_and_drain(std::coroutine_handle<> handle) {
 #endif
 }
 
+frame_pool* exchange_active_frame_pool(frame_pool* pool) noexcept {
+    return std::exchange(active_frame_pool, pool);
+}
+
+loop_stats* exchange_active_loop_stats(loop_stats* stats) noexcept {
+#if KOTA_ASYNC_LOOP_STATS
+    return std::exchange(current_loop_stats, stats);
+#else
+    (void)stats;
+    return nullptr;
+#endif
+}
+
+task_trace* exchange_active_trace(task_trace* trace) noexcept {
+#if KOTA_ASYNC_TRACE
+    return std::exchange(current_trace, trace);
+#else
+    (void)trace;
+    return nullptr;
+#endif
+}
+
+loop_stats* active_loop_stats() noexcept {
+#if KOTA_ASYNC_LOOP_STATS
+    return current_loop_stats;
+#else
+    return nullptr;
+#endif
+}
+
+void* detail::allocate_frame(std::size_t size) {
+    auto block = frame_pool::block_size(size);
+    if(auto* pool = active_frame_pool) {
+        if(auto* ptr = pool->allocate(block)) {
+            return ptr;
+        }
+    }
+    return mem::slab_allocate(block);
+}
+
+void detail::deallocate_frame(void* ptr, std::size_t size) noexcept {
+    auto block = frame_pool::block_size(size);
+    if(auto* pool = active_frame_pool; pool && pool->recycle(ptr, block)) {
+        return;
+    }
+    mem::slab_deallocate(ptr, block);
+}
+
 void async_node::intercept_cancel() noexcept {
     policy = static_cast<Policy>(policy | InterceptCancel);
 }
@@ -126,6 +195,11 @@ void async_node::cancel() {
             auto* self = static_cast<waiter_link*>(this);
             if(auto* res = self->resource) {
                 res->remove(self);
+                // A weighted acquisition leaving the front may have been
+                // holding back smaller ones behind it.
+                if(res->kind == sync_primitive::Kind::Semaphore) {
+                    static_cast<semaphore*>(res)->grant();
+                }
             }
             propagate_cancel(self);
             break;
@@ -133,6 +207,7 @@ void async_node::cancel() {
 
         case NodeKind::WhenAll:
         case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
         case NodeKind::Scope: {
             auto* self = static_cast<aggregate_op*>(this);
             const bool was_arming = self->phase == aggregate_op::Phase::Arming;
@@ -179,6 +254,11 @@ void async_node::resume() {
 /// Called by libuv callbacks when an I/O operation completes.
 /// Preserves Cancelled state if already set, then notifies the parent.
 void system_op::complete() noexcept {
+#if KOTA_ASYNC_LOOP_STATS
+    if(auto* stats = current_loop_stats) {
+        stats->io_callbacks += 1;
+    }
+#endif
     if(state != Cancelled) {
         state = Finished;
     }
@@ -187,6 +267,14 @@ void system_op::complete() noexcept {
     if(!parent) {
         return;
     }
+#if KOTA_ASYNC_TRACE
+    if(auto* trace = current_trace; trace && trace->tracing()) {
+        trace->resume_slice(*parent, [this, parent] {
+            detail::resume_and_drain(parent->handle_subtask_result(this));
+        });
+        return;
+    }
+#endif
     auto next = parent->handle_subtask_result(this);
     detail::resume_and_drain(next);
 }
@@ -219,6 +307,7 @@ std::coroutine_handle<> async_node::link_continuation(async_node* awaiter,
         }
         case NodeKind::WhenAll:
         case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
         case NodeKind::Scope: break;
         case NodeKind::SystemIO: {
             auto self = static_cast<system_op*>(this);
@@ -237,6 +326,11 @@ std::coroutine_handle<> async_node::final_transition() {
     switch(kind) {
         case NodeKind::Task: {
             auto p = static_cast<standard_task*>(this);
+#if KOTA_ASYNC_TRACE
+            if(auto* trace = current_trace; trace && trace->tracing()) {
+                trace->instant(task_trace::Phase::Finish, *p);
+            }
+#endif
             if(!p->awaiter) {
                 if(p->root) {
                     enqueue_destroy(p->handle());
@@ -251,6 +345,7 @@ std::coroutine_handle<> async_node::final_transition() {
         case NodeKind::EventWaiter:
         case NodeKind::WhenAll:
         case NodeKind::WhenAny:
+        case NodeKind::WhenEach:
         case NodeKind::Scope:
         case NodeKind::SystemIO: break;
     }
@@ -267,6 +362,9 @@ std::coroutine_handle<> async_node::final_transition() {
 ///   - Failed child (exception or structured error): cancels all siblings, resumes awaiter.
 ///   - WhenAny completion: records winner, cancels siblings, resumes awaiter.
 ///   - WhenAll/Scope completion: increments counter, resumes awaiter when all done.
+/// For WhenEach parents (as_completed): records the child in completion order
+///   and resumes the awaiter if one is waiting for the next result. Only an
+///   uncaught cancellation ends the stream early.
 std::coroutine_handle<> async_node::handle_subtask_result(async_node* child) {
     assert(child && child != this && "invalid parameter!");
 
@@ -399,6 +497,47 @@ std::coroutine_handle<> async_node::handle_subtask_result(async_node* child) {
             return std::noop_coroutine();
         }
 
+        case NodeKind::WhenEach: {
+            auto self = static_cast<aggregate_op*>(this);
+            if(self->is_settled()) {
+                return std::noop_coroutine();
+            }
+
+            if(child->state == Cancelled && !(child->policy & InterceptCancel)) {
+                self->defer_cancel();
+                if(self->is_deferring()) {
+                    return std::noop_coroutine();
+                }
+
+                self->phase = aggregate_op::Phase::Settled;
+                for(std::size_t i = self->completed; i < self->awaitees.size(); ++i) {
+                    if(auto* other = self->awaitees[i]; other && other != child) {
+                        other->cancel();
+                    }
+                }
+
+                // Without a waiting awaiter the latched cancellation is
+                // delivered by the next await.
+                return self->deliver_deferred();
+            }
+
+            // Keep awaitees[0, completed) in completion order.
+            auto first = self->awaitees.begin() + static_cast<std::ptrdiff_t>(self->completed);
+            auto it = std::find(first, self->awaitees.end(), child);
+            assert(it != self->awaitees.end() && "as_completed: unknown child");
+            std::iter_swap(first, it);
+            self->completed += 1;
+
+            if(!self->awaiter || self->is_deferring()) {
+                return std::noop_coroutine();
+            }
+
+            auto* parent = std::exchange(self->awaiter, nullptr);
+            assert(parent->is_standard_task() && "aggregate awaiter must be a task");
+            parent->clear_awaitee();
+            return static_cast<standard_task*>(parent)->handle();
+        }
+
         case NodeKind::MutexWaiter:
         case NodeKind::EventWaiter:
         case NodeKind::SystemIO:
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "kota/async/io/loop.h"
+#include "kota/support/memory.h"
+
+namespace kota {
+
+/// Per-loop cache of coroutine frame blocks, bucketed by size class.
+///
+/// Every pool-eligible frame is taken from mem::slab_allocate() at its
+/// rounded class size, whether or not a pool is active at the time. A block
+/// is therefore interchangeable with any other block of the same class and
+/// can be cached by whichever loop frees it, or handed back to the slab
+/// allocator when no loop is running; a block freed on another thread
+/// returns to the thread that carved it. That matters for frames created before run() and for
+/// unstarted tasks that loop_group moves between workers.
+class frame_pool {
+public:
+    constexpr static std::size_t granularity = 64;
+
+    constexpr static std::size_t class_count = 16;
+
+    /// Largest frame served from a size class; larger frames bypass the pool.
+    constexpr static std::size_t max_size = granularity * class_count;
+
+    /// Upper bound on cached blocks per class, so a burst of short-lived
+    /// tasks does not pin its peak footprint for the lifetime of the loop.
+    constexpr static std::size_t max_cached = 256;
+
+    frame_pool() = default;
+
+    frame_pool(const frame_pool&) = delete;
+    frame_pool& operator=(const frame_pool&) = delete;
+
+    ~frame_pool() {
+        release();
+    }
+
+    /// Rounds `size` up to its class size, or returns it unchanged when it is
+    /// too large for the pool.
+    constexpr static std::size_t block_size(std::size_t size) noexcept {
+        if(size > max_size) {
+            return size;
+        }
+        return (size + granularity - 1) / granularity * granularity;
+    }
+
+    /// Returns a cached block for `size`, or nullptr if the caller has to
+    /// fall back to the heap.
+    void* allocate(std::size_t size) noexcept {
+        if(size > max_size) {
+            counters.oversized += 1;
+            return nullptr;
+        }
+        if(!enabled) {
+            return nullptr;
+        }
+
+        auto index = class_index(size);
+        auto* block = heads[index];
+        if(!block) {
+            counters.misses += 1;
+            return nullptr;
+        }
+
+        heads[index] = block->next;
+        counts[index] -= 1;
+        counters.hits += 1;
+        counters.cached -= 1;
+        return block;
+    }
+
+    /// Caches `ptr` for reuse. Returns false if the caller should release it
+    /// to the heap instead.
+    bool recycle(void* ptr, std::size_t size) noexcept {
+        if(!enabled || size > max_size) {
+            return false;
+        }
+
+        auto index = class_index(size);
+        if(counts[index] >= max_cached) {
+            return false;
+        }
+
+        auto* block = ::new(ptr) free_block{heads[index]};
+        heads[index] = block;
+        counts[index] += 1;
+        counters.recycled += 1;
+        counters.cached += 1;
+        return true;
+    }
+
+    /// Returns every cached block to the slab allocator.
+    void release() noexcept {
+        for(std::size_t index = 0; index < class_count; ++index) {
+            auto* block = heads[index];
+            while(block) {
+                auto* next = block->next;
+                mem::slab_deallocate(block, (index + 1) * granularity);
+                block = next;
+            }
+            heads[index] = nullptr;
+            counts[index] = 0;
+        }
+        counters.cached = 0;
+    }
+
+    void set_enabled(bool value) noexcept {
+        enabled = value;
+        if(!enabled) {
+            release();
+        }
+    }
+
+    const frame_pool_stats& stats() const noexcept {
+        return counters;
+    }
+
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    constexpr static std::size_t class_index(std::size_t size) noexcept {
+        return size == 0 ? 0 : (size - 1) / granularity;
+    }
+
+    bool enabled = true;
+    std::array<free_block*, class_count> heads = {};
+    std::array<std::uint32_t, class_count> counts = {};
+    frame_pool_stats counters;
+};
+
+/// Installs `pool` as the calling thread's active pool and returns the
+/// previous one. event_loop::run() brackets itself with this.
+frame_pool* exchange_active_frame_pool(frame_pool* pool) noexcept;
+
+}  // namespace kota
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "kota/async/io/loop.h"
+
+namespace kota {
+
+/// Installs `stats` as the calling thread's active loop counters and returns
+/// the previous ones. event_loop::run() brackets itself with this when built
+/// with KOTA_ASYNC_LOOP_STATS.
+loop_stats* exchange_active_loop_stats(loop_stats* stats) noexcept;
+
+/// Counters of the loop running on this thread, or null outside run().
+loop_stats* active_loop_stats() noexcept;
+
+}  // namespace kota
@@ -0,0 +1,226 @@
+#include "kota/async/runtime/task_graph.h"
+
+#include <algorithm>
+
+namespace kota {
+
+namespace {
+
+/// Lays `pairs` (from, to) out as CSR adjacency over `nodes` nodes.
+void build_csr(std::size_t nodes,
+               std::span<const std::pair<task_graph::node_id, task_graph::node_id>> pairs,
+               std::vector<std::uint32_t>& offsets,
+               std::vector<task_graph::node_id>& targets) {
+    offsets.assign(nodes + 1, 0);
+    for(auto& [from, to]: pairs) {
+        offsets[from + 1] += 1;
+    }
+    for(std::size_t i = 0; i < nodes; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    targets.resize(pairs.size());
+    std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for(auto& [from, to]: pairs) {
+        targets[cursor[from]++] = to;
+    }
+}
+
+}  // namespace
+
+task_graph::node_id task_graph::add_node(std::string_view name, std::uint64_t cost) {
+    if(auto it = index.find(name); it != index.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<node_id>(names.size());
+    names.emplace_back(name);
+    costs.push_back(cost);
+    index.try_emplace(std::string(name), id);
+    is_frozen = false;
+    return id;
+}
+
+void task_graph::add_edge(node_id dependent, node_id dependency) {
+    assert(dependent < size() && dependency < size() && "task_graph::add_edge on unknown node");
+    edges.emplace_back(dependent, dependency);
+    is_frozen = false;
+}
+
+void task_graph::set_cost(node_id node, std::uint64_t cost) noexcept {
+    costs[node] = cost;
+    if(is_frozen) {
+        // Critical paths depend on every cost after this node; recompute.
+        for(auto it = order.rbegin(); it != order.rend(); ++it) {
+            std::uint64_t longest = 0;
+            for(auto dependent: dependents(*it)) {
+                longest = (std::max)(longest, paths[dependent]);
+            }
+            paths[*it] = costs[*it] + longest;
+        }
+    }
+}
+
+std::optional<task_graph::node_id> task_graph::find(std::string_view name) const {
+    if(auto it = index.find(name); it != index.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+std::span<const task_graph::node_id> task_graph::dependencies(node_id node) const noexcept {
+    assert(is_frozen && "task_graph::dependencies on unfrozen graph");
+    return std::span<const node_id>(dependency_targets)
+        .subspan(dependency_offsets[node], dependency_offsets[node + 1] - dependency_offsets[node]);
+}
+
+std::span<const task_graph::node_id> task_graph::dependents(node_id node) const noexcept {
+    assert(is_frozen && "task_graph::dependents on unfrozen graph");
+    return std::span<const node_id>(dependent_targets)
+        .subspan(dependent_offsets[node], dependent_offsets[node + 1] - dependent_offsets[node]);
+}
+
+error task_graph::freeze() {
+    if(is_frozen) {
+        return {};
+    }
+
+    std::ranges::sort(edges);
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    const auto n = size();
+    build_csr(n, edges, dependency_offsets, dependency_targets);
+
+    std::vector<std::pair<node_id, node_id>> reversed;
+    reversed.reserve(edges.size());
+    for(auto& [dependent, dependency]: edges) {
+        reversed.emplace_back(dependency, dependent);
+    }
+    build_csr(n, reversed, dependent_offsets, dependent_targets);
+
+    // Kahn's algorithm; a node's level is settled once its last dependency
+    // is ordered.
+    std::vector<std::uint32_t> blockers(n);
+    order.clear();
+    order.reserve(n);
+    levels.assign(n, 0);
+    for(node_id id = 0; id < n; ++id) {
+        blockers[id] = dependency_offsets[id + 1] - dependency_offsets[id];
+        if(blockers[id] == 0) {
+            order.push_back(id);
+        }
+    }
+    for(std::size_t i = 0; i < order.size(); ++i) {
+        auto id = order[i];
+        for(auto dependent: std::span<const node_id>(dependent_targets)
+                                .subspan(dependent_offsets[id],
+                                         dependent_offsets[id + 1] - dependent_offsets[id])) {
+            levels[dependent] = (std::max)(levels[dependent], levels[id] + 1);
+            if(--blockers[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+    if(order.size() != n) {
+        return error::invalid_argument;
+    }
+
+    is_frozen = true;
+    paths.assign(n, 0);
+    for(auto it = order.rbegin(); it != order.rend(); ++it) {
+        std::uint64_t longest = 0;
+        for(auto dependent: dependents(*it)) {
+            longest = (std::max)(longest, paths[dependent]);
+        }
+        paths[*it] = costs[*it] + longest;
+    }
+    return {};
+}
+
+void task_graph::prepare(run_state& state, std::span<const node_id> targets) const {
+    const auto n = size();
+    state.marks.assign(n, run_mark::idle);
+    state.blockers.assign(n, 0);
+    state.ready.clear();
+    state.remaining = 0;
+    state.failed = false;
+
+    std::vector<node_id> stack(targets.begin(), targets.end());
+    while(!stack.empty()) {
+        auto id = stack.back();
+        stack.pop_back();
+        if(state.marks[id] != run_mark::idle) {
+            continue;
+        }
+        state.marks[id] = run_mark::waiting;
+        state.remaining += 1;
+
+        auto deps = dependencies(id);
+        state.blockers[id] = static_cast<std::uint32_t>(deps.size());
+        stack.insert(stack.end(), deps.begin(), deps.end());
+    }
+
+    auto by_path = [this](node_id lhs, node_id rhs) {
+        return paths[lhs] < paths[rhs];
+    };
+    for(node_id id = 0; id < n; ++id) {
+        if(state.marks[id] == run_mark::waiting && state.blockers[id] == 0) {
+            state.marks[id] = run_mark::ready;
+            state.ready.push_back(id);
+        }
+    }
+    std::ranges::make_heap(state.ready, by_path);
+}
+
+std::optional<task_graph::node_id> task_graph::pop_ready(run_state& state) const {
+    if(state.ready.empty()) {
+        return std::nullopt;
+    }
+
+    std::ranges::pop_heap(state.ready, [this](node_id lhs, node_id rhs) {
+        return paths[lhs] < paths[rhs];
+    });
+    auto id = state.ready.back();
+    state.ready.pop_back();
+    state.marks[id] = run_mark::running;
+    return id;
+}
+
+void task_graph::finish(run_state& state, node_id node, bool ok) const {
+    auto by_path = [this](node_id lhs, node_id rhs) {
+        return paths[lhs] < paths[rhs];
+    };
+
+    state.marks[node] = run_mark::done;
+    state.remaining -= 1;
+
+    if(ok) {
+        for(auto dependent: dependents(node)) {
+            if(state.marks[dependent] == run_mark::waiting && --state.blockers[dependent] == 0) {
+                state.marks[dependent] = run_mark::ready;
+                state.ready.push_back(dependent);
+                std::ranges::push_heap(state.ready, by_path);
+            }
+        }
+    } else {
+        // Nothing downstream can run; drop it from the run, iteratively so
+        // deep graphs do not exhaust the stack.
+        state.failed = true;
+        std::vector<node_id> stack(dependents(node).begin(), dependents(node).end());
+        while(!stack.empty()) {
+            auto id = stack.back();
+            stack.pop_back();
+            if(state.marks[id] != run_mark::waiting) {
+                continue;
+            }
+            state.marks[id] = run_mark::skipped;
+            state.remaining -= 1;
+            auto next = dependents(id);
+            stack.insert(stack.end(), next.begin(), next.end());
+        }
+    }
+
+    state.progress.set();
+}
+
+}  // namespace kota
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../libuv.h"
+#include "kota/async/io/loop.h"
+#include "kota/async/runtime/frame.h"
+#include "kota/support/name_table.h"
+
+namespace kota {
+
+/// Ring of task events recorded by one event loop, exported as Chrome trace
+/// JSON by to_chrome_json() (defined in debug.cpp).
+///
+/// Only the loop thread writes, so recording is a plain store into a
+/// preallocated slot; once the ring is full the oldest events are
+/// overwritten. Export from the loop thread or after run() returns.
+class task_trace {
+public:
+    enum class Phase : std::uint8_t {
+        /// Node queued with event_loop::schedule().
+        Create,
+
+        /// Node resumed from the ready queue or by an I/O completion. Has a
+        /// duration covering everything that ran before it suspended again.
+        Resume,
+
+        /// Task reached its final suspend point.
+        Finish,
+
+        /// Named point recorded with event_loop::trace_mark(); has no node.
+        Mark,
+    };
+
+    struct record {
+        Phase phase = Phase::Create;
+        async_node::NodeKind kind = async_node::NodeKind::Task;
+        async_node::State state = async_node::Pending;
+
+        /// Set for Mark events. Sits in what would otherwise be padding.
+        name_id name;
+        const void* node = nullptr;
+        std::source_location location;
+
+        /// uv_hrtime() nanoseconds.
+        std::uint64_t start = 0;
+        std::uint64_t duration = 0;
+    };
+
+    bool tracing() const noexcept {
+        return active;
+    }
+
+    /// Discards previous events and starts recording into `capacity` slots.
+    void start(std::size_t capacity) {
+        records.assign(capacity == 0 ? 1 : capacity, record{});
+        next = 0;
+        total = 0;
+        epoch = uv::hrtime();
+        active = true;
+    }
+
+    /// Stops recording, keeping recorded events for export.
+    void stop() noexcept {
+        active = false;
+    }
+
+    /// Records a zero-length event for `node`.
+    void instant(Phase phase, const async_node& node) noexcept {
+        push(record{phase, node.kind, node.state, {}, &node, node.location, uv::hrtime(), 0});
+    }
+
+    /// Records a zero-length Mark event named `name`, made at `location`.
+    void mark(name_id name, std::source_location location) noexcept {
+        record entry{};
+        entry.phase = Phase::Mark;
+        entry.name = name;
+        entry.location = location;
+        entry.start = uv::hrtime();
+        push(entry);
+    }
+
+    /// Runs `resume` and records it as one Resume slice for `node`. Node
+    /// details are captured first since resuming may destroy it.
+    template <typename Fn>
+    void resume_slice(const async_node& node, Fn&& resume) {
+        record entry{
+            Phase::Resume, node.kind, node.state, {}, &node, node.location, uv::hrtime(), 0};
+        std::forward<Fn>(resume)();
+        entry.duration = uv::hrtime() - entry.start;
+        push(entry);
+    }
+
+    /// Events that were overwritten because the ring was full.
+    std::size_t dropped() const noexcept {
+        return total > records.size() ? total - records.size() : 0;
+    }
+
+    /// `thread_id` becomes the `tid` of every event, to tell loops apart when
+    /// traces are merged.
+    std::string to_chrome_json(std::uint32_t thread_id) const;
+
+private:
+    void push(const record& entry) noexcept {
+        records[next] = entry;
+        next = next + 1 == records.size() ? 0 : next + 1;
+        total += 1;
+    }
+
+    std::vector<record> records;
+    std::size_t next = 0;
+    std::size_t total = 0;
+    std::uint64_t epoch = 0;
+    bool active = false;
+};
+
+/// Installs `trace` as the calling thread's active trace and returns the
+/// previous one. event_loop::run() brackets itself with this when built with
+/// KOTA_ASYNC_TRACE.
+task_trace* exchange_active_trace(task_trace* trace) noexcept;
+
+}  // namespace kota
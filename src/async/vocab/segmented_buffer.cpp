@@ -0,0 +1,229 @@
+#include "segmented_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace kota {
+
+namespace {
+
+/// Fully read slabs kept for reuse per buffer.
+constexpr std::size_t max_free_slabs = 4;
+
+/// Free slabs kept per thread for pooled buffers (4 MiB of default slabs).
+constexpr std::size_t max_pooled_slabs = 64;
+
+/// Slab size of the segmented_buffer default; only these are pooled.
+constexpr std::size_t pooled_slab_size = 64 * 1024;
+
+}  // namespace
+
+slab_pool::~slab_pool() {
+    for(auto* slab: free_slabs) {
+        byte_slab::release(slab);
+    }
+}
+
+slab_pool& slab_pool::local() {
+    thread_local slab_pool pool;
+    return pool;
+}
+
+byte_slab* slab_pool::take(std::size_t capacity) {
+    if(capacity == pooled_slab_size && !free_slabs.empty()) {
+        auto* slab = free_slabs.back();
+        free_slabs.pop_back();
+        return slab;
+    }
+    return byte_slab::create(capacity);
+}
+
+void slab_pool::give(byte_slab* slab) {
+    if(slab->refs == 1 && slab->capacity == pooled_slab_size &&
+       free_slabs.size() < max_pooled_slabs) {
+        free_slabs.push_back(slab);
+        return;
+    }
+    byte_slab::release(slab);
+}
+
+segmented_buffer::~segmented_buffer() {
+    for(auto* slab: slabs) {
+        recycle(slab);
+    }
+    for(auto* slab: free_slabs) {
+        byte_slab::release(slab);
+    }
+}
+
+std::size_t segmented_buffer::read(char* dest, std::size_t len) {
+    const std::size_t to_read = std::min(len, size);
+    std::size_t copied = 0;
+    while(copied < to_read) {
+        auto [ptr, contiguous] = get_read_ptr();
+        const auto take = std::min(contiguous, to_read - copied);
+        std::memcpy(dest + copied, ptr, take);
+        advance_read(take);
+        copied += take;
+    }
+    return copied;
+}
+
+std::pair<const char*, std::size_t> segmented_buffer::get_read_ptr() const {
+    if(size == 0) {
+        return {nullptr, 0};
+    }
+
+    const auto contiguous = front_end() - read_offset;
+    assert(contiguous > 0 && "get_read_ptr: non-empty buffer must yield contiguous > 0");
+    return {slabs.front()->data() + read_offset, contiguous};
+}
+
+void segmented_buffer::advance_read(std::size_t len) {
+    len = std::min(len, size);
+    while(len > 0) {
+        const auto take = std::min(len, front_end() - read_offset);
+        read_offset += take;
+        size -= take;
+        len -= take;
+
+        if(read_offset != front_end()) {
+            continue;
+        }
+
+        auto* front = slabs.front();
+        if(slabs.size() == 1 && front->refs == 1 && !pooled) {
+            // Sole owner of the only slab: rewind instead of dropping it.
+            read_offset = 0;
+            write_offset = 0;
+            continue;
+        }
+
+        // Bytes before read_offset may belong to a detached chain, so a
+        // shared slab is never rewound and written over.
+        slabs.pop_front();
+        recycle(front);
+        read_offset = 0;
+        if(slabs.empty()) {
+            write_offset = 0;
+        }
+    }
+}
+
+std::pair<char*, std::size_t> segmented_buffer::get_write_ptr() {
+    if(size >= limit) {
+        return {nullptr, 0};
+    }
+
+    if(slabs.empty() || write_offset == slabs.back()->capacity) {
+        if(slabs.empty()) {
+            read_offset = 0;
+        }
+        slabs.push_back(take_slab());
+        write_offset = 0;
+    }
+
+    auto* back = slabs.back();
+    const auto contiguous = std::min<std::size_t>(back->capacity - write_offset, limit - size);
+    return {back->data() + write_offset, contiguous};
+}
+
+void segmented_buffer::advance_write(std::size_t len) {
+    if(slabs.empty()) {
+        return;
+    }
+
+    len = std::min<std::size_t>(len, slabs.back()->capacity - write_offset);
+    write_offset += len;
+    size += len;
+}
+
+void segmented_buffer::read_chunks(small_vector<std::span<const char>>& out) const {
+    if(size == 0) {
+        return;
+    }
+
+    const auto last = slabs.size() - 1;
+    for(std::size_t i = 0; i <= last; ++i) {
+        const auto begin = i == 0 ? read_offset : 0;
+        const auto end = i == last ? write_offset : slabs[i]->capacity;
+        if(end > begin) {
+            out.emplace_back(slabs[i]->data() + begin, end - begin);
+        }
+    }
+}
+
+byte_chain segmented_buffer::detach(std::size_t len) {
+    byte_chain chain;
+    len = std::min(len, size);
+    while(len > 0) {
+        const auto take = std::min(len, front_end() - read_offset);
+        chain.append(slabs.front(), read_offset, take);
+        advance_read(take);
+        len -= take;
+    }
+    return chain;
+}
+
+void segmented_buffer::set_pooled(bool enabled) {
+    pooled = enabled;
+    if(!pooled) {
+        return;
+    }
+
+    for(auto* slab: free_slabs) {
+        slab_pool::local().give(slab);
+    }
+    free_slabs.clear();
+    release_unused();
+}
+
+void segmented_buffer::release_unused() {
+    if(!pooled || slabs.empty()) {
+        return;
+    }
+
+    if(size == 0) {
+        for(auto* slab: slabs) {
+            recycle(slab);
+        }
+        slabs.clear();
+        read_offset = 0;
+        write_offset = 0;
+        return;
+    }
+
+    // Every slab but the last is full, so only the last can be unused.
+    if(slabs.size() > 1 && write_offset == 0) {
+        recycle(slabs.back());
+        slabs.pop_back();
+        write_offset = slabs.back()->capacity;
+    }
+}
+
+byte_slab* segmented_buffer::take_slab() {
+    if(pooled) {
+        return slab_pool::local().take(slab_size);
+    }
+    if(!free_slabs.empty()) {
+        auto* slab = free_slabs.back();
+        free_slabs.pop_back();
+        return slab;
+    }
+    return byte_slab::create(slab_size);
+}
+
+void segmented_buffer::recycle(byte_slab* slab) {
+    if(pooled) {
+        slab_pool::local().give(slab);
+        return;
+    }
+    if(slab->refs == 1 && slab->capacity == slab_size && free_slabs.size() < max_free_slabs) {
+        free_slabs.push_back(slab);
+        return;
+    }
+    byte_slab::release(slab);
+}
+
+}  // namespace kota
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "kota/async/vocab/byte_chain.h"
+
+namespace kota {
+
+/// Free slabs shared by every pooled segmented_buffer on one thread, so that
+/// buffers of idle streams hold no memory. Each thread (and so each loop)
+/// has its own pool; slabs never move between threads through it.
+class slab_pool {
+public:
+    slab_pool() = default;
+
+    slab_pool(const slab_pool&) = delete;
+    slab_pool& operator=(const slab_pool&) = delete;
+
+    ~slab_pool();
+
+    /// Pool of the calling thread.
+    static slab_pool& local();
+
+    /// Returns a free slab of `capacity` bytes, allocating one if needed.
+    byte_slab* take(std::size_t capacity);
+
+    /// Keeps `slab` for reuse, or releases it if the pool is full or it is
+    /// still referenced elsewhere.
+    void give(byte_slab* slab);
+
+    std::size_t size() const noexcept {
+        return free_slabs.size();
+    }
+
+private:
+    std::vector<byte_slab*> free_slabs;
+};
+
+/// Growable read buffer made of a chain of fixed-size slabs.
+///
+/// Unlike ring_buffer it grows on demand up to `limit` bytes, allocates
+/// nothing until the first write, and can hand buffered bytes to a consumer
+/// without copying through detach(). Fully read slabs are kept on a small
+/// free list and reused before new ones are allocated, or, once set_pooled()
+/// is on, go back to the thread's slab_pool as soon as they are read.
+class segmented_buffer {
+public:
+    explicit segmented_buffer(std::size_t slab_size = 64 * 1024,
+                              std::size_t limit = 1024 * 1024) :
+        slab_size(slab_size), limit(limit) {}
+
+    segmented_buffer(const segmented_buffer&) = delete;
+    segmented_buffer& operator=(const segmented_buffer&) = delete;
+
+    ~segmented_buffer();
+
+    std::size_t readable_bytes() const {
+        return size;
+    }
+
+    /// Bytes that can still be buffered before reaching the limit.
+    std::size_t writable_bytes() const {
+        return size < limit ? limit - size : 0;
+    }
+
+    std::size_t read(char* dest, std::size_t len);
+
+    /// Contiguous readable bytes at the front.
+    std::pair<const char*, std::size_t> get_read_ptr() const;
+    void advance_read(std::size_t len);
+
+    /// Contiguous writable space at the back, adding a slab if needed.
+    std::pair<char*, std::size_t> get_write_ptr();
+    void advance_write(std::size_t len);
+
+    /// Appends a view of every readable byte, in order, to `out`.
+    void read_chunks(small_vector<std::span<const char>>& out) const;
+
+    /// Removes the first `len` readable bytes (at most readable_bytes()) and
+    /// returns them as a chain sharing the underlying slabs.
+    byte_chain detach(std::size_t len);
+
+    /// Takes slabs from slab_pool::local() only while bytes are buffered and
+    /// returns each one as soon as it is fully read, instead of keeping them.
+    void set_pooled(bool enabled);
+
+    /// In pooled mode, returns slabs that get_write_ptr() added but no
+    /// write filled, e.g. after a read that found nothing.
+    void release_unused();
+
+private:
+    std::size_t front_end() const noexcept {
+        return slabs.size() == 1 ? write_offset : slabs.front()->capacity;
+    }
+
+    byte_slab* take_slab();
+
+    void recycle(byte_slab* slab);
+
+    std::size_t slab_size;
+    std::size_t limit;
+
+    std::deque<byte_slab*> slabs;
+    std::vector<byte_slab*> free_slabs;
+
+    /// Read position in the front slab and write position in the back slab.
+    std::size_t read_offset = 0;
+    std::size_t write_offset = 0;
+
+    std::size_t size = 0;
+
+    bool pooled = false;
+};
+
+}  // namespace kota
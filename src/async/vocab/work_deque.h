@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace kota {
+
+/// Chase-Lev work-stealing deque of raw pointers.
+///
+/// The owning thread pushes and pops at the bottom; any other thread may
+/// steal from the top. This follows the C11 formulation by Lê, Pop, Cohen and
+/// Zappa Nardelli ("Correct and Efficient Work-Stealing for Weak Memory
+/// Models", PPoPP 2013).
+///
+/// Growth replaces the ring with a larger copy. Thieves may still be reading
+/// the previous ring, so retired rings are kept alive until the deque itself
+/// is destroyed instead of being reclaimed eagerly.
+template <typename T>
+class work_stealing_deque {
+public:
+    explicit work_stealing_deque(std::size_t capacity = 64) {
+        std::size_t rounded = 1;
+        while(rounded < capacity) {
+            rounded <<= 1;
+        }
+        rings.push_back(std::make_unique<ring>(rounded));
+        active.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    /// Owner only.
+    void push(T* item) {
+        auto b = bottom.load(std::memory_order_relaxed);
+        auto t = top.load(std::memory_order_acquire);
+        auto* a = active.load(std::memory_order_relaxed);
+        if(b - t > static_cast<std::int64_t>(a->capacity) - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /// Owner only. Returns nullptr when the deque is empty or the last item
+    /// was lost to a concurrent thief.
+    T* pop() {
+        auto b = bottom.load(std::memory_order_relaxed) - 1;
+        auto* a = active.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+
+        if(t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = a->get(b);
+        if(t == b) {
+            // Racing thieves for the last element.
+            if(!top.compare_exchange_strong(t,
+                                            t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// Any thread. Returns nullptr when empty or when another thief won.
+    T* steal() {
+        auto t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = bottom.load(std::memory_order_acquire);
+        if(t >= b) {
+            return nullptr;
+        }
+
+        auto* a = active.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if(!top.compare_exchange_strong(t,
+                                        t + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /// Approximate when called concurrently with push/pop/steal.
+    bool empty() const noexcept {
+        auto b = bottom.load(std::memory_order_relaxed);
+        auto t = top.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+
+private:
+    struct ring {
+        explicit ring(std::size_t capacity) :
+            capacity(capacity), mask(capacity - 1), slots(new std::atomic<T*>[capacity]) {}
+
+        T* get(std::int64_t index) const noexcept {
+            return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, T* item) noexcept {
+            slots[static_cast<std::size_t>(index) & mask].store(item, std::memory_order_relaxed);
+        }
+
+        std::size_t capacity;
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+    };
+
+    ring* grow(ring* current, std::int64_t t, std::int64_t b) {
+        auto next = std::make_unique<ring>(current->capacity * 2);
+        for(auto i = t; i < b; ++i) {
+            next->put(i, current->get(i));
+        }
+        auto* raw = next.get();
+        rings.push_back(std::move(next));
+        active.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::atomic<ring*> active{nullptr};
+
+    /// Owner-only list of every ring ever allocated; the last one is active.
+    std::vector<std::unique_ptr<ring>> rings;
+};
+
+}  // namespace kota
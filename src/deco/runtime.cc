@@ -15,6 +15,17 @@ std::vector<std::string> argvify(int argc, const char* const* argv, unsigned ski
     return res;
 }
 
+std::vector<std::string_view> borrow_argv(int argc, const char* const* argv, unsigned skip_num) {
+    std::vector<std::string_view> res;
+    if(argc <= 0) {
+        return res;
+    }
+    for(unsigned i = skip_num; i < static_cast<unsigned>(argc); ++i) {
+        res.emplace_back(argv[i]);
+    }
+    return res;
+}
+
 }  // namespace kota::deco::util
 
 namespace kota::deco::cli {
@@ -110,16 +121,15 @@ void SubCommander::usage(std::ostream& os) const {
                                                                  : renderer_ptr());
 }
 
-auto SubCommander::match(std::span<std::string> argv) const
+auto SubCommander::match(backend::ArgvView argv) const
     -> std::expected<SubCommander::match_t, SubCommandError> {
     auto positioned_error = [&](SubCommandError::Type type,
                                 unsigned begin,
                                 unsigned end,
                                 std::string message) -> std::expected<match_t, SubCommandError> {
-        const auto argv_view = std::span<const std::string>(argv.data(), argv.size());
         return std::unexpected(SubCommandError{
             type,
-            text::render_diagnostic(text::diagnostic_at(argv_view, begin, end, std::move(message)),
+            text::render_diagnostic(text::diagnostic_at(argv, begin, end, std::move(message)),
                                     renderer_ptr()),
         });
     };
@@ -160,7 +170,7 @@ auto SubCommander::match(std::span<std::string> argv) const
                             std::format("unknown subcommand '{}'", argv.front()));
 }
 
-void SubCommander::parse(std::span<std::string> argv) {
+void SubCommander::parse(backend::ArgvView argv) {
     auto matched = match(argv);
     if(!matched.has_value()) {
         errorHandler(std::move(matched.error()));
@@ -188,7 +198,7 @@ void SubCommander::parse(std::span<std::string> argv) {
         SubCommandError{SubCommandError::Type::Internal, "default route resolved without handler"});
 }
 
-void SubCommander::operator()(std::span<std::string> argv) {
+void SubCommander::operator()(backend::ArgvView argv) {
     parse(argv);
 }
 
@@ -47,7 +47,7 @@ struct DiagnosticLayout {
 };
 
 auto paint(std::string_view ansi, std::string_view text) -> std::string;
-auto join_argv(std::span<const std::string> argv) -> JoinedArgv;
+auto join_argv(::kota::option::ArgvView argv) -> JoinedArgv;
 auto build_diagnostic_layout(const Diagnostic& diagnostic, std::size_t max_width)
     -> DiagnosticLayout;
 auto excerpt_diagnostic_line(std::string_view line,
@@ -375,7 +375,7 @@ auto paint(std::string_view ansi, std::string_view text) -> std::string {
     return std::format("{}{}{}", ansi, text, ansi_reset);
 }
 
-auto join_argv(std::span<const std::string> argv) -> JoinedArgv {
+auto join_argv(::kota::option::ArgvView argv) -> JoinedArgv {
     JoinedArgv joined;
     joined.line.reserve(argv.size() * 8);
     joined.starts.reserve(argv.size());
@@ -582,7 +582,7 @@ auto looks_like_rendered_diagnostic([[maybe_unused]] std::string_view text) -> b
     return false;
 }
 
-auto diagnostic_at(std::span<const std::string> argv,
+auto diagnostic_at(::kota::option::ArgvView argv,
                    unsigned begin,
                    unsigned end,
                    std::string message) -> Diagnostic {
@@ -0,0 +1,189 @@
+#include "kota/ipc/binary_transport.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "framing.h"
+
+namespace kota::ipc {
+
+namespace {
+
+constexpr std::size_t length_size = 4;
+
+using length_prefix = std::array<char, length_size>;
+
+length_prefix encode_length(std::size_t size) {
+    const auto value = static_cast<std::uint32_t>(size);
+    return {
+        static_cast<char>(value & 0xff),
+        static_cast<char>((value >> 8) & 0xff),
+        static_cast<char>((value >> 16) & 0xff),
+        static_cast<char>((value >> 24) & 0xff),
+    };
+}
+
+std::size_t decode_length(std::string_view prefix) {
+    std::uint32_t value = 0;
+    for(std::size_t i = 0; i < length_size; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(prefix[i])) << (8 * i);
+    }
+    return value;
+}
+
+/// Fills `dst` from `input`; false, with reading stopped, on end of stream.
+task<bool> read_exact(stream& input, std::span<char> dst) {
+    std::size_t filled = 0;
+    while(filled < dst.size()) {
+        auto n = co_await input.read_some(dst.subspan(filled));
+        if(!n || *n == 0) {
+            input.stop();
+            co_return false;
+        }
+        filled += *n;
+    }
+    co_return true;
+}
+
+}  // namespace
+
+BinaryFramedTransport::BinaryFramedTransport(stream input, stream output) :
+    read_stream(std::move(input)), write_stream(std::move(output)) {}
+
+BinaryFramedTransport::BinaryFramedTransport(stream stream) :
+    read_stream(std::move(stream)), shared_stream(true) {}
+
+Result<std::unique_ptr<BinaryFramedTransport>>
+    BinaryFramedTransport::open_stdio(event_loop& loop) {
+    auto input = detail::open_stdio_stream(0, true, loop);
+    if(!input) {
+        return outcome_error(input.error());
+    }
+
+    auto output = detail::open_stdio_stream(1, false, loop);
+    if(!output) {
+        return outcome_error(output.error());
+    }
+
+    return std::make_unique<BinaryFramedTransport>(std::move(*input), std::move(*output));
+}
+
+task<std::optional<std::string>> BinaryFramedTransport::read_message() {
+    length_prefix prefix;
+    if(!co_await read_exact(read_stream, prefix)) {
+        co_return std::nullopt;
+    }
+
+    const auto length = decode_length(std::string_view(prefix.data(), prefix.size()));
+    if(length > max_payload) [[unlikely]] {
+        read_stream.stop();
+        co_return std::nullopt;
+    }
+
+    std::string payload;
+    payload.resize(length);
+    if(!co_await read_exact(read_stream, payload)) {
+        co_return std::nullopt;
+    }
+    co_return payload;
+}
+
+task<std::optional<BorrowedMessage>> BinaryFramedTransport::read_borrowed() {
+    auto chunk = co_await read_stream.read_chunk();
+    if(!chunk) [[unlikely]] {
+        read_stream.stop();
+        co_return std::nullopt;
+    }
+
+    const auto buffered = std::string_view(chunk->data(), chunk->size());
+    if(buffered.size() >= length_size) {
+        const auto length = decode_length(buffered);
+        if(length <= max_payload && length <= buffered.size() - length_size) {
+            co_return BorrowedMessage(buffered.substr(length_size, length),
+                                      read_stream,
+                                      length_size + length);
+        }
+    }
+
+    // Nothing is consumed yet, so the copying reader starts from the prefix.
+    auto payload = co_await read_message();
+    if(!payload) {
+        co_return std::nullopt;
+    }
+    co_return BorrowedMessage(std::move(*payload));
+}
+
+task<void, Error> BinaryFramedTransport::write_message(std::string_view payload) {
+    if(payload.size() > max_payload) {
+        co_await fail("message too large for binary framing");
+    }
+
+    const auto prefix = encode_length(payload.size());
+    const std::span<const char> pieces[] = {
+        std::span<const char>(prefix),
+        std::span<const char>(payload.data(), payload.size()),
+    };
+
+    auto status = co_await output().write(std::span<const std::span<const char>>(pieces));
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
+}
+
+task<void, Error>
+    BinaryFramedTransport::write_messages(std::span<const std::string_view> payloads) {
+    std::vector<length_prefix> prefixes;
+    prefixes.reserve(payloads.size());
+    for(auto payload: payloads) {
+        if(payload.size() > max_payload) {
+            co_await fail("message too large for binary framing");
+        }
+        prefixes.push_back(encode_length(payload.size()));
+    }
+
+    std::vector<std::span<const char>> pieces;
+    pieces.reserve(payloads.size() * 2);
+    for(std::size_t i = 0; i < payloads.size(); ++i) {
+        pieces.emplace_back(prefixes[i]);
+        pieces.emplace_back(payloads[i].data(), payloads[i].size());
+    }
+
+    auto status = co_await output().write(std::span<const std::span<const char>>(pieces));
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
+}
+
+void BinaryFramedTransport::cork() {
+    output().cork();
+}
+
+task<void, Error> BinaryFramedTransport::uncork() {
+    auto& stream = output();
+    stream.uncork();
+    auto status = co_await stream.flush();
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
+}
+
+Result<void> BinaryFramedTransport::close_output() {
+    output() = stream{};
+    return {};
+}
+
+Result<void> BinaryFramedTransport::close() {
+    read_stream.stop();
+    read_stream = stream{};
+    if(!shared_stream) {
+        write_stream = stream{};
+    }
+    return {};
+}
+
+}  // namespace kota::ipc
@@ -4,23 +4,34 @@
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace kota::ipc {
 
 namespace {
 
-struct bincode_request {
+// Params are written from a RawValue and read back as a RawValueView, so
+// parse_message() slices them out of the payload without copying.
+template <typename Raw>
+struct basic_bincode_request {
     protocol::RequestID id;
     std::string method;
-    codec::RawValue params;
+    Raw params;
 };
 
-struct bincode_notification {
+template <typename Raw>
+struct basic_bincode_notification {
     std::string method;
-    codec::RawValue params;
+    Raw params;
 };
 
+using bincode_request = basic_bincode_request<codec::RawValue>;
+using bincode_notification = basic_bincode_notification<codec::RawValue>;
+using incoming_bincode_request = basic_bincode_request<codec::RawValueView>;
+using incoming_bincode_notification = basic_bincode_notification<codec::RawValueView>;
+
 struct bincode_success {
     protocol::RequestID id;
     codec::RawValue result;
@@ -36,12 +47,31 @@ struct bincode_error {
 using bincode_envelope =
     std::variant<bincode_request, bincode_notification, bincode_success, bincode_error>;
 
-Result<std::string> encode_envelope(const bincode_envelope& envelope) {
-    auto bytes = codec::bincode::to_bytes(envelope);
-    if(!bytes) {
-        return outcome_error(Error(protocol::ErrorCode::InternalError, bytes.error().to_string()));
+// Same alternatives, in the same order, as bincode_envelope.
+using incoming_bincode_envelope = std::variant<incoming_bincode_request,
+                                               incoming_bincode_notification,
+                                               bincode_success,
+                                               bincode_error>;
+
+Result<void> encode_envelope(std::string& out, const bincode_envelope& envelope) {
+    // Kept per thread so its capacity carries over between messages.
+    thread_local std::vector<std::byte> bytes;
+    bytes.clear();
+    if(auto status = codec::bincode::to_bytes_into(bytes, envelope); !status) {
+        return outcome_error(Error(protocol::ErrorCode::InternalError, status.error().to_string()));
+    }
+    out.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return {};
+}
+
+template <typename Encode>
+Result<std::string> encode_to_string(Encode&& encode) {
+    std::string out;
+    auto status = encode(out);
+    if(status.has_error()) {
+        return outcome_error(std::move(status.error()));
     }
-    return std::string(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+    return out;
 }
 
 }  // namespace
@@ -50,7 +80,7 @@ IncomingMessage BincodeCodec::parse_message(std::string_view payload) {
     auto bytes_span = std::span<const std::byte>(reinterpret_cast<const std::byte*>(payload.data()),
                                                  payload.size());
 
-    bincode_envelope envelope;
+    incoming_bincode_envelope envelope;
     auto status = codec::bincode::from_bytes(bytes_span, envelope);
     if(!status) {
         return IncomingParseError{
@@ -58,12 +88,12 @@ IncomingMessage BincodeCodec::parse_message(std::string_view payload) {
     }
 
     return std::visit(
-        [](auto&& v) -> IncomingMessage {
+        [&](auto&& v) -> IncomingMessage {
             using T = std::remove_cvref_t<decltype(v)>;
-            if constexpr(std::is_same_v<T, bincode_request>) {
-                return IncomingRequest{v.id, std::move(v.method), std::move(v.params.data)};
-            } else if constexpr(std::is_same_v<T, bincode_notification>) {
-                return IncomingNotification{std::move(v.method), std::move(v.params.data)};
+            if constexpr(std::is_same_v<T, incoming_bincode_request>) {
+                return IncomingRequest{v.id, std::move(v.method), v.params.in(payload)};
+            } else if constexpr(std::is_same_v<T, incoming_bincode_notification>) {
+                return IncomingNotification{std::move(v.method), v.params.in(payload)};
             } else if constexpr(std::is_same_v<T, bincode_success>) {
                 return IncomingResponse{v.id, std::move(v.result.data)};
             } else if constexpr(std::is_same_v<T, bincode_error>) {
@@ -79,32 +109,68 @@ IncomingMessage BincodeCodec::parse_message(std::string_view payload) {
 Result<std::string> BincodeCodec::encode_request(const protocol::RequestID& id,
                                                  std::string_view method,
                                                  std::string_view params) {
-    return encode_envelope(
-        bincode_request{id, std::string(method), codec::RawValue{std::string(params)}});
+    return encode_to_string([&](std::string& out) {
+        return encode_request(out, id, method, params);
+    });
 }
 
 Result<std::string> BincodeCodec::encode_notification(std::string_view method,
                                                       std::string_view params) {
-    return encode_envelope(
-        bincode_notification{std::string(method), codec::RawValue{std::string(params)}});
+    return encode_to_string([&](std::string& out) {
+        return encode_notification(out, method, params);
+    });
 }
 
 Result<std::string> BincodeCodec::encode_success_response(const protocol::RequestID& id,
                                                           std::string_view result) {
-    return encode_envelope(bincode_success{id, codec::RawValue{std::string(result)}});
+    return encode_to_string([&](std::string& out) {
+        return encode_success_response(out, id, result);
+    });
 }
 
 Result<std::string> BincodeCodec::encode_error_response(const protocol::RequestID& id,
                                                         const Error& error) {
-    std::optional<protocol::RequestID> wire_id = id;
-    return encode_envelope(bincode_error{
-        wire_id,
-        static_cast<std::int32_t>(error.code),
-        error.message,
-        codec::RawValue{},
+    return encode_to_string([&](std::string& out) {
+        return encode_error_response(out, id, error);
     });
 }
 
+Result<void> BincodeCodec::encode_request(std::string& out,
+                                          const protocol::RequestID& id,
+                                          std::string_view method,
+                                          std::string_view params) {
+    return encode_envelope(
+        out,
+        bincode_request{id, std::string(method), codec::RawValue{std::string(params)}});
+}
+
+Result<void> BincodeCodec::encode_notification(std::string& out,
+                                               std::string_view method,
+                                               std::string_view params) {
+    return encode_envelope(
+        out,
+        bincode_notification{std::string(method), codec::RawValue{std::string(params)}});
+}
+
+Result<void> BincodeCodec::encode_success_response(std::string& out,
+                                                   const protocol::RequestID& id,
+                                                   std::string_view result) {
+    return encode_envelope(out, bincode_success{id, codec::RawValue{std::string(result)}});
+}
+
+Result<void> BincodeCodec::encode_error_response(std::string& out,
+                                                 const protocol::RequestID& id,
+                                                 const Error& error) {
+    std::optional<protocol::RequestID> wire_id = id;
+    return encode_envelope(out,
+                           bincode_error{
+                               wire_id,
+                               static_cast<std::int32_t>(error.code),
+                               error.message,
+                               codec::RawValue{},
+                           });
+}
+
 template class Peer<BincodeCodec>;
 
 }  // namespace kota::ipc
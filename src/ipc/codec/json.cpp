@@ -1,7 +1,10 @@
 #include "kota/codec/json/json.h"
 
+#include <span>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "kota/ipc/codec/json.h"
 
@@ -10,14 +13,22 @@ namespace kota::ipc {
 namespace {
 
 template <typename T>
-Result<std::string>
-    serialize_json_value(const T& value,
-                         protocol::ErrorCode code = protocol::ErrorCode::InternalError) {
-    auto serialized = codec::json::to_string(value);
-    if(!serialized) {
-        return outcome_error(Error(code, serialized.error().to_string()));
+Result<void> write_json_value(std::string& out, const T& value) {
+    out.clear();
+    if(auto status = codec::json::to_json_into(out, value); !status) {
+        return outcome_error(Error(protocol::ErrorCode::InternalError, status.error().to_string()));
     }
-    return std::move(*serialized);
+    return {};
+}
+
+template <typename Encode>
+Result<std::string> encode_to_string(Encode&& encode) {
+    std::string out;
+    auto status = encode(out);
+    if(status.has_error()) {
+        return outcome_error(std::move(status.error()));
+    }
+    return out;
 }
 
 struct outgoing_request_message {
@@ -48,7 +59,8 @@ struct outgoing_error_response_message {
 struct json_rpc_incoming {
     std::optional<protocol::RequestID> id;
     std::optional<std::string> method;
-    std::optional<codec::RawValue> params;
+    // Only located, not copied: parse_message() slices it out of the payload.
+    std::optional<codec::RawValueView> params;
     // Not optional<RawValue> because "result": null is a valid success
     // response — optional would lose it as nullopt. defaulted<RawValue>
     // keeps absent → empty(), null → "null" text.
@@ -59,23 +71,24 @@ struct json_rpc_incoming {
 }  // namespace
 
 IncomingMessage JsonCodec::parse_message(std::string_view payload) {
-    auto envelope = codec::json::parse<json_rpc_incoming>(payload);
+    // The thread's parse context keeps simdjson's buffers from one message
+    // to the next.
+    auto envelope =
+        codec::json::parse<json_rpc_incoming>(codec::json::parse_context::local(), payload);
     if(!envelope) {
         return IncomingParseError{
             Error(protocol::ErrorCode::ParseError, envelope.error().to_string())};
     }
 
     auto raw_params =
-        envelope->params.has_value() ? std::move(envelope->params->data) : std::string{};
+        envelope->params.has_value() ? envelope->params->in(payload) : std::string_view{};
 
     // Has method → request or notification
     if(envelope->method.has_value()) {
         if(envelope->id.has_value()) {
-            return IncomingRequest{*envelope->id,
-                                   std::move(*envelope->method),
-                                   std::move(raw_params)};
+            return IncomingRequest{*envelope->id, std::move(*envelope->method), raw_params};
         }
-        return IncomingNotification{std::move(*envelope->method), std::move(raw_params)};
+        return IncomingNotification{std::move(*envelope->method), raw_params};
     }
 
     // No method + has id → response
@@ -99,40 +112,212 @@ IncomingMessage JsonCodec::parse_message(std::string_view payload) {
         Error(protocol::ErrorCode::InvalidRequest, "message must contain method or id")};
 }
 
+bool JsonCodec::is_batch(std::string_view payload) noexcept {
+    auto start = payload.find_first_not_of(" \t\n\r");
+    return start != std::string_view::npos && payload[start] == '[';
+}
+
+Result<std::vector<std::string_view>> JsonCodec::split_batch(std::string_view payload) {
+    auto parsed = codec::json::parse<std::vector<codec::RawValueView>>(
+        codec::json::parse_context::local(), payload);
+    if(!parsed) {
+        return outcome_error(Error(protocol::ErrorCode::ParseError, parsed.error().to_string()));
+    }
+    if(parsed->empty()) {
+        return outcome_error(Error(protocol::ErrorCode::InvalidRequest, "empty batch"));
+    }
+
+    std::vector<std::string_view> messages;
+    messages.reserve(parsed->size());
+    for(auto& message: *parsed) {
+        messages.push_back(message.in(payload));
+    }
+    return messages;
+}
+
+Result<void> JsonCodec::encode_batch(std::string& out, std::span<const std::string> messages) {
+    std::size_t size = 2;
+    for(auto& message: messages) {
+        size += message.size() + 1;
+    }
+
+    out.clear();
+    out.reserve(size);
+    out.push_back('[');
+    for(std::size_t i = 0; i < messages.size(); ++i) {
+        if(i != 0) {
+            out.push_back(',');
+        }
+        out.append(messages[i]);
+    }
+    out.push_back(']');
+    return {};
+}
+
+std::optional<std::string_view> JsonCodec::peek_method(std::string_view payload) {
+    std::size_t pos = 0;
+    auto skip_space = [&] {
+        while(pos < payload.size() && (payload[pos] == ' ' || payload[pos] == '\t' ||
+                                       payload[pos] == '\n' || payload[pos] == '\r')) {
+            ++pos;
+        }
+    };
+
+    // Reads the string at `pos`; nullopt when it has escapes, which only a
+    // parser can decode.
+    auto read_string = [&]() -> std::optional<std::string_view> {
+        if(pos >= payload.size() || payload[pos] != '"') {
+            return std::nullopt;
+        }
+        const auto start = ++pos;
+        while(pos < payload.size() && payload[pos] != '"') {
+            if(payload[pos] == '\\') {
+                return std::nullopt;
+            }
+            ++pos;
+        }
+        if(pos >= payload.size()) {
+            return std::nullopt;
+        }
+        return payload.substr(start, pos++ - start);
+    };
+
+    // Skips a member's value, stopping at the ',' or '}' that follows it.
+    auto skip_value = [&] {
+        std::size_t depth = 0;
+        bool in_string = false;
+        for(; pos < payload.size(); ++pos) {
+            const char ch = payload[pos];
+            if(in_string) {
+                if(ch == '\\') {
+                    ++pos;
+                } else if(ch == '"') {
+                    in_string = false;
+                }
+                continue;
+            }
+            switch(ch) {
+                case '"': in_string = true; break;
+                case '{':
+                case '[': ++depth; break;
+                case '}':
+                case ']':
+                    if(depth == 0) {
+                        return true;
+                    }
+                    --depth;
+                    break;
+                case ',':
+                    if(depth == 0) {
+                        return true;
+                    }
+                    break;
+                default: break;
+            }
+        }
+        return false;
+    };
+
+    skip_space();
+    if(pos >= payload.size() || payload[pos] != '{') {
+        return std::nullopt;
+    }
+    ++pos;
+
+    while(true) {
+        skip_space();
+        auto key = read_string();
+        if(!key) {
+            return std::nullopt;
+        }
+        skip_space();
+        if(pos >= payload.size() || payload[pos] != ':') {
+            return std::nullopt;
+        }
+        ++pos;
+        skip_space();
+
+        if(*key == "method") {
+            return read_string();
+        }
+        if(!skip_value() || payload[pos] == '}') {
+            return std::nullopt;
+        }
+        ++pos;
+    }
+}
+
 Result<std::string> JsonCodec::encode_request(const protocol::RequestID& id,
                                               std::string_view method,
                                               std::string_view params) {
-    return serialize_json_value(outgoing_request_message{
-        .id = id,
-        .method = std::string(method),
-        .params = codec::RawValue{std::string(params)},
+    return encode_to_string([&](std::string& out) {
+        return encode_request(out, id, method, params);
     });
 }
 
 Result<std::string> JsonCodec::encode_notification(std::string_view method,
                                                    std::string_view params) {
-    return serialize_json_value(outgoing_notification_message{
-        .method = std::string(method),
-        .params = codec::RawValue{std::string(params)},
+    return encode_to_string([&](std::string& out) {
+        return encode_notification(out, method, params);
     });
 }
 
 Result<std::string> JsonCodec::encode_success_response(const protocol::RequestID& id,
                                                        std::string_view result) {
-    return serialize_json_value(outgoing_success_response_message{
-        .id = id,
-        .result = codec::RawValue{std::string(result)},
+    return encode_to_string([&](std::string& out) {
+        return encode_success_response(out, id, result);
     });
 }
 
 Result<std::string> JsonCodec::encode_error_response(const protocol::RequestID& id,
                                                      const Error& error) {
-    return serialize_json_value(outgoing_error_response_message{
-        .id = id,
-        .error = error,
+    return encode_to_string([&](std::string& out) {
+        return encode_error_response(out, id, error);
     });
 }
 
+Result<void> JsonCodec::encode_request(std::string& out,
+                                       const protocol::RequestID& id,
+                                       std::string_view method,
+                                       std::string_view params) {
+    return write_json_value(out,
+                            outgoing_request_message{
+                                .id = id,
+                                .method = std::string(method),
+                                .params = codec::RawValue{std::string(params)},
+                            });
+}
+
+Result<void> JsonCodec::encode_notification(std::string& out,
+                                            std::string_view method,
+                                            std::string_view params) {
+    return write_json_value(out,
+                            outgoing_notification_message{
+                                .method = std::string(method),
+                                .params = codec::RawValue{std::string(params)},
+                            });
+}
+
+Result<void> JsonCodec::encode_success_response(std::string& out,
+                                                const protocol::RequestID& id,
+                                                std::string_view result) {
+    return write_json_value(out,
+                            outgoing_success_response_message{
+                                .id = id,
+                                .result = codec::RawValue{std::string(result)},
+                            });
+}
+
+Result<void> JsonCodec::encode_error_response(std::string& out,
+                                              const protocol::RequestID& id,
+                                              const Error& error) {
+    return write_json_value(out,
+                            outgoing_error_response_message{
+                                .id = id,
+                                .error = error,
+                            });
+}
+
 template class Peer<JsonCodec>;
 
 }  // namespace kota::ipc
@@ -0,0 +1,338 @@
+#include "kota/ipc/compressing_transport.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace kota::ipc {
+
+namespace {
+
+// Sent once, before the first message: a magic, the framing version and
+// the compression format (1 = LZ4 block with a 64 KiB history).
+constexpr std::string_view hello("\0KOTZ\1\1", 7);
+constexpr std::string_view hello_magic = hello.substr(0, 5);
+
+constexpr char stored_tag = 0;
+constexpr char block_tag = 1;
+
+constexpr std::size_t size_field = 4;
+constexpr std::size_t max_payload = 64 * 1024 * 1024;
+
+// LZ4 block format limits: matches are at least 4 bytes and reach back at
+// most 65535; the last 5 bytes are always literals, and no match starts in
+// the last 12.
+constexpr std::size_t min_match = 4;
+constexpr std::size_t last_literals = 5;
+constexpr std::size_t match_guard = 12;
+constexpr std::size_t max_offset = 65535;
+constexpr std::size_t dictionary_size = max_offset;
+
+constexpr int hash_log = 14;
+
+std::uint32_t read32(std::string_view bytes, std::size_t at) {
+    std::uint32_t value;
+    std::memcpy(&value, bytes.data() + at, sizeof(value));
+    return value;
+}
+
+std::size_t hash_at(std::string_view bytes, std::size_t at) {
+    return (read32(bytes, at) * 2654435761U) >> (32 - hash_log);
+}
+
+/// Writes the part of a literal or match length that does not fit in its
+/// token nibble.
+void write_count(std::string& out, std::size_t count) {
+    while(count >= 255) {
+        out.push_back(static_cast<char>(255));
+        count -= 255;
+    }
+    out.push_back(static_cast<char>(count));
+}
+
+void write_sequence(std::string& out,
+                    std::string_view literals,
+                    std::size_t offset,
+                    std::size_t length) {
+    const auto match = length - min_match;
+    const auto token = (std::min<std::size_t>(literals.size(), 15) << 4) |
+                       std::min<std::size_t>(match, 15);
+    out.push_back(static_cast<char>(token));
+    if(literals.size() >= 15) {
+        write_count(out, literals.size() - 15);
+    }
+    out.append(literals);
+    out.push_back(static_cast<char>(offset & 0xff));
+    out.push_back(static_cast<char>((offset >> 8) & 0xff));
+    if(match >= 15) {
+        write_count(out, match - 15);
+    }
+}
+
+/// Appends the LZ4 block encoding of the bytes of `window` from `start` on
+/// to `out`. Matches may reach back into the bytes before `start`, which
+/// serve as the dictionary.
+void compress_block(std::string_view window, std::size_t start, std::string& out) {
+    const auto end = window.size();
+    std::size_t anchor = start;
+
+    if(end - start > match_guard) {
+        constexpr auto none = (std::numeric_limits<std::uint32_t>::max)();
+        std::vector<std::uint32_t> table(std::size_t(1) << hash_log, none);
+        for(auto at = start > dictionary_size ? start - dictionary_size : 0;
+            at + min_match <= start;
+            ++at) {
+            table[hash_at(window, at)] = static_cast<std::uint32_t>(at);
+        }
+
+        // Greedy: take the first match the hash table offers, as is.
+        const auto limit = end - match_guard;
+        std::size_t at = start;
+        while(at <= limit) {
+            const auto slot = hash_at(window, at);
+            const auto candidate = table[slot];
+            table[slot] = static_cast<std::uint32_t>(at);
+            if(candidate == none || at - candidate > max_offset ||
+               read32(window, candidate) != read32(window, at)) {
+                ++at;
+                continue;
+            }
+
+            std::size_t length = min_match;
+            const auto max_length = end - last_literals - at;
+            while(length < max_length && window[candidate + length] == window[at + length]) {
+                ++length;
+            }
+
+            write_sequence(out, window.substr(anchor, at - anchor), at - candidate, length);
+            at += length;
+            anchor = at;
+        }
+    }
+
+    const auto literals = end - anchor;
+    out.push_back(static_cast<char>(std::min<std::size_t>(literals, 15) << 4));
+    if(literals >= 15) {
+        write_count(out, literals - 15);
+    }
+    out.append(window.substr(anchor));
+}
+
+/// Decodes an LZ4 block of `size` bytes onto the end of `window`, whose
+/// bytes so far serve as the dictionary. False if the block is malformed,
+/// leaving the tail of `window` unspecified.
+bool decompress_block(std::string_view block, std::size_t size, std::string& window) {
+    const auto start = window.size();
+    const auto end = start + size;
+    window.resize(end);
+    auto* out = window.data();
+    std::size_t pos = start;
+    std::size_t in = 0;
+
+    auto read_count = [&](std::size_t& count) {
+        if(count != 15) {
+            return true;
+        }
+        unsigned char byte = 0;
+        do {
+            if(in >= block.size()) {
+                return false;
+            }
+            byte = static_cast<unsigned char>(block[in++]);
+            count += byte;
+        } while(byte == 255);
+        return true;
+    };
+
+    while(true) {
+        if(in >= block.size()) {
+            return false;
+        }
+        const auto token = static_cast<unsigned char>(block[in++]);
+
+        std::size_t literals = token >> 4;
+        if(!read_count(literals) || literals > block.size() - in || literals > end - pos) {
+            return false;
+        }
+        std::memcpy(out + pos, block.data() + in, literals);
+        pos += literals;
+        in += literals;
+
+        // The last sequence is literals only.
+        if(in == block.size()) {
+            break;
+        }
+
+        if(block.size() - in < 2) {
+            return false;
+        }
+        const auto low = static_cast<unsigned char>(block[in]);
+        const auto high = static_cast<unsigned char>(block[in + 1]);
+        const std::size_t offset = low | (static_cast<std::size_t>(high) << 8);
+        in += 2;
+
+        std::size_t length = token & 0x0f;
+        if(!read_count(length)) {
+            return false;
+        }
+        length += min_match;
+        if(offset == 0 || offset > pos || length > end - pos) {
+            return false;
+        }
+
+        const auto from = pos - offset;
+        if(offset >= length) {
+            std::memcpy(out + pos, out + from, length);
+        } else {
+            // Overlapping: the match repeats the bytes it is producing.
+            for(std::size_t i = 0; i < length; ++i) {
+                out[pos + i] = out[from + i];
+            }
+        }
+        pos += length;
+    }
+
+    return pos == end;
+}
+
+void trim_history(std::string& history) {
+    if(history.size() > dictionary_size) {
+        history.erase(0, history.size() - dictionary_size);
+    }
+}
+
+}  // namespace
+
+CompressingTransport::CompressingTransport(std::unique_ptr<Transport> transport, options opts) :
+    inner(std::move(transport)), opts(opts) {
+    assert(inner && "CompressingTransport requires a non-null inner transport");
+}
+
+task<std::optional<std::string>> CompressingTransport::read_message() {
+    auto message = co_await inner->read_message();
+    if(message && mode == input_mode::unknown) {
+        if(message->starts_with(hello_magic)) {
+            if(*message != hello) {
+                // A version or format this side does not know.
+                co_return std::nullopt;
+            }
+            mode = input_mode::framed;
+            message = co_await inner->read_message();
+        } else {
+            mode = input_mode::plain;
+        }
+    }
+
+    if(!message || mode == input_mode::plain) {
+        co_return message;
+    }
+    co_return decode(*message);
+}
+
+task<void, Error> CompressingTransport::write_message(std::string_view payload) {
+    co_await write_messages(std::span<const std::string_view>(&payload, 1)).or_fail();
+}
+
+task<void, Error> CompressingTransport::write_messages(std::span<const std::string_view> payloads) {
+    if(!opts.compress) {
+        co_await inner->write_messages(payloads).or_fail();
+        co_return;
+    }
+
+    // Framed before the first suspension, so the output dictionary follows
+    // the order the messages reach the inner transport in.
+    std::vector<std::string> frames;
+    frames.reserve(payloads.size() + 1);
+    if(!hello_sent) {
+        hello_sent = true;
+        frames.emplace_back(hello);
+    }
+    for(auto payload: payloads) {
+        frames.push_back(encode(payload));
+    }
+
+    std::vector<std::string_view> views(frames.begin(), frames.end());
+    co_await inner->write_messages(views).or_fail();
+}
+
+void CompressingTransport::cork() {
+    inner->cork();
+}
+
+task<void, Error> CompressingTransport::uncork() {
+    co_await inner->uncork().or_fail();
+}
+
+Result<void> CompressingTransport::close_output() {
+    return inner->close_output();
+}
+
+Result<void> CompressingTransport::close() {
+    return inner->close();
+}
+
+std::string CompressingTransport::encode(std::string_view payload) {
+    std::string frame;
+    const auto start = output_history.size();
+    output_history.append(payload);
+
+    if(payload.size() >= opts.threshold && payload.size() <= max_payload) {
+        const auto size = static_cast<std::uint32_t>(payload.size());
+        frame.reserve(payload.size() / 2 + 16);
+        frame.push_back(block_tag);
+        for(std::size_t i = 0; i < size_field; ++i) {
+            frame.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+        }
+        compress_block(output_history, start, frame);
+        if(frame.size() > payload.size()) {
+            frame.clear();
+        }
+    }
+
+    if(frame.empty()) {
+        frame.reserve(payload.size() + 1);
+        frame.push_back(stored_tag);
+        frame.append(payload);
+    }
+
+    trim_history(output_history);
+    return frame;
+}
+
+std::optional<std::string> CompressingTransport::decode(std::string_view frame) {
+    if(frame.empty()) {
+        return std::nullopt;
+    }
+
+    const auto body = frame.substr(1);
+    std::string payload;
+    if(frame[0] == stored_tag) {
+        payload.assign(body);
+        input_history.append(body);
+    } else if(frame[0] == block_tag && body.size() >= size_field) {
+        std::size_t size = 0;
+        for(std::size_t i = 0; i < size_field; ++i) {
+            size |= static_cast<std::size_t>(static_cast<unsigned char>(body[i])) << (8 * i);
+        }
+        if(size > max_payload) {
+            return std::nullopt;
+        }
+
+        const auto start = input_history.size();
+        if(!decompress_block(body.substr(size_field), size, input_history)) {
+            input_history.resize(start);
+            return std::nullopt;
+        }
+        payload.assign(input_history, start, size);
+    } else {
+        return std::nullopt;
+    }
+
+    trim_history(input_history);
+    return payload;
+}
+
+}  // namespace kota::ipc
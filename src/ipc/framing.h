@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "kota/ipc/codec.h"
+#include "kota/async/async.h"
+
+namespace kota::ipc::detail {
+
+/// One message of the Content-Length framing shared by the stream transports.
+struct frame {
+    std::string payload;
+
+    /// Value of the File-Descriptors header: descriptors sent along with
+    /// the message over a Unix socket; 0 when absent.
+    std::size_t descriptors = 0;
+};
+
+/// Reads the next frame; nullopt at end of stream or when it is malformed,
+/// after which reading has been stopped.
+task<std::optional<frame>> read_frame(stream& input);
+
+/// Header announcing a payload of `length` bytes.
+std::string frame_header(std::size_t length, std::size_t descriptors = 0);
+
+/// Opens stdio descriptor `fd` as whichever stream type it refers to.
+Result<stream> open_stdio_stream(int fd, bool readable, event_loop& loop);
+
+}  // namespace kota::ipc::detail
@@ -0,0 +1,72 @@
+#include "kota/ipc/logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace kota::ipc {
+
+DeferredLog::DeferredLog(LogCallback sink, std::size_t capacity) :
+    capacity(std::bit_ceil((std::max)(capacity, std::size_t(2)))),
+    records(std::make_unique<record[]>(this->capacity)), sink(std::move(sink)),
+    worker([this] { drain(); }) {}
+
+DeferredLog::~DeferredLog() {
+    stopping.store(true);
+    sleeping.store(false);
+    sleeping.notify_one();
+    worker.join();
+}
+
+void DeferredLog::publish(std::size_t tail) {
+    // Pairs with the store-then-check in drain(): either the thread sees
+    // the new tail before sleeping, or this sees it asleep and wakes it.
+    write_index.store(tail, std::memory_order_seq_cst);
+    if(sleeping.load(std::memory_order_seq_cst)) {
+        sleeping.store(false);
+        sleeping.notify_one();
+    }
+}
+
+void DeferredLog::flush() {
+    const auto tail = write_index.load(std::memory_order_relaxed);
+    auto head = read_index.load(std::memory_order_acquire);
+    while(head < tail) {
+        read_index.wait(head, std::memory_order_acquire);
+        head = read_index.load(std::memory_order_acquire);
+    }
+}
+
+void DeferredLog::drain() {
+    std::string line;
+    while(true) {
+        auto head = read_index.load(std::memory_order_relaxed);
+        const auto tail = write_index.load(std::memory_order_acquire);
+        for(; head != tail; ++head) {
+            auto& slot = records[head & (capacity - 1)];
+            line.clear();
+            slot.render(slot, line);
+            if(sink) {
+                sink(slot.level, std::move(line));
+            }
+            read_index.store(head + 1, std::memory_order_release);
+            read_index.notify_all();
+        }
+
+        if(stopping.load()) {
+            if(write_index.load(std::memory_order_acquire) == head) {
+                return;
+            }
+            continue;
+        }
+
+        sleeping.store(true, std::memory_order_seq_cst);
+        if(write_index.load(std::memory_order_seq_cst) != head || stopping.load()) {
+            sleeping.store(false);
+            continue;
+        }
+        sleeping.wait(true);
+    }
+}
+
+}  // namespace kota::ipc
@@ -0,0 +1,15 @@
+#define KOTA_LSP_JSON_CODEC_BUILD
+#include "kota/ipc/lsp/json_codec.h"
+
+namespace kota::ipc {
+
+#define KOTA_LSP_JSON_CODEC_DEFINE_VALUE(TYPE) KOTA_LSP_JSON_CODEC_VALUE(template, TYPE)
+#define KOTA_LSP_JSON_CODEC_DEFINE_REQUEST(PARAMS) KOTA_LSP_JSON_CODEC_REQUEST(template, PARAMS)
+
+KOTA_LSP_JSON_CODEC_TYPES(KOTA_LSP_JSON_CODEC_DEFINE_VALUE)
+KOTA_LSP_JSON_CODEC_REQUEST_PARAMS(KOTA_LSP_JSON_CODEC_DEFINE_REQUEST)
+
+#undef KOTA_LSP_JSON_CODEC_DEFINE_REQUEST
+#undef KOTA_LSP_JSON_CODEC_DEFINE_VALUE
+
+}  // namespace kota::ipc
@@ -0,0 +1,88 @@
+#include "kota/ipc/lsp/document.h"
+
+#include <memory>
+#include <utility>
+#include <variant>
+
+namespace kota::ipc::lsp {
+
+TextDocument::TextDocument(std::string_view text, PositionEncoding encoding) :
+    content(text), mapper(content, encoding) {}
+
+bool TextDocument::apply(const protocol::TextDocumentContentChangeEvent& change) {
+    if(auto* whole = std::get_if<protocol::TextDocumentContentChangeWholeDocument>(&change)) {
+        content.assign(whole->text);
+        return true;
+    }
+
+    auto& partial = std::get<protocol::TextDocumentContentChangePartial>(change);
+    auto begin = mapper.to_offset(partial.range.start);
+    auto end = mapper.to_offset(partial.range.end);
+    if(!begin || !end || *begin > *end) {
+        return false;
+    }
+
+    content.replace(*begin, *end, partial.text);
+    return true;
+}
+
+bool TextDocument::apply(std::span<const protocol::TextDocumentContentChangeEvent> changes) {
+    // The copy shares every node, so keeping it to roll back costs O(1).
+    auto before = content;
+    for(auto& change: changes) {
+        if(!apply(change)) {
+            content = std::move(before);
+            return false;
+        }
+    }
+    return true;
+}
+
+DocumentSnapshot DocumentStore::open(const protocol::TextDocumentItem& item) {
+    auto uri = pool.intern(item.uri);
+    auto& slot = documents[uri];
+    slot.document = std::make_unique<TextDocument>(item.text, encoding);
+    slot.version = item.version;
+    slot.latest = {};
+    return snapshot(uri);
+}
+
+bool DocumentStore::change(const protocol::DidChangeTextDocumentParams& params) {
+    auto it = documents.find(std::string_view(params.text_document.uri));
+    if(it == documents.end()) {
+        return false;
+    }
+
+    auto& slot = it->second;
+    if(!slot.document->apply(params.content_changes)) {
+        return false;
+    }
+    slot.version = params.text_document.version;
+    slot.latest = {};
+    return true;
+}
+
+void DocumentStore::close(std::string_view uri) {
+    documents.erase(uri);
+}
+
+DocumentSnapshot DocumentStore::snapshot(std::string_view uri) {
+    auto it = documents.find(uri);
+    if(it == documents.end()) {
+        return {};
+    }
+
+    auto& slot = it->second;
+    if(!slot.latest) {
+        slot.latest = DocumentSnapshot(
+            std::make_shared<const DocumentSnapshot::snapshot_state>(DocumentSnapshot::snapshot_state{
+                .uri = it->first,
+                .version = slot.version,
+                .encoding = encoding,
+                .text = slot.document->text(),
+            }));
+    }
+    return slot.latest;
+}
+
+}  // namespace kota::ipc::lsp
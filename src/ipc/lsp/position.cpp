@@ -6,8 +6,18 @@
 #include <optional>
 #include <utility>
 
+#include "kota/support/simd.h"
+
 namespace {
 
+/// Appends `base + i + 1` to `starts` for the position `i` of every '\n'
+/// in `text`, in order.
+void index_lines(std::string_view text, std::uint32_t base, std::vector<std::uint32_t>& starts) {
+    kota::simd::for_each_byte(text, '\n', [&](std::size_t at) {
+        starts.push_back(base + static_cast<std::uint32_t>(at) + 1);
+    });
+}
+
 // Decodes one UTF-8 code point starting at `index`.
 // Returns:
 // - first: consumed UTF-8 byte count
@@ -169,15 +179,67 @@ PositionEncoding parse_position_encoding(std::string_view encoding) {
 PositionMapper::PositionMapper(std::string_view content, PositionEncoding encoding) :
     content(content), encoding(encoding) {
     line_starts.push_back(0);
-    for(std::uint32_t i = 0; i < content.size(); ++i) {
-        if(content[i] == '\n') {
-            line_starts.push_back(i + 1);
+    index_lines(content, 0, line_starts);
+
+    ascii_lines.resize(line_starts.size());
+    for(std::uint32_t line = 0; line < line_starts.size(); ++line) {
+        ascii_lines[line] = line_is_ascii(line);
+    }
+}
+
+PositionMapper::PositionMapper(const kota::rope& content, PositionEncoding encoding) :
+    text_rope(&content), encoding(encoding) {}
+
+std::uint32_t PositionMapper::content_size() const {
+    return static_cast<std::uint32_t>(text_rope ? text_rope->size() : content.size());
+}
+
+std::size_t PositionMapper::rope_units(std::uint32_t offset) const {
+    switch(encoding) {
+        case PositionEncoding::UTF8: return offset;
+        case PositionEncoding::UTF16: return text_rope->measure(offset).utf16;
+        case PositionEncoding::UTF32: return text_rope->measure(offset).codepoints;
+    }
+    return offset;
+}
+
+std::optional<std::uint32_t> PositionMapper::rope_offset(protocol::Position position) const {
+    if(position.line >= text_rope->line_count()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    auto begin = line_start(position.line);
+    auto end = line_end_exclusive(position.line);
+    if(encoding == PositionEncoding::UTF8) {
+        if(position.character > end - begin) [[unlikely]] {
+            return std::nullopt;
         }
+        return begin + position.character;
     }
+
+    // Seek the unit count the position names; it lands past the line, or
+    // short of the count inside a surrogate pair, when it is out of range.
+    const auto unit = encoding == PositionEncoding::UTF16 ? &kota::rope_metrics::utf16
+                                                          : &kota::rope_metrics::codepoints;
+    const auto target = text_rope->measure(begin).*unit + position.character;
+    const auto offset = text_rope->seek(unit, target);
+    if(offset > end || text_rope->measure(offset).*unit != target) [[unlikely]] {
+        return std::nullopt;
+    }
+    return static_cast<std::uint32_t>(offset);
+}
+
+bool PositionMapper::line_is_ascii(std::uint32_t line) const {
+    auto start = line_start(line);
+    auto text = content.substr(start, line_end_exclusive(line) - start);
+    return kota::simd::is_ascii(text);
 }
 
 std::uint32_t PositionMapper::line_of(std::uint32_t offset) const {
-    assert(offset <= content.size() && "offset out of range");
+    assert(offset <= content_size() && "offset out of range");
+    if(text_rope) {
+        return static_cast<std::uint32_t>(text_rope->line_of(offset));
+    }
     auto it = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
     if(it == line_starts.begin()) {
         return 0;
@@ -186,11 +248,20 @@ std::uint32_t PositionMapper::line_of(std::uint32_t offset) const {
 }
 
 std::uint32_t PositionMapper::line_start(std::uint32_t line) const {
+    if(text_rope) {
+        return static_cast<std::uint32_t>(text_rope->line_start(line));
+    }
     assert(line < line_starts.size() && "line out of range");
     return line_starts[line];
 }
 
 std::uint32_t PositionMapper::line_end_exclusive(std::uint32_t line) const {
+    if(text_rope) {
+        if(line + 1 < text_rope->line_count()) {
+            return line_start(line + 1) - 1;
+        }
+        return content_size();
+    }
     assert(line < line_starts.size() && "line out of range");
     if(line + 1 < line_starts.size()) {
         return line_starts[line + 1] - 1;
@@ -203,8 +274,17 @@ std::uint32_t PositionMapper::measure(std::string_view text) const {
         return static_cast<std::uint32_t>(text.size());
     }
 
+    // ASCII runs are one unit per byte in either encoding; only the code
+    // points between them are decoded.
     std::uint32_t units = 0;
     for(std::size_t index = 0; index < text.size();) {
+        auto run = kota::simd::ascii_prefix(text.substr(index));
+        units += static_cast<std::uint32_t>(run);
+        index += run;
+        if(index == text.size()) {
+            break;
+        }
+
         auto [utf8, utf16] = next_codepoint_sizes(text, index);
         index += utf8;
         units += (encoding == PositionEncoding::UTF16) ? utf16 : 1;
@@ -216,6 +296,12 @@ std::uint32_t PositionMapper::character(std::uint32_t line, std::uint32_t byte_c
     auto start = line_start(line);
     [[maybe_unused]] auto end = line_end_exclusive(line);
     assert(start + byte_column <= end && "byte column out of range");
+    if(text_rope) {
+        return static_cast<std::uint32_t>(rope_units(start + byte_column) - rope_units(start));
+    }
+    if(ascii_lines[line]) {
+        return byte_column;
+    }
     return measure(content.substr(start, byte_column));
 }
 
@@ -232,11 +318,18 @@ std::uint32_t PositionMapper::length(std::uint32_t line,
     }
 
     auto size = end_byte_column - begin_byte_column;
+    if(text_rope) {
+        return static_cast<std::uint32_t>(rope_units(start + end_byte_column) -
+                                          rope_units(start + begin_byte_column));
+    }
+    if(ascii_lines[line]) {
+        return size;
+    }
     return measure(content.substr(start + begin_byte_column, size));
 }
 
 std::optional<protocol::Position> PositionMapper::to_position(std::uint32_t offset) const {
-    if(offset > content.size()) [[unlikely]] {
+    if(offset > content_size()) [[unlikely]] {
         return std::nullopt;
     }
     auto line = line_of(offset);
@@ -251,6 +344,10 @@ std::optional<protocol::Position> PositionMapper::to_position(std::uint32_t offs
 }
 
 std::optional<std::uint32_t> PositionMapper::to_offset(protocol::Position position) const {
+    if(text_rope) {
+        return rope_offset(position);
+    }
+
     auto line = position.line;
     auto target = position.character;
 
@@ -265,7 +362,7 @@ std::optional<std::uint32_t> PositionMapper::to_offset(protocol::Position positi
         return begin;
     }
 
-    if(encoding == PositionEncoding::UTF8) {
+    if(encoding == PositionEncoding::UTF8 || ascii_lines[line]) {
         if(begin + target > end) [[unlikely]] {
             return std::nullopt;
         }
@@ -291,4 +388,45 @@ std::optional<std::uint32_t> PositionMapper::to_offset(protocol::Position positi
     return std::nullopt;
 }
 
+void PositionMapper::apply_edit(std::string_view content,
+                                std::uint32_t begin,
+                                std::uint32_t end,
+                                std::string_view text) {
+    assert(!text_rope && "a mapper over a rope follows its edits");
+    assert(begin <= end && "edit range reversed");
+    assert(end <= this->content.size() && "edit range out of range");
+
+    // Lines starting in (begin, end] followed a newline the edit removed;
+    // the ones after shift by the change in length.
+    auto first = static_cast<std::size_t>(
+        std::upper_bound(line_starts.begin(), line_starts.end(), begin) - line_starts.begin());
+    auto last = static_cast<std::size_t>(
+        std::upper_bound(line_starts.begin() + first, line_starts.end(), end) -
+        line_starts.begin());
+
+    const auto delta = static_cast<std::uint32_t>(text.size()) - (end - begin);
+    for(auto i = last; i < line_starts.size(); ++i) {
+        line_starts[i] += delta;
+    }
+
+    std::vector<std::uint32_t> added;
+    index_lines(text, begin, added);
+    const auto removed = last - first;
+    if(added.size() > removed) {
+        line_starts.insert(line_starts.begin() + last, added.size() - removed, 0);
+        ascii_lines.insert(ascii_lines.begin() + last, added.size() - removed, true);
+    } else if(added.size() < removed) {
+        line_starts.erase(line_starts.begin() + first + added.size(), line_starts.begin() + last);
+        ascii_lines.erase(ascii_lines.begin() + first + added.size(), ascii_lines.begin() + last);
+    }
+    std::copy(added.begin(), added.end(), line_starts.begin() + first);
+
+    this->content = content;
+
+    // The line the edit starts on, and those the new text adds.
+    for(auto line = first - 1; line <= first + added.size() - 1; ++line) {
+        ascii_lines[line] = line_is_ascii(static_cast<std::uint32_t>(line));
+    }
+}
+
 }  // namespace kota::ipc::lsp
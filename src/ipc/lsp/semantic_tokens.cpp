@@ -0,0 +1,160 @@
+#include "kota/ipc/lsp/semantic_tokens.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace kota::ipc::lsp {
+
+namespace {
+
+constexpr std::size_t token_width = 5;
+
+}  // namespace
+
+void SemanticTokensBuilder::add(std::uint32_t begin,
+                                std::uint32_t end,
+                                std::uint32_t type,
+                                std::uint32_t modifiers) {
+    if(begin >= end) {
+        return;
+    }
+
+    auto first_line = mapper.line_of(begin);
+    auto last_line = mapper.line_of(end);
+    for(auto line = first_line; line <= last_line; ++line) {
+        auto line_start = mapper.line_start(line);
+        auto from = line == first_line ? begin - line_start : 0;
+        auto to = line == last_line ? end - line_start
+                                    : mapper.line_end_exclusive(line) - line_start;
+        if(from >= to) {
+            continue;
+        }
+        push(line, mapper.character(line, from), mapper.length(line, from, to), type, modifiers);
+    }
+}
+
+void SemanticTokensBuilder::push(std::uint32_t line,
+                                 std::uint32_t character,
+                                 std::uint32_t length,
+                                 std::uint32_t type,
+                                 std::uint32_t modifiers) {
+    if(sorted && !tokens.empty()) {
+        auto last_line = tokens[tokens.size() - token_width];
+        auto last_character = tokens[tokens.size() - token_width + 1];
+        sorted = last_line < line || (last_line == line && last_character <= character);
+    }
+    tokens.insert(tokens.end(), {line, character, length, type, modifiers});
+}
+
+std::vector<protocol::uinteger> SemanticTokensBuilder::build() {
+    auto count = size();
+    if(!sorted) {
+        // Sort whole tokens through an index, then gather them in order.
+        std::vector<std::uint32_t> order(count);
+        for(std::uint32_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::ranges::stable_sort(order, [&](std::uint32_t lhs, std::uint32_t rhs) {
+            auto* a = tokens.data() + lhs * token_width;
+            auto* b = tokens.data() + rhs * token_width;
+            return a[0] != b[0] ? a[0] < b[0] : a[1] < b[1];
+        });
+
+        std::vector<protocol::uinteger> ordered;
+        ordered.reserve(tokens.size());
+        for(auto index: order) {
+            auto* token = tokens.data() + index * token_width;
+            ordered.insert(ordered.end(), token, token + token_width);
+        }
+        tokens = std::move(ordered);
+    }
+
+    // Rewrite in place, back to front, so each token still sees the
+    // absolute position of the one before it.
+    for(auto i = count; i-- > 1;) {
+        auto* token = tokens.data() + i * token_width;
+        auto* previous = token - token_width;
+        if(token[0] == previous[0]) {
+            token[1] -= previous[1];
+        }
+        token[0] -= previous[0];
+    }
+
+    sorted = true;
+    return std::exchange(tokens, {});
+}
+
+std::vector<protocol::SemanticTokensEdit>
+    diff_semantic_tokens(std::span<const protocol::uinteger> previous,
+                         std::span<const protocol::uinteger> current) {
+    assert(previous.size() % token_width == 0 && current.size() % token_width == 0);
+
+    // Compare whole tokens so an edit never splits one.
+    auto shorter = std::min(previous.size(), current.size()) / token_width;
+    std::size_t prefix = 0;
+    while(prefix < shorter &&
+          std::ranges::equal(previous.subspan(prefix * token_width, token_width),
+                             current.subspan(prefix * token_width, token_width))) {
+        ++prefix;
+    }
+
+    std::size_t suffix = 0;
+    while(suffix < shorter - prefix &&
+          std::ranges::equal(
+              previous.subspan(previous.size() - (suffix + 1) * token_width, token_width),
+              current.subspan(current.size() - (suffix + 1) * token_width, token_width))) {
+        ++suffix;
+    }
+
+    auto start = prefix * token_width;
+    auto removed = previous.size() - (prefix + suffix) * token_width;
+    auto inserted = current.subspan(start, current.size() - (prefix + suffix) * token_width);
+    if(removed == 0 && inserted.empty()) {
+        return {};
+    }
+
+    protocol::SemanticTokensEdit edit{
+        .start = static_cast<protocol::uinteger>(start),
+        .delete_count = static_cast<protocol::uinteger>(removed),
+    };
+    if(!inserted.empty()) {
+        edit.data = std::vector<protocol::uinteger>(inserted.begin(), inserted.end());
+    }
+
+    std::vector<protocol::SemanticTokensEdit> edits;
+    edits.push_back(std::move(edit));
+    return edits;
+}
+
+protocol::SemanticTokens SemanticTokensCache::full(std::vector<protocol::uinteger> tokens) {
+    result_id = next_result_id();
+    data = std::move(tokens);
+    return protocol::SemanticTokens{.result_id = *result_id, .data = data};
+}
+
+std::variant<protocol::SemanticTokens, protocol::SemanticTokensDelta>
+    SemanticTokensCache::delta(std::string_view previous_result_id,
+                               std::vector<protocol::uinteger> tokens) {
+    if(!result_id || *result_id != previous_result_id) {
+        return full(std::move(tokens));
+    }
+
+    protocol::SemanticTokensDelta delta;
+    delta.edits = diff_semantic_tokens(data, tokens);
+    result_id = next_result_id();
+    delta.result_id = *result_id;
+    data = std::move(tokens);
+    return delta;
+}
+
+void SemanticTokensCache::clear() {
+    result_id.reset();
+    data.clear();
+}
+
+std::string SemanticTokensCache::next_result_id() {
+    return std::to_string(++generation);
+}
+
+}  // namespace kota::ipc::lsp
@@ -1,7 +1,12 @@
 #include "kota/ipc/lsp/uri.h"
 
 #include <algorithm>
+#include <cassert>
 #include <ranges>
+#include <utility>
+
+#include "kota/support/expected_try.h"
+#include "kota/support/simd.h"
 
 namespace kota::ipc::lsp {
 
@@ -26,22 +31,6 @@ constexpr char to_ascii_lower(unsigned char value) noexcept {
     return static_cast<char>(value);
 }
 
-constexpr bool is_ascii_iequal(std::string_view left, std::string_view right) noexcept {
-    if(left.size() != right.size()) [[unlikely]] {
-        return false;
-    }
-
-    for(std::size_t index = 0; index < left.size(); ++index) {
-        const auto lhs = to_ascii_lower(static_cast<unsigned char>(left[index]));
-        const auto rhs = to_ascii_lower(static_cast<unsigned char>(right[index]));
-        if(lhs != rhs) [[unlikely]] {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 constexpr bool is_valid_scheme(std::string_view scheme) noexcept {
     if(scheme.empty()) {
         return false;
@@ -121,21 +110,37 @@ constexpr bool is_absolute_fs_path(std::string_view path) noexcept {
     return path.starts_with('/') || path.starts_with("//") || is_windows_drive_absolute(path);
 }
 
-std::string percent_encode_with_policy(std::string_view input, bool encode_slash) {
-    constexpr static char hex[] = "0123456789ABCDEF";
+constexpr simd::byte_set encoded_bytes(bool encode_slash) noexcept {
+    simd::byte_set set;
+    for(unsigned value = 0; value < 256; ++value) {
+        if(should_encode(static_cast<unsigned char>(value), encode_slash)) {
+            set.insert(static_cast<unsigned char>(value));
+        }
+    }
+    return set;
+}
 
-    std::string output;
-    output.reserve(input.size());
-    for(unsigned char value: input) {
-        if(should_encode(value, encode_slash)) {
-            output.push_back('%');
-            output.push_back(hex[(value >> 4) & 0x0F]);
-            output.push_back(hex[value & 0x0F]);
-        } else {
-            output.push_back(static_cast<char>(value));
+void append_percent_encoded(std::string& output, std::string_view input, bool encode_slash) {
+    constexpr static char hex[] = "0123456789ABCDEF";
+    constexpr static simd::byte_set encode_with_slash = encoded_bytes(true);
+    constexpr static simd::byte_set encode_without_slash = encoded_bytes(false);
+    const auto& encoded = encode_slash ? encode_with_slash : encode_without_slash;
+
+    // Runs that need no escape are copied whole, so text with nothing to
+    // escape is a single search and append.
+    output.reserve(output.size() + input.size());
+    for(std::size_t index = 0; index < input.size();) {
+        const auto next = simd::find_first_of(input, encoded, index);
+        output.append(input.substr(index, next - index));
+        if(next == input.size()) {
+            break;
         }
+        const auto value = static_cast<unsigned char>(input[next]);
+        output.push_back('%');
+        output.push_back(hex[(value >> 4) & 0x0F]);
+        output.push_back(hex[value & 0x0F]);
+        index = next + 1;
     }
-    return output;
 }
 
 }  // namespace
@@ -279,19 +284,27 @@ std::expected<URI, std::string> URI::from_file_path(std::string_view path) {
         uri.text.append(part);
     };
 
-    auto encode_authority_host = [](std::string_view host) {
+    // Segments are encoded straight into the URI text.
+    auto append_encoded = [&uri](std::string_view part, bool encode_slash, Segment& segment) {
+        segment.offset = uri.text.size();
+        append_percent_encoded(uri.text, part, encode_slash);
+        segment.size = uri.text.size() - segment.offset;
+    };
+
+    auto append_authority_host = [&uri](std::string_view host) {
+        uri.authority_segment.offset = uri.text.size();
         // Preserve IPv6 literal brackets in authority, e.g. "[::1]".
         if(host.size() >= 2 && host.front() == '[' && host.back() == ']') {
-            std::string encoded;
-            encoded.reserve(host.size());
-            encoded.push_back('[');
-            encoded += percent_encode_with_policy(host.substr(1, host.size() - 2), true);
-            encoded.push_back(']');
-            return encoded;
+            uri.text.push_back('[');
+            append_percent_encoded(uri.text, host.substr(1, host.size() - 2), true);
+            uri.text.push_back(']');
+        } else {
+            append_percent_encoded(uri.text, host, true);
         }
-        return percent_encode_with_policy(host, true);
+        uri.authority_segment.size = uri.text.size() - uri.authority_segment.offset;
     };
 
+    uri.text.reserve(normalized_path.size() + 8);
     append_segment("file", uri.scheme_segment);
     uri.text.push_back(':');
     uri.text.append("//");
@@ -312,11 +325,8 @@ std::expected<URI, std::string> URI::from_file_path(std::string_view path) {
         const std::string_view host = host_and_rest.substr(0, first_slash);
         const std::string_view share_and_path = host_and_rest.substr(first_slash);
 
-        const std::string encoded_authority = encode_authority_host(host);
-        const std::string encoded_path = percent_encode(share_and_path, false);
-
-        append_segment(encoded_authority, uri.authority_segment);
-        append_segment(encoded_path, uri.path_segment);
+        append_authority_host(host);
+        append_encoded(share_and_path, false, uri.path_segment);
         return uri;
     }
 
@@ -328,38 +338,55 @@ std::expected<URI, std::string> URI::from_file_path(std::string_view path) {
         normalized_storage.insert(normalized_storage.begin(), '/');
         normalized_path = normalized_storage;
     }
-    const std::string encoded_path = percent_encode(normalized_path, false);
 
     // Empty authority is still present in "file:///<path>" form.
     uri.authority_segment.offset = uri.text.size();
     uri.authority_segment.size = 0;
-    append_segment(encoded_path, uri.path_segment);
+    append_encoded(normalized_path, false, uri.path_segment);
 
     return uri;
 }
 
 std::string URI::percent_encode(std::string_view input, bool encode_slash) {
-    return percent_encode_with_policy(input, encode_slash);
+    std::string output;
+    append_percent_encoded(output, input, encode_slash);
+    return output;
+}
+
+void URI::percent_encode_to(std::string_view input, std::string& output, bool encode_slash) {
+    append_percent_encoded(output, input, encode_slash);
 }
 
 std::expected<std::string, std::string> URI::percent_decode(std::string_view input) {
     std::string output;
-    output.reserve(input.size());
+    KOTA_EXPECTED_TRY(percent_decode_to(input, output));
+    return output;
+}
+
+std::expected<void, std::string> URI::percent_decode_to(std::string_view input,
+                                                        std::string& output) {
+    const auto old_size = output.size();
+    // Decoding never grows the text.
+    output.reserve(old_size + input.size());
 
     for(std::size_t index = 0; index < input.size(); ++index) {
-        if(input[index] != '%') [[likely]] {
-            output.push_back(input[index]);
-            continue;
+        const auto escape = simd::find_byte(input, '%', index);
+        output.append(input.substr(index, escape - index));
+        if(escape == input.size()) {
+            break;
         }
+        index = escape;
 
         // Percent escape is exactly "%HH", so we need two chars after '%'.
         if(index + 2 >= input.size()) [[unlikely]] {
+            output.resize(old_size);
             return std::unexpected("invalid percent-encoding: truncated escape");
         }
 
         const int high = hex_value(input[index + 1]);
         const int low = hex_value(input[index + 2]);
         if(high < 0 || low < 0) [[unlikely]] {
+            output.resize(old_size);
             return std::unexpected("invalid percent-encoding: non-hex digit");
         }
 
@@ -368,7 +395,7 @@ std::expected<std::string, std::string> URI::percent_decode(std::string_view inp
         index += 2;
     }
 
-    return output;
+    return {};
 }
 
 std::string URI::str() const {
@@ -416,36 +443,32 @@ std::expected<std::string, std::string> URI::file_path() const {
         return std::unexpected("uri scheme is not file");
     }
 
-    auto decoded_path = percent_decode(path());
-    if(!decoded_path) [[unlikely]] {
-        return std::unexpected(decoded_path.error());
-    }
-
     const auto authority_view = authority();
-    if(has_authority() && !authority_view.empty() && !is_ascii_iequal(authority_view, "localhost"))
-        [[unlikely]] {
-        auto decoded_authority = percent_decode(authority_view);
-        if(!decoded_authority) [[unlikely]] {
-            return std::unexpected(decoded_authority.error());
-        }
+    if(has_authority() && !authority_view.empty() &&
+       !simd::iequals_ascii(authority_view, "localhost")) [[unlikely]] {
+        // Build UNC-style "//authority/path", decoding both in place.
+        std::string unc_path;
+        unc_path.reserve(2 + authority_view.size() + path().size());
+        unc_path += "//";
+        KOTA_EXPECTED_TRY(percent_decode_to(authority_view, unc_path));
 
         // A decoded authority must remain a single host token. If it contains
         // '/' or '\\', UNC host/path boundaries become ambiguous.
-        if(std::ranges::any_of(*decoded_authority, [](char value) {
+        if(std::ranges::any_of(std::string_view(unc_path).substr(2), [](char value) {
                return value == '/' || value == '\\';
            })) [[unlikely]] {
             return std::unexpected("file uri authority contains path separator");
         }
 
-        // Build UNC-style "//authority/path" with a single allocation.
-        std::string unc_path;
-        unc_path.reserve(2 + decoded_authority->size() + decoded_path->size());
-        unc_path += "//";
-        unc_path += *decoded_authority;
-        unc_path += *decoded_path;
+        KOTA_EXPECTED_TRY(percent_decode_to(path(), unc_path));
         return unc_path;
     }
 
+    auto decoded_path = percent_decode(path());
+    if(!decoded_path) [[unlikely]] {
+        return std::unexpected(decoded_path.error());
+    }
+
     // Local file URI path should be absolute.
     if(decoded_path->empty() || (*decoded_path)[0] != '/') [[unlikely]] {
         return std::unexpected("file uri local path must be absolute");
@@ -463,4 +486,56 @@ std::expected<std::string, std::string> URI::file_path() const {
     return *decoded_path;
 }
 
+std::expected<URITable::ID, std::string> URITable::intern(std::string_view text) {
+    if(auto it = uri_spellings.find(text); it != uri_spellings.end()) {
+        return it->second;
+    }
+
+    auto parsed = URI::parse(text);
+    if(!parsed) {
+        return std::unexpected(std::move(parsed.error()));
+    }
+    return add(text, std::move(*parsed), uri_spellings);
+}
+
+std::expected<URITable::ID, std::string> URITable::intern_file_path(std::string_view path) {
+    if(auto it = path_spellings.find(path); it != path_spellings.end()) {
+        return it->second;
+    }
+
+    auto built = URI::from_file_path(path);
+    if(!built) {
+        return std::unexpected(std::move(built.error()));
+    }
+    return add(path, std::move(*built), path_spellings);
+}
+
+std::optional<URITable::ID> URITable::find(std::string_view text) const {
+    if(auto it = uri_spellings.find(text); it != uri_spellings.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+const URI& URITable::uri(ID id) const {
+    assert(id < uris.size() && "unknown URI id");
+    return uris[id];
+}
+
+std::string_view URITable::str(ID id) const {
+    return uri(id).text;
+}
+
+URITable::ID URITable::add(std::string_view spelling, URI uri, spelling_map& spellings) {
+    // Another spelling of a URI already interned shares its id.
+    auto [it, inserted] = uri_spellings.try_emplace(uri.text, static_cast<ID>(uris.size()));
+    if(inserted) {
+        uris.push_back(std::move(uri));
+    }
+
+    const auto id = it->second;
+    spellings.try_emplace(std::string(spelling), id);
+    return id;
+}
+
 }  // namespace kota::ipc::lsp
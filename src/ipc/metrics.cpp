@@ -0,0 +1,190 @@
+#include "kota/ipc/metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <iterator>
+
+namespace kota::ipc {
+
+namespace {
+
+/// Method names come from the wire; Prometheus label values escape these.
+std::string escape_label(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for(char c: value) {
+        switch(c) {
+            case '\\': out.append(R"(\\)"); break;
+            case '"': out.append(R"(\")"); break;
+            case '\n': out.append(R"(\n)"); break;
+            default: out.push_back(c); break;
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+std::size_t Histogram::bucket_of(std::uint64_t value) noexcept {
+    if(value < sub_buckets) {
+        return static_cast<std::size_t>(value);
+    }
+    // The top bit picks the power of two, the next `sub_bits` the bucket
+    // within it.
+    const auto exponent = static_cast<std::size_t>(std::bit_width(value)) - 1;
+    const auto shift = exponent - sub_bits;
+    const auto sub = static_cast<std::size_t>(value >> shift) & (sub_buckets - 1);
+    return sub_buckets * (shift + 1) + sub;
+}
+
+std::uint64_t Histogram::bucket_upper(std::size_t bucket) noexcept {
+    if(bucket < sub_buckets) {
+        return bucket;
+    }
+    const auto shift = bucket / sub_buckets - 1;
+    const auto sub = bucket % sub_buckets;
+    const auto lower = static_cast<std::uint64_t>(sub_buckets + sub) << shift;
+    return lower + ((std::uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(std::uint64_t value) noexcept {
+    counts[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    total_sum.fetch_add(value, std::memory_order_relaxed);
+    auto current = maximum.load(std::memory_order_relaxed);
+    while(value > current &&
+          !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+std::uint64_t Histogram::percentile(double quantile) const noexcept {
+    const auto recorded = count();
+    if(recorded == 0) {
+        return 0;
+    }
+
+    const auto wanted = std::clamp<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(recorded))),
+        1,
+        recorded);
+    std::uint64_t seen = 0;
+    for(std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        seen += counts[bucket].load(std::memory_order_relaxed);
+        if(seen >= wanted) {
+            return (std::min)(bucket_upper(bucket), max());
+        }
+    }
+    // Counts recorded after `total` was read.
+    return max();
+}
+
+void Histogram::reset() noexcept {
+    for(auto& slot: counts) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+MethodMetrics& PeerMetrics::method(std::string_view method) {
+    std::lock_guard guard(lock);
+    auto it = entries.find(method);
+    if(it == entries.end()) {
+        it = entries.emplace(std::string(method), std::make_unique<MethodMetrics>()).first;
+    }
+    return *it->second;
+}
+
+const MethodMetrics* PeerMetrics::find(std::string_view method) const {
+    std::lock_guard guard(lock);
+    auto it = entries.find(method);
+    return it == entries.end() ? nullptr : it->second.get();
+}
+
+std::vector<std::string> PeerMetrics::methods() const {
+    std::lock_guard guard(lock);
+    std::vector<std::string> names;
+    names.reserve(entries.size());
+    for(const auto& [name, entry]: entries) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+std::string PeerMetrics::to_prometheus(std::string_view prefix) const {
+    std::lock_guard guard(lock);
+    std::string out;
+    auto sink = std::back_inserter(out);
+
+    auto header = [&](std::string_view name, std::string_view help, std::string_view type) {
+        std::format_to(sink, "# HELP {0}_{1} {2}\n# TYPE {0}_{1} {3}\n", prefix, name, help, type);
+    };
+
+    auto counter = [&](std::string_view name, std::string_view help, auto field) {
+        header(name, help, "counter");
+        for(const auto& [method, entry]: entries) {
+            std::format_to(sink,
+                           "{}_{}{{method=\"{}\"}} {}\n",
+                           prefix,
+                           name,
+                           escape_label(method),
+                           (entry.get()->*field).load(std::memory_order_relaxed));
+        }
+    };
+
+    // `scale` converts the recorded unit to the exported one.
+    auto summary = [&](std::string_view name, std::string_view help, auto field, double scale) {
+        header(name, help, "summary");
+        for(const auto& [method, entry]: entries) {
+            const auto& histogram = entry.get()->*field;
+            const auto label = escape_label(method);
+            for(double quantile: {0.5, 0.9, 0.99}) {
+                std::format_to(sink,
+                               "{}_{}{{method=\"{}\",quantile=\"{}\"}} {}\n",
+                               prefix,
+                               name,
+                               label,
+                               quantile,
+                               static_cast<double>(histogram.percentile(quantile)) * scale);
+            }
+            std::format_to(sink,
+                           "{}_{}_sum{{method=\"{}\"}} {}\n",
+                           prefix,
+                           name,
+                           label,
+                           static_cast<double>(histogram.sum()) * scale);
+            std::format_to(sink,
+                           "{}_{}_count{{method=\"{}\"}} {}\n",
+                           prefix,
+                           name,
+                           label,
+                           histogram.count());
+        }
+    };
+
+    counter("requests_total", "Incoming requests.", &MethodMetrics::requests);
+    counter("notifications_total", "Incoming notifications.", &MethodMetrics::notifications);
+    counter("errors_total", "Requests answered with an error.", &MethodMetrics::errors);
+    counter("cancelled_total", "Requests cancelled before answering.", &MethodMetrics::cancelled);
+
+    header("in_flight", "Requests not answered yet.", "gauge");
+    for(const auto& [method, entry]: entries) {
+        std::format_to(sink,
+                       "{}_in_flight{{method=\"{}\"}} {}\n",
+                       prefix,
+                       escape_label(method),
+                       entry->in_flight.load(std::memory_order_relaxed));
+    }
+
+    constexpr double ns = 1e-9;
+    summary("decode_seconds", "Time decoding incoming messages.", &MethodMetrics::decode_ns, ns);
+    summary("handler_seconds", "Time running handlers.", &MethodMetrics::handler_ns, ns);
+    summary("encode_seconds", "Time encoding responses.", &MethodMetrics::encode_ns, ns);
+    summary("request_bytes", "Incoming message sizes.", &MethodMetrics::request_bytes, 1.0);
+    summary("response_bytes", "Response sizes.", &MethodMetrics::response_bytes, 1.0);
+    return out;
+}
+
+}  // namespace kota::ipc
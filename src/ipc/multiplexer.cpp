@@ -0,0 +1,261 @@
+#include "kota/ipc/multiplexer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace kota::ipc {
+
+namespace {
+
+enum class frame_kind : char {
+    /// A message of the channel.
+    data = 0,
+
+    /// The reader took this many messages; the body is a 4-byte count.
+    credit = 1,
+
+    /// The channel's output is closed.
+    end = 2,
+};
+
+constexpr std::size_t header_size = 5;
+
+void append_u32(std::string& out, std::uint32_t value) {
+    for(int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+std::uint32_t read_u32(std::string_view bytes) {
+    std::uint32_t value = 0;
+    for(int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+
+std::string frame_of(frame_kind kind, std::uint32_t id, std::string_view body = {}) {
+    std::string frame;
+    frame.reserve(header_size + body.size());
+    frame.push_back(static_cast<char>(kind));
+    append_u32(frame, id);
+    frame.append(body);
+    return frame;
+}
+
+}  // namespace
+
+struct Multiplexer::ChannelState {
+    explicit ChannelState(std::uint32_t window) :
+        incoming(window), credit(static_cast<std::ptrdiff_t>(window)) {}
+
+    /// Messages received and not read yet; never more than the window.
+    channel<std::string> incoming;
+
+    /// Messages this side may still send before the other grants more.
+    semaphore credit;
+
+    /// Messages read since credit was last granted for them.
+    std::uint32_t consumed = 0;
+
+    bool opened = false;
+    bool output_closed = false;
+};
+
+class Multiplexer::Channel final : public Transport {
+public:
+    Channel(Multiplexer& owner, std::uint32_t id, ChannelState& state) :
+        owner(owner), id(id), state(state) {}
+
+    ~Channel() override {
+        (void)close_output();
+        owner.release(id);
+    }
+
+    task<std::optional<std::string>> read_message() override {
+        auto message = co_await state.incoming.recv();
+        if(!message) {
+            co_return std::nullopt;
+        }
+
+        // Credit goes back in batches of half a window, not per message.
+        state.consumed += 1;
+        if(state.consumed >= (std::max)(owner.opts.window / 2, std::uint32_t(1))) {
+            std::string count;
+            append_u32(count, std::exchange(state.consumed, 0));
+            owner.enqueue(frame_of(frame_kind::credit, id, count));
+        }
+        co_return message;
+    }
+
+    task<void, Error> write_message(std::string_view payload) override {
+        co_await write_messages(std::span<const std::string_view>(&payload, 1)).or_fail();
+    }
+
+    task<void, Error> write_messages(std::span<const std::string_view> payloads) override {
+        for(auto payload: payloads) {
+            if(!state.credit.try_acquire()) {
+                co_await state.credit.acquire();
+            }
+            if(owner.failure) {
+                co_await fail(*owner.failure);
+            }
+            if(state.output_closed) {
+                co_await fail("channel output is closed");
+            }
+            owner.enqueue(frame_of(frame_kind::data, id, payload));
+        }
+    }
+
+    Result<void> close_output() override {
+        if(!state.output_closed) {
+            state.output_closed = true;
+            owner.enqueue(frame_of(frame_kind::end, id));
+        }
+        return {};
+    }
+
+    Result<void> close() override {
+        (void)close_output();
+        state.incoming.close();
+        return {};
+    }
+
+private:
+    Multiplexer& owner;
+    std::uint32_t id;
+    ChannelState& state;
+};
+
+Multiplexer::Multiplexer(event_loop& loop, std::unique_ptr<Transport> transport, options opts) :
+    loop(loop), inner(std::move(transport)), opts(opts) {
+    assert(inner && "Multiplexer requires a non-null inner transport");
+    assert(opts.window > 0 && "Multiplexer window must be positive");
+}
+
+Multiplexer::~Multiplexer() = default;
+
+Result<std::unique_ptr<Transport>> Multiplexer::open(std::uint32_t id) {
+    auto& state = state_of(id);
+    if(state.opened) {
+        return outcome_error(Error("channel is already open"));
+    }
+    state.opened = true;
+    return std::unique_ptr<Transport>(std::make_unique<Channel>(*this, id, state));
+}
+
+task<> Multiplexer::run() {
+    while(auto message = co_await inner->read_message()) {
+        if(message->size() < header_size) {
+            break;
+        }
+
+        const auto kind = static_cast<frame_kind>((*message)[0]);
+        const auto id = read_u32(std::string_view(*message).substr(1));
+        auto& state = state_of(id);
+
+        // Handing a message over may resume its reader at once, which may
+        // destroy the channel; `state` is not touched after that.
+        if(kind == frame_kind::data) {
+            if(state.incoming.is_closed()) {
+                // Nobody reads this channel here any more: drop the message
+                // and give its credit back, so the sender is not stalled.
+                std::string count;
+                append_u32(count, 1);
+                enqueue(frame_of(frame_kind::credit, id, count));
+                continue;
+            }
+            message->erase(0, header_size);
+            if(!state.incoming.try_send(std::move(*message))) {
+                // The sender overran the window it was granted.
+                break;
+            }
+        } else if(kind == frame_kind::credit && message->size() == header_size + 4) {
+            state.credit.release(read_u32(std::string_view(*message).substr(header_size)));
+        } else if(kind == frame_kind::end) {
+            state.incoming.close();
+        } else {
+            break;
+        }
+    }
+
+    if(!failure) {
+        shut_down(Error("multiplexed transport is closed"));
+    }
+}
+
+Result<void> Multiplexer::close() {
+    return inner->close();
+}
+
+auto Multiplexer::state_of(std::uint32_t id) -> ChannelState& {
+    auto& state = channels[id];
+    if(!state) {
+        state = std::make_unique<ChannelState>(opts.window);
+    }
+    return *state;
+}
+
+void Multiplexer::enqueue(std::string frame) {
+    if(failure) {
+        return;
+    }
+    outgoing.push_back(std::move(frame));
+    if(!writer_running) {
+        writer_running = true;
+        loop.schedule(write_loop());
+    }
+}
+
+task<> Multiplexer::write_loop() {
+    std::vector<std::string> batch;
+    std::vector<std::string_view> payloads;
+    while(!outgoing.empty() && !failure) {
+        // Everything queued so far, from every channel, goes out in one
+        // write; frames queued while it is in flight form the next batch.
+        batch.swap(outgoing);
+        payloads.assign(batch.begin(), batch.end());
+
+        auto written = co_await inner->write_messages(payloads);
+
+        payloads.clear();
+        batch.clear();
+
+        if(!written) {
+            shut_down(written.error());
+            break;
+        }
+    }
+
+    writer_running = false;
+}
+
+void Multiplexer::shut_down(Error error) {
+    failure = std::move(error);
+    outgoing.clear();
+
+    // Waking a channel's reader or writer may destroy the channel and so
+    // its entry; look each one up again.
+    std::vector<std::uint32_t> ids;
+    ids.reserve(channels.size());
+    for(auto& [id, state]: channels) {
+        ids.push_back(id);
+    }
+    for(auto id: ids) {
+        if(auto it = channels.find(id); it != channels.end()) {
+            it->second->incoming.close();
+        }
+        if(auto it = channels.find(id); it != channels.end()) {
+            it->second->credit.release((std::numeric_limits<std::ptrdiff_t>::max)() / 2);
+        }
+    }
+}
+
+void Multiplexer::release(std::uint32_t id) noexcept {
+    channels.erase(id);
+}
+
+}  // namespace kota::ipc
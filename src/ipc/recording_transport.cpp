@@ -1,22 +1,40 @@
 #include "kota/ipc/recording_transport.h"
 
+#include <algorithm>
 #include <cassert>
 #include <format>
 #include <utility>
 
+#include "kota/codec/json/escape.h"
+
 namespace kota::ipc {
 
-RecordingTransport::RecordingTransport(std::unique_ptr<Transport> transport, std::string path) :
+namespace {
+
+void append_record(std::string& out, std::chrono::milliseconds time, std::string_view payload) {
+    out.append(std::format(R"({{"ts":{},"msg":")", time.count()));
+    codec::json::escape_string(payload, [&](std::string_view part) { out.append(part); });
+    out.append("\"}\n");
+}
+
+}  // namespace
+
+RecordingTransport::RecordingTransport(std::unique_ptr<Transport> transport,
+                                       std::string path,
+                                       options opts) :
     inner(std::move(transport)), file(std::fopen(path.c_str(), "wb")),
-    start(std::chrono::steady_clock::now()) {
+    start(std::chrono::steady_clock::now()), buffer_size(opts.buffer_size),
+    capacity(std::max<std::size_t>(opts.queue_capacity, 1)) {
     assert(inner && "RecordingTransport requires a non-null inner transport");
     // If fopen fails, keep transport functional; write_record() no-ops on null file.
+    if(file) {
+        slots = std::make_unique<Entry[]>(capacity);
+        writer = std::thread([this] { run_writer(); });
+    }
 }
 
 RecordingTransport::~RecordingTransport() {
-    if(file) {
-        std::fclose(file);
-    }
+    finish();
 }
 
 task<std::optional<std::string>> RecordingTransport::read_message() {
@@ -31,49 +49,112 @@ task<void, Error> RecordingTransport::write_message(std::string_view payload) {
     co_await inner->write_message(payload);
 }
 
+task<void, Error> RecordingTransport::write_messages(std::span<const std::string_view> payloads) {
+    co_await inner->write_messages(payloads).or_fail();
+}
+
+void RecordingTransport::cork() {
+    inner->cork();
+}
+
+task<void, Error> RecordingTransport::uncork() {
+    co_await inner->uncork();
+}
+
 Result<void> RecordingTransport::close_output() {
     return inner->close_output();
 }
 
 Result<void> RecordingTransport::close() {
-    if(file) {
-        std::fclose(file);
-        file = nullptr;
-    }
+    finish();
     return inner->close();
 }
 
 void RecordingTransport::write_record(std::string_view payload) {
-    if(!file) {
+    if(!writer.joinable()) {
         return;
     }
+
+    const auto t = tail.load(std::memory_order_relaxed);
+    if(t - head.load(std::memory_order_acquire) >= capacity) {
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& entry = slots[t % capacity];
     auto elapsed = std::chrono::steady_clock::now() - start;
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-
-    std::string line;
-    line.reserve(payload.size() + 64);
-    line.append(std::format(R"({{"ts":{},"msg":")", ms));
-    for(unsigned char uc: payload) {
-        switch(uc) {
-            case '"': line.append(R"(\")"); break;
-            case '\\': line.append(R"(\\)"); break;
-            case '\b': line.append(R"(\b)"); break;
-            case '\f': line.append(R"(\f)"); break;
-            case '\n': line.append(R"(\n)"); break;
-            case '\r': line.append(R"(\r)"); break;
-            case '\t': line.append(R"(\t)"); break;
-            default:
-                if(uc < 0x20) {
-                    line.append(std::format("\\u{:04X}", uc));
-                } else {
-                    line.push_back(static_cast<char>(uc));
-                }
+    entry.time = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    entry.message.assign(payload);
+    tail.store(t + 1, std::memory_order_seq_cst);
+
+    if(sleeping.load(std::memory_order_seq_cst) && sleeping.exchange(false)) {
+        doorbell.fetch_add(1, std::memory_order_release);
+        doorbell.notify_one();
+    }
+}
+
+void RecordingTransport::run_writer() {
+    std::string buffer;
+    buffer.reserve(buffer_size + 4096);
+
+    auto flush = [&] {
+        if(file && !buffer.empty()) {
+            auto written = std::fwrite(buffer.data(), 1, buffer.size(), file);
+            if(written != buffer.size() || std::fflush(file) != 0) {
+                std::fclose(file);
+                file = nullptr;
+            }
+        }
+        buffer.clear();
+    };
+
+    auto h = head.load(std::memory_order_relaxed);
+    while(true) {
+        const auto t = tail.load(std::memory_order_acquire);
+        if(h == t) {
+            // Idle: hand what was gathered to the OS before sleeping, so the
+            // trace stays current when messages are sparse.
+            flush();
+            if(stopping.load(std::memory_order_acquire)) {
                 break;
+            }
+
+            const auto seen = doorbell.load(std::memory_order_acquire);
+            sleeping.store(true, std::memory_order_seq_cst);
+            if(tail.load(std::memory_order_seq_cst) == h &&
+               !stopping.load(std::memory_order_seq_cst)) {
+                doorbell.wait(seen, std::memory_order_acquire);
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        for(; h != t; ++h) {
+            auto& entry = slots[h % capacity];
+            if(file) {
+                append_record(buffer, entry.time, entry.message);
+            }
+            // The slot's capacity is kept for the next message, unless it
+            // held an unusually large one.
+            if(entry.message.capacity() > 64 * 1024) {
+                std::string().swap(entry.message);
+            }
+            head.store(h + 1, std::memory_order_release);
+            if(buffer.size() >= buffer_size) {
+                flush();
+            }
         }
     }
-    line.append("\"}\n");
-    auto written = std::fwrite(line.data(), 1, line.size(), file);
-    if(written != line.size() || std::fflush(file) != 0) {
+}
+
+void RecordingTransport::finish() {
+    if(writer.joinable()) {
+        stopping.store(true, std::memory_order_seq_cst);
+        doorbell.fetch_add(1, std::memory_order_release);
+        doorbell.notify_one();
+        writer.join();
+    }
+    if(file) {
         std::fclose(file);
         file = nullptr;
     }
@@ -0,0 +1,218 @@
+#include "kota/ipc/replay_transport.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <utility>
+
+namespace kota::ipc {
+
+namespace {
+
+void append_utf8(std::string& out, std::uint32_t code_point) {
+    if(code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if(code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if(code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+std::optional<std::uint32_t> parse_hex4(std::string_view text, std::size_t at) {
+    if(at + 4 > text.size()) {
+        return std::nullopt;
+    }
+    std::uint32_t value = 0;
+    auto [ptr, err] = std::from_chars(text.data() + at, text.data() + at + 4, value, 16);
+    if(err != std::errc() || ptr != text.data() + at + 4) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// Decodes the JSON string body starting at `pos`, up to and past its
+/// closing quote. Bytes RecordingTransport writes unescaped (all but quotes,
+/// backslashes and control characters) are copied as they are.
+std::optional<std::string> decode_string(std::string_view text, std::size_t& pos) {
+    std::string out;
+    while(pos < text.size()) {
+        const char c = text[pos++];
+        if(c == '"') {
+            return out;
+        }
+        if(c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+
+        if(pos >= text.size()) {
+            return std::nullopt;
+        }
+        switch(text[pos++]) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                auto unit = parse_hex4(text, pos);
+                if(!unit) {
+                    return std::nullopt;
+                }
+                pos += 4;
+
+                std::uint32_t code_point = *unit;
+                // A surrogate pair spells one code point past the BMP.
+                if(code_point >= 0xD800 && code_point < 0xDC00 && text.substr(pos, 2) == "\\u") {
+                    auto low = parse_hex4(text, pos + 2);
+                    if(low && *low >= 0xDC00 && *low < 0xE000) {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (*low - 0xDC00);
+                        pos += 6;
+                    }
+                }
+                append_utf8(out, code_point);
+                break;
+            }
+            default: return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+/// Parses one line written by RecordingTransport:
+/// {"ts":<ms_since_start>,"msg":"<escaped_json>"}
+std::optional<ReplayTransport::Record> parse_record(std::string_view line) {
+    constexpr std::string_view ts_key = R"({"ts":)";
+    constexpr std::string_view msg_key = R"(,"msg":")";
+
+    if(!line.starts_with(ts_key)) {
+        return std::nullopt;
+    }
+    std::size_t pos = ts_key.size();
+
+    std::int64_t ms = 0;
+    auto [ptr, err] = std::from_chars(line.data() + pos, line.data() + line.size(), ms);
+    if(err != std::errc() || ms < 0) {
+        return std::nullopt;
+    }
+    pos = static_cast<std::size_t>(ptr - line.data());
+
+    if(line.substr(pos, msg_key.size()) != msg_key) {
+        return std::nullopt;
+    }
+    pos += msg_key.size();
+
+    auto message = decode_string(line, pos);
+    if(!message || line.substr(pos) != "}") {
+        return std::nullopt;
+    }
+    return ReplayTransport::Record{std::chrono::milliseconds(ms), std::move(*message)};
+}
+
+}  // namespace
+
+ReplayTransport::ReplayTransport(std::vector<Record> records, options opts) :
+    records(std::move(records)), opts(opts) {}
+
+Result<std::vector<ReplayTransport::Record>> ReplayTransport::load(const std::string& path) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "rb"),
+                                                         &std::fclose);
+    if(!file) {
+        return outcome_error(Error(std::format("cannot open trace {}", path)));
+    }
+
+    std::string content;
+    char buffer[64 * 1024];
+    while(auto n = std::fread(buffer, 1, sizeof(buffer), file.get())) {
+        content.append(buffer, n);
+    }
+    if(std::ferror(file.get())) {
+        return outcome_error(Error(std::format("cannot read trace {}", path)));
+    }
+
+    std::vector<Record> records;
+    std::size_t line_number = 0;
+    for(std::size_t begin = 0; begin < content.size();) {
+        auto end = content.find('\n', begin);
+        if(end == std::string::npos) {
+            end = content.size();
+        }
+        std::string_view line(content.data() + begin, end - begin);
+        begin = end + 1;
+        ++line_number;
+
+        if(line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        if(line.empty()) {
+            continue;
+        }
+
+        auto record = parse_record(line);
+        if(!record) {
+            return outcome_error(
+                Error(std::format("malformed record at {}:{}", path, line_number)));
+        }
+        records.push_back(std::move(*record));
+    }
+    return records;
+}
+
+task<std::optional<std::string>> ReplayTransport::read_message() {
+    if(closed || next >= records.size()) {
+        co_return std::nullopt;
+    }
+
+    if(opts.real_time) {
+        auto now = std::chrono::steady_clock::now();
+        if(!start) {
+            start = now - records[next].time;
+        }
+        auto due = *start + records[next].time;
+        if(due > now) {
+            auto delay = std::chrono::ceil<std::chrono::milliseconds>(due - now);
+            co_await with_token(after(delay), stop.token());
+            if(closed) {
+                co_return std::nullopt;
+            }
+        }
+    }
+
+    auto message = std::move(records[next++].message);
+    if(read_hook) {
+        read_hook(message);
+    }
+    co_return message;
+}
+
+task<void, Error> ReplayTransport::write_message(std::string_view payload) {
+    if(closed) {
+        co_await fail("transport is closed");
+    }
+    if(write_hook) {
+        write_hook(payload);
+    }
+    co_return;
+}
+
+Result<void> ReplayTransport::close() {
+    closed = true;
+    stop.cancel();
+    return {};
+}
+
+}  // namespace kota::ipc
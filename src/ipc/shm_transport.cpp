@@ -0,0 +1,404 @@
+#include "kota/ipc/shm_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kota::ipc {
+
+namespace {
+
+constexpr std::uint32_t region_magic = 0x6b6f7461;
+constexpr std::uint32_t region_version = 1;
+constexpr std::size_t frame_header_size = 4;
+constexpr std::size_t max_payload_bytes = 64 * 1024 * 1024;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared rings need address-free 64-bit atomics");
+
+/// Keeps the producer and consumer cursors of a ring on separate cache
+/// lines, so the two processes do not bounce one line between them.
+struct alignas(64) ring_cursor {
+    std::atomic<std::uint64_t> value{0};
+};
+
+struct ring_state {
+    /// Bytes ever written; advanced by the producer only.
+    ring_cursor head;
+
+    /// Bytes ever read; advanced by the consumer only.
+    ring_cursor tail;
+};
+
+Error system_error_text(int code) {
+    return Error(std::generic_category().message(code));
+}
+
+}  // namespace
+
+/// Header at the start of the mapping, followed by the bytes of rings[0]
+/// and then rings[1], `capacity` each. Side i produces into rings[i].
+struct SharedMemoryTransport::Region {
+    std::uint32_t magic = region_magic;
+    std::uint32_t version = region_version;
+    std::uint64_t capacity = 0;
+
+    /// Set by a side before it sleeps on its doorbell; whoever clears it
+    /// owes that side a ring.
+    alignas(64) std::atomic<std::uint32_t> sleeping[2] = {};
+
+    /// Set once a side writes no more, and once it reads no more.
+    std::atomic<std::uint32_t> output_closed[2] = {};
+    std::atomic<std::uint32_t> input_closed[2] = {};
+
+    ring_state rings[2];
+
+    char* data(int ring) noexcept {
+        return reinterpret_cast<char*>(this + 1) + static_cast<std::size_t>(ring) * capacity;
+    }
+};
+
+SharedMemoryTransport::SharedMemoryTransport(std::string name,
+                                             Region* region,
+                                             std::size_t mapping_size,
+                                             int side,
+                                             stream doorbell_in,
+                                             stream doorbell_out) :
+    region_name(std::move(name)), region(region), mapping_size(mapping_size), side(side),
+    doorbell_in(std::move(doorbell_in)), doorbell_out(std::move(doorbell_out)) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+#ifndef _WIN32
+    if(region != nullptr) {
+        region->output_closed[side].store(1);
+        region->input_closed[side].store(1);
+        ring_peer_now();
+        ::munmap(region, mapping_size);
+    }
+    if(side == 0 && !region_name.empty()) {
+        ::shm_unlink(region_name.c_str());
+    }
+#endif
+}
+
+Result<std::unique_ptr<SharedMemoryTransport>>
+    SharedMemoryTransport::create(stream doorbell_in, stream doorbell_out, std::size_t capacity) {
+#ifdef _WIN32
+    return outcome_error(Error("shared memory transport is not supported on this platform"));
+#else
+    if(capacity < frame_header_size) {
+        return outcome_error(Error("shared memory ring capacity is too small"));
+    }
+
+    static std::atomic<unsigned> counter{0};
+    std::string name = "/kota-ipc-" + std::to_string(::getpid()) + "-" +
+                       std::to_string(counter.fetch_add(1));
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0) {
+        return outcome_error(system_error_text(errno));
+    }
+
+    const auto size = sizeof(Region) + 2 * capacity;
+    if(::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        auto err = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return outcome_error(system_error_text(err));
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto err = errno;
+    ::close(fd);
+    if(mapping == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return outcome_error(system_error_text(err));
+    }
+
+    auto* region = new(mapping) Region();
+    region->capacity = capacity;
+
+    auto* transport = new SharedMemoryTransport(std::move(name),
+                                                region,
+                                                size,
+                                                0,
+                                                std::move(doorbell_in),
+                                                std::move(doorbell_out));
+    return std::unique_ptr<SharedMemoryTransport>(transport);
+#endif
+}
+
+Result<std::unique_ptr<SharedMemoryTransport>>
+    SharedMemoryTransport::open(std::string_view name, stream doorbell_in, stream doorbell_out) {
+#ifdef _WIN32
+    return outcome_error(Error("shared memory transport is not supported on this platform"));
+#else
+    std::string region_name(name);
+    int fd = ::shm_open(region_name.c_str(), O_RDWR, 0);
+    if(fd < 0) {
+        return outcome_error(system_error_text(errno));
+    }
+
+    struct stat st{};
+    if(::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Region)) {
+        ::close(fd);
+        return outcome_error(Error("shared memory region is truncated"));
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto err = errno;
+    ::close(fd);
+    if(mapping == MAP_FAILED) {
+        return outcome_error(system_error_text(err));
+    }
+
+    auto* region = static_cast<Region*>(mapping);
+    if(region->magic != region_magic || region->version != region_version ||
+       sizeof(Region) + 2 * region->capacity != size) {
+        ::munmap(mapping, size);
+        return outcome_error(Error("shared memory region has an unknown layout"));
+    }
+
+    // The peer keeps the name; only the creator removes it.
+    auto* transport = new SharedMemoryTransport(std::move(region_name),
+                                                region,
+                                                size,
+                                                1,
+                                                std::move(doorbell_in),
+                                                std::move(doorbell_out));
+    return std::unique_ptr<SharedMemoryTransport>(transport);
+#endif
+}
+
+std::size_t SharedMemoryTransport::push(std::span<const char> src) noexcept {
+    auto& ring = region->rings[side];
+    const auto capacity = region->capacity;
+    const auto head = ring.head.value.load(std::memory_order_relaxed);
+    const auto tail = ring.tail.value.load(std::memory_order_acquire);
+
+    const auto n = std::min<std::uint64_t>(src.size(), capacity - (head - tail));
+    const auto at = head % capacity;
+    const auto first = std::min<std::uint64_t>(n, capacity - at);
+    auto* data = region->data(side);
+    std::memcpy(data + at, src.data(), first);
+    std::memcpy(data, src.data() + first, n - first);
+
+    ring.head.value.store(head + n, std::memory_order_seq_cst);
+    return n;
+}
+
+std::size_t SharedMemoryTransport::pull(std::span<char> dst) noexcept {
+    const int peer = 1 - side;
+    auto& ring = region->rings[peer];
+    const auto capacity = region->capacity;
+    const auto tail = ring.tail.value.load(std::memory_order_relaxed);
+    const auto head = ring.head.value.load(std::memory_order_acquire);
+
+    const auto n = std::min<std::uint64_t>(dst.size(), head - tail);
+    const auto at = tail % capacity;
+    const auto first = std::min<std::uint64_t>(n, capacity - at);
+    const auto* data = region->data(peer);
+    std::memcpy(dst.data(), data + at, first);
+    std::memcpy(dst.data() + first, data, n - first);
+
+    ring.tail.value.store(tail + n, std::memory_order_seq_cst);
+    return n;
+}
+
+task<bool> SharedMemoryTransport::wait_doorbell() {
+    if(pumping) {
+        auto current = tick;
+        co_await current->wait();
+        co_return !doorbell_closed;
+    }
+
+    // Wakes the other waiters even if this one is cancelled mid-read.
+    struct pump_guard {
+        SharedMemoryTransport* self;
+        std::shared_ptr<event> current;
+
+        ~pump_guard() {
+            self->pumping = false;
+            self->tick = std::make_shared<event>();
+            current->set();
+        }
+    };
+
+    pumping = true;
+    pump_guard guard{this, tick};
+    auto chunk = co_await doorbell_in.read_chunk();
+    if(chunk) {
+        doorbell_in.consume(chunk->size());
+    } else {
+        doorbell_closed = true;
+    }
+    co_return !doorbell_closed;
+}
+
+task<bool> SharedMemoryTransport::ring_peer() {
+    if(region->sleeping[1 - side].exchange(0, std::memory_order_seq_cst) == 0) {
+        co_return true;
+    }
+
+    constexpr static char bell = 1;
+    auto status = co_await doorbell_out.write(std::span<const char>(&bell, 1));
+    co_return !status.has_error();
+}
+
+void SharedMemoryTransport::ring_peer_now() noexcept {
+    if(region->sleeping[1 - side].exchange(0, std::memory_order_seq_cst) == 0) {
+        return;
+    }
+
+    constexpr static char bell = 1;
+    (void)doorbell_out.try_write(std::span<const char>(&bell, 1));
+}
+
+task<bool> SharedMemoryTransport::read_exact(std::span<char> dst) {
+    const int peer = 1 - side;
+    auto& ring = region->rings[peer];
+    std::size_t filled = 0;
+    while(filled < dst.size()) {
+        if(auto n = pull(dst.subspan(filled)); n != 0) {
+            filled += n;
+            // The peer may be waiting for the space just freed.
+            if(!co_await ring_peer()) {
+                co_return false;
+            }
+            continue;
+        }
+
+        region->sleeping[side].store(1, std::memory_order_seq_cst);
+        const auto tail = ring.tail.value.load(std::memory_order_relaxed);
+        if(ring.head.value.load(std::memory_order_seq_cst) != tail) {
+            continue;
+        }
+        if(region->output_closed[peer].load() != 0 || !co_await wait_doorbell()) {
+            // Bytes written before the peer closed are still delivered.
+            if(ring.head.value.load(std::memory_order_acquire) == tail) {
+                co_return false;
+            }
+        }
+    }
+    co_return true;
+}
+
+task<bool> SharedMemoryTransport::write_exact(std::span<const char> src) {
+    const int peer = 1 - side;
+    auto& ring = region->rings[side];
+    const auto capacity = region->capacity;
+    std::size_t written = 0;
+    while(written < src.size()) {
+        if(region->input_closed[peer].load() != 0) {
+            co_return false;
+        }
+
+        if(auto n = push(src.subspan(written)); n != 0) {
+            written += n;
+            if(!co_await ring_peer()) {
+                co_return false;
+            }
+            continue;
+        }
+
+        region->sleeping[side].store(1, std::memory_order_seq_cst);
+        const auto head = ring.head.value.load(std::memory_order_relaxed);
+        if(head - ring.tail.value.load(std::memory_order_seq_cst) != capacity) {
+            continue;
+        }
+        if(!co_await wait_doorbell()) {
+            co_return false;
+        }
+    }
+    co_return true;
+}
+
+task<std::optional<std::string>> SharedMemoryTransport::read_message() {
+    if(region == nullptr) {
+        co_return std::nullopt;
+    }
+
+    std::array<char, frame_header_size> header{};
+    if(!co_await read_exact(header)) {
+        co_return std::nullopt;
+    }
+
+    std::size_t length = 0;
+    for(std::size_t i = 0; i < frame_header_size; ++i) {
+        length |= static_cast<std::size_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+    }
+    if(length > max_payload_bytes) [[unlikely]] {
+        co_return std::nullopt;
+    }
+
+    std::string payload;
+    payload.resize(length);
+    if(!co_await read_exact(payload)) {
+        co_return std::nullopt;
+    }
+    co_return payload;
+}
+
+task<void, Error> SharedMemoryTransport::write_message(std::string_view payload) {
+    if(region == nullptr || region->output_closed[side].load() != 0) {
+        co_await fail(Error("transport is closed"));
+    }
+    if(payload.size() > max_payload_bytes) {
+        co_await fail(Error("payload is too large"));
+    }
+
+    std::array<char, frame_header_size> header{};
+    for(std::size_t i = 0; i < frame_header_size; ++i) {
+        header[i] = static_cast<char>((payload.size() >> (8 * i)) & 0xff);
+    }
+
+    // Frames of concurrent writers must not interleave in the ring.
+    co_await write_lock.lock();
+    struct unlock_guard {
+        mutex& lock;
+
+        ~unlock_guard() {
+            lock.unlock();
+        }
+    } unlock{write_lock};
+
+    if(!co_await write_exact(header) || !co_await write_exact(payload)) {
+        co_await fail(Error("peer closed the transport"));
+    }
+}
+
+Result<void> SharedMemoryTransport::close_output() {
+    if(region != nullptr) {
+        region->output_closed[side].store(1);
+        ring_peer_now();
+    }
+    return {};
+}
+
+Result<void> SharedMemoryTransport::close() {
+    if(region != nullptr) {
+        region->output_closed[side].store(1);
+        region->input_closed[side].store(1);
+        ring_peer_now();
+    }
+    doorbell_in.stop();
+    doorbell_in = stream{};
+    doorbell_out = stream{};
+    return {};
+}
+
+}  // namespace kota::ipc
@@ -1,13 +1,15 @@
 #include "kota/ipc/transport.h"
 
-#include <algorithm>
-#include <cctype>
 #include <limits>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
+
+#include "framing.h"
+#include "kota/support/simd.h"
 
 namespace kota::ipc {
 
@@ -27,18 +29,13 @@ std::string_view trim_ascii(std::string_view value) {
     return value.substr(start, end - start + 1);
 }
 
-bool iequals_ascii(std::string_view lhs, std::string_view rhs) {
-    return std::ranges::equal(lhs, rhs, [](char a, char b) {
-        return std::tolower(static_cast<unsigned char>(a)) ==
-               std::tolower(static_cast<unsigned char>(b));
-    });
-}
-
-std::optional<std::size_t> parse_content_length(std::string_view header) {
+/// Value of the header field `field` as a decimal number; nullopt when the
+/// field is missing or malformed.
+std::optional<std::size_t> parse_header_number(std::string_view header, std::string_view field) {
     std::size_t pos = 0;
     while(pos < header.size()) {
-        auto end = header.find("\r\n", pos);
-        if(end == std::string_view::npos) {
+        auto end = simd::find(header, "\r\n", pos);
+        if(end == header.size()) {
             break;
         }
 
@@ -51,7 +48,7 @@ std::optional<std::size_t> parse_content_length(std::string_view header) {
         }
 
         auto name = trim_ascii(line.substr(0, sep));
-        if(!iequals_ascii(name, "Content-Length")) {
+        if(!simd::iequals_ascii(name, field)) {
             continue;
         }
 
@@ -71,15 +68,19 @@ std::optional<std::size_t> parse_content_length(std::string_view header) {
             }
             parsed = parsed * 10 + digit;
         }
-
-        if(parsed > max_payload_bytes) {
-            return std::nullopt;
-        }
         return parsed;
     }
     return std::nullopt;
 }
 
+std::optional<std::size_t> parse_content_length(std::string_view header) {
+    auto parsed = parse_header_number(header, "Content-Length");
+    if(!parsed || *parsed > max_payload_bytes) {
+        return std::nullopt;
+    }
+    return parsed;
+}
+
 std::string to_error_text(error err) {
     return std::string(err.message());
 }
@@ -125,6 +126,144 @@ Result<stream> open_stdio_stream(int fd, bool readable, event_loop& loop) {
 
 }  // namespace
 
+namespace detail {
+
+task<std::optional<frame>> read_frame(stream& input) {
+    std::string header;
+    std::optional<std::size_t> content_length;
+    std::size_t descriptors = 0;
+
+    while(!content_length.has_value()) {
+        auto chunk = co_await input.read_chunk();
+        if(!chunk) [[unlikely]] {
+            input.stop();
+            co_return std::nullopt;
+        }
+
+        const auto old_size = header.size();
+        header.append(chunk->data(), chunk->size());
+
+        // Only the new bytes, and the three before them, can complete the
+        // terminator.
+        auto marker = simd::find(header, "\r\n\r\n", old_size >= 3 ? old_size - 3 : 0);
+        if(marker == header.size()) {
+            if(header.size() > max_header_bytes) [[unlikely]] {
+                input.stop();
+                co_return std::nullopt;
+            }
+            input.consume(chunk->size());
+            continue;
+        }
+
+        const auto header_end = marker + 4;
+        if(header_end > max_header_bytes) [[unlikely]] {
+            input.stop();
+            co_return std::nullopt;
+        }
+        const auto consumed_from_chunk = header_end > old_size ? header_end - old_size : 0;
+        input.consume(consumed_from_chunk);
+
+        auto view = std::string_view(header.data(), header_end);
+        content_length = parse_content_length(view);
+        if(!content_length.has_value()) [[unlikely]] {
+            input.stop();
+            co_return std::nullopt;
+        }
+        descriptors = parse_header_number(view, "File-Descriptors").value_or(0);
+    }
+
+    // read_some() drains what is already buffered, then reads the rest of
+    // the body straight into the payload instead of through the stream
+    // buffer, so large payloads are copied once.
+    std::string payload;
+    payload.resize(*content_length);
+
+    std::size_t filled = 0;
+    while(filled < payload.size()) {
+        auto rest = std::span<char>(payload.data() + filled, payload.size() - filled);
+        auto n = co_await input.read_some(rest);
+        if(!n || *n == 0) [[unlikely]] {
+            input.stop();
+            co_return std::nullopt;
+        }
+        filled += *n;
+    }
+
+    co_return frame{std::move(payload), descriptors};
+}
+
+Result<stream> open_stdio_stream(int fd, bool readable, event_loop& loop) {
+    return ipc::open_stdio_stream(fd, readable, loop);
+}
+
+std::string frame_header(std::size_t length, std::size_t descriptors) {
+    std::string header;
+    header.reserve(64);
+    header.append("Content-Length: ");
+    header.append(std::to_string(length));
+    if(descriptors != 0) {
+        header.append("\r\nFile-Descriptors: ");
+        header.append(std::to_string(descriptors));
+    }
+    header.append("\r\n\r\n");
+    return header;
+}
+
+}  // namespace detail
+
+BorrowedMessage::BorrowedMessage(std::string payload) noexcept : owned(std::move(payload)) {}
+
+BorrowedMessage::BorrowedMessage(std::string_view payload,
+                                 stream& source,
+                                 std::size_t release) noexcept :
+    view(payload), source(&source), release(release) {}
+
+BorrowedMessage::BorrowedMessage(BorrowedMessage&& other) noexcept :
+    owned(std::move(other.owned)), view(other.view), source(std::exchange(other.source, nullptr)),
+    release(std::exchange(other.release, 0)) {}
+
+BorrowedMessage& BorrowedMessage::operator=(BorrowedMessage&& other) noexcept {
+    if(this != &other) {
+        release_bytes();
+        owned = std::move(other.owned);
+        view = other.view;
+        source = std::exchange(other.source, nullptr);
+        release = std::exchange(other.release, 0);
+    }
+    return *this;
+}
+
+BorrowedMessage::~BorrowedMessage() {
+    release_bytes();
+}
+
+void BorrowedMessage::release_bytes() noexcept {
+    if(source) {
+        source->consume(release);
+        source = nullptr;
+    }
+}
+
+task<std::optional<BorrowedMessage>> Transport::read_borrowed() {
+    auto payload = co_await read_message();
+    if(!payload) {
+        co_return std::nullopt;
+    }
+    co_return BorrowedMessage(std::move(*payload));
+}
+
+task<void, Error> Transport::write_messages(std::span<const std::string_view> payloads) {
+    for(auto payload: payloads) {
+        co_await write_message(payload).or_fail();
+    }
+}
+
+void Transport::cork() {}
+
+task<void, Error> Transport::uncork() {
+    co_return;
+}
+
 Result<void> Transport::close_output() {
     return outcome_error(Error("transport does not support closing output"));
 }
@@ -169,74 +308,89 @@ Result<std::unique_ptr<StreamTransport>> StreamTransport::open_tcp(int fd, event
 }
 
 task<std::optional<std::string>> StreamTransport::read_message() {
-    std::string header;
-    std::optional<std::size_t> content_length;
-
-    while(!content_length.has_value()) {
-        auto chunk = co_await read_stream.read_chunk();
-        if(!chunk) [[unlikely]] {
-            read_stream.stop();
-            co_return std::nullopt;
-        }
-
-        const auto old_size = header.size();
-        header.append(chunk->data(), chunk->size());
+    auto message = co_await detail::read_frame(read_stream);
+    if(!message) {
+        co_return std::nullopt;
+    }
+    co_return std::move(message->payload);
+}
 
-        auto marker = header.find("\r\n\r\n");
-        if(marker == std::string::npos) {
-            if(header.size() > max_header_bytes) [[unlikely]] {
-                read_stream.stop();
-                co_return std::nullopt;
-            }
-            read_stream.consume(chunk->size());
-            continue;
-        }
+task<std::optional<BorrowedMessage>> StreamTransport::read_borrowed() {
+    auto chunk = co_await read_stream.read_chunk();
+    if(!chunk) [[unlikely]] {
+        read_stream.stop();
+        co_return std::nullopt;
+    }
 
+    // Typically the whole message arrived in one read: parse its header in
+    // place and lend out the body, consuming both once the view is dropped.
+    const auto buffered = std::string_view(chunk->data(), chunk->size());
+    const auto window = buffered.substr(0, max_header_bytes);
+    const auto marker = simd::find(window, "\r\n\r\n");
+    if(marker != window.size()) {
         const auto header_end = marker + 4;
-        if(header_end > max_header_bytes) [[unlikely]] {
-            read_stream.stop();
-            co_return std::nullopt;
+        const auto length = parse_content_length(buffered.substr(0, header_end));
+        if(length && *length <= buffered.size() - header_end) {
+            co_return BorrowedMessage(buffered.substr(header_end, *length),
+                                      read_stream,
+                                      header_end + *length);
         }
-        const auto consumed_from_chunk = header_end > old_size ? header_end - old_size : 0;
-        read_stream.consume(consumed_from_chunk);
+    }
 
-        auto view = std::string_view(header.data(), header_end);
-        content_length = parse_content_length(view);
-        if(!content_length.has_value()) [[unlikely]] {
-            read_stream.stop();
-            co_return std::nullopt;
-        }
+    // Split across reads, or malformed: nothing has been consumed yet, so
+    // the copying reader starts over from the same bytes.
+    auto message = co_await detail::read_frame(read_stream);
+    if(!message) {
+        co_return std::nullopt;
     }
+    co_return BorrowedMessage(std::move(message->payload));
+}
 
-    std::string payload;
-    payload.reserve(*content_length);
+task<void, Error> StreamTransport::write_message(std::string_view payload) {
+    auto header = detail::frame_header(payload.size());
 
-    while(payload.size() < *content_length) {
-        auto chunk = co_await read_stream.read_chunk();
-        if(!chunk) [[unlikely]] {
-            read_stream.stop();
-            co_return std::nullopt;
-        }
+    const std::span<const char> pieces[] = {
+        std::span<const char>(header.data(), header.size()),
+        std::span<const char>(payload.data(), payload.size()),
+    };
 
-        const auto need = *content_length - payload.size();
-        const auto take = std::min<std::size_t>(need, chunk->size());
-        payload.append(chunk->data(), take);
-        read_stream.consume(take);
+    auto& stream = shared_stream ? read_stream : write_stream;
+    auto status = co_await stream.write(std::span<const std::span<const char>>(pieces));
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
+}
+
+task<void, Error> StreamTransport::write_messages(std::span<const std::string_view> payloads) {
+    std::vector<std::string> headers;
+    headers.reserve(payloads.size());
+    for(auto payload: payloads) {
+        headers.push_back(detail::frame_header(payload.size()));
+    }
+
+    std::vector<std::span<const char>> pieces;
+    pieces.reserve(payloads.size() * 2);
+    for(std::size_t i = 0; i < payloads.size(); ++i) {
+        pieces.emplace_back(headers[i].data(), headers[i].size());
+        pieces.emplace_back(payloads[i].data(), payloads[i].size());
     }
 
-    co_return payload;
+    auto& stream = shared_stream ? read_stream : write_stream;
+    auto status = co_await stream.write(std::span<const std::span<const char>>(pieces));
+    if(status.has_error()) {
+        co_await fail(std::string(status.error().message()));
+    }
 }
 
-task<void, Error> StreamTransport::write_message(std::string_view payload) {
-    std::string framed;
-    framed.reserve(32 + payload.size());
-    framed.append("Content-Length: ");
-    framed.append(std::to_string(payload.size()));
-    framed.append("\r\n\r\n");
-    framed.append(payload.data(), payload.size());
+void StreamTransport::cork() {
+    auto& stream = shared_stream ? read_stream : write_stream;
+    stream.cork();
+}
 
+task<void, Error> StreamTransport::uncork() {
     auto& stream = shared_stream ? read_stream : write_stream;
-    auto status = co_await stream.write(std::span<const char>(framed.data(), framed.size()));
+    stream.uncork();
+    auto status = co_await stream.flush();
     if(status.has_error()) {
         co_await fail(std::string(status.error().message()));
     }
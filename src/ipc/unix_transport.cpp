@@ -0,0 +1,146 @@
+#include "kota/ipc/unix_transport.h"
+
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "framing.h"
+
+namespace kota::ipc {
+
+namespace {
+
+Error to_error(error err) {
+    return Error(std::string(err.message()));
+}
+
+}  // namespace
+
+UnixSocketTransport::UnixSocketTransport(pipe channel) : channel(std::move(channel)) {}
+
+UnixSocketTransport::~UnixSocketTransport() {
+    close_received();
+}
+
+task<std::unique_ptr<UnixSocketTransport>, Error>
+    UnixSocketTransport::connect(std::string_view path, event_loop& loop) {
+    auto connected = co_await pipe::connect(path, pipe::options{true}, loop);
+    if(!connected) {
+        co_await fail(to_error(connected.error()));
+    }
+    co_return std::make_unique<UnixSocketTransport>(std::move(*connected));
+}
+
+Result<std::unique_ptr<UnixSocketTransport>> UnixSocketTransport::open(int fd, event_loop& loop) {
+    auto opened = pipe::open(fd, pipe::options{true}, loop);
+    if(!opened) {
+        return outcome_error(to_error(opened.error()));
+    }
+    return std::make_unique<UnixSocketTransport>(std::move(*opened));
+}
+
+Result<pipe::acceptor> UnixSocketTransport::listen(std::string_view path, event_loop& loop) {
+    auto listening = pipe::listen(path, pipe::options{true}, loop);
+    if(!listening) {
+        return outcome_error(to_error(listening.error()));
+    }
+    return std::move(*listening);
+}
+
+task<std::optional<std::string>> UnixSocketTransport::read_message() {
+    close_received();
+
+    auto message = co_await detail::read_frame(channel);
+    if(!message) {
+        co_return std::nullopt;
+    }
+
+    // The descriptors came with the first header byte, so they are queued
+    // by the time the header has been parsed.
+    for(std::size_t i = 0; i < message->descriptors; ++i) {
+        auto fd = channel.take_descriptor();
+        if(!fd) [[unlikely]] {
+            channel.stop();
+            co_return std::nullopt;
+        }
+        received.push_back(*fd);
+    }
+
+    co_return std::move(message->payload);
+}
+
+task<void, Error> UnixSocketTransport::write_message(std::string_view payload) {
+    co_await write_message(payload, {}).or_fail();
+}
+
+task<void, Error> UnixSocketTransport::write_message(std::string_view payload,
+                                                     std::span<const int> descriptors) {
+    if(descriptors.size() > max_descriptors) {
+        co_await fail(Error("too many descriptors for one message"));
+    }
+
+    // A descriptor-carrying frame must go out with nothing queued before it,
+    // and frames of concurrent writers must not interleave.
+    co_await write_lock.lock();
+    struct unlock_guard {
+        mutex& lock;
+
+        ~unlock_guard() {
+            lock.unlock();
+        }
+    } unlock{write_lock};
+
+    const auto header = detail::frame_header(payload.size(), descriptors.size());
+    const auto header_bytes = std::span<const char>(header.data(), header.size());
+    const auto payload_bytes = std::span<const char>(payload.data(), payload.size());
+
+    if(descriptors.empty()) {
+        const std::span<const char> pieces[] = {header_bytes, payload_bytes};
+        auto status = co_await channel.write(std::span<const std::span<const char>>(pieces));
+        if(status.has_error()) {
+            co_await fail(to_error(status.error()));
+        }
+        co_return;
+    }
+
+    auto status = co_await channel.write_with_descriptors(header_bytes, descriptors);
+    if(status.has_error()) {
+        co_await fail(to_error(status.error()));
+    }
+
+    if(!payload.empty()) {
+        auto rest = co_await channel.write(payload_bytes);
+        if(rest.has_error()) {
+            co_await fail(to_error(rest.error()));
+        }
+    }
+}
+
+std::vector<int> UnixSocketTransport::take_descriptors() {
+    return std::exchange(received, {});
+}
+
+Result<void> UnixSocketTransport::close_output() {
+    channel = pipe{};
+    return {};
+}
+
+Result<void> UnixSocketTransport::close() {
+    channel.stop();
+    channel = pipe{};
+    close_received();
+    return {};
+}
+
+void UnixSocketTransport::close_received() noexcept {
+#ifndef _WIN32
+    for(int fd: received) {
+        ::close(fd);
+    }
+#endif
+    received.clear();
+}
+
+}  // namespace kota::ipc
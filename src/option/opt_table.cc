@@ -3,10 +3,11 @@
 #include <cctype>
 #include <cstdio>
 #include <expected>
-#include <set>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "kota/option/option.h"
@@ -15,7 +16,7 @@ using namespace kota::option;
 
 namespace {
 
-std::string_view ltrim_all_of(std::string_view str, const std::vector<char>& prefixes) {
+std::string_view ltrim_all_of(std::string_view str, std::span<const char> prefixes) {
     auto pos = str.find_first_not_of(prefixes.data(), 0, prefixes.size());
 
     if(pos != std::string_view::npos) {
@@ -78,6 +79,13 @@ int str_cmp_opt_name(std::string_view a, std::string_view b, bool fallback_case_
                                 : -1 /* B is a prefix of A */;
 }
 
+// Rewrites a grouped short option after its first letter was consumed,
+// in place: "-abc" and "/abc" both become "-bc".
+void drop_grouped_letter(std::string& arg) {
+    arg.erase(0, 1);
+    arg[0] = '-';
+}
+
 struct OptNameLess {
     inline bool operator()(const OptTable::Info& i, std::string_view name) const {
         return str_cmp_opt_name(i.name(), name, false) < 0;
@@ -90,55 +98,90 @@ OptTable::OptTable(std::span<const OptTable::Info> option_infos,
                    bool ignore_case,
                    //    std::span<SubCommand> SubCommands,
                    std::vector<std::string_view> prefixes_union,
-                   bool build_now) :
-    option_infos(option_infos), ignore_case(ignore_case), _prefixes_union(prefixes_union) {
+                   bool build_now) : option_infos(option_infos), ignore_case(ignore_case) {
+    if(!prefixes_union.empty()) {
+        auto requested = std::make_shared<std::vector<std::string_view>>(std::move(prefixes_union));
+        this->_prefixes_union = *requested;
+        this->index_storage = std::move(requested);
+    }
     if(build_now) {
         this->build();
     }
 }
 
 OptTable& OptTable::build() {
-    // Explicitly zero initialize the error to work around a bug in array
-    // value-initialization on MinGW with gcc 4.3.5.
-
-    // Find start of normal options.
-    bool found_searchable = false;
-    for(unsigned i = 0, e = this->num_options(); i != e; ++i) {
-        unsigned kind = this->info(i + 1).kind;
-        if(kind == Option::InputClass) {
-            assert(!this->input_option_id && "Cannot have multiple input options!");
-            this->input_option_id = this->info(i + 1).id;
-        } else if(kind == Option::UnknownClass) {
-            assert(!this->unknown_option_id && "Cannot have multiple unknown options!");
-            this->unknown_option_id = this->info(i + 1).id;
-        } else if(kind != Option::GroupClass && !found_searchable) {
-            this->first_searchable_index = i;
-            found_searchable = true;
+    auto derived = std::make_shared<DerivedIndex>(
+        derive_index(this->option_infos, this->input_random_index, this->_prefixes_union));
+    this->build(IndexView{
+        .first_searchable_index = derived->first_searchable_index,
+        .input_option_id = derived->input_option_id,
+        .unknown_option_id = derived->unknown_option_id,
+        .prefixes_union = derived->prefixes_union,
+        .prefix_chars = derived->prefix_chars,
+        .nodes = derived->nodes,
+        .edges = derived->edges,
+        .options = derived->options,
+        .prefix_start = derived->prefix_start.data(),
+    });
+    this->index_storage = std::move(derived);
+    return *this;
+}
+
+OptTable& OptTable::build(const IndexView& index) {
+    this->first_searchable_index = index.first_searchable_index;
+    this->input_option_id = index.input_option_id;
+    this->unknown_option_id = index.unknown_option_id;
+    this->_prefixes_union = index.prefixes_union;
+    this->prefix_chars = index.prefix_chars;
+    this->spelling_index = SpellingIndex{
+        .nodes = index.nodes,
+        .edges = index.edges,
+        .options = index.options,
+        .prefix_start = index.prefix_start,
+    };
+    this->index_storage.reset();
+    return *this;
+}
+
+OptTable::Candidates OptTable::candidates(std::string_view str, const Info* first) const {
+    Candidates found;
+    const Info* end = this->option_infos.data() + this->option_infos.size();
+    const auto& index = this->spelling_index;
+
+    // Tables used without build() keep the full scan.
+    if(index.nodes.empty()) {
+        for(; first != end; ++first) {
+            found.push_back(first);
         }
-    }
-    if(this->input_random_index) {
-        this->first_searchable_index = 0;
+        return found;
     }
 
-    if(this->_prefixes_union.empty()) {
-        std::set<std::string_view> tmp_prefixes_union;
-        for(const auto& Info: option_infos.subspan(this->first_searchable_index)) {
-            if((Info.kind == Option::InputClass || Info.kind == Option::UnknownClass) &&
-               input_random_index) {
-                continue;
-            }
-            for(auto prefix: Info.prefixes()) {
-                tmp_prefixes_union.insert(prefix);
+    const auto* node = &index.nodes[0];
+    for(char c: str) {
+        auto byte = fold_ascii(c);
+        auto edges = index.edges.subspan(node->first_edge, node->edge_count);
+        auto edge = std::ranges::lower_bound(edges, byte, {}, &IndexEdge::byte);
+        if(edge == edges.end() || edge->byte != byte) {
+            break;
+        }
+        node = &index.nodes[edge->child];
+        for(auto option: index.options.subspan(node->first_option, node->option_count)) {
+            const Info* info = this->option_infos.data() + option;
+            if(info >= first) {
+                found.push_back(info);
             }
         }
-        this->_prefixes_union =
-            std::vector<std::string_view>(tmp_prefixes_union.begin(), tmp_prefixes_union.end());
     }
 
-    buildPrefixChars();
-    return *this;
+    // An option is reached once per prefix that spells it.
+    if(found.size() > 1) {
+        std::ranges::sort(found);
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+    }
+    return found;
 }
 
+
 const Option OptTable::option(OptSpecifier opt) const {
     unsigned id = opt.id();
     if(id == 0) {
@@ -148,11 +191,15 @@ const Option OptTable::option(OptSpecifier opt) const {
     return Option(&this->info(id), this);
 }
 
-static bool is_input(const OptTable* o_table, std::string_view arg) {
+bool OptTable::is_input(std::string_view arg) const {
     if(arg == "-") {
         return true;
     }
-    for(const auto& prefix: o_table->prefixes_union()) {
+    if(!this->spelling_index.nodes.empty() && !arg.empty() &&
+       !this->spelling_index.prefix_start[static_cast<unsigned char>(arg[0])]) {
+        return true;
+    }
+    for(const auto& prefix: this->prefixes_union()) {
         if(arg.starts_with(prefix)) {
             return false;
         }
@@ -185,7 +232,7 @@ std::expected<PArg, const char*> OptTable::parse_one_arg_grouped(InputArgv argv,
     // Anything that doesn't start with PrefixesUnion is an input, as is '-'
     // itself.
     std::string_view str = argv[index];
-    if(is_input(this, str)) {
+    if(this->is_input(str)) {
         return ParsedArgument{
             .option_id = this->input_option_id,
             .spelling = str,
@@ -207,13 +254,13 @@ std::expected<PArg, const char*> OptTable::parse_one_arg_grouped(InputArgv argv,
     unsigned prev = index;
 
     // Search for the option which matches Str.
-    for(; start != end; ++start) {
-        unsigned arg_sz = match_opt(start, str, ignore_case);
+    for(const Info* candidate: this->candidates(str, start)) {
+        unsigned arg_sz = match_opt(candidate, str, ignore_case);
         if(!arg_sz) {
             continue;
         }
 
-        Option opt(start, this);
+        Option opt(candidate, this);
         auto a = opt.accept(argv,
                             std::string_view(argv[index]).substr(0, arg_sz),
                             /*GroupedShortOption=*/false,
@@ -224,7 +271,7 @@ std::expected<PArg, const char*> OptTable::parse_one_arg_grouped(InputArgv argv,
 
         // -abc, find -a, but -abc maybe a flag option, record -a as Fallback
         if(arg_sz == 2 && opt.kind() == Option::FlagClass) {
-            fallback_opt = start;
+            fallback_opt = candidate;
         }
 
         // Otherwise, see if the argument is missing, index will be changed in accept.
@@ -245,13 +292,13 @@ std::expected<PArg, const char*> OptTable::parse_one_arg_grouped(InputArgv argv,
 
         auto a = opt.accept(argv, str.substr(0, 2), /*GroupedShortOption=*/true, index);
         if(a.has_value()) {
-            argv[index] = '-' + std::string(str.substr(2));
+            drop_grouped_letter(argv.writable_tokens()[index]);
             return a;
         }
     }
 
     // -abc, -a is invalid, to -bc
-    if(str[1] != '-') {
+    if(str.size() >= 2 && str[1] != '-') {
         auto first_flag_name = str.substr(0, 2);
         auto r = ParsedArgument{
             .option_id = this->unknown_option_id,
@@ -259,7 +306,7 @@ std::expected<PArg, const char*> OptTable::parse_one_arg_grouped(InputArgv argv,
             .values = {},
             .index = index,
         };
-        argv[index] = '-' + std::string(str.substr(2));
+        drop_grouped_letter(argv.writable_tokens()[index]);
         return r;
     }
 
@@ -317,7 +364,7 @@ std::expected<PArg, const char*>
 
     // Anything that doesn't start with PrefixesUnion is an input, as is '-'
     // itself.
-    if(is_input(this, str)) {
+    if(this->is_input(str)) {
         return ParsedArgument{
             .option_id = this->input_option_id,
             .spelling = str,
@@ -337,21 +384,14 @@ std::expected<PArg, const char*>
     if(this->tablegen_mode) {
         // Options are stored in sorted order, with '\0' at the end of the
         // alphabet. Since the only options which can accept a string must
-        // prefix it, we iteratively search for the next option which could
-        // be a prefix.
-        for(; start != end; ++start) {
-            unsigned arg_sz = 0;
-            // Scan for first option which is a proper prefix.
-            for(; start != end; ++start) {
-                if(arg_sz = match_opt(start, str, this->ignore_case); arg_sz) {
-                    break;
-                }
-            }
-            if(start == end) {
-                break;
+        // prefix it, we try every option that prefixes it, in table order.
+        for(const Info* candidate: this->candidates(str, start)) {
+            unsigned arg_sz = match_opt(candidate, str, this->ignore_case);
+            if(!arg_sz) {
+                continue;
             }
 
-            Option opt(start, this);
+            Option opt(candidate, this);
 
             if(exclude_option(opt)) {
                 continue;
@@ -381,19 +421,13 @@ std::expected<PArg, const char*>
 
         // Unsorted tables may contain overlapping spellings, so prefer the
         // longest successful prefix match instead of returning the first one.
-        for(; start != end; ++start) {
-            unsigned arg_sz = 0;
-            // Scan for first option which is a proper prefix.
-            for(; start != end; ++start) {
-                if(arg_sz = match_opt(start, str, this->ignore_case); arg_sz) {
-                    break;
-                }
-            }
-            if(start == end) {
-                break;
+        for(const Info* candidate: this->candidates(str, start)) {
+            unsigned arg_sz = match_opt(candidate, str, this->ignore_case);
+            if(!arg_sz) {
+                continue;
             }
 
-            Option opt(start, this);
+            Option opt(candidate, this);
 
             if(exclude_option(opt)) {
                 continue;
@@ -449,3 +483,20 @@ std::expected<PArg, const char*>
         .index = index++,
     };
 }
+
+void OptTable::parse_batch(std::span<const InputArgv> commands,
+                           ParsedBatch& out,
+                           Visibility visibility_mask) const {
+    for(auto argv: commands) {
+        ParsedBatch::Command command{.first = static_cast<unsigned>(out.args.size())};
+        this->parse_args(
+            argv,
+            command.missing_arg_index,
+            command.missing_arg_count,
+            [&out](ParsedArgument arg) { out.args.push_back(std::move(arg)); },
+            visibility_mask,
+            &command.missing_arg_reason);
+        command.count = static_cast<unsigned>(out.args.size()) - command.first;
+        out.commands.push_back(command);
+    }
+}
@@ -0,0 +1,173 @@
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include "kota/option/option.h"
+
+namespace kota::option {
+
+void ParseCache::make_key(OptTable::InputArgv argv) {
+    // Tagged so that no two token sequences share a key: 'i' stands for an
+    // input, 't' for a token spelled out after its length.
+    this->key.clear();
+    for(std::string_view token: argv) {
+        if(!token.empty() && this->table->is_input(token)) {
+            this->key += 'i';
+            continue;
+        }
+        auto size = static_cast<std::uint32_t>(token.size());
+        this->key += 't';
+        this->key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        this->key += token;
+    }
+}
+
+ParseCache::TextRef ParseCache::locate(OptTable::InputArgv argv,
+                                       unsigned hint,
+                                       std::string_view text) {
+    auto contains = [&](std::size_t token) {
+        const char* begin = argv[token].data();
+        const char* end = begin + argv[token].size();
+        return std::less_equal<const char*>{}(begin, text.data()) &&
+               std::less_equal<const char*>{}(text.data() + text.size(), end);
+    };
+    auto at = [&](std::size_t token) {
+        if(text.data() == argv[token].data() && text.size() == argv[token].size()) {
+            // Inputs differ in length between command lines sharing an entry.
+            return TextRef{
+                .text = nullptr,
+                .token = static_cast<std::uint32_t>(token),
+                .offset = 0,
+                .length = TextRef::whole_token,
+            };
+        }
+        return TextRef{
+            .text = nullptr,
+            .token = static_cast<std::uint32_t>(token),
+            .offset = static_cast<std::uint32_t>(text.data() - argv[token].data()),
+            .length = static_cast<std::uint32_t>(text.size()),
+        };
+    };
+
+    // Spellings and values come from the argument's own token or the ones
+    // right after it.
+    for(std::size_t token = hint; token < argv.size(); ++token) {
+        if(contains(token)) {
+            return at(token);
+        }
+    }
+    for(std::size_t token = 0; token < hint && token < argv.size(); ++token) {
+        if(contains(token)) {
+            return at(token);
+        }
+    }
+    return TextRef{.text = text.data(), .length = static_cast<std::uint32_t>(text.size())};
+}
+
+std::string_view ParseCache::resolve(OptTable::InputArgv argv, const TextRef& ref) {
+    if(ref.token == TextRef::no_token) {
+        return std::string_view(ref.text, ref.length);
+    }
+    if(ref.length == TextRef::whole_token) {
+        return argv[ref.token];
+    }
+    return std::string_view(argv[ref.token]).substr(ref.offset, ref.length);
+}
+
+std::optional<ParseCache::Entry> ParseCache::record(OptTable::InputArgv argv,
+                                                    const ParsedBatch& out,
+                                                    std::size_t first) {
+    auto patchable = [&](const TextRef& ref) {
+        return ref.token == TextRef::no_token || ref.length == TextRef::whole_token ||
+               !this->table->is_input(argv[ref.token]);
+    };
+
+    Entry entry;
+    for(std::size_t i = first; i < out.args.size(); ++i) {
+        const auto& arg = out.args[i];
+        // Only grouped short options spell with a copied array.
+        assert(std::holds_alternative<std::string_view>(arg.spelling));
+
+        CachedArgument cached{
+            .option_id = arg.option_id,
+            .spelling = locate(argv, arg.index, arg.get_spelling_view()),
+            .index = arg.index,
+            .first_value = static_cast<unsigned>(entry.values.size()),
+            .value_count = static_cast<unsigned>(arg.values.size()),
+            .unaliased_option_id = arg.unaliased_option_id,
+            .unaliased_addition_values = arg.unaliased_addition_values,
+        };
+        if(!patchable(cached.spelling)) {
+            return std::nullopt;
+        }
+        for(auto value: arg.values) {
+            auto ref = locate(argv, arg.index, value);
+            if(!patchable(ref)) {
+                return std::nullopt;
+            }
+            entry.values.push_back(ref);
+        }
+        entry.arguments.push_back(std::move(cached));
+    }
+    return entry;
+}
+
+void ParseCache::replay(const Entry& entry, OptTable::InputArgv argv, ParsedBatch& out) {
+    for(const auto& cached: entry.arguments) {
+        ParsedArgument arg{
+            .option_id = cached.option_id,
+            .spelling = resolve(argv, cached.spelling),
+            .values = {},
+            .index = cached.index,
+            .unaliased_option_id = cached.unaliased_option_id,
+            .unaliased_addition_values = cached.unaliased_addition_values,
+        };
+        arg.values.reserve(cached.value_count);
+        for(unsigned i = 0; i < cached.value_count; ++i) {
+            arg.values.push_back(resolve(argv, entry.values[cached.first_value + i]));
+        }
+        out.args.push_back(std::move(arg));
+    }
+}
+
+void ParseCache::parse_batch(std::span<const OptTable::InputArgv> commands, ParsedBatch& out) {
+    if(this->table->grouped_short_options) {
+        this->table->parse_batch(commands, out, this->visibility_mask);
+        return;
+    }
+
+    for(auto argv: commands) {
+        ParsedBatch::Command command{.first = static_cast<unsigned>(out.args.size())};
+        this->make_key(argv);
+        if(auto it = this->entries.find(std::string_view(this->key)); it != this->entries.end()) {
+            const auto& entry = it->second;
+            this->replay(entry, argv, out);
+            command.missing_arg_index = entry.missing_arg_index;
+            command.missing_arg_count = entry.missing_arg_count;
+            command.missing_arg_reason = entry.missing_arg_reason;
+            this->hit_count += 1;
+        } else {
+            this->table->parse_args(
+                argv,
+                command.missing_arg_index,
+                command.missing_arg_count,
+                [&out](ParsedArgument arg) { out.args.push_back(std::move(arg)); },
+                this->visibility_mask,
+                &command.missing_arg_reason);
+            if(auto entry = this->record(argv, out, command.first)) {
+                entry->missing_arg_index = command.missing_arg_index;
+                entry->missing_arg_count = command.missing_arg_count;
+                entry->missing_arg_reason = command.missing_arg_reason;
+                this->entries.emplace(this->key, std::move(*entry));
+            }
+            this->miss_count += 1;
+        }
+        command.count = static_cast<unsigned>(out.args.size()) - command.first;
+        out.commands.push_back(command);
+    }
+}
+
+}  // namespace kota::option
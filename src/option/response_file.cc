@@ -0,0 +1,398 @@
+#include <cerrno>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "kota/option/option.h"
+
+namespace kota::option {
+
+namespace {
+
+/// Response files nested deeper than this are taken to include themselves
+/// under another spelling of their path.
+constexpr std::size_t max_nesting = 64;
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/// Starting offset past a UTF-8 byte order mark.
+std::size_t skip_bom(const char* text, std::size_t length) {
+    return length >= 3 && std::memcmp(text, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+}
+
+/// Writes an argument over the text it is read from. Resolving quotes and
+/// escapes only ever drops characters, so the write position never passes
+/// the read position; nothing is written while the two coincide, which
+/// keeps the pages of plain arguments shared with the file.
+struct InPlaceWriter {
+    char* text;
+    std::size_t start;
+    std::size_t out;
+
+    void emit(std::size_t from) {
+        if(this->out != from) {
+            this->text[this->out] = this->text[from];
+        }
+        ++this->out;
+    }
+
+    std::string_view result() const {
+        return std::string_view(this->text + this->start, this->out - this->start);
+    }
+};
+
+}  // namespace
+
+ResponseFile::ResponseFile(ResponseFile&& other) noexcept :
+    base(std::exchange(other.base, nullptr)), length(std::exchange(other.length, 0)),
+    cursor(std::exchange(other.cursor, 0)), backing(std::exchange(other.backing, Backing::None)),
+    syntax(other.syntax) {}
+
+ResponseFile& ResponseFile::operator=(ResponseFile&& other) noexcept {
+    if(this != &other) {
+        this->reset();
+        this->base = std::exchange(other.base, nullptr);
+        this->length = std::exchange(other.length, 0);
+        this->cursor = std::exchange(other.cursor, 0);
+        this->backing = std::exchange(other.backing, Backing::None);
+        this->syntax = other.syntax;
+    }
+    return *this;
+}
+
+ResponseFile::~ResponseFile() {
+    this->reset();
+}
+
+void ResponseFile::reset() noexcept {
+    switch(this->backing) {
+        case Backing::None: break;
+        case Backing::Heap: delete[] this->base; break;
+        case Backing::Mapping:
+#ifdef _WIN32
+            ::UnmapViewOfFile(this->base);
+#else
+            ::munmap(this->base, this->length);
+#endif
+            break;
+    }
+    this->base = nullptr;
+    this->length = 0;
+    this->cursor = 0;
+    this->backing = Backing::None;
+}
+
+std::expected<ResponseFile, std::string>
+    ResponseFile::open(const std::string& path, ResponseFileSyntax syntax, bool* missing) {
+    if(missing != nullptr) {
+        *missing = false;
+    }
+    ResponseFile file;
+    file.syntax = syntax;
+    bool regular = true;
+
+#ifdef _WIN32
+    HANDLE handle = ::CreateFileA(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+    if(handle == INVALID_HANDLE_VALUE) {
+        auto err = ::GetLastError();
+        if(missing != nullptr) {
+            *missing = err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND;
+        }
+        return std::unexpected(std::format("cannot read response file '{}': {}",
+                                           path,
+                                           std::system_category().message(static_cast<int>(err))));
+    }
+    LARGE_INTEGER size{};
+    if(!::GetFileSizeEx(handle, &size)) {
+        auto err = ::GetLastError();
+        ::CloseHandle(handle);
+        return std::unexpected(std::format("cannot read response file '{}': {}",
+                                           path,
+                                           std::system_category().message(static_cast<int>(err))));
+    }
+    file.length = static_cast<std::size_t>(size.QuadPart);
+    if(file.length != 0) {
+        HANDLE mapping = ::CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if(mapping != nullptr) {
+            void* view = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            ::CloseHandle(mapping);
+            if(view != nullptr) {
+                file.base = static_cast<char*>(view);
+                file.backing = Backing::Mapping;
+            }
+        }
+    }
+    ::CloseHandle(handle);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        auto err = errno;
+        if(missing != nullptr) {
+            *missing = err == ENOENT;
+        }
+        return std::unexpected(std::format("cannot read response file '{}': {}",
+                                           path,
+                                           std::generic_category().message(err)));
+    }
+    struct stat st{};
+    if(::fstat(fd, &st) != 0) {
+        auto err = errno;
+        ::close(fd);
+        return std::unexpected(std::format("cannot read response file '{}': {}",
+                                           path,
+                                           std::generic_category().message(err)));
+    }
+    regular = S_ISREG(st.st_mode);
+    file.length = regular ? static_cast<std::size_t>(st.st_size) : 0;
+    if(file.length != 0) {
+        // Private and writable: rewriting an argument copies just its page.
+        void* mapping =
+            ::mmap(nullptr, file.length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(mapping != MAP_FAILED) {
+            file.base = static_cast<char*>(mapping);
+            file.backing = Backing::Mapping;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // Files that cannot be mapped, such as pipes, are read instead.
+    if(file.base == nullptr && (file.length != 0 || !regular)) {
+        std::ifstream in(path, std::ios::binary);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if(!in && !in.eof()) {
+            return std::unexpected(std::format("cannot read response file '{}'", path));
+        }
+        return from_text(text, syntax);
+    }
+
+    file.cursor = skip_bom(file.base, file.length);
+    return file;
+}
+
+ResponseFile ResponseFile::from_text(std::string_view text, ResponseFileSyntax syntax) {
+    ResponseFile file;
+    file.syntax = syntax;
+    if(!text.empty()) {
+        file.base = new char[text.size()];
+        file.length = text.size();
+        file.backing = Backing::Heap;
+        std::memcpy(file.base, text.data(), text.size());
+    }
+    file.cursor = skip_bom(file.base, file.length);
+    return file;
+}
+
+std::optional<std::string_view> ResponseFile::next() {
+    while(this->cursor < this->length && is_space(this->base[this->cursor])) {
+        ++this->cursor;
+    }
+    if(this->cursor == this->length) {
+        return std::nullopt;
+    }
+    return this->syntax == ResponseFileSyntax::MSVC ? this->next_msvc() : this->next_gnu();
+}
+
+std::string_view ResponseFile::next_gnu() {
+    auto& in = this->cursor;
+    const auto end = this->length;
+    InPlaceWriter writer{this->base, in, in};
+
+    while(in < end) {
+        char c = this->base[in];
+        // A backslash escapes the next character.
+        if(c == '\\' && in + 1 < end) {
+            writer.emit(in + 1);
+            in += 2;
+            continue;
+        }
+        // Quotes group everything up to the matching quote; an unterminated
+        // one runs to the end of the file.
+        if(c == '\'' || c == '"') {
+            ++in;
+            while(in < end && this->base[in] != c) {
+                if(this->base[in] == '\\' && in + 1 < end) {
+                    ++in;
+                }
+                writer.emit(in);
+                ++in;
+            }
+            if(in < end) {
+                ++in;
+            }
+            continue;
+        }
+        if(is_space(c)) {
+            break;
+        }
+        writer.emit(in);
+        ++in;
+    }
+    return writer.result();
+}
+
+std::string_view ResponseFile::next_msvc() {
+    auto& in = this->cursor;
+    const auto end = this->length;
+    InPlaceWriter writer{this->base, in, in};
+    bool quoted = false;
+
+    while(in < end) {
+        char c = this->base[in];
+        if(!quoted && is_space(c)) {
+            break;
+        }
+        if(c == '\\') {
+            std::size_t count = 0;
+            while(in + count < end && this->base[in + count] == '\\') {
+                ++count;
+            }
+            if(in + count < end && this->base[in + count] == '"') {
+                // 2n backslashes and a quote are n backslashes and a quote
+                // that toggles quoting; 2n + 1 of them escape the quote.
+                for(std::size_t i = 0; i < count / 2; ++i) {
+                    writer.emit(in + i);
+                }
+                in += count;
+                if(count % 2 == 1) {
+                    writer.emit(in);
+                    ++in;
+                }
+            } else {
+                for(std::size_t i = 0; i < count; ++i) {
+                    writer.emit(in + i);
+                }
+                in += count;
+            }
+            continue;
+        }
+        if(c == '"') {
+            if(quoted && in + 1 < end && this->base[in + 1] == '"') {
+                writer.emit(in + 1);
+                in += 2;
+                continue;
+            }
+            quoted = !quoted;
+            ++in;
+            continue;
+        }
+        writer.emit(in);
+        ++in;
+    }
+    return writer.result();
+}
+
+namespace {
+
+struct Expander {
+    std::vector<std::string_view>& args;
+    std::vector<ResponseFile>& files;
+    ResponseFileSyntax syntax;
+    std::vector<std::string> nesting = {};
+
+    std::expected<void, std::string> add(std::string_view arg) {
+        if(arg.size() < 2 || arg.front() != '@') {
+            this->args.push_back(arg);
+            return {};
+        }
+
+        std::string path(arg.substr(1));
+        for(const auto& including: this->nesting) {
+            if(including == path) {
+                return std::unexpected(std::format("response file '{}' includes itself", path));
+            }
+        }
+        if(this->nesting.size() == max_nesting) {
+            return std::unexpected(
+                std::format("response file '{}' is nested too deeply", path));
+        }
+
+        bool missing = false;
+        auto file = ResponseFile::open(path, this->syntax, &missing);
+        if(!file.has_value()) {
+            if(missing) {
+                this->args.push_back(arg);
+                return {};
+            }
+            return std::unexpected(std::move(file.error()));
+        }
+
+        // Tokens view the mapping, which moving the file keeps in place.
+        // Nested files may grow `files`, so it is indexed, not referenced.
+        const auto index = this->files.size();
+        this->files.push_back(std::move(*file));
+        this->nesting.push_back(std::move(path));
+        while(auto token = this->files[index].next()) {
+            if(auto added = this->add(*token); !added.has_value()) {
+                return added;
+            }
+        }
+        this->nesting.pop_back();
+        return {};
+    }
+};
+
+}  // namespace
+
+std::expected<ExpandedArgv, std::string> expand_response_files(ArgvView argv,
+                                                               ResponseFileSyntax syntax) {
+    ExpandedArgv out;
+    out.view = argv;
+
+    std::size_t first = 0;
+    while(first < argv.size() && !(argv[first].size() >= 2 && argv[first].front() == '@')) {
+        ++first;
+    }
+    if(first == argv.size()) {
+        return out;
+    }
+
+    out.args.reserve(argv.size());
+    out.args.insert(out.args.end(), argv.begin(), argv.begin() + first);
+    Expander expander{out.args, out.files, syntax};
+    for(std::size_t i = first; i < argv.size(); ++i) {
+        if(auto added = expander.add(argv[i]); !added.has_value()) {
+            return std::unexpected(std::move(added.error()));
+        }
+    }
+
+    // Files that did not exist leave the arguments unchanged.
+    if(out.files.empty()) {
+        out.args.clear();
+        return out;
+    }
+    out.view = ArgvView(out.args);
+    return out;
+}
+
+}  // namespace kota::option
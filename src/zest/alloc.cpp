@@ -0,0 +1,218 @@
+#include "kota/zest/detail/alloc.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <print>
+
+#include "kota/zest/detail/registry.h"
+#include "kota/zest/detail/trace.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace kota::zest {
+
+namespace {
+
+thread_local AllocationStats counters;
+
+#if KOTA_ZEST_COUNT_ALLOCATIONS
+
+void* allocate(std::size_t size) {
+    counters.allocations += 1;
+    counters.bytes += size;
+    while(true) {
+        if(void* p = std::malloc(size == 0 ? 1 : size)) {
+            return p;
+        }
+        auto handler = std::get_new_handler();
+        if(handler == nullptr) {
+#ifdef __cpp_exceptions
+            throw std::bad_alloc();
+#else
+            std::abort();
+#endif
+        }
+        handler();
+    }
+}
+
+void* allocate(std::size_t size, std::align_val_t align) {
+    counters.allocations += 1;
+    counters.bytes += size;
+    const auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc() wants a size that is a multiple of the alignment.
+    const auto rounded = (size + alignment - 1) / alignment * alignment;
+    while(true) {
+#ifdef _WIN32
+        void* p = ::_aligned_malloc(rounded == 0 ? alignment : rounded, alignment);
+#else
+        void* p = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+#endif
+        if(p != nullptr) {
+            return p;
+        }
+        auto handler = std::get_new_handler();
+        if(handler == nullptr) {
+#ifdef __cpp_exceptions
+            throw std::bad_alloc();
+#else
+            std::abort();
+#endif
+        }
+        handler();
+    }
+}
+
+void deallocate(void* p) noexcept {
+    if(p != nullptr) {
+        counters.deallocations += 1;
+        std::free(p);
+    }
+}
+
+void deallocate(void* p, std::align_val_t) noexcept {
+    if(p != nullptr) {
+        counters.deallocations += 1;
+#ifdef _WIN32
+        ::_aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+template <typename... Args>
+void* allocate_nothrow(std::size_t size, Args... args) noexcept {
+#ifdef __cpp_exceptions
+    try {
+        return allocate(size, args...);
+    } catch(...) {
+        return nullptr;
+    }
+#else
+    return allocate(size, args...);
+#endif
+}
+
+#endif
+
+}  // namespace
+
+AllocationStats thread_allocations() noexcept {
+    return counters;
+}
+
+bool counts_allocations() noexcept {
+#if KOTA_ZEST_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationCheck::~AllocationCheck() {
+    // Read before reporting, which allocates itself.
+    const auto allocations = counters.allocations - this->before.allocations;
+    const auto bytes = counters.bytes - this->before.bytes;
+    if(allocations <= this->limit) {
+        return;
+    }
+    std::println("[ expect ] {} (expected at most {} allocations)", this->expr, this->limit);
+    std::println("           got: {} allocations, {} bytes", allocations, bytes);
+    std::println("           at {}:{}", this->loc.file_name(), this->loc.line());
+    print_trace(this->loc);
+    failure();
+}
+
+}  // namespace kota::zest
+
+#if KOTA_ZEST_COUNT_ALLOCATIONS
+
+// Replacements of the global allocation functions. Every form is replaced,
+// so that none of them falls back to a library default that bypasses the
+// counters or pairs a counted allocation with an uncounted release.
+
+void* operator new(std::size_t size) {
+    return kota::zest::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return kota::zest::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return kota::zest::allocate_nothrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return kota::zest::allocate_nothrow(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return kota::zest::allocate(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return kota::zest::allocate(size, align);
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return kota::zest::allocate_nothrow(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return kota::zest::allocate_nothrow(size, align);
+}
+
+void operator delete(void* p) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    kota::zest::deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t align) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+void operator delete[](void* p, std::align_val_t align) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept {
+    kota::zest::deallocate(p, align);
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include "kota/zest/detail/bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "kota/zest/detail/alloc.h"
+
+namespace kota::zest {
+
+namespace detail {
+
+void use_char_pointer(const volatile char*) {}
+
+}  // namespace detail
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+/// Calibration stops growing a sample here, whatever the operation costs.
+constexpr std::uint64_t max_iterations = std::uint64_t(1) << 40;
+
+/// Latencies kept for the percentiles.
+constexpr std::size_t max_latencies = std::size_t(1) << 16;
+
+/// Nearest rank: the smallest of the sorted `values` that at least a
+/// `fraction` of them do not exceed.
+double percentile(const std::vector<double>& values, double fraction) {
+    const auto size = static_cast<double>(values.size());
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * size));
+    return values[std::max<std::size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+void Bench::record_latency(std::chrono::nanoseconds latency) {
+    const auto value = static_cast<double>(latency.count());
+    this->latencies_seen += 1;
+    this->latency_peak = std::max(this->latency_peak, value);
+    if(this->latencies.size() < max_latencies) {
+        if(this->latencies.capacity() == 0) {
+            // The first call is a warmup one, so sampling never allocates.
+            this->latencies.reserve(max_latencies);
+        }
+        this->latencies.push_back(value);
+        return;
+    }
+
+    // Keep each of the values seen so far with the same probability.
+    auto& x = this->reservoir_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    const auto slot = x % this->latencies_seen;
+    if(slot < max_latencies) {
+        this->latencies[slot] = value;
+    }
+}
+
+void Bench::measure(const void* op, invoker_t invoke) {
+    auto time = [&](std::uint64_t iterations) {
+        auto begin = bench_clock::now();
+        invoke(op, iterations);
+        return bench_clock::now() - begin;
+    };
+
+    // Warm caches, branch predictors and lazily initialized state.
+    const auto warmup_end = bench_clock::now() + this->warmup_time;
+    do {
+        invoke(op, 1);
+    } while(bench_clock::now() < warmup_end);
+
+    // Grow the sample until it is long enough for the clock to resolve it,
+    // jumping close to the target once a sample is long enough to predict it.
+    std::uint64_t iterations = 1;
+    while(iterations < max_iterations) {
+        auto elapsed = time(iterations);
+        if(elapsed >= this->sample_time) {
+            break;
+        }
+        if(elapsed * 100 < this->sample_time) {
+            iterations *= 10;
+        } else {
+            const auto ratio = static_cast<double>(this->sample_time.count()) /
+                               static_cast<double>(std::max<bench_clock::rep>(elapsed.count(), 1));
+            iterations = std::max(iterations + 1,
+                                  static_cast<std::uint64_t>(static_cast<double>(iterations) *
+                                                             ratio * 1.1));
+        }
+    }
+    iterations = std::min(iterations, max_iterations);
+
+    std::vector<double> per_iteration;
+    per_iteration.reserve(this->sample_count);
+    // Only the latencies of the samples count.
+    this->latencies.clear();
+    this->latencies_seen = 0;
+    this->latency_peak = 0;
+    // Taken around the whole loop: the vector above is the only allocation
+    // of the harness itself, and it is already reserved.
+    const auto allocs_before = thread_allocations();
+    for(std::size_t sample = 0; sample < this->sample_count; ++sample) {
+        const auto elapsed = std::chrono::duration<double, std::nano>(time(iterations));
+        per_iteration.push_back(elapsed.count() / static_cast<double>(iterations));
+    }
+    const auto allocs_after = thread_allocations();
+
+    auto& stats = this->result;
+    stats.iterations = iterations;
+    stats.samples = per_iteration.size();
+
+    const auto total = static_cast<double>(iterations) * static_cast<double>(stats.samples);
+    stats.allocations =
+        static_cast<double>(allocs_after.allocations - allocs_before.allocations) / total;
+    stats.allocated_bytes = static_cast<double>(allocs_after.bytes - allocs_before.bytes) / total;
+
+    std::ranges::sort(per_iteration);
+    const auto n = per_iteration.size();
+    double sum = 0;
+    for(auto value: per_iteration) {
+        sum += value;
+    }
+    stats.mean_ns = sum / static_cast<double>(n);
+
+    double squares = 0;
+    for(auto value: per_iteration) {
+        squares += (value - stats.mean_ns) * (value - stats.mean_ns);
+    }
+    stats.stddev_ns = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+
+    stats.median_ns = n % 2 == 1 ? per_iteration[n / 2]
+                                 : (per_iteration[n / 2 - 1] + per_iteration[n / 2]) / 2;
+    stats.p99_ns = percentile(per_iteration, 0.99);
+    stats.min_ns = per_iteration.front();
+    stats.max_ns = per_iteration.back();
+
+    if(this->items_per_iteration != 0 && stats.mean_ns > 0) {
+        stats.items_per_second =
+            static_cast<double>(this->items_per_iteration) * 1e9 / stats.mean_ns;
+    }
+
+    stats.latency_count = this->latencies_seen;
+    if(!this->latencies.empty()) {
+        std::ranges::sort(this->latencies);
+        stats.latency_p50_ns = percentile(this->latencies, 0.50);
+        stats.latency_p90_ns = percentile(this->latencies, 0.90);
+        stats.latency_p99_ns = percentile(this->latencies, 0.99);
+        stats.latency_max_ns = this->latency_peak;
+    }
+}
+
+}  // namespace kota::zest
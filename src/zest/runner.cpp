@@ -1,7 +1,9 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <csignal>
 #include <expected>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <print>
@@ -14,9 +16,14 @@
 
 #include "kota/deco/deco.h"
 #include "kota/deco/detail/text.h"
+#include "kota/zest/detail/bench.h"
 #include "kota/zest/detail/registry.h"
 #include "kota/zest/run.h"
 
+#if KOTA_ZEST_ENABLE_PROCESS
+#include "kota/async/async.h"
+#endif
+
 namespace {
 
 constexpr std::string_view wildcard_pattern = "*";
@@ -48,6 +55,46 @@ struct ZestCliOptions {
         help = "Number of worker threads for parallel mode (default: hardware_concurrency)";
         required = false)
     <unsigned> parallel_workers = 0;
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--jobs"};
+                 meta_var = "<N>";
+                 help = "Run each test case in its own process, N at a time";
+                 required = false)
+    <unsigned> jobs = 0;
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--shard-index"};
+                 meta_var = "<N>";
+                 help = "Index of the shard to run, from 0 to --shard-count - 1";
+                 required = false)
+    <unsigned> shard_index = 0;
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--shard-count"};
+                 meta_var = "<N>";
+                 help = "Split the selected tests into N shards and run one of them";
+                 required = false)
+    <unsigned> shard_count = 1;
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--timeout"};
+                 meta_var = "<MS>";
+                 help = "Fail test cases that run longer than MS milliseconds";
+                 required = false)
+    <unsigned> timeout = 0;
+
+    DecoFlag(names = {"--zest-worker"}; help = "Internal: run as a child process of --jobs";
+             required = false)
+    worker = false;
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--bench-filter"};
+                 meta_var = "<PATTERN>";
+                 help = "Run the benchmarks matching PATTERN instead of the tests";
+                 required = false)
+    <std::string> bench_filter = "";
+
+    DecoKVStyled(kota::deco::decl::KVStyle::JoinedOrSeparate, names = {"--bench-json"};
+                 meta_var = "<PATH>";
+                 help = "Write benchmark results to PATH as JSON";
+                 required = false)
+    <std::string> bench_json = "";
 };
 
 auto to_runner_options(ZestCliOptions options)
@@ -56,10 +103,27 @@ auto to_runner_options(ZestCliOptions options)
         return std::unexpected("cannot use both positional filter and --test-filter");
     }
 
+    if(*options.jobs != 0 && *options.parallel) {
+        return std::unexpected("cannot use both --jobs and --parallel");
+    }
+    if(*options.shard_count == 0) {
+        return std::unexpected("--shard-count must be at least 1");
+    }
+    if(*options.shard_index >= *options.shard_count) {
+        return std::unexpected("--shard-index must be less than --shard-count");
+    }
+
     kota::zest::RunnerOptions runner_options;
     runner_options.only_failed_output = *options.only_failed;
     runner_options.parallel = *options.parallel;
     runner_options.parallel_workers = *options.parallel_workers;
+    runner_options.jobs = *options.jobs;
+    runner_options.shard_index = *options.shard_index;
+    runner_options.shard_count = *options.shard_count;
+    runner_options.timeout_ms = *options.timeout;
+    runner_options.worker = *options.worker;
+    runner_options.bench_filter = std::move(*options.bench_filter);
+    runner_options.bench_json = std::move(*options.bench_json);
     if(options.test_filter_input.has_value()) {
         runner_options.filter = std::move(*options.test_filter_input);
     } else {
@@ -94,6 +158,19 @@ struct TestResult {
     std::size_t line;
     kota::zest::TestState state;
     std::chrono::milliseconds duration;
+    /// Why the test failed when its assertions did not say, e.g. a timeout.
+    std::string note = {};
+    /// What an isolated test printed, shown when it fails.
+    std::string output = {};
+};
+
+struct RunnableTest {
+    std::string suite_name;
+    std::string display_name;
+    std::string path;
+    std::size_t line;
+    bool serial;
+    std::function<kota::zest::TestState()> test;
 };
 
 using SuiteMap = std::unordered_map<std::string, std::vector<kota::zest::TestCase>>;
@@ -194,16 +271,19 @@ bool is_failure(kota::zest::TestState state) {
     return state == kota::zest::TestState::Failed || state == kota::zest::TestState::Fatal;
 }
 
-void print_run_result(std::string_view display_name,
-                      bool failed,
-                      std::chrono::milliseconds duration,
-                      bool only_failed_output) {
+void print_run_result(const TestResult& result, bool only_failed_output) {
+    const bool failed = is_failure(result.state);
+    if(failed) {
+        std::print("{}", result.output);
+    }
     if(failed || !only_failed_output) {
-        std::println("{0}[   {1} ] {2} ({3} ms){4}",
+        std::println("{0}[   {1} ] {2} ({3} ms{4}{5}){6}",
                      failed ? red : green,
                      failed ? "FAILED" : "    OK",
-                     display_name,
-                     duration.count(),
+                     result.display_name,
+                     result.duration.count(),
+                     result.note.empty() ? "" : ", ",
+                     result.note,
                      clear);
     }
 }
@@ -238,12 +318,219 @@ void print_summary(const RunSummary& summary) {
     }
 }
 
+struct BenchRecord {
+    std::string display_name;
+    std::string path;
+    std::size_t line;
+    kota::zest::BenchStats stats;
+};
+
+auto format_time(double ns) -> std::string {
+    if(ns < 1e3) {
+        return std::format("{:.2f} ns", ns);
+    }
+    if(ns < 1e6) {
+        return std::format("{:.2f} us", ns / 1e3);
+    }
+    if(ns < 1e9) {
+        return std::format("{:.2f} ms", ns / 1e6);
+    }
+    return std::format("{:.2f} s", ns / 1e9);
+}
+
+auto json_string(std::string_view text) -> std::string {
+    std::string out = "\"";
+    for(char c: text) {
+        switch(c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+bool write_bench_json(const std::string& path, const std::vector<BenchRecord>& records) {
+    std::ofstream out(path, std::ios::binary);
+    if(!out) {
+        return false;
+    }
+
+    out << "{\n  \"benchmarks\": [";
+    for(std::size_t i = 0; i < records.size(); ++i) {
+        const auto& record = records[i];
+        const auto& stats = record.stats;
+        out << (i == 0 ? "\n" : ",\n");
+        out << std::format("    {{\"name\": {}, \"path\": {}, \"line\": {}, "
+                           "\"iterations\": {}, \"samples\": {}, "
+                           "\"mean_ns\": {}, \"median_ns\": {}, \"stddev_ns\": {}, "
+                           "\"p99_ns\": {}, \"min_ns\": {}, \"max_ns\": {}, "
+                           "\"allocations_per_iteration\": {}, \"bytes_per_iteration\": {}, "
+                           "\"items_per_second\": {}, \"latency_count\": {}, "
+                           "\"latency_p50_ns\": {}, \"latency_p90_ns\": {}, "
+                           "\"latency_p99_ns\": {}, \"latency_max_ns\": {}}}",
+                           json_string(record.display_name),
+                           json_string(record.path),
+                           record.line,
+                           stats.iterations,
+                           stats.samples,
+                           stats.mean_ns,
+                           stats.median_ns,
+                           stats.stddev_ns,
+                           stats.p99_ns,
+                           stats.min_ns,
+                           stats.max_ns,
+                           stats.allocations,
+                           stats.allocated_bytes,
+                           stats.items_per_second,
+                           stats.latency_count,
+                           stats.latency_p50_ns,
+                           stats.latency_p90_ns,
+                           stats.latency_p99_ns,
+                           stats.latency_max_ns);
+    }
+    out << (records.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    return static_cast<bool>(out);
+}
+
+#if KOTA_ZEST_ENABLE_PROCESS
+
+#ifdef SIGKILL
+constexpr int kill_signal = SIGKILL;
+#else
+constexpr int kill_signal = SIGTERM;
+#endif
+
+/// Run `test` in a child process of the test binary, which --zest-worker
+/// limits to that test, and kill the child once it runs past `timeout`.
+kota::task<TestResult> run_isolated(const RunnableTest& test,
+                                    const std::string& executable,
+                                    std::chrono::milliseconds timeout,
+                                    kota::event_loop& loop) {
+    TestResult result{
+        .display_name = test.display_name,
+        .path = test.path,
+        .line = test.line,
+        .state = kota::zest::TestState::Failed,
+        .duration = std::chrono::milliseconds(0),
+    };
+
+    kota::process::options opts;
+    opts.file = executable;
+    opts.args = {executable, "--zest-worker", "--test-filter", test.display_name};
+    opts.streams = {kota::process::stdio::ignore(),
+                    kota::process::stdio::pipe(false, true),
+                    kota::process::stdio::pipe(false, true)};
+
+    using namespace std::chrono;
+    auto begin = steady_clock::now();
+    auto spawned = kota::process::spawn(opts, loop);
+    if(!spawned) {
+        result.note = std::format("cannot start {}: {}", executable, spawned.error().message());
+        co_return result;
+    }
+    { auto drop = std::move(spawned->stdin_pipe); }
+
+    bool timed_out = false;
+    auto supervise = [&]() -> kota::task<kota::process::wait_result> {
+        if(timeout.count() == 0) {
+            co_return co_await spawned->proc.wait();
+        }
+        kota::deadline limit(timeout, loop);
+        auto status =
+            co_await kota::with_token(spawned->proc.wait(), limit.token()).catch_cancel();
+        if(!status.is_cancelled()) {
+            co_return std::move(*status);
+        }
+        timed_out = true;
+        spawned->proc.kill(kill_signal);
+        co_return co_await spawned->proc.wait();
+    };
+
+    // Both streams go to one buffer, so the output keeps its order.
+    auto keep = [&result](std::string_view chunk) {
+        result.output.append(chunk);
+    };
+    auto done = co_await kota::when_all(kota::process::drain_output(spawned->stdout_pipe, keep),
+                                        kota::process::drain_output(spawned->stderr_pipe, keep),
+                                        supervise());
+    result.duration = duration_cast<milliseconds>(steady_clock::now() - begin);
+    if(done.has_error()) {
+        result.note = std::format("lost track of its process: {}", done.error().message());
+        co_return result;
+    }
+
+    const auto& status = std::get<2>(*done);
+    if(timed_out) {
+        result.note = std::format("timed out after {} ms", timeout.count());
+    } else if(status.term_signal != 0) {
+        result.note = std::format("killed by signal {}", status.term_signal);
+    } else if(status.status == 0) {
+        result.state = kota::zest::TestState::Passed;
+    } else if(status.status != 1) {
+        result.note = std::format("exited with code {}", status.status);
+    }
+    co_return result;
+}
+
+/// Run every test in a child process, `options.jobs` at a time; serial
+/// tests run one by one after the others.
+void run_in_processes(const std::vector<RunnableTest>& runnable,
+                      const kota::zest::RunnerOptions& options,
+                      const std::function<void(const TestResult&)>& record) {
+    std::vector<std::size_t> parallel_indices;
+    std::vector<std::size_t> serial_indices;
+    for(std::size_t i = 0; i < runnable.size(); ++i) {
+        (runnable[i].serial ? serial_indices : parallel_indices).push_back(i);
+    }
+
+    kota::event_loop loop;
+    const auto timeout = std::chrono::milliseconds(options.timeout_ms);
+    std::size_t next_task = 0;
+
+    auto worker = [&]() -> kota::task<> {
+        while(next_task < parallel_indices.size()) {
+            const auto& test = runnable[parallel_indices[next_task++]];
+            record(co_await run_isolated(test, options.executable, timeout, loop));
+        }
+    };
+
+    auto drive = [&]() -> kota::task<> {
+        const auto num_workers = std::min<std::size_t>(options.jobs, parallel_indices.size());
+        if(num_workers != 0) {
+            std::vector<kota::task<>> workers;
+            workers.reserve(num_workers);
+            for(std::size_t w = 0; w < num_workers; ++w) {
+                workers.push_back(worker());
+            }
+            co_await kota::when_all(std::move(workers));
+        }
+        for(auto i: serial_indices) {
+            record(co_await run_isolated(runnable[i], options.executable, timeout, loop));
+        }
+        loop.stop();
+    };
+
+    loop.schedule(drive());
+    loop.run();
+}
+
+#endif
+
 }  // namespace
 
 namespace kota::zest {
 
 int run_cli(int argc, char** argv, std::string_view command_overview) {
-    auto args = kota::deco::util::argvify(argc, argv);
+    auto args = kota::deco::util::borrow_argv(argc, argv);
     auto renderer = kota::deco::cli::text::ModernRenderer();
     kota::deco::cli::Command<ZestCliOptions> command(command_overview);
     command.render_with(renderer);
@@ -261,6 +548,9 @@ int run_cli(int argc, char** argv, std::string_view command_overview) {
         command.usage(std::cerr);
         std::exit(1);
     }
+    if(argc > 0) {
+        options->executable = argv[0];
+    }
 
     return run_tests(std::move(*options));
 }
@@ -282,33 +572,48 @@ void Runner::add_suite(std::string_view name, std::vector<TestCase> (*cases)())
     suites.emplace_back(std::string(name), cases);
 }
 
+void Runner::add_bench_suite(std::string_view name, std::vector<BenchCase> (*cases)()) {
+    bench_suites.emplace_back(std::string(name), cases);
+}
+
 int Runner::run_tests(std::string_view filter) {
     return run_tests(RunnerOptions{.filter = std::string(filter)});
 }
 
 int Runner::run_tests(RunnerOptions options) {
+    if(!options.bench_filter.empty()) {
+        return run_benchmarks(options);
+    }
+
     const auto patterns = resolve_filter_patterns(options.filter);
     auto grouped_suites = group_suites(suites);
     const bool focus_mode = has_focused_tests(grouped_suites, patterns);
+    // Workers of --jobs report through their output and exit code alone.
+    const bool quiet = options.worker;
+    const bool isolated = options.jobs != 0 && !options.worker;
+    if(isolated) {
+#if KOTA_ZEST_ENABLE_PROCESS
+        if(options.executable.empty()) {
+            std::println("{}[  ERROR   ] --jobs needs the path of the test binary.{}", red, clear);
+            return 1;
+        }
+#else
+        std::println("{}[  ERROR   ] --jobs needs zest built with kota::async.{}", red, clear);
+        return 1;
+#endif
+    }
 
     RunSummary summary;
 
-    std::println("{}[----------] Global test environment set-up.{}", green, clear);
-    if(focus_mode) {
-        std::println("{}[  FOCUS   ] Running in focus-only mode.{}", yellow, clear);
+    if(!quiet) {
+        std::println("{}[----------] Global test environment set-up.{}", green, clear);
+        if(focus_mode) {
+            std::println("{}[  FOCUS   ] Running in focus-only mode.{}", yellow, clear);
+        }
     }
 
     // Collect all runnable test cases.
-    struct RunnableTest {
-        std::string display_name;
-        std::string path;
-        std::size_t line;
-        bool serial;
-        std::function<TestState()> test;
-    };
-
     std::vector<RunnableTest> runnable;
-    std::unordered_set<std::string> active_suites;
 
     for(auto& [suite_name, test_cases]: grouped_suites) {
         if(!matches_suite_filter(suite_name, patterns)) {
@@ -328,15 +633,15 @@ int Runner::run_tests(RunnerOptions options) {
             }
 
             if(test_case.attrs.skip) {
-                if(!options.only_failed_output) {
+                if(!options.only_failed_output && !quiet) {
                     std::println("{}[ SKIPPED  ] {}{}", yellow, display_name, clear);
                 }
                 summary.skipped += 1;
                 continue;
             }
 
-            active_suites.insert(std::string(suite_name));
             runnable.push_back(RunnableTest{
+                .suite_name = suite_name,
                 .display_name = display_name,
                 .path = test_case.path,
                 .line = test_case.line,
@@ -346,11 +651,33 @@ int Runner::run_tests(RunnerOptions options) {
         }
     }
 
+    // The same binary always selects the same tests in the same order, so
+    // taking every shard_count-th of them splits a run without coordination.
+    if(options.shard_count > 1) {
+        std::vector<RunnableTest> shard;
+        for(std::size_t i = options.shard_index; i < runnable.size(); i += options.shard_count) {
+            shard.push_back(std::move(runnable[i]));
+        }
+        runnable = std::move(shard);
+    }
+
+    if(quiet && runnable.empty()) {
+        // The parent asked for a test that is not there; do not pass it.
+        return 2;
+    }
+
+    std::unordered_set<std::string_view> active_suites;
+    for(const auto& test: runnable) {
+        active_suites.insert(test.suite_name);
+    }
+
     summary.suites = static_cast<std::uint32_t>(active_suites.size());
     summary.tests = static_cast<std::uint32_t>(runnable.size());
 
+    const auto timeout = std::chrono::milliseconds(options.timeout_ms);
+
     auto run_single = [&](const RunnableTest& test, bool show_run_line) -> TestResult {
-        if(show_run_line && !options.only_failed_output) {
+        if(show_run_line && !options.only_failed_output && !quiet) {
             std::println("{}[ RUN      ] {}{}", green, test.display_name, clear);
         }
 
@@ -359,18 +686,26 @@ int Runner::run_tests(RunnerOptions options) {
         auto state = test.test();
         auto end = system_clock::now();
 
-        return TestResult{
+        TestResult result{
             .display_name = test.display_name,
             .path = test.path,
             .line = test.line,
             .state = state,
             .duration = duration_cast<milliseconds>(end - begin),
         };
+        // Without a process of its own a test cannot be stopped, only failed.
+        if(timeout.count() != 0 && result.duration > timeout && !is_failure(result.state)) {
+            result.state = TestState::Failed;
+            result.note = std::format("timed out after {} ms", timeout.count());
+        }
+        return result;
     };
 
     auto record_result = [&](const TestResult& result) {
         const bool failed = is_failure(result.state);
-        print_run_result(result.display_name, failed, result.duration, options.only_failed_output);
+        if(!quiet) {
+            print_run_result(result, options.only_failed_output);
+        }
         summary.duration += result.duration;
         if(failed) {
             summary.failed += 1;
@@ -380,9 +715,16 @@ int Runner::run_tests(RunnerOptions options) {
     };
 
     // Execute tests.
-    std::vector<TestResult> results(runnable.size());
+    if(isolated) {
+#if KOTA_ZEST_ENABLE_PROCESS
+        using namespace std::chrono;
+        auto wall_begin = system_clock::now();
+        run_in_processes(runnable, options, record_result);
+        summary.duration = duration_cast<milliseconds>(system_clock::now() - wall_begin);
+#endif
+    } else if(options.parallel) {
+        std::vector<TestResult> results(runnable.size());
 
-    if(options.parallel) {
         using namespace std::chrono;
         auto wall_begin = system_clock::now();
 
@@ -434,30 +776,113 @@ int Runner::run_tests(RunnerOptions options) {
             results[i] = run_single(runnable[i], false);
         }
 
-        summary.duration = duration_cast<milliseconds>(system_clock::now() - wall_begin);
-
         // Print all results in original order.
         for(const auto& result: results) {
-            const bool failed = is_failure(result.state);
-            print_run_result(result.display_name,
-                             failed,
-                             result.duration,
-                             options.only_failed_output);
-            if(failed) {
-                summary.failed += 1;
-                summary.failed_tests.push_back(
-                    FailedTest{result.display_name, result.path, result.line});
-            }
+            record_result(result);
         }
+
+        summary.duration = duration_cast<milliseconds>(system_clock::now() - wall_begin);
     } else {
-        for(std::size_t i = 0; i < runnable.size(); ++i) {
-            results[i] = run_single(runnable[i], true);
-            record_result(results[i]);
+        for(const auto& test: runnable) {
+            record_result(run_single(test, true));
         }
     }
 
-    print_summary(summary);
+    if(!quiet) {
+        print_summary(summary);
+    }
     return summary.failed != 0;
 }
 
+int Runner::run_benchmarks(const RunnerOptions& options) {
+    const auto patterns = resolve_filter_patterns(options.bench_filter);
+
+    struct RunnableBench {
+        std::string display_name;
+        BenchCase bench;
+    };
+
+    std::vector<RunnableBench> runnable;
+    for(const auto& suite: bench_suites) {
+        if(!matches_suite_filter(suite.name, patterns)) {
+            continue;
+        }
+        for(auto& bench_case: suite.cases()) {
+            if(!matches_test_filter(suite.name, bench_case.name, patterns)) {
+                continue;
+            }
+            runnable.push_back(RunnableBench{
+                .display_name = make_display_name(suite.name, bench_case.name),
+                .bench = std::move(bench_case),
+            });
+        }
+    }
+    std::ranges::sort(runnable, {}, &RunnableBench::display_name);
+
+    std::println("{}[----------] Benchmark environment set-up.{}", green, clear);
+
+    std::vector<BenchRecord> records;
+    std::uint32_t failed = 0;
+    std::uint32_t skipped = 0;
+    for(auto& [display_name, bench_case]: runnable) {
+        if(bench_case.attrs.skip) {
+            std::println("{}[ SKIPPED  ] {}{}", yellow, display_name, clear);
+            skipped += 1;
+            continue;
+        }
+
+        std::println("{}[ BENCH    ] {}{}", green, display_name, clear);
+        Bench bench;
+        auto state = bench_case.bench(bench);
+        if(is_failure(state) || !bench.measured()) {
+            std::println("{}[   FAILED ] {}{}{}",
+                         red,
+                         display_name,
+                         bench.measured() ? "" : " (never called Bench::run)",
+                         clear);
+            failed += 1;
+            continue;
+        }
+
+        const auto& stats = bench.stats();
+        std::println("{}[     DONE ] {}{}", green, display_name, clear);
+        std::println("             mean {}, median {}, stddev {}, p99 {}",
+                     format_time(stats.mean_ns),
+                     format_time(stats.median_ns),
+                     format_time(stats.stddev_ns),
+                     format_time(stats.p99_ns));
+        std::println("             {:.2f} allocations, {:.1f} bytes per iteration, {} x {}",
+                     stats.allocations,
+                     stats.allocated_bytes,
+                     stats.samples,
+                     stats.iterations);
+        if(stats.items_per_second != 0) {
+            std::println("             {:.4g} items per second", stats.items_per_second);
+        }
+        if(stats.latency_count != 0) {
+            std::println("             latency p50 {}, p90 {}, p99 {}, max {} over {} operations",
+                         format_time(stats.latency_p50_ns),
+                         format_time(stats.latency_p90_ns),
+                         format_time(stats.latency_p99_ns),
+                         format_time(stats.latency_max_ns),
+                         stats.latency_count);
+        }
+        records.push_back(BenchRecord{display_name, bench_case.path, bench_case.line, stats});
+    }
+
+    std::println("{}[==========] {} benchmarks ran.{}", green, records.size() + failed, clear);
+    if(skipped > 0) {
+        std::println("{}[  SKIPPED ] {} benchmarks.{}", yellow, skipped, clear);
+    }
+    if(failed > 0) {
+        std::println("{}[  FAILED  ] {} benchmarks.{}", red, failed, clear);
+    }
+
+    if(!options.bench_json.empty() && !write_bench_json(options.bench_json, records)) {
+        std::println("{}[  ERROR   ] cannot write {}.{}", red, options.bench_json, clear);
+        return 1;
+    }
+    return failed != 0;
+}
+
 }  // namespace kota::zest
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "kota/ipc/protocol.h"
+
+namespace kota::ipc {
+
+/// The request ipc_throughput sends; the stub server's bench mode echoes
+/// the payload back.
+struct EchoParams {
+    std::string payload;
+};
+
+struct EchoResult {
+    std::string payload;
+};
+
+}  // namespace kota::ipc
+
+namespace kota::ipc::protocol {
+
+template <>
+struct RequestTraits<EchoParams> {
+    using Result = EchoResult;
+    constexpr inline static std::string_view method = "bench/echo";
+};
+
+}  // namespace kota::ipc::protocol
@@ -0,0 +1,336 @@
+// End-to-end IPC throughput: drives the stub server's bench mode with a
+// Peer over each transport and codec, sweeping payload size and the number
+// of requests in flight, and prints one row per combination.
+//
+//   ipc_throughput <lsp_stub_server> [--quick]
+//
+// Numbers are for comparing runs on one machine, e.g. before and after a
+// change; --quick runs a smaller sweep, for CI smoke runs.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bench_protocol.h"
+#include "kota/ipc/codec/bincode.h"
+#include "kota/ipc/codec/json.h"
+#include "kota/ipc/unix_transport.h"
+
+namespace et = kota;
+namespace ipc = et::ipc;
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+enum class link { stdio, tcp, unix_socket };
+
+std::string_view link_name(link kind) {
+    switch(kind) {
+        case link::stdio: return "stdio";
+        case link::tcp: return "tcp";
+        case link::unix_socket: return "unix";
+    }
+    return "?";
+}
+
+struct sweep_point {
+    link kind;
+    std::size_t payload;
+    std::size_t concurrency;
+    std::size_t requests;
+};
+
+struct measurement {
+    double requests_per_second = 0;
+    double p50_us = 0;
+    double p99_us = 0;
+    double p999_us = 0;
+
+    /// User plus system CPU time per request, on each side.
+    double client_cpu_us = 0;
+    double server_cpu_us = 0;
+};
+
+/// A spawned server and the client end of its link.
+struct connection {
+    et::process proc;
+    std::unique_ptr<ipc::Transport> transport;
+};
+
+std::uint64_t cpu_time_us(const et::result<et::process_info>& info) {
+    return info ? info->utime_us + info->stime_us : 0;
+}
+
+double percentile_us(const std::vector<bench_clock::duration>& sorted, double q) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    auto index = std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1);
+    return std::chrono::duration<double, std::micro>(sorted[index]).count();
+}
+
+/// Spawns the stub server in bench mode and links up with it.
+et::task<connection, ipc::Error> launch(const std::string& server,
+                                        std::string_view codec,
+                                        link kind,
+                                        et::event_loop& loop) {
+    et::process::options opts;
+    opts.file = server;
+    opts.args = {server, "--bench", std::string(codec), std::string(link_name(kind))};
+
+    if(kind == link::stdio) {
+        opts.streams = {
+            et::process::stdio::pipe(true, false),
+            et::process::stdio::pipe(false, true),
+            et::process::stdio::inherit(),
+        };
+        auto spawned = et::process::spawn(opts, loop);
+        if(!spawned) {
+            co_await et::fail(std::string(spawned.error().message()));
+        }
+        co_return connection{
+            std::move(spawned->proc),
+            std::make_unique<ipc::StreamTransport>(std::move(spawned->stdout_pipe),
+                                                   std::move(spawned->stdin_pipe)),
+        };
+    }
+
+    opts.streams = {
+        et::process::stdio::ignore(),
+        et::process::stdio::ignore(),
+        et::process::stdio::inherit(),
+    };
+
+    if(kind == link::tcp) {
+        auto listening = et::tcp::listen("127.0.0.1", 0, et::tcp::options(), loop);
+        if(!listening) {
+            co_await et::fail(std::string(listening.error().message()));
+        }
+        auto port = et::tcp::local_port(*listening);
+        if(!port) {
+            co_await et::fail(std::string(port.error().message()));
+        }
+
+        opts.args.push_back(std::to_string(*port));
+        auto spawned = et::process::spawn(opts, loop);
+        if(!spawned) {
+            co_await et::fail(std::string(spawned.error().message()));
+        }
+        auto accepted = co_await listening->accept();
+        if(!accepted) {
+            co_await et::fail(std::string(accepted.error().message()));
+        }
+        co_return connection{
+            std::move(spawned->proc),
+            std::make_unique<ipc::StreamTransport>(et::stream(std::move(*accepted))),
+        };
+    }
+
+    auto path = (std::filesystem::temp_directory_path() /
+                 std::format("kota-ipc-throughput-{}.sock", et::process::current_pid()))
+                    .string();
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+
+    auto listening = co_await et::or_fail(ipc::UnixSocketTransport::listen(path, loop));
+    opts.args.push_back(path);
+    auto spawned = et::process::spawn(opts, loop);
+    if(!spawned) {
+        co_await et::fail(std::string(spawned.error().message()));
+    }
+    auto accepted = co_await listening.accept();
+    std::filesystem::remove(path, ignored);
+    if(!accepted) {
+        co_await et::fail(std::string(accepted.error().message()));
+    }
+    co_return connection{
+        std::move(spawned->proc),
+        std::make_unique<ipc::UnixSocketTransport>(std::move(*accepted)),
+    };
+}
+
+/// Sends `count` echo requests one after another, recording each latency.
+template <typename Peer>
+et::task<bool> echo_loop(Peer& peer,
+                         const std::string& payload,
+                         std::size_t count,
+                         std::vector<bench_clock::duration>& latencies) {
+    for(std::size_t i = 0; i < count; ++i) {
+        const auto sent = bench_clock::now();
+        auto reply = co_await peer.send_request(ipc::EchoParams{.payload = payload});
+        latencies.push_back(bench_clock::now() - sent);
+        if(!reply || reply->payload.size() != payload.size()) {
+            co_return false;
+        }
+    }
+    co_return true;
+}
+
+template <typename Peer>
+et::task<measurement, ipc::Error> measure(const std::string& server,
+                                          std::string_view codec,
+                                          sweep_point point,
+                                          et::event_loop& loop) {
+    auto linked = co_await launch(server, codec, point.kind, loop).or_fail();
+    Peer peer(loop, std::move(linked.transport));
+
+    const std::string payload(point.payload, 'x');
+    const auto per_worker = std::max<std::size_t>(1, point.requests / point.concurrency);
+    std::vector<std::vector<bench_clock::duration>> latencies(point.concurrency);
+    bench_clock::duration elapsed{};
+    std::uint64_t client_cpu = 0;
+    std::uint64_t server_cpu = 0;
+    bool succeeded = true;
+
+    auto drive = [&]() -> et::task<> {
+        std::vector<bench_clock::duration> warmup;
+        succeeded = co_await echo_loop(peer, payload, 64, warmup);
+
+        // Each worker keeps one request in flight; together they keep
+        // `concurrency` of them.
+        et::small_vector<et::task<bool>> workers;
+        for(auto& recorded: latencies) {
+            recorded.reserve(per_worker);
+            workers.push_back(echo_loop(peer, payload, per_worker, recorded));
+        }
+
+        const auto self = et::process::current_pid();
+        const auto client_before = cpu_time_us(et::process::query_info(self));
+        const auto server_before = cpu_time_us(linked.proc.query_info());
+        const auto start = bench_clock::now();
+
+        if(succeeded) {
+            auto results = co_await et::when_all(std::move(workers));
+            succeeded = std::ranges::find(results, false) == results.end();
+        }
+
+        elapsed = bench_clock::now() - start;
+        client_cpu = cpu_time_us(et::process::query_info(self)) - client_before;
+        server_cpu = cpu_time_us(linked.proc.query_info()) - server_before;
+
+        // Closing our output ends the server, and its exit ends run().
+        (void)peer.close_output();
+    };
+
+    co_await et::when_all(peer.run(), drive());
+    (void)co_await linked.proc.wait();
+
+    if(!succeeded) {
+        co_await et::fail("request failed");
+    }
+
+    std::vector<bench_clock::duration> all;
+    all.reserve(per_worker * point.concurrency);
+    for(auto& recorded: latencies) {
+        all.insert(all.end(), recorded.begin(), recorded.end());
+    }
+    std::ranges::sort(all);
+
+    const auto total = static_cast<double>(all.size());
+    measurement result;
+    result.requests_per_second = total / std::chrono::duration<double>(elapsed).count();
+    result.p50_us = percentile_us(all, 0.50);
+    result.p99_us = percentile_us(all, 0.99);
+    result.p999_us = percentile_us(all, 0.999);
+    result.client_cpu_us = static_cast<double>(client_cpu) / total;
+    result.server_cpu_us = static_cast<double>(server_cpu) / total;
+    co_return result;
+}
+
+et::task<int> run_sweep(std::string server, bool quick, et::event_loop& loop) {
+    std::vector<link> links = {link::stdio, link::tcp};
+#ifndef _WIN32
+    links.push_back(link::unix_socket);
+#endif
+    const std::vector<std::size_t> payloads =
+        quick ? std::vector<std::size_t>{64, 4096} : std::vector<std::size_t>{64, 4096, 65536};
+    const std::vector<std::size_t> concurrencies =
+        quick ? std::vector<std::size_t>{1, 16} : std::vector<std::size_t>{1, 16, 64};
+    const std::size_t requests = quick ? 2000 : 20000;
+
+    std::println("{:<8} {:<6} {:>8} {:>6} {:>12} {:>10} {:>10} {:>10} {:>12} {:>12}",
+                 "codec",
+                 "link",
+                 "payload",
+                 "inflt",
+                 "req/s",
+                 "p50 us",
+                 "p99 us",
+                 "p999 us",
+                 "client us/r",
+                 "server us/r");
+
+    int status = 0;
+    for(std::string_view codec: {"json", "bincode"}) {
+        for(auto kind: links) {
+            for(auto payload: payloads) {
+                for(auto concurrency: concurrencies) {
+                    // Large payloads get fewer requests, so each point
+                    // moves a few hundred megabytes at most.
+                    const auto count = (std::min)(
+                        requests,
+                        (std::max)(std::size_t(1000), (std::size_t(256) << 20) / payload));
+                    sweep_point point{kind, payload, concurrency, count};
+                    auto result = codec == "json"
+                                      ? co_await measure<ipc::JsonPeer>(server, codec, point, loop)
+                                      : co_await measure<ipc::BincodePeer>(server, codec, point, loop);
+                    if(!result) {
+                        std::println(stderr,
+                                     "{} over {}, {} bytes x {}: {}",
+                                     codec,
+                                     link_name(kind),
+                                     payload,
+                                     concurrency,
+                                     result.error().message);
+                        status = 1;
+                        continue;
+                    }
+
+                    std::println(
+                        "{:<8} {:<6} {:>8} {:>6} {:>12.0f} {:>10.1f} {:>10.1f} {:>10.1f} {:>12.2f} {:>12.2f}",
+                        codec,
+                        link_name(kind),
+                        payload,
+                        concurrency,
+                        result->requests_per_second,
+                        result->p50_us,
+                        result->p99_us,
+                        result->p999_us,
+                        result->client_cpu_us,
+                        result->server_cpu_us);
+                }
+            }
+        }
+    }
+    co_return status;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        std::println(stderr, "usage: {} <lsp_stub_server> [--quick]", argv[0]);
+        return 2;
+    }
+
+    const bool quick = argc > 2 && std::string_view(argv[2]) == "--quick";
+    auto server = std::filesystem::absolute(argv[1]).string();
+
+    et::event_loop loop;
+    auto sweep = run_sweep(std::move(server), quick, loop);
+    loop.schedule(sweep);
+    loop.run();
+    return sweep.result();
+}
@@ -1,8 +1,13 @@
+#include <memory>
 #include <print>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "bench_protocol.h"
+#include "kota/ipc/codec/bincode.h"
 #include "kota/ipc/codec/json.h"
+#include "kota/ipc/unix_transport.h"
 #include "kota/ipc/lsp/progress.h"
 #include "kota/ipc/lsp/protocol.h"
 
@@ -47,9 +52,63 @@ auto make_capabilities() -> proto::ServerCapabilities {
     return caps;
 }
 
+/// Connects back to ipc_throughput over the transport it asked for:
+/// `stdio`, `tcp <port>` on localhost or `unix <path>`.
+auto connect_bench(std::string_view kind, std::string_view address, et::event_loop& loop)
+    -> et::task<std::unique_ptr<ipc::Transport>, ipc::Error> {
+    if(kind == "tcp") {
+        co_return co_await ipc::StreamTransport::connect_tcp("127.0.0.1",
+                                                             std::stoi(std::string(address)),
+                                                             loop)
+            .or_fail();
+    }
+    if(kind == "unix") {
+        co_return co_await ipc::UnixSocketTransport::connect(address, loop).or_fail();
+    }
+    co_return co_await et::or_fail(ipc::StreamTransport::open_stdio(loop));
+}
+
+/// Echoes bench/echo requests until the client closes its end.
+template <typename Peer>
+auto serve_bench(std::string_view kind, std::string_view address, et::event_loop& loop)
+    -> et::task<void, ipc::Error> {
+    auto transport = co_await connect_bench(kind, address, loop).or_fail();
+
+    Peer peer(loop, std::move(transport));
+    peer.on_request([](typename Peer::RequestContext&,
+                       const ipc::EchoParams& params) -> ipc::RequestResult<ipc::EchoParams> {
+        co_return ipc::EchoResult{.payload = params.payload};
+    });
+    co_await peer.run();
+}
+
+/// `--bench <json|bincode> <stdio|tcp|unix> [address]`: the other end of
+/// ipc_throughput, without the LSP handlers or logging.
+int run_bench(int argc, char** argv) {
+    std::string_view codec = argc > 2 ? argv[2] : "json";
+    std::string_view kind = argc > 3 ? argv[3] : "stdio";
+    std::string_view address = argc > 4 ? argv[4] : "";
+
+    et::event_loop loop;
+    auto served = codec == "bincode" ? serve_bench<ipc::BincodePeer>(kind, address, loop)
+                                     : serve_bench<ipc::JsonPeer>(kind, address, loop);
+    loop.schedule(served);
+    loop.run();
+
+    if(auto result = served.result(); !result.has_value()) {
+        std::println(stderr, "bench server failed: {}", result.error().message);
+        return 1;
+    }
+    return 0;
+}
+
 }  // namespace
 
-int main() {
+int main(int argc, char** argv) {
+    if(argc > 1 && std::string_view(argv[1]) == "--bench") {
+        return run_bench(argc, argv);
+    }
+
     et::event_loop loop;
     auto transport = ipc::StreamTransport::open_stdio(loop);
     if(!transport) {
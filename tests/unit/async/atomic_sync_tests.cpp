@@ -0,0 +1,151 @@
+#include <atomic>
+#include <thread>
+#include <variant>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(atomic_sync, loop_fixture) {
+
+TEST_CASE(event_already_set) {
+    atomic_event ev(true);
+    EXPECT_TRUE(ev.is_set());
+    bool passed = false;
+
+    auto waiter = [&]() -> task<> {
+        co_await ev.wait();
+        passed = true;
+    };
+
+    auto t = waiter();
+    schedule_all(t);
+    EXPECT_TRUE(passed);
+
+    ev.reset();
+    EXPECT_FALSE(ev.is_set());
+}
+
+TEST_CASE(event_set_from_another_thread) {
+    atomic_event ev;
+    std::atomic<int> woken{0};
+    std::thread setter;
+
+    auto waiter = [&]() -> task<> {
+        co_await ev.wait();
+        woken.fetch_add(1);
+    };
+
+    auto starter = [&]() -> task<> {
+        co_await sleep(1, loop);
+        setter = std::thread([&] { ev.set(); });
+    };
+
+    auto t1 = waiter();
+    auto t2 = waiter();
+    auto t3 = starter();
+    schedule_all(t1, t2, t3);
+    setter.join();
+
+    EXPECT_EQ(woken.load(), 2);
+    EXPECT_TRUE(ev.is_set());
+}
+
+TEST_CASE(event_wakes_waiters_on_their_own_loops) {
+    atomic_event ev;
+    std::thread::id woke_on;
+    std::thread::id worker_id;
+
+    std::thread worker([&] {
+        worker_id = std::this_thread::get_id();
+        event_loop worker_loop;
+        auto waiter = [&]() -> task<> {
+            co_await ev.wait();
+            woke_on = std::this_thread::get_id();
+        };
+        auto t = waiter();
+        worker_loop.schedule(t);
+        worker_loop.run();
+    });
+
+    auto setter = [&]() -> task<> {
+        co_await sleep(10, loop);
+        ev.set();
+    };
+
+    auto t = setter();
+    schedule_all(t);
+    worker.join();
+
+    EXPECT_TRUE(woke_on == worker_id);
+}
+
+TEST_CASE(semaphore_try_acquire) {
+    atomic_semaphore sem(2);
+    EXPECT_EQ(sem.available(), 2);
+    EXPECT_TRUE(sem.try_acquire());
+    EXPECT_TRUE(sem.try_acquire());
+    EXPECT_FALSE(sem.try_acquire());
+    sem.release(3);
+    EXPECT_EQ(sem.available(), 3);
+}
+
+TEST_CASE(semaphore_released_across_threads) {
+    atomic_semaphore sem(0);
+    constexpr int count = 100;
+    int acquired = 0;
+    std::thread releaser;
+
+    auto consumer = [&]() -> task<> {
+        releaser = std::thread([&] {
+            for(int i = 0; i < count; ++i) {
+                sem.release();
+            }
+        });
+        for(int i = 0; i < count; ++i) {
+            co_await sem.acquire();
+            acquired += 1;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+    releaser.join();
+
+    EXPECT_EQ(acquired, count);
+    EXPECT_EQ(sem.available(), 0);
+}
+
+TEST_CASE(cancelled_acquire_keeps_permit) {
+    atomic_semaphore sem(0);
+
+    auto acquire = [&]() -> task<int> {
+        co_await sem.acquire();
+        co_return 1;
+    };
+
+    auto timeout = [&]() -> task<int> {
+        co_await sleep(1, loop);
+        co_return 0;
+    };
+
+    auto race = [&]() -> task<std::variant<int, int>> {
+        co_return co_await when_any(acquire(), timeout());
+    };
+
+    auto t = race();
+    schedule_all(t);
+
+    EXPECT_EQ(t.result().index(), 1U);
+    sem.release();
+    EXPECT_EQ(sem.available(), 1);
+}
+
+};  // TEST_SUITE(atomic_sync)
+
+}  // namespace
+
+}  // namespace kota
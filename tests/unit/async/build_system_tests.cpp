@@ -1,4 +1,8 @@
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
 
 #include "compile_graph.h"
 #include "loop_fixture.h"
@@ -157,6 +161,99 @@ TEST_CASE(shared_dependency_compiled_once) {
     EXPECT_EQ(compile_count, 3);
 }
 
+TEST_CASE(build_compiles_each_unit_once) {
+    int compile_count = 0;
+    CompileGraph graph([&] {
+        compile_count += 1;
+        return 2ms;
+    });
+    graph.add_unit("lexer.h");
+    graph.add_unit("parser.h");
+    graph.add_unit("codegen.h");
+    graph.add_unit("lexer.cpp", {"lexer.h"});
+    graph.add_unit("main.cpp", {"parser.h", "codegen.h"});
+
+    auto test = [&]() -> task<> {
+        std::string targets[] = {"main.cpp", "lexer.cpp"};
+        auto result = co_await graph.build(targets, 2, loop).catch_cancel();
+        EXPECT_TRUE(result.has_value());
+        EXPECT_TRUE(*result);
+    };
+
+    auto t = test();
+    schedule_all(t);
+
+    EXPECT_EQ(compile_count, 5);
+}
+
+TEST_CASE(unchanged_output_cuts_off_dependents) {
+    // Edits to the header never change its output, as with a comment fix.
+    CompileGraph graph([] { return 1ms; },
+                       [](const std::string& name, std::uint64_t revision) -> std::uint64_t {
+                           return name == "lexer.h" ? 1 : std::hash<std::string>{}(name) + revision;
+                       });
+    graph.add_unit("lexer.h");
+    graph.add_unit("lexer.cpp", {"lexer.h"});
+    graph.add_unit("parser.cpp", {"lexer.cpp"});
+
+    auto test = [&]() -> task<> {
+        EXPECT_TRUE(co_await graph.compile("parser.cpp", loop));
+        EXPECT_TRUE(graph.rebuilt("parser.cpp"));
+
+        graph.update("lexer.h");
+        EXPECT_TRUE(co_await graph.compile("parser.cpp", loop));
+        EXPECT_TRUE(graph.rebuilt("lexer.h"));
+        EXPECT_FALSE(graph.rebuilt("lexer.cpp"));
+        EXPECT_FALSE(graph.rebuilt("parser.cpp"));
+
+        // lexer.cpp's own output does change, so parser.cpp follows.
+        graph.update("lexer.cpp");
+        EXPECT_TRUE(co_await graph.compile("parser.cpp", loop));
+        EXPECT_TRUE(graph.rebuilt("parser.cpp"));
+    };
+
+    auto t = test();
+    schedule_all(t);
+}
+
+TEST_CASE(saved_hashes_skip_rebuilds) {
+    int compile_count = 0;
+    auto make_graph = [&] {
+        CompileGraph graph([&] {
+            compile_count += 1;
+            return 1ms;
+        });
+        graph.add_unit("lexer.h");
+        graph.add_unit("lexer.cpp", {"lexer.h"});
+        graph.add_unit("main.cpp", {"lexer.cpp"});
+        return graph;
+    };
+
+    auto first = make_graph();
+    auto build_first = [&]() -> task<> {
+        EXPECT_TRUE(co_await first.compile("main.cpp", loop));
+    };
+    auto t1 = build_first();
+    schedule_all(t1);
+    EXPECT_EQ(compile_count, 3);
+
+    auto saved = first.save_state();
+    ASSERT_TRUE(saved.has_value());
+
+    // A fresh graph with the saved hashes finds everything up to date.
+    auto second = make_graph();
+    ASSERT_TRUE(second.load_state(*saved));
+    auto build_second = [&]() -> task<> {
+        EXPECT_TRUE(co_await second.compile("main.cpp", loop));
+    };
+    auto t2 = build_second();
+    schedule_all(t2);
+    EXPECT_EQ(compile_count, 3);
+
+    const std::byte garbage[] = {std::byte{0xff}};
+    EXPECT_FALSE(second.load_state(garbage));
+}
+
 };  // TEST_SUITE(build_system)
 
 }  // namespace
@@ -1,6 +1,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <optional>
 #include <thread>
 #include <vector>
@@ -653,6 +654,146 @@ TEST_CASE(nested_with_token_same_token_cancel) {
     schedule_all(guarded, cancel_task);
 }
 
+TEST_CASE(cancel_after_fires) {
+    cancellation_source source;
+    source.cancel_after(std::chrono::milliseconds(5), loop);
+
+    event gate;
+    auto worker = [&]() -> task<> {
+        co_await gate.wait();
+    };
+
+    auto guarded = with_token(worker(), source.token());
+    schedule_all(guarded);
+
+    EXPECT_TRUE(source.cancelled());
+    EXPECT_TRUE(guarded.result().is_cancelled());
+}
+
+TEST_CASE(cancel_after_not_reached) {
+    cancellation_source source;
+    source.cancel_after(std::chrono::seconds(60), loop);
+
+    auto worker = [&]() -> task<int> {
+        co_await sleep(1, loop);
+        source.clear_timeout();
+        co_return 7;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto guarded = with_token(worker(), source.token());
+    schedule_all(guarded);
+
+    EXPECT_FALSE(source.cancelled());
+    auto result = guarded.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 7);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST_CASE(cancel_after_replaces_timeout) {
+    cancellation_source source;
+    std::vector<bool> seen;
+
+    auto watcher = [&]() -> task<> {
+        source.cancel_after(std::chrono::milliseconds(10), loop);
+        source.cancel_after(std::chrono::milliseconds(60), loop);
+        co_await sleep(30, loop);
+        seen.push_back(source.cancelled());
+        co_await sleep(60, loop);
+        seen.push_back(source.cancelled());
+    };
+
+    auto t = watcher();
+    schedule_all(t);
+
+    EXPECT_EQ(seen, std::vector<bool>({false, true}));
+}
+
+TEST_CASE(cancel_at_past) {
+    cancellation_source source;
+    source.cancel_at(std::chrono::steady_clock::now() - std::chrono::seconds(1), loop);
+
+    event gate;
+    auto worker = [&]() -> task<> {
+        co_await gate.wait();
+    };
+
+    auto guarded = with_token(worker(), source.token());
+    schedule_all(guarded);
+
+    EXPECT_TRUE(guarded.result().is_cancelled());
+}
+
+TEST_CASE(cancel_disarms_timeout) {
+    cancellation_source source;
+    source.cancel_after(std::chrono::seconds(60), loop);
+
+    auto worker = [&]() -> task<> {
+        co_await sleep(1, loop);
+        source.cancel();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto t = worker();
+    schedule_all(t);
+
+    EXPECT_TRUE(source.cancelled());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST_CASE(callback_runs_once) {
+    cancellation_source source;
+    int calls = 0;
+    int dropped_calls = 0;
+
+    cancellation_callback counted(source.token(), [&] { ++calls; });
+    {
+        cancellation_callback dropped(source.token(), [&] { ++dropped_calls; });
+    }
+
+    source.cancel();
+    source.cancel();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(dropped_calls, 0);
+
+    // Registering on a cancelled token runs the callback right away.
+    cancellation_callback late(source.token(), [&] { ++calls; });
+    EXPECT_EQ(calls, 2);
+}
+
+TEST_CASE(callback_drops_itself) {
+    cancellation_source source;
+    std::optional<cancellation_callback<std::function<void()>>> self;
+    int later_calls = 0;
+
+    cancellation_callback later(source.token(), [&] { ++later_calls; });
+    self.emplace(source.token(), [&] { self.reset(); });
+
+    source.cancel();
+    EXPECT_FALSE(self.has_value());
+    EXPECT_EQ(later_calls, 1);
+}
+
+TEST_CASE(callback_cancelled_from_another_thread) {
+    cancellation_source source;
+    std::atomic<int> calls{0};
+    std::thread::id ran_on;
+
+    {
+        cancellation_callback callback(source.token(), [&] {
+            ran_on = std::this_thread::get_id();
+            calls.fetch_add(1);
+        });
+
+        std::thread canceller([&] { source.cancel(); });
+        canceller.join();
+    }
+
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_NE(ran_on, std::this_thread::get_id());
+}
+
 };  // TEST_SUITE(cancellation)
 
 }  // namespace
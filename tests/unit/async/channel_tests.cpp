@@ -0,0 +1,233 @@
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(channel, loop_fixture) {
+
+TEST_CASE(try_send_try_recv_fifo) {
+    channel<int> ch(2);
+    EXPECT_EQ(ch.capacity(), 2U);
+
+    EXPECT_TRUE(ch.try_send(1));
+    EXPECT_TRUE(ch.try_send(2));
+    EXPECT_FALSE(ch.try_send(3));
+    EXPECT_EQ(ch.size(), 2U);
+
+    EXPECT_EQ(ch.try_recv(), std::optional<int>(1));
+    EXPECT_EQ(ch.try_recv(), std::optional<int>(2));
+    EXPECT_FALSE(ch.try_recv().has_value());
+}
+
+TEST_CASE(send_waits_for_space) {
+    channel<int> ch(1);
+    std::vector<int> received;
+
+    auto producer = [&]() -> task<> {
+        for(int i = 0; i < 5; ++i) {
+            EXPECT_TRUE(co_await ch.send(i));
+        }
+        ch.close();
+    };
+
+    auto consumer = [&]() -> task<> {
+        while(auto value = co_await ch.recv()) {
+            received.push_back(*value);
+            co_await sleep(1, loop);
+        }
+    };
+
+    auto t1 = producer();
+    auto t2 = consumer();
+    schedule_all(t1, t2);
+
+    EXPECT_EQ(received, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST_CASE(handoff_to_parked_receiver) {
+    channel<int> ch(4);
+    std::optional<int> got;
+
+    auto consumer = [&]() -> task<> {
+        got = co_await ch.recv();
+    };
+
+    auto producer = [&]() -> task<> {
+        co_await sleep(1, loop);
+        EXPECT_TRUE(ch.try_send(42));
+        // The value went straight to the receiver, not into the buffer.
+        EXPECT_EQ(ch.size(), 0U);
+        EXPECT_EQ(got, std::optional<int>(42));
+    };
+
+    auto t1 = consumer();
+    auto t2 = producer();
+    schedule_all(t1, t2);
+
+    EXPECT_EQ(got, std::optional<int>(42));
+}
+
+TEST_CASE(unbuffered_rendezvous) {
+    channel<int> ch(0);
+    EXPECT_FALSE(ch.try_send(1));
+
+    int sent = 0;
+    std::optional<int> got;
+
+    auto producer = [&]() -> task<> {
+        EXPECT_TRUE(co_await ch.send(7));
+        sent += 1;
+    };
+
+    auto consumer = [&]() -> task<> {
+        co_await sleep(1, loop);
+        EXPECT_EQ(sent, 0);
+        got = ch.try_recv();
+    };
+
+    auto t1 = producer();
+    auto t2 = consumer();
+    schedule_all(t1, t2);
+
+    EXPECT_EQ(sent, 1);
+    EXPECT_EQ(got, std::optional<int>(7));
+}
+
+TEST_CASE(close_wakes_both_sides) {
+    channel<int> ch(0);
+    bool receiver_woke = false;
+    bool sender_result = true;
+
+    auto receiver = [&]() -> task<> {
+        auto value = co_await ch.recv();
+        receiver_woke = !value.has_value();
+    };
+
+    auto closer = [&]() -> task<> {
+        co_await sleep(1, loop);
+        ch.close();
+        sender_result = co_await ch.send(1);
+    };
+
+    auto t1 = receiver();
+    auto t2 = closer();
+    schedule_all(t1, t2);
+
+    EXPECT_TRUE(receiver_woke);
+    EXPECT_FALSE(sender_result);
+    EXPECT_TRUE(ch.is_closed());
+}
+
+TEST_CASE(close_keeps_buffered_values) {
+    channel<int> ch(2);
+    EXPECT_TRUE(ch.try_send(1));
+    ch.close();
+    EXPECT_FALSE(ch.try_send(2));
+
+    std::vector<std::optional<int>> received;
+    auto consumer = [&]() -> task<> {
+        received.push_back(co_await ch.recv());
+        received.push_back(co_await ch.recv());
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(received.size(), 2U);
+    EXPECT_EQ(received[0], std::optional<int>(1));
+    EXPECT_FALSE(received[1].has_value());
+}
+
+TEST_CASE(cancelled_receiver_is_skipped) {
+    channel<int> ch(1);
+
+    auto receive = [&]() -> task<int> {
+        auto value = co_await ch.recv();
+        co_return value.value_or(-1);
+    };
+
+    auto timeout = [&]() -> task<int> {
+        co_await sleep(1, loop);
+        co_return 0;
+    };
+
+    auto race = [&]() -> task<std::variant<int, int>> {
+        co_return co_await when_any(receive(), timeout());
+    };
+
+    auto t = race();
+    schedule_all(t);
+
+    EXPECT_EQ(t.result().index(), 1U);
+    // The cancelled receive must not swallow the next value.
+    EXPECT_TRUE(ch.try_send(5));
+    EXPECT_EQ(ch.size(), 1U);
+}
+
+TEST_CASE(shared_across_threads) {
+    shared_channel<int> ch(4);
+    constexpr int count = 200;
+    int sum = 0;
+    int received = 0;
+
+    std::thread producer([&] {
+        event_loop producer_loop;
+        auto send_all = [&]() -> task<> {
+            for(int i = 1; i <= count; ++i) {
+                EXPECT_TRUE(co_await ch.send(i));
+            }
+            ch.close();
+        };
+        auto t = send_all();
+        producer_loop.schedule(t);
+        producer_loop.run();
+    });
+
+    auto consumer = [&]() -> task<> {
+        while(auto value = co_await ch.recv()) {
+            sum += *value;
+            received += 1;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+    producer.join();
+
+    EXPECT_EQ(received, count);
+    EXPECT_EQ(sum, count * (count + 1) / 2);
+}
+
+TEST_CASE(shared_try_send_from_plain_thread) {
+    shared_channel<int> ch(8);
+
+    std::thread producer([&] {
+        for(int i = 0; i < 8; ++i) {
+            while(!ch.try_send(i)) {
+                std::this_thread::yield();
+            }
+        }
+        ch.close();
+    });
+    producer.join();
+
+    int next = 0;
+    while(auto value = ch.try_recv()) {
+        EXPECT_EQ(*value, next);
+        next += 1;
+    }
+    EXPECT_EQ(next, 8);
+    EXPECT_TRUE(ch.is_closed());
+}
+
+};  // TEST_SUITE(channel)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,225 @@
+#include <chrono>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+task<> record_after(int ms, std::vector<int>& order, event_loop& loop) {
+    co_await after(ms, loop);
+    order.push_back(ms);
+}
+
+task<> record_sleep(int ms, std::vector<int>& order, event_loop& loop) {
+    co_await sleep(ms, loop);
+    order.push_back(ms);
+}
+
+TEST_SUITE(deadline, loop_fixture) {
+
+TEST_CASE(after_completes) {
+    bool done = false;
+
+    auto waiter = [&]() -> task<> {
+        co_await after(5, loop);
+        done = true;
+    };
+
+    auto t = waiter();
+    schedule_all(t);
+
+    EXPECT_TRUE(done);
+}
+
+TEST_CASE(after_zero) {
+    int steps = 0;
+
+    auto waiter = [&]() -> task<> {
+        co_await after(0, loop);
+        steps += 1;
+        co_await after(0, loop);
+        steps += 1;
+    };
+
+    auto t = waiter();
+    schedule_all(t);
+
+    EXPECT_EQ(steps, 2);
+}
+
+TEST_CASE(after_in_deadline_order) {
+    std::vector<int> order;
+
+    auto a = record_after(30, order, loop);
+    auto b = record_after(10, order, loop);
+    auto c = record_after(20, order, loop);
+    auto d = record_after(1, order, loop);
+    schedule_all(a, b, c, d);
+
+    EXPECT_EQ(order, std::vector<int>({1, 10, 20, 30}));
+}
+
+TEST_CASE(after_cascades_long_timeouts) {
+    std::vector<int> order;
+
+    auto a = record_after(300, order, loop);
+    auto b = record_after(70, order, loop);
+    auto c = record_after(5, order, loop);
+    auto d = record_sleep(150, order, loop);
+    schedule_all(a, b, c, d);
+
+    EXPECT_EQ(order, std::vector<int>({5, 70, 150, 300}));
+}
+
+TEST_CASE(after_rearms_from_callback) {
+    std::vector<int> order;
+
+    auto chain = [&]() -> task<> {
+        for(int i = 0; i < 5; ++i) {
+            co_await after(2, loop);
+            order.push_back(i);
+        }
+    };
+
+    auto t = chain();
+    schedule_all(t);
+
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST_CASE(after_cancelled) {
+    cancellation_source source;
+    bool finished = false;
+
+    auto waiter = [&]() -> task<> {
+        co_await after(60'000, loop);
+        finished = true;
+    };
+
+    auto canceler = [&]() -> task<> {
+        co_await after(5, loop);
+        source.cancel();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto guarded = with_token(waiter(), source.token());
+    auto stopper = canceler();
+    schedule_all(guarded, stopper);
+
+    EXPECT_TRUE(guarded.result().is_cancelled());
+    EXPECT_FALSE(finished);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST_CASE(many_timers_cancelled) {
+    cancellation_source source;
+    int finished = 0;
+
+    auto waiter = [&](int ms) -> task<> {
+        co_await after(ms, loop);
+        finished += 1;
+    };
+
+    auto canceler = [&]() -> task<> {
+        co_await after(10, loop);
+        source.cancel();
+    };
+
+    std::vector<task<void, void, cancellation>> waiters;
+    for(int i = 0; i < 1000; ++i) {
+        waiters.push_back(with_token(waiter(i % 2 == 0 ? 1 : 60'000 + i), source.token()));
+    }
+    for(auto& w: waiters) {
+        loop.schedule(w);
+    }
+
+    auto stopper = canceler();
+    schedule_all(stopper);
+
+    EXPECT_EQ(finished, 500);
+}
+
+TEST_CASE(deadline_cancels_operation) {
+    bool finished = false;
+    bool expired = false;
+
+    auto slow = [&]() -> task<> {
+        co_await after(60'000, loop);
+        finished = true;
+    };
+
+    auto caller = [&]() -> task<> {
+        deadline timeout(std::chrono::milliseconds(10), loop);
+        auto result = co_await with_token(slow(), timeout.token());
+        EXPECT_TRUE(result.is_cancelled());
+        expired = timeout.expired();
+    };
+
+    auto t = caller();
+    schedule_all(t);
+
+    EXPECT_FALSE(finished);
+    EXPECT_TRUE(expired);
+}
+
+TEST_CASE(deadline_not_reached) {
+    bool expired = true;
+
+    auto caller = [&]() -> task<> {
+        deadline timeout(std::chrono::milliseconds(60'000), loop);
+        auto result = co_await with_token(after(5, loop), timeout.token());
+        EXPECT_FALSE(result.is_cancelled());
+        expired = timeout.expired();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto t = caller();
+    schedule_all(t);
+
+    EXPECT_FALSE(expired);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST_CASE(deadline_disarm) {
+    bool expired = true;
+
+    auto caller = [&]() -> task<> {
+        deadline timeout(std::chrono::milliseconds(5), loop);
+        timeout.disarm();
+        co_await after(20, loop);
+        expired = timeout.expired();
+    };
+
+    auto t = caller();
+    schedule_all(t);
+
+    EXPECT_FALSE(expired);
+}
+
+TEST_CASE(deadline_rearm) {
+    std::vector<bool> expired;
+
+    auto caller = [&]() -> task<> {
+        deadline timeout(std::chrono::milliseconds(20), loop);
+        co_await after(10, loop);
+        timeout.rearm(std::chrono::milliseconds(100));
+        co_await after(30, loop);
+        expired.push_back(timeout.expired());
+        co_await after(150, loop);
+        expired.push_back(timeout.expired());
+    };
+
+    auto t = caller();
+    schedule_all(t);
+
+    EXPECT_EQ(expired, std::vector<bool>({false, true}));
+}
+
+};  // TEST_SUITE(deadline)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,108 @@
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(fs_async_file, loop_fixture) {
+
+TEST_CASE(lines_round_trip) {
+    auto worker = [](event_loop& ev) -> task<std::vector<std::string>, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-file-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+        std::string path = (std::filesystem::path(dir) / "log.txt").string();
+
+        // Small buffers, so lines straddle refills and writes overflow.
+        fs::async_file::options opts(16, 64);
+        {
+            auto out = co_await fs::async_file::open(path,
+                                                     O_CREAT | O_WRONLY | O_TRUNC,
+                                                     0644,
+                                                     opts,
+                                                     ev)
+                           .or_fail();
+            for(int i = 0; i < 20; ++i) {
+                co_await out.write("line " + std::to_string(i) + "\n").or_fail();
+            }
+            co_await out.write(std::string_view("tail")).or_fail();
+            co_await out.close().or_fail();
+        }
+
+        std::vector<std::string> lines;
+        {
+            auto in = co_await fs::async_file::open(path, O_RDONLY, 0, opts, ev).or_fail();
+            std::string line;
+            while(co_await in.read_line(line).or_fail()) {
+                lines.push_back(line);
+            }
+            co_await in.close().or_fail();
+        }
+
+        co_await fs::unlink(path, ev).or_fail();
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return lines;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 21U);
+    EXPECT_EQ((*result)[0], "line 0");
+    EXPECT_EQ((*result)[19], "line 19");
+    EXPECT_EQ((*result)[20], "tail");
+}
+
+TEST_CASE(positional_writes_and_reads) {
+    auto worker = [](event_loop& ev) -> task<std::string, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-file-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+        std::string path = (std::filesystem::path(dir) / "data.bin").string();
+
+        auto file =
+            co_await fs::async_file::open(path, O_CREAT | O_RDWR | O_TRUNC, 0644, {}, ev)
+                .or_fail();
+
+        // Contiguous pwrites coalesce; the one elsewhere forces a flush.
+        co_await file.pwrite(std::string_view("abc"), 0).or_fail();
+        co_await file.pwrite(std::string_view("def"), 3).or_fail();
+        co_await file.pwrite(std::string_view("XY"), 10).or_fail();
+
+        // A read sees the buffered writes, and a later write over bytes it
+        // cached is not hidden by the read buffer.
+        char buf[16]{};
+        auto n = co_await file.pread(std::span<char>(buf, 6), 0).or_fail();
+        std::string seen(buf, n);
+        co_await file.pwrite(std::string_view("D"), 3).or_fail();
+        n = co_await file.pread(std::span<char>(buf, sizeof(buf)), 0).or_fail();
+        seen += '|';
+        seen.append(buf, n);
+
+        co_await file.sync(true).or_fail();
+        co_await file.close().or_fail();
+        co_await fs::unlink(path, ev).or_fail();
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return seen;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, std::string("abcdef|abcDef\0\0\0\0XY", 19));
+}
+
+};  // TEST_SUITE(fs_async_file)
+
+}  // namespace
+
+}  // namespace kota
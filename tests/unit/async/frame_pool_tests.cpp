@@ -0,0 +1,109 @@
+#include <array>
+
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+
+namespace kota {
+
+namespace {
+
+task<int> leaf(int value) {
+    co_return value;
+}
+
+task<int> sum_leaves(int count) {
+    int total = 0;
+    for(int i = 0; i < count; ++i) {
+        total += co_await leaf(i);
+    }
+    co_return total;
+}
+
+task<int> large_frame() {
+    std::array<char, 4096> buffer{};
+    buffer[0] = 1;
+    co_await leaf(0);
+    co_return buffer[0] + buffer[buffer.size() - 1];
+}
+
+task<int> await_large_frame() {
+    co_return co_await large_frame();
+}
+
+}  // namespace
+
+#if KOTA_ASYNC_FRAME_POOL
+
+TEST_SUITE(frame_pool) {
+
+TEST_CASE(recycles_sequential_children) {
+    event_loop loop;
+    auto t = sum_leaves(100);
+    loop.schedule(t);
+    loop.run();
+
+    EXPECT_EQ(t.value(), 4950);
+
+    auto stats = loop.frame_stats();
+    // The first child misses; every later one reuses its predecessor's frame.
+    EXPECT_EQ(stats.misses, 1U);
+    EXPECT_EQ(stats.hits, 99U);
+    EXPECT_EQ(stats.recycled, 100U);
+    EXPECT_EQ(stats.cached, 1U);
+    EXPECT_GT(stats.hit_rate(), 0.9);
+}
+
+TEST_CASE(disabled_pool_uses_heap) {
+    event_loop loop;
+    loop.set_frame_pool_enabled(false);
+
+    auto t = sum_leaves(10);
+    loop.schedule(t);
+    loop.run();
+
+    EXPECT_EQ(t.value(), 45);
+
+    auto stats = loop.frame_stats();
+    EXPECT_EQ(stats.hits, 0U);
+    EXPECT_EQ(stats.recycled, 0U);
+    EXPECT_EQ(stats.cached, 0U);
+    EXPECT_EQ(stats.hit_rate(), 0.0);
+}
+
+TEST_CASE(disable_releases_cache) {
+    event_loop loop;
+    auto t = sum_leaves(4);
+    loop.schedule(t);
+    loop.run();
+    EXPECT_GT(loop.frame_stats().cached, 0U);
+
+    loop.set_frame_pool_enabled(false);
+    EXPECT_EQ(loop.frame_stats().cached, 0U);
+}
+
+TEST_CASE(outside_run_is_not_counted) {
+    event_loop loop;
+    {
+        auto t = leaf(1);
+    }
+
+    auto stats = loop.frame_stats();
+    EXPECT_EQ(stats.hits + stats.misses + stats.recycled, 0U);
+}
+
+TEST_CASE(large_frames_bypass_pool) {
+    event_loop loop;
+    auto t = await_large_frame();
+    loop.schedule(t);
+    loop.run();
+
+    EXPECT_EQ(t.value(), 1);
+
+    EXPECT_GE(loop.frame_stats().oversized, 1U);
+}
+
+};  // TEST_SUITE(frame_pool)
+
+#endif
+
+}  // namespace kota
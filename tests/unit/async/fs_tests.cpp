@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <fcntl.h>
 #include <filesystem>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #ifdef _WIN32
 #include <io.h>
@@ -161,6 +163,231 @@ TEST_CASE(async_open_read_write_close) {
     EXPECT_EQ(*result, 1);
 }
 
+TEST_CASE(map_file_with_padding) {
+    auto worker = [](event_loop& ev) -> task<int, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-map-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+
+        // Ends exactly on a page boundary, so the padding cannot come from
+        // the tail of the last file page.
+        std::string payload(4096, 'k');
+        std::string file = (std::filesystem::path(dir) / "page.json").string();
+        std::string empty = (std::filesystem::path(dir) / "empty.json").string();
+        for(auto& [path, bytes]: {std::pair{file, payload}, std::pair{empty, std::string()}}) {
+            int fd = co_await fs::open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644, ev).or_fail();
+            if(!bytes.empty()) {
+                co_await fs::write(fd, std::span<const char>(bytes), -1, ev).or_fail();
+            }
+            co_await fs::close(fd, ev).or_fail();
+        }
+
+        int checks = 0;
+        {
+            auto mapped = co_await fs::map(file, ev).or_fail();
+            checks += mapped.view() == payload;
+            checks += mapped.padding() >= fs::mapped_file::min_padding;
+            const auto* tail = mapped.data() + mapped.size();
+            checks += std::all_of(tail, tail + mapped.padding(), [](char c) { return c == 0; });
+
+            auto none = co_await fs::map(empty, ev).or_fail();
+            checks += none.empty() && none.padding() >= fs::mapped_file::min_padding;
+        }
+
+        co_await fs::unlink(file, ev).or_fail();
+        co_await fs::unlink(empty, ev).or_fail();
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return checks;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 4);
+}
+
+TEST_CASE(read_file_and_read_many) {
+    auto worker = [](event_loop& ev) -> task<int, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-read-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+
+        // Larger than the default chunk, so a size-less read would grow.
+        std::string big(100 * 1024 + 7, 'r');
+        std::string small = "hi";
+        std::vector<std::string> paths;
+        for(auto [name, bytes]: {std::pair{"big.txt", big}, std::pair{"small.txt", small}}) {
+            paths.push_back((std::filesystem::path(dir) / name).string());
+            auto& path = paths.back();
+            int fd = co_await fs::open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644, ev).or_fail();
+            co_await fs::write(fd, std::span<const char>(bytes), -1, ev).or_fail();
+            co_await fs::close(fd, ev).or_fail();
+        }
+        paths.push_back((std::filesystem::path(dir) / "missing.txt").string());
+
+        int checks = 0;
+        checks += co_await fs::read_file(paths[0], ev).or_fail() == big;
+        checks += (co_await fs::read_file(paths[2], ev)).has_error();
+
+        auto contents = co_await fs::read_many(paths, 2, ev).or_fail();
+        checks += contents.size() == 3;
+        checks += contents[0].has_value() && *contents[0] == big;
+        checks += contents[1].has_value() && *contents[1] == small;
+        checks += contents[2].has_error();
+
+        co_await fs::unlink(paths[0], ev).or_fail();
+        co_await fs::unlink(paths[1], ev).or_fail();
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return checks;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 6);
+}
+
+TEST_CASE(walk_tree_with_prune) {
+    auto worker = [](event_loop& ev) -> task<std::vector<std::string>, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-walk-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+
+        // dir/{a.txt, sub/{b.txt, deep/c.txt}, skip/d.txt}
+        auto at = [&](std::string_view rel) { return (std::filesystem::path(dir) / rel).string(); };
+        for(auto sub: {"sub", "sub/deep", "skip"}) {
+            co_await fs::mkdir(at(sub), 0755, ev).or_fail();
+        }
+        for(auto file: {"a.txt", "sub/b.txt", "sub/deep/c.txt", "skip/d.txt"}) {
+            int fd = co_await fs::open(at(file), O_CREAT | O_WRONLY | O_TRUNC, 0644, ev).or_fail();
+            co_await fs::close(fd, ev).or_fail();
+        }
+
+        std::vector<std::string> seen;
+        fs::walk_options options{
+            .prune = [](const fs::walk_entry& entry) { return entry.path.ends_with("skip"); },
+            .stat = true,
+            .max_concurrency = 2,
+        };
+        auto entries = fs::walk(dir, std::move(options), ev);
+        while(auto entry = co_await or_fail(co_await entries.next())) {
+            if(!entry->stats.has_value()) {
+                co_await fail(error::invalid_argument);
+            }
+            auto rel = std::filesystem::path(entry->path).lexically_relative(dir).generic_string();
+            seen.push_back(rel + (entry->kind == fs::dirent::type::dir ? "/" : ""));
+        }
+
+        for(auto file: {"a.txt", "sub/b.txt", "sub/deep/c.txt", "skip/d.txt"}) {
+            co_await fs::unlink(at(file), ev).or_fail();
+        }
+        for(auto sub: {"sub/deep", "sub", "skip"}) {
+            co_await fs::rmdir(at(sub), ev).or_fail();
+        }
+        co_await fs::rmdir(dir, ev).or_fail();
+
+        std::ranges::sort(seen);
+        co_return seen;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result,
+              std::vector<std::string>(
+                  {"a.txt", "skip/", "sub/", "sub/b.txt", "sub/deep/", "sub/deep/c.txt"}));
+}
+
+TEST_CASE(fs_event_batch_merges_paths) {
+    auto worker = [](event_loop& ev) -> task<std::vector<fs_event::change>, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-watch-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+        std::string file = (std::filesystem::path(dir) / "burst.txt").string();
+
+        auto watcher = co_await or_fail(fs_event::create(ev));
+        if(auto err = watcher.start(dir.c_str())) {
+            co_await fail(err);
+        }
+
+        // A burst of writes to one file, all reported in the same batch.
+        int fd = co_await fs::open(file, O_CREAT | O_WRONLY | O_TRUNC, 0644, ev).or_fail();
+        for(int i = 0; i < 8; ++i) {
+            co_await fs::write(fd, std::span<const char>("x", 1), -1, ev).or_fail();
+        }
+        co_await fs::close(fd, ev).or_fail();
+
+        auto changes = co_await watcher.wait_batch(std::chrono::milliseconds(50)).or_fail();
+
+        watcher.stop();
+        co_await fs::unlink(file, ev).or_fail();
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return changes;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    ASSERT_FALSE(result->empty());
+    for(std::size_t i = 0; i < result->size(); ++i) {
+        for(std::size_t j = i + 1; j < result->size(); ++j) {
+            EXPECT_NE((*result)[i].path, (*result)[j].path);
+        }
+    }
+}
+
+TEST_CASE(tree_watcher_sees_nested_changes) {
+    auto worker = [](event_loop& ev) -> task<std::vector<std::string>, error> {
+        auto dir_template =
+            (std::filesystem::temp_directory_path() / "kotatsu-tree-XXXXXX").string();
+        std::string dir = co_await fs::mkdtemp(dir_template, ev).or_fail();
+        auto at = [&](std::string_view rel) { return (std::filesystem::path(dir) / rel).string(); };
+        co_await fs::mkdir(at("sub"), 0755, ev).or_fail();
+
+        auto watcher = co_await or_fail(tree_watcher::create(ev));
+        co_await watcher.start(dir).or_fail();
+
+        // One change below an existing directory, one in a directory that
+        // only appears after the watch started.
+        co_await fs::mkdir(at("fresh"), 0755, ev).or_fail();
+        for(auto file: {"sub/a.txt", "fresh/b.txt"}) {
+            int fd = co_await fs::open(at(file), O_CREAT | O_WRONLY | O_TRUNC, 0644, ev).or_fail();
+            co_await fs::close(fd, ev).or_fail();
+        }
+
+        std::vector<std::string> paths;
+        auto seen = [&](std::string_view path) {
+            return std::ranges::find(paths, path) != paths.end();
+        };
+        while(!seen("sub/a.txt") || !seen("fresh/b.txt")) {
+            auto changes = co_await watcher.wait_batch(std::chrono::milliseconds(20)).or_fail();
+            for(auto& change: changes) {
+                paths.push_back(std::filesystem::path(change.path).generic_string());
+            }
+        }
+
+        watcher.stop();
+        for(auto file: {"sub/a.txt", "fresh/b.txt"}) {
+            co_await fs::unlink(at(file), ev).or_fail();
+        }
+        for(auto sub: {"sub", "fresh"}) {
+            co_await fs::rmdir(at(sub), ev).or_fail();
+        }
+        co_await fs::rmdir(dir, ev).or_fail();
+        co_return paths;
+    }(loop);
+
+    schedule_all(worker);
+
+    auto result = worker.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_NE(std::ranges::find(*result, "fresh"), result->end());
+}
+
 #ifndef _WIN32
 
 TEST_CASE(symlink_readlink_realpath) {
@@ -0,0 +1,264 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+generator<int> count_to(int n) {
+    for(int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+generator<int> ticks(event_loop& loop, int n, int& produced) {
+    for(int i = 0; i < n; ++i) {
+        co_await sleep(1, loop);
+        produced += 1;
+        co_yield i;
+    }
+}
+
+generator<int, error> fail_after(int n) {
+    for(int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+    co_await fail(error::connection_refused);
+}
+
+TEST_SUITE(generator, loop_fixture) {
+
+TEST_CASE(yields_in_order) {
+    std::vector<int> seen;
+
+    auto consumer = [&]() -> task<> {
+        auto source = count_to(4);
+        while(auto value = co_await source.next()) {
+            seen.push_back(*value);
+        }
+        EXPECT_TRUE(source.done());
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(seen, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_CASE(lazy_until_pulled) {
+    int produced = 0;
+
+    auto consumer = [&]() -> task<> {
+        auto source = ticks(loop, 10, produced);
+        co_await sleep(5, loop);
+        EXPECT_EQ(produced, 0);
+
+        auto first = co_await source.next();
+        EXPECT_EQ(first, std::optional<int>(0));
+        EXPECT_EQ(produced, 1);
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(produced, 1);
+}
+
+TEST_CASE(async_body) {
+    int produced = 0;
+    int sum = 0;
+
+    auto consumer = [&]() -> task<> {
+        auto source = ticks(loop, 5, produced);
+        while(auto value = co_await source.next()) {
+            sum += *value;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(produced, 5);
+    EXPECT_EQ(sum, 10);
+}
+
+TEST_CASE(move_only_items) {
+    auto words = []() -> generator<std::string> {
+        std::string word = "alpha";
+        co_yield std::move(word);
+        co_yield std::string("beta");
+    };
+
+    std::vector<std::string> seen;
+    auto consumer = [&]() -> task<> {
+        auto source = words();
+        while(auto word = co_await source.next()) {
+            seen.push_back(std::move(*word));
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(seen, std::vector<std::string>({"alpha", "beta"}));
+}
+
+TEST_CASE(error_after_items) {
+    std::vector<int> seen;
+    bool got_error = false;
+
+    auto consumer = [&]() -> task<> {
+        auto source = fail_after(2);
+        while(true) {
+            auto result = co_await source.next();
+            if(result.has_error()) {
+                EXPECT_EQ(result.error(), error::connection_refused);
+                got_error = true;
+                break;
+            }
+            if(!result->has_value()) {
+                break;
+            }
+            seen.push_back(**result);
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(seen, std::vector<int>({0, 1}));
+    EXPECT_TRUE(got_error);
+}
+
+TEST_CASE(or_fail_in_body) {
+    auto failing = []() -> task<int, error> {
+        co_await fail(error::connection_refused);
+    };
+
+    auto source_fn = [&]() -> generator<int, error> {
+        co_yield 1;
+        auto value = co_await failing().or_fail();
+        co_yield value;
+    };
+
+    int items = 0;
+    bool got_error = false;
+    auto consumer = [&]() -> task<> {
+        auto source = source_fn();
+        while(true) {
+            auto result = co_await source.next();
+            if(!result) {
+                got_error = result.error() == error::connection_refused;
+                break;
+            }
+            if(!result->has_value()) {
+                break;
+            }
+            items += 1;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(items, 1);
+    EXPECT_TRUE(got_error);
+}
+
+TEST_CASE(drop_early) {
+    int produced = 0;
+
+    auto consumer = [&]() -> task<> {
+        auto source = ticks(loop, 100, produced);
+        co_await source.next();
+        co_await source.next();
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_EQ(produced, 2);
+}
+
+TEST_CASE(token_cancels_body) {
+    cancellation_source source;
+    int produced = 0;
+    int consumed = 0;
+
+    auto consumer = [&]() -> task<> {
+        auto items = ticks(loop, 1000, produced);
+        while(co_await items.next()) {
+            consumed += 1;
+        }
+    };
+
+    auto canceler = [&]() -> task<> {
+        co_await sleep(10, loop);
+        source.cancel();
+    };
+
+    auto guarded = with_token(consumer(), source.token());
+    auto stopper = canceler();
+    schedule_all(guarded, stopper);
+
+    EXPECT_TRUE(guarded.result().is_cancelled());
+    EXPECT_LT(produced, 1000);
+    EXPECT_EQ(produced, consumed);
+}
+
+TEST_CASE(body_cancel_propagates) {
+    auto cancelling = []() -> generator<int> {
+        co_yield 1;
+        co_await cancel();
+    };
+
+    int items = 0;
+    auto consumer = [&]() -> task<> {
+        auto source = cancelling();
+        while(co_await source.next()) {
+            items += 1;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_TRUE(t->is_cancelled());
+    EXPECT_EQ(items, 1);
+}
+
+#if KOTA_ENABLE_EXCEPTIONS
+
+TEST_CASE(exception_rethrown_from_next) {
+    auto throwing = []() -> generator<int> {
+        co_yield 1;
+        throw std::runtime_error("generator boom");
+    };
+
+    int items = 0;
+    auto consumer = [&]() -> task<> {
+        auto source = throwing();
+        while(co_await source.next()) {
+            items += 1;
+        }
+    };
+
+    auto t = consumer();
+    schedule_all(t);
+
+    EXPECT_TRUE(t->is_failed());
+    EXPECT_THROWS(t.result());
+    EXPECT_EQ(items, 1);
+}
+
+#endif  // KOTA_ENABLE_EXCEPTIONS
+
+};  // TEST_SUITE(generator)
+
+}  // namespace
+
+}  // namespace kota
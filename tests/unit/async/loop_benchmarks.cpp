@@ -0,0 +1,241 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+/// Bytes of one ping-pong message.
+constexpr std::size_t message_size = 64;
+
+task<int> value_task(int value) {
+    co_return value;
+}
+
+task<> read_exact(stream& s, std::span<char> dst) {
+    std::size_t done = 0;
+    while(done < dst.size()) {
+        auto n = co_await s.read_some(dst.subspan(done));
+        if(!n || *n == 0) {
+            zest::failure();
+            co_return;
+        }
+        done += *n;
+    }
+}
+
+task<> echo(stream& s, std::uint64_t iterations) {
+    std::array<char, message_size> buffer{};
+    for(std::uint64_t i = 0; i < iterations; ++i) {
+        co_await read_exact(s, buffer);
+        auto written = co_await s.write(buffer);
+        if(!written) {
+            zest::failure();
+            co_return;
+        }
+    }
+}
+
+/// Round trips of one message between `client` and an echoing `server`.
+void bench_ping_pong(loop_fixture& fixture, zest::Bench& bench, stream& server, stream& client) {
+    std::array<char, message_size> request{};
+    std::array<char, message_size> reply{};
+    bench.items(1);
+    fixture.bench_loop(bench, [&](std::uint64_t iterations) -> task<> {
+        auto send = [&]() -> task<> {
+            for(std::uint64_t i = 0; i < iterations; ++i) {
+                const auto sent = bench_clock::now();
+                auto written = co_await client.write(request);
+                if(!written) {
+                    zest::failure();
+                    co_return;
+                }
+                co_await read_exact(client, reply);
+                bench.record_latency(bench_clock::now() - sent);
+            }
+        };
+        co_await when_all(echo(server, iterations), send());
+    });
+}
+
+template <typename Stream, typename Acceptor>
+task<std::pair<Stream, Stream>, error> accept_and_connect(Acceptor acceptor,
+                                                          task<Stream, error> connecting) {
+    auto connected = co_await when_all(acceptor.accept(), std::move(connecting));
+    if(connected.has_error()) {
+        co_await fail(std::move(connected).error());
+    }
+    auto& [accepted, connector] = *connected;
+    co_return std::pair{std::move(accepted), std::move(connector)};
+}
+
+std::string bench_pipe_name() {
+#ifdef _WIN32
+    return std::format("\\\\.\\pipe\\kotatsu-bench-{}", process::current_pid());
+#else
+    auto path = std::filesystem::temp_directory_path() /
+                std::format("kotatsu-bench-{}.sock", process::current_pid());
+    std::filesystem::remove(path);
+    return path.string();
+#endif
+}
+
+TEST_SUITE(async_bench, loop_fixture) {
+
+BENCH(task_resume) {
+    bench.items(1);
+    bench_loop(bench, [](std::uint64_t iterations) -> task<> {
+        int sum = 0;
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            sum += co_await value_task(static_cast<int>(i));
+        }
+        zest::do_not_optimize(sum);
+    });
+}
+
+BENCH(when_all_fan_out) {
+    constexpr std::size_t width = 16;
+    bench.items(width);
+    bench_loop(bench, [](std::uint64_t iterations) -> task<> {
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            std::vector<task<int>> children;
+            children.reserve(width);
+            for(std::size_t w = 0; w < width; ++w) {
+                children.push_back(value_task(static_cast<int>(w)));
+            }
+            auto values = co_await when_all(std::move(children));
+            zest::do_not_optimize(values);
+        }
+    });
+}
+
+// Cancelling one token that 10k waiters watch: through with_token(), each
+// of which races a wait task, and through registered callbacks.
+BENCH(cancellation_fan_out_with_token) {
+    constexpr std::size_t width = 10'000;
+    bench.items(width);
+    bench_loop(bench, [&](std::uint64_t iterations) -> task<> {
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            cancellation_source source;
+            event never;
+            auto waiter = [&]() -> task<> {
+                auto result = co_await with_token(never.wait(), source.token());
+                zest::do_not_optimize(result.is_cancelled());
+            };
+
+            std::vector<task<>> waiters;
+            waiters.reserve(width);
+            for(std::size_t w = 0; w < width; ++w) {
+                waiters.push_back(waiter());
+            }
+
+            auto canceller = [&]() -> task<> {
+                source.cancel();
+                co_return;
+            };
+            auto wait_all = [&]() -> task<> {
+                co_await when_all(std::move(waiters));
+            };
+            co_await when_all(wait_all(), canceller());
+        }
+    });
+}
+
+BENCH(cancellation_fan_out_callbacks) {
+    constexpr std::size_t width = 10'000;
+    bench.items(width);
+    bench_loop(bench, [&](std::uint64_t iterations) -> task<> {
+        using callback = cancellation_callback<std::function<void()>>;
+        std::size_t fired = 0;
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            cancellation_source source;
+            std::vector<std::optional<callback>> callbacks(width);
+            for(auto& slot: callbacks) {
+                slot.emplace(source.token(), [&fired] { ++fired; });
+            }
+            source.cancel();
+        }
+        zest::do_not_optimize(fired);
+        co_return;
+    });
+}
+
+BENCH(post_from_another_thread) {
+    // One callback in flight at a time, so the latency is that of a wakeup
+    // rather than of a queue.
+    bench.items(1);
+    bench_loop(bench, [&](std::uint64_t iterations) -> task<> {
+        event done;
+        std::atomic<std::uint64_t> handled{0};
+        std::thread poster([&] {
+            for(std::uint64_t i = 0; i < iterations; ++i) {
+                const auto posted = bench_clock::now();
+                loop.post([&, posted] {
+                    bench.record_latency(bench_clock::now() - posted);
+                    if(handled.fetch_add(1, std::memory_order_release) + 1 == iterations) {
+                        done.set();
+                    }
+                });
+                while(handled.load(std::memory_order_acquire) <= i) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        co_await done.wait();
+        poster.join();
+    });
+}
+
+BENCH(tcp_ping_pong) {
+    auto acceptor = tcp::listen("127.0.0.1", 0, {}, loop);
+    ASSERT_TRUE(acceptor.has_value());
+    auto port = tcp::local_port(*acceptor);
+    ASSERT_TRUE(port.has_value());
+
+    auto connecting = tcp::connect("127.0.0.1", *port, loop);
+    auto pair = accept_and_connect<tcp>(std::move(*acceptor), std::move(connecting));
+    schedule_all(pair);
+    auto connected = pair.result();
+    ASSERT_TRUE(connected.has_value());
+
+    bench_ping_pong(*this, bench, connected->first, connected->second);
+}
+
+BENCH(pipe_ping_pong) {
+    const auto name = bench_pipe_name();
+    auto acceptor = pipe::listen(name, {}, loop);
+    ASSERT_TRUE(acceptor.has_value());
+
+    auto connecting = pipe::connect(name, {}, loop);
+    auto pair = accept_and_connect<pipe>(std::move(*acceptor), std::move(connecting));
+    schedule_all(pair);
+    auto connected = pair.result();
+    ASSERT_TRUE(connected.has_value());
+
+    bench_ping_pong(*this, bench, connected->first, connected->second);
+#ifndef _WIN32
+    std::filesystem::remove(name);
+#endif
+}
+
+};  // TEST_SUITE(async_bench)
+
+}  // namespace
+
+}  // namespace kota
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
 #include "kota/async/async.h"
+#include "kota/zest/detail/bench.h"
 
 namespace kota {
 
@@ -12,6 +15,23 @@ struct loop_fixture {
         (loop.schedule(tasks), ...);
         loop.run();
     }
+
+    /// Benchmark the task that `make(iterations)` returns, which runs that
+    /// many iterations on the loop. Every batch runs the loop until the task
+    /// is done and then stops it, so handles that stay open across batches,
+    /// such as connected streams or a running peer, do not keep it going.
+    template <typename Make>
+    void bench_loop(zest::Bench& bench, Make&& make) {
+        bench.run_batch([&](std::uint64_t iterations) {
+            auto driver = [&]() -> task<> {
+                co_await make(iterations);
+                loop.stop();
+            };
+            auto batch = driver();
+            loop.schedule(batch);
+            loop.run();
+        });
+    }
 };
 
 }  // namespace kota
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+
+namespace kota {
+
+namespace {
+
+task<> bump(std::atomic<int>& counter) {
+    counter.fetch_add(1);
+    co_return;
+}
+
+task<> sleep_and_bump(std::atomic<int>& counter) {
+    co_await sleep(1);
+    counter.fetch_add(1);
+}
+
+task<> record_index(loop_group& group, std::size_t expected, std::atomic<int>& mismatches) {
+    auto index = group.current_index();
+    if(!index || *index != expected) {
+        mismatches.fetch_add(1);
+    }
+    co_return;
+}
+
+task<> fan_out(std::atomic<int>& counter, int children) {
+    auto* group = loop_group::current();
+    for(int i = 0; i < children; ++i) {
+        group->spawn(bump(counter));
+    }
+    counter.fetch_add(1);
+    co_return;
+}
+
+task<> record_thread(std::mutex& m, std::set<std::thread::id>& ids) {
+    co_await sleep(5);
+    std::lock_guard lock(m);
+    ids.insert(std::this_thread::get_id());
+}
+
+}  // namespace
+
+TEST_SUITE(loop_group) {
+
+TEST_CASE(spawn_and_wait) {
+    std::atomic<int> counter{0};
+    loop_group group(4);
+    EXPECT_EQ(group.size(), 4U);
+
+    for(int i = 0; i < 200; ++i) {
+        group.spawn(bump(counter));
+    }
+    group.wait();
+
+    EXPECT_EQ(counter.load(), 200);
+}
+
+TEST_CASE(tasks_use_worker_loop) {
+    std::atomic<int> counter{0};
+    loop_group group(2);
+
+    for(int i = 0; i < 20; ++i) {
+        group.spawn(sleep_and_bump(counter));
+    }
+    group.wait();
+
+    EXPECT_EQ(counter.load(), 20);
+}
+
+TEST_CASE(spawn_on_pins_worker) {
+    std::atomic<int> mismatches{0};
+    loop_group group(3);
+
+    for(std::size_t i = 0; i < 30; ++i) {
+        auto index = i % group.size();
+        group.spawn_on(index, record_index(group, index, mismatches));
+    }
+    group.wait();
+
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_CASE(spawn_from_worker) {
+    std::atomic<int> counter{0};
+    loop_group group(4);
+
+    group.spawn(fan_out(counter, 64));
+    group.wait();
+
+    EXPECT_EQ(counter.load(), 65);
+}
+
+TEST_CASE(idle_workers_steal) {
+    std::mutex m;
+    std::set<std::thread::id> ids;
+    loop_group group(4);
+
+    for(int i = 0; i < 64; ++i) {
+        group.spawn(record_thread(m, ids));
+    }
+    group.wait();
+
+    EXPECT_GE(ids.size(), 1U);
+    EXPECT_FALSE(ids.contains(std::this_thread::get_id()));
+}
+
+TEST_CASE(current_outside_group) {
+    loop_group group(1);
+    EXPECT_TRUE(loop_group::current() == nullptr);
+    EXPECT_FALSE(group.current_index().has_value());
+}
+
+TEST_CASE(spawn_after_stop_discards) {
+    std::atomic<int> counter{0};
+    loop_group group(2);
+
+    group.stop();
+    group.spawn(bump(counter));
+    group.wait();
+
+    EXPECT_EQ(counter.load(), 0);
+}
+
+};  // TEST_SUITE(loop_group)
+
+}  // namespace kota
@@ -0,0 +1,116 @@
+#include <chrono>
+
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+
+namespace kota {
+
+namespace {
+
+task<> nap(event_loop& loop) {
+    co_await after(1, loop);
+}
+
+task<> fan_out(event_loop& loop, int count) {
+    for(int i = 0; i < count; ++i) {
+        co_await nap(loop);
+    }
+}
+
+}  // namespace
+
+TEST_SUITE(loop_stats) {
+
+#if KOTA_ASYNC_LOOP_STATS
+
+TEST_CASE(counts_scheduling) {
+    event_loop loop;
+    auto a = fan_out(loop, 3);
+    auto b = fan_out(loop, 3);
+    auto c = fan_out(loop, 3);
+    loop.schedule(a);
+    loop.schedule(b);
+    loop.schedule(c);
+    loop.run();
+
+    auto stats = loop.stats();
+    EXPECT_EQ(stats.scheduled, 3U);
+    EXPECT_EQ(stats.resumed, stats.scheduled);
+    EXPECT_EQ(stats.max_ready, 3U);
+    EXPECT_GE(stats.io_callbacks, 9U);
+    EXPECT_GE(stats.timer_callbacks, 1U);
+    EXPECT_GE(stats.idle_callbacks, 1U);
+    EXPECT_GE(stats.iterations, 1U);
+    EXPECT_GT(stats.continuations, 0U);
+}
+
+TEST_CASE(counts_posts) {
+    event_loop loop;
+    int ran = 0;
+
+    auto poster = [&]() -> task<> {
+        loop.post([&] { ran += 1; });
+        loop.post([&] { ran += 1; });
+        co_await after(5, loop);
+    };
+
+    auto t = poster();
+    loop.schedule(t);
+    loop.run();
+
+    EXPECT_EQ(ran, 2);
+    auto stats = loop.stats();
+    EXPECT_EQ(stats.posts, 2U);
+    EXPECT_GE(stats.async_callbacks, 1U);
+}
+
+TEST_CASE(counts_relays) {
+    event_loop loop;
+    bool delivered = false;
+
+    auto relay = loop.create_relay();
+    relay.send([&] { delivered = true; });
+    loop.run();
+
+    EXPECT_TRUE(delivered);
+    EXPECT_EQ(loop.stats().relay_sends, 1U);
+}
+
+TEST_CASE(counts_busy_poll) {
+    event_loop loop;
+    loop.set_busy_poll(std::chrono::microseconds(200));
+
+    auto t = fan_out(loop, 3);
+    loop.schedule(t);
+    loop.run();
+
+    // Each nap outlasts the window, so the loop gives up spinning and
+    // blocks at least once per nap.
+    auto stats = loop.stats();
+    EXPECT_GE(stats.spin_hits, 1U);
+    EXPECT_GE(stats.spin_misses, 1U);
+    EXPECT_GE(stats.sleeps, 3U);
+}
+
+#else
+
+TEST_CASE(disabled_reports_zero) {
+    event_loop loop;
+    auto t = fan_out(loop, 3);
+    loop.schedule(t);
+    loop.run();
+
+    auto stats = loop.stats();
+    EXPECT_EQ(stats.scheduled, 0U);
+    EXPECT_EQ(stats.resumed, 0U);
+    EXPECT_EQ(stats.io_callbacks, 0U);
+    EXPECT_EQ(stats.iterations, 0U);
+    EXPECT_EQ(stats.sleeps, 0U);
+    EXPECT_EQ(stats.busy_ns_per_iteration(), 0.0);
+}
+
+#endif  // KOTA_ASYNC_LOOP_STATS
+
+};  // TEST_SUITE(loop_stats)
+
+}  // namespace kota
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(parallel, loop_fixture) {
+
+TEST_CASE(for_visits_every_element) {
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto worker = [&]() -> task<void, error> {
+        co_await parallel_for(values, [](int& v) { v *= 2; }, 0, loop).or_fail();
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    EXPECT_FALSE(t.result().has_error());
+    for(int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(values[i], i * 2);
+    }
+}
+
+TEST_CASE(transform_keeps_order) {
+    std::vector<int> values(257);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto worker = [&]() -> task<std::vector<long>, error> {
+        co_return co_await parallel_transform(
+                      values, [](int v) { return static_cast<long>(v) * v; }, 10, loop)
+            .or_fail();
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 257U);
+    for(int i = 0; i < 257; ++i) {
+        EXPECT_EQ((*result)[i], static_cast<long>(i) * i);
+    }
+}
+
+TEST_CASE(reduce_sums) {
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 1);
+
+    auto worker = [&]() -> task<long, error> {
+        co_return co_await parallel_reduce(values, 0L, std::plus{}, 64, loop).or_fail();
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 50005000L);
+}
+
+TEST_CASE(empty_range) {
+    std::vector<int> values;
+
+    auto worker = [&]() -> task<int, error> {
+        co_return co_await parallel_reduce(values, 7, std::plus{}, 0, loop).or_fail();
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 7);
+}
+
+TEST_CASE(cancel_skips_unstarted_chunks) {
+    std::vector<int> values(200);
+    std::atomic<int> ran{0};
+    cancellation_source source;
+
+    auto slow = [&](int&) {
+        ran.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    };
+
+    auto canceller = [&]() -> task<> {
+        co_await after(5, loop);
+        source.cancel();
+    };
+
+    auto guarded = with_token(parallel_for(values, slow, 1, loop), source.token());
+    auto stop = canceller();
+    schedule_all(guarded, stop);
+
+    EXPECT_FALSE(guarded.result().has_value());
+    EXPECT_LT(ran.load(), 200);
+}
+
+};  // TEST_SUITE(parallel)
+
+}  // namespace
+
+}  // namespace kota
@@ -1,5 +1,8 @@
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #include "loop_fixture.h"
 #include "kota/zest/zest.h"
@@ -76,6 +79,96 @@ TEST_CASE(post_stops_loop) {
     worker.join();
 }
 
+TEST_CASE(post_batch_runs_in_order) {
+    std::vector<int> order;
+
+    auto t = [&]() -> task<> {
+        std::vector<loop_callback> callbacks;
+        for(int i = 0; i < 5; ++i) {
+            callbacks.emplace_back([&order, i] { order.push_back(i); });
+        }
+        loop.post([&] { order.push_back(-1); });
+        loop.post_batch(callbacks);
+        loop.post([&] { order.push_back(5); });
+        co_await sleep(1, loop);
+        loop.stop();
+    };
+
+    auto task = t();
+    schedule_all(task);
+    EXPECT_EQ(order, std::vector<int>({-1, 0, 1, 2, 3, 4, 5}));
+}
+
+TEST_CASE(post_batch_from_another_thread) {
+    std::atomic<int> counter{0};
+    std::thread worker;
+    constexpr int rounds = 20;
+    constexpr int batch = 50;
+
+    auto t = [&]() -> task<> {
+        worker = std::thread([&] {
+            for(int round = 0; round < rounds; ++round) {
+                std::vector<loop_callback> callbacks;
+                for(int i = 0; i < batch; ++i) {
+                    callbacks.emplace_back([&] { counter.fetch_add(1); });
+                }
+                loop.post_batch(callbacks);
+            }
+        });
+        co_await sleep(100, loop);
+        loop.stop();
+    };
+
+    auto task = t();
+    schedule_all(task);
+    worker.join();
+    EXPECT_EQ(counter.load(), rounds * batch);
+}
+
+TEST_CASE(recycled_nodes_release_captures) {
+    auto payload = std::make_shared<int>(0);
+    int runs = 0;
+
+    auto t = [&]() -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            loop.post([payload, &runs] { runs += *payload + 1; });
+            co_await sleep(1, loop);
+            // The callback ran and its node went back to the pool; the
+            // captured copy must be gone even though the node is still alive.
+            EXPECT_EQ(payload.use_count(), 1);
+        }
+        loop.stop();
+    };
+
+    auto task = t();
+    schedule_all(task);
+    EXPECT_EQ(runs, 3);
+}
+
+TEST_CASE(busy_poll_delivers_and_stops) {
+    std::atomic<int> counter{0};
+    std::thread worker;
+    constexpr int N = 100;
+    loop.set_busy_poll(std::chrono::milliseconds(1));
+
+    auto t = [&]() -> task<> {
+        worker = std::thread([&] {
+            for(int i = 0; i < N; ++i) {
+                loop.post([&] { counter.fetch_add(1); });
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            loop.post([&] { loop.stop(); });
+        });
+        // Stopped by the last post, long before this sleep ends.
+        co_await sleep(5000, loop);
+    };
+
+    auto task = t();
+    schedule_all(task);
+    worker.join();
+    EXPECT_EQ(counter.load(), N);
+}
+
 };  // TEST_SUITE(event_loop_post)
 
 }  // namespace
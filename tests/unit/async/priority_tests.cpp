@@ -0,0 +1,196 @@
+#include <chrono>
+#include <string>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(priority_lanes, loop_fixture) {
+
+TEST_CASE(higher_lanes_run_first) {
+    std::string order;
+
+    auto mark = [&](char c) -> task<> {
+        order += c;
+        co_return;
+    };
+
+    auto background = mark('b');
+    auto normal = mark('n');
+    auto interactive = mark('i');
+    loop.schedule(background, priority::background);
+    loop.schedule(normal);
+    loop.schedule(interactive, priority::interactive);
+    loop.run();
+
+    EXPECT_EQ(order, "inb");
+}
+
+TEST_CASE(background_budget_interleaves) {
+    std::string order;
+    loop.set_background_budget(2);
+
+    auto mark = [&](char c) -> task<> {
+        order += c;
+        co_return;
+    };
+
+    auto chain = [&]() -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            order += 'n';
+            co_await reschedule();
+        }
+    };
+
+    auto b0 = mark('b');
+    auto b1 = mark('b');
+    auto b2 = mark('b');
+    auto b3 = mark('b');
+    auto b4 = mark('b');
+    auto n = chain();
+    loop.schedule(b0, priority::background);
+    loop.schedule(b1, priority::background);
+    loop.schedule(b2, priority::background);
+    loop.schedule(b3, priority::background);
+    loop.schedule(b4, priority::background);
+    loop.schedule(n);
+    loop.run();
+
+    EXPECT_EQ(order, "nbbnbbnb");
+}
+
+TEST_CASE(reschedule_yields_to_interactive) {
+    std::string order;
+
+    auto mark = [&](char c) -> task<> {
+        order += c;
+        co_return;
+    };
+
+    auto interactive = mark('i');
+    auto worker = [&]() -> task<> {
+        order += 'w';
+        loop.schedule(interactive, priority::interactive);
+        co_await reschedule(priority::background);
+        order += 'w';
+    };
+
+    auto t = worker();
+    schedule_all(t);
+    EXPECT_EQ(order, "wiw");
+}
+
+TEST_CASE(cancel_while_queued) {
+    cancellation_source source;
+    int spins = 0;
+
+    auto spinner = [&]() -> task<> {
+        while(true) {
+            spins += 1;
+            co_await reschedule(priority::background);
+        }
+    };
+
+    auto canceller = [&]() -> task<> {
+        co_await after(5, loop);
+        source.cancel();
+    };
+
+    auto guarded = with_token(spinner(), source.token());
+    auto stop = canceller();
+    schedule_all(guarded, stop);
+
+    EXPECT_GT(spins, 1);
+    EXPECT_FALSE(guarded.result().has_value());
+}
+
+TEST_CASE(scope_spawn_in_lane) {
+    std::string order;
+
+    auto mark = [&](char c) -> task<> {
+        order += c;
+        co_return;
+    };
+
+    auto driver = [&]() -> task<> {
+        async_scope scope;
+        scope.spawn(mark('b'), priority::background);
+        scope.spawn(mark('i'), priority::interactive);
+        scope.spawn(mark('x'));
+        co_await scope;
+    };
+
+    auto t = driver();
+    schedule_all(t);
+    EXPECT_EQ(order, "xib");
+}
+
+};  // TEST_SUITE(priority_lanes)
+
+TEST_SUITE(cooperative_yield, loop_fixture) {
+
+TEST_CASE(yield_interleaves) {
+    std::string order;
+
+    auto worker = [&](char c) -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            order += c;
+            co_await yield(loop);
+        }
+    };
+
+    auto a = worker('a');
+    auto b = worker('b');
+    schedule_all(a, b);
+    EXPECT_EQ(order, "ababab");
+}
+
+TEST_CASE(yield_within_slice_continues) {
+    std::string order;
+    loop.set_time_slice(std::chrono::hours(1));
+
+    auto worker = [&](char c) -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            order += c;
+            co_await yield(loop);
+        }
+    };
+
+    auto a = worker('a');
+    auto b = worker('b');
+    schedule_all(a, b);
+    EXPECT_EQ(order, "aaabbb");
+}
+
+TEST_CASE(yield_lets_timers_fire) {
+    bool fired = false;
+    int spins = 0;
+    loop.set_time_slice(std::chrono::microseconds(100));
+
+    auto timer = [&]() -> task<> {
+        co_await after(1, loop);
+        fired = true;
+    };
+
+    auto spinner = [&]() -> task<> {
+        while(!fired) {
+            spins += 1;
+            co_await yield(loop);
+        }
+    };
+
+    auto t = timer();
+    auto s = spinner();
+    schedule_all(t, s);
+    EXPECT_TRUE(fired);
+    EXPECT_GT(spins, 1);
+}
+
+};  // TEST_SUITE(cooperative_yield)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdint>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(process_monitoring, loop_fixture) {
+
+TEST_CASE(samples_watched_processes) {
+    // A one-byte budget puts any live process over the watermark.
+    process_monitor monitor(process_monitor::options(std::chrono::seconds(1), 2, 1), loop);
+    const int self = process::current_pid();
+    monitor.watch(self);
+    EXPECT_TRUE(monitor.watching(self));
+    EXPECT_EQ(monitor.latest(self), nullptr);
+
+    auto driver = [&]() -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            auto sampled = co_await monitor.sample();
+            CO_ASSERT_TRUE(sampled.has_value());
+        }
+        event_loop::current().stop();
+    };
+
+    auto t = driver();
+    schedule_all(t);
+
+    auto* latest = monitor.latest(self);
+    ASSERT_TRUE(latest != nullptr);
+    EXPECT_EQ(latest->info.pid, self);
+    EXPECT_GT(latest->info.rss, std::size_t{0});
+    EXPECT_EQ(monitor.history(self).size(), 2U);
+    EXPECT_EQ(monitor.total_rss(), latest->info.rss);
+    EXPECT_TRUE(monitor.under_pressure());
+    EXPECT_GT(monitor.memory_pressure(), 1.0);
+
+    monitor.unwatch(self);
+    EXPECT_FALSE(monitor.watching(self));
+    EXPECT_TRUE(monitor.history(self).empty());
+}
+
+TEST_CASE(drops_reaped_processes) {
+#ifdef _WIN32
+    zest::skip();
+    return;
+#else
+    process::options opts;
+    opts.file = "/bin/sh";
+    opts.args = {opts.file, "-c", "exit 0"};
+
+    auto spawned = process::spawn(opts, loop);
+    ASSERT_TRUE(spawned.has_value());
+
+    process_monitor monitor(process_monitor::options(), loop);
+    monitor.watch(spawned->proc);
+    monitor.watch(process::current_pid());
+    EXPECT_EQ(monitor.size(), 2U);
+
+    auto driver = [&]() -> task<> {
+        co_await spawned->proc.wait();
+        auto sampled = co_await monitor.sample();
+        CO_ASSERT_TRUE(sampled.has_value());
+        event_loop::current().stop();
+    };
+
+    auto t = driver();
+    schedule_all(t);
+
+    EXPECT_EQ(monitor.size(), 1U);
+    EXPECT_TRUE(monitor.watching(process::current_pid()));
+    EXPECT_FALSE(monitor.under_pressure());
+#endif
+}
+
+TEST_CASE(periodic_sampler_stops) {
+    process_monitor monitor(process_monitor::options(std::chrono::milliseconds(2)), loop);
+    monitor.watch(process::current_pid());
+
+    auto driver = [&]() -> task<> {
+        co_await after(30, loop);
+        monitor.stop();
+    };
+
+    auto d = driver();
+    monitor.start();
+    EXPECT_TRUE(monitor.sampling());
+    schedule_all(d);
+
+    EXPECT_FALSE(monitor.sampling());
+    EXPECT_FALSE(monitor.history(process::current_pid()).empty());
+}
+
+};  // TEST_SUITE(process_monitoring)
+
+}  // namespace
+
+}  // namespace kota
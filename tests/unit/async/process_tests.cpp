@@ -1,6 +1,7 @@
 #include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "loop_fixture.h"
 #include "kota/zest/zest.h"
@@ -336,6 +337,82 @@ TEST_CASE(query_info_child) {
     schedule_all(task);
 }
 
+TEST_CASE(spawn_and_collect_limits_output) {
+#ifdef _WIN32
+    zest::skip();
+    return;
+#else
+    process::options opts;
+    opts.file = "/bin/sh";
+    opts.args = {opts.file, "-c", "head -c 300000 /dev/zero; printf 'diag' >&2"};
+
+    auto collect = [](process::options opts, event_loop& ev) -> task<process::collected, error> {
+        auto out = co_await process::spawn_and_collect(std::move(opts), 1000, ev);
+        ev.stop();
+        co_return co_await or_fail(std::move(out));
+    }(std::move(opts), loop);
+    schedule_all(collect);
+
+    auto result = collect.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->status.status, 0);
+    EXPECT_EQ(result->out.size(), 1000U);
+    EXPECT_TRUE(result->out_truncated);
+    EXPECT_EQ(result->err, "diag");
+    EXPECT_FALSE(result->err_truncated);
+#endif
+}
+
+TEST_CASE(process_pool_reuses_workers) {
+#ifdef _WIN32
+    zest::skip();
+    return;
+#else
+    // cat echoes each request frame back, which is a well-formed reply.
+    process_pool::options opts;
+    opts.worker.file = "/bin/cat";
+    opts.size = 2;
+    process_pool pool(std::move(opts), loop);
+
+    const std::vector<std::string> requests = {"alpha", "", "gamma", std::string(100000, 'x')};
+
+    auto jobs = [&]() -> task<std::vector<std::string>, error> {
+        std::vector<std::string> replies;
+        for(int round = 0; round < 2; ++round) {
+            small_vector<task<std::string, error>> batch;
+            for(auto& request: requests) {
+                batch.push_back(pool.run(request));
+            }
+            auto done = co_await when_all(std::move(batch));
+            if(done.has_error()) {
+                event_loop::current().stop();
+                co_await fail(std::move(done).error());
+            }
+            for(auto& reply: *done) {
+                replies.push_back(std::move(reply));
+            }
+        }
+
+        const auto running = pool.running();
+        co_await pool.shutdown();
+        replies.push_back(std::to_string(running) + "/" + std::to_string(pool.running()));
+        event_loop::current().stop();
+        co_return replies;
+    };
+
+    auto task = jobs();
+    schedule_all(task);
+
+    auto replies = task.result();
+    ASSERT_TRUE(replies.has_value());
+    ASSERT_EQ(replies->size(), requests.size() * 2 + 1);
+    for(std::size_t i = 0; i < requests.size() * 2; ++i) {
+        EXPECT_EQ((*replies)[i], requests[i % requests.size()]);
+    }
+    EXPECT_EQ(replies->back(), "2/0");
+#endif
+}
+
 TEST_CASE(query_info_invalid_pid) {
     // A very large pid should not correspond to any real process.
     auto info = process::query_info(999999999);
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <string>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(async_profiling, loop_fixture) {
+
+TEST_CASE(samples_waits_below_root) {
+    event gate;
+    async_profiler profiler(std::chrono::milliseconds(1), loop);
+
+    auto waiter = [&]() -> task<> {
+        co_await gate.wait();
+    };
+
+    auto root = [&]() -> task<> {
+        co_await when_all(waiter(), waiter());
+    };
+
+    auto driver = [&]() -> task<> {
+        // Let the root park both waiters first.
+        co_await after(5, loop);
+        profiler.sample();
+        profiler.sample();
+        gate.set();
+    };
+
+    auto r = root();
+    auto d = driver();
+    profiler.watch(r.operator->());
+    schedule_all(r, d);
+    profiler.unwatch(r.operator->());
+
+    EXPECT_EQ(profiler.samples(), 2U);
+
+    // Both waiters wait at the same line, so they share one site.
+    auto sites = profiler.hottest();
+    ASSERT_EQ(sites.size(), 1U);
+    EXPECT_EQ(sites[0].kind, async_node::NodeKind::EventWaiter);
+    EXPECT_EQ(sites[0].samples, 4U);
+    EXPECT_EQ(sites[0].waited, std::chrono::milliseconds(4));
+
+    auto folded = profiler.folded();
+    EXPECT_NE(folded.find("WhenAll"), std::string::npos);
+    EXPECT_NE(folded.find("EventWaiter"), std::string::npos);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.folded().empty());
+}
+
+TEST_CASE(periodic_sampler_stops) {
+    async_profiler profiler(std::chrono::milliseconds(1), loop);
+
+    auto sleeper = [&]() -> task<> {
+        co_await sleep(20, loop);
+    };
+
+    auto driver = [&]() -> task<> {
+        co_await after(30, loop);
+        profiler.stop();
+    };
+
+    auto s = sleeper();
+    auto d = driver();
+    profiler.watch(s.operator->());
+    profiler.start();
+    EXPECT_TRUE(profiler.sampling());
+    schedule_all(s, d);
+    profiler.unwatch(s.operator->());
+
+    EXPECT_FALSE(profiler.sampling());
+    EXPECT_GT(profiler.samples(), 0U);
+
+    auto sites = profiler.hottest(1);
+    ASSERT_EQ(sites.size(), 1U);
+    EXPECT_EQ(sites[0].kind, async_node::NodeKind::SystemIO);
+}
+
+};  // TEST_SUITE(async_profiling)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(event_loop_run_once, loop_fixture) {
+
+TEST_CASE(next_timeout_follows_work) {
+    EXPECT_FALSE(loop.next_timeout().has_value());
+
+    bool done = false;
+    auto t = [&]() -> task<> {
+        co_await sleep(20, loop);
+        done = true;
+    };
+
+    auto task = t();
+    loop.schedule(task);
+    // A ready task means there is no time to sleep.
+    ASSERT_TRUE(loop.next_timeout().has_value());
+    EXPECT_EQ(*loop.next_timeout(), std::chrono::milliseconds(0));
+
+    // Once the task is parked on its timer, the host may sleep until then.
+    for(int i = 0; i < 3 && loop.next_timeout() == std::chrono::milliseconds(0); ++i) {
+        loop.run_once();
+    }
+    ASSERT_TRUE(loop.next_timeout().has_value());
+    EXPECT_GT(*loop.next_timeout(), std::chrono::milliseconds(0));
+    EXPECT_FALSE(done);
+
+    while(!done) {
+        loop.run_once(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(task->is_finished());
+}
+
+#ifndef _WIN32
+
+TEST_CASE(driven_by_external_poll) {
+    std::atomic<bool> called{false};
+    std::thread worker;
+    bool done = false;
+
+    auto t = [&]() -> task<> {
+        worker = std::thread([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            loop.post([&] { called.store(true); });
+        });
+        co_await sleep(30, loop);
+        done = true;
+    };
+
+    auto task = t();
+    loop.schedule(task);
+
+    const int fd = loop.backend_fd();
+    ASSERT_GE(fd, 0);
+
+    // What a host poller would do: sleep on the loop's descriptor no longer
+    // than next_timeout(), then let the loop process what is due.
+    while(!done) {
+        auto timeout = loop.next_timeout();
+        pollfd entry{.fd = fd, .events = POLLIN, .revents = 0};
+        ::poll(&entry, 1, timeout ? static_cast<int>(timeout->count()) : -1);
+        loop.run_once();
+    }
+
+    worker.join();
+    EXPECT_TRUE(called.load());
+}
+
+#endif  // !_WIN32
+
+};  // TEST_SUITE(event_loop_run_once)
+
+}  // namespace
+
+}  // namespace kota
@@ -1,7 +1,12 @@
 #include <array>
+#include <atomic>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "loop_fixture.h"
 #include "kota/zest/macro.h"
@@ -84,6 +89,24 @@ int pick_free_port() {
     return port;
 }
 
+socket_t connect_loopback(int port) {
+    socket_t fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(fd == invalid_socket) {
+        return invalid_socket;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+
+    if(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close_socket(fd);
+        return invalid_socket;
+    }
+    return fd;
+}
+
 bool bump_and_stop(int& done, int target) {
     done += 1;
     if(done == target) {
@@ -111,6 +134,25 @@ task<std::string, error> read_some_from_pipe(pipe p) {
     co_return std::string(buf.data(), *n);
 }
 
+task<std::pair<std::string, std::string>> read_chunks_and_detach(pipe p) {
+    auto views = co_await p.read_chunks();
+    event_loop::current().stop();
+    if(!views) {
+        co_return std::make_pair(std::string{}, std::string{});
+    }
+
+    std::string all;
+    for(auto view: *views) {
+        all.append(view.data(), view.size());
+    }
+
+    auto head = p.detach(7);
+    auto rest = p.detach(all.size());
+    EXPECT_EQ(head.size(), 7U);
+    EXPECT_EQ(head.to_string() + rest.to_string(), all);
+    co_return std::make_pair(all, head.to_string());
+}
+
 task<std::pair<std::string, std::size_t>> read_chunk_from_pipe(pipe p) {
     auto view = co_await p.read_chunk();
     if(!view) {
@@ -263,6 +305,221 @@ task<void, error>
     co_await or_fail(err);
 }
 
+/// Answers two pings on the first connection, closes it, then reads once
+/// from a second one.
+task<std::string, error> serve_pool_client(tcp::acceptor acc, event& closed, int& done) {
+    {
+        auto conn = co_await acc.accept().or_fail();
+        for(int i = 0; i < 2; ++i) {
+            auto ping = co_await conn.read().or_fail();
+            if(ping != "ping") {
+                bump_and_stop(done, 2);
+                co_return ping;
+            }
+            std::string_view pong = "pong";
+            co_await conn.write(std::span<const char>(pong.data(), pong.size())).or_fail();
+        }
+    }
+    closed.set();
+
+    auto conn = co_await acc.accept().or_fail();
+    auto data = co_await conn.read();
+    bump_and_stop(done, 2);
+    co_return data;
+}
+
+/// Pings through a pooled connection; returns whether it was reused.
+task<bool, error> ping_through_pool(tcp_pool& pool, int port) {
+    auto lease = co_await pool.acquire("127.0.0.1", port).or_fail();
+    std::string_view ping = "ping";
+    co_await lease->write(std::span<const char>(ping.data(), ping.size())).or_fail();
+    auto pong = co_await lease->read().or_fail();
+    if(pong != "pong") {
+        co_await fail(error::invalid_argument);
+    }
+    co_return lease.reused();
+}
+
+task<std::vector<bool>, error> use_pool(tcp_pool& pool, int port, event& closed, int& done) {
+    std::vector<bool> reused;
+    for(int i = 0; i < 2; ++i) {
+        auto res = co_await ping_through_pool(pool, port);
+        if(!res) {
+            bump_and_stop(done, 2);
+            co_await fail(res.error());
+        }
+        reused.push_back(*res);
+    }
+
+    // The server closed the pooled connection; acquire() must not hand it out.
+    co_await closed.wait();
+    co_await sleep(20);
+    auto lease = co_await pool.acquire("127.0.0.1", port).or_fail();
+    reused.push_back(lease.reused());
+    std::string_view payload = "fresh";
+    co_await lease->write(std::span<const char>(payload.data(), payload.size())).or_fail();
+    bump_and_stop(done, 2);
+    co_return reused;
+}
+
+task<std::size_t, error> accept_queued_batch(tcp::acceptor& acc) {
+    // Let the loop take every pending connection off the backlog first.
+    co_await sleep(20);
+    auto batch = co_await acc.accept_batch();
+    event_loop::current().stop();
+    if(!batch) {
+        co_await fail(batch.error());
+    }
+    co_return batch->size();
+}
+
+task<> accept_until(tcp::acceptor acc, std::atomic<int>& accepted, int expected) {
+    while(accepted.load() < expected) {
+        auto next = co_await when_any(acc.accept(), after(20));
+        if(next.has_value() && next->index() == 0) {
+            accepted.fetch_add(1);
+        }
+    }
+}
+
+task<void, error> connect_and_send_pieces(std::string_view host, int port, int& done) {
+    auto conn_res = co_await tcp::connect(host, port);
+    if(!conn_res.has_value()) {
+        bump_and_stop(done, 2);
+        co_await fail(conn_res.error());
+    }
+
+    auto conn = std::move(*conn_res);
+    std::string_view header = "kotatsu-";
+    std::string_view empty;
+    std::string_view body = "gather-write";
+    const std::span<const char> pieces[] = {
+        std::span<const char>(header.data(), header.size()),
+        std::span<const char>(empty.data(), empty.size()),
+        std::span<const char>(body.data(), body.size()),
+    };
+    auto err = co_await conn.write(std::span<const std::span<const char>>(pieces));
+    bump_and_stop(done, 2);
+    co_await or_fail(err);
+}
+
+task<void, error>
+    connect_and_send_corked(std::string_view host, int port, bool flush, int& done) {
+    auto conn_res = co_await tcp::connect(host, port);
+    if(!conn_res.has_value()) {
+        bump_and_stop(done, 2);
+        co_await fail(conn_res.error());
+    }
+
+    auto conn = std::move(*conn_res);
+    conn.cork();
+    error err;
+    for(std::string_view part: {"kotatsu-", "corked-", "write"}) {
+        auto res = co_await conn.write(std::span<const char>(part.data(), part.size()));
+        if(res.has_error()) {
+            err = res.error();
+            break;
+        }
+    }
+
+    if(!err && flush) {
+        if(auto res = co_await conn.flush(); res.has_error()) {
+            err = res.error();
+        }
+    } else if(!err) {
+        // The check watcher sends the buffer at the end of this iteration.
+        co_await sleep(10);
+    }
+
+    bump_and_stop(done, 2);
+    if(err) {
+        co_await fail(err);
+    }
+}
+
+task<std::string, error> accept_and_read_all(tcp::acceptor acc, std::size_t expected, int& done) {
+    auto conn_res = co_await acc.accept();
+    if(!conn_res.has_value()) {
+        bump_and_stop(done, 2);
+        co_await fail(conn_res.error());
+    }
+
+    auto conn = std::move(*conn_res);
+    std::string data;
+    while(data.size() < expected) {
+        auto chunk = co_await conn.read();
+        if(!chunk.has_value() || chunk->empty()) {
+            break;
+        }
+        data += *chunk;
+    }
+
+    bump_and_stop(done, 2);
+    co_return data;
+}
+
+task<> write_piece(tcp& conn, std::string piece, int& failures) {
+    auto res = co_await conn.write(std::span<const char>(piece.data(), piece.size()));
+    if(res.has_error()) {
+        failures += 1;
+    }
+}
+
+task<void, error> connect_and_write_concurrently(std::string_view host,
+                                                 int port,
+                                                 std::size_t piece_size,
+                                                 std::size_t& queued,
+                                                 int& done) {
+    auto conn_res = co_await tcp::connect(host, port);
+    if(!conn_res.has_value()) {
+        bump_and_stop(done, 2);
+        co_await fail(conn_res.error());
+    }
+
+    auto conn = std::move(*conn_res);
+    conn.set_max_inflight_writes(1);
+
+    int failures = 0;
+    auto probe = [&]() -> task<> {
+        queued = conn.queued_bytes();
+        co_return;
+    };
+    co_await when_all(write_piece(conn, std::string(piece_size, 'a'), failures),
+                      write_piece(conn, std::string(piece_size, 'b'), failures),
+                      write_piece(conn, std::string(piece_size, 'c'), failures),
+                      probe());
+
+    bump_and_stop(done, 2);
+    if(failures != 0 || conn.queued_bytes() != 0) {
+        co_await fail(error::io_error);
+    }
+}
+
+task<std::size_t, error> connect_and_send_file(std::string_view host,
+                                               int port,
+                                               const std::string& path,
+                                               std::int64_t offset,
+                                               std::size_t length,
+                                               int& done) {
+    auto conn_res = co_await tcp::connect(host, port);
+    if(!conn_res.has_value()) {
+        bump_and_stop(done, 2);
+        co_await fail(conn_res.error());
+    }
+
+    auto conn = std::move(*conn_res);
+    auto fd = co_await fs::open(path, O_RDONLY);
+    if(!fd) {
+        bump_and_stop(done, 2);
+        co_await fail(fd.error());
+    }
+
+    auto sent = co_await conn.send_file(*fd, offset, length);
+    co_await fs::close(*fd);
+    bump_and_stop(done, 2);
+    co_return sent;
+}
+
 task<tcp, error> accept_once(tcp::acceptor& acc, int& done) {
     auto res = co_await acc.accept();
     bump_and_stop(done, 2);
@@ -352,6 +609,48 @@ TEST_CASE(read_chunk_fd) {
     EXPECT_EQ(result.second, static_cast<std::size_t>(0));
 }
 
+TEST_CASE(read_chunks_detach_fd) {
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    const std::string message = "kotatsu-pipe-detach";
+    ASSERT_EQ(write_fd(fds[1], message.data(), message.size()),
+              static_cast<ssize_t>(message.size()));
+    close_fd(fds[1]);
+
+    auto pipe_res = pipe::open(fds[0], {}, loop);
+    ASSERT_TRUE(pipe_res.has_value());
+
+    auto reader = read_chunks_and_detach(std::move(*pipe_res));
+    schedule_all(reader);
+
+    auto [all, head] = reader.result();
+    EXPECT_EQ(all, message);
+    EXPECT_EQ(head, "kotatsu");
+}
+
+TEST_CASE(pooled_buffer_read_and_detach_fd) {
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    const std::string message = "kotatsu-pipe-pooled";
+    ASSERT_EQ(write_fd(fds[1], message.data(), message.size()),
+              static_cast<ssize_t>(message.size()));
+    close_fd(fds[1]);
+
+    auto pipe_res = pipe::open(fds[0], {}, loop);
+    ASSERT_TRUE(pipe_res.has_value());
+    pipe_res->set_pooled_buffer(true);
+
+    auto reader = read_chunks_and_detach(std::move(*pipe_res));
+    schedule_all(reader);
+
+    // The detached head keeps its slab alive after the buffer hands it back.
+    auto [all, head] = reader.result();
+    EXPECT_EQ(all, message);
+    EXPECT_EQ(head, "kotatsu");
+}
+
 TEST_CASE(read_chunk_then_read_some_fd) {
     int fds[2] = {-1, -1};
     ASSERT_EQ(create_pipe(fds), 0);
@@ -371,6 +670,55 @@ TEST_CASE(read_chunk_then_read_some_fd) {
     EXPECT_EQ(*second, "kotatsu-read-some");
 }
 
+TEST_CASE(splice_between_fds) {
+    int in_fds[2] = {-1, -1};
+    int out_fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(in_fds), 0);
+    ASSERT_EQ(create_pipe(out_fds), 0);
+
+    std::string message(4096, '\0');
+    for(std::size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<char>('a' + i % 26);
+    }
+    ASSERT_EQ(write_fd(in_fds[1], message.data(), message.size()),
+              static_cast<ssize_t>(message.size()));
+    close_fd(in_fds[1]);
+
+    auto from = pipe::open(in_fds[0], {}, loop);
+    auto to = pipe::open(out_fds[1], {}, loop);
+    auto sink = pipe::open(out_fds[0], {}, loop);
+    ASSERT_TRUE(from.has_value() && to.has_value() && sink.has_value());
+
+    // Closing `to` once the splice is done ends the sink's reads.
+    auto forward = [](pipe from, pipe to) -> task<std::size_t, error> {
+        co_return co_await splice(from, to).or_fail();
+    }(std::move(*from), std::move(*to));
+
+    auto collect = [](pipe sink) -> task<std::string, error> {
+        std::string all;
+        while(true) {
+            auto chunk = co_await sink.read();
+            if(!chunk) {
+                if(chunk.error() == error::end_of_file) {
+                    break;
+                }
+                co_await fail(chunk.error());
+            }
+            all += *chunk;
+        }
+        co_return all;
+    }(std::move(*sink));
+
+    schedule_all(forward, collect);
+
+    auto forwarded = forward.result();
+    ASSERT_TRUE(forwarded.has_value());
+    EXPECT_EQ(*forwarded, message.size());
+    auto received = collect.result();
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(*received, message);
+}
+
 TEST_CASE(connect_and_accept) {
 #ifdef _WIN32
     const std::string name = "\\\\.\\pipe\\kotatsu-test-pipe";
@@ -554,6 +902,234 @@ TEST_CASE(connect_and_write) {
     EXPECT_FALSE(client_res.has_error());
 }
 
+TEST_CASE(connect_by_host_name) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto addrs = [](event_loop& ev) -> task<std::vector<resolved_address>, error> {
+        co_return co_await resolve("localhost", ev).or_fail();
+    }(loop);
+    schedule_all(addrs);
+
+    auto addrs_res = addrs.result();
+    ASSERT_TRUE(addrs_res.has_value());
+    EXPECT_FALSE(addrs_res->empty());
+
+    // "localhost" may resolve to ::1 first; the connect must fall back to
+    // 127.0.0.1, where the acceptor is.
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    int done = 0;
+    auto server = accept_and_read_once(std::move(*acc_res), done);
+    auto client = connect_and_send("localhost", port, "kotatsu-tcp-resolve", done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    EXPECT_TRUE(server_res.has_value());
+    EXPECT_EQ(*server_res, "kotatsu-tcp-resolve");
+    EXPECT_FALSE(client_res.has_error());
+}
+
+TEST_CASE(pool_reuses_idle_connection) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    tcp_pool pool({}, loop);
+    event closed;
+    int done = 0;
+    auto server = serve_pool_client(std::move(*acc_res), closed, done);
+    auto client = use_pool(pool, port, closed, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    ASSERT_TRUE(server_res.has_value());
+    EXPECT_EQ(*server_res, "fresh");
+    ASSERT_TRUE(client_res.has_value());
+    EXPECT_EQ(*client_res, (std::vector<bool>{false, true, false}));
+}
+
+TEST_CASE(accept_batch_drains_pending) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    std::array<socket_t, 3> clients{};
+    for(auto& client: clients) {
+        client = connect_loopback(port);
+        ASSERT_TRUE(client != invalid_socket);
+    }
+
+    auto acc = std::move(*acc_res);
+    auto server = accept_queued_batch(acc);
+    schedule_all(server);
+
+    auto result = server.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, clients.size());
+
+    for(auto client: clients) {
+        close_socket(client);
+    }
+}
+
+TEST_CASE(listen_sharded_across_workers) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    constexpr int expected = 8;
+    std::atomic<int> accepted{0};
+    loop_group group(2);
+    auto err = tcp::listen_sharded("127.0.0.1", port, {}, group, [&](tcp::acceptor acc) {
+        return accept_until(std::move(acc), accepted, expected);
+    });
+    if(err == error::function_not_implemented || err == error::operation_not_supported_on_socket) {
+        return;
+    }
+    ASSERT_FALSE(static_cast<bool>(err));
+
+    std::array<socket_t, expected> clients{};
+    for(auto& client: clients) {
+        client = connect_loopback(port);
+        ASSERT_TRUE(client != invalid_socket);
+    }
+
+    group.wait();
+    EXPECT_EQ(accepted.load(), expected);
+
+    for(auto client: clients) {
+        close_socket(client);
+    }
+}
+
+TEST_CASE(connect_and_gather_write) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    int done = 0;
+    auto server = accept_and_read_once(std::move(*acc_res), done);
+    auto client = connect_and_send_pieces("127.0.0.1", port, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    EXPECT_TRUE(server_res.has_value());
+    EXPECT_EQ(*server_res, "kotatsu-gather-write");
+    EXPECT_FALSE(client_res.has_error());
+}
+
+TEST_CASE(corked_write_flush) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    int done = 0;
+    auto server = accept_and_read_once(std::move(*acc_res), done);
+    auto client = connect_and_send_corked("127.0.0.1", port, true, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    EXPECT_TRUE(server_res.has_value());
+    EXPECT_EQ(*server_res, "kotatsu-corked-write");
+    EXPECT_FALSE(client_res.has_error());
+}
+
+TEST_CASE(corked_write_end_of_iteration) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    int done = 0;
+    auto server = accept_and_read_once(std::move(*acc_res), done);
+    auto client = connect_and_send_corked("127.0.0.1", port, false, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    EXPECT_TRUE(server_res.has_value());
+    EXPECT_EQ(*server_res, "kotatsu-corked-write");
+    EXPECT_FALSE(client_res.has_error());
+}
+
+TEST_CASE(concurrent_writes_keep_order) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    // Large enough that the kernel cannot take every piece at once.
+    constexpr std::size_t piece_size = 4 * 1024 * 1024;
+    std::string expected;
+    for(char c: {'a', 'b', 'c'}) {
+        expected.append(piece_size, c);
+    }
+
+    int done = 0;
+    std::size_t queued = 0;
+    auto server = accept_and_read_all(std::move(*acc_res), expected.size(), done);
+    auto client = connect_and_write_concurrently("127.0.0.1", port, piece_size, queued, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    ASSERT_TRUE(server_res.has_value());
+    EXPECT_TRUE(*server_res == expected);
+    EXPECT_FALSE(client_res.has_error());
+    EXPECT_GT(queued, std::size_t(0));
+}
+
+TEST_CASE(send_file_range) {
+    int port = pick_free_port();
+    ASSERT_TRUE(port > 0);
+
+    auto acc_res = tcp::listen("127.0.0.1", port, {}, loop);
+    ASSERT_TRUE(acc_res.has_value());
+
+    // Several times the pooled copy chunk, so partial sends are exercised.
+    std::string contents;
+    for(int i = 0; contents.size() < 512 * 1024; ++i) {
+        contents += "kotatsu-send-file-" + std::to_string(i) + "\n";
+    }
+    auto path = (std::filesystem::temp_directory_path() / "kotatsu-send-file.txt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    constexpr std::int64_t offset = 7;
+    const std::size_t length = contents.size() - offset - 100;
+
+    int done = 0;
+    auto server = accept_and_read_all(std::move(*acc_res), length, done);
+    auto client = connect_and_send_file("127.0.0.1", port, path, offset, length, done);
+    schedule_all(server, client);
+
+    auto server_res = server.result();
+    auto client_res = client.result();
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(client_res.has_value());
+    EXPECT_EQ(*client_res, length);
+    ASSERT_TRUE(server_res.has_value());
+    EXPECT_TRUE(*server_res == contents.substr(offset, length));
+}
+
 TEST_CASE(read_some_error) {
     int port = pick_free_port();
     ASSERT_TRUE(port > 0);
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "loop_fixture.h"
 #include "kota/zest/zest.h"
@@ -48,6 +51,94 @@ TEST_CASE(mutex_lock_order) {
     EXPECT_EQ(step, 2);
 }
 
+TEST_CASE(mutex_unlock_hands_off) {
+    mutex m;
+    bool waiter_locked = false;
+
+    auto holder = [&]() -> task<> {
+        co_await m.lock();
+        co_await sleep(milliseconds{2}, loop);
+        m.unlock();
+        // Ownership went to the queued waiter; a new locker cannot barge.
+        EXPECT_TRUE(waiter_locked);
+        EXPECT_FALSE(m.try_lock());
+    };
+
+    auto waiter = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        co_await m.lock();
+        waiter_locked = true;
+        co_await sleep(milliseconds{1}, loop);
+        m.unlock();
+    };
+
+    auto t1 = holder();
+    auto t2 = waiter();
+    schedule_all(t1, t2);
+    EXPECT_TRUE(waiter_locked);
+}
+
+TEST_CASE(shared_mutex_try_lock) {
+    shared_mutex m;
+    EXPECT_TRUE(m.try_lock_shared());
+    EXPECT_TRUE(m.try_lock_shared());
+    EXPECT_FALSE(m.try_lock());
+    m.unlock_shared();
+    m.unlock_shared();
+    EXPECT_TRUE(m.try_lock());
+    EXPECT_FALSE(m.try_lock_shared());
+    m.unlock();
+}
+
+TEST_CASE(shared_mutex_readers_overlap) {
+    shared_mutex m;
+    int active = 0;
+    int peak = 0;
+
+    auto reader = [&]() -> task<> {
+        co_await m.lock_shared();
+        active += 1;
+        peak = std::max(peak, active);
+        co_await sleep(milliseconds{2}, loop);
+        active -= 1;
+        m.unlock_shared();
+    };
+
+    auto a = reader();
+    auto b = reader();
+    auto c = reader();
+    schedule_all(a, b, c);
+    EXPECT_EQ(peak, 3);
+}
+
+TEST_CASE(shared_mutex_writer_not_starved) {
+    shared_mutex m;
+    std::string order;
+
+    auto reader = [&](char c, int delay) -> task<> {
+        co_await sleep(milliseconds{delay}, loop);
+        co_await m.lock_shared();
+        order += c;
+        co_await sleep(milliseconds{3}, loop);
+        m.unlock_shared();
+    };
+
+    auto writer = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        co_await m.lock();
+        order += 'w';
+        co_await sleep(milliseconds{1}, loop);
+        m.unlock();
+    };
+
+    // r1 holds the lock when w queues; r2 arrives after w and must wait.
+    auto r1 = reader('a', 0);
+    auto w = writer();
+    auto r2 = reader('b', 2);
+    schedule_all(r1, w, r2);
+    EXPECT_EQ(order, "awb");
+}
+
 TEST_CASE(event_set_wait) {
     event ev;
     int fired = 0;
@@ -239,6 +330,105 @@ TEST_CASE(semaphore_acquire_release) {
     EXPECT_EQ(step, 2);
 }
 
+TEST_CASE(semaphore_weighted_fifo) {
+    semaphore sem(2);
+    std::vector<int> order;
+
+    auto large = [&]() -> task<> {
+        co_await sem.acquire(3);
+        order.push_back(3);
+        sem.release(3);
+    };
+
+    auto small = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        // Two permits are free, but the larger acquisition came first.
+        EXPECT_FALSE(sem.try_acquire(1));
+        co_await sem.acquire(1);
+        order.push_back(1);
+        sem.release(1);
+    };
+
+    auto releaser = [&]() -> task<> {
+        co_await sleep(milliseconds{3}, loop);
+        sem.release(1);
+    };
+
+    auto t1 = large();
+    auto t2 = small();
+    auto t3 = releaser();
+    schedule_all(t1, t2, t3);
+
+    EXPECT_EQ(order, (std::vector<int>{3, 1}));
+    EXPECT_EQ(sem.available(), 3);
+}
+
+TEST_CASE(semaphore_cancelled_waiter_unblocks) {
+    semaphore sem(1);
+    bool small_acquired = false;
+
+    auto large = [&]() -> task<> {
+        co_await sem.acquire(4);
+    };
+
+    auto small = [&]() -> task<> {
+        co_await sem.acquire(1);
+        small_acquired = true;
+    };
+
+    auto t1 = large();
+    auto t2 = small();
+    auto canceller = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        EXPECT_FALSE(small_acquired);
+        t1->cancel();
+    };
+
+    auto t3 = canceller();
+    schedule_all(t1, t2, t3);
+
+    EXPECT_TRUE(small_acquired);
+    EXPECT_EQ(sem.available(), 0);
+}
+
+TEST_CASE(byte_budget_leases) {
+    byte_budget budget(100);
+    std::vector<int> order;
+
+    auto first = [&]() -> task<> {
+        auto lease = co_await budget.reserve(80);
+        EXPECT_EQ(lease.size(), 80U);
+        EXPECT_FALSE(budget.try_reserve(30).has_value());
+        co_await sleep(milliseconds{2}, loop);
+        order.push_back(1);
+        lease.release(50);
+        co_await sleep(milliseconds{2}, loop);
+    };
+
+    auto second = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        auto lease = co_await budget.reserve(40);
+        order.push_back(2);
+        EXPECT_EQ(budget.available(), 30U);
+    };
+
+    auto oversized = [&]() -> task<> {
+        co_await sleep(milliseconds{1}, loop);
+        // Cut down to the whole budget; it runs once everything came back.
+        auto lease = co_await budget.reserve(1000);
+        EXPECT_EQ(lease.size(), 100U);
+        order.push_back(3);
+    };
+
+    auto t1 = first();
+    auto t2 = second();
+    auto t3 = oversized();
+    schedule_all(t1, t2, t3);
+
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(budget.available(), 100U);
+}
+
 TEST_CASE(condition_variable_wait) {
     mutex m;
     condition_variable cv;
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(task_graph_scheduling, loop_fixture) {
+
+TEST_CASE(freeze_orders_and_ranks) {
+    task_graph graph;
+    auto a = graph.add_node("a", 1);
+    auto b = graph.add_node("b", 5);
+    auto c = graph.add_node("c", 1);
+    auto d = graph.add_node("d", 2);
+    graph.add_edge(b, a);
+    graph.add_edge(c, a);
+    graph.add_edge(d, b);
+    graph.add_edge(d, c);
+    graph.add_edge(d, c);
+
+    EXPECT_EQ(graph.add_node("b"), b);
+    ASSERT_FALSE(static_cast<bool>(graph.freeze()));
+
+    EXPECT_EQ(graph.dependencies(d).size(), 2U);
+    EXPECT_EQ(graph.dependents(a).size(), 2U);
+
+    auto order = graph.topological_order();
+    ASSERT_EQ(order.size(), 4U);
+    EXPECT_EQ(order.front(), a);
+    EXPECT_EQ(order.back(), d);
+
+    EXPECT_EQ(graph.level(a), 0U);
+    EXPECT_EQ(graph.level(b), 1U);
+    EXPECT_EQ(graph.level(d), 2U);
+
+    // a -> b -> d is the costly chain.
+    EXPECT_EQ(graph.critical_path(d), 2U);
+    EXPECT_EQ(graph.critical_path(b), 7U);
+    EXPECT_EQ(graph.critical_path(c), 3U);
+    EXPECT_EQ(graph.critical_path(a), 8U);
+}
+
+TEST_CASE(freeze_rejects_cycles) {
+    task_graph graph;
+    auto a = graph.add_node("a");
+    auto b = graph.add_node("b");
+    graph.add_edge(a, b);
+    graph.add_edge(b, a);
+
+    EXPECT_EQ(graph.freeze(), error::invalid_argument);
+    EXPECT_FALSE(graph.frozen());
+}
+
+TEST_CASE(run_starts_critical_path_first) {
+    task_graph graph;
+    auto root = graph.add_node("root", 1);
+    auto shallow = graph.add_node("shallow", 1);
+    auto deep = graph.add_node("deep", 1);
+    auto deeper = graph.add_node("deeper", 10);
+    graph.add_edge(deeper, deep);
+    graph.add_edge(root, shallow);
+    graph.add_edge(root, deeper);
+    ASSERT_FALSE(static_cast<bool>(graph.freeze()));
+
+    std::vector<task_graph::node_id> started;
+    auto driver = [&]() -> task<bool> {
+        task_graph::node_id targets[] = {root};
+        co_return co_await graph.run(
+            targets,
+            [&](task_graph::node_id id) -> task<bool> {
+                started.push_back(id);
+                co_await sleep(1, loop);
+                co_return true;
+            },
+            1);
+    };
+
+    auto t = driver();
+    schedule_all(t);
+
+    ASSERT_TRUE(t.result());
+    ASSERT_EQ(started.size(), 4U);
+    EXPECT_EQ(started[0], deep);
+    EXPECT_EQ(started[1], deeper);
+    EXPECT_EQ(started[2], shallow);
+    EXPECT_EQ(started[3], root);
+}
+
+TEST_CASE(run_bounds_concurrency_and_skips_after_failure) {
+    task_graph graph;
+    std::vector<task_graph::node_id> leaves;
+    for(int i = 0; i < 6; ++i) {
+        leaves.push_back(graph.add_node("leaf" + std::to_string(i)));
+    }
+    auto top = graph.add_node("top");
+    for(auto leaf: leaves) {
+        graph.add_edge(top, leaf);
+    }
+    ASSERT_FALSE(static_cast<bool>(graph.freeze()));
+
+    std::size_t running = 0;
+    std::size_t peak = 0;
+    bool top_ran = false;
+    auto driver = [&]() -> task<bool> {
+        task_graph::node_id targets[] = {top};
+        co_return co_await graph.run(
+            targets,
+            [&](task_graph::node_id id) -> task<bool> {
+                if(id == top) {
+                    top_ran = true;
+                    co_return true;
+                }
+                running += 1;
+                peak = (std::max)(peak, running);
+                co_await sleep(2, loop);
+                running -= 1;
+                co_return id != leaves[3];
+            },
+            3);
+    };
+
+    auto t = driver();
+    schedule_all(t);
+
+    EXPECT_FALSE(t.result());
+    EXPECT_EQ(peak, 3U);
+    EXPECT_FALSE(top_ran);
+}
+
+};  // TEST_SUITE(task_graph_scheduling)
+
+}  // namespace
+
+}  // namespace kota
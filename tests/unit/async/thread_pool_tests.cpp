@@ -0,0 +1,104 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "loop_fixture.h"
+#include "kota/zest/zest.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(thread_pool_io, loop_fixture) {
+
+TEST_CASE(submit_returns_value) {
+    thread_pool pool(2);
+
+    auto worker = [&]() -> task<int, error> {
+        auto value = co_await pool.submit([] { return 6 * 7; }, loop).or_fail();
+        co_return value;
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 42);
+}
+
+TEST_CASE(runs_off_loop_thread) {
+    thread_pool pool(1);
+    auto loop_thread = std::this_thread::get_id();
+    std::thread::id job_thread;
+
+    auto worker = [&]() -> task<void, error> {
+        co_await pool.submit([&] { job_thread = std::this_thread::get_id(); }, loop).or_fail();
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    EXPECT_FALSE(t.result().has_error());
+    EXPECT_NE(job_thread, loop_thread);
+}
+
+TEST_CASE(many_jobs_complete) {
+    thread_pool pool(4);
+    std::atomic<int> ran{0};
+    int done = 0;
+
+    auto worker = [&]() -> task<void, error> {
+        co_await pool.submit([&] { ran.fetch_add(1); }, loop).or_fail();
+        done += 1;
+    };
+
+    std::vector<task<void, error>> tasks;
+    for(int i = 0; i < 64; ++i) {
+        tasks.push_back(worker());
+        loop.schedule(tasks.back());
+    }
+    loop.run();
+
+    EXPECT_EQ(ran.load(), 64);
+    EXPECT_EQ(done, 64);
+}
+
+TEST_CASE(cancel_queued_job) {
+    thread_pool pool(1);
+    std::atomic<bool> release{false};
+    std::atomic<bool> second_ran{false};
+    cancellation_source source;
+
+    auto blocker = [&]() -> task<void, error> {
+        co_await pool.submit(
+                         [&] {
+                             while(!release.load()) {
+                                 std::this_thread::yield();
+                             }
+                         },
+                         loop)
+            .or_fail();
+    };
+
+    auto canceller = [&]() -> task<> {
+        co_await after(5, loop);
+        source.cancel();
+        release.store(true);
+    };
+
+    auto blocked = blocker();
+    auto guarded = with_token(pool.submit([&] { second_ran.store(true); }, loop), source.token());
+    auto stop = canceller();
+    schedule_all(blocked, guarded, stop);
+
+    EXPECT_FALSE(blocked.result().has_error());
+    EXPECT_FALSE(guarded.result().has_value());
+    EXPECT_FALSE(second_ran.load());
+}
+
+};  // TEST_SUITE(thread_pool_io)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,110 @@
+#include <string>
+
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+
+namespace kota {
+
+namespace {
+
+task<> step(event_loop& loop) {
+    co_await after(1, loop);
+}
+
+task<> steps(event_loop& loop, int count) {
+    for(int i = 0; i < count; ++i) {
+        co_await step(loop);
+    }
+}
+
+std::size_t occurrences(const std::string& text, const std::string& needle) {
+    std::size_t count = 0;
+    for(auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        count += 1;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST_SUITE(trace) {
+
+#if KOTA_ASYNC_TRACE
+
+TEST_CASE(records_task_lifecycle) {
+    event_loop loop;
+    loop.start_trace();
+
+    auto t = steps(loop, 3);
+    loop.schedule(t);
+    loop.run();
+
+    auto json = loop.trace_json();
+    EXPECT_TRUE(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[{)"));
+    EXPECT_EQ(occurrences(json, R"("cat":"create")"), 1U);
+    EXPECT_GE(occurrences(json, R"("cat":"resume")"), 4U);
+    // The root, three step() children and the after() task each one awaits.
+    EXPECT_EQ(occurrences(json, R"("cat":"finish")"), 7U);
+    EXPECT_NE(json.find("trace_tests.cpp"), std::string::npos);
+    EXPECT_NE(json.find(R"("dropped":0)"), std::string::npos);
+}
+
+TEST_CASE(ring_keeps_newest) {
+    event_loop loop;
+    loop.start_trace(4);
+
+    auto t = steps(loop, 10);
+    loop.schedule(t);
+    loop.run();
+
+    auto json = loop.trace_json();
+    EXPECT_EQ(occurrences(json, R"("ph":)"), 4U);
+    EXPECT_EQ(occurrences(json, R"("cat":"create")"), 0U);
+    EXPECT_EQ(json.find(R"("dropped":0)"), std::string::npos);
+}
+
+TEST_CASE(stop_keeps_events) {
+    event_loop loop;
+    loop.start_trace();
+
+    auto first = steps(loop, 1);
+    loop.schedule(first);
+    loop.run();
+    loop.stop_trace();
+
+    auto second = steps(loop, 1);
+    loop.schedule(second);
+    loop.run();
+
+    EXPECT_EQ(occurrences(loop.trace_json(), R"("cat":"create")"), 1U);
+}
+
+TEST_CASE(named_marks) {
+    event_loop loop;
+    loop.start_trace();
+    loop.trace_mark(static_name<"trace.checkpoint">());
+    loop.trace_mark(static_name<"trace.checkpoint">());
+
+    auto json = loop.trace_json();
+    EXPECT_EQ(occurrences(json, R"({"name":"trace.checkpoint","cat":"mark")"), 2U);
+    EXPECT_NE(json.find("trace_tests.cpp"), std::string::npos);
+}
+
+#else
+
+TEST_CASE(disabled_is_empty) {
+    event_loop loop;
+    loop.start_trace();
+
+    auto t = steps(loop, 2);
+    loop.schedule(t);
+    loop.run();
+
+    EXPECT_EQ(loop.trace_json(), R"({"displayTimeUnit":"ns","traceEvents":[],"otherData":{"dropped":0}})");
+}
+
+#endif  // KOTA_ASYNC_TRACE
+
+};  // TEST_SUITE(trace)
+
+}  // namespace kota
@@ -1,5 +1,7 @@
+#include <array>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "loop_fixture.h"
 #include "kota/zest/zest.h"
@@ -38,6 +40,85 @@ task<void, error> send_connected(udp& sock, std::string_view payload, int& done)
     co_await or_fail(ec);
 }
 
+task<std::vector<std::string>, error> recv_batches(udp& sock, std::size_t count, int& done) {
+    std::array<std::array<char, 64>, 4> storage{};
+    std::array<udp::datagram, 4> slots{};
+    for(std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i].buffer = storage[i];
+    }
+
+    std::vector<std::string> out;
+    while(out.size() < count) {
+        auto filled = co_await sock.recv_batch(slots);
+        if(!filled) {
+            bump_and_stop(done, 2);
+            co_await fail(filled.error());
+        }
+        for(std::size_t i = 0; i < *filled; ++i) {
+            out.emplace_back(slots[i].buffer.data(), slots[i].size);
+        }
+    }
+
+    bump_and_stop(done, 2);
+    co_return out;
+}
+
+task<void, error> send_batch_to(udp& sock, std::string_view host, int port, int& done) {
+    std::string_view payloads[] = {"kotatsu-1", "kotatsu-2", "kotatsu-3"};
+    std::span<const char> datagrams[] = {
+        std::span<const char>(payloads[0].data(), payloads[0].size()),
+        std::span<const char>(payloads[1].data(), payloads[1].size()),
+        std::span<const char>(payloads[2].data(), payloads[2].size()),
+    };
+    auto ec = co_await sock.send_batch(std::span<const std::span<const char>>(datagrams), host, port);
+    bump_and_stop(done, 2);
+    co_await or_fail(ec);
+}
+
+std::string segmented_payload() {
+    // Ten full segments of 100 bytes and a short one.
+    std::string payload(1037, '\0');
+    for(std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    return payload;
+}
+
+task<std::string, error> recv_segments(udp& sock, std::size_t total, int& done) {
+    std::vector<char> storage(64 * 1024);
+    udp::datagram slot{};
+    slot.buffer = storage;
+
+    // GRO may hand back several segments at once; either way each is at
+    // most the sender's segment size.
+    std::string out;
+    while(out.size() < total) {
+        auto ec = co_await sock.recv_segmented(slot);
+        if(ec.has_error()) {
+            bump_and_stop(done, 2);
+            co_await fail(ec.error());
+        }
+        if(slot.segment_size == 0 || slot.segment_size > 100) {
+            bump_and_stop(done, 2);
+            co_await fail(error::invalid_argument);
+        }
+        out.append(slot.buffer.data(), slot.size);
+    }
+
+    bump_and_stop(done, 2);
+    co_return out;
+}
+
+task<void, error>
+    send_segments_to(udp& sock, std::string_view payload, std::string_view host, int port, int& done) {
+    auto ec = co_await sock.send_segmented(std::span<const char>(payload.data(), payload.size()),
+                                           100,
+                                           host,
+                                           port);
+    bump_and_stop(done, 2);
+    co_await or_fail(ec);
+}
+
 }  // namespace
 
 TEST_SUITE(udp_io, loop_fixture) {
@@ -97,6 +178,62 @@ TEST_CASE(connect_and_send) {
     EXPECT_FALSE(send_result.has_error());
 }
 
+TEST_CASE(send_and_recv_batch) {
+    auto recv_sock = udp::create(udp::create_options{false, true}, loop);
+    ASSERT_TRUE(recv_sock.has_value());
+
+    auto bind_ec = recv_sock->bind("127.0.0.1", 0);
+    EXPECT_FALSE(static_cast<bool>(bind_ec));
+
+    auto endpoint = recv_sock->getsockname();
+    ASSERT_TRUE(endpoint.has_value());
+
+    auto send_sock = udp::create(loop);
+    ASSERT_TRUE(send_sock.has_value());
+
+    int done = 0;
+    auto receiver = recv_batches(*recv_sock, 3, done);
+    auto sender = send_batch_to(*send_sock, endpoint->addr, endpoint->port, done);
+    schedule_all(receiver, sender);
+
+    auto recv_result = receiver.result();
+    ASSERT_TRUE(recv_result.has_value());
+    ASSERT_EQ(recv_result->size(), 3U);
+    EXPECT_EQ((*recv_result)[0], "kotatsu-1");
+    EXPECT_EQ((*recv_result)[1], "kotatsu-2");
+    EXPECT_EQ((*recv_result)[2], "kotatsu-3");
+
+    auto send_result = sender.result();
+    EXPECT_FALSE(send_result.has_error());
+}
+
+TEST_CASE(send_and_recv_segmented) {
+    auto recv_sock = udp::create(loop);
+    ASSERT_TRUE(recv_sock.has_value());
+
+    auto bind_ec = recv_sock->bind("127.0.0.1", 0);
+    EXPECT_FALSE(static_cast<bool>(bind_ec));
+
+    auto endpoint = recv_sock->getsockname();
+    ASSERT_TRUE(endpoint.has_value());
+
+    auto send_sock = udp::create(loop);
+    ASSERT_TRUE(send_sock.has_value());
+
+    auto payload = segmented_payload();
+    int done = 0;
+    auto receiver = recv_segments(*recv_sock, payload.size(), done);
+    auto sender = send_segments_to(*send_sock, payload, endpoint->addr, endpoint->port, done);
+    schedule_all(receiver, sender);
+
+    auto recv_result = receiver.result();
+    ASSERT_TRUE(recv_result.has_value());
+    EXPECT_EQ(*recv_result, payload);
+
+    auto send_result = sender.result();
+    EXPECT_FALSE(send_result.has_error());
+}
+
 };  // TEST_SUITE(udp_io)
 
 }  // namespace kota
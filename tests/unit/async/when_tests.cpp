@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "kota/zest/zest.h"
 #include "kota/async/async.h"
@@ -313,6 +315,48 @@ TEST_CASE(range_values) {
     EXPECT_EQ(sum, 7);
 }
 
+TEST_CASE(range_values_move_once) {
+    // Counts how often a value has been moved on its way to where it is.
+    struct hops {
+        int count = 0;
+
+        hops() = default;
+
+        hops(hops&& other) noexcept : count(other.count + 1) {}
+
+        hops& operator=(hops&&) = delete;
+    };
+
+    auto make = []() -> task<hops> {
+        co_return hops{};
+    };
+
+    // How many moves it takes to land the value in the promise.
+    auto probe = make();
+    {
+        event_loop loop;
+        loop.schedule(probe);
+        loop.run();
+    }
+    auto stored = probe.take_value().count;
+
+    small_vector<task<hops>> tasks;
+    for(int i = 0; i < 4; ++i) {
+        tasks.emplace_back(make());
+    }
+
+    auto combined = [&]() -> task<bool> {
+        auto values = co_await when_all(std::move(tasks));
+        EXPECT_EQ(values.size(), 4U);
+        co_return std::ranges::all_of(values, [&](const hops& value) {
+            return value.count == stored + 1;
+        });
+    };
+
+    auto [moved_once] = run(combined());
+    EXPECT_TRUE(moved_once);
+}
+
 TEST_CASE(range_empty) {
     small_vector<task<int>> tasks;
 
@@ -364,6 +408,38 @@ TEST_CASE(range_sync_awaiters) {
     EXPECT_EQ(task.result(), 2U);
 }
 
+TEST_CASE(ready_children_resume_inline) {
+    std::vector<int> order;
+
+    auto fast = [&]() -> task<> {
+        auto [a, b, c] = co_await when_all(ready_int(1), ready_int(2), ready_int(3));
+        order.push_back(a + b + c);
+    };
+
+    auto fast_range = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        for(int i = 0; i < 64; ++i) {
+            tasks.emplace_back(ready_int(1));
+        }
+        auto values = co_await when_all(std::move(tasks));
+        order.push_back(static_cast<int>(values.size()));
+    };
+
+    auto sibling = [&]() -> task<> {
+        order.push_back(0);
+        co_return;
+    };
+
+    // Both aggregates settle during their first resume, so they finish
+    // before the sibling queued after them gets a turn.
+    auto a = fast();
+    auto b = fast_range();
+    auto c = sibling();
+    run(a, b, c);
+
+    EXPECT_EQ(order, std::vector<int>({6, 64, 0}));
+}
+
 };  // TEST_SUITE(when_all)
 
 // ============================================================================
@@ -1904,4 +1980,328 @@ TEST_CASE(when_all_in_scope) {
 
 };  // TEST_SUITE(async_scope)
 
+// ============================================================================
+// TEST_SUITE: bounded_scope
+// ============================================================================
+
+TEST_SUITE(bounded_scope) {
+
+TEST_CASE(runs_all) {
+    int count = 0;
+
+    auto work = [&](int val) -> task<> {
+        co_await sleep(1);
+        count += val;
+    };
+
+    auto driver = [&]() -> task<> {
+        bounded_scope scope(2);
+        for(int i = 0; i < 10; ++i) {
+            scope.spawn([&] { return work(1); });
+        }
+        EXPECT_EQ(scope.queued(), 10U);
+        co_await scope;
+        EXPECT_EQ(scope.queued(), 0U);
+    };
+
+    run(driver());
+    EXPECT_EQ(count, 10);
+}
+
+TEST_CASE(empty) {
+    auto driver = []() -> task<> {
+        bounded_scope scope(4);
+        co_await scope;
+    };
+
+    run(driver());
+}
+
+TEST_CASE(respects_limit) {
+    int inflight = 0;
+    int peak = 0;
+    int started = 0;
+
+    auto work = [&]() -> task<> {
+        inflight += 1;
+        peak = (std::max)(peak, inflight);
+        co_await sleep(1);
+        inflight -= 1;
+    };
+
+    auto driver = [&]() -> task<> {
+        bounded_scope scope(3);
+        for(int i = 0; i < 20; ++i) {
+            scope.spawn([&] {
+                started += 1;
+                return work();
+            });
+        }
+        EXPECT_EQ(started, 0);
+        co_await scope;
+    };
+
+    run(driver());
+    EXPECT_EQ(started, 20);
+    EXPECT_EQ(peak, 3);
+}
+
+TEST_CASE(child_spawns_more) {
+    int count = 0;
+
+    auto driver = [&]() -> task<> {
+        bounded_scope scope(2);
+        auto leaf = [&]() -> task<> {
+            count += 1;
+            co_return;
+        };
+        auto parent = [&]() -> task<> {
+            co_await sleep(1);
+            scope.spawn(leaf);
+            scope.spawn(leaf);
+            count += 1;
+        };
+        scope.spawn(parent);
+        scope.spawn(parent);
+        co_await scope;
+    };
+
+    run(driver());
+    EXPECT_EQ(count, 6);
+}
+
+TEST_CASE(error_skips_queued) {
+    int started = 0;
+
+    auto failing = [&]() -> task<int, error> {
+        co_await sleep(1);
+        co_await fail(error::connection_refused);
+    };
+
+    auto slow = [&]() -> task<> {
+        co_await sleep(50);
+    };
+
+    auto driver = [&]() -> task<> {
+        bounded_scope<error> scope(2);
+        scope.spawn(failing);
+        for(int i = 0; i < 5; ++i) {
+            scope.spawn([&] {
+                started += 1;
+                return slow();
+            });
+        }
+        auto res = co_await scope;
+        EXPECT_TRUE(res.has_error());
+        EXPECT_EQ(res.error(), error::connection_refused);
+    };
+
+    auto t = driver();
+    run(t);
+
+    EXPECT_TRUE(t->is_finished());
+    EXPECT_EQ(started, 1);
+}
+
+TEST_CASE(mixed_error_types) {
+    auto failing = []() -> task<int, custom_error> {
+        co_await sleep(1);
+        co_await fail(custom_error{7});
+    };
+
+    auto fine = []() -> task<int, error> {
+        co_return 1;
+    };
+
+    auto driver = [&]() -> task<> {
+        bounded_scope<error, custom_error> scope(1);
+        scope.spawn(fine);
+        scope.spawn(failing);
+        auto res = co_await scope;
+        EXPECT_TRUE(res.has_error());
+        EXPECT_EQ(std::get<custom_error>(res.error()), custom_error{7});
+    };
+
+    run(driver());
+}
+
+};  // TEST_SUITE(bounded_scope)
+
+// ============================================================================
+// TEST_SUITE: as_completed
+// ============================================================================
+
+TEST_SUITE(as_completed) {
+
+TEST_CASE(completion_order) {
+    std::vector<std::size_t> order;
+    std::vector<int> values;
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        tasks.emplace_back(delayed_int(30, 1));
+        tasks.emplace_back(delayed_int(1, 2));
+        tasks.emplace_back(delayed_int(15, 3));
+
+        as_completed stream(std::move(tasks));
+        EXPECT_EQ(stream.size(), 3U);
+        while(auto item = co_await stream.next()) {
+            order.push_back(item->first);
+            values.push_back(item->second);
+        }
+    };
+
+    run(driver());
+    EXPECT_EQ(order, (std::vector<std::size_t>{1, 2, 0}));
+    EXPECT_EQ(values, (std::vector<int>{2, 3, 1}));
+}
+
+TEST_CASE(empty) {
+    int items = 0;
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        as_completed stream(std::move(tasks));
+        while(co_await stream.next()) {
+            items += 1;
+        }
+    };
+
+    run(driver());
+    EXPECT_EQ(items, 0);
+}
+
+TEST_CASE(ready_children) {
+    int sum = 0;
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        for(int i = 1; i <= 4; ++i) {
+            tasks.emplace_back(ready_int(i));
+        }
+        as_completed stream(std::move(tasks));
+        while(auto item = co_await stream.next()) {
+            sum += item->second;
+        }
+    };
+
+    run(driver());
+    EXPECT_EQ(sum, 10);
+}
+
+TEST_CASE(early_results_before_slowest) {
+    int consumed_before_slow = 0;
+    bool slow_done = false;
+
+    auto slow = [&]() -> task<int> {
+        co_await sleep(50);
+        slow_done = true;
+        co_return 0;
+    };
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        tasks.emplace_back(slow());
+        tasks.emplace_back(delayed_int(1, 1));
+        tasks.emplace_back(delayed_int(2, 2));
+
+        as_completed stream(std::move(tasks));
+        while(auto item = co_await stream.next()) {
+            if(!slow_done) {
+                consumed_before_slow += 1;
+            }
+        }
+    };
+
+    run(driver());
+    EXPECT_EQ(consumed_before_slow, 2);
+}
+
+TEST_CASE(errors_do_not_cancel_siblings) {
+    int errors = 0;
+    int values = 0;
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int, error>> tasks;
+        tasks.emplace_back(delayed_return_error(1, error::connection_refused));
+        tasks.emplace_back(delayed_return_value(5, 7));
+
+        as_completed stream(std::move(tasks));
+        while(auto item = co_await stream.next()) {
+            auto& [index, result] = *item;
+            if(result.has_error()) {
+                EXPECT_EQ(index, 0U);
+                EXPECT_EQ(result.error(), error::connection_refused);
+                errors += 1;
+            } else {
+                EXPECT_EQ(index, 1U);
+                EXPECT_EQ(*result, 7);
+                values += 1;
+            }
+        }
+    };
+
+    run(driver());
+    EXPECT_EQ(errors, 1);
+    EXPECT_EQ(values, 1);
+}
+
+TEST_CASE(break_cancels_rest) {
+    int slow_done = 0;
+
+    auto slow = [&]() -> task<int> {
+        co_await sleep(50);
+        slow_done += 1;
+        co_return 0;
+    };
+
+    auto driver = [&]() -> task<int> {
+        small_vector<task<int>> tasks;
+        tasks.emplace_back(slow());
+        tasks.emplace_back(delayed_int(1, 42));
+        tasks.emplace_back(slow());
+
+        as_completed stream(std::move(tasks));
+        auto item = co_await stream.next();
+        co_return item->second;
+    };
+
+    auto [res] = run(driver());
+    EXPECT_EQ(res, 42);
+    EXPECT_EQ(slow_done, 0);
+}
+
+TEST_CASE(child_cancel_propagates) {
+    int slow_done = 0;
+
+    auto canceler = [&]() -> task<int> {
+        co_await sleep(1);
+        co_await cancel();
+        co_return 0;
+    };
+
+    auto slow = [&]() -> task<int> {
+        co_await sleep(20);
+        slow_done += 1;
+        co_return 0;
+    };
+
+    auto driver = [&]() -> task<> {
+        small_vector<task<int>> tasks;
+        tasks.emplace_back(slow());
+        tasks.emplace_back(canceler());
+
+        as_completed stream(std::move(tasks));
+        while(co_await stream.next()) {}
+    };
+
+    auto t = driver();
+    run(t);
+
+    EXPECT_TRUE(t->is_cancelled());
+    EXPECT_EQ(slow_done, 0);
+}
+
+};  // TEST_SUITE(as_completed)
+
 }  // namespace kota
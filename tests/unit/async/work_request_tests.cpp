@@ -1,4 +1,6 @@
+#include <array>
 #include <atomic>
+#include <numeric>
 
 #include "loop_fixture.h"
 #include "kota/zest/zest.h"
@@ -52,6 +54,40 @@ TEST_CASE(queue_runs_twice) {
     EXPECT_EQ(flag.load(), 2);
 }
 
+TEST_CASE(queue_returns_value) {
+    auto worker = [&]() -> task<int, error> {
+        auto value = co_await queue([] { return 6 * 7; }, loop).or_fail();
+        co_return value;
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 42);
+}
+
+TEST_CASE(queue_large_callable) {
+    std::array<int, 32> values{};
+    std::iota(values.begin(), values.end(), 1);
+
+    auto worker = [&]() -> task<int, error> {
+        auto sum = co_await queue(
+                       [values] { return std::accumulate(values.begin(), values.end(), 0); },
+                       loop)
+                       .or_fail();
+        co_return sum;
+    };
+
+    auto t = worker();
+    schedule_all(t);
+
+    auto result = t.result();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 528);
+}
+
 };  // TEST_SUITE(work_request_io)
 
 }  // namespace kota
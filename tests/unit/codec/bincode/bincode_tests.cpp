@@ -1,9 +1,26 @@
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
 #include <vector>
 
 #include "kota/zest/zest.h"
+#include "kota/support/flat_hash_map.h"
+#include "kota/support/interned_string.h"
+#include "kota/support/small_string.h"
+#include "kota/support/small_vector.h"
+#include "kota/meta/diff.h"
 #include "kota/codec/bincode.h"
+#include "kota/codec/patch.h"
 
 namespace kota::codec {
 
@@ -58,8 +75,67 @@ struct WithFlattenField {
     int third{};
 };
 
+struct BorrowedMessage {
+    std::string_view name;
+    std::span<const std::byte> payload;
+    int id{};
+};
+
+enum class Severity : std::uint8_t { error = 1, warning = 2 };
+
+struct Diagnostic {
+    std::int32_t line{};
+    std::int64_t delta{};
+    Severity severity{};
+    std::string message;
+    std::vector<std::int32_t> tokens;
+    std::variant<std::monostate, std::uint64_t> code;
+};
+
+enum class WatchKind : std::uint8_t { create = 1, change = 2, remove = 4 };
+
+struct Watcher {
+    std::string glob;
+    enum_flags<WatchKind> kind{};
+};
+
+struct Outline {
+    small_string<16> name;
+    small_vector<PlainPair, 4> children;
+    std::vector<std::string> tags;
+};
+
+struct Snapshot {
+    std::string uri;
+    std::vector<std::uint32_t> tokens;
+};
+
 TEST_SUITE(serde_bincode) {
 
+TEST_CASE(patch_round_trip) {
+    const Snapshot old{.uri = "a.cpp", .tokens = {1, 2, 3, 4}};
+    const Snapshot updated{.uri = "b.cpp", .tokens = {1, 7, 4}};
+    auto encoded = bincode::to_bytes(meta::diff(old, updated));
+    ASSERT_TRUE(encoded.has_value());
+
+    Snapshot patched = old;
+    patch_target target(patched);
+    ASSERT_TRUE(bincode::from_bytes(*encoded, target).has_value());
+    EXPECT_EQ(patched.uri, "b.cpp");
+    EXPECT_EQ(patched.tokens, updated.tokens);
+}
+
+TEST_CASE(enum_flags_round_trip_as_names) {
+    const Watcher input{.glob = "*.h", .kind = static_cast<WatchKind>(1 | 4)};
+    auto encoded = bincode::to_bytes(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    auto decoded = bincode::from_bytes<Watcher>(*encoded);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->glob, "*.h");
+    EXPECT_EQ(decoded->kind, input.kind);
+}
+
 TEST_CASE(invalid_optional_tag_poison_deserializer) {
     const std::vector<std::uint8_t> bytes{2U, 1U};
     bincode::Deserializer<> deserializer(bytes);
@@ -116,6 +192,281 @@ TEST_CASE(struct_deserialize_respects_flatten) {
     EXPECT_EQ(decoded.third, 40);
 }
 
+TEST_CASE(serialized_size_matches_output) {
+    static_assert(bincode::fixed_serialized_size<PlainPair>() == 16);
+    static_assert(bincode::fixed_serialized_size<std::tuple<bool, char, double>>() == 10);
+    static_assert(!bincode::fixed_serialized_size<std::string>().has_value());
+    static_assert(!bincode::fixed_serialized_size<WithSkippedField>().has_value());
+
+    auto pair_size = bincode::serialized_size(PlainPair{.first = 1, .second = 2});
+    ASSERT_TRUE(pair_size.has_value());
+    EXPECT_EQ(*pair_size, 16U);
+
+    std::vector<std::variant<std::string, std::optional<PlainTriple>>> values{
+        std::string("hello"),
+        std::optional<PlainTriple>{},
+        std::optional<PlainTriple>(PlainTriple{.first = 1, .second = 2, .third = 3}),
+    };
+    auto size = bincode::serialized_size(values);
+    auto bytes = bincode::to_bytes(values);
+    ASSERT_TRUE(size.has_value());
+    ASSERT_TRUE(bytes.has_value());
+    EXPECT_EQ(*size, bytes->size());
+    EXPECT_EQ(bytes->capacity(), bytes->size());
+}
+
+TEST_CASE(scalar_sequences_as_blocks) {
+    // Lists take the element-by-element path, so they give the bytes to match.
+    auto same_bytes = [](const auto& block, const auto& list) {
+        auto packed = bincode::to_bytes(block);
+        auto generic = bincode::to_bytes(list);
+        return packed.has_value() && generic.has_value() && *packed == *generic;
+    };
+    EXPECT_TRUE(same_bytes(std::vector<std::int32_t>{1, -2, 3}, std::list<std::int32_t>{1, -2, 3}));
+    EXPECT_TRUE(same_bytes(std::vector<std::int64_t>{-1, 1LL << 40},
+                           std::list<std::int64_t>{-1, 1LL << 40}));
+    EXPECT_TRUE(same_bytes(std::vector<float>{1.5F, -0.25F}, std::list<float>{1.5F, -0.25F}));
+    EXPECT_TRUE(same_bytes(std::vector<char>{'a', 'b'}, std::list<char>{'a', 'b'}));
+    EXPECT_TRUE(same_bytes(std::array<double, 2>{0.5, 2.0}, std::tuple<double, double>{0.5, 2.0}));
+
+    std::vector<std::uint32_t> tokens(1000);
+    for(std::size_t i = 0; i < tokens.size(); ++i) {
+        tokens[i] = static_cast<std::uint32_t>(i * 7);
+    }
+    auto bytes = bincode::to_bytes(tokens);
+    ASSERT_TRUE(bytes.has_value());
+    std::vector<std::uint32_t> decoded_tokens;
+    ASSERT_TRUE(bincode::from_bytes(*bytes, decoded_tokens).has_value());
+    EXPECT_EQ(decoded_tokens, tokens);
+
+    std::array<double, 3> doubles{1.0, -2.5, 1e300};
+    auto array_bytes = bincode::to_bytes(doubles);
+    ASSERT_TRUE(array_bytes.has_value());
+    std::array<double, 3> decoded_doubles{};
+    ASSERT_TRUE(bincode::from_bytes(*array_bytes, decoded_doubles).has_value());
+    EXPECT_EQ(decoded_doubles, doubles);
+
+    auto wide = bincode::to_bytes(std::vector<std::int64_t>{1, 300});
+    ASSERT_TRUE(wide.has_value());
+    std::vector<std::int8_t> narrow;
+    auto narrowed = bincode::from_bytes(*wide, narrow);
+    ASSERT_FALSE(narrowed.has_value());
+    EXPECT_EQ(narrowed.error(), bincode::error_kind::number_out_of_range);
+
+    auto chars = bincode::to_bytes(std::array<char, 2>{1, 2});
+    ASSERT_TRUE(chars.has_value());
+    std::array<bool, 2> flags{};
+    auto not_bool = bincode::from_bytes(*chars, flags);
+    ASSERT_FALSE(not_bool.has_value());
+    EXPECT_EQ(not_bool.error(), bincode::error_kind::type_mismatch);
+
+    auto truncated = std::span<const std::byte>(*bytes).first(bytes->size() - 1);
+    EXPECT_FALSE(bincode::from_bytes(truncated, decoded_tokens).has_value());
+}
+
+TEST_CASE(views_borrow_from_input) {
+    const std::array<std::byte, 3> payload{std::byte{1}, std::byte{2}, std::byte{3}};
+    BorrowedMessage message{.name = "hover", .payload = payload, .id = 9};
+    auto bytes = bincode::to_bytes(message);
+    ASSERT_TRUE(bytes.has_value());
+
+    BorrowedMessage decoded{};
+    ASSERT_TRUE(bincode::from_bytes(std::span<const std::byte>(*bytes), decoded).has_value());
+    EXPECT_EQ(decoded.name, "hover");
+    EXPECT_EQ(decoded.payload.size(), 3U);
+    EXPECT_TRUE(std::ranges::equal(decoded.payload, payload));
+    EXPECT_EQ(decoded.id, 9);
+
+    auto inside = [&](const void* pointer) {
+        const auto* at = static_cast<const std::byte*>(pointer);
+        return at >= bytes->data() && at < bytes->data() + bytes->size();
+    };
+    EXPECT_TRUE(inside(decoded.name.data()));
+    EXPECT_TRUE(inside(decoded.payload.data()));
+}
+
+TEST_CASE(varint_integers) {
+    using bincode::varint_config;
+
+    auto small = bincode::to_bytes<varint_config>(std::vector<std::int64_t>{300, -1, 0});
+    ASSERT_TRUE(small.has_value());
+    const std::vector<std::byte> expected{std::byte{3},
+                                          std::byte{0xD8},
+                                          std::byte{0x04},
+                                          std::byte{0x01},
+                                          std::byte{0x00}};
+    EXPECT_EQ(*small, expected);
+
+    Diagnostic value{
+        .line = 120,
+        .delta = -5,
+        .severity = Severity::warning,
+        .message = "unused",
+        .tokens = {0, 4, -1, 1 << 20},
+        .code = std::uint64_t(1) << 63,
+    };
+    auto compact = bincode::to_bytes<varint_config>(value);
+    auto fixed = bincode::to_bytes(value);
+    ASSERT_TRUE(compact.has_value());
+    ASSERT_TRUE(fixed.has_value());
+    EXPECT_TRUE(compact->size() * 2 < fixed->size());
+
+    auto size = bincode::serialized_size<varint_config>(value);
+    ASSERT_TRUE(size.has_value());
+    EXPECT_EQ(*size, compact->size());
+    static_assert(!bincode::fixed_serialized_size<PlainPair, varint_config>().has_value());
+
+    Diagnostic decoded{};
+    ASSERT_TRUE(bincode::from_bytes<varint_config>(*compact, decoded).has_value());
+    EXPECT_EQ(decoded.line, 120);
+    EXPECT_EQ(decoded.delta, -5);
+    EXPECT_EQ(decoded.severity, Severity::warning);
+    EXPECT_EQ(decoded.message, "unused");
+    EXPECT_EQ(decoded.tokens, value.tokens);
+    EXPECT_EQ(std::get<1>(decoded.code), std::uint64_t(1) << 63);
+
+    // Eleven bytes with the continuation bit all set is too long.
+    std::vector<std::byte> overlong(11, std::byte{0xFF});
+    std::uint64_t overflowed = 0;
+    EXPECT_FALSE(bincode::from_bytes<varint_config>(overlong, overflowed).has_value());
+
+    bincode::Serializer<varint_config> nested_writer;
+    ASSERT_TRUE(nested_writer.serialize_nested(std::string(200, 'x')).has_value());
+    auto nested = nested_writer.bytes();
+    bincode::Deserializer<varint_config> nested_reader(nested);
+    auto nested_length = nested_reader.read_length_prefix();
+    ASSERT_TRUE(nested_length.has_value());
+    EXPECT_EQ(*nested_length, 202U);
+    std::string text;
+    ASSERT_TRUE(nested_reader.deserialize_str(text).has_value());
+    EXPECT_EQ(text, std::string(200, 'x'));
+    EXPECT_TRUE(nested_reader.finish().has_value());
+}
+
+TEST_CASE(serialize_into_appends) {
+    PlainPair value{.first = 1, .second = 2};
+    auto whole = bincode::to_bytes(value);
+    ASSERT_TRUE(whole.has_value());
+
+    std::vector<std::byte> out(3, std::byte{0xFF});
+    ASSERT_TRUE(bincode::to_bytes_into(out, value).has_value());
+    ASSERT_EQ(out.size(), 3 + whole->size());
+    EXPECT_TRUE(std::equal(whole->begin(), whole->end(), out.begin() + 3));
+
+    PlainPair decoded{};
+    auto tail = std::span<const std::byte>(out).subspan(3);
+    ASSERT_TRUE(bincode::from_bytes(tail, decoded).has_value());
+    EXPECT_EQ(decoded.first, 1);
+    EXPECT_EQ(decoded.second, 2);
+}
+
+TEST_CASE(unsized_sequences_patch_length) {
+    const std::vector<std::string> values{"a", std::string(200, 'b')};
+    auto write = [&]<typename Config>(bincode::Serializer<Config>& serializer) {
+        auto seq = serializer.serialize_seq(std::nullopt);
+        ASSERT_TRUE(seq.has_value());
+        for(const auto& value: values) {
+            ASSERT_TRUE(seq->serialize_element(value).has_value());
+        }
+        ASSERT_TRUE(seq->end().has_value());
+    };
+
+    bincode::Serializer<> fixed;
+    write(fixed);
+    auto sized = bincode::to_bytes(values);
+    ASSERT_TRUE(sized.has_value());
+    EXPECT_TRUE(std::ranges::equal(fixed.bytes(), *sized));
+
+    bincode::Serializer<bincode::varint_config> compact;
+    write(compact);
+    auto compact_sized = bincode::to_bytes<bincode::varint_config>(values);
+    ASSERT_TRUE(compact_sized.has_value());
+    EXPECT_TRUE(std::ranges::equal(compact.bytes(), *compact_sized));
+}
+
+TEST_CASE(small_containers) {
+    const Outline input{
+        .name = std::string_view("outline"),
+        .children = {{.first = 1, .second = 2}, {.first = 3, .second = 4}},
+        .tags = {"a", "b", "c"},
+    };
+    auto encoded = bincode::to_bytes(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    // A small_string is written as a string, the same bytes as std::string.
+    auto plain = bincode::to_bytes(std::string("outline"));
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_TRUE(std::equal(plain->begin(), plain->end(), encoded->begin()));
+
+    Outline decoded{};
+    ASSERT_TRUE(bincode::from_bytes(*encoded, decoded).has_value());
+    EXPECT_EQ(std::string_view(decoded.name), "outline");
+    ASSERT_EQ(decoded.children.size(), 2U);
+    EXPECT_EQ(decoded.children[1].second, 4);
+    EXPECT_EQ(decoded.tags, input.tags);
+    // The length prefix is known, so the vector is sized once.
+    EXPECT_EQ(decoded.tags.capacity(), 3U);
+}
+
+TEST_CASE(pmr_containers) {
+    const std::vector<std::string> input{"a string too long to fit inline", "b"};
+    auto encoded = bincode::to_bytes(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::vector<std::pmr::string> decoded(&arena);
+    ASSERT_TRUE(bincode::from_bytes(*encoded, decoded).has_value());
+    ASSERT_EQ(decoded.size(), 2U);
+    EXPECT_EQ(decoded[0], input[0]);
+    EXPECT_TRUE(decoded[0].get_allocator().resource() == &arena);
+
+    auto reencoded = bincode::to_bytes(decoded);
+    ASSERT_TRUE(reencoded.has_value());
+    EXPECT_TRUE(std::ranges::equal(*reencoded, *encoded));
+}
+
+TEST_CASE(interned_strings) {
+    const std::vector<std::string> input{"clang-tidy", "clang-tidy", "clangd"};
+    auto encoded = bincode::to_bytes(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    std::vector<interned_string> decoded;
+    ASSERT_TRUE(bincode::from_bytes(*encoded, decoded).has_value());
+    ASSERT_EQ(decoded.size(), 3U);
+    EXPECT_TRUE(decoded[0].data() == decoded[1].data());
+    EXPECT_EQ(decoded[2], "clangd");
+
+    auto reencoded = bincode::to_bytes(decoded);
+    ASSERT_TRUE(reencoded.has_value());
+    EXPECT_TRUE(std::ranges::equal(*reencoded, *encoded));
+}
+
+TEST_CASE(flat_hash_tables) {
+    const std::map<std::string, int> input{{"didOpen", 1}, {"didChange", 2}, {"hover", 3}};
+    auto encoded = bincode::to_bytes(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    flat_hash_map<std::string, int> decoded;
+    ASSERT_TRUE(bincode::from_bytes(*encoded, decoded).has_value());
+    ASSERT_EQ(decoded.size(), 3U);
+    EXPECT_EQ(decoded.at(std::string_view("didChange")), 2);
+    EXPECT_GE(decoded.capacity(), 3U);
+
+    auto reencoded = bincode::to_bytes(decoded);
+    ASSERT_TRUE(reencoded.has_value());
+    std::map<std::string, int> round_trip;
+    ASSERT_TRUE(bincode::from_bytes(*reencoded, round_trip).has_value());
+    EXPECT_EQ(round_trip, input);
+
+    const std::vector<std::string> names{"a", "b", "a"};
+    auto encoded_names = bincode::to_bytes(names);
+    ASSERT_TRUE(encoded_names.has_value());
+    flat_hash_set<std::string> unique_names;
+    ASSERT_TRUE(bincode::from_bytes(*encoded_names, unique_names).has_value());
+    EXPECT_EQ(unique_names.size(), 2U);
+    EXPECT_TRUE(unique_names.contains("b"));
+}
+
 };  // TEST_SUITE(serde_bincode)
 
 }  // namespace
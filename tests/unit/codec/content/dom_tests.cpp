@@ -120,6 +120,27 @@ TEST_CASE(deserializer_keeps_temporary_root_value_alive) {
     EXPECT_EQ(payload, (dom_payload{.id = 7, .name = "alice"}));
 }
 
+TEST_CASE(object_iterator_outlives_its_ref) {
+    auto node = json::Value::parse(R"({"a":1,"b":2})");
+    ASSERT_TRUE(node.has_value());
+
+    auto it = node->as_ref().get_object()->begin();
+    ASSERT_EQ((*it).key, std::string_view("a"));
+    ++it;
+    EXPECT_EQ((*it).value.as_int(), 2);
+}
+
+TEST_CASE(deserializer_reads_entries_in_any_order) {
+    auto dom = json::Value::parse(R"({"skip":[1,{"x":2}],"name":"bob","id":3,"more":{}})");
+    ASSERT_TRUE(dom.has_value());
+
+    dom_payload payload{};
+    json::yy::Deserializer deserializer(*dom);
+    ASSERT_TRUE(codec::deserialize(deserializer, payload).has_value());
+    ASSERT_TRUE(deserializer.finish().has_value());
+    EXPECT_EQ(payload, (dom_payload{.id = 3, .name = "bob"}));
+}
+
 };  // TEST_SUITE(serde_json_dom)
 
 }  // namespace
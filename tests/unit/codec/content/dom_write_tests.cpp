@@ -1,7 +1,10 @@
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 #include "kota/zest/zest.h"
 #include "kota/codec/json/json.h"
@@ -106,6 +109,42 @@ TEST_CASE(value_parse_with_yyjson_flags) {
     EXPECT_EQ(value->as_object()["a"].as_int(), 1);
 }
 
+TEST_CASE(value_parse_in_place) {
+    std::string buffer = R"({"name":"a\nb","n":2})";
+    const auto length = buffer.size();
+    buffer.resize(length + YYJSON_PADDING_SIZE);
+
+    auto value = Value::parse_in_place(buffer, length);
+    ASSERT_TRUE(value.has_value());
+    auto name = value->as_object()["name"].as_string();
+    EXPECT_EQ(name, std::string_view("a\nb"));
+    EXPECT_TRUE(name.data() >= buffer.data() && name.data() < buffer.data() + buffer.size());
+    EXPECT_EQ(value->as_object()["n"].as_int(), 2);
+
+    std::string unpadded = "[1]";
+    auto rejected = Value::parse_in_place(unpadded, unpadded.size());
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error(), YYJSON_READ_ERROR_INVALID_PARAMETER);
+}
+
+TEST_CASE(value_parse_with_arena) {
+    Arena arena(256);
+    Value::parse_options options{};
+    options.allocator = arena.allocator();
+
+    for(int round = 0; round < 3; ++round) {
+        {
+            auto value = Value::parse(R"({"items":[1,2,3,4,5,6,7,8],"label":"arena"})", options);
+            ASSERT_TRUE(value.has_value());
+            EXPECT_EQ(value->as_object()["items"].as_array()[7].as_int(), 8);
+            EXPECT_EQ(value->as_object()["label"].as_string(), std::string_view("arena"));
+            EXPECT_TRUE(arena.used() > 0);
+        }
+        arena.reset();
+        EXPECT_EQ(arena.used(), 0U);
+    }
+}
+
 TEST_CASE(value_set_scalars) {
     auto value = must_parse_mutable_value("0");
 
@@ -236,6 +275,30 @@ TEST_CASE(cow_shared_mutable_doc_on_write) {
     EXPECT_EQ(copy.use_count(), 2);
 }
 
+TEST_CASE(shared_doc_copies_across_threads) {
+    auto value = must_parse_immutable_value(R"({"items":[1,2,3]})");
+
+    std::vector<std::thread> workers;
+    std::atomic<int> matched = 0;
+    for(int i = 0; i < 4; ++i) {
+        workers.emplace_back([value, &matched] {
+            for(int round = 0; round < 1000; ++round) {
+                auto copy = value;
+                auto items = copy.as_object()["items"].as_array();
+                if(items.size() == 3 && items[2].as_int() == 3) {
+                    matched.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for(auto& worker: workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(matched.load(), 4000);
+    EXPECT_EQ(value.use_count(), 1);
+}
+
 TEST_CASE(doc_accessors_follow_owner_document_state) {
     auto immutable_value = must_parse_immutable_value(R"({"n":1})");
     auto immutable_array = must_parse_immutable_value("[1,2]").as_array();
@@ -0,0 +1,142 @@
+#include <string>
+#include <string_view>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/json/json.h"
+
+namespace kota::codec::json {
+
+namespace {
+
+auto parse_value(std::string_view json) -> Value {
+    auto value = Value::parse(json);
+    return value.has_value() ? *value : Value{};
+}
+
+TEST_SUITE(serde_json_yyjson_overlay) {
+
+TEST_CASE(unedited_overlay_writes_base) {
+    auto base = parse_value(R"({"a":1,"b":[true,null]})");
+    Overlay overlay(base);
+    EXPECT_TRUE(overlay.empty());
+
+    auto text = overlay.to_json_string();
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text, std::string(R"({"a":1,"b":[true,null]})"));
+}
+
+TEST_CASE(edits_merge_without_touching_base) {
+    auto base = parse_value(R"({"name":"x","items":[1,2,3],"meta":{"k":"v","drop":0}})");
+    Overlay overlay(base);
+
+    EXPECT_TRUE(overlay.set("/name", parse_value(R"("y")")).has_value());
+    EXPECT_TRUE(overlay.set("/items/1", parse_value("20")).has_value());
+    EXPECT_TRUE(overlay.remove("/items/2").has_value());
+    EXPECT_TRUE(overlay.remove("/meta/drop").has_value());
+    EXPECT_TRUE(overlay.set("/meta/a~1b", parse_value("[]")).has_value());
+    EXPECT_TRUE(overlay.set("/added", parse_value(R"({"n":1})")).has_value());
+    EXPECT_FALSE(overlay.empty());
+
+    auto text = overlay.to_json_string();
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text,
+              std::string(R"({"name":"y","items":[1,20],"meta":{"k":"v","a/b":[]},)"
+                          R"("added":{"n":1}})"));
+
+    auto original = base.to_json_string();
+    ASSERT_TRUE(original.has_value());
+    EXPECT_EQ(*original, std::string(R"({"name":"x","items":[1,2,3],"meta":{"k":"v","drop":0}})"));
+}
+
+TEST_CASE(get_sees_edits) {
+    Overlay overlay(parse_value(R"({"a":{"b":1},"c":[5,6]})"));
+    ASSERT_TRUE(overlay.set("/a/b", parse_value("2")).has_value());
+    ASSERT_TRUE(overlay.set("/d", parse_value(R"({"e":3})")).has_value());
+    ASSERT_TRUE(overlay.remove("/c/0").has_value());
+
+    auto b = overlay.get("/a/b");
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(b->as_int(), 2);
+
+    auto e = overlay.get("/d/e");
+    ASSERT_TRUE(e.has_value());
+    EXPECT_EQ(e->as_int(), 3);
+
+    EXPECT_FALSE(overlay.get("/c/0").has_value());
+    auto kept = overlay.get("/c/1");
+    ASSERT_TRUE(kept.has_value());
+    EXPECT_EQ(kept->as_int(), 6);
+
+    auto root = overlay.get("");
+    ASSERT_TRUE(root.has_value());
+    EXPECT_TRUE(root->is_object());
+}
+
+TEST_CASE(removing_added_member_restores_base) {
+    Overlay overlay(parse_value(R"({"a":1})"));
+    ASSERT_TRUE(overlay.set("/b", parse_value("2")).has_value());
+    ASSERT_TRUE(overlay.remove("/b").has_value());
+
+    auto text = overlay.to_json_string();
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text, std::string(R"({"a":1})"));
+}
+
+TEST_CASE(replace_root) {
+    Overlay overlay(parse_value("[1]"));
+    ASSERT_TRUE(overlay.set("", parse_value(R"({"x":0})")).has_value());
+
+    auto text = overlay.to_json_string();
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text, std::string(R"({"x":0})"));
+}
+
+TEST_CASE(rejects_bad_pointers) {
+    Overlay overlay(parse_value(R"({"a":{"b":1},"s":"text","arr":[0]})"));
+
+    auto status = overlay.set("a", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::parse_error);
+
+    status = overlay.set("/a/~2", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::parse_error);
+
+    status = overlay.set("/missing/x", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::no_such_field);
+
+    status = overlay.set("/s/x", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::type_mismatch);
+
+    status = overlay.set("/arr/1", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::index_out_of_bounds);
+
+    status = overlay.set("/arr/01", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::parse_error);
+
+    status = overlay.remove("/a/missing");
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::no_such_field);
+
+    status = overlay.remove("");
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::invalid_state);
+
+    ASSERT_TRUE(overlay.set("/a", parse_value("{}")).has_value());
+    status = overlay.set("/a/b", parse_value("1"));
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), error_kind::invalid_state);
+
+    EXPECT_EQ(overlay.to_json_string().value_or(""),
+              std::string(R"({"a":{},"s":"text","arr":[0]})"));
+}
+
+};  // TEST_SUITE(serde_json_yyjson_overlay)
+
+}  // namespace
+
+}  // namespace kota::codec::json
@@ -0,0 +1,99 @@
+#if __has_include(<flatbuffers/flatbuffers.h>)
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/flatbuffers/flatbuffers.h"
+
+namespace kota::codec {
+
+namespace {
+
+using flatbuffers::append_record;
+using flatbuffers::record_archive;
+
+struct symbol {
+    std::string name;
+    std::int32_t line;
+    std::vector<std::int32_t> references;
+};
+
+auto symbols_archive() -> std::vector<std::uint8_t> {
+    std::vector<std::uint8_t> archive;
+    flatbuffers::Serializer<> serializer;
+    for(std::int32_t line = 1; line <= 3; ++line) {
+        const symbol input{.name = "s" + std::to_string(line), .line = line, .references = {line}};
+        EXPECT_TRUE(append_record(serializer, archive, input).has_value());
+    }
+    return archive;
+}
+
+TEST_SUITE(serde_flatbuffers_archive) {
+
+TEST_CASE(records_read_in_place) {
+    auto archive = symbols_archive();
+    ASSERT_EQ(archive.size() % flatbuffers::archive_alignment, 0U);
+
+    std::int32_t expected = 1;
+    for(auto it = record_archive<symbol>(archive).begin(); it != std::default_sentinel; ++it) {
+        EXPECT_EQ(it.offset() % flatbuffers::archive_alignment, 0U);
+        auto record = it.verified();
+        ASSERT_TRUE(record.valid());
+        EXPECT_EQ(record[&symbol::name], "s" + std::to_string(expected));
+        EXPECT_EQ(record[&symbol::line], expected);
+        EXPECT_EQ((*it)[&symbol::references][0], expected);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 4);
+}
+
+TEST_CASE(append_keeps_earlier_records) {
+    auto archive = symbols_archive();
+    const auto before = archive.size();
+    const symbol late{.name = "late", .line = 9, .references = {}};
+    ASSERT_TRUE(append_record(archive, late).has_value());
+
+    std::vector<std::string> names;
+    for(auto record: record_archive<symbol>(archive)) {
+        names.emplace_back(record[&symbol::name]);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"s1", "s2", "s3", "late"}));
+    EXPECT_EQ(std::vector<std::uint8_t>(archive.begin(), archive.begin() + before),
+              symbols_archive());
+}
+
+TEST_CASE(torn_append_ends_iteration) {
+    auto archive = symbols_archive();
+    const auto intact = archive.size();
+    const symbol torn{.name = "torn", .line = 4, .references = {4}};
+    ASSERT_TRUE(append_record(archive, torn).has_value());
+    archive.resize(archive.size() - 5);
+
+    record_archive<symbol> records(std::as_bytes(std::span(archive)));
+    std::size_t count = 0;
+    for(auto record: records) {
+        EXPECT_TRUE(record.valid());
+        ++count;
+    }
+    EXPECT_EQ(count, 3U);
+    EXPECT_EQ(records.intact_size(), intact);
+}
+
+TEST_CASE(empty_archive) {
+    std::vector<std::uint8_t> archive;
+    record_archive<symbol> records(archive);
+    EXPECT_TRUE(records.begin() == records.end());
+    EXPECT_EQ(records.intact_size(), 0U);
+}
+
+};  // TEST_SUITE(serde_flatbuffers_archive)
+
+}  // namespace
+
+}  // namespace kota::codec
+
+#endif
@@ -4,6 +4,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -119,6 +120,49 @@ TEST_CASE(non_trivial_nested_object_serializes_as_table_offset) {
     EXPECT_EQ(addr[&address::zip], 100);
 }
 
+TEST_CASE(serializer_reused_across_nested_tables) {
+    const std::vector<person> input{
+        {.id = 1, .name = "a", .pos = {1, 2}, .scores = {1}, .addr = {.city = "x", .zip = 1}},
+        {.id = 2, .name = "b", .pos = {3, 4}, .scores = {}, .addr = {.city = "y", .zip = 2}},
+    };
+
+    flatbuffers::Serializer<> serializer;
+    auto first = serializer.bytes(input);
+    ASSERT_TRUE(first.has_value());
+    auto second = serializer.bytes(input);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(*first, *second);
+    EXPECT_EQ(*first, *to_flatbuffer(input));
+}
+
+TEST_CASE(encode_into_caller_builder) {
+    const person input{
+        .id = 3,
+        .name = "carol",
+        .pos = {.x = 5, .y = 6},
+        .scores = {7, 8},
+        .addr = {.city = "sz", .zip = 518000},
+    };
+    auto expected = to_flatbuffer(input);
+    ASSERT_TRUE(expected.has_value());
+
+    ::flatbuffers::FlatBufferBuilder builder(64);
+    flatbuffers::Serializer<> serializer(builder);
+    for(int round = 0; round < 2; ++round) {
+        auto encoded = serializer.encode(input);
+        ASSERT_TRUE(encoded.has_value());
+        EXPECT_EQ(std::vector<std::uint8_t>(encoded->begin(), encoded->end()), *expected);
+        EXPECT_EQ(encoded->data(), builder.GetBufferPointer());
+    }
+
+    auto released = serializer.release();
+    ASSERT_EQ(released.size(), expected->size());
+    auto root = table_view<person>::from_bytes(
+        std::span<const std::uint8_t>(released.data(), released.size()));
+    ASSERT_TRUE(root.valid());
+    EXPECT_EQ(root[&person::name], "carol");
+}
+
 TEST_CASE(skip_attr_keeps_field_index_layout) {
     with_skip input{};
     input.a = 3;
@@ -319,6 +363,15 @@ struct deeply_nested_struct {
     outer nested;
 };
 
+struct untrusted_document {
+    std::string title;
+    std::vector<address> addresses;
+    std::vector<std::string> tags;
+    std::map<std::string, std::int32_t> counts;
+    std::variant<std::int32_t, address> owner;
+    std::vector<std::pair<std::int32_t, std::string>> pairs;
+};
+
 // ======== Optional / smart pointer tests ========
 
 TEST_CASE(optional_scalar_field_present) {
@@ -973,6 +1026,72 @@ TEST_CASE(array_view_out_of_bounds) {
     EXPECT_EQ(scores[100], 0);
 }
 
+TEST_CASE(verified_view_reads_whole_buffer) {
+    const untrusted_document input{
+        .title = "doc",
+        .addresses = {{.city = "a", .zip = 1}, {.city = "b", .zip = 2}},
+        .tags = {"x", "y"},
+        .counts = {{"one", 1}, {"two", 2}},
+        .owner = address{.city = "c", .zip = 3},
+        .pairs = {{1, "p"}},
+    };
+
+    auto encoded = to_flatbuffer(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    auto root = table_view<untrusted_document>::verified(*encoded);
+    ASSERT_TRUE(root.valid());
+    EXPECT_EQ(root[&untrusted_document::title], "doc");
+    EXPECT_EQ(root[&untrusted_document::addresses].size(), 2U);
+    EXPECT_EQ(root[&untrusted_document::counts]["two"], 2);
+}
+
+TEST_CASE(verified_view_rejects_truncated_buffer) {
+    const untrusted_document input{
+        .title = "a title long enough to be cut off",
+        .addresses = {{.city = "a", .zip = 1}},
+        .tags = {"x"},
+        .counts = {{"one", 1}},
+        .owner = 7,
+        .pairs = {},
+    };
+
+    auto encoded = to_flatbuffer(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    for(std::size_t size: {std::size_t{0}, std::size_t{3}, encoded->size() / 2}) {
+        auto truncated = std::span<const std::uint8_t>(encoded->data(), size);
+        EXPECT_FALSE(table_view<untrusted_document>::verified(truncated).valid());
+    }
+}
+
+TEST_CASE(cached_view_matches_table_view) {
+    const person input{
+        .id = 9,
+        .name = "dave",
+        .pos = {.x = 3, .y = 4},
+        .scores = {5},
+        .addr = {.city = "bj", .zip = 100000},
+    };
+
+    auto encoded = to_flatbuffer(input);
+    ASSERT_TRUE(encoded.has_value());
+
+    auto cached = table_view<person>::from_bytes(*encoded).cached();
+    ASSERT_TRUE(cached.valid());
+    EXPECT_TRUE(cached.has(&person::name));
+    EXPECT_EQ(cached[&person::id], 9);
+    EXPECT_EQ(cached[&person::name], "dave");
+    EXPECT_EQ(cached[&person::pos].y, 4);
+    EXPECT_EQ(cached[&person::scores][0], 5);
+    EXPECT_EQ(cached[&person::addr][&address::city], "bj");
+
+    flatbuffers::cached_table_view<person> empty;
+    EXPECT_FALSE(empty.valid());
+    EXPECT_FALSE(empty.has(&person::name));
+    EXPECT_EQ(empty[&person::id], 0);
+}
+
 };  // TEST_SUITE(serde_flatbuffers_object)
 
 }  // namespace
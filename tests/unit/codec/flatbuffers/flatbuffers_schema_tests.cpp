@@ -2,6 +2,8 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "kota/zest/zest.h"
@@ -43,6 +45,21 @@ TEST_CASE(map_field_emits_binary_search_entry_table) {
     EXPECT_NE(schema.find("attrs:[" + map_entry_name + "];"), std::string::npos);
 }
 
+TEST_CASE(table_layout_assigns_slot_voffsets) {
+    using payload_layout = flatbuffers::table_layout<payload>;
+    static_assert(payload_layout::slots == 4);
+    EXPECT_EQ(payload_layout::voffsets[0], 4U);
+    EXPECT_EQ(payload_layout::voffsets[3], 10U);
+
+    // Slot 0 of a variant holds the union type id.
+    using variant_layout = flatbuffers::table_layout<std::variant<std::int32_t, std::string>>;
+    static_assert(variant_layout::slots == 3);
+    EXPECT_EQ(variant_layout::voffsets[0], 4U);
+    EXPECT_EQ(variant_layout::voffsets[2], 8U);
+
+    EXPECT_EQ((flatbuffers::table_layout<std::pair<std::string, std::int32_t>>::voffsets[1]), 6U);
+}
+
 TEST_CASE(sorted_entries_support_binary_search_lookup) {
     const std::map<std::string, int> input{
         {"zeta",  3},
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -20,6 +21,31 @@ enum class access_level {
     viewer,
 };
 
+/// A capability set.
+enum class watch_kind : std::uint8_t {
+    Create = 1,
+    Change = 2,
+    Delete = 4,
+    Rename = 8,
+};
+
+struct watcher_payload {
+    std::string glob;
+    enum_flags<watch_kind> kind{};
+};
+
+struct document_pool {
+    static string_pool& pool() {
+        static string_pool documents;
+        return documents;
+    }
+};
+
+struct document_payload {
+    interned_string language_id;
+    interned<document_pool> uri;
+};
+
 struct profile_info {
     std::string first;
     int age = 0;
@@ -140,6 +166,53 @@ TEST_CASE(top_level_annotated_value_enum_string_unknown_fails) {
     EXPECT_EQ(parsed, access_level::admin);
 }
 
+TEST_CASE(enum_flags_as_names) {
+    watcher_payload input{.glob = "**/*.cpp",
+                          .kind = static_cast<watch_kind>(1 | 4 | 8)};
+    auto encoded = to_json(input);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, R"({"glob":"**/*.cpp","kind":["create","delete","rename"]})");
+
+    watcher_payload parsed{};
+    ASSERT_TRUE(from_json(*encoded, parsed).has_value());
+    EXPECT_EQ(parsed.kind, static_cast<watch_kind>(13));
+
+    ASSERT_TRUE(from_json(R"({"glob":"*","kind":[]})", parsed).has_value());
+    EXPECT_EQ(parsed.kind, watch_kind{});
+}
+
+TEST_CASE(enum_flags_unknown_name_fails) {
+    watcher_payload parsed{};
+    auto status = from_json(R"({"glob":"*","kind":["create","move"]})", parsed);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_NE(status.error().to_string().find("move"), std::string::npos);
+}
+
+TEST_CASE(interned_strings) {
+    const std::string_view text = R"({"language_id":"cpp","uri":"file:///a.cpp"})";
+    document_payload first{};
+    document_payload second{};
+    ASSERT_TRUE(from_json(text, first).has_value());
+    ASSERT_TRUE(from_json(text, second).has_value());
+
+    EXPECT_EQ(first.language_id, "cpp");
+    EXPECT_EQ(static_cast<interned_string&>(first.uri), "file:///a.cpp");
+    EXPECT_TRUE(first.language_id.data() == second.language_id.data());
+    EXPECT_TRUE(first.uri.data() == second.uri.data());
+    EXPECT_TRUE(first.language_id.data() == string_pool::global().intern("cpp").data());
+    EXPECT_EQ(document_pool::pool().size(), 1U);
+
+    auto encoded = to_json(first);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, text);
+}
+
+TEST_CASE(flag_enum_without_annotation_is_packed) {
+    auto encoded = to_json(static_cast<watch_kind>(1 | 2));
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, "3");
+}
+
 TEST_CASE(alias_conflict_fails_fast) {
     alias_conflict_payload parsed{};
     auto status = from_json(R"({"dup":1})", parsed);
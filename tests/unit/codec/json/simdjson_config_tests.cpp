@@ -1,6 +1,8 @@
 #include <string>
+#include <vector>
 
 #include "kota/zest/zest.h"
+#include "kota/support/small_string.h"
 #include "kota/codec/codec.h"
 #include "kota/codec/config.h"
 #include "kota/codec/json/deserializer.h"
@@ -40,6 +42,19 @@ struct camel_config {
     using field_rename = rename_policy::lower_camel;
 };
 
+struct six_digit_config {
+    using float_format = config::float_precision<6>;
+};
+
+struct small_buffer_config {
+    using vector_buffer = config::small_buffer<4>;
+};
+
+struct labelled_payload {
+    small_string<8> label;
+    std::vector<int> values;
+};
+
 TEST_SUITE(serde_simdjson_config) {
 
 TEST_CASE(default_identity_rename) {
@@ -116,6 +131,32 @@ TEST_CASE(config_with_attr_override) {
     EXPECT_EQ(parsed.request_id, 6);
 }
 
+TEST_CASE(renamed_keys_in_any_order) {
+    protocol_payload parsed{};
+    auto status = from_json<camel_config>(
+        R"({"nestedInfo":{"someValue":4},"request_id":1,"userName":"fay","requestId":2})",
+        parsed);
+    ASSERT_TRUE(status.has_value());
+    // Only the renamed spelling names a field; the canonical one is unknown.
+    EXPECT_EQ(parsed.request_id, 2);
+    EXPECT_EQ(parsed.user_name, "fay");
+    EXPECT_EQ(parsed.nested_info.some_value, 4);
+}
+
+TEST_CASE(static_renames) {
+    static_assert(spelling::constexpr_rename_policy<rename_policy::lower_camel>);
+    static_assert(spelling::static_rename<rename_policy::lower_camel, "request_id"> ==
+                  "requestId");
+    static_assert(spelling::static_rename<rename_policy::upper_snake, "requestId"> ==
+                  "REQUEST_ID");
+
+    std::string scratch;
+    EXPECT_EQ(config::static_field_rename<camel_config, "user_name">(scratch), "userName");
+    EXPECT_TRUE(scratch.empty());
+    EXPECT_EQ(config::static_field_rename<config::default_config, "user_name">(scratch),
+              "user_name");
+}
+
 TEST_CASE(rename_collision_fails) {
     ambiguous_camel_payload parsed{};
     auto status = from_json<camel_config>(R"({"userId":1})", parsed);
@@ -150,6 +191,41 @@ TEST_CASE(parse_value_with_config) {
     EXPECT_EQ(result->nested_info.some_value, 9);
 }
 
+TEST_CASE(float_precision_policy) {
+    std::vector<double> values = {0.1 + 0.2, 1.0 / 3.0, 2.5, 1e21, 40.0};
+
+    auto shortest = to_json(values);
+    ASSERT_TRUE(shortest.has_value());
+    EXPECT_EQ(*shortest, "[0.30000000000000004,0.3333333333333333,2.5,1e+21,40.0]");
+
+    auto rounded = to_json<six_digit_config>(values);
+    ASSERT_TRUE(rounded.has_value());
+    EXPECT_EQ(*rounded, "[0.3,0.333333,2.5,1e+21,40.0]");
+}
+
+TEST_CASE(vector_small_buffer) {
+    labelled_payload parsed;
+    auto status = from_json<small_buffer_config>(R"({"label":"short","values":[1,2,3]})", parsed);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(std::string_view(parsed.label), "short");
+    EXPECT_EQ(parsed.values, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(parsed.values.capacity(), 3U);
+
+    std::vector<int> longer;
+    status = from_json<small_buffer_config>("[1,2,3,4,5,6]", longer);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(longer, (std::vector<int>{1, 2, 3, 4, 5, 6}));
+
+    std::vector<int> empty{9};
+    status = from_json<small_buffer_config>("[]", empty);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_TRUE(empty.empty());
+
+    auto encoded = to_json(parsed);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, R"({"label":"short","values":[1,2,3]})");
+}
+
 };  // TEST_SUITE(serde_simdjson_config)
 
 }  // namespace
@@ -6,6 +6,7 @@
 #include "kota/meta/annotation.h"
 #include "kota/meta/attrs.h"
 #include "kota/codec/codec.h"
+#include "kota/codec/config.h"
 #include "kota/codec/json/deserializer.h"
 
 namespace kota::codec {
@@ -41,6 +42,10 @@ struct with_scores {
     std::vector<int> scores;
 };
 
+struct speculative_config {
+    using error_detail = config::no_error_detail;
+};
+
 TEST_SUITE(serde_simdjson_error_message) {
 
 TEST_CASE(missing_required_field) {
@@ -85,6 +90,31 @@ TEST_CASE(nested_sequence_error_path) {
     EXPECT_EQ(status.error().format_path(), "scores[1]");
 }
 
+TEST_CASE(mixed_error_path) {
+    std::vector<person> parsed;
+    auto status = from_json(R"([{"name": "a", "age": 1, "addr": {"city": "x", "zip": 1}},
+                                {"name": "b", "age": 2, "addr": {"city": "y", "zip": []}}])",
+                            parsed);
+    EXPECT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().format_path(), "[1].addr.zip");
+}
+
+TEST_CASE(no_error_detail) {
+    person parsed{};
+    auto status = from_json<speculative_config>(
+        R"({"name": "alice", "age": 30, "addr": {"city": "NY", "zip": "wrong"}})",
+        parsed);
+    EXPECT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().kind, json::error_kind::type_mismatch);
+    EXPECT_EQ(status.error().message(), "type mismatch");
+    EXPECT_EQ(status.error().format_path(), "");
+    EXPECT_FALSE(status.error().location().has_value());
+
+    status = from_json<speculative_config>(R"({"age": 25})", parsed);
+    EXPECT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().message(), "type mismatch");
+}
+
 TEST_CASE(enum_string_error_message) {
     enum_string<color> parsed = color::red;
     auto status = from_json(R"("yellow")", parsed);
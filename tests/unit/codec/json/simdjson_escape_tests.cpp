@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/escape.h"
+#include "kota/codec/json/serializer.h"
+
+namespace kota::codec::json {
+
+namespace {
+
+auto escaped(std::string_view text) -> std::string {
+    std::string out;
+    escape_string(text, [&](std::string_view part) { out.append(part); });
+    return out;
+}
+
+TEST_SUITE(serde_json_escape) {
+
+TEST_CASE(find_escape_at_every_offset) {
+    // Cover the SIMD, word and byte loops and the seams between them.
+    for(char special: {'"', '\\', '\n', '\0', '\x1f'}) {
+        for(std::size_t size = 1; size <= 40; ++size) {
+            for(std::size_t at = 0; at < size; ++at) {
+                std::string text(size, 'a');
+                text[at] = special;
+                EXPECT_EQ(find_escape(text), at);
+                EXPECT_EQ(find_escape(text, at + 1), size);
+            }
+        }
+    }
+
+    // Bytes at and above 0x20, including UTF-8, pass through.
+    std::string plain;
+    for(int c = 0x20; c < 0x100; ++c) {
+        if(c != '"' && c != '\\') {
+            plain.push_back(static_cast<char>(c));
+        }
+    }
+    EXPECT_EQ(find_escape(plain), plain.size());
+    EXPECT_EQ(escaped(plain), plain);
+}
+
+TEST_CASE(escape_sequences) {
+    EXPECT_EQ(escaped("say \"hi\"\\"), std::string(R"(say \"hi\"\\)"));
+    EXPECT_EQ(escaped("\b\f\n\r\t"), std::string(R"(\b\f\n\r\t)"));
+    EXPECT_EQ(escaped(std::string_view("\x00\x01\x1f", 3)), std::string(R"(\u0000\u0001\u001f)"));
+    EXPECT_EQ(escaped("多言語 text"), std::string("多言語 text"));
+    EXPECT_EQ(escaped(""), std::string());
+}
+
+TEST_CASE(serializer_escapes_long_strings) {
+    std::string text;
+    for(int i = 0; i < 200; ++i) {
+        text.append("line ");
+        text.append(std::to_string(i));
+        text.append(i % 7 == 0 ? "\t\"quoted\"\n" : " — plain text\n");
+    }
+
+    auto json = to_json(text);
+    ASSERT_TRUE(json.has_value());
+    EXPECT_EQ(*json, "\"" + escaped(text) + "\"");
+
+    std::string round_trip;
+    ASSERT_TRUE(from_json(*json, round_trip).has_value());
+    EXPECT_EQ(round_trip, text);
+}
+
+};  // TEST_SUITE(serde_json_escape)
+
+}  // namespace
+
+}  // namespace kota::codec::json
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/json/fragment_cache.h"
+#include "kota/codec/json/serializer.h"
+
+namespace kota::codec {
+
+namespace {
+
+using json::fragment_cache;
+
+struct symbol_entry {
+    std::string name;
+    std::uint32_t kind = 0;
+    std::optional<std::string> container;
+};
+
+struct symbol_response {
+    std::uint32_t id = 0;
+    json::cached_range<std::vector<symbol_entry>, config::default_config> result;
+};
+
+auto make_symbols() -> std::vector<symbol_entry> {
+    return {
+        {.name = "main",     .kind = 12, .container = std::nullopt},
+        {.name = "parse",    .kind = 12, .container = "lexer"      },
+        {.name = "position", .kind = 23, .container = std::nullopt},
+    };
+}
+
+TEST_SUITE(serde_json_fragment_cache) {
+
+TEST_CASE(matches_plain_serialization) {
+    auto symbols = make_symbols();
+    fragment_cache<symbol_entry> cache;
+
+    auto cached = json::to_json(json::cached(symbols, cache));
+    auto plain = json::to_json(symbols);
+    ASSERT_TRUE(cached.has_value());
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(*cached, *plain);
+    EXPECT_EQ(cache.size(), 3U);
+    EXPECT_EQ(cache.hits(), 0U);
+}
+
+TEST_CASE(unchanged_elements_are_reused) {
+    auto symbols = make_symbols();
+    fragment_cache<symbol_entry> cache;
+    ASSERT_TRUE(json::to_json(json::cached(symbols, cache)).has_value());
+    cache.sweep();
+
+    symbols[1].container = "parser";
+    symbols.push_back({.name = "main", .kind = 12, .container = std::nullopt});
+    auto cached = json::to_json(json::cached(symbols, cache));
+    auto plain = json::to_json(symbols);
+    ASSERT_TRUE(cached.has_value());
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(*cached, *plain);
+    EXPECT_EQ(cache.hits(), 3U);
+
+    // The old "parse" entry went unused and is dropped.
+    EXPECT_EQ(cache.size(), 4U);
+    cache.sweep();
+    EXPECT_EQ(cache.size(), 3U);
+}
+
+TEST_CASE(cached_range_as_struct_field) {
+    auto symbols = make_symbols();
+    fragment_cache<symbol_entry> cache;
+    symbol_response response{.id = 4, .result = json::cached(symbols, cache)};
+
+    auto encoded = json::to_json(response);
+    ASSERT_TRUE(encoded.has_value());
+    auto plain = json::to_json(symbols);
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(*encoded, R"({"id":4,"result":)" + *plain + "}");
+}
+
+};  // TEST_SUITE(serde_json_fragment_cache)
+
+}  // namespace
+
+}  // namespace kota::codec
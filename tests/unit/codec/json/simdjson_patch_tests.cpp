@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/meta/compare.h"
+#include "kota/meta/diff.h"
+#include "kota/codec/patch.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/serializer.h"
+
+namespace kota::codec {
+
+namespace {
+
+struct p_position {
+    std::uint32_t line = 0;
+    std::uint32_t character = 0;
+};
+
+struct p_diagnostic {
+    p_position start;
+    std::string message;
+};
+
+struct p_report {
+    std::string uri;
+    std::optional<std::int32_t> version;
+    std::vector<p_diagnostic> diagnostics;
+    std::vector<std::uint32_t> tokens;
+};
+
+auto sample() -> p_report {
+    return p_report{
+        .uri = "file:///main.cpp",
+        .version = 1,
+        .diagnostics = {{.start = {.line = 1, .character = 0}, .message = "unused"},
+                        {.start = {.line = 4, .character = 2}, .message = "missing"}},
+        .tokens = {0, 5, 3, 0, 0, 1},
+    };
+}
+
+TEST_SUITE(serde_simdjson_patch) {
+
+TEST_CASE(patch_is_written_inline) {
+    const auto old = sample();
+    auto updated = sample();
+    updated.diagnostics[1].message = "missing return";
+    updated.tokens = {0, 5, 9, 9, 0, 1};
+
+    auto changes = meta::diff(old, updated);
+    auto encoded = json::to_json(changes);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded,
+              R"([[0,"/diagnostics/1/message",0,0,"missing return"],)"
+              R"([1,"/tokens",2,2,[9,9]]])");
+}
+
+TEST_CASE(patch_applies_to_old_snapshot) {
+    const auto old = sample();
+    auto updated = sample();
+    updated.version.reset();
+    updated.diagnostics.push_back({.start = {.line = 9, .character = 1}, .message = "shadowed"});
+    updated.diagnostics[0].start.character = 3;
+    updated.tokens.erase(updated.tokens.begin(), updated.tokens.begin() + 3);
+
+    auto encoded = json::to_json(meta::diff(old, updated));
+    ASSERT_TRUE(encoded.has_value());
+
+    auto patched = sample();
+    patch_target target(patched);
+    ASSERT_TRUE(json::from_json(*encoded, target).has_value());
+    EXPECT_TRUE(meta::eq(patched, updated));
+}
+
+TEST_CASE(unknown_path_is_an_error) {
+    auto patched = sample();
+    patch_target target(patched);
+    auto status = json::from_json(R"([[0,"/nowhere",0,0,1]])", target);
+    ASSERT_FALSE(status.has_value());
+
+    status = json::from_json(R"([[1,"/tokens",4,9,[]]])", target);
+    ASSERT_FALSE(status.has_value());
+}
+
+};  // TEST_SUITE(serde_simdjson_patch)
+
+}  // namespace
+
+}  // namespace kota::codec
@@ -248,6 +248,27 @@ TEST_CASE(adjacently_tagged_content_before_tag_ambiguous_object) {
     EXPECT_EQ(rect.height, 20.0);
 }
 
+TEST_CASE(adjacently_tagged_content_before_tag_with_spacing) {
+    AdjShapeVariant parsed;
+    auto status = from_json(R"({ "value" : { "width" : 1.0, "height" : 2.0 } , "type" : "rect" })",
+                            parsed);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(std::get<ShapeRect>(parsed), (ShapeRect{.width = 1.0, .height = 2.0}));
+}
+
+TEST_CASE(adjacently_tagged_escaped_tag_after_content) {
+    AdjVariant parsed;
+    auto status = from_json(R"({"value":"hello","type":"te\u0078t"})", parsed);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(std::get<std::string>(parsed), "hello");
+}
+
+TEST_CASE(adjacently_tagged_duplicate_tag_fails) {
+    AdjVariant parsed;
+    auto status = from_json(R"({"value":1,"type":"integer","type":"text"})", parsed);
+    EXPECT_FALSE(status.has_value());
+}
+
 TEST_CASE(adjacently_tagged_unknown_tag_fails) {
     AdjVariant parsed;
     auto status = from_json(R"({"type":"unknown","value":42})", parsed);
@@ -307,6 +328,20 @@ TEST_CASE(internally_tagged_in_struct) {
     EXPECT_EQ(parsed, input);
 }
 
+TEST_CASE(internally_tagged_tag_after_fields) {
+    IntTagVariant parsed;
+    auto status = from_json(R"({"width":3.0,"height":4.0,"kind":"rect"})", parsed);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(std::get<ShapeRect>(parsed), (ShapeRect{.width = 3.0, .height = 4.0}));
+}
+
+TEST_CASE(internally_tagged_escaped_tag) {
+    IntTagVariant parsed;
+    auto status = from_json(R"({"kind":"circl\u0065","radius":1.5})", parsed);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(std::get<ShapeCircle>(parsed).radius, 1.5);
+}
+
 TEST_CASE(internally_tagged_unknown_tag_fails) {
     IntTagVariant parsed;
     auto status = from_json(R"({"kind":"triangle","side":5})", parsed);
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <limits>
 #include <map>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
@@ -12,7 +13,10 @@
 
 #include "kota/zest/zest.h"
 #include "kota/codec/codec.h"
+#include "kota/codec/json/array_index.h"
 #include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/push_parser.h"
+#include "kota/codec/json/record_stream.h"
 #include "kota/codec/json/serializer.h"
 
 namespace kota::codec {
@@ -23,6 +27,7 @@ namespace {
 
 using json::from_json;
 using json::to_json;
+using json::to_json_into;
 
 struct person {
     int id = 0;
@@ -39,6 +44,30 @@ struct object_string_value {
     std::string value;
 };
 
+struct text_position {
+    int line = 0;
+    int character = 0;
+};
+
+struct text_range {
+    text_position start;
+    text_position end;
+};
+
+struct renamed_position {
+    rename<int, "ln"> line = 0;
+    int character = 0;
+};
+
+struct snake_to_camel_config {
+    using field_rename = rename_policy::lower_camel;
+};
+
+struct camel_payload {
+    int request_id = 0;
+    text_position last_position;
+};
+
 enum class signed_enum : std::int8_t {
     low = -3,
     high = 7,
@@ -181,6 +210,23 @@ TEST_CASE(array_roundtrip) {
     EXPECT_EQ(fixed_out, fixed);
 }
 
+TEST_CASE(pmr_containers) {
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::vector<std::pmr::string> words(&arena);
+    ASSERT_TRUE(from_json(R"(["a word too long to fit inline","b"])", words).has_value());
+    ASSERT_EQ(words.size(), 2U);
+    EXPECT_EQ(words[0], "a word too long to fit inline");
+    EXPECT_EQ(words[1], "b");
+    EXPECT_TRUE(words.get_allocator().resource() == &arena);
+    EXPECT_TRUE(words[0].get_allocator().resource() == &arena);
+    ASSERT_EQ(to_json(words), R"(["a word too long to fit inline","b"])");
+
+    std::pmr::map<std::string, std::pmr::vector<int>> lines(&arena);
+    ASSERT_TRUE(from_json(R"({"main":[1,2,3]})", lines).has_value());
+    ASSERT_EQ(lines.at("main").size(), 3U);
+    EXPECT_TRUE(lines.at("main").get_allocator().resource() == &arena);
+}
+
 TEST_CASE(array_errors) {
     std::vector<int> ints;
     auto vector_shape_error = from_json(R"({"not":"array"})", ints);
@@ -226,6 +272,142 @@ TEST_CASE(object_roundtrip) {
     EXPECT_EQ(parsed.active, true);
 }
 
+TEST_CASE(sink_serializer) {
+    std::vector<person> people(20, person{.id = 1, .name = "someone", .scores = {1, 2}});
+    auto whole = to_json(people);
+    ASSERT_TRUE(whole.has_value());
+
+    std::vector<std::string> chunks;
+    auto status = to_json(
+        people,
+        [&](std::string_view chunk) {
+            chunks.emplace_back(chunk);
+            return true;
+        },
+        64);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_TRUE(chunks.size() > 1);
+
+    std::string joined;
+    for(const auto& chunk: chunks) {
+        joined += chunk;
+    }
+    EXPECT_EQ(joined, *whole);
+
+    std::size_t calls = 0;
+    auto refused = to_json(
+        people,
+        [&](std::string_view) {
+            ++calls;
+            return false;
+        },
+        64);
+    ASSERT_FALSE(refused.has_value());
+    EXPECT_EQ(refused.error(), json::error_kind::write_failed);
+    EXPECT_EQ(calls, 1U);
+}
+
+TEST_CASE(number_formatting) {
+    using limits64 = std::numeric_limits<std::int64_t>;
+    ASSERT_EQ(to_json(limits64::min()), "-9223372036854775808");
+    ASSERT_EQ(to_json(limits64::max()), "9223372036854775807");
+    ASSERT_EQ(to_json(std::numeric_limits<std::uint64_t>::max()), "18446744073709551615");
+
+    for(std::uint64_t value: {0ULL, 7ULL, 10ULL, 99ULL, 100ULL, 12345ULL, 10000000000ULL}) {
+        ASSERT_EQ(to_json(value), std::to_string(value));
+        auto negative = -static_cast<std::int64_t>(value);
+        ASSERT_EQ(to_json(negative), std::to_string(negative));
+    }
+
+    // Shortest digits that read back exactly, and a double stays a double.
+    ASSERT_EQ(to_json(0.1), "0.1");
+    ASSERT_EQ(to_json(-0.0), "-0.0");
+    ASSERT_EQ(to_json(1.0), "1.0");
+    ASSERT_EQ(to_json(5e-324), "5e-324");
+    ASSERT_EQ(to_json(1.7976931348623157e308), "1.7976931348623157e+308");
+
+    std::variant<std::int64_t, double> number;
+    ASSERT_TRUE(from_json(*to_json(2.0), number).has_value());
+    EXPECT_EQ(number.index(), 1U);
+}
+
+TEST_CASE(unsigned_number_arrays) {
+    ASSERT_EQ(to_json(std::vector<std::uint32_t>{}), "[]");
+    ASSERT_EQ(to_json(std::vector<std::uint32_t>{0, 7, 4294967295U}), "[0,7,4294967295]");
+
+    // Longer than one formatting block, nested, and read back.
+    std::vector<std::uint64_t> numbers(1000);
+    for(std::size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = i * 1000003ULL;
+    }
+    std::vector<std::vector<std::uint64_t>> nested{numbers, {}, numbers};
+    auto text = to_json(nested);
+    ASSERT_TRUE(text.has_value());
+
+    std::vector<std::vector<std::uint64_t>> parsed;
+    ASSERT_TRUE(from_json(*text, parsed).has_value());
+    EXPECT_EQ(parsed, nested);
+}
+
+TEST_CASE(fixed_shape_struct_keys) {
+    static_assert(detail::fixed_shape_struct<text_range, config::default_config>);
+    static_assert(!detail::fixed_shape_struct<renamed_position, config::default_config>);
+    EXPECT_EQ(json::detail::fixed_struct_keys<text_position, config::default_config>::fragments[1],
+              std::string_view(R"(,"character":)"));
+
+    text_range range{.start = {1, 2}, .end = {3, 40}};
+    auto encoded = to_json(range);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, R"({"start":{"line":1,"character":2},"end":{"line":3,"character":40}})");
+
+    text_range decoded;
+    ASSERT_TRUE(from_json(*encoded, decoded).has_value());
+    EXPECT_EQ(decoded.end.character, 40);
+
+    std::vector<text_position> positions{{0, 1}, {2, 3}};
+    EXPECT_EQ(to_json(positions), R"([{"line":0,"character":1},{"line":2,"character":3}])");
+    EXPECT_EQ(to_json(renamed_position{.line = 5, .character = 6}), R"({"ln":5,"character":6})");
+    EXPECT_EQ(to_json<snake_to_camel_config>(camel_payload{7, {8, 9}}),
+              R"({"requestId":7,"lastPosition":{"line":8,"character":9}})");
+
+    // A struct value is still one value where only one is allowed.
+    json::Serializer<> serializer;
+    ASSERT_TRUE(codec::serialize(serializer, range).has_value());
+    EXPECT_FALSE(codec::serialize(serializer, range).has_value());
+}
+
+TEST_CASE(serialize_into) {
+    person value{.id = 5, .name = "ann", .scores = {3}, .active = false};
+    auto whole = to_json(value);
+    ASSERT_TRUE(whole.has_value());
+
+    std::string out = "[";
+    ASSERT_TRUE(to_json_into(out, value).has_value());
+    out += ',';
+    ASSERT_TRUE(to_json_into(out, value).has_value());
+    out += ']';
+    EXPECT_EQ(out, "[" + *whole + "," + *whole + "]");
+}
+
+TEST_CASE(object_key_order) {
+    person parsed{};
+    ASSERT_TRUE(
+        from_json(R"({"active":true,"scores":[1],"name":"bob","id":3})", parsed).has_value());
+    EXPECT_EQ(parsed.id, 3);
+    EXPECT_EQ(parsed.name, "bob");
+    EXPECT_EQ(parsed.active, true);
+
+    // Out of order, unknown and escaped keys among ones in order.
+    parsed = {};
+    ASSERT_TRUE(from_json(R"({"id":4,"extra":0,"scores":[2],"n\u0061me":"eve","active":true})",
+                          parsed)
+                    .has_value());
+    EXPECT_EQ(parsed.id, 4);
+    EXPECT_EQ(parsed.name, "eve");
+    EXPECT_EQ(parsed.scores, std::vector<int>({2}));
+    EXPECT_EQ(parsed.active, true);
+}
+
 TEST_CASE(object_errors) {
     person parsed{};
 
@@ -379,6 +561,214 @@ TEST_CASE(misc_behavior) {
     ASSERT_EQ(from_value, std::vector<int>({7, 9}));
 }
 
+TEST_CASE(parse_context_reuse) {
+    json::parse_context context;
+
+    auto first = from_json<person>(
+        context,
+        R"({"id":1,"name":"a long enough name","scores":[1,2,3],"active":true})");
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->name, "a long enough name");
+    EXPECT_EQ(first->scores, std::vector<int>({1, 2, 3}));
+
+    // A shorter document after a longer one must not see its leftovers.
+    auto second = from_json<std::vector<int>>(context, "[4]");
+    ASSERT_EQ(second, std::vector<int>({4}));
+
+    auto truncated = from_json<person>(context, R"({"id":2,"name":"b")");
+    EXPECT_FALSE(truncated.has_value());
+    EXPECT_FALSE(context.busy());
+
+    auto third = from_json<person>(context, R"({"id":3,"name":"c","scores":[],"active":false})");
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(third->id, 3);
+
+    // A busy context falls back to a parser of its own.
+    {
+        json::parse_context::lease lease(context);
+        EXPECT_TRUE(context.busy());
+        auto nested = from_json<std::vector<int>>(context, "[5,6]");
+        ASSERT_EQ(nested, std::vector<int>({5, 6}));
+    }
+    EXPECT_FALSE(context.busy());
+
+    auto local = from_json<std::vector<int>>(json::parse_context::local(), "[]");
+    ASSERT_EQ(local, std::vector<int>{});
+}
+
+TEST_CASE(extract_by_pointer) {
+    constexpr std::string_view message = R"({"method":"textDocument/didOpen","params":{
+        "textDocument":{"uri":"file:///a~b.cpp","version":3,"text":"int main() {}"},
+        "a/b":{"~":[10,20,30]}}})";
+
+    auto uri = json::extract<std::string>(message, "/params/textDocument/uri");
+    ASSERT_EQ(uri, std::string("file:///a~b.cpp"));
+
+    auto escaped = json::extract<int>(message, "/params/a~1b/~0/2");
+    ASSERT_EQ(escaped, 30);
+
+    auto doc = json::extract<person>(R"({"p":{"id":4,"name":"n","scores":[1],"active":true}})",
+                                     "/p");
+    ASSERT_TRUE(doc.has_value());
+    EXPECT_EQ(doc->id, 4);
+    EXPECT_EQ(doc->scores, std::vector<int>({1}));
+
+    auto missing = json::extract<int>(message, "/params/missing");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error(), json::error_kind::no_such_field);
+
+    auto out_of_range = json::extract<int>(message, "/params/a~1b/~0/3");
+    ASSERT_FALSE(out_of_range.has_value());
+    EXPECT_EQ(out_of_range.error(), json::error_kind::index_out_of_bounds);
+
+    auto wrong_type = json::extract<int>(message, "/method");
+    EXPECT_FALSE(wrong_type.has_value());
+
+    // Several paths in one parse, in any order.
+    int version = 0;
+    std::string method;
+    std::vector<int> numbers;
+    auto status = json::extract<"/params/textDocument/version", "/method", "/params/a~1b/~0">(
+        message,
+        version,
+        method,
+        numbers);
+    ASSERT_TRUE(status.has_value());
+    EXPECT_EQ(version, 3);
+    EXPECT_EQ(method, "textDocument/didOpen");
+    EXPECT_EQ(numbers, std::vector<int>({10, 20, 30}));
+}
+
+TEST_CASE(records_from_ndjson) {
+    std::string lines = R"({"id":1,"name":"a","scores":[1],"active":true}
+{"id":2,"name":"b","scores":[],"active":false}
+{"id":"bad"}
+{"id":4,"name":"d","scores":[4,4],"active":true}
+)";
+
+    std::vector<int> ids;
+    std::vector<std::string> sources;
+    int failures = 0;
+    auto records = json::from_json_many<person>(lines);
+    EXPECT_FALSE(records.status().has_value());
+    for(auto it = records.begin(); it != records.end(); ++it) {
+        sources.emplace_back(it.source());
+        if(auto& record = *it; record.has_value()) {
+            ids.push_back(record->id);
+        } else {
+            ++failures;
+        }
+    }
+    EXPECT_EQ(ids, std::vector<int>({1, 2, 4}));
+    EXPECT_EQ(failures, 1);
+    ASSERT_EQ(sources.size(), 4U);
+    EXPECT_EQ(sources[2], R"({"id":"bad"})");
+
+    // Scalars and whitespace between records, read in place.
+    simdjson::padded_string padded(std::string_view(" 1 2\n\n 3 "));
+    std::vector<int> numbers;
+    for(auto& number: json::from_json_many<int>(simdjson::padded_string_view(padded))) {
+        ASSERT_TRUE(number.has_value());
+        numbers.push_back(*number);
+    }
+    EXPECT_EQ(numbers, std::vector<int>({1, 2, 3}));
+
+    // A truncated record ends the range after reporting it.
+    int seen = 0;
+    bool truncated = false;
+    for(auto& record: json::from_json_many<person>(std::string_view(R"({"id":1} {"id":)"))) {
+        ++seen;
+        truncated = !record.has_value();
+    }
+    EXPECT_TRUE(seen >= 1 && seen <= 2);
+    EXPECT_TRUE(truncated);
+}
+
+TEST_CASE(array_index_decodes_elements_out_of_order) {
+    simdjson::padded_string padded(std::string_view(
+        R"([ {"id":1,"name":"a","scores":[1],"active":true} , "x",
+          {"id":3,"name":"c","scores":[],"active":false} ])"));
+
+    auto index = json::array_index::build(padded);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_EQ(index->size(), 3U);
+    EXPECT_EQ((*index)[1], R"("x")");
+
+    person last;
+    ASSERT_TRUE(index->decode(2, last).has_value());
+    EXPECT_EQ(last.id, 3);
+    EXPECT_EQ(last.name, "c");
+
+    person first;
+    ASSERT_TRUE(index->decode(0, first).has_value());
+    EXPECT_EQ(first.scores, std::vector<int>({1}));
+
+    person wrong;
+    EXPECT_FALSE(index->decode(1, wrong).has_value());
+
+    simdjson::padded_string object(std::string_view(R"({"id":1})"));
+    EXPECT_FALSE(json::array_index::build(object).has_value());
+    simdjson::padded_string trailing(std::string_view("[1] 2"));
+    EXPECT_FALSE(json::array_index::build(trailing).has_value());
+}
+
+TEST_CASE(push_parser_decodes_elements_as_they_arrive) {
+    constexpr std::string_view input =
+        R"( [ {"id":1,"name":"a]\"}","scores":[1,2],"active":true},)"
+        R"({"id":"bad"}, {"id":3,"name":"","scores":[],"active":false} ] {"next":1})";
+
+    // Every split of the input, down to a byte at a time, decodes the same.
+    for(std::size_t piece: {input.size(), std::size_t{7}, std::size_t{1}}) {
+        json::array_push_parser<person> parser;
+        std::vector<int> ids;
+        int failures = 0;
+        auto on_element = [&](std::expected<person, json::error> element) {
+            if(element.has_value()) {
+                ids.push_back(element->id);
+            } else {
+                ++failures;
+            }
+        };
+
+        std::size_t fed = 0;
+        while(fed < input.size() && !parser.done()) {
+            auto decoded = parser.feed(input.substr(fed, piece), on_element);
+            ASSERT_TRUE(decoded.has_value());
+            fed = parser.offset();
+        }
+
+        ASSERT_TRUE(parser.finish().has_value());
+        EXPECT_EQ(ids, std::vector<int>({1, 3}));
+        EXPECT_EQ(failures, 1);
+        EXPECT_EQ(parser.buffered(), 0U);
+        EXPECT_EQ(input.substr(parser.offset()), R"( {"next":1})");
+    }
+
+    // Scalars end at the delimiter after them.
+    json::array_push_parser<int> numbers;
+    std::vector<int> values;
+    auto push = [&](std::expected<int, json::error> value) {
+        values.push_back(value.value_or(-1));
+    };
+    ASSERT_EQ(numbers.feed("[1, 2", push).value_or(0), 1U);
+    EXPECT_EQ(numbers.buffered(), 1U);
+    ASSERT_EQ(numbers.feed("3,\n4]  ", push).value_or(0), 2U);
+    EXPECT_TRUE(numbers.done());
+    EXPECT_EQ(values, std::vector<int>({1, 23, 4}));
+    EXPECT_TRUE(numbers.feed("\n", push).has_value());
+    EXPECT_FALSE(numbers.feed("5", push).has_value());
+
+    // Bytes that cannot be an array fail the parser for good.
+    json::array_push_parser<int> malformed;
+    EXPECT_FALSE(malformed.feed("[1,,2]", push).has_value());
+    EXPECT_FALSE(malformed.feed("]", push).has_value());
+    EXPECT_FALSE(malformed.finish().has_value());
+
+    json::array_push_parser<int> truncated;
+    EXPECT_TRUE(truncated.feed("[1, 2", push).has_value());
+    EXPECT_FALSE(truncated.finish().has_value());
+}
+
 };  // TEST_SUITE(serde_simdjson)
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -454,6 +844,31 @@ TEST_CASE(unknown_fields_ignored_by_default) {
     EXPECT_EQ(result->x, 1);
 }
 
+TEST_CASE(unknown_fields_skipped_whatever_their_value) {
+    // Unknown keys that share a length or a first byte with known ones, and
+    // nested values full of brackets inside strings.
+    auto result = from_json<StrictStruct>(R"({
+        "initializationOptions": {"a": [1, {"b": "}]"}], "c": {"d": null}},
+        "y": 2,
+        "nam": "x",
+        "x": 3,
+        "experimental": [[], {}, "\"]", -1.5e3],
+        "name": "ok",
+        "namf": {"name": "nested"}
+    })");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->x, 3);
+    EXPECT_EQ(result->name, "ok");
+
+    auto truncated = from_json<StrictStruct>(R"({"x": 1, "name": "ok", "extra": [1, 2)");
+    EXPECT_FALSE(truncated.has_value());
+
+    const auto& index = detail::wire_name_index<StrictStruct, config::default_config>();
+    EXPECT_TRUE(index.may_contain("name"));
+    EXPECT_FALSE(index.may_contain("z"));
+    EXPECT_FALSE(index.may_contain("initializationOptions"));
+}
+
 };  // TEST_SUITE(serde_required_fields)
 
 }  // namespace
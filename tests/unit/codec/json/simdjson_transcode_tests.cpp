@@ -0,0 +1,121 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/bincode.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/transcode.h"
+
+namespace kota::codec {
+
+namespace {
+
+struct location {
+    std::string uri;
+    std::uint32_t line = 0;
+    std::uint32_t column = 0;
+};
+
+struct diagnostic {
+    std::string message;
+    std::optional<std::string> source;
+    location where;
+    std::vector<std::string> tags;
+    std::tuple<int, bool> severity;
+    std::variant<int, std::string> code;
+};
+
+/// JSON transcoded to bincode.
+auto transcode_json(std::string_view text) -> std::expected<std::vector<std::byte>, std::string> {
+    json::Deserializer<> deserializer(text);
+    bincode::Serializer<> serializer;
+    auto status = transcode<diagnostic>(deserializer, serializer);
+    if(!status) {
+        return std::unexpected(status.error().index() == 0
+                                   ? std::get<0>(status.error()).to_string()
+                                   : std::string("write failed"));
+    }
+    return serializer.take_bytes();
+}
+
+constexpr std::string_view in_order = R"({
+    "message": "unused \"x\"",
+    "source": "clang",
+    "where": {"uri": "file:///a.cpp", "line": 3, "column": 7},
+    "tags": ["unnecessary", "deprecated"],
+    "severity": [2, true],
+    "code": "W123"
+})";
+
+TEST_SUITE(serde_transcode) {
+
+TEST_CASE(matches_decoding_then_encoding) {
+    diagnostic parsed;
+    ASSERT_TRUE(json::from_json(in_order, parsed).has_value());
+    auto expected = bincode::to_bytes(parsed);
+    ASSERT_TRUE(expected.has_value());
+
+    auto transcoded = transcode_json(in_order);
+    ASSERT_TRUE(transcoded.has_value());
+    EXPECT_EQ(*transcoded, *expected);
+}
+
+TEST_CASE(fields_out_of_order) {
+    constexpr std::string_view text = R"({
+        "tags": [],
+        "code": 4,
+        "where": {"column": 1, "uri": "u", "line": 2},
+        "unknown": {"ignored": [1, 2]},
+        "message": "m",
+        "severity": [1, false]
+    })";
+    auto transcoded = transcode_json(text);
+    ASSERT_TRUE(transcoded.has_value());
+
+    auto decoded = bincode::from_bytes<diagnostic>(*transcoded);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->message, "m");
+    EXPECT_FALSE(decoded->source.has_value());
+    EXPECT_EQ(decoded->where.uri, "u");
+    EXPECT_EQ(decoded->where.line, 2U);
+    EXPECT_EQ(decoded->where.column, 1U);
+    EXPECT_TRUE(decoded->tags.empty());
+    EXPECT_EQ(std::get<0>(decoded->severity), 1);
+    EXPECT_EQ(std::get<int>(decoded->code), 4);
+}
+
+TEST_CASE(unordered_map_entries) {
+    using table = std::unordered_map<std::string, std::vector<int>>;
+    json::Deserializer<> deserializer(R"({"a": [1], "b": [2, 3]})");
+    bincode::Serializer<> serializer;
+    ASSERT_TRUE(transcode<table>(deserializer, serializer).has_value());
+
+    auto decoded = bincode::from_bytes<table>(serializer.bytes());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(*decoded, (table{{"a", {1}}, {"b", {2, 3}}}));
+}
+
+TEST_CASE(missing_field_is_an_input_error) {
+    auto transcoded = transcode_json(R"({"message": "m", "where": {"uri": "u", "line": 1}})");
+    ASSERT_FALSE(transcoded.has_value());
+    EXPECT_NE(transcoded.error().find("column"), std::string::npos);
+}
+
+TEST_CASE(bad_value_names_its_path) {
+    auto transcoded = transcode_json(R"({"message": "m", "tags": ["a", 5]})");
+    ASSERT_FALSE(transcoded.has_value());
+    EXPECT_NE(transcoded.error().find("tags"), std::string::npos);
+}
+
+};  // TEST_SUITE(serde_transcode)
+
+}  // namespace
+
+}  // namespace kota::codec
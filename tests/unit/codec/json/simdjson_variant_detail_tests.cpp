@@ -269,6 +269,39 @@ TEST_CASE(struct_backtracking) {
     EXPECT_EQ(std::get<IntHolder>(out).value, 42);
 }
 
+TEST_CASE(struct_selected_by_keys) {
+    using V = std::variant<Point, Color, IntHolder>;
+
+    V out{};
+    ASSERT_TRUE(from_json(R"({"value":3})", out).has_value());
+    EXPECT_EQ(out.index(), 2U);
+    EXPECT_EQ(std::get<IntHolder>(out).value, 3);
+
+    // Keys are matched at the top level only, whatever the values hold.
+    ASSERT_TRUE(from_json(R"({ "r" : 1, "g":2, "b":3, "x":{"x":[1,"}"]} })", out).has_value());
+    EXPECT_EQ(out.index(), 1U);
+    EXPECT_EQ(std::get<Color>(out), (Color{.r = 1, .g = 2, .b = 3}));
+
+    // An escaped key is not screened; every alternative is tried.
+    ASSERT_TRUE(from_json(R"({"\u0078":1.5,"y":2.5})", out).has_value());
+    EXPECT_EQ(out.index(), 0U);
+    EXPECT_EQ(std::get<Point>(out), (Point{.x = 1.5, .y = 2.5}));
+
+    EXPECT_FALSE(from_json(R"({"r":1,"g":2})", out).has_value());
+}
+
+TEST_CASE(struct_without_required_fields_still_first) {
+    struct Loose {
+        std::optional<std::int32_t> value;
+    };
+    using V = std::variant<Loose, IntHolder>;
+
+    V out{};
+    ASSERT_TRUE(from_json(R"({"value":4})", out).has_value());
+    EXPECT_EQ(out.index(), 0U);
+    EXPECT_TRUE(std::get<Loose>(out).value == 4);
+}
+
 TEST_CASE(no_matching_type_fails) {
     using V = std::variant<int, std::string>;
 
@@ -30,6 +30,12 @@ struct payload_with_extra {
     ::toml::table extra;
 };
 
+struct named_payload {
+    int id = 0;
+    std::string name;
+    ::toml::table extra;
+};
+
 TEST_SUITE(serde_toml) {
 
 TEST_CASE(struct_roundtrip_with_dom) {
@@ -76,6 +82,23 @@ active = true
     EXPECT_EQ(*reparsed, *parsed);
 }
 
+TEST_CASE(to_string_appends_into_reused_buffer) {
+    person input{.id = 3, .name = "eve", .scores = {1, 2}, .active = true};
+
+    auto expected = to_string(input);
+    ASSERT_TRUE(expected.has_value());
+
+    std::string out = "# header\n";
+    ASSERT_TRUE(to_string(input, out).has_value());
+    EXPECT_EQ(out, "# header\n" + *expected);
+
+    out.clear();
+    const auto capacity = out.capacity();
+    ASSERT_TRUE(to_string(input, out).has_value());
+    EXPECT_EQ(out, *expected);
+    EXPECT_EQ(out.capacity(), capacity);
+}
+
 TEST_CASE(dynamic_dom_field_roundtrip) {
     payload_with_extra input{};
     input.id = 1;
@@ -132,6 +155,28 @@ TEST_CASE(boxed_root_scalar_and_optional_none) {
     EXPECT_FALSE(decoded_none.has_value());
 }
 
+TEST_CASE(from_toml_moves_out_of_rvalue_table) {
+    payload_with_extra input{};
+    input.id = 3;
+    input.extra.insert_or_assign("note", std::string(256, 'n'));
+
+    auto dom = to_toml(input);
+    ASSERT_TRUE(dom.has_value());
+    dom->insert_or_assign("name", std::string(256, 'x'));
+
+    auto output = from_toml<named_payload>(std::move(*dom));
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(output->id, 3);
+    EXPECT_EQ(output->name, std::string(256, 'x'));
+    EXPECT_EQ(output->extra["note"].value<std::string>().value_or(""), std::string(256, 'n'));
+
+    auto boxed = to_toml(std::vector<std::string>{"a", "b"});
+    ASSERT_TRUE(boxed.has_value());
+    auto strings = from_toml<std::vector<std::string>>(std::move(*boxed));
+    ASSERT_TRUE(strings.has_value());
+    EXPECT_EQ(*strings, (std::vector<std::string>{"a", "b"}));
+}
+
 };  // TEST_SUITE(serde_toml)
 
 }  // namespace
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <expected>
 #include <string>
 #include <type_traits>
@@ -202,6 +203,8 @@ static_assert(!std::is_move_constructible_v<ParseAllStorage>);
 static_assert(std::is_same_v<
               ParseAllStorage,
               detail::LLVMOptGenerator<ParseAllOpt, detail::BuildStorage<ParseAllOpt>::record>>);
+static_assert(detail::build_storage<ParseAllOpt>().opt_size() > 1);
+static_assert(detail::BuildStorage<ParseAllOpt>::index.view().nodes.size() > 1);
 
 using Parsed = option::ParsedArgument;
 
@@ -286,6 +289,38 @@ TEST_CASE(storage_keeps_dummy_alignment_for_id_map) {
     }
 }
 
+TEST_CASE(static_index_matches_runtime_table) {
+    const auto& built = detail::build_storage<ParseAllOpt>();
+    const auto view = detail::BuildStorage<ParseAllOpt>::index.view();
+    const auto derived = option::OptTable::derive_index(built.option_infos(), true);
+
+    EXPECT_TRUE(view.nodes.size() == derived.nodes.size());
+    EXPECT_TRUE(view.edges.size() == derived.edges.size());
+    EXPECT_TRUE(std::ranges::equal(view.prefixes_union, derived.prefixes_union));
+    EXPECT_TRUE(std::ranges::equal(view.prefix_chars, derived.prefix_chars));
+    EXPECT_TRUE(std::ranges::equal(view.options, derived.options));
+
+    std::vector<std::string> argv = {"--version", "--opt42", "-P", "left", "right", "main.cc"};
+    auto runtime_args = parse_with(built, argv);
+    auto static_table = detail::make_opt_table<ParseAllOpt>();
+    std::vector<Parsed> static_args;
+    static_table.parse_args(argv, [&](std::expected<Parsed, std::string> parsed) {
+        EXPECT_TRUE(parsed.has_value());
+        if(parsed.has_value()) {
+            static_args.push_back(*parsed);
+        }
+        return parsed.has_value();
+    });
+
+    ASSERT_TRUE(runtime_args.has_value());
+    ASSERT_TRUE(runtime_args->size() == static_args.size());
+    for(std::size_t i = 0; i < static_args.size(); ++i) {
+        EXPECT_TRUE(static_args[i].option_id.id() == (*runtime_args)[i].option_id.id());
+        EXPECT_TRUE(static_args[i].get_spelling_view() == (*runtime_args)[i].get_spelling_view());
+        EXPECT_TRUE(std::ranges::equal(static_args[i].values, (*runtime_args)[i].values));
+    }
+}
+
 TEST_CASE(parse_covers_flag_input_kv_comma_multi) {
     const auto& built = detail::build_storage<ParseAllOpt>();
     std::vector<std::string> argv = {"--version",
@@ -640,7 +640,7 @@ TEST_CASE(diagnostic_at_uses_non_owning_argv_view) {
     const auto argv_view = std::span<const std::string>(argv.data(), argv.size());
     auto diagnostic = cli::text::diagnostic_at(argv_view, 0, 1, "boom");
 
-    EXPECT_EQ(diagnostic.argv.data(), argv.data());
+    EXPECT_EQ(diagnostic.argv[0].data(), argv[0].data());
     argv[0] = "--renamed";
 
     auto renderer = cli::text::CompatibleRenderer();
@@ -829,6 +829,26 @@ TEST_CASE(alias_static_forward_supports_comma_and_multi_shapes) {
     EXPECT_TRUE((*res->options.pair)[1] == "right");
 }
 
+TEST_CASE(alias_forward_views_borrowed_argv) {
+    const char* raw[] = {"alias", "--tags-alias,a,b", "--pair-alias", "left", "right"};
+    const auto argv = util::borrow_argv(5, raw);
+    auto res = cli::parse<AliasRuntimeOpt>(argv);
+    ASSERT_TRUE(res.has_value());
+
+    EXPECT_TRUE(res->options.tags.has_value());
+    EXPECT_TRUE(*res->options.tags == std::vector<std::string>{"a", "b"});
+    EXPECT_TRUE(res->options.pair.has_value());
+    EXPECT_TRUE(*res->options.pair == std::vector<std::string>{"left", "right"});
+
+    // Both forwards reuse the caller's tokens instead of copying them.
+    EXPECT_EQ(res->original_argv[0].data(), raw[1]);
+    const auto active = res->argv();
+    ASSERT_EQ(active.size(), 3u);
+    EXPECT_TRUE(active[0] == "--pair");
+    EXPECT_EQ(active[1].data(), raw[3]);
+    EXPECT_EQ(active[2].data(), raw[4]);
+}
+
 TEST_CASE(alias_dynamic_with_context_preserves_preformatted_errors) {
     auto res = cli::parse<AliasRuntimeOpt>(into_deco_args("--ctx-fail"));
     EXPECT_FALSE(res.has_value());
@@ -1078,13 +1098,13 @@ TEST_CASE(dispatching_with_subcommand_and_default) {
                 .name = "run",
                 .description = "Run task",
             },
-            [&](std::span<std::string> args) {
+            [&](backend::ArgvView args) {
                 ss << "run:";
                 for(const auto& arg: args) {
                     ss << arg << ",";
                 }
             })
-        .add([&](std::span<std::string> args) {
+        .add([&](backend::ArgvView args) {
             ss << "default:";
             for(const auto& arg: args) {
                 ss << arg << ",";
@@ -1111,7 +1131,7 @@ TEST_CASE(match_reports_subcommand_context) {
             .name = "run",
             .description = "Run task",
         },
-        [](std::span<std::string>) {});
+        [](backend::ArgvView) {});
 
     auto match = subcommander.match(into_deco_args("run", "-v", "--dry"));
     EXPECT_TRUE(match.has_value());
@@ -1178,15 +1198,15 @@ TEST_CASE(usage_with_default_and_overview) {
                 .name = "run",
                 .description = "Run a task",
             },
-            [](std::span<std::string>) {})
+            [](backend::ArgvView) {})
         .add(
             decl::SubCommand{
                 .name = "inspect",
                 .description = "Inspect metadata",
                 .command = "show",
             },
-            [](std::span<std::string>) {})
-        .add([](std::span<std::string>) {});
+            [](backend::ArgvView) {})
+        .add([](backend::ArgvView) {});
 
     std::stringstream ss;
     subcommander.usage(ss);
@@ -1209,7 +1229,7 @@ TEST_CASE(usage_without_default_and_unknown_subcommand) {
                 .name = "run",
                 .description = "Run a task",
             },
-            [](std::span<std::string>) {})
+            [](backend::ArgvView) {})
         .when_err([&](auto err) { ss << err.message; });
 
     std::vector<std::string> args = {"unknown"};
@@ -1237,7 +1257,7 @@ TEST_CASE(subcommand_can_use_custom_renderer) {
                 .name = "run",
                 .description = "Run a task",
             },
-            [](std::span<std::string>) {})
+            [](backend::ArgvView) {})
         .render_with(make_custom_renderer())
         .when_err([&](auto err) { seen_error = err.message; });
 
@@ -1257,7 +1277,7 @@ TEST_CASE(subcommand_can_use_modern_renderer_config) {
                 .name = "run",
                 .description = "Run a task",
             },
-            [](std::span<std::string>) {})
+            [](backend::ArgvView) {})
         .render_with_modern();
 
     std::stringstream ss;
@@ -1334,9 +1354,9 @@ TEST_CASE(catter_v2) {
         cli::command<CatterOpt>("catter [OPTIONS] [OPTIONS for script] -- [OPTIONS for command]");
     auto eat_script_args = [](auto& step) {
         unsigned idx = step.next_cursor();
-        std::span<std::string> original_argv = step.original_argv();
+        backend::ArgvView original_argv = step.original_argv();
         while(idx < original_argv.size() && original_argv[idx] != "--") {
-            step.options().script_args.push_back(original_argv[idx++]);
+            step.options().script_args.emplace_back(original_argv[idx++]);
         }
         return step.seek(idx);
     };
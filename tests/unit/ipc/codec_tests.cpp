@@ -1,9 +1,14 @@
 #include <cstdint>
+#include <format>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
+#include <vector>
 
 #include "kota/ipc/codec/bincode.h"
 #include "kota/ipc/codec/json.h"
+#include "kota/ipc/message_pool.h"
 #include "kota/zest/zest.h"
 
 namespace kota::ipc {
@@ -24,6 +29,11 @@ const T& get(const IncomingMessage& msg) {
     return std::get<T>(msg);
 }
 
+struct AddParams {
+    int a = 0;
+    int b = 0;
+};
+
 // ============================================================================
 // Group 1: JsonCodec — parse_message boundary tests
 // ============================================================================
@@ -166,11 +176,73 @@ TEST_CASE(string_id_accepted) {
 
     ASSERT_TRUE(holds<IncomingRequest>(msg));
     auto& req = get<IncomingRequest>(msg);
-    EXPECT_TRUE(std::holds_alternative<std::string>(req.id));
-    EXPECT_EQ(std::get<std::string>(req.id), "abc");
+    EXPECT_TRUE(req.id.is_string());
+    EXPECT_EQ(req.id.as_string(), "abc");
     EXPECT_EQ(req.method, "test/foo");
 }
 
+// 1.13 Params are sliced out of the payload, not copied
+TEST_CASE(params_view_into_payload) {
+    JsonCodec codec;
+    const std::string payload = R"({"jsonrpc":"2.0","method":"$/progress","params":{"token":1}})";
+    auto msg = codec.parse_message(payload);
+
+    ASSERT_TRUE(holds<IncomingNotification>(msg));
+    auto params = get<IncomingNotification>(msg).params;
+    EXPECT_EQ(params, R"({"token":1})");
+    EXPECT_TRUE(params.data() > payload.data());
+    EXPECT_TRUE(params.data() + params.size() < payload.data() + payload.size());
+}
+
+// 1.14 The method is found by scanning, past members of any shape
+TEST_CASE(peek_method) {
+    EXPECT_EQ(JsonCodec::peek_method(
+                  R"({"jsonrpc":"2.0","id":1,"params":{"s":"},\"","v":[1,{}]},"method":"add"})"),
+              std::optional<std::string_view>("add"));
+    EXPECT_EQ(JsonCodec::peek_method(R"( { "method" : "test/foo" } )"),
+              std::optional<std::string_view>("test/foo"));
+    EXPECT_FALSE(JsonCodec::peek_method(R"({"jsonrpc":"2.0","id":1,"result":null})").has_value());
+    EXPECT_FALSE(JsonCodec::peek_method(R"({"method":"a\/b"})").has_value());
+    EXPECT_FALSE(JsonCodec::peek_method("{not valid json").has_value());
+}
+
+// 1.15 Typed decoding reads id and params together
+TEST_CASE(decode_request_typed) {
+    JsonCodec codec;
+    auto decoded = codec.decode_request<AddParams>(
+        R"({"jsonrpc":"2.0","id":3,"method":"add","params":{"a":1,"b":2}})");
+
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->id, protocol::RequestID{std::int64_t(3)});
+    EXPECT_EQ(decoded->params.a, 1);
+    EXPECT_EQ(decoded->params.b, 2);
+
+    EXPECT_FALSE(codec.decode_request<AddParams>(R"({"method":"add","params":{}})").has_value());
+    EXPECT_FALSE(
+        codec.decode_request<AddParams>(R"({"id":1,"method":"add","params":{"a":"x"}})")
+            .has_value());
+}
+
+// 1.16 A batch splits into views of its messages
+TEST_CASE(split_batch) {
+    JsonCodec codec;
+    const std::string payload =
+        R"( [{"jsonrpc":"2.0","id":1,"method":"a"}, {"jsonrpc":"2.0","method":"b"}])";
+    ASSERT_TRUE(JsonCodec::is_batch(payload));
+    EXPECT_FALSE(JsonCodec::is_batch(R"({"jsonrpc":"2.0","method":"a"})"));
+
+    auto messages = codec.split_batch(payload);
+    ASSERT_TRUE(messages.has_value());
+    ASSERT_EQ(messages->size(), 2U);
+    EXPECT_EQ((*messages)[0], R"({"jsonrpc":"2.0","id":1,"method":"a"})");
+    EXPECT_TRUE(holds<IncomingNotification>(codec.parse_message((*messages)[1])));
+
+    auto empty = codec.split_batch("[]");
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().code,
+              static_cast<protocol::integer>(protocol::ErrorCode::InvalidRequest));
+}
+
 };  // TEST_SUITE(ipc_json_codec_parse)
 
 // ============================================================================
@@ -339,6 +411,90 @@ TEST_CASE(empty_params_roundtrip) {
     ASSERT_TRUE(holds<IncomingRequest>(msg));
 }
 
+// 2.6 Encoding into a recycled buffer replaces its contents and keeps its storage
+TEST_CASE(encode_into_reused_buffer) {
+    JsonCodec codec;
+    MessagePool pool;
+
+    std::string buffer(256, 'x');
+    pool.give(std::move(buffer));
+    ASSERT_EQ(pool.size(), 1u);
+
+    auto out = pool.take();
+    const auto capacity = out.capacity();
+    EXPECT_TRUE(out.empty());
+
+    auto status = codec.encode_notification(out, "log/info", R"({"text":"hi"})");
+    ASSERT_FALSE(status.has_error());
+    EXPECT_EQ(out.capacity(), capacity);
+    EXPECT_EQ(out, *codec.encode_notification("log/info", R"({"text":"hi"})"));
+
+    auto msg = codec.parse_message(out);
+    ASSERT_TRUE(holds<IncomingNotification>(msg));
+    EXPECT_EQ(get<IncomingNotification>(msg).method, "log/info");
+}
+
+// 2.7 Request ids keep their kind, inline or not, through a round trip
+TEST_CASE(request_id_kinds) {
+    static_assert(sizeof(protocol::RequestID) == 16);
+
+    protocol::RequestID number = 7;
+    protocol::RequestID short_text = "req-1";
+    protocol::RequestID long_text = "3f2b8c1e-9d4a-4e7b-a1c2-5d6e7f8a9b0c";
+    EXPECT_TRUE(number.is_integer());
+    EXPECT_EQ(short_text.as_string(), "req-1");
+    EXPECT_FALSE(protocol::RequestID(1) == protocol::RequestID("1"));
+
+    auto copy = long_text;
+    EXPECT_EQ(copy, long_text);
+    EXPECT_EQ(copy.hash(), long_text.hash());
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved.as_string(), long_text.as_string());
+
+    JsonCodec codec;
+    for(const auto& id: {number, short_text, long_text}) {
+        auto encoded = codec.encode_success_response(id, "null");
+        ASSERT_TRUE(encoded.has_value());
+        auto msg = codec.parse_message(*encoded);
+        ASSERT_TRUE(holds<IncomingResponse>(msg));
+        EXPECT_EQ(get<IncomingResponse>(msg).id, id);
+    }
+}
+
+TEST_CASE(parse_array_parallel_fills_every_slot) {
+    std::string json = "[";
+    constexpr int count = 5000;
+    for(int i = 0; i < count; ++i) {
+        json += (i == 0 ? "" : ",") + std::format(R"({{"a":{},"b":{}}})", i, -i);
+    }
+    json += "]";
+
+    event_loop loop;
+    auto decode = [&](std::string_view text) -> task<std::optional<std::vector<AddParams>>> {
+        auto values = co_await parse_array_parallel<AddParams>(text, 64);
+        co_return values.has_error() ? std::nullopt : std::optional(std::move(*values));
+    };
+
+    auto parsed = decode(json);
+    auto bad = decode(R"([{"a":1,"b":2}, {"a":"x"}])");
+    auto empty = decode("[]");
+    loop.schedule(parsed);
+    loop.schedule(bad);
+    loop.schedule(empty);
+    loop.run();
+
+    auto values = parsed.result();
+    ASSERT_TRUE(values.has_value());
+    ASSERT_EQ(values->size(), static_cast<std::size_t>(count));
+    for(int i = 0; i < count; ++i) {
+        EXPECT_EQ((*values)[i].a, i);
+        EXPECT_EQ((*values)[i].b, -i);
+    }
+    EXPECT_FALSE(bad.result().has_value());
+    ASSERT_TRUE(empty.result().has_value());
+    EXPECT_TRUE(empty.result()->empty());
+}
+
 };  // TEST_SUITE(ipc_json_codec_roundtrip)
 
 TEST_SUITE(ipc_bincode_codec_roundtrip) {
@@ -409,6 +565,39 @@ TEST_CASE(empty_params_roundtrip) {
     EXPECT_TRUE(req.params.empty());
 }
 
+// 2.6 typed params encode to the same bytes as pre-serialized ones
+TEST_CASE(typed_params_match_serialized) {
+    BincodeCodec codec;
+    AddParams params{.a = 3, .b = 4};
+    auto serialized = codec.serialize_value(params);
+    ASSERT_TRUE(serialized.has_value());
+
+    std::string typed;
+    ASSERT_TRUE(codec
+                    .encode_typed_request(typed,
+                                          protocol::RequestID{std::int64_t(5)},
+                                          "math/add",
+                                          params)
+                    .has_value());
+    auto expected =
+        codec.encode_request(protocol::RequestID{std::int64_t(5)}, "math/add", *serialized);
+    ASSERT_TRUE(expected.has_value());
+    EXPECT_EQ(typed, *expected);
+
+    std::string typed_note;
+    ASSERT_TRUE(codec.encode_typed_notification(typed_note, "math/add", params).has_value());
+    auto expected_note = codec.encode_notification("math/add", *serialized);
+    ASSERT_TRUE(expected_note.has_value());
+    EXPECT_EQ(typed_note, *expected_note);
+
+    auto msg = codec.parse_message(typed);
+    ASSERT_TRUE(holds<IncomingRequest>(msg));
+    auto parsed = codec.deserialize_value<AddParams>(get<IncomingRequest>(msg).params);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->a, 3);
+    EXPECT_EQ(parsed->b, 4);
+}
+
 };  // TEST_SUITE(ipc_bincode_codec_roundtrip)
 
 }  // namespace
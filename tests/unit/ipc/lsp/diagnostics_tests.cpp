@@ -0,0 +1,108 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../peer_test_types.h"
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+#include "kota/ipc/lsp/diagnostics.h"
+
+namespace kota::ipc {
+namespace {
+
+using lsp::DiagnosticsPublisher;
+
+protocol::PublishDiagnosticsParams diagnostics(std::string uri, std::string message) {
+    protocol::PublishDiagnosticsParams params;
+    params.uri = std::move(uri);
+    params.diagnostics.push_back(protocol::Diagnostic{
+        .range = {.start = {.line = 0, .character = 0}, .end = {.line = 0, .character = 1}},
+        .message = std::move(message),
+    });
+    return params;
+}
+
+std::size_t count(const std::string& text, std::string_view needle) {
+    std::size_t found = 0;
+    for(auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+TEST_SUITE(ipc_diagnostics) {
+
+TEST_CASE(identical_publishes_are_dropped) {
+    auto transport = std::make_unique<ScriptedTransport>(std::vector<std::string>{},
+                                                         ScriptedTransport::WriteHook{});
+    auto* tp = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    auto publisher_task = [&]() -> task<> {
+        DiagnosticsPublisher publisher(peer, std::chrono::milliseconds::zero(), loop);
+        EXPECT_TRUE(publisher.publish(diagnostics("file:///a.cpp", "first")).has_value());
+        EXPECT_TRUE(publisher.publish(diagnostics("file:///a.cpp", "first")).has_value());
+        EXPECT_TRUE(publisher.publish(diagnostics("file:///a.cpp", "second")).has_value());
+
+        publisher.forget("file:///a.cpp");
+        EXPECT_TRUE(publisher.publish(diagnostics("file:///a.cpp", "second")).has_value());
+        tp->close();
+        co_return;
+    };
+
+    auto task = publisher_task();
+    loop.schedule(peer.run());
+    loop.schedule(task);
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(tp->outgoing().size(), 3U);
+    EXPECT_TRUE(tp->outgoing()[0].find(R"("message":"first")") != std::string::npos);
+    EXPECT_TRUE(tp->outgoing()[1].find(R"("message":"second")") != std::string::npos);
+    EXPECT_TRUE(tp->outgoing()[2].find(R"("message":"second")") != std::string::npos);
+}
+
+TEST_CASE(window_coalesces_into_one_batch) {
+    auto transport = std::make_unique<ScriptedTransport>(std::vector<std::string>{},
+                                                         ScriptedTransport::WriteHook{});
+    auto* tp = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    auto publisher_task = [&]() -> task<> {
+        DiagnosticsPublisher publisher(peer, std::chrono::milliseconds(20), loop);
+        publisher.publish(diagnostics("file:///a.cpp", "a1"));
+        publisher.publish(diagnostics("file:///b.cpp", "b1"));
+        publisher.publish(diagnostics("file:///a.cpp", "a2"));
+        EXPECT_EQ(publisher.pending(), 2U);
+        EXPECT_TRUE(tp->outgoing().empty());
+
+        co_await after(std::chrono::milliseconds(50), loop);
+        EXPECT_EQ(publisher.pending(), 0U);
+
+        // Unchanged since the batch went out.
+        publisher.publish(diagnostics("file:///b.cpp", "b1"));
+        EXPECT_EQ(publisher.pending(), 0U);
+        tp->close();
+    };
+
+    auto task = publisher_task();
+    loop.schedule(peer.run());
+    loop.schedule(task);
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(tp->outgoing().size(), 1U);
+    auto& batch = tp->outgoing()[0];
+    EXPECT_EQ(count(batch, "textDocument/publishDiagnostics"), 2U);
+    EXPECT_TRUE(batch.find(R"("message":"a2")") != std::string::npos);
+    EXPECT_TRUE(batch.find(R"("message":"a1")") == std::string::npos);
+}
+
+};  // TEST_SUITE(ipc_diagnostics)
+
+}  // namespace
+}  // namespace kota::ipc
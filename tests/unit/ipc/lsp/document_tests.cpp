@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/ipc/lsp/document.h"
+
+namespace kota::ipc::lsp {
+namespace {
+
+protocol::TextDocumentContentChangeEvent replace(std::uint32_t start_line,
+                                                 std::uint32_t start_character,
+                                                 std::uint32_t end_line,
+                                                 std::uint32_t end_character,
+                                                 std::string text) {
+    return protocol::TextDocumentContentChangePartial{
+        .range = {.start = {.line = start_line, .character = start_character},
+                  .end = {.line = end_line, .character = end_character}},
+        .text = std::move(text),
+    };
+}
+
+/// Checks the document's positions against an index built from scratch,
+/// at every offset that starts a code point.
+void expect_fresh_index(const TextDocument& document) {
+    const auto text = document.text().str();
+    PositionMapper fresh(text, PositionEncoding::UTF16);
+    auto& kept = document.positions();
+    for(std::uint32_t offset = 0; offset <= text.size(); ++offset) {
+        if(offset < text.size() && (static_cast<unsigned char>(text[offset]) & 0xC0u) == 0x80u) {
+            continue;
+        }
+        auto position = fresh.to_position(offset);
+        EXPECT_EQ(kept.to_position(offset), position);
+        ASSERT_TRUE(position.has_value());
+        EXPECT_EQ(kept.to_offset(*position), std::optional<std::uint32_t>(offset));
+    }
+}
+
+TEST_SUITE(language_document) {
+
+TEST_CASE(ranged_changes) {
+    TextDocument document("int a;\nint b;\nint c;\n", PositionEncoding::UTF16);
+
+    std::vector<protocol::TextDocumentContentChangeEvent> changes = {
+        // Join the first two lines.
+        replace(0, 6, 1, 0, " "),
+        // Split the last line in two, inserting a non-ASCII identifier.
+        replace(1, 4, 1, 5, "\xe4\xbd\xa0\nx"),
+        // Append at the very end.
+        replace(3, 0, 3, 0, "// end"),
+    };
+    ASSERT_TRUE(document.apply(changes));
+    EXPECT_EQ(document.text(), "int a; int b;\nint \xe4\xbd\xa0\nx;\n// end");
+    expect_fresh_index(document);
+
+    auto offset = document.positions().to_offset({.line = 2, .character = 1});
+    ASSERT_TRUE(offset.has_value());
+    EXPECT_EQ(document.text().at(*offset), ';');
+}
+
+TEST_CASE(whole_document_change) {
+    TextDocument document("one\ntwo\n", PositionEncoding::UTF16);
+    protocol::TextDocumentContentChangeEvent change =
+        protocol::TextDocumentContentChangeWholeDocument{.text = "a\nb\nc"};
+    ASSERT_TRUE(document.apply(change));
+    EXPECT_EQ(document.text(), "a\nb\nc");
+    expect_fresh_index(document);
+}
+
+TEST_CASE(out_of_range_change) {
+    TextDocument document("abc\n", PositionEncoding::UTF16);
+    EXPECT_FALSE(document.apply(replace(5, 0, 5, 0, "x")));
+    EXPECT_FALSE(document.apply(replace(0, 2, 0, 1, "x")));
+    EXPECT_EQ(document.text(), "abc\n");
+}
+
+TEST_CASE(edits_across_chunks) {
+    // Long enough to span many rope chunks.
+    std::string expected;
+    for(int line = 0; line < 2000; ++line) {
+        expected += "line " + std::to_string(line) + " \xf0\x9f\x98\x80 text\n";
+    }
+    TextDocument document(expected, PositionEncoding::UTF16);
+
+    auto boundary = [&](std::size_t offset) {
+        while(offset < expected.size() &&
+              (static_cast<unsigned char>(expected[offset]) & 0xC0u) == 0x80u) {
+            --offset;
+        }
+        return static_cast<std::uint32_t>(offset);
+    };
+
+    const std::string inserts[] = {"", "\n", "\xc3\xa9", "x\ny\xf0\x9f\x98\x80"};
+    std::mt19937 random(7);
+    for(int round = 0; round < 300; ++round) {
+        PositionMapper model(expected, PositionEncoding::UTF16);
+        auto begin = boundary(random() % (expected.size() + 1));
+        auto end = boundary(std::min<std::size_t>(begin + random() % 64, expected.size()));
+        auto start = *model.to_position(begin);
+        auto stop = *model.to_position(end);
+        const auto& text = inserts[random() % 4];
+
+        ASSERT_TRUE(
+            document.apply(replace(start.line, start.character, stop.line, stop.character, text)));
+        expected.replace(begin, end - begin, text);
+    }
+    EXPECT_TRUE(document.text() == expected);
+    expect_fresh_index(document);
+}
+
+TEST_CASE(surrogate_pairs) {
+    TextDocument document("a\xf0\x9f\x98\x80"
+                          "b",
+                          PositionEncoding::UTF16);
+    auto& positions = document.positions();
+    EXPECT_EQ(positions.to_offset({.line = 0, .character = 1}), std::optional<std::uint32_t>(1));
+    EXPECT_EQ(positions.to_offset({.line = 0, .character = 2}), std::nullopt);
+    EXPECT_EQ(positions.to_offset({.line = 0, .character = 3}), std::optional<std::uint32_t>(5));
+    EXPECT_EQ(positions.to_offset({.line = 0, .character = 5}), std::nullopt);
+    EXPECT_EQ(positions.length(0, 0, 6), 4U);
+}
+
+TEST_CASE(failed_batch_leaves_document) {
+    TextDocument document("abc\n", PositionEncoding::UTF16);
+    std::vector<protocol::TextDocumentContentChangeEvent> changes = {
+        replace(0, 0, 0, 1, "x"),
+        replace(9, 0, 9, 0, "y"),
+    };
+    EXPECT_FALSE(document.apply(changes));
+    EXPECT_EQ(document.text(), "abc\n");
+    expect_fresh_index(document);
+}
+
+TEST_CASE(store_snapshots) {
+    DocumentStore store(PositionEncoding::UTF16);
+    auto opened = store.open({.uri = "file:///a.cpp", .version = 1, .text = "int a;\n"});
+    ASSERT_TRUE(static_cast<bool>(opened));
+    EXPECT_EQ(std::string_view(opened.uri()), "file:///a.cpp");
+    EXPECT_EQ(opened.version(), 1);
+
+    // Taking a snapshot again before an edit shares the same state.
+    auto again = store.snapshot("file:///a.cpp");
+    EXPECT_EQ(&again.text(), &opened.text());
+
+    protocol::DidChangeTextDocumentParams change{
+        .text_document = {.uri = "file:///a.cpp", .version = 2},
+        .content_changes = {replace(0, 4, 0, 5, "b")},
+    };
+    ASSERT_TRUE(store.change(change));
+
+    auto changed = store.snapshot("file:///a.cpp");
+    EXPECT_EQ(changed.version(), 2);
+    EXPECT_EQ(changed.text(), "int b;\n");
+    EXPECT_EQ(opened.text(), "int a;\n");
+    EXPECT_EQ(opened.positions().to_offset({.line = 0, .character = 4}),
+              std::optional<std::uint32_t>(4));
+
+    change.content_changes = {replace(5, 0, 5, 0, "x")};
+    EXPECT_FALSE(store.change(change));
+    EXPECT_EQ(store.snapshot("file:///a.cpp").text(), "int b;\n");
+
+    store.close("file:///a.cpp");
+    EXPECT_EQ(store.size(), 0U);
+    EXPECT_FALSE(static_cast<bool>(store.snapshot("file:///a.cpp")));
+    EXPECT_EQ(changed.text(), "int b;\n");
+}
+
+};  // TEST_SUITE(language_document)
+
+}  // namespace
+}  // namespace kota::ipc::lsp
@@ -125,7 +125,7 @@ TEST_CASE(traits_dispatch_order) {
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 5);
 }
@@ -162,7 +162,7 @@ TEST_CASE(explicit_method) {
     ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 2);
+    EXPECT_EQ(response->id.as_integer(), 2);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 15);
 }
@@ -198,7 +198,7 @@ TEST_CASE(request_notify_apis) {
     peer.on_request([&](JsonPeer::RequestContext& context,
                         const AddParams& params) -> RequestResult<AddParams> {
         request_method = std::string(context.method);
-        request_id = static_cast<protocol::integer>(std::get<std::int64_t>(context.id));
+        request_id = static_cast<protocol::integer>(context.id.as_integer());
 
         co_await or_fail(
             context->send_notification("client/note/context", CustomNoteParams{.text = "context"}));
@@ -243,7 +243,7 @@ TEST_CASE(request_notify_apis) {
     auto request_from_context = codec::json::from_json<Request>(outgoing[2]);
     ASSERT_TRUE(request_from_context.has_value());
     EXPECT_EQ(request_from_context->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(request_from_context->id), 1);
+    EXPECT_EQ(request_from_context->id.as_integer(), 1);
     EXPECT_EQ(request_from_context->method, "client/add/context");
     EXPECT_EQ(request_from_context->params.a, 2);
     EXPECT_EQ(request_from_context->params.b, 3);
@@ -251,7 +251,7 @@ TEST_CASE(request_notify_apis) {
     auto request_from_server = codec::json::from_json<Request>(outgoing[3]);
     ASSERT_TRUE(request_from_server.has_value());
     EXPECT_EQ(request_from_server->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(request_from_server->id), 2);
+    EXPECT_EQ(request_from_server->id.as_integer(), 2);
     EXPECT_EQ(request_from_server->method, "client/add/server");
     EXPECT_EQ(request_from_server->params.a, 3);
     EXPECT_EQ(request_from_server->params.b, 1);
@@ -259,7 +259,7 @@ TEST_CASE(request_notify_apis) {
     auto final_response = codec::json::from_json<Response>(outgoing[4]);
     ASSERT_TRUE(final_response.has_value());
     EXPECT_EQ(final_response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(final_response->id), 7);
+    EXPECT_EQ(final_response->id.as_integer(), 7);
     ASSERT_TRUE(final_response->result.has_value());
     EXPECT_EQ(final_response->result->sum, 13);
 }
@@ -1,4 +1,6 @@
 #include <cstdint>
+#include <optional>
+#include <string>
 
 #include "kota/zest/zest.h"
 #include "kota/ipc/lsp/position.h"
@@ -275,6 +277,76 @@ TEST_CASE(to_offset_character_out_of_range) {
     }
 }
 
+TEST_CASE(long_lines_past_chunks) {
+    // Newlines and a non-ASCII code point well past the first 16 bytes, so
+    // the chunked scans meet them mid-run.
+    std::string content(40, 'a');
+    content += "\n";
+    content += std::string(20, 'b') + "\xf0\x9f\x99\x82" + std::string(20, 'c');
+    content += "\n" + std::string(33, 'd');
+
+    PositionMapper converter(content, PositionEncoding::UTF16);
+    EXPECT_EQ(converter.line_start(1), 41U);
+    EXPECT_EQ(converter.line_start(2), 41U + 44U + 1U);
+    EXPECT_EQ(converter.character(0, 40), 40U);
+    EXPECT_EQ(converter.character(1, 44), 42U);
+    EXPECT_EQ(converter.measure(content), 40U + 1U + 42U + 1U + 33U);
+
+    auto offset = converter.to_offset({.line = 1, .character = 22});
+    ASSERT_TRUE(offset.has_value());
+    EXPECT_EQ(*offset, 41U + 24U);
+}
+
+TEST_CASE(apply_edit_lines) {
+    std::string content = "ab\ncd\nef";
+    PositionMapper converter(content, PositionEncoding::UTF16);
+
+    // Replace "b\nc" with a non-ASCII line break pair.
+    content.replace(1, 3, "\xe4\xbd\xa0\nx\ny");
+    converter.apply_edit(content, 1, 4, "\xe4\xbd\xa0\nx\ny");
+
+    PositionMapper fresh(content, PositionEncoding::UTF16);
+    for(std::uint32_t offset = 0; offset <= content.size(); ++offset) {
+        EXPECT_EQ(converter.to_position(offset), fresh.to_position(offset));
+    }
+    EXPECT_EQ(converter.character(0, 4), 2U);
+
+    // Removing the non-ASCII code point makes its line ASCII again.
+    content.replace(1, 3, "");
+    converter.apply_edit(content, 1, 4, "");
+    EXPECT_EQ(converter.character(0, 1), 1U);
+    EXPECT_EQ(converter.line_start(3), 7U);
+}
+
+TEST_CASE(rope_matches_string) {
+    std::string_view content = "a\xe4\xbd\xa0" "b\nx\xf0\x9f\x99\x82" "y\n\nend";
+    kota::rope text(content);
+    constexpr std::uint32_t offsets[] = {0, 1, 4, 5, 6, 7, 11, 12, 13, 14, 17};
+
+    for(auto encoding: {PositionEncoding::UTF8, PositionEncoding::UTF16, PositionEncoding::UTF32}) {
+        PositionMapper expected(content, encoding);
+        PositionMapper converter(text, encoding);
+        for(auto offset: offsets) {
+            auto position = converter.to_position(offset);
+            auto reference = expected.to_position(offset);
+            ASSERT_TRUE(position.has_value() && reference.has_value());
+            EXPECT_EQ(position->line, reference->line);
+            EXPECT_EQ(position->character, reference->character);
+            EXPECT_EQ(converter.to_offset(*position), expected.to_offset(*reference));
+        }
+        EXPECT_EQ(converter.line_end_exclusive(1), expected.line_end_exclusive(1));
+        EXPECT_EQ(converter.length(1, 0, 6), expected.length(1, 0, 6));
+        EXPECT_FALSE(converter.to_offset({.line = 1, .character = 9}).has_value());
+        EXPECT_FALSE(converter.to_offset({.line = 4, .character = 0}).has_value());
+    }
+
+    // The mapper reads the rope as it is now.
+    PositionMapper converter(text, PositionEncoding::UTF16);
+    text.insert(0, "\n");
+    EXPECT_EQ(converter.line_start(1), 1U);
+    EXPECT_EQ(converter.to_offset({.line = 4, .character = 3}), std::optional<std::uint32_t>(18));
+}
+
 };  // TEST_SUITE(language_position)
 
 }  // namespace
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <string>
 #include <utility>
 #include <vector>
@@ -91,6 +92,40 @@ TEST_CASE(begin_report_end) {
     EXPECT_TRUE(tp->outgoing()[3].find(R"("kind":"end")") != std::string::npos);
 }
 
+TEST_CASE(throttled_reports) {
+    auto transport = std::make_unique<ScriptedTransport>(std::vector<std::string>{},
+                                                         ScriptedTransport::WriteHook{});
+    auto* tp = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    auto requester = [&]() -> task<> {
+        ProgressReporter reporter(peer, protocol::ProgressToken(7), std::chrono::hours(1));
+        reporter.begin("Indexing");
+        reporter.report("a.cpp", protocol::uinteger(10));
+        reporter.report("b.cpp", protocol::uinteger(20), false);
+        reporter.report({}, protocol::uinteger(30));
+        reporter.end("Complete");
+        tp->close();
+        co_return;
+    };
+
+    auto req_task = requester();
+    loop.schedule(peer.run());
+    loop.schedule(req_task);
+    EXPECT_EQ(loop.run(), 0);
+
+    // begin, then the three reports as one, sent ahead of end.
+    ASSERT_EQ(tp->outgoing().size(), 3U);
+    auto& report = tp->outgoing()[1];
+    EXPECT_TRUE(report.find(R"("kind":"report")") != std::string::npos);
+    EXPECT_TRUE(report.find(R"("message":"b.cpp")") != std::string::npos);
+    EXPECT_TRUE(report.find(R"("percentage":30)") != std::string::npos);
+    EXPECT_TRUE(report.find(R"("cancellable":false)") != std::string::npos);
+    EXPECT_TRUE(tp->outgoing()[2].find(R"("kind":"end")") != std::string::npos);
+}
+
 TEST_CASE(string_token) {
     auto hook = [](std::string_view payload, ScriptedTransport& t) {
         if(payload.find(R"("method":"window/workDoneProgress/create")") != std::string_view::npos) {
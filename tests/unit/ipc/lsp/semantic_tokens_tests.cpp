@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/ipc/lsp/semantic_tokens.h"
+
+namespace kota::ipc::lsp {
+namespace {
+
+using tokens_t = std::vector<protocol::uinteger>;
+
+TEST_SUITE(language_semantic_tokens) {
+
+TEST_CASE(relative_encoding) {
+    std::string_view content = "int x;\n  int y;\n";
+    PositionMapper mapper(content, PositionEncoding::UTF16);
+    SemanticTokensBuilder builder(mapper);
+
+    builder.add(0, 3, 1);
+    builder.add(4, 5, 2, 1);
+    builder.add(9, 12, 1);
+    builder.add(13, 14, 2);
+    ASSERT_EQ(builder.size(), 4U);
+
+    EXPECT_EQ(builder.build(),
+              tokens_t({0, 0, 3, 1, 0, 0, 4, 1, 2, 1, 1, 2, 3, 1, 0, 0, 4, 1, 2, 0}));
+    EXPECT_EQ(builder.size(), 0U);
+}
+
+TEST_CASE(out_of_order_and_utf16) {
+    std::string_view content = "\xe4\xbd\xa0 a\nb";
+    PositionMapper mapper(content, PositionEncoding::UTF16);
+    SemanticTokensBuilder builder(mapper);
+
+    builder.add(6, 7, 3);
+    builder.add(4, 5, 2);
+    builder.add(0, 3, 1);
+
+    EXPECT_EQ(builder.build(), tokens_t({0, 0, 1, 1, 0, 0, 2, 1, 2, 0, 1, 0, 1, 3, 0}));
+}
+
+TEST_CASE(multiline_token_is_split) {
+    std::string_view content = "/* a\nbc */";
+    PositionMapper mapper(content, PositionEncoding::UTF16);
+    SemanticTokensBuilder builder(mapper);
+
+    builder.add(0, 10, 4);
+    EXPECT_EQ(builder.build(), tokens_t({0, 0, 4, 4, 0, 1, 0, 5, 4, 0}));
+}
+
+TEST_CASE(diff_single_edit) {
+    tokens_t previous{0, 0, 3, 1, 0, 1, 2, 3, 1, 0, 1, 0, 1, 2, 0};
+    tokens_t current{0, 0, 3, 1, 0, 1, 4, 3, 1, 0, 0, 5, 2, 2, 0, 1, 0, 1, 2, 0};
+
+    auto edits = diff_semantic_tokens(previous, current);
+    ASSERT_EQ(edits.size(), 1U);
+    EXPECT_EQ(edits[0].start, 5U);
+    EXPECT_EQ(edits[0].delete_count, 5U);
+    ASSERT_TRUE(edits[0].data.has_value());
+    EXPECT_EQ(*edits[0].data, tokens_t({1, 4, 3, 1, 0, 0, 5, 2, 2, 0}));
+
+    EXPECT_TRUE(diff_semantic_tokens(previous, previous).empty());
+
+    auto cleared = diff_semantic_tokens(previous, {});
+    ASSERT_EQ(cleared.size(), 1U);
+    EXPECT_EQ(cleared[0].start, 0U);
+    EXPECT_EQ(cleared[0].delete_count, 15U);
+    EXPECT_FALSE(cleared[0].data.has_value());
+}
+
+TEST_CASE(cache_answers_with_delta) {
+    SemanticTokensCache cache;
+    auto first = cache.full({0, 0, 3, 1, 0});
+    ASSERT_TRUE(first.result_id.has_value());
+
+    auto second = cache.delta(*first.result_id, {0, 0, 3, 1, 0, 1, 0, 2, 2, 0});
+    ASSERT_TRUE(std::holds_alternative<protocol::SemanticTokensDelta>(second));
+    auto& delta = std::get<protocol::SemanticTokensDelta>(second);
+    ASSERT_EQ(delta.edits.size(), 1U);
+    EXPECT_EQ(delta.edits[0].start, 5U);
+    EXPECT_EQ(delta.edits[0].delete_count, 0U);
+    ASSERT_TRUE(delta.result_id.has_value());
+    EXPECT_NE(*delta.result_id, *first.result_id);
+
+    // A stale id gets the full tokens back.
+    auto third = cache.delta(*first.result_id, {0, 0, 1, 1, 0});
+    ASSERT_TRUE(std::holds_alternative<protocol::SemanticTokens>(third));
+    EXPECT_EQ(std::get<protocol::SemanticTokens>(third).data, tokens_t({0, 0, 1, 1, 0}));
+}
+
+};  // TEST_SUITE(language_semantic_tokens)
+
+}  // namespace
+}  // namespace kota::ipc::lsp
@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "kota/zest/zest.h"
+#include "kota/codec/json/deserializer.h"
+#include "kota/codec/json/serializer.h"
+#include "kota/ipc/lsp/ts.h"
+
+namespace kota::ipc::lsp {
+namespace {
+
+TEST_SUITE(lsp_any) {
+
+TEST_CASE(object_keeps_insertion_order) {
+    protocol::LSPObject object;
+    object["b"] = std::int64_t(1);
+    object["a"] = true;
+    object.insert_or_assign("b", std::string("x"));
+
+    ASSERT_EQ(object.size(), 2U);
+    EXPECT_EQ(object.begin()->first, "b");
+    EXPECT_EQ(std::get<std::string>(object["b"]), "x");
+    EXPECT_TRUE(object.contains("a"));
+    EXPECT_EQ(object.erase("a"), 1U);
+    EXPECT_FALSE(object.contains("a"));
+}
+
+TEST_CASE(round_trip) {
+    constexpr std::string_view json = R"({"b":1,"a":[true,null,"s"],"c":{"d":2.5}})";
+
+    auto value = codec::json::from_json<protocol::LSPAny>(json);
+    ASSERT_TRUE(value.has_value());
+
+    auto& object = std::get<protocol::LSPObject>(*value);
+    ASSERT_EQ(object.size(), 3U);
+    EXPECT_EQ(object.begin()->first, "b");
+    EXPECT_EQ(std::get<protocol::LSPArray>(object["a"]).size(), 3U);
+
+    auto text = codec::json::to_json(*value);
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text, json);
+}
+
+};  // TEST_SUITE(lsp_any)
+
+}  // namespace
+}  // namespace kota::ipc::lsp
@@ -60,6 +60,28 @@ TEST_CASE(decode_invalid_input) {
     EXPECT_FALSE(URI::percent_decode("%GG").has_value());
 }
 
+TEST_CASE(percent_into_buffer) {
+    std::string buffer = "file://";
+    const std::string long_path(100, 'x');
+    URI::percent_encode_to("/" + long_path + "/a b#1", buffer);
+    EXPECT_EQ(buffer, "file:///" + long_path + "/a%20b%231");
+
+    buffer.clear();
+    URI::percent_encode_to("one/two", buffer, true);
+    EXPECT_EQ(buffer, "one%2Ftwo");
+
+    buffer = "> ";
+    ASSERT_TRUE(URI::percent_decode_to(long_path + "%2Fa%20b", buffer).has_value());
+    EXPECT_EQ(buffer, "> " + long_path + "/a b");
+
+    // A failed decode leaves the buffer as it was.
+    buffer = "kept";
+    EXPECT_FALSE(URI::percent_decode_to("a%20b%G", buffer).has_value());
+    EXPECT_EQ(buffer, "kept");
+    EXPECT_FALSE(URI::percent_decode_to(long_path + "%2", buffer).has_value());
+    EXPECT_EQ(buffer, "kept");
+}
+
 TEST_CASE(file_path_roundtrip) {
     auto uri = URI::from_file_path("/tmp/a b.txt");
     ASSERT_TRUE(uri.has_value());
@@ -156,6 +178,34 @@ TEST_CASE(non_file_path_fails) {
     EXPECT_FALSE(uri->file_path().has_value());
 }
 
+TEST_CASE(table_interns) {
+    URITable table;
+
+    auto first = table.intern("file:///tmp/a.cpp");
+    ASSERT_TRUE(first.has_value());
+    // Spellings that normalize alike share the id.
+    auto shouted = table.intern("FILE:///tmp/a.cpp");
+    ASSERT_TRUE(shouted.has_value());
+    EXPECT_EQ(*shouted, *first);
+
+    auto path = table.intern_file_path("/tmp/a.cpp");
+    ASSERT_TRUE(path.has_value());
+    EXPECT_EQ(*path, *first);
+
+    auto other = table.intern("file:///tmp/b.cpp");
+    ASSERT_TRUE(other.has_value());
+    EXPECT_NE(*other, *first);
+
+    EXPECT_EQ(table.size(), 2U);
+    EXPECT_EQ(table.str(*first), "file:///tmp/a.cpp");
+    EXPECT_EQ(table.uri(*other).path(), "/tmp/b.cpp");
+    EXPECT_EQ(table.find("FILE:///tmp/a.cpp"), std::optional<URITable::ID>(*first));
+    EXPECT_FALSE(table.find("file:///tmp/c.cpp").has_value());
+
+    EXPECT_FALSE(table.intern("noscheme").has_value());
+    EXPECT_EQ(table.size(), 2U);
+}
+
 };  // TEST_SUITE(language_uri)
 
 }  // namespace
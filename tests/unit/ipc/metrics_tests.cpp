@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <string>
+
+#include "kota/ipc/metrics.h"
+#include "kota/zest/zest.h"
+
+namespace kota::ipc {
+namespace {
+
+TEST_SUITE(ipc_metrics) {
+
+TEST_CASE(histogram_percentiles) {
+    Histogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0U);
+
+    for(std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 1000U);
+    EXPECT_EQ(histogram.sum(), 500500U);
+    EXPECT_EQ(histogram.max(), 1000U);
+
+    // Each answer is the top of a bucket at most 12.5% above the true value.
+    auto p50 = histogram.percentile(0.5);
+    EXPECT_TRUE(p50 >= 500 && p50 <= 500 + 500 / 8);
+    auto p99 = histogram.percentile(0.99);
+    EXPECT_TRUE(p99 >= 990 && p99 <= 1000);
+    EXPECT_EQ(histogram.percentile(1.0), 1000U);
+
+    histogram.record(UINT64_MAX);
+    EXPECT_EQ(histogram.percentile(1.0), UINT64_MAX);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0U);
+    EXPECT_EQ(histogram.percentile(0.5), 0U);
+}
+
+TEST_CASE(small_values_exact) {
+    Histogram histogram;
+    for(std::uint64_t value: {0, 1, 2, 3, 4, 5, 6, 7}) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.percentile(0.125), 0U);
+    EXPECT_EQ(histogram.percentile(0.5), 3U);
+    EXPECT_EQ(histogram.percentile(1.0), 7U);
+}
+
+TEST_CASE(prometheus_labels) {
+    PeerMetrics metrics;
+    auto& entry = metrics.method("odd\"method\\");
+    entry.requests.fetch_add(3);
+    entry.in_flight.fetch_add(1);
+    entry.handler_ns.record(2'000'000);
+
+    EXPECT_TRUE(metrics.find("odd\"method\\") == &entry);
+    EXPECT_TRUE(metrics.find("other") == nullptr);
+
+    auto text = metrics.to_prometheus("lsp");
+    EXPECT_TRUE(text.contains("lsp_requests_total{method=\"odd\\\"method\\\\\"} 3\n"));
+    EXPECT_TRUE(text.contains("# TYPE lsp_in_flight gauge\n"));
+    EXPECT_TRUE(text.contains("lsp_in_flight{method=\"odd\\\"method\\\\\"} 1\n"));
+    EXPECT_TRUE(text.contains("# TYPE lsp_handler_seconds summary\n"));
+    EXPECT_TRUE(text.contains("lsp_handler_seconds_count{method=\"odd\\\"method\\\\\"} 1\n"));
+}
+
+};  // TEST_SUITE(ipc_metrics)
+
+}  // namespace
+}  // namespace kota::ipc
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "peer_test_types.h"
+#include "../async/loop_fixture.h"
+#include "kota/zest/zest.h"
+#include "kota/async/async.h"
+
+namespace kota::ipc {
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+TEST_SUITE(ipc_bench, loop_fixture) {
+
+BENCH(request_round_trip) {
+    int to_server[2] = {-1, -1};
+    int to_client[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(to_server), 0);
+    ASSERT_EQ(create_pipe(to_client), 0);
+
+    auto server_input = pipe::open(to_server[0], pipe::options{}, loop);
+    auto server_output = pipe::open(to_client[1], pipe::options{}, loop);
+    auto client_input = pipe::open(to_client[0], pipe::options{}, loop);
+    auto client_output = pipe::open(to_server[1], pipe::options{}, loop);
+    ASSERT_TRUE(server_input.has_value() && server_output.has_value());
+    ASSERT_TRUE(client_input.has_value() && client_output.has_value());
+
+    JsonPeer server(loop,
+                    std::make_unique<StreamTransport>(stream(std::move(*server_input)),
+                                                      stream(std::move(*server_output))));
+    JsonPeer client(loop,
+                    std::make_unique<StreamTransport>(stream(std::move(*client_input)),
+                                                      stream(std::move(*client_output))));
+
+    server.on_request([](RequestContext&, const AddParams& params) -> RequestResult<AddParams> {
+        co_return AddResult{.sum = params.a + params.b};
+    });
+
+    loop.schedule(server.run());
+    loop.schedule(client.run());
+
+    bench.items(1);
+    bench_loop(bench, [&](std::uint64_t iterations) -> task<> {
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            const auto sent = bench_clock::now();
+            auto reply = co_await client.send_request(AddParams{.a = 2, .b = 3});
+            bench.record_latency(bench_clock::now() - sent);
+            if(!reply.has_value() || reply->sum != 5) {
+                zest::failure();
+                co_return;
+            }
+        }
+    });
+
+    // Closing both outputs ends both peers' reads, and with them run().
+    EXPECT_TRUE(client.close_output());
+    EXPECT_TRUE(server.close_output());
+    loop.run();
+}
+
+};  // TEST_SUITE(ipc_bench)
+
+}  // namespace
+
+}  // namespace kota::ipc
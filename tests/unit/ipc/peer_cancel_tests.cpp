@@ -1,3 +1,5 @@
+#include <string>
+
 #include "peer_test_types.h"
 #include "kota/zest/zest.h"
 
@@ -103,6 +105,42 @@ TEST_CASE(bad_cancel_params) {
     EXPECT_TRUE(transport_ptr->outgoing().empty());
 }
 
+// 4.6 A newer request with the same key cancels the one still running
+TEST_CASE(superseded_request) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":1}})",
+        R"({"jsonrpc":"2.0","id":2,"method":"test/add","params":{"a":7,"b":1}})",
+        R"({"jsonrpc":"2.0","id":3,"method":"test/add","params":{"a":1,"b":2}})",
+    });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    peer.on_request([&](RequestContext&, const AddParams& params) -> RequestResult<AddParams> {
+        co_await sleep(10, loop);
+        co_return AddResult{.sum = params.a + params.b};
+    });
+    peer.supersede_requests<AddParams>(
+        [](const AddParams& params) { return std::to_string(params.a); });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(transport_ptr->outgoing().size(), 3U);
+    auto cancelled = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
+    ASSERT_TRUE(cancelled.has_value());
+    EXPECT_EQ(cancelled->id.as_integer(), 1);
+    EXPECT_EQ(cancelled->error.code,
+              static_cast<protocol::integer>(protocol::ErrorCode::RequestCancelled));
+
+    for(std::size_t i = 1; i < 3; ++i) {
+        auto response = codec::json::from_json<Response>(transport_ptr->outgoing()[i]);
+        ASSERT_TRUE(response.has_value());
+        ASSERT_TRUE(response->result.has_value());
+    }
+}
+
 };  // TEST_SUITE(ipc_peer_cancel)
 
 }  // namespace
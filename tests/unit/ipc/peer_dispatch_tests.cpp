@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "peer_test_types.h"
 #include "kota/zest/zest.h"
 
@@ -26,7 +33,7 @@ TEST_CASE(unregistered_method) {
     ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::MethodNotFound));
 }
@@ -58,14 +65,14 @@ TEST_CASE(duplicate_request_id) {
     // (dispatched synchronously before the handler task runs)
     auto error = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing()[0]);
     ASSERT_TRUE(error.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(error->id), 1);
+    EXPECT_EQ(error->id.as_integer(), 1);
     EXPECT_EQ(error->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::InvalidRequest));
 
     // Second output: success response from the first handler
     auto success = codec::json::from_json<Response>(transport_ptr->outgoing()[1]);
     ASSERT_TRUE(success.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(success->id), 1);
+    EXPECT_EQ(success->id.as_integer(), 1);
     ASSERT_TRUE(success->result.has_value());
     EXPECT_EQ(success->result->sum, 3);
 }
@@ -139,11 +146,148 @@ TEST_CASE(mixed_sequence) {
     ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 30);
 }
 
+// 3.10 Requests over the in-flight limit wait for a running handler to finish
+TEST_CASE(in_flight_limit) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":0}})",
+        R"({"jsonrpc":"2.0","id":2,"method":"test/add","params":{"a":2,"b":0}})",
+        R"({"jsonrpc":"2.0","id":3,"method":"test/add","params":{"a":3,"b":0}})",
+        R"({"jsonrpc":"2.0","id":4,"method":"test/add","params":{"a":4,"b":0}})",
+    });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    peer.set_dispatch_options({.max_in_flight = 2, .max_queued = 1});
+
+    int running = 0;
+    int peak = 0;
+    peer.on_request([&](RequestContext&, const AddParams& params) -> RequestResult<AddParams> {
+        peak = std::max(peak, ++running);
+        co_await sleep(5, loop);
+        --running;
+        co_return AddResult{.sum = params.a + params.b};
+    });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    EXPECT_EQ(peak, 2);
+    ASSERT_EQ(transport_ptr->outgoing().size(), 4U);
+    std::int64_t total = 0;
+    for(auto& message: transport_ptr->outgoing()) {
+        auto response = codec::json::from_json<Response>(message);
+        ASSERT_TRUE(response.has_value());
+        ASSERT_TRUE(response->result.has_value());
+        total += response->result->sum;
+    }
+    EXPECT_EQ(total, 10);
+}
+
+// 3.11 Metrics count handled methods only
+TEST_CASE(metrics_recorded) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":2}})",
+        R"({"jsonrpc":"2.0","id":2,"method":"test/add","params":{"a":-1,"b":0}})",
+        R"({"jsonrpc":"2.0","method":"test/note","params":{"text":"counted"}})",
+        R"({"jsonrpc":"2.0","id":3,"method":"unknown/method","params":{}})",
+    });
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    auto metrics = std::make_shared<PeerMetrics>();
+    peer.set_metrics(metrics);
+
+    peer.on_request([](RequestContext&, const AddParams& params) -> RequestResult<AddParams> {
+        if(params.a < 0) {
+            co_await fail(protocol::ErrorCode::InvalidParams, "negative");
+        }
+        co_return AddResult{.sum = params.a + params.b};
+    });
+    peer.on_notification([](const NoteParams&) {});
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    EXPECT_EQ(metrics->methods(), (std::vector<std::string>{"test/add", "test/note"}));
+    EXPECT_TRUE(metrics->find("unknown/method") == nullptr);
+
+    const auto* add = metrics->find("test/add");
+    ASSERT_TRUE(add != nullptr);
+    EXPECT_EQ(add->requests.load(), 2U);
+    EXPECT_EQ(add->errors.load(), 1U);
+    EXPECT_EQ(add->in_flight.load(), 0);
+    EXPECT_EQ(add->handler_ns.count(), 2U);
+    EXPECT_EQ(add->decode_ns.count(), 2U);
+    EXPECT_EQ(add->response_bytes.count(), 1U);
+    EXPECT_TRUE(add->request_bytes.max() > 0);
+
+    const auto* note = metrics->find("test/note");
+    ASSERT_TRUE(note != nullptr);
+    EXPECT_EQ(note->notifications.load(), 1U);
+    EXPECT_EQ(note->requests.load(), 0U);
+
+    auto text = metrics->to_prometheus();
+    EXPECT_TRUE(text.contains("# TYPE kota_ipc_requests_total counter\n"));
+    EXPECT_TRUE(text.contains("kota_ipc_requests_total{method=\"test/add\"} 2\n"));
+    EXPECT_TRUE(text.contains("kota_ipc_handler_seconds_count{method=\"test/add\"} 2\n"));
+}
+
+// 3.12 Handlers given a pool run off the loop thread
+TEST_CASE(pooled_handler) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":2}})",
+        R"({"jsonrpc":"2.0","id":2,"method":"test/add","params":{"a":-1,"b":0}})",
+        R"({"jsonrpc":"2.0","id":3,"method":"test/add","params":{"a":"x"}})",
+    });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    thread_pool pool(2);
+
+    const auto loop_thread = std::this_thread::get_id();
+    std::atomic<int> off_loop = 0;
+    peer.on_request(pool, [&](const AddParams& params) -> Result<AddResult> {
+        if(std::this_thread::get_id() != loop_thread) {
+            off_loop.fetch_add(1);
+        }
+        if(params.a < 0) {
+            return outcome_error(Error(protocol::ErrorCode::InvalidParams, "negative"));
+        }
+        return AddResult{.sum = params.a + params.b};
+    });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    EXPECT_EQ(off_loop.load(), 2);
+    ASSERT_EQ(transport_ptr->outgoing().size(), 3U);
+    int succeeded = 0;
+    int failed = 0;
+    for(auto& message: transport_ptr->outgoing()) {
+        if(auto response = codec::json::from_json<Response>(message);
+           response.has_value() && response->result.has_value()) {
+            EXPECT_EQ(response->id.as_integer(), 1);
+            EXPECT_EQ(response->result->sum, 3);
+            ++succeeded;
+        } else {
+            auto error = codec::json::from_json<ErrorResponse>(message);
+            ASSERT_TRUE(error.has_value());
+            EXPECT_EQ(error->error.code,
+                      static_cast<protocol::integer>(protocol::ErrorCode::InvalidParams));
+            ++failed;
+        }
+    }
+    EXPECT_EQ(succeeded, 1);
+    EXPECT_EQ(failed, 2);
+}
+
 };  // TEST_SUITE(ipc_peer_dispatch)
 
 }  // namespace
@@ -1,4 +1,6 @@
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -184,6 +186,66 @@ TEST_CASE(read_loop_lifecycle) {
     EXPECT_TRUE(has_ended);
 }
 
+TEST_CASE(deferred_log_formats_off_thread) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":2}})",
+    });
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    // The sink runs on the log's thread; flush() orders it before the reads below.
+    LogEntries logs;
+    std::thread::id sink_thread;
+    DeferredLog log([&](LogLevel level, std::string msg) {
+        sink_thread = std::this_thread::get_id();
+        logs.push_back({level, std::move(msg)});
+    });
+    peer.set_logger(log, LogLevel::trace);
+
+    peer.on_request([&](RequestContext&, const AddParams& p) -> RequestResult<AddParams> {
+        co_return AddResult{.sum = p.a + p.b};
+    });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+    log.flush();
+
+    EXPECT_NE(sink_thread, std::this_thread::get_id());
+    EXPECT_EQ(log.dropped(), 0U);
+
+    bool has_recv = false;
+    bool has_send = false;
+    for(const auto& entry: logs) {
+        if(entry.level == LogLevel::trace && entry.message.starts_with("recv:")) {
+            has_recv = true;
+        }
+        if(entry.level == LogLevel::trace && entry.message.starts_with("send:")) {
+            has_send = true;
+        }
+    }
+    EXPECT_TRUE(has_recv);
+    EXPECT_TRUE(has_send);
+}
+
+TEST_CASE(deferred_log_copies_string_views) {
+    LogEntries logs;
+    DeferredLog log([&](LogLevel level, std::string msg) {
+        logs.push_back({level, std::move(msg)});
+    });
+
+    {
+        std::string method = "test/add";
+        log.push(LogLevel::debug, "request: {} id={}", std::string_view(method), 7);
+        method.assign("overwritten");
+    }
+    log.flush();
+
+    ASSERT_EQ(logs.size(), 1U);
+    EXPECT_EQ(logs[0].level, LogLevel::debug);
+    EXPECT_EQ(logs[0].message, "request: test/add id=7");
+}
+
 };  // TEST_SUITE(ipc_peer_logger)
 
 }  // namespace
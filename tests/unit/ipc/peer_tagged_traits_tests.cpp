@@ -27,7 +27,7 @@ TEST_CASE(tagged_request_handler) {
     ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 30);
 }
@@ -98,7 +98,7 @@ TEST_CASE(tagged_send_apis) {
 
     auto resp = codec::json::from_json<Response>(outgoing[2]);
     ASSERT_TRUE(resp.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(resp->id), 7);
+    EXPECT_EQ(resp->id.as_integer(), 7);
     ASSERT_TRUE(resp->result.has_value());
     EXPECT_EQ(resp->result->sum, 99);
 }
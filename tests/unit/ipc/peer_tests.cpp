@@ -1,4 +1,5 @@
 #include <chrono>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -91,7 +92,7 @@ TEST_CASE(traits_dispatch_order) {
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 5);
 }
@@ -169,14 +170,14 @@ TEST_CASE(peers_share_loop) {
     ASSERT_EQ(transport1_ptr->outgoing().size(), 1U);
     auto response1 = codec::json::from_json<Response>(transport1_ptr->outgoing().front());
     ASSERT_TRUE(response1.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response1->id), 11);
+    EXPECT_EQ(response1->id.as_integer(), 11);
     ASSERT_TRUE(response1->result.has_value());
     EXPECT_EQ(response1->result->sum, 7);
 
     ASSERT_EQ(transport2_ptr->outgoing().size(), 1U);
     auto response2 = codec::json::from_json<Response>(transport2_ptr->outgoing().front());
     ASSERT_TRUE(response2.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response2->id), 22);
+    EXPECT_EQ(response2->id.as_integer(), 22);
     ASSERT_TRUE(response2->result.has_value());
     EXPECT_EQ(response2->result->sum, 21);
 }
@@ -213,7 +214,7 @@ TEST_CASE(explicit_method) {
     ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 2);
+    EXPECT_EQ(response->id.as_integer(), 2);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 15);
 }
@@ -250,7 +251,7 @@ TEST_CASE(request_notify_apis) {
     peer.on_request([&](RequestContext& context,
                         const AddParams& params) -> RequestResult<AddParams> {
         request_method = std::string(context.method);
-        request_id = static_cast<protocol::integer>(std::get<std::int64_t>(context.id));
+        request_id = static_cast<protocol::integer>(context.id.as_integer());
 
         co_await or_fail(
             context->send_notification("client/note/context", CustomNoteParams{.text = "context"}));
@@ -295,7 +296,7 @@ TEST_CASE(request_notify_apis) {
     auto request_from_context = codec::json::from_json<Request>(outgoing[2]);
     ASSERT_TRUE(request_from_context.has_value());
     EXPECT_EQ(request_from_context->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(request_from_context->id), 1);
+    EXPECT_EQ(request_from_context->id.as_integer(), 1);
     EXPECT_EQ(request_from_context->method, "client/add/context");
     EXPECT_EQ(request_from_context->params.a, 2);
     EXPECT_EQ(request_from_context->params.b, 3);
@@ -303,7 +304,7 @@ TEST_CASE(request_notify_apis) {
     auto request_from_peer = codec::json::from_json<Request>(outgoing[3]);
     ASSERT_TRUE(request_from_peer.has_value());
     EXPECT_EQ(request_from_peer->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(request_from_peer->id), 2);
+    EXPECT_EQ(request_from_peer->id.as_integer(), 2);
     EXPECT_EQ(request_from_peer->method, "client/add/peer");
     EXPECT_EQ(request_from_peer->params.a, 3);
     EXPECT_EQ(request_from_peer->params.b, 1);
@@ -311,7 +312,7 @@ TEST_CASE(request_notify_apis) {
     auto final_response = codec::json::from_json<Response>(outgoing[4]);
     ASSERT_TRUE(final_response.has_value());
     EXPECT_EQ(final_response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(final_response->id), 7);
+    EXPECT_EQ(final_response->id.as_integer(), 7);
     ASSERT_TRUE(final_response->result.has_value());
     EXPECT_EQ(final_response->result->sum, 13);
 }
@@ -362,7 +363,7 @@ TEST_CASE(request_notify_apis_failure) {
     ASSERT_TRUE(final_response.has_value());
     EXPECT_NE(outgoing[1].find(R"("error")"), std::string::npos);
     EXPECT_EQ(final_response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(final_response->id), 7);
+    EXPECT_EQ(final_response->id.as_integer(), 7);
     EXPECT_EQ(final_response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::RequestFailed));
 }
@@ -387,7 +388,7 @@ TEST_CASE(request_error_code) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 10);
+    EXPECT_EQ(response->id.as_integer(), 10);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::InvalidParams));
     EXPECT_EQ(response->error.message, "forced invalid params");
@@ -418,7 +419,7 @@ TEST_CASE(request_error_data) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 12);
+    EXPECT_EQ(response->id.as_integer(), 12);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::InvalidParams));
     EXPECT_EQ(response->error.message, "forced invalid params");
@@ -546,7 +547,7 @@ TEST_CASE(bad_params_invalid) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 11);
+    EXPECT_EQ(response->id.as_integer(), 11);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::InvalidParams));
     EXPECT_FALSE(response->error.message.empty());
@@ -568,7 +569,7 @@ TEST_CASE(malformed_parse_null) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 0);
+    EXPECT_EQ(response->id.as_integer(), 0);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::ParseError));
     EXPECT_FALSE(response->error.message.empty());
@@ -590,7 +591,7 @@ TEST_CASE(invalid_request_null) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 0);
+    EXPECT_EQ(response->id.as_integer(), 0);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::InvalidRequest));
     EXPECT_EQ(response->error.message, "message must contain method or id");
@@ -643,7 +644,7 @@ TEST_CASE(cancel_inflight_request) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 21);
+    EXPECT_EQ(response->id.as_integer(), 21);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::RequestCancelled));
     EXPECT_EQ(response->error.message, "request cancelled");
@@ -692,7 +693,7 @@ TEST_CASE(cancel_running_handler) {
     auto response = codec::json::from_json<ErrorResponse>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 22);
+    EXPECT_EQ(response->id.as_integer(), 22);
     EXPECT_EQ(response->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::RequestCancelled));
     EXPECT_EQ(response->error.message, "request cancelled");
@@ -752,7 +753,7 @@ TEST_CASE(context_token_propagates) {
     auto nested_request = codec::json::from_json<Request>(outgoing[0]);
     ASSERT_TRUE(nested_request.has_value());
     EXPECT_EQ(nested_request->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(nested_request->id), 1);
+    EXPECT_EQ(nested_request->id.as_integer(), 1);
     EXPECT_EQ(nested_request->method, "client/add/context");
     EXPECT_EQ(nested_request->params.a, 4);
     EXPECT_EQ(nested_request->params.b, 5);
@@ -761,12 +762,12 @@ TEST_CASE(context_token_propagates) {
     ASSERT_TRUE(nested_cancel.has_value());
     EXPECT_EQ(nested_cancel->jsonrpc, "2.0");
     EXPECT_EQ(nested_cancel->method, "$/cancelRequest");
-    EXPECT_EQ(std::get<std::int64_t>(nested_cancel->params.id), 1);
+    EXPECT_EQ(nested_cancel->params.id.as_integer(), 1);
 
     auto final_error = codec::json::from_json<ErrorResponse>(outgoing[2]);
     ASSERT_TRUE(final_error.has_value());
     EXPECT_EQ(final_error->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(final_error->id), 31);
+    EXPECT_EQ(final_error->id.as_integer(), 31);
     EXPECT_EQ(final_error->error.code,
               static_cast<protocol::integer>(protocol::ErrorCode::RequestCancelled));
     EXPECT_EQ(final_error->error.message, "request cancelled");
@@ -818,14 +819,14 @@ TEST_CASE(outbound_cancel_request) {
     auto request = codec::json::from_json<Request>(outgoing[0]);
     ASSERT_TRUE(request.has_value());
     EXPECT_EQ(request->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(request->id), 1);
+    EXPECT_EQ(request->id.as_integer(), 1);
     EXPECT_EQ(request->method, "worker/build");
 
     auto cancel = codec::json::from_json<CancelNotification>(outgoing[1]);
     ASSERT_TRUE(cancel.has_value());
     EXPECT_EQ(cancel->jsonrpc, "2.0");
     EXPECT_EQ(cancel->method, "$/cancelRequest");
-    EXPECT_EQ(std::get<std::int64_t>(cancel->params.id), 1);
+    EXPECT_EQ(cancel->params.id.as_integer(), 1);
 }
 
 TEST_CASE(outbound_precancel) {
@@ -908,6 +909,43 @@ TEST_CASE(outbound_timeout_cancel) {
     EXPECT_EQ(cancel->method, "$/cancelRequest");
 }
 
+// A request whose caller stops waiting for it, here by losing a race, is
+// cancelled on the remote as well.
+TEST_CASE(outbound_abandoned_cancel) {
+    auto transport = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [](std::string_view payload, ScriptedTransport& channel) {
+            if(payload.find(R"("method":"$/cancelRequest")") != std::string_view::npos) {
+                channel.close();
+            }
+        });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    auto racer = [&]() -> task<> {
+        auto request = [&]() -> task<> {
+            (void)co_await peer.send_request<AddResult>("worker/build",
+                                                        CustomAddParams{.a = 4, .b = 5});
+        };
+        co_await when_any(request(), sleep(1, loop));
+    };
+
+    auto race_task = racer();
+    loop.schedule(peer.run());
+    loop.schedule(race_task);
+    EXPECT_EQ(loop.run(), 0);
+
+    const auto& outgoing = transport_ptr->outgoing();
+    ASSERT_EQ(outgoing.size(), 2U);
+
+    auto cancel = codec::json::from_json<CancelNotification>(outgoing[1]);
+    ASSERT_TRUE(cancel.has_value());
+    EXPECT_EQ(cancel->method, "$/cancelRequest");
+    EXPECT_EQ(cancel->params.id.as_integer(), 1);
+}
+
 TEST_CASE(zero_timeout_cancel) {
     auto transport = std::make_unique<ScriptedTransport>(std::vector<std::string>{}, nullptr);
     auto* transport_ptr = transport.get();
@@ -943,11 +981,9 @@ TEST_CASE(zero_timeout_cancel) {
     EXPECT_TRUE(transport_ptr->outgoing().empty());
 }
 
-// Verify that completing a request before its timeout doesn't leak the timer coroutine frame.
-// Before the fix, cancel_after_timeout held a shared_ptr<cancellation_source> in its coroutine
-// frame that was only released when the timer fired. If the request completed early and the peer
-// was closed, the timer task's coroutine frame (and its captured shared_ptrs) leaked.
-// ASan will catch this as a leak if the fix regresses.
+// Verify that completing a request before its timeout disarms the timeout. The deadline sits on
+// the loop's timer wheel, so a timeout left armed would fire into a destroyed source; ASan will
+// catch this if it regresses.
 TEST_CASE(timeout_timer_cleanup_on_early_completion) {
     auto transport = std::make_unique<ScriptedTransport>(
         std::vector<std::string>{},
@@ -979,6 +1015,180 @@ TEST_CASE(timeout_timer_cleanup_on_early_completion) {
     EXPECT_EQ(request_result->sum, 5);
 }
 
+// A request left outstanding while many later ones complete still gets its response
+TEST_CASE(many_pending_out_of_order) {
+    constexpr std::int64_t count = 40;
+    auto transport = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [](std::string_view payload, ScriptedTransport& channel) {
+            auto request = codec::json::from_json<Request>(payload);
+            if(!request.has_value()) {
+                return;
+            }
+
+            // The first request is answered last, long after later ids wrapped around it.
+            auto id = request->id.as_integer();
+            if(id == 1) {
+                return;
+            }
+            auto value = std::to_string(id);
+            channel.push_incoming(R"({"jsonrpc":"2.0","id":)" + value + R"(,"result":{"sum":)" +
+                                  value + "}}");
+            if(id == count) {
+                channel.push_incoming(R"({"jsonrpc":"2.0","id":1,"result":{"sum":1}})");
+            }
+        });
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    std::vector<Result<AddResult>> results;
+    for(std::int64_t i = 0; i < count; ++i) {
+        results.push_back(outcome_error(Error("request did not complete")));
+    }
+    std::int64_t remaining = count;
+
+    auto requester = [&](std::size_t index) -> task<> {
+        results[index] = co_await peer.send_request<AddResult>("worker/build",
+                                                               CustomAddParams{.a = 1, .b = 2});
+        if(--remaining == 0) {
+            peer.close();
+        }
+    };
+
+    std::vector<task<>> requests;
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        requests.push_back(requester(i));
+    }
+
+    loop.schedule(peer.run());
+    for(auto& request: requests) {
+        loop.schedule(request);
+    }
+    EXPECT_EQ(loop.run(), 0);
+
+    std::int64_t total = 0;
+    for(auto& result: results) {
+        ASSERT_TRUE(result.has_value());
+        total += result->sum;
+    }
+    EXPECT_EQ(total, count * (count + 1) / 2);
+}
+
+// Every message of an incoming batch is dispatched
+TEST_CASE(incoming_batch) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"([{"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":1,"b":2}},)"
+        R"({"jsonrpc":"2.0","method":"test/note","params":{"text":"batched"}}])",
+    });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    std::string note;
+
+    peer.on_request([](RequestContext&, const AddParams& params) -> RequestResult<AddParams> {
+        co_return AddResult{.sum = params.a + params.b};
+    });
+    peer.on_notification([&](const NoteParams& params) { note = params.text; });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    EXPECT_EQ(note, "batched");
+    ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
+    auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
+    ASSERT_TRUE(response.has_value());
+    ASSERT_TRUE(response->result.has_value());
+    EXPECT_EQ(response->result->sum, 3);
+}
+
+// Requests and notifications added to a Batch go out as one array
+TEST_CASE(outgoing_batch) {
+    auto transport = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [](std::string_view payload, ScriptedTransport& channel) {
+            if(payload.starts_with("[")) {
+                channel.push_incoming(R"([{"jsonrpc":"2.0","id":2,"result":{"sum":7}},)"
+                                      R"({"jsonrpc":"2.0","id":1,"result":{"sum":3}}])");
+            }
+        });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    Result<AddResult> first = outcome_error(Error("request did not complete"));
+    Result<AddResult> second = outcome_error(Error("request did not complete"));
+
+    auto requester = [&]() -> task<> {
+        auto batch = peer.batch();
+        auto first_task = batch.request<AddResult>("worker/build", CustomAddParams{.a = 1, .b = 2});
+        auto second_task = batch.request(AddParams{.a = 3, .b = 4});
+        EXPECT_TRUE(batch.notify(NoteParams{.text = "sent"}).has_value());
+        EXPECT_TRUE(batch.send().has_value());
+
+        first = co_await std::move(first_task);
+        second = co_await std::move(second_task);
+        peer.close();
+    };
+
+    auto request_task = requester();
+    loop.schedule(peer.run());
+    loop.schedule(request_task);
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(transport_ptr->outgoing().size(), 1U);
+    EXPECT_TRUE(transport_ptr->outgoing().front().starts_with("["));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->sum, 3);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->sum, 7);
+}
+
+// Queued messages go out by class, and a keyed notification replaces its
+// predecessor while that still waits
+TEST_CASE(outgoing_priority) {
+    auto transport = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [](std::string_view payload, ScriptedTransport& channel) {
+            if(payload.find(R"("method":"test/add")") != std::string_view::npos) {
+                channel.push_incoming(R"({"jsonrpc":"2.0","id":1,"result":{"sum":3}})");
+            }
+        });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    // Everything is queued before the writer first runs.
+    auto sender = [&]() -> task<> {
+        for(auto text: {"10%", "20%", "30%"}) {
+            EXPECT_TRUE(peer.send_notification("$/progress",
+                                               NoteParams{.text = text},
+                                               {.supersede_key = "token"})
+                            .has_value());
+        }
+        EXPECT_TRUE(
+            peer.send_notification("window/logMessage", NoteParams{.text = "log"}).has_value());
+        EXPECT_TRUE(peer.send_notification(NoteParams{.text = "note"}).has_value());
+        auto sum = co_await peer.send_request(AddParams{.a = 1, .b = 2});
+        EXPECT_TRUE(sum.has_value());
+        peer.close();
+    };
+
+    auto sender_task = sender();
+    loop.schedule(peer.run());
+    loop.schedule(sender_task);
+    EXPECT_EQ(loop.run(), 0);
+
+    auto& outgoing = transport_ptr->outgoing();
+    ASSERT_EQ(outgoing.size(), 4U);
+    EXPECT_TRUE(outgoing[0].find(R"("method":"test/add")") != std::string::npos);
+    EXPECT_TRUE(outgoing[1].find(R"("text":"note")") != std::string::npos);
+    EXPECT_TRUE(outgoing[2].find(R"("text":"30%")") != std::string::npos);
+    EXPECT_TRUE(outgoing[3].find(R"("text":"log")") != std::string::npos);
+}
+
 // Handler returning task<codec::RawValue, Error> instead of RequestResult<Params>
 TEST_CASE(raw_value_return) {
     auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
@@ -1002,11 +1212,45 @@ TEST_CASE(raw_value_return) {
     auto response = codec::json::from_json<Response>(transport_ptr->outgoing().front());
     ASSERT_TRUE(response.has_value());
     EXPECT_EQ(response->jsonrpc, "2.0");
-    EXPECT_EQ(std::get<std::int64_t>(response->id), 1);
+    EXPECT_EQ(response->id.as_integer(), 1);
     ASSERT_TRUE(response->result.has_value());
     EXPECT_EQ(response->result->sum, 30);
 }
 
+// Raw params reach handlers shared, so copying them for fan-out copies no text
+TEST_CASE(raw_value_params_are_shared) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","method":"test/raw","params":{"text":"hello"}})",
+    });
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+
+    std::vector<codec::RawValue> forwarded;
+    peer.on_notification("test/raw", [&](const codec::RawValue& params) {
+        forwarded.push_back(params);
+        forwarded.push_back(params);
+    });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(forwarded.size(), 2U);
+    EXPECT_EQ(forwarded[0].text(), R"({"text":"hello"})");
+    ASSERT_TRUE(forwarded[0].buffer != nullptr);
+    EXPECT_EQ(forwarded[0].buffer, forwarded[1].buffer);
+    EXPECT_EQ(forwarded[0].text().data(), forwarded[1].text().data());
+
+    auto encoded = codec::json::to_json(forwarded[1]);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(*encoded, R"({"text":"hello"})");
+
+    auto message = std::make_shared<const std::string>(R"({"params":[1,2]})");
+    auto slice = codec::RawValue::shared(message, std::string_view(*message).substr(10, 5));
+    EXPECT_EQ(slice.text(), "[1,2]");
+    EXPECT_EQ(message.use_count(), 2);
+}
+
 };  // TEST_SUITE(ipc_peer)
 
 // ============================================================================
@@ -1042,6 +1286,41 @@ TEST_CASE(request_params_result) {
     EXPECT_TRUE(raw.find("computed_sum") == std::string::npos);
 }
 
+TEST_CASE(request_arena) {
+    auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
+        R"({"jsonrpc":"2.0","id":1,"method":"test/add","params":{"a":2,"b":3}})",
+        R"({"jsonrpc":"2.0","id":2,"method":"test/add","params":{"a":4,"b":5}})",
+    });
+    auto* transport_ptr = transport.get();
+
+    event_loop loop;
+    JsonPeer peer(loop, std::move(transport));
+    std::vector<std::pmr::memory_resource*> arenas;
+
+    peer.on_request([&](RequestContext& context,
+                        const AddParams& params) -> RequestResult<AddParams> {
+        arenas.push_back(context.memory);
+        std::pmr::vector<std::pmr::string> words(context.memory);
+        auto status = codec::json::from_json(R"(["a word too long to fit inline"])", words);
+        if(!status || words.front().get_allocator().resource() != context.memory) {
+            co_return AddResult{.sum = -1};
+        }
+        co_return AddResult{.sum = params.a + params.b};
+    });
+
+    loop.schedule(peer.run());
+    EXPECT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(arenas.size(), 2U);
+    EXPECT_TRUE(arenas[0] != std::pmr::get_default_resource());
+
+    ASSERT_EQ(transport_ptr->outgoing().size(), 2U);
+    auto response = codec::json::from_json<Response>(transport_ptr->outgoing().back());
+    ASSERT_TRUE(response.has_value());
+    ASSERT_TRUE(response->result.has_value());
+    EXPECT_EQ(response->result->sum, 9);
+}
+
 // Incoming notification with camelCase params
 TEST_CASE(notification_params) {
     auto transport = std::make_unique<FakeTransport>(std::vector<std::string>{
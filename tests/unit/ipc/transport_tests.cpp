@@ -1,13 +1,29 @@
 #include <atomic>
+#include <cstdio>
+#include <expected>
+#include <filesystem>
+#include <format>
 #include <optional>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
 #include "test_transport.h"
 #include "../support/fd_helpers.h"
+#include "kota/ipc/binary_transport.h"
+#include "kota/ipc/codec/json.h"
+#include "kota/ipc/compressing_transport.h"
+#include "kota/ipc/multiplexer.h"
+#include "kota/ipc/recording_transport.h"
+#include "kota/ipc/replay_transport.h"
+#include "kota/ipc/shm_transport.h"
 #include "kota/ipc/transport.h"
+#include "kota/ipc/unix_transport.h"
 #include "kota/zest/zest.h"
 #include "kota/async/async.h"
 
@@ -60,6 +76,394 @@ TEST_CASE(consecutive_messages) {
     EXPECT_EQ(*second, second_payload);
 }
 
+TEST_CASE(borrowed_messages) {
+    event_loop loop;
+
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    auto input = pipe::open(fds[0], pipe::options{}, loop);
+    ASSERT_TRUE(input.has_value());
+
+    StreamTransport transport(stream(std::move(*input)));
+
+    const std::string first_payload = R"({"jsonrpc":"2.0","method":"a"})";
+    const std::string second_payload = R"({"jsonrpc":"2.0","id":2,"result":null})";
+    const auto payload = frame(first_payload) + frame(second_payload);
+
+    ASSERT_EQ(write_fd(fds[1], payload.data(), payload.size()),
+              static_cast<ssize_t>(payload.size()));
+    ASSERT_EQ(close_fd(fds[1]), 0);
+
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await transport.read_borrowed()) {
+            messages.emplace_back(message->payload());
+        }
+        event_loop::current().stop();
+        co_return messages;
+    };
+
+    auto read_task = reader();
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_EQ(read_task.result(), (std::vector<std::string>{first_payload, second_payload}));
+}
+
+TEST_CASE(json_array_decoded_while_read) {
+    event_loop loop;
+
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    auto input = pipe::open(fds[0], pipe::options{}, loop);
+    ASSERT_TRUE(input.has_value());
+    stream channel(std::move(*input));
+
+    const std::string data = R"([1, "two", [3], 4] rest)";
+    ASSERT_EQ(write_fd(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    ASSERT_EQ(close_fd(fds[1]), 0);
+
+    std::vector<int> values;
+    int failures = 0;
+    auto on_element = [&](std::expected<int, codec::json::error> element) {
+        if(element.has_value()) {
+            values.push_back(*element);
+        } else {
+            ++failures;
+        }
+    };
+
+    auto reader = [&]() -> task<std::pair<std::size_t, std::string>> {
+        auto count = co_await read_json_array<int>(channel, on_element);
+        auto rest = co_await channel.read();
+        event_loop::current().stop();
+        co_return std::pair{count.has_error() ? 0 : *count, rest.has_error() ? "" : *rest};
+    };
+
+    auto read_task = reader();
+    loop.schedule(read_task);
+    loop.run();
+
+    const auto [count, rest] = read_task.result();
+    EXPECT_EQ(count, 4U);
+    EXPECT_EQ(values, std::vector<int>({1, 4}));
+    EXPECT_EQ(failures, 2);
+    EXPECT_EQ(rest, " rest");
+}
+
+TEST_CASE(write_messages_gathers_frames) {
+    event_loop loop;
+
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    auto input = pipe::open(fds[0], pipe::options{}, loop);
+    ASSERT_TRUE(input.has_value());
+    auto output = pipe::open(fds[1], pipe::options{}, loop);
+    ASSERT_TRUE(output.has_value());
+
+    StreamTransport reader_side(stream(std::move(*input)));
+    StreamTransport writer_side(stream(std::move(*output)));
+
+    const std::vector<std::string> sent = {"first", "", R"({"id":3})"};
+
+    auto writer = [&]() -> task<void, Error> {
+        const std::string_view payloads[] = {sent[0], sent[1], sent[2]};
+        co_await writer_side.write_messages(payloads).or_fail();
+        auto closed = writer_side.close();
+        if(!closed) {
+            co_await fail(closed.error());
+        }
+    };
+
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await reader_side.read_message()) {
+            messages.push_back(std::move(*message));
+        }
+        event_loop::current().stop();
+        co_return messages;
+    };
+
+    auto write_task = writer();
+    auto read_task = reader();
+    loop.schedule(write_task);
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_FALSE(write_task.result().has_error());
+    EXPECT_EQ(read_task.result(), sent);
+}
+
+TEST_CASE(binary_framed_roundtrip) {
+    event_loop loop;
+
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    auto input = pipe::open(fds[0], pipe::options{}, loop);
+    ASSERT_TRUE(input.has_value());
+    auto output = pipe::open(fds[1], pipe::options{}, loop);
+    ASSERT_TRUE(output.has_value());
+
+    BinaryFramedTransport reader_side(stream(std::move(*input)));
+    BinaryFramedTransport writer_side(stream(std::move(*output)));
+
+    const std::vector<std::string> sent = {
+        std::string("\0\x01\xff", 3),
+        "",
+        std::string(100 * 1024, 'x'),
+        "last",
+    };
+
+    auto writer = [&]() -> task<void, Error> {
+        co_await writer_side.write_message(sent[0]).or_fail();
+        const std::string_view rest[] = {sent[1], sent[2], sent[3]};
+        co_await writer_side.write_messages(rest).or_fail();
+        auto closed = writer_side.close();
+        if(!closed) {
+            co_await fail(closed.error());
+        }
+    };
+
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await reader_side.read_borrowed()) {
+            messages.emplace_back(message->payload());
+        }
+        event_loop::current().stop();
+        co_return messages;
+    };
+
+    auto write_task = writer();
+    auto read_task = reader();
+    loop.schedule(write_task);
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_FALSE(write_task.result().has_error());
+    EXPECT_EQ(read_task.result(), sent);
+}
+
+TEST_CASE(compressing_roundtrip) {
+    event_loop loop;
+
+    std::string envelope = R"({"jsonrpc":"2.0","id":1,"result":[)";
+    for(int i = 0; i < 200; ++i) {
+        envelope += R"({"name":"symbol)" + std::to_string(i) + R"(","kind":12},)";
+    }
+    envelope += "{}]}";
+
+    const std::vector<std::string> sent = {
+        "short",
+        envelope,
+        envelope + " ",
+        std::string("\0\x01\xff", 3),
+    };
+
+    auto wire = std::make_unique<FakeTransport>(std::vector<std::string>{});
+    auto* captured = wire.get();
+    CompressingTransport writer_side(std::move(wire));
+
+    auto writer = [&]() -> task<void, Error> {
+        co_await writer_side.write_message(sent[0]).or_fail();
+        const std::string_view rest[] = {sent[1], sent[2], sent[3]};
+        co_await writer_side.write_messages(rest).or_fail();
+    };
+
+    auto write_task = writer();
+    loop.schedule(write_task);
+    loop.run();
+    ASSERT_FALSE(write_task.result().has_error());
+
+    // A hello, then one frame per message; the repeated envelope is nearly
+    // free thanks to the dictionary left by the first.
+    const auto& frames = captured->outgoing();
+    ASSERT_EQ(frames.size(), sent.size() + 1);
+    EXPECT_EQ(frames[1].size(), sent[0].size() + 1);
+    EXPECT_LT(frames[2].size(), envelope.size() / 2);
+    EXPECT_LT(frames[3].size(), std::size_t(64));
+
+    CompressingTransport reader_side(std::make_unique<FakeTransport>(frames));
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await reader_side.read_message()) {
+            messages.push_back(std::move(*message));
+        }
+        co_return messages;
+    };
+
+    auto read_task = reader();
+    loop.schedule(read_task);
+    loop.run();
+    EXPECT_EQ(read_task.result(), sent);
+
+    // Without a hello the reader passes messages through.
+    CompressingTransport plain_reader(
+        std::make_unique<FakeTransport>(std::vector<std::string>{"plain"}));
+    auto read_plain = [&]() -> task<std::optional<std::string>> {
+        co_return co_await plain_reader.read_message();
+    };
+    auto plain_task = read_plain();
+    loop.schedule(plain_task);
+    loop.run();
+    EXPECT_EQ(plain_task.result(), std::optional<std::string>("plain"));
+}
+
+TEST_CASE(multiplexed_channels) {
+    event_loop loop;
+
+    // Two scripted transports wired back to back stand in for a pipe.
+    ScriptedTransport* left_end = nullptr;
+    ScriptedTransport* right_end = nullptr;
+    auto left = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [&](std::string_view payload, ScriptedTransport&) {
+            right_end->push_incoming(std::string(payload));
+        });
+    auto right = std::make_unique<ScriptedTransport>(
+        std::vector<std::string>{},
+        [&](std::string_view payload, ScriptedTransport&) {
+            left_end->push_incoming(std::string(payload));
+        });
+    left_end = left.get();
+    right_end = right.get();
+
+    Multiplexer writer_side(loop, std::move(left), {.window = 2});
+    Multiplexer reader_side(loop, std::move(right), {.window = 2});
+
+    auto busy_out = writer_side.open(1);
+    auto quiet_out = writer_side.open(2);
+    auto busy_in = reader_side.open(1);
+    auto quiet_in = reader_side.open(2);
+    ASSERT_TRUE(busy_out && quiet_out && busy_in && quiet_in);
+    EXPECT_FALSE(writer_side.open(1).has_value());
+
+    const std::vector<std::string> sent = {"one", "two", "three", "four", "five"};
+    auto writer = [&]() -> task<void, Error> {
+        std::vector<std::string_view> views(sent.begin(), sent.end());
+        co_await (*busy_out)->write_messages(views).or_fail();
+        (void)(*busy_out)->close_output();
+    };
+    auto quiet_writer = [&]() -> task<void, Error> {
+        co_await (*quiet_out)->write_message("other").or_fail();
+    };
+
+    // Channel 1 runs out of credit long before its reader starts; channel
+    // 2 still gets through.
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        if(auto other = co_await (*quiet_in)->read_message()) {
+            messages.push_back(std::move(*other));
+        }
+        while(auto message = co_await (*busy_in)->read_message()) {
+            messages.push_back(std::move(*message));
+        }
+        (void)left_end->close();
+        (void)right_end->close();
+        co_return messages;
+    };
+
+    auto write_task = writer();
+    auto quiet_task = quiet_writer();
+    auto read_task = reader();
+    loop.schedule(writer_side.run());
+    loop.schedule(reader_side.run());
+    loop.schedule(write_task);
+    loop.schedule(quiet_task);
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_FALSE(write_task.result().has_error());
+    EXPECT_FALSE(quiet_task.result().has_error());
+    const std::vector<std::string> expected = {"other", "one", "two", "three", "four", "five"};
+    EXPECT_EQ(read_task.result(), expected);
+}
+
+TEST_CASE(replay_recorded_trace) {
+    event_loop loop;
+
+    const std::vector<std::string> sent = {
+        R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{"q":"\"x\"\n"}})",
+        std::string("tab\there \x01 \xe4\xbd\xa0"),
+        R"({"jsonrpc":"2.0","method":"exit"})",
+    };
+
+    auto path = (std::filesystem::temp_directory_path() / "kotatsu-replay-trace.jsonl").string();
+    {
+        RecordingTransport recorder(std::make_unique<FakeTransport>(sent), path);
+        auto drain = [&]() -> task<> {
+            while(co_await recorder.read_message()) {}
+        };
+        auto drain_task = drain();
+        loop.schedule(drain_task);
+        loop.run();
+    }
+
+    auto records = ReplayTransport::load(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(records.has_value());
+    ASSERT_EQ(records->size(), sent.size());
+
+    ReplayTransport replay(std::move(*records));
+    std::vector<std::string> written;
+    replay.on_write([&](std::string_view payload) { written.emplace_back(payload); });
+
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await replay.read_message()) {
+            messages.push_back(std::move(*message));
+            co_await replay.write_message("ack");
+        }
+        co_return messages;
+    };
+
+    auto read_task = reader();
+    loop.schedule(read_task);
+    loop.run();
+    EXPECT_EQ(read_task.result(), sent);
+    EXPECT_EQ(written.size(), sent.size());
+    EXPECT_EQ(replay.remaining(), 0U);
+}
+
+TEST_CASE(recording_counts_dropped) {
+    event_loop loop;
+
+    std::vector<std::string> sent;
+    for(int i = 0; i < 200; ++i) {
+        sent.push_back(std::format(R"({{"jsonrpc":"2.0","method":"note","params":{}}})", i));
+    }
+
+    // A two-slot queue the writer cannot always keep empty: whatever is not
+    // in the trace must be counted as dropped.
+    auto path = (std::filesystem::temp_directory_path() / "kotatsu-dropped-trace.jsonl").string();
+    RecordingTransport recorder(std::make_unique<FakeTransport>(sent),
+                                path,
+                                {.queue_capacity = 2, .buffer_size = 64});
+    auto drain = [&]() -> task<std::size_t> {
+        std::size_t count = 0;
+        while(co_await recorder.read_message()) {
+            count += 1;
+        }
+        co_return count;
+    };
+    auto drain_task = drain();
+    loop.schedule(drain_task);
+    loop.run();
+    EXPECT_EQ(drain_task.result(), sent.size());
+    ASSERT_TRUE(recorder.close().has_value());
+
+    auto records = ReplayTransport::load(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(records.has_value());
+    EXPECT_EQ(records->size() + recorder.dropped(), sent.size());
+    for(std::size_t i = 1; i < records->size(); ++i) {
+        EXPECT_TRUE((*records)[i - 1].time <= (*records)[i].time);
+    }
+}
+
 // 6.1 Content-Length: 0 → empty string payload
 TEST_CASE(empty_payload) {
     event_loop loop;
@@ -273,6 +677,134 @@ TEST_CASE(large_payload_single_chunk) {
     EXPECT_EQ(result->size(), payload.size());
 }
 
+TEST_CASE(shared_memory_roundtrip) {
+#ifdef _WIN32
+    zest::skip();
+    return;
+#else
+    event_loop loop;
+
+    // One pipe per direction serves as the doorbell.
+    int to_opener[2] = {-1, -1};
+    int to_creator[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(to_opener), 0);
+    ASSERT_EQ(create_pipe(to_creator), 0);
+
+    auto open_pipe = [&](int fd) {
+        auto opened = pipe::open(fd, pipe::options{}, loop);
+        return opened ? stream(std::move(*opened)) : stream();
+    };
+
+    // A ring smaller than the large message forces it through in pieces.
+    auto creator = SharedMemoryTransport::create(open_pipe(to_creator[0]),
+                                                 open_pipe(to_opener[1]),
+                                                 4096);
+    ASSERT_TRUE(creator.has_value());
+    auto opener = SharedMemoryTransport::open((*creator)->name(),
+                                              open_pipe(to_opener[0]),
+                                              open_pipe(to_creator[1]));
+    ASSERT_TRUE(opener.has_value());
+
+    const std::vector<std::string> payloads = {"first", "", std::string(100000, 'a')};
+
+    auto writer = [&]() -> task<void, Error> {
+        for(auto& payload: payloads) {
+            co_await (*creator)->write_message(payload).or_fail();
+        }
+        auto closed = (*creator)->close_output();
+        if(!closed) {
+            co_await fail(closed.error());
+        }
+    };
+
+    auto reader = [&]() -> task<std::vector<std::string>> {
+        std::vector<std::string> messages;
+        while(auto message = co_await (*opener)->read_message()) {
+            messages.push_back(std::move(*message));
+        }
+        event_loop::current().stop();
+        co_return messages;
+    };
+
+    auto write_task = writer();
+    auto read_task = reader();
+    loop.schedule(write_task);
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_FALSE(write_task.result().has_error());
+    EXPECT_EQ(read_task.result(), payloads);
+#endif
+}
+
+TEST_CASE(unix_socket_passes_descriptors) {
+#ifdef _WIN32
+    zest::skip();
+    return;
+#else
+    event_loop loop;
+
+    int sockets[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+
+    auto sender = UnixSocketTransport::open(sockets[0], loop);
+    ASSERT_TRUE(sender.has_value());
+    auto receiver = UnixSocketTransport::open(sockets[1], loop);
+    ASSERT_TRUE(receiver.has_value());
+
+    // The write end of a pipe is handed over; the receiver writes through it.
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(create_pipe(fds), 0);
+
+    auto writer = [&]() -> task<void, Error> {
+        co_await (*sender)->write_message("plain").or_fail();
+        const int passed[] = {fds[1]};
+        co_await (*sender)->write_message("with fd", passed).or_fail();
+        co_await (*sender)->write_message("after").or_fail();
+    };
+
+    std::vector<std::string> messages;
+    std::vector<std::size_t> counts;
+    int received = -1;
+    auto reader = [&]() -> task<> {
+        for(int i = 0; i < 3; ++i) {
+            auto message = co_await (*receiver)->read_message();
+            if(!message) {
+                break;
+            }
+            messages.push_back(std::move(*message));
+            auto descriptors = (*receiver)->take_descriptors();
+            counts.push_back(descriptors.size());
+            if(!descriptors.empty()) {
+                received = descriptors.front();
+            }
+        }
+        event_loop::current().stop();
+    };
+
+    auto write_task = writer();
+    auto read_task = reader();
+    loop.schedule(write_task);
+    loop.schedule(read_task);
+    loop.run();
+
+    EXPECT_FALSE(write_task.result().has_error());
+    EXPECT_EQ(messages, (std::vector<std::string>{"plain", "with fd", "after"}));
+    EXPECT_EQ(counts, (std::vector<std::size_t>{0, 1, 0}));
+    ASSERT_TRUE(received >= 0);
+    EXPECT_TRUE(received != fds[1]);
+
+    close_fd(fds[1]);
+    ASSERT_EQ(write_fd(received, "x", 1), 1);
+    close_fd(received);
+
+    char byte = 0;
+    EXPECT_EQ(::read(fds[0], &byte, 1), 1);
+    EXPECT_EQ(byte, 'x');
+    close_fd(fds[0]);
+#endif
+}
+
 };  // TEST_SUITE(ipc_transport)
 
 }  // namespace
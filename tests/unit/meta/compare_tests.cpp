@@ -176,6 +176,21 @@ struct unsized_unordered_set {
 static_assert(!std::ranges::sized_range<const unsized_unordered_map<int, int>>);
 static_assert(!std::ranges::sized_range<const unsized_unordered_set<int>>);
 
+struct c_weighted {
+    int id;
+    float weight;
+};
+
+struct c_holder {
+    with_custom_ops inner;
+};
+
+static_assert(detail::bitwise_eq_comparable<c_box>());
+static_assert(!detail::bitwise_eq_comparable<c_weighted>());
+static_assert(!detail::bitwise_eq_comparable<with_custom_ops>());
+static_assert(!detail::bitwise_eq_comparable<c_holder>());
+static_assert(detail::bitwise_eq_ranges<std::vector<c_box>, std::vector<c_box>>);
+
 TEST_SUITE(reflection) {
 
 TEST_CASE(primitive_types) {
@@ -642,6 +657,29 @@ TEST_CASE(functor_sort) {
     EXPECT_EQ(values[3].y, 1);
 }
 
+TEST_CASE(bitwise_fast_path) {
+    std::vector<c_box> lhs(100);
+    for(int i = 0; i < 100; ++i) {
+        lhs[i] = c_box{.pos = {i, i + 1}, .id = i * 2};
+    }
+    auto rhs = lhs;
+    EXPECT_TRUE(eq(lhs, rhs));
+    EXPECT_TRUE(eq(lhs[3], rhs[3]));
+
+    rhs[99].pos.y = -1;
+    EXPECT_FALSE(eq(lhs, rhs));
+    EXPECT_FALSE(eq(lhs[99], rhs[99]));
+
+    rhs.pop_back();
+    EXPECT_FALSE(eq(lhs, rhs));
+    EXPECT_TRUE(eq(std::vector<c_box>{}, std::vector<c_box>{}));
+
+    // A field with its own operator== still decides by that operator.
+    EXPECT_TRUE(eq(c_holder{.inner = {1, 2}}, c_holder{.inner = {3, 2}}));
+
+    static_assert(eq(c_box{.pos = {1, 2}, .id = 3}, c_box{.pos = {1, 2}, .id = 3}));
+}
+
 };  // TEST_SUITE(reflection)
 
 }  // namespace
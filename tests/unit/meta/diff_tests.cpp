@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/meta/diff.h"
+
+namespace kota::meta {
+
+namespace {
+
+struct d_position {
+    std::uint32_t line = 0;
+    std::uint32_t character = 0;
+};
+
+struct d_range {
+    d_position start;
+    d_position end;
+};
+
+struct d_diagnostic {
+    d_range range;
+    std::string message;
+    std::optional<std::string> source;
+};
+
+struct d_report {
+    std::string uri;
+    std::optional<std::int32_t> version;
+    std::vector<d_diagnostic> diagnostics;
+    std::vector<std::uint32_t> tokens;
+    skip<int> cached = 0;
+};
+
+struct d_config {
+    using field_rename = rename_policy::lower_camel;
+};
+
+auto diagnostic(std::uint32_t line, std::string message) -> d_diagnostic {
+    return d_diagnostic{
+        .range = {.start = {.line = line, .character = 0}, .end = {.line = line, .character = 8}},
+        .message = std::move(message),
+        .source = "clang",
+    };
+}
+
+auto sample() -> d_report {
+    return d_report{
+        .uri = "file:///main.cpp",
+        .version = 1,
+        .diagnostics = {diagnostic(1, "unused variable"), diagnostic(4, "missing return")},
+        .tokens = {0, 5, 3, 0, 0, 1, 2, 4, 1, 0},
+        .cached = 0,
+    };
+}
+
+TEST_SUITE(diff) {
+
+TEST_CASE(equal_snapshots_have_no_ops) {
+    const auto old = sample();
+    const auto updated = sample();
+    EXPECT_TRUE(diff(old, updated).empty());
+}
+
+TEST_CASE(changed_fields_are_replaced) {
+    const auto old = sample();
+    auto updated = sample();
+    updated.version = 2;
+    updated.diagnostics[1].range.end.character = 12;
+    updated.cached = 9;
+
+    auto changes = diff(old, updated);
+    ASSERT_EQ(changes.ops.size(), 2U);
+    EXPECT_EQ(changes.ops[0].kind, patch_kind::replace);
+    EXPECT_EQ(changes.ops[0].path, "/version");
+    EXPECT_EQ(changes.ops[1].path, "/diagnostics/1/range/end/character");
+    EXPECT_EQ(changes.ops[1].indices, (std::vector<std::size_t>{2, 1, 0, 1, 1}));
+
+    auto patched = sample();
+    ASSERT_TRUE(apply(patched, changes));
+    EXPECT_TRUE(eq(patched.diagnostics, updated.diagnostics));
+    EXPECT_EQ(patched.version, std::optional<std::int32_t>(2));
+    EXPECT_EQ(static_cast<int>(patched.cached), 0);
+}
+
+TEST_CASE(sequences_are_spliced) {
+    const auto old = sample();
+    auto updated = sample();
+    updated.tokens = {0, 5, 3, 0, 0, 7, 7, 1, 2, 4, 1, 0};
+    updated.diagnostics.insert(updated.diagnostics.begin() + 1, diagnostic(2, "shadowed"));
+
+    auto changes = diff(old, updated);
+    ASSERT_EQ(changes.ops.size(), 2U);
+    EXPECT_EQ(changes.ops[0].kind, patch_kind::splice);
+    EXPECT_EQ(changes.ops[0].path, "/diagnostics");
+    EXPECT_EQ(changes.ops[0].start, 1U);
+    EXPECT_EQ(changes.ops[0].remove, 0U);
+    EXPECT_EQ(changes.ops[0].insert, 1U);
+    EXPECT_EQ(changes.ops[1].path, "/tokens");
+    EXPECT_EQ(changes.ops[1].start, 5U);
+    EXPECT_EQ(changes.ops[1].remove, 0U);
+    EXPECT_EQ(changes.ops[1].insert, 2U);
+
+    auto patched = sample();
+    ASSERT_TRUE(apply(patched, changes));
+    EXPECT_TRUE(eq(patched, updated));
+
+    updated.tokens.clear();
+    changes = diff(old, updated);
+    patched = sample();
+    ASSERT_TRUE(apply(patched, changes));
+    EXPECT_TRUE(patched.tokens.empty());
+}
+
+TEST_CASE(optionals_pass_through) {
+    auto old = sample();
+    auto updated = sample();
+    updated.diagnostics[0].source.reset();
+    old.version.reset();
+
+    auto changes = diff<d_config>(old, updated);
+    ASSERT_EQ(changes.ops.size(), 2U);
+    EXPECT_EQ(changes.ops[0].path, "/version");
+    EXPECT_EQ(changes.ops[1].path, "/diagnostics/0/source");
+
+    ASSERT_TRUE(apply(old, changes));
+    EXPECT_TRUE(eq(old, updated));
+}
+
+TEST_CASE(missing_paths_fail) {
+    const auto old = sample();
+    auto updated = sample();
+    updated.diagnostics[1].message = "changed";
+    auto changes = diff(old, updated);
+
+    auto shorter = sample();
+    shorter.diagnostics.pop_back();
+    EXPECT_FALSE(apply(shorter, changes));
+}
+
+};  // TEST_SUITE(diff)
+
+}  // namespace
+
+}  // namespace kota::meta
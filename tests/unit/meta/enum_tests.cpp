@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <cstdint>
 
 #include "kota/zest/zest.h"
@@ -36,6 +37,51 @@ enum class Edge8 : std::int8_t {
     Max = 127,
 };
 
+enum class Wide : std::uint8_t {
+    // clang-format off
+    K0, K1, K2, K3, K4, K5, K6, K7, K8, K9,
+    K10, K11, K12, K13, K14, K15, K16, K17, K18, K19,
+    K20, K21, K22, K23, K24, K25, K26, K27, K28, K29,
+    K30, K31, K32, K33, K34, K35, K36, K37, K38, K39,
+    // clang-format on
+};
+
+enum class Access : std::uint16_t {
+    None = 0,
+    Read = 1,
+    Write = 2,
+    Exec = 4,
+    Admin = 1024,
+};
+
+enum class Masks : int {
+    A = 1,
+    B = 2,
+    C = 4,
+    All = 7,
+};
+
+}  // namespace
+
+template <>
+constexpr inline bool enable_enum_flags<Masks> = true;
+
+namespace {
+
+static_assert(flag_enum<Access>);
+static_assert(flag_enum<Masks>);
+static_assert(!flag_enum<Color>);
+static_assert(!flag_enum<Sparse>);
+static_assert(flag_reflection<Access>::member_count == 4);
+static_assert(flag_reflection<Access>::member_names[3] == "Admin");
+static_assert(flag_reflection<Masks>::member_count == 3);
+
+static_assert(enum_value_index<Sparse>::dense);
+static_assert(!enum_value_index<Edge8>::dense);
+static_assert(enum_names_index<Wide>.perfect);
+static_assert(enum_value<Wide>("K27") == Wide::K27);
+static_assert(enum_name(Wide::K39) == "K39");
+
 static_assert(reflection<Color>::member_count == 3);
 static_assert(reflection<Color>::member_names.size() == 3);
 static_assert(reflection<Color>::member_names[0] == "Red");
@@ -91,6 +137,49 @@ TEST_CASE(enum_member_names) {
 
     EXPECT_EQ(enum_name(Edge8::Min), "Min");
     EXPECT_EQ(enum_name(Edge8::Max), "Max");
+    EXPECT_EQ(enum_name(static_cast<Edge8>(0)), "");
+}
+
+TEST_CASE(enum_member_values) {
+    EXPECT_EQ(enum_value<Color>("Green"), Color::Green);
+    EXPECT_EQ(enum_value<Sparse>("Neg"), Sparse::Neg);
+    EXPECT_EQ(enum_value<Edge8>("Max"), Edge8::Max);
+    EXPECT_FALSE(enum_value<Color>("green").has_value());
+    EXPECT_FALSE(enum_value<Color>("").has_value());
+    EXPECT_FALSE(enum_value<Sparse>("Neg ").has_value());
+
+    for(std::size_t i = 0; i < reflection<Wide>::member_count; ++i) {
+        const auto value = reflection<Wide>::member_values[i];
+        EXPECT_EQ(enum_index(value), i);
+        EXPECT_EQ(enum_value<Wide>(enum_name(value)), value);
+    }
+    EXPECT_FALSE(enum_value<Wide>("K40").has_value());
+    EXPECT_FALSE(enum_index(static_cast<Wide>(40)).has_value());
+}
+
+TEST_CASE(enum_flag_names) {
+    const auto all = static_cast<Access>(1 | 2 | 1024);
+    EXPECT_EQ(enum_flags_name(all), "Read|Write|Admin");
+    EXPECT_EQ(enum_flags_name(all, ", "), "Read, Write, Admin");
+    EXPECT_EQ(enum_flags_name(Access::None), "");
+    EXPECT_EQ(enum_flags_name(static_cast<Access>(1 | 16)), "");
+    EXPECT_EQ(enum_flags_name(Masks::All), "A|B|C");
+
+    EXPECT_EQ(enum_flags_value<Access>("Read|Write|Admin"), all);
+    EXPECT_EQ(enum_flags_value<Access>(""), Access::None);
+    EXPECT_EQ(enum_flags_value<Access>("Exec, Read", ", "), static_cast<Access>(5));
+    EXPECT_FALSE(enum_flags_value<Access>("Read|Delete").has_value());
+    EXPECT_FALSE(enum_flags_value<Access>("Read|").has_value());
+    EXPECT_EQ(enum_flag_value<Access>("Admin"), Access::Admin);
+
+    std::size_t count = 0;
+    auto unnamed = for_each_enum_flag(static_cast<Access>(4 | 32), [&](Access flag, auto name) {
+        EXPECT_EQ(flag, Access::Exec);
+        EXPECT_EQ(name, "Exec");
+        ++count;
+    });
+    EXPECT_EQ(count, 1U);
+    EXPECT_EQ(unnamed, static_cast<Access>(32));
 }
 
 };  // TEST_SUITE(reflection)
@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/meta/compare.h"
+#include "kota/meta/hash.h"
+
+namespace kota::meta {
+
+namespace {
+
+struct h_position {
+    std::uint32_t line;
+    std::uint32_t character;
+};
+
+struct h_range {
+    h_position start;
+    h_position end;
+};
+
+struct h_request {
+    std::string uri;
+    h_range range;
+    double weight = 0;
+    std::optional<std::string> context;
+    std::vector<int> tags;
+};
+
+struct h_keyed {
+    int id;
+    std::string label;
+
+    bool operator==(const h_keyed& other) const {
+        return id == other.id;
+    }
+};
+
+}  // namespace
+
+}  // namespace kota::meta
+
+template <>
+struct std::hash<kota::meta::h_keyed> {
+    std::size_t operator()(const kota::meta::h_keyed& value) const {
+        return std::hash<int>{}(value.id);
+    }
+};
+
+namespace kota::meta {
+
+namespace {
+
+static_assert(detail::bytewise_hashable<h_range>);
+static_assert(!detail::bytewise_hashable<h_request>);
+
+auto sample() -> h_request {
+    return h_request{
+        .uri = "file:///main.cpp",
+        .range = {.start = {.line = 1, .character = 2}, .end = {.line = 3, .character = 4}},
+        .weight = 0.5,
+        .context = "hover",
+        .tags = {1, 2},
+    };
+}
+
+template <typename T>
+std::size_t hash_of(const T& value) {
+    return hash<T>{}(value);
+}
+
+TEST_SUITE(hash) {
+
+TEST_CASE(equal_structs_hash_equal) {
+    auto lhs = sample();
+    auto rhs = sample();
+    EXPECT_EQ(hash_of(lhs), hash_of(rhs));
+
+    rhs.range.end.character = 5;
+    EXPECT_NE(hash_of(lhs), hash_of(rhs));
+
+    rhs = sample();
+    rhs.context.reset();
+    EXPECT_NE(hash_of(lhs), hash_of(rhs));
+
+    rhs = sample();
+    rhs.weight = 0.25;
+    EXPECT_NE(hash_of(lhs), hash_of(rhs));
+}
+
+TEST_CASE(field_order_matters) {
+    const h_position a{.line = 1, .character = 2};
+    const h_position b{.line = 2, .character = 1};
+    EXPECT_NE(hash_of(a), hash_of(b));
+    EXPECT_NE(hash_of(std::vector<int>{1, 2}), hash_of(std::vector<int>{2, 1}));
+}
+
+TEST_CASE(contiguous_ranges) {
+    std::vector<h_range> ranges(64);
+    for(std::uint32_t i = 0; i < ranges.size(); ++i) {
+        ranges[i].start.line = i;
+        ranges[i].end.line = i + 1;
+    }
+    auto copy = ranges;
+    EXPECT_EQ(hash_of(ranges), hash_of(copy));
+
+    copy.back().end.character = 1;
+    EXPECT_NE(hash_of(ranges), hash_of(copy));
+}
+
+TEST_CASE(unordered_containers_ignore_order) {
+    std::unordered_set<int> lhs;
+    std::unordered_set<int> rhs;
+    for(int i = 0; i < 32; ++i) {
+        lhs.insert(i);
+        rhs.insert(31 - i);
+    }
+    EXPECT_EQ(hash_of(lhs), hash_of(rhs));
+
+    std::map<std::string, int> ordered{
+        {"a", 1},
+        {"b", 2}
+    };
+    std::map<std::string, int> changed{
+        {"a", 2},
+        {"b", 1}
+    };
+    EXPECT_NE(hash_of(ordered), hash_of(changed));
+}
+
+TEST_CASE(variants_and_zero) {
+    using value_t = std::variant<int, std::string>;
+    EXPECT_EQ(hash_of(value_t(7)), hash_of(value_t(7)));
+    EXPECT_NE(hash_of(value_t(7)), hash_of(value_t(std::string("7"))));
+    EXPECT_EQ(hash_of(0.0), hash_of(-0.0));
+}
+
+TEST_CASE(custom_equality_uses_std_hash) {
+    const h_keyed lhs{.id = 1, .label = "one"};
+    const h_keyed rhs{.id = 1, .label = "uno"};
+    ASSERT_TRUE(meta::eq(lhs, rhs));
+    EXPECT_EQ(hash_of(lhs), hash_of(rhs));
+}
+
+TEST_CASE(keys_unordered_map) {
+    std::unordered_map<h_request, int, hash<h_request>, eq_t> memo;
+    memo.emplace(sample(), 1);
+
+    auto other = sample();
+    other.uri = "file:///other.cpp";
+    memo.emplace(other, 2);
+
+    ASSERT_EQ(memo.size(), 2U);
+    EXPECT_EQ(memo.at(sample()), 1);
+    EXPECT_EQ(memo.at(other), 2);
+}
+
+};  // TEST_SUITE(hash)
+
+}  // namespace
+
+}  // namespace kota::meta
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/meta/layout.h"
+
+namespace kota::meta {
+
+namespace {
+
+struct l_position {
+    std::uint32_t line;
+    std::uint32_t character;
+};
+
+struct l_range {
+    l_position start;
+    l_position end;
+};
+
+struct l_diagnostic {
+    l_range range;
+    double weight = 0;
+    std::string message;
+    std::optional<std::string> source;
+    std::vector<int> tags;
+    skip<int> cached = 0;
+};
+
+struct l_config {
+    using field_rename = rename_policy::lower_camel;
+};
+
+static_assert(layout_of<l_range>().bitwise_comparable);
+static_assert(layout_of<l_range>().fields.size() == 2);
+static_assert(layout_of<l_range>().fields[1].offset == sizeof(l_position));
+static_assert(!layout_of<l_diagnostic>().bitwise_comparable);
+static_assert(layout_of<l_diagnostic>().fields[0].bitwise_comparable);
+static_assert(!layout_of<l_diagnostic>().fields[1].bitwise_comparable);
+static_assert(layout_of<l_diagnostic>().fields[2].kind == type_kind::string);
+static_assert(layout_of<l_diagnostic>().fields[5].name.empty());
+
+auto sample() -> l_diagnostic {
+    return l_diagnostic{
+        .range = {.start = {.line = 1, .character = 2}, .end = {.line = 1, .character = 9}},
+        .weight = 0.5,
+        .message = "unused variable",
+        .source = "clang",
+        .tags = {1, 2},
+        .cached = 7,
+    };
+}
+
+TEST_SUITE(layout) {
+
+TEST_CASE(fields_carry_wire_names) {
+    const auto& layout = layout_of<l_diagnostic, l_config>();
+    ASSERT_EQ(layout.fields.size(), 6U);
+    EXPECT_EQ(layout.fields[0].name, "range");
+    EXPECT_EQ(layout.fields[2].name, "message");
+    EXPECT_EQ(layout.fields[0].nested, nullptr);
+    EXPECT_EQ(layout.fields[0].kind, type_kind::structure);
+    EXPECT_EQ(layout.fields[4].type, type_info_of<std::vector<int>, l_config>());
+}
+
+TEST_CASE(equal_and_hash_follow_values) {
+    const auto& layout = layout_of<l_diagnostic>();
+    auto lhs = sample();
+    auto rhs = sample();
+    EXPECT_TRUE(layout_equal(layout, &lhs, &rhs));
+    EXPECT_EQ(layout_hash(layout, &lhs), layout_hash(layout, &rhs));
+
+    rhs.message = "unused parameter";
+    EXPECT_FALSE(layout_equal(layout, &lhs, &rhs));
+
+    rhs = sample();
+    rhs.range.end.character = 10;
+    EXPECT_FALSE(layout_equal(layout, &lhs, &rhs));
+    EXPECT_NE(layout_hash(layout, &lhs), layout_hash(layout, &rhs));
+
+    rhs = sample();
+    rhs.tags.push_back(3);
+    EXPECT_FALSE(layout_equal(layout, &lhs, &rhs));
+}
+
+TEST_CASE(copy_assigns_every_field) {
+    const auto& layout = layout_of<l_diagnostic>();
+    const auto source = sample();
+    l_diagnostic target{};
+    layout_copy(layout, &target, &source);
+
+    EXPECT_EQ(target.range.end.character, 9U);
+    EXPECT_EQ(target.weight, 0.5);
+    EXPECT_EQ(target.message, "unused variable");
+    EXPECT_EQ(target.source, std::optional<std::string>("clang"));
+    EXPECT_EQ(target.tags, (std::vector<int>{1, 2}));
+    EXPECT_EQ(static_cast<int>(target.cached), 7);
+}
+
+TEST_CASE(trivial_structs_copy_whole) {
+    const l_range source{.start = {.line = 3, .character = 4}, .end = {.line = 5, .character = 6}};
+    l_range target{};
+    layout_copy(layout_of<l_range>(), &target, &source);
+    EXPECT_TRUE(layout_equal(layout_of<l_range>(), &target, &source));
+    EXPECT_EQ(target.end.line, 5U);
+}
+
+};  // TEST_SUITE(layout)
+
+}  // namespace
+
+}  // namespace kota::meta
@@ -1,11 +1,14 @@
 #include <array>
 #include <expected>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <ranges>
 #include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "kota/option/option.h"
@@ -617,6 +620,36 @@ constexpr auto kAliasOptInfos = std::array{
         .alias_of(ALIAS_OPT_EMIT_EQ),
 };
 
+enum SortedOptionID {
+    SORTED_OPT_INVALID = 0,
+    SORTED_OPT_INPUT = 1,
+    SORTED_OPT_UNKNOWN = 2,
+    SORTED_OPT_FOO_EQ,
+    SORTED_OPT_FOO,
+    SORTED_OPT_OUTPUT,
+};
+
+// Sorted as TableGen emits: "foo" prefixes "foo=", so it comes after it.
+constexpr auto kSortedOptInfos = std::array{
+    OptTable::Info::input(SORTED_OPT_INPUT),
+    OptTable::Info::unknown(SORTED_OPT_UNKNOWN),
+    OptTable::Info::unaliased_one(pfx_dash,
+                                  "-foo=",
+                                  SORTED_OPT_FOO_EQ,
+                                  Option::JoinedClass,
+                                  1,
+                                  "",
+                                  ""),
+    OptTable::Info::unaliased_one(pfx_dash, "-foo", SORTED_OPT_FOO, Option::FlagClass, 0, "", ""),
+    OptTable::Info::unaliased_one(pfx_dash_double,
+                                  "-o",
+                                  SORTED_OPT_OUTPUT,
+                                  Option::JoinedOrSeparateClass,
+                                  1,
+                                  "",
+                                  ""),
+};
+
 OptTable make_alias_opt_table() {
     return OptTable(std::span<const OptTable::Info>(kAliasOptInfos)).set_tablegen_mode(false);
 }
@@ -637,6 +670,57 @@ TEST_CASE(ignore_case_controls_matching) {
     EXPECT_EQ(parsed.args[0].option_id.id(), IGNORE_CASE_OPT_HELP);
 }
 
+TEST_CASE(spelling_index_matches_sorted_table) {
+    auto table = OptTable(std::span<const OptTable::Info>(kSortedOptInfos)).set_tablegen_mode(true);
+
+    auto parsed = parse_all(table, split2vec("-foo=bar -foo --o out -oout -FOO -fox /x"));
+    EXPECT_TRUE(parsed.errors.empty());
+    ASSERT_EQ(parsed.args.size(), 7U);
+    EXPECT_EQ(parsed.args[0].option_id.id(), SORTED_OPT_FOO_EQ);
+    EXPECT_EQ(parsed.args[0].values[0], "bar");
+    EXPECT_EQ(parsed.args[1].option_id.id(), SORTED_OPT_FOO);
+    EXPECT_EQ(parsed.args[2].option_id.id(), SORTED_OPT_OUTPUT);
+    EXPECT_EQ(parsed.args[2].values[0], "out");
+    EXPECT_EQ(parsed.args[3].option_id.id(), SORTED_OPT_OUTPUT);
+    EXPECT_EQ(parsed.args[3].values[0], "out");
+    EXPECT_EQ(parsed.args[4].option_id.id(), SORTED_OPT_UNKNOWN);
+    EXPECT_EQ(parsed.args[5].option_id.id(), SORTED_OPT_UNKNOWN);
+    EXPECT_EQ(parsed.args[6].option_id.id(), SORTED_OPT_INPUT);
+
+    table.set_ignore_case(true);
+    parsed = parse_all(table, split2vec("-FOO"));
+    ASSERT_EQ(parsed.args.size(), 1U);
+    EXPECT_EQ(parsed.args[0].option_id.id(), SORTED_OPT_FOO);
+}
+
+constexpr static auto kSortedIndexSizes = OptTable::index_sizes(kSortedOptInfos, false);
+constexpr static auto kSortedIndex = StaticIndex<kSortedIndexSizes>(kSortedOptInfos, false);
+
+TEST_CASE(static_index_matches_runtime_build) {
+    auto runtime = OptTable(std::span<const OptTable::Info>(kSortedOptInfos));
+    auto table = OptTable(std::span<const OptTable::Info>(kSortedOptInfos), false, {}, false)
+                     .set_tablegen_mode(true)
+                     .build(kSortedIndex.view());
+
+    EXPECT_EQ(table.prefixes_union().size(), runtime.prefixes_union().size());
+    for(std::size_t i = 0; i < runtime.prefixes_union().size(); ++i) {
+        EXPECT_EQ(table.prefixes_union()[i], runtime.prefixes_union()[i]);
+    }
+
+    auto parsed = parse_all(table, split2vec("-foo=bar -foo --o out -oout -FOO -fox /x"));
+    EXPECT_TRUE(parsed.errors.empty());
+    ASSERT_EQ(parsed.args.size(), 7U);
+    EXPECT_EQ(parsed.args[0].option_id.id(), SORTED_OPT_FOO_EQ);
+    EXPECT_EQ(parsed.args[0].values[0], "bar");
+    EXPECT_EQ(parsed.args[1].option_id.id(), SORTED_OPT_FOO);
+    EXPECT_EQ(parsed.args[2].option_id.id(), SORTED_OPT_OUTPUT);
+    EXPECT_EQ(parsed.args[3].option_id.id(), SORTED_OPT_OUTPUT);
+    EXPECT_EQ(parsed.args[3].values[0], "out");
+    EXPECT_EQ(parsed.args[4].option_id.id(), SORTED_OPT_UNKNOWN);
+    EXPECT_EQ(parsed.args[5].option_id.id(), SORTED_OPT_UNKNOWN);
+    EXPECT_EQ(parsed.args[6].option_id.id(), SORTED_OPT_INPUT);
+}
+
 TEST_CASE(grouped_short_option_parsing_paths) {
     auto table = make_grouped_opt_table();
 
@@ -743,6 +827,264 @@ TEST_CASE(parse_callback_can_stop_iteration) {
     EXPECT_TRUE(first_was_value);
 }
 
+TEST_CASE(parse_batch_keeps_command_ranges) {
+    auto table = make_grouped_opt_table();
+    std::vector<std::vector<std::string>> argvs = {
+        split2vec("-ab input.c"),
+        split2vec("--zz"),
+        split2vec("main.c -b"),
+    };
+    std::vector<OptTable::InputArgv> commands(argvs.begin(), argvs.end());
+
+    ParsedBatch batch;
+    table.parse_batch(commands, batch);
+    ASSERT_EQ(batch.size(), 3U);
+    EXPECT_EQ(batch.arguments().size(), 6U);
+
+    auto first = batch.arguments(0);
+    ASSERT_EQ(first.size(), 3U);
+    EXPECT_EQ(first[0].option_id.id(), GROUPED_OPT_A);
+    EXPECT_EQ(first[1].option_id.id(), GROUPED_OPT_B);
+    EXPECT_EQ(first[2].option_id.id(), GROUPED_OPT_INPUT);
+    EXPECT_EQ(first[2].get_spelling_view(), "input.c");
+
+    ASSERT_EQ(batch.arguments(1).size(), 1U);
+    EXPECT_EQ(batch.arguments(1)[0].option_id.id(), GROUPED_OPT_UNKNOWN);
+    EXPECT_EQ(batch.arguments(2)[1].option_id.id(), GROUPED_OPT_B);
+    EXPECT_EQ(batch.command(2).missing_arg_count, 0U);
+
+    const auto* storage = batch.arguments().data();
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    auto again = split2vec("-a");
+    std::vector<OptTable::InputArgv> single = {again};
+    table.parse_batch(single, batch);
+    ASSERT_EQ(batch.size(), 1U);
+    EXPECT_EQ(batch.arguments().data(), storage);
+}
+
+TEST_CASE(parse_batch_reports_missing_values) {
+    auto table = make_main_opt_table();
+    auto ok = split2vec("-s run.lua");
+    auto missing = split2vec("--help -s");
+    std::vector<OptTable::InputArgv> commands = {ok, missing};
+
+    ParsedBatch batch;
+    table.parse_batch(commands, batch);
+    ASSERT_EQ(batch.size(), 2U);
+    EXPECT_EQ(batch.command(0).missing_arg_count, 0U);
+    ASSERT_EQ(batch.arguments(0).size(), 1U);
+    EXPECT_EQ(batch.arguments(0)[0].values[0], "run.lua");
+
+    EXPECT_EQ(batch.arguments(1).size(), 1U);
+    EXPECT_EQ(batch.command(1).missing_arg_index, 1U);
+    EXPECT_EQ(batch.command(1).missing_arg_count, 1U);
+    EXPECT_TRUE(batch.command(1).missing_arg_reason != nullptr);
+}
+
+TEST_CASE(parse_batch_shares_table_across_threads) {
+    const auto table = make_main_opt_table();
+    constexpr int thread_count = 4;
+    std::vector<std::size_t> parsed(thread_count);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<std::vector<std::string>> argvs;
+            for(int i = 0; i < 500; ++i) {
+                argvs.push_back(split2vec("--help -s script" + std::to_string(i) + ".lua"));
+            }
+            std::vector<OptTable::InputArgv> commands(argvs.begin(), argvs.end());
+            ParsedBatch batch;
+            table.parse_batch(commands, batch);
+            for(std::size_t i = 0; i < batch.size(); ++i) {
+                if(batch.arguments(i).size() == 2 && batch.arguments(i)[1].values.size() == 1) {
+                    parsed[t] += 1;
+                }
+            }
+        });
+    }
+    for(auto& thread: threads) {
+        thread.join();
+    }
+    for(auto count: parsed) {
+        EXPECT_EQ(count, 500U);
+    }
+}
+
+TEST_CASE(parse_args_views_borrowed_argv) {
+    auto table = make_kinds_opt_table();
+    const char* raw = "-o out.o -xjoin value src.c";
+    std::vector<std::string_view> argv;
+    for(auto token: std::views::split(std::string_view(raw), ' ')) {
+        argv.emplace_back(token.begin(), token.end());
+    }
+
+    std::vector<ParsedArgument> args;
+    table.parse_args(argv, [&](std::expected<ParsedArgument, std::string> parsed) {
+        ASSERT_TRUE(parsed.has_value());
+        args.push_back(std::move(*parsed));
+    });
+    ASSERT_EQ(args.size(), 3U);
+    EXPECT_EQ(args[0].values[0], "out.o");
+    EXPECT_EQ(args[0].values[0].data(), raw + 3);
+    EXPECT_EQ(args[1].values[1].data(), argv[3].data());
+    EXPECT_EQ(args[2].get_spelling_view().data(), argv[4].data());
+}
+
+TEST_CASE(parse_cache_patches_inputs) {
+    auto table = make_kinds_opt_table();
+    std::vector<std::vector<std::string>> argvs;
+    for(int i = 0; i < 6; ++i) {
+        // Inputs of different lengths still share one entry.
+        auto n = std::to_string(i * 7);
+        argvs.push_back(split2vec("-jflag --list=a,b src" + n + ".c -o out" + n + ".o -xjoin x" + n));
+    }
+    argvs.push_back(split2vec("--pair one"));
+    argvs.push_back(split2vec("--pair two"));
+    argvs.push_back(split2vec("--rest a b"));
+    std::vector<OptTable::InputArgv> commands(argvs.begin(), argvs.end());
+
+    ParsedBatch expected;
+    table.parse_batch(commands, expected);
+
+    ParseCache cache(table);
+    ParsedBatch batch;
+    cache.parse_batch(commands, batch);
+    EXPECT_EQ(cache.size(), 3U);
+    EXPECT_EQ(cache.hits(), 6U);
+    EXPECT_EQ(cache.misses(), 3U);
+
+    ASSERT_EQ(batch.size(), expected.size());
+    for(std::size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(batch.command(i).missing_arg_count, expected.command(i).missing_arg_count);
+        EXPECT_EQ(batch.command(i).missing_arg_index, expected.command(i).missing_arg_index);
+        auto got = batch.arguments(i);
+        auto want = expected.arguments(i);
+        ASSERT_EQ(got.size(), want.size());
+        for(std::size_t k = 0; k < got.size(); ++k) {
+            EXPECT_EQ(got[k].option_id.id(), want[k].option_id.id());
+            EXPECT_EQ(got[k].index, want[k].index);
+            EXPECT_EQ(got[k].get_spelling_view(), want[k].get_spelling_view());
+            EXPECT_TRUE(got[k].values == want[k].values);
+        }
+    }
+
+    // Views point into the replayed command line, not the recorded one.
+    auto last = batch.arguments(5);
+    EXPECT_EQ(last[2].get_spelling_view(), "src35.c");
+    EXPECT_EQ(last[2].get_spelling_view().data(), argvs[5][2].data());
+    EXPECT_EQ(last[3].values[0], "out35.o");
+    EXPECT_EQ(last[4].values[1], "x35");
+    EXPECT_EQ(batch.command(7).missing_arg_count, 2U);
+}
+
+TEST_CASE(parse_cache_bypasses_grouped_tables) {
+    auto table = make_grouped_opt_table();
+    auto first = split2vec("-ab x.c");
+    auto second = split2vec("-ab y.c");
+    std::vector<OptTable::InputArgv> commands = {first, second};
+
+    ParseCache cache(table);
+    ParsedBatch batch;
+    cache.parse_batch(commands, batch);
+    EXPECT_EQ(cache.size(), 0U);
+    ASSERT_EQ(batch.arguments(1).size(), 3U);
+    EXPECT_EQ(batch.arguments(1)[1].option_id.id(), GROUPED_OPT_B);
+    EXPECT_EQ(batch.arguments(1)[2].get_spelling_view(), "y.c");
+}
+
+std::vector<std::string> drain(ResponseFile& file) {
+    std::vector<std::string> args;
+    while(auto arg = file.next()) {
+        args.emplace_back(*arg);
+    }
+    return args;
+}
+
+std::string write_response_file(std::string_view name, std::string_view text) {
+    auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+}
+
+TEST_CASE(response_file_gnu_quoting) {
+    auto file = ResponseFile::from_text("\xEF\xBB\xBF" R"(a 'b c'  "d\"e"
+f\ g '' h\\ "un)");
+    auto args = drain(file);
+    ASSERT_EQ(args.size(), 7U);
+    EXPECT_EQ(args[0], "a");
+    EXPECT_EQ(args[1], "b c");
+    EXPECT_EQ(args[2], "d\"e");
+    EXPECT_EQ(args[3], "f g");
+    EXPECT_EQ(args[4], "");
+    EXPECT_EQ(args[5], "h\\");
+    EXPECT_EQ(args[6], "un");
+}
+
+TEST_CASE(response_file_msvc_quoting) {
+    auto file = ResponseFile::from_text(R"(a "b c" d\"e "x""y" \\\\"q r" \\n C:\dir\)",
+                                        ResponseFileSyntax::MSVC);
+    auto args = drain(file);
+    ASSERT_EQ(args.size(), 7U);
+    EXPECT_EQ(args[0], "a");
+    EXPECT_EQ(args[1], "b c");
+    EXPECT_EQ(args[2], "d\"e");
+    EXPECT_EQ(args[3], "x\"y");
+    EXPECT_EQ(args[4], "\\\\q r");
+    EXPECT_EQ(args[5], "\\\\n");
+    EXPECT_EQ(args[6], "C:\\dir\\");
+}
+
+TEST_CASE(expand_response_files_nested) {
+    auto inner = write_response_file("kotatsu-option-inner.rsp", "-s 'script path.js'");
+    auto outer = write_response_file("kotatsu-option-outer.rsp", "--help @" + inner + " in.txt");
+    std::vector<std::string> argv = {"first", "@" + outer, "@kotatsu-option-missing.rsp", "last"};
+
+    auto expanded = expand_response_files(argv);
+    std::remove(inner.c_str());
+    std::remove(outer.c_str());
+    ASSERT_TRUE(expanded.has_value());
+    EXPECT_EQ(expanded->response_file_count(), 2U);
+
+    auto args = expanded->argv();
+    ASSERT_EQ(args.size(), 7U);
+    EXPECT_EQ(args[0].data(), argv[0].data());
+    EXPECT_EQ(args[1], "--help");
+    EXPECT_EQ(args[2], "-s");
+    EXPECT_EQ(args[3], "script path.js");
+    EXPECT_EQ(args[4], "in.txt");
+    EXPECT_EQ(args[5], "@kotatsu-option-missing.rsp");
+    EXPECT_EQ(args[6].data(), argv[3].data());
+
+    auto table = make_main_opt_table();
+    std::vector<ParsedArgumentOwning> parsed;
+    table.parse_args(args, [&](std::expected<ParsedArgument, std::string> arg) {
+        ASSERT_TRUE(arg.has_value());
+        parsed.emplace_back(ParsedArgumentOwning::from_parsed_argument(*arg));
+    });
+    ASSERT_EQ(parsed.size(), 6U);
+    EXPECT_EQ(parsed[1].option_id.id(), MAIN_OPT_HELP);
+    EXPECT_EQ(parsed[2].option_id.id(), MAIN_OPT_SCRIPT);
+    EXPECT_EQ(parsed[2].values[0], "script path.js");
+}
+
+TEST_CASE(expand_response_files_rejects_cycles) {
+    auto path = (std::filesystem::temp_directory_path() / "kotatsu-option-cycle.rsp").string();
+    write_response_file("kotatsu-option-cycle.rsp", "-x @" + path);
+    std::vector<std::string> argv = {"@" + path};
+
+    auto expanded = expand_response_files(argv);
+    std::remove(path.c_str());
+    ASSERT_FALSE(expanded.has_value());
+    EXPECT_TRUE(expanded.error().find("includes itself") != std::string::npos);
+
+    std::vector<std::string> plain = {"-s", "x"};
+    auto unchanged = expand_response_files(plain);
+    ASSERT_TRUE(unchanged.has_value());
+    EXPECT_EQ(unchanged->response_file_count(), 0U);
+    EXPECT_TRUE(unchanged->argv().is_writable());
+}
+
 TEST_CASE(option_kinds_parse_expected_values) {
     auto table = make_kinds_opt_table();
 
@@ -150,14 +150,14 @@ TEST_CASE(copy_owned_deep_copies) {
 }
 
 TEST_CASE(move_transfers_ownership) {
-    cow_string a = cow_string::owned(string_ref{"move me"});
+    cow_string a = cow_string::owned(string_ref{"move me off the heap"});
     const char* original_data = a.data();
 
     cow_string b{std::move(a)};
 
     EXPECT_TRUE(b.is_owned());
     EXPECT_EQ(b.data(), original_data);
-    EXPECT_EQ(b.ref(), "move me");
+    EXPECT_EQ(b.ref(), "move me off the heap");
 
     EXPECT_TRUE(a.empty());
     EXPECT_EQ(a.data(), nullptr);
@@ -185,14 +185,14 @@ TEST_CASE(copy_assignment) {
 }
 
 TEST_CASE(move_assignment) {
-    cow_string a = cow_string::owned(string_ref{"transfer"});
+    cow_string a = cow_string::owned(string_ref{"transfer the heap buffer"});
     const char* data = a.data();
     cow_string b;
     b = std::move(a);
 
     EXPECT_TRUE(b.is_owned());
     EXPECT_EQ(b.data(), data);
-    EXPECT_EQ(b.ref(), "transfer");
+    EXPECT_EQ(b.ref(), "transfer the heap buffer");
     EXPECT_TRUE(a.empty());
 }
 
@@ -283,7 +283,7 @@ TEST_CASE(self_assignment) {
 }
 
 TEST_CASE(release_owned) {
-    cow_string s = cow_string::owned(string_ref{"release me"});
+    cow_string s = cow_string::owned(string_ref{"release me from the heap"});
     const char* data = s.data();
 
     small_string<0> ss = s.release();
@@ -295,7 +295,7 @@ TEST_CASE(release_owned) {
 
     // small_string holds the buffer without copy.
     EXPECT_EQ(ss.data(), data);
-    EXPECT_EQ(ss.ref(), "release me");
+    EXPECT_EQ(ss.ref(), "release me from the heap");
 }
 
 TEST_CASE(release_borrowed_makes_copy) {
@@ -341,6 +341,63 @@ TEST_CASE(release_borrowed_fits_inline) {
     EXPECT_EQ(ss.ref(), "hi");
 }
 
+TEST_CASE(short_owned_is_inline) {
+    // A 12-byte identifier, promoted without touching the heap.
+    const char* literal = "textDocument";
+    cow_string s{string_ref{literal}};
+    s.make_owned();
+
+    EXPECT_TRUE(s.is_owned());
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(s.ref(), "textDocument");
+    const auto* object = reinterpret_cast<const char*>(&s);
+    EXPECT_TRUE(s.data() >= object && s.data() < object + sizeof(s));
+
+    // Copies and moves carry the characters along.
+    cow_string copy{s};
+    EXPECT_TRUE(copy.is_inline());
+    EXPECT_EQ(copy.ref(), "textDocument");
+    cow_string moved{std::move(copy)};
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(moved.ref(), "textDocument");
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(copy.is_borrowed());
+
+    moved.swap(s);
+    EXPECT_EQ(s.ref(), "textDocument");
+}
+
+TEST_CASE(inline_capacity_boundary) {
+    std::string fits(cow_string::inline_capacity, 'x');
+    std::string spills(cow_string::inline_capacity + 1, 'y');
+
+    auto a = cow_string::owned(string_ref{fits});
+    auto b = cow_string::owned(string_ref{spills});
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_FALSE(b.is_inline());
+    EXPECT_TRUE(b.is_owned());
+    EXPECT_EQ(a.size(), fits.size());
+    EXPECT_EQ(b.ref(), string_ref{spills});
+
+    a = b;
+    EXPECT_FALSE(a.is_inline());
+    EXPECT_EQ(a.ref(), string_ref{spills});
+    b = cow_string::owned(string_ref{"short"});
+    EXPECT_TRUE(b.is_inline());
+    EXPECT_EQ(b.ref(), "short");
+}
+
+TEST_CASE(release_inline_into_small_string) {
+    cow_string s = cow_string::owned(string_ref{"uri"});
+    ASSERT_TRUE(s.is_inline());
+
+    small_string<16> ss = s.release<16>();
+    EXPECT_TRUE(ss.inlined());
+    EXPECT_EQ(ss.ref(), "uri");
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(s.is_borrowed());
+}
+
 };  // TEST_SUITE(cow_string)
 
 }  // namespace
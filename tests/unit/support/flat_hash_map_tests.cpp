@@ -0,0 +1,182 @@
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/support/flat_hash_map.h"
+#include "kota/support/ranges.h"
+
+namespace kota {
+
+namespace {
+
+/// Sends every key to the same group so probing and tombstones get used.
+struct colliding_hash {
+    std::size_t operator()(int) const noexcept {
+        return 0;
+    }
+};
+
+static_assert(map_range<flat_hash_map<std::string, int>>);
+static_assert(unordered_map_range<flat_hash_map<std::string, int>>);
+static_assert(unordered_set_range<flat_hash_set<int>>);
+
+TEST_SUITE(flat_hash_map) {
+
+TEST_CASE(insert_find_erase) {
+    flat_hash_map<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.find(1) == map.end());
+
+    for(int i = 0; i < 1000; ++i) {
+        auto [it, inserted] = map.try_emplace(i, std::to_string(i));
+        EXPECT_TRUE(inserted);
+        EXPECT_EQ(it->first, i);
+    }
+    ASSERT_EQ(map.size(), 1000U);
+    EXPECT_FALSE(map.try_emplace(7, "seven").second);
+    EXPECT_EQ(map.at(7), "7");
+
+    for(int i = 0; i < 1000; i += 2) {
+        EXPECT_EQ(map.erase(i), 1U);
+    }
+    EXPECT_EQ(map.erase(0), 0U);
+    EXPECT_EQ(map.size(), 500U);
+    for(int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(map.contains(i), i % 2 == 1);
+    }
+
+    std::size_t visited = 0;
+    for(const auto& [key, value]: map) {
+        EXPECT_EQ(value, std::to_string(key));
+        visited += 1;
+    }
+    EXPECT_EQ(visited, 500U);
+}
+
+TEST_CASE(heterogeneous_lookup) {
+    flat_hash_map<std::string, int> map;
+    map["textDocument/hover"] = 1;
+    map.insert_or_assign(std::string_view("textDocument/definition"), 2);
+    map.insert_or_assign("textDocument/hover", 3);
+
+    std::string_view method = "textDocument/hover";
+    auto it = map.find(method);
+    ASSERT_TRUE(it != map.end());
+    EXPECT_EQ(it->second, 3);
+    EXPECT_TRUE(map.contains("textDocument/definition"));
+    EXPECT_EQ(map.count(std::string_view("missing")), 0U);
+    EXPECT_EQ(map.erase(std::string_view("textDocument/definition")), 1U);
+    EXPECT_EQ(map.size(), 1U);
+}
+
+TEST_CASE(collisions_and_tombstones) {
+    flat_hash_map<int, int, colliding_hash> map;
+    for(int round = 0; round < 50; ++round) {
+        for(int i = 0; i < 40; ++i) {
+            map[i] = round;
+        }
+        for(int i = 0; i < 40; i += 3) {
+            map.erase(i);
+        }
+    }
+    for(int i = 0; i < 40; ++i) {
+        auto it = map.find(i);
+        if(i % 3 == 0) {
+            EXPECT_TRUE(it == map.end());
+        } else {
+            ASSERT_TRUE(it != map.end());
+            EXPECT_EQ(it->second, 49);
+        }
+    }
+}
+
+TEST_CASE(matches_unordered_map) {
+    std::mt19937 random(42);
+    flat_hash_map<std::uint32_t, int> map;
+    std::unordered_map<std::uint32_t, int> expected;
+    for(int i = 0; i < 20000; ++i) {
+        const auto key = random() % 2048;
+        if(random() % 3 == 0) {
+            EXPECT_EQ(map.erase(key), expected.erase(key));
+        } else {
+            map[key] = i;
+            expected[key] = i;
+        }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    for(const auto& [key, value]: expected) {
+        auto it = map.find(key);
+        ASSERT_TRUE(it != map.end());
+        EXPECT_EQ(it->second, value);
+    }
+}
+
+TEST_CASE(inline_slots) {
+    flat_hash_map<std::string, std::unique_ptr<int>, flat_hash<std::string>, std::equal_to<>, 8>
+        map;
+    EXPECT_TRUE(map.inlined());
+    for(int i = 0; i < 7; ++i) {
+        map.try_emplace(std::to_string(i), std::make_unique<int>(i));
+    }
+    EXPECT_TRUE(map.inlined());
+    EXPECT_EQ(map.capacity(), 8U);
+
+    auto moved = std::move(map);
+    EXPECT_TRUE(moved.inlined());
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(*moved.at("3"), 3);
+
+    for(int i = 7; i < 40; ++i) {
+        moved.try_emplace(std::to_string(i), std::make_unique<int>(i));
+    }
+    EXPECT_FALSE(moved.inlined());
+    for(int i = 0; i < 40; ++i) {
+        EXPECT_EQ(*moved.at(std::to_string(i)), i);
+    }
+}
+
+TEST_CASE(copy_and_compare) {
+    flat_hash_map<std::string, int> map{
+        {"a", 1},
+        {"b", 2},
+        {"c", 3},
+    };
+    auto copy = map;
+    EXPECT_TRUE(copy == map);
+    copy["b"] = 5;
+    EXPECT_FALSE(copy == map);
+
+    map = copy;
+    EXPECT_EQ(map.at("b"), 5);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.begin() == map.end());
+    map.reserve(100);
+    EXPECT_GE(map.capacity(), 100U);
+}
+
+TEST_CASE(set_operations) {
+    flat_hash_set<std::string> set{"alpha", "beta"};
+    EXPECT_TRUE(set.insert("gamma").second);
+    EXPECT_FALSE(set.insert(std::string("alpha")).second);
+    EXPECT_TRUE(set.contains(std::string_view("beta")));
+    EXPECT_EQ(set.erase(std::string_view("beta")), 1U);
+    EXPECT_EQ(set.size(), 2U);
+
+    std::map<std::string, int> seen;
+    for(const auto& value: set) {
+        seen[value] += 1;
+    }
+    EXPECT_EQ(seen, (std::map<std::string, int>{{"alpha", 1}, {"gamma", 1}}));
+}
+
+};  // TEST_SUITE(flat_hash_map)
+
+}  // namespace
+
+}  // namespace kota
@@ -661,6 +661,64 @@ TEST_CASE(mem_fn_const) {
     EXPECT_EQ((a.*ptr)(5), 15);
 };
 
+TEST_CASE(function_custom_inline_bytes) {
+    auto text = std::make_shared<std::string>("shared");
+    auto lambda = [name = std::string("captured"), text](int x) {
+        return static_cast<int>(name.size() + text->size()) + x;
+    };
+    static_assert(!function<int(int)>::sbo_eligible<decltype(lambda)>);
+    static_assert(function<int(int), 64>::sbo_eligible<decltype(lambda)>);
+
+    function<int(int), 64> fn1(std::move(lambda));
+    function<int(int), 64> fn2(std::move(fn1));
+    EXPECT_EQ(fn2(1), 15);
+    EXPECT_EQ(text.use_count(), 2);
+
+    function<int(int), 64> fn3(free_negate);
+    fn3 = std::move(fn2);
+    EXPECT_EQ(fn3(0), 14);
+};
+
+TEST_CASE(unique_function_destroys_on_call) {
+    int counter = 0;
+    unique_function<int(int)> fn(TrackedCallable{&counter, 4});
+    EXPECT_EQ(counter, 1);
+    ASSERT_TRUE(static_cast<bool>(fn));
+    EXPECT_EQ(std::move(fn)(1), 5);
+    EXPECT_EQ(counter, 0);
+    EXPECT_FALSE(static_cast<bool>(fn));
+
+    unique_function<int(int)> large(LargeTrackedCallable{&counter, 2});
+    EXPECT_EQ(counter, 1);
+    EXPECT_EQ(std::move(large)(1), 3);
+    EXPECT_EQ(counter, 0);
+};
+
+TEST_CASE(unique_function_move_only_capture) {
+    auto value = std::make_unique<std::string>("payload");
+    unique_function<std::string(), 48> fn([value = std::move(value), suffix = std::string("!")] {
+        return *value + suffix;
+    });
+    unique_function<std::string(), 48> moved(std::move(fn));
+    EXPECT_FALSE(static_cast<bool>(fn));
+    EXPECT_EQ(std::move(moved)(), "payload!");
+};
+
+TEST_CASE(unique_function_release_uncalled) {
+    int counter = 0;
+    {
+        unique_function<void()> small([tc = TrackedCallable{&counter, 0}] {});
+        unique_function<void()> large([tc = LargeTrackedCallable{&counter, 0}] {});
+        EXPECT_EQ(counter, 2);
+        small = std::move(large);
+        EXPECT_EQ(counter, 1);
+    }
+    EXPECT_EQ(counter, 0);
+
+    unique_function<int(int, int)> fnptr(free_add);
+    EXPECT_EQ(std::move(fnptr)(2, 3), 5);
+};
+
 };  // TEST_SUITE(functional)
 
 }  // namespace
@@ -0,0 +1,80 @@
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/support/interned_string.h"
+
+namespace kota {
+
+namespace {
+
+TEST_SUITE(interned_string) {
+
+TEST_CASE(equal_text_shares_storage) {
+    string_pool pool;
+    std::string first = "file:///workspace/src/main.cpp";
+    std::string second = first;
+
+    auto a = pool.intern(first);
+    auto b = pool.intern(second);
+    EXPECT_EQ(a, b);
+    EXPECT_TRUE(a.data() == b.data());
+    EXPECT_TRUE(a.data() != first.data());
+    EXPECT_EQ(std::string_view(a), first);
+    EXPECT_EQ(pool.size(), 1U);
+
+    auto c = pool.intern("file:///workspace/src/util.cpp");
+    EXPECT_NE(a, c);
+    EXPECT_TRUE(a < c);
+    EXPECT_EQ(pool.size(), 2U);
+}
+
+TEST_CASE(empty_needs_no_pool) {
+    string_pool pool;
+    interned_string none;
+    EXPECT_TRUE(none.empty());
+    EXPECT_EQ(pool.intern(""), none);
+    EXPECT_EQ(pool.size(), 0U);
+}
+
+TEST_CASE(pools_compare_by_text) {
+    string_pool left;
+    string_pool right;
+    auto a = left.intern("cpp");
+    auto b = right.intern("cpp");
+    EXPECT_TRUE(a.data() != b.data());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(std::hash<interned_string>{}(a), std::hash<interned_string>{}(b));
+
+    std::unordered_set<interned_string> seen{a};
+    EXPECT_TRUE(seen.contains(b));
+}
+
+TEST_CASE(concurrent_interning) {
+    string_pool pool;
+    std::vector<std::thread> threads;
+    std::vector<const char*> results(8);
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&, i] {
+            for(int round = 0; round < 100; ++round) {
+                results[i] = pool.intern("clangd").data();
+            }
+        });
+    }
+    for(auto& thread: threads) {
+        thread.join();
+    }
+    for(const auto* data: results) {
+        EXPECT_TRUE(data == results.front());
+    }
+    EXPECT_EQ(pool.size(), 1U);
+}
+
+};  // TEST_SUITE(interned_string)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,142 @@
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/support/memory.h"
+
+namespace kota::mem {
+
+namespace {
+
+struct tracked {
+    inline static int alive = 0;
+
+    std::string name;
+    int value;
+
+    tracked(std::string name, int value) : name(std::move(name)), value(value) {
+        alive += 1;
+    }
+
+    ~tracked() {
+        alive -= 1;
+    }
+};
+
+static_assert(slab_block_size(1) == 16);
+static_assert(slab_block_size(129) == 160);
+static_assert(slab_block_size(1000) == 1024);
+static_assert(slab_block_size(4096) == 4096);
+
+TEST_SUITE(memory) {
+
+TEST_CASE(slab_reuses_blocks) {
+    std::vector<void*> blocks;
+    for(int i = 0; i < 1000; ++i) {
+        auto* block = slab_allocate(48);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % slab_alignment, 0U);
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), blocks.size());
+
+    for(auto* block: blocks) {
+        slab_deallocate(block, 48);
+    }
+    // A freed block is the next one handed out for its class.
+    auto* again = slab_allocate(40);
+    EXPECT_EQ(again, blocks.back());
+    slab_deallocate(again, 40);
+
+    auto* large = slab_allocate(slab_max_size + 1);
+    slab_deallocate(large, slab_max_size + 1);
+    slab_deallocate(nullptr, 16);
+}
+
+TEST_CASE(object_pool_lifetimes) {
+    auto* first = object_pool<tracked>::create("first", 1);
+    auto* second = object_pool<tracked>::create("second", 2);
+    EXPECT_EQ(tracked::alive, 2);
+    EXPECT_EQ(first->name, "first");
+    EXPECT_EQ(second->value, 2);
+
+    object_pool<tracked>::destroy(first);
+    EXPECT_EQ(tracked::alive, 1);
+    auto* third = object_pool<tracked>::create("third", 3);
+    EXPECT_TRUE(third == first);
+
+    object_pool<tracked>::destroy(second);
+    object_pool<tracked>::destroy(third);
+    object_pool<tracked>::destroy(nullptr);
+    EXPECT_EQ(tracked::alive, 0);
+}
+
+TEST_CASE(remote_free) {
+    // Blocks carved here and freed on other threads come back to this
+    // thread's cache.
+    std::vector<void*> blocks;
+    for(int i = 0; i < 256; ++i) {
+        blocks.push_back(slab_allocate(96));
+    }
+    std::vector<std::thread> workers;
+    for(int worker = 0; worker < 4; ++worker) {
+        workers.emplace_back([&, worker] {
+            for(std::size_t i = worker; i < blocks.size(); i += 4) {
+                slab_deallocate(blocks[i], 96);
+            }
+        });
+    }
+    for(auto& worker: workers) {
+        worker.join();
+    }
+
+    // Blocks made on other threads and freed here go back to those.
+    std::vector<tracked*> objects(64);
+    std::thread maker([&] {
+        for(auto& object: objects) {
+            object = object_pool<tracked>::create("remote", 7);
+        }
+    });
+    maker.join();
+    for(auto* object: objects) {
+        EXPECT_EQ(object->value, 7);
+        object_pool<tracked>::destroy(object);
+    }
+    EXPECT_EQ(tracked::alive, 0);
+
+    // The cache takes the remote frees when its free list runs dry.
+    const std::set<void*> freed(blocks.begin(), blocks.end());
+    std::size_t recovered = 0;
+    std::vector<void*> reused;
+    for(int i = 0; i < 2000 && recovered < blocks.size(); ++i) {
+        auto* block = slab_allocate(96);
+        recovered += freed.contains(block);
+        reused.push_back(block);
+    }
+    EXPECT_EQ(recovered, blocks.size());
+    for(auto* block: reused) {
+        slab_deallocate(block, 96);
+    }
+}
+
+TEST_CASE(slab_allocator_in_containers) {
+    std::vector<int, slab_allocator<int>> values;
+    for(int i = 0; i < 10000; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values[9999], 9999);
+    EXPECT_TRUE(slab_allocator<int>() == slab_allocator<long>());
+
+    auto* data = allocate<int, slab_allocator<int>>(8);
+    data[7] = 3;
+    deallocate<int, slab_allocator<int>>(data, 8);
+}
+
+};  // TEST_SUITE(memory)
+
+}  // namespace
+
+}  // namespace kota::mem
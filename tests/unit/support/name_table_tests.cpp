@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/meta/name_id.h"
+#include "kota/support/name_table.h"
+
+namespace kota {
+
+namespace {
+
+struct widget {};
+
+static_assert(sizeof(name_id) == 4);
+
+TEST_SUITE(name_table) {
+
+TEST_CASE(intern_deduplicates) {
+    name_table table;
+    auto alpha = table.intern("alpha");
+    auto beta = table.intern("beta");
+    EXPECT_EQ(alpha.value(), 1U);
+    EXPECT_EQ(beta.value(), 2U);
+    EXPECT_TRUE(table.intern(std::string("alpha")) == alpha);
+    EXPECT_EQ(table.size(), 2U);
+
+    EXPECT_EQ(table.view(alpha), "alpha");
+    EXPECT_EQ(table.view(beta), "beta");
+    EXPECT_TRUE(table.intern("").empty());
+    EXPECT_EQ(table.view(name_id()), "");
+
+    EXPECT_TRUE(table.find("beta") == beta);
+    EXPECT_FALSE(table.find("gamma").has_value());
+    EXPECT_EQ(table.size(), 2U);
+}
+
+TEST_CASE(views_stay_valid) {
+    name_table table;
+    std::vector<name_id> ids;
+    std::vector<std::string> names;
+    // Past one segment of entries and one page of text.
+    for(int i = 0; i < 10000; ++i) {
+        names.push_back("name_" + std::to_string(i) + std::string(i % 13, 'x'));
+        ids.push_back(table.intern(names.back()));
+    }
+    auto first = table.view(ids.front());
+    names.push_back(std::string(100000, 'y'));
+    ids.push_back(table.intern(names.back()));
+
+    EXPECT_EQ(first, names.front());
+    for(std::size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(table.view(ids[i]), names[i]);
+    }
+}
+
+TEST_CASE(static_names) {
+    auto flush = static_name<"loop.flush">();
+    EXPECT_TRUE(static_name<"loop.flush">() == flush);
+    EXPECT_TRUE(name_table::global().intern("loop.flush") == flush);
+    EXPECT_EQ(flush.view(), "loop.flush");
+    EXPECT_FALSE(static_name<"loop.poll">() == flush);
+
+    auto type = meta::type_name_id<widget>();
+    EXPECT_EQ(type.view(), "widget");
+    EXPECT_TRUE(meta::type_name_id<widget>() == type);
+}
+
+TEST_CASE(concurrent_intern) {
+    name_table table;
+    constexpr int thread_count = 4;
+    constexpr int name_count = 2000;
+    std::vector<std::vector<name_id>> results(thread_count);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for(int i = 0; i < name_count; ++i) {
+                auto id = table.intern("shared_" + std::to_string(i));
+                results[t].push_back(id);
+                // Readers never lock, so check them against concurrent writers.
+                if(table.view(id) != "shared_" + std::to_string(i)) {
+                    results[t].back() = name_id();
+                }
+            }
+        });
+    }
+    for(auto& thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(table.size(), static_cast<std::size_t>(name_count));
+    for(int t = 1; t < thread_count; ++t) {
+        EXPECT_TRUE(results[t] == results[0]);
+    }
+    for(auto id: results[0]) {
+        EXPECT_FALSE(id.empty());
+    }
+}
+
+};  // TEST_SUITE(name_table)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/support/rope.h"
+
+namespace kota {
+
+namespace {
+
+/// Checks every cached count of `text` against a scan of `expected`.
+void expect_matches(const rope& text, std::string_view expected) {
+    ASSERT_EQ(text.size(), expected.size());
+    EXPECT_TRUE(text == expected);
+    EXPECT_EQ(text.metrics(), rope_metrics::of(expected));
+
+    std::size_t line = 0;
+    for(std::size_t offset = 0; offset <= expected.size(); offset += 7) {
+        EXPECT_EQ(text.measure(offset), rope_metrics::of(expected.substr(0, offset)));
+    }
+    for(std::size_t offset = 0; offset < expected.size(); ++offset) {
+        if(offset == 0 || expected[offset - 1] == '\n') {
+            EXPECT_EQ(text.line_start(line), offset);
+            line += 1;
+        }
+    }
+}
+
+TEST_SUITE(rope) {
+
+TEST_CASE(build_and_read) {
+    std::string expected;
+    for(int i = 0; i < 500; ++i) {
+        expected += "line " + std::to_string(i) + " \xe4\xbd\xa0\xf0\x9f\x98\x80\n";
+    }
+    rope text(expected);
+    expect_matches(text, expected);
+    EXPECT_EQ(text.line_count(), 501U);
+    EXPECT_EQ(text.substr(5, 3), expected.substr(5, 3));
+    EXPECT_EQ(text.at(expected.size() - 1), '\n');
+    EXPECT_EQ(text.str(), expected);
+
+    // Every chunk ends on a code point boundary.
+    text.for_each_chunk([](std::string_view chunk) {
+        EXPECT_TRUE(chunk.size() <= rope::chunk_size);
+        EXPECT_TRUE((static_cast<unsigned char>(chunk.front()) & 0xC0u) != 0x80u);
+    });
+}
+
+TEST_CASE(random_edits) {
+    std::mt19937 random(11);
+    std::string expected(10000, 'a');
+    rope text(expected);
+    const std::string_view inserts[] = {"", "x", "\n", "\xc3\xa9\n"};
+    for(int round = 0; round < 2000; ++round) {
+        const auto begin = random() % (expected.size() + 1);
+        const auto span = std::min<std::size_t>(expected.size() - begin, 300);
+        const auto end = begin + random() % (span + 1);
+        // Mostly small typing edits, with an occasional large paste.
+        std::string insert(round % 97 == 0 ? expected.substr(0, 3000) : inserts[random() % 4]);
+        text.replace(begin, end, insert);
+        expected.replace(begin, end - begin, insert);
+        if(expected.size() > 40000) {
+            text.erase(20000, expected.size());
+            expected.resize(20000);
+        }
+    }
+    expect_matches(text, expected);
+}
+
+TEST_CASE(seek_units) {
+    // One byte, two, three and four byte code points.
+    rope text("a\xc3\xa9\xe4\xbd\xa0\xf0\x9f\x98\x80z");
+    EXPECT_EQ(text.seek(&rope_metrics::codepoints, 0), 0U);
+    EXPECT_EQ(text.seek(&rope_metrics::codepoints, 2), 3U);
+    EXPECT_EQ(text.seek(&rope_metrics::codepoints, 4), 10U);
+    EXPECT_EQ(text.seek(&rope_metrics::utf16, 3), 6U);
+    // Four UTF-16 units fall inside the surrogate pair: the seek stops in
+    // front of it, one unit short.
+    EXPECT_EQ(text.seek(&rope_metrics::utf16, 4), 6U);
+    EXPECT_EQ(text.measure(6).utf16, 3U);
+    EXPECT_EQ(text.seek(&rope_metrics::utf16, 5), 10U);
+    EXPECT_EQ(text.seek(&rope_metrics::utf16, 100), text.size());
+}
+
+TEST_CASE(copy_and_clear) {
+    rope text(std::string(5000, 'q'));
+    rope copy = text;
+    copy.insert(2500, "\n");
+    EXPECT_EQ(text.line_count(), 1U);
+    EXPECT_EQ(copy.line_count(), 2U);
+    EXPECT_FALSE(copy == text);
+
+    text = copy;
+    EXPECT_TRUE(text == copy);
+    text.clear();
+    EXPECT_TRUE(text.empty());
+    EXPECT_EQ(text.measure(0), rope_metrics{});
+    text.insert(0, "abc");
+    EXPECT_TRUE(text == std::string_view("abc"));
+}
+
+TEST_CASE(copies_are_snapshots) {
+    std::mt19937 random(11);
+    std::string expected(20000, 'a');
+    rope text(expected);
+
+    std::vector<std::pair<rope, std::string>> snapshots;
+    for(int step = 0; step < 400; ++step) {
+        if(step % 50 == 0) {
+            snapshots.emplace_back(text, expected);
+        }
+        auto begin = random() % (expected.size() + 1);
+        auto end = std::min<std::size_t>(begin + random() % 3000, expected.size());
+        std::string inserted(random() % (step % 7 == 0 ? 4000 : 20), 'b');
+        text.replace(begin, end, inserted);
+        expected.replace(begin, end - begin, inserted);
+    }
+    expect_matches(text, expected);
+
+    // Edits to the original never reach the copies taken before them.
+    for(const auto& [snapshot, contents]: snapshots) {
+        expect_matches(snapshot, contents);
+    }
+}
+
+TEST_CASE(copy_read_on_another_thread) {
+    std::string expected(50000, 'x');
+    rope text(expected);
+    rope copy = text;
+
+    bool unchanged = true;
+    std::thread reader([&] {
+        for(int round = 0; round < 20; ++round) {
+            unchanged = unchanged && copy == expected;
+        }
+    });
+    for(int step = 0; step < 1000; ++step) {
+        text.insert(static_cast<std::size_t>(step) * 37 % text.size(), "y\n");
+    }
+    reader.join();
+    EXPECT_TRUE(unchanged);
+    EXPECT_EQ(text.size(), expected.size() + 2000);
+}
+
+};  // TEST_SUITE(rope)
+
+}  // namespace
+
+}  // namespace kota
@@ -0,0 +1,118 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kota/zest/zest.h"
+#include "kota/support/simd.h"
+
+namespace kota::simd {
+
+namespace {
+
+/// Text of `size` bytes, mostly lowercase letters with some uppercase and
+/// arbitrary bytes, so every kernel sees runs and hits in both the vector
+/// and the tail loops.
+std::string random_text(std::mt19937& random, std::size_t size) {
+    std::string text(size, 'a');
+    for(auto& byte: text) {
+        auto kind = random() % 10;
+        if(kind < 6) {
+            byte = static_cast<char>('a' + random() % 26);
+        } else if(kind < 8) {
+            byte = static_cast<char>('A' + random() % 26);
+        } else {
+            byte = static_cast<char>(random() % 256);
+        }
+    }
+    return text;
+}
+
+std::size_t or_size(std::string_view text, std::size_t found) {
+    return found == std::string_view::npos ? text.size() : found;
+}
+
+TEST_SUITE(simd) {
+
+TEST_CASE(find_byte_and_substring) {
+    std::mt19937 random(7);
+    for(int round = 0; round < 2000; ++round) {
+        auto text = random_text(random, random() % 100);
+        std::string_view view = text;
+        auto from = random() % (text.size() + 1);
+        EXPECT_EQ(find_byte(view, 'q', from), or_size(view, view.find('q', from)));
+
+        std::string needle = "xy";
+        if(text.size() > 4) {
+            needle = text.substr(random() % (text.size() - 4), 1 + random() % 4);
+        }
+        EXPECT_EQ(simd::find(view, needle, from), or_size(view, view.find(needle, from)));
+    }
+
+    EXPECT_EQ(simd::find("Content-Length: 5\r\n\r\n{}", "\r\n\r\n"), 17U);
+    EXPECT_EQ(simd::find("abc", "", 2), 2U);
+    EXPECT_EQ(find_byte("abc", 'a', 5), 3U);
+}
+
+TEST_CASE(byte_set_search) {
+    constexpr auto set = byte_set("\"#%<>?").insert_range(0x00, 0x20).insert_range(0x7F, 0xFF);
+    static_assert(set.contains('#') && set.contains(0x80) && !set.contains('a'));
+    static_assert((~set).contains('a') && !(~set).contains(' '));
+
+    std::mt19937 random(11);
+    for(int round = 0; round < 2000; ++round) {
+        auto text = random_text(random, random() % 100);
+        auto from = random() % (text.size() + 1);
+        auto expected = text.size();
+        for(auto index = from; index < text.size(); ++index) {
+            if(set.contains(static_cast<unsigned char>(text[index]))) {
+                expected = index;
+                break;
+            }
+        }
+        EXPECT_EQ(find_first_of(text, set, from), expected);
+    }
+}
+
+TEST_CASE(each_byte) {
+    std::mt19937 random(3);
+    for(int round = 0; round < 500; ++round) {
+        auto text = random_text(random, random() % 200);
+        std::vector<std::size_t> expected;
+        for(std::size_t index = 0; index < text.size(); ++index) {
+            if(text[index] == 'e') {
+                expected.push_back(index);
+            }
+        }
+        std::vector<std::size_t> found;
+        for_each_byte(text, 'e', [&](std::size_t index) { found.push_back(index); });
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST_CASE(ascii_and_case) {
+    std::string text(70, 'x');
+    EXPECT_TRUE(is_ascii(text));
+    text[41] = '\xC3';
+    EXPECT_EQ(ascii_prefix(text), 41U);
+    EXPECT_FALSE(is_ascii(text));
+
+    EXPECT_TRUE(iequals_ascii("Content-Length", "content-length"));
+    EXPECT_FALSE(iequals_ascii("Content-Length", "content-lengtx"));
+    EXPECT_FALSE(iequals_ascii("abc", "abcd"));
+    // Only ASCII letters fold: '@' and '`' sit next to them.
+    EXPECT_FALSE(iequals_ascii("@", "`"));
+
+    std::string upper = "THE-QUICK-BROWN-FOX-JUMPS-OVER-THE-LAZY-DOG-\xC3\x89";
+    std::string lower = "the-quick-brown-fox-jumps-over-the-lazy-dog-\xC3\x89";
+    EXPECT_TRUE(iequals_ascii(upper, lower));
+    lower[20] = 'X';
+    EXPECT_FALSE(iequals_ascii(upper, lower));
+}
+
+};  // TEST_SUITE(simd)
+
+}  // namespace
+
+}  // namespace kota::simd
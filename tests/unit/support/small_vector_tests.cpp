@@ -2,9 +2,11 @@
 #include <array>
 #include <numeric>
 #include <optional>
+#include <memory>
 #include <ranges>
 #include <string>
 #include <variant>
+#include <vector>
 
 #ifdef __cpp_exceptions
 #include <stdexcept>
@@ -88,6 +90,70 @@ struct nontrivial {
     auto operator<=>(const nontrivial& rhs) const = default;
 };
 
+/// Counts the constructors and destructors that bitwise relocation skips.
+struct relocatable {
+    inline thread_local static int alive = 0;
+    inline thread_local static int moves = 0;
+    inline thread_local static bool throw_on_copy = false;
+
+    std::unique_ptr<int> value;
+
+    explicit relocatable(int v) : value(std::make_unique<int>(v)) {
+        ++alive;
+    }
+
+    relocatable(const relocatable& other) {
+#ifdef __cpp_exceptions
+        if(throw_on_copy) {
+            throw std::runtime_error("copy failed");
+        }
+#endif
+        value = std::make_unique<int>(*other.value);
+        ++alive;
+    }
+
+    relocatable(relocatable&& other) noexcept : value(std::move(other.value)) {
+        ++alive;
+        ++moves;
+    }
+
+    relocatable& operator=(const relocatable& other) {
+        value = std::make_unique<int>(*other.value);
+        return *this;
+    }
+
+    relocatable& operator=(relocatable&& other) noexcept {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+
+    ~relocatable() {
+        --alive;
+    }
+};
+
+}  // namespace
+
+template <>
+struct mem::is_trivially_relocatable<relocatable> : std::true_type {};
+
+namespace {
+
+static_assert(mem::is_trivially_relocatable_v<std::unique_ptr<int>>);
+static_assert(mem::is_trivially_relocatable_v<relocatable>);
+static_assert(!mem::is_trivially_relocatable_v<std::unique_ptr<int, void (*)(int*)>>);
+static_assert(!mem::is_trivially_relocatable_v<small_vector<int, 0>>);
+static_assert(!mem::is_trivially_relocatable_v<small_vector<int, 4>>);
+
+auto values_of(const small_vector<relocatable, 2>& values) {
+    std::vector<int> out;
+    for(const auto& value: values) {
+        out.push_back(*value.value);
+    }
+    return out;
+}
+
 constexpr bool constexpr_int_operations() {
     small_vector<int, 4> values{1, 2, 3};
     std::array<int, 2> tail = {4, 5};
@@ -1459,6 +1525,75 @@ TEST_CASE(exception_safety) {
 
 #endif  // __cpp_exceptions
 
+TEST_CASE(relocatable_growth) {
+    relocatable::moves = 0;
+    {
+        small_vector<relocatable, 2> values;
+        for(int i = 0; i < 64; ++i) {
+            values.emplace_back(i);
+        }
+        values.shrink_to_fit();
+        EXPECT_EQ(relocatable::moves, 0);
+        EXPECT_EQ(relocatable::alive, 64);
+        EXPECT_EQ(*values.front().value, 0);
+        EXPECT_EQ(*values.back().value, 63);
+    }
+    EXPECT_EQ(relocatable::alive, 0);
+}
+
+TEST_CASE(relocatable_insert_erase) {
+    {
+        small_vector<relocatable, 2> values;
+        values.emplace_back(1);
+        values.emplace_back(4);
+        const relocatable two(2);
+        values.insert(values.begin() + 1, two);
+        values.insert(values.begin() + 2, relocatable(3));
+        values.insert(values.begin(), 2, relocatable(0));
+        EXPECT_EQ(values_of(values), (std::vector<int>{0, 0, 1, 2, 3, 4}));
+
+        relocatable::moves = 0;
+        values.erase(values.begin(), values.begin() + 2);
+        values.erase(values.begin() + 1);
+        EXPECT_EQ(relocatable::moves, 0);
+        EXPECT_EQ(values_of(values), (std::vector<int>{1, 3, 4}));
+        EXPECT_EQ(relocatable::alive, 4);
+    }
+    EXPECT_EQ(relocatable::alive, 0);
+
+    small_vector<std::unique_ptr<int>, 1> owners;
+    for(int i = 0; i < 8; ++i) {
+        owners.insert(owners.begin(), std::make_unique<int>(i));
+    }
+    owners.erase(owners.begin() + 2, owners.begin() + 6);
+    ASSERT_EQ(owners.size(), 4U);
+    EXPECT_EQ(*owners[0], 7);
+    EXPECT_EQ(*owners[1], 6);
+    EXPECT_EQ(*owners[2], 1);
+    EXPECT_EQ(*owners[3], 0);
+}
+
+#ifdef __cpp_exceptions
+
+TEST_CASE(relocatable_failed_insert) {
+    {
+        small_vector<relocatable, 2> values;
+        values.emplace_back(1);
+        values.emplace_back(2);
+        const relocatable extra(9);
+
+        relocatable::throw_on_copy = true;
+        EXPECT_THROWS(values.insert(values.begin() + 1, 3, extra));
+        relocatable::throw_on_copy = false;
+
+        EXPECT_EQ(values_of(values), (std::vector<int>{1, 2}));
+        EXPECT_EQ(relocatable::alive, 3);
+    }
+    EXPECT_EQ(relocatable::alive, 0);
+}
+
+#endif  // __cpp_exceptions
+
 };  // TEST_SUITE(small_vector)
 
 }  // namespace
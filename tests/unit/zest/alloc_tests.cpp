@@ -0,0 +1,95 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "kota/zest/zest.h"
+
+namespace kota::zest {
+
+namespace {
+
+/// Whether a check inside `body` failed the test; the caller's state is
+/// restored either way.
+template <typename F>
+bool fails(F&& body) {
+    const auto saved = current_test_state();
+    pass();
+    body();
+    const bool failed = current_test_state() == TestState::Failed;
+    current_test_state() = saved;
+    return failed;
+}
+
+TEST_SUITE(zest_alloc) {
+
+TEST_CASE(no_alloc_passes_without_allocations) {
+    int values[4] = {1, 2, 3, 4};
+    int sum = 0;
+    ZEST_EXPECT_NO_ALLOC {
+        for(auto value: values) {
+            sum += value;
+        }
+    }
+    EXPECT_EQ(sum, 10);
+}
+
+TEST_CASE(no_alloc_fails_on_allocation) {
+    if(!counts_allocations()) {
+        skip();
+        return;
+    }
+
+    EXPECT_TRUE(fails([] {
+        ZEST_EXPECT_NO_ALLOC {
+            auto value = std::make_unique<int>(1);
+            do_not_optimize(value);
+        }
+    }));
+}
+
+TEST_CASE(allocs_le_counts_up_to_the_limit) {
+    if(!counts_allocations()) {
+        skip();
+        return;
+    }
+
+    EXPECT_FALSE(fails([] {
+        ZEST_EXPECT_ALLOCS_LE(2) {
+            std::vector<int> values;
+            values.reserve(8);
+            auto other = std::make_unique<int>(1);
+            do_not_optimize(values);
+            do_not_optimize(other);
+        }
+    }));
+
+    EXPECT_TRUE(fails([] {
+        ZEST_EXPECT_ALLOCS_LE(1) {
+            auto first = std::make_unique<int>(1);
+            auto second = std::make_unique<int>(2);
+            do_not_optimize(first);
+            do_not_optimize(second);
+        }
+    }));
+}
+
+TEST_CASE(allocs_le_checks_an_early_return) {
+    if(!counts_allocations()) {
+        skip();
+        return;
+    }
+
+    EXPECT_TRUE(fails([] {
+        ZEST_EXPECT_ALLOCS_LE(0) {
+            std::string text(64, 'x');
+            do_not_optimize(text);
+            return;
+        }
+    }));
+}
+
+};  // TEST_SUITE(zest_alloc)
+
+}  // namespace
+
+}  // namespace kota::zest
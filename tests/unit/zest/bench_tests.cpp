@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "kota/zest/detail/alloc.h"
+#include "kota/zest/zest.h"
+
+namespace kota::zest {
+
+namespace {
+
+TEST_SUITE(zest_bench) {
+
+TEST_CASE(thread_allocations_count_new_and_delete) {
+    if(!counts_allocations()) {
+        skip();
+        return;
+    }
+
+    const auto before = thread_allocations();
+    auto value = std::make_unique<std::uint64_t>(42);
+    do_not_optimize(value);
+    value.reset();
+    const auto after = thread_allocations();
+
+    EXPECT_EQ(after.allocations - before.allocations, 1U);
+    EXPECT_EQ(after.deallocations - before.deallocations, 1U);
+    EXPECT_EQ(after.bytes - before.bytes, sizeof(std::uint64_t));
+}
+
+TEST_CASE(run_reports_calibrated_samples) {
+    Bench bench;
+    bench.samples(5).min_sample_time(std::chrono::microseconds(200)).warmup({});
+    EXPECT_FALSE(bench.measured());
+
+    std::uint64_t counter = 0;
+    bench.run([&] { return ++counter; });
+
+    ASSERT_TRUE(bench.measured());
+    const auto& stats = bench.stats();
+    EXPECT_EQ(stats.samples, 5U);
+    EXPECT_GE(stats.iterations, 1U);
+    EXPECT_GE(counter, stats.iterations * stats.samples);
+    EXPECT_LE(stats.min_ns, stats.median_ns);
+    EXPECT_LE(stats.median_ns, stats.p99_ns);
+    EXPECT_LE(stats.p99_ns, stats.max_ns);
+    EXPECT_GE(stats.stddev_ns, 0.0);
+    EXPECT_EQ(stats.allocations, 0.0);
+}
+
+TEST_CASE(run_counts_allocations_per_iteration) {
+    if(!counts_allocations()) {
+        skip();
+        return;
+    }
+
+    Bench bench;
+    bench.samples(3).min_sample_time(std::chrono::microseconds(200)).warmup({});
+    bench.run([] {
+        std::vector<int> values;
+        values.reserve(4);
+        do_not_optimize(values);
+    });
+
+    EXPECT_EQ(bench.stats().allocations, 1.0);
+    EXPECT_EQ(bench.stats().allocated_bytes, static_cast<double>(4 * sizeof(int)));
+}
+
+TEST_CASE(run_batch_reports_throughput_and_latencies) {
+    Bench bench;
+    bench.samples(3).min_sample_time(std::chrono::microseconds(200)).warmup({}).items(4);
+
+    std::uint64_t batches = 0;
+    bench.run_batch([&](std::uint64_t iterations) {
+        batches += 1;
+        for(std::uint64_t i = 0; i < iterations; ++i) {
+            bench.record_latency(std::chrono::nanoseconds(i % 100 + 1));
+        }
+    });
+
+    ASSERT_TRUE(bench.measured());
+    const auto& stats = bench.stats();
+    EXPECT_GE(batches, stats.samples);
+    EXPECT_GT(stats.items_per_second, 0.0);
+    EXPECT_EQ(stats.latency_count, stats.iterations * stats.samples);
+    EXPECT_LE(stats.latency_p50_ns, stats.latency_p90_ns);
+    EXPECT_LE(stats.latency_p90_ns, stats.latency_p99_ns);
+    EXPECT_LE(stats.latency_p99_ns, stats.latency_max_ns);
+    EXPECT_LE(stats.latency_max_ns, 100.0);
+}
+
+BENCH(vector_push_back) {
+    std::vector<int> values;
+    values.reserve(1024);
+    bench.samples(5).min_sample_time(std::chrono::milliseconds(1));
+    bench.run([&] {
+        if(values.size() == values.capacity()) {
+            values.clear();
+        }
+        values.push_back(1);
+        clobber();
+    });
+}
+
+};  // TEST_SUITE(zest_bench)
+
+}  // namespace
+
+}  // namespace kota::zest
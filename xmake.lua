@@ -6,6 +6,7 @@ set_allowedplats("windows", "linux", "macosx")
 option("dev", { default = true })
 option("test", { default = true })
 option("async", { default = true })
+option("async_io_uring", { default = false })
 option("ztest", { default = true })
 option("codec", { default = true })
 option("option", { default = true })
@@ -203,6 +204,9 @@ if has_config("async") then
 		add_headerfiles("include/(kota/async/**)")
 		add_deps("support")
 		add_packages("libuv")
+		if has_config("async_io_uring") then
+			add_defines("KOTA_ASYNC_IO_URING=1")
+		end
 	end)
 end
 
@@ -236,6 +240,9 @@ if has_config("async") then
 		add_files("src/ipc/codec/bincode.cpp")
 		add_includedirs("include", { public = true })
 		add_headerfiles("include/(kota/ipc/*)")
+		if is_plat("linux") then
+			add_syslinks("rt")
+		end
 		if has_config("codec") and has_config("codec_simdjson") then
 			add_files("src/ipc/codec/json.cpp")
 			add_deps("codec_json")
@@ -251,6 +258,15 @@ if has_config("async") then
 		add_headerfiles("include/(kota/ipc/lsp/*)")
 		add_deps("ipc")
 	end)
+
+	if has_config("codec") and has_config("codec_simdjson") then
+		target("language_codec", function()
+			set_kind("$(kind)")
+			add_rules("cl-flags")
+			add_files("src/ipc/lsp/codec/json.cpp")
+			add_deps("language")
+		end)
+	end
 end
 
 target("kotatsu", function()
@@ -327,6 +343,17 @@ target("kotatsu", function()
 	end)
 end)
 
+if has_config("codec") and has_config("codec_simdjson") then
+	target("codec_bench", function()
+		set_default(false)
+		set_kind("binary")
+		add_rules("cl-flags")
+		add_files("examples/codec_bench/codec_bench.cpp")
+		add_includedirs("tests/unit/codec")
+		add_deps("codec")
+	end)
+end
+
 if has_config("test") and has_config("ztest") then
 	target("unit_tests", function()
 		set_default(false)